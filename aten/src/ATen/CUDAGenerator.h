@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ATen/core/Generator.h>
+#include <ATen/cuda/PhiloxCudaState.h>
 
 // TODO: this file should be in ATen/cuda, not top level
 
@@ -19,12 +20,23 @@ struct TORCH_CUDA_API CUDAGenerator : public Generator {
   void set_philox_offset_per_thread(uint64_t offset);
   uint64_t philox_offset_per_thread();
   std::pair<uint64_t, uint64_t> philox_engine_inputs(uint64_t increment);
+  PhiloxCudaState philox_cuda_state(uint64_t increment);
+  // Called by CUDAGraph around the capture of a graph: while it is captured,
+  // philox_cuda_state hands out offsets relative to the value that replays
+  // write at `offset_extragraph`. capture_epilogue returns the increment a
+  // whole replay consumes.
+  void capture_prologue(int64_t* offset_extragraph);
+  uint64_t capture_epilogue();
   static DeviceType device_type();
 
 private:
   CUDAGenerator* clone_impl() const override;
+  void check_not_captured_by_others();
   uint64_t seed_ = default_rng_seed_val;
   uint64_t philox_offset_per_thread_ = 0;
+  int64_t* offset_extragraph_ = nullptr;
+  uint32_t offset_intragraph_ = 0;
+  bool graph_expects_this_gen_ = false;
 };
 
 namespace cuda {
@@ -59,6 +59,14 @@ void Context::setDeterministicCuDNN(bool b) {
   deterministic_cudnn = b;
 }
 
+bool Context::deterministic() const {
+  return deterministic_algorithms;
+}
+
+void Context::setDeterministic(bool b) {
+  deterministic_algorithms = b;
+}
+
 bool Context::benchmarkCuDNN() const {
   return benchmark_cudnn;
 }
@@ -67,6 +75,14 @@ void Context::setBenchmarkCuDNN(bool b) {
   benchmark_cudnn = b;
 }
 
+bool Context::tensorIteratorPlanCache() const {
+  return tensor_iterator_plan_cache;
+}
+
+void Context::setTensorIteratorPlanCache(bool b) {
+  tensor_iterator_plan_cache = b;
+}
+
 bool Context::hasMKL() const {
 #if AT_MKL_ENABLED()
   return true;
@@ -113,6 +129,14 @@ void Context::setQEngine(at::QEngine e) {
   TORCH_CHECK(false, "quantized engine ", toString(e), " is not supported");
 }
 
+bool Context::qEngineAutoSelect() const {
+  return qengine_auto_select;
+}
+
+void Context::setQEngineAutoSelect(bool b) {
+  qengine_auto_select = b;
+}
+
 const std::vector<at::QEngine>& Context::supportedQEngines() const {
   static auto supported_qengines = []() {
     std::vector<at::QEngine> engines = {};
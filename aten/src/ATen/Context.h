@@ -106,9 +106,25 @@ class CAFFE2_API Context {
   void setBenchmarkCuDNN(bool);
   bool deterministicCuDNN() const;
   void setDeterministicCuDNN(bool);
+  // Whether operators must pick a deterministic algorithm where they have a
+  // faster nondeterministic one, e.g. sort-based instead of atomic-add based
+  // accumulation on CUDA. Unlike deterministicCuDNN this is not specific to a
+  // library; it is off by default.
+  bool deterministic() const;
+  void setDeterministic(bool);
+  // Whether TensorIterator may reuse the dimension order, strides and output
+  // layout it computed for earlier operands with the same sizes, strides and
+  // element sizes on the same thread. See [TensorIterator plan cache].
+  bool tensorIteratorPlanCache() const;
+  void setTensorIteratorPlanCache(bool);
   at::QEngine qEngine() const;
   void setQEngine(at::QEngine e);
   const std::vector<at::QEngine>& supportedQEngines() const;
+  // Whether quantized prepack ops may pick FBGEMM or QNNPACK per weight
+  // shape instead of always using qEngine(). The chosen engine is recorded by
+  // the type of the packed weight and the matching run op follows it.
+  bool qEngineAutoSelect() const;
+  void setQEngineAutoSelect(bool);
 
  private:
   void initCUDAIfNeeded(DeviceType p) {
@@ -125,8 +141,11 @@ class CAFFE2_API Context {
   std::once_flag thh_init;
   bool enabled_cudnn = true;
   bool deterministic_cudnn = false;
+  bool deterministic_algorithms = false;
   bool benchmark_cudnn = false;
   bool enabled_mkldnn = true;
+  bool tensor_iterator_plan_cache = false;
+  bool qengine_auto_select = false;
   c10::optional<at::QEngine> quantized_engine = c10::nullopt;
   std::unique_ptr<THCState, void(*)(THCState*)> thc_state;
   std::unique_ptr<THHState, void(*)(THHState*)> thh_state;
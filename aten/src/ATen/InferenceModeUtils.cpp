@@ -0,0 +1,18 @@
+#include <ATen/InferenceModeUtils.h>
+
+namespace at {
+namespace impl {
+
+void check_inplace_in_inference_mode_slow(const Tensor& tensor, const char* op) {
+  if (!tensor.defined() || !tensor.unsafeGetTensorImpl()->has_storage()) {
+    return;
+  }
+  TORCH_CHECK(
+      tensor.unsafeGetTensorImpl()->storage().unsafeGetStorageImpl()->is_inference(),
+      op, ": in inference mode, in-place operations and out= arguments are only "
+      "allowed on tensors whose memory was allocated in inference mode. The "
+      "tensor may have been saved for backward outside of it; clone it first.");
+}
+
+} // namespace impl
+} // namespace at
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ATen/core/Tensor.h>
+#include <c10/core/InferenceMode.h>
+
+namespace at {
+namespace impl {
+
+CAFFE2_API void check_inplace_in_inference_mode_slow(const Tensor& tensor, const char* op);
+
+// Called by the generated kernels of ops that write into `tensor`.
+//
+// at::InferenceModeGuard skips the Variable kernels, so writes done under it
+// do not bump version counters. A tensor that autograd saved for backward
+// outside of the guard could then be modified without backward noticing.
+// While the guard is active, writes are only allowed to storages that were
+// created under it; views of other tensors share those tensors' storage and
+// are rejected as well.
+inline void check_inplace_in_inference_mode(const Tensor& tensor, const char* op) {
+  if (C10_UNLIKELY(c10::InferenceMode::is_enabled())) {
+    check_inplace_in_inference_mode_slow(tensor, op);
+  }
+}
+
+} // namespace impl
+} // namespace at
@@ -11,8 +11,11 @@ namespace at {
 using NameVector = SmallVector<Dimname, kDimVectorStaticSize>;
 
 inline bool has_names(TensorList tensors) {
-  return std::any_of(
-      tensors.begin(), tensors.end(), [](const Tensor& t) { return t.has_names(); });
+  DispatchKeySet ks;
+  for (const auto& t : tensors) {
+    ks = ks | t.key_set();
+  }
+  return impl::has_names(ks);
 }
 
 // Converts dim to an positional index. Errors if `dim` cannot be used to
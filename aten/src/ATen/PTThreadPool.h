@@ -16,4 +16,15 @@ public:
       }) {}
 };
 
+class CAFFE2_API PTWorkStealingThreadPool : public c10::WorkStealingThreadPool {
+public:
+  explicit PTWorkStealingThreadPool(
+      int pool_size,
+      int numa_node_id = -1)
+    : c10::WorkStealingThreadPool(pool_size, numa_node_id, [](){
+        c10::setThreadName("PTThreadPool");
+        at::init_num_threads();
+      }) {}
+};
+
 } // namespace at
@@ -10,6 +10,8 @@
 #endif // C10_MOBILE
 
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -36,10 +38,6 @@ void _set_thread_num(size_t thread_num) {
   thread_num_ = thread_num;
 }
 
-void _unset_thread_num() {
-  thread_num_ = 0;
-}
-
 #ifndef C10_MOBILE
 
 const int NOT_SET = -1;
@@ -100,16 +98,86 @@ void _run_with_pool(const std::function<void(int, size_t)>& fn, size_t range) {
 }
 
 // RAII guard helps to support in_parallel_region() and get_thread_num() API.
+// Restores the previous values on exit so that nested parallel regions leave
+// the enclosing task's thread number intact.
 struct ParallelRegionGuard {
-  ParallelRegionGuard(int64_t task_id) {
+  ParallelRegionGuard(int64_t task_id)
+    : prev_thread_num_(thread_num_),
+      prev_in_parallel_region_(in_parallel_region_) {
     _set_thread_num(task_id);
     _set_in_parallel_region(true);
   }
 
   ~ParallelRegionGuard() {
-    _set_in_parallel_region(false);
-    _unset_thread_num();
+    _set_in_parallel_region(prev_in_parallel_region_);
+    _set_thread_num(prev_thread_num_);
+  }
+
+ private:
+  size_t prev_thread_num_;
+  bool prev_in_parallel_region_;
+};
+
+// State shared by the threads working on one _parallel_run_chunks call.
+// Chunks are claimed from next_task, so whichever threads show up first do
+// the work; helpers that arrive after all chunks were claimed return at once.
+struct ParallelJob {
+  ParallelJob(
+      int64_t begin,
+      int64_t end,
+      size_t num_tasks,
+      size_t chunk_size,
+      const std::function<void(int64_t, int64_t, size_t)>& f)
+    : begin(begin),
+      end(end),
+      num_tasks(num_tasks),
+      chunk_size(chunk_size),
+      f(f),
+      remaining(num_tasks) {}
+
+  // Claims and runs chunks until there are none left.
+  void work() {
+    for (size_t task_id = next_task++; task_id < num_tasks;
+         task_id = next_task++) {
+      int64_t local_start = begin + task_id * chunk_size;
+      int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
+      int64_t start_ns = internal::_now_ns();
+      try {
+        ParallelRegionGuard guard(task_id);
+        f(local_start, local_end, task_id);
+      } catch (...) {
+        if (!err_flag.test_and_set()) {
+          eptr = std::current_exception();
+        }
+      }
+      busy_ns += internal::_now_ns() - start_ns;
+      // f must not be touched once the last chunk is done: the caller
+      // returns as soon as it sees remaining == 0.
+      if (--remaining == 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        done.notify_all();
+      }
+    }
   }
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this]() { return remaining.load() == 0; });
+  }
+
+  const int64_t begin;
+  const int64_t end;
+  const size_t num_tasks;
+  const size_t chunk_size;
+  const std::function<void(int64_t, int64_t, size_t)>& f;
+
+  std::atomic<size_t> next_task{0};
+  std::atomic<size_t> remaining;
+  std::atomic<int64_t> busy_ns{0};
+  std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
+  std::exception_ptr eptr;
+  std::mutex mutex;
+  std::condition_variable done;
 };
 
 } // namespace
@@ -124,37 +192,32 @@ void _parallel_run(
   size_t num_tasks, chunk_size;
   std::tie(num_tasks, chunk_size) =
       internal::calc_num_tasks_and_chunk_size(begin, end, grain_size);
+  _parallel_run_chunks(begin, end, num_tasks, chunk_size, f, nullptr);
+}
 
-  std::atomic_flag err_flag = ATOMIC_FLAG_INIT;
-  std::exception_ptr eptr;
-  std::vector<std::shared_ptr<c10::ivalue::Future>> futures(num_tasks);
-  for (size_t task_id = 0; task_id < num_tasks; ++task_id) {
-    futures[task_id] = std::make_shared<c10::ivalue::Future>(c10::NoneType::get());
-  }
-  auto task = [f, &eptr, &err_flag, &futures, begin, end, chunk_size]
-      (int /* unused */, size_t task_id) {
-    int64_t local_start = begin + task_id * chunk_size;
-    if (local_start < end) {
-      int64_t local_end = std::min(end, (int64_t)(chunk_size + local_start));
-      try {
-        ParallelRegionGuard guard(task_id);
-        f(local_start, local_end, task_id);
-      } catch (...) {
-        if (!err_flag.test_and_set()) {
-          eptr = std::current_exception();
-        }
-      }
-    }
-    futures[task_id]->markCompleted();
-  };
-  _run_with_pool(task, num_tasks);
-
-  // Wait for all tasks to finish.
-  for (size_t task_id = 0; task_id < num_tasks; ++task_id) {
-    futures[task_id]->wait();
+void _parallel_run_chunks(
+  const int64_t begin,
+  const int64_t end,
+  const size_t num_tasks,
+  const size_t chunk_size,
+  const std::function<void(int64_t, int64_t, size_t)>& f,
+  ParallelCostEstimate* estimate) {
+  // Helpers may still be queued in the pool after this call returned, so the
+  // job outlives the stack frame.
+  auto job = std::make_shared<ParallelJob>(begin, end, num_tasks, chunk_size, f);
+  // The calling thread always takes part, so a nested call never blocks on
+  // chunks that are still waiting for a pool thread: it only waits for chunks
+  // that another thread is already running.
+  _run_with_pool(
+      [job](int /* unused */, size_t /* unused */) { job->work(); },
+      std::min(num_tasks, (size_t)get_num_threads()));
+  job->wait();
+
+  if (estimate) {
+    estimate->record(job->busy_ns.load(), end - begin);
   }
-  if (eptr) {
-    std::rethrow_exception(eptr);
+  if (job->eptr) {
+    std::rethrow_exception(job->eptr);
   }
 }
 
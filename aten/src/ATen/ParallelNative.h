@@ -1,21 +1,63 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <exception>
+#include <tuple>
 
 #define INTRA_OP_PARALLEL
 
 namespace at {
 namespace internal {
 
+// Parallel work expected to take less than this runs on the calling thread.
+constexpr float kMinParallelWorkNs = 20000;
+// Every task gets at least this much expected work.
+constexpr float kMinTaskWorkNs = 10000;
+
+// Running estimate of how long one item of a parallel_for / parallel_reduce
+// body takes. There is one per call site (i.e. per body type), and it is
+// refined whenever that call site runs, so that the task count can follow the
+// measured cost instead of relying on grain_size alone.
+struct ParallelCostEstimate {
+  // negative until the first measurement
+  std::atomic<float> ns_per_item{-1.0f};
+
+  void record(int64_t ns, int64_t items) {
+    if (items <= 0) {
+      return;
+    }
+    const float sample = static_cast<float>(ns) / items;
+    const float prev = ns_per_item.load(std::memory_order_relaxed);
+    ns_per_item.store(
+        prev < 0 ? sample : 0.75f * prev + 0.25f * sample,
+        std::memory_order_relaxed);
+  }
+};
+
 inline std::tuple<size_t, size_t> calc_num_tasks_and_chunk_size(
-    int64_t begin, int64_t end, int64_t grain_size) {
+    int64_t begin, int64_t end, int64_t grain_size,
+    const ParallelCostEstimate* estimate = nullptr) {
   if ((end - begin) < grain_size) {
     return std::make_tuple(1, std::max((int64_t)0, end - begin));
   }
+  size_t max_tasks = get_num_threads();
+  if (estimate) {
+    const float ns_per_item =
+        estimate->ns_per_item.load(std::memory_order_relaxed);
+    if (ns_per_item >= 0) {
+      const float work_ns = ns_per_item * (end - begin);
+      if (work_ns < kMinParallelWorkNs) {
+        return std::make_tuple(1, end - begin);
+      }
+      max_tasks = std::min(
+          max_tasks, std::max((size_t)1, (size_t)(work_ns / kMinTaskWorkNs)));
+    }
+  }
   // Choose number of tasks based on grain size and number of threads.
-  size_t chunk_size = divup((end - begin), get_num_threads());
+  size_t chunk_size = divup((end - begin), max_tasks);
   // Make sure each task is at least grain_size size.
   chunk_size = std::max((size_t)grain_size, chunk_size);
   size_t num_tasks = divup((end - begin), chunk_size);
@@ -28,8 +70,27 @@ CAFFE2_API void _parallel_run(
   const int64_t grain_size,
   const std::function<void(int64_t, int64_t, size_t)>& f);
 
+// Runs f over num_tasks chunks of chunk_size items and, if estimate is not
+// null, records the time spent in f into it. Safe to call from inside a
+// parallel region: the calling thread works on the chunks itself and only
+// waits for chunks other threads have already started.
+CAFFE2_API void _parallel_run_chunks(
+  const int64_t begin,
+  const int64_t end,
+  const size_t num_tasks,
+  const size_t chunk_size,
+  const std::function<void(int64_t, int64_t, size_t)>& f,
+  ParallelCostEstimate* estimate);
+
+inline int64_t _now_ns() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 } // namespace internal
 
+// Nested calls (from inside another parallel_for or from an inter-op task)
+// are run in parallel too when there is enough work; see _parallel_run_chunks.
 template <class F>
 inline void parallel_for(
     const int64_t begin,
@@ -40,17 +101,29 @@ inline void parallel_for(
   if (begin >= end) {
     return;
   }
-  if ((end - begin) < grain_size || in_parallel_region()) {
+  if ((end - begin) < grain_size) {
+    f(begin, end);
+    return;
+  }
+  static internal::ParallelCostEstimate estimate;
+  size_t num_tasks, chunk_size;
+  std::tie(num_tasks, chunk_size) =
+      internal::calc_num_tasks_and_chunk_size(begin, end, grain_size, &estimate);
+  if (num_tasks == 1) {
+    const int64_t start_ns = internal::_now_ns();
     f(begin, end);
+    estimate.record(internal::_now_ns() - start_ns, end - begin);
     return;
   }
-  internal::_parallel_run(
+  internal::_parallel_run_chunks(
       begin,
       end,
-      grain_size,
+      num_tasks,
+      chunk_size,
       [f](int64_t start, int64_t end, size_t /* unused */) {
         f(start, end);
-      }
+      },
+      &estimate
   );
 }
 
@@ -66,21 +139,30 @@ inline scalar_t parallel_reduce(
   if (begin >= end) {
     return ident;
   }
-  if ((end - begin) < grain_size || in_parallel_region()) {
+  if ((end - begin) < grain_size) {
     return f(begin, end, ident);
   }
+  static internal::ParallelCostEstimate estimate;
   size_t num_tasks, chunk_size;
   std::tie(num_tasks, chunk_size) =
-      internal::calc_num_tasks_and_chunk_size(begin, end, grain_size);
+      internal::calc_num_tasks_and_chunk_size(begin, end, grain_size, &estimate);
+  if (num_tasks == 1) {
+    const int64_t start_ns = internal::_now_ns();
+    scalar_t result = f(begin, end, ident);
+    estimate.record(internal::_now_ns() - start_ns, end - begin);
+    return result;
+  }
   std::vector<scalar_t> results(num_tasks);
   scalar_t* results_data = results.data();
-  internal::_parallel_run(
+  internal::_parallel_run_chunks(
       begin,
       end,
-      grain_size,
+      num_tasks,
+      chunk_size,
       [f, ident, results_data](int64_t start, int64_t end, size_t task_id) {
         results_data[task_id] = f(start, end, ident);
-      }
+      },
+      &estimate
   );
   scalar_t result = ident;
   for (auto partial_result : results) {
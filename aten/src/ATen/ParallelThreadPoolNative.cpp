@@ -1,9 +1,11 @@
 #if AT_PARALLEL_OPENMP || AT_PARALLEL_NATIVE || AT_PARALLEL_NATIVE_TBB
 #include <ATen/Parallel.h>
 #include <ATen/PTThreadPool.h>
-#include <ATen/ThreadLocalDebugInfo.h>
+#include <ATen/ThreadLocalState.h>
 
 #include <atomic>
+#include <cstdlib>
+#include <cstring>
 
 namespace at {
 
@@ -20,10 +22,17 @@ std::atomic<int> num_interop_threads{NOT_SET};
 
 // thread pool global instance is hidden,
 // users should use at::launch and get/set_num_interop_threads interface
+// PYTORCH_INTEROP_WORK_STEALING=1 selects the work-stealing implementation
+// for the inter-op pool.
+bool use_work_stealing_pool() {
+  const char* env = std::getenv("PYTORCH_INTEROP_WORK_STEALING");
+  return env != nullptr && std::strcmp(env, "0") != 0;
+}
+
 TaskThreadPoolBase& get_pool() {
   static std::shared_ptr<TaskThreadPoolBase> pool =
       ThreadPoolRegistry()->Create(
-          "C10",
+          use_work_stealing_pool() ? "C10WorkStealing" : "C10",
           /* device_id */ 0,
           /* pool_size */ num_interop_threads.exchange(CONSUMED),
           /* create_new */ true);
@@ -42,9 +51,22 @@ std::shared_ptr<TaskThreadPoolBase> create_c10_threadpool(
   return std::make_shared<PTThreadPool>(pool_size);
 }
 
+std::shared_ptr<TaskThreadPoolBase> create_c10_work_stealing_threadpool(
+    int device_id,
+    int pool_size,
+    bool create_new) {
+  TORCH_CHECK(device_id == 0);
+  TORCH_CHECK(create_new);
+  return std::make_shared<PTWorkStealingThreadPool>(pool_size);
+}
+
 } // namespace
 
 C10_REGISTER_CREATOR(ThreadPoolRegistry, C10, create_c10_threadpool);
+C10_REGISTER_CREATOR(
+    ThreadPoolRegistry,
+    C10WorkStealing,
+    create_c10_work_stealing_threadpool);
 
 void set_num_interop_threads(int nthreads) {
   TORCH_CHECK(nthreads > 0, "Expected positive number of threads");
@@ -68,17 +90,15 @@ int get_num_interop_threads() {
 }
 
 void launch(std::function<void()> func) {
-  auto fn = std::bind([](
-    std::function<void()> f, std::shared_ptr<ThreadLocalDebugInfoBase> info) {
-      DebugInfoGuard guard(std::move(info));
-      f();
-    },
-    std::move(func),
-    getThreadLocalDebugInfo()
-  );
+  // The task runs once, so the captured state is moved into the guard.
+  std::function<void()> fn =
+      [f = std::move(func), thread_locals = ThreadLocalState()]() mutable {
+        ThreadLocalStateGuard guard(std::move(thread_locals));
+        f();
+      };
 
 #if AT_EXPERIMENTAL_SINGLE_THREAD_POOL
-  intraop_launch(fn);
+  intraop_launch(std::move(fn));
 #else
   get_pool().run(fn);
 #endif
@@ -0,0 +1,30 @@
+#include <ATen/ThreadLocalState.h>
+
+#include <ATen/core/grad_mode.h>
+#include <c10/core/InferenceMode.h>
+
+namespace at {
+
+ThreadLocalState::ThreadLocalState()
+    : dispatch_key_(c10::impl::tls_local_dispatch_key_set()),
+      debug_info_(getThreadLocalDebugInfo()),
+      grad_mode_enabled_(GradMode::is_enabled()),
+      inference_mode_enabled_(c10::InferenceMode::is_enabled()) {}
+
+ThreadLocalState::ThreadLocalState(skip_debug_info_t)
+    : dispatch_key_(c10::impl::tls_local_dispatch_key_set()),
+      grad_mode_enabled_(GradMode::is_enabled()),
+      inference_mode_enabled_(c10::InferenceMode::is_enabled()) {}
+
+ThreadLocalState ThreadLocalState::exchange(ThreadLocalState state) {
+  ThreadLocalState prev{skip_debug_info_t()};
+  c10::impl::_force_tls_local_dispatch_key_set(state.dispatch_key_);
+  // setThreadLocalDebugInfo moves the pointers in and out, so installing the
+  // debug info does not touch its refcount.
+  prev.debug_info_ = setThreadLocalDebugInfo(std::move(state.debug_info_));
+  GradMode::set_enabled(state.grad_mode_enabled_);
+  c10::InferenceMode::set_enabled(state.inference_mode_enabled_);
+  return prev;
+}
+
+} // namespace at
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <c10/core/impl/LocalDispatchKeySet.h>
+#include <c10/macros/Export.h>
+
+#include <ATen/ThreadLocalDebugInfo.h>
+
+#include <memory>
+
+namespace at {
+
+// Snapshot of the thread local state that work handed to another thread has
+// to run with: the grad and inference modes, the local dispatch key set
+// (e.g. the keys excluded by AutoNonVariableTypeMode or included for
+// profiling) and the thread local debug info. Inter-op tasks (at::launch)
+// and JIT forks capture it when they are created and install it on the
+// thread that runs them.
+//
+// Capturing copies a few flags and the debug info pointer; installing it
+// with ThreadLocalStateGuard swaps them in and out, so that fine grained
+// tasks don't pay for propagating each piece separately. Profiler state and
+// RecordFunction callbacks are process wide and need no propagation.
+class CAFFE2_API ThreadLocalState {
+ public:
+  // Captures the state of the current thread.
+  ThreadLocalState();
+
+ private:
+  struct skip_debug_info_t {};
+
+  // Captures the state of the current thread except for the debug info.
+  explicit ThreadLocalState(skip_debug_info_t);
+
+  c10::impl::LocalDispatchKeySet dispatch_key_;
+  std::shared_ptr<ThreadLocalDebugInfoBase> debug_info_;
+  bool grad_mode_enabled_;
+  bool inference_mode_enabled_;
+
+  // Installs `state` on the current thread and returns the state it replaced.
+  static ThreadLocalState exchange(ThreadLocalState state);
+
+  friend class ThreadLocalStateGuard;
+};
+
+// Installs a captured ThreadLocalState on the current thread for the
+// lifetime of the guard. Pass the state as an rvalue if it is not needed
+// afterwards, e.g. by a task that runs once, to avoid copying it.
+class CAFFE2_API ThreadLocalStateGuard {
+ public:
+  explicit ThreadLocalStateGuard(ThreadLocalState state)
+      : prev_state_(ThreadLocalState::exchange(std::move(state))) {}
+
+  ThreadLocalStateGuard(const ThreadLocalStateGuard&) = delete;
+  ThreadLocalStateGuard& operator=(const ThreadLocalStateGuard&) = delete;
+
+  ~ThreadLocalStateGuard() {
+    ThreadLocalState::exchange(std::move(prev_state_));
+  }
+
+ private:
+  ThreadLocalState prev_state_;
+};
+
+} // namespace at
@@ -0,0 +1,241 @@
+#include <ATen/autocast_mode.h>
+
+#include <ATen/core/dispatch/Dispatcher.h>
+#include <ATen/core/grad_mode.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <c10/core/impl/LocalDispatchKeySet.h>
+#include <c10/util/Metaprogramming.h>
+
+#include <unordered_map>
+
+namespace at {
+namespace autocast {
+
+namespace {
+
+// A reduced precision copy of a weight, along with the version of the weight
+// it was made from, so that in-place updates of the weight (e.g. an optimizer
+// step inside the autocast region) invalidate it. The weak reference tells a
+// weight that was freed apart from a new one that got the same TensorImpl*
+// (and also starts at version 0).
+struct CachedCast {
+  c10::weak_intrusive_ptr<TensorImpl, UndefinedTensorImpl> source;
+  Tensor casted;
+  uint32_t version;
+};
+
+thread_local std::unordered_map<TensorImpl*, CachedCast> cached_casts;
+thread_local int nesting = 0;
+thread_local ScalarType autocast_dtype = at::kHalf;
+
+} // namespace
+
+bool is_enabled() {
+  return c10::impl::tls_is_dispatch_key_included(DispatchKey::AutocastTensorId);
+}
+
+void set_enabled(bool enabled) {
+  c10::impl::tls_set_dispatch_key_included(DispatchKey::AutocastTensorId, enabled);
+}
+
+ScalarType get_autocast_dtype() {
+  return autocast_dtype;
+}
+
+void set_autocast_dtype(ScalarType dtype) {
+  TORCH_CHECK(
+      dtype == at::kHalf || dtype == at::kBFloat16,
+      "autocast: the autocast dtype must be Half or BFloat16, but got ", dtype);
+  if (dtype != autocast_dtype) {
+    clear_cache();
+    autocast_dtype = dtype;
+  }
+}
+
+void clear_cache() {
+  cached_casts.clear();
+}
+
+int increment_nesting() {
+  return ++nesting;
+}
+
+int decrement_nesting() {
+  return --nesting;
+}
+
+namespace {
+
+// Only CUDA floating point tensors take part in autocasting.  Double is
+// assumed to have been asked for explicitly and is never cast.
+bool is_eligible(const Tensor& arg) {
+  return arg.defined() && arg.is_cuda() && arg.is_floating_point() &&
+      arg.scalar_type() != at::kDouble;
+}
+
+Tensor cached_cast(ScalarType to_type, const Tensor& arg) {
+  if (!is_eligible(arg) || arg.scalar_type() == to_type) {
+    return arg;
+  }
+  // Leaves that require grad are the parameters of the model: they are used by
+  // several operators and outlive the iteration, so their casts are cached.
+  // Activations are only consumed once and would just pin memory.
+  if (to_type != autocast_dtype || !arg.requires_grad() || !arg.is_leaf()) {
+    return arg.to(to_type);
+  }
+  const auto version = arg.unsafeGetTensorImpl()->version_counter().current_version();
+  auto it = cached_casts.find(arg.unsafeGetTensorImpl());
+  // A copy made under no_grad has no history and can't be reused with grad
+  // mode on (and the other way around).
+  if (it != cached_casts.end() && !it->second.source.expired() &&
+      it->second.version == version &&
+      it->second.casted.requires_grad() == GradMode::is_enabled()) {
+    return it->second.casted;
+  }
+  auto casted = arg.to(to_type);
+  CachedCast entry{
+      c10::weak_intrusive_ptr<TensorImpl, UndefinedTensorImpl>(
+          arg.getIntrusivePtr()),
+      casted,
+      version};
+  if (it != cached_casts.end()) {
+    it->second = std::move(entry);
+  } else {
+    cached_casts.emplace(arg.unsafeGetTensorImpl(), std::move(entry));
+  }
+  return casted;
+}
+
+template <class T>
+T cached_cast(ScalarType to_type, T arg) {
+  return arg;
+}
+
+enum class CastPolicy : uint8_t {
+  lower_precision, // cast to the autocast dtype
+  fp32, // cast to float
+};
+
+ScalarType policy_dtype(CastPolicy policy) {
+  return policy == CastPolicy::fp32 ? at::kFloat : autocast_dtype;
+}
+
+// Wraps F into a kernel with the same signature that casts all the eligible
+// tensor arguments according to policy and then redispatches below autocast.
+template <CastPolicy policy, class Redispatch, Redispatch* F, class Ret, class ArgList>
+struct WrapFunction_ {};
+
+template <CastPolicy policy, class Redispatch, Redispatch* F, class Ret, class... Args>
+struct WrapFunction_<policy, Redispatch, F, Ret, guts::typelist::typelist<Args...>> {
+  static Ret call(Args... args) {
+    c10::impl::ExcludeDispatchKeyGuard no_autocast(DispatchKey::AutocastTensorId);
+    const auto to_type = policy_dtype(policy);
+    return (*F)(cached_cast(to_type, args)...);
+  }
+};
+
+template <CastPolicy policy, class Signature, Signature* F>
+struct WrapFunction final {
+  using type = WrapFunction_<
+      policy,
+      Signature,
+      F,
+      typename guts::function_traits<Signature>::return_type,
+      typename guts::function_traits<Signature>::parameter_types>;
+};
+
+#define KERNEL(FUNC, SCHEMA, SIGNATURE, POLICY)                           \
+  .op(torch::RegisterOperators::options()                                \
+          .schema(SCHEMA)                                                \
+          .impl_unboxedOnlyKernel<                                       \
+              SIGNATURE,                                                 \
+              &WrapFunction<CastPolicy::POLICY, SIGNATURE, &FUNC>::type::call>( \
+              DispatchKey::AutocastTensorId)                             \
+          .aliasAnalysis(c10::AliasAnalysisKind::FROM_SCHEMA))
+
+// Operators without an autocast kernel run in the dtype of their inputs.
+auto fallthrough = c10::Dispatcher::singleton().registerBackendFallbackKernel(
+    DispatchKey::AutocastTensorId,
+    KernelFunction::makeFallthrough());
+
+auto registry = torch::RegisterOperators()
+  // lower precision: matmuls and convolutions, which run on tensor cores
+  KERNEL(at::mm, "aten::mm(Tensor self, Tensor mat2) -> Tensor",
+         Tensor (const Tensor&, const Tensor&), lower_precision)
+  KERNEL(at::mv, "aten::mv(Tensor self, Tensor vec) -> Tensor",
+         Tensor (const Tensor&, const Tensor&), lower_precision)
+  KERNEL(at::bmm, "aten::bmm(Tensor self, Tensor mat2) -> Tensor",
+         Tensor (const Tensor&, const Tensor&), lower_precision)
+  KERNEL(at::matmul, "aten::matmul(Tensor self, Tensor other) -> Tensor",
+         Tensor (const Tensor&, const Tensor&), lower_precision)
+  KERNEL(at::addmm, "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&, Scalar, Scalar), lower_precision)
+  KERNEL(at::addmv, "aten::addmv(Tensor self, Tensor mat, Tensor vec, *, Scalar beta=1, Scalar alpha=1) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&, Scalar, Scalar), lower_precision)
+  KERNEL(at::baddbmm, "aten::baddbmm(Tensor self, Tensor batch1, Tensor batch2, *, Scalar beta=1, Scalar alpha=1) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&, Scalar, Scalar), lower_precision)
+  KERNEL(at::addbmm, "aten::addbmm(Tensor self, Tensor batch1, Tensor batch2, *, Scalar beta=1, Scalar alpha=1) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&, Scalar, Scalar), lower_precision)
+  KERNEL(at::linear, "aten::linear(Tensor input, Tensor weight, Tensor? bias=None) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&), lower_precision)
+  KERNEL(at::conv1d, "aten::conv1d(Tensor input, Tensor weight, Tensor? bias=None, int[1] stride=1, int[1] padding=0, int[1] dilation=1, int groups=1) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&, IntArrayRef, IntArrayRef, IntArrayRef, int64_t), lower_precision)
+  KERNEL(at::conv2d, "aten::conv2d(Tensor input, Tensor weight, Tensor? bias=None, int[2] stride=1, int[2] padding=0, int[2] dilation=1, int groups=1) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&, IntArrayRef, IntArrayRef, IntArrayRef, int64_t), lower_precision)
+  KERNEL(at::conv3d, "aten::conv3d(Tensor input, Tensor weight, Tensor? bias=None, int[3] stride=1, int[3] padding=0, int[3] dilation=1, int groups=1) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&, IntArrayRef, IntArrayRef, IntArrayRef, int64_t), lower_precision)
+  KERNEL(at::conv_transpose1d, "aten::conv_transpose1d(Tensor input, Tensor weight, Tensor? bias=None, int[1] stride=1, int[1] padding=0, int[1] output_padding=0, int groups=1, int[1] dilation=1) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&, IntArrayRef, IntArrayRef, IntArrayRef, int64_t, IntArrayRef), lower_precision)
+  KERNEL(at::conv_transpose2d, "aten::conv_transpose2d.input(Tensor input, Tensor weight, Tensor? bias=None, int[2] stride=1, int[2] padding=0, int[2] output_padding=0, int groups=1, int[2] dilation=1) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&, IntArrayRef, IntArrayRef, IntArrayRef, int64_t, IntArrayRef), lower_precision)
+  KERNEL(at::conv_transpose3d, "aten::conv_transpose3d.input(Tensor input, Tensor weight, Tensor? bias=None, int[3] stride=1, int[3] padding=0, int[3] output_padding=0, int groups=1, int[3] dilation=1) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&, IntArrayRef, IntArrayRef, IntArrayRef, int64_t, IntArrayRef), lower_precision)
+  KERNEL(at::prelu, "aten::prelu(Tensor self, Tensor weight) -> Tensor",
+         Tensor (const Tensor&, const Tensor&), lower_precision)
+  // fp32: reductions whose range or accumulated error matters
+  KERNEL(at::softmax, "aten::softmax.int(Tensor self, int dim, ScalarType? dtype=None) -> Tensor",
+         Tensor (const Tensor&, int64_t, c10::optional<ScalarType>), fp32)
+  KERNEL(at::log_softmax, "aten::log_softmax.int(Tensor self, int dim, ScalarType? dtype=None) -> Tensor",
+         Tensor (const Tensor&, int64_t, c10::optional<ScalarType>), fp32)
+  KERNEL(at::layer_norm, "aten::layer_norm(Tensor input, int[] normalized_shape, Tensor? weight=None, Tensor? bias=None, float eps=1e-05, bool cudnn_enable=True) -> Tensor",
+         Tensor (const Tensor&, IntArrayRef, const Tensor&, const Tensor&, double, bool), fp32)
+  KERNEL(at::group_norm, "aten::group_norm(Tensor input, int num_groups, Tensor? weight=None, Tensor? bias=None, float eps=1e-05, bool cudnn_enabled=True) -> Tensor",
+         Tensor (const Tensor&, int64_t, const Tensor&, const Tensor&, double, bool), fp32)
+  KERNEL(at::cosine_similarity, "aten::cosine_similarity(Tensor x1, Tensor x2, int dim=1, float eps=1e-08) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, int64_t, double), fp32)
+  KERNEL(at::cdist, "aten::cdist(Tensor x1, Tensor x2, float p=2, int? compute_mode=None) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, double, c10::optional<int64_t>), fp32)
+  KERNEL(at::mse_loss, "aten::mse_loss(Tensor self, Tensor target, int reduction=Mean) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, int64_t), fp32)
+  KERNEL(at::l1_loss, "aten::l1_loss(Tensor self, Tensor target, int reduction=Mean) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, int64_t), fp32)
+  KERNEL(at::smooth_l1_loss, "aten::smooth_l1_loss(Tensor self, Tensor target, int reduction=Mean) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, int64_t), fp32)
+  KERNEL(at::soft_margin_loss, "aten::soft_margin_loss(Tensor self, Tensor target, int reduction=Mean) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, int64_t), fp32)
+  KERNEL(at::kl_div, "aten::kl_div(Tensor self, Tensor target, int reduction=Mean) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, int64_t), fp32)
+  KERNEL(at::multilabel_margin_loss, "aten::multilabel_margin_loss(Tensor self, Tensor target, int reduction=Mean) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, int64_t), fp32)
+  KERNEL(at::nll_loss, "aten::nll_loss(Tensor self, Tensor target, Tensor? weight=None, int reduction=Mean, int ignore_index=-100) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&, int64_t, int64_t), fp32)
+  KERNEL(at::nll_loss2d, "aten::nll_loss2d(Tensor self, Tensor target, Tensor? weight=None, int reduction=Mean, int ignore_index=-100) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&, int64_t, int64_t), fp32)
+  KERNEL(at::binary_cross_entropy_with_logits, "aten::binary_cross_entropy_with_logits(Tensor self, Tensor target, Tensor? weight=None, Tensor? pos_weight=None, int reduction=Mean) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&, const Tensor&, int64_t), fp32)
+  KERNEL(at::poisson_nll_loss, "aten::poisson_nll_loss(Tensor input, Tensor target, bool log_input, bool full, float eps, int reduction) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, bool, bool, double, int64_t), fp32)
+  KERNEL(at::hinge_embedding_loss, "aten::hinge_embedding_loss(Tensor self, Tensor target, float margin=1.0, int reduction=Mean) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, double, int64_t), fp32)
+  KERNEL(at::cosine_embedding_loss, "aten::cosine_embedding_loss(Tensor input1, Tensor input2, Tensor target, float margin=0.0, int reduction=Mean) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&, double, int64_t), fp32)
+  KERNEL(at::margin_ranking_loss, "aten::margin_ranking_loss(Tensor input1, Tensor input2, Tensor target, float margin=0.0, int reduction=Mean) -> Tensor",
+         Tensor (const Tensor&, const Tensor&, const Tensor&, double, int64_t), fp32)
+  ;
+
+#undef KERNEL
+
+} // namespace
+
+} // namespace autocast
+} // namespace at
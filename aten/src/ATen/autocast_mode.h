@@ -0,0 +1,36 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at {
+namespace autocast {
+
+// Autocast (automatic mixed precision) state of the current thread.
+//
+// While autocast is enabled, operators that are fast and numerically safe in
+// reduced precision (matmuls, convolutions, linear) run in the autocast dtype
+// (Half by default, or BFloat16), and operators that need the range of float
+// (softmax, norms, losses) run in float, regardless of the dtype of their
+// inputs.  Only CUDA floating point tensors are cast; double tensors are left
+// alone.  The mode is implemented by the AutocastTensorId dispatch key, so it
+// only applies on the thread that enabled it; in particular backward runs in
+// the dtypes chosen during forward.
+
+CAFFE2_API bool is_enabled();
+CAFFE2_API void set_enabled(bool enabled);
+
+// The reduced precision dtype, kHalf or kBFloat16.
+CAFFE2_API ScalarType get_autocast_dtype();
+CAFFE2_API void set_autocast_dtype(ScalarType dtype);
+
+// Reduced precision copies of leaf tensors that require grad (i.e. the
+// parameters of a model) are cached per thread, so that a weight used by
+// several operators is only cast once per iteration.  The cache must be
+// cleared when leaving the outermost autocast region, which callers track
+// with the nesting counter below.
+CAFFE2_API void clear_cache();
+CAFFE2_API int increment_nesting();
+CAFFE2_API int decrement_nesting();
+
+} // namespace autocast
+} // namespace at
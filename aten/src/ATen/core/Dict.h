@@ -247,7 +247,15 @@ public:
    * The Dict returned is a new dict with separate storage.
    * Changes in it are not reflected in the original dict or vice versa.
    */
-  Dict copy() const;
+  Dict copy() const &;
+
+  /**
+   * Same as above, but if this is the only Dict pointing to its storage,
+   * nobody can observe the difference between a copy and the original, so
+   * the storage is handed over to the returned Dict instead of being copied.
+   * This Dict is empty afterwards.
+   */
+  Dict copy() &&;
 
   /**
    * Returns an iterator to the first element of the container.
@@ -115,7 +115,15 @@ Dict<Key, Value>& Dict<Key, Value>::operator=(Dict&& rhs) noexcept {
 }
 
 template<class Key, class Value>
-Dict<Key, Value> Dict<Key, Value>::copy() const {
+Dict<Key, Value> Dict<Key, Value>::copy() const & {
+  return Dict<Key, Value>(impl_->copy());
+}
+
+template<class Key, class Value>
+Dict<Key, Value> Dict<Key, Value>::copy() && {
+  if (impl_.use_count() == 1) {
+    return Dict<Key, Value>(std::move(*this));
+  }
   return Dict<Key, Value>(impl_->copy());
 }
 
@@ -6,6 +6,7 @@
 #include <c10/util/intrusive_ptr.h>
 #include <c10/util/ArrayRef.h>
 #include <c10/util/Optional.h>
+#include <iterator>
 #include <vector>
 
 namespace at {
@@ -19,21 +20,12 @@ using TypePtr = std::shared_ptr<Type>;
 
 namespace detail {
 
-struct ListImpl final : public c10::intrusive_ptr_target {
-  using list_type = std::vector<IValue>;
-
-  explicit ListImpl(list_type list_, TypePtr elementType_)
-  : list(std::move(list_))
-  , elementType(std::move(elementType_)) {}
-
-  list_type list;
-
-  TypePtr elementType;
-
-  intrusive_ptr<ListImpl> copy() const {
-    return make_intrusive<ListImpl>(list, elementType);
-  }
-};
+// ListImpl is defined in ivalue_inl.h, because its inline element storage
+// needs the complete IValue type. It keeps the elements in a
+// c10::SmallVector<IValue, N>, whose iterators are plain pointers.
+struct ListImpl;
+using list_iterator = IValue*;
+using list_reverse_iterator = std::reverse_iterator<IValue*>;
 }
 
 namespace impl {
@@ -169,7 +161,7 @@ private:
     return lhs.iterator_ >= rhs.iterator_;
   }
 
-  friend class ListIterator<T, typename detail::ListImpl::list_type::iterator>;
+  friend class ListIterator<T, detail::list_iterator>;
   friend class List<T>;
 };
 
@@ -203,13 +195,13 @@ private:
   // ListImpl.
   c10::intrusive_ptr<detail::ListImpl> impl_;
 
-  using internal_reference_type = impl::ListElementReference<T, typename detail::ListImpl::list_type::iterator>;
+  using internal_reference_type = impl::ListElementReference<T, detail::list_iterator>;
 
 public:
   using value_type = T;
-  using size_type = typename detail::ListImpl::list_type::size_type;
-  using iterator = impl::ListIterator<T, typename detail::ListImpl::list_type::iterator>;
-  using reverse_iterator = impl::ListIterator<T, typename detail::ListImpl::list_type::reverse_iterator>;
+  using size_type = size_t;
+  using iterator = impl::ListIterator<T, detail::list_iterator>;
+  using reverse_iterator = impl::ListIterator<T, detail::list_reverse_iterator>;
 
   /**
    * Constructs an empty list.
@@ -241,7 +233,15 @@ public:
    * The List returned is a new list with separate storage.
    * Changes in it are not reflected in the original list or vice versa.
    */
-  List copy() const;
+  List copy() const &;
+
+  /**
+   * Same as above, but if this is the only List pointing to its storage,
+   * nobody can observe the difference between a copy and the original, so
+   * the storage is handed over to the returned List instead of being copied.
+   * This List is empty afterwards.
+   */
+  List copy() &&;
 
   /**
    * Returns the element at specified location pos, with bounds checking.
@@ -426,11 +426,6 @@ namespace impl {
 // public API. Kernels should use Lists with concrete types instead
 // (maybe except for some internal prim ops).
 using GenericList = List<IValue>;
-
-inline const IValue* ptr_to_first_element(const GenericList& list) {
-  return &list.impl_->list[0];
-}
-
 }
 }
 
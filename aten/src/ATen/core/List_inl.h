@@ -8,6 +8,24 @@ namespace c10 {
 template<class T> TypePtr getTypePtr();
 std::string toString(TypePtr typePtr);
 
+static_assert(
+    std::is_same<detail::ListImpl::list_type::iterator, detail::list_iterator>::value &&
+    std::is_same<detail::ListImpl::list_type::reverse_iterator, detail::list_reverse_iterator>::value,
+    "The iterator types declared in List.h don't match ListImpl::list_type");
+
+namespace detail {
+// c10::SmallVector::at() doesn't check its argument, but List promises
+// std::out_of_range for positions past the end.
+inline ListImpl::list_type::reference list_element_at(ListImpl::list_type& list, size_t pos) {
+  if (pos >= list.size()) {
+    throw std::out_of_range(
+        "List index " + c10::guts::to_string(pos) + " is out of range for a list of size " +
+        c10::guts::to_string(list.size()));
+  }
+  return list[pos];
+}
+}
+
 template<class T>
 List<T>::List(c10::intrusive_ptr<detail::ListImpl>&& elements)
 : impl_(std::move(elements)) {}
@@ -61,18 +79,26 @@ impl::GenericList toList(List<T> list) {
 
 template<class T>
 List<T>::List(List&& rhs) noexcept: impl_(std::move(rhs.impl_)) {
-  rhs.impl_ = make_intrusive<detail::ListImpl>(std::vector<IValue>{}, impl_->elementType);
+  rhs.impl_ = make_intrusive<detail::ListImpl>(detail::ListImpl::list_type(), impl_->elementType);
 }
 
 template<class T>
 List<T>& List<T>::operator=(List&& rhs) noexcept {
   impl_ = std::move(rhs.impl_);
-  rhs.impl_ = make_intrusive<detail::ListImpl>(std::vector<IValue>{}, impl_->elementType);
+  rhs.impl_ = make_intrusive<detail::ListImpl>(detail::ListImpl::list_type(), impl_->elementType);
   return *this;
 }
 
 template<class T>
-List<T> List<T>::copy() const {
+List<T> List<T>::copy() const & {
+  return List<T>(impl_->copy());
+}
+
+template<class T>
+List<T> List<T>::copy() && {
+  if (impl_.use_count() == 1) {
+    return List<T>(std::move(*this));
+  }
   return List<T>(impl_->copy());
 }
 
@@ -132,28 +158,28 @@ void swap(ListElementReference<T, Iterator>&& lhs, ListElementReference<T, Itera
 
 template<class T>
 void List<T>::set(size_type pos, const value_type& value) const {
-  impl_->list.at(pos) = detail::list_element_from<T>(value);
+  detail::list_element_at(impl_->list, pos) = detail::list_element_from<T>(value);
 }
 
 template<class T>
 void List<T>::set(size_type pos, value_type&& value) const {
-  impl_->list.at(pos) = detail::list_element_from<T>(std::move(value));
+  detail::list_element_at(impl_->list, pos) = detail::list_element_from<T>(std::move(value));
 }
 
 template<class T>
 typename List<T>::value_type List<T>::get(size_type pos) const {
-  return detail::list_element_to<T>(impl_->list.at(pos));
+  return detail::list_element_to<T>(detail::list_element_at(impl_->list, pos));
 }
 
 template<class T>
 typename List<T>::internal_reference_type List<T>::operator[](size_type pos) const {
-  static_cast<void>(impl_->list.at(pos)); // Throw the exception if it is out of range.
+  static_cast<void>(detail::list_element_at(impl_->list, pos)); // Throw the exception if it is out of range.
   return {impl_->list.begin() + pos};
 }
 
 template<class T>
 typename List<T>::value_type List<T>::extract(size_type pos) const {
-  auto& elem = impl_->list.at(pos);
+  auto& elem = detail::list_element_at(impl_->list, pos);
   auto result = detail::list_element_to<T>(std::move(elem));
   // Reset the list element to a T() instead of None to keep it correctly typed
   elem = detail::list_element_from<T>(T{});
@@ -203,8 +229,8 @@ typename List<T>::iterator List<T>::insert(iterator pos, T&& value) const {
 template<class T>
 template<class... Args>
 typename List<T>::iterator List<T>::emplace(iterator pos, Args&&... value) const {
-  // TODO Use list_element_from?
-  return iterator { impl_->list.emplace(pos.iterator_, std::forward<Args>(value)...) };
+  // c10::SmallVector has no emplace(), so construct the element in front
+  return iterator { impl_->list.insert(pos.iterator_, detail::list_element_from<T>(T(std::forward<Args>(value)...))) };
 }
 
 template<class T>
@@ -220,7 +246,7 @@ void List<T>::push_back(T&& value) const {
 template<class T>
 void List<T>::append(List<T> b) const {
   if (b.use_count() == 1) {
-    impl_->list.insert(impl_->list.end(), make_move_iterator(b.impl_->list.begin()), make_move_iterator(b.impl_->list.end()));
+    impl_->list.insert(impl_->list.end(), std::make_move_iterator(b.impl_->list.begin()), std::make_move_iterator(b.impl_->list.end()));
   } else {
     impl_->list.insert(impl_->list.end(), b.impl_->list.begin(), b.impl_->list.end());
   }
@@ -291,4 +317,10 @@ template <class T>
 void List<T>::unsafeSetElementType(TypePtr t) {
   impl_->elementType = std::move(t);
 }
+
+namespace impl {
+inline const IValue* ptr_to_first_element(const GenericList& list) {
+  return list.impl_->list.data();
+}
+}
 }
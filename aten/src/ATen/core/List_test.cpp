@@ -1055,6 +1055,44 @@ TEST(ListTest_NonIValueBasedList, copyHasSeparateStorage) {
   EXPECT_EQ(0, list3.size());
 }
 
+TEST(ListTest_NonIValueBasedList, givenUniqueList_whenCopyingRvalue_thenTakesOverStorage) {
+  List<int64_t> list1({3, 4});
+  List<int64_t> list2 = std::move(list1).copy();
+  EXPECT_EQ(0, list1.size());
+  ASSERT_EQ(2, list2.size());
+  EXPECT_EQ(3, list2.get(0));
+  EXPECT_EQ(4, list2.get(1));
+  EXPECT_EQ(1, list2.use_count());
+}
+
+TEST(ListTest_NonIValueBasedList, givenSharedList_whenCopyingRvalue_thenHasSeparateStorage) {
+  List<int64_t> list1({3, 4});
+  List<int64_t> alias = list1;
+  List<int64_t> list2 = std::move(list1).copy();
+
+  list2.push_back(5);
+  EXPECT_EQ(2, alias.size());
+  EXPECT_EQ(3, list2.size());
+  EXPECT_EQ(1, list2.use_count());
+}
+
+TEST(ListTest_NonIValueBasedList, givenListLargerThanInlineStorage_thenKeepsAllElements) {
+  List<int64_t> list;
+  for (int64_t i = 0; i < 100; ++i) {
+    list.push_back(i);
+  }
+  List<int64_t> copy = list.copy();
+  list.erase(list.begin(), list.begin() + 50);
+  ASSERT_EQ(50, list.size());
+  ASSERT_EQ(100, copy.size());
+  for (int64_t i = 0; i < 50; ++i) {
+    EXPECT_EQ(50 + i, list.get(i));
+  }
+  for (int64_t i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, copy.get(i));
+  }
+}
+
 TEST(ListTest_NonIValueBasedList, givenEqualLists_thenIsEqual) {
   List<int64_t> list1({1, 3});
   List<int64_t> list2({1, 3});
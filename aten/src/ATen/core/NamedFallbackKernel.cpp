@@ -0,0 +1,22 @@
+#include <ATen/core/dispatch/Dispatcher.h>
+
+/*
+ * Named tensors have DispatchKey::NamedTensorId in their key set (see
+ * TensorImpl::refresh_named_tensor_key). Operators propagate names in their
+ * regular kernels for now, so this key must not change which kernel is
+ * called: it falls through to the next key unless an operator registers a
+ * kernel for it. Unnamed tensors never have the key and are not affected.
+ */
+
+using c10::DispatchKey;
+using c10::Dispatcher;
+using c10::KernelFunction;
+
+namespace {
+
+static auto registry = Dispatcher::singleton().registerBackendFallbackKernel(
+    DispatchKey::NamedTensorId,
+    KernelFunction::makeFallthrough()
+);
+
+}
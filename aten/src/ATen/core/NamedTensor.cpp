@@ -103,6 +103,7 @@ void internal_set_names_inplace(TensorImpl* impl, optional<DimnameList> names, b
     impl->set_named_tensor_meta(std::make_unique<NamedTensorMeta>(*names));
   } else {
     meta->set_names(*names);
+    impl->refresh_named_tensor_key();
   }
 }
 
@@ -115,6 +116,7 @@ void internal_set_names_inplace(TensorImpl* impl, std::vector<Dimname>&& names,
     impl->set_named_tensor_meta(std::make_unique<NamedTensorMeta>(names));
   } else {
     meta->set_names(names);
+    impl->refresh_named_tensor_key();
   }
 }
 
@@ -135,11 +137,6 @@ DimnameList get_names(const TensorImpl* impl) {
   return default_names(impl->dim());
 }
 
-bool has_names(const TensorImpl* impl) {
-  const auto* named_tensor_meta = get_named_tensor_meta(impl);
-  return named_tensor_meta != nullptr && named_tensor_meta->has_names();
-}
-
 } // namespace impl
 
 } // namespace at
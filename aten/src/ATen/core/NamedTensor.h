@@ -29,7 +29,7 @@ struct CAFFE2_API NamedTensorMeta : public c10::NamedTensorMetaInterface {
     return std::make_unique<NamedTensorMeta>(names_);
   }
 
-  bool has_names() const;
+  bool has_names() const override;
   DimnameList names() const { return names_; }
 
   // Used for an assertion in TensorImpl.h
@@ -103,7 +103,16 @@ void check_names_valid_for(TensorImpl* impl, DimnameList names);
 // Returns false if the tensor's names don't exist (were not allocated),
 // or if all names are 'None'.
 // We treat not-allocated-names the same as allocated names that are all 'None'.
-CAFFE2_API bool has_names(const TensorImpl* impl);
+// This only tests DispatchKey::NamedTensorId in the tensor's key set.
+inline bool has_names(const TensorImpl* impl) {
+  return impl->key_set().has(DispatchKey::NamedTensorId) && NamesMode::is_enabled();
+}
+
+// Returns true if any tensor with a key set in `ks` has names, e.g.
+// has_names(a.key_set() | b.key_set()).
+inline bool has_names(DispatchKeySet ks) {
+  return ks.has(DispatchKey::NamedTensorId) && NamesMode::is_enabled();
+}
 
 // Returns the names of the tensor's dimensions.
 // Unnamed tensors are treated as having 'None' in all dimension; this method
@@ -57,8 +57,8 @@ Result boxAndCallBoxedFunc(KernelFunction::InternalBoxedKernelFunction* boxed_ke
 template<class Result, class... Args>
 std::enable_if_t<supports_boxing<Result, Args...>::value && !std::is_same<void, Result>::value, Result>
 boxAndCallBoxedFunc(KernelFunction::InternalBoxedKernelFunction* boxed_kernel_func, OperatorKernel* functor, const OperatorHandle& opHandle, Args... args) {
-  // TODO Reuse stack vector instead of allocating?
   torch::jit::Stack stack;
+  stack.reserve(sizeof...(Args));
   torch::jit::push(stack, std::forward<Args>(args)...);
 
   (*boxed_kernel_func)(functor, opHandle, &stack);
@@ -71,8 +71,8 @@ boxAndCallBoxedFunc(KernelFunction::InternalBoxedKernelFunction* boxed_kernel_fu
 template<class Result, class... Args>
 std::enable_if_t<supports_boxing<Result, Args...>::value && std::is_same<void, Result>::value, Result>
 boxAndCallBoxedFunc(KernelFunction::InternalBoxedKernelFunction* boxed_kernel_func, OperatorKernel* functor, const OperatorHandle& opHandle, Args... args) {
-  // TODO Reuse stack vector instead of allocating?
   torch::jit::Stack stack;
+  stack.reserve(sizeof...(Args));
   torch::jit::push(stack, std::forward<Args>(args)...);
 
   (*boxed_kernel_func)(functor, opHandle, &stack);
@@ -83,11 +83,20 @@ private:
  */
 class DispatchTable final {
  public:
-  explicit DispatchTable(const FunctionSchema& schema)
+  /**
+   * @param backendFallbackKernels The backend fallback kernels of the
+   *        dispatcher, which calls are resolved to when there is no kernel
+   *        for their dispatch key. It must outlive the table.
+   */
+  explicit DispatchTable(const FunctionSchema& schema, const impl::KernelFunctionTable& backendFallbackKernels)
   : kernels_()
   , catchallKernel_()
   , dispatchKeyExtractor_(DispatchKeyExtractor::make(schema))
-  , operatorName_(toString(schema.operator_name())) {}
+  , operatorName_(toString(schema.operator_name()))
+  , backendFallbackKernels_(&backendFallbackKernels)
+  , resolvedKernels_() {
+    updateResolvedKernels();
+  }
 
   /**
    * Register a kernel in the table at some dispatch key.
@@ -97,6 +106,7 @@ class DispatchTable final {
   void setKernel(DispatchKey dispatchKey, KernelFunction kernel) {
     auto result = kernels_.setKernel(dispatchKey, std::move(kernel));
     dispatchKeyExtractor_.setOperatorHasKernelForBackend(dispatchKey, true);
+    updateResolvedKernels();
     if (result == impl::KernelFunctionTable::SetKernelResult::OVERWROTE_EXISTING_KERNEL) {
       TORCH_WARN("Registered a kernel for operator ", operatorName_, " with dispatch key ", toString(dispatchKey), " that overwrote a previously registered kernel with the same dispatch key for the same operator.");
     }
@@ -110,6 +120,7 @@ class DispatchTable final {
   void removeKernelIfExists(DispatchKey dispatchKey) {
     kernels_.removeKernelIfExists(dispatchKey);
     dispatchKeyExtractor_.setOperatorHasKernelForBackend(dispatchKey, false);
+    updateResolvedKernels();
   }
 
   /**
@@ -123,6 +134,7 @@ class DispatchTable final {
       TORCH_WARN("Registered a catch-all kernel for operator ", operatorName_," that overwrote a previously registered catch-all kernel for the same operator.");
     }
     catchallKernel_ = std::move(kernel);
+    updateResolvedKernels();
   }
 
   /**
@@ -131,6 +143,7 @@ class DispatchTable final {
   void removeCatchallKernel() {
     TORCH_INTERNAL_ASSERT(catchallKernel_.isValid(), "Tried to remove the catch-all kernel for operator ", operatorName_," but there is no catch-all kernel registered.");
     catchallKernel_ = {};
+    updateResolvedKernels();
   }
 
   bool isEmpty() const {
@@ -180,6 +193,35 @@ class DispatchTable final {
     return &catchallKernel_;
   }
 
+  /**
+   * Returns the kernel that a call with the given dispatch key runs, or
+   * nullptr if there is none. That is the kernel for the dispatch key if
+   * there is one, else the backend fallback kernel for it, else the
+   * catch-all kernel. These are resolved whenever a kernel is registered,
+   * so that calls only need a single lookup.
+   */
+  const KernelFunction* lookupResolved(DispatchKey dispatchKey) const {
+    return resolvedKernels_[static_cast<uint8_t>(dispatchKey)];
+  }
+
+  /**
+   * Resolves the kernel of every dispatch key again. The dispatcher calls
+   * this when a backend fallback kernel is registered or deregistered.
+   */
+  void updateResolvedKernels() {
+    for (uint8_t iter = 0; iter != static_cast<uint8_t>(DispatchKey::NumDispatchKeys); ++iter) {
+      const auto dispatchKey = static_cast<DispatchKey>(iter);
+      const KernelFunction* kernel = lookup(dispatchKey);
+      if (kernel == nullptr && (*backendFallbackKernels_)[dispatchKey].isValid()) {
+        kernel = &(*backendFallbackKernels_)[dispatchKey];
+      }
+      if (kernel == nullptr) {
+        kernel = lookupCatchallKernel();
+      }
+      resolvedKernels_[iter] = kernel;
+    }
+  }
+
   const DispatchKeyExtractor& dispatchKeyExtractor() const {
     return dispatchKeyExtractor_;
   }
@@ -194,6 +236,8 @@ private:
   KernelFunction catchallKernel_;
   DispatchKeyExtractor dispatchKeyExtractor_;
   std::string operatorName_;
+  const impl::KernelFunctionTable* backendFallbackKernels_;
+  std::array<const KernelFunction*, static_cast<uint8_t>(DispatchKey::NumDispatchKeys)> resolvedKernels_;
 };
 
 } // namespace c10
@@ -76,7 +76,7 @@ OperatorHandle Dispatcher::findOrRegisterSchema_(FunctionSchema&& schema, Operat
   }
 
   OperatorName op_name = schema.operator_name();
-  operators_.emplace_back(std::move(schema), std::move(options));
+  operators_.emplace_back(std::move(schema), std::move(options), backendFallbackKernels_);
   OperatorHandle handle(--operators_.end());
   operatorLookupTable_.write([&] (ska::flat_hash_map<OperatorName, OperatorHandle>& operatorLookupTable) {
     operatorLookupTable.emplace(op_name, handle);
@@ -132,6 +132,7 @@ RegistrationHandleRAII Dispatcher::registerBackendFallbackKernel(DispatchKey dis
   if (kernel.isFallthrough()) {
     backendsWithoutFallthrough_ = backendsWithoutFallthrough_.remove(dispatchKey);
   }
+  updateBackendFallbackKernels_();
 
   return RegistrationHandleRAII([this, dispatchKey] {
     deregisterBackendFallbackKernel_(dispatchKey);
@@ -142,6 +143,14 @@ void Dispatcher::deregisterBackendFallbackKernel_(DispatchKey dispatchKey) {
   auto result = backendFallbackKernels_.removeKernelIfExists(dispatchKey);
   backendsWithoutFallthrough_ = backendsWithoutFallthrough_.add(dispatchKey);
   TORCH_INTERNAL_ASSERT(result == impl::KernelFunctionTable::RemoveKernelIfExistsResult::REMOVED_KERNEL, "Tried to deregister a backend fallback kernel for ", dispatchKey, " but there was none registered.");
+  updateBackendFallbackKernels_();
+}
+
+void Dispatcher::updateBackendFallbackKernels_() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& def : operators_) {
+    def.op.updateBackendFallbackKernels();
+  }
 }
 
 RegistrationHandleRAII Dispatcher::registerKernel(const OperatorHandle& op, DispatchKey dispatch_key, KernelFunction kernel) {
@@ -35,8 +35,8 @@ class SchemaRegistrationHandleRAII;
 class CAFFE2_API Dispatcher final {
 private:
   struct OperatorDef final {
-    explicit OperatorDef(FunctionSchema&& schema, OperatorOptions&& options)
-    : op(std::move(schema), std::move(options)), refcount(0) {}
+    explicit OperatorDef(FunctionSchema&& schema, OperatorOptions&& options, const impl::KernelFunctionTable& backendFallbackKernels)
+    : op(std::move(schema), std::move(options), backendFallbackKernels), refcount(0) {}
 
     impl::OperatorEntry op;
     size_t refcount;
@@ -122,6 +122,17 @@ public:
 
   void callBoxed(const OperatorHandle& op, Stack* stack) const;
 
+  /**
+   * Returns the kernel that is called for `op` and the given dispatch key,
+   * i.e. the kernel for that key, the backend fallback kernel or the
+   * catch-all kernel, or nullptr if there is none. This lets callers that
+   * always dispatch to the same key skip the dispatcher. The pointer stays
+   * valid while `op` is registered, but only points to the resolved kernel
+   * until kernels for `op` or backend fallback kernels are registered or
+   * deregistered.
+   */
+  const KernelFunction* lookupKernel(const OperatorHandle& op, DispatchKey dispatchKey) const;
+
   /**
    * Add a listener that gets called whenever a new op is registered or an existing
    * op is deregistered. Immediately after registering, this listener gets called
@@ -137,6 +148,7 @@ private:
 
   void deregisterSchema_(const OperatorHandle& op, const OperatorName& op_name);
   void deregisterBackendFallbackKernel_(DispatchKey dispatchKey);
+  void updateBackendFallbackKernels_();
   [[noreturn]] static void reportError(const DispatchTable& dispatchTable, DispatchKey dispatchKey);
 
   const KernelFunction& dispatch_(const DispatchTable& dispatchTable, DispatchKey dispatch_key) const;
@@ -222,21 +234,16 @@ inline void Dispatcher::callBoxed(const OperatorHandle& op, Stack* stack) const
   kernel.callBoxed(op, stack);
 }
 
-inline const KernelFunction& Dispatcher::dispatch_(const DispatchTable& dispatchTable, DispatchKey dispatchKey) const {
-  const KernelFunction* backendKernel = dispatchTable.lookup(dispatchKey);
-
-  if (nullptr != backendKernel) {
-    return *backendKernel;
-  }
-
-  const auto& backendFallbackKernel = backendFallbackKernels_[dispatchKey];
-  if (backendFallbackKernel.isValid()) {
-    return backendFallbackKernel;
-  }
+inline const KernelFunction* Dispatcher::lookupKernel(const OperatorHandle& op, DispatchKey dispatchKey) const {
+  return op.operatorIterator_->op.dispatch_table().lookupResolved(dispatchKey);
+}
 
-  const KernelFunction* catchallKernel = dispatchTable.lookupCatchallKernel();
-  if (C10_LIKELY(nullptr != catchallKernel)) {
-    return *catchallKernel;
+inline const KernelFunction& Dispatcher::dispatch_(const DispatchTable& dispatchTable, DispatchKey dispatchKey) const {
+  // the kernel for the dispatch key, the backend fallback kernel or the
+  // catch-all kernel, as resolved by the dispatch table at registration time
+  const KernelFunction* kernel = dispatchTable.lookupResolved(dispatchKey);
+  if (C10_LIKELY(nullptr != kernel)) {
+    return *kernel;
   }
 
   reportError(dispatchTable, dispatchKey);
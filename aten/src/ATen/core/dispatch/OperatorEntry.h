@@ -16,7 +16,7 @@ namespace impl {
 // and its dispatch table. This is not part of the public API.
 class OperatorEntry final {
 public:
-  explicit OperatorEntry(FunctionSchema&& schema, OperatorOptions&& options);
+  explicit OperatorEntry(FunctionSchema&& schema, OperatorOptions&& options, const KernelFunctionTable& backendFallbackKernels);
 
   OperatorEntry(const OperatorEntry&) = delete;
   OperatorEntry(OperatorEntry&&) noexcept = delete;
@@ -36,6 +36,9 @@ public:
   RegistrationHandleRAII registerKernel(DispatchKey dispatch_key, KernelFunction kernel);
   RegistrationHandleRAII registerCatchallKernel(KernelFunction kernel);
 
+  // Called by the dispatcher when its backend fallback kernels changed
+  void updateBackendFallbackKernels();
+
   const OperatorOptions& options() {
     return options_;
   }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <c10/core/InferenceMode.h>
+#include <c10/core/impl/LocalDispatchKeySet.h>
 #include <c10/macros/Macros.h>
 
 namespace at {
@@ -27,4 +29,29 @@ struct CAFFE2_API NoGradGuard : public AutoGradMode {
   NoGradGuard() : AutoGradMode(/*enabled=*/false) {}
 };
 
+// A RAII, thread local (!) guard for code that only runs inference. Unlike
+// NoGradGuard, which still goes through the Variable kernels of every op, it
+// also excludes VariableTensorId from dispatch, so ops go straight to their
+// backend kernels. Tensors created under it are inference tensors (see
+// TensorImpl::is_inference()) and cannot be made to require grad later.
+// As version counters are not bumped under the guard, ops may only write into
+// tensors whose storage was created under it (see
+// at::impl::check_inplace_in_inference_mode).
+struct CAFFE2_API InferenceModeGuard {
+  InferenceModeGuard()
+      : grad_mode_(/*enabled=*/false),
+        variable_guard_(c10::DispatchKey::VariableTensorId),
+        prev_mode_(c10::InferenceMode::is_enabled()) {
+    c10::InferenceMode::set_enabled(true);
+  }
+  ~InferenceModeGuard() {
+    c10::InferenceMode::set_enabled(prev_mode_);
+  }
+
+ private:
+  AutoGradMode grad_mode_;
+  c10::impl::ExcludeDispatchKeyGuard variable_guard_;
+  bool prev_mode_;
+};
+
 }
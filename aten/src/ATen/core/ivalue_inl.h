@@ -8,7 +8,36 @@
 #include <c10/core/Scalar.h>
 #include <c10/core/TensorImpl.h>
 #include <c10/core/UndefinedTensorImpl.h>
+#include <c10/util/SmallVector.h>
 #include <ATen/core/Dict.h>
+
+namespace c10 {
+namespace detail {
+
+// The storage behind c10::List. Lists in TorchScript programs are mostly
+// short (sizes, lists of tensors passed to cat or returned from chunk), so
+// the first few elements live inline and such a list only takes a single
+// allocation. This has to come before List.h's inline definitions and
+// after IValue is complete, which is why it lives here.
+struct ListImpl final : public c10::intrusive_ptr_target {
+  static constexpr unsigned kInlineElements = 4;
+  using list_type = c10::SmallVector<IValue, kInlineElements>;
+
+  explicit ListImpl(list_type list_, TypePtr elementType_)
+  : list(std::move(list_))
+  , elementType(std::move(elementType_)) {}
+
+  list_type list;
+
+  TypePtr elementType;
+
+  intrusive_ptr<ListImpl> copy() const {
+    return make_intrusive<ListImpl>(list, elementType);
+  }
+};
+} // namespace detail
+} // namespace c10
+
 #include <ATen/core/List.h>
 
 namespace torch {
@@ -838,7 +867,7 @@ template<class T> struct has_constructor<
 
 template <typename T>
 IValue from_(T x, std::true_type) {
-  return IValue(x);
+  return IValue(std::move(x));
 }
 template <typename T>
 IValue from_(c10::intrusive_ptr<T> x, std::false_type) {
@@ -863,7 +892,7 @@ IValue from_(T x, std::false_type) {
 
 template <typename T>
 IValue from(T x) {
-  return detail::from_(x, detail::has_constructor<T>{});
+  return detail::from_(std::move(x), detail::has_constructor<T>{});
 }
 
 }
@@ -1,3 +1,5 @@
+#pragma once
+
 // WARNING! WARNING! WARNING!
 // This file is a temporary hack to enable development of pytorch quantization
 //
@@ -0,0 +1,37 @@
+#pragma once
+
+// Selects the widest Vec type the current CPU_CAPABILITY build supports, so
+// that kernels written against it get 512-bit vectors in the AVX512 build of
+// native/cpu and 256-bit ones otherwise:
+//
+//   using Vec = vec::Vectorized<scalar_t>;
+//   vec::map([](Vec x) { return x.exp(); }, out, in, size);
+//
+// The other functions and types of vec256 (or vec512) are available in
+// at::vec too, e.g. vec::maximum.
+
+#if defined(CPU_CAPABILITY_AVX512)
+#include <ATen/cpu/vec512/functional.h>
+#include <ATen/cpu/vec512/vec512.h>
+#else
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec256/vec256.h>
+#endif
+
+namespace at {
+namespace vec {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+#if defined(CPU_CAPABILITY_AVX512)
+using namespace vec512;
+template <typename T>
+using Vectorized = Vec512<T>;
+#else
+using namespace vec256;
+template <typename T>
+using Vectorized = Vec256<T>;
+#endif
+
+} // namespace
+}} // namespace at::vec
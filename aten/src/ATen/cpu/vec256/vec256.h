@@ -4,8 +4,11 @@
 
 #include <ATen/cpu/vec256/vec256_base.h>
 #include <ATen/cpu/vec256/vec256_float.h>
+#include <ATen/cpu/vec256/vec256_float_neon.h>
+#include <ATen/cpu/vec256/vec256_bfloat16.h>
 #include <ATen/cpu/vec256/vec256_double.h>
 #include <ATen/cpu/vec256/vec256_int.h>
+#include <ATen/cpu/vec256/vec256_int_neon.h>
 #include <ATen/cpu/vec256/vec256_qint.h>
 #include <ATen/cpu/vec256/vec256_complex_float.h>
 #include <ATen/cpu/vec256/vec256_complex_double.h>
@@ -221,8 +224,135 @@ inline deinterleave2<float>(const Vec256<float>& a, const Vec256<float>& b) {
                         _mm256_permute2f128_ps(a_grouped, b_grouped, 0b0110001)); // 1, 3.   4 bits apart
 }
 
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ TRANSPOSE ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+template <>
+inline void transpose_block<double>(const double* src, int64_t ld_src, double* dst, int64_t ld_dst) {
+  // rows a, b, c, d:
+  //   t0 = {a0, b0, a2, b2}, t1 = {a1, b1, a3, b3}
+  //   t2 = {c0, d0, c2, d2}, t3 = {c1, d1, c3, d3}
+  __m256d r0 = _mm256_loadu_pd(src);
+  __m256d r1 = _mm256_loadu_pd(src + ld_src);
+  __m256d r2 = _mm256_loadu_pd(src + 2 * ld_src);
+  __m256d r3 = _mm256_loadu_pd(src + 3 * ld_src);
+  __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+  __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+  __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+  __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+
+  // swap lanes:
+  //   {a0, b0, c0, d0}, {a1, b1, c1, d1}, {a2, b2, c2, d2}, {a3, b3, c3, d3}
+  _mm256_storeu_pd(dst, _mm256_permute2f128_pd(t0, t2, 0x20));
+  _mm256_storeu_pd(dst + ld_dst, _mm256_permute2f128_pd(t1, t3, 0x20));
+  _mm256_storeu_pd(dst + 2 * ld_dst, _mm256_permute2f128_pd(t0, t2, 0x31));
+  _mm256_storeu_pd(dst + 3 * ld_dst, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+template <>
+inline void transpose_block<float>(const float* src, int64_t ld_src, float* dst, int64_t ld_dst) {
+  // rows a, b, ..., h:
+  //   t0 = {a0, b0, a1, b1, a4, b4, a5, b5}, t1 = {a2, b2, a3, b3, a6, b6, a7, b7}
+  //   and the same for rows c and d (t2, t3), e and f (t4, t5), g and h (t6, t7)
+  __m256 t0 = _mm256_unpacklo_ps(_mm256_loadu_ps(src), _mm256_loadu_ps(src + ld_src));
+  __m256 t1 = _mm256_unpackhi_ps(_mm256_loadu_ps(src), _mm256_loadu_ps(src + ld_src));
+  __m256 t2 = _mm256_unpacklo_ps(_mm256_loadu_ps(src + 2 * ld_src), _mm256_loadu_ps(src + 3 * ld_src));
+  __m256 t3 = _mm256_unpackhi_ps(_mm256_loadu_ps(src + 2 * ld_src), _mm256_loadu_ps(src + 3 * ld_src));
+  __m256 t4 = _mm256_unpacklo_ps(_mm256_loadu_ps(src + 4 * ld_src), _mm256_loadu_ps(src + 5 * ld_src));
+  __m256 t5 = _mm256_unpackhi_ps(_mm256_loadu_ps(src + 4 * ld_src), _mm256_loadu_ps(src + 5 * ld_src));
+  __m256 t6 = _mm256_unpacklo_ps(_mm256_loadu_ps(src + 6 * ld_src), _mm256_loadu_ps(src + 7 * ld_src));
+  __m256 t7 = _mm256_unpackhi_ps(_mm256_loadu_ps(src + 6 * ld_src), _mm256_loadu_ps(src + 7 * ld_src));
+
+  // columns of 4 rows within lanes:
+  //   s0 = {a0, b0, c0, d0, a4, b4, c4, d4}, s1 = {a1, b1, c1, d1, a5, b5, c5, d5}
+  //   s2 = {a2, b2, c2, d2, a6, b6, c6, d6}, s3 = {a3, b3, c3, d3, a7, b7, c7, d7}
+  //   and the same for rows e to h (s4 to s7)
+  __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+  __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+  __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+  // swap lanes:
+  //   {a0, b0, c0, d0, e0, f0, g0, h0}, ..., {a7, b7, c7, d7, e7, f7, g7, h7}
+  _mm256_storeu_ps(dst, _mm256_permute2f128_ps(s0, s4, 0x20));
+  _mm256_storeu_ps(dst + ld_dst, _mm256_permute2f128_ps(s1, s5, 0x20));
+  _mm256_storeu_ps(dst + 2 * ld_dst, _mm256_permute2f128_ps(s2, s6, 0x20));
+  _mm256_storeu_ps(dst + 3 * ld_dst, _mm256_permute2f128_ps(s3, s7, 0x20));
+  _mm256_storeu_ps(dst + 4 * ld_dst, _mm256_permute2f128_ps(s0, s4, 0x31));
+  _mm256_storeu_ps(dst + 5 * ld_dst, _mm256_permute2f128_ps(s1, s5, 0x31));
+  _mm256_storeu_ps(dst + 6 * ld_dst, _mm256_permute2f128_ps(s2, s6, 0x31));
+  _mm256_storeu_ps(dst + 7 * ld_dst, _mm256_permute2f128_ps(s3, s7, 0x31));
+}
+
 #endif  // defined(__AVX2__)
 
 #endif // defined(__AVX__) && !defined(_MSC_VER)
 
+#if defined(__aarch64__)
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ CAST (NEON) ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+template<>
+inline Vec256<int32_t> cast<int32_t, float>(const Vec256<float>& src) {
+  return Vec256<int32_t>(vreinterpretq_s32_f32(src.get_low()),
+                         vreinterpretq_s32_f32(src.get_high()));
+}
+
+template<>
+inline Vec256<float> cast<float, int32_t>(const Vec256<int32_t>& src) {
+  return Vec256<float>(vreinterpretq_f32_s32(src.get_low()),
+                       vreinterpretq_f32_s32(src.get_high()));
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ CONVERT (NEON) ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+template<>
+Vec256<int32_t>
+inline convert_to_int_of_same_size<float>(const Vec256<float> &src) {
+  // Truncates, like _mm256_cvttps_epi32.
+  return Vec256<int32_t>(vcvtq_s32_f32(src.get_low()),
+                         vcvtq_s32_f32(src.get_high()));
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ INTERLEAVE (NEON) ~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+template <>
+std::pair<Vec256<float>, Vec256<float>>
+inline interleave2<float>(const Vec256<float>& a, const Vec256<float>& b) {
+  // inputs:
+  //   a = {a0, a1, a2, a3, a4, a5, a6, a7}
+  //   b = {b0, b1, b2, b3, b4, b5, b6, b7}
+  // returns:
+  //       {a0, b0, a1, b1, a2, b2, a3, b3}
+  //       {a4, b4, a5, b5, a6, b6, a7, b7}
+  return std::make_pair(
+      Vec256<float>(vzip1q_f32(a.get_low(), b.get_low()),
+                    vzip2q_f32(a.get_low(), b.get_low())),
+      Vec256<float>(vzip1q_f32(a.get_high(), b.get_high()),
+                    vzip2q_f32(a.get_high(), b.get_high())));
+}
+
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~ DEINTERLEAVE (NEON) ~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+template <>
+std::pair<Vec256<float>, Vec256<float>>
+inline deinterleave2<float>(const Vec256<float>& a, const Vec256<float>& b) {
+  // inputs:
+  //   a = {a0, b0, a1, b1, a2, b2, a3, b3}
+  //   b = {a4, b4, a5, b5, a6, b6, a7, b7}
+  // returns:
+  //       {a0, a1, a2, a3, a4, a5, a6, a7}
+  //       {b0, b1, b2, b3, b4, b5, b6, b7}
+  return std::make_pair(
+      Vec256<float>(vuzp1q_f32(a.get_low(), a.get_high()),
+                    vuzp1q_f32(b.get_low(), b.get_high())),
+      Vec256<float>(vuzp2q_f32(a.get_low(), a.get_high()),
+                    vuzp2q_f32(b.get_low(), b.get_high())));
+}
+
+#endif // defined(__aarch64__)
+
 }}}
@@ -733,6 +733,34 @@ interleave2(const Vec256<T>& a, const Vec256<T>& b) {
                         Vec256<T>::loadu(static_cast<void*>(buffer2)));
 }
 
+// Reverses the order of the elements of a vector.
+// E.g., inputs: a           Vec256<float>   = {a0, a1, a2, a3, a4, a5, a6, a7}
+//       returns:            Vec256<float>   = {a7, a6, a5, a4, a3, a2, a1, a0}
+template <typename T>
+inline Vec256<T> flip(const Vec256<T>& a) {
+  static constexpr int size = Vec256<T>::size();
+  T a_arr[size];
+  T buffer[size];
+  a.store(static_cast<void*>(a_arr));
+  for (int64_t i = 0; i < size; i++) {
+    buffer[i] = a_arr[size - 1 - i];
+  }
+  return Vec256<T>::loadu(static_cast<void*>(buffer));
+}
+
+// Transposes the Vec256<T>::size() x Vec256<T>::size() block at `src`, whose
+// rows are `ld_src` elements apart, into `dst`, whose rows are `ld_dst`
+// elements apart: dst[j * ld_dst + i] = src[i * ld_src + j].
+template <typename T>
+inline void transpose_block(const T* src, int64_t ld_src, T* dst, int64_t ld_dst) {
+  static constexpr int size = Vec256<T>::size();
+  for (int64_t i = 0; i < size; i++) {
+    for (int64_t j = 0; j < size; j++) {
+      dst[j * ld_dst + i] = src[i * ld_src + j];
+    }
+  }
+}
+
 template <typename src_T, typename dst_T>
 inline void convert(const src_T *src, dst_T *dst, int64_t n) {
 #ifndef _MSC_VER
@@ -0,0 +1,474 @@
+#pragma once
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256_base.h>
+#if defined(__AVX2__) && !defined(_MSC_VER)
+#include <sleef.h>
+#endif
+
+#include <tuple>
+
+namespace at {
+namespace vec256 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+#if defined(__AVX2__) && !defined(_MSC_VER)
+
+// Vec256<BFloat16> holds 16 bfloat16 values. There is no bfloat16 arithmetic
+// on AVX2, so every operation widens both halves to Vec256<float>, computes in
+// fp32 and rounds the result back to bfloat16 (round to nearest even, like
+// the c10::BFloat16 constructor). Only sign and bitwise operations act on the
+// raw bits.
+
+static inline __m256 cvtbf16_fp32(const __m128i& a) {
+  // bfloat16 is the upper half of an fp32 with the same bits.
+  return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(a), 16));
+}
+
+static inline void cvtbf16_fp32(const __m256i& a, __m256& o1, __m256& o2) {
+  o1 = cvtbf16_fp32(_mm256_extractf128_si256(a, 0));
+  o2 = cvtbf16_fp32(_mm256_extractf128_si256(a, 1));
+}
+
+static inline __m256i round_fp32_bf16(const __m256& a) {
+  // Same as c10::detail::round_to_nearest_even, as 32bit lanes:
+  //   bias = ((bits >> 16) & 1) + 0x7fff; bf16 = (bits + bias) >> 16
+  // with NaN mapped to 0x7fc0.
+  auto bits = _mm256_castps_si256(a);
+  auto lsb = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+  auto bias = _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7fff));
+  auto rounded = _mm256_srli_epi32(_mm256_add_epi32(bits, bias), 16);
+  auto ordered = _mm256_castps_si256(_mm256_cmp_ps(a, a, _CMP_ORD_Q));
+  return _mm256_blendv_epi8(_mm256_set1_epi32(0x7fc0), rounded, ordered);
+}
+
+static inline __m256i cvtfp32_bf16(const __m256& a, const __m256& b) {
+  auto lo = round_fp32_bf16(a);
+  auto hi = round_fp32_bf16(b);
+  // packus works within 128bit lanes, giving a[0:4] b[0:4] a[4:8] b[4:8];
+  // the permute puts the 64bit quarters back in order.
+  return _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xd8);
+}
+
+static inline __m256i merge_compare_result(const __m256& a, const __m256& b) {
+  // The fp32 masks are 0 or -1, which packs saturates to 16bit 0 or -1.
+  auto packed = _mm256_packs_epi32(_mm256_castps_si256(a), _mm256_castps_si256(b));
+  return _mm256_permute4x64_epi64(packed, 0xd8);
+}
+
+template <> class Vec256<BFloat16> {
+private:
+  __m256i values;
+public:
+  using value_type = BFloat16;
+  static constexpr int size() {
+    return 16;
+  }
+  Vec256() {}
+  Vec256(__m256i v) : values(v) {}
+  Vec256(BFloat16 val) {
+    values = _mm256_set1_epi16(val.x);
+  }
+  Vec256(BFloat16 val1, BFloat16 val2, BFloat16 val3, BFloat16 val4,
+         BFloat16 val5, BFloat16 val6, BFloat16 val7, BFloat16 val8,
+         BFloat16 val9, BFloat16 val10, BFloat16 val11, BFloat16 val12,
+         BFloat16 val13, BFloat16 val14, BFloat16 val15, BFloat16 val16) {
+    values = _mm256_setr_epi16(
+        val1.x, val2.x, val3.x, val4.x, val5.x, val6.x, val7.x, val8.x,
+        val9.x, val10.x, val11.x, val12.x, val13.x, val14.x, val15.x, val16.x);
+  }
+  operator __m256i() const {
+    return values;
+  }
+  template <int64_t mask>
+  static Vec256<BFloat16> blend(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+    __at_align32__ int16_t tmp_values[size()];
+    __at_align32__ int16_t b_values[size()];
+    a.store(tmp_values);
+    b.store(b_values);
+    for (int i = 0; i < size(); i++) {
+      if (mask & (1LL << i)) {
+        tmp_values[i] = b_values[i];
+      }
+    }
+    return loadu(tmp_values);
+  }
+  static Vec256<BFloat16> blendv(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b,
+                                 const Vec256<BFloat16>& mask) {
+    // Masks from the comparisons are 0 or -1 in each 16bit lane, so the
+    // bytewise blend selects whole elements.
+    return _mm256_blendv_epi8(a.values, b.values, mask.values);
+  }
+  static Vec256<BFloat16> arange(BFloat16 base = 0.f, BFloat16 step = 1.f) {
+    __at_align32__ BFloat16 tmp_values[size()];
+    for (int i = 0; i < size(); i++) {
+      tmp_values[i] = static_cast<float>(base) + i * static_cast<float>(step);
+    }
+    return loadu(tmp_values);
+  }
+  static Vec256<BFloat16> set(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b,
+                              int64_t count = size()) {
+    if (count <= 0) {
+      return a;
+    } else if (count >= size()) {
+      return b;
+    }
+    __at_align32__ BFloat16 tmp_values[size()];
+    __at_align32__ BFloat16 b_values[size()];
+    a.store(tmp_values);
+    b.store(b_values);
+    std::memcpy(tmp_values, b_values, count * sizeof(BFloat16));
+    return loadu(tmp_values);
+  }
+  static Vec256<BFloat16> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size())
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    __at_align32__ int16_t tmp_values[size()];
+    // Ensure uninitialized memory does not change the output value
+    // See https://github.com/pytorch/pytorch/issues/32502 for more details
+    for (auto i = 0; i < size(); ++i) {
+      tmp_values[i] = 0;
+    }
+    std::memcpy(tmp_values, ptr, count * sizeof(BFloat16));
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tmp_values));
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), values);
+    } else if (count > 0) {
+      __at_align32__ int16_t tmp_values[size()];
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(tmp_values), values);
+      std::memcpy(ptr, tmp_values, count * sizeof(BFloat16));
+    }
+  }
+  const BFloat16& operator[](int idx) const  = delete;
+  BFloat16& operator[](int idx) = delete;
+  // Applies an fp32 vector op to both halves.
+  template <typename Op>
+  Vec256<BFloat16> map(const Op& vop) const {
+    __m256 lo, hi;
+    cvtbf16_fp32(values, lo, hi);
+    return cvtfp32_bf16(vop(lo), vop(hi));
+  }
+  template <typename Op>
+  Vec256<BFloat16> map(const Op& vop, const Vec256<BFloat16>& b) const {
+    __m256 lo, hi, b_lo, b_hi;
+    cvtbf16_fp32(values, lo, hi);
+    cvtbf16_fp32(b.values, b_lo, b_hi);
+    return cvtfp32_bf16(vop(lo, b_lo), vop(hi, b_hi));
+  }
+  Vec256<BFloat16> map(float (*f)(float)) const {
+    __at_align32__ float tmp[size()];
+    __m256 lo, hi;
+    cvtbf16_fp32(values, lo, hi);
+    _mm256_storeu_ps(tmp, lo);
+    _mm256_storeu_ps(tmp + 8, hi);
+    for (int64_t i = 0; i < size(); i++) {
+      tmp[i] = f(tmp[i]);
+    }
+    return cvtfp32_bf16(_mm256_loadu_ps(tmp), _mm256_loadu_ps(tmp + 8));
+  }
+  Vec256<BFloat16> abs() const {
+    return _mm256_andnot_si256(_mm256_set1_epi16(0x8000), values);
+  }
+  Vec256<BFloat16> angle() const {
+    return _mm256_set1_epi16(0);
+  }
+  Vec256<BFloat16> real() const {
+    return *this;
+  }
+  Vec256<BFloat16> imag() const {
+    return _mm256_set1_epi16(0);
+  }
+  Vec256<BFloat16> conj() const {
+    return *this;
+  }
+  Vec256<BFloat16> acos() const {
+    return map(Sleef_acosf8_u10);
+  }
+  Vec256<BFloat16> asin() const {
+    return map(Sleef_asinf8_u10);
+  }
+  Vec256<BFloat16> atan() const {
+    return map(Sleef_atanf8_u10);
+  }
+  Vec256<BFloat16> atan2(const Vec256<BFloat16> &b) const {
+    return map(Sleef_atan2f8_u10, b);
+  }
+  Vec256<BFloat16> erf() const {
+    return map(Sleef_erff8_u10);
+  }
+  Vec256<BFloat16> erfc() const {
+    return map(Sleef_erfcf8_u15);
+  }
+  Vec256<BFloat16> erfinv() const {
+    return map(calc_erfinv);
+  }
+  Vec256<BFloat16> exp() const {
+    return map(Sleef_expf8_u10);
+  }
+  Vec256<BFloat16> expm1() const {
+    return map(Sleef_expm1f8_u10);
+  }
+  Vec256<BFloat16> log() const {
+    return map(Sleef_logf8_u10);
+  }
+  Vec256<BFloat16> log2() const {
+    return map(Sleef_log2f8_u10);
+  }
+  Vec256<BFloat16> log10() const {
+    return map(Sleef_log10f8_u10);
+  }
+  Vec256<BFloat16> log1p() const {
+    return map(Sleef_log1pf8_u10);
+  }
+  Vec256<BFloat16> frac() const {
+    return map([](__m256 x) {
+      return _mm256_sub_ps(x, _mm256_round_ps(x, (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC)));
+    });
+  }
+  Vec256<BFloat16> sin() const {
+    return map(Sleef_sinf8_u10);
+  }
+  Vec256<BFloat16> sinh() const {
+    return map(Sleef_sinhf8_u10);
+  }
+  Vec256<BFloat16> cos() const {
+    return map(Sleef_cosf8_u10);
+  }
+  Vec256<BFloat16> cosh() const {
+    return map(Sleef_coshf8_u10);
+  }
+  Vec256<BFloat16> ceil() const {
+    return map([](__m256 x) { return _mm256_ceil_ps(x); });
+  }
+  Vec256<BFloat16> floor() const {
+    return map([](__m256 x) { return _mm256_floor_ps(x); });
+  }
+  Vec256<BFloat16> neg() const {
+    return _mm256_xor_si256(_mm256_set1_epi16(0x8000), values);
+  }
+  Vec256<BFloat16> round() const {
+    return map([](__m256 x) {
+      return _mm256_round_ps(x, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    });
+  }
+  Vec256<BFloat16> tan() const {
+    return map(Sleef_tanf8_u10);
+  }
+  Vec256<BFloat16> tanh() const {
+    return map(Sleef_tanhf8_u10);
+  }
+  Vec256<BFloat16> trunc() const {
+    return map([](__m256 x) {
+      return _mm256_round_ps(x, (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+    });
+  }
+  Vec256<BFloat16> lgamma() const {
+    return map(Sleef_lgammaf8_u10);
+  }
+  Vec256<BFloat16> sqrt() const {
+    return map([](__m256 x) { return _mm256_sqrt_ps(x); });
+  }
+  Vec256<BFloat16> reciprocal() const {
+    return map([](__m256 x) { return _mm256_div_ps(_mm256_set1_ps(1), x); });
+  }
+  Vec256<BFloat16> rsqrt() const {
+    return map([](__m256 x) {
+      return _mm256_div_ps(_mm256_set1_ps(1), _mm256_sqrt_ps(x));
+    });
+  }
+  Vec256<BFloat16> pow(const Vec256<BFloat16> &b) const {
+    return map(Sleef_powf8_u10, b);
+  }
+  // Comparisons are done in fp32 with the same _CMP_**_OQ predicates as
+  // Vec256<float>, and return all-ones 16bit lanes where true.
+#define DEFINE_BF16_COMP(binary_pred, cmp)                                     \
+  Vec256<BFloat16> operator binary_pred(const Vec256<BFloat16>& other) const { \
+    __m256 lo, hi, other_lo, other_hi;                                         \
+    cvtbf16_fp32(values, lo, hi);                                              \
+    cvtbf16_fp32(other.values, other_lo, other_hi);                            \
+    return merge_compare_result(                                               \
+        _mm256_cmp_ps(lo, other_lo, cmp), _mm256_cmp_ps(hi, other_hi, cmp));   \
+  }
+  DEFINE_BF16_COMP(==, _CMP_EQ_OQ)
+  DEFINE_BF16_COMP(!=, _CMP_NEQ_OQ)
+  DEFINE_BF16_COMP(<, _CMP_LT_OQ)
+  DEFINE_BF16_COMP(<=, _CMP_LE_OQ)
+  DEFINE_BF16_COMP(>, _CMP_GT_OQ)
+  DEFINE_BF16_COMP(>=, _CMP_GE_OQ)
+#undef DEFINE_BF16_COMP
+};
+
+template <typename Op>
+Vec256<BFloat16> inline binary_op_as_fp32(const Vec256<BFloat16>& a,
+                                          const Vec256<BFloat16>& b, const Op& op) {
+  __m256 a_lo, a_hi, b_lo, b_hi;
+  cvtbf16_fp32(a, a_lo, a_hi);
+  cvtbf16_fp32(b, b_lo, b_hi);
+  return cvtfp32_bf16(op(a_lo, b_lo), op(a_hi, b_hi));
+}
+
+template <>
+Vec256<BFloat16> inline operator+(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](__m256 x, __m256 y) { return _mm256_add_ps(x, y); });
+}
+
+template <>
+Vec256<BFloat16> inline operator-(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](__m256 x, __m256 y) { return _mm256_sub_ps(x, y); });
+}
+
+template <>
+Vec256<BFloat16> inline operator*(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](__m256 x, __m256 y) { return _mm256_mul_ps(x, y); });
+}
+
+template <>
+Vec256<BFloat16> inline operator/(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](__m256 x, __m256 y) { return _mm256_div_ps(x, y); });
+}
+
+// Implements the IEEE 754 201X `maximum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vec256<BFloat16> inline maximum(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](__m256 x, __m256 y) {
+    auto max = _mm256_max_ps(x, y);
+    auto isnan = _mm256_cmp_ps(x, y, _CMP_UNORD_Q);
+    // Exploit the fact that all-ones is a NaN.
+    return _mm256_or_ps(max, isnan);
+  });
+}
+
+// Implements the IEEE 754 201X `minimum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vec256<BFloat16> inline minimum(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](__m256 x, __m256 y) {
+    auto min = _mm256_min_ps(x, y);
+    auto isnan = _mm256_cmp_ps(x, y, _CMP_UNORD_Q);
+    // Exploit the fact that all-ones is a NaN.
+    return _mm256_or_ps(min, isnan);
+  });
+}
+
+template <>
+Vec256<BFloat16> inline clamp(const Vec256<BFloat16>& a,
+                              const Vec256<BFloat16>& min, const Vec256<BFloat16>& max) {
+  __m256 a_lo, a_hi, min_lo, min_hi, max_lo, max_hi;
+  cvtbf16_fp32(a, a_lo, a_hi);
+  cvtbf16_fp32(min, min_lo, min_hi);
+  cvtbf16_fp32(max, max_lo, max_hi);
+  return cvtfp32_bf16(_mm256_min_ps(max_lo, _mm256_max_ps(min_lo, a_lo)),
+                      _mm256_min_ps(max_hi, _mm256_max_ps(min_hi, a_hi)));
+}
+
+template <>
+Vec256<BFloat16> inline clamp_max(const Vec256<BFloat16>& a, const Vec256<BFloat16>& max) {
+  return binary_op_as_fp32(max, a, [](__m256 x, __m256 y) { return _mm256_min_ps(x, y); });
+}
+
+template <>
+Vec256<BFloat16> inline clamp_min(const Vec256<BFloat16>& a, const Vec256<BFloat16>& min) {
+  return binary_op_as_fp32(min, a, [](__m256 x, __m256 y) { return _mm256_max_ps(x, y); });
+}
+
+template <>
+Vec256<BFloat16> inline operator&(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return _mm256_and_si256(a, b);
+}
+
+template <>
+Vec256<BFloat16> inline operator|(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return _mm256_or_si256(a, b);
+}
+
+template <>
+Vec256<BFloat16> inline operator^(const Vec256<BFloat16>& a, const Vec256<BFloat16>& b) {
+  return _mm256_xor_si256(a, b);
+}
+
+// Rounds once, unlike the a * b + c of the generic fmadd.
+template <>
+Vec256<BFloat16> inline fmadd(const Vec256<BFloat16>& a,
+                              const Vec256<BFloat16>& b, const Vec256<BFloat16>& c) {
+  __m256 a_lo, a_hi, b_lo, b_hi, c_lo, c_hi;
+  cvtbf16_fp32(a, a_lo, a_hi);
+  cvtbf16_fp32(b, b_lo, b_hi);
+  cvtbf16_fp32(c, c_lo, c_hi);
+  return cvtfp32_bf16(_mm256_fmadd_ps(a_lo, b_lo, c_lo),
+                      _mm256_fmadd_ps(a_hi, b_hi, c_hi));
+}
+
+// Widens a Vec256<BFloat16> to the two Vec256<float> holding its low and high
+// halves, e.g. to accumulate in fp32 across several loads.
+inline std::tuple<Vec256<float>, Vec256<float>> convert_bfloat16_float(
+    const Vec256<BFloat16>& a) {
+  __m256 lo, hi;
+  cvtbf16_fp32(a, lo, hi);
+  return std::make_tuple(Vec256<float>(lo), Vec256<float>(hi));
+}
+
+inline Vec256<BFloat16> convert_float_bfloat16(const Vec256<float>& a,
+                                               const Vec256<float>& b) {
+  return cvtfp32_bf16(a, b);
+}
+
+template <>
+inline void convert(const BFloat16* src, float* dst, int64_t n) {
+  int64_t i;
+#pragma unroll
+  for (i = 0; i <= (n - 8); i += 8) {
+    auto vsrc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm256_storeu_ps(dst + i, cvtbf16_fp32(vsrc));
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const float* src, BFloat16* dst, int64_t n) {
+  int64_t i;
+#pragma unroll
+  for (i = 0; i <= (n - Vec256<BFloat16>::size()); i += Vec256<BFloat16>::size()) {
+    auto vdst = cvtfp32_bf16(_mm256_loadu_ps(src + i), _mm256_loadu_ps(src + i + 8));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), vdst);
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = static_cast<BFloat16>(src[i]);
+  }
+}
+
+#else
+
+inline std::tuple<Vec256<float>, Vec256<float>> convert_bfloat16_float(
+    const Vec256<BFloat16>& a) {
+  constexpr int64_t K = Vec256<BFloat16>::size();
+  __at_align32__ float arr[K];
+  __at_align32__ BFloat16 arr2[K];
+  a.store(arr2);
+  convert(arr2, arr, K);
+  return std::make_tuple(
+      Vec256<float>::loadu(arr),
+      Vec256<float>::loadu(arr + Vec256<float>::size()));
+}
+
+inline Vec256<BFloat16> convert_float_bfloat16(const Vec256<float>& a,
+                                               const Vec256<float>& b) {
+  constexpr int64_t K = Vec256<BFloat16>::size();
+  __at_align32__ float arr[K];
+  __at_align32__ BFloat16 arr2[K];
+  a.store(arr);
+  b.store(arr + Vec256<float>::size());
+  convert(arr, arr2, K);
+  return Vec256<BFloat16>::loadu(arr2);
+}
+
+#endif
+
+}}}
@@ -419,6 +419,11 @@ Vec256<std::complex<double>> inline operator^(const Vec256<std::complex<double>>
   return _mm256_xor_pd(a, b);
 }
 
+template <>
+inline Vec256<std::complex<double>> flip(const Vec256<std::complex<double>>& a) {
+  return _mm256_permute2f128_pd(a, a, 0x01);            //c1    c0
+}
+
 #ifdef __AVX2__
 template <> inline Vec256<std::complex<double>> fmadd(const Vec256<std::complex<double>>& a, const Vec256<std::complex<double>>& b, const Vec256<std::complex<double>>& c) {
   return a * b + c;
@@ -459,6 +459,12 @@ Vec256<std::complex<float>> inline operator^(const Vec256<std::complex<float>>&
   return _mm256_xor_ps(a, b);
 }
 
+template <>
+inline Vec256<std::complex<float>> flip(const Vec256<std::complex<float>>& a) {
+  auto swapped = _mm256_permute2f128_ps(a, a, 0x01);    //c2    c3    c0    c1
+  return _mm256_permute_ps(swapped, 0x4E);              //c3    c2    c1    c0
+}
+
 #ifdef __AVX2__
 template <> inline Vec256<std::complex<float>> fmadd(const Vec256<std::complex<float>>& a, const Vec256<std::complex<float>>& b, const Vec256<std::complex<float>>& c) {
   return a * b + c;
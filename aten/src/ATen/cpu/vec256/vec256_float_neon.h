@@ -0,0 +1,410 @@
+#pragma once
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256_base.h>
+
+namespace at {
+namespace vec256 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+// NEON has 128-bit registers, so a Vec256<float> is a pair of float32x4_t.
+// aarch64 always has NEON, which is why this doesn't need a CPU_CAPABILITY
+// of its own: the DEFAULT build picks it up.
+//
+// There is no sleef build for aarch64 here, so the transcendental functions
+// go through map() like vec256_base.h does.
+
+#if defined(__aarch64__)
+
+template <> class Vec256<float> {
+private:
+  float32x4x2_t values;
+  static inline float32x4_t from_mask(uint32x4_t mask) {
+    return vreinterpretq_f32_u32(mask);
+  }
+  static inline uint32x4_t to_mask(float32x4_t v) {
+    return vreinterpretq_u32_f32(v);
+  }
+public:
+  using value_type = float;
+  static constexpr int size() {
+    return 8;
+  }
+  Vec256() {}
+  Vec256(float32x4x2_t v) : values(v) {}
+  Vec256(float32x4_t low, float32x4_t high) {
+    values.val[0] = low;
+    values.val[1] = high;
+  }
+  Vec256(float val) {
+    values.val[0] = vdupq_n_f32(val);
+    values.val[1] = vdupq_n_f32(val);
+  }
+  Vec256(float val1, float val2, float val3, float val4,
+         float val5, float val6, float val7, float val8) {
+    __at_align32__ float tmp[8] = {val1, val2, val3, val4, val5, val6, val7, val8};
+    values.val[0] = vld1q_f32(tmp);
+    values.val[1] = vld1q_f32(tmp + 4);
+  }
+  operator float32x4x2_t() const {
+    return values;
+  }
+  float32x4_t get_low() const {
+    return values.val[0];
+  }
+  float32x4_t get_high() const {
+    return values.val[1];
+  }
+  template <int64_t mask>
+  static Vec256<float> blend(const Vec256<float>& a, const Vec256<float>& b) {
+    const uint32_t m[8] = {
+      (mask & 0x01) ? 0xFFFFFFFF : 0, (mask & 0x02) ? 0xFFFFFFFF : 0,
+      (mask & 0x04) ? 0xFFFFFFFF : 0, (mask & 0x08) ? 0xFFFFFFFF : 0,
+      (mask & 0x10) ? 0xFFFFFFFF : 0, (mask & 0x20) ? 0xFFFFFFFF : 0,
+      (mask & 0x40) ? 0xFFFFFFFF : 0, (mask & 0x80) ? 0xFFFFFFFF : 0};
+    return Vec256<float>(
+        vbslq_f32(vld1q_u32(m), b.values.val[0], a.values.val[0]),
+        vbslq_f32(vld1q_u32(m + 4), b.values.val[1], a.values.val[1]));
+  }
+  static Vec256<float> blendv(const Vec256<float>& a, const Vec256<float>& b,
+                              const Vec256<float>& mask) {
+    // Like _mm256_blendv_ps, select on the sign bit of each element of mask.
+    auto m0 = vreinterpretq_u32_s32(
+        vshrq_n_s32(vreinterpretq_s32_f32(mask.values.val[0]), 31));
+    auto m1 = vreinterpretq_u32_s32(
+        vshrq_n_s32(vreinterpretq_s32_f32(mask.values.val[1]), 31));
+    return Vec256<float>(
+        vbslq_f32(m0, b.values.val[0], a.values.val[0]),
+        vbslq_f32(m1, b.values.val[1], a.values.val[1]));
+  }
+  static Vec256<float> arange(float base = 0.f, float step = 1.f) {
+    return Vec256<float>(
+      base,            base +     step, base + 2 * step, base + 3 * step,
+      base + 4 * step, base + 5 * step, base + 6 * step, base + 7 * step);
+  }
+  static Vec256<float> set(const Vec256<float>& a, const Vec256<float>& b,
+                           int64_t count = size()) {
+    if (count <= 0) {
+      return a;
+    } else if (count >= size()) {
+      return b;
+    }
+    // The first `count` lanes come from b.
+    const int32_t idx[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+    auto limit = vdupq_n_s32(static_cast<int32_t>(count));
+    auto m0 = vcltq_s32(vld1q_s32(idx), limit);
+    auto m1 = vcltq_s32(vld1q_s32(idx + 4), limit);
+    return Vec256<float>(
+        vbslq_f32(m0, b.values.val[0], a.values.val[0]),
+        vbslq_f32(m1, b.values.val[1], a.values.val[1]));
+  }
+  static Vec256<float> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size()) {
+      const float* p = reinterpret_cast<const float*>(ptr);
+      return Vec256<float>(vld1q_f32(p), vld1q_f32(p + 4));
+    }
+    __at_align32__ float tmp_values[size()];
+    // Ensure uninitialized memory does not change the output value
+    // See https://github.com/pytorch/pytorch/issues/32502 for more details
+    for (auto i = 0; i < size(); ++i) {
+      tmp_values[i] = 0.0;
+    }
+    std::memcpy(tmp_values, ptr, count * sizeof(float));
+    return Vec256<float>(vld1q_f32(tmp_values), vld1q_f32(tmp_values + 4));
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      float* p = reinterpret_cast<float*>(ptr);
+      vst1q_f32(p, values.val[0]);
+      vst1q_f32(p + 4, values.val[1]);
+    } else if (count > 0) {
+      __at_align32__ float tmp_values[size()];
+      vst1q_f32(tmp_values, values.val[0]);
+      vst1q_f32(tmp_values + 4, values.val[1]);
+      std::memcpy(ptr, tmp_values, count * sizeof(float));
+    }
+  }
+  const float& operator[](int idx) const  = delete;
+  float& operator[](int idx) = delete;
+  Vec256<float> map(float (*f)(float)) const {
+    __at_align32__ float tmp[8];
+    store(tmp);
+    for (int64_t i = 0; i < 8; i++) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+  Vec256<float> map2(const Vec256<float>& b, float (*f)(float, float)) const {
+    __at_align32__ float tmp[8];
+    __at_align32__ float tmp_b[8];
+    store(tmp);
+    b.store(tmp_b);
+    for (int64_t i = 0; i < 8; i++) {
+      tmp[i] = f(tmp[i], tmp_b[i]);
+    }
+    return loadu(tmp);
+  }
+  Vec256<float> abs() const {
+    return Vec256<float>(vabsq_f32(values.val[0]), vabsq_f32(values.val[1]));
+  }
+  Vec256<float> angle() const {
+    return Vec256<float>(0.f);
+  }
+  Vec256<float> real() const {
+    return *this;
+  }
+  Vec256<float> imag() const {
+    return Vec256<float>(0.f);
+  }
+  Vec256<float> conj() const {
+    return *this;
+  }
+  Vec256<float> acos() const {
+    return map(std::acos);
+  }
+  Vec256<float> asin() const {
+    return map(std::asin);
+  }
+  Vec256<float> atan() const {
+    return map(std::atan);
+  }
+  Vec256<float> atan2(const Vec256<float> &b) const {
+    return map2(b, std::atan2);
+  }
+  Vec256<float> erf() const {
+    return map(std::erf);
+  }
+  Vec256<float> erfc() const {
+    return map(std::erfc);
+  }
+  Vec256<float> erfinv() const {
+    return map(calc_erfinv);
+  }
+  Vec256<float> exp() const {
+    return map(std::exp);
+  }
+  Vec256<float> expm1() const {
+    return map(std::expm1);
+  }
+  Vec256<float> log() const {
+    return map(std::log);
+  }
+  Vec256<float> log2() const {
+    return map(std::log2);
+  }
+  Vec256<float> log10() const {
+    return map(std::log10);
+  }
+  Vec256<float> log1p() const {
+    return map(std::log1p);
+  }
+  Vec256<float> frac() const;
+  Vec256<float> sin() const {
+    return map(std::sin);
+  }
+  Vec256<float> sinh() const {
+    return map(std::sinh);
+  }
+  Vec256<float> cos() const {
+    return map(std::cos);
+  }
+  Vec256<float> cosh() const {
+    return map(std::cosh);
+  }
+  Vec256<float> ceil() const {
+    return Vec256<float>(vrndpq_f32(values.val[0]), vrndpq_f32(values.val[1]));
+  }
+  Vec256<float> floor() const {
+    return Vec256<float>(vrndmq_f32(values.val[0]), vrndmq_f32(values.val[1]));
+  }
+  Vec256<float> neg() const {
+    return Vec256<float>(vnegq_f32(values.val[0]), vnegq_f32(values.val[1]));
+  }
+  Vec256<float> round() const {
+    // Round half to even, like _MM_FROUND_TO_NEAREST_INT.
+    return Vec256<float>(vrndnq_f32(values.val[0]), vrndnq_f32(values.val[1]));
+  }
+  Vec256<float> tan() const {
+    return map(std::tan);
+  }
+  Vec256<float> tanh() const {
+    return map(std::tanh);
+  }
+  Vec256<float> trunc() const {
+    return Vec256<float>(vrndq_f32(values.val[0]), vrndq_f32(values.val[1]));
+  }
+  Vec256<float> lgamma() const {
+    return map(std::lgamma);
+  }
+  Vec256<float> sqrt() const {
+    return Vec256<float>(vsqrtq_f32(values.val[0]), vsqrtq_f32(values.val[1]));
+  }
+  Vec256<float> reciprocal() const {
+    auto one = vdupq_n_f32(1.f);
+    return Vec256<float>(
+        vdivq_f32(one, values.val[0]), vdivq_f32(one, values.val[1]));
+  }
+  Vec256<float> rsqrt() const {
+    return this->sqrt().reciprocal();
+  }
+  Vec256<float> pow(const Vec256<float> &b) const {
+    return map2(b, std::pow);
+  }
+  // Comparisons are false if an operand is NaN, like the _CMP_**_OQ
+  // predicates of the AVX version.
+  Vec256<float> operator==(const Vec256<float>& other) const {
+    return Vec256<float>(
+        from_mask(vceqq_f32(values.val[0], other.values.val[0])),
+        from_mask(vceqq_f32(values.val[1], other.values.val[1])));
+  }
+
+  Vec256<float> operator!=(const Vec256<float>& other) const {
+    return Vec256<float>(
+        from_mask(vorrq_u32(vcltq_f32(values.val[0], other.values.val[0]),
+                            vcgtq_f32(values.val[0], other.values.val[0]))),
+        from_mask(vorrq_u32(vcltq_f32(values.val[1], other.values.val[1]),
+                            vcgtq_f32(values.val[1], other.values.val[1]))));
+  }
+
+  Vec256<float> operator<(const Vec256<float>& other) const {
+    return Vec256<float>(
+        from_mask(vcltq_f32(values.val[0], other.values.val[0])),
+        from_mask(vcltq_f32(values.val[1], other.values.val[1])));
+  }
+
+  Vec256<float> operator<=(const Vec256<float>& other) const {
+    return Vec256<float>(
+        from_mask(vcleq_f32(values.val[0], other.values.val[0])),
+        from_mask(vcleq_f32(values.val[1], other.values.val[1])));
+  }
+
+  Vec256<float> operator>(const Vec256<float>& other) const {
+    return Vec256<float>(
+        from_mask(vcgtq_f32(values.val[0], other.values.val[0])),
+        from_mask(vcgtq_f32(values.val[1], other.values.val[1])));
+  }
+
+  Vec256<float> operator>=(const Vec256<float>& other) const {
+    return Vec256<float>(
+        from_mask(vcgeq_f32(values.val[0], other.values.val[0])),
+        from_mask(vcgeq_f32(values.val[1], other.values.val[1])));
+  }
+
+  Vec256<float> bitwise_and(const Vec256<float>& other) const {
+    return Vec256<float>(
+        from_mask(vandq_u32(to_mask(values.val[0]), to_mask(other.values.val[0]))),
+        from_mask(vandq_u32(to_mask(values.val[1]), to_mask(other.values.val[1]))));
+  }
+
+  Vec256<float> bitwise_or(const Vec256<float>& other) const {
+    return Vec256<float>(
+        from_mask(vorrq_u32(to_mask(values.val[0]), to_mask(other.values.val[0]))),
+        from_mask(vorrq_u32(to_mask(values.val[1]), to_mask(other.values.val[1]))));
+  }
+
+  Vec256<float> bitwise_xor(const Vec256<float>& other) const {
+    return Vec256<float>(
+        from_mask(veorq_u32(to_mask(values.val[0]), to_mask(other.values.val[0]))),
+        from_mask(veorq_u32(to_mask(values.val[1]), to_mask(other.values.val[1]))));
+  }
+};
+
+template <>
+Vec256<float> inline operator+(const Vec256<float>& a, const Vec256<float>& b) {
+  return Vec256<float>(vaddq_f32(a.get_low(), b.get_low()),
+                       vaddq_f32(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<float> inline operator-(const Vec256<float>& a, const Vec256<float>& b) {
+  return Vec256<float>(vsubq_f32(a.get_low(), b.get_low()),
+                       vsubq_f32(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<float> inline operator*(const Vec256<float>& a, const Vec256<float>& b) {
+  return Vec256<float>(vmulq_f32(a.get_low(), b.get_low()),
+                       vmulq_f32(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<float> inline operator/(const Vec256<float>& a, const Vec256<float>& b) {
+  return Vec256<float>(vdivq_f32(a.get_low(), b.get_low()),
+                       vdivq_f32(a.get_high(), b.get_high()));
+}
+
+// frac. Implement this here so we can use subtraction
+Vec256<float> Vec256<float>::frac() const {
+  return *this - this->trunc();
+}
+
+// Implements the IEEE 754 201X `maximum` operation, which propagates NaN if
+// either input is a NaN. vmaxq_f32 already does.
+template <>
+Vec256<float> inline maximum(const Vec256<float>& a, const Vec256<float>& b) {
+  return Vec256<float>(vmaxq_f32(a.get_low(), b.get_low()),
+                       vmaxq_f32(a.get_high(), b.get_high()));
+}
+
+// Implements the IEEE 754 201X `minimum` operation, which propagates NaN if
+// either input is a NaN. vminq_f32 already does.
+template <>
+Vec256<float> inline minimum(const Vec256<float>& a, const Vec256<float>& b) {
+  return Vec256<float>(vminq_f32(a.get_low(), b.get_low()),
+                       vminq_f32(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<float> inline clamp(const Vec256<float>& a, const Vec256<float>& min, const Vec256<float>& max) {
+  return minimum(max, maximum(min, a));
+}
+
+template <>
+Vec256<float> inline clamp_max(const Vec256<float>& a, const Vec256<float>& max) {
+  return minimum(max, a);
+}
+
+template <>
+Vec256<float> inline clamp_min(const Vec256<float>& a, const Vec256<float>& min) {
+  return maximum(min, a);
+}
+
+template <>
+Vec256<float> inline operator&(const Vec256<float>& a, const Vec256<float>& b) {
+  return a.bitwise_and(b);
+}
+
+template <>
+Vec256<float> inline operator|(const Vec256<float>& a, const Vec256<float>& b) {
+  return a.bitwise_or(b);
+}
+
+template <>
+Vec256<float> inline operator^(const Vec256<float>& a, const Vec256<float>& b) {
+  return a.bitwise_xor(b);
+}
+
+template <>
+inline void convert(const float* src, float* dst, int64_t n) {
+  int64_t i;
+#pragma unroll
+  for (i = 0; i <= (n - Vec256<float>::size()); i += Vec256<float>::size()) {
+    vst1q_f32(dst + i, vld1q_f32(src + i));
+    vst1q_f32(dst + i + 4, vld1q_f32(src + i + 4));
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = src[i];
+  }
+}
+
+template <>
+Vec256<float> inline fmadd(const Vec256<float>& a, const Vec256<float>& b, const Vec256<float>& c) {
+  return Vec256<float>(vfmaq_f32(c.get_low(), a.get_low(), b.get_low()),
+                       vfmaq_f32(c.get_high(), a.get_high(), b.get_high()));
+}
+
+#endif
+
+}}}
@@ -0,0 +1,756 @@
+#pragma once
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256_base.h>
+
+namespace at {
+namespace vec256 {
+namespace {
+
+// NEON counterparts of vec256_int.h, each Vec256 being a pair of 128-bit
+// registers. See vec256_float_neon.h.
+
+#if defined(__aarch64__)
+
+template <>
+struct Vec256<int64_t> {
+private:
+  int64x2x2_t values;
+public:
+  using value_type = int64_t;
+  static constexpr int size() {
+    return 4;
+  }
+  Vec256() {}
+  Vec256(int64x2x2_t v) : values(v) {}
+  Vec256(int64x2_t low, int64x2_t high) {
+    values.val[0] = low;
+    values.val[1] = high;
+  }
+  Vec256(int64_t v) {
+    values.val[0] = vdupq_n_s64(v);
+    values.val[1] = vdupq_n_s64(v);
+  }
+  Vec256(int64_t val1, int64_t val2, int64_t val3, int64_t val4) {
+    __at_align32__ int64_t tmp[size()] = {
+        val1, val2, val3, val4};
+    values.val[0] = vld1q_s64(tmp);
+    values.val[1] = vld1q_s64(tmp + 2);
+  }
+  operator int64x2x2_t() const {
+    return values;
+  }
+  int64x2_t get_low() const {
+    return values.val[0];
+  }
+  int64x2_t get_high() const {
+    return values.val[1];
+  }
+  template <int64_t mask>
+  static Vec256<int64_t> blend(Vec256<int64_t> a, Vec256<int64_t> b) {
+    __at_align32__ uint64_t m[size()];
+    for (int i = 0; i < size(); i++) {
+      m[i] = (mask & (1LL << i)) ? ~uint64_t(0) : 0;
+    }
+    return Vec256<int64_t>(
+        vbslq_s64(vld1q_u64(m), b.values.val[0], a.values.val[0]),
+        vbslq_s64(vld1q_u64(m + 2), b.values.val[1], a.values.val[1]));
+  }
+  static Vec256<int64_t> blendv(const Vec256<int64_t>& a, const Vec256<int64_t>& b,
+                                const Vec256<int64_t>& mask) {
+    // Select on the sign bit of each element of mask, like blendv_epi8 does
+    // for the all-ones/all-zeros masks that comparisons return.
+    auto m0 = vreinterpretq_u64_s64(vshrq_n_s64(mask.values.val[0], 63));
+    auto m1 = vreinterpretq_u64_s64(vshrq_n_s64(mask.values.val[1], 63));
+    return Vec256<int64_t>(
+        vbslq_s64(m0, b.values.val[0], a.values.val[0]),
+        vbslq_s64(m1, b.values.val[1], a.values.val[1]));
+  }
+  static Vec256<int64_t> arange(int64_t base = 0, int64_t step = 1) {
+    __at_align32__ int64_t tmp[size()];
+    for (int i = 0; i < size(); i++) {
+      tmp[i] = base + i * step;
+    }
+    return loadu(tmp);
+  }
+  static Vec256<int64_t>
+  set(Vec256<int64_t> a, Vec256<int64_t> b, int64_t count = size()) {
+    if (count <= 0) {
+      return a;
+    } else if (count >= size()) {
+      return b;
+    }
+    // The first `count` lanes come from b.
+    auto idx = arange();
+    auto limit = vdupq_n_s64(count);
+    auto m0 = vcltq_s64(idx.values.val[0], limit);
+    auto m1 = vcltq_s64(idx.values.val[1], limit);
+    return Vec256<int64_t>(
+        vbslq_s64(m0, b.values.val[0], a.values.val[0]),
+        vbslq_s64(m1, b.values.val[1], a.values.val[1]));
+  }
+  static Vec256<int64_t> loadu(const void* ptr) {
+    const int64_t* p = reinterpret_cast<const int64_t*>(ptr);
+    return Vec256<int64_t>(vld1q_s64(p), vld1q_s64(p + 2));
+  }
+  static Vec256<int64_t> loadu(const void* ptr, int64_t count) {
+    __at_align32__ int64_t tmp_values[size()];
+    // Ensure uninitialized memory does not change the output value
+    // See https://github.com/pytorch/pytorch/issues/32502 for more details
+    for (auto i = 0; i < size(); ++i) {
+      tmp_values[i] = 0;
+    }
+    std::memcpy(tmp_values, ptr, count * sizeof(int64_t));
+    return loadu(tmp_values);
+  }
+  void store(void* ptr, int count = size()) const {
+    if (count == size()) {
+      int64_t* p = reinterpret_cast<int64_t*>(ptr);
+      vst1q_s64(p, values.val[0]);
+      vst1q_s64(p + 2, values.val[1]);
+    } else if (count > 0) {
+      __at_align32__ int64_t tmp_values[size()];
+      store(tmp_values);
+      std::memcpy(ptr, tmp_values, count * sizeof(int64_t));
+    }
+  }
+  const int64_t& operator[](int idx) const  = delete;
+  int64_t& operator[](int idx)  = delete;
+  Vec256<int64_t> abs() const {
+    return Vec256<int64_t>(vabsq_s64(values.val[0]), vabsq_s64(values.val[1]));
+  }
+  Vec256<int64_t> angle() const {
+    return Vec256<int64_t>(0);
+  }
+  Vec256<int64_t> real() const {
+    return *this;
+  }
+  Vec256<int64_t> imag() const {
+    return Vec256<int64_t>(0);
+  }
+  Vec256<int64_t> conj() const {
+    return *this;
+  }
+  Vec256<int64_t> frac() const;
+  Vec256<int64_t> neg() const {
+    return Vec256<int64_t>(vnegq_s64(values.val[0]), vnegq_s64(values.val[1]));
+  }
+  Vec256<int64_t> operator==(const Vec256<int64_t>& other) const {
+    return from_mask(vceqq_s64(values.val[0], other.values.val[0]),
+                     vceqq_s64(values.val[1], other.values.val[1]));
+  }
+  Vec256<int64_t> operator!=(const Vec256<int64_t>& other) const {
+    return invert(*this == other);
+  }
+  Vec256<int64_t> operator<(const Vec256<int64_t>& other) const {
+    return from_mask(vcltq_s64(values.val[0], other.values.val[0]),
+                     vcltq_s64(values.val[1], other.values.val[1]));
+  }
+  Vec256<int64_t> operator<=(const Vec256<int64_t>& other) const {
+    return from_mask(vcleq_s64(values.val[0], other.values.val[0]),
+                     vcleq_s64(values.val[1], other.values.val[1]));
+  }
+  Vec256<int64_t> operator>(const Vec256<int64_t>& other) const {
+    return from_mask(vcgtq_s64(values.val[0], other.values.val[0]),
+                     vcgtq_s64(values.val[1], other.values.val[1]));
+  }
+  Vec256<int64_t> operator>=(const Vec256<int64_t>& other) const {
+    return from_mask(vcgeq_s64(values.val[0], other.values.val[0]),
+                     vcgeq_s64(values.val[1], other.values.val[1]));
+  }
+private:
+  static inline Vec256<int64_t> from_mask(uint64x2_t low, uint64x2_t high) {
+    return Vec256<int64_t>(vreinterpretq_s64_u64(low), vreinterpretq_s64_u64(high));
+  }
+  static inline Vec256<int64_t> invert(const Vec256<int64_t>& v) {
+    auto ones = vdupq_n_s64(-1);
+    return Vec256<int64_t>(veorq_s64(v.values.val[0], ones),
+                           veorq_s64(v.values.val[1], ones));
+  }
+};
+
+template <>
+struct Vec256<int32_t> {
+private:
+  int32x4x2_t values;
+public:
+  using value_type = int32_t;
+  static constexpr int size() {
+    return 8;
+  }
+  Vec256() {}
+  Vec256(int32x4x2_t v) : values(v) {}
+  Vec256(int32x4_t low, int32x4_t high) {
+    values.val[0] = low;
+    values.val[1] = high;
+  }
+  Vec256(int32_t v) {
+    values.val[0] = vdupq_n_s32(v);
+    values.val[1] = vdupq_n_s32(v);
+  }
+  Vec256(int32_t val1, int32_t val2, int32_t val3, int32_t val4,
+         int32_t val5, int32_t val6, int32_t val7, int32_t val8) {
+    __at_align32__ int32_t tmp[size()] = {
+        val1, val2, val3, val4, val5, val6, val7, val8};
+    values.val[0] = vld1q_s32(tmp);
+    values.val[1] = vld1q_s32(tmp + 4);
+  }
+  operator int32x4x2_t() const {
+    return values;
+  }
+  int32x4_t get_low() const {
+    return values.val[0];
+  }
+  int32x4_t get_high() const {
+    return values.val[1];
+  }
+  template <int64_t mask>
+  static Vec256<int32_t> blend(Vec256<int32_t> a, Vec256<int32_t> b) {
+    __at_align32__ uint32_t m[size()];
+    for (int i = 0; i < size(); i++) {
+      m[i] = (mask & (1LL << i)) ? ~uint32_t(0) : 0;
+    }
+    return Vec256<int32_t>(
+        vbslq_s32(vld1q_u32(m), b.values.val[0], a.values.val[0]),
+        vbslq_s32(vld1q_u32(m + 4), b.values.val[1], a.values.val[1]));
+  }
+  static Vec256<int32_t> blendv(const Vec256<int32_t>& a, const Vec256<int32_t>& b,
+                                const Vec256<int32_t>& mask) {
+    // Select on the sign bit of each element of mask, like blendv_epi8 does
+    // for the all-ones/all-zeros masks that comparisons return.
+    auto m0 = vreinterpretq_u32_s32(vshrq_n_s32(mask.values.val[0], 31));
+    auto m1 = vreinterpretq_u32_s32(vshrq_n_s32(mask.values.val[1], 31));
+    return Vec256<int32_t>(
+        vbslq_s32(m0, b.values.val[0], a.values.val[0]),
+        vbslq_s32(m1, b.values.val[1], a.values.val[1]));
+  }
+  static Vec256<int32_t> arange(int32_t base = 0, int32_t step = 1) {
+    __at_align32__ int32_t tmp[size()];
+    for (int i = 0; i < size(); i++) {
+      tmp[i] = base + i * step;
+    }
+    return loadu(tmp);
+  }
+  static Vec256<int32_t>
+  set(Vec256<int32_t> a, Vec256<int32_t> b, int32_t count = size()) {
+    if (count <= 0) {
+      return a;
+    } else if (count >= size()) {
+      return b;
+    }
+    // The first `count` lanes come from b.
+    auto idx = arange();
+    auto limit = vdupq_n_s32(count);
+    auto m0 = vcltq_s32(idx.values.val[0], limit);
+    auto m1 = vcltq_s32(idx.values.val[1], limit);
+    return Vec256<int32_t>(
+        vbslq_s32(m0, b.values.val[0], a.values.val[0]),
+        vbslq_s32(m1, b.values.val[1], a.values.val[1]));
+  }
+  static Vec256<int32_t> loadu(const void* ptr) {
+    const int32_t* p = reinterpret_cast<const int32_t*>(ptr);
+    return Vec256<int32_t>(vld1q_s32(p), vld1q_s32(p + 4));
+  }
+  static Vec256<int32_t> loadu(const void* ptr, int32_t count) {
+    __at_align32__ int32_t tmp_values[size()];
+    // Ensure uninitialized memory does not change the output value
+    // See https://github.com/pytorch/pytorch/issues/32502 for more details
+    for (auto i = 0; i < size(); ++i) {
+      tmp_values[i] = 0;
+    }
+    std::memcpy(tmp_values, ptr, count * sizeof(int32_t));
+    return loadu(tmp_values);
+  }
+  void store(void* ptr, int count = size()) const {
+    if (count == size()) {
+      int32_t* p = reinterpret_cast<int32_t*>(ptr);
+      vst1q_s32(p, values.val[0]);
+      vst1q_s32(p + 4, values.val[1]);
+    } else if (count > 0) {
+      __at_align32__ int32_t tmp_values[size()];
+      store(tmp_values);
+      std::memcpy(ptr, tmp_values, count * sizeof(int32_t));
+    }
+  }
+  const int32_t& operator[](int idx) const  = delete;
+  int32_t& operator[](int idx)  = delete;
+  Vec256<int32_t> abs() const {
+    return Vec256<int32_t>(vabsq_s32(values.val[0]), vabsq_s32(values.val[1]));
+  }
+  Vec256<int32_t> angle() const {
+    return Vec256<int32_t>(0);
+  }
+  Vec256<int32_t> real() const {
+    return *this;
+  }
+  Vec256<int32_t> imag() const {
+    return Vec256<int32_t>(0);
+  }
+  Vec256<int32_t> conj() const {
+    return *this;
+  }
+  Vec256<int32_t> frac() const;
+  Vec256<int32_t> neg() const {
+    return Vec256<int32_t>(vnegq_s32(values.val[0]), vnegq_s32(values.val[1]));
+  }
+  Vec256<int32_t> operator==(const Vec256<int32_t>& other) const {
+    return from_mask(vceqq_s32(values.val[0], other.values.val[0]),
+                     vceqq_s32(values.val[1], other.values.val[1]));
+  }
+  Vec256<int32_t> operator!=(const Vec256<int32_t>& other) const {
+    return invert(*this == other);
+  }
+  Vec256<int32_t> operator<(const Vec256<int32_t>& other) const {
+    return from_mask(vcltq_s32(values.val[0], other.values.val[0]),
+                     vcltq_s32(values.val[1], other.values.val[1]));
+  }
+  Vec256<int32_t> operator<=(const Vec256<int32_t>& other) const {
+    return from_mask(vcleq_s32(values.val[0], other.values.val[0]),
+                     vcleq_s32(values.val[1], other.values.val[1]));
+  }
+  Vec256<int32_t> operator>(const Vec256<int32_t>& other) const {
+    return from_mask(vcgtq_s32(values.val[0], other.values.val[0]),
+                     vcgtq_s32(values.val[1], other.values.val[1]));
+  }
+  Vec256<int32_t> operator>=(const Vec256<int32_t>& other) const {
+    return from_mask(vcgeq_s32(values.val[0], other.values.val[0]),
+                     vcgeq_s32(values.val[1], other.values.val[1]));
+  }
+private:
+  static inline Vec256<int32_t> from_mask(uint32x4_t low, uint32x4_t high) {
+    return Vec256<int32_t>(vreinterpretq_s32_u32(low), vreinterpretq_s32_u32(high));
+  }
+  static inline Vec256<int32_t> invert(const Vec256<int32_t>& v) {
+    auto ones = vdupq_n_s32(-1);
+    return Vec256<int32_t>(veorq_s32(v.values.val[0], ones),
+                           veorq_s32(v.values.val[1], ones));
+  }
+};
+
+template <>
+struct Vec256<int16_t> {
+private:
+  int16x8x2_t values;
+public:
+  using value_type = int16_t;
+  static constexpr int size() {
+    return 16;
+  }
+  Vec256() {}
+  Vec256(int16x8x2_t v) : values(v) {}
+  Vec256(int16x8_t low, int16x8_t high) {
+    values.val[0] = low;
+    values.val[1] = high;
+  }
+  Vec256(int16_t v) {
+    values.val[0] = vdupq_n_s16(v);
+    values.val[1] = vdupq_n_s16(v);
+  }
+  Vec256(int16_t val1, int16_t val2, int16_t val3, int16_t val4,
+         int16_t val5, int16_t val6, int16_t val7, int16_t val8,
+         int16_t val9, int16_t val10, int16_t val11, int16_t val12,
+         int16_t val13, int16_t val14, int16_t val15, int16_t val16) {
+    __at_align32__ int16_t tmp[size()] = {
+        val1, val2, val3, val4, val5, val6, val7, val8,
+        val9, val10, val11, val12, val13, val14, val15, val16};
+    values.val[0] = vld1q_s16(tmp);
+    values.val[1] = vld1q_s16(tmp + 8);
+  }
+  operator int16x8x2_t() const {
+    return values;
+  }
+  int16x8_t get_low() const {
+    return values.val[0];
+  }
+  int16x8_t get_high() const {
+    return values.val[1];
+  }
+  template <int64_t mask>
+  static Vec256<int16_t> blend(Vec256<int16_t> a, Vec256<int16_t> b) {
+    __at_align32__ uint16_t m[size()];
+    for (int i = 0; i < size(); i++) {
+      m[i] = (mask & (1LL << i)) ? ~uint16_t(0) : 0;
+    }
+    return Vec256<int16_t>(
+        vbslq_s16(vld1q_u16(m), b.values.val[0], a.values.val[0]),
+        vbslq_s16(vld1q_u16(m + 8), b.values.val[1], a.values.val[1]));
+  }
+  static Vec256<int16_t> blendv(const Vec256<int16_t>& a, const Vec256<int16_t>& b,
+                                const Vec256<int16_t>& mask) {
+    // Select on the sign bit of each element of mask, like blendv_epi8 does
+    // for the all-ones/all-zeros masks that comparisons return.
+    auto m0 = vreinterpretq_u16_s16(vshrq_n_s16(mask.values.val[0], 15));
+    auto m1 = vreinterpretq_u16_s16(vshrq_n_s16(mask.values.val[1], 15));
+    return Vec256<int16_t>(
+        vbslq_s16(m0, b.values.val[0], a.values.val[0]),
+        vbslq_s16(m1, b.values.val[1], a.values.val[1]));
+  }
+  static Vec256<int16_t> arange(int16_t base = 0, int16_t step = 1) {
+    __at_align32__ int16_t tmp[size()];
+    for (int i = 0; i < size(); i++) {
+      tmp[i] = base + i * step;
+    }
+    return loadu(tmp);
+  }
+  static Vec256<int16_t>
+  set(Vec256<int16_t> a, Vec256<int16_t> b, int16_t count = size()) {
+    if (count <= 0) {
+      return a;
+    } else if (count >= size()) {
+      return b;
+    }
+    // The first `count` lanes come from b.
+    auto idx = arange();
+    auto limit = vdupq_n_s16(count);
+    auto m0 = vcltq_s16(idx.values.val[0], limit);
+    auto m1 = vcltq_s16(idx.values.val[1], limit);
+    return Vec256<int16_t>(
+        vbslq_s16(m0, b.values.val[0], a.values.val[0]),
+        vbslq_s16(m1, b.values.val[1], a.values.val[1]));
+  }
+  static Vec256<int16_t> loadu(const void* ptr) {
+    const int16_t* p = reinterpret_cast<const int16_t*>(ptr);
+    return Vec256<int16_t>(vld1q_s16(p), vld1q_s16(p + 8));
+  }
+  static Vec256<int16_t> loadu(const void* ptr, int16_t count) {
+    __at_align32__ int16_t tmp_values[size()];
+    // Ensure uninitialized memory does not change the output value
+    // See https://github.com/pytorch/pytorch/issues/32502 for more details
+    for (auto i = 0; i < size(); ++i) {
+      tmp_values[i] = 0;
+    }
+    std::memcpy(tmp_values, ptr, count * sizeof(int16_t));
+    return loadu(tmp_values);
+  }
+  void store(void* ptr, int count = size()) const {
+    if (count == size()) {
+      int16_t* p = reinterpret_cast<int16_t*>(ptr);
+      vst1q_s16(p, values.val[0]);
+      vst1q_s16(p + 8, values.val[1]);
+    } else if (count > 0) {
+      __at_align32__ int16_t tmp_values[size()];
+      store(tmp_values);
+      std::memcpy(ptr, tmp_values, count * sizeof(int16_t));
+    }
+  }
+  const int16_t& operator[](int idx) const  = delete;
+  int16_t& operator[](int idx)  = delete;
+  Vec256<int16_t> abs() const {
+    return Vec256<int16_t>(vabsq_s16(values.val[0]), vabsq_s16(values.val[1]));
+  }
+  Vec256<int16_t> angle() const {
+    return Vec256<int16_t>(0);
+  }
+  Vec256<int16_t> real() const {
+    return *this;
+  }
+  Vec256<int16_t> imag() const {
+    return Vec256<int16_t>(0);
+  }
+  Vec256<int16_t> conj() const {
+    return *this;
+  }
+  Vec256<int16_t> frac() const;
+  Vec256<int16_t> neg() const {
+    return Vec256<int16_t>(vnegq_s16(values.val[0]), vnegq_s16(values.val[1]));
+  }
+  Vec256<int16_t> operator==(const Vec256<int16_t>& other) const {
+    return from_mask(vceqq_s16(values.val[0], other.values.val[0]),
+                     vceqq_s16(values.val[1], other.values.val[1]));
+  }
+  Vec256<int16_t> operator!=(const Vec256<int16_t>& other) const {
+    return invert(*this == other);
+  }
+  Vec256<int16_t> operator<(const Vec256<int16_t>& other) const {
+    return from_mask(vcltq_s16(values.val[0], other.values.val[0]),
+                     vcltq_s16(values.val[1], other.values.val[1]));
+  }
+  Vec256<int16_t> operator<=(const Vec256<int16_t>& other) const {
+    return from_mask(vcleq_s16(values.val[0], other.values.val[0]),
+                     vcleq_s16(values.val[1], other.values.val[1]));
+  }
+  Vec256<int16_t> operator>(const Vec256<int16_t>& other) const {
+    return from_mask(vcgtq_s16(values.val[0], other.values.val[0]),
+                     vcgtq_s16(values.val[1], other.values.val[1]));
+  }
+  Vec256<int16_t> operator>=(const Vec256<int16_t>& other) const {
+    return from_mask(vcgeq_s16(values.val[0], other.values.val[0]),
+                     vcgeq_s16(values.val[1], other.values.val[1]));
+  }
+private:
+  static inline Vec256<int16_t> from_mask(uint16x8_t low, uint16x8_t high) {
+    return Vec256<int16_t>(vreinterpretq_s16_u16(low), vreinterpretq_s16_u16(high));
+  }
+  static inline Vec256<int16_t> invert(const Vec256<int16_t>& v) {
+    auto ones = vdupq_n_s16(-1);
+    return Vec256<int16_t>(veorq_s16(v.values.val[0], ones),
+                           veorq_s16(v.values.val[1], ones));
+  }
+};
+
+template <>
+Vec256<int64_t> inline operator+(const Vec256<int64_t>& a, const Vec256<int64_t>& b) {
+  return Vec256<int64_t>(vaddq_s64(a.get_low(), b.get_low()),
+                         vaddq_s64(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int32_t> inline operator+(const Vec256<int32_t>& a, const Vec256<int32_t>& b) {
+  return Vec256<int32_t>(vaddq_s32(a.get_low(), b.get_low()),
+                         vaddq_s32(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int16_t> inline operator+(const Vec256<int16_t>& a, const Vec256<int16_t>& b) {
+  return Vec256<int16_t>(vaddq_s16(a.get_low(), b.get_low()),
+                         vaddq_s16(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int64_t> inline operator-(const Vec256<int64_t>& a, const Vec256<int64_t>& b) {
+  return Vec256<int64_t>(vsubq_s64(a.get_low(), b.get_low()),
+                         vsubq_s64(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int32_t> inline operator-(const Vec256<int32_t>& a, const Vec256<int32_t>& b) {
+  return Vec256<int32_t>(vsubq_s32(a.get_low(), b.get_low()),
+                         vsubq_s32(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int16_t> inline operator-(const Vec256<int16_t>& a, const Vec256<int16_t>& b) {
+  return Vec256<int16_t>(vsubq_s16(a.get_low(), b.get_low()),
+                         vsubq_s16(a.get_high(), b.get_high()));
+}
+
+// NEON has no 64-bit integer multiply, so it is emulated pointwise.
+template <typename op_t>
+Vec256<int64_t> inline emulate(const Vec256<int64_t>& a, const Vec256<int64_t>& b, const op_t& op) {
+  __at_align32__ int64_t values_a[Vec256<int64_t>::size()];
+  __at_align32__ int64_t values_b[Vec256<int64_t>::size()];
+  a.store(values_a);
+  b.store(values_b);
+  for (int i = 0; i != Vec256<int64_t>::size(); i++) {
+    values_a[i] = op(values_a[i], values_b[i]);
+  }
+  return Vec256<int64_t>::loadu(values_a);
+}
+
+template <>
+Vec256<int64_t> inline operator*(const Vec256<int64_t>& a, const Vec256<int64_t>& b) {
+  return emulate(a, b, [](int64_t a_point, int64_t b_point){return a_point * b_point;});
+}
+
+template <>
+Vec256<int32_t> inline operator*(const Vec256<int32_t>& a, const Vec256<int32_t>& b) {
+  return Vec256<int32_t>(vmulq_s32(a.get_low(), b.get_low()),
+                         vmulq_s32(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int16_t> inline operator*(const Vec256<int16_t>& a, const Vec256<int16_t>& b) {
+  return Vec256<int16_t>(vmulq_s16(a.get_low(), b.get_low()),
+                         vmulq_s16(a.get_high(), b.get_high()));
+}
+
+// There is no 64-bit vminq/vmaxq either, but there are 64-bit compares.
+template <>
+Vec256<int64_t> inline minimum(const Vec256<int64_t>& a, const Vec256<int64_t>& b) {
+  return Vec256<int64_t>(
+      vbslq_s64(vcltq_s64(a.get_low(), b.get_low()), a.get_low(), b.get_low()),
+      vbslq_s64(vcltq_s64(a.get_high(), b.get_high()), a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int32_t> inline minimum(const Vec256<int32_t>& a, const Vec256<int32_t>& b) {
+  return Vec256<int32_t>(vminq_s32(a.get_low(), b.get_low()),
+                         vminq_s32(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int16_t> inline minimum(const Vec256<int16_t>& a, const Vec256<int16_t>& b) {
+  return Vec256<int16_t>(vminq_s16(a.get_low(), b.get_low()),
+                         vminq_s16(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int64_t> inline maximum(const Vec256<int64_t>& a, const Vec256<int64_t>& b) {
+  return Vec256<int64_t>(
+      vbslq_s64(vcgtq_s64(a.get_low(), b.get_low()), a.get_low(), b.get_low()),
+      vbslq_s64(vcgtq_s64(a.get_high(), b.get_high()), a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int32_t> inline maximum(const Vec256<int32_t>& a, const Vec256<int32_t>& b) {
+  return Vec256<int32_t>(vmaxq_s32(a.get_low(), b.get_low()),
+                         vmaxq_s32(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int16_t> inline maximum(const Vec256<int16_t>& a, const Vec256<int16_t>& b) {
+  return Vec256<int16_t>(vmaxq_s16(a.get_low(), b.get_low()),
+                         vmaxq_s16(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int64_t> inline clamp(const Vec256<int64_t>& a, const Vec256<int64_t>& min_val, const Vec256<int64_t>& max_val) {
+  return minimum(max_val, maximum(a, min_val));
+}
+
+template <>
+Vec256<int32_t> inline clamp(const Vec256<int32_t>& a, const Vec256<int32_t>& min_val, const Vec256<int32_t>& max_val) {
+  return minimum(max_val, maximum(a, min_val));
+}
+
+template <>
+Vec256<int16_t> inline clamp(const Vec256<int16_t>& a, const Vec256<int16_t>& min_val, const Vec256<int16_t>& max_val) {
+  return minimum(max_val, maximum(a, min_val));
+}
+
+template <>
+Vec256<int64_t> inline clamp_max(const Vec256<int64_t>& a, const Vec256<int64_t>& max_val) {
+  return minimum(max_val, a);
+}
+
+template <>
+Vec256<int32_t> inline clamp_max(const Vec256<int32_t>& a, const Vec256<int32_t>& max_val) {
+  return minimum(max_val, a);
+}
+
+template <>
+Vec256<int16_t> inline clamp_max(const Vec256<int16_t>& a, const Vec256<int16_t>& max_val) {
+  return minimum(max_val, a);
+}
+
+template <>
+Vec256<int64_t> inline clamp_min(const Vec256<int64_t>& a, const Vec256<int64_t>& min_val) {
+  return maximum(min_val, a);
+}
+
+template <>
+Vec256<int32_t> inline clamp_min(const Vec256<int32_t>& a, const Vec256<int32_t>& min_val) {
+  return maximum(min_val, a);
+}
+
+template <>
+Vec256<int16_t> inline clamp_min(const Vec256<int16_t>& a, const Vec256<int16_t>& min_val) {
+  return maximum(min_val, a);
+}
+
+template <>
+inline void convert(const int32_t *src, float *dst, int64_t n) {
+  int64_t i;
+  // int32_t and float have same size
+#pragma unroll
+  for (i = 0; i <= (n - Vec256<int32_t>::size()); i += Vec256<int32_t>::size()) {
+    vst1q_f32(dst + i, vcvtq_f32_s32(vld1q_s32(src + i)));
+    vst1q_f32(dst + i + 4, vcvtq_f32_s32(vld1q_s32(src + i + 4)));
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template<typename T>
+Vec256<int32_t> inline convert_to_int32(const T* ptr) {
+  return Vec256<int32_t>::loadu(ptr);
+}
+
+template<>
+Vec256<int32_t> inline convert_to_int32<int8_t>(const int8_t* ptr) {
+  int16x8_t v = vmovl_s8(vld1_s8(ptr));
+  return Vec256<int32_t>(vmovl_s16(vget_low_s16(v)), vmovl_s16(vget_high_s16(v)));
+}
+
+template<>
+Vec256<int32_t> inline convert_to_int32<uint8_t>(const uint8_t* ptr) {
+  int16x8_t v = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ptr)));
+  return Vec256<int32_t>(vmovl_s16(vget_low_s16(v)), vmovl_s16(vget_high_s16(v)));
+}
+
+template <typename T>
+Vec256<T> inline intdiv_256(const Vec256<T>& a, const Vec256<T>& b) {
+  T values_a[Vec256<T>::size()];
+  T values_b[Vec256<T>::size()];
+  a.store(values_a);
+  b.store(values_b);
+  for (int i = 0; i != Vec256<T>::size(); i++) {
+    values_a[i] /= values_b[i];
+  }
+  return Vec256<T>::loadu(values_a);
+}
+
+template <>
+Vec256<int64_t> inline operator/(const Vec256<int64_t>& a, const Vec256<int64_t>& b) {
+  return intdiv_256(a, b);
+}
+
+template <>
+Vec256<int32_t> inline operator/(const Vec256<int32_t>& a, const Vec256<int32_t>& b) {
+  return intdiv_256(a, b);
+}
+
+template <>
+Vec256<int16_t> inline operator/(const Vec256<int16_t>& a, const Vec256<int16_t>& b) {
+  return intdiv_256(a, b);
+}
+
+template <>
+Vec256<int64_t> inline operator&(const Vec256<int64_t>& a, const Vec256<int64_t>& b) {
+  return Vec256<int64_t>(vandq_s64(a.get_low(), b.get_low()),
+                         vandq_s64(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int32_t> inline operator&(const Vec256<int32_t>& a, const Vec256<int32_t>& b) {
+  return Vec256<int32_t>(vandq_s32(a.get_low(), b.get_low()),
+                         vandq_s32(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int16_t> inline operator&(const Vec256<int16_t>& a, const Vec256<int16_t>& b) {
+  return Vec256<int16_t>(vandq_s16(a.get_low(), b.get_low()),
+                         vandq_s16(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int64_t> inline operator|(const Vec256<int64_t>& a, const Vec256<int64_t>& b) {
+  return Vec256<int64_t>(vorrq_s64(a.get_low(), b.get_low()),
+                         vorrq_s64(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int32_t> inline operator|(const Vec256<int32_t>& a, const Vec256<int32_t>& b) {
+  return Vec256<int32_t>(vorrq_s32(a.get_low(), b.get_low()),
+                         vorrq_s32(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int16_t> inline operator|(const Vec256<int16_t>& a, const Vec256<int16_t>& b) {
+  return Vec256<int16_t>(vorrq_s16(a.get_low(), b.get_low()),
+                         vorrq_s16(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int64_t> inline operator^(const Vec256<int64_t>& a, const Vec256<int64_t>& b) {
+  return Vec256<int64_t>(veorq_s64(a.get_low(), b.get_low()),
+                         veorq_s64(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int32_t> inline operator^(const Vec256<int32_t>& a, const Vec256<int32_t>& b) {
+  return Vec256<int32_t>(veorq_s32(a.get_low(), b.get_low()),
+                         veorq_s32(a.get_high(), b.get_high()));
+}
+
+template <>
+Vec256<int16_t> inline operator^(const Vec256<int16_t>& a, const Vec256<int16_t>& b) {
+  return Vec256<int16_t>(veorq_s16(a.get_low(), b.get_low()),
+                         veorq_s16(a.get_high(), b.get_high()));
+}
+
+#endif
+
+}}}
@@ -676,6 +676,74 @@ Vec256<c10::qint32> inline maximum(const Vec256<c10::qint32>& a, const Vec256<c1
 // If in the future we relax this requirement (AVX2+), we should probably
 // revisit these implementations
 
+#if defined(__aarch64__)
+
+// Widens eight quantized values to a Vec256<float>.
+inline Vec256<float> neon_cvt_to_float(const int8_t* ptr) {
+  int16x8_t v = vmovl_s8(vld1_s8(ptr));
+  return Vec256<float>(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))),
+                       vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))));
+}
+
+inline Vec256<float> neon_cvt_to_float(const uint8_t* ptr) {
+  uint16x8_t v = vmovl_u8(vld1_u8(ptr));
+  return Vec256<float>(vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))),
+                       vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))));
+}
+
+inline Vec256<float> neon_cvt_to_float(const int32_t* ptr) {
+  return Vec256<float>(vcvtq_f32_s32(vld1q_s32(ptr)),
+                       vcvtq_f32_s32(vld1q_s32(ptr + 4)));
+}
+
+// Narrows eight int32 values, already clamped to the range of the
+// quantized type.
+inline void neon_store_narrowed(int8_t* dst, int32x4_t low, int32x4_t high) {
+  vst1_s8(dst, vmovn_s16(vcombine_s16(vmovn_s32(low), vmovn_s32(high))));
+}
+
+inline void neon_store_narrowed(uint8_t* dst, int32x4_t low, int32x4_t high) {
+  vst1_u8(dst, vmovn_u16(vreinterpretq_u16_s16(
+      vcombine_s16(vmovn_s32(low), vmovn_s32(high)))));
+}
+
+// Same computation as QuantizeAvx2.
+template <typename T>
+inline void QuantizeNeon(
+    const float* src,
+    typename T::underlying* dst,
+    int len,
+    float inverse_scale,
+    int64_t zero_point) {
+  constexpr int VLEN = 8;
+  constexpr auto min_val = std::numeric_limits<typename T::underlying>::min();
+  constexpr auto max_val = std::numeric_limits<typename T::underlying>::max();
+  const float32x4_t inverse_scale_v = vdupq_n_f32(inverse_scale);
+  const float32x4_t zero_point_v = vdupq_n_f32(zero_point);
+  const int32x4_t min_v = vdupq_n_s32(min_val);
+  const int32x4_t max_v = vdupq_n_s32(max_val);
+  int i = 0;
+  for (; i + VLEN <= len; i += VLEN) {
+    // vcvtnq rounds to even in halfway cases, like _mm256_cvtps_epi32.
+    int32x4_t low = vcvtnq_s32_f32(
+        vfmaq_f32(zero_point_v, vld1q_f32(src + i), inverse_scale_v));
+    int32x4_t high = vcvtnq_s32_f32(
+        vfmaq_f32(zero_point_v, vld1q_f32(src + i + 4), inverse_scale_v));
+    low = vminq_s32(vmaxq_s32(low, min_v), max_v);
+    high = vminq_s32(vmaxq_s32(high, min_v), max_v);
+    neon_store_narrowed(dst + i, low, high);
+  }
+  for (; i < len; ++i) {
+    float transformed = zero_point + src[i] * inverse_scale;
+    float clipped =
+        std::min(std::max(transformed, float(min_val)), float(max_val));
+    // See the note on rounding in QuantizeAvx2.
+    dst[i] = nearbyint(clipped);
+  }
+}
+
+#endif // defined(__aarch64__)
+
 template <typename T, typename float_vec_return_type_, int size_>
 struct Vec256QuantizedConverter {
   static constexpr int size() {
@@ -710,12 +778,19 @@ struct Vec256QuantizedConverter {
       Vec256<float> zero_point,
       Vec256<float> scale_zp_premul) const {
     float_vec_return_type rv;
+#if defined(__aarch64__)
+    for (int i = 0; i < float_num_vecs(); ++i) {
+      rv[i] = vec256::fmadd(
+          scale, neon_cvt_to_float(vals + 8 * i), scale_zp_premul);
+    }
+#else
     for (int i = 0; i < float_num_vecs(); ++i) {
       for (int j = 0; j < 8; ++j) {
         rv[i][j] =
             at::dequantize_val<T>(scale[j], zero_point[j], T(vals[8 * i + j]));
       }
     }
+#endif
     return rv;
   }
 
@@ -758,29 +833,44 @@ struct Vec256<c10::qint8> : public Vec256QuantizedConverter<
       rhs[i].store(float_vals + i * 8, 8);
     }
 
+#if defined(__aarch64__)
+    QuantizeNeon<c10::qint8>(
+        float_vals, qvals, 8 * float_num_vecs(), inverse_scale, zero_point);
+#else
     at::quantize_vec<c10::qint8>(
         scale,
         zero_point,
         float_vals,
         (c10::qint8*)qvals,
         8 * float_num_vecs());
+#endif
 
     return Vec256<c10::qint8>::loadu(qvals);
   }
 
   Vec256<c10::qint8> maximum(Vec256<c10::qint8> b) const {
     Vec256<c10::qint8> retval;
+#if defined(__aarch64__)
+    vst1q_s8(retval.vals, vmaxq_s8(vld1q_s8(vals), vld1q_s8(b.vals)));
+    vst1q_s8(retval.vals + 16, vmaxq_s8(vld1q_s8(vals + 16), vld1q_s8(b.vals + 16)));
+#else
     for (size_t i = 0; i < size(); ++i) {
       retval.vals[i] = std::max<value_type>(vals[i], b.vals[i]);
     }
+#endif
     return retval;
   }
 
   Vec256<c10::qint8> minimum(Vec256<c10::qint8> b) const {
     Vec256<c10::qint8> retval;
+#if defined(__aarch64__)
+    vst1q_s8(retval.vals, vminq_s8(vld1q_s8(vals), vld1q_s8(b.vals)));
+    vst1q_s8(retval.vals + 16, vminq_s8(vld1q_s8(vals + 16), vld1q_s8(b.vals + 16)));
+#else
     for (size_t i = 0; i < size(); ++i) {
       retval.vals[i] = std::min<value_type>(vals[i], b.vals[i]);
     }
+#endif
     return retval;
   }
 
@@ -836,29 +926,44 @@ struct Vec256<c10::quint8> : public Vec256QuantizedConverter<
       rhs[i].store(float_vals + i * 8, 8);
     }
 
+#if defined(__aarch64__)
+    QuantizeNeon<c10::quint8>(
+        float_vals, qvals, 8 * float_num_vecs(), inverse_scale, zero_point);
+#else
     at::quantize_vec<c10::quint8>(
         scale,
         zero_point,
         float_vals,
         (c10::quint8*)qvals,
         8 * float_num_vecs());
+#endif
 
     return Vec256<c10::quint8>::loadu(qvals);
   }
 
   Vec256<c10::quint8> maximum(Vec256<c10::quint8> b) const {
     Vec256<c10::quint8> retval;
+#if defined(__aarch64__)
+    vst1q_u8(retval.vals, vmaxq_u8(vld1q_u8(vals), vld1q_u8(b.vals)));
+    vst1q_u8(retval.vals + 16, vmaxq_u8(vld1q_u8(vals + 16), vld1q_u8(b.vals + 16)));
+#else
     for (size_t i = 0; i < size(); ++i) {
       retval.vals[i] = std::max<value_type>(vals[i], b.vals[i]);
     }
+#endif
     return retval;
   }
 
   Vec256<c10::quint8> minimum(Vec256<c10::quint8> b) const {
     Vec256<c10::quint8> retval;
+#if defined(__aarch64__)
+    vst1q_u8(retval.vals, vminq_u8(vld1q_u8(vals), vld1q_u8(b.vals)));
+    vst1q_u8(retval.vals + 16, vminq_u8(vld1q_u8(vals + 16), vld1q_u8(b.vals + 16)));
+#else
     for (size_t i = 0; i < size(); ++i) {
       retval.vals[i] = std::min<value_type>(vals[i], b.vals[i]);
     }
+#endif
     return retval;
   }
 
@@ -0,0 +1,431 @@
+#pragma once
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec512/vec512_base.h>
+#if defined(__AVX512F__) && !defined(_MSC_VER)
+#include <sleef.h>
+#endif
+
+#include <tuple>
+
+namespace at {
+namespace vec512 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+#if defined(__AVX512F__) && !defined(_MSC_VER)
+
+// Vec512<BFloat16> holds 32 bfloat16 values and, like Vec256<BFloat16>,
+// computes in fp32 on the two widened halves.
+
+static inline __m512 cvtbf16_fp32(const __m256i& a) {
+  return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(a), 16));
+}
+
+static inline void cvtbf16_fp32(const __m512i& a, __m512& o1, __m512& o2) {
+  o1 = cvtbf16_fp32(_mm512_extracti64x4_epi64(a, 0));
+  o2 = cvtbf16_fp32(_mm512_extracti64x4_epi64(a, 1));
+}
+
+static inline __m256i round_fp32_bf16(const __m512& a) {
+  // See round_fp32_bf16 in vec256_bfloat16.h.
+  auto bits = _mm512_castps_si512(a);
+  auto lsb = _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1));
+  auto bias = _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7fff));
+  auto rounded = _mm512_srli_epi32(_mm512_add_epi32(bits, bias), 16);
+  auto ordered = _mm512_cmp_ps_mask(a, a, _CMP_ORD_Q);
+  rounded = _mm512_mask_blend_epi32(ordered, _mm512_set1_epi32(0x7fc0), rounded);
+  return _mm512_cvtepi32_epi16(rounded);
+}
+
+static inline __m512i cvtfp32_bf16(const __m512& a, const __m512& b) {
+  return _mm512_inserti64x4(
+      _mm512_castsi256_si512(round_fp32_bf16(a)), round_fp32_bf16(b), 1);
+}
+
+template <> class Vec512<BFloat16> {
+private:
+  __m512i values;
+  static inline __m512i from_mask(__mmask16 lo, __mmask16 hi) {
+    __mmask32 mask = static_cast<__mmask32>(lo) | (static_cast<__mmask32>(hi) << 16);
+    return _mm512_maskz_set1_epi16(mask, 0xFFFF);
+  }
+public:
+  using value_type = BFloat16;
+  static constexpr int size() {
+    return 32;
+  }
+  Vec512() {}
+  Vec512(__m512i v) : values(v) {}
+  Vec512(BFloat16 val) {
+    values = _mm512_set1_epi16(val.x);
+  }
+  operator __m512i() const {
+    return values;
+  }
+  template <int64_t mask>
+  static Vec512<BFloat16> blend(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+    return _mm512_mask_blend_epi16(mask, a.values, b.values);
+  }
+  static Vec512<BFloat16> blendv(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b,
+                                 const Vec512<BFloat16>& mask) {
+    return _mm512_mask_blend_epi16(_mm512_movepi16_mask(mask.values), a.values, b.values);
+  }
+  static Vec512<BFloat16> arange(BFloat16 base = 0.f, BFloat16 step = 1.f) {
+    __at_align64__ BFloat16 tmp_values[size()];
+    for (int i = 0; i < size(); i++) {
+      tmp_values[i] = static_cast<float>(base) + i * static_cast<float>(step);
+    }
+    return loadu(tmp_values);
+  }
+  static Vec512<BFloat16> set(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b,
+                              int64_t count = size()) {
+    if (count <= 0) {
+      return a;
+    } else if (count >= size()) {
+      return b;
+    }
+    return _mm512_mask_blend_epi16((1U << count) - 1, a.values, b.values);
+  }
+  static Vec512<BFloat16> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size())
+      return _mm512_loadu_si512(ptr);
+    // Masked-off elements read as zero and never touch memory.
+    return _mm512_maskz_loadu_epi16((1U << count) - 1, ptr);
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm512_storeu_si512(ptr, values);
+    } else if (count > 0) {
+      _mm512_mask_storeu_epi16(ptr, (1U << count) - 1, values);
+    }
+  }
+  const BFloat16& operator[](int idx) const  = delete;
+  BFloat16& operator[](int idx) = delete;
+  // Applies an fp32 vector op to both halves.
+  template <typename Op>
+  Vec512<BFloat16> map(const Op& vop) const {
+    __m512 lo, hi;
+    cvtbf16_fp32(values, lo, hi);
+    return cvtfp32_bf16(vop(lo), vop(hi));
+  }
+  template <typename Op>
+  Vec512<BFloat16> map(const Op& vop, const Vec512<BFloat16>& b) const {
+    __m512 lo, hi, b_lo, b_hi;
+    cvtbf16_fp32(values, lo, hi);
+    cvtbf16_fp32(b.values, b_lo, b_hi);
+    return cvtfp32_bf16(vop(lo, b_lo), vop(hi, b_hi));
+  }
+  Vec512<BFloat16> map(float (*f)(float)) const {
+    __at_align64__ float tmp[size()];
+    __m512 lo, hi;
+    cvtbf16_fp32(values, lo, hi);
+    _mm512_storeu_ps(tmp, lo);
+    _mm512_storeu_ps(tmp + 16, hi);
+    for (int64_t i = 0; i < size(); i++) {
+      tmp[i] = f(tmp[i]);
+    }
+    return cvtfp32_bf16(_mm512_loadu_ps(tmp), _mm512_loadu_ps(tmp + 16));
+  }
+  Vec512<BFloat16> abs() const {
+    return _mm512_andnot_si512(_mm512_set1_epi16(0x8000), values);
+  }
+  Vec512<BFloat16> angle() const {
+    return _mm512_set1_epi16(0);
+  }
+  Vec512<BFloat16> real() const {
+    return *this;
+  }
+  Vec512<BFloat16> imag() const {
+    return _mm512_set1_epi16(0);
+  }
+  Vec512<BFloat16> conj() const {
+    return *this;
+  }
+  Vec512<BFloat16> acos() const {
+    return map(Sleef_acosf16_u10);
+  }
+  Vec512<BFloat16> asin() const {
+    return map(Sleef_asinf16_u10);
+  }
+  Vec512<BFloat16> atan() const {
+    return map(Sleef_atanf16_u10);
+  }
+  Vec512<BFloat16> atan2(const Vec512<BFloat16> &b) const {
+    return map(Sleef_atan2f16_u10, b);
+  }
+  Vec512<BFloat16> erf() const {
+    return map(Sleef_erff16_u10);
+  }
+  Vec512<BFloat16> erfc() const {
+    return map(Sleef_erfcf16_u15);
+  }
+  Vec512<BFloat16> erfinv() const {
+    return map(calc_erfinv);
+  }
+  Vec512<BFloat16> exp() const {
+    return map(Sleef_expf16_u10);
+  }
+  Vec512<BFloat16> expm1() const {
+    return map(Sleef_expm1f16_u10);
+  }
+  Vec512<BFloat16> log() const {
+    return map(Sleef_logf16_u10);
+  }
+  Vec512<BFloat16> log2() const {
+    return map(Sleef_log2f16_u10);
+  }
+  Vec512<BFloat16> log10() const {
+    return map(Sleef_log10f16_u10);
+  }
+  Vec512<BFloat16> log1p() const {
+    return map(Sleef_log1pf16_u10);
+  }
+  Vec512<BFloat16> frac() const {
+    return map([](__m512 x) {
+      return _mm512_sub_ps(x, _mm512_roundscale_ps(x, (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC)));
+    });
+  }
+  Vec512<BFloat16> sin() const {
+    return map(Sleef_sinf16_u10);
+  }
+  Vec512<BFloat16> sinh() const {
+    return map(Sleef_sinhf16_u10);
+  }
+  Vec512<BFloat16> cos() const {
+    return map(Sleef_cosf16_u10);
+  }
+  Vec512<BFloat16> cosh() const {
+    return map(Sleef_coshf16_u10);
+  }
+  Vec512<BFloat16> ceil() const {
+    return map([](__m512 x) {
+      return _mm512_roundscale_ps(x, (_MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC));
+    });
+  }
+  Vec512<BFloat16> floor() const {
+    return map([](__m512 x) {
+      return _mm512_roundscale_ps(x, (_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+    });
+  }
+  Vec512<BFloat16> neg() const {
+    return _mm512_xor_si512(_mm512_set1_epi16(0x8000), values);
+  }
+  Vec512<BFloat16> round() const {
+    return map([](__m512 x) {
+      return _mm512_roundscale_ps(x, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+    });
+  }
+  Vec512<BFloat16> tan() const {
+    return map(Sleef_tanf16_u10);
+  }
+  Vec512<BFloat16> tanh() const {
+    return map(Sleef_tanhf16_u10);
+  }
+  Vec512<BFloat16> trunc() const {
+    return map([](__m512 x) {
+      return _mm512_roundscale_ps(x, (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+    });
+  }
+  Vec512<BFloat16> lgamma() const {
+    return map(Sleef_lgammaf16_u10);
+  }
+  Vec512<BFloat16> sqrt() const {
+    return map([](__m512 x) { return _mm512_sqrt_ps(x); });
+  }
+  Vec512<BFloat16> reciprocal() const {
+    return map([](__m512 x) { return _mm512_div_ps(_mm512_set1_ps(1), x); });
+  }
+  Vec512<BFloat16> rsqrt() const {
+    return map([](__m512 x) {
+      return _mm512_div_ps(_mm512_set1_ps(1), _mm512_sqrt_ps(x));
+    });
+  }
+  Vec512<BFloat16> pow(const Vec512<BFloat16> &b) const {
+    return map(Sleef_powf16_u10, b);
+  }
+#define DEFINE_BF16_COMP(binary_pred, cmp)                                     \
+  Vec512<BFloat16> operator binary_pred(const Vec512<BFloat16>& other) const { \
+    __m512 lo, hi, other_lo, other_hi;                                         \
+    cvtbf16_fp32(values, lo, hi);                                              \
+    cvtbf16_fp32(other.values, other_lo, other_hi);                            \
+    return from_mask(_mm512_cmp_ps_mask(lo, other_lo, cmp),                    \
+                     _mm512_cmp_ps_mask(hi, other_hi, cmp));                   \
+  }
+  DEFINE_BF16_COMP(==, _CMP_EQ_OQ)
+  DEFINE_BF16_COMP(!=, _CMP_NEQ_OQ)
+  DEFINE_BF16_COMP(<, _CMP_LT_OQ)
+  DEFINE_BF16_COMP(<=, _CMP_LE_OQ)
+  DEFINE_BF16_COMP(>, _CMP_GT_OQ)
+  DEFINE_BF16_COMP(>=, _CMP_GE_OQ)
+#undef DEFINE_BF16_COMP
+};
+
+template <typename Op>
+Vec512<BFloat16> inline binary_op_as_fp32(const Vec512<BFloat16>& a,
+                                          const Vec512<BFloat16>& b, const Op& op) {
+  __m512 a_lo, a_hi, b_lo, b_hi;
+  cvtbf16_fp32(a, a_lo, a_hi);
+  cvtbf16_fp32(b, b_lo, b_hi);
+  return cvtfp32_bf16(op(a_lo, b_lo), op(a_hi, b_hi));
+}
+
+template <>
+Vec512<BFloat16> inline operator+(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](__m512 x, __m512 y) { return _mm512_add_ps(x, y); });
+}
+
+template <>
+Vec512<BFloat16> inline operator-(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](__m512 x, __m512 y) { return _mm512_sub_ps(x, y); });
+}
+
+template <>
+Vec512<BFloat16> inline operator*(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](__m512 x, __m512 y) { return _mm512_mul_ps(x, y); });
+}
+
+template <>
+Vec512<BFloat16> inline operator/(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](__m512 x, __m512 y) { return _mm512_div_ps(x, y); });
+}
+
+// Implements the IEEE 754 201X `maximum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vec512<BFloat16> inline maximum(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](__m512 x, __m512 y) {
+    auto max = _mm512_max_ps(x, y);
+    auto isnan = _mm512_cmp_ps_mask(x, y, _CMP_UNORD_Q);
+    auto nan = _mm512_castsi512_ps(_mm512_set1_epi32(0xFFFFFFFF));
+    return _mm512_mask_blend_ps(isnan, max, nan);
+  });
+}
+
+// Implements the IEEE 754 201X `minimum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vec512<BFloat16> inline minimum(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return binary_op_as_fp32(a, b, [](__m512 x, __m512 y) {
+    auto min = _mm512_min_ps(x, y);
+    auto isnan = _mm512_cmp_ps_mask(x, y, _CMP_UNORD_Q);
+    auto nan = _mm512_castsi512_ps(_mm512_set1_epi32(0xFFFFFFFF));
+    return _mm512_mask_blend_ps(isnan, min, nan);
+  });
+}
+
+template <>
+Vec512<BFloat16> inline clamp(const Vec512<BFloat16>& a,
+                              const Vec512<BFloat16>& min, const Vec512<BFloat16>& max) {
+  __m512 a_lo, a_hi, min_lo, min_hi, max_lo, max_hi;
+  cvtbf16_fp32(a, a_lo, a_hi);
+  cvtbf16_fp32(min, min_lo, min_hi);
+  cvtbf16_fp32(max, max_lo, max_hi);
+  return cvtfp32_bf16(_mm512_min_ps(max_lo, _mm512_max_ps(min_lo, a_lo)),
+                      _mm512_min_ps(max_hi, _mm512_max_ps(min_hi, a_hi)));
+}
+
+template <>
+Vec512<BFloat16> inline clamp_max(const Vec512<BFloat16>& a, const Vec512<BFloat16>& max) {
+  return binary_op_as_fp32(max, a, [](__m512 x, __m512 y) { return _mm512_min_ps(x, y); });
+}
+
+template <>
+Vec512<BFloat16> inline clamp_min(const Vec512<BFloat16>& a, const Vec512<BFloat16>& min) {
+  return binary_op_as_fp32(min, a, [](__m512 x, __m512 y) { return _mm512_max_ps(x, y); });
+}
+
+template <>
+Vec512<BFloat16> inline operator&(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return _mm512_and_si512(a, b);
+}
+
+template <>
+Vec512<BFloat16> inline operator|(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return _mm512_or_si512(a, b);
+}
+
+template <>
+Vec512<BFloat16> inline operator^(const Vec512<BFloat16>& a, const Vec512<BFloat16>& b) {
+  return _mm512_xor_si512(a, b);
+}
+
+template <>
+Vec512<BFloat16> inline fmadd(const Vec512<BFloat16>& a,
+                              const Vec512<BFloat16>& b, const Vec512<BFloat16>& c) {
+  __m512 a_lo, a_hi, b_lo, b_hi, c_lo, c_hi;
+  cvtbf16_fp32(a, a_lo, a_hi);
+  cvtbf16_fp32(b, b_lo, b_hi);
+  cvtbf16_fp32(c, c_lo, c_hi);
+  return cvtfp32_bf16(_mm512_fmadd_ps(a_lo, b_lo, c_lo),
+                      _mm512_fmadd_ps(a_hi, b_hi, c_hi));
+}
+
+inline std::tuple<Vec512<float>, Vec512<float>> convert_bfloat16_float(
+    const Vec512<BFloat16>& a) {
+  __m512 lo, hi;
+  cvtbf16_fp32(a, lo, hi);
+  return std::make_tuple(Vec512<float>(lo), Vec512<float>(hi));
+}
+
+inline Vec512<BFloat16> convert_float_bfloat16(const Vec512<float>& a,
+                                               const Vec512<float>& b) {
+  return cvtfp32_bf16(a, b);
+}
+
+template <>
+inline void convert(const BFloat16* src, float* dst, int64_t n) {
+  int64_t i;
+#pragma unroll
+  for (i = 0; i <= (n - 16); i += 16) {
+    auto vsrc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm512_storeu_ps(dst + i, cvtbf16_fp32(vsrc));
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = static_cast<float>(src[i]);
+  }
+}
+
+template <>
+inline void convert(const float* src, BFloat16* dst, int64_t n) {
+  int64_t i;
+#pragma unroll
+  for (i = 0; i <= (n - 16); i += 16) {
+    auto vdst = round_fp32_bf16(_mm512_loadu_ps(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), vdst);
+  }
+#pragma unroll
+  for (; i < n; i++) {
+    dst[i] = static_cast<BFloat16>(src[i]);
+  }
+}
+
+#else
+
+inline std::tuple<Vec512<float>, Vec512<float>> convert_bfloat16_float(
+    const Vec512<BFloat16>& a) {
+  constexpr int64_t K = Vec512<BFloat16>::size();
+  __at_align64__ float arr[K];
+  __at_align64__ BFloat16 arr2[K];
+  a.store(arr2);
+  convert(arr2, arr, K);
+  return std::make_tuple(
+      Vec512<float>::loadu(arr),
+      Vec512<float>::loadu(arr + Vec512<float>::size()));
+}
+
+inline Vec512<BFloat16> convert_float_bfloat16(const Vec512<float>& a,
+                                               const Vec512<float>& b) {
+  constexpr int64_t K = Vec512<BFloat16>::size();
+  __at_align64__ float arr[K];
+  __at_align64__ BFloat16 arr2[K];
+  a.store(arr);
+  b.store(arr + Vec512<float>::size());
+  convert(arr, arr2, K);
+  return Vec512<BFloat16>::loadu(arr2);
+}
+
+#endif
+
+}}}
@@ -0,0 +1,415 @@
+#pragma once
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec512/vec512_base.h>
+#if defined(__AVX512F__) && !defined(_MSC_VER)
+#include <sleef.h>
+#endif
+
+namespace at {
+namespace vec512 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+#if defined(__AVX512F__) && !defined(_MSC_VER)
+
+template <> class Vec512<std::complex<float>> {
+private:
+  __m512 values;
+  // Masks of the real and imaginary parts of the elements.
+  static constexpr __mmask16 real_mask = 0x5555;
+  static constexpr __mmask16 imag_mask = 0xAAAA;
+public:
+  using value_type = std::complex<float>;
+  static constexpr int size() {
+    return 8;
+  }
+  Vec512() {}
+  Vec512(__m512 v) : values(v) {}
+  Vec512(std::complex<float> val) {
+    float real_value = val.real();
+    float imag_value = val.imag();
+    values = _mm512_mask_blend_ps(
+        imag_mask, _mm512_set1_ps(real_value), _mm512_set1_ps(imag_value));
+  }
+  Vec512(std::complex<float> val1, std::complex<float> val2, std::complex<float> val3, std::complex<float> val4,
+         std::complex<float> val5, std::complex<float> val6, std::complex<float> val7, std::complex<float> val8) {
+    values = _mm512_setr_ps(val1.real(), val1.imag(),
+                            val2.real(), val2.imag(),
+                            val3.real(), val3.imag(),
+                            val4.real(), val4.imag(),
+                            val5.real(), val5.imag(),
+                            val6.real(), val6.imag(),
+                            val7.real(), val7.imag(),
+                            val8.real(), val8.imag()
+                            );
+  }
+  operator __m512() const {
+    return values;
+  }
+  template <int64_t mask>
+  static Vec512<std::complex<float>> blend(const Vec512<std::complex<float>>& a, const Vec512<std::complex<float>>& b) {
+    constexpr __mmask16 mask_ = complex_to_value_mask(mask);
+    return _mm512_mask_blend_ps(mask_, a.values, b.values);
+  }
+  static Vec512<std::complex<float>> blendv(const Vec512<std::complex<float>>& a, const Vec512<std::complex<float>>& b,
+                               const Vec512<std::complex<float>>& mask) {
+    // Select on the sign bit of the real part of each element of mask.
+    auto mask_ = _mm512_movepi32_mask(_mm512_castps_si512(_mm512_moveldup_ps(mask.values)));
+    return _mm512_mask_blend_ps(mask_, a.values, b.values);
+  }
+  static Vec512<std::complex<float>> arange(std::complex<float> base = 0., std::complex<float> step = 1.) {
+    return Vec512<std::complex<float>>(base,
+                                       base + step,
+                                       base + std::complex<float>(2)*step,
+                                       base + std::complex<float>(3)*step,
+                                       base + std::complex<float>(4)*step,
+                                       base + std::complex<float>(5)*step,
+                                       base + std::complex<float>(6)*step,
+                                       base + std::complex<float>(7)*step);
+  }
+  static Vec512<std::complex<float>> set(const Vec512<std::complex<float>>& a, const Vec512<std::complex<float>>& b,
+                            int64_t count = size()) {
+    if (count >= size()) {
+      return b;
+    }
+    __mmask16 mask = (1ULL << (2 * count)) - 1;
+    return _mm512_mask_blend_ps(mask, a.values, b.values);
+  }
+  static Vec512<std::complex<float>> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size())
+      return _mm512_loadu_ps(reinterpret_cast<const float*>(ptr));
+    // Masked out elements are zeroed and are not read from memory.
+    __mmask16 mask = (1ULL << (2 * count)) - 1;
+    return _mm512_maskz_loadu_ps(mask, ptr);
+  }
+  void store(void* ptr, int count = size()) const {
+    if (count == size()) {
+      _mm512_storeu_ps(reinterpret_cast<float*>(ptr), values);
+    } else if (count > 0) {
+      __mmask16 mask = (1ULL << (2 * count)) - 1;
+      _mm512_mask_storeu_ps(ptr, mask, values);
+    }
+  }
+  const std::complex<float>& operator[](int idx) const  = delete;
+  std::complex<float>& operator[](int idx) = delete;
+  Vec512<std::complex<float>> map(std::complex<float> (*f)(const std::complex<float> &)) const {
+    __at_align64__ std::complex<float> tmp[size()];
+    store(tmp);
+    for (int i = 0; i < size(); i++) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+  __m512 abs_2_() const {
+    auto val_2 = _mm512_mul_ps(values, values);                 // a*a     b*b
+    return _mm512_add_ps(val_2, _mm512_permute_ps(val_2, 0xB1)); // a*a+b*b a*a+b*b
+  }
+  __m512 abs_() const {
+    return _mm512_sqrt_ps(abs_2_());                            // abs     abs
+  }
+  Vec512<std::complex<float>> abs() const {
+    return _mm512_maskz_mov_ps(real_mask, abs_());              // abs     0
+  }
+  __m512 angle_() const {
+    //angle = atan2(b/a)
+    auto b_a = _mm512_permute_ps(values, 0xB1);                 // b        a
+    return Sleef_atan2f16_u10(values, b_a);                     // 90-angle angle
+  }
+  Vec512<std::complex<float>> angle() const {
+    auto angle = _mm512_permute_ps(angle_(), 0xB1);             // angle    90-angle
+    return _mm512_maskz_mov_ps(real_mask, angle);               // angle    0
+  }
+  __m512 real_() const {
+    return _mm512_maskz_mov_ps(real_mask, values);
+  }
+  Vec512<std::complex<float>> real() const {
+    return real_();
+  }
+  __m512 imag_() const {
+    return _mm512_maskz_mov_ps(imag_mask, values);
+  }
+  Vec512<std::complex<float>> imag() const {
+    return _mm512_permute_ps(imag_(), 0xB1);                    //b        a
+  }
+  __m512 conj_() const {
+    const __m512 sign_mask = _mm512_maskz_mov_ps(imag_mask, _mm512_set1_ps(-0.0));
+    return _mm512_xor_ps(values, sign_mask);                    // a       -b
+  }
+  Vec512<std::complex<float>> conj() const {
+    return conj_();
+  }
+  Vec512<std::complex<float>> log() const {
+    // Most trigonomic ops use the log() op to improve complex number performance.
+    return map(std::log);
+  }
+  Vec512<std::complex<float>> log2() const {
+    const __m512 log2_ = _mm512_set1_ps(std::log(2));
+    return _mm512_div_ps(log(), log2_);
+  }
+  Vec512<std::complex<float>> log10() const {
+    const __m512 log10_ = _mm512_set1_ps(std::log(10));
+    return _mm512_div_ps(log(), log10_);
+  }
+  Vec512<std::complex<float>> log1p() const {
+    AT_ERROR("not supported for complex numbers");
+  }
+  Vec512<std::complex<float>> asin() const {
+    // asin(x)
+    // = -i*ln(iz + sqrt(1 -z^2))
+    // = -i*ln((ai - b) + sqrt(1 - (a + bi)*(a + bi)))
+    // = -i*ln((-b + ai) + sqrt(1 - (a**2 - b**2) - 2*abi))
+    const __m512 one = _mm512_set1_ps(1);
+
+    auto conj = conj_();
+    auto b_a = _mm512_permute_ps(conj, 0xB1);                         //-b        a
+    auto ab = _mm512_mul_ps(conj, b_a);                               //-ab       -ab
+    auto im = _mm512_add_ps(ab, ab);                                  //-2ab      -2ab
+
+    auto val_2 = _mm512_mul_ps(values, values);                       // a*a      b*b
+    auto re = _mm512_sub_ps(val_2, _mm512_permute_ps(val_2, 0xB1));   // a*a-b*b  b*b-a*a
+    re = _mm512_sub_ps(one, re);
+
+    auto root = Vec512(_mm512_mask_blend_ps(imag_mask, re, im)).sqrt(); //sqrt(re + i*im)
+    auto ln = Vec512(_mm512_add_ps(b_a, root)).log();                 //ln(iz + sqrt())
+    return Vec512(_mm512_permute_ps(ln.values, 0xB1)).conj();         //-i*ln()
+  }
+  Vec512<std::complex<float>> acos() const {
+    // acos(x) = pi/2 - asin(x)
+    const __m512 pi_2 = _mm512_maskz_mov_ps(real_mask, _mm512_set1_ps(M_PI/2));
+    return _mm512_sub_ps(pi_2, asin());
+  }
+  Vec512<std::complex<float>> atan() const;
+  Vec512<std::complex<float>> atan2(const Vec512<std::complex<float>> &b) const {
+    AT_ERROR("not supported for complex numbers");
+  }
+  Vec512<std::complex<float>> erf() const {
+    AT_ERROR("not supported for complex numbers");
+  }
+  Vec512<std::complex<float>> erfc() const {
+    AT_ERROR("not supported for complex numbers");
+  }
+  Vec512<std::complex<float>> exp() const {
+    //exp(a + bi)
+    // = exp(a)*(cos(b) + sin(b)i)
+    auto exp = Sleef_expf16_u10(values);                                        //exp(a)           exp(b)
+    exp = _mm512_mask_blend_ps(imag_mask, exp, _mm512_permute_ps(exp, 0xB1));   //exp(a)           exp(a)
+
+    auto sin_cos = Sleef_sincosf16_u10(values);                                 //[sin(a), cos(a)] [sin(b), cos(b)]
+    auto cos_sin = _mm512_mask_blend_ps(imag_mask, _mm512_permute_ps(sin_cos.y, 0xB1),
+                                        sin_cos.x);                             //cos(b)           sin(b)
+    return _mm512_mul_ps(exp, cos_sin);
+  }
+  Vec512<std::complex<float>> expm1() const {
+    AT_ERROR("not supported for complex numbers");
+  }
+  Vec512<std::complex<float>> sin() const {
+    return map(std::sin);
+  }
+  Vec512<std::complex<float>> sinh() const {
+    return map(std::sinh);
+  }
+  Vec512<std::complex<float>> cos() const {
+    return map(std::cos);
+  }
+  Vec512<std::complex<float>> cosh() const {
+    return map(std::cosh);
+  }
+  Vec512<std::complex<float>> ceil() const {
+    return _mm512_roundscale_ps(values, (_MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC));
+  }
+  Vec512<std::complex<float>> floor() const {
+    return _mm512_roundscale_ps(values, (_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+  }
+  Vec512<std::complex<float>> neg() const {
+    auto zero = _mm512_setzero_ps();
+    return _mm512_sub_ps(zero, values);
+  }
+  Vec512<std::complex<float>> round() const {
+    return _mm512_roundscale_ps(values, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+  Vec512<std::complex<float>> tan() const {
+    return map(std::tan);
+  }
+  Vec512<std::complex<float>> tanh() const {
+    return map(std::tanh);
+  }
+  Vec512<std::complex<float>> trunc() const {
+    return _mm512_roundscale_ps(values, (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+  }
+  Vec512<std::complex<float>> sqrt() const {
+    //   sqrt(a + bi)
+    // = sqrt(2)/2 * [sqrt(sqrt(a**2 + b**2) + a) + sgn(b)*sqrt(sqrt(a**2 + b**2) - a)i]
+    // = sqrt(2)/2 * [sqrt(abs() + a) + sgn(b)*sqrt(abs() - a)i]
+
+    const __m512 scalar = _mm512_set1_ps(std::sqrt(2)/2);              //sqrt(2)/2      sqrt(2)/2
+    const __m512 sign_mask = _mm512_maskz_mov_ps(imag_mask, _mm512_set1_ps(-0.0));
+    auto sign = _mm512_and_ps(values, sign_mask);
+    auto factor = _mm512_or_ps(scalar, sign);
+
+    auto a_a = _mm512_xor_ps(_mm512_moveldup_ps(values), sign_mask);   // a             -a
+    auto res_re_im = _mm512_sqrt_ps(_mm512_add_ps(abs_(), a_a));       // sqrt(abs + a) sqrt(abs - a)
+    return _mm512_mul_ps(factor, res_re_im);
+  }
+  Vec512<std::complex<float>> reciprocal() const;
+  Vec512<std::complex<float>> rsqrt() const {
+    return sqrt().reciprocal();
+  }
+  Vec512<std::complex<float>> pow(const Vec512<std::complex<float>> &exp) const {
+    __at_align64__ std::complex<float> x_tmp[size()];
+    __at_align64__ std::complex<float> y_tmp[size()];
+    store(x_tmp);
+    exp.store(y_tmp);
+    for (int i = 0; i < size(); i++) {
+      x_tmp[i] = std::pow(x_tmp[i], y_tmp[i]);
+    }
+    return loadu(x_tmp);
+  }
+  // Comparisons return all-ones in the elements where they hold, using the
+  // _CMP_**_OQ predicate.
+  //   `O`: get false if an operand is NaN
+  //   `Q`: do not raise if an operand is NaN
+  Vec512<std::complex<float>> operator==(const Vec512<std::complex<float>>& other) const {
+    auto mask = _mm512_cmp_ps_mask(values, other.values, _CMP_EQ_OQ);
+    return _mm512_castsi512_ps(_mm512_maskz_set1_epi32(mask, 0xFFFFFFFF));
+  }
+  Vec512<std::complex<float>> operator!=(const Vec512<std::complex<float>>& other) const {
+    auto mask = _mm512_cmp_ps_mask(values, other.values, _CMP_NEQ_OQ);
+    return _mm512_castsi512_ps(_mm512_maskz_set1_epi32(mask, 0xFFFFFFFF));
+  }
+  Vec512<std::complex<float>> operator<(const Vec512<std::complex<float>>& other) const {
+    AT_ERROR("not supported for complex numbers");
+  }
+  Vec512<std::complex<float>> operator<=(const Vec512<std::complex<float>>& other) const {
+    AT_ERROR("not supported for complex numbers");
+  }
+  Vec512<std::complex<float>> operator>(const Vec512<std::complex<float>>& other) const {
+    AT_ERROR("not supported for complex numbers");
+  }
+  Vec512<std::complex<float>> operator>=(const Vec512<std::complex<float>>& other) const {
+    AT_ERROR("not supported for complex numbers");
+  }
+};
+
+template <> Vec512<std::complex<float>> inline operator+(const Vec512<std::complex<float>> &a, const Vec512<std::complex<float>> &b) {
+  return _mm512_add_ps(a, b);
+}
+
+template <> Vec512<std::complex<float>> inline operator-(const Vec512<std::complex<float>> &a, const Vec512<std::complex<float>> &b) {
+  return _mm512_sub_ps(a, b);
+}
+
+template <> Vec512<std::complex<float>> inline operator*(const Vec512<std::complex<float>> &a, const Vec512<std::complex<float>> &b) {
+  //(a + bi)  * (c + di) = (ac - bd) + (ad + bc)i
+  auto a_a = _mm512_moveldup_ps(a);             //a        a
+  auto b_b = _mm512_movehdup_ps(a);             //b        b
+  auto d_c = _mm512_permute_ps(b, 0xB1);        //d        c
+  auto bd_bc = _mm512_mul_ps(b_b, d_c);         //bd       bc
+  return _mm512_fmaddsub_ps(a_a, b, bd_bc);     //ac - bd  ad + bc
+}
+
+template <> Vec512<std::complex<float>> inline operator/(const Vec512<std::complex<float>> &a, const Vec512<std::complex<float>> &b) {
+  //re + im*i = (a + bi)  / (c + di)
+  //re = (ac + bd)/abs_2()
+  //im = (bc - ad)/abs_2()
+  const __m512 sign_mask = _mm512_maskz_mov_ps(0xAAAA, _mm512_set1_ps(-0.0));
+  auto a_a = _mm512_moveldup_ps(a);             //a        a
+  auto b_b = _mm512_movehdup_ps(a);             //b        b
+  auto d_c = _mm512_permute_ps(b, 0xB1);        //d        c
+  auto bd_bc = _mm512_mul_ps(b_b, d_c);         //bd       bc
+  auto re_im = _mm512_fmsubadd_ps(a_a, b, bd_bc); //ac + bd  ad - bc
+  re_im = _mm512_xor_ps(re_im, sign_mask);      //ac + bd  bc - ad
+  return _mm512_div_ps(re_im, b.abs_2_());
+}
+
+// reciprocal. Implement this here so we can use multiplication.
+Vec512<std::complex<float>> Vec512<std::complex<float>>::reciprocal() const {
+  //re + im*i = (a + bi)  / (c + di)
+  //re = (ac + bd)/abs_2() = c/abs_2()
+  //im = (bc - ad)/abs_2() = d/abs_2()
+  return _mm512_div_ps(conj_(), abs_2_());     //c       -d
+}
+
+Vec512<std::complex<float>> Vec512<std::complex<float>>::atan() const {
+  // atan(x) = i/2 * ln((i + z)/(i - z))
+  const __m512 i = _mm512_maskz_mov_ps(imag_mask, _mm512_set1_ps(1.0));
+  const Vec512 i_half = _mm512_maskz_mov_ps(imag_mask, _mm512_set1_ps(0.5));
+
+  auto sum = Vec512(_mm512_add_ps(i, values));                      // a        1+b
+  auto sub = Vec512(_mm512_sub_ps(i, values));                      // -a       1-b
+  auto ln = (sum/sub).log();                                        // ln((i + z)/(i - z))
+  return i_half*ln;                                                 // i/2*ln()
+}
+
+template <>
+Vec512<std::complex<float>> inline maximum(const Vec512<std::complex<float>>& a, const Vec512<std::complex<float>>& b) {
+  auto abs_a = a.abs_2_();
+  auto abs_b = b.abs_2_();
+  auto mask = _mm512_cmp_ps_mask(abs_a, abs_b, _CMP_LT_OQ);
+  auto max = _mm512_mask_blend_ps(mask, a, b);
+  // Exploit the fact that all-ones is a NaN.
+  auto isnan = _mm512_cmp_ps_mask(abs_a, abs_b, _CMP_UNORD_Q);
+  auto nan = _mm512_castsi512_ps(_mm512_set1_epi32(0xFFFFFFFF));
+  return _mm512_mask_blend_ps(isnan, max, nan);
+}
+
+template <>
+Vec512<std::complex<float>> inline minimum(const Vec512<std::complex<float>>& a, const Vec512<std::complex<float>>& b) {
+  auto abs_a = a.abs_2_();
+  auto abs_b = b.abs_2_();
+  auto mask = _mm512_cmp_ps_mask(abs_a, abs_b, _CMP_GT_OQ);
+  auto min = _mm512_mask_blend_ps(mask, a, b);
+  // Exploit the fact that all-ones is a NaN.
+  auto isnan = _mm512_cmp_ps_mask(abs_a, abs_b, _CMP_UNORD_Q);
+  auto nan = _mm512_castsi512_ps(_mm512_set1_epi32(0xFFFFFFFF));
+  return _mm512_mask_blend_ps(isnan, min, nan);
+}
+
+template <>
+Vec512<std::complex<float>> inline clamp(const Vec512<std::complex<float>>& a, const Vec512<std::complex<float>>& min, const Vec512<std::complex<float>>& max) {
+  auto abs_a = a.abs_2_();
+  auto abs_min = min.abs_2_();
+  auto max_mask = _mm512_cmp_ps_mask(abs_a, abs_min, _CMP_LT_OQ);
+  auto abs_max = max.abs_2_();
+  auto min_mask = _mm512_cmp_ps_mask(abs_a, abs_max, _CMP_GT_OQ);
+  return _mm512_mask_blend_ps(min_mask, _mm512_mask_blend_ps(max_mask, a, min), max);
+}
+
+template <>
+Vec512<std::complex<float>> inline clamp_min(const Vec512<std::complex<float>>& a, const Vec512<std::complex<float>>& min) {
+  auto abs_a = a.abs_2_();
+  auto abs_min = min.abs_2_();
+  auto max_mask = _mm512_cmp_ps_mask(abs_a, abs_min, _CMP_LT_OQ);
+  return _mm512_mask_blend_ps(max_mask, a, min);
+}
+
+template <>
+Vec512<std::complex<float>> inline clamp_max(const Vec512<std::complex<float>>& a, const Vec512<std::complex<float>>& max) {
+  auto abs_a = a.abs_2_();
+  auto abs_max = max.abs_2_();
+  auto min_mask = _mm512_cmp_ps_mask(abs_a, abs_max, _CMP_GT_OQ);
+  return _mm512_mask_blend_ps(min_mask, a, max);
+}
+
+template <>
+Vec512<std::complex<float>> inline operator&(const Vec512<std::complex<float>>& a, const Vec512<std::complex<float>>& b) {
+  return _mm512_and_ps(a, b);
+}
+
+template <>
+Vec512<std::complex<float>> inline operator|(const Vec512<std::complex<float>>& a, const Vec512<std::complex<float>>& b) {
+  return _mm512_or_ps(a, b);
+}
+
+template <>
+Vec512<std::complex<float>> inline operator^(const Vec512<std::complex<float>>& a, const Vec512<std::complex<float>>& b) {
+  return _mm512_xor_ps(a, b);
+}
+
+template <> inline Vec512<std::complex<float>> fmadd(const Vec512<std::complex<float>>& a, const Vec512<std::complex<float>>& b, const Vec512<std::complex<float>>& c) {
+  return a * b + c;
+}
+
+#endif
+
+}}}
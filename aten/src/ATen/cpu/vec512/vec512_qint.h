@@ -0,0 +1,565 @@
+#pragma once
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec512/vec512_base.h>
+#include <ATen/quantized/Quantizer.h>
+#include <c10/util/qint8.h>
+#include <c10/util/quint8.h>
+#include <c10/util/qint32.h>
+
+
+#include <array>
+
+// This file defines Vec512<> for the quantized types, see vec256_qint.h.
+//
+// Conversions are as follows:
+//  Vec512<qint8> -> 4x Vec512<float>
+//  Vec512<quint8> -> 4x Vec512<float>
+//  Vec512<qint32> -> 1x Vec512<float>
+
+namespace at {
+namespace vec512 {
+namespace {
+
+#if defined(__AVX512F__) && !defined(_MSC_VER)
+
+template <typename T>
+inline void __attribute__((always_inline)) QuantizeAvx512(
+    const float* src,
+    typename T::underlying* dst,
+    int len,
+    float inverse_scale,
+    int64_t zero_point) {
+  constexpr int VLEN = 16;
+  constexpr auto min_val = std::numeric_limits<typename T::underlying>::min();
+  constexpr auto max_val = std::numeric_limits<typename T::underlying>::max();
+  int i = 0;
+  __m512 inverse_scale_v = _mm512_set1_ps(inverse_scale);
+  __m512 zero_point_v = _mm512_set1_ps(zero_point);
+  __m512i min_v = _mm512_set1_epi32(min_val);
+  __m512i max_v = _mm512_set1_epi32(max_val);
+  int len_aligned = len / VLEN * VLEN;
+  for (; i < len_aligned; i += VLEN) {
+    __m512 x_vals = _mm512_loadu_ps(src + i);
+    __m512 x_transformed_v =
+        _mm512_fmadd_ps(x_vals, inverse_scale_v, zero_point_v);
+    // Rounds to even in halfway cases, like the AVX2 version.
+    __m512i x_rounded_v = _mm512_cvtps_epi32(x_transformed_v);
+    __m512i x_clamped_v =
+        _mm512_min_epi32(_mm512_max_epi32(x_rounded_v, min_v), max_v);
+    // The values are in range, so the narrowing conversion doesn't need to
+    // saturate.
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + i), _mm512_cvtepi32_epi8(x_clamped_v));
+  }
+
+  for (; i < len; ++i) {
+    float transformed = zero_point + src[i] * inverse_scale;
+    float clipped =
+        std::min(std::max(transformed, float(min_val)), float(max_val));
+    // See the note in QuantizeAvx2 about the rounding mode.
+    dst[i] = nearbyint(clipped);
+  }
+}
+
+template<>
+struct Vec512<c10::qint8> {
+    static constexpr int size() {
+        return 64;
+    }
+
+    static constexpr int float_num_vecs() {
+        return 4;
+    }
+
+    using float_vec_return_type = std::array<Vec512<float>, 4>;
+    using value_type = typename c10::qint8::underlying;
+
+ private:
+    __m512i vals __attribute__((aligned(64)));
+ public:
+
+    // Broadcast constructor
+    Vec512(const c10::qint8& val) {
+        value_type uw = val.val_;
+        vals = _mm512_set1_epi8(uw);
+    }
+
+    // This is needed because the compiler emits awful code for the default
+    // constructor for moving the enum
+    Vec512(const Vec512<c10::qint8>& other) {
+        vals = other.vals;
+    }
+
+    void store(void* ptr, int count = size()) const {
+        if (count != size()) {
+            memcpy(ptr, &vals, count * sizeof(value_type));
+        } else {
+            _mm512_storeu_si512(ptr, vals);
+        }
+    }
+
+    static Vec512<c10::qint8> loadu(const void* ptr) {
+        return Vec512<c10::qint8>(ptr);
+    }
+
+ public:
+  float_vec_return_type dequantize(
+      Vec512<float> scale,
+      Vec512<float> zero_point,
+      Vec512<float> scale_neg_zp_premul) const {
+    __m512 float_val0 = _mm512_cvtepi32_ps(
+        _mm512_cvtepi8_epi32(_mm512_extracti32x4_epi32(vals, 0)));
+    __m512 float_val1 = _mm512_cvtepi32_ps(
+        _mm512_cvtepi8_epi32(_mm512_extracti32x4_epi32(vals, 1)));
+    __m512 float_val2 = _mm512_cvtepi32_ps(
+        _mm512_cvtepi8_epi32(_mm512_extracti32x4_epi32(vals, 2)));
+    __m512 float_val3 = _mm512_cvtepi32_ps(
+        _mm512_cvtepi8_epi32(_mm512_extracti32x4_epi32(vals, 3)));
+
+    auto val0 =
+        vec512::fmadd(scale, Vec512<float>(float_val0), scale_neg_zp_premul);
+    auto val1 =
+        vec512::fmadd(scale, Vec512<float>(float_val1), scale_neg_zp_premul);
+    auto val2 =
+        vec512::fmadd(scale, Vec512<float>(float_val2), scale_neg_zp_premul);
+    auto val3 =
+        vec512::fmadd(scale, Vec512<float>(float_val3), scale_neg_zp_premul);
+    return {val0, val1, val2, val3};
+  }
+
+  static Vec512<c10::qint8> quantize(
+      const float_vec_return_type& rhs,
+      float scale,
+      int32_t zero_point,
+      float inverse_scale) {
+    auto* rhs_data = (float*)rhs.data();
+    int8_t quantized_values[64];
+    QuantizeAvx512<c10::qint8>(
+        rhs_data, quantized_values, 64, inverse_scale, zero_point);
+    return Vec512<c10::qint8>::loadu(quantized_values);
+  }
+
+  Vec512<c10::qint8> maximum(Vec512<c10::qint8> b) const {
+      return _mm512_max_epi8(vals, b.vals);
+    }
+
+  Vec512<c10::qint8> minimum(Vec512<c10::qint8> b) const {
+      return _mm512_min_epi8(vals, b.vals);
+    }
+
+    Vec512<c10::qint8> relu(Vec512<c10::qint8> zero_point) const {
+        return maximum(zero_point);
+    }
+
+    Vec512<c10::qint8> relu6(
+        Vec512<c10::qint8> zero_point,
+        Vec512<c10::qint8> q_six) {
+      return _mm512_min_epi8(
+          _mm512_max_epi8(vals, zero_point.vals), q_six.vals);
+    }
+
+    void dump() const {
+        for (size_t i = 0; i < size(); ++i) {
+            std::cout << (int)((value_type*)&vals)[i] << " ";
+        }
+        std::cout << std::endl;
+    }
+ private:
+    Vec512() {}
+
+    Vec512(__m512i vals_) : vals(vals_) {}
+
+    // Load from memory constructor
+    Vec512(const void* ptr) {
+        vals = _mm512_loadu_si512(ptr);
+    }
+};
+
+template <>
+Vec512<c10::qint8> inline maximum(const Vec512<c10::qint8>& a, const Vec512<c10::qint8>& b) {
+  return a.maximum(b);
+}
+
+template<>
+struct Vec512<c10::quint8> {
+    static constexpr int size() {
+        return 64;
+    }
+
+    static constexpr int float_num_vecs() {
+        return 4;
+    }
+
+    using float_vec_return_type = std::array<Vec512<float>, 4>;
+    using value_type = typename c10::quint8::underlying;
+
+ private:
+    __m512i vals __attribute__((aligned(64)));
+
+ public:
+    // Broadcast constructor
+    Vec512(const c10::quint8& val) {
+        value_type uw = val.val_;
+        vals = _mm512_set1_epi8(uw);
+    }
+
+    Vec512(const Vec512<c10::quint8>& other) {
+        vals = other.vals;
+    }
+
+    void store(void* ptr, int count = size()) const {
+        if (count != size()) {
+            memcpy(ptr, &vals, count * sizeof(value_type));
+        } else {
+            _mm512_storeu_si512(ptr, vals);
+        }
+    }
+
+    static Vec512<c10::quint8> loadu(const void* ptr) {
+        return Vec512<c10::quint8>(ptr);
+    }
+
+ public:
+  float_vec_return_type dequantize(
+      Vec512<float> scale,
+      Vec512<float> zero_point,
+      Vec512<float> scale_zp_premul) const {
+    __m512 float_val0 = _mm512_cvtepi32_ps(
+        _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(vals, 0)));
+    __m512 float_val1 = _mm512_cvtepi32_ps(
+        _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(vals, 1)));
+    __m512 float_val2 = _mm512_cvtepi32_ps(
+        _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(vals, 2)));
+    __m512 float_val3 = _mm512_cvtepi32_ps(
+        _mm512_cvtepu8_epi32(_mm512_extracti32x4_epi32(vals, 3)));
+
+    auto val0 =
+        vec512::fmadd(scale, Vec512<float>(float_val0), scale_zp_premul);
+    auto val1 =
+        vec512::fmadd(scale, Vec512<float>(float_val1), scale_zp_premul);
+    auto val2 =
+        vec512::fmadd(scale, Vec512<float>(float_val2), scale_zp_premul);
+    auto val3 =
+        vec512::fmadd(scale, Vec512<float>(float_val3), scale_zp_premul);
+    return {val0, val1, val2, val3};
+  }
+
+  static Vec512<c10::quint8> quantize(
+      const float_vec_return_type& rhs,
+      float scale,
+      int32_t zero_point,
+      float inverse_scale) {
+    auto* rhs_data = (float*)rhs.data();
+    uint8_t quantized_values[64];
+    QuantizeAvx512<c10::quint8>(
+        rhs_data, quantized_values, 64, inverse_scale, zero_point);
+    return Vec512<c10::quint8>::loadu(quantized_values);
+  }
+
+  Vec512<c10::quint8> maximum(Vec512<c10::quint8> b) const {
+      return _mm512_max_epu8(vals, b.vals);
+    }
+
+  Vec512<c10::quint8> minimum(Vec512<c10::quint8> b) const {
+      return _mm512_min_epu8(vals, b.vals);
+    }
+
+    Vec512<c10::quint8> relu(Vec512<c10::quint8> zero_point) const {
+        return maximum(zero_point);
+    }
+
+    Vec512<c10::quint8> relu6(
+        Vec512<c10::quint8> zero_point,
+        Vec512<c10::quint8> q_six) {
+      return _mm512_min_epu8(
+          _mm512_max_epu8(vals, zero_point.vals), q_six.vals);
+    }
+
+    void dump() const {
+        for (size_t i = 0; i < size(); ++i) {
+            std::cout << (int)((value_type*)&vals)[i] << " ";
+        }
+        std::cout << std::endl;
+    }
+ private:
+    Vec512() {}
+
+    Vec512(__m512i vals_) : vals(vals_) {}
+
+    // Load from memory constructor
+    Vec512(const void* ptr) {
+        vals = _mm512_loadu_si512(ptr);
+    }
+};
+
+template <>
+Vec512<c10::quint8> inline maximum(const Vec512<c10::quint8>& a, const Vec512<c10::quint8>& b) {
+  return a.maximum(b);
+}
+
+template<>
+struct Vec512<c10::qint32> {
+    static constexpr int size() {
+        return 16;
+    }
+
+    static constexpr int float_num_vecs() {
+        return 1;
+    }
+
+    using float_vec_return_type = std::array<Vec512<float>, 1>;
+    using value_type = c10::qint32::underlying;
+
+ private:
+    __m512i vals __attribute__((aligned(64)));
+ public:
+
+    // Broadcast constructor
+    Vec512(const c10::qint32& val) {
+        value_type uw = val.val_;
+        vals = _mm512_set1_epi32(uw);
+    }
+
+    void store(void* ptr, int count = size()) const {
+      if (count != size()) {
+        memcpy(ptr, &vals, count * sizeof(value_type));
+      } else {
+        _mm512_storeu_si512(ptr, vals);
+      }
+    }
+
+    static Vec512<c10::qint32> loadu(const void* ptr) {
+        return Vec512<c10::qint32>(ptr);
+    }
+
+    float_vec_return_type dequantize(
+        Vec512<float> scale,
+        Vec512<float> zero_point,
+        Vec512<float> scale_zp_premul) const {
+      __m512 float_vals = _mm512_cvtepi32_ps(vals);
+      return {vec512::fmadd(scale, Vec512<float>(float_vals), scale_zp_premul)};
+    }
+
+    static Vec512<c10::qint32> quantize(
+        const float_vec_return_type& rhs,
+        float scale,
+        int32_t zero_point,
+        float inverse_scale) {
+      Vec512<c10::qint32> retval;
+      auto rhs_data = (__m512)rhs[0];
+      at::quantize_vec<c10::qint32, /*precision=*/32>(
+          scale, zero_point, (float*)&rhs_data, (c10::qint32*)&retval.vals, 16);
+      return retval;
+    }
+
+    Vec512<c10::qint32> maximum(Vec512<c10::qint32> b) const {
+      return _mm512_max_epi32(vals, b.vals);
+    }
+
+    Vec512<c10::qint32> minimum(Vec512<c10::qint32> b) const {
+      return _mm512_min_epi32(vals, b.vals);
+    }
+
+    Vec512<c10::qint32> relu(Vec512<c10::qint32> zero_point) const {
+        return maximum(zero_point);
+    }
+
+    Vec512<c10::qint32> relu6(
+        Vec512<c10::qint32> zero_point,
+        Vec512<c10::qint32> q_six) {
+      return _mm512_min_epi32(
+          _mm512_max_epi32(vals, zero_point.vals), q_six.vals);
+    }
+
+    void dump() const {
+        for (size_t i = 0; i < 16; ++i) {
+          std::cout << ((int32_t*)&vals)[i] << " ";
+        }
+        std::cout << std::endl;
+    }
+ private:
+    Vec512() {}
+
+    Vec512(__m512i vals_) : vals(vals_) {}
+
+    // Load from memory constructor
+    Vec512(const void* ptr) {
+      vals = _mm512_loadu_si512(ptr);
+    }
+};
+
+template <>
+Vec512<c10::qint32> inline maximum(const Vec512<c10::qint32>& a, const Vec512<c10::qint32>& b) {
+  return a.maximum(b);
+}
+
+#else
+
+// NOTE: Reference implementations for builds without AVX-512, like the
+// non-AVX2 ones in vec256_qint.h.
+
+template <typename T, typename float_vec_return_type_, int size_>
+struct Vec512QuantizedConverter {
+  static constexpr int size() {
+    return size_;
+  }
+
+  static constexpr int float_num_vecs() {
+    return size() / 16;
+  }
+
+  using float_vec_return_type = float_vec_return_type_;
+
+  using value_type = typename T::underlying;
+  value_type vals[size()];
+
+  Vec512QuantizedConverter(T val) {
+    for (size_t i = 0; i < size(); ++i) {
+      vals[i] = val.val_;
+    }
+  }
+
+  Vec512QuantizedConverter(const void* ptr) {
+    memcpy(vals, ptr, sizeof(value_type) * size());
+  }
+
+  void store(void* ptr, int count = size()) const {
+    memcpy(ptr, vals, count * sizeof(value_type));
+  }
+
+  float_vec_return_type dequantize(
+      Vec512<float> scale,
+      Vec512<float> zero_point,
+      Vec512<float> scale_zp_premul) const {
+    float_vec_return_type rv;
+    for (int i = 0; i < float_num_vecs(); ++i) {
+      for (int j = 0; j < 16; ++j) {
+        rv[i][j] =
+            at::dequantize_val<T>(scale[j], zero_point[j], T(vals[16 * i + j]));
+      }
+    }
+    return rv;
+  }
+
+  void dump() const {
+      for (int i = 0; i < size(); ++i) {
+          std::cout << vals[i] << " ";
+      }
+      std::cout << std::endl;
+  }
+
+ protected:
+  Vec512QuantizedConverter() {}
+};
+
+template <typename T, int size_>
+struct Vec512QuantizedType : public Vec512QuantizedConverter<
+                                 T,
+                                 std::array<Vec512<float>, size_ / 16>,
+                                 size_> {
+  using Converter = Vec512QuantizedConverter<
+      T,
+      std::array<Vec512<float>, size_ / 16>,
+      size_>;
+  using typename Converter::float_vec_return_type;
+  using typename Converter::value_type;
+  using Converter::float_num_vecs;
+  using Converter::size;
+  using Converter::vals;
+
+  Vec512QuantizedType(T val) : Converter(val) {}
+  Vec512QuantizedType(const void* ptr) : Converter(ptr) {}
+
+ protected:
+  Vec512QuantizedType() {}
+
+  template <typename Vec, typename F>
+  static Vec zip(const Vec& a, const Vec& b, const F& f) {
+    Vec retval;
+    for (size_t i = 0; i < size(); ++i) {
+      retval.vals[i] = f(a.vals[i], b.vals[i]);
+    }
+    return retval;
+  }
+
+  template <typename Vec>
+  static Vec quantize_impl(
+      const float_vec_return_type& rhs,
+      float scale,
+      int32_t zero_point) {
+    value_type qvals[size()];
+    float float_vals[float_num_vecs() * 16];
+
+    for (int i = 0; i < float_num_vecs(); ++i) {
+      rhs[i].store(float_vals + i * 16, 16);
+    }
+
+    at::quantize_vec<T, /*precision=*/8 * sizeof(value_type)>(
+        scale,
+        zero_point,
+        float_vals,
+        (T*)qvals,
+        16 * float_num_vecs());
+
+    return Vec::loadu(qvals);
+  }
+};
+
+#define DEFINE_QUANTIZED_VEC512(T, SIZE)                                     \
+template <>                                                                  \
+struct Vec512<T> : public Vec512QuantizedType<T, SIZE> {                     \
+  Vec512(T val) : Vec512QuantizedType<T, SIZE>(val) {}                       \
+  Vec512(const void* ptr) : Vec512QuantizedType<T, SIZE>(ptr) {}             \
+                                                                             \
+  static Vec512<T> loadu(const void* ptr) {                                  \
+    return Vec512<T>(ptr);                                                   \
+  }                                                                          \
+                                                                             \
+  static Vec512<T> quantize(                                                 \
+      const float_vec_return_type& rhs,                                      \
+      float scale,                                                           \
+      int32_t zero_point,                                                    \
+      float inverse_scale) {                                                 \
+    return quantize_impl<Vec512<T>>(rhs, scale, zero_point);                 \
+  }                                                                          \
+                                                                             \
+  Vec512<T> maximum(Vec512<T> b) const {                                     \
+    return zip(*this, b, [](value_type x, value_type y) {                    \
+      return std::max<value_type>(x, y);                                     \
+    });                                                                      \
+  }                                                                          \
+                                                                             \
+  Vec512<T> minimum(Vec512<T> b) const {                                     \
+    return zip(*this, b, [](value_type x, value_type y) {                    \
+      return std::min<value_type>(x, y);                                     \
+    });                                                                      \
+  }                                                                          \
+                                                                             \
+  Vec512<T> relu(Vec512<T> zero_point) const {                               \
+    return maximum(zero_point);                                              \
+  }                                                                          \
+                                                                             \
+  Vec512<T> relu6(Vec512<T> zero_point, Vec512<T> q_six) {                   \
+    return maximum(zero_point).minimum(q_six);                               \
+  }                                                                          \
+                                                                             \
+ private:                                                                    \
+  friend struct Vec512QuantizedType<T, SIZE>;                                \
+  Vec512() {}                                                                \
+};                                                                           \
+                                                                             \
+template <>                                                                  \
+Vec512<T> inline maximum(const Vec512<T>& a, const Vec512<T>& b) {           \
+  return a.maximum(b);                                                       \
+}
+
+DEFINE_QUANTIZED_VEC512(c10::qint8, 64)
+DEFINE_QUANTIZED_VEC512(c10::quint8, 64)
+DEFINE_QUANTIZED_VEC512(c10::qint32, 16)
+
+#undef DEFINE_QUANTIZED_VEC512
+
+#endif // defined(__AVX512F__) && !defined(_MSC_VER)
+
+}}}
@@ -5,6 +5,12 @@
 #include <ATen/cuda/CUDABlas.h>
 #include <ATen/cuda/Exceptions.h>
 
+#include <memory>
+
+#if !defined(__HIP_PLATFORM_HCC__) && CUDART_VERSION >= 11000
+#include <cublasLt.h>
+#endif
+
 // In CUDA 8.0, definition of data types for sgemmex changed
 #if CUDA_VERSION < 8000
 #define CUDA_R_16F CUBLAS_DATA_HALF
@@ -298,6 +304,311 @@ void gemm<at::BFloat16>(CUDABLAS_GEMM_ARGTYPES(at::BFloat16)) {
 }
 #endif
 
+#if !defined(__HIP_PLATFORM_HCC__) && CUDART_VERSION >= 11000
+namespace {
+
+// cuBLASLt descriptors, destroyed when going out of scope
+template <typename T, cublasStatus_t (*destructor)(T*)>
+struct CuBlasLtDeleter {
+  void operator()(T* x) {
+    if (x != nullptr) {
+      TORCH_CUDABLAS_CHECK(destructor(x));
+    }
+  }
+};
+
+template <typename T, cublasStatus_t (*destructor)(T*)>
+class CuBlasLtDescriptor {
+ public:
+  T* descriptor() const {
+    return descriptor_.get();
+  }
+
+ protected:
+  std::unique_ptr<T, CuBlasLtDeleter<T, destructor>> descriptor_;
+};
+
+class CuBlasLtMatmulDescriptor : public CuBlasLtDescriptor<
+                                     cublasLtMatmulDescOpaque_t,
+                                     &cublasLtMatmulDescDestroy> {
+ public:
+  CuBlasLtMatmulDescriptor(
+      cublasComputeType_t compute_type,
+      cudaDataType_t scale_type) {
+    cublasLtMatmulDesc_t raw_descriptor = nullptr;
+    TORCH_CUDABLAS_CHECK(
+        cublasLtMatmulDescCreate(&raw_descriptor, compute_type, scale_type));
+    descriptor_.reset(raw_descriptor);
+  }
+  template <typename T>
+  void setAttribute(cublasLtMatmulDescAttributes_t attr, const T value) {
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulDescSetAttribute(
+        descriptor(), attr, &value, sizeof(T)));
+  }
+};
+
+class CuBlasLtMatrixLayout : public CuBlasLtDescriptor<
+                                 cublasLtMatrixLayoutOpaque_t,
+                                 &cublasLtMatrixLayoutDestroy> {
+ public:
+  CuBlasLtMatrixLayout(
+      cudaDataType_t type,
+      uint64_t rows,
+      uint64_t cols,
+      int64_t ld) {
+    cublasLtMatrixLayout_t raw_descriptor = nullptr;
+    TORCH_CUDABLAS_CHECK(
+        cublasLtMatrixLayoutCreate(&raw_descriptor, type, rows, cols, ld));
+    descriptor_.reset(raw_descriptor);
+  }
+};
+
+class CuBlasLtMatmulPreference : public CuBlasLtDescriptor<
+                                     cublasLtMatmulPreferenceOpaque_t,
+                                     &cublasLtMatmulPreferenceDestroy> {
+ public:
+  CuBlasLtMatmulPreference() {
+    cublasLtMatmulPreference_t raw_descriptor = nullptr;
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulPreferenceCreate(&raw_descriptor));
+    descriptor_.reset(raw_descriptor);
+  }
+  template <typename T>
+  void setAttribute(cublasLtMatmulPreferenceAttributes_t attr, const T value) {
+    TORCH_CUDABLAS_CHECK(cublasLtMatmulPreferenceSetAttribute(
+        descriptor(), attr, &value, sizeof(T)));
+  }
+};
+
+template <typename Dtype>
+struct CuBlasLtTypes {};
+
+template <>
+struct CuBlasLtTypes<double> {
+  static constexpr cudaDataType_t data_type = CUDA_R_64F;
+  static constexpr cublasComputeType_t compute_type = CUBLAS_COMPUTE_64F;
+  static constexpr cudaDataType_t scale_type = CUDA_R_64F;
+};
+
+template <>
+struct CuBlasLtTypes<float> {
+  static constexpr cudaDataType_t data_type = CUDA_R_32F;
+  static constexpr cublasComputeType_t compute_type = CUBLAS_COMPUTE_32F;
+  static constexpr cudaDataType_t scale_type = CUDA_R_32F;
+};
+
+template <>
+struct CuBlasLtTypes<at::Half> {
+  static constexpr cudaDataType_t data_type = CUDA_R_16F;
+  static constexpr cublasComputeType_t compute_type = CUBLAS_COMPUTE_32F;
+  static constexpr cudaDataType_t scale_type = CUDA_R_32F;
+};
+
+} // anonymous namespace
+
+template <typename Dtype>
+void gemm_and_bias(
+    bool transpose_mat1,
+    bool transpose_mat2,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    at::acc_type<Dtype, true> alpha,
+    const Dtype* mat1,
+    int64_t mat1_ld,
+    const Dtype* mat2,
+    int64_t mat2_ld,
+    const Dtype* bias,
+    Dtype* result,
+    int64_t result_ld,
+    GEMMAndBiasActivationEpilogue activation) {
+  using opmath_t = at::acc_type<Dtype, true>;
+  using types = CuBlasLtTypes<Dtype>;
+  CUDABLAS_POSINT_CHECK(gemm_and_bias<Dtype>, m);
+  CUDABLAS_POSINT_CHECK(gemm_and_bias<Dtype>, n);
+  CUDABLAS_POSINT_CHECK(gemm_and_bias<Dtype>, k);
+  CUDABLAS_POSINT_CHECK(gemm_and_bias<Dtype>, mat1_ld);
+  CUDABLAS_POSINT_CHECK(gemm_and_bias<Dtype>, mat2_ld);
+  CUDABLAS_POSINT_CHECK(gemm_and_bias<Dtype>, result_ld);
+  opmath_t beta_val = 0;
+
+  CuBlasLtMatmulDescriptor computeDesc(types::compute_type, types::scale_type);
+  computeDesc.setAttribute(
+      CUBLASLT_MATMUL_DESC_TRANSA,
+      transpose_mat1 ? CUBLAS_OP_T : CUBLAS_OP_N);
+  computeDesc.setAttribute(
+      CUBLASLT_MATMUL_DESC_TRANSB,
+      transpose_mat2 ? CUBLAS_OP_T : CUBLAS_OP_N);
+  computeDesc.setAttribute(
+      CUBLASLT_MATMUL_DESC_EPILOGUE,
+      activation == GEMMAndBiasActivationEpilogue::RELU
+          ? CUBLASLT_EPILOGUE_RELU_BIAS
+          : CUBLASLT_EPILOGUE_BIAS);
+  computeDesc.setAttribute(CUBLASLT_MATMUL_DESC_BIAS_POINTER, bias);
+
+  CuBlasLtMatrixLayout Adesc(
+      types::data_type,
+      transpose_mat1 ? k : m,
+      transpose_mat1 ? m : k,
+      mat1_ld);
+  CuBlasLtMatrixLayout Bdesc(
+      types::data_type,
+      transpose_mat2 ? n : k,
+      transpose_mat2 ? k : n,
+      mat2_ld);
+  CuBlasLtMatrixLayout Cdesc(types::data_type, m, n, result_ld);
+
+  // the matmul shares the workspace of the cuBLAS handle of the stream
+  const size_t workspaceSize = getChosenWorkspaceSize();
+  CuBlasLtMatmulPreference preference;
+  preference.setAttribute(
+      CUBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, workspaceSize);
+
+  // a cublasHandle_t can be used as a cublasLtHandle_t
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  cublasLtHandle_t ltHandle = reinterpret_cast<cublasLtHandle_t>(handle);
+  void* workspace = at::cuda::getCurrentCUDABlasWorkspace();
+
+  cublasLtMatmulHeuristicResult_t heuristicResult = {};
+  int returnedResult = 0;
+  TORCH_CUDABLAS_CHECK(cublasLtMatmulAlgoGetHeuristic(
+      ltHandle,
+      computeDesc.descriptor(),
+      Adesc.descriptor(),
+      Bdesc.descriptor(),
+      Cdesc.descriptor(),
+      Cdesc.descriptor(),
+      preference.descriptor(),
+      1,
+      &heuristicResult,
+      &returnedResult));
+  TORCH_CHECK(
+      returnedResult != 0,
+      "at::cuda::blas::gemm_and_bias: cuBLASLt has no algorithm for m=", m,
+      " n=", n, " k=", k);
+
+  TORCH_CUDABLAS_CHECK(cublasLtMatmul(
+      ltHandle,
+      computeDesc.descriptor(),
+      &alpha,
+      mat1,
+      Adesc.descriptor(),
+      mat2,
+      Bdesc.descriptor(),
+      &beta_val,
+      result,
+      Cdesc.descriptor(),
+      result,
+      Cdesc.descriptor(),
+      &heuristicResult.algo,
+      workspace,
+      workspaceSize,
+      at::cuda::getCurrentCUDAStream()));
+}
+
+template void gemm_and_bias(
+    bool transpose_mat1,
+    bool transpose_mat2,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    double alpha,
+    const double* mat1,
+    int64_t mat1_ld,
+    const double* mat2,
+    int64_t mat2_ld,
+    const double* bias,
+    double* result,
+    int64_t result_ld,
+    GEMMAndBiasActivationEpilogue activation);
+
+template void gemm_and_bias(
+    bool transpose_mat1,
+    bool transpose_mat2,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    float alpha,
+    const float* mat1,
+    int64_t mat1_ld,
+    const float* mat2,
+    int64_t mat2_ld,
+    const float* bias,
+    float* result,
+    int64_t result_ld,
+    GEMMAndBiasActivationEpilogue activation);
+
+template void gemm_and_bias(
+    bool transpose_mat1,
+    bool transpose_mat2,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    float alpha,
+    const at::Half* mat1,
+    int64_t mat1_ld,
+    const at::Half* mat2,
+    int64_t mat2_ld,
+    const at::Half* bias,
+    at::Half* result,
+    int64_t result_ld,
+    GEMMAndBiasActivationEpilogue activation);
+#endif // !defined(__HIP_PLATFORM_HCC__) && CUDART_VERSION >= 11000
+
+#ifndef __HIP_PLATFORM_HCC__
+void int8_gemm(
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const int8_t* a,
+    int64_t lda,
+    const int8_t* b,
+    int64_t ldb,
+    int32_t* c,
+    int64_t ldc) {
+  CUDABLAS_NONNEGINT_CHECK(int8_gemm, m);
+  CUDABLAS_NONNEGINT_CHECK(int8_gemm, n);
+  CUDABLAS_NONNEGINT_CHECK(int8_gemm, k);
+  CUDABLAS_POSINT_CHECK(int8_gemm, lda);
+  CUDABLAS_POSINT_CHECK(int8_gemm, ldb);
+  CUDABLAS_POSINT_CHECK(int8_gemm, ldc);
+  TORCH_CHECK(
+      lda % 4 == 0 && ldb % 4 == 0 && ldc % 4 == 0,
+      "at::cuda::blas::int8_gemm: leading dimensions must be multiples of 4, "
+      "but got lda = ", lda, ", ldb = ", ldb, ", ldc = ", ldc);
+  TORCH_CHECK(
+      reinterpret_cast<uintptr_t>(a) % 4 == 0 &&
+          reinterpret_cast<uintptr_t>(b) % 4 == 0,
+      "at::cuda::blas::int8_gemm: inputs must be 4 byte aligned");
+  cublasHandle_t handle = at::cuda::getCurrentCUDABlasHandle();
+  int32_t alpha = 1;
+  int32_t beta = 0;
+  TORCH_CUDABLAS_CHECK(cublasGemmEx(
+      handle,
+      CUBLAS_OP_T,
+      CUBLAS_OP_N,
+      m,
+      n,
+      k,
+      &alpha,
+      a,
+      CUDA_R_8I,
+      lda,
+      b,
+      CUDA_R_8I,
+      ldb,
+      &beta,
+      c,
+      CUDA_R_32I,
+      ldc,
+#if CUDA_VERSION >= 11000
+      CUBLAS_COMPUTE_32I,
+#else
+      CUDA_R_32I,
+#endif
+      CUBLAS_GEMM_DEFAULT));
+}
+#endif // __HIP_PLATFORM_HCC__
+
 
 /* LEVEL 2 BLAS FUNCTIONS */
 
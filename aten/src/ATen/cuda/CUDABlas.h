@@ -9,8 +9,23 @@
 
   where Dtype is double, float, at::Half or at::BFloat16(ROCm). The functions are
   available in at::cuda::blas namespace.
+
+  With CUDA 11 or newer, it also provides
+
+    gemm_and_bias<Dtype>(transpose_mat1, transpose_mat2, m, n, k, alpha, mat1,
+  mat1_ld, mat2, mat2_ld, bias, result, result_ld, activation)
+
+  which runs a cuBLASLt matmul with the bias and activation fused into its
+  epilogue.
+
+  On CUDA (not ROCm) it also provides
+
+    int8_gemm(m, n, k, a, lda, b, ldb, c, ldc)
+
+  which computes an int32 product of int8 matrices.
  */
 
+#include <ATen/AccumulateType.h>
 #include <ATen/cuda/CUDAContext.h>
 
 namespace at {
@@ -40,6 +55,55 @@ template <>
 void gemm<at::BFloat16>(CUDABLAS_GEMM_ARGTYPES(at::BFloat16));
 #endif
 
+#if !defined(__HIP_PLATFORM_HCC__) && CUDART_VERSION >= 11000
+enum class GEMMAndBiasActivationEpilogue {
+  NONE,
+  RELU,
+};
+
+// Computes the column-major m x n
+//   result = activation(alpha * op(mat1) * op(mat2) + bias)
+// where op(mat1) is m x k, op(mat2) is k x n, and bias has m elements, added
+// to every column. For a row-major linear layer y = x * w^T + b, that is
+// gemm_and_bias(true, false, out_features, batch, in_features, 1, w,
+// in_features, x, in_features, b, y, out_features).
+template <typename Dtype>
+void gemm_and_bias(
+    bool transpose_mat1,
+    bool transpose_mat2,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    at::acc_type<Dtype, true> alpha,
+    const Dtype* mat1,
+    int64_t mat1_ld,
+    const Dtype* mat2,
+    int64_t mat2_ld,
+    const Dtype* bias,
+    Dtype* result,
+    int64_t result_ld,
+    GEMMAndBiasActivationEpilogue activation = GEMMAndBiasActivationEpilogue::NONE);
+#endif
+
+#ifndef __HIP_PLATFORM_HCC__
+// Computes the column-major m x n int32 result = a^T * b, where a is k x m
+// and b is k x n, both int8. That transposition is the only one cuBLAS
+// supports for int8 inputs, and it requires lda, ldb and ldc to be multiples
+// of 4. For a row-major linear layer y = x * w^T, that is
+// int8_gemm(out_features, batch, in_features, w, in_features, x,
+// in_features, y, out_features).
+void int8_gemm(
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    const int8_t* a,
+    int64_t lda,
+    const int8_t* b,
+    int64_t ldb,
+    int32_t* c,
+    int64_t ldc);
+#endif
+
 /* LEVEL 2 BLAS FUNCTIONS */
 
 #define CUDABLAS_GEMV_ARGTYPES(Dtype)                                        \
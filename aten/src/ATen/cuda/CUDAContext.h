@@ -62,8 +62,17 @@ TORCH_CUDA_API Allocator* getCUDADeviceAllocator();
 
 /* Handles */
 TORCH_CUDA_API cusparseHandle_t getCurrentCUDASparseHandle();
+// The cuBLAS handle of the current thread and stream. Each stream of a thread
+// gets its own handle, bound to that stream once, so the handle must not be
+// bound to another stream with cublasSetStream.
 TORCH_CUDA_API cublasHandle_t getCurrentCUDABlasHandle();
 
+// The workspace that the handle of the current thread and stream uses, of
+// getChosenWorkspaceSize() bytes (set from CUBLAS_WORKSPACE_CONFIG), or
+// nullptr before CUDA 11, where cuBLAS allocates its own workspace.
+TORCH_CUDA_API void* getCurrentCUDABlasWorkspace();
+TORCH_CUDA_API size_t getChosenWorkspaceSize();
+
 
 } // namespace cuda
 } // namespace at
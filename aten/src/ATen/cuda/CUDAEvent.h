@@ -3,6 +3,7 @@
 #include <ATen/cuda/ATenCUDAGeneral.h>
 #include <ATen/cuda/CUDAContext.h>
 #include <c10/cuda/CUDAStream.h>
+#include <c10/cuda/CUDAEventPool.h>
 #include <c10/cuda/CUDAGuard.h>
 #include <ATen/cuda/Exceptions.h>
 #include <c10/util/Exception.h>
@@ -23,6 +24,9 @@ namespace at { namespace cuda {
 * from a handle, the device should be explicitly specified; or if ipc_handle() is
 * called before the event is ever recorded, it will use the current device.
 * Later streams that record the event must match this device.
+*
+* Events with the default flags come from the c10::cuda::CUDAEventPool, and go
+* back to it when destroyed.
 */
 struct TORCH_CUDA_API CUDAEvent {
   // Constructors
@@ -47,7 +51,9 @@ struct TORCH_CUDA_API CUDAEvent {
   // CUDA context on other devices.
   ~CUDAEvent() {
     try {
-      if (is_created_) {
+      if (is_pooled_) {
+        c10::cuda::CUDAEventPool::release(device_index_, event_);
+      } else if (is_created_) {
         CUDAGuard guard(device_index_);
         cudaEventDestroy(event_);
       }
@@ -161,20 +167,27 @@ struct TORCH_CUDA_API CUDAEvent {
 private:
   unsigned int flags_ = cudaEventDisableTiming;
   bool is_created_ = false;
+  bool is_pooled_ = false;
   bool was_recorded_ = false;
   DeviceIndex device_index_ = -1;
   cudaEvent_t event_;
 
   void createEvent(DeviceIndex device_index) {
     device_index_ = device_index;
-    CUDAGuard guard(device_index_);
-    AT_CUDA_CHECK(cudaEventCreateWithFlags(&event_, flags_));
+    if (flags_ == cudaEventDisableTiming) {
+      event_ = c10::cuda::CUDAEventPool::acquire(device_index_);
+      is_pooled_ = true;
+    } else {
+      CUDAGuard guard(device_index_);
+      AT_CUDA_CHECK(cudaEventCreateWithFlags(&event_, flags_));
+    }
     is_created_ = true;
   }
 
   void moveHelper(CUDAEvent&& other) {
     std::swap(flags_, other.flags_);
     std::swap(is_created_, other.is_created_);
+    std::swap(is_pooled_, other.is_pooled_);
     std::swap(was_recorded_, other.was_recorded_);
     std::swap(device_index_, other.device_index_);
     std::swap(event_, other.event_);
@@ -1,5 +1,9 @@
 #include <ATen/CUDAGenerator.h>
+#include <ATen/cuda/Exceptions.h>
 #include <c10/cuda/CUDAFunctions.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <limits>
 
 namespace at {
 
@@ -142,11 +146,92 @@ uint64_t CUDAGenerator::philox_offset_per_thread() {
  * See Note [Acquire lock when using random generators]
  */
 std::pair<uint64_t, uint64_t> CUDAGenerator::philox_engine_inputs(uint64_t increment) {
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDART_VERSION) && CUDART_VERSION >= 10010
+  // The seed and offset are kernel arguments, which a CUDA graph replays as
+  // they were captured, so every replay would draw the same numbers.
+  // Kernels that take a PhiloxCudaState can be captured.
+  cudaStreamCaptureStatus status;
+  AT_CUDA_CHECK(cudaStreamIsCapturing(
+      c10::cuda::getCurrentCUDAStream(this->device().index()), &status));
+  TORCH_CHECK(status == cudaStreamCaptureStatusNone,
+              "This random number generation on CUDA cannot be captured into a CUDA graph, "
+              "since its replays would repeat the random numbers of the capture");
+#endif
   uint64_t offset = this->philox_offset_per_thread_;
   this->philox_offset_per_thread_ += increment;
   return std::make_pair(this->seed_, offset);
 }
 
+/**
+ * Gets the seed and philox offset to be used by a kernel, like
+ * philox_engine_inputs, as a PhiloxCudaState that kernels read with
+ * at::cuda::philox::unpack.
+ *
+ * Unlike philox_engine_inputs, it can be called while a CUDAGraph is
+ * captured: the state then holds the offset of the kernel within the graph,
+ * which each replay adds to the offset it reserved for the whole graph.
+ *
+ * To reserve the offsets of several kernels (or of the sub-kernels of a
+ * fused kernel) at once, pass the sum of their increments and give each of
+ * them the PhiloxCudaState::advanced subrange it needs.
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+PhiloxCudaState CUDAGenerator::philox_cuda_state(uint64_t increment) {
+  if (this->graph_expects_this_gen_) {
+    TORCH_CHECK(
+        increment <= std::numeric_limits<uint32_t>::max() - this->offset_intragraph_,
+        "The random numbers generated during the capture of a CUDA graph exceed "
+        "the philox offsets available to a graph");
+    uint32_t offset = this->offset_intragraph_;
+    this->offset_intragraph_ += static_cast<uint32_t>(increment);
+    return PhiloxCudaState(this->seed_, this->offset_extragraph_, offset);
+  }
+  check_not_captured_by_others();
+  uint64_t offset = this->philox_offset_per_thread_;
+  this->philox_offset_per_thread_ += increment;
+  return PhiloxCudaState(this->seed_, offset);
+}
+
+/**
+ * Makes philox_cuda_state hand out offsets relative to *offset_extragraph
+ * until capture_epilogue.
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+void CUDAGenerator::capture_prologue(int64_t* offset_extragraph) {
+  TORCH_CHECK(!this->graph_expects_this_gen_,
+              "The CUDA generator is already used by the capture of another graph");
+  this->offset_extragraph_ = offset_extragraph;
+  this->offset_intragraph_ = 0;
+  this->graph_expects_this_gen_ = true;
+}
+
+/**
+ * Ends the capture started with capture_prologue, and returns the philox
+ * offset increment that each replay of the graph consumes.
+ *
+ * See Note [Acquire lock when using random generators]
+ */
+uint64_t CUDAGenerator::capture_epilogue() {
+  TORCH_INTERNAL_ASSERT(this->graph_expects_this_gen_);
+  this->graph_expects_this_gen_ = false;
+  this->offset_extragraph_ = nullptr;
+  return this->offset_intragraph_;
+}
+
+// A capture that did not go through capture_prologue (e.g. a raw
+// cudaStreamBeginCapture) would bake the offset into its graph.
+void CUDAGenerator::check_not_captured_by_others() {
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDART_VERSION) && CUDART_VERSION >= 10010
+  cudaStreamCaptureStatus status;
+  AT_CUDA_CHECK(cudaStreamIsCapturing(
+      c10::cuda::getCurrentCUDAStream(this->device().index()), &status));
+  TORCH_CHECK(status == cudaStreamCaptureStatusNone,
+              "Random number generation on CUDA can only be captured into an at::cuda::CUDAGraph");
+#endif
+}
+
 /*
  * Gets the DeviceType of CUDAGenerator.
  * Used for type checking during run time.
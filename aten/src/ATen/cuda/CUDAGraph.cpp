@@ -0,0 +1,148 @@
+#include <ATen/Functions.h>
+#include <ATen/CUDAGenerator.h>
+#include <ATen/cuda/CUDAGraph.h>
+#include <ATen/cuda/Exceptions.h>
+#include <c10/cuda/CUDAFunctions.h>
+
+// cudaStreamBeginCapture takes a capture mode since CUDA 10.1
+#if !defined(__HIP_PLATFORM_HCC__) && defined(CUDART_VERSION) && CUDART_VERSION >= 10010
+#define AT_CUDA_HAS_GRAPHS 1
+#endif
+
+namespace at { namespace cuda {
+
+CUDAGraph::CUDAGraph() {
+#ifndef AT_CUDA_HAS_GRAPHS
+  TORCH_CHECK(false, "CUDA graphs require CUDA 10.1 or newer");
+#endif
+}
+
+CUDAGraph::~CUDAGraph() {
+  try {
+    reset();
+  } catch (const c10::Error& e) {
+    TORCH_WARN("Failed to destroy a CUDA graph: ", e.what_without_backtrace());
+  }
+}
+
+void CUDAGraph::capture_begin(c10::cuda::CUDACachingAllocator::MempoolId_t pool) {
+#ifdef AT_CUDA_HAS_GRAPHS
+  TORCH_CHECK(!has_graph_exec_ && !capture_stream_,
+              "This CUDAGraph instance already owns a captured graph. "
+              "To capture a new graph, create a new instance or call reset() first.");
+
+  auto stream = getCurrentCUDAStream();
+  TORCH_CHECK(stream != getDefaultCUDAStream(),
+              "CUDA graphs must be captured on a non-default stream. "
+              "(However, after capture, it's ok to replay them on the default stream.)");
+
+  // Allocated before the capture, so that it is not part of the graph's
+  // pool and the fill_ of each replay is not captured.
+  offset_extragraph_ = at::empty({1}, at::device(at::kCUDA).dtype(at::kLong));
+  auto gen = at::cuda::detail::getDefaultCUDAGenerator();
+  {
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    gen->capture_prologue(offset_extragraph_.data_ptr<int64_t>());
+  }
+
+  mempool_id_ = pool != 0 ? pool : c10::cuda::CUDACachingAllocator::graphPoolHandle();
+  capture_dev_ = c10::cuda::current_device();
+  capture_stream_ = stream;
+
+  // Allocations on the stream go to the private pool until capture_end, so
+  // that the memory the graph uses is not handed to anyone else between its
+  // replays.
+  c10::cuda::CUDACachingAllocator::beginAllocateStreamToPool(capture_dev_, stream, mempool_id_);
+  holds_pool_ = true;
+
+  // Global mode makes any unsafe call during the capture an error, in
+  // particular synchronizations from other threads that would otherwise
+  // silently observe a stream without the captured work.
+  cudaError_t err = cudaStreamBeginCapture(stream, cudaStreamCaptureModeGlobal);
+  if (err != cudaSuccess) {
+    c10::cuda::CUDACachingAllocator::endAllocateStreamToPool(capture_dev_, stream);
+    capture_stream_ = c10::nullopt;
+    {
+      std::lock_guard<std::mutex> lock(gen->mutex_);
+      gen->capture_epilogue();
+    }
+    AT_CUDA_CHECK(err);
+  }
+#endif
+}
+
+void CUDAGraph::capture_end() {
+#ifdef AT_CUDA_HAS_GRAPHS
+  TORCH_CHECK(capture_stream_, "capture_end() called without capture_begin()");
+  auto stream = getCurrentCUDAStream();
+  TORCH_CHECK(stream == *capture_stream_,
+              "Capture must end on the same stream it began on.");
+
+  cudaError_t err = cudaStreamEndCapture(stream, &graph_);
+  c10::cuda::CUDACachingAllocator::endAllocateStreamToPool(capture_dev_, stream);
+  capture_stream_ = c10::nullopt;
+  auto gen = at::cuda::detail::getDefaultCUDAGenerator(capture_dev_);
+  {
+    std::lock_guard<std::mutex> lock(gen->mutex_);
+    wholegraph_increment_ = gen->capture_epilogue();
+  }
+  AT_CUDA_CHECK(err);
+  TORCH_CHECK(graph_ != nullptr, "Invalid capture.");
+
+  AT_CUDA_CHECK(cudaGraphInstantiate(&graph_exec_, graph_, nullptr, nullptr, 0));
+  has_graph_exec_ = true;
+
+  // The executable graph is all replays need.
+  AT_CUDA_CHECK(cudaGraphDestroy(graph_));
+  graph_ = nullptr;
+#endif
+}
+
+void CUDAGraph::replay() {
+#ifdef AT_CUDA_HAS_GRAPHS
+  TORCH_CHECK(has_graph_exec_,
+              "Called CUDAGraph::replay without a preceding successful capture.");
+  c10::OptionalDeviceGuard device_guard{Device(DeviceType::CUDA, capture_dev_)};
+
+  if (wholegraph_increment_ > 0) {
+    // The offsets of the whole graph are reserved at once; the captured
+    // kernels add their own offset within the graph to this one.
+    auto gen = at::cuda::detail::getDefaultCUDAGenerator(capture_dev_);
+    uint64_t offset;
+    {
+      std::lock_guard<std::mutex> lock(gen->mutex_);
+      offset = gen->philox_engine_inputs(wholegraph_increment_).second;
+    }
+    offset_extragraph_.fill_(static_cast<int64_t>(offset));
+  }
+
+  AT_CUDA_CHECK(cudaGraphLaunch(graph_exec_, getCurrentCUDAStream()));
+#endif
+}
+
+void CUDAGraph::reset() {
+#ifdef AT_CUDA_HAS_GRAPHS
+  TORCH_CHECK(!capture_stream_, "Cannot reset a CUDAGraph during its capture.");
+  if (has_graph_exec_) {
+    // Replays may still be running on some stream, and the pool must not be
+    // reused before they finish.
+    c10::OptionalDeviceGuard device_guard{Device(DeviceType::CUDA, capture_dev_)};
+    AT_CUDA_CHECK(cudaDeviceSynchronize());
+    AT_CUDA_CHECK(cudaGraphExecDestroy(graph_exec_));
+    has_graph_exec_ = false;
+  }
+  if (graph_) {
+    AT_CUDA_CHECK(cudaGraphDestroy(graph_));
+    graph_ = nullptr;
+  }
+  if (holds_pool_) {
+    c10::cuda::CUDACachingAllocator::releasePool(mempool_id_);
+    holds_pool_ = false;
+  }
+  offset_extragraph_ = at::Tensor();
+  wholegraph_increment_ = 0;
+#endif
+}
+
+}} // namespace at::cuda
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <ATen/cuda/ATenCUDAGeneral.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAStream.h>
+#include <c10/util/Optional.h>
+
+#include <cuda_runtime_api.h>
+
+namespace at { namespace cuda {
+
+/*
+* CUDAGraph records the kernels that ATen ops launch on a stream into a
+* cudaGraph_t, and replays them all with a single launch, which removes the
+* CPU launch overhead of workloads with static shapes (small batch inference,
+* RNN decode steps).
+*
+*   auto stream = at::cuda::getStreamFromPool();
+*   at::cuda::CUDAGraph graph;
+*   {
+*     at::cuda::CUDAStreamGuard guard(stream);
+*     graph.capture_begin();
+*     y = model(x);            // x and y must stay alive for the replays
+*     graph.capture_end();
+*   }
+*   x.copy_(next_input);
+*   graph.replay();            // recomputes y from x on the current stream
+*
+* A replay does the work of the captured kernels only: it reads and writes
+* the memory they used during capture, so inputs are updated in place and
+* results are read from the tensors produced by the capture. The memory
+* allocated during capture comes from a private pool of the caching
+* allocator, which keeps those addresses valid until the graph is reset.
+*
+* Capturing requires a stream other than the default stream, and everything
+* captured must be stream-ordered work: synchronizations and host copies of
+* device data raise errors. CUDA graphs require CUDA 10.1 or newer.
+*
+* Kernels that get their philox state from
+* CUDAGenerator::philox_cuda_state (such as dropout) can be captured: each
+* replay reserves the offsets of the whole graph from the default generator
+* of the device, so replays draw new numbers, and manual_seed after the
+* capture still reproduces the same sequence of replays. The seed itself is
+* the one of the capture. Other random number generation raises errors.
+*/
+struct TORCH_CUDA_API CUDAGraph {
+  CUDAGraph();
+  ~CUDAGraph();
+
+  CUDAGraph(const CUDAGraph&) = delete;
+  CUDAGraph& operator=(const CUDAGraph&) = delete;
+
+  // Starts capturing the current stream. `pool` lets graphs share a private
+  // pool (see pool()); by default the graph gets its own.
+  void capture_begin(c10::cuda::CUDACachingAllocator::MempoolId_t pool = 0);
+  void capture_end();
+  // Launches the captured graph on the current stream.
+  void replay();
+  // Destroys the graph and releases its private pool.
+  void reset();
+
+  c10::cuda::CUDACachingAllocator::MempoolId_t pool() const {
+    return mempool_id_;
+  }
+
+ private:
+#ifndef __HIP_PLATFORM_HCC__
+  cudaGraph_t graph_ = nullptr;
+  cudaGraphExec_t graph_exec_ = nullptr;
+#endif
+  bool has_graph_exec_ = false;
+
+  c10::cuda::CUDACachingAllocator::MempoolId_t mempool_id_ = 0;
+  // whether the graph holds a use of its pool
+  bool holds_pool_ = false;
+
+  // the stream and device of the capture underway
+  c10::optional<CUDAStream> capture_stream_;
+  int capture_dev_ = -1;
+
+  // the one element the captured random kernels read their replay's philox
+  // offset from, and the offsets each replay consumes
+  at::Tensor offset_extragraph_;
+  uint64_t wholegraph_increment_ = 0;
+};
+
+}} // namespace at::cuda
@@ -1,5 +1,11 @@
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/detail/DeviceThreadHandles.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <utility>
 
 namespace at { namespace cuda {
 namespace {
@@ -23,25 +29,101 @@ void destroyCublasHandle(cublasHandle_t handle) {
 
 DeviceThreadHandlePool<cublasHandle_t, createCublasHandle, destroyCublasHandle> pool;
 
-// Thread local PoolWindows are wrapped by unique_ptrs and lazily-initialized
+// A handle bound to one stream of a thread. Binding a handle to its own
+// stream, instead of calling cublasSetStream on a per-thread handle at every
+// call, keeps concurrent streams of the same thread from sharing (and
+// serializing on) the workspace of the handle.
+struct StreamHandle {
+  std::unique_ptr<decltype(pool)::PoolWindow> window;
+  cublasHandle_t handle = nullptr;
+  // the workspace given to cuBLAS with cublasSetWorkspace, allocated on the
+  // stream of the handle
+  at::DataPtr workspace;
+};
+
+// Thread local handles are wrapped by a unique_ptr and lazily-initialized
 // to avoid initialization issues that caused hangs on Windows.
 // See: https://github.com/pytorch/pytorch/pull/22405
-// This thread local unique_ptrs will be destroyed when the thread terminates,
-// releasing its reserved handles back to the pool.
-thread_local std::unique_ptr<decltype(pool)::PoolWindow> myPoolWindow;
+// The handles go back to the pool, through the PoolWindows, when the thread
+// terminates.
+using StreamHandles = std::map<std::pair<int, cudaStream_t>, StreamHandle>;
+thread_local std::unique_ptr<StreamHandles> myStreamHandles;
 
-} // namespace
+// CUBLAS_WORKSPACE_CONFIG is the variable cuBLAS itself reads to size its
+// workspace, as a list of ":SIZE_KIB:COUNT" pairs; the workspace we allocate
+// has the same size.
+size_t parseChosenWorkspaceSize() {
+  // 4 MiB, the default of cuBLAS for a single stream
+  size_t size = 4096 * 1024;
+  const char* env = std::getenv("CUBLAS_WORKSPACE_CONFIG");
+  if (!env) {
+    return size;
+  }
+  size_t total = 0;
+  std::string config(env);
+  size_t pos = 0;
+  while (pos < config.size() && config[pos] == ':') {
+    size_t size_end = config.find(':', pos + 1);
+    if (size_end == std::string::npos) {
+      break;
+    }
+    size_t count_end = config.find(':', size_end + 1);
+    try {
+      const size_t size_kib = std::stoul(config.substr(pos + 1, size_end - pos - 1));
+      const size_t count = std::stoul(config.substr(
+          size_end + 1,
+          count_end == std::string::npos ? std::string::npos
+                                         : count_end - size_end - 1));
+      total += size_kib * 1024 * count;
+    } catch (const std::exception&) {
+      TORCH_WARN("Ignoring invalid CUBLAS_WORKSPACE_CONFIG=", config);
+      return size;
+    }
+    pos = count_end == std::string::npos ? config.size() : count_end;
+  }
+  return total > 0 ? total : size;
+}
 
-cublasHandle_t getCurrentCUDABlasHandle() {
+StreamHandle& getCurrentStreamHandle() {
   int device;
   AT_CUDA_CHECK(cudaGetDevice(&device));
-
-  if (!myPoolWindow)
-    myPoolWindow.reset(pool.newPoolWindow());
-  auto handle = myPoolWindow->reserve(device);
   auto stream = c10::cuda::getCurrentCUDAStream();
-  TORCH_CUDABLAS_CHECK(cublasSetStream(handle, stream));
-  return handle;
+
+  if (!myStreamHandles)
+    myStreamHandles.reset(new StreamHandles());
+  auto& stream_handle = (*myStreamHandles)[{device, stream.stream()}];
+  if (!stream_handle.window) {
+    // A handle released by another thread may still be bound to another
+    // stream and workspace, so the binding is always redone.
+    stream_handle.window.reset(pool.newPoolWindow());
+    stream_handle.handle = stream_handle.window->reserve(device);
+    TORCH_CUDABLAS_CHECK(cublasSetStream(stream_handle.handle, stream));
+#if !defined(__HIP_PLATFORM_HCC__) && CUDART_VERSION >= 11000
+    // cublasSetStream resets the workspace, so it is set afterwards
+    stream_handle.workspace = c10::cuda::CUDACachingAllocator::get()->allocate(
+        getChosenWorkspaceSize());
+    TORCH_CUDABLAS_CHECK(cublasSetWorkspace(
+        stream_handle.handle,
+        stream_handle.workspace.get(),
+        getChosenWorkspaceSize()));
+#endif
+  }
+  return stream_handle;
+}
+
+} // namespace
+
+size_t getChosenWorkspaceSize() {
+  static const size_t size = parseChosenWorkspaceSize();
+  return size;
+}
+
+cublasHandle_t getCurrentCUDABlasHandle() {
+  return getCurrentStreamHandle().handle;
+}
+
+void* getCurrentCUDABlasWorkspace() {
+  return getCurrentStreamHandle().workspace.get();
 }
 
 }} // namespace at::cuda
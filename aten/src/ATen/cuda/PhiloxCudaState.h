@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+namespace at {
+
+// The philox seed and offset that a kernel generating random numbers starts
+// from, as handed out by CUDAGenerator::philox_cuda_state.
+//
+// Outside of graph capture the offset is a plain value. While a CUDAGraph is
+// captured, the offset is split into the offset of the current replay, which
+// CUDAGraph::replay writes to device memory at `offset_.ptr` before each
+// launch, and the offset of the kernel within the graph. Kernels read both
+// with at::cuda::philox::unpack (see ATen/cuda/PhiloxUtils.cuh), so that
+// every replay draws new numbers.
+struct PhiloxCudaState {
+  PhiloxCudaState() = default;
+  // Outside of graph capture
+  PhiloxCudaState(uint64_t seed, uint64_t offset) {
+    seed_ = seed;
+    offset_.val = offset;
+  }
+  // During graph capture
+  PhiloxCudaState(
+      uint64_t seed,
+      int64_t* offset_extragraph,
+      uint32_t offset_intragraph) {
+    seed_ = seed;
+    offset_.ptr = offset_extragraph;
+    offset_intragraph_ = offset_intragraph;
+    captured_ = true;
+  }
+
+  // The state `increment` offsets further. A kernel that reserved the offsets
+  // of several sub-kernels at once (e.g. the dropouts of a fused kernel) gives
+  // each of them its own subrange this way, without going back to the
+  // generator.
+  PhiloxCudaState advanced(uint64_t increment) const {
+    PhiloxCudaState state = *this;
+    if (captured_) {
+      state.offset_intragraph_ += static_cast<uint32_t>(increment);
+    } else {
+      state.offset_.val += increment;
+    }
+    return state;
+  }
+
+  // Public members, directly accessible by at::cuda::philox::unpack.
+  union Payload {
+    uint64_t val;
+    int64_t* ptr;
+  };
+
+  uint64_t seed_ = 0;
+  Payload offset_;
+  uint32_t offset_intragraph_ = 0;
+  bool captured_ = false;
+};
+
+} // namespace at
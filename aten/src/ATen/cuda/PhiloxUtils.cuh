@@ -0,0 +1,28 @@
+#pragma once
+
+#include <ATen/cuda/PhiloxCudaState.h>
+#include <c10/macros/Macros.h>
+
+#include <thrust/tuple.h>
+
+namespace at {
+namespace cuda {
+namespace philox {
+
+// Returns the seed and offset of a PhiloxCudaState, reading the offset of the
+// current replay from device memory if the state was captured into a graph.
+// Meant to be called by each thread of the kernel before curand_init.
+__device__ __forceinline__ thrust::tuple<uint64_t, uint64_t>
+unpack(at::PhiloxCudaState arg) {
+  if (arg.captured_) {
+    return thrust::make_tuple(
+        arg.seed_,
+        static_cast<uint64_t>(*arg.offset_.ptr) + arg.offset_intragraph_);
+  } else {
+    return thrust::make_tuple(arg.seed_, arg.offset_.val);
+  }
+}
+
+} // namespace philox
+} // namespace cuda
+} // namespace at
@@ -5,6 +5,7 @@
 #include <ATen/DeviceGuard.h>
 #include <ATen/DynamicLibrary.h>
 #include <ATen/cuda/CUDAConfig.h>
+#include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/CUDADevice.h>
 #include <ATen/cuda/Exceptions.h>
 #include <ATen/cuda/PinnedMemoryAllocator.h>
@@ -61,6 +62,15 @@ Generator* CUDAHooks::getDefaultCUDAGenerator(DeviceIndex device_index) const {
   return at::cuda::detail::getDefaultCUDAGenerator(device_index);
 }
 
+void CUDAHooks::setCUDAGeneratorState(Generator* generator, const Generator& state) const {
+  auto* cuda_generator = static_cast<CUDAGenerator*>(generator);
+  const auto& cuda_state = static_cast<const CUDAGenerator&>(state);
+  cuda_generator->set_current_seed(cuda_state.current_seed());
+  // set_current_seed resets the offset
+  cuda_generator->set_philox_offset_per_thread(
+      const_cast<CUDAGenerator&>(cuda_state).philox_offset_per_thread());
+}
+
 Device CUDAHooks::getDeviceFromPtr(void* data) const {
   return at::cuda::getDeviceFromPtr(data);
 }
@@ -181,6 +191,10 @@ Allocator* CUDAHooks::getPinnedMemoryAllocator() const {
   return at::cuda::getPinnedMemoryAllocator();
 }
 
+Stream CUDAHooks::getStreamFromPool(DeviceIndex device_index) const {
+  return at::cuda::getStreamFromPool(/*isHighPriority=*/false, device_index);
+}
+
 bool CUDAHooks::compiledWithCuDNN() const {
   return AT_CUDNN_ENABLED();
 }
@@ -15,6 +15,7 @@ struct CUDAHooks : public at::CUDAHooksInterface {
   Device getDeviceFromPtr(void* data) const override;
   bool isPinnedPtr(void* data) const override;
   Generator* getDefaultCUDAGenerator(DeviceIndex device_index = -1) const override;
+  void setCUDAGeneratorState(Generator* generator, const Generator& state) const override;
   bool hasCUDA() const override;
   bool hasMAGMA() const override;
   bool hasCuDNN() const override;
@@ -23,6 +24,7 @@ struct CUDAHooks : public at::CUDAHooksInterface {
   bool hasPrimaryContext(int64_t device_index) const override;
   c10::optional<int64_t> getDevceIndexWithPrimaryContext() const override;
   Allocator* getPinnedMemoryAllocator() const override;
+  Stream getStreamFromPool(DeviceIndex device_index) const override;
   bool compiledWithCuDNN() const override;
   bool compiledWithMIOpen() const override;
   bool supportsDilatedConvolutionWithCuDNN() const override;
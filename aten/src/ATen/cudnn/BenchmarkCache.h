@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+#include <ATen/cuda/ATenCUDAGeneral.h>
+
+namespace at { namespace native {
+
+// Write the convolution algorithms picked by cudnn.benchmark (forward,
+// backward data and backward filter) to a file, so that a later process can
+// skip cudnnFind for the shapes it has already seen. The file records the
+// cuDNN version and the GPU model of the current device.
+TORCH_CUDA_API void cudnn_convolution_save_benchmark_cache(const std::string& filename);
+
+// Merge a file written by cudnn_convolution_save_benchmark_cache into the
+// in-process caches. Returns false, leaving the caches untouched, when the
+// file was written by a different cuDNN version, for a different GPU model or
+// by an incompatible build.
+TORCH_CUDA_API bool cudnn_convolution_load_benchmark_cache(const std::string& filename);
+
+}} // namespace at::native
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <c10/core/Allocator.h>
+#include <c10/core/Stream.h>
 #include <ATen/core/Generator.h>
 #include <c10/util/Exception.h>
 #include <c10/util/Optional.h>
@@ -67,6 +68,12 @@ struct CAFFE2_API CUDAHooksInterface {
     TORCH_CHECK(false, "Cannot get default CUDA generator without ATen_cuda library. ", CUDA_HELP);
   }
 
+  // Makes the CUDA generator `generator` continue from the state of `state`,
+  // a clone() of a CUDA generator.
+  virtual void setCUDAGeneratorState(Generator* generator, const Generator& state) const {
+    TORCH_CHECK(false, "Cannot set CUDA generator state without ATen_cuda library. ", CUDA_HELP);
+  }
+
   virtual Device getDeviceFromPtr(void* data) const {
     TORCH_CHECK(false, "Cannot get device of pointer on CUDA without ATen_cuda library. ", CUDA_HELP);
   }
@@ -107,6 +114,10 @@ struct CAFFE2_API CUDAHooksInterface {
     TORCH_CHECK(false, "Pinned memory requires CUDA. ", CUDA_HELP);
   }
 
+  virtual Stream getStreamFromPool(DeviceIndex device_index) const {
+    TORCH_CHECK(false, "Cannot get a CUDA stream without ATen_cuda library. ", CUDA_HELP);
+  }
+
   virtual bool compiledWithCuDNN() const {
     return false;
   }
@@ -90,6 +90,7 @@ ${return_type} ${api_name}(${type_method_formals});
 NATIVE_DISPATCH_DEFINITION_DEFAULT = CodeTemplate("""\
 ${return_type} ${api_name}(${type_method_formals}) {
     ${named_guard_declaration}
+    ${inference_guard_declaration}
     ${device_guard_declaration}
     ${return_call} at::native::${native_type_method_dispatch}(${native_actuals});
 }
@@ -98,6 +99,7 @@ ${return_type} ${api_name}(${type_method_formals}) {
 NATIVE_DISPATCH_DEFINITION_BACKEND = CodeTemplate("""\
 ${return_type} ${api_name}(${type_method_formals}) {
     ${named_guard_declaration}
+    ${inference_guard_declaration}
     ${device_guard_declaration}
     ${return_call} at::native::${native_type_method_dispatch}(${native_actuals});
 }
@@ -530,6 +532,7 @@ FunctionOption = TypedDict('FunctionOption', {
     'method_formals': List[str],
     'method_prefix_derived': str,
     'named_guard_declaration': str,
+    'inference_guard_declaration': str,
     'mode': str,
     'python_module': str,
     'name': str,
@@ -608,9 +611,12 @@ def named_guard(option, tensors, tensorlists):
     # There is always some at:: function that calls the _th_ function.
     if option['name'].startswith('_th_'):
         return ''
+    # Named tensors have DispatchKey::NamedTensorId in their key set, so a
+    # single test on the union of the key sets covers all tensor arguments.
     named_conditions = []
-    for tensor in tensors:
-        named_conditions.append('{}.has_names()'.format(tensor))
+    if tensors:
+        key_sets = ' | '.join('{}.key_set()'.format(tensor) for tensor in tensors)
+        named_conditions.append('at::impl::has_names({})'.format(key_sets))
     for tensorlist in tensorlists:
         named_conditions.append('at::has_names({})'.format(tensorlist))
     return ("""\
@@ -622,6 +628,17 @@ if ({named_conditions}) {{
 }}""".format(named_conditions=' || '.join(named_conditions), op=option['name']))
 
 
+def inference_guard(option, formals):
+    # Under at::InferenceModeGuard the Variable kernels are skipped, so version
+    # counters are not bumped. Ops that write into a tensor therefore check
+    # that its memory was allocated in inference mode.
+    if option['name'].startswith('_th_'):
+        return ''
+    mutable_tensors = [formal['name'] for formal in formals if formal['type'] == 'Tensor &']
+    return '\n'.join('at::impl::check_inplace_in_inference_mode({}, "{}");'.format(tensor, option['name'])
+                     for tensor in mutable_tensors)
+
+
 def dispatch_scalar_type(option, dispatch_options, dispatch_tensor):
     if dispatch_options:
         return 'auto dispatch_scalar_type = typeMetaToScalarType({}.dtype());'.format(dispatch_options['name'])
@@ -1188,6 +1205,7 @@ def create_generic(top_env, declarations):
         option['device_guard_declaration'] = device_guard(option, dispatch_options, guard_tensor)
         option['named_guard_declaration'] = named_guard(option, find_tensors(formals),
                                                         find_tensorlists(formals))
+        option['inference_guard_declaration'] = inference_guard(option, formals)
         option['dispatch_scalar_type_declaration'] = dispatch_scalar_type(option, dispatch_options, guard_tensor)
 
         broadcast_arg = get_broadcast_argument(option)
@@ -101,6 +101,59 @@ namespace {
     });
   }
 
+  template <typename scalar_t>
+  void adaptive_avg_pool2d_out_frame_channels_last(
+    scalar_t *input_p,
+    scalar_t *output_p,
+    int64_t sizeB,
+    int64_t sizeD,
+    int64_t isizeH,
+    int64_t isizeW,
+    int64_t osizeH,
+    int64_t osizeW)
+  {
+    /* input and output are NHWC, so each output point sums over the
+       contiguous channel vectors of its window */
+    at::parallel_for(0, sizeB * osizeH * osizeW, 0, [&](int64_t start, int64_t end) {
+      for (auto idx = start; idx < end; idx++)
+      {
+        int64_t b = idx / (osizeH * osizeW);
+        int64_t oh = (idx / osizeW) % osizeH;
+        int64_t ow = idx % osizeW;
+
+        int istartH = start_index(oh, osizeH, isizeH);
+        int iendH   = end_index(oh, osizeH, isizeH);
+        int kH = iendH - istartH;
+        int istartW = start_index(ow, osizeW, isizeW);
+        int iendW   = end_index(ow, osizeW, isizeW);
+        int kW = iendW - istartW;
+
+        scalar_t *op = output_p + idx * sizeD;
+        for (int64_t d = 0; d < sizeD; d++) {
+          op[d] = 0;
+        }
+
+        /* compute local average: */
+        int ih, iw;
+        for(ih = istartH; ih < iendH; ih++)
+        {
+          for(iw = istartW; iw < iendW; iw++)
+          {
+            scalar_t *ip = input_p + ((b * isizeH + ih) * isizeW + iw) * sizeD;
+            for (int64_t d = 0; d < sizeD; d++) {
+              op[d] += ip[d];
+            }
+          }
+        }
+
+        /* set output to local average */
+        for (int64_t d = 0; d < sizeD; d++) {
+          op[d] = op[d] / kW / kH;
+        }
+      }
+    });
+  }
+
   void adaptive_avg_pool2d_out_cpu_template(
     at::Tensor& output,
     at::Tensor const& input,
@@ -129,7 +182,25 @@ namespace {
     auto osizeW = output_size[1];
 
     /* resize output */
-    if (input.ndimension() == 3 || input.size(-4) == 1)
+    if (input.suggest_memory_format() == at::MemoryFormat::ChannelsLast)
+    {
+      int64_t sizeB = input.size(-4);
+      auto input_cl = input.contiguous(at::MemoryFormat::ChannelsLast);
+      output.resize_({sizeB, sizeD, osizeH, osizeW}, at::MemoryFormat::ChannelsLast);
+
+      AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "adaptive_avg_pool2d_cpu", [&] {
+        auto input_data = input_cl.data_ptr<scalar_t>();
+        auto output_data = output.data_ptr<scalar_t>();
+        adaptive_avg_pool2d_out_frame_channels_last<scalar_t>(
+          input_data,
+          output_data,
+          sizeB,
+          sizeD,
+          isizeH, isizeW,
+          osizeH, osizeW);
+      });
+    }
+    else if (input.ndimension() == 3 || input.size(-4) == 1)
     {
       if (input.ndimension() == 3) {
         output.resize_({sizeD, osizeH, osizeW});
@@ -247,6 +318,56 @@ namespace {
     });
   }
 
+  template <typename scalar_t>
+  void adaptive_avg_pool2d_backward_out_frame_channels_last(
+    scalar_t *gradInput_p,
+    scalar_t *gradOutput_p,
+    int64_t sizeB,
+    int64_t sizeD,
+    int64_t isizeH,
+    int64_t isizeW,
+    int64_t osizeH,
+    int64_t osizeW)
+  {
+    at::parallel_for(0, sizeB, 0, [&](int64_t start, int64_t end) {
+      for (auto b = start; b < end; b++)
+      {
+        scalar_t *gradInput_p_b = gradInput_p + b * isizeH * isizeW * sizeD;
+        scalar_t *gradOutput_p_b = gradOutput_p + b * osizeH * osizeW * sizeD;
+
+        int64_t oh, ow;
+        for(oh = 0; oh < osizeH; oh++)
+        {
+          int istartH = start_index(oh, osizeH, isizeH);
+          int iendH   = end_index(oh, osizeH, isizeH);
+          int kH = iendH - istartH;
+
+          for(ow = 0; ow < osizeW; ow++)
+          {
+            int istartW = start_index(ow, osizeW, isizeW);
+            int iendW   = end_index(ow, osizeW, isizeW);
+            int kW = iendW - istartW;
+
+            scalar_t *gop = gradOutput_p_b + (oh * osizeW + ow) * sizeD;
+
+            int ih, iw;
+            for(ih = istartH; ih < iendH; ih++)
+            {
+              for(iw = istartW; iw < iendW; iw++)
+              {
+                /* update gradient */
+                scalar_t *gip = gradInput_p_b + (ih * isizeW + iw) * sizeD;
+                for (int64_t d = 0; d < sizeD; d++) {
+                  gip[d] += gop[d] / kH / kW;
+                }
+              }
+            }
+          }
+        }
+      }
+    });
+  }
+
   Tensor& adaptive_avg_pool2d_backward_out_cpu_template(
     Tensor& gradInput,
     const Tensor& gradOutput_,
@@ -259,11 +380,31 @@ namespace {
     int osizeH = gradOutput_.size(-2);
     int osizeW = gradOutput_.size(-1);
 
-    /* get contiguous gradOutput */
-    auto gradOutput = gradOutput_.contiguous();
+    /* get contiguous gradOutput in the layout of gradInput */
+    const bool channels_last = input.suggest_memory_format() == at::MemoryFormat::ChannelsLast &&
+        gradInput.is_contiguous(at::MemoryFormat::ChannelsLast);
+    auto gradOutput = gradOutput_.contiguous(
+        channels_last ? at::MemoryFormat::ChannelsLast : at::MemoryFormat::Contiguous);
 
     /* backprop */
-    if (input.ndimension() == 3 || input.size(-4) == 1)
+    if (channels_last)
+    {
+      AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+        input.scalar_type(), "adaptive_avg_pool2d_backward_cpu", [&] {
+          /* get raw pointers */
+          scalar_t *gradInput_data = gradInput.data_ptr<scalar_t>();
+          scalar_t *gradOutput_data = gradOutput.data_ptr<scalar_t>();
+          int64_t sizeB = input.size(-4);
+
+          adaptive_avg_pool2d_backward_out_frame_channels_last<scalar_t>(
+            gradInput_data, gradOutput_data,
+            sizeB, sizeD,
+            isizeH, isizeW,
+            osizeH, osizeW);
+        }
+      );
+    }
+    else if (input.ndimension() == 3 || input.size(-4) == 1)
     {
       AT_DISPATCH_FLOATING_TYPES_AND_HALF(
         input.scalar_type(), "adaptive_avg_pool2d_backward_cpu", [&] {
@@ -326,7 +467,8 @@ namespace {
       return at::mkldnn_adaptive_avg_pool2d(input, output_size);
     }
 
-    // TODO: fastpath for Channels_last should be explored later;
+    // Channels last inputs go through _adaptive_avg_pool2d, whose NHWC kernel
+    // already reduces over hw with contiguous channel vectors.
     if (input.suggest_memory_format() == at::MemoryFormat::Contiguous && !input.is_quantized() && output_size[0] == 1 && output_size[1] == 1) {
       // in this case, adaptive pooling is just computing mean over hw
       // dimensions, which can be done more efficiently
@@ -344,7 +486,7 @@ namespace {
     const Tensor& gradOutput,
     const Tensor& input)
   {
-    gradInput.resize_as_(input);
+    gradInput.resize_(input.sizes(), input.suggest_memory_format());
     adaptive_avg_pool2d_backward_out_cpu_template(
       gradInput, gradOutput, input);
     return gradInput;
@@ -354,7 +496,7 @@ namespace {
     const Tensor& gradOutput,
     const Tensor& input)
   {
-    auto gradInput = at::zeros_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    auto gradInput = at::zeros_like(input, input.suggest_memory_format());
     adaptive_avg_pool2d_backward_out_cpu_template(
       gradInput, gradOutput, input);
     return gradInput;
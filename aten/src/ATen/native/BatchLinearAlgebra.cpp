@@ -4,6 +4,7 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/ExpandUtils.h>
 
+#include <ATen/native/BatchLinearAlgebra.h>
 #include <ATen/native/LinearAlgebraUtils.h>
 #include <ATen/native/cpu/zmath.h>
 #include <ATen/Parallel.h>
@@ -303,6 +304,30 @@ template<> void lapackLuSolve<float>(char trans, int n, int nrhs, float *a, int
 // Below of the definitions of the functions operating on a batch that are going to be dispatched
 // in the main helper functions for the linear algebra operations
 
+DEFINE_DISPATCH(small_lu_stub);
+DEFINE_DISPATCH(small_solve_stub);
+DEFINE_DISPATCH(small_inverse_stub);
+DEFINE_DISPATCH(small_cholesky_stub);
+
+// Batches of tiny real matrices go to the small_*_stub kernels, which
+// vectorize across the batch; everything else calls LAPACK per matrix.
+static inline bool use_small_matrix_kernel(const Tensor& self) {
+  return (self.scalar_type() == kFloat || self.scalar_type() == kDouble) &&
+      self.size(-1) == self.size(-2) &&
+      self.size(-1) >= 1 && self.size(-1) <= kSmallMatrixMaxSize &&
+      batchCount(self) > 1;
+}
+
+// The per matrix LAPACK loops run the batch in parallel when the matrices are
+// small enough that LAPACK itself won't use more than one thread; larger ones
+// keep the batch serial and leave the threading to LAPACK.
+static inline int64_t lapack_batch_grain_size(int64_t n, int64_t batch_size) {
+  if (n > 64) {
+    return std::max<int64_t>(batch_size, 1);
+  }
+  return std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, n * n * n));
+}
+
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ solve ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 template<typename scalar_t>
@@ -318,19 +343,21 @@ static void apply_solve(Tensor& b, Tensor& A, std::vector<int64_t>& infos) {
   auto n = A.size(-2);
   auto nrhs = b.size(-1);
 
-  auto ipiv = at::empty({n}, b.options().dtype(kInt));
-  auto ipiv_data = ipiv.data_ptr<int>();
-
-  int info;
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
-    scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
-    lapackSolve<scalar_t>(n, nrhs, A_working_ptr, n, ipiv_data, b_working_ptr, n, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
+  // Each chunk stops at its first failure; batchCheckErrors then reports
+  // the lowest failing matrix, as the serial loop did.
+  at::parallel_for(0, batch_size, lapack_batch_grain_size(n, batch_size), [&](int64_t start, int64_t end) {
+    std::vector<int> ipiv(n);
+    int info;
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* A_working_ptr = &A_data[i * A_mat_stride];
+      scalar_t* b_working_ptr = &b_data[i * b_mat_stride];
+      lapackSolve<scalar_t>(n, nrhs, A_working_ptr, n, ipiv.data(), b_working_ptr, n, &info);
+      infos[i] = info;
+      if (info != 0) {
+        return;
+      }
     }
-  }
+  });
 #endif
 }
 
@@ -338,9 +365,13 @@ std::tuple<Tensor, Tensor> _solve_helper_cpu(const Tensor& self, const Tensor& A
   auto self_working_copy = cloneBatchedColumnMajor(self);
   auto A_working_copy = cloneBatchedColumnMajor(A);
   std::vector<int64_t> infos(batchCount(self), 0);
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "solve_cpu", [&]{
-    apply_solve<scalar_t>(self_working_copy, A_working_copy, infos);
-  });
+  if (use_small_matrix_kernel(A_working_copy)) {
+    small_solve_stub(kCPU, self_working_copy, A_working_copy, infos.data());
+  } else {
+    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "solve_cpu", [&]{
+      apply_solve<scalar_t>(self_working_copy, A_working_copy, infos);
+    });
+  }
   if (self.dim() > 2) {
     batchCheckErrors(infos, "solve_cpu");
   } else {
@@ -393,33 +424,40 @@ static void apply_inverse(Tensor& self, std::vector<int64_t>& infos) {
   scalar_t wkopt;
   lapackGetri<scalar_t>(n, self_data, n, ipiv_data, &wkopt, lwork, &info);
   lwork = static_cast<int>(real_impl<scalar_t, value_t>(wkopt));
-  Tensor work = at::empty({lwork}, self.options());
-  auto work_data = work.data_ptr<scalar_t>();
 
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-    lapackLu<scalar_t>(n, n, self_working_ptr, n, ipiv_data, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
-    }
+  at::parallel_for(0, batch_size, lapack_batch_grain_size(n, batch_size), [&](int64_t start, int64_t end) {
+    std::vector<int> ipiv(n);
+    std::vector<scalar_t> work(lwork);
+    int info;
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+      lapackLu<scalar_t>(n, n, self_working_ptr, n, ipiv.data(), &info);
+      infos[i] = info;
+      if (info != 0) {
+        return;
+      }
 
-    // now compute the actual inverse
-    lapackGetri<scalar_t>(n, self_working_ptr, n, ipiv_data, work_data, lwork, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
+      // now compute the actual inverse
+      lapackGetri<scalar_t>(n, self_working_ptr, n, ipiv.data(), work.data(), lwork, &info);
+      infos[i] = info;
+      if (info != 0) {
+        return;
+      }
     }
-  }
+  });
 #endif
 }
 
 Tensor _inverse_helper_cpu(const Tensor& self) {
   std::vector<int64_t> infos(batchCount(self), 0);
   auto self_working_copy = cloneBatchedColumnMajor(self);
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "inverse_cpu", [&]{
-    apply_inverse<scalar_t>(self_working_copy, infos);
-  });
+  if (use_small_matrix_kernel(self_working_copy)) {
+    small_inverse_stub(kCPU, self_working_copy, infos.data());
+  } else {
+    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "inverse_cpu", [&]{
+      apply_inverse<scalar_t>(self_working_copy, infos);
+    });
+  }
   if (self.dim() > 2) {
     batchCheckErrors(infos, "inverse_cpu");
   } else {
@@ -521,24 +559,30 @@ static void apply_cholesky(Tensor& self, bool upper, std::vector<int64_t>& infos
   auto batch_size = batchCount(self);
   auto n = self.size(-2);
 
-  int info;
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-    lapackCholesky<scalar_t>(uplo, n, self_working_ptr, n, &info);
-    infos[i] = info;
-    if (info != 0) {
-      return;
+  at::parallel_for(0, batch_size, lapack_batch_grain_size(n, batch_size), [&](int64_t start, int64_t end) {
+    int info;
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+      lapackCholesky<scalar_t>(uplo, n, self_working_ptr, n, &info);
+      infos[i] = info;
+      if (info != 0) {
+        return;
+      }
     }
-  }
+  });
 #endif
 }
 
 Tensor _cholesky_helper_cpu(const Tensor& self, bool upper) {
   std::vector<int64_t> infos(batchCount(self), 0);
   auto self_working_copy = cloneBatchedColumnMajor(self);
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "cholesky_cpu", [&]{
-    apply_cholesky<scalar_t>(self_working_copy, upper, infos);
-  });
+  if (use_small_matrix_kernel(self_working_copy)) {
+    small_cholesky_stub(kCPU, self_working_copy, upper, infos.data());
+  } else {
+    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "cholesky_cpu", [&]{
+      apply_cholesky<scalar_t>(self_working_copy, upper, infos);
+    });
+  }
   if (self.dim() > 2) {
     batchCheckErrors(infos, "cholesky_cpu");
   } else {
@@ -585,12 +629,14 @@ static void apply_lu(Tensor& self, Tensor& pivots, Tensor& infos) {
   auto m = self.size(-2);
   auto n = self.size(-1);
 
-  for (int64_t i = 0; i < batch_size; i++) {
-    scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
-    int* pivots_working_ptr = &pivots_data[i * pivots_matrix_stride];
-    int* infos_working_ptr = &infos_data[i];
-    lapackLu<scalar_t>(m, n, self_working_ptr, m, pivots_working_ptr, infos_working_ptr);
-  }
+  at::parallel_for(0, batch_size, lapack_batch_grain_size(std::max(m, n), batch_size), [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; i++) {
+      scalar_t* self_working_ptr = &self_data[i * self_matrix_stride];
+      int* pivots_working_ptr = &pivots_data[i * pivots_matrix_stride];
+      int* infos_working_ptr = &infos_data[i];
+      lapackLu<scalar_t>(m, n, self_working_ptr, m, pivots_working_ptr, infos_working_ptr);
+    }
+  });
 #endif
 }
 
@@ -613,9 +659,13 @@ std::tuple<Tensor, Tensor, Tensor> _lu_with_info_cpu(const Tensor& self, bool pi
     self_working_copy = at::empty_like(self, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   } else {
     self_working_copy = cloneBatchedColumnMajor(self);
-    AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "lu_cpu", [&]{
-      apply_lu<scalar_t>(self_working_copy, pivots_tensor, infos_tensor);
-    });
+    if (use_small_matrix_kernel(self_working_copy)) {
+      small_lu_stub(kCPU, self_working_copy, pivots_tensor.data_ptr<int>(), infos_tensor.data_ptr<int>());
+    } else {
+      AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(self.scalar_type(), "lu_cpu", [&]{
+        apply_lu<scalar_t>(self_working_copy, pivots_tensor, infos_tensor);
+      });
+    }
   }
   if (check_errors) {
     if (self.dim() > 2) {
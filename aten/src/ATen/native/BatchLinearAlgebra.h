@@ -0,0 +1,26 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// Kernels for batches of tiny square float or double matrices, at most
+// kSmallMatrixMaxSize on a side. They vectorize across the batch instead of
+// calling LAPACK once per matrix. The tensors are batched column major and
+// contiguous (as produced by cloneBatchedColumnMajor) and are overwritten in
+// place; infos and pivots follow the LAPACK conventions of getrf, gesv, getri
+// and potrf.
+constexpr int64_t kSmallMatrixMaxSize = 8;
+
+using small_lu_fn = void(*)(Tensor& self, int* pivots, int* infos);
+using small_solve_fn = void(*)(Tensor& b, Tensor& A, int64_t* infos);
+using small_inverse_fn = void(*)(Tensor& self, int64_t* infos);
+using small_cholesky_fn = void(*)(Tensor& self, bool upper, int64_t* infos);
+
+DECLARE_DISPATCH(small_lu_fn, small_lu_stub);
+DECLARE_DISPATCH(small_solve_fn, small_solve_stub);
+DECLARE_DISPATCH(small_inverse_fn, small_inverse_stub);
+DECLARE_DISPATCH(small_cholesky_fn, small_cholesky_stub);
+
+}} // namespace at::native
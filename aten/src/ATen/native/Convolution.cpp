@@ -238,12 +238,18 @@ auto ConvParams::use_nnpack(const at::Tensor& input) const -> bool {
   return false;
 }
 
-// We currently only have depthwise support for the case where groups ==
-// nInputPlane and nInputPlane == nOutputPlane (the latter due to the lack of
-// a depthwise multiplier)
+// We only have depthwise support for the case where groups == nInputPlane,
+// on CUDA and on CPU for the dtypes of the direct kernel. On CPU mkldnn and
+// the ARM winograd kernel are preferred when they apply.
 auto ConvParams::is_depthwise(
         const at::Tensor& input, const at::Tensor& weight) const -> bool {
-  return input.is_cuda() &&
+  const bool cpu_depthwise = input.device().is_cpu() &&
+         input.layout() == at::kStrided &&
+         (input.scalar_type() == kFloat || input.scalar_type() == kDouble) &&
+         weight.scalar_type() == input.scalar_type() &&
+         !use_mkldnn(input) &&
+         !use_cpu_depthwise3x3_winograd(input, weight);
+  return (input.is_cuda() || cpu_depthwise) &&
          !transposed &&
          input.ndimension() == 4 &&
          input.size(1) == groups &&
@@ -646,7 +652,10 @@ at::Tensor _convolution(
             input.contiguous(), weight, bias,
             padding, stride, dilation, params.groups, params.benchmark, params.deterministic);
       } else {
-          output = at::thnn_conv_depthwise2d(input.contiguous(), weight, kernel_size, bias, stride, padding, dilation);
+          // the CPU kernel has a channels last variant
+          output = at::thnn_conv_depthwise2d(
+              input.device().is_cpu() ? input.contiguous(input.suggest_memory_format()) : input.contiguous(),
+              weight, kernel_size, bias, stride, padding, dilation);
       }
   } else if (params.use_cudnn(input, weight)) {
     TORCH_CHECK(input.options().type_equal(weight.options()),
@@ -710,8 +719,14 @@ at::Tensor _convolution(
       output = convolution_depthwise3x3_winograd_stub(
         input.device().type(), input, weight, bias, params.stride, params.padding, params.groups);
     } else if (params.groups == 1) {
+      // thnn_conv2d and slow_conv_transpose2d have NHWC kernels on CPU, so
+      // channels last inputs stay channels last for them; the other kernels
+      // expect NCHW.
+      const bool keep_channels_last = input.device().is_cpu() &&
+          (params.transposed || !params.is_dilated()) && !params.use_nnpack(input);
       output = at::_convolution_nogroup(
-          input.contiguous(), weight, bias, params.stride, params.padding, params.dilation, params.transposed, params.output_padding);
+          keep_channels_last ? input.contiguous(input.suggest_memory_format()) : input.contiguous(),
+          weight, bias, params.stride, params.padding, params.dilation, params.transposed, params.output_padding);
     } else {
       std::vector<Tensor> outputs(params.groups);
       input = input.contiguous();
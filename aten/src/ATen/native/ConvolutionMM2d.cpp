@@ -124,6 +124,19 @@ static inline void slow_conv2d_shape_check(
   }
 }
 
+// 1x1 convolutions with unit stride and no padding multiply the weight with
+// the input frame directly, the columns of im2col would be a copy of it.
+static inline bool is_pointwise(
+    int64_t kernel_height,
+    int64_t kernel_width,
+    int64_t stride_height,
+    int64_t stride_width,
+    int64_t pad_height,
+    int64_t pad_width) {
+  return kernel_height == 1 && kernel_width == 1 && stride_height == 1 &&
+      stride_width == 1 && pad_height == 0 && pad_width == 0;
+}
+
 static Tensor view_weight_2d(const Tensor& weight_) {
   Tensor weight = weight_.contiguous();
   if (weight.dim() == 4) {
@@ -152,22 +165,28 @@ static void slow_conv2d_update_output_frame(
     int64_t input_width,
     int64_t n_output_plane,
     int64_t output_height,
-    int64_t output_width) {
-  unfolded2d_copy_stub(
-      kCPU,
-      finput,
-      input,
-      kernel_height,
-      kernel_width,
-      stride_height,
-      stride_width,
-      pad_height,
-      pad_width,
-      n_input_plane,
-      input_height,
-      input_width,
-      output_height,
-      output_width);
+    int64_t output_width,
+    bool pointwise) {
+  if (!pointwise) {
+    unfolded2d_copy_stub(
+        kCPU,
+        finput,
+        input,
+        kernel_height,
+        kernel_width,
+        stride_height,
+        stride_width,
+        pad_height,
+        pad_width,
+        n_input_plane,
+        input_height,
+        input_width,
+        output_height,
+        output_width);
+  }
+  const Tensor columns = pointwise
+      ? input.view({n_input_plane, output_height * output_width})
+      : finput;
 
   auto output2d =
       output.reshape({n_output_plane, output_height * output_width});
@@ -179,7 +198,110 @@ static void slow_conv2d_update_output_frame(
     output.zero_();
   }
 
-  output2d.addmm_(weight, finput, 1, 1);
+  output2d.addmm_(weight, columns, 1, 1);
+}
+
+// im2col for an NHWC input frame. finput keeps the usual
+// (n_input_plane * kernel_height * kernel_width, output_height * output_width)
+// layout, so the backward functions can consume it unchanged.
+template <typename scalar_t>
+static void unfolded2d_copy_channels_last(
+    const scalar_t* input_data,
+    scalar_t* finput_data,
+    int64_t kernel_height,
+    int64_t kernel_width,
+    int64_t stride_height,
+    int64_t stride_width,
+    int64_t pad_height,
+    int64_t pad_width,
+    int64_t n_input_plane,
+    int64_t input_height,
+    int64_t input_width,
+    int64_t output_height,
+    int64_t output_width) {
+  const int64_t output_size = output_height * output_width;
+  const int64_t plane_stride = kernel_height * kernel_width * output_size;
+  for (int64_t oh = 0; oh < output_height; oh++) {
+    for (int64_t ow = 0; ow < output_width; ow++) {
+      for (int64_t kh = 0; kh < kernel_height; kh++) {
+        const int64_t ih = oh * stride_height - pad_height + kh;
+        for (int64_t kw = 0; kw < kernel_width; kw++) {
+          const int64_t iw = ow * stride_width - pad_width + kw;
+          scalar_t* dst = finput_data + (kh * kernel_width + kw) * output_size +
+              oh * output_width + ow;
+          if (ih < 0 || ih >= input_height || iw < 0 || iw >= input_width) {
+            for (int64_t c = 0; c < n_input_plane; c++) {
+              dst[c * plane_stride] = 0;
+            }
+          } else {
+            const scalar_t* src =
+                input_data + (ih * input_width + iw) * n_input_plane;
+            for (int64_t c = 0; c < n_input_plane; c++) {
+              dst[c * plane_stride] = src[c];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+static void slow_conv2d_update_output_frame_channels_last(
+    Tensor& input,
+    Tensor& output,
+    const Tensor& weight,
+    const Tensor& bias,
+    Tensor& finput,
+    int64_t kernel_height,
+    int64_t kernel_width,
+    int64_t stride_height,
+    int64_t stride_width,
+    int64_t pad_height,
+    int64_t pad_width,
+    int64_t n_input_plane,
+    int64_t input_height,
+    int64_t input_width,
+    int64_t n_output_plane,
+    int64_t output_height,
+    int64_t output_width,
+    bool pointwise) {
+  // An NHWC output frame is a row-major
+  // (output_height * output_width, n_output_plane) matrix.
+  auto output2d = output.permute({1, 2, 0})
+                      .reshape({output_height * output_width, n_output_plane});
+  if (bias.defined()) {
+    output2d.copy_(bias);
+  } else {
+    output2d.zero_();
+  }
+
+  if (pointwise) {
+    // so is the input frame
+    output2d.addmm_(
+        input.permute({1, 2, 0}).reshape({input_height * input_width, n_input_plane}),
+        weight.t(), 1, 1);
+    return;
+  }
+
+  AT_DISPATCH_ALL_TYPES_AND(
+      at::ScalarType::BFloat16, input.scalar_type(), "unfolded2d_copy_channels_last", [&] {
+        unfolded2d_copy_channels_last(
+            input.data_ptr<scalar_t>(),
+            finput.data_ptr<scalar_t>(),
+            kernel_height,
+            kernel_width,
+            stride_height,
+            stride_width,
+            pad_height,
+            pad_width,
+            n_input_plane,
+            input_height,
+            input_width,
+            output_height,
+            output_width);
+      });
+
+  output2d.addmm_(finput.t(), weight.t(), 1, 1);
 }
 
 void slow_conv2d_backward_update_grad_input_frame(
@@ -192,10 +314,18 @@ void slow_conv2d_backward_update_grad_input_frame(
     int64_t stride_height,
     int64_t stride_width,
     int64_t pad_height,
-    int64_t pad_width) {
+    int64_t pad_width,
+    bool pointwise) {
   auto grad_output_2d = grad_output.reshape(
       {grad_output.size(0), grad_output.size(1) * grad_output.size(2)});
-  fgrad_input.addmm_(weight, grad_output_2d, 0, 1);
+  if (pointwise) {
+    // the gradient of the columns is the gradient of the input
+    auto grad_input_2d = grad_input.view(
+        {grad_input.size(0), grad_input.size(1) * grad_input.size(2)});
+    at::mm_out(grad_input_2d, weight, grad_output_2d);
+    return;
+  }
+  at::mm_out(fgrad_input, weight, grad_output_2d);
 
   grad_input.zero_();
   unfolded2d_acc_stub(
@@ -220,8 +350,6 @@ void slow_conv2d_backward_out_cpu_template(
     const Tensor& grad_output_,
     const Tensor& input_,
     const Tensor& weight_,
-    const Tensor& finput,
-    Tensor& fgrad_input,
     IntArrayRef kernel_size,
     IntArrayRef stride,
     IntArrayRef padding) {
@@ -249,17 +377,24 @@ void slow_conv2d_backward_out_cpu_template(
   const Tensor input = input_.contiguous();
   const Tensor grad_output = grad_output_.contiguous();
   grad_input.resize_as_(input);
-  fgrad_input.resize_as_(finput);
-  fgrad_input.zero_();
   const Tensor tweight = weight.transpose(0, 1);
   const int64_t batch_size = input.size(0);
+  const bool pointwise = is_pointwise(
+      kernel_height, kernel_width, stride_height, stride_width, pad_height, pad_width);
   at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
     NoGradGuard no_grad;
     AutoNonVariableTypeMode non_variable_type_mode;
+    // the gradient of the columns of a frame is only needed until it is
+    // folded into grad_input, so each thread reuses one buffer for its frames
+    Tensor fgrad_input_t;
+    if (!pointwise) {
+      fgrad_input_t = at::empty(
+          {tweight.size(0), grad_output.size(2) * grad_output.size(3)},
+          grad_output.options());
+    }
     for (int64_t t = start; t < end; t++) {
       Tensor grad_input_t = grad_input[t];
       Tensor grad_output_t = grad_output[t];
-      Tensor fgrad_input_t = fgrad_input[t];
       slow_conv2d_backward_update_grad_input_frame(
           grad_input_t,
           grad_output_t,
@@ -270,7 +405,8 @@ void slow_conv2d_backward_out_cpu_template(
           stride_height,
           stride_width,
           pad_height,
-          pad_width);
+          pad_width,
+          pointwise);
     }
   });
 }
@@ -313,7 +449,6 @@ static void slow_conv2d_backward_parameters_out_cpu_template(
     const Tensor& input_,
     const Tensor& grad_output_,
     const Tensor& finput,
-    Tensor fgrad_input,
     IntArrayRef kernel_size,
     IntArrayRef stride,
     IntArrayRef padding) {
@@ -355,11 +490,48 @@ static void slow_conv2d_backward_parameters_out_cpu_template(
   auto grad_output = grad_output_.contiguous();
 
   const int64_t batch_size = input.size(0);
+  const int64_t n_input_plane = input.size(1);
+  const int64_t output_height = grad_output.size(2);
+  const int64_t output_width = grad_output.size(3);
+  const bool pointwise = is_pointwise(
+      kernel_height, kernel_width, stride_height, stride_width, pad_height, pad_width);
+  // The forward only saves the columns when they differ from the input and
+  // a backward is then expected; otherwise they are rebuilt frame by frame.
+  const bool rebuild_columns = grad_weight_2d.defined() && !pointwise &&
+      finput.numel() == 0;
+  Tensor columns;
+  if (rebuild_columns) {
+    columns = at::empty(
+        {n_input_plane * kernel_height * kernel_width, output_height * output_width},
+        input.options());
+  }
   for (int64_t t = 0; t < batch_size; t++) {
     Tensor grad_output_t = grad_output[t];
     Tensor finput_t;
     if (grad_weight_2d.defined()) {
-      finput_t = finput[t];
+      if (pointwise) {
+        finput_t = input[t].view({n_input_plane, output_height * output_width});
+      } else if (rebuild_columns) {
+        Tensor input_t = input[t];
+        unfolded2d_copy_stub(
+            kCPU,
+            columns,
+            input_t,
+            kernel_height,
+            kernel_width,
+            stride_height,
+            stride_width,
+            pad_height,
+            pad_width,
+            n_input_plane,
+            input.size(2),
+            input.size(3),
+            output_height,
+            output_width);
+        finput_t = columns;
+      } else {
+        finput_t = finput[t];
+      }
     }
 
     slow_conv2d_backward_parameters_frame(
@@ -401,7 +573,8 @@ std::tuple<Tensor&, Tensor&, Tensor&> slow_conv2d_forward_out_cpu(
       pad_width,
       false);
 
-  const Tensor input = self.contiguous();
+  const auto memory_format = self.suggest_memory_format();
+  const Tensor input = self.contiguous(memory_format);
   const int64_t ndim = input.dim();
   const int64_t dim_planes = 1;
   const int64_t dim_height = 2;
@@ -418,19 +591,42 @@ std::tuple<Tensor&, Tensor&, Tensor&> slow_conv2d_forward_out_cpu(
 
   const int64_t batch_size = input.size(0);
 
-  finput.resize_({batch_size,
-                  n_input_plane * kernel_height * kernel_width,
-                  output_height * output_width});
-  output.resize_({batch_size, n_output_plane, output_height, output_width});
+  const bool pointwise = is_pointwise(
+      kernel_height, kernel_width, stride_height, stride_width, pad_height, pad_width);
+  // finput is only read by the gradient of the weight, so the columns of all
+  // the frames are only kept when it will be computed; the backward rebuilds
+  // them otherwise.
+  const bool keep_columns = !pointwise && GradMode::is_enabled() && weight_.requires_grad();
+  if (keep_columns) {
+    finput.resize_({batch_size,
+                    n_input_plane * kernel_height * kernel_width,
+                    output_height * output_width});
+  } else {
+    finput.resize_({0});
+  }
+  output.resize_({batch_size, n_output_plane, output_height, output_width}, memory_format);
+
+  // Channels last inputs produce a channels last output; finput has the same
+  // layout either way.
+  const auto update_output_frame = memory_format == at::MemoryFormat::ChannelsLast
+      ? slow_conv2d_update_output_frame_channels_last
+      : slow_conv2d_update_output_frame;
 
   at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
     NoGradGuard no_grad;
     AutoNonVariableTypeMode non_variable_type_mode;
+    // without kept columns each thread reuses one buffer for its frames
+    Tensor columns;
+    if (!keep_columns && !pointwise) {
+      columns = at::empty(
+          {n_input_plane * kernel_height * kernel_width, output_height * output_width},
+          input.options());
+    }
     for (int64_t t = start; t < end; t++) {
       Tensor input_t = input[t];
       Tensor output_t = output[t];
-      Tensor finput_t = finput[t];
-      slow_conv2d_update_output_frame(
+      Tensor finput_t = keep_columns ? finput[t] : columns;
+      update_output_frame(
           input_t,
           output_t,
           weight_2d,
@@ -447,7 +643,8 @@ std::tuple<Tensor&, Tensor&, Tensor&> slow_conv2d_forward_out_cpu(
           input_width,
           n_output_plane,
           output_height,
-          output_width);
+          output_width,
+          pointwise);
     }
   });
 
@@ -495,8 +692,6 @@ std::tuple<Tensor&, Tensor&, Tensor&> slow_conv2d_backward_out_cpu(
         grad_output,
         self,
         weight,
-        finput,
-        const_cast<Tensor&>(fgrad_input),   // cast away auto-generated const of buffer
         kernel_size,
         stride,
         padding);
@@ -519,7 +714,6 @@ std::tuple<Tensor&, Tensor&, Tensor&> slow_conv2d_backward_out_cpu(
         self,
         grad_output,
         finput,
-        fgrad_input,
         kernel_size,
         stride,
         padding);
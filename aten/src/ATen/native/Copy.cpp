@@ -14,66 +14,6 @@ namespace {
 
 using namespace at;
 
-bool copy_transpose_valid(const Tensor& self, const Tensor& src) {
-  const int MIN_SZ = 60 * 60;
-  return self.is_contiguous() && src.numel() != 0 && src.dim() == 2 &&
-      src.stride(0) == 1 && src.stride(1) == src.size(0) &&
-      self.scalar_type() == src.scalar_type() &&
-      self.numel() >= MIN_SZ;
-}
-
-// special case copy where tensor is contiguous and src is a transposed matrix
-// This can be generalized to most copies, but it's trickier
-void copy_same_type_transpose_(Tensor& self, const Tensor& src) {
-  int64_t BLOCK_SZ;
-  if (self.scalar_type() == kByte) {
-    BLOCK_SZ = 120;
-  } else {
-    BLOCK_SZ = 60;
-  }
-  Tensor buf = empty({BLOCK_SZ, BLOCK_SZ}, self.options());
-
-  AT_DISPATCH_ALL_TYPES_AND3(kHalf, kBool, kBFloat16, self.scalar_type(), "copy_", [&] {
-    scalar_t* sp = src.data_ptr<scalar_t>();
-    scalar_t* rp = self.data_ptr<scalar_t>();
-    scalar_t* bp = buf.data_ptr<scalar_t>();
-
-    int64_t NR = src.size(0);
-    int64_t NC = src.size(1);
-    for (int64_t R = 0; R < NR; R += BLOCK_SZ) {
-      for (int64_t C = 0; C < NC; C += BLOCK_SZ) {
-        scalar_t* spo = sp + R + C * NR;
-        scalar_t* rpo = rp + C + R * NC;
-
-        int nr = std::min(NR - R, BLOCK_SZ);
-        int nc = std::min(NC - C, BLOCK_SZ);
-
-        // 1. copy columns from src to buf
-        for (int c = 0; c < nc; c++) {
-          memcpy(bp + c * BLOCK_SZ, spo + c * NR, nr * sizeof(scalar_t));
-        }
-
-        // 2. transpose buf in place
-        int rc_max = std::max(nr, nc);
-        int rc_min = std::min(nr, nc);
-        for (int r = 0; r < rc_max; r++) {
-          int end = std::min(r, rc_min);
-          for (int c = 0; c < end; c++) {
-            scalar_t tmp = bp[r + BLOCK_SZ * c];
-            bp[r + BLOCK_SZ * c] = bp[r * BLOCK_SZ + c];
-            bp[r * BLOCK_SZ + c] = tmp;
-          }
-        }
-
-        // 3. copy rows from buf to dst
-        for (int r = 0; r < nr; r++) {
-          memcpy(rpo + r * NC, bp + r * BLOCK_SZ, nc * sizeof(scalar_t));
-        }
-      }
-    }
-  });
-}
-
 // Devices directly supported by this copy implementation. Other device types
 // (e.g. XLA) may be supported by overriding copy_ and _copy_from.
 bool is_supported_device(Device device) {
@@ -143,12 +83,6 @@ static Tensor & copy_impl(Tensor & self, const Tensor & src, bool non_blocking)
     device_type = kCUDA;
   }
 
-  // TODO: if we need to, we can also enable this path for quantized tensor
-  if (device_type == kCPU && copy_transpose_valid(self, src) && !self.is_quantized()) {
-    copy_same_type_transpose_(self, src);
-    return self;
-  }
-
   copy_stub(device_type, iter, non_blocking);
   return self;
 }
@@ -170,6 +104,45 @@ static auto registry = torch::RegisterOperators()
     .aliasAnalysis(AliasAnalysisKind::FROM_SCHEMA))
   ;
 
+c10::optional<TransposeCopy> as_transpose_copy(const TensorIterator& iter) {
+  // smaller copies are left to the elementwise loops
+  const int64_t kMinNumel = 60 * 60;
+  const int64_t kMinSize = 8;
+  if (iter.ntensors() != 2 || iter.dtype(0) != iter.dtype(1) ||
+      iter.ndim() < 2 || iter.ndim() > 3 || iter.numel() < kMinNumel) {
+    return c10::nullopt;
+  }
+  const int64_t element_size = iter.element_size(0);
+  if (element_size != 1 && element_size != 2 && element_size != 4 && element_size != 8) {
+    return c10::nullopt;
+  }
+  // the dimensions are ordered by the strides of the destination, so its
+  // columns are the fastest moving dimension
+  auto dst_strides = iter.strides(0);
+  auto src_strides = iter.strides(1);
+  if (dst_strides[0] != element_size || src_strides[1] != element_size ||
+      dst_strides[1] <= 0 || src_strides[0] <= 0) {
+    return c10::nullopt;
+  }
+  for (int i = 0; i < iter.ndim(); i++) {
+    if (dst_strides[i] % element_size != 0 || src_strides[i] % element_size != 0) {
+      return c10::nullopt;
+    }
+  }
+  TransposeCopy transpose;
+  transpose.rows = iter.shape()[0];
+  transpose.cols = iter.shape()[1];
+  if (transpose.rows < kMinSize || transpose.cols < kMinSize) {
+    return c10::nullopt;
+  }
+  transpose.batch = iter.ndim() == 3 ? iter.shape()[2] : 1;
+  transpose.src_ld = src_strides[0] / element_size;
+  transpose.dst_ld = dst_strides[1] / element_size;
+  transpose.src_batch_stride = iter.ndim() == 3 ? src_strides[2] / element_size : 0;
+  transpose.dst_batch_stride = iter.ndim() == 3 ? dst_strides[2] / element_size : 0;
+  return transpose;
+}
+
 DEFINE_DISPATCH(copy_stub);
 
 } // namespace native
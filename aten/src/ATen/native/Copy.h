@@ -13,5 +13,23 @@ using copy_fn = void (*)(TensorIterator&, bool non_blocking);
 
 DECLARE_DISPATCH(copy_fn, copy_stub);
 
+// A same-dtype copy of `batch` matrices of `rows` x `cols` elements whose
+// rows are contiguous in the source and columns in the destination, i.e.
+//   dst[b * dst_batch_stride + c * dst_ld + r] = src[b * src_batch_stride + r * src_ld + c]
+// with strides in elements, such as x.t().contiguous() or NCHW to NHWC.
+struct TransposeCopy {
+  int64_t rows;
+  int64_t cols;
+  int64_t batch;
+  int64_t src_ld;
+  int64_t dst_ld;
+  int64_t src_batch_stride;
+  int64_t dst_batch_stride;
+};
+
+// Returns the TransposeCopy that `iter` performs, if it is large enough for a
+// tiled transpose to pay off.
+CAFFE2_API c10::optional<TransposeCopy> as_transpose_copy(const TensorIterator& iter);
+
 } // namespace native
 } // namespace at
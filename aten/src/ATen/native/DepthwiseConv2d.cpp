@@ -0,0 +1,199 @@
+#include <ATen/ATen.h>
+#include <ATen/TensorUtils.h>
+#include <ATen/div_rtn.h>
+#include <ATen/native/cpu/DepthwiseConv2dKernel.h>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(depthwise_conv2d_stub);
+DEFINE_DISPATCH(depthwise_conv2d_backward_input_stub);
+DEFINE_DISPATCH(depthwise_conv2d_backward_weight_stub);
+
+namespace {
+
+// Checks the arguments of a depthwise convolution and returns the size of
+// its output.
+std::vector<int64_t> depthwise_conv2d_output_size(
+    const Tensor& input,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  TORCH_CHECK(
+      kernel_size.size() == 2 && stride.size() == 2 && padding.size() == 2 &&
+          dilation.size() == 2,
+      "depthwise_conv2d: kernel_size, stride, padding and dilation must have 2 elements");
+  TORCH_CHECK(
+      stride[0] > 0 && stride[1] > 0,
+      "depthwise_conv2d: stride should be greater than zero, but got ", stride);
+  TORCH_CHECK(
+      dilation[0] > 0 && dilation[1] > 0,
+      "depthwise_conv2d: dilation should be greater than zero, but got ", dilation);
+  TORCH_CHECK(
+      padding[0] >= 0 && padding[1] >= 0,
+      "depthwise_conv2d: padding should be non-negative, but got ", padding);
+  TORCH_CHECK(
+      input.dim() == 4,
+      "depthwise_conv2d: 4D input tensor expected, but got: ", input.sizes());
+  TORCH_CHECK(
+      weight.dim() == 4 && weight.size(1) == 1 && weight.size(2) == kernel_size[0] &&
+          weight.size(3) == kernel_size[1],
+      "depthwise_conv2d: expected a weight of size (out_channels, 1, ", kernel_size[0],
+      ", ", kernel_size[1], "), but got: ", weight.sizes());
+  TORCH_CHECK(
+      input.size(1) > 0 && weight.size(0) % input.size(1) == 0,
+      "depthwise_conv2d: the output channels (", weight.size(0),
+      ") must be a multiple of the input channels (", input.size(1), ")");
+  TORCH_CHECK(
+      input.scalar_type() == weight.scalar_type(),
+      "depthwise_conv2d: expected input and weight of the same dtype, but got ",
+      input.scalar_type(), " and ", weight.scalar_type());
+
+  std::vector<int64_t> output_size{input.size(0), weight.size(0), 0, 0};
+  for (int64_t d = 0; d < 2; d++) {
+    const int64_t extent = dilation[d] * (kernel_size[d] - 1) + 1;
+    output_size[d + 2] = div_rtn<int64_t>(input.size(d + 2) + 2 * padding[d] - extent, stride[d]) + 1;
+    TORCH_CHECK(
+        output_size[d + 2] > 0,
+        "depthwise_conv2d: given input size per channel: (", input.size(2), " x ",
+        input.size(3), "), the calculated output size is too small");
+  }
+  return output_size;
+}
+
+} // namespace
+
+Tensor& thnn_conv_depthwise2d_forward_out_cpu(
+    Tensor& output,
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  const auto output_size =
+      depthwise_conv2d_output_size(self, weight, kernel_size, stride, padding, dilation);
+  if (bias.defined()) {
+    check_dim_size(bias, 1, 0, weight.size(0));
+  }
+
+  // channels last inputs stay channels last, all the operands of the kernel
+  // share the layout of the input
+  const auto memory_format = self.suggest_memory_format();
+  const Tensor input = self.contiguous(memory_format);
+  output.resize_(output_size, memory_format);
+  if (output.numel() == 0) {
+    return output;
+  }
+  Tensor result = output.is_contiguous(memory_format)
+      ? output
+      : at::empty(output_size, output.options(), memory_format);
+  depthwise_conv2d_stub(
+      kCPU, result, input, weight.contiguous(),
+      bias.defined() ? bias.contiguous() : bias, stride, padding, dilation, memory_format);
+  if (!result.is_same(output)) {
+    output.copy_(result);
+  }
+  return output;
+}
+
+Tensor thnn_conv_depthwise2d_forward_cpu(
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  auto output = at::empty({0}, self.options());
+  thnn_conv_depthwise2d_forward_out_cpu(
+      output, self, weight, kernel_size, bias, stride, padding, dilation);
+  return output;
+}
+
+std::tuple<Tensor&, Tensor&> thnn_conv_depthwise2d_backward_out_cpu(
+    Tensor& grad_input,
+    Tensor& grad_weight,
+    const Tensor& grad_output,
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation) {
+  const auto output_size =
+      depthwise_conv2d_output_size(self, weight, kernel_size, stride, padding, dilation);
+  TORCH_CHECK(
+      grad_output.sizes().equals(output_size),
+      "depthwise_conv2d_backward: expected grad_output of size ", IntArrayRef(output_size),
+      ", but got: ", grad_output.sizes());
+
+  const auto memory_format = self.suggest_memory_format();
+  const Tensor grad_out = grad_output.contiguous(memory_format);
+
+  if (grad_input.defined()) {
+    grad_input.resize_(self.sizes(), memory_format);
+    if (grad_input.numel() > 0 && grad_out.numel() > 0) {
+      Tensor result = grad_input.is_contiguous(memory_format)
+          ? grad_input
+          : at::empty(self.sizes(), grad_input.options(), memory_format);
+      depthwise_conv2d_backward_input_stub(
+          kCPU, result, grad_out, weight.contiguous(), stride, padding, dilation, memory_format);
+      if (!result.is_same(grad_input)) {
+        grad_input.copy_(result);
+      }
+    } else {
+      grad_input.zero_();
+    }
+  }
+
+  if (grad_weight.defined()) {
+    grad_weight.resize_(weight.sizes());
+    if (grad_weight.numel() > 0 && grad_out.numel() > 0) {
+      Tensor result = grad_weight.is_contiguous()
+          ? grad_weight
+          : at::empty(weight.sizes(), grad_weight.options());
+      depthwise_conv2d_backward_weight_stub(
+          kCPU, result, grad_out, self.contiguous(memory_format), stride, padding, dilation, memory_format);
+      if (!result.is_same(grad_weight)) {
+        grad_weight.copy_(result);
+      }
+    } else {
+      grad_weight.zero_();
+    }
+  }
+
+  return std::tuple<Tensor&, Tensor&>(grad_input, grad_weight);
+}
+
+std::tuple<Tensor, Tensor> thnn_conv_depthwise2d_backward_cpu(
+    const Tensor& grad_output,
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef kernel_size,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    std::array<bool, 2> output_mask) {
+  Tensor grad_input;
+  Tensor grad_weight;
+
+  if (output_mask[0]) {
+    grad_input = at::empty({0}, grad_output.options());
+  }
+
+  if (output_mask[1]) {
+    grad_weight = at::empty({0}, grad_output.options());
+  }
+
+  thnn_conv_depthwise2d_backward_out_cpu(
+      grad_input, grad_weight, grad_output, self, weight,
+      kernel_size, stride, padding, dilation);
+  return std::make_tuple(grad_input, grad_weight);
+}
+
+} // namespace native
+} // namespace at
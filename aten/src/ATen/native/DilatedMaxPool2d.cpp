@@ -118,6 +118,77 @@ static void max_pool2d_with_indices_out_frame(
   });
 }
 
+template <typename scalar_t>
+static void max_pool2d_with_indices_out_frame_channels_last(
+          scalar_t *input_data,
+          scalar_t *output_data,
+          int64_t *indices_data,
+          int64_t nbatch,
+          int64_t nInputPlane,
+          int64_t inputWidth,
+          int64_t inputHeight,
+          int64_t outputWidth,
+          int64_t outputHeight,
+          int kW,
+          int kH,
+          int dW,
+          int dH,
+          int padW,
+          int padH,
+          int dilationW,
+          int dilationH)
+{
+  /* input and output are NHWC; like the NCHW kernel, indices hold the
+     flattened h * inputWidth + w position of the max within its plane */
+  at::parallel_for(0, nbatch * outputHeight * outputWidth, 0, [&](int64_t start, int64_t end) {
+    for (auto idx = start; idx < end; idx++)
+    {
+      const int64_t p = idx / (outputHeight * outputWidth);
+      const int64_t i = (idx / outputWidth) % outputHeight;
+      const int64_t j = idx % outputWidth;
+
+      int64_t hstart = i * dH - padH;
+      int64_t wstart = j * dW - padW;
+      int64_t hend = std::min(hstart + (kH - 1) * dilationH + 1, inputHeight);
+      int64_t wend = std::min(wstart + (kW - 1) * dilationW + 1, inputWidth);
+      while(hstart < 0)
+        hstart += dilationH;
+      while(wstart < 0)
+        wstart += dilationW;
+
+      /* local pointers */
+      scalar_t *ip = input_data + p*inputHeight*inputWidth*nInputPlane;
+      scalar_t *op = output_data + idx*nInputPlane;
+      int64_t *indp = indices_data + idx*nInputPlane;
+
+      for (int64_t c = 0; c < nInputPlane; c++)
+      {
+        op[c] = -std::numeric_limits<scalar_t>::infinity();
+        indp[c] = hstart*inputWidth + wstart;
+      }
+
+      /* compute local max, one channel vector at a time */
+      for(int64_t y = hstart; y < hend; y += dilationH)
+      {
+        for(int64_t x = wstart; x < wend; x += dilationW)
+        {
+          int64_t tcntr = y*inputWidth + x;
+          scalar_t *vp = ip + tcntr*nInputPlane;
+          for (int64_t c = 0; c < nInputPlane; c++)
+          {
+            scalar_t val = vp[c];
+            if ((val > op[c]) || std::isnan(val))
+            {
+              op[c] = val;
+              indp[c] = tcntr;
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
 void max_pool2d_with_indices_out_cpu_template(
           Tensor& output,
           Tensor& indices,
@@ -171,8 +242,9 @@ void max_pool2d_with_indices_out_cpu_template(
     inputHeight, inputWidth,
     outputHeight, outputWidth);
 
-  /* get contiguous input */
-  Tensor input = input_.contiguous();
+  /* get contiguous input, keeping channels last inputs in NHWC */
+  const auto memory_format = input_.suggest_memory_format();
+  Tensor input = input_.contiguous(memory_format);
 
   /* resize output */
   if (input.ndimension() == 3)
@@ -201,6 +273,32 @@ void max_pool2d_with_indices_out_cpu_template(
       }
     );
   }
+  else if (memory_format == at::MemoryFormat::ChannelsLast)
+  {
+    output.resize_({nbatch, nInputPlane, outputHeight, outputWidth}, memory_format);
+    /* indices will contain the locations for each output point */
+    indices.resize_({nbatch, nInputPlane, outputHeight, outputWidth}, memory_format);
+
+    AT_DISPATCH_FLOATING_TYPES(input.scalar_type(),
+      "max_pool2d_with_indices_cpu",
+      [&] {
+        scalar_t *input_data = input.data_ptr<scalar_t>();
+        scalar_t *output_data = output.data_ptr<scalar_t>();
+        int64_t *indices_data = indices.data_ptr<int64_t>();
+
+        max_pool2d_with_indices_out_frame_channels_last(
+          input_data,
+          output_data,
+          indices_data,
+          nbatch,
+          nInputPlane,
+          inputWidth, inputHeight,
+          outputWidth, outputHeight,
+          kW, kH, dW, dH,
+          padW, padH,
+          dilationW, dilationH); }
+    );
+  }
   else
   {
     output.resize_({nbatch, nInputPlane, outputHeight, outputWidth});
@@ -295,6 +393,37 @@ static void max_pool2d_with_indices_backward_out_frame(
   });
 }
 
+template <typename scalar_t>
+static void max_pool2d_with_indices_backward_out_frame_channels_last(
+          scalar_t *gradInput_data,
+          scalar_t *gradOutput_data,
+          int64_t *indices_data,
+          int64_t nbatch,
+          int64_t nInputPlane,
+          int64_t inputWidth,
+          int64_t inputHeight,
+          int64_t outputWidth,
+          int64_t outputHeight)
+{
+  at::parallel_for(0, nbatch, 0, [&](int64_t start, int64_t end) {
+    for (auto p = start; p < end; p++) {
+      scalar_t *gradInput_p = gradInput_data + p*inputHeight*inputWidth*nInputPlane;
+      scalar_t *gradOutput_p = gradOutput_data + p*outputHeight*outputWidth*nInputPlane;
+      int64_t *ind_p = indices_data + p*outputHeight*outputWidth*nInputPlane;
+
+      for (int64_t k = 0; k < outputHeight*outputWidth*nInputPlane; k++)
+      {
+        /* retrieve position of max */
+        int64_t maxp = ind_p[k];
+        if (maxp != -1) {
+          /* update gradient */
+          gradInput_p[maxp*nInputPlane + k%nInputPlane] += gradOutput_p[k];
+        }
+      }
+    }
+  });
+}
+
 Tensor& max_pool2d_with_indices_backward_out_cpu_template(
           Tensor& gradInput,
           const Tensor& gradOutput_,
@@ -333,11 +462,13 @@ Tensor& max_pool2d_with_indices_backward_out_cpu_template(
   TORCH_CHECK((input.ndimension() == 3 || input.ndimension() == 4),
     "non-empty 3D or 4D (batch mode) tensor expected for input");
 
-  /* get contiguous gradOutput */
-  const Tensor gradOutput = gradOutput_.contiguous();
+  /* get contiguous gradOutput and indices in the layout of input */
+  const auto memory_format = input.suggest_memory_format();
+  const Tensor gradOutput = gradOutput_.contiguous(memory_format);
+  const Tensor indices_ = indices.contiguous(memory_format);
 
   /* resize */
-  gradInput.resize_as_(input);
+  gradInput.resize_(input.sizes(), memory_format);
   gradInput.zero_();
 
   /* sizes */
@@ -371,7 +502,7 @@ Tensor& max_pool2d_with_indices_backward_out_cpu_template(
         /* get raw pointers */
         scalar_t *gradInput_data = gradInput.data_ptr<scalar_t>();
         scalar_t *gradOutput_data = gradOutput.data_ptr<scalar_t>();
-        int64_t *indices_data = indices.data_ptr<int64_t>();
+        int64_t *indices_data = indices_.data_ptr<int64_t>();
 
         max_pool2d_with_indices_backward_single_out_frame(
           gradInput_data, gradOutput_data,
@@ -383,6 +514,26 @@ Tensor& max_pool2d_with_indices_backward_out_cpu_template(
       }
     );
   }
+  else if (memory_format == at::MemoryFormat::ChannelsLast)
+  {
+    AT_DISPATCH_FLOATING_TYPES(input.scalar_type(),
+      "max_pool2d_with_indices_backward",
+      [&] {
+        /* get raw pointers */
+        scalar_t *gradInput_data = gradInput.data_ptr<scalar_t>();
+        scalar_t *gradOutput_data = gradOutput.data_ptr<scalar_t>();
+        int64_t *indices_data = indices_.data_ptr<int64_t>();
+
+        max_pool2d_with_indices_backward_out_frame_channels_last<scalar_t>(
+          gradInput_data, gradOutput_data,
+          indices_data,
+          nbatch,
+          nInputPlane,
+          inputWidth, inputHeight,
+          outputWidth, outputHeight);
+      }
+    );
+  }
   else
   {
     AT_DISPATCH_FLOATING_TYPES(input.scalar_type(),
@@ -391,7 +542,7 @@ Tensor& max_pool2d_with_indices_backward_out_cpu_template(
         /* get raw pointers */
         scalar_t *gradInput_data = gradInput.data_ptr<scalar_t>();
         scalar_t *gradOutput_data = gradOutput.data_ptr<scalar_t>();
-        int64_t *indices_data = indices.data_ptr<int64_t>();
+        int64_t *indices_data = indices_.data_ptr<int64_t>();
 
         max_pool2d_with_indices_backward_out_frame<scalar_t>(
           gradInput_data, gradOutput_data,
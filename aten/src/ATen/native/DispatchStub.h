@@ -35,7 +35,7 @@
 // TODO: CPU instruction set selection should be folded into whatever
 // the main dispatch mechanism is.
 
-// ignore warnings about DispatchStub::DEFAULT, AVX, AVX2 defined elsewhere
+// ignore warnings about DispatchStub::DEFAULT, AVX, AVX2, AVX512 defined elsewhere
 #if defined(__clang__)
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wundefined-var-template"
@@ -43,10 +43,13 @@
 
 namespace at { namespace native {
 
+// On aarch64 only DEFAULT is built, and its Vec256 uses NEON (see
+// vec256_float_neon.h), so there is nothing to detect at runtime.
 enum class CPUCapability {
   DEFAULT = 0,
   AVX = 1,
   AVX2 = 2,
+  AVX512 = 3,
   NUM_OPTIONS
 };
 
@@ -88,6 +91,12 @@ struct CAFFE2_API DispatchStub<rT (*)(Args...), T> {
   FnPtr choose_cpu_impl() {
     auto capability = static_cast<int>(get_cpu_capability());
     (void)capability;
+#ifdef HAVE_AVX512_CPU_DEFINITION
+    if (capability >= static_cast<int>(CPUCapability::AVX512)) {
+      AT_ASSERTM(AVX512, "DispatchStub: missing AVX512 kernel");
+      return AVX512;
+    }
+#endif
 #ifdef HAVE_AVX2_CPU_DEFINITION
     if (capability >= static_cast<int>(CPUCapability::AVX2)) {
       AT_ASSERTM(AVX2, "DispatchStub: missing AVX2 kernel");
@@ -122,6 +131,9 @@ struct CAFFE2_API DispatchStub<rT (*)(Args...), T> {
 #ifdef HAVE_AVX2_CPU_DEFINITION
   static FnPtr AVX2;
 #endif
+#ifdef HAVE_AVX512_CPU_DEFINITION
+  static FnPtr AVX512;
+#endif
 };
 
 namespace {
@@ -171,10 +183,17 @@ struct RegisterHIPDispatch {
 #define REGISTER_AVX2_DISPATCH(name, fn)
 #endif
 
+#ifdef HAVE_AVX512_CPU_DEFINITION
+#define REGISTER_AVX512_DISPATCH(name, fn) REGISTER_ARCH_DISPATCH(name, AVX512, fn)
+#else
+#define REGISTER_AVX512_DISPATCH(name, fn)
+#endif
+
 #define REGISTER_NO_CPU_DISPATCH(name, fn_type)                                \
   REGISTER_ARCH_DISPATCH(name, DEFAULT, static_cast<fn_type>(nullptr))         \
   REGISTER_AVX_DISPATCH(name, static_cast<fn_type>(nullptr))                   \
-  REGISTER_AVX2_DISPATCH(name, static_cast<fn_type>(nullptr))
+  REGISTER_AVX2_DISPATCH(name, static_cast<fn_type>(nullptr))                  \
+  REGISTER_AVX512_DISPATCH(name, static_cast<fn_type>(nullptr))
 
 #define REGISTER_CUDA_DISPATCH(name, fn) \
   static RegisterCUDADispatch<decltype(fn), struct name> name ## __register(name, fn);
@@ -3,6 +3,7 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/NamedTensorUtils.h>
 #include <ATen/ExpandUtils.h>
+#include <ATen/core/grad_mode.h>
 #include <ATen/native/Distance.h>
 
 namespace at { namespace native {
@@ -110,6 +111,101 @@ Tensor cdist(const Tensor& x1, const Tensor& x2, const double p, c10::optional<i
   return result;
 }
 
+// cdist_topk computes the distances of at most kCdistTopkTileRows rows of x1
+// to kCdistTopkTileCols rows of x2 at a time and merges each tile into the
+// running k nearest neighbours, so memory is bounded by the tile size
+// instead of growing with r1 * r2.
+static constexpr int64_t kCdistTopkTileRows = 1024;
+static constexpr int64_t kCdistTopkTileCols = 4096;
+
+std::tuple<Tensor, Tensor> cdist_topk(const Tensor& x1, const Tensor& x2, int64_t k, const double p, c10::optional<int64_t> compute_mode) {
+  TORCH_CHECK(x1.dim() == 2, "cdist_topk only supports 2D tensors, X1 got: ", x1.dim(), "D");
+  TORCH_CHECK(x2.dim() == 2, "cdist_topk only supports 2D tensors, X2 got: ", x2.dim(), "D");
+  TORCH_CHECK(x1.size(-1) == x2.size(-1), "X1 and X2 must have the same number of columns. X1: ", x1.size(-1), " X2: ", x2.size(-1));
+  TORCH_CHECK(at::isFloatingType(x1.scalar_type()), "cdist_topk only supports floating-point dtypes, X1 got: ", x1.scalar_type());
+  TORCH_CHECK(x1.scalar_type() == x2.scalar_type(), "X1 and X2 must have the same dtype. X1: ", x1.scalar_type(), " X2: ", x2.scalar_type());
+  auto device = x1.device().type();
+  TORCH_CHECK(device == kCPU || device == kCUDA, "cdist_topk only supports CPU and CUDA devices, X1 got: ", device);
+  TORCH_CHECK(x1.device() == x2.device(), "X1 and X2 must be on the same device. X1: ", x1.device(), " X2: ", x2.device());
+  TORCH_CHECK(p >= 0, "cdist_topk only supports non-negative p values");
+  const int64_t r1 = x1.size(0);
+  const int64_t r2 = x2.size(0);
+  const int64_t c = x1.size(1);
+  TORCH_CHECK(k >= 0 && k <= r2, "cdist_topk: k (", k, ") must be in the range [0, ", r2, "]");
+  // same meaning as in cdist
+  int64_t mode = compute_mode.value_or(0);
+  TORCH_CHECK(mode >= 0 && mode <= 2, "possible modes: 0, 1, 2, but was: ", mode);
+  const bool use_mm = p == 2 && (mode == 1 || (mode == 0 && (r1 > 25 || r2 > 25)));
+
+  Tensor values = at::empty({r1, k}, x1.options());
+  Tensor indices = at::empty({r1, k}, x1.options().dtype(kLong));
+  if (r1 == 0 || k == 0) {
+    return std::make_tuple(values, indices);
+  }
+
+  {
+    at::NoGradGuard no_grad;
+    Tensor a = x1.detach();
+    Tensor b = x2.detach();
+    if (use_mm) {
+      // The matmul form |a|^2 + |b|^2 - 2 a.b cancels badly for neighbours
+      // that are close relative to their norms; centering both sets on the
+      // mean of x2 keeps the norms small. It is only used to rank candidates,
+      // the returned distances are recomputed directly below.
+      Tensor center = b.mean(0, true);
+      a = a - center;
+      b = b - center;
+    }
+    a = a.contiguous();
+    b = b.contiguous();
+    for (int64_t i = 0; i < r1; i += kCdistTopkTileRows) {
+      const int64_t rows = std::min(kCdistTopkTileRows, r1 - i);
+      const Tensor a_tile = a.narrow(0, i, rows);
+      Tensor best_dist;
+      Tensor best_idx;
+      for (int64_t j = 0; j < r2; j += kCdistTopkTileCols) {
+        const int64_t cols = std::min(kCdistTopkTileCols, r2 - j);
+        const Tensor b_tile = b.narrow(0, j, cols);
+        Tensor dist;
+        if (c == 0) {
+          dist = at::zeros({rows, cols}, a.options());
+        } else if (use_mm) {
+          dist = euclidean_dist_out(a_tile, b_tile);
+        } else {
+          dist = at::empty({1, rows, cols}, a.options());
+          cdist_stub(device, dist, a_tile.unsqueeze(0), b_tile.unsqueeze(0), p);
+          dist = dist.squeeze(0);
+        }
+        Tensor idx = at::arange(j, j + cols, indices.options()).expand({rows, cols});
+        if (best_dist.defined()) {
+          dist = at::cat({best_dist, dist}, 1);
+          idx = at::cat({best_idx, idx}, 1);
+        }
+        if (dist.size(1) > k) {
+          Tensor pos;
+          std::tie(best_dist, pos) = dist.topk(k, 1, /*largest=*/false, /*sorted=*/false);
+          best_idx = idx.gather(1, pos);
+        } else {
+          best_dist = dist;
+          best_idx = idx;
+        }
+      }
+      Tensor neighbours = x2.detach().index_select(0, best_idx.reshape({-1})).view({rows, k, c});
+      values.narrow(0, i, rows).copy_(at::norm(x1.detach().narrow(0, i, rows).unsqueeze(1) - neighbours, p, -1));
+      indices.narrow(0, i, rows).copy_(best_idx);
+    }
+  }
+
+  if (GradMode::is_enabled() && (x1.requires_grad() || x2.requires_grad())) {
+    // only the selected pairs take part in the backward
+    Tensor neighbours = x2.index_select(0, indices.view(-1)).view({r1, k, c});
+    values = at::norm(x1.unsqueeze(1) - neighbours, p, -1);
+  }
+  Tensor order;
+  std::tie(values, order) = values.sort(1);
+  return std::make_tuple(values, indices.gather(1, order));
+}
+
 Tensor _cdist_backward(const Tensor& grad, const Tensor& x1, const Tensor& x2, const double p, const Tensor& cdist) {
   TORCH_CHECK(x1.is_contiguous(), "_cdist_backward requires X1 to be contiguous");
   TORCH_CHECK(x2.is_contiguous(), "_cdist_backward requires X2 to be contiguous");
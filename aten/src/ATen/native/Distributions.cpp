@@ -3,13 +3,16 @@
 #include <ATen/Config.h>
 #include <ATen/Dispatch.h>
 #include <ATen/ExpandUtils.h>
+#include <ATen/LegacyTHFunctionsCPU.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <c10/util/Exception.h>
 #include <c10/util/math_compat.h>
 
 #include <ATen/Utils.h>
 #include <ATen/CPUGenerator.h>
 #include <ATen/core/DistributionsHelper.h>
+#include <ATen/core/PhiloxRNGEngine.h>
 #include <ATen/native/Distributions.h>
 #include <ATen/native/DispatchStub.h>
 #include <ATen/native/UnaryOps.h>
@@ -55,9 +58,9 @@ namespace {
  */
 
 
-int64_t sample_poisson(double lambda, at::CPUGenerator* generator) {
+template <typename uniform_sampler_t>
+int64_t sample_poisson(double lambda, uniform_sampler_t& standard_uniform) {
   TORCH_CHECK(lambda >= 0, "invalid Poisson rate, expected rate to be non-negative");
-  at::uniform_real_distribution<double> standard_uniform(0.0, 1.0);
   if (lambda >= 10) {
     // transformed rejection method, (Hoermann, 1993)
     int64_t k;
@@ -71,8 +74,8 @@ int64_t sample_poisson(double lambda, at::CPUGenerator* generator) {
     vr = 0.9277 - 3.6224 / (b - 2);
 
     while (1) {
-      U = standard_uniform(generator) - 0.5;
-      V = standard_uniform(generator);
+      U = standard_uniform() - 0.5;
+      V = standard_uniform();
       us = 0.5 - std::fabs(U);
       k = (int64_t)std::floor((2 * a / us + b) * U + lambda + 0.43);
       if ((us >= 0.07) && (V <= vr)) {
@@ -96,7 +99,7 @@ int64_t sample_poisson(double lambda, at::CPUGenerator* generator) {
     X = 0;
     prod = 1.0;
     while (1) {
-      U = standard_uniform(generator);
+      U = standard_uniform();
       prod *= U;
       if (prod > enlam) {
         X += 1;
@@ -107,6 +110,98 @@ int64_t sample_poisson(double lambda, at::CPUGenerator* generator) {
   }
 }
 
+/*
+ * Note [Philox streams for rejection samplers]
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Gamma and Poisson samples take a variable number of uniform draws, so a
+ * large tensor can't be filled from fixed ranges of a single stream as in
+ * Note [Philox fill of large CPU tensors]. Instead, for contiguous parameter
+ * tensors of at least philox_sample_min_numel elements, a single random64()
+ * from the generator, taken under its mutex, seeds one Philox stream per
+ * element, using the index of the element as subsequence, and the elements
+ * are sampled in parallel. The samples therefore depend only on the generator
+ * state and not on the number of threads. Smaller or non-contiguous tensors
+ * keep drawing from the generator on a single thread.
+ */
+constexpr int64_t philox_sample_min_numel = at::internal::GRAIN_SIZE / 16;
+
+class PhiloxSampler {
+ public:
+  PhiloxSampler(uint64_t seed, int64_t index) : engine_(seed, index, 0) {}
+
+  // Same bit to double mapping as at::uniform_real_distribution<double>.
+  double uniform() {
+    const uint64_t hi = engine_();
+    const uint64_t lo = engine_();
+    return (((hi << 32) | lo) & at::DOUBLE_MASK) * at::DOUBLE_DIVISOR;
+  }
+
+  // Box-Muller, as in at::normal_distribution, keeping the second sample for
+  // the next call.
+  double normal() {
+    if (has_next_normal_) {
+      has_next_normal_ = false;
+      return next_normal_;
+    }
+    const double u1 = uniform();
+    const double u2 = uniform();
+    const double r = std::sqrt(-2.0 * std::log(1.0 - u2));
+    const double theta = 2.0 * M_PI * u1;
+    next_normal_ = r * std::sin(theta);
+    has_next_normal_ = true;
+    return r * std::cos(theta);
+  }
+
+ private:
+  at::philox_engine engine_;
+  double next_normal_ = 0;
+  bool has_next_normal_ = false;
+};
+
+bool use_philox_sampling(const at::Tensor& param) {
+  return param.numel() >= philox_sample_min_numel && param.is_contiguous();
+}
+
+// Sets ret[i] = sample_fn(param[i], sampler_i) in parallel, where sampler_i is
+// the PhiloxSampler of element i, see
+// Note [Philox streams for rejection samplers]. ret must be contiguous.
+template <typename scalar_t, typename param_t, typename sample_fn_t>
+void philox_sample(
+    at::Tensor& ret,
+    const at::Tensor& param,
+    at::CPUGenerator* generator,
+    const sample_fn_t& sample_fn) {
+  uint64_t seed;
+  {
+    // See Note [Acquire lock when using random generators]
+    std::lock_guard<std::mutex> lock(generator->mutex_);
+    seed = generator->random64();
+  }
+  scalar_t* ret_data = ret.data_ptr<scalar_t>();
+  const param_t* param_data = param.data_ptr<param_t>();
+  at::parallel_for(0, ret.numel(), philox_sample_min_numel, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      PhiloxSampler sampler(seed, i);
+      ret_data[i] = sample_fn(param_data[i], sampler);
+    }
+  });
+}
+
+template <typename scalar_t>
+scalar_t philox_sample_gamma(scalar_t alpha, PhiloxSampler& sampler) {
+  auto uniform_lambda = [&sampler] () {
+    return sampler.uniform();
+  };
+  BaseSampler<double, decltype(uniform_lambda)> standard_uniform(uniform_lambda);
+
+  auto normal_lambda = [&sampler] () {
+    return sampler.normal();
+  };
+  BaseSampler<double, decltype(normal_lambda)> standard_normal(normal_lambda);
+  auto sample = sample_gamma<scalar_t, double, decltype(uniform_lambda), decltype(normal_lambda)>(alpha, standard_uniform, standard_normal);
+  return std::max(std::numeric_limits<scalar_t>::min(), (scalar_t) sample);
+}
+
 } // namespace
 
 namespace at {
@@ -116,9 +211,17 @@ DEFINE_DISPATCH(bernoulli_mkl_stub);
 DEFINE_DISPATCH(cauchy_stub);
 DEFINE_DISPATCH(exponential_stub);
 DEFINE_DISPATCH(multinomial_stub);
+DEFINE_DISPATCH(multinomial_alias_draw_stub);
 DEFINE_DISPATCH(geometric_stub);
 DEFINE_DISPATCH(log_normal_stub);
 DEFINE_DISPATCH(normal_stub);
+DEFINE_DISPATCH(uniform_philox_stub);
+DEFINE_DISPATCH(bernoulli_philox_stub);
+
+// See Note [Philox fill of large CPU tensors] in native/cpu/DistributionTemplates.h
+static inline bool use_philox_fill(const Tensor& self) {
+  return self.numel() >= at::internal::GRAIN_SIZE && self.is_contiguous();
+}
 
 Tensor bernoulli(const Tensor& self, Generator* gen) {
   return at::empty_like(self, LEGACY_CONTIGUOUS_MEMORY_FORMAT).bernoulli_(self, gen);
@@ -174,6 +277,10 @@ Tensor& bernoulli_scalar_cpu_(Tensor& self, double p, Generator* gen) {
     return self;
   }
 #endif
+  if (use_philox_fill(self)) {
+    bernoulli_philox_stub(kCPU, self, p, gen);
+    return self;
+  }
   AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "bernoulli_scalar_cpu_", [&] {
     CPUGenerator* generator = get_generator_or_default<CPUGenerator>(gen, detail::getDefaultCPUGenerator());
     // See Note [Acquire lock when using random generators]
@@ -214,6 +321,15 @@ Tensor& geometric_(Tensor& self, double p, Generator* gen) {
   return self;
 }
 
+Tensor& uniform_cpu_(Tensor& self, double from, double to, Generator* gen) {
+  TORCH_CHECK(from <= to, "uniform_ expects to return a [from, to) range, but found from=", from, " > to=", to);
+  if ((self.scalar_type() == kFloat || self.scalar_type() == kDouble) && use_philox_fill(self)) {
+    uniform_philox_stub(kCPU, self, from, to, gen);
+    return self;
+  }
+  return legacy::cpu::_th_uniform_(self, from, to, gen);
+}
+
 Tensor& normal_cpu_(Tensor& self, double mean, double std, Generator* gen) {
   TORCH_CHECK(std > 0.0, "normal_ expects std > 0.0, but found std=", std);
   normal_stub(kCPU, self, mean, std, gen);
@@ -289,11 +405,25 @@ Tensor _s_poisson_cpu(const Tensor& lambda, Generator *gen) {
   Tensor ret = at::zeros(lambda.sizes(), lambda.options());
   AT_DISPATCH_FLOATING_TYPES(ret.scalar_type(), "poisson_cpu", [&] {
     CPUGenerator* generator = get_generator_or_default<CPUGenerator>(gen, detail::getDefaultCPUGenerator());
+    if (use_philox_sampling(lambda)) {
+      philox_sample<scalar_t, scalar_t>(ret, lambda, generator,
+        [](scalar_t lambda, PhiloxSampler& sampler) {
+          auto standard_uniform = [&sampler] () {
+            return sampler.uniform();
+          };
+          return static_cast<scalar_t>(sample_poisson(static_cast<double>(lambda), standard_uniform));
+        });
+      return;
+    }
     // See Note [Acquire lock when using random generators]
     std::lock_guard<std::mutex> lock(generator->mutex_);
     CPU_tensor_apply2<scalar_t, scalar_t>(ret, lambda,
       [generator](scalar_t& ret_val, const scalar_t& lambda){
-        ret_val = static_cast<scalar_t>(sample_poisson(static_cast<double>(lambda), generator));
+        auto standard_uniform = [generator] () {
+          at::uniform_real_distribution<double> uniform(0.0, 1.0);
+          return uniform(generator);
+        };
+        ret_val = static_cast<scalar_t>(sample_poisson(static_cast<double>(lambda), standard_uniform));
       }
     );
     });
@@ -304,6 +434,10 @@ Tensor _s_gamma_cpu(const Tensor& alpha, Generator *gen) {
   Tensor ret = at::zeros(alpha.sizes(), alpha.options());
   AT_DISPATCH_FLOATING_TYPES(ret.scalar_type(), "gamma_cpu", [&] {
     CPUGenerator* generator = get_generator_or_default<CPUGenerator>(gen, detail::getDefaultCPUGenerator());
+    if (use_philox_sampling(alpha)) {
+      philox_sample<scalar_t, scalar_t>(ret, alpha, generator, philox_sample_gamma<scalar_t>);
+      return;
+    }
     // See Note [Acquire lock when using random generators]
     std::lock_guard<std::mutex> lock(generator->mutex_);
     CPU_tensor_apply2<scalar_t, scalar_t>(ret, alpha,
@@ -334,27 +468,34 @@ Tensor _s_dirichlet_cpu(const Tensor& alpha, Generator *gen) {
   AT_DISPATCH_FLOATING_TYPES(ret.scalar_type(), "dirichlet", [&] {
     Tensor gamma = at::zeros(alpha.sizes(), alpha.options().dtype(ScalarType::Double));
     CPUGenerator* generator = get_generator_or_default<CPUGenerator>(gen, detail::getDefaultCPUGenerator());
-    // See Note [Acquire lock when using random generators]
-    std::lock_guard<std::mutex> lock(generator->mutex_);
     /* Generate gamma sample by casting alpha to double to prevent underflow. */
-    CPU_tensor_apply2<double, scalar_t>(gamma, alpha,
-      [generator](double& ret_val, const scalar_t& alpha){
-        auto uniform_lambda = [generator] () {
-          at::uniform_real_distribution<double> standard_uniform(0.0, 1.0);
-          return standard_uniform(generator);
-        };
-        BaseSampler<double, decltype(uniform_lambda)> standard_uniform(uniform_lambda);
-
-        auto normal_lambda = [generator] () {
-          at::normal_distribution<double> normal(0.0, 1.0);
-          return normal(generator);
-        };
-        BaseSampler<double, decltype(normal_lambda)> standard_normal(normal_lambda);
-        auto sample = sample_gamma<double, double, decltype(uniform_lambda), decltype(normal_lambda)>
-          (alpha, standard_uniform, standard_normal);
-        ret_val = std::max(std::numeric_limits<double>::min(), sample);
-      }
-    );
+    if (use_philox_sampling(alpha)) {
+      philox_sample<double, scalar_t>(gamma, alpha, generator,
+        [](scalar_t alpha, PhiloxSampler& sampler) {
+          return philox_sample_gamma<double>(static_cast<double>(alpha), sampler);
+        });
+    } else {
+      // See Note [Acquire lock when using random generators]
+      std::lock_guard<std::mutex> lock(generator->mutex_);
+      CPU_tensor_apply2<double, scalar_t>(gamma, alpha,
+        [generator](double& ret_val, const scalar_t& alpha){
+          auto uniform_lambda = [generator] () {
+            at::uniform_real_distribution<double> standard_uniform(0.0, 1.0);
+            return standard_uniform(generator);
+          };
+          BaseSampler<double, decltype(uniform_lambda)> standard_uniform(uniform_lambda);
+
+          auto normal_lambda = [generator] () {
+            at::normal_distribution<double> normal(0.0, 1.0);
+            return normal(generator);
+          };
+          BaseSampler<double, decltype(normal_lambda)> standard_normal(normal_lambda);
+          auto sample = sample_gamma<double, double, decltype(uniform_lambda), decltype(normal_lambda)>
+            (alpha, standard_uniform, standard_normal);
+          ret_val = std::max(std::numeric_limits<double>::min(), sample);
+        }
+      );
+    }
     /* Normalize and cast back to scalar_t. */
     Tensor gamma_sum = gamma.sum(-1, true).expand(alpha.sizes());
     CPU_tensor_apply3<scalar_t, double , double>(ret, gamma, gamma_sum,
@@ -403,4 +544,21 @@ Tensor multinomial(const Tensor& self, int64_t n_sample, bool with_replacement,
   return result;
 }
 
+Tensor _multinomial_alias_draw_cpu(const Tensor& q, const Tensor& J, int64_t n_sample, Generator *gen) {
+  TORCH_CHECK(q.dim() == 1, "expected 1-D probability table, got ", q.dim(), "-D probability table instead");
+  TORCH_CHECK(J.dim() == 1, "expected 1-D alias table, got ", J.dim(), "-D alias table instead");
+  TORCH_CHECK(J.scalar_type() == kLong, "expected alias table of type Long, got ", J.scalar_type());
+  TORCH_CHECK(n_sample > 0, "cannot sample <= 0 samples");
+  TORCH_CHECK(q.numel() == J.numel(),
+      "probability and alias tables must have the same size, got ", q.numel(), " and ", J.numel());
+  // Small draws stay on the generator itself, see
+  // Note [Philox fill of large CPU tensors] in native/cpu/DistributionTemplates.h
+  if (n_sample < at::internal::GRAIN_SIZE) {
+    return legacy::cpu::_th_multinomial_alias_draw(q, J, n_sample, gen);
+  }
+  Tensor result = at::empty({n_sample}, J.options());
+  multinomial_alias_draw_stub(kCPU, result, q.contiguous(), J.contiguous(), gen);
+  return result;
+}
+
 }} // namespace at::native
@@ -43,14 +43,18 @@ bool isFastPathIndexSelectScale(const Tensor& src, const Tensor& scale, Tensor&
 
 // This function combines index_select (using select_indices as the index) and
 // index_add (using add_indices as the index), without creating an intermediary
-// tensor to hold the selected embeddings
+// tensor to hold the selected embeddings.
+// normalize_by_lengths divides every bag by its size; it is only supported on
+// the fast path (see isFastPathIndexSelect), otherwise apply_bag_size does it.
 template<typename T>
 void index_select_add(const Tensor &select_indices,
                              const Tensor &add_indices,
                              const Tensor &src,
                              Tensor &output,
                              const Tensor& /*offsets*/,
-                             bool /*include_last_offset*/) {
+                             bool /*include_last_offset*/,
+                             bool normalize_by_lengths) {
+  TORCH_INTERNAL_ASSERT(!normalize_by_lengths);
   AT_ASSERT(select_indices.numel() == add_indices.numel());
   auto* add_indices_data = add_indices.data_ptr<int64_t>();
   auto* select_indices_data = select_indices.data_ptr<int64_t>();
@@ -76,7 +80,8 @@ void index_select_add<float>(const Tensor &select_indices,
                              const Tensor &src,
                              Tensor &output,
                              const Tensor& offsets,
-                             bool include_last_offset) {
+                             bool include_last_offset,
+                             bool normalize_by_lengths) {
   int64_t ddim = src.size(1);
   auto* src_data = src.data_ptr<float>();
   auto* select_indices_data = select_indices.data_ptr<int64_t>();
@@ -112,10 +117,11 @@ void index_select_add<float>(const Tensor &select_indices,
               /*offsets=*/offsets_data + start_idx,
               /*weights=*/nullptr,
               /*scale_bias=*/nullptr,
-              /*normalize_by_lengths=*/false,
+              /*normalize_by_lengths=*/normalize_by_lengths,
               /*out=*/output_data + start_idx * ddim);
         });
   } else {
+    TORCH_INTERNAL_ASSERT(!normalize_by_lengths);
     AT_ASSERT(select_indices.numel() == add_indices.numel());
     auto* add_indices_data = add_indices.data_ptr<int64_t>();
     auto src_stride0 = src.stride(0);
@@ -399,7 +405,8 @@ _embedding_bag_cpu(const Tensor &weight, const Tensor &indices,
       weight.options());
 
   // To save compute, if we are going to go down the fast path case for the 'sum'
-  // mode, we skip calculating offset2bag, since it is not going to be used.
+  // or 'mean' mode, we skip calculating offset2bag, since it is not going to be
+  // used. The fast path also divides 'mean' bags by their size in the same pass.
   auto fast_path_sum = [&weight, &per_sample_weights, &output]() {
     if (per_sample_weights.defined()) {
       return isFastPathIndexSelectScale(weight, per_sample_weights, output);
@@ -407,12 +414,13 @@ _embedding_bag_cpu(const Tensor &weight, const Tensor &indices,
       return isFastPathIndexSelect(weight, output);
     }
   };
+  const bool fast_path = mode != MODE_MAX && fast_path_sum();
 
   // Use an empty 0-element tensor as a sentinel that we have skipped the
   // creation of offset2bag because autograd chokes when trying to use an
   // undefined tensor as an input to a backward op.
   Tensor offset2bag = at::empty({0}, offsets.options());
-  if (mode == MODE_MEAN || mode == MODE_MAX || !fast_path_sum()) {
+  if (!fast_path) {
     // If the last entries are empty, that the last offsets are irrelevant as they
     // won't change anything in the assignment of ID -> bag, but index_add would
     // throw out of bounds error. So to keep it simple we just add one more
@@ -432,9 +440,13 @@ _embedding_bag_cpu(const Tensor &weight, const Tensor &indices,
         index_select_scale_add<scalar_t>(
             indices, offset2bag, per_sample_weights, weight, output, offsets, include_last_offset);
       } else {
-        index_select_add<scalar_t>(indices, offset2bag, weight, output, offsets, include_last_offset);
+        index_select_add<scalar_t>(indices, offset2bag, weight, output, offsets, include_last_offset,
+                                   /*normalize_by_lengths=*/fast_path && mode == MODE_MEAN);
       }
     });
+    if (fast_path) {
+      return std::tuple<Tensor, Tensor, Tensor, Tensor>(output, offset2bag, bag_size, bag_size);
+    }
     auto ret = apply_bag_size(offsets, indices, mode, output, bag_size);
     return std::tuple<Tensor, Tensor, Tensor, Tensor>(ret, offset2bag, bag_size, bag_size);
   } else { // MODE_MAX
@@ -0,0 +1,271 @@
+// Fused optimizer steps that update lists of parameters at once.
+#include <ATen/native/FusedOptimizers.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace at { namespace native {
+
+void check_fused_optimizer_list(
+    const char* op,
+    TensorList self,
+    TensorList list,
+    const char* list_name) {
+  TORCH_CHECK(
+      list.size() == self.size(),
+      op, ": expected ", self.size(), " tensors in ", list_name, ", but got ",
+      list.size());
+  for (size_t i = 0; i < list.size(); i++) {
+    TORCH_CHECK(
+        self[i].defined() && list[i].defined(),
+        op, ": undefined tensor at index ", i, " of self or ", list_name);
+  }
+}
+
+bool can_use_fused_optimizer_kernel(
+    const std::vector<TensorList>& lists,
+    size_t index,
+    const Tensor& like) {
+  if (!isFloatingType(like.scalar_type()) || like.numel() == 0) {
+    return false;
+  }
+  for (const auto& list : lists) {
+    const auto& tensor = list[index];
+    if (tensor.layout() != kStrided || !tensor.is_contiguous() ||
+        tensor.numel() != like.numel() ||
+        tensor.scalar_type() != like.scalar_type() ||
+        tensor.device() != like.device()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void sgd_step_reference(
+    Tensor param,
+    const Tensor& grad,
+    Tensor buffer,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov) {
+  auto update = weight_decay != 0 ? grad.add(param, weight_decay) : grad;
+  if (momentum != 0) {
+    buffer.mul_(momentum).add_(update, 1 - dampening);
+    if (nesterov) {
+      update = update.add(buffer, momentum);
+    } else {
+      update = buffer;
+    }
+  }
+  param.add_(update, -lr);
+}
+
+void adam_step_reference(
+    Tensor param,
+    const Tensor& grad,
+    Tensor exp_avg,
+    Tensor exp_avg_sq,
+    Tensor max_exp_avg_sq,
+    double step_size,
+    double bias_correction2,
+    double beta1,
+    double beta2,
+    double eps,
+    double weight_decay,
+    bool amsgrad) {
+  auto g = weight_decay != 0 ? grad.add(param, weight_decay) : grad;
+  exp_avg.mul_(beta1).add_(g, 1 - beta1);
+  exp_avg_sq.mul_(beta2).addcmul_(g, g, 1 - beta2);
+  Tensor denom;
+  if (amsgrad) {
+    at::max_out(max_exp_avg_sq, max_exp_avg_sq, exp_avg_sq);
+    denom = (max_exp_avg_sq / bias_correction2).sqrt_().add_(eps);
+  } else {
+    denom = (exp_avg_sq / bias_correction2).sqrt_().add_(eps);
+  }
+  param.addcdiv_(exp_avg, denom, -step_size);
+}
+
+namespace {
+
+// Elements of one tensor that are updated by the same task.
+struct Chunk {
+  size_t index;
+  int64_t begin;
+  int64_t end;
+};
+
+constexpr int64_t kChunkSize = 32768;
+
+// Updates the tensors of ``lists`` that the fused kernel can handle by
+// calling ``kernel(index, begin, end)`` on chunks of their elements. The
+// chunks of all tensors are processed in parallel, so many small tensors are
+// updated as efficiently as a few large ones. The other tensors are passed
+// to ``reference(index)``.
+template <typename kernel_t, typename reference_t>
+void fused_optimizer_apply(
+    const std::vector<TensorList>& lists,
+    const kernel_t& kernel,
+    const reference_t& reference) {
+  std::vector<Chunk> chunks;
+  for (size_t i = 0; i < lists[0].size(); i++) {
+    const auto dtype = lists[0][i].scalar_type();
+    if ((dtype != kFloat && dtype != kDouble) ||
+        !can_use_fused_optimizer_kernel(lists, i, lists[0][i])) {
+      reference(i);
+      continue;
+    }
+    const auto numel = lists[0][i].numel();
+    for (int64_t begin = 0; begin < numel; begin += kChunkSize) {
+      chunks.push_back({i, begin, std::min(begin + kChunkSize, numel)});
+    }
+  }
+  at::parallel_for(0, chunks.size(), 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      kernel(chunks[c].index, chunks[c].begin, chunks[c].end);
+    }
+  });
+}
+
+} // namespace
+
+void _fused_sgd_cpu_(
+    TensorList self,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov) {
+  check_fused_optimizer_list("_fused_sgd_", self, grads, "grads");
+  std::vector<TensorList> lists = {self, grads};
+  if (momentum != 0) {
+    check_fused_optimizer_list(
+        "_fused_sgd_", self, momentum_buffers, "momentum_buffers");
+    lists.push_back(momentum_buffers);
+  }
+
+  fused_optimizer_apply(
+      lists,
+      [&](size_t index, int64_t begin, int64_t end) {
+        AT_DISPATCH_FLOATING_TYPES(
+            self[index].scalar_type(), "_fused_sgd_cpu_", [&] {
+              auto param = self[index].data_ptr<scalar_t>();
+              auto grad = grads[index].data_ptr<scalar_t>();
+              const auto lr_ = static_cast<scalar_t>(lr);
+              const auto weight_decay_ = static_cast<scalar_t>(weight_decay);
+              if (momentum == 0) {
+                for (int64_t i = begin; i < end; i++) {
+                  param[i] -= lr_ * (grad[i] + weight_decay_ * param[i]);
+                }
+                return;
+              }
+              auto buffer = momentum_buffers[index].data_ptr<scalar_t>();
+              const auto momentum_ = static_cast<scalar_t>(momentum);
+              const auto dampening_ = static_cast<scalar_t>(1 - dampening);
+              for (int64_t i = begin; i < end; i++) {
+                const scalar_t update = grad[i] + weight_decay_ * param[i];
+                buffer[i] = momentum_ * buffer[i] + dampening_ * update;
+                param[i] -= lr_ *
+                    (nesterov ? update + momentum_ * buffer[i] : buffer[i]);
+              }
+            });
+      },
+      [&](size_t index) {
+        sgd_step_reference(
+            self[index],
+            grads[index],
+            momentum != 0 ? momentum_buffers[index] : Tensor(),
+            lr,
+            momentum,
+            dampening,
+            weight_decay,
+            nesterov);
+      });
+}
+
+void _fused_adam_cpu_(
+    TensorList self,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    int64_t step,
+    double lr,
+    double beta1,
+    double beta2,
+    double eps,
+    double weight_decay,
+    bool amsgrad) {
+  check_fused_optimizer_list("_fused_adam_", self, grads, "grads");
+  check_fused_optimizer_list("_fused_adam_", self, exp_avgs, "exp_avgs");
+  check_fused_optimizer_list("_fused_adam_", self, exp_avg_sqs, "exp_avg_sqs");
+  std::vector<TensorList> lists = {self, grads, exp_avgs, exp_avg_sqs};
+  if (amsgrad) {
+    check_fused_optimizer_list(
+        "_fused_adam_", self, max_exp_avg_sqs, "max_exp_avg_sqs");
+    lists.push_back(max_exp_avg_sqs);
+  }
+  TORCH_CHECK(step > 0, "_fused_adam_: expected a positive step, got ", step);
+  const double bias_correction1 = 1 - std::pow(beta1, step);
+  const double bias_correction2 = 1 - std::pow(beta2, step);
+  const double step_size = lr / bias_correction1;
+
+  fused_optimizer_apply(
+      lists,
+      [&](size_t index, int64_t begin, int64_t end) {
+        AT_DISPATCH_FLOATING_TYPES(
+            self[index].scalar_type(), "_fused_adam_cpu_", [&] {
+              auto param = self[index].data_ptr<scalar_t>();
+              auto grad = grads[index].data_ptr<scalar_t>();
+              auto exp_avg = exp_avgs[index].data_ptr<scalar_t>();
+              auto exp_avg_sq = exp_avg_sqs[index].data_ptr<scalar_t>();
+              auto max_exp_avg_sq = amsgrad
+                  ? max_exp_avg_sqs[index].data_ptr<scalar_t>()
+                  : nullptr;
+              const auto beta1_ = static_cast<scalar_t>(beta1);
+              const auto beta2_ = static_cast<scalar_t>(beta2);
+              const auto eps_ = static_cast<scalar_t>(eps);
+              const auto weight_decay_ = static_cast<scalar_t>(weight_decay);
+              const auto step_size_ = static_cast<scalar_t>(step_size);
+              const auto bias_correction2_ =
+                  static_cast<scalar_t>(bias_correction2);
+              for (int64_t i = begin; i < end; i++) {
+                const scalar_t g = grad[i] + weight_decay_ * param[i];
+                exp_avg[i] = beta1_ * exp_avg[i] + (1 - beta1_) * g;
+                exp_avg_sq[i] = beta2_ * exp_avg_sq[i] + (1 - beta2_) * g * g;
+                scalar_t sq = exp_avg_sq[i];
+                if (amsgrad) {
+                  max_exp_avg_sq[i] = std::max(max_exp_avg_sq[i], sq);
+                  sq = max_exp_avg_sq[i];
+                }
+                const scalar_t denom = std::sqrt(sq / bias_correction2_) + eps_;
+                param[i] -= step_size_ * exp_avg[i] / denom;
+              }
+            });
+      },
+      [&](size_t index) {
+        adam_step_reference(
+            self[index],
+            grads[index],
+            exp_avgs[index],
+            exp_avg_sqs[index],
+            amsgrad ? max_exp_avg_sqs[index] : Tensor(),
+            step_size,
+            bias_correction2,
+            beta1,
+            beta2,
+            eps,
+            weight_decay,
+            amsgrad);
+      });
+}
+
+}} // namespace at::native
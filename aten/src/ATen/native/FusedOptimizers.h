@@ -0,0 +1,55 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+#include <vector>
+
+// Helpers shared by the CPU and CUDA implementations of the fused optimizer
+// steps (_fused_sgd_ and _fused_adam_).
+
+namespace at { namespace native {
+
+// Checks that ``list`` holds a defined tensor for every tensor of ``self``.
+CAFFE2_API void check_fused_optimizer_list(
+    const char* op,
+    TensorList self,
+    TensorList list,
+    const char* list_name);
+
+// Whether the fused kernels can update the ``index``th tensors of ``lists``:
+// they must be non-empty, dense and contiguous, and have the same number of
+// elements and the same floating point dtype and device as ``like``.
+CAFFE2_API bool can_use_fused_optimizer_kernel(
+    const std::vector<TensorList>& lists,
+    size_t index,
+    const Tensor& like);
+
+// Updates a single parameter with regular tensor ops. Used for the tensors
+// that the fused kernels cannot update, e.g. non-contiguous ones. ``buffer``
+// is ignored if ``momentum`` is 0.
+CAFFE2_API void sgd_step_reference(
+    Tensor param,
+    const Tensor& grad,
+    Tensor buffer,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov);
+
+// ``max_exp_avg_sq`` is ignored if ``amsgrad`` is false.
+CAFFE2_API void adam_step_reference(
+    Tensor param,
+    const Tensor& grad,
+    Tensor exp_avg,
+    Tensor exp_avg_sq,
+    Tensor max_exp_avg_sq,
+    double step_size,
+    double bias_correction2,
+    double beta1,
+    double beta2,
+    double eps,
+    double weight_decay,
+    bool amsgrad);
+
+}} // namespace at::native
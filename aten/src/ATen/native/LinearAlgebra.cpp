@@ -7,12 +7,19 @@
 #include <ATen/Parallel.h>
 #include <ATen/LegacyTHFunctionsCPU.h>
 #include <ATen/core/grad_mode.h>
+#include <TH/TH.h>  // for USE_BLAS
+#include <complex>
 #include <functional>
 #include <numeric>
 #include <vector>
 #include <limits>
 #include <ATen/NamedTensorUtils.h>
 
+#ifdef USE_BLAS
+extern "C" void cgemm_(char *transa, char *transb, int *m, int *n, int *k, std::complex<float> *alpha, std::complex<float> *a, int *lda, std::complex<float> *b, int *ldb, std::complex<float> *beta, std::complex<float> *c, int *ldc);
+extern "C" void zgemm_(char *transa, char *transb, int *m, int *n, int *k, std::complex<double> *alpha, std::complex<double> *a, int *lda, std::complex<double> *b, int *ldb, std::complex<double> *beta, std::complex<double> *c, int *ldc);
+#endif
+
 namespace at {
 namespace native {
 
@@ -156,6 +163,127 @@ Tensor& addr_out(Tensor &result, const Tensor& self, const Tensor& vec1, const T
   return at::_addr_out(result, self, vec1, vec2, beta, alpha);
 }
 
+#ifdef USE_BLAS
+static inline void complex_gemm(char transa, char transb, int m, int n, int k, std::complex<float> alpha,
+    std::complex<float>* a, int lda, std::complex<float>* b, int ldb, std::complex<float> beta,
+    std::complex<float>* c, int ldc) {
+  cgemm_(&transa, &transb, &m, &n, &k, &alpha, a, &lda, b, &ldb, &beta, c, &ldc);
+}
+
+static inline void complex_gemm(char transa, char transb, int m, int n, int k, std::complex<double> alpha,
+    std::complex<double>* a, int lda, std::complex<double>* b, int ldb, std::complex<double> beta,
+    std::complex<double>* c, int ldc) {
+  zgemm_(&transa, &transb, &m, &n, &k, &alpha, a, &lda, b, &ldb, &beta, c, &ldc);
+}
+#endif
+
+// result = beta * result + alpha * (mat1 @ mat2) for complex matrices. TH,
+// which implements mm and addmm for the real types, has no complex types, so
+// this calls cgemm/zgemm directly. As in BLAS, result is not read if beta is 0.
+template <typename scalar_t>
+static void complex_addmm_(Tensor& result, const Tensor& mat1, const Tensor& mat2, scalar_t beta, scalar_t alpha) {
+  const int64_t m = mat1.size(0);
+  const int64_t k = mat1.size(1);
+  const int64_t n = mat2.size(1);
+  if (result.numel() == 0) {
+    return;
+  }
+  if (k == 0 || alpha == scalar_t(0)) {
+    if (beta == scalar_t(0)) {
+      result.zero_();
+    } else {
+      result.mul_(beta);
+    }
+    return;
+  }
+
+#ifdef USE_BLAS
+  // BLAS is column major, so compute result^T = mat2^T @ mat1^T, which turns
+  // a row major result into a column major one. An operand that is row major
+  // is used as is, one that is column major is transposed by BLAS, and any
+  // other is made contiguous first.
+  auto as_blas_operand = [](const Tensor& t, char& trans, int64_t& ld) {
+    if (t.stride(1) == 1 && (t.size(0) == 1 || t.stride(0) >= std::max<int64_t>(1, t.size(1)))) {
+      trans = 'n';
+      ld = t.size(0) == 1 ? std::max<int64_t>(1, t.size(1)) : t.stride(0);
+      return t;
+    }
+    if (t.stride(0) == 1 && (t.size(1) == 1 || t.stride(1) >= std::max<int64_t>(1, t.size(0)))) {
+      trans = 't';
+      ld = t.size(1) == 1 ? std::max<int64_t>(1, t.size(0)) : t.stride(1);
+      return t;
+    }
+    trans = 'n';
+    ld = std::max<int64_t>(1, t.size(1));
+    return t.contiguous();
+  };
+  Tensor c = result.is_contiguous() ? result : result.contiguous();
+  char transa, transb;
+  int64_t lda, ldb;
+  Tensor a = as_blas_operand(mat2, transa, lda);
+  Tensor b = as_blas_operand(mat1, transb, ldb);
+  const int64_t ldc = m == 1 ? std::max<int64_t>(1, n) : c.stride(0);
+  const int64_t int_max = std::numeric_limits<int>::max();
+  if (m <= int_max && n <= int_max && k <= int_max &&
+      lda <= int_max && ldb <= int_max && ldc <= int_max) {
+    complex_gemm(transa, transb, n, m, k, alpha,
+        a.data_ptr<scalar_t>(), lda, b.data_ptr<scalar_t>(), ldb, beta,
+        c.data_ptr<scalar_t>(), ldc);
+    if (!c.is_same(result)) {
+      result.copy_(c);
+    }
+    return;
+  }
+#endif
+
+  auto r = result.accessor<scalar_t, 2>();
+  auto m1 = mat1.accessor<scalar_t, 2>();
+  auto m2 = mat2.accessor<scalar_t, 2>();
+  at::parallel_for(0, m, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      for (int64_t j = 0; j < n; j++) {
+        scalar_t sum = 0;
+        for (int64_t l = 0; l < k; l++) {
+          sum += m1[i][l] * m2[l][j];
+        }
+        r[i][j] = beta == scalar_t(0) ? alpha * sum : beta * r[i][j] + alpha * sum;
+      }
+    }
+  });
+}
+
+Tensor mm_cpu(const Tensor& self, const Tensor& mat2) {
+  if (!self.is_complex()) {
+    return legacy::cpu::_th_mm(self, mat2);
+  }
+  Tensor result = at::empty({0}, self.options());
+  return at::native::mm_out_cpu(result, self, mat2);
+}
+
+Tensor& mm_out_cpu(Tensor& result, const Tensor& self, const Tensor& mat2) {
+  if (!self.is_complex()) {
+    return legacy::cpu::_th_mm_out(result, self, mat2);
+  }
+  TORCH_CHECK(self.dim() == 2 && mat2.dim() == 2,
+      "mm: expected 2D tensors, but got ", self.dim(), "D and ", mat2.dim(), "D tensors");
+  TORCH_CHECK(self.size(1) == mat2.size(0),
+      "size mismatch, m1: ", self.sizes(), ", m2: ", mat2.sizes());
+  TORCH_CHECK(mat2.scalar_type() == self.scalar_type() && result.scalar_type() == self.scalar_type(),
+      "mm: expected all tensors to be of dtype ", self.scalar_type(), ", but got ",
+      mat2.scalar_type(), " for mat2 and ", result.scalar_type(), " for result");
+  result.resize_({self.size(0), mat2.size(1)});
+  {
+    NoNamesGuard guard;
+    AT_DISPATCH_COMPLEX_TYPES(self.scalar_type(), "mm", [&] {
+      complex_addmm_<scalar_t>(result, self, mat2, scalar_t(0), scalar_t(1));
+    });
+  }
+  namedinference::propagate_names_for_addmm(
+      result.unsafeGetTensorImpl(), self.unsafeGetTensorImpl(),
+      mat2.unsafeGetTensorImpl(), result.unsafeGetTensorImpl());
+  return result;
+}
+
 template <typename scalar_t, bool is_bmm>
 inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const Tensor& mat2, Scalar beta_, Scalar alpha_) {
   int64_t bs = result.size(0);
@@ -247,19 +375,28 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
 
   if (contraction_size * res_rows * res_cols < 400) {
     if (is_bmm_out) {
-      AT_DISPATCH_ALL_TYPES(batch1.scalar_type(), "bmm", [&] {
+      AT_DISPATCH_ALL_TYPES_AND_COMPLEX(batch1.scalar_type(), "bmm", [&] {
           baddbmm_cpu_kernel<scalar_t, true>(self_or_result, batch1, batch2, beta, alpha);
         });
     } else {
-      AT_DISPATCH_ALL_TYPES(batch1.scalar_type(), "baddbmm", [&] {
+      AT_DISPATCH_ALL_TYPES_AND_COMPLEX(batch1.scalar_type(), "baddbmm", [&] {
           baddbmm_cpu_kernel<scalar_t, false>(self_or_result, batch1, batch2, beta, alpha);
         });
     }
-  } else if (at::hasMKL() && at::native::is_floating_point(self_or_result)
+  } else if (at::hasMKL() && (at::native::is_floating_point(self_or_result) || self_or_result.is_complex())
             && batch_items_contiguous_or_transposed(batch1)
             && batch_items_contiguous_or_transposed(batch2)
             && self_or_result.is_contiguous()) {
     at::native::_baddbmm_mkl_(self_or_result, batch1, batch2, beta, alpha);
+  } else if (self_or_result.is_complex()) { // split along batch dimension
+    AT_DISPATCH_COMPLEX_TYPES(batch1.scalar_type(), "baddbmm", [&] {
+      const auto beta_value = is_bmm_out ? scalar_t(0) : beta.to<scalar_t>();
+      const auto alpha_value = alpha.to<scalar_t>();
+      for (int64_t b = 0; b < bs; b++) {
+        auto r = self_or_result.select(0, b);
+        complex_addmm_<scalar_t>(r, batch1.select(0, b), batch2.select(0, b), beta_value, alpha_value);
+      }
+    });
   } else { // split along batch dimension
     if (is_bmm_out) {
       for (int64_t b = 0; b < bs; b++) {
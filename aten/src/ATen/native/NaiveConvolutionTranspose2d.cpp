@@ -1,6 +1,8 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/core/grad_mode.h>
 
 #include <TH/THBlasUtils.h>
 
@@ -129,6 +131,85 @@ static inline void slow_conv_transpose2d_shape_check(
   }
 }
 
+// Computes an NHWC output frame. The columns of the frame are the
+// (input_height * input_width, kernel_height * kernel_width * n_output_plane)
+// product of the NHWC input frame and of the weight permuted to
+// (n_input_plane, kernel_height, kernel_width, n_output_plane), so every input
+// pixel adds a contiguous run of n_output_plane values to each output pixel
+// its kernel covers.
+template <typename scalar_t>
+static void slow_conv_transpose2d_update_output_frame_channels_last(
+    const scalar_t* input_data,
+    const scalar_t* weight_data,
+    const scalar_t* bias_data,
+    scalar_t* columns_data,
+    scalar_t* output_data,
+    int64_t n_input_plane,
+    int64_t input_height,
+    int64_t input_width,
+    int64_t n_output_plane,
+    int64_t output_height,
+    int64_t output_width,
+    int64_t kernel_height,
+    int64_t kernel_width,
+    int64_t pad_height,
+    int64_t pad_width,
+    int64_t stride_height,
+    int64_t stride_width,
+    int64_t dilation_height,
+    int64_t dilation_width) {
+  const int64_t columns_width = kernel_height * kernel_width * n_output_plane;
+
+  // Do GEMM (note: this is a bit confusing because gemm assumes
+  // column-major matrices)
+  THBlas_gemm<scalar_t>(
+      'n',
+      'n',
+      columns_width,
+      input_height * input_width,
+      n_input_plane,
+      1,
+      const_cast<scalar_t*>(weight_data),
+      columns_width,
+      const_cast<scalar_t*>(input_data),
+      n_input_plane,
+      0,
+      columns_data,
+      columns_width);
+
+  for (int64_t i = 0; i < output_height * output_width; i++) {
+    scalar_t* dst = output_data + i * n_output_plane;
+    for (int64_t c = 0; c < n_output_plane; c++) {
+      dst[c] = bias_data ? bias_data[c] : scalar_t(0);
+    }
+  }
+
+  for (int64_t ih = 0; ih < input_height; ih++) {
+    for (int64_t iw = 0; iw < input_width; iw++) {
+      const scalar_t* src =
+          columns_data + (ih * input_width + iw) * columns_width;
+      for (int64_t kh = 0; kh < kernel_height; kh++) {
+        const int64_t oh = ih * stride_height - pad_height + kh * dilation_height;
+        if (oh < 0 || oh >= output_height) {
+          continue;
+        }
+        for (int64_t kw = 0; kw < kernel_width; kw++) {
+          const int64_t ow = iw * stride_width - pad_width + kw * dilation_width;
+          if (ow < 0 || ow >= output_width) {
+            continue;
+          }
+          const scalar_t* src_k =
+              src + (kh * kernel_width + kw) * n_output_plane;
+          scalar_t* dst = output_data + (oh * output_width + ow) * n_output_plane;
+          for (int64_t c = 0; c < n_output_plane; c++) {
+            dst[c] += src_k[c];
+          }
+        }
+      }
+    }
+  }
+}
+
 void slow_conv_transpose2d_out_cpu_template(
     Tensor& output,
     const Tensor& input_,
@@ -200,8 +281,14 @@ void slow_conv_transpose2d_out_cpu_template(
   int n_input_plane = weight_.size(0);
   int n_output_plane = weight_.size(1);
 
-  Tensor input = input_.contiguous();
-  Tensor weight = weight_.contiguous();
+  // Channels last inputs produce a channels last output
+  const auto memory_format = input_.suggest_memory_format();
+  const bool channels_last = memory_format == at::MemoryFormat::ChannelsLast;
+  Tensor input = input_.contiguous(memory_format);
+  // The columns of an NHWC frame are computed with the weight laid out as
+  // (n_input_plane, kernel_height, kernel_width, n_output_plane)
+  Tensor weight = channels_last ? weight_.permute({0, 2, 3, 1}).contiguous()
+                                : weight_.contiguous();
 
   TORCH_CHECK(columns.is_contiguous(), "columns needs to be contiguous");
 
@@ -230,18 +317,25 @@ void slow_conv_transpose2d_out_cpu_template(
   int64_t batch_size = input.size(0);
 
   // Resize output
-  output.resize_({batch_size, n_output_plane, output_height, output_width});
-
-  // Resize temporary columns
-  columns.resize_({n_output_plane * kernel_width * kernel_height,
-                   input_height * input_width});
-  columns.zero_();
+  output.resize_(
+      {batch_size, n_output_plane, output_height, output_width}, memory_format);
+
+  // Resize temporary columns. They are overwritten by the GEMM of every frame,
+  // so they don't need to be zeroed.
+  const int64_t columns_rows = n_output_plane * kernel_width * kernel_height;
+  const int64_t columns_cols = input_height * input_width;
+  if (channels_last) {
+    columns.resize_({columns_cols, columns_rows});
+  } else {
+    columns.resize_({columns_rows, columns_cols});
+  }
 
   // Define a buffer of ones, for bias accumulation
   // Note: this buffer can be shared with other modules, it only ever gets
   // increased, and always contains ones.
-  if (ones.dim() != 2 ||
-      ones.size(0) * ones.size(1) < output_height * output_width) {
+  if (!channels_last && bias_.defined() &&
+      (ones.dim() != 2 ||
+       ones.size(0) * ones.size(1) < output_height * output_width)) {
     // Resize plane and fill with ones...
     ones.resize_({output_height, output_width});
     ones.fill_(1);
@@ -249,83 +343,113 @@ void slow_conv_transpose2d_out_cpu_template(
 
   AT_DISPATCH_FLOATING_TYPES_AND(at::ScalarType::Long,
       input.scalar_type(), "slow_conv_transpose2d_out_cpu", [&] {
-        // For each elt in batch, do:
-        for (int elt = 0; elt < batch_size; elt++) {
-          // Helpers
-          Tensor input_n;
-          Tensor output_n;
+        // The frames of the batch are independent. The thread that starts at
+        // the first frame reuses the columns buffer passed in, every other
+        // thread allocates one buffer for all of its frames.
+        at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+          NoGradGuard no_grad;
+          AutoNonVariableTypeMode non_variable_type_mode;
+          Tensor columns_t =
+              start == 0 ? columns : at::empty(columns.sizes(), columns.options());
+          scalar_t* columns_data = columns_t.data_ptr<scalar_t>();
+
+          for (int64_t elt = start; elt < end; elt++) {
+            // Matrix mulitply per output:
+            Tensor input_n = input.select(0, elt);
+            Tensor output_n = output.select(0, elt);
+
+            if (channels_last) {
+              slow_conv_transpose2d_update_output_frame_channels_last<scalar_t>(
+                  input_n.data_ptr<scalar_t>(),
+                  weight.data_ptr<scalar_t>(),
+                  bias.defined() ? bias.data_ptr<scalar_t>() : nullptr,
+                  columns_data,
+                  output_n.data_ptr<scalar_t>(),
+                  n_input_plane,
+                  input_height,
+                  input_width,
+                  n_output_plane,
+                  output_height,
+                  output_width,
+                  kernel_height,
+                  kernel_width,
+                  pad_height,
+                  pad_width,
+                  stride_height,
+                  stride_width,
+                  dilation_height,
+                  dilation_width);
+              continue;
+            }
 
-          // Matrix mulitply per output:
-          input_n = input.select(0, elt);
-          output_n = output.select(0, elt);
-
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          int64_t m = weight.size(1) * weight.size(2) * weight.size(3);
-          int64_t n = columns.size(1);
-          int64_t k = weight.size(0);
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          THBlas_gemm<scalar_t>(
-              'n',
-              't',
-              n,
-              m,
-              k,
-              1,
-              input_n.data_ptr<scalar_t>(),
-              n,
-              weight.data_ptr<scalar_t>(),
-              m,
-              0,
-              columns.data_ptr<scalar_t>(),
-              n);
-
-          // Unpack columns back into input:
-          col2im<scalar_t>(
-              columns.data_ptr<scalar_t>(),
-              n_output_plane,
-              output_height,
-              output_width,
-              input_height,
-              input_width,
-              kernel_height,
-              kernel_width,
-              pad_height,
-              pad_width,
-              stride_height,
-              stride_width,
-              dilation_height,
-              dilation_width,
-              output_n.data_ptr<scalar_t>());
-
-          // Do Bias after:
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          int64_t m_ = n_output_plane;
-          int64_t n_ = output_height * output_width;
-          int64_t k_ = 1;
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          if (bias_.defined()) {
+            // M,N,K are dims of matrix A and B
+            // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+            int64_t m = weight.size(1) * weight.size(2) * weight.size(3);
+            int64_t n = columns_cols;
+            int64_t k = weight.size(0);
+
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
             THBlas_gemm<scalar_t>(
-                't',
                 'n',
-                n_,
-                m_,
-                k_,
-                1,
-                ones.data_ptr<scalar_t>(),
-                k_,
-                bias.data_ptr<scalar_t>(),
-                k_,
+                't',
+                n,
+                m,
+                k,
                 1,
-                output_n.data_ptr<scalar_t>(),
-                n_);
+                input_n.data_ptr<scalar_t>(),
+                n,
+                weight.data_ptr<scalar_t>(),
+                m,
+                0,
+                columns_data,
+                n);
+
+            // Unpack columns back into input:
+            col2im<scalar_t>(
+                columns_data,
+                n_output_plane,
+                output_height,
+                output_width,
+                input_height,
+                input_width,
+                kernel_height,
+                kernel_width,
+                pad_height,
+                pad_width,
+                stride_height,
+                stride_width,
+                dilation_height,
+                dilation_width,
+                output_n.data_ptr<scalar_t>());
+
+            // Do Bias after:
+            // M,N,K are dims of matrix A and B
+            // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+            int64_t m_ = n_output_plane;
+            int64_t n_ = output_height * output_width;
+            int64_t k_ = 1;
+
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
+            if (bias_.defined()) {
+              THBlas_gemm<scalar_t>(
+                  't',
+                  'n',
+                  n_,
+                  m_,
+                  k_,
+                  1,
+                  ones.data_ptr<scalar_t>(),
+                  k_,
+                  bias.data_ptr<scalar_t>(),
+                  k_,
+                  1,
+                  output_n.data_ptr<scalar_t>(),
+                  n_);
+            }
           }
-        }
+        });
 
         // Resize output
         if (is_batch) {
@@ -430,9 +554,8 @@ static void slow_conv_transpose2d_backward_out_cpu_template(
   // Batch size + input planes
   int64_t batch_size = input.size(0);
 
-  // Resize output
+  // Resize output. Every frame is overwritten by its GEMM.
   grad_input.resize_({batch_size, n_input_plane, input_height, input_width});
-  grad_input.zero_();
 
   // Resize temporary columns
   grad_columns.resize_({n_output_plane * kernel_width * kernel_height,
@@ -440,57 +563,63 @@ static void slow_conv_transpose2d_backward_out_cpu_template(
 
   AT_DISPATCH_FLOATING_TYPES(
       grad_output.scalar_type(), "slow_conv_transpose2d_backward_out_cpu", [&] {
-        // Helpers
-        Tensor grad_input_n = Tensor();
-        Tensor grad_output_n = Tensor();
+        // The frames of the batch are independent. The thread that starts at
+        // the first frame reuses grad_columns, every other thread allocates
+        // one buffer for all of its frames.
+        at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+          NoGradGuard no_grad;
+          AutoNonVariableTypeMode non_variable_type_mode;
+          Tensor grad_columns_t = start == 0
+              ? grad_columns
+              : at::empty(grad_columns.sizes(), grad_columns.options());
+
+          for (int64_t elt = start; elt < end; elt++) {
+            // Matrix mulitply per sample:
+            Tensor grad_input_n = grad_input.select(0, elt);
+            Tensor grad_output_n = grad_output.select(0, elt);
 
-        // For each elt in batch, do:
-        for (int elt = 0; elt < batch_size; elt++) {
-          // Matrix mulitply per sample:
-          grad_input_n = grad_input.select(0, elt);
-          grad_output_n = grad_output.select(0, elt);
+            // Extract columns:
+            im2col<scalar_t>(
+                grad_output_n.data_ptr<scalar_t>(),
+                n_output_plane,
+                output_height,
+                output_width,
+                input_height,
+                input_width,
+                kernel_height,
+                kernel_width,
+                pad_height,
+                pad_width,
+                stride_height,
+                stride_width,
+                dilation_height,
+                dilation_width,
+                grad_columns_t.data_ptr<scalar_t>());
 
-          // Extract columns:
-          im2col<scalar_t>(
-              grad_output_n.data_ptr<scalar_t>(),
-              n_output_plane,
-              output_height,
-              output_width,
-              input_height,
-              input_width,
-              kernel_height,
-              kernel_width,
-              pad_height,
-              pad_width,
-              stride_height,
-              stride_width,
-              dilation_height,
-              dilation_width,
-              grad_columns.data_ptr<scalar_t>());
-
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          int64_t m = weight.size(0);
-          int64_t n = grad_columns.size(1);
-          int64_t k = weight.size(1) * weight.size(2) * weight.size(3);
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          THBlas_gemm<scalar_t>(
-              'n',
-              'n',
-              n,
-              m,
-              k,
-              1,
-              grad_columns.data_ptr<scalar_t>(),
-              n,
-              weight.data_ptr<scalar_t>(),
-              k,
-              0,
-              grad_input_n.data_ptr<scalar_t>(),
-              n);
-        }
+            // M,N,K are dims of matrix A and B
+            // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+            int64_t m = weight.size(0);
+            int64_t n = grad_columns_t.size(1);
+            int64_t k = weight.size(1) * weight.size(2) * weight.size(3);
+
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
+            THBlas_gemm<scalar_t>(
+                'n',
+                'n',
+                n,
+                m,
+                k,
+                1,
+                grad_columns_t.data_ptr<scalar_t>(),
+                n,
+                weight.data_ptr<scalar_t>(),
+                k,
+                0,
+                grad_input_n.data_ptr<scalar_t>(),
+                n);
+          }
+        });
 
         // Resize output
         if (is_batch) {
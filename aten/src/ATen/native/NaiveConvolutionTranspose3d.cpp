@@ -1,6 +1,8 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
+#include <ATen/core/grad_mode.h>
 
 #include <TH/THBlasUtils.h>
 
@@ -275,10 +277,10 @@ void slow_conv_transpose3d_out_cpu_template(
   output.resize_(
       {batch_size, n_output_plane, output_depth, output_height, output_width});
 
-  // Resize temporary columns
+  // Resize temporary columns. They are overwritten by the GEMM of every frame,
+  // so they don't need to be zeroed.
   columns.resize_({n_output_plane * kernel_width * kernel_height * kernel_depth,
                    input_depth * input_height * input_width});
-  columns.zero_();
 
   // Define a buffer of ones, for bias accumulation
   // Note: this buffer can be shared with other modules, it only ever gets
@@ -293,91 +295,96 @@ void slow_conv_transpose3d_out_cpu_template(
 
   AT_DISPATCH_FLOATING_TYPES_AND(at::ScalarType::Long,
       input.scalar_type(), "slow_conv_transpose3d_out_cpu", [&] {
-        // Helpers
-        Tensor input_n;
-        Tensor output_n;
+        // The frames of the batch are independent. The thread that starts at
+        // the first frame reuses the columns buffer passed in, every other
+        // thread allocates one buffer for all of its frames.
+        at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+          NoGradGuard no_grad;
+          AutoNonVariableTypeMode non_variable_type_mode;
+          Tensor columns_t = start == 0
+              ? columns
+              : at::empty(columns.sizes(), columns.options());
+
+          for (int64_t elt = start; elt < end; elt++) {
+            // Matrix mulitply per output:
+            Tensor input_n = input.select(0, elt);
+            Tensor output_n = output.select(0, elt);
 
-        int elt;
-        // For each elt in batch, do:
-        for (elt = 0; elt < batch_size; ++elt) {
-          // Matrix mulitply per output:
-          input_n = input.select(0, elt);
-          output_n = output.select(0, elt);
-
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          const int64_t m =
-              weight.size(1) * weight.size(2) * weight.size(3) * weight.size(4);
-          const int64_t n = columns.size(1);
-          const int64_t k = weight.size(0);
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          THBlas_gemm<scalar_t>(
-              'n',
-              't',
-              n,
-              m,
-              k,
-              1,
-              input_n.data_ptr<scalar_t>(),
-              n,
-              weight.data_ptr<scalar_t>(),
-              m,
-              0,
-              columns.data_ptr<scalar_t>(),
-              n);
-
-          // Unpack columns back into input:
-          at::native::col2vol<scalar_t>(
-              columns.data_ptr<scalar_t>(),
-              n_output_plane,
-              output_depth,
-              output_height,
-              output_width,
-              input_depth,
-              input_height,
-              input_width,
-              kernel_depth,
-              kernel_height,
-              kernel_width,
-              padding_depth,
-              padding_height,
-              padding_width,
-              stride_depth,
-              stride_height,
-              stride_width,
-              dilation_depth,
-              dilation_height,
-              dilation_width,
-              output_n.data_ptr<scalar_t>());
-
-          // Do Bias after:
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          const int64_t m_ = n_output_plane;
-          const int64_t n_ = output_depth * output_height * output_width;
-          const int64_t k_ = 1;
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          if (bias.defined()) {
+            // M,N,K are dims of matrix A and B
+            // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+            const int64_t m =
+                weight.size(1) * weight.size(2) * weight.size(3) * weight.size(4);
+            const int64_t n = columns_t.size(1);
+            const int64_t k = weight.size(0);
+
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
             THBlas_gemm<scalar_t>(
-                't',
                 'n',
-                n_,
-                m_,
-                k_,
-                1,
-                ones.data_ptr<scalar_t>(),
-                k_,
-                bias.data_ptr<scalar_t>(),
-                k_,
+                't',
+                n,
+                m,
+                k,
                 1,
-                output_n.data_ptr<scalar_t>(),
-                n_);
+                input_n.data_ptr<scalar_t>(),
+                n,
+                weight.data_ptr<scalar_t>(),
+                m,
+                0,
+                columns_t.data_ptr<scalar_t>(),
+                n);
+
+            // Unpack columns back into input:
+            at::native::col2vol<scalar_t>(
+                columns_t.data_ptr<scalar_t>(),
+                n_output_plane,
+                output_depth,
+                output_height,
+                output_width,
+                input_depth,
+                input_height,
+                input_width,
+                kernel_depth,
+                kernel_height,
+                kernel_width,
+                padding_depth,
+                padding_height,
+                padding_width,
+                stride_depth,
+                stride_height,
+                stride_width,
+                dilation_depth,
+                dilation_height,
+                dilation_width,
+                output_n.data_ptr<scalar_t>());
+
+            // Do Bias after:
+            // M,N,K are dims of matrix A and B
+            // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+            const int64_t m_ = n_output_plane;
+            const int64_t n_ = output_depth * output_height * output_width;
+            const int64_t k_ = 1;
+
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
+            if (bias.defined()) {
+              THBlas_gemm<scalar_t>(
+                  't',
+                  'n',
+                  n_,
+                  m_,
+                  k_,
+                  1,
+                  ones.data_ptr<scalar_t>(),
+                  k_,
+                  bias.data_ptr<scalar_t>(),
+                  k_,
+                  1,
+                  output_n.data_ptr<scalar_t>(),
+                  n_);
+            }
           }
-        }
+        });
 
         // Resize output
         if (is_batch) {
@@ -505,10 +512,9 @@ void slow_conv_transpose3d_backward_out_cpu_template(
   // Batch size + input planes
   const int64_t batch_size = input.size(0);
 
-  // Resize output
+  // Resize output. Every frame is overwritten by its GEMM.
   grad_input.resize_(
       {batch_size, n_input_plane, input_depth, input_height, input_width});
-  grad_input.zero_();
 
   // Resize temporary columns
   grad_columns.resize_(
@@ -517,65 +523,70 @@ void slow_conv_transpose3d_backward_out_cpu_template(
 
   AT_DISPATCH_FLOATING_TYPES(
       input.scalar_type(), "slow_conv_transpose3d_backward_out_cpu", [&] {
-        // Helpers
-        Tensor grad_input_n;
-        Tensor grad_output_n;
+        // The frames of the batch are independent. The thread that starts at
+        // the first frame reuses grad_columns, every other thread allocates
+        // one buffer for all of its frames.
+        at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+          NoGradGuard no_grad;
+          AutoNonVariableTypeMode non_variable_type_mode;
+          Tensor grad_columns_t = start == 0
+              ? grad_columns
+              : at::empty(grad_columns.sizes(), grad_columns.options());
+
+          for (int64_t elt = start; elt < end; elt++) {
+            // Matrix mulitply per sample:
+            Tensor grad_input_n = grad_input.select(0, elt);
+            Tensor grad_output_n = grad_output.select(0, elt);
 
-        int elt;
-        // For each elt in batch, do:
-        for (elt = 0; elt < batch_size; ++elt) {
-          // Matrix mulitply per sample:
-          grad_input_n = grad_input.select(0, elt);
-          grad_output_n = grad_output.select(0, elt);
+            // Extract columns:
+            at::native::vol2col<scalar_t>(
+                grad_output_n.data_ptr<scalar_t>(),
+                n_output_plane,
+                output_depth,
+                output_height,
+                output_width,
+                input_depth,
+                input_height,
+                input_width,
+                kernel_depth,
+                kernel_height,
+                kernel_width,
+                padding_depth,
+                padding_height,
+                padding_width,
+                stride_depth,
+                stride_height,
+                stride_width,
+                dilation_depth,
+                dilation_height,
+                dilation_width,
+                grad_columns_t.data_ptr<scalar_t>());
 
-          // Extract columns:
-          at::native::vol2col<scalar_t>(
-              grad_output_n.data_ptr<scalar_t>(),
-              n_output_plane,
-              output_depth,
-              output_height,
-              output_width,
-              input_depth,
-              input_height,
-              input_width,
-              kernel_depth,
-              kernel_height,
-              kernel_width,
-              padding_depth,
-              padding_height,
-              padding_width,
-              stride_depth,
-              stride_height,
-              stride_width,
-              dilation_depth,
-              dilation_height,
-              dilation_width,
-              grad_columns.data_ptr<scalar_t>());
-
-          // M,N,K are dims of matrix A and B
-          // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
-          const int64_t m = weight.size(0);
-          const int64_t n = grad_columns.size(1);
-          const int64_t k =
-              weight.size(1) * weight.size(2) * weight.size(3) * weight.size(4);
-
-          // Do GEMM (note: this is a bit confusing because gemm assumes
-          // column-major matrices)
-          THBlas_gemm<scalar_t>(
-              'n',
-              'n',
-              n,
-              m,
-              k,
-              1,
-              grad_columns.data_ptr<scalar_t>(),
-              n,
-              weight.data_ptr<scalar_t>(),
-              k,
-              0,
-              grad_input_n.data_ptr<scalar_t>(),
-              n);
-        }
+            // M,N,K are dims of matrix A and B
+            // (see http://docs.nvidia.com/cuda/cublas/#cublas-lt-t-gt-gemm)
+            const int64_t m = weight.size(0);
+            const int64_t n = grad_columns_t.size(1);
+            const int64_t k =
+                weight.size(1) * weight.size(2) * weight.size(3) * weight.size(4);
+
+            // Do GEMM (note: this is a bit confusing because gemm assumes
+            // column-major matrices)
+            THBlas_gemm<scalar_t>(
+                'n',
+                'n',
+                n,
+                m,
+                k,
+                1,
+                grad_columns_t.data_ptr<scalar_t>(),
+                n,
+                weight.data_ptr<scalar_t>(),
+                k,
+                0,
+                grad_input_n.data_ptr<scalar_t>(),
+                n);
+          }
+        });
 
         // Resize output
         if (is_batch) {
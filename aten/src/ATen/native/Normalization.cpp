@@ -225,8 +225,6 @@ std::tuple<Tensor,Tensor,Tensor> batch_norm_cpu_transform_input_template(
     return std::make_tuple(output, save_mean, save_invstd);
   }
 
-  Tensor output = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-
   int64_t n_input = input.size(1);
 
   auto save_mean_a = conditional_accessor_1d<scalar_t>(save_mean);
@@ -235,6 +233,34 @@ std::tuple<Tensor,Tensor,Tensor> batch_norm_cpu_transform_input_template(
   auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
   auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
 
+  // Channels last training: every row of the (N * H * W, C) view is
+  // normalized with the per channel statistics, keeping the output NHWC.
+  if (train && input.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    Tensor output = at::empty_like(input, at::MemoryFormat::ChannelsLast);
+    std::vector<scalar_t> mean(n_input), invstd(n_input), w(n_input), b(n_input);
+    for (int64_t f = 0; f < n_input; ++f) {
+      mean[f] = save_mean_a[f];
+      invstd[f] = save_invstd_a[f];
+      w[f] = weight.defined() ? weight.data_ptr<scalar_t>()[f * weight.stride(0)] : 1;
+      b[f] = bias.defined() ? bias.data_ptr<scalar_t>()[f * bias.stride(0)] : 0;
+    }
+    const scalar_t* input_data = input.data_ptr<scalar_t>();
+    scalar_t* output_data = output.data_ptr<scalar_t>();
+    const int64_t n_rows = input.numel() / n_input;
+    parallel_for(0, n_rows, internal::GRAIN_SIZE / n_input + 1, [&](int64_t r_begin, int64_t r_end) {
+      for (int64_t r = r_begin; r < r_end; ++r) {
+        const scalar_t* in = input_data + r * n_input;
+        scalar_t* out = output_data + r * n_input;
+        for (int64_t f = 0; f < n_input; ++f) {
+          out[f] = ((in[f] - mean[f]) * invstd[f]) * w[f] + b[f];
+        }
+      }
+    });
+    return std::make_tuple(output, save_mean, save_invstd);
+  }
+
+  Tensor output = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+
   parallel_for(0, n_input, 1, [&](int64_t b_begin, int64_t b_end) {
     for (int64_t f = b_begin; f < b_end; ++f) {
       Tensor in = input.select(1, f);
@@ -280,6 +306,48 @@ std::tuple<Tensor,Tensor> batch_norm_cpu_update_stats_template(
   auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
   auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
 
+  // For channels last inputs the (N * H * W, C) view is walked row by row,
+  // with each thread accumulating a contiguous block of channels.
+  if (input.is_contiguous(at::MemoryFormat::ChannelsLast)) {
+    const scalar_t* input_data = input.data_ptr<scalar_t>();
+    parallel_for(0, n_input, 1, [&](int64_t b_begin, int64_t b_end) {
+      const int64_t n_block = b_end - b_begin;
+      std::vector<accscalar_t> sum(n_block, 0);
+      std::vector<accscalar_t> var_sum(n_block, 0);
+      std::vector<scalar_t> mean(n_block);
+      for (int64_t r = 0; r < n; ++r) {
+        const scalar_t* in = input_data + r * n_input + b_begin;
+        for (int64_t f = 0; f < n_block; ++f) {
+          sum[f] += in[f];
+        }
+      }
+      for (int64_t f = 0; f < n_block; ++f) {
+        mean[f] = sum[f] / n;
+      }
+      for (int64_t r = 0; r < n; ++r) {
+        const scalar_t* in = input_data + r * n_input + b_begin;
+        for (int64_t f = 0; f < n_block; ++f) {
+          var_sum[f] += (in[f] - mean[f]) * (in[f] - mean[f]);
+        }
+      }
+      for (int64_t f = 0; f < n_block; ++f) {
+        const int64_t c = b_begin + f;
+        save_mean_a[c] = mean[f];
+        save_var_transform_a[c] = VarTransform<accscalar_t>{}(var_sum[f] / n, eps);
+
+        // update running averages
+        if (running_mean.defined()) {
+          running_mean_a[c] = momentum * mean[f] + (1 - momentum) * running_mean_a[c];
+        }
+        if (running_var.defined()) {
+          accscalar_t unbiased_var = var_sum[f] / (n - 1);
+          running_var_a[c] = momentum * unbiased_var + (1 - momentum) * running_var_a[c];
+        }
+      }
+    });
+    return std::make_tuple(save_mean, save_var_transform);
+  }
+
   parallel_for(0, n_input, 1, [&](int64_t b_begin, int64_t b_end) {
     for (int64_t f = b_begin; f < b_end; ++f) {
       Tensor in = input.select(1, f);
@@ -329,8 +397,10 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_template(const Tensor
   Tensor grad_input;
   Tensor grad_weight;
   Tensor grad_bias;
+  const bool channels_last = input.is_contiguous(at::MemoryFormat::ChannelsLast);
   if (grad_input_mask[0]) {
-    grad_input = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    grad_input = at::empty_like(input, channels_last ? at::MemoryFormat::ChannelsLast
+                                                     : LEGACY_CONTIGUOUS_MEMORY_FORMAT);
   }
   if (grad_input_mask[1]) {
     grad_weight = at::empty_like(weight, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
@@ -352,6 +422,73 @@ std::tuple<Tensor, Tensor, Tensor> batch_norm_backward_cpu_template(const Tensor
   auto running_mean_a = conditional_accessor_1d<scalar_t>(running_mean);
   auto running_var_a = conditional_accessor_1d<scalar_t>(running_var);
 
+  if (channels_last) {
+    // Same math as the per plane loop below, over the (N * H * W, C) view.
+    // Each thread owns a block of channels, so grad_input writes never overlap.
+    const auto grad_out = grad_out_.contiguous(at::MemoryFormat::ChannelsLast);
+    const scalar_t* input_data = input.data_ptr<scalar_t>();
+    const scalar_t* grad_out_data = grad_out.data_ptr<scalar_t>();
+    scalar_t* grad_input_data = grad_input_mask[0] ? grad_input.data_ptr<scalar_t>() : nullptr;
+    parallel_for(0, n_input, 1, [&](int64_t b_begin, int64_t b_end) {
+      const int64_t n_block = b_end - b_begin;
+      std::vector<scalar_t> mean(n_block), invstd(n_block), w(n_block);
+      std::vector<accscalar_t> sum(n_block, 0), dotp(n_block, 0);
+      for (int64_t f = 0; f < n_block; ++f) {
+        const int64_t c = b_begin + f;
+        w[f] = weight.defined() ? weight_a[c] : 1;
+        if (train) {
+          mean[f] = save_mean_a[c];
+          invstd[f] = save_invstd_a[c];
+        } else {
+          mean[f] = running_mean_a[c];
+          invstd[f] = 1 / std::sqrt(running_var_a[c] + eps);
+        }
+      }
+
+      // sum over gradOutput and dot product of Q(X) and gradOutput
+      for (int64_t r = 0; r < n; ++r) {
+        const scalar_t* in = input_data + r * n_input + b_begin;
+        const scalar_t* go = grad_out_data + r * n_input + b_begin;
+        for (int64_t f = 0; f < n_block; ++f) {
+          sum[f] += go[f];
+          dotp[f] += (in[f] - mean[f]) * go[f];
+        }
+      }
+
+      if (grad_input_mask[0]) {
+        std::vector<scalar_t> k(n_block);
+        std::vector<accscalar_t> grad_mean(n_block);
+        for (int64_t f = 0; f < n_block; ++f) {
+          k[f] = (scalar_t) dotp[f] * invstd[f] * invstd[f] / n;
+          grad_mean[f] = sum[f] / n;
+        }
+        for (int64_t r = 0; r < n; ++r) {
+          const scalar_t* in = input_data + r * n_input + b_begin;
+          const scalar_t* go = grad_out_data + r * n_input + b_begin;
+          scalar_t* gi = grad_input_data + r * n_input + b_begin;
+          if (train) {
+            for (int64_t f = 0; f < n_block; ++f) {
+              gi[f] = (go[f] - grad_mean[f] - (in[f] - mean[f]) * k[f]) * invstd[f] * w[f];
+            }
+          } else {
+            for (int64_t f = 0; f < n_block; ++f) {
+              gi[f] = go[f] * invstd[f] * w[f];
+            }
+          }
+        }
+      }
+
+      for (int64_t f = 0; f < n_block; ++f) {
+        if (grad_input_mask[1]) {
+          grad_weight_a[b_begin + f] = dotp[f] * invstd[f];
+        }
+        if (grad_input_mask[2]) {
+          grad_bias_a[b_begin + f] = sum[f];
+        }
+      }
+    });
+    return std::make_tuple(grad_input, grad_weight, grad_bias);
+  }
 
   parallel_for(0, n_input, 1, [&](int64_t b_begin, int64_t b_end) {
       for (int64_t f = b_begin; f < b_end; ++f) {
@@ -577,52 +714,6 @@ Tensor instance_norm(
   return out.view(input.sizes());
 }
 
-Tensor group_norm(const Tensor& input, int64_t num_groups,
-    const Tensor& weight /* optional */, const Tensor& bias /* optional */,
-    double eps, bool cudnn_enabled) {
-
-    auto input_shape = input.sizes();
-    int64_t b = input.size(0);
-    int64_t c = input.size(1);
-
-    TORCH_CHECK(c % num_groups == 0,
-             "Expected number of channels in input to be divisible by ",
-             "num_groups, but got input of shape ", input.sizes(), " and "
-             "num_groups=", num_groups);
-
-    TORCH_CHECK(!weight.defined() || (weight.dim() == 1 && weight.numel() == c),
-             "Expected weight to be a vector of size equal to the number of ",
-             "channels in input, but got weight of shape ", weight.sizes(),
-             " and input of shape ", input.sizes());
-    TORCH_CHECK(!bias.defined() || (bias.dim() == 1 && bias.numel() == c),
-             "Expected bias to be a vector of size equal to the number of ",
-             "channels in input, but got bias of shape ", weight.sizes(),
-             " and input of shape ", input.sizes());
-
-    // Apply group norm
-    // view(..., -1) does not work for empty tensor
-    auto input_reshaped = input.contiguous().view({1, b * num_groups, b ? -1 : 1});
-
-    auto out = at::batch_norm(input_reshaped, {}, {}, {}, {}, true, 0, eps,
-                              cudnn_enabled);
-    out = out.view(input_shape);
-
-    if (!weight.defined() && !bias.defined()) {
-      return out;
-    }
-
-    std::vector<int64_t> affine_param_shape(input.dim(), 1);
-    affine_param_shape[1] = c;
-
-    if (weight.defined() && bias.defined()) {
-      return bias.view(affine_param_shape).addcmul(out, weight.view(affine_param_shape), 1);
-    } else if (weight.defined()) {
-      return out.mul(weight.view(affine_param_shape));
-    } else {
-      return out.add(bias.view(affine_param_shape));
-    }
-}
-
 std::tuple<Tensor, Tensor> batch_norm_update_stats_cpu(
         const Tensor& self, const Tensor& running_mean, const Tensor& running_var, double momentum) {
   return AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "batch_norm_update_stats_cpu", [&] {
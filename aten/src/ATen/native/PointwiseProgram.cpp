@@ -0,0 +1,9 @@
+#include <ATen/native/PointwiseProgram.h>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(pointwise_program_stub);
+
+} // namespace native
+} // namespace at
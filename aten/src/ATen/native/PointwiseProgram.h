@@ -0,0 +1,110 @@
+#pragma once
+
+#include <ATen/native/DispatchStub.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace at {
+namespace native {
+
+// Elementwise float operations of a PointwiseProgram. Each writes register
+// dst from registers a, b, c (see the comments for how they are used) and
+// the constant scalar.
+enum class PointwiseOp : uint8_t {
+  // dst = scalar
+  Fill,
+  // dst = scalars[a], a scalar argument of the launch
+  ScalarArg,
+  // dst = f(a)
+  Abs,
+  Neg,
+  Reciprocal,
+  Relu,
+  Sigmoid,
+  Tanh,
+  Exp,
+  Expm1,
+  Log,
+  Log10,
+  Log1p,
+  Log2,
+  Sqrt,
+  Rsqrt,
+  Sin,
+  Cos,
+  Tan,
+  Asin,
+  Acos,
+  Atan,
+  Erf,
+  Erfc,
+  Ceil,
+  Floor,
+  Round,
+  Trunc,
+  Frac,
+  // dst = a + scalar * b, a - scalar * b
+  Add,
+  Sub,
+  // dst = f(a, b)
+  Mul,
+  Div,
+  Pow,
+  Atan2,
+  // fmin / fmax: a NaN operand is ignored in favor of the other one
+  Min,
+  Max,
+  // dst = a + scalar * b * c
+  Addcmul,
+  // dst = a + c * (b - a)
+  Lerp,
+  // dst = a clamped to [b, c], with -1 for a missing bound
+  Clamp,
+  // dst = a <= b ? c : a
+  Threshold,
+  // dst = a * b * (1 - b), the gradient a through sigmoid output b
+  SigmoidBackward,
+  // dst = a * (1 - b * b), the gradient a through tanh output b
+  TanhBackward,
+};
+
+struct PointwiseInstruction {
+  PointwiseOp op;
+  int32_t dst;
+  int32_t a;
+  int32_t b;
+  int32_t c;
+  float scalar;
+};
+
+// A straight-line program over registers of n floats. Registers
+// [0, num_inputs) are the inputs of the launch and are never written; the
+// remaining registers are scratch, except that a register listed in outputs
+// may be written straight into that output.
+struct PointwiseProgram {
+  int32_t num_inputs = 0;
+  int32_t num_registers = 0;
+  std::vector<PointwiseInstruction> instructions;
+  // register holding each output once the program has run
+  std::vector<int32_t> outputs;
+};
+
+// Number of elements a single call of pointwise_program_stub should cover,
+// sized so that all registers of a typical program stay in L1.
+constexpr int64_t kPointwiseProgramBlockSize = 512;
+
+// Runs program on n contiguous elements of each input and output. scratch
+// holds at least (program.num_registers - program.num_inputs) * n floats.
+using pointwise_program_fn = void (*)(
+    const PointwiseProgram& program,
+    int64_t n,
+    const float* const* inputs,
+    const float* scalars,
+    float* const* outputs,
+    float* scratch);
+
+DECLARE_DISPATCH(pointwise_program_fn, pointwise_program_stub);
+
+} // namespace native
+} // namespace at
@@ -1,12 +1,18 @@
 #include <ATen/native/RNN.h>
 
 #include <ATen/ATen.h>
+#include <ATen/Config.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/core/grad_mode.h>
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
 #include <ATen/native/c10_utils.h>
 
+#if AT_MKL_ENABLED()
+#include <mkl.h>
+#endif
+
 namespace at { namespace native {
 
 namespace {
@@ -377,6 +383,182 @@ tpair_of<Tensor> hidden_slice(const tpair_of<Tensor>& t, int64_t start, int64_t
                          hidden_slice(std::get<1>(t), start, end));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// FUSED CPU CELLS
+//
+// The CPU layers compute the input projections for all timesteps as a single
+// GEMM before stepping through the sequence. When no gradient is needed, LSTM
+// and GRU layers with plain CellParams can additionally skip the chain of
+// pointwise ops in their cells: each step does one GEMM against w_hh into a
+// workspace that is reused across steps, and a single vectorized kernel
+// applies the gate nonlinearities and writes the new hidden state straight
+// into the layer output. With MKL, w_hh is packed once per layer for float.
+
+bool use_fused_cpu_cell(const Tensor& inputs_w, const CellParams& params,
+                        at::ArrayRef<Tensor> hiddens, int64_t num_gates) {
+  if (!inputs_w.device().is_cpu() || inputs_w.dim() != 3 || inputs_w.size(0) == 0) {
+    return false;
+  }
+  const auto dtype = inputs_w.scalar_type();
+  if (dtype != at::kFloat && dtype != at::kDouble) {
+    return false;
+  }
+  const int64_t batch = inputs_w.size(1);
+  const int64_t hidden_size = params.w_hh.size(-1);
+  if (params.w_hh.dim() != 2 || params.w_hh.scalar_type() != dtype ||
+      params.w_hh.size(0) != num_gates * hidden_size ||
+      inputs_w.size(2) != num_gates * hidden_size) {
+    return false;
+  }
+  if (params.b_hh.defined() && (params.b_hh.scalar_type() != dtype ||
+                                params.b_hh.numel() != num_gates * hidden_size)) {
+    return false;
+  }
+  bool requires_grad = inputs_w.requires_grad() || params.w_hh.requires_grad() ||
+      (params.b_hh.defined() && params.b_hh.requires_grad());
+  for (const auto& h : hiddens) {
+    if (!h.device().is_cpu() || h.scalar_type() != dtype ||
+        h.sizes() != IntArrayRef({batch, hidden_size})) {
+      return false;
+    }
+    requires_grad |= h.requires_grad();
+  }
+  return !(at::GradMode::is_enabled() && requires_grad);
+}
+
+// Computes out = bias + h @ w_hh^T for every step of a layer. bias is either
+// a (batch, gates * hidden) tensor, the (gates * hidden) b_hh, or undefined.
+struct HiddenGemm {
+  HiddenGemm(const Tensor& w_hh, int64_t batch) : w_hh_(w_hh) {
+#if AT_MKL_ENABLED()
+    if (w_hh.scalar_type() == at::kFloat) {
+      const auto w = w_hh.contiguous();
+      m_ = batch;
+      n_ = w.size(0);
+      k_ = w.size(1);
+      packed_ = cblas_sgemm_alloc(CblasBMatrix, m_, n_, k_);
+      cblas_sgemm_pack(CblasRowMajor, CblasBMatrix, CblasTrans, m_, n_, k_,
+                       1.0f, w.data_ptr<float>(), k_, packed_);
+    }
+#endif
+  }
+
+  ~HiddenGemm() {
+#if AT_MKL_ENABLED()
+    if (packed_) {
+      cblas_sgemm_free(packed_);
+    }
+#endif
+  }
+
+  HiddenGemm(const HiddenGemm&) = delete;
+  HiddenGemm& operator=(const HiddenGemm&) = delete;
+
+  void operator()(Tensor& out, const Tensor& bias, const Tensor& h) const {
+#if AT_MKL_ENABLED()
+    if (packed_) {
+      float beta = 0.0f;
+      if (bias.defined()) {
+        out.copy_(bias);
+        beta = 1.0f;
+      }
+      cblas_sgemm_compute(CblasRowMajor, CblasNoTrans, CblasPacked, m_, n_, k_,
+                          h.data_ptr<float>(), k_, packed_, k_, beta,
+                          out.data_ptr<float>(), n_);
+      return;
+    }
+#endif
+    if (bias.defined()) {
+      at::addmm_out(out, bias, h, w_hh_.t());
+    } else {
+      at::mm_out(out, h, w_hh_.t());
+    }
+  }
+
+ private:
+  const Tensor& w_hh_;
+#if AT_MKL_ENABLED()
+  float* packed_ = nullptr;
+  MKL_INT m_ = 0;
+  MKL_INT n_ = 0;
+  MKL_INT k_ = 0;
+#endif
+};
+
+// inputs_w holds the input projections (b_ih included) of every timestep.
+// Fills output with the hidden state of each step, indexed by the original
+// timestep even when the sequence is walked in reverse.
+template <typename cell_params>
+bool lstm_fused_sequence(const Tensor&, const tpair_of<Tensor>&, const cell_params&,
+                         bool, Tensor&, tpair_of<Tensor>&) {
+  return false;
+}
+
+bool lstm_fused_sequence(const Tensor& inputs_w, const tpair_of<Tensor>& hidden,
+                         const CellParams& params, bool reverse, Tensor& output,
+                         tpair_of<Tensor>& final_hidden) {
+  if (!use_fused_cpu_cell(inputs_w, params, {std::get<0>(hidden), std::get<1>(hidden)}, 4)) {
+    return false;
+  }
+  const int64_t seq_len = inputs_w.size(0);
+  const int64_t batch = inputs_w.size(1);
+  const int64_t hidden_size = params.w_hh.size(1);
+  // b_hh is added to every step, so fold it into the input projections once.
+  const auto step_inputs = params.b_hh.defined()
+      ? inputs_w.add(params.b_hh).contiguous() : inputs_w.contiguous();
+  output = at::empty({seq_len, batch, hidden_size}, inputs_w.options());
+  auto gates = at::empty({batch, 4 * hidden_size}, inputs_w.options());
+  Tensor cy_buffers[2] = {at::empty({batch, hidden_size}, inputs_w.options()),
+                          at::empty({batch, hidden_size}, inputs_w.options())};
+  HiddenGemm gemm(params.w_hh, batch);
+  auto hx = std::get<0>(hidden).contiguous();
+  auto cx = std::get<1>(hidden).contiguous();
+  for (int64_t step = 0; step < seq_len; ++step) {
+    const int64_t t = reverse ? seq_len - 1 - step : step;
+    gemm(gates, step_inputs[t], hx);
+    auto hy = output[t];
+    auto& cy = cy_buffers[step % 2];
+    lstm_cell_pointwise_stub(kCPU, hy, cy, gates, cx);
+    hx = hy;
+    cx = cy;
+  }
+  final_hidden = std::make_tuple(std::move(hx), std::move(cx));
+  return true;
+}
+
+template <typename cell_params>
+bool gru_fused_sequence(const Tensor&, const Tensor&, const cell_params&,
+                        bool, Tensor&, Tensor&) {
+  return false;
+}
+
+bool gru_fused_sequence(const Tensor& inputs_w, const Tensor& hidden,
+                        const CellParams& params, bool reverse, Tensor& output,
+                        Tensor& final_hidden) {
+  if (!use_fused_cpu_cell(inputs_w, params, {hidden}, 3)) {
+    return false;
+  }
+  const int64_t seq_len = inputs_w.size(0);
+  const int64_t batch = inputs_w.size(1);
+  const int64_t hidden_size = params.w_hh.size(1);
+  // The new gate scales the hidden projection by the reset gate, so b_hh has
+  // to stay with the hidden projection rather than being folded into inputs_w.
+  const auto step_inputs = inputs_w.contiguous();
+  output = at::empty({seq_len, batch, hidden_size}, inputs_w.options());
+  auto hgates = at::empty({batch, 3 * hidden_size}, inputs_w.options());
+  HiddenGemm gemm(params.w_hh, batch);
+  auto hx = hidden.contiguous();
+  for (int64_t step = 0; step < seq_len; ++step) {
+    const int64_t t = reverse ? seq_len - 1 - step : step;
+    gemm(hgates, params.b_hh, hx);
+    auto hy = output[t];
+    gru_cell_pointwise_stub(kCPU, hy, step_inputs[t], hgates, hx);
+    hx = hy;
+  }
+  final_hidden = std::move(hx);
+  return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // CELL IMPLEMENTATIONS
 //
@@ -402,6 +584,19 @@ struct Cell {
       const hidden_type& hidden,
       const cell_params& params,
       bool pre_compute_input = false) const = 0;
+
+  // Runs the cell over a whole (seq_len, batch, gates * hidden) sequence of
+  // input projections in one go. Returns false if the cell has no fused path
+  // for these arguments, in which case the caller steps through operator().
+  virtual bool fused_sequence(
+      const Tensor& /* inputs_w */,
+      const hidden_type& /* hidden */,
+      const cell_params& /* params */,
+      bool /* reverse */,
+      Tensor& /* output */,
+      hidden_type& /* final_hidden */) const {
+    return false;
+  }
 };
 
 template<typename nonlinearity, typename cell_params>
@@ -452,6 +647,15 @@ struct LSTMCell : Cell<std::tuple<Tensor, Tensor>, cell_params> {
     return std::make_tuple(std::move(hy), std::move(cy));
   }
 
+  bool fused_sequence(
+      const Tensor& inputs_w,
+      const hidden_type& hidden,
+      const cell_params& params,
+      bool reverse,
+      Tensor& output,
+      hidden_type& final_hidden) const override {
+    return lstm_fused_sequence(inputs_w, hidden, params, reverse, output, final_hidden);
+  }
 };
 
 template <typename cell_params>
@@ -484,6 +688,16 @@ struct GRUCell : Cell<Tensor, cell_params> {
         chunked_igates[2].add(chunked_hgates[2].mul_(reset_gate)).tanh_();
     return (hidden - new_gate).mul_(input_gate).add_(new_gate);
   }
+
+  bool fused_sequence(
+      const Tensor& inputs_w,
+      const hidden_type& hidden,
+      const cell_params& params,
+      bool reverse,
+      Tensor& output,
+      hidden_type& final_hidden) const override {
+    return gru_fused_sequence(inputs_w, hidden, params, reverse, output, final_hidden);
+  }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -544,6 +758,12 @@ struct FullLayer : Layer<Tensor, hidden_type, cell_params> {
       const cell_params& params) const override {
     if (inputs.device().is_cpu()) {
       const auto inputs_w = params.linear_ih(inputs);
+      Tensor output;
+      hidden_type final_hidden;
+      if (cell_.fused_sequence(inputs_w, input_hidden, params,
+                               /*reverse=*/false, output, final_hidden)) {
+        return {output, final_hidden};
+      }
       auto unstacked_output =
           (*this)(inputs_w.unbind(0), input_hidden, params, true);
       return {at::stack(unstacked_output.outputs, 0),
@@ -574,6 +794,17 @@ struct FullBidirectionalLayer
     std::vector<Tensor> step_inputs;
     if (input.device().is_cpu()) {
       auto input_w = params.first.linear_ih(input);
+      Tensor fused_fw_output, fused_rev_output;
+      dir_hidden_type fw_hidden, rev_hidden;
+      if (layer_.cell_.fused_sequence(input_w, input_hidden.first, params.first,
+                                      /*reverse=*/false, fused_fw_output, fw_hidden)) {
+        auto rev_input_w = params.second.linear_ih(input);
+        if (layer_.cell_.fused_sequence(rev_input_w, input_hidden.second, params.second,
+                                        /*reverse=*/true, fused_rev_output, rev_hidden)) {
+          return {at::cat({fused_fw_output, fused_rev_output}, fused_fw_output.dim() - 1),
+                  std::make_pair(fw_hidden, rev_hidden)};
+        }
+      }
       step_inputs = input_w.unbind(0);
       auto fw_result = layer_(
           step_inputs, input_hidden.first, params.first, true);
@@ -932,65 +1163,14 @@ std::tuple<Tensor, Tensor> NAME(                                               \
   return std::make_tuple(std::move(packed_output.data), std::move(std::get<1>(result)));             \
 }
 
-#define ONE_HIDDEN_QRNN(NAME, CELL)                                             \
-std::tuple<Tensor, Tensor> NAME(                                               \
-    const Tensor& _input, \
-    const Tensor& hx, \
-    TensorList _params, \
-    bool has_biases, \
-    int64_t num_layers, \
-    double dropout_p,  \
-    bool train, \
-    bool bidirectional, \
-    bool batch_first) { \
-  if (at::cudnn_is_acceptable(_input)) {                                       \
-    Tensor output, hy;                                                         \
-    gru_cudnn_stub(_input.device().type(), output, hy, _input, hx, _params, has_biases, \
-            num_layers, dropout_p, train, bidirectional, batch_first);         \
-    return std::make_tuple(std::move(output), std::move(hy));                  \
-  }                                                                            \
-  check_device(_input, _params, hx); \
-  auto input = batch_first ? _input.transpose(0, 1) : _input;                  \
-  auto params = gather_quantized_params(_params);                            \
-  auto results = _rnn_impl_with_concat<CELL, FullLayer, FullBidirectionalLayer>( \
-      input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional); \
-  if (batch_first) {                                                           \
-    std::get<0>(results).transpose_(0, 1);               \
-  }                                                                            \
-  return results;                                                              \
-}                                                                              \
-                                                                               \
-std::tuple<Tensor, Tensor> NAME(                                               \
-    const Tensor& data, \
-    const Tensor& batch_sizes, \
-    const Tensor& hx, \
-    TensorList _params, \
-    bool has_biases, \
-    int64_t num_layers, \
-    double dropout_p, \
-    bool train, \
-    bool bidirectional) {  \
-  if (at::cudnn_is_acceptable(data)) {                                         \
-    Tensor output, hy;                                                         \
-    gru_packed_cudnn_stub(data.device().type(), output, hy, data, batch_sizes, hx, \
-            _params, has_biases, num_layers, dropout_p, train, bidirectional); \
-    return std::make_tuple(std::move(output), std::move(hy));                                        \
-  }                                                                            \
-  PackedSequence input { data, batch_sizes };                                  \
-  auto params = gather_quantized_params(_params);                            \
-  auto result = _rnn_impl_with_concat<CELL, PackedLayer, PackedBidirectionalLayer>( \
-          input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional); \
-  auto & packed_output = std::get<0>(result);                                  \
-  return std::make_tuple(std::move(packed_output.data), std::move(std::get<1>(result)));             \
-}
-
 ONE_HIDDEN_RNN(gru, GRUCell<CellParams>)
-ONE_HIDDEN_QRNN(quantized_gru, GRUCell<QuantizedCellParams>)
 using tanf_cell_type = SimpleCell<tanh_f, CellParams>;
 ONE_HIDDEN_RNN(rnn_tanh, tanf_cell_type)
 using relu_cell_type = SimpleCell<relu_f, CellParams>;
 ONE_HIDDEN_RNN(rnn_relu, relu_cell_type);
 
+DEFINE_DISPATCH(lstm_cell_pointwise_stub);
+DEFINE_DISPATCH(gru_cell_pointwise_stub);
 DEFINE_DISPATCH(lstm_cudnn_stub);
 DEFINE_DISPATCH(lstm_packed_cudnn_stub);
 DEFINE_DISPATCH(lstm_miopen_stub);
@@ -1266,6 +1446,87 @@ std::tuple<Tensor, Tensor, Tensor> quantized_lstm(
                          std::move(std::get<2>(results)));
 }
 
+std::tuple<Tensor, Tensor> quantized_gru(
+      const Tensor& _input, const Tensor& hx,
+      TensorList _params, bool has_biases,
+      int64_t num_layers, double dropout_p, bool train, bool bidirectional,
+      bool batch_first, c10::optional<ScalarType> dtype, bool use_dynamic) {
+  if (at::cudnn_is_acceptable(_input)) {
+    Tensor output, hy;
+    gru_cudnn_stub(_input.device().type(), output, hy, _input, hx, _params, has_biases,
+                   num_layers, dropout_p, train, bidirectional, batch_first);
+    return std::make_tuple(std::move(output), std::move(hy));
+  }
+  auto result_dtype = dtype.has_value() ? dtype.value() : at::kChar;
+  check_device(_input, _params, hx);
+  auto input = batch_first ? _input.transpose(0, 1) : _input;
+  TORCH_CHECK(
+      result_dtype == at::kChar || result_dtype == at::kQInt8 ||
+          result_dtype == at::kHalf,
+      "dtype is not supported");
+
+  std::tuple<Tensor, Tensor> results;
+  if (result_dtype == at::kChar || result_dtype == at::kQInt8) {
+    if (use_dynamic) {
+      TORCH_CHECK(has_biases, "dynamic quantized GRU requires biases");
+      auto params = gather_quantized_params_dynamic(_params);
+      results = _rnn_impl_with_concat<GRUCell<QuantizedCellParamsDynamic>, FullLayer, FullBidirectionalLayer>(
+          input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional);
+    } else {
+      auto params = gather_quantized_params(_params);
+      results = _rnn_impl_with_concat<GRUCell<QuantizedCellParams>, FullLayer, FullBidirectionalLayer>(
+          input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional);
+    }
+  } else {
+    TORCH_CHECK(has_biases, "quantized GRU with float16 weights requires biases");
+    auto params = gather_quantized_params_fp16(_params);
+    results = _rnn_impl_with_concat<GRUCell<QuantizedCellParamsFP16>, FullLayer, FullBidirectionalLayer>(
+        input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional);
+  }
+
+  if (batch_first) {
+    std::get<0>(results).transpose_(0, 1);
+  }
+  return results;
+}
+
+std::tuple<Tensor, Tensor> quantized_gru(
+      const Tensor& data, const Tensor& batch_sizes, const Tensor& hx,
+      TensorList _params, bool has_biases,
+      int64_t num_layers, double dropout_p, bool train, bool bidirectional,
+      c10::optional<ScalarType> dtype, bool use_dynamic) {
+  if (at::cudnn_is_acceptable(data)) {
+    Tensor output, hy;
+    gru_packed_cudnn_stub(data.device().type(), output, hy, data, batch_sizes, hx,
+                          _params, has_biases, num_layers, dropout_p, train, bidirectional);
+    return std::make_tuple(std::move(output), std::move(hy));
+  }
+
+  auto result_dtype = dtype.has_value() ? dtype.value() : at::kChar;
+
+  PackedSequence input { data, batch_sizes };
+  std::tuple<PackedSequence, Tensor> results;
+  if (result_dtype == at::kChar || result_dtype == at::kQInt8) {
+    if (use_dynamic) {
+      TORCH_CHECK(has_biases, "dynamic quantized GRU requires biases");
+      auto params = gather_quantized_params_dynamic(_params);
+      results = _rnn_impl_with_concat<GRUCell<QuantizedCellParamsDynamic>, PackedLayer, PackedBidirectionalLayer>(
+          input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional);
+    } else {
+      auto params = gather_quantized_params(_params);
+      results = _rnn_impl_with_concat<GRUCell<QuantizedCellParams>, PackedLayer, PackedBidirectionalLayer>(
+          input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional);
+    }
+  } else {
+    TORCH_CHECK(has_biases, "quantized GRU with float16 weights requires biases");
+    auto params = gather_quantized_params_fp16(_params);
+    results = _rnn_impl_with_concat<GRUCell<QuantizedCellParamsFP16>, PackedLayer, PackedBidirectionalLayer>(
+        input, params, hx.unbind(0), num_layers, dropout_p, train, bidirectional);
+  }
+  auto & packed_output = std::get<0>(results);
+  return std::make_tuple(std::move(packed_output.data), std::move(std::get<1>(results)));
+}
+
 #define DEFINE_QUANTIZED_RNN_CELL(name, hx_type, cell_type, return_type, prepare_hx_fn) \
 return_type name( \
     const Tensor& input, \
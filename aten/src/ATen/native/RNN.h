@@ -27,6 +27,15 @@ DECLARE_DISPATCH(rnn_packed_fn, rnn_tanh_packed_miopen_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_cudnn_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_miopen_stub);
 
+// Pointwise halves of the fused CPU LSTM and GRU cells. The gate
+// pre-activations are computed with a GEMM beforehand; all tensors are
+// contiguous and (batch, gates * hidden) or (batch, hidden).
+using lstm_cell_pointwise_fn = void(*)(Tensor& hy, Tensor& cy, const Tensor& gates, const Tensor& cx);
+using gru_cell_pointwise_fn = void(*)(Tensor& hy, const Tensor& igates, const Tensor& hgates, const Tensor& hx);
+
+DECLARE_DISPATCH(lstm_cell_pointwise_fn, lstm_cell_pointwise_stub);
+DECLARE_DISPATCH(gru_cell_pointwise_fn, gru_cell_pointwise_stub);
+
 inline void check_device(const Tensor& input, const TensorList& params, const TensorList& hiddens) {
   auto input_device = input.device();
 
@@ -31,6 +31,9 @@ DEFINE_DISPATCH(min_values_stub);
 DEFINE_DISPATCH(max_values_stub);
 DEFINE_DISPATCH(argmax_stub);
 DEFINE_DISPATCH(argmin_stub);
+DEFINE_DISPATCH(aminmax_stub);
+DEFINE_DISPATCH(cumsum_stub);
+DEFINE_DISPATCH(cumprod_stub);
 
 #define OPTION_TYPE_EQUALITY_CHECK(option, out, self) \
 { \
@@ -232,6 +235,51 @@ Tensor& cumprod_out(Tensor& result, const Tensor& self, int64_t dim, c10::option
   return result;
 }
 
+template <typename Stub>
+static Tensor& cumulative_out_cpu(
+    Tensor& result, const Tensor& self, int64_t dim, Stub& stub, const char* name) {
+  TORCH_CHECK(result.scalar_type() == self.scalar_type(),
+      name, "(): expected result to have dtype ", self.scalar_type(),
+      " but got ", result.scalar_type());
+  const int64_t wrapped_dim = maybe_wrap_dim(dim, self.dim());
+  result.resize_(self.sizes());
+  if (self.numel() == 0) {
+    return result;
+  }
+  if (self.dim() == 0) {
+    return result.copy_(self);
+  }
+  // the kernel scans the rows in order, so result may alias self as long as
+  // both are contiguous
+  auto input = self.contiguous();
+  if (result.is_contiguous()) {
+    stub(kCPU, result, input, wrapped_dim);
+  } else {
+    auto contiguous_result = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+    stub(kCPU, contiguous_result, input, wrapped_dim);
+    result.copy_(contiguous_result);
+  }
+  return result;
+}
+
+Tensor& _cumsum_out_cpu(Tensor& result, const Tensor& self, int64_t dim) {
+  return cumulative_out_cpu(result, self, dim, cumsum_stub, "cumsum");
+}
+
+Tensor _cumsum_cpu(const Tensor& self, int64_t dim) {
+  Tensor result = at::empty({0}, self.options());
+  return _cumsum_out_cpu(result, self, dim);
+}
+
+Tensor& _cumprod_out_cpu(Tensor& result, const Tensor& self, int64_t dim) {
+  return cumulative_out_cpu(result, self, dim, cumprod_stub, "cumprod");
+}
+
+Tensor _cumprod_cpu(const Tensor& self, int64_t dim) {
+  Tensor result = at::empty({0}, self.options());
+  return _cumprod_out_cpu(result, self, dim);
+}
+
 std::tuple<Tensor&, Tensor&> cummax_out(Tensor& values, Tensor& indices, const Tensor& self, int64_t dim) {
   check_scalar_type_device_layout_equal(values, self);
   check_scalar_type_device_layout_equal(indices, at::empty({0}, self.options().dtype(at::kLong)));
@@ -726,6 +774,26 @@ Tensor argmin(const Tensor& self, c10::optional<int64_t> dim, bool keepdims) {
   return at::native::argmin_out(result, self, dim, keepdims);
 }
 
+static std::tuple<Tensor, Tensor> aminmax_impl(const Tensor& self, IntArrayRef dims, bool keepdim) {
+  TORCH_CHECK(self.numel() > 0, "cannot perform reduction function aminmax on a "
+      "tensor with no elements because the operation does not have an identity");
+  TORCH_CHECK(!at::isComplexType(self.scalar_type()) && self.scalar_type() != kBool,
+      "aminmax is not supported for ", toString(self.scalar_type()));
+  Tensor min = at::empty({0}, self.options());
+  Tensor max = at::empty({0}, self.options());
+  auto iter = make_reduction("aminmax", min, max, self, dims, keepdim, self.scalar_type());
+  aminmax_stub(iter.device_type(), iter);
+  return std::make_tuple(min, max);
+}
+
+std::tuple<Tensor, Tensor> _aminmax(const Tensor& self, int64_t dim, bool keepdim) {
+  return aminmax_impl(self, {dim}, keepdim);
+}
+
+std::tuple<Tensor, Tensor> _aminmax_all(const Tensor& self) {
+  return aminmax_impl(self, {}, false);
+}
+
 static Tensor &std_var_out(Tensor &result, const Tensor &self, IntArrayRef dim, bool unbiased, bool keepdim, bool take_sqrt) {
   TORCH_CHECK(self.device().type() == DeviceType::CPU || self.device().type() == DeviceType::CUDA,
               "std and var only supports CPU AND CUDA device type, got: ", self.device().type());
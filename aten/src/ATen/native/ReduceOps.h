@@ -21,6 +21,7 @@ DECLARE_DISPATCH(reduce_fn, min_values_stub);
 DECLARE_DISPATCH(reduce_fn, max_values_stub);
 DECLARE_DISPATCH(reduce_fn, argmax_stub);
 DECLARE_DISPATCH(reduce_fn, argmin_stub);
+DECLARE_DISPATCH(reduce_fn, aminmax_stub);
 
 using reduce_std_var_function =
   void (*)(TensorIterator&, bool unbiased, bool take_sqrt);
@@ -33,4 +34,8 @@ DECLARE_DISPATCH(reduce_norm_fn, norm_kernel);
 using reduce_fn_flag = void(*)(TensorIterator &, Scalar);
 DECLARE_DISPATCH(reduce_fn_flag, norm_stub);
 
+using cum_fn = void(*)(Tensor& result, const Tensor& self, int64_t dim);
+DECLARE_DISPATCH(cum_fn, cumsum_stub);
+DECLARE_DISPATCH(cum_fn, cumprod_stub);
+
 }} // namespace at::native
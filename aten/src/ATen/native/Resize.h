@@ -9,7 +9,14 @@ namespace at { namespace native {
 // They are not in TH/THTensor.cpp because the at namespace is easier
 // to benchmark than TH; I can't get gbenchmark to call fns from THTensor.cpp
 
-static inline void maybe_resize_storage_cpu(TensorImpl* self, int64_t new_size) {
+// When a storage is reallocated by an amortized resize, it grows to at least
+// this many times its previous size.
+constexpr double kAmortizedStorageGrowthFactor = 1.5;
+
+static inline void maybe_resize_storage_cpu(
+    TensorImpl* self,
+    int64_t new_size,
+    bool amortized = false) {
   // It does not make sense to try to resize a storage
   // to hold 0 elements, and this can break
   // if storage_offset is positive but
@@ -20,9 +27,14 @@ static inline void maybe_resize_storage_cpu(TensorImpl* self, int64_t new_size)
       THTensor_stealAndSetStoragePtr(self, THStorage_new(self->dtype()));
     }
     if (new_size + self->storage_offset() > self->storage().numel()) {
-      THStorage_resize(
-          THTensor_getStoragePtr(self),
-          new_size + self->storage_offset());
+      int64_t storage_size = new_size + self->storage_offset();
+      if (amortized) {
+        storage_size = std::max(
+            storage_size,
+            static_cast<int64_t>(
+                self->storage().numel() * kAmortizedStorageGrowthFactor));
+      }
+      THStorage_resize(THTensor_getStoragePtr(self), storage_size);
     }
   }
 }
@@ -30,7 +42,8 @@ static inline void maybe_resize_storage_cpu(TensorImpl* self, int64_t new_size)
 inline TensorImpl* resize_impl_cpu_(
     TensorImpl* self,
     IntArrayRef size,
-    c10::optional<IntArrayRef> stride) {
+    c10::optional<IntArrayRef> stride,
+    bool amortized = false) {
   if (self->sizes() == size && (!stride || self->strides() == stride)) {
     return self;
   }
@@ -52,11 +65,28 @@ inline TensorImpl* resize_impl_cpu_(
     self->set_sizes_contiguous(size);
     storage_size = self->numel();
   }
-  maybe_resize_storage_cpu(self, storage_size);
+  maybe_resize_storage_cpu(self, storage_size, amortized);
 
   return self;
 }
 
+// Resizes the output of a CPU out= kernel to a contiguous `size`, like
+// resize_, except that a storage that has to be reallocated grows
+// geometrically. An output that is reused across calls while growing a little
+// on each of them, e.g. when a loop accumulates its results with cat(out=), is
+// then only reallocated a logarithmic number of times. The spare capacity
+// stays allocated for as long as the storage is alive, so only kernels whose
+// outputs typically grow across calls should use this.
+inline void resize_output_amortized_cpu_(Tensor& output, IntArrayRef size) {
+  if (output.has_names() || output.layout() != kStrided ||
+      !output.device().is_cpu() || output.is_quantized()) {
+    output.resize_(size);
+    return;
+  }
+  resize_impl_cpu_(
+      output.unsafeGetTensorImpl(), size, /*stride=*/c10::nullopt, /*amortized=*/true);
+}
+
 static inline void checkInBoundsForStorage(
     IntArrayRef size,
     IntArrayRef stride,
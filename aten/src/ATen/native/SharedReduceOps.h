@@ -336,6 +336,33 @@ struct ArgMinOps :
   public detail::ArgReductionOps<detail::LessOrNan<scalar_t>> {
 };
 
+// Min and max in one pass. A NaN in the input becomes both results.
+template <typename scalar_t, typename acc_scalar_t, typename res_t>
+struct MinMaxOps {
+  using acc_t = detail::pair<acc_scalar_t, acc_scalar_t>;
+
+  inline C10_DEVICE acc_t reduce(acc_t acc, scalar_t data, int64_t /*idx*/) const {
+    return combine(acc, acc_t(data, data));
+  }
+
+  inline C10_DEVICE acc_t combine(acc_t a, acc_t b) const {
+    return acc_t(
+      detail::LessOrNan<acc_scalar_t>{}(a.first, b.first) ? a.first : b.first,
+      detail::GreaterOrNan<acc_scalar_t>{}(a.second, b.second) ? a.second : b.second);
+  }
+
+  inline C10_DEVICE res_t project(acc_t acc) const {
+    return res_t((scalar_t) acc.first, (scalar_t) acc.second);
+  }
+
+#if defined(__CUDACC__) || defined(__HIPCC__)
+  inline C10_DEVICE acc_t warp_shfl_down(acc_t acc, int offset) const {
+    return acc_t(WARP_SHFL_DOWN(acc.first, offset),
+                 WARP_SHFL_DOWN(acc.second, offset));
+  }
+#endif
+};
+
 }} // namespace at::native
 
 #undef MAX
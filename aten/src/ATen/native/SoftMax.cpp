@@ -4,6 +4,7 @@
 #include <ATen/Parallel.h>
 #include <ATen/TensorUtils.h>
 #include <ATen/WrapDimUtils.h>
+#include <ATen/native/SoftMax.h>
 #include <ATen/native/cpu/SoftmaxKernel.h>
 #include <ATen/NamedTensorUtils.h>
 
@@ -134,9 +135,9 @@ Tensor softmax_cpu(const Tensor& input_, const int64_t dim_, const bool half_to_
   if (input.ndimension() > 0 && dim == input.ndimension() - 1) {
     softmax_lastdim_kernel(kCPU, output, input);
   } else {
-    AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "softmax", [&] {
-      host_softmax<scalar_t, false>(output, input, dim);
-    });
+    AT_DISPATCH_FLOATING_TYPES_AND(
+        at::ScalarType::BFloat16, input.scalar_type(), "softmax",
+        [&] { host_softmax<scalar_t, false>(output, input, dim); });
   }
   return output;
 }
@@ -190,9 +191,11 @@ Tensor softmax_backward_cpu(
   if (grad.ndimension() > 0 && dim == grad.ndimension() - 1) {
     softmax_backward_lastdim_kernel(kCPU, grad_input, grad, output);
   } else {
-    AT_DISPATCH_FLOATING_TYPES(grad.scalar_type(), "softmax_backward", [&] {
-      host_softmax_backward<scalar_t, false>(grad_input, grad, output, dim);
-    });
+    AT_DISPATCH_FLOATING_TYPES_AND(at::ScalarType::BFloat16, grad.scalar_type(),
+                                   "softmax_backward", [&] {
+                                     host_softmax_backward<scalar_t, false>(
+                                         grad_input, grad, output, dim);
+                                   });
   }
   return grad_input;
 }
@@ -281,6 +284,45 @@ DEFINE_DISPATCH(softmax_lastdim_kernel);
 DEFINE_DISPATCH(log_softmax_lastdim_kernel);
 DEFINE_DISPATCH(softmax_backward_lastdim_kernel);
 DEFINE_DISPATCH(log_softmax_backward_lastdim_kernel);
+DEFINE_DISPATCH(softmax_cross_entropy_kernel);
+DEFINE_DISPATCH(softmax_cross_entropy_backward_kernel);
+
+Tensor softmax_cross_entropy(const Tensor& self, const Tensor& target, int64_t reduction, int64_t ignore_index) {
+  Tensor losses = std::get<0>(at::_softmax_cross_entropy(self, target, ignore_index));
+  if (reduction == Reduction::Mean) {
+    // like nll_loss, average over the targets that are not ignored
+    return losses.sum() / target.ne(ignore_index).sum().to(losses.scalar_type());
+  } else if (reduction == Reduction::Sum) {
+    return losses.sum();
+  }
+  return losses;
+}
+
+std::tuple<Tensor, Tensor> softmax_cross_entropy_cpu(const Tensor& self, const Tensor& target, int64_t ignore_index) {
+  check_softmax_cross_entropy_inputs(self, target);
+  auto input = self.expect_contiguous();
+  auto target_ = target.expect_contiguous();
+  Tensor losses = at::empty({self.size(0)}, self.options());
+  Tensor logsumexp = at::empty({self.size(0)}, self.options());
+  if (self.size(0) > 0) {
+    softmax_cross_entropy_kernel(kCPU, losses, logsumexp, *input, *target_, ignore_index);
+  }
+  return std::make_tuple(losses, logsumexp);
+}
+
+Tensor softmax_cross_entropy_backward_cpu(const Tensor& grad, const Tensor& self, const Tensor& target,
+                                          const Tensor& logsumexp, int64_t ignore_index) {
+  check_softmax_cross_entropy_inputs(self, target);
+  auto input = self.expect_contiguous();
+  auto target_ = target.expect_contiguous();
+  auto logsumexp_ = logsumexp.expect_contiguous();
+  Tensor grad_input = at::empty_like(*input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  if (self.size(0) > 0) {
+    softmax_cross_entropy_backward_kernel(
+        kCPU, grad_input, grad.contiguous(), *input, *target_, *logsumexp_, ignore_index);
+  }
+  return grad_input;
+}
 
 Tensor softmax(const Tensor& self, Dimname dim, optional<ScalarType> dtype) {
   return at::softmax(self, dimname_to_position(self, dim), dtype);
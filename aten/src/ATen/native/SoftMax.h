@@ -0,0 +1,17 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at { namespace native {
+
+// Shared by the CPU and CUDA implementations of _softmax_cross_entropy.
+static inline void check_softmax_cross_entropy_inputs(const Tensor& self, const Tensor& target) {
+  TORCH_CHECK(self.dim() == 2, "softmax_cross_entropy: expected input to be 2-D, but got ", self.dim(), "-D");
+  TORCH_CHECK(self.size(1) > 0, "softmax_cross_entropy: expected at least one class");
+  TORCH_CHECK(target.dim() == 1 && target.size(0) == self.size(0),
+              "softmax_cross_entropy: expected target of shape [", self.size(0), "], but got ", target.sizes());
+  TORCH_CHECK(target.scalar_type() == ScalarType::Long,
+              "softmax_cross_entropy: expected target of type Long, but got ", target.scalar_type());
+}
+
+}} // namespace at::native
@@ -220,6 +220,41 @@ std::tuple<Tensor, Tensor> topk(
   return std::make_tuple(values, indices);
 }
 
+std::tuple<Tensor&, Tensor&> sort_out_cpu(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim_,
+    bool descending) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim(), /*wrap_scalar=*/true);
+  TORCH_CHECK(
+      self.options().type_equal(values.options()),
+      "output values must be of same type as input");
+  TORCH_CHECK(
+      indices.scalar_type() == kLong,
+      "output indices must be of scalar type Long");
+
+  values.resize_as_(self).copy_(self);
+  indices.resize_(self.sizes());
+  if (self.dim() == 0 && self.numel() == 1) {
+    indices.zero_();
+    return std::forward_as_tuple(values, indices);
+  }
+
+  sort_stub(kCPU, values, indices, dim, descending);
+
+  return std::forward_as_tuple(values, indices);
+}
+
+std::tuple<Tensor, Tensor> sort_cpu(
+    const Tensor& self,
+    int64_t dim,
+    bool descending) {
+  Tensor values = at::empty({0}, self.options());
+  Tensor indices = at::empty({0}, self.options().dtype(kLong));
+  return sort_out_cpu(values, indices, self, dim, descending);
+}
+
 std::tuple<Tensor&, Tensor&> median_out(
     Tensor& values,
     Tensor& indices,
@@ -304,6 +339,7 @@ Tensor median_cpu(const Tensor& self) {
 }
 
 DEFINE_DISPATCH(topk_stub);
+DEFINE_DISPATCH(sort_stub);
 
 } // namespace native
 } // namespace at
@@ -9,4 +9,8 @@ using topk_fn = void(*)(Tensor&, Tensor&, const Tensor&, int64_t, int64_t, bool,
 
 DECLARE_DISPATCH(topk_fn, topk_stub);
 
+using sort_fn = void(*)(Tensor& values, Tensor& indices, int64_t dim, bool descending);
+
+DECLARE_DISPATCH(sort_fn, sort_stub);
+
 }} // at::native
@@ -16,6 +16,8 @@
 
 namespace at { namespace native {
 
+DEFINE_DISPATCH(fft_fill_with_conjugate_symmetry_stub);
+
 // This is a pass-through wrapper function that does the size check and
 // inferences. The actual forward implementation function is called
 // at::_fft_with_size which dispatches to _fft_cufft (CUDA) or _fft_mkl (CPU).
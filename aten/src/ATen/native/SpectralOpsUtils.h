@@ -4,6 +4,9 @@
 #include <stdexcept>
 #include <sstream>
 
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
 namespace at { namespace native {
 
 // NOTE [ Fourier Transform Conjugate Symmetry ]
@@ -55,4 +58,13 @@ inline int64_t infer_ft_complex_to_real_onesided_size(int64_t complex_size,
   }
 }
 
+// Fills in the values of a real-to-complex transform that FFT libraries leave
+// out, X[..., last_dim_start_slice:], from the onesided half using conjugate
+// symmetry. The input must be a contiguous batched tensor of the size of the
+// twosided transform; it is modified in place.
+using fft_fill_with_conjugate_symmetry_fn =
+    void (*)(Tensor& input, int64_t signal_ndim, int64_t size_last_dim,
+             int64_t last_dim_start_slice);
+DECLARE_DISPATCH(fft_fill_with_conjugate_symmetry_fn, fft_fill_with_conjugate_symmetry_stub);
+
 }} // at::native
@@ -57,6 +57,7 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/BinaryOps.h>
 #include <ATen/native/Copy.h>
+#include <ATen/native/Resize.h>
 #include <ATen/Parallel.h>
 
 #include <algorithm>
@@ -376,6 +377,33 @@ Tensor index_add(const Tensor & self, int64_t dim, const Tensor & index, const T
   return self.clone(at::MemoryFormat::Preserve).index_add_(dim, index, source);
 }
 
+// index_select of contiguous tensors along dim > 0: viewed as
+// [outer, self.size(dim), inner], every output row of `inner` elements is one
+// contiguous copy, and the outer rows and indices are split between threads.
+static void index_select_out_cpu_contiguous_(Tensor & result, const Tensor & self, int64_t dim,
+                                             const int64_t* index_data, int64_t numel) {
+  const auto self_dim_size = self.size(dim);
+  const auto inner = self.stride(dim);
+  const auto outer = self.numel() / (self_dim_size * inner);
+  for (int64_t i = 0; i < numel; i++) {
+    TORCH_CHECK_INDEX((index_data[i] >= 0) && (index_data[i] < self_dim_size), "index out of range in self");
+  }
+
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(at::ScalarType::Half, at::ScalarType::Bool, at::ScalarType::BFloat16,
+    self.scalar_type(), "index_select", [&] {
+    const scalar_t* self_data = self.data_ptr<scalar_t>();
+    scalar_t* result_data = result.data_ptr<scalar_t>();
+    at::parallel_for(0, outer * numel, std::max<int64_t>(1, at::internal::GRAIN_SIZE / inner),
+                     [&](int64_t start, int64_t end) {
+      for (int64_t row = start; row < end; row++) {
+        const int64_t o = row / numel;
+        const scalar_t* self_row = self_data + (o * self_dim_size + index_data[row % numel]) * inner;
+        std::copy(self_row, self_row + inner, result_data + row * inner);
+      }
+    });
+  });
+}
+
 Tensor & index_select_out_cpu_(Tensor & result, const Tensor & self, int64_t dim, const Tensor & index) {
   dim = maybe_wrap_dim(dim, self.dim());
 
@@ -391,7 +419,7 @@ Tensor & index_select_out_cpu_(Tensor & result, const Tensor & self, int64_t dim
   if (self.dim() > 0) {
     result_size[dim] = numel;
   }
-  result.resize_(result_size);
+  resize_output_amortized_cpu_(result, result_size);
 
   auto index_contig = index.contiguous();
   auto index_data = index_contig.data_ptr<int64_t>();
@@ -401,6 +429,11 @@ Tensor & index_select_out_cpu_(Tensor & result, const Tensor & self, int64_t dim
       return result;
     }
 
+    if (dim > 0 && self.is_contiguous() && result.is_contiguous()) {
+      index_select_out_cpu_contiguous_(result, self, dim, index_data, numel);
+      return result;
+    }
+
     auto selfSlice = self.select(dim, 0);
     auto resultSlice = result.select(dim, 0);
     auto selfSlice_data = selfSlice.data_ptr();
@@ -458,12 +491,16 @@ Tensor & index_select_out_cpu_(Tensor & result, const Tensor & self, int64_t dim
     AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "index_select", [&] {
       auto self_stride = self.dim() == 0 ? 1 : self.stride(dim);
       auto result_stride = result.dim() == 0 ? 1 : result.stride(dim);
-      for (auto i = 0; i < numel; i++) {
-        auto self_i = index_data[i];
-        TORCH_CHECK_INDEX((self_i >= 0) && (self_i < self.numel()), "index out of range in self");
-        scalar_t *self_ip = self.data_ptr<scalar_t>() + self_i * self_stride;
-        *(result.data_ptr<scalar_t>() + i * result_stride) = *self_ip;
-      }
+      auto self_numel = self.numel();
+      const scalar_t* self_data = self.data_ptr<scalar_t>();
+      scalar_t* result_data = result.data_ptr<scalar_t>();
+      at::parallel_for(0, numel, at::internal::GRAIN_SIZE, [&](int64_t start, int64_t end) {
+        for (int64_t i = start; i < end; i++) {
+          auto self_i = index_data[i];
+          TORCH_CHECK_INDEX((self_i >= 0) && (self_i < self_numel), "index out of range in self");
+          result_data[i * result_stride] = self_data[self_i * self_stride];
+        }
+      });
     });
   }
 
@@ -101,22 +101,27 @@ Tensor empty_cpu(IntArrayRef size, const TensorOptions& options, c10::optional<c
   TORCH_INTERNAL_ASSERT(impl::variable_excluded_from_dispatch());
   check_size_nonnegative(size);
 
-  c10::Allocator* allocator;
+  int64_t nelements = prod_intlist(size);
+  auto dtype = options.dtype();
+  c10::intrusive_ptr<StorageImpl> storage_impl;
   if (options.pinned_memory()) {
-    allocator = detail::getCUDAHooks().getPinnedMemoryAllocator();
+    c10::Allocator* allocator = detail::getCUDAHooks().getPinnedMemoryAllocator();
+    storage_impl = c10::make_intrusive<StorageImpl>(
+      dtype,
+      nelements,
+      allocator->allocate(nelements * dtype.itemsize()),
+      allocator,
+      /*resizeable=*/true);
   } else {
-    allocator = at::getCPUAllocator();
+    // Scalars and other small tensors keep their data in the StorageImpl,
+    // which saves an allocation per tensor in scalar-heavy code
+    storage_impl = StorageImpl::makeWithInlineData(
+      dtype,
+      nelements,
+      at::getCPUAllocator(),
+      /*resizeable=*/true);
   }
 
-  int64_t nelements = prod_intlist(size);
-  auto dtype = options.dtype();
-  auto storage_impl = c10::make_intrusive<StorageImpl>(
-    dtype,
-    nelements,
-    allocator->allocate(nelements * dtype.itemsize()),
-    allocator,
-    /*resizeable=*/true);
-
   auto tensor = detail::make_tensor<TensorImpl>(std::move(storage_impl), at::DispatchKey::CPUTensorId);
   // Default TensorImpl has size [0]
   if (size.size() != 1 || size[0] != 0) {
@@ -1,6 +1,7 @@
 #include <ATen/native/TensorIterator.h>
 
 #include <array>
+#include <ATen/Context.h>
 #include <ATen/ExpandUtils.h>
 #include <ATen/Parallel.h>
 #include <ATen/native/TypeProperties.h>
@@ -941,6 +942,144 @@ bool TensorIterator::can_use_fast_set_up() {
   return true;
 }
 
+// [TensorIterator plan cache]
+// When the shapes or strides of the operands rule out fast_set_up(), build()
+// sorts the dimensions, allocates outputs and coalesces dimensions. The
+// result only depends on the broadcast shape, on the sizes, strides and
+// element sizes of the operands, and on a few flags, and code that runs the
+// same ops over and over (e.g. a training loop) sees the same ones each
+// time. With at::globalContext().setTensorIteratorPlanCache(true), the result
+// is kept in a small per-thread cache keyed on those, and replayed on a hit.
+namespace {
+
+struct IterationPlan {
+  using Key = SmallVector<int64_t, 32>;
+
+  // An output allocate_outputs() created.
+  struct Output {
+    DimVector sizes;
+    DimVector strides;
+    bool contiguous;
+  };
+
+  Key key;
+  DimVector perm;
+  DimVector shape;
+  SmallVector<StrideVector, 4> stride_bytes;
+  SmallVector<c10::optional<Output>, 4> outputs;
+  bool has_coalesced_dimensions;
+};
+
+struct IterationPlanCache {
+  static constexpr size_t kSize = 8;
+
+  const IterationPlan* find(const IterationPlan::Key& key) const {
+    for (const auto& plan : plans_) {
+      if (plan.key == key) {
+        return &plan;
+      }
+    }
+    return nullptr;
+  }
+
+  IterationPlan& insert() {
+    auto& plan = plans_[next_];
+    next_ = (next_ + 1) % kSize;
+    return plan;
+  }
+
+ private:
+  std::array<IterationPlan, kSize> plans_;
+  size_t next_ = 0;
+};
+
+IterationPlanCache& plan_cache() {
+  static thread_local IterationPlanCache cache;
+  return cache;
+}
+
+} // namespace
+
+void TensorIterator::compute_layout() {
+  if (!globalContext().tensorIteratorPlanCache()) {
+    // compute each tensor's stride after broadcasting
+    compute_strides();
+    // re-order dimensions to improve coalescing
+    reorder_dimensions();
+    // allocate the output tensor if it's not provided
+    allocate_outputs();
+    // coalesce adjacent dimensions when possible
+    coalesce_dimensions();
+    return;
+  }
+
+  IterationPlan::Key key;
+  key.push_back(num_outputs_);
+  key.push_back(is_reduction_);
+  key.push_back(requires_channels_last_output_);
+  key.push_back(ndim());
+  key.append(shape_.begin(), shape_.end());
+  for (const auto& op : operands_) {
+    if (op.tensor.defined()) {
+      key.push_back(op.tensor.element_size());
+      key.push_back(op.tensor.dim());
+      key.append(op.tensor.sizes().begin(), op.tensor.sizes().end());
+      key.append(op.tensor.strides().begin(), op.tensor.strides().end());
+    } else {
+      // the strides of an allocated output only depend on its element size
+      key.push_back(-static_cast<int64_t>(elementSize(op.target_dtype)));
+    }
+  }
+
+  auto& cache = plan_cache();
+  if (const auto* plan = cache.find(key)) {
+    perm_ = plan->perm;
+    for (int i = 0; i < ntensors(); i++) {
+      auto& op = operands_[i];
+      const auto& output = plan->outputs[i];
+      if (output) {
+        TORCH_INTERNAL_ASSERT(op.is_type_defined(), "no type for operand", i);
+        op.tensor = output->contiguous
+            ? at::empty(output->sizes, op.options())
+            : at::empty_strided(output->sizes, output->strides, op.options());
+        op.current_dtype = op.target_dtype;
+      }
+      op.stride_bytes = plan->stride_bytes[i];
+    }
+    shape_ = plan->shape;
+    has_coalesced_dimensions_ = plan->has_coalesced_dimensions;
+    return;
+  }
+
+  SmallVector<bool, 4> allocated;
+  for (const auto& op : operands_) {
+    allocated.push_back(!op.tensor.defined());
+  }
+  compute_strides();
+  reorder_dimensions();
+  allocate_outputs();
+  coalesce_dimensions();
+  auto& plan = cache.insert();
+  plan.key = std::move(key);
+  plan.perm = perm_;
+  plan.shape = shape_;
+  plan.has_coalesced_dimensions = has_coalesced_dimensions_;
+  plan.stride_bytes.clear();
+  plan.outputs.clear();
+  for (int i = 0; i < ntensors(); i++) {
+    const auto& op = operands_[i];
+    plan.stride_bytes.push_back(op.stride_bytes);
+    if (allocated[i]) {
+      plan.outputs.push_back(IterationPlan::Output{
+          DimVector(op.tensor.sizes()),
+          DimVector(op.tensor.strides()),
+          op.tensor.is_contiguous()});
+    } else {
+      plan.outputs.push_back(c10::nullopt);
+    }
+  }
+}
+
 void TensorIterator::build() {
   // check input tensors memory format to use it during output allocation
   analyze_memory_format();
@@ -958,14 +1097,9 @@ void TensorIterator::build() {
   if (can_use_fast_set_up()) {
     fast_set_up();
   } else {
-    // compute each tensor's stride after broadcasting
-    compute_strides();
-    // re-order dimensions to improve coalescing
-    reorder_dimensions();
-    // allocate the output tensor if it's not provided
-    allocate_outputs();
-    // coalesce adjacent dimensions when possible
-    coalesce_dimensions();
+    // compute the strides, dimension order and outputs, possibly from the
+    // plan cache
+    compute_layout();
   }
   // perform name inference
   propagate_names_to_outputs();
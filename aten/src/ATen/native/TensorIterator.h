@@ -366,6 +366,7 @@ protected:
   void propagate_names_to_outputs();
   void coalesce_dimensions();
   void analyze_memory_format();
+  void compute_layout();
 
 protected:
   DimVector shape_;
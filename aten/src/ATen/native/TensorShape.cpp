@@ -3,7 +3,9 @@
 #include <ATen/ATen.h>
 #include <ATen/ExpandUtils.h>
 #include <ATen/InferSize.h>
+#include <ATen/MemoryOverlap.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/WrapDimUtils.h>
 #include <c10/util/Exception.h>
 #include <c10/util/Optional.h>
@@ -56,6 +58,144 @@ static void check_cat_no_zero_dim(TensorList tensors) {
   }
 }
 
+static void check_cat_shape_except_dim(const Tensor & first, const Tensor & second,
+                                       int64_t dimension, int64_t index) {
+  int64_t first_dims = first.dim();
+  int64_t second_dims = second.dim();
+  TORCH_CHECK(first_dims == second_dims, "Tensors must have same number of dimensions: got ",
+              first_dims, " and ", second_dims);
+  for (int64_t dim = 0; dim < first_dims; dim++) {
+    if (dim == dimension) {
+      continue;
+    }
+    int64_t first_dim_size = first.size(dim);
+    int64_t second_dim_size = second.size(dim);
+    TORCH_CHECK(first_dim_size == second_dim_size, "Sizes of tensors must match except in dimension ",
+                dimension, ". Got ", first_dim_size, " and ", second_dim_size, " in dimension ", dim,
+                " (The offending index is ", index, ")");
+  }
+}
+
+Tensor & _cat_out_cpu(Tensor& result, TensorList tensors, int64_t dim) {
+  // previously, size [0] tensors were the only possible empty tensors; thus, it wasn't possible
+  // to cat empty tensors unless all the other tensors were 1-dimensional, so we allowed these tensors
+  // to be "skipped".  We maintain this behavior for backwards compatibility, but only for this specific
+  // size (i.e. other empty sizes are not skipped).
+  // FIXME: warn if this is the case
+  auto should_skip = [](const Tensor& t) { return t.numel() == 0 && t.dim() == 1; };
+  TORCH_CHECK(tensors.size() > 0, "expected a non-empty list of Tensors");
+  TORCH_CHECK(result.device().is_cpu(), "_cat_out_cpu: expected a CPU result but got ", result.device());
+
+  const Tensor* notSkippedTensor = nullptr;  // non-owning reference
+  for (size_t i = 0; i < tensors.size(); i++) {
+    const Tensor& t = tensors[i];
+    TORCH_CHECK(t.layout() == Layout::Strided && t.device().is_cpu(),
+                "Expected a dense CPU tensor but got ", t.toString(), " for sequence element ", i);
+    TORCH_CHECK(t.scalar_type() == result.scalar_type(),
+                "Expected object of scalar type ", result.scalar_type(), " but got scalar type ",
+                t.scalar_type(), " for sequence element ", i);
+    // Inputs cannot alias the output tensor
+    auto lap = at::get_overlap_status(result, t);
+    TORCH_CHECK(lap != at::MemOverlapStatus::PARTIAL && lap != at::MemOverlapStatus::FULL,
+                "unsupported operation: the input tensors cannot refer to any of the "
+                "output memory locations. Found overlap in input tensor ", i);
+    if (!notSkippedTensor && !should_skip(t)) {
+      notSkippedTensor = &t;
+    }
+  }
+  if (!notSkippedTensor) {
+    return result;
+  }
+
+  auto nDims = notSkippedTensor->dim();
+  TORCH_CHECK(dim >= 0 && dim < nDims, "invalid dimension ", dim);
+
+  // Compute size of the result in the cat dimension
+  int64_t cat_dim_size = 0;
+  for (size_t i = 0; i < tensors.size(); i++) {
+    const Tensor& t = tensors[i];
+    if (should_skip(t)) {
+      continue;
+    }
+    check_cat_shape_except_dim(*notSkippedTensor, t, dim, i);
+    cat_dim_size += t.size(dim);
+  }
+
+  auto result_size = notSkippedTensor->sizes().vec();
+  result_size[dim] = cat_dim_size;
+  resize_output_amortized_cpu_(result, result_size);
+  if (result.numel() == 0) {
+    return result;
+  }
+
+  bool allContiguous = result.is_contiguous();
+  for (const Tensor& t : tensors) {
+    allContiguous = allContiguous && (should_skip(t) || t.is_contiguous());
+  }
+
+  if (!allContiguous) {
+    int64_t offset = 0;
+    for (const Tensor& t : tensors) {
+      if (should_skip(t)) {
+        continue;
+      }
+      int64_t dimSize = t.size(dim);
+      result.narrow(dim, offset, dimSize).copy_(t);
+      offset += dimSize;
+    }
+    return result;
+  }
+
+  // With contiguous inputs and result, the output is `outer` rows that each
+  // hold one contiguous slice of every input. All (row, input) slices are
+  // independent memcpys, so they are done in a single parallel pass rather
+  // than input by input, which matters when there are many small inputs.
+  int64_t outer = 1, inner = 1;
+  for (int64_t i = 0; i < dim; ++i) {
+    outer *= result_size[i];
+  }
+  for (int64_t i = dim + 1; i < nDims; ++i) {
+    inner *= result_size[i];
+  }
+  const int64_t element_size = result.element_size();
+  const int64_t row_bytes = cat_dim_size * inner * element_size;
+
+  std::vector<const char*> input_data;
+  std::vector<int64_t> slice_bytes;
+  std::vector<int64_t> slice_offsets;
+  int64_t offset = 0;
+  for (const Tensor& t : tensors) {
+    if (should_skip(t) || t.size(dim) == 0) {
+      continue;
+    }
+    input_data.push_back(static_cast<const char*>(t.data_ptr()));
+    slice_bytes.push_back(t.size(dim) * inner * element_size);
+    slice_offsets.push_back(offset);
+    offset += slice_bytes.back();
+  }
+
+  char* result_data = static_cast<char*>(result.data_ptr());
+  const int64_t num_slices = input_data.size();
+  const int64_t avg_slice_elems = std::max<int64_t>(1, row_bytes / (element_size * num_slices));
+  at::parallel_for(0, outer * num_slices, std::max<int64_t>(1, at::internal::GRAIN_SIZE / avg_slice_elems),
+                   [&](int64_t start, int64_t end) {
+    for (int64_t k = start; k < end; k++) {
+      const int64_t o = k / num_slices;
+      const int64_t j = k % num_slices;
+      memcpy(result_data + o * row_bytes + slice_offsets[j],
+             input_data[j] + o * slice_bytes[j],
+             slice_bytes[j]);
+    }
+  });
+  return result;
+}
+
+Tensor _cat_cpu(TensorList tensors, int64_t dim) {
+  TORCH_CHECK(tensors.size() > 0, "expected a non-empty list of Tensors");
+  Tensor result = at::empty({0}, tensors[0].options());
+  return native::_cat_out_cpu(result, tensors, dim);
+}
+
 Tensor & cat_out(Tensor & result, TensorList tensors, int64_t dim) {
   check_cat_no_zero_dim(tensors);
   dim = legacy_cat_wrap_dim(dim, tensors);
@@ -60,9 +60,13 @@ DECLARE_DISPATCH(void(*)(TensorIterator&, const double, Generator *), exponentia
 DECLARE_DISPATCH(void(*)(TensorIterator&, const double, Generator *), geometric_stub);
 DECLARE_DISPATCH(void(*)(TensorIterator&, const double, const double, Generator *), log_normal_stub);
 DECLARE_DISPATCH(void(*)(Tensor&, const double, const double, Generator *), normal_stub);
+// See Note [Philox fill of large CPU tensors] in native/cpu/DistributionTemplates.h
+DECLARE_DISPATCH(void(*)(Tensor&, const double, const double, Generator *), uniform_philox_stub);
+DECLARE_DISPATCH(void(*)(Tensor&, const double, Generator *), bernoulli_philox_stub);
 DECLARE_DISPATCH(void(*)(TensorIterator&, const int64_t), polygamma_stub);
 DECLARE_DISPATCH(void(*)(TensorIterator&, Scalar a, Scalar b), clamp_stub);
 DECLARE_DISPATCH(void(*)(Tensor&, const Tensor&, int64_t, bool, Generator *), multinomial_stub);
+DECLARE_DISPATCH(void(*)(Tensor&, const Tensor&, const Tensor&, Generator *), multinomial_alias_draw_stub);
 
 // Missing unary functions
 // digamma
@@ -2,11 +2,12 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/NumericUtils.h>
+#include <c10/util/flat_hash_map.h>
 
+#include <numeric>
 #include <set>
 #include <tuple>
-#include <unordered_map>
-#include <unordered_set>
 
 namespace at {
 namespace native{
@@ -22,49 +23,80 @@ std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
   const Tensor& input = self.contiguous();
   const scalar_t* input_data = input.data_ptr<scalar_t>();
   int64_t numel = input.numel();
-  Tensor output;
   Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
   Tensor counts = at::empty({0}, self.options().dtype(kLong));
 
-  std::unordered_set<scalar_t> set(input_data, input_data + numel);
-  output = at::empty({static_cast<int64_t>(set.size())}, input.options());
-  scalar_t *output_data = output.data_ptr<scalar_t>();
-
-  if (sorted) {
-    std::vector<scalar_t> vec(set.begin(), set.end());
-    std::sort(vec.begin(), vec.end());
-    std::copy(vec.begin(), vec.end(), output_data);
-  } else {
-    std::copy(set.begin(), set.end(), output_data);
-  }
-
-  if (return_inverse || return_counts) {
+  // A single pass over the input with an open-addressing hash map from each
+  // distinct value to its id, its position in order of first occurrence.
+  // NaNs never compare equal, so each one is its own unique value; they are
+  // kept out of the map, where they would all collide.
+  ska::flat_hash_map<scalar_t, int64_t> ids;
+  std::vector<scalar_t> uniques;
+  std::vector<int64_t> counts_vec;
+  int64_t* inverse_data = nullptr;
+  if (return_inverse) {
     inverse_indices.resize_(input.sizes());
-    int64_t* inverse_indices_data = inverse_indices.data_ptr<int64_t>();
-    std::unordered_map<scalar_t, int64_t> inverse_map;
-    inverse_map.reserve(output.numel());
-    for (int64_t i = 0; i < output.numel(); ++i) {
-      inverse_map[output_data[i]] = i;
-    }
-    for(int64_t i = 0; i < numel; ++i) {
-      inverse_indices_data[i] = inverse_map[input_data[i]];
+    inverse_data = inverse_indices.data_ptr<int64_t>();
+  }
+  for (int64_t i = 0; i < numel; ++i) {
+    const scalar_t value = input_data[i];
+    int64_t id = uniques.size();
+    if (_isnan(value)) {
+      uniques.push_back(value);
+    } else {
+      auto inserted = ids.emplace(value, id);
+      if (inserted.second) {
+        uniques.push_back(value);
+      } else {
+        id = inserted.first->second;
+      }
     }
     if (return_counts) {
-      std::unordered_map<scalar_t, int64_t> counts_map;
-      counts_map.reserve(output.numel());
-      for (int64_t i = 0; i < output.numel(); ++i) {
-        counts_map[output_data[i]] = 0;
+      if (id == static_cast<int64_t>(counts_vec.size())) {
+        counts_vec.push_back(0);
       }
-      for(int64_t i = 0; i < numel; i++) {
-        counts_map[input_data[i]] += 1;
+      counts_vec[id]++;
+    }
+    if (return_inverse) {
+      inverse_data[i] = id;
+    }
+  }
+
+  const int64_t num_uniques = uniques.size();
+  Tensor output = at::empty({num_uniques}, input.options());
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  if (return_counts) {
+    counts.resize_({num_uniques});
+  }
+  int64_t* counts_data = return_counts ? counts.data_ptr<int64_t>() : nullptr;
+
+  if (sorted) {
+    // only the distinct values are sorted; ids are then renumbered by rank
+    std::vector<int64_t> order(num_uniques);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&uniques](int64_t a, int64_t b) {
+      const scalar_t x = uniques[a];
+      const scalar_t y = uniques[b];
+      return (!_isnan(x) && _isnan(y)) || x < y;
+    });
+    std::vector<int64_t> rank(num_uniques);
+    for (int64_t j = 0; j < num_uniques; ++j) {
+      output_data[j] = uniques[order[j]];
+      rank[order[j]] = j;
+      if (return_counts) {
+        counts_data[j] = counts_vec[order[j]];
       }
-      counts.resize_(output.sizes());
-      counts.fill_(0);
-      int64_t *counts_data = counts.data_ptr<int64_t>();
-      for(int64_t i = 0; i < output.numel(); i++) {
-        counts_data[i] = counts_map[output_data[i]];
+    }
+    if (return_inverse) {
+      for (int64_t i = 0; i < numel; ++i) {
+        inverse_data[i] = rank[inverse_data[i]];
       }
     }
+  } else {
+    std::copy(uniques.begin(), uniques.end(), output_data);
+    if (return_counts) {
+      std::copy(counts_vec.begin(), counts_vec.end(), counts_data);
+    }
   }
   return std::make_tuple(output, inverse_indices, counts);
 }
@@ -1,4 +1,5 @@
 #include <math.h>
+#include <vector>
 
 #include <ATen/ATen.h>
 #include <ATen/TensorUtils.h>
@@ -220,6 +221,57 @@ static inline int64_t nearest_neighbor_compute_source_index(
   return src_index;
 }
 
+// The source index of every output index along one dimension, so that the
+// kernels don't recompute it for every channel and row.
+static inline std::vector<int64_t> nearest_neighbor_compute_source_indices(
+    const float scale,
+    int64_t input_size,
+    int64_t output_size) {
+  std::vector<int64_t> indices(output_size);
+  for (int64_t i = 0; i < output_size; ++i) {
+    indices[i] = nearest_neighbor_compute_source_index(scale, i, input_size);
+  }
+  return indices;
+}
+
+// The source indices and weights of linear interpolation along one
+// dimension: output index i interpolates between input indices index[i] and
+// index[i] + offset[i] (offset[i] is 0 at the border) with weights lambda0[i]
+// and lambda1[i].
+template <typename scalar_t>
+struct LinearInterpolationTable {
+  std::vector<int64_t> index;
+  std::vector<int64_t> offset;
+  std::vector<scalar_t> lambda0;
+  std::vector<scalar_t> lambda1;
+};
+
+template <typename scalar_t>
+static inline LinearInterpolationTable<scalar_t> compute_linear_interpolation_table(
+    int64_t input_size,
+    int64_t output_size,
+    bool align_corners,
+    const c10::optional<double> scale) {
+  const scalar_t ratio = area_pixel_compute_scale<scalar_t>(
+      input_size, output_size, align_corners, scale);
+
+  LinearInterpolationTable<scalar_t> table;
+  table.index.resize(output_size);
+  table.offset.resize(output_size);
+  table.lambda0.resize(output_size);
+  table.lambda1.resize(output_size);
+  for (int64_t i = 0; i < output_size; ++i) {
+    const scalar_t real_index = area_pixel_compute_source_index<scalar_t>(
+        ratio, i, align_corners, /*cubic=*/false);
+    const int64_t index = real_index;
+    table.index[i] = index;
+    table.offset[i] = (index < input_size - 1) ? 1 : 0;
+    table.lambda1[i] = real_index - index;
+    table.lambda0[i] = static_cast<scalar_t>(1.) - table.lambda1[i];
+  }
+  return table;
+}
+
 template <typename scalar_t>
 static scalar_t upsample_get_value_bounded(
     scalar_t* data,
@@ -1,11 +1,51 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/UpSample.h>
 
+#include <array>
+
 namespace at {
 namespace native {
 namespace {
 
+// The four (clamped) source indices and cubic coefficients of every output
+// index along one dimension.
+template <typename scalar_t>
+struct CubicInterpolationTable {
+  std::vector<std::array<int64_t, 4>> indices;
+  std::vector<std::array<scalar_t, 4>> coeffs;
+};
+
+template <typename scalar_t>
+static CubicInterpolationTable<scalar_t> compute_cubic_interpolation_table(
+    int64_t input_size,
+    int64_t output_size,
+    bool align_corners,
+    c10::optional<double> scale) {
+  const scalar_t ratio = area_pixel_compute_scale<scalar_t>(
+      input_size, output_size, align_corners, scale);
+
+  CubicInterpolationTable<scalar_t> table;
+  table.indices.resize(output_size);
+  table.coeffs.resize(output_size);
+  for (int64_t i = 0; i < output_size; ++i) {
+    const scalar_t real_index = area_pixel_compute_source_index(
+        ratio, i, align_corners, /*cubic=*/true);
+    const int64_t index = floorf(real_index);
+    const scalar_t t = real_index - index;
+    for (int64_t k = 0; k < 4; ++k) {
+      table.indices[i][k] = std::max(
+          std::min(index - 1 + k, input_size - 1), static_cast<int64_t>(0));
+    }
+    get_cubic_upsample_coefficients<scalar_t>(table.coeffs[i].data(), t);
+  }
+  return table;
+}
+
+// Every output plane (of a channel of an image) is written by a single
+// thread, so the backward pass, which accumulates into the input planes,
+// doesn't need to synchronize.
 template <typename scalar_t>
 static void upsample_bicubic2d_out_frame(
     scalar_t* odata,
@@ -19,73 +59,55 @@ static void upsample_bicubic2d_out_frame(
     bool align_corners,
     c10::optional<double> scales_h,
     c10::optional<double> scales_w) {
+  channels = channels * nbatch;
+
   // Special case: input/output same size, just copy
   if (input_height == output_height && input_width == output_width) {
-    for (int64_t output_y = 0; output_y < output_height; output_y++) {
-      for (int64_t output_x = 0; output_x < output_width; output_x++) {
-        const scalar_t* in = &idata[output_y * input_width + output_x];
-        scalar_t* out = &odata[output_y * output_width + output_x];
-
-        for (int64_t c = 0; c < channels; ++c) {
-          out[0] = in[0];
-          in += input_width * input_height;
-          out += output_width * output_height;
-        }
-      }
-    }
+    std::copy(idata, idata + channels * input_height * input_width, odata);
     return;
   }
 
   // Bicubic interpolation
-  const scalar_t height_scale = area_pixel_compute_scale<scalar_t>(
+  const auto y_table = compute_cubic_interpolation_table<scalar_t>(
       input_height, output_height, align_corners, scales_h);
-  const scalar_t width_scale = area_pixel_compute_scale<scalar_t>(
+  const auto x_table = compute_cubic_interpolation_table<scalar_t>(
       input_width, output_width, align_corners, scales_w);
 
-  for (int64_t output_y = 0; output_y < output_height; output_y++) {
-    for (int64_t output_x = 0; output_x < output_width; output_x++) {
-      scalar_t* in = idata;
-      scalar_t* out = odata;
-
-      const scalar_t real_x = area_pixel_compute_source_index(width_scale, output_x, align_corners, /*cubic=*/true);
-      int64_t input_x = floorf(real_x);
-      const scalar_t t_x = real_x - input_x;
-
-      const scalar_t real_y = area_pixel_compute_source_index(height_scale, output_y, align_corners, /*cubic=*/true);
-      int64_t input_y = floorf(real_y);
-      const scalar_t t_y = real_y - input_y;
-
-      for (int64_t c = 0; c < channels * nbatch; c++) {
-        scalar_t coefficients[4];
-
-        // Interpolate 4 times in the x direction
-        for (int64_t i = 0; i < 4; i++) {
-          coefficients[i] = cubic_interp1d<scalar_t>(
-              upsample_get_value_bounded<scalar_t>(
-                  in, input_width, input_height, input_x - 1, input_y - 1 + i),
-              upsample_get_value_bounded<scalar_t>(
-                  in, input_width, input_height, input_x + 0, input_y - 1 + i),
-              upsample_get_value_bounded<scalar_t>(
-                  in, input_width, input_height, input_x + 1, input_y - 1 + i),
-              upsample_get_value_bounded<scalar_t>(
-                  in, input_width, input_height, input_x + 2, input_y - 1 + i),
-              t_x);
-        }
+  const int64_t input_plane = input_height * input_width;
+  const int64_t output_plane = output_height * output_width;
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / (16 * output_plane));
+
+  at::parallel_for(0, channels, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t c = start; c < end; ++c) {
+      const scalar_t* in = idata + c * input_plane;
+      scalar_t* out = odata + c * output_plane;
+
+      for (int64_t output_y = 0; output_y < output_height; output_y++) {
+        const auto& input_y = y_table.indices[output_y];
+        const auto& y_coeffs = y_table.coeffs[output_y];
+
+        for (int64_t output_x = 0; output_x < output_width; output_x++) {
+          const auto& input_x = x_table.indices[output_x];
+          const auto& x_coeffs = x_table.coeffs[output_x];
+          scalar_t coefficients[4];
+
+          // Interpolate 4 times in the x direction
+          for (int64_t i = 0; i < 4; i++) {
+            const scalar_t* row = in + input_y[i] * input_width;
+            coefficients[i] = row[input_x[0]] * x_coeffs[0] +
+                row[input_x[1]] * x_coeffs[1] + row[input_x[2]] * x_coeffs[2] +
+                row[input_x[3]] * x_coeffs[3];
+          }
 
-        // Interpolate in the y direction using x interpolations
-        out[output_y * output_width + output_x] = cubic_interp1d<scalar_t>(
-            coefficients[0],
-            coefficients[1],
-            coefficients[2],
-            coefficients[3],
-            t_y);
-
-        // Move to next channel
-        in += input_width * input_height;
-        out += output_width * output_height;
+          // Interpolate in the y direction using x interpolations
+          out[output_y * output_width + output_x] =
+              coefficients[0] * y_coeffs[0] + coefficients[1] * y_coeffs[1] +
+              coefficients[2] * y_coeffs[2] + coefficients[3] * y_coeffs[3];
+        }
       }
     }
-  }
+  });
 }
 
 template <typename scalar_t>
@@ -105,64 +127,44 @@ static void upsample_bicubic2d_backward_out_frame(
 
   // Special case: input/output same size, just copy
   if (input_height == output_height && input_width == output_width) {
-    for (int64_t output_y = 0; output_y < output_height; output_y++) {
-      for (int64_t output_x = 0; output_x < output_width; output_x++) {
-        scalar_t* in = &idata[output_y * input_width + output_x];
-        scalar_t* out = &odata[output_y * output_width + output_x];
-        for (int64_t c = 0; c < channels; ++c) {
-          in[0] = out[0];
-          in += input_width * input_height;
-          out += output_width * output_height;
-        }
-      }
-    }
+    std::copy(odata, odata + channels * output_height * output_width, idata);
     return;
   }
 
-  const scalar_t height_scale = area_pixel_compute_scale<scalar_t>(
+  const auto y_table = compute_cubic_interpolation_table<scalar_t>(
       input_height, output_height, align_corners, scales_h);
-  const scalar_t width_scale = area_pixel_compute_scale<scalar_t>(
+  const auto x_table = compute_cubic_interpolation_table<scalar_t>(
       input_width, output_width, align_corners, scales_w);
 
-  for (int64_t output_y = 0; output_y < output_height; output_y++) {
-    for (int64_t output_x = 0; output_x < output_width; output_x++) {
-      scalar_t* in = idata;
-      scalar_t* out = odata;
-
-      const scalar_t real_x = area_pixel_compute_source_index(width_scale, output_x, align_corners, /*cubic=*/true);
-      int64_t input_x = floorf(real_x);
-      scalar_t t_x = real_x - input_x;
-
-      const scalar_t real_y = area_pixel_compute_source_index(height_scale, output_y, align_corners, /*cubic=*/true);
-      int64_t input_y = floorf(real_y);
-      scalar_t t_y = real_y - input_y;
-
-      scalar_t x_coeffs[4];
-      scalar_t y_coeffs[4];
-
-      get_cubic_upsample_coefficients<scalar_t>(x_coeffs, t_x);
-      get_cubic_upsample_coefficients<scalar_t>(y_coeffs, t_y);
-
-      for (int64_t c = 0; c < channels; c++) {
-        scalar_t out_value = out[output_y * output_width + output_x];
-
-        for (int64_t i = 0; i < 4; i++) {
-          for (int64_t j = 0; j < 4; j++) {
-            upsample_increment_value_bounded<scalar_t>(
-                in,
-                input_width,
-                input_height,
-                input_x - 1 + i,
-                input_y - 1 + j,
-                out_value * y_coeffs[j] * x_coeffs[i]);
+  const int64_t input_plane = input_height * input_width;
+  const int64_t output_plane = output_height * output_width;
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / (16 * output_plane));
+
+  at::parallel_for(0, channels, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t c = start; c < end; ++c) {
+      scalar_t* in = idata + c * input_plane;
+      const scalar_t* out = odata + c * output_plane;
+
+      for (int64_t output_y = 0; output_y < output_height; output_y++) {
+        const auto& input_y = y_table.indices[output_y];
+        const auto& y_coeffs = y_table.coeffs[output_y];
+
+        for (int64_t output_x = 0; output_x < output_width; output_x++) {
+          const auto& input_x = x_table.indices[output_x];
+          const auto& x_coeffs = x_table.coeffs[output_x];
+          const scalar_t out_value = out[output_y * output_width + output_x];
+
+          for (int64_t i = 0; i < 4; i++) {
+            for (int64_t j = 0; j < 4; j++) {
+              in[input_y[j] * input_width + input_x[i]] +=
+                  out_value * y_coeffs[j] * x_coeffs[i];
+            }
           }
         }
-
-        in += input_width * input_height;
-        out += output_width * output_height;
       }
     }
-  }
+  });
 }
 
 static void upsample_bicubic2d_out_cpu_template(
@@ -3,12 +3,17 @@
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/UpSample.h>
 
 namespace at {
 namespace native {
 namespace {
 
+// Every output plane (of a channel of an image) is written by a single
+// thread, so the backward pass, which accumulates into the input planes,
+// doesn't need to synchronize. The source indices and weights are computed
+// once per output row and column.
 template <typename scalar_t>
 static void upsample_bilinear2d_out_frame(
     scalar_t* odata,
@@ -26,61 +31,43 @@ static void upsample_bilinear2d_out_frame(
 
   // special case: just copy
   if (input_height == output_height && input_width == output_width) {
-    for (int64_t h2 = 0; h2 < output_height; ++h2) {
-      const int64_t h1 = h2;
-
-      for (int64_t w2 = 0; w2 < output_width; ++w2) {
-        const int64_t w1 = w2;
-        const scalar_t* pos1 = &idata[h1 * input_width + w1];
-        scalar_t* pos2 = &odata[h2 * output_width + w2];
-
-        for (int64_t c = 0; c < channels; ++c) {
-          pos2[0] = pos1[0];
-          pos1 += input_width * input_height;
-          pos2 += output_width * output_height;
-        }
-      }
-    }
+    std::copy(idata, idata + channels * input_height * input_width, odata);
     return;
   }
-  const scalar_t rheight = area_pixel_compute_scale<scalar_t>(
-      input_height, output_height, align_corners, scales_h);
-
-  const scalar_t rwidth = area_pixel_compute_scale<scalar_t>(
-       input_width, output_width, align_corners, scales_w);
-
-  for (int64_t h2 = 0; h2 < output_height; ++h2) {
-    const scalar_t h1r = area_pixel_compute_source_index<scalar_t>(
-        rheight, h2, align_corners, /*cubic=*/false);
 
-    const int64_t h1 = h1r;
-    const int64_t h1p = (h1 < input_height - 1) ? 1 : 0;
-
-    const scalar_t h1lambda = h1r - h1;
-    const scalar_t h0lambda = static_cast<scalar_t>(1.) - h1lambda;
-
-    for (int64_t w2 = 0; w2 < output_width; ++w2) {
-      const scalar_t w1r = area_pixel_compute_source_index<scalar_t>(
-          rwidth, w2, align_corners, /*cubic=*/false);
-
-      const int64_t w1 = w1r;
-      const int64_t w1p = (w1 < input_width - 1) ? 1 : 0;
-
-      const scalar_t w1lambda = w1r - w1;
-      const scalar_t w0lambda = static_cast<scalar_t>(1.) - w1lambda;
-      const scalar_t* pos1 = &idata[h1 * input_width + w1];
-      scalar_t* pos2 = &odata[h2 * output_width + w2];
+  const auto h_table = compute_linear_interpolation_table<scalar_t>(
+      input_height, output_height, align_corners, scales_h);
+  const auto w_table = compute_linear_interpolation_table<scalar_t>(
+      input_width, output_width, align_corners, scales_w);
 
-      for (int64_t c = 0; c < channels; ++c) {
-        pos2[0] = h0lambda * (w0lambda * pos1[0] + w1lambda * pos1[w1p]) +
-            h1lambda *
-                (w0lambda * pos1[h1p * input_width] +
-                 w1lambda * pos1[h1p * input_width + w1p]);
-        pos1 += input_width * input_height;
-        pos2 += output_width * output_height;
+  const int64_t input_plane = input_height * input_width;
+  const int64_t output_plane = output_height * output_width;
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / output_plane);
+
+  at::parallel_for(0, channels, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t c = start; c < end; ++c) {
+      const scalar_t* in = idata + c * input_plane;
+      scalar_t* out = odata + c * output_plane;
+
+      for (int64_t h2 = 0; h2 < output_height; ++h2) {
+        const scalar_t* row0 = in + h_table.index[h2] * input_width;
+        const scalar_t* row1 = row0 + h_table.offset[h2] * input_width;
+        const scalar_t h0lambda = h_table.lambda0[h2];
+        const scalar_t h1lambda = h_table.lambda1[h2];
+        scalar_t* out_row = out + h2 * output_width;
+
+        for (int64_t w2 = 0; w2 < output_width; ++w2) {
+          const int64_t w1 = w_table.index[w2];
+          const int64_t w1p = w_table.offset[w2];
+          const scalar_t w0lambda = w_table.lambda0[w2];
+          const scalar_t w1lambda = w_table.lambda1[w2];
+          out_row[w2] = h0lambda * (w0lambda * row0[w1] + w1lambda * row0[w1 + w1p]) +
+              h1lambda * (w0lambda * row1[w1] + w1lambda * row1[w1 + w1p]);
+        }
       }
     }
-  }
+  });
 }
 
 template <typename scalar_t>
@@ -100,62 +87,163 @@ static void upsample_bilinear2d_backward_out_frame(
 
   // special case: same-size matching grids
   if (input_height == output_height && input_width == output_width) {
-    for (int64_t h2 = 0; h2 < output_height; ++h2) {
-      const int64_t h1 = h2;
-      for (int64_t w2 = 0; w2 < output_width; ++w2) {
-        const int64_t w1 = w2;
-        scalar_t* pos1 = &idata[h1 * input_width + w1];
-        const scalar_t* pos2 = &odata[h2 * output_width + w2];
+    std::copy(odata, odata + channels * output_height * output_width, idata);
+    return;
+  }
 
-        for (int64_t c = 0; c < channels; ++c) {
-          pos1[0] += pos2[0];
-          pos1 += input_width * input_height;
-          pos2 += output_width * output_height;
+  const auto h_table = compute_linear_interpolation_table<scalar_t>(
+      input_height, output_height, align_corners, scales_h);
+  const auto w_table = compute_linear_interpolation_table<scalar_t>(
+      input_width, output_width, align_corners, scales_w);
+
+  const int64_t input_plane = input_height * input_width;
+  const int64_t output_plane = output_height * output_width;
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / output_plane);
+
+  at::parallel_for(0, channels, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t c = start; c < end; ++c) {
+      scalar_t* in = idata + c * input_plane;
+      const scalar_t* out = odata + c * output_plane;
+
+      for (int64_t h2 = 0; h2 < output_height; ++h2) {
+        scalar_t* row0 = in + h_table.index[h2] * input_width;
+        scalar_t* row1 = row0 + h_table.offset[h2] * input_width;
+        const scalar_t h0lambda = h_table.lambda0[h2];
+        const scalar_t h1lambda = h_table.lambda1[h2];
+        const scalar_t* out_row = out + h2 * output_width;
+
+        for (int64_t w2 = 0; w2 < output_width; ++w2) {
+          const int64_t w1 = w_table.index[w2];
+          const int64_t w1p = w_table.offset[w2];
+          const scalar_t w0lambda = w_table.lambda0[w2];
+          const scalar_t w1lambda = w_table.lambda1[w2];
+          row0[w1] += h0lambda * w0lambda * out_row[w2];
+          row0[w1 + w1p] += h0lambda * w1lambda * out_row[w2];
+          row1[w1] += h1lambda * w0lambda * out_row[w2];
+          row1[w1 + w1p] += h1lambda * w1lambda * out_row[w2];
         }
       }
     }
+  });
+}
+
+// NHWC variants: every output point interpolates between four
+// contiguous channel vectors of the input.
+template <typename scalar_t>
+static void upsample_bilinear2d_out_frame_channels_last(
+    scalar_t* odata,
+    scalar_t* idata,
+    int64_t input_height,
+    int64_t input_width,
+    int64_t output_height,
+    int64_t output_width,
+    int64_t nbatch,
+    int64_t channels,
+    bool align_corners,
+    c10::optional<double> scales_h,
+    c10::optional<double> scales_w) {
+  // special case: just copy
+  if (input_height == output_height && input_width == output_width) {
+    std::copy(idata, idata + nbatch * input_height * input_width * channels, odata);
     return;
   }
 
-  const scalar_t rheight = area_pixel_compute_scale<scalar_t>(
+  const auto h_table = compute_linear_interpolation_table<scalar_t>(
       input_height, output_height, align_corners, scales_h);
-  const scalar_t rwidth = area_pixel_compute_scale<scalar_t>(
+  const auto w_table = compute_linear_interpolation_table<scalar_t>(
       input_width, output_width, align_corners, scales_w);
 
-  for (int64_t h2 = 0; h2 < output_height; ++h2) {
-    const scalar_t h1r = area_pixel_compute_source_index<scalar_t>(
-        rheight, h2, align_corners, /*cubic=*/false);
-
-    const int64_t h1 = h1r;
-    const int64_t h1p = (h1 < input_height - 1) ? 1 : 0;
-
-    const scalar_t h1lambda = h1r - h1;
-    const scalar_t h0lambda = static_cast<scalar_t>(1.) - h1lambda;
+  at::parallel_for(0, nbatch * output_height, 0, [&](int64_t start, int64_t end) {
+    for (int64_t idx = start; idx < end; ++idx) {
+      const int64_t n = idx / output_height;
+      const int64_t h2 = idx % output_height;
+      const int64_t h1 = h_table.index[h2];
+      const int64_t h1p = h_table.offset[h2];
+      const scalar_t h0lambda = h_table.lambda0[h2];
+      const scalar_t h1lambda = h_table.lambda1[h2];
 
-    for (int64_t w2 = 0; w2 < output_width; ++w2) {
-      const scalar_t w1r = area_pixel_compute_source_index<scalar_t>(
-          rwidth, w2, align_corners, /*cubic=*/false);
-
-      const int64_t w1 = w1r;
-      const int64_t w1p = (w1 < input_width - 1) ? 1 : 0;
+      for (int64_t w2 = 0; w2 < output_width; ++w2) {
+        const int64_t w1 = w_table.index[w2];
+        const int64_t w1p = w_table.offset[w2];
+        const scalar_t w0lambda = w_table.lambda0[w2];
+        const scalar_t w1lambda = w_table.lambda1[w2];
+        const scalar_t* pos1 =
+            &idata[((n * input_height + h1) * input_width + w1) * channels];
+        const scalar_t* pos1_w = pos1 + w1p * channels;
+        const scalar_t* pos1_h = pos1 + h1p * input_width * channels;
+        const scalar_t* pos1_hw = pos1_h + w1p * channels;
+        scalar_t* pos2 =
+            &odata[((n * output_height + h2) * output_width + w2) * channels];
 
-      const scalar_t w1lambda = w1r - w1;
-      const scalar_t w0lambda = static_cast<scalar_t>(1.) - w1lambda;
+        for (int64_t c = 0; c < channels; ++c) {
+          pos2[c] = h0lambda * (w0lambda * pos1[c] + w1lambda * pos1_w[c]) +
+              h1lambda * (w0lambda * pos1_h[c] + w1lambda * pos1_hw[c]);
+        }
+      }
+    }
+  });
+}
 
-      scalar_t* pos1 = &idata[h1 * input_width + w1];
+template <typename scalar_t>
+static void upsample_bilinear2d_backward_out_frame_channels_last(
+    scalar_t* odata,
+    scalar_t* idata,
+    int64_t input_height,
+    int64_t input_width,
+    int64_t output_height,
+    int64_t output_width,
+    int64_t nbatch,
+    int64_t channels,
+    bool align_corners,
+    c10::optional<double> scales_h,
+    c10::optional<double> scales_w) {
+  // special case: same-size matching grids
+  if (input_height == output_height && input_width == output_width) {
+    std::copy(odata, odata + nbatch * output_height * output_width * channels, idata);
+    return;
+  }
 
-      const scalar_t* pos2 = &odata[h2 * output_width + w2];
+  const auto h_table = compute_linear_interpolation_table<scalar_t>(
+      input_height, output_height, align_corners, scales_h);
+  const auto w_table = compute_linear_interpolation_table<scalar_t>(
+      input_width, output_width, align_corners, scales_w);
 
-      for (int64_t c = 0; c < channels; ++c) {
-        pos1[0] += h0lambda * w0lambda * pos2[0];
-        pos1[w1p] += h0lambda * w1lambda * pos2[0];
-        pos1[h1p * input_width] += h1lambda * w0lambda * pos2[0];
-        pos1[h1p * input_width + w1p] += h1lambda * w1lambda * pos2[0];
-        pos1 += input_width * input_height;
-        pos2 += output_width * output_height;
+  // Different output points of an image scatter into the same input points,
+  // so only the batch is split across threads.
+  at::parallel_for(0, nbatch, 0, [&](int64_t start, int64_t end) {
+    for (int64_t n = start; n < end; ++n) {
+      for (int64_t h2 = 0; h2 < output_height; ++h2) {
+        const int64_t h1 = h_table.index[h2];
+        const int64_t h1p = h_table.offset[h2];
+        const scalar_t h0lambda = h_table.lambda0[h2];
+        const scalar_t h1lambda = h_table.lambda1[h2];
+
+        for (int64_t w2 = 0; w2 < output_width; ++w2) {
+          const int64_t w1 = w_table.index[w2];
+          const int64_t w1p = w_table.offset[w2];
+          const scalar_t w0lambda = w_table.lambda0[w2];
+          const scalar_t w1lambda = w_table.lambda1[w2];
+
+          scalar_t* pos1 =
+              &idata[((n * input_height + h1) * input_width + w1) * channels];
+          scalar_t* pos1_w = pos1 + w1p * channels;
+          scalar_t* pos1_h = pos1 + h1p * input_width * channels;
+          scalar_t* pos1_hw = pos1_h + w1p * channels;
+
+          const scalar_t* pos2 =
+              &odata[((n * output_height + h2) * output_width + w2) * channels];
+
+          for (int64_t c = 0; c < channels; ++c) {
+            pos1[c] += h0lambda * w0lambda * pos2[c];
+            pos1_w[c] += h0lambda * w1lambda * pos2[c];
+            pos1_h[c] += h1lambda * w0lambda * pos2[c];
+            pos1_hw[c] += h1lambda * w1lambda * pos2[c];
+          }
+        }
       }
     }
-  }
+  });
 }
 
 static void upsample_bilinear2d_out_cpu_template(
@@ -188,9 +276,10 @@ static void upsample_bilinear2d_out_cpu_template(
       output_height,
       output_width);
 
-  auto input = input_.contiguous();
+  const auto memory_format = input_.suggest_memory_format();
+  auto input = input_.contiguous(memory_format);
 
-  output.resize_({nbatch, channels, output_height, output_width});
+  output.resize_({nbatch, channels, output_height, output_width}, memory_format);
   output.zero_();
 
   AT_ASSERT(
@@ -201,7 +290,10 @@ static void upsample_bilinear2d_out_cpu_template(
     auto* idata = input.data_ptr<scalar_t>();
     auto* odata = output.data_ptr<scalar_t>();
 
-    upsample_bilinear2d_out_frame<scalar_t>(
+    auto kernel = memory_format == at::MemoryFormat::ChannelsLast
+        ? upsample_bilinear2d_out_frame_channels_last<scalar_t>
+        : upsample_bilinear2d_out_frame<scalar_t>;
+    kernel(
         odata,
         idata,
         input_height,
@@ -252,9 +344,10 @@ static void upsample_bilinear2d_backward_out_cpu_template(
       output_height,
       output_width);
 
-  auto grad_output = grad_output_.contiguous();
+  const auto memory_format = grad_output_.suggest_memory_format();
+  auto grad_output = grad_output_.contiguous(memory_format);
 
-  grad_input.resize_({nbatch, channels, input_height, input_width});
+  grad_input.resize_({nbatch, channels, input_height, input_width}, memory_format);
   grad_input.zero_();
 
   AT_DISPATCH_FLOATING_TYPES_AND_HALF(
@@ -262,7 +355,10 @@ static void upsample_bilinear2d_backward_out_cpu_template(
         scalar_t* idata = grad_input.data_ptr<scalar_t>();
         scalar_t* odata = grad_output.data_ptr<scalar_t>();
 
-        upsample_bilinear2d_backward_out_frame<scalar_t>(
+        auto kernel = memory_format == at::MemoryFormat::ChannelsLast
+            ? upsample_bilinear2d_backward_out_frame_channels_last<scalar_t>
+            : upsample_bilinear2d_backward_out_frame<scalar_t>;
+        kernel(
             odata,
             idata,
             input_height,
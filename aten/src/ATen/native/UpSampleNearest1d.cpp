@@ -1,11 +1,15 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/UpSample.h>
 
 namespace at {
 namespace native {
 namespace {
 
+// Every output row (of a channel of an image) is written by a single thread,
+// so the backward pass, which accumulates into the input rows, doesn't need
+// to synchronize.
 template <typename scalar_t>
 static void upsample_nearest1d_out_frame(
     scalar_t* odata,
@@ -20,33 +24,25 @@ static void upsample_nearest1d_out_frame(
 
   // special case: just copy
   if (input_width == output_width) {
-    for (int64_t w2 = 0; w2 < output_width; ++w2) {
-      const int64_t w1 = w2;
-      const scalar_t* pos1 = &idata[w1];
-      scalar_t* pos2 = &odata[w2];
-
-      for (int64_t c = 0; c < channels; ++c) {
-        pos2[0] = pos1[0];
-        pos1 += input_width;
-        pos2 += output_width;
-      }
-    }
+    std::copy(idata, idata + channels * input_width, odata);
     return;
   }
 
-  for (int64_t w2 = 0; w2 < output_width; ++w2) {
-    const scalar_t src_x =
-        nearest_neighbor_compute_source_index(scale, w2, input_width);
-    const int64_t w1 = src_x;
-    const scalar_t* pos1 = &idata[w1];
-    scalar_t* pos2 = &odata[w2];
-
-    for (int64_t c = 0; c < channels; ++c) {
-      pos2[0] = pos1[0];
-      pos1 += input_width;
-      pos2 += output_width;
+  const auto w_index =
+      nearest_neighbor_compute_source_indices(scale, input_width, output_width);
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / output_width);
+
+  at::parallel_for(0, channels, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t c = start; c < end; ++c) {
+      const scalar_t* in = idata + c * input_width;
+      scalar_t* out = odata + c * output_width;
+
+      for (int64_t w2 = 0; w2 < output_width; ++w2) {
+        out[w2] = in[w_index[w2]];
+      }
     }
-  }
+  });
 }
 
 template <typename scalar_t>
@@ -63,33 +59,25 @@ static void upsample_nearest1d_backward_out_frame(
 
   // special case: same-size matching grids
   if (input_width == output_width) {
-    for (int64_t w2 = 0; w2 < output_width; ++w2) {
-      const int64_t w1 = w2;
-      scalar_t* pos1 = &idata[w1];
-      const scalar_t* pos2 = &odata[w2];
-
-      for (int64_t c = 0; c < channels; ++c) {
-        pos1[0] += pos2[0];
-        pos1 += input_width;
-        pos2 += output_width;
-      }
-    }
+    std::copy(odata, odata + channels * output_width, idata);
     return;
   }
 
-  for (int64_t w2 = 0; w2 < output_width; ++w2) {
-    const int64_t w1 =
-        nearest_neighbor_compute_source_index(scale, w2, input_width);
+  const auto w_index =
+      nearest_neighbor_compute_source_indices(scale, input_width, output_width);
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / output_width);
 
-    scalar_t* pos1 = &idata[w1];
-    const scalar_t* pos2 = &odata[w2];
+  at::parallel_for(0, channels, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t c = start; c < end; ++c) {
+      scalar_t* in = idata + c * input_width;
+      const scalar_t* out = odata + c * output_width;
 
-    for (int64_t c = 0; c < channels; ++c) {
-      pos1[0] += pos2[0];
-      pos1 += input_width;
-      pos2 += output_width;
+      for (int64_t w2 = 0; w2 < output_width; ++w2) {
+        in[w_index[w2]] += out[w2];
+      }
     }
-  }
+  });
 }
 
 static void upsample_nearest1d_out_cpu_template(
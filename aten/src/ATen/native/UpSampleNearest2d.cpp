@@ -1,11 +1,15 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/UpSample.h>
 
 namespace at {
 namespace native {
 namespace {
 
+// Every output plane (of a channel of an image) is written by a single
+// thread, so the backward pass, which accumulates into the input planes,
+// doesn't need to synchronize.
 template <typename scalar_t>
 static void upsample_nearest2d_out_frame(
     scalar_t* odata,
@@ -25,42 +29,32 @@ static void upsample_nearest2d_out_frame(
 
   // special case: just copy
   if (input_height == output_height && input_width == output_width) {
-    for (int64_t h2 = 0; h2 < output_height; ++h2) {
-      const int64_t h1 = h2;
-
-      for (int64_t w2 = 0; w2 < output_width; ++w2) {
-        const int64_t w1 = w2;
-        const scalar_t* pos1 = &idata[h1 * input_width + w1];
-        scalar_t* pos2 = &odata[h2 * output_width + w2];
-
-        for (int64_t c = 0; c < channels; ++c) {
-          pos2[0] = pos1[0];
-          pos1 += input_height * input_width;
-          pos2 += output_height * output_width;
-        }
-      }
-    }
+    std::copy(idata, idata + channels * input_height * input_width, odata);
     return;
   }
 
-  for (int64_t h2 = 0; h2 < output_height; ++h2) {
-    const int64_t h1 =
-        nearest_neighbor_compute_source_index(height_scale, h2, input_height);
+  const auto h_index = nearest_neighbor_compute_source_indices(
+      height_scale, input_height, output_height);
+  const auto w_index =
+      nearest_neighbor_compute_source_indices(width_scale, input_width, output_width);
 
-    for (int64_t w2 = 0; w2 < output_width; ++w2) {
-      const int64_t w1 =
-          nearest_neighbor_compute_source_index(width_scale, w2, input_width);
+  const int64_t input_plane = input_height * input_width;
+  const int64_t output_plane = output_height * output_width;
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / output_plane);
 
-      const scalar_t* pos1 = &idata[h1 * input_width + w1];
-      scalar_t* pos2 = &odata[h2 * output_width + w2];
+  at::parallel_for(0, channels, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t c = start; c < end; ++c) {
+      for (int64_t h2 = 0; h2 < output_height; ++h2) {
+        const scalar_t* in = idata + c * input_plane + h_index[h2] * input_width;
+        scalar_t* out = odata + c * output_plane + h2 * output_width;
 
-      for (int64_t c = 0; c < channels; ++c) {
-        pos2[0] = pos1[0];
-        pos1 += input_height * input_width;
-        pos2 += output_height * output_width;
+        for (int64_t w2 = 0; w2 < output_width; ++w2) {
+          out[w2] = in[w_index[w2]];
+        }
       }
     }
-  }
+  });
 }
 
 template <typename scalar_t>
@@ -83,41 +77,32 @@ static void upsample_nearest2d_backward_out_frame(
 
   // special case: just copy
   if (input_height == output_height && input_width == output_width) {
-    for (int64_t h2 = 0; h2 < output_height; ++h2) {
-      const int64_t h1 = h2;
-
-      for (int64_t w2 = 0; w2 < output_width; ++w2) {
-        const int64_t w1 = w2;
-        scalar_t* pos1 = &idata[h1 * input_width + w1];
-        const scalar_t* pos2 = &odata[h2 * output_width + w2];
-
-        for (int64_t c = 0; c < channels; ++c) {
-          pos1[0] = pos2[0];
-          pos1 += input_height * input_width;
-          pos2 += output_height * output_width;
-        }
-      }
-    }
+    std::copy(odata, odata + channels * output_height * output_width, idata);
     return;
   }
 
-  for (int64_t h2 = 0; h2 < output_height; ++h2) {
-    const int64_t h1 =
-        nearest_neighbor_compute_source_index(height_scale, h2, input_height);
+  const auto h_index = nearest_neighbor_compute_source_indices(
+      height_scale, input_height, output_height);
+  const auto w_index =
+      nearest_neighbor_compute_source_indices(width_scale, input_width, output_width);
+
+  const int64_t input_plane = input_height * input_width;
+  const int64_t output_plane = output_height * output_width;
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / output_plane);
 
-    for (int64_t w2 = 0; w2 < output_width; ++w2) {
-      const int64_t w1 =
-          nearest_neighbor_compute_source_index(width_scale, w2, input_width);
-      scalar_t* pos1 = &idata[h1 * input_width + w1];
-      const scalar_t* pos2 = &odata[h2 * output_width + w2];
+  at::parallel_for(0, channels, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t c = start; c < end; ++c) {
+      for (int64_t h2 = 0; h2 < output_height; ++h2) {
+        scalar_t* in = idata + c * input_plane + h_index[h2] * input_width;
+        const scalar_t* out = odata + c * output_plane + h2 * output_width;
 
-      for (int64_t c = 0; c < channels; ++c) {
-        pos1[0] += pos2[0];
-        pos1 += input_height * input_width;
-        pos2 += output_height * output_width;
+        for (int64_t w2 = 0; w2 < output_width; ++w2) {
+          in[w_index[w2]] += out[w2];
+        }
       }
     }
-  }
+  });
 }
 
 static void upsample_nearest2d_out_cpu_template(
@@ -1,11 +1,15 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/UpSample.h>
 
 namespace at {
 namespace native {
 namespace {
 
+// Every output volume (of a channel of an image) is written by a single
+// thread, so the backward pass, which accumulates into the input volumes,
+// doesn't need to synchronize.
 template <typename scalar_t>
 static void upsample_nearest3d_out_frame(
     scalar_t* odata,
@@ -30,55 +34,39 @@ static void upsample_nearest3d_out_frame(
   // special case: just copy
   if (input_depth == output_depth && input_height == output_height &&
       input_width == output_width) {
-    for (int64_t d2 = 0; d2 < output_depth; ++d2) {
-      const int64_t d1 = d2;
-
-      for (int64_t h2 = 0; h2 < output_height; ++h2) {
-        const int64_t h1 = h2;
-
-        for (int64_t w2 = 0; w2 < output_width; ++w2) {
-          const int64_t w1 = w2;
-          const scalar_t* pos1 =
-              &idata[d1 * input_height * input_width + h1 * input_width + w1];
-          scalar_t* pos2 =
-              &odata
-                  [d2 * output_height * output_width + h2 * output_width + w2];
-
-          for (int64_t c = 0; c < channels; ++c) {
-            pos2[0] = pos1[0];
-            pos1 += input_depth * input_height * input_width;
-            pos2 += output_depth * output_height * output_width;
-          }
-        }
-      }
-    }
+    std::copy(
+        idata, idata + channels * input_depth * input_height * input_width, odata);
     return;
   }
 
-  for (int64_t d2 = 0; d2 < output_depth; ++d2) {
-    const int64_t d1 =
-        nearest_neighbor_compute_source_index(depth_scale, d2, input_depth);
-
-    for (int64_t h2 = 0; h2 < output_height; ++h2) {
-      const int64_t h1 =
-          nearest_neighbor_compute_source_index(height_scale, h2, input_height);
-
-      for (int64_t w2 = 0; w2 < output_width; ++w2) {
-        const int64_t w1 =
-            nearest_neighbor_compute_source_index(width_scale, w2, input_width);
-        const scalar_t* pos1 =
-            &idata[d1 * input_height * input_width + h1 * input_width + w1];
-        scalar_t* pos2 =
-            &odata[d2 * output_height * output_width + h2 * output_width + w2];
-
-        for (int64_t c = 0; c < channels; ++c) {
-          pos2[0] = pos1[0];
-          pos1 += input_depth * input_height * input_width;
-          pos2 += output_depth * output_height * output_width;
+  const auto d_index =
+      nearest_neighbor_compute_source_indices(depth_scale, input_depth, output_depth);
+  const auto h_index = nearest_neighbor_compute_source_indices(
+      height_scale, input_height, output_height);
+  const auto w_index =
+      nearest_neighbor_compute_source_indices(width_scale, input_width, output_width);
+
+  const int64_t input_volume = input_depth * input_height * input_width;
+  const int64_t output_volume = output_depth * output_height * output_width;
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / output_volume);
+
+  at::parallel_for(0, channels, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t c = start; c < end; ++c) {
+      for (int64_t d2 = 0; d2 < output_depth; ++d2) {
+        for (int64_t h2 = 0; h2 < output_height; ++h2) {
+          const scalar_t* in = idata + c * input_volume +
+              (d_index[d2] * input_height + h_index[h2]) * input_width;
+          scalar_t* out = odata + c * output_volume +
+              (d2 * output_height + h2) * output_width;
+
+          for (int64_t w2 = 0; w2 < output_width; ++w2) {
+            out[w2] = in[w_index[w2]];
+          }
         }
       }
     }
-  }
+  });
 }
 
 template <typename scalar_t>
@@ -105,55 +93,39 @@ static void upsample_nearest3d_backward_out_frame(
   // special case: just copy
   if (input_depth == output_depth && input_height == output_height &&
       input_width == output_width) {
-    for (int64_t d2 = 0; d2 < output_depth; ++d2) {
-      const int64_t d1 = d2;
-
-      for (int64_t h2 = 0; h2 < output_height; ++h2) {
-        const int64_t h1 = h2;
-
-        for (int64_t w2 = 0; w2 < output_width; ++w2) {
-          const int64_t w1 = w2;
-          scalar_t* pos1 =
-              &idata[d1 * input_height * input_width + h1 * input_width + w1];
-          const scalar_t* pos2 =
-              &odata
-                  [d2 * output_height * output_width + h2 * output_width + w2];
-
-          for (int64_t c = 0; c < channels; ++c) {
-            pos1[0] += pos2[0];
-            pos1 += input_depth * input_height * input_width;
-            pos2 += output_depth * output_height * output_width;
-          }
-        }
-      }
-    }
+    std::copy(
+        odata, odata + channels * output_depth * output_height * output_width, idata);
     return;
   }
 
-  for (int64_t d2 = 0; d2 < output_depth; ++d2) {
-    const int64_t d1 =
-        nearest_neighbor_compute_source_index(depth_scale, d2, input_depth);
-
-    for (int64_t h2 = 0; h2 < output_height; ++h2) {
-      const int64_t h1 =
-          nearest_neighbor_compute_source_index(height_scale, h2, input_height);
-
-      for (int64_t w2 = 0; w2 < output_width; ++w2) {
-        const int64_t w1 =
-            nearest_neighbor_compute_source_index(width_scale, w2, input_width);
-        scalar_t* pos1 =
-            &idata[d1 * input_height * input_width + h1 * input_width + w1];
-        const scalar_t* pos2 =
-            &odata[d2 * output_height * output_width + h2 * output_width + w2];
-
-        for (int64_t c = 0; c < channels; ++c) {
-          pos1[0] += pos2[0];
-          pos1 += input_depth * input_height * input_width;
-          pos2 += output_depth * output_height * output_width;
+  const auto d_index =
+      nearest_neighbor_compute_source_indices(depth_scale, input_depth, output_depth);
+  const auto h_index = nearest_neighbor_compute_source_indices(
+      height_scale, input_height, output_height);
+  const auto w_index =
+      nearest_neighbor_compute_source_indices(width_scale, input_width, output_width);
+
+  const int64_t input_volume = input_depth * input_height * input_width;
+  const int64_t output_volume = output_depth * output_height * output_width;
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / output_volume);
+
+  at::parallel_for(0, channels, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t c = start; c < end; ++c) {
+      for (int64_t d2 = 0; d2 < output_depth; ++d2) {
+        for (int64_t h2 = 0; h2 < output_height; ++h2) {
+          scalar_t* in = idata + c * input_volume +
+              (d_index[d2] * input_height + h_index[h2]) * input_width;
+          const scalar_t* out = odata + c * output_volume +
+              (d2 * output_height + h2) * output_width;
+
+          for (int64_t w2 = 0; w2 < output_width; ++w2) {
+            in[w_index[w2]] += out[w2];
+          }
         }
       }
     }
-  }
+  });
 }
 
 static void upsample_nearest3d_out_cpu_template(
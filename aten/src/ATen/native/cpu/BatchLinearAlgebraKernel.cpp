@@ -0,0 +1,334 @@
+#include <ATen/native/BatchLinearAlgebra.h>
+
+#include <algorithm>
+#include <type_traits>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec.h>
+#include <ATen/native/LinearAlgebraUtils.h>
+
+namespace at { namespace native {
+
+namespace {
+
+// The kernels below work on blocks of Vec::size() matrices, one matrix per
+// lane: element e (column major) of every matrix in the block is held by
+// block[e]. Pivoting is done per lane with blends, so all the lanes run the
+// same instruction stream. Lanes past the end of the batch are filled with
+// the identity (and zero right hand sides) so that they never report an error.
+
+template <typename scalar_t>
+void load_block(vec::Vectorized<scalar_t>* block, const scalar_t* data, int64_t stride,
+                int64_t count, int64_t numel, int64_t diag_step) {
+  using Vec = vec::Vectorized<scalar_t>;
+  scalar_t buffer[Vec::size()];
+  for (int64_t e = 0; e < numel; ++e) {
+    for (int64_t l = 0; l < count; ++l) {
+      buffer[l] = data[l * stride + e];
+    }
+    const scalar_t fill = (diag_step > 0 && e % diag_step == 0) ? scalar_t(1) : scalar_t(0);
+    for (int64_t l = count; l < Vec::size(); ++l) {
+      buffer[l] = fill;
+    }
+    block[e] = Vec::loadu(buffer);
+  }
+}
+
+template <typename scalar_t>
+void store_block(const vec::Vectorized<scalar_t>* block, scalar_t* data, int64_t stride,
+                 int64_t count, int64_t numel) {
+  using Vec = vec::Vectorized<scalar_t>;
+  scalar_t buffer[Vec::size()];
+  for (int64_t e = 0; e < numel; ++e) {
+    block[e].store(buffer);
+    for (int64_t l = 0; l < count; ++l) {
+      data[l * stride + e] = buffer[l];
+    }
+  }
+}
+
+// Sets info to value in the lanes of mask that have not failed yet, so that
+// info keeps the first failing step like LAPACK does.
+template <typename scalar_t>
+inline void record_info(vec::Vectorized<scalar_t>& info, const vec::Vectorized<scalar_t>& mask, int64_t value) {
+  using Vec = vec::Vectorized<scalar_t>;
+  info = Vec::blendv(Vec::blendv(info, Vec(scalar_t(value)), mask), info, info != Vec(scalar_t(0)));
+}
+
+// In place LU factorization with partial pivoting (getrf). piv[k] holds the
+// 0-based row swapped with row k; info is the 1-based index of the first zero
+// pivot, or 0.
+template <typename scalar_t, int N>
+void lu_block(vec::Vectorized<scalar_t>* a, vec::Vectorized<scalar_t>* piv, vec::Vectorized<scalar_t>& info) {
+  using Vec = vec::Vectorized<scalar_t>;
+  const Vec zero(scalar_t(0));
+  const Vec one(scalar_t(1));
+  info = zero;
+  for (int k = 0; k < N; ++k) {
+    // First row with the largest |a(i, k)|, as i?amax picks it.
+    Vec best = a[k + k * N].abs();
+    Vec p = Vec(scalar_t(k));
+    for (int i = k + 1; i < N; ++i) {
+      const Vec candidate = a[i + k * N].abs();
+      const Vec larger = candidate > best;
+      best = Vec::blendv(best, candidate, larger);
+      p = Vec::blendv(p, Vec(scalar_t(i)), larger);
+    }
+    piv[k] = p;
+    for (int i = k + 1; i < N; ++i) {
+      const Vec swap = p == Vec(scalar_t(i));
+      for (int j = 0; j < N; ++j) {
+        const Vec row_k = a[k + j * N];
+        const Vec row_i = a[i + j * N];
+        a[k + j * N] = Vec::blendv(row_k, row_i, swap);
+        a[i + j * N] = Vec::blendv(row_i, row_k, swap);
+      }
+    }
+    // A zero pivot means the rest of the column is zero too; LAPACK leaves
+    // it unscaled and carries on.
+    const Vec singular = a[k + k * N] == zero;
+    record_info(info, singular, k + 1);
+    const Vec inv_pivot = Vec::blendv(one / a[k + k * N], zero, singular);
+    for (int i = k + 1; i < N; ++i) {
+      a[i + k * N] = a[i + k * N] * inv_pivot;
+    }
+    for (int j = k + 1; j < N; ++j) {
+      for (int i = k + 1; i < N; ++i) {
+        a[i + j * N] = a[i + j * N] - a[i + k * N] * a[k + j * N];
+      }
+    }
+  }
+}
+
+// Solves a x = b for one right hand side given the output of lu_block.
+template <typename scalar_t, int N>
+void lu_solve_block(const vec::Vectorized<scalar_t>* lu, const vec::Vectorized<scalar_t>* piv,
+                    vec::Vectorized<scalar_t>* b) {
+  using Vec = vec::Vectorized<scalar_t>;
+  for (int k = 0; k < N; ++k) {
+    for (int i = k + 1; i < N; ++i) {
+      const Vec swap = piv[k] == Vec(scalar_t(i));
+      const Vec b_k = b[k];
+      b[k] = Vec::blendv(b_k, b[i], swap);
+      b[i] = Vec::blendv(b[i], b_k, swap);
+    }
+  }
+  for (int i = 1; i < N; ++i) {
+    for (int k = 0; k < i; ++k) {
+      b[i] = b[i] - lu[i + k * N] * b[k];
+    }
+  }
+  for (int i = N - 1; i >= 0; --i) {
+    for (int k = i + 1; k < N; ++k) {
+      b[i] = b[i] - lu[i + k * N] * b[k];
+    }
+    b[i] = b[i] / lu[i + i * N];
+  }
+}
+
+template <typename scalar_t, int N, typename F>
+void for_each_block(int64_t batch_size, const F& f) {
+  using Vec = vec::Vectorized<scalar_t>;
+  const int64_t num_blocks = (batch_size + Vec::size() - 1) / Vec::size();
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / (Vec::size() * N * N * N));
+  at::parallel_for(0, num_blocks, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t block = begin; block < end; ++block) {
+      const int64_t first = block * Vec::size();
+      f(first, std::min<int64_t>(Vec::size(), batch_size - first));
+    }
+  });
+}
+
+template <typename scalar_t>
+void store_infos(const vec::Vectorized<scalar_t>& info, int64_t* infos, int64_t count) {
+  scalar_t buffer[vec::Vectorized<scalar_t>::size()];
+  info.store(buffer);
+  for (int64_t l = 0; l < count; ++l) {
+    infos[l] = static_cast<int64_t>(buffer[l]);
+  }
+}
+
+template <typename scalar_t, int N>
+void small_lu_impl(Tensor& self, int* pivots, int* infos) {
+  using Vec = vec::Vectorized<scalar_t>;
+  scalar_t* data = self.data_ptr<scalar_t>();
+  const int64_t stride = matrixStride(self);
+  for_each_block<scalar_t, N>(batchCount(self), [&](int64_t first, int64_t count) {
+    Vec a[N * N];
+    Vec piv[N];
+    Vec info;
+    load_block(a, data + first * stride, stride, count, N * N, N + 1);
+    lu_block<scalar_t, N>(a, piv, info);
+    store_block(a, data + first * stride, stride, count, N * N);
+    scalar_t buffer[Vec::size()];
+    for (int k = 0; k < N; ++k) {
+      piv[k].store(buffer);
+      for (int64_t l = 0; l < count; ++l) {
+        pivots[(first + l) * N + k] = static_cast<int>(buffer[l]) + 1;
+      }
+    }
+    info.store(buffer);
+    for (int64_t l = 0; l < count; ++l) {
+      infos[first + l] = static_cast<int>(buffer[l]);
+    }
+  });
+}
+
+template <typename scalar_t, int N>
+void small_solve_impl(Tensor& b, Tensor& A, int64_t* infos) {
+  using Vec = vec::Vectorized<scalar_t>;
+  scalar_t* A_data = A.data_ptr<scalar_t>();
+  scalar_t* b_data = b.data_ptr<scalar_t>();
+  const int64_t A_stride = matrixStride(A);
+  const int64_t b_stride = matrixStride(b);
+  const int64_t nrhs = b.size(-1);
+  for_each_block<scalar_t, N>(batchCount(A), [&](int64_t first, int64_t count) {
+    Vec a[N * N];
+    Vec piv[N];
+    Vec info;
+    load_block(a, A_data + first * A_stride, A_stride, count, N * N, N + 1);
+    lu_block<scalar_t, N>(a, piv, info);
+    store_block(a, A_data + first * A_stride, A_stride, count, N * N);
+    for (int64_t c = 0; c < nrhs; ++c) {
+      Vec x[N];
+      scalar_t* b_column = b_data + first * b_stride + c * N;
+      load_block(x, b_column, b_stride, count, N, 0);
+      lu_solve_block<scalar_t, N>(a, piv, x);
+      store_block(x, b_column, b_stride, count, N);
+    }
+    store_infos(info, infos + first, count);
+  });
+}
+
+template <typename scalar_t, int N>
+void small_inverse_impl(Tensor& self, int64_t* infos) {
+  using Vec = vec::Vectorized<scalar_t>;
+  scalar_t* data = self.data_ptr<scalar_t>();
+  const int64_t stride = matrixStride(self);
+  for_each_block<scalar_t, N>(batchCount(self), [&](int64_t first, int64_t count) {
+    Vec a[N * N];
+    Vec piv[N];
+    Vec info;
+    load_block(a, data + first * stride, stride, count, N * N, N + 1);
+    lu_block<scalar_t, N>(a, piv, info);
+    Vec inverse[N * N];
+    for (int j = 0; j < N; ++j) {
+      Vec* column = inverse + j * N;
+      for (int i = 0; i < N; ++i) {
+        column[i] = Vec(scalar_t(i == j ? 1 : 0));
+      }
+      lu_solve_block<scalar_t, N>(a, piv, column);
+    }
+    store_block(inverse, data + first * stride, stride, count, N * N);
+    store_infos(info, infos + first, count);
+  });
+}
+
+// potrf: only the lower (or, transposed, the upper) triangle is read and
+// written; info is the order of the first leading minor that is not
+// positive definite.
+template <typename scalar_t, int N>
+void small_cholesky_impl(Tensor& self, bool upper, int64_t* infos) {
+  using Vec = vec::Vectorized<scalar_t>;
+  scalar_t* data = self.data_ptr<scalar_t>();
+  const int64_t stride = matrixStride(self);
+  const Vec zero(scalar_t(0));
+  const Vec one(scalar_t(1));
+  for_each_block<scalar_t, N>(batchCount(self), [&](int64_t first, int64_t count) {
+    Vec a[N * N];
+    load_block(a, data + first * stride, stride, count, N * N, N + 1);
+    if (upper) {
+      for (int j = 0; j < N; ++j) {
+        for (int i = j + 1; i < N; ++i) {
+          std::swap(a[i + j * N], a[j + i * N]);
+        }
+      }
+    }
+    Vec info = zero;
+    for (int j = 0; j < N; ++j) {
+      Vec d = a[j + j * N];
+      for (int k = 0; k < j; ++k) {
+        d = d - a[j + k * N] * a[j + k * N];
+      }
+      // d > 0 is false for NaN as well.
+      record_info(info, Vec::blendv(one, zero, d > zero) == one, j + 1);
+      const Vec diag = d.sqrt();
+      a[j + j * N] = diag;
+      const Vec inv_diag = one / diag;
+      for (int i = j + 1; i < N; ++i) {
+        Vec s = a[i + j * N];
+        for (int k = 0; k < j; ++k) {
+          s = s - a[i + k * N] * a[j + k * N];
+        }
+        a[i + j * N] = s * inv_diag;
+      }
+    }
+    if (upper) {
+      for (int j = 0; j < N; ++j) {
+        for (int i = j + 1; i < N; ++i) {
+          std::swap(a[i + j * N], a[j + i * N]);
+        }
+      }
+    }
+    store_block(a, data + first * stride, stride, count, N * N);
+    store_infos(info, infos + first, count);
+  });
+}
+
+template <typename F>
+void dispatch_small_size(int64_t n, const F& f) {
+  switch (n) {
+    case 1: f(std::integral_constant<int, 1>()); break;
+    case 2: f(std::integral_constant<int, 2>()); break;
+    case 3: f(std::integral_constant<int, 3>()); break;
+    case 4: f(std::integral_constant<int, 4>()); break;
+    case 5: f(std::integral_constant<int, 5>()); break;
+    case 6: f(std::integral_constant<int, 6>()); break;
+    case 7: f(std::integral_constant<int, 7>()); break;
+    case 8: f(std::integral_constant<int, 8>()); break;
+    default: TORCH_INTERNAL_ASSERT(false, "no small matrix kernel for size ", n);
+  }
+}
+
+void small_lu_kernel(Tensor& self, int* pivots, int* infos) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "small_lu_cpu", [&] {
+    dispatch_small_size(self.size(-1), [&](auto size) {
+      small_lu_impl<scalar_t, decltype(size)::value>(self, pivots, infos);
+    });
+  });
+}
+
+void small_solve_kernel(Tensor& b, Tensor& A, int64_t* infos) {
+  AT_DISPATCH_FLOATING_TYPES(A.scalar_type(), "small_solve_cpu", [&] {
+    dispatch_small_size(A.size(-1), [&](auto size) {
+      small_solve_impl<scalar_t, decltype(size)::value>(b, A, infos);
+    });
+  });
+}
+
+void small_inverse_kernel(Tensor& self, int64_t* infos) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "small_inverse_cpu", [&] {
+    dispatch_small_size(self.size(-1), [&](auto size) {
+      small_inverse_impl<scalar_t, decltype(size)::value>(self, infos);
+    });
+  });
+}
+
+void small_cholesky_kernel(Tensor& self, bool upper, int64_t* infos) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "small_cholesky_cpu", [&] {
+    dispatch_small_size(self.size(-1), [&](auto size) {
+      small_cholesky_impl<scalar_t, decltype(size)::value>(self, upper, infos);
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(small_lu_stub, &small_lu_kernel);
+REGISTER_DISPATCH(small_solve_stub, &small_solve_kernel);
+REGISTER_DISPATCH(small_inverse_stub, &small_inverse_kernel);
+REGISTER_DISPATCH(small_cholesky_stub, &small_cholesky_kernel);
+
+}} // namespace at::native
@@ -2,8 +2,7 @@
 #include <iostream>
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
-#include <ATen/cpu/vec256/vec256.h>
-#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/BinaryOps.h>
 #include <ATen/native/cpu/Loops.h>
@@ -11,8 +10,6 @@
 namespace at { namespace native {
 namespace {
 
-using namespace vec256;
-
 void add_kernel(TensorIterator& iter, Scalar alpha_scalar) {
   if (iter.dtype() == ScalarType::Bool) {
       using scalar_t = bool;
@@ -22,11 +19,11 @@ void add_kernel(TensorIterator& iter, Scalar alpha_scalar) {
   } else {
     AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kBFloat16, iter.dtype(), "add_cpu/sub_cpu", [&]() {
       auto alpha = alpha_scalar.to<scalar_t>();
-      auto alpha_vec = Vec256<scalar_t>(alpha);
+      auto alpha_vec = vec::Vectorized<scalar_t>(alpha);
       cpu_kernel_vec(iter,
         [=](scalar_t a, scalar_t b) -> scalar_t { return a + alpha * b; },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
-          return vec256::fmadd(b, alpha_vec, a);
+        [=](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) {
+          return vec::fmadd(b, alpha_vec, a);
         });
       });
   }
@@ -37,7 +34,7 @@ void atan2_kernel(TensorIterator& iter) {
     cpu_kernel_vec(iter, [=](scalar_t a, scalar_t b) -> scalar_t {
     return std::atan2(a, b);
   },
-    [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+    [=](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) {
       return a.atan2(b);
     });
   });
@@ -54,7 +51,7 @@ void mul_kernel(TensorIterator& iter) {
     AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kBFloat16, iter.dtype(), "mul_cpu", [&]() {
       cpu_kernel_vec(iter,
         [=](scalar_t a, scalar_t b) -> scalar_t { return a * b; },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+        [=](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) {
           return a * b;
         });
     });
@@ -77,7 +74,7 @@ void div_kernel(TensorIterator& iter) {
           [=](scalar_t a, scalar_t b) __ubsan_ignore_float_divide_by_zero__ -> scalar_t {
              return a / b;
           },
-          [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+          [=](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) {
             return a / b;
           });
       });
@@ -87,7 +84,7 @@ void div_kernel(TensorIterator& iter) {
         [=](scalar_t a, scalar_t b) __ubsan_ignore_float_divide_by_zero__ -> scalar_t {
            return a / b;
         },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+        [=](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) {
           return a / b;
         });
     });
@@ -108,7 +105,7 @@ void bitwise_and_kernel(TensorIterator& iter) {
           [](scalar_t a, scalar_t b) -> scalar_t {
             return a & b;
           },
-          [](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+          [](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) {
             return a & b;
           });
     });
@@ -129,7 +126,7 @@ void bitwise_or_kernel(TensorIterator& iter) {
           [](scalar_t a, scalar_t b) -> scalar_t {
             return a | b;
           },
-          [](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+          [](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) {
             return a | b;
           });
     });
@@ -152,7 +149,7 @@ void bitwise_xor_kernel(TensorIterator& iter) {
           [](scalar_t a, scalar_t b) -> scalar_t {
             return a ^ b;
           },
-          [](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+          [](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) {
             return a ^ b;
           });
     });
@@ -183,13 +180,13 @@ static inline int64_t lshift_wrapper(int64_t a, int64_t b) {
 void lshift_kernel(TensorIterator& iter) {
   if (iter.dtype() == ScalarType::Float || iter.dtype() == ScalarType::Double) {
     AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "lshift_cpu", [&]() {
-      auto base_vec = Vec256<scalar_t>((scalar_t)(2));
+      auto base_vec = vec::Vectorized<scalar_t>((scalar_t)(2));
       cpu_kernel_vec(
         iter,
         [=](scalar_t a, scalar_t b) -> scalar_t {
           return a * std::pow((scalar_t)(2), b);
         },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+        [=](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) {
           return a * base_vec.pow(b);
       });
     });
@@ -287,13 +284,13 @@ static inline int64_t rshift_wrapper(int64_t a, int64_t b) {
 void rshift_kernel(TensorIterator& iter) {
   if (iter.dtype() == ScalarType::Float || iter.dtype() == ScalarType::Double) {
     AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "rshift_cpu", [&]() {
-      auto base_vec = Vec256<scalar_t>((scalar_t)(2));
+      auto base_vec = vec::Vectorized<scalar_t>((scalar_t)(2));
       cpu_kernel_vec(
         iter,
         [=](scalar_t a, scalar_t b) -> scalar_t {
           return a / std::pow((scalar_t)(2), b);
         },
-        [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+        [=](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) {
           return a / base_vec.pow(b);
       });
     });
@@ -425,10 +422,10 @@ void max_elementwise_kernel(TensorIterator& iter) {
     AT_DISPATCH_INTEGRAL_TYPES(iter.dtype(), "max_lementwise_cpu", [&]() {
       cpu_kernel_vec(iter,
         [](scalar_t a, scalar_t b) -> scalar_t { return std::max(a, b); },
-        [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return at::vec256::maximum(a, b); });
+        [](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) { return vec::maximum(a, b); });
     });
   } else {
-    AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "max_elementwise_cpu", [&]() {
+    AT_DISPATCH_FLOATING_TYPES_AND(kBFloat16, iter.dtype(), "max_elementwise_cpu", [&]() {
       cpu_kernel_vec(iter,
         [](scalar_t a, scalar_t b) -> scalar_t {
           if (std::isnan(a) || std::isnan(b)) {
@@ -437,7 +434,7 @@ void max_elementwise_kernel(TensorIterator& iter) {
             return std::max(a, b);
           }
         },
-        [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return at::vec256::maximum(a, b); });
+        [](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) { return vec::maximum(a, b); });
     });
   }
 }
@@ -452,10 +449,10 @@ void min_elementwise_kernel(TensorIterator& iter) {
     AT_DISPATCH_INTEGRAL_TYPES(iter.dtype(), "min_elementwise_cpu", [&]() {
       cpu_kernel_vec(iter,
         [](scalar_t a, scalar_t b) -> scalar_t { return std::min(a, b); },
-        [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return at::vec256::minimum(a, b); });
+        [](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) { return vec::minimum(a, b); });
     });
   } else {
-    AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "min_elementwise_cpu", [&]() {
+    AT_DISPATCH_FLOATING_TYPES_AND(kBFloat16, iter.dtype(), "min_elementwise_cpu", [&]() {
       cpu_kernel_vec(iter,
         [](scalar_t a, scalar_t b) -> scalar_t {
           if (std::isnan(a) || std::isnan(b)) {
@@ -464,7 +461,7 @@ void min_elementwise_kernel(TensorIterator& iter) {
             return std::min(a, b);
           }
         },
-        [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return at::vec256::minimum(a, b); });
+        [](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) { return vec::minimum(a, b); });
     });
   }
 }
@@ -479,39 +476,39 @@ void smooth_l1_kernel(TensorIterator& iter) {
 }
 
 void sigmoid_backward_kernel(TensorIterator& iter) {
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(iter.dtype(), "sigmoid_backward_cpu", [&]() {
-    auto one_vec = Vec256<scalar_t>((scalar_t)(1));
+  AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, iter.dtype(), "sigmoid_backward_cpu", [&]() {
+    auto one_vec = vec::Vectorized<scalar_t>((scalar_t)(1));
     cpu_kernel_vec(iter,
       [=](scalar_t a, scalar_t b) -> scalar_t {
         return a * (scalar_t(1) - b) * b;
       },
-      [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+      [=](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) {
         return a * (one_vec - b) * b;
       });
   });
 }
 
 void tanh_backward_kernel(TensorIterator& iter) {
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(iter.dtype(), "tanh_backward_cpu", [&]() {
-    auto one_vec = Vec256<scalar_t>((scalar_t)(1));
+  AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, iter.dtype(), "tanh_backward_cpu", [&]() {
+    auto one_vec = vec::Vectorized<scalar_t>((scalar_t)(1));
     cpu_kernel_vec(iter,
       [=](scalar_t a, scalar_t b) -> scalar_t {
         return a * (scalar_t(1) - b * b);
       },
-      [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+      [=](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) {
         return a * (one_vec - b * b);
       });
   });
 }
 
 void mse_kernel(TensorIterator& iter) {
-  AT_DISPATCH_FLOATING_TYPES_AND_HALF(iter.dtype(), "mse_cpu", [&]() {
+  AT_DISPATCH_FLOATING_TYPES_AND2(kHalf, kBFloat16, iter.dtype(), "mse_cpu", [&]() {
     cpu_kernel_vec(iter,
       [=](scalar_t a, scalar_t b) -> scalar_t {
         auto diff = a - b;
         return diff * diff;
       },
-      [=](Vec256<scalar_t> a, Vec256<scalar_t> b) {
+      [=](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) {
       auto diff =  a - b;
       return diff * diff;
       });
@@ -1,6 +1,9 @@
 #include <ATen/ATen.h>
 
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec.h>
+#include <ATen/cpu/vec256/vec256.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
@@ -10,8 +13,81 @@ namespace at {
 namespace native {
 namespace {
 
+// Edge of the square tiles, in elements, the transposed copies are split in:
+// a tile of the source and one of the destination stay in the L1 cache.
+constexpr int64_t kTransposeTile = 32;
+
+// Copies a tile of `rows` x `cols` elements of a TransposeCopy, in blocks
+// transposed in registers.
+template <typename scalar_t>
+void transpose_tile(
+    const scalar_t* src, int64_t src_ld, scalar_t* dst, int64_t dst_ld,
+    int64_t rows, int64_t cols) {
+  constexpr int64_t block = vec256::Vec256<scalar_t>::size();
+  const int64_t block_rows = rows - rows % block;
+  const int64_t block_cols = cols - cols % block;
+  for (int64_t r = 0; r < block_rows; r += block) {
+    for (int64_t c = 0; c < block_cols; c += block) {
+      vec256::transpose_block(src + r * src_ld + c, src_ld, dst + c * dst_ld + r, dst_ld);
+    }
+  }
+  for (int64_t c = 0; c < cols; c++) {
+    const int64_t begin = c < block_cols ? block_rows : 0;
+    for (int64_t r = begin; r < rows; r++) {
+      dst[c * dst_ld + r] = src[r * src_ld + c];
+    }
+  }
+}
+
+template <typename scalar_t>
+void transpose_copy_kernel(TensorIterator& iter, const TransposeCopy& t) {
+  const scalar_t* src = static_cast<const scalar_t*>(iter.data_ptr(1));
+  scalar_t* dst = static_cast<scalar_t*>(iter.data_ptr(0));
+  const int64_t row_tiles = (t.rows + kTransposeTile - 1) / kTransposeTile;
+  const int64_t col_tiles = (t.cols + kTransposeTile - 1) / kTransposeTile;
+  const int64_t grain_size =
+      std::max<int64_t>(1, at::internal::GRAIN_SIZE / (kTransposeTile * kTransposeTile));
+  at::parallel_for(0, t.batch * row_tiles * col_tiles, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t tile = begin; tile < end; tile++) {
+      const int64_t b = tile / (row_tiles * col_tiles);
+      const int64_t r = (tile / col_tiles) % row_tiles * kTransposeTile;
+      const int64_t c = tile % col_tiles * kTransposeTile;
+      transpose_tile(
+          src + b * t.src_batch_stride + r * t.src_ld + c, t.src_ld,
+          dst + b * t.dst_batch_stride + c * t.dst_ld + r, t.dst_ld,
+          std::min(kTransposeTile, t.rows - r), std::min(kTransposeTile, t.cols - c));
+    }
+  });
+}
+
+// Copies between dtypes converted by vec::convert, e.g. Half and float with
+// F16C, on the contiguous runs of elements.
+template <typename dst_t, typename src_t>
+void convert_copy_kernel(TensorIterator& iter) {
+  iter.for_each([](char** data, const int64_t* strides, int64_t n) {
+    if (strides[0] == sizeof(dst_t) && strides[1] == sizeof(src_t)) {
+      vec::convert(reinterpret_cast<const src_t*>(data[1]), reinterpret_cast<dst_t*>(data[0]), n);
+      return;
+    }
+    for (int64_t i = 0; i < n; i++) {
+      *reinterpret_cast<dst_t*>(data[0] + i * strides[0]) =
+          static_cast<dst_t>(*reinterpret_cast<const src_t*>(data[1] + i * strides[1]));
+    }
+  });
+}
+
 static void copy_kernel(TensorIterator& iter, bool non_blocking) {
   ScalarType dtype = iter.dtype(0);
+  if (auto transpose = as_transpose_copy(iter)) {
+    // only the bytes are copied, so the elements are moved as floating
+    // point or integer types of the same size
+    switch (iter.element_size(0)) {
+      case 1: return transpose_copy_kernel<uint8_t>(iter, *transpose);
+      case 2: return transpose_copy_kernel<int16_t>(iter, *transpose);
+      case 4: return transpose_copy_kernel<float>(iter, *transpose);
+      case 8: return transpose_copy_kernel<double>(iter, *transpose);
+    }
+  }
   if (dtype == iter.dtype(1)) {
     if (dtype == ScalarType::Half) {
       cpu_kernel(iter, [=](at::Half a) -> at::Half { return a; });
@@ -38,6 +114,10 @@ static void copy_kernel(TensorIterator& iter, bool non_blocking) {
                 [=](Vec256<scalar_t> a) { return a; });
           });
     }
+  } else if (dtype == ScalarType::Float && iter.dtype(1) == ScalarType::Half) {
+    convert_copy_kernel<float, at::Half>(iter);
+  } else if (dtype == ScalarType::Half && iter.dtype(1) == ScalarType::Float) {
+    convert_copy_kernel<at::Half, float>(iter);
   } else {
     AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND3(ScalarType::Half, ScalarType::Bool, ScalarType::BFloat16, dtype, "copy_", [&] {
       using dest_t = scalar_t;
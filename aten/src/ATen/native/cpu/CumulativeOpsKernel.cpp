@@ -0,0 +1,282 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec.h>
+#include <ATen/native/ReduceOps.h>
+
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+
+namespace at { namespace native {
+
+namespace {
+
+// A tensor of sizes (outer, n, inner) is scanned along n, as `outer * inner`
+// independent lines. When there are enough lines to keep every thread busy,
+// or the lines are short, the lines are split among threads. Otherwise each
+// slice of (n, inner) elements of at least this size is scanned by all
+// threads together, in two passes over row chunks: each chunk is reduced,
+// the chunk totals are scanned serially, and each chunk is then scanned
+// starting from the total of the chunks before it.
+constexpr int64_t kParallelScanMinSize = 1 << 15;
+// Rows of a two-pass scan chunk hold at least this many elements.
+constexpr int64_t kParallelScanMinChunk = 1 << 13;
+// Width of the blocks of columns the lines are grouped in when inner > 1.
+constexpr int64_t kColumnBlock = 256;
+
+// Same as TH: floating types accumulate in double and integers in int64,
+// while bool stays bool (cumsum is a running or, cumprod a running and).
+template <typename scalar_t>
+struct ScanAccumulateType {
+  using type = acc_type<scalar_t, /*is_cuda=*/false>;
+};
+template <>
+struct ScanAccumulateType<bool> {
+  using type = bool;
+};
+
+// The loops are written with Vectorized when the accumulation type is the
+// scalar type; with float and double accumulation they are left to the
+// compiler.
+template <typename scalar_t, typename acc_t>
+struct CanVectorize
+    : std::integral_constant<bool,
+          std::is_same<scalar_t, acc_t>::value &&
+          !std::is_same<scalar_t, bool>::value> {};
+
+// Scans `rows` rows of `width` columns, the rows being `row_stride` elements
+// apart, starting from and updating the carries `acc` of the columns.
+template <typename scalar_t, typename acc_t, typename Op, typename VecOp>
+void scan_rows(
+    const scalar_t* in,
+    scalar_t* out,
+    int64_t rows,
+    int64_t width,
+    int64_t row_stride,
+    acc_t* acc,
+    const Op& op,
+    const VecOp& vec_op,
+    std::true_type /*vectorize*/) {
+  using Vec = vec::Vectorized<scalar_t>;
+  if (width == 1) {
+    acc_t a = acc[0];
+    for (int64_t i = 0; i < rows; i++) {
+      a = op(a, in[i * row_stride]);
+      out[i * row_stride] = a;
+    }
+    acc[0] = a;
+    return;
+  }
+  const int64_t vec_width = width - width % Vec::size();
+  for (int64_t i = 0; i < rows; i++) {
+    const scalar_t* in_row = in + i * row_stride;
+    scalar_t* out_row = out + i * row_stride;
+    int64_t j = 0;
+    for (; j < vec_width; j += Vec::size()) {
+      Vec a = vec_op(Vec::loadu(acc + j), Vec::loadu(in_row + j));
+      a.store(acc + j);
+      a.store(out_row + j);
+    }
+    for (; j < width; j++) {
+      acc[j] = op(acc[j], in_row[j]);
+      out_row[j] = acc[j];
+    }
+  }
+}
+
+template <typename scalar_t, typename acc_t, typename Op, typename VecOp>
+void scan_rows(
+    const scalar_t* in,
+    scalar_t* out,
+    int64_t rows,
+    int64_t width,
+    int64_t row_stride,
+    acc_t* acc,
+    const Op& op,
+    const VecOp& /*vec_op*/,
+    std::false_type /*vectorize*/) {
+  for (int64_t i = 0; i < rows; i++) {
+    const scalar_t* in_row = in + i * row_stride;
+    scalar_t* out_row = out + i * row_stride;
+    for (int64_t j = 0; j < width; j++) {
+      acc[j] = op(acc[j], static_cast<acc_t>(in_row[j]));
+      out_row[j] = static_cast<scalar_t>(acc[j]);
+    }
+  }
+}
+
+// Like scan_rows, but only computes the totals of the columns.
+template <typename scalar_t, typename acc_t, typename Op, typename VecOp>
+void reduce_rows(
+    const scalar_t* in,
+    int64_t rows,
+    int64_t width,
+    acc_t* acc,
+    acc_t init,
+    const Op& op,
+    const VecOp& vec_op,
+    std::true_type /*vectorize*/) {
+  using Vec = vec::Vectorized<scalar_t>;
+  if (width == 1) {
+    // the lanes reduce interleaved parts of the column
+    const int64_t vec_rows = rows - rows % Vec::size();
+    Vec lanes(init);
+    for (int64_t i = 0; i < vec_rows; i += Vec::size()) {
+      lanes = vec_op(lanes, Vec::loadu(in + i));
+    }
+    scalar_t lane_values[Vec::size()];
+    lanes.store(lane_values);
+    acc_t a = acc[0];
+    for (int64_t k = 0; k < Vec::size(); k++) {
+      a = op(a, lane_values[k]);
+    }
+    for (int64_t i = vec_rows; i < rows; i++) {
+      a = op(a, in[i]);
+    }
+    acc[0] = a;
+    return;
+  }
+  const int64_t vec_width = width - width % Vec::size();
+  for (int64_t i = 0; i < rows; i++) {
+    const scalar_t* in_row = in + i * width;
+    int64_t j = 0;
+    for (; j < vec_width; j += Vec::size()) {
+      vec_op(Vec::loadu(acc + j), Vec::loadu(in_row + j)).store(acc + j);
+    }
+    for (; j < width; j++) {
+      acc[j] = op(acc[j], in_row[j]);
+    }
+  }
+}
+
+template <typename scalar_t, typename acc_t, typename Op, typename VecOp>
+void reduce_rows(
+    const scalar_t* in,
+    int64_t rows,
+    int64_t width,
+    acc_t* acc,
+    acc_t /*init*/,
+    const Op& op,
+    const VecOp& /*vec_op*/,
+    std::false_type /*vectorize*/) {
+  for (int64_t i = 0; i < rows; i++) {
+    const scalar_t* in_row = in + i * width;
+    for (int64_t j = 0; j < width; j++) {
+      acc[j] = op(acc[j], static_cast<acc_t>(in_row[j]));
+    }
+  }
+}
+
+template <typename scalar_t, typename Op, typename VecOp>
+void cumulative_kernel(
+    Tensor& result,
+    const Tensor& self,
+    int64_t dim,
+    scalar_t identity,
+    const Op& op,
+    const VecOp& vec_op) {
+  using acc_t = typename ScanAccumulateType<scalar_t>::type;
+  using vectorize = CanVectorize<scalar_t, acc_t>;
+  const acc_t init = static_cast<acc_t>(identity);
+
+  int64_t outer = 1;
+  for (int64_t d = 0; d < dim; d++) {
+    outer *= self.size(d);
+  }
+  const int64_t n = self.dim() == 0 ? 1 : self.size(dim);
+  int64_t inner = 1;
+  for (int64_t d = dim + 1; d < self.dim(); d++) {
+    inner *= self.size(d);
+  }
+  const scalar_t* in = self.data_ptr<scalar_t>();
+  scalar_t* out = result.data_ptr<scalar_t>();
+
+  if (outer * inner >= at::get_num_threads() || n * inner < kParallelScanMinSize) {
+    // batch parallelism: lines (or blocks of columns) per thread
+    const int64_t num_blocks = (inner + kColumnBlock - 1) / kColumnBlock;
+    const int64_t block = std::min(inner, kColumnBlock);
+    const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / (n * block));
+    at::parallel_for(0, outer * num_blocks, grain_size, [&](int64_t begin, int64_t end) {
+      // not a std::vector, which does not hold bools as such
+      std::unique_ptr<acc_t[]> acc(new acc_t[block]);
+      for (int64_t task = begin; task < end; task++) {
+        const int64_t o = task / num_blocks;
+        const int64_t column = (task % num_blocks) * kColumnBlock;
+        const int64_t width = std::min(kColumnBlock, inner - column);
+        const int64_t offset = o * n * inner + column;
+        std::fill(acc.get(), acc.get() + block, init);
+        scan_rows(in + offset, out + offset, n, width, inner, acc.get(), op, vec_op, vectorize());
+      }
+    });
+    return;
+  }
+
+  // two-pass scan of each (n, inner) slice by all threads
+  const int64_t min_chunk_rows = std::max<int64_t>(1, kParallelScanMinChunk / inner);
+  const int64_t num_chunks =
+      std::max<int64_t>(1, std::min<int64_t>(at::get_num_threads(), n / min_chunk_rows));
+  const int64_t chunk_rows = (n + num_chunks - 1) / num_chunks;
+  std::unique_ptr<acc_t[]> carries(new acc_t[num_chunks * inner]);
+  for (int64_t o = 0; o < outer; o++) {
+    const scalar_t* slice_in = in + o * n * inner;
+    scalar_t* slice_out = out + o * n * inner;
+    std::fill(carries.get(), carries.get() + num_chunks * inner, init);
+    // pass 1: the totals of all chunks but the last, stored as the carries of
+    // the chunks after them
+    at::parallel_for(0, num_chunks - 1, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        const int64_t row = c * chunk_rows;
+        const int64_t rows = std::min(chunk_rows, n - row);
+        if (rows > 0) {
+          reduce_rows(slice_in + row * inner, rows, inner, carries.get() + (c + 1) * inner,
+                      init, op, vec_op, vectorize());
+        }
+      }
+    });
+    for (int64_t c = 2; c < num_chunks; c++) {
+      for (int64_t j = 0; j < inner; j++) {
+        carries[c * inner + j] = op(carries[(c - 1) * inner + j], carries[c * inner + j]);
+      }
+    }
+    // pass 2: each chunk starting from the total of the chunks before it
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        const int64_t row = c * chunk_rows;
+        const int64_t rows = std::min(chunk_rows, n - row);
+        if (rows > 0) {
+          scan_rows(slice_in + row * inner, slice_out + row * inner, rows, inner, inner,
+                    carries.get() + c * inner, op, vec_op, vectorize());
+        }
+      }
+    });
+  }
+}
+
+void cumsum_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
+  AT_DISPATCH_ALL_TYPES_AND(ScalarType::Bool, self.scalar_type(), "cumsum_cpu", [&] {
+    using acc_t = typename ScanAccumulateType<scalar_t>::type;
+    cumulative_kernel<scalar_t>(
+        result, self, dim, /*identity=*/scalar_t(0),
+        [](acc_t a, acc_t b) -> acc_t { return a + b; },
+        [](const vec::Vectorized<scalar_t>& a, const vec::Vectorized<scalar_t>& b) { return a + b; });
+  });
+}
+
+void cumprod_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim) {
+  AT_DISPATCH_ALL_TYPES_AND(ScalarType::Bool, self.scalar_type(), "cumprod_cpu", [&] {
+    using acc_t = typename ScanAccumulateType<scalar_t>::type;
+    cumulative_kernel<scalar_t>(
+        result, self, dim, /*identity=*/scalar_t(1),
+        [](acc_t a, acc_t b) -> acc_t { return a * b; },
+        [](const vec::Vectorized<scalar_t>& a, const vec::Vectorized<scalar_t>& b) { return a * b; });
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(cumsum_stub, &cumsum_cpu_kernel);
+REGISTER_DISPATCH(cumprod_stub, &cumprod_cpu_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,434 @@
+#include <ATen/native/cpu/DepthwiseConv2dKernel.h>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+namespace at {
+namespace native {
+namespace {
+
+// Output channels handled together by a task of the channels last weight
+// gradient.
+constexpr int64_t kChannelBlock = 256;
+
+struct Geometry {
+  int64_t batch;
+  int64_t channels;
+  int64_t multiplier;
+  int64_t in_h;
+  int64_t in_w;
+  int64_t out_h;
+  int64_t out_w;
+  int64_t k_h;
+  int64_t k_w;
+  int64_t s_h;
+  int64_t s_w;
+  int64_t p_h;
+  int64_t p_w;
+  int64_t d_h;
+  int64_t d_w;
+
+  int64_t out_channels() const {
+    return channels * multiplier;
+  }
+};
+
+Geometry make_geometry(
+    IntArrayRef input_size, IntArrayRef weight_size, IntArrayRef output_size,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation) {
+  Geometry g;
+  g.batch = input_size[0];
+  g.channels = input_size[1];
+  g.multiplier = weight_size[0] / input_size[1];
+  g.in_h = input_size[2];
+  g.in_w = input_size[3];
+  g.out_h = output_size[2];
+  g.out_w = output_size[3];
+  g.k_h = weight_size[2];
+  g.k_w = weight_size[3];
+  g.s_h = stride[0];
+  g.s_w = stride[1];
+  g.p_h = padding[0];
+  g.p_w = padding[1];
+  g.d_h = dilation[0];
+  g.d_w = dilation[1];
+  return g;
+}
+
+// The range [first, second) of the output positions o in [0, out_size) for
+// which the input position o * stride + offset is in [0, in_size).
+std::pair<int64_t, int64_t> valid_range(
+    int64_t out_size, int64_t in_size, int64_t stride, int64_t offset) {
+  int64_t lo = offset >= 0 ? 0 : (-offset + stride - 1) / stride;
+  int64_t hi = in_size - offset <= 0 ? 0 : (in_size - 1 - offset) / stride + 1;
+  lo = std::min(lo, out_size);
+  hi = std::max(lo, std::min(hi, out_size));
+  return {lo, hi};
+}
+
+// y[i * y_stride] += a * x[i * x_stride] for i in [0, n)
+template <typename scalar_t>
+inline void axpy(
+    int64_t n, scalar_t a, const scalar_t* x, int64_t x_stride, scalar_t* y, int64_t y_stride) {
+  using Vec = vec::Vectorized<scalar_t>;
+  int64_t i = 0;
+  if (x_stride == 1 && y_stride == 1) {
+    const Vec a_vec(a);
+    for (; i + Vec::size() <= n; i += Vec::size()) {
+      vec::fmadd(a_vec, Vec::loadu(x + i), Vec::loadu(y + i)).store(y + i);
+    }
+  }
+  for (; i < n; i++) {
+    y[i * y_stride] += a * x[i * x_stride];
+  }
+}
+
+// y[i] += a[i] * b[i] for i in [0, n)
+template <typename scalar_t>
+inline void mul_add(int64_t n, const scalar_t* a, const scalar_t* b, scalar_t* y) {
+  using Vec = vec::Vectorized<scalar_t>;
+  int64_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    vec::fmadd(Vec::loadu(a + i), Vec::loadu(b + i), Vec::loadu(y + i)).store(y + i);
+  }
+  for (; i < n; i++) {
+    y[i] += a[i] * b[i];
+  }
+}
+
+// The sum of x[i] * y[i * y_stride] for i in [0, n)
+template <typename scalar_t>
+inline scalar_t dot(int64_t n, const scalar_t* x, const scalar_t* y, int64_t y_stride) {
+  using Vec = vec::Vectorized<scalar_t>;
+  int64_t i = 0;
+  scalar_t sum = 0;
+  if (y_stride == 1 && n >= Vec::size()) {
+    Vec sum_vec(0);
+    for (; i + Vec::size() <= n; i += Vec::size()) {
+      sum_vec = vec::fmadd(Vec::loadu(x + i), Vec::loadu(y + i), sum_vec);
+    }
+    scalar_t lanes[Vec::size()];
+    sum_vec.store(lanes);
+    for (int64_t k = 0; k < Vec::size(); k++) {
+      sum += lanes[k];
+    }
+  }
+  for (; i < n; i++) {
+    sum += x[i] * y[i * y_stride];
+  }
+  return sum;
+}
+
+// The weight of channels last kernels, as (kH, kW, C * multiplier), so that
+// the weights of the channels of a pixel are contiguous.
+Tensor channels_last_weight(const Tensor& weight) {
+  return weight.reshape({weight.size(0), -1}).t().contiguous();
+}
+
+int64_t grain_size(int64_t work_per_item) {
+  return std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, work_per_item));
+}
+
+template <typename scalar_t>
+void depthwise_conv2d_nchw(
+    scalar_t* out, const scalar_t* in, const scalar_t* weight, const scalar_t* bias,
+    const Geometry& g) {
+  const int64_t out_channels = g.out_channels();
+  const int64_t out_plane_size = g.out_h * g.out_w;
+  at::parallel_for(0, g.batch * out_channels, grain_size(out_plane_size * g.k_h * g.k_w),
+                   [&](int64_t begin, int64_t end) {
+    for (int64_t plane = begin; plane < end; plane++) {
+      const int64_t n = plane / out_channels;
+      const int64_t oc = plane % out_channels;
+      const scalar_t* in_plane = in + (n * g.channels + oc / g.multiplier) * g.in_h * g.in_w;
+      const scalar_t* w = weight + oc * g.k_h * g.k_w;
+      scalar_t* out_plane = out + plane * out_plane_size;
+      std::fill_n(out_plane, out_plane_size, bias ? bias[oc] : scalar_t(0));
+      for (int64_t oh = 0; oh < g.out_h; oh++) {
+        scalar_t* out_row = out_plane + oh * g.out_w;
+        for (int64_t kh = 0; kh < g.k_h; kh++) {
+          const int64_t ih = oh * g.s_h - g.p_h + kh * g.d_h;
+          if (ih < 0 || ih >= g.in_h) {
+            continue;
+          }
+          const scalar_t* in_row = in_plane + ih * g.in_w;
+          for (int64_t kw = 0; kw < g.k_w; kw++) {
+            const auto cols = valid_range(g.out_w, g.in_w, g.s_w, kw * g.d_w - g.p_w);
+            const int64_t iw = cols.first * g.s_w - g.p_w + kw * g.d_w;
+            axpy(cols.second - cols.first, w[kh * g.k_w + kw],
+                 in_row + iw, g.s_w, out_row + cols.first, 1);
+          }
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void depthwise_conv2d_nhwc(
+    scalar_t* out, const scalar_t* in, const scalar_t* weight, const scalar_t* bias,
+    const Geometry& g) {
+  const int64_t out_channels = g.out_channels();
+  at::parallel_for(0, g.batch * g.out_h, grain_size(g.out_w * out_channels * g.k_h * g.k_w),
+                   [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      const int64_t n = row / g.out_h;
+      const int64_t oh = row % g.out_h;
+      for (int64_t ow = 0; ow < g.out_w; ow++) {
+        scalar_t* out_pixel = out + (row * g.out_w + ow) * out_channels;
+        if (bias) {
+          std::copy_n(bias, out_channels, out_pixel);
+        } else {
+          std::fill_n(out_pixel, out_channels, scalar_t(0));
+        }
+        for (int64_t kh = 0; kh < g.k_h; kh++) {
+          const int64_t ih = oh * g.s_h - g.p_h + kh * g.d_h;
+          if (ih < 0 || ih >= g.in_h) {
+            continue;
+          }
+          for (int64_t kw = 0; kw < g.k_w; kw++) {
+            const int64_t iw = ow * g.s_w - g.p_w + kw * g.d_w;
+            if (iw < 0 || iw >= g.in_w) {
+              continue;
+            }
+            const scalar_t* in_pixel = in + ((n * g.in_h + ih) * g.in_w + iw) * g.channels;
+            const scalar_t* w = weight + (kh * g.k_w + kw) * out_channels;
+            if (g.multiplier == 1) {
+              mul_add(out_channels, w, in_pixel, out_pixel);
+            } else {
+              for (int64_t oc = 0; oc < out_channels; oc++) {
+                out_pixel[oc] += w[oc] * in_pixel[oc / g.multiplier];
+              }
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void depthwise_conv2d_backward_input_nchw(
+    scalar_t* grad_in, const scalar_t* grad_out, const scalar_t* weight, const Geometry& g) {
+  const int64_t out_channels = g.out_channels();
+  const int64_t in_plane_size = g.in_h * g.in_w;
+  // each plane of grad_input only gets the gradients of the output planes of
+  // its channel, so the planes are computed independently
+  at::parallel_for(0, g.batch * g.channels,
+                   grain_size(g.multiplier * g.out_h * g.out_w * g.k_h * g.k_w),
+                   [&](int64_t begin, int64_t end) {
+    for (int64_t plane = begin; plane < end; plane++) {
+      const int64_t n = plane / g.channels;
+      const int64_t c = plane % g.channels;
+      scalar_t* grad_in_plane = grad_in + plane * in_plane_size;
+      std::fill_n(grad_in_plane, in_plane_size, scalar_t(0));
+      for (int64_t m = 0; m < g.multiplier; m++) {
+        const int64_t oc = c * g.multiplier + m;
+        const scalar_t* grad_out_plane = grad_out + (n * out_channels + oc) * g.out_h * g.out_w;
+        const scalar_t* w = weight + oc * g.k_h * g.k_w;
+        for (int64_t oh = 0; oh < g.out_h; oh++) {
+          const scalar_t* grad_out_row = grad_out_plane + oh * g.out_w;
+          for (int64_t kh = 0; kh < g.k_h; kh++) {
+            const int64_t ih = oh * g.s_h - g.p_h + kh * g.d_h;
+            if (ih < 0 || ih >= g.in_h) {
+              continue;
+            }
+            scalar_t* grad_in_row = grad_in_plane + ih * g.in_w;
+            for (int64_t kw = 0; kw < g.k_w; kw++) {
+              const auto cols = valid_range(g.out_w, g.in_w, g.s_w, kw * g.d_w - g.p_w);
+              const int64_t iw = cols.first * g.s_w - g.p_w + kw * g.d_w;
+              axpy(cols.second - cols.first, w[kh * g.k_w + kw],
+                   grad_out_row + cols.first, 1, grad_in_row + iw, g.s_w);
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void depthwise_conv2d_backward_input_nhwc(
+    scalar_t* grad_in, const scalar_t* grad_out, const scalar_t* weight, const Geometry& g) {
+  const int64_t out_channels = g.out_channels();
+  // each pixel of grad_input gathers the gradients of the output pixels it
+  // contributed to, so the rows are computed independently
+  at::parallel_for(0, g.batch * g.in_h, grain_size(g.in_w * out_channels * g.k_h * g.k_w),
+                   [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      const int64_t n = row / g.in_h;
+      const int64_t ih = row % g.in_h;
+      for (int64_t iw = 0; iw < g.in_w; iw++) {
+        scalar_t* grad_in_pixel = grad_in + (row * g.in_w + iw) * g.channels;
+        std::fill_n(grad_in_pixel, g.channels, scalar_t(0));
+        for (int64_t kh = 0; kh < g.k_h; kh++) {
+          const int64_t oh_strided = ih + g.p_h - kh * g.d_h;
+          if (oh_strided < 0 || oh_strided % g.s_h != 0 || oh_strided / g.s_h >= g.out_h) {
+            continue;
+          }
+          const int64_t oh = oh_strided / g.s_h;
+          for (int64_t kw = 0; kw < g.k_w; kw++) {
+            const int64_t ow_strided = iw + g.p_w - kw * g.d_w;
+            if (ow_strided < 0 || ow_strided % g.s_w != 0 || ow_strided / g.s_w >= g.out_w) {
+              continue;
+            }
+            const int64_t ow = ow_strided / g.s_w;
+            const scalar_t* grad_out_pixel =
+                grad_out + ((n * g.out_h + oh) * g.out_w + ow) * out_channels;
+            const scalar_t* w = weight + (kh * g.k_w + kw) * out_channels;
+            if (g.multiplier == 1) {
+              mul_add(g.channels, w, grad_out_pixel, grad_in_pixel);
+            } else {
+              for (int64_t oc = 0; oc < out_channels; oc++) {
+                grad_in_pixel[oc / g.multiplier] += w[oc] * grad_out_pixel[oc];
+              }
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void depthwise_conv2d_backward_weight_nchw(
+    scalar_t* grad_weight, const scalar_t* grad_out, const scalar_t* in, const Geometry& g) {
+  const int64_t out_channels = g.out_channels();
+  at::parallel_for(0, out_channels, grain_size(g.batch * g.out_h * g.out_w * g.k_h * g.k_w),
+                   [&](int64_t begin, int64_t end) {
+    for (int64_t oc = begin; oc < end; oc++) {
+      const int64_t c = oc / g.multiplier;
+      for (int64_t kh = 0; kh < g.k_h; kh++) {
+        const auto rows = valid_range(g.out_h, g.in_h, g.s_h, kh * g.d_h - g.p_h);
+        for (int64_t kw = 0; kw < g.k_w; kw++) {
+          const auto cols = valid_range(g.out_w, g.in_w, g.s_w, kw * g.d_w - g.p_w);
+          const int64_t iw = cols.first * g.s_w - g.p_w + kw * g.d_w;
+          scalar_t sum = 0;
+          for (int64_t n = 0; n < g.batch; n++) {
+            const scalar_t* grad_out_plane = grad_out + (n * out_channels + oc) * g.out_h * g.out_w;
+            const scalar_t* in_plane = in + (n * g.channels + c) * g.in_h * g.in_w;
+            for (int64_t oh = rows.first; oh < rows.second; oh++) {
+              const int64_t ih = oh * g.s_h - g.p_h + kh * g.d_h;
+              sum += dot(cols.second - cols.first, grad_out_plane + oh * g.out_w + cols.first,
+                         in_plane + ih * g.in_w + iw, g.s_w);
+            }
+          }
+          grad_weight[(oc * g.k_h + kh) * g.k_w + kw] = sum;
+        }
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void depthwise_conv2d_backward_weight_nhwc(
+    scalar_t* grad_weight, const scalar_t* grad_out, const scalar_t* in, const Geometry& g) {
+  const int64_t out_channels = g.out_channels();
+  const int64_t num_blocks = (out_channels + kChannelBlock - 1) / kChannelBlock;
+  // the taps of the kernel and blocks of channels are computed independently
+  at::parallel_for(0, g.k_h * g.k_w * num_blocks, 1, [&](int64_t begin, int64_t end) {
+    std::unique_ptr<scalar_t[]> sums(new scalar_t[kChannelBlock]);
+    for (int64_t task = begin; task < end; task++) {
+      const int64_t tap = task / num_blocks;
+      const int64_t kh = tap / g.k_w;
+      const int64_t kw = tap % g.k_w;
+      const int64_t oc_begin = task % num_blocks * kChannelBlock;
+      const int64_t width = std::min(kChannelBlock, out_channels - oc_begin);
+      const auto rows = valid_range(g.out_h, g.in_h, g.s_h, kh * g.d_h - g.p_h);
+      const auto cols = valid_range(g.out_w, g.in_w, g.s_w, kw * g.d_w - g.p_w);
+      std::fill_n(sums.get(), width, scalar_t(0));
+      for (int64_t n = 0; n < g.batch; n++) {
+        for (int64_t oh = rows.first; oh < rows.second; oh++) {
+          const int64_t ih = oh * g.s_h - g.p_h + kh * g.d_h;
+          for (int64_t ow = cols.first; ow < cols.second; ow++) {
+            const int64_t iw = ow * g.s_w - g.p_w + kw * g.d_w;
+            const scalar_t* grad_out_pixel =
+                grad_out + ((n * g.out_h + oh) * g.out_w + ow) * out_channels + oc_begin;
+            const scalar_t* in_pixel = in + ((n * g.in_h + ih) * g.in_w + iw) * g.channels;
+            if (g.multiplier == 1) {
+              mul_add(width, grad_out_pixel, in_pixel + oc_begin, sums.get());
+            } else {
+              for (int64_t j = 0; j < width; j++) {
+                sums[j] += grad_out_pixel[j] * in_pixel[(oc_begin + j) / g.multiplier];
+              }
+            }
+          }
+        }
+      }
+      for (int64_t j = 0; j < width; j++) {
+        grad_weight[(oc_begin + j) * g.k_h * g.k_w + tap] = sums[j];
+      }
+    }
+  });
+}
+
+void depthwise_conv2d_kernel(
+    Tensor& output, const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation,
+    MemoryFormat memory_format) {
+  const auto g = make_geometry(input.sizes(), weight.sizes(), output.sizes(), stride, padding, dilation);
+  const bool channels_last = memory_format == at::MemoryFormat::ChannelsLast;
+  const Tensor w = channels_last ? channels_last_weight(weight) : weight;
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "depthwise_conv2d", [&] {
+    const scalar_t* bias_data = bias.defined() ? bias.data_ptr<scalar_t>() : nullptr;
+    if (channels_last) {
+      depthwise_conv2d_nhwc(output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(),
+                            w.data_ptr<scalar_t>(), bias_data, g);
+    } else {
+      depthwise_conv2d_nchw(output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(),
+                            w.data_ptr<scalar_t>(), bias_data, g);
+    }
+  });
+}
+
+void depthwise_conv2d_backward_input_kernel(
+    Tensor& grad_input, const Tensor& grad_output, const Tensor& weight,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation,
+    MemoryFormat memory_format) {
+  const auto g = make_geometry(
+      grad_input.sizes(), weight.sizes(), grad_output.sizes(), stride, padding, dilation);
+  const bool channels_last = memory_format == at::MemoryFormat::ChannelsLast;
+  const Tensor w = channels_last ? channels_last_weight(weight) : weight;
+  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "depthwise_conv2d_backward_input", [&] {
+    if (channels_last) {
+      depthwise_conv2d_backward_input_nhwc(grad_input.data_ptr<scalar_t>(),
+                                           grad_output.data_ptr<scalar_t>(), w.data_ptr<scalar_t>(), g);
+    } else {
+      depthwise_conv2d_backward_input_nchw(grad_input.data_ptr<scalar_t>(),
+                                           grad_output.data_ptr<scalar_t>(), w.data_ptr<scalar_t>(), g);
+    }
+  });
+}
+
+void depthwise_conv2d_backward_weight_kernel(
+    Tensor& grad_weight, const Tensor& grad_output, const Tensor& input,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation,
+    MemoryFormat memory_format) {
+  const auto g = make_geometry(
+      input.sizes(), grad_weight.sizes(), grad_output.sizes(), stride, padding, dilation);
+  const bool channels_last = memory_format == at::MemoryFormat::ChannelsLast;
+  AT_DISPATCH_FLOATING_TYPES(grad_output.scalar_type(), "depthwise_conv2d_backward_weight", [&] {
+    if (channels_last) {
+      depthwise_conv2d_backward_weight_nhwc(grad_weight.data_ptr<scalar_t>(),
+                                            grad_output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), g);
+    } else {
+      depthwise_conv2d_backward_weight_nchw(grad_weight.data_ptr<scalar_t>(),
+                                            grad_output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), g);
+    }
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(depthwise_conv2d_stub, &depthwise_conv2d_kernel);
+REGISTER_DISPATCH(depthwise_conv2d_backward_input_stub, &depthwise_conv2d_backward_input_kernel);
+REGISTER_DISPATCH(depthwise_conv2d_backward_weight_stub, &depthwise_conv2d_backward_weight_kernel);
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+/*
+  Direct depthwise 2d convolution on CPU, for any kernel size, stride,
+  padding, dilation and depth multiplier. All the tensors passed to a kernel
+  are contiguous in memory_format, which is either Contiguous or ChannelsLast
+  (the weight is always contiguous).
+
+  input: (N, C, H, W), weight: (C * multiplier, 1, kH, kW),
+  output: (N, C * multiplier, oH, oW)
+*/
+
+namespace at {
+namespace native {
+
+using depthwise_conv2d_fn = void (*)(
+    Tensor& output, const Tensor& input, const Tensor& weight, const Tensor& bias,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation,
+    MemoryFormat memory_format);
+using depthwise_conv2d_backward_input_fn = void (*)(
+    Tensor& grad_input, const Tensor& grad_output, const Tensor& weight,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation,
+    MemoryFormat memory_format);
+using depthwise_conv2d_backward_weight_fn = void (*)(
+    Tensor& grad_weight, const Tensor& grad_output, const Tensor& input,
+    IntArrayRef stride, IntArrayRef padding, IntArrayRef dilation,
+    MemoryFormat memory_format);
+
+DECLARE_DISPATCH(depthwise_conv2d_fn, depthwise_conv2d_stub);
+DECLARE_DISPATCH(depthwise_conv2d_backward_input_fn, depthwise_conv2d_backward_input_stub);
+DECLARE_DISPATCH(depthwise_conv2d_backward_weight_fn, depthwise_conv2d_backward_weight_stub);
+
+}  // namespace native
+}  // namespace at
@@ -1,13 +1,113 @@
 #pragma once
 
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/core/DistributionsHelper.h>
+#include <ATen/core/PhiloxRNGEngine.h>
+#include <ATen/cpu/vec.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
+#include <algorithm>
 #include <mutex>
 
 namespace at { namespace native { namespace templates {
 
+/**
+ * Note [Philox fill of large CPU tensors]
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * Filling a large contiguous tensor one mt19937 draw at a time, under the
+ * generator mutex, keeps uniform_, normal_ and bernoulli_ on a single
+ * thread. For tensors of at least philox_fill_min_numel elements these ops
+ * instead take a single random64() from the generator, under its mutex, and
+ * use it to seed a Philox stream that is split across threads with
+ * parallel_for. Element i always reads draws [i * k, i * k + k) of that
+ * stream, where k is 1 for float samples and 2 for double samples. So the
+ * result depends only on the generator state and not on the number of
+ * threads. Smaller tensors keep using the generator directly.
+ */
+constexpr int64_t philox_fill_min_numel = at::internal::GRAIN_SIZE;
+
+template<typename RNG>
+uint64_t philox_fill_seed(RNG* generator) {
+  // See Note [Acquire lock when using random generators]
+  std::lock_guard<std::mutex> lock(generator->mutex_);
+  return generator->random64();
+}
+
+// Writes uniform [0, 1) samples for stream elements [begin, end) to out,
+// with the same bit to float mapping as at::uniform_real_distribution.
+template<typename scalar_t>
+void philox_uniform(scalar_t* out, int64_t begin, int64_t end, uint64_t seed);
+
+template<>
+inline void philox_uniform<float>(float* out, int64_t begin, int64_t end, uint64_t seed) {
+  at::philox_engine engine(seed, 0, begin / 4);
+  for (int64_t skip = 0; skip < begin % 4; skip++) {
+    engine();
+  }
+  for (int64_t i = 0; i < end - begin; i++) {
+    out[i] = (engine() & FLOAT_MASK) * FLOAT_DIVISOR;
+  }
+}
+
+template<>
+inline void philox_uniform<double>(double* out, int64_t begin, int64_t end, uint64_t seed) {
+  at::philox_engine engine(seed, 0, begin / 2);
+  if (begin % 2 != 0) {
+    engine();
+    engine();
+  }
+  for (int64_t i = 0; i < end - begin; i++) {
+    const uint64_t hi = engine();
+    const uint64_t lo = engine();
+    out[i] = (((hi << 32) | lo) & DOUBLE_MASK) * DOUBLE_DIVISOR;
+  }
+}
+
+// uniform_ on a contiguous float or double tensor, see
+// Note [Philox fill of large CPU tensors].
+template<typename scalar_t, typename RNG>
+void philox_uniform_fill(Tensor& self, double from, double to, RNG* generator) {
+  using Vec = vec::Vectorized<scalar_t>;
+  const uint64_t seed = philox_fill_seed(generator);
+  scalar_t* data = self.data_ptr<scalar_t>();
+  const scalar_t range = static_cast<scalar_t>(to - from);
+  const scalar_t start = static_cast<scalar_t>(from);
+  at::parallel_for(0, self.numel(), at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    scalar_t* out = data + begin;
+    philox_uniform<scalar_t>(out, begin, end, seed);
+    const Vec range_vec(range);
+    const Vec start_vec(start);
+    int64_t i = 0;
+    for (; i + Vec::size() <= end - begin; i += Vec::size()) {
+      (Vec::loadu(out + i) * range_vec + start_vec).store(out + i);
+    }
+    for (; i < end - begin; i++) {
+      out[i] = out[i] * range + start;
+    }
+  });
+}
+
+// bernoulli_ with a scalar p on a contiguous tensor of any type, see
+// Note [Philox fill of large CPU tensors]. Like at::bernoulli_distribution,
+// a sample is 1 when a double uniform is below p.
+template<typename scalar_t, typename RNG>
+void philox_bernoulli_fill(Tensor& self, double p, RNG* generator) {
+  constexpr int64_t buffer_size = 256;
+  const uint64_t seed = philox_fill_seed(generator);
+  scalar_t* data = self.data_ptr<scalar_t>();
+  at::parallel_for(0, self.numel(), at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    double buffer[buffer_size];
+    for (int64_t chunk = begin; chunk < end; chunk += buffer_size) {
+      const int64_t chunk_end = std::min(end, chunk + buffer_size);
+      philox_uniform<double>(buffer, chunk, chunk_end, seed);
+      for (int64_t i = chunk; i < chunk_end; i++) {
+        data[i] = static_cast<scalar_t>(buffer[i - chunk] < p);
+      }
+    }
+  });
+}
+
 template<typename RNG>
 void cauchy_kernel(TensorIterator& iter, double median, double sigma, RNG* generator) {
   AT_DISPATCH_FLOATING_TYPES(iter.dtype(), "cauchy_cpu", [&]() {
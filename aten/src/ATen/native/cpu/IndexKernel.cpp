@@ -70,8 +70,9 @@ void cpu_index_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef
       // specialization for when every element uses the same index
       int64_t offset = indexer.get(0);
       if (strides[0] == sizeof(scalar_t) && strides[1] == sizeof(scalar_t)) {
+        // constant strides, so that the compiler can vectorize `f`
         for (int64_t i = 0; i < n; i++) {
-          f(dst + strides[0] * i, src + strides[1] * i, offset);
+          f(dst + sizeof(scalar_t) * i, src + sizeof(scalar_t) * i, offset);
         }
       } else {
         for (int64_t i = 0; i < n; i++) {
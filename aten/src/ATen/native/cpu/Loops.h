@@ -135,7 +135,7 @@ static inline void
 vectorized_loop(char** C10_RESTRICT data_, int64_t n, int64_t S, func_t&& op, vec_func_t&& vop) {
   using traits = function_traits<vec_func_t>;
   using scalar_t = typename function_traits<func_t>::result_type;
-  using Vec = Vec256<scalar_t>;
+  using Vec = typename traits::result_type;
   constexpr int ntensors = traits::arity + 1;
 
   char* C10_RESTRICT data[ntensors];
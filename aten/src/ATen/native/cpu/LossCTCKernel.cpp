@@ -0,0 +1,325 @@
+// Copyright (c) 2018 MathInf GmbH, Thomas Viehmann
+// Licensed under the BSD-3-Clause license
+// This is the CPU kernel of the Connectionist Temporal Loss, see LossCTC.cpp for the references and the argument checks.
+// Within the alpha and beta recursions, the states s of a time step only depend on the previous (or next) time step,
+// so each time step is computed vectorized over s, with the log_probs of the augmented targets gathered into a
+// contiguous row first. The batch is split across threads.
+
+#include <ATen/native/cpu/LossCTCKernel.h>
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at {
+namespace native {
+
+namespace {
+
+// this ad-hoc converts from targets (l in [1]) to augmented targets (l' in [1]) note that no bound-checking is done
+template<typename target_t>
+static inline int64_t get_target_prime(const target_t* target, int64_t offset, int64_t stride, int64_t idx, int64_t BLANK) {
+  if (idx % 2 == 0) {
+    return BLANK;
+  } else {
+    return target[offset + stride * (idx / 2)];
+  }
+}
+
+// Fills target_primes with the augmented target of a batch item, and skip_penalties with 0 where the
+// transition from s-2 (forward) resp. s+2 (backward) to s is allowed, i.e. where l'(s) differs from l'(s-2)
+// resp. l'(s+2), and -inf elsewhere, so that the penalty can simply be added to the log_alpha or log_beta.
+template<typename scalar_t, typename target_t>
+static void init_target_primes(std::vector<int64_t>& target_primes, std::vector<scalar_t>& skip_penalties,
+                               const target_t* targets_data, int64_t tg_batch_offset, int64_t tg_target_stride,
+                               int64_t target_length, int64_t BLANK, bool backward) {
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  const int64_t num_states = 2*target_length+1;
+  target_primes.resize(num_states);
+  skip_penalties.resize(num_states);
+  for (int64_t s = 0; s < num_states; s++) {
+    target_primes[s] = get_target_prime(targets_data, tg_batch_offset, tg_target_stride, s, BLANK);
+  }
+  for (int64_t s = 0; s < num_states; s++) {
+    const int64_t other = backward ? s+2 : s-2;
+    skip_penalties[s] = (other >= 0 && other < num_states && target_primes[other] != target_primes[s]) ? 0 : neginf;
+  }
+}
+
+// log(exp(l1)+exp(l2)+exp(l3)) + lp, keeping track of the maximum.
+template<typename scalar_t>
+static inline scalar_t logsumexp3_add(scalar_t l1, scalar_t l2, scalar_t l3, scalar_t lp) {
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  scalar_t lmax = std::max(std::max(l1, l2), l3);
+  if (lmax == neginf) // cannot do neginf-neginf
+    lmax = 0;
+  return std::log(std::exp(l1-lmax)+std::exp(l2-lmax)+std::exp(l3-lmax))+lmax + lp;
+}
+
+// The vectorized version of the above: out[i] = log(exp(l1[i])+exp(l2[i])+exp(l3[i]+penalty[i])) + lp[i]
+template<typename scalar_t>
+static void vec_logsumexp3_add(scalar_t* out, const scalar_t* l1, const scalar_t* l2, const scalar_t* l3,
+                               const scalar_t* penalty, const scalar_t* lp, int64_t size) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const Vec neginf_vec(-std::numeric_limits<scalar_t>::infinity());
+  const Vec zero_vec(0);
+  for (int64_t i = 0; i < size; i += Vec::size()) {
+    const int64_t count = std::min<int64_t>(Vec::size(), size - i);
+    const Vec a = Vec::loadu(l1 + i, count);
+    const Vec b = Vec::loadu(l2 + i, count);
+    const Vec c = Vec::loadu(l3 + i, count) + Vec::loadu(penalty + i, count);
+    Vec lmax = vec256::maximum(vec256::maximum(a, b), c);
+    lmax = Vec::blendv(lmax, zero_vec, lmax == neginf_vec);
+    const Vec res = ((a - lmax).exp() + (b - lmax).exp() + (c - lmax).exp()).log() + lmax + Vec::loadu(lp + i, count);
+    res.store(out + i, count);
+  }
+}
+
+// This is a relatively straightforward implementation of the alpha calculation in the forward backward algorithm (section 4.1).
+// A (minor) twist is that we are using log-calculations to enhance numerical stability (log_probs and log_alpha).
+// log_alpha is contiguous, as allocated by ctc_loss_cpu.
+template<typename scalar_t, typename target_t>
+void ctc_loss_kernel_template(Tensor& neg_log_likelihood, Tensor& log_alpha, const Tensor& log_probs, const Tensor& targets,
+                              IntArrayRef input_lengths, IntArrayRef target_lengths, IntArrayRef tg_batch_offsets,
+                              int64_t tg_target_stride, int64_t BLANK) {
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  const int64_t batch_size = log_probs.size(1);
+  const int64_t max_input_length = log_alpha.size(1);
+  const int64_t max_states = log_alpha.size(2);
+
+  auto lpp  = log_probs.permute({1,0,2});
+  auto log_probs_a_global = lpp.accessor<scalar_t, 3>();
+  scalar_t* log_alpha_data = log_alpha.data_ptr<scalar_t>();
+  const target_t* targets_data = targets.data_ptr<target_t>();
+  auto neg_log_likelihood_a = neg_log_likelihood.accessor<scalar_t, 1>();
+
+  at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+    std::vector<int64_t> target_primes;
+    std::vector<scalar_t> skip_penalties;
+    std::vector<scalar_t> log_probs_prime(max_states);
+    for (int64_t b = start; b < end; b++) {
+      int64_t input_length = input_lengths[b];
+      int64_t target_length = target_lengths[b];
+      const int64_t num_states = 2*target_length+1;
+      auto log_probs_a = log_probs_a_global[b];
+      scalar_t* log_alpha_b = log_alpha_data + b * max_input_length * max_states;
+      init_target_primes(target_primes, skip_penalties, targets_data, tg_batch_offsets[b], tg_target_stride,
+                         target_length, BLANK, /*backward=*/false);
+
+      // alpha calculation for the first row, the three equations for alpha_1 above eq (6)
+      // first the default
+      std::fill(log_alpha_b, log_alpha_b + max_states, neginf);
+      // the first two items of alpha_t above eq (6)
+      log_alpha_b[0] = log_probs_a[0][BLANK];
+      if (target_length > 0)
+        log_alpha_b[1] = log_probs_a[0][target_primes[1]];
+
+      // now the loop over the inputs
+      for (int64_t t=1; t<input_length; t++) {
+        const scalar_t* prev = log_alpha_b + (t-1) * max_states;
+        scalar_t* cur = log_alpha_b + t * max_states;
+        for (int64_t s = 0; s < num_states; s++) {
+          log_probs_prime[s] = log_probs_a[t][target_primes[s]];
+        }
+        // This is eq (6) and (7), the three summands are alpha_{t-1} at s, s-1 and s-2, the latter only if
+        // l'(s-2) != l'(s). The first two states lack some of the summands.
+        cur[0] = logsumexp3_add(prev[0], neginf, neginf, log_probs_prime[0]);
+        if (num_states > 1) {
+          cur[1] = logsumexp3_add(prev[1], prev[0], neginf, log_probs_prime[1]);
+        }
+        if (num_states > 2) {
+          vec_logsumexp3_add(cur + 2, prev + 2, prev + 1, prev, skip_penalties.data() + 2,
+                             log_probs_prime.data() + 2, num_states - 2);
+        }
+      }
+      // the likelihood is the the sum of the last two alphas, eq (8), the loss is the negative log likelihood
+      const scalar_t* last = log_alpha_b + (input_length-1) * max_states;
+      if (target_length == 0) {
+        // if the target is empty then there is no preceding BLANK state and hence there is no path to merge
+        neg_log_likelihood_a[b] = -last[0];
+      } else {
+        scalar_t l1 = last[target_length*2];
+        scalar_t l2 = last[target_length*2-1];
+        scalar_t m = std::max(l1, l2);
+        m = ((m == neginf) ? 0 : m);
+        scalar_t log_likelihood = std::log(std::exp(l1-m)+std::exp(l2-m))+m;
+        neg_log_likelihood_a[b] = -log_likelihood;
+      }
+    }
+  });
+}
+
+// This is the backward. It consists of two phases:
+// a) computing the beta analogous to the alphas in the forward (backward half of the forward-backward algorithm) (eq (10) and (11))
+// b) collecting the per-activation characters for all s and wrapping the gradient (eq (16), the collection is the sum)
+// Only two rows of beta are kept per batch item: row t is collected into the gradient right after it is computed from row t+1.
+// grad has been filled with neginf (the log of an empty sum) and is contiguous, as allocated by ctc_loss_backward_cpu.
+template<typename scalar_t, typename target_t>
+void ctc_loss_backward_kernel_template(Tensor& grad, const Tensor& grad_out, const Tensor& log_probs, const Tensor& targets,
+                                       IntArrayRef input_lengths, IntArrayRef target_lengths, const Tensor& neg_log_likelihood,
+                                       const Tensor& log_alpha_, IntArrayRef tg_batch_offsets, int64_t tg_target_stride,
+                                       int64_t BLANK, bool zero_infinity) {
+  using Vec = vec256::Vec256<scalar_t>;
+  constexpr scalar_t neginf = -std::numeric_limits<scalar_t>::infinity();
+  const int64_t max_input_length = log_probs.size(0);
+  const int64_t batch_size = log_probs.size(1);
+  const int64_t num_labels = log_probs.size(2);
+
+  auto log_alpha = log_alpha_.expect_contiguous();
+  const int64_t max_states = log_alpha->size(2);
+  auto lpp  = log_probs.permute({1,0,2});
+  auto log_probs_a_global = lpp.accessor<scalar_t, 3>();
+  const scalar_t* log_alpha_data = log_alpha->data_ptr<scalar_t>();
+  auto gp = grad.permute({1,0,2});
+  auto grad_a_global = gp.accessor<scalar_t, 3>();
+  const target_t* targets_data = targets.data_ptr<target_t>();
+  auto neg_log_likelihood_a = neg_log_likelihood.accessor<scalar_t, 1>();
+  auto grad_out_a = grad_out.accessor<scalar_t, 1>();
+  const bool log_probs_contiguous_labels = log_probs.stride(2) == 1;
+
+  at::parallel_for(0, batch_size, 0, [&](int64_t start, int64_t end) {
+    std::vector<int64_t> target_primes;
+    std::vector<scalar_t> skip_penalties;
+    std::vector<scalar_t> log_probs_prime(max_states);
+    std::vector<scalar_t> log_beta_rows(2 * max_states);
+    for (int64_t b = start; b < end; b++) {
+      scalar_t nll = neg_log_likelihood_a[b];
+      if (zero_infinity &&  nll == std::numeric_limits<scalar_t>::infinity()) {
+        grad.narrow(1, b, 1).zero_();
+        continue;
+      }
+
+      auto log_probs_a = log_probs_a_global[b];
+      auto grad_a = grad_a_global[b];
+      const scalar_t* log_alpha_b = log_alpha_data + b * log_alpha->size(1) * max_states;
+      int64_t input_length = input_lengths[b];
+      int64_t target_length = target_lengths[b];
+      const int64_t num_states = 2*target_length+1;
+      init_target_primes(target_primes, skip_penalties, targets_data, tg_batch_offsets[b], tg_target_stride,
+                         target_length, BLANK, /*backward=*/true);
+      scalar_t* next = log_beta_rows.data();
+      scalar_t* cur = log_beta_rows.data() + max_states;
+
+      // the initialization of beta before eq (10)
+      // here we do the fill for each batch item separately, as the input lengths will differ, so the t in which
+      // we start varies
+      if (input_length > 0) {
+        const scalar_t* log_alpha_t = log_alpha_b + (input_length-1) * max_states;
+        std::fill(next, next + num_states, neginf);
+        next[2*target_length] = log_probs_a[input_length-1][BLANK];
+        grad_a[input_length-1][BLANK] = log_alpha_t[2*target_length] + next[2*target_length];
+
+        if (target_length > 0) {
+          auto current_target_prime = target_primes[2*target_length-1];
+          next[2*target_length-1] = log_probs_a[input_length-1][current_target_prime];
+
+          // the first two are a blank and a non-blank, so we know they are different and we don't need to do log+
+          grad_a[input_length-1][current_target_prime] = log_alpha_t[2*target_length-1] + next[2*target_length-1];
+        }
+      }
+
+      // now loop applying eq (10) / (11)
+      for (int64_t t=input_length-2; t>=0; t--) {
+        for (int64_t s = 0; s < num_states; s++) {
+          log_probs_prime[s] = log_probs_a[t][target_primes[s]];
+        }
+        // the three summands are beta_{t+1} at s, s+1 and s+2, the latter only if l'(s+2) != l'(s).
+        // The last two states lack some of the summands.
+        if (num_states > 2) {
+          vec_logsumexp3_add(cur, next, next + 1, next + 2, skip_penalties.data(),
+                             log_probs_prime.data(), num_states - 2);
+        }
+        if (num_states > 1) {
+          cur[num_states-2] = logsumexp3_add(next[num_states-2], next[num_states-1], neginf, log_probs_prime[num_states-2]);
+        }
+        cur[num_states-1] = logsumexp3_add(next[num_states-1], neginf, neginf, log_probs_prime[num_states-1]);
+
+        // now that we have beta, we fill in the sum of alpha*beta in eq (16)
+        // in contrast to the cuda implementation, we only parallelize over the batch, so we don't have a concurrency
+        // issue (several s can map to the same target character)
+        // collected[b, t, target'[s]] "log+=" log_alpha[t, s]+log_beta[t, s]
+        const scalar_t* log_alpha_t = log_alpha_b + t * max_states;
+        for (int64_t s = num_states-1; s >= 0; s--) {
+          scalar_t log_alpha_beta =  log_alpha_t[s] + cur[s];
+          scalar_t &lcab = grad_a[t][target_primes[s]];
+          if (lcab == neginf) {
+            lcab = log_alpha_beta;
+          } else {
+            scalar_t max = std::max(lcab, log_alpha_beta);
+            lcab = std::log(std::exp(lcab-max)+std::exp(log_alpha_beta-max))+max;
+          }
+        }
+        std::swap(cur, next);
+      }
+
+      // now grad has the sum of eq (16)
+      // now we wrap up the calculation by adding in the remaining items of eq (16)
+      // grad is the output gradient, nll is the loss. Note that the likelihood -nll is the Z of eq (16)
+      scalar_t gr = grad_out_a[b];
+      for (int64_t t = 0; t < input_length; t++) { // or go for the full thing?
+        scalar_t* grad_data = grad_a[t].data();
+        if (log_probs_contiguous_labels) {
+          const Vec nll_vec(nll);
+          const Vec gr_vec(gr);
+          vec256::map2(
+              [&](Vec res, Vec lp) { return (lp.exp() - (res + nll_vec - lp).exp()) * gr_vec; },
+              grad_data, grad_data, log_probs_a[t].data(), num_labels);
+        } else {
+          for (int64_t c = 0; c < num_labels; c++) {
+            scalar_t& res = grad_data[c];
+            scalar_t lp = log_probs_a[t][c];
+            res = (std::exp(lp)-std::exp(res + nll - lp)) * gr;
+          }
+        }
+      }
+      // zero the remainder
+      if (input_length < max_input_length) {
+        grad.narrow(0, input_length, max_input_length - input_length).narrow(1, b, 1).zero_();
+      }
+    }
+  });
+}
+
+void ctc_loss_kernel_impl(Tensor& neg_log_likelihood, Tensor& log_alpha, const Tensor& log_probs, const Tensor& targets,
+                          IntArrayRef input_lengths, IntArrayRef target_lengths, IntArrayRef tg_batch_offsets,
+                          int64_t tg_target_stride, int64_t BLANK) {
+  AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_cpu", [&] {
+    if (targets.scalar_type() == kLong) {
+      ctc_loss_kernel_template<scalar_t, int64_t>(neg_log_likelihood, log_alpha, log_probs, targets, input_lengths,
+                                                  target_lengths, tg_batch_offsets, tg_target_stride, BLANK);
+    } else {
+      ctc_loss_kernel_template<scalar_t, int>(neg_log_likelihood, log_alpha, log_probs, targets, input_lengths,
+                                              target_lengths, tg_batch_offsets, tg_target_stride, BLANK);
+    }
+  });
+}
+
+void ctc_loss_backward_kernel_impl(Tensor& grad, const Tensor& grad_out, const Tensor& log_probs, const Tensor& targets,
+                                   IntArrayRef input_lengths, IntArrayRef target_lengths, const Tensor& neg_log_likelihood,
+                                   const Tensor& log_alpha, IntArrayRef tg_batch_offsets, int64_t tg_target_stride,
+                                   int64_t BLANK, bool zero_infinity) {
+  AT_DISPATCH_FLOATING_TYPES(log_probs.scalar_type(), "ctc_loss_backward_cpu", [&] {
+    if (targets.scalar_type() == kLong) {
+      ctc_loss_backward_kernel_template<scalar_t, int64_t>(grad, grad_out, log_probs, targets, input_lengths, target_lengths,
+                                                           neg_log_likelihood, log_alpha, tg_batch_offsets, tg_target_stride,
+                                                           BLANK, zero_infinity);
+    } else {
+      ctc_loss_backward_kernel_template<scalar_t, int>(grad, grad_out, log_probs, targets, input_lengths, target_lengths,
+                                                       neg_log_likelihood, log_alpha, tg_batch_offsets, tg_target_stride,
+                                                       BLANK, zero_infinity);
+    }
+  });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(ctc_loss_kernel, &ctc_loss_kernel_impl);
+REGISTER_DISPATCH(ctc_loss_backward_kernel, &ctc_loss_backward_kernel_impl);
+
+}} // namespace at::native
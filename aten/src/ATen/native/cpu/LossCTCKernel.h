@@ -0,0 +1,24 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at {
+namespace native {
+
+// (neg_log_likelihood, log_alpha, log_probs, targets, input_lengths,
+//  target_lengths, tg_batch_offsets, tg_target_stride, BLANK)
+using ctc_loss_fn = void(*)(Tensor&, Tensor&, const Tensor&, const Tensor&,
+                            IntArrayRef, IntArrayRef, IntArrayRef, int64_t, int64_t);
+// (grad, grad_out, log_probs, targets, input_lengths, target_lengths,
+//  neg_log_likelihood, log_alpha, tg_batch_offsets, tg_target_stride, BLANK,
+//  zero_infinity)
+using ctc_loss_backward_fn = void(*)(Tensor&, const Tensor&, const Tensor&, const Tensor&,
+                                     IntArrayRef, IntArrayRef, const Tensor&, const Tensor&,
+                                     IntArrayRef, int64_t, int64_t, bool);
+
+DECLARE_DISPATCH(ctc_loss_fn, ctc_loss_kernel);
+DECLARE_DISPATCH(ctc_loss_backward_fn, ctc_loss_backward_kernel);
+
+}
+}
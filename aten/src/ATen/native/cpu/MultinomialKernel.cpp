@@ -3,6 +3,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/native/Copy.h>
 #include <ATen/native/TensorIterator.h>
+#include <ATen/native/cpu/DistributionTemplates.h>
 #include <ATen/native/cpu/Loops.h>
 #include <ATen/core/DistributionsHelper.h>
 #include <ATen/native/UnaryOps.h>
@@ -136,9 +137,43 @@ static void multinomial_kernel_impl(Tensor& result, const Tensor& self, const in
   });
 }
 
+// Walker alias draw from the tables made by _multinomial_alias_setup, see
+// Note [Philox fill of large CPU tensors]. Sample i reads uniforms 2 * i and
+// 2 * i + 1 of the stream: the first picks a bucket, the second decides
+// between the bucket and its alias.
+template<typename scalar_t>
+void multinomial_alias_draw_apply(Tensor& result, const Tensor& q, const Tensor& J, Generator* generator) {
+  constexpr int64_t buffer_size = 128;
+  auto gen = get_generator_or_default<CPUGenerator>(generator, detail::getDefaultCPUGenerator());
+  const uint64_t seed = templates::philox_fill_seed(gen);
+  const int64_t n_categories = J.numel();
+  const scalar_t* q_ptr = q.data_ptr<scalar_t>();
+  const int64_t* J_ptr = J.data_ptr<int64_t>();
+  int64_t* result_ptr = result.data_ptr<int64_t>();
+  at::parallel_for(0, result.numel(), at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    double buffer[2 * buffer_size];
+    for (int64_t chunk = begin; chunk < end; chunk += buffer_size) {
+      const int64_t chunk_end = std::min(end, chunk + buffer_size);
+      templates::philox_uniform<double>(buffer, 2 * chunk, 2 * chunk_end, seed);
+      for (int64_t i = chunk; i < chunk_end; i++) {
+        const double* u = buffer + 2 * (i - chunk);
+        const int64_t bucket = std::min(static_cast<int64_t>(u[0] * n_categories), n_categories - 1);
+        result_ptr[i] = u[1] < q_ptr[bucket] ? bucket : J_ptr[bucket];
+      }
+    }
+  });
+}
+
+static void multinomial_alias_draw_kernel_impl(Tensor& result, const Tensor& q, const Tensor& J, Generator *gen) {
+  AT_DISPATCH_FLOATING_TYPES(q.scalar_type(), "multinomial_alias_draw", [&] {
+    multinomial_alias_draw_apply<scalar_t>(result, q, J, gen);
+  });
+}
+
 }
 
 REGISTER_DISPATCH(multinomial_stub, &multinomial_kernel_impl);
+REGISTER_DISPATCH(multinomial_alias_draw_stub, &multinomial_alias_draw_kernel_impl);
 
 }
 }
@@ -0,0 +1,294 @@
+#include <ATen/native/PointwiseProgram.h>
+
+#include <ATen/cpu/vec256/vec256.h>
+#include <c10/util/Exception.h>
+
+#include <cstring>
+#include <vector>
+
+namespace at {
+namespace native {
+namespace {
+
+using Vec = vec256::Vec256<float>;
+
+template <typename Op>
+inline void map1(float* out, const float* a, int64_t n, const Op& op) {
+  int64_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    op(Vec::loadu(a + i)).store(out + i);
+  }
+  if (i < n) {
+    op(Vec::loadu(a + i, n - i)).store(out + i, n - i);
+  }
+}
+
+template <typename Op>
+inline void map2(
+    float* out,
+    const float* a,
+    const float* b,
+    int64_t n,
+    const Op& op) {
+  int64_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    op(Vec::loadu(a + i), Vec::loadu(b + i)).store(out + i);
+  }
+  if (i < n) {
+    op(Vec::loadu(a + i, n - i), Vec::loadu(b + i, n - i))
+        .store(out + i, n - i);
+  }
+}
+
+template <typename Op>
+inline void map3(
+    float* out,
+    const float* a,
+    const float* b,
+    const float* c,
+    int64_t n,
+    const Op& op) {
+  int64_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    op(Vec::loadu(a + i), Vec::loadu(b + i), Vec::loadu(c + i))
+        .store(out + i);
+  }
+  if (i < n) {
+    op(Vec::loadu(a + i, n - i),
+       Vec::loadu(b + i, n - i),
+       Vec::loadu(c + i, n - i))
+        .store(out + i, n - i);
+  }
+}
+
+inline void fill(float* out, float value, int64_t n) {
+  const Vec v(value);
+  int64_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    v.store(out + i);
+  }
+  if (i < n) {
+    v.store(out + i, n - i);
+  }
+}
+
+void pointwise_program_kernel(
+    const PointwiseProgram& program,
+    int64_t n,
+    const float* const* inputs,
+    const float* scalars,
+    float* const* outputs,
+    float* scratch) {
+  // Inputs are read in place, outputs that are computed by the program are
+  // written in place, and everything else lives in scratch.
+  std::vector<float*> regs(program.num_registers, nullptr);
+  for (int32_t r = 0; r < program.num_inputs; ++r) {
+    regs[r] = const_cast<float*>(inputs[r]);
+  }
+  std::vector<bool> copy_output(program.outputs.size(), false);
+  for (size_t i = 0; i < program.outputs.size(); ++i) {
+    const int32_t r = program.outputs[i];
+    if (r < program.num_inputs || regs[r] != nullptr) {
+      copy_output[i] = true;
+    } else {
+      regs[r] = outputs[i];
+    }
+  }
+  for (int32_t r = program.num_inputs; r < program.num_registers; ++r) {
+    if (regs[r] == nullptr) {
+      regs[r] = scratch;
+    }
+    scratch += n;
+  }
+
+  const Vec zero(0.f);
+  const Vec one(1.f);
+  for (const PointwiseInstruction& inst : program.instructions) {
+    float* out = regs[inst.dst];
+    const float* a = inst.a >= 0 ? regs[inst.a] : nullptr;
+    const float* b = inst.b >= 0 ? regs[inst.b] : nullptr;
+    const float* c = inst.c >= 0 ? regs[inst.c] : nullptr;
+    const Vec s(inst.scalar);
+    switch (inst.op) {
+      case PointwiseOp::Fill:
+        fill(out, inst.scalar, n);
+        break;
+      case PointwiseOp::ScalarArg:
+        fill(out, scalars[inst.a], n);
+        break;
+      case PointwiseOp::Abs:
+        map1(out, a, n, [](Vec x) { return x.abs(); });
+        break;
+      case PointwiseOp::Neg:
+        map1(out, a, n, [](Vec x) { return x.neg(); });
+        break;
+      case PointwiseOp::Reciprocal:
+        map1(out, a, n, [](Vec x) { return x.reciprocal(); });
+        break;
+      case PointwiseOp::Relu:
+        map1(out, a, n, [&](Vec x) { return Vec::blendv(x, zero, x < zero); });
+        break;
+      case PointwiseOp::Sigmoid:
+        map1(out, a, n, [&](Vec x) { return one / (one + x.neg().exp()); });
+        break;
+      case PointwiseOp::Tanh:
+        map1(out, a, n, [](Vec x) { return x.tanh(); });
+        break;
+      case PointwiseOp::Exp:
+        map1(out, a, n, [](Vec x) { return x.exp(); });
+        break;
+      case PointwiseOp::Expm1:
+        map1(out, a, n, [](Vec x) { return x.expm1(); });
+        break;
+      case PointwiseOp::Log:
+        map1(out, a, n, [](Vec x) { return x.log(); });
+        break;
+      case PointwiseOp::Log10:
+        map1(out, a, n, [](Vec x) { return x.log10(); });
+        break;
+      case PointwiseOp::Log1p:
+        map1(out, a, n, [](Vec x) { return x.log1p(); });
+        break;
+      case PointwiseOp::Log2:
+        map1(out, a, n, [](Vec x) { return x.log2(); });
+        break;
+      case PointwiseOp::Sqrt:
+        map1(out, a, n, [](Vec x) { return x.sqrt(); });
+        break;
+      case PointwiseOp::Rsqrt:
+        map1(out, a, n, [](Vec x) { return x.rsqrt(); });
+        break;
+      case PointwiseOp::Sin:
+        map1(out, a, n, [](Vec x) { return x.sin(); });
+        break;
+      case PointwiseOp::Cos:
+        map1(out, a, n, [](Vec x) { return x.cos(); });
+        break;
+      case PointwiseOp::Tan:
+        map1(out, a, n, [](Vec x) { return x.tan(); });
+        break;
+      case PointwiseOp::Asin:
+        map1(out, a, n, [](Vec x) { return x.asin(); });
+        break;
+      case PointwiseOp::Acos:
+        map1(out, a, n, [](Vec x) { return x.acos(); });
+        break;
+      case PointwiseOp::Atan:
+        map1(out, a, n, [](Vec x) { return x.atan(); });
+        break;
+      case PointwiseOp::Erf:
+        map1(out, a, n, [](Vec x) { return x.erf(); });
+        break;
+      case PointwiseOp::Erfc:
+        map1(out, a, n, [](Vec x) { return x.erfc(); });
+        break;
+      case PointwiseOp::Ceil:
+        map1(out, a, n, [](Vec x) { return x.ceil(); });
+        break;
+      case PointwiseOp::Floor:
+        map1(out, a, n, [](Vec x) { return x.floor(); });
+        break;
+      case PointwiseOp::Round:
+        map1(out, a, n, [](Vec x) { return x.round(); });
+        break;
+      case PointwiseOp::Trunc:
+        map1(out, a, n, [](Vec x) { return x.trunc(); });
+        break;
+      case PointwiseOp::Frac:
+        map1(out, a, n, [](Vec x) { return x.frac(); });
+        break;
+      case PointwiseOp::Add:
+        if (inst.scalar == 1.f) {
+          map2(out, a, b, n, [](Vec x, Vec y) { return x + y; });
+        } else {
+          map2(out, a, b, n, [&](Vec x, Vec y) { return x + s * y; });
+        }
+        break;
+      case PointwiseOp::Sub:
+        if (inst.scalar == 1.f) {
+          map2(out, a, b, n, [](Vec x, Vec y) { return x - y; });
+        } else {
+          map2(out, a, b, n, [&](Vec x, Vec y) { return x - s * y; });
+        }
+        break;
+      case PointwiseOp::Mul:
+        map2(out, a, b, n, [](Vec x, Vec y) { return x * y; });
+        break;
+      case PointwiseOp::Div:
+        map2(out, a, b, n, [](Vec x, Vec y) { return x / y; });
+        break;
+      case PointwiseOp::Pow:
+        map2(out, a, b, n, [](Vec x, Vec y) { return x.pow(y); });
+        break;
+      case PointwiseOp::Atan2:
+        map2(out, a, b, n, [](Vec x, Vec y) { return x.atan2(y); });
+        break;
+      case PointwiseOp::Min:
+        map2(out, a, b, n, [](Vec x, Vec y) {
+          return Vec::blendv(y, x, (x < y) | (y != y));
+        });
+        break;
+      case PointwiseOp::Max:
+        map2(out, a, b, n, [](Vec x, Vec y) {
+          return Vec::blendv(y, x, (x > y) | (y != y));
+        });
+        break;
+      case PointwiseOp::Addcmul:
+        map3(out, a, b, c, n, [&](Vec x, Vec y, Vec z) {
+          return x + s * y * z;
+        });
+        break;
+      case PointwiseOp::Lerp:
+        map3(out, a, b, c, n, [](Vec x, Vec y, Vec w) {
+          return x + w * (y - x);
+        });
+        break;
+      case PointwiseOp::Clamp:
+        // Same selection as the generated kernels: a NaN bound is ignored and
+        // a NaN input stays NaN.
+        if (b && c) {
+          map3(out, a, b, c, n, [](Vec x, Vec lo, Vec hi) {
+            return Vec::blendv(Vec::blendv(x, hi, x > hi), lo, x < lo);
+          });
+        } else if (b) {
+          map2(out, a, b, n, [](Vec x, Vec lo) {
+            return Vec::blendv(x, lo, x < lo);
+          });
+        } else {
+          TORCH_INTERNAL_ASSERT(c, "clamp needs a min or a max");
+          map2(out, a, c, n, [](Vec x, Vec hi) {
+            return Vec::blendv(x, hi, x > hi);
+          });
+        }
+        break;
+      case PointwiseOp::Threshold:
+        map3(out, a, b, c, n, [](Vec x, Vec threshold, Vec value) {
+          return Vec::blendv(x, value, x <= threshold);
+        });
+        break;
+      case PointwiseOp::SigmoidBackward:
+        map2(out, a, b, n, [&](Vec grad, Vec y) {
+          return grad * y * (one - y);
+        });
+        break;
+      case PointwiseOp::TanhBackward:
+        map2(out, a, b, n, [&](Vec grad, Vec y) {
+          return grad * (one - y * y);
+        });
+        break;
+    }
+  }
+
+  for (size_t i = 0; i < program.outputs.size(); ++i) {
+    if (copy_output[i]) {
+      std::memcpy(outputs[i], regs[program.outputs[i]], n * sizeof(float));
+    }
+  }
+}
+
+} // namespace
+
+REGISTER_DISPATCH(pointwise_program_stub, &pointwise_program_kernel);
+
+} // namespace native
+} // namespace at
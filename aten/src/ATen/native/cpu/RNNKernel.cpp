@@ -0,0 +1,104 @@
+#include <ATen/native/RNN.h>
+
+#include <algorithm>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec.h>
+
+namespace at { namespace native {
+
+namespace {
+
+template <typename scalar_t>
+inline vec::Vectorized<scalar_t> sigmoid(const vec::Vectorized<scalar_t>& x) {
+  using Vec = vec::Vectorized<scalar_t>;
+  const Vec one(scalar_t(1));
+  return one / (one + x.neg().exp());
+}
+
+// gates is (batch, 4 * hidden) holding the ingate, forgetgate, cellgate and
+// outgate pre-activations; hy, cy and cx are (batch, hidden). All are
+// contiguous. Each row of the batch is handled independently.
+template <typename scalar_t>
+void lstm_cell_pointwise_impl(Tensor& hy, Tensor& cy, const Tensor& gates, const Tensor& cx) {
+  using Vec = vec::Vectorized<scalar_t>;
+  const int64_t batch = cx.size(0);
+  const int64_t hidden = cx.size(1);
+  const scalar_t* gates_data = gates.data_ptr<scalar_t>();
+  const scalar_t* cx_data = cx.data_ptr<scalar_t>();
+  scalar_t* hy_data = hy.data_ptr<scalar_t>();
+  scalar_t* cy_data = cy.data_ptr<scalar_t>();
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / (4 * hidden));
+  at::parallel_for(0, batch, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t b = start; b < end; ++b) {
+      const scalar_t* g = gates_data + b * 4 * hidden;
+      const scalar_t* c_prev = cx_data + b * hidden;
+      scalar_t* h_out = hy_data + b * hidden;
+      scalar_t* c_out = cy_data + b * hidden;
+      for (int64_t d = 0; d < hidden; d += Vec::size()) {
+        const int64_t count = std::min<int64_t>(Vec::size(), hidden - d);
+        const Vec ingate = sigmoid(Vec::loadu(g + d, count));
+        const Vec forgetgate = sigmoid(Vec::loadu(g + hidden + d, count));
+        const Vec cellgate = Vec::loadu(g + 2 * hidden + d, count).tanh();
+        const Vec outgate = sigmoid(Vec::loadu(g + 3 * hidden + d, count));
+        const Vec c = forgetgate * Vec::loadu(c_prev + d, count) + ingate * cellgate;
+        c.store(c_out + d, count);
+        (outgate * c.tanh()).store(h_out + d, count);
+      }
+    }
+  });
+}
+
+// igates and hgates are (batch, 3 * hidden) holding the reset, input and new
+// gate projections of the input and of hx respectively, biases included.
+template <typename scalar_t>
+void gru_cell_pointwise_impl(Tensor& hy, const Tensor& igates, const Tensor& hgates, const Tensor& hx) {
+  using Vec = vec::Vectorized<scalar_t>;
+  const int64_t batch = hx.size(0);
+  const int64_t hidden = hx.size(1);
+  const scalar_t* igates_data = igates.data_ptr<scalar_t>();
+  const scalar_t* hgates_data = hgates.data_ptr<scalar_t>();
+  const scalar_t* hx_data = hx.data_ptr<scalar_t>();
+  scalar_t* hy_data = hy.data_ptr<scalar_t>();
+  const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / (3 * hidden));
+  at::parallel_for(0, batch, grain_size, [&](int64_t start, int64_t end) {
+    for (int64_t b = start; b < end; ++b) {
+      const scalar_t* ig = igates_data + b * 3 * hidden;
+      const scalar_t* hg = hgates_data + b * 3 * hidden;
+      const scalar_t* h_prev = hx_data + b * hidden;
+      scalar_t* h_out = hy_data + b * hidden;
+      for (int64_t d = 0; d < hidden; d += Vec::size()) {
+        const int64_t count = std::min<int64_t>(Vec::size(), hidden - d);
+        const Vec reset_gate = sigmoid(
+            Vec::loadu(ig + d, count) + Vec::loadu(hg + d, count));
+        const Vec input_gate = sigmoid(
+            Vec::loadu(ig + hidden + d, count) + Vec::loadu(hg + hidden + d, count));
+        const Vec new_gate = (Vec::loadu(ig + 2 * hidden + d, count) +
+            reset_gate * Vec::loadu(hg + 2 * hidden + d, count)).tanh();
+        const Vec h = Vec::loadu(h_prev + d, count);
+        ((h - new_gate) * input_gate + new_gate).store(h_out + d, count);
+      }
+    }
+  });
+}
+
+void lstm_cell_pointwise_kernel(Tensor& hy, Tensor& cy, const Tensor& gates, const Tensor& cx) {
+  AT_DISPATCH_FLOATING_TYPES(gates.scalar_type(), "lstm_cell_pointwise_cpu", [&] {
+    lstm_cell_pointwise_impl<scalar_t>(hy, cy, gates, cx);
+  });
+}
+
+void gru_cell_pointwise_kernel(Tensor& hy, const Tensor& igates, const Tensor& hgates, const Tensor& hx) {
+  AT_DISPATCH_FLOATING_TYPES(igates.scalar_type(), "gru_cell_pointwise_cpu", [&] {
+    gru_cell_pointwise_impl<scalar_t>(hy, igates, hgates, hx);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(lstm_cell_pointwise_stub, &lstm_cell_pointwise_kernel);
+REGISTER_DISPATCH(gru_cell_pointwise_stub, &gru_cell_pointwise_kernel);
+
+}} // namespace at::native
@@ -4,15 +4,17 @@
 #include <ATen/Parallel.h>
 #include <c10/util/TypeList.h>
 
+#include <array>
 #include <sstream>
+#include <tuple>
 
 namespace at { namespace native { namespace {
 
 using namespace vec256;
 
-#define VEC_LOOP_HEADER(func_t, data) \
+#define VEC_LOOP_HEADER(func_t, vec_func_t, data) \
   using scalar_t = typename function_traits<func_t>::result_type; \
-  using Vec = Vec256<scalar_t>; \
+  using Vec = typename function_traits<vec_func_t>::result_type; \
   char* out_ptr = data[0]; \
   (void) out_ptr;
 
@@ -33,7 +35,7 @@ static inline bool is_outer_reduction(const int64_t* strides) {
 
 template <typename func_t, typename vec_func_t>
 static inline void reduction128(char** data, int64_t n, int64_t stride, func_t op, vec_func_t vop, bool reduce) {
-  VEC_LOOP_HEADER(func_t, data)
+  VEC_LOOP_HEADER(func_t, vec_func_t, data)
   const char* in1_ptr = data[1];
   Vec acc[4];
   for  (int j = 0; j < 4; j++) {
@@ -76,7 +78,7 @@ static inline void UNARY_OUTER_LOOP(char* data[2], const int64_t strides[2], int
 // computes the reduction out = op(out, in)
 template <typename func_t, typename vec_func_t>
 static inline void vectorized_inner_reduction(char** data, int64_t n, func_t op, vec_func_t vop) {
-  VEC_LOOP_HEADER(func_t, data)
+  VEC_LOOP_HEADER(func_t, vec_func_t, data)
   int64_t vector_stride = 4 * Vec::size() * sizeof(scalar_t);
   int64_t count = n / (4 * Vec::size());
   if (count > 0) {
@@ -90,10 +92,12 @@ static inline void vectorized_inner_reduction(char** data, int64_t n, func_t op,
 // computes the reduction out = op(out, in)
 template <typename func_t, typename vec_func_t>
 static inline void vectorized_outer_reduction(char** data, int64_t inner_stride, int64_t size0, int64_t size1, func_t op, vec_func_t vop) {
-  VEC_LOOP_HEADER(func_t, data)
+  VEC_LOOP_HEADER(func_t, vec_func_t, data)
 
-  // reduce down each column of 4 * Vec::size() elements (128 bytes)
-  int64_t outer_stride[2] = { 128, 128 };
+  // reduce down each column of 4 * Vec::size() elements (128 bytes with
+  // Vec256, 256 bytes with Vec512)
+  const int64_t column_stride = 4 * Vec::size() * sizeof(scalar_t);
+  int64_t outer_stride[2] = { column_stride, column_stride };
   UNARY_OUTER_LOOP(data, outer_stride, size1 / (4 * Vec::size()), [&] {
     reduction128(data, size0, inner_stride, op, vop, /*reduce=*/false);
   });
@@ -275,4 +279,126 @@ void binary_kernel_reduce_vec(TensorIterator& iter, func_t op, vec_func_t vop, d
   });
 }
 
+// Helpers for binary_kernel_multi_reduce_vec: apply the i-th op of a tuple of
+// reduction ops to the i-th accumulator, for every i.
+template <std::size_t i = 0, typename ops_t, typename acc_t, typename data_t>
+static inline typename std::enable_if<i == std::tuple_size<ops_t>::value>::type
+multi_reduce_step(const ops_t& ops, acc_t* acc, const data_t& x) {}
+
+template <std::size_t i = 0, typename ops_t, typename acc_t, typename data_t>
+static inline typename std::enable_if<i < std::tuple_size<ops_t>::value>::type
+multi_reduce_step(const ops_t& ops, acc_t* acc, const data_t& x) {
+  acc[i] = std::get<i>(ops)(acc[i], x);
+  multi_reduce_step<i + 1>(ops, acc, x);
+}
+
+template <std::size_t i = 0, typename ops_t, typename acc_t>
+static inline typename std::enable_if<i == std::tuple_size<ops_t>::value>::type
+multi_reduce_combine(const ops_t& ops, acc_t* acc, const acc_t* other) {}
+
+template <std::size_t i = 0, typename ops_t, typename acc_t>
+static inline typename std::enable_if<i < std::tuple_size<ops_t>::value>::type
+multi_reduce_combine(const ops_t& ops, acc_t* acc, const acc_t* other) {
+  acc[i] = std::get<i>(ops)(acc[i], other[i]);
+  multi_reduce_combine<i + 1>(ops, acc, other);
+}
+
+// computes acc[k] = ops[k](acc[k], in[j]) for every k over a contiguous input,
+// loading each vector of the input once for all of the reductions
+template <typename scalar_t, std::size_t N, typename ops_t, typename vops_t>
+static inline void vectorized_multi_reduction(const scalar_t* in, int64_t n, const ops_t& ops, const vops_t& vops, scalar_t* acc) {
+  using Vec = typename function_traits<typename std::tuple_element<0, vops_t>::type>::result_type;
+  constexpr int64_t kChunk = 4 * Vec::size();
+  int64_t count = n / kChunk;
+  if (count > 0) {
+    Vec vacc[4][N];
+    for (int j = 0; j < 4; j++) {
+      Vec x = Vec::loadu(in + j * Vec::size());
+      for (std::size_t k = 0; k < N; k++) {
+        vacc[j][k] = x;
+      }
+    }
+    for (int64_t i = 1; i < count; i++) {
+      const scalar_t* ptr = in + i * kChunk;
+      for (int j = 0; j < 4; j++) {
+        multi_reduce_step(vops, vacc[j], Vec::loadu(ptr + j * Vec::size()));
+      }
+    }
+    for (int j = 1; j < 4; j++) {
+      multi_reduce_combine(vops, vacc[0], vacc[j]);
+    }
+    scalar_t buffer[N][Vec::size()];
+    for (std::size_t k = 0; k < N; k++) {
+      vacc[0][k].store(buffer[k]);
+    }
+    for (int64_t j = 0; j < Vec::size(); j++) {
+      scalar_t lane[N];
+      for (std::size_t k = 0; k < N; k++) {
+        lane[k] = buffer[k][j];
+      }
+      multi_reduce_combine(ops, acc, lane);
+    }
+  }
+  for (int64_t i = count * kChunk; i < n; i++) {
+    multi_reduce_step(ops, acc, in[i]);
+  }
+}
+
+// Reduces the single input of `iter` into its N outputs in one pass:
+// output k becomes the reduction of the input under the k-th element of the
+// tuples `ops` and `vops`, starting from idents[k]. As in
+// binary_kernel_reduce_vec, op is (scalar_t, scalar_t) -> scalar_t and vop is
+// its Vectorized counterpart; every output has the input's scalar type.
+//
+// Contiguous runs of the input are vectorized, with each vector fed to all N
+// vops; strided runs fall back to the scalar ops. Parallelization follows
+// binary_kernel_reduce.
+template <typename ops_t, typename vops_t, typename scalar_t, std::size_t N>
+void binary_kernel_multi_reduce_vec(TensorIterator& iter, ops_t ops, vops_t vops, std::array<scalar_t, N> idents) {
+  static_assert(
+    std::tuple_size<ops_t>::value == N && std::tuple_size<vops_t>::value == N,
+    "one op and one vectorized op are needed per output");
+  using acc_t = std::array<scalar_t, N>;
+  TORCH_INTERNAL_ASSERT(iter.noutputs() == (int)N && iter.ninputs() == 1);
+  iter.foreach_reduced_elt([&](TensorIterator &sub_iter) {
+    auto reduction_body = [&](acc_t acc, int64_t begin, int64_t end) -> acc_t {
+      sub_iter.serial_for_each([&](char** data, const int64_t* strides, int64_t size) {
+        const char* in = data[N];
+        int64_t stride = strides[N];
+        if (stride == sizeof(scalar_t)) {
+          vectorized_multi_reduction<scalar_t, N>((const scalar_t*)in, size, ops, vops, acc.data());
+        } else {
+          for (int64_t i = 0; i < size; ++i) {
+            multi_reduce_step(ops, acc.data(), *(const scalar_t*)in);
+            in += stride;
+          }
+        }
+      }, {begin, end});
+      return acc;
+    };
+    acc_t total_acc = idents;
+    auto numel = sub_iter.numel();
+    if (numel < at::internal::GRAIN_SIZE || at::get_num_threads() == 1 ||
+        at::in_parallel_region()) {
+      total_acc = reduction_body(total_acc, 0, numel);
+    } else {
+      int max_threads = at::get_num_threads();
+      AT_ASSERT(max_threads > 0);
+      std::vector<acc_t> buffer((unsigned)max_threads, idents);
+      at::parallel_for(0, numel, internal::GRAIN_SIZE,
+        [&](int64_t begin, int64_t end) {
+          auto& acc = buffer[at::get_thread_num()];
+          acc = reduction_body(acc, begin, end);
+        }
+      );
+      for (int i = 0; i < max_threads; ++i) {
+        multi_reduce_combine(ops, total_acc.data(), buffer[i].data());
+      }
+    }
+    for (std::size_t k = 0; k < N; k++) {
+      *(scalar_t*)sub_iter.data_ptr(k) = total_acc[k];
+    }
+  });
+}
+
 }}}  // namespace at::native::<anonymous>
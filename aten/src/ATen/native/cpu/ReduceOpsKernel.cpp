@@ -4,7 +4,7 @@
 #include <limits>
 
 #include <ATen/Dispatch.h>
-#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec.h>
 #include <ATen/native/ReduceOps.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/SharedReduceOps.h>
@@ -13,14 +13,13 @@
 
 namespace at { namespace native { namespace {
 
-using namespace vec256;
 
 static void sum_kernel_impl(TensorIterator& iter) {
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND2(
       ScalarType::BFloat16, ScalarType::Bool, iter.dtype(), "sum_cpu", [&] {
         binary_kernel_reduce_vec(
             iter, [=](scalar_t a, scalar_t b) -> scalar_t { return a + b; },
-            [=](Vec256<scalar_t> a, Vec256<scalar_t> b) { return a + b; });
+            [=](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) { return a + b; });
       });
 }
 
@@ -50,7 +49,7 @@ static void prod_kernel_impl(TensorIterator& iter) {
     binary_kernel_reduce_vec(
       iter,
       [=](scalar_t a, scalar_t b) -> scalar_t { return a * b; },
-      [=](Vec256<scalar_t> a, Vec256<scalar_t> b) { return a * b; },
+      [=](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) { return a * b; },
       /*identity=*/1);
   });
 }
@@ -123,7 +122,7 @@ static void and_kernel_impl(TensorIterator& iter) {
   binary_kernel_reduce_vec(
     iter,
     [=](uint8_t a, uint8_t b) -> uint8_t { return a && b; },
-    [=](Vec256<uint8_t> a, Vec256<uint8_t> b) {
+    [=](vec::Vectorized<uint8_t> a, vec::Vectorized<uint8_t> b) {
       // Adding the implementation here instead of in vec256_base to avoid
       // return value inconsistency. Other comparison operators in vec256_base
       // return -1/0 (all bit 1 / all bit 0) as true/false to follow the AVX2
@@ -134,8 +133,8 @@ static void and_kernel_impl(TensorIterator& iter) {
       //
       // In this method, users would expect, e.g., all(), to return 1/0 as
       // true/false.
-      Vec256<uint8_t> c = Vec256<uint8_t>();
-      for (int i = 0; i != Vec256<uint8_t>::size(); i++) {
+      vec::Vectorized<uint8_t> c = vec::Vectorized<uint8_t>();
+      for (int i = 0; i != vec::Vectorized<uint8_t>::size(); i++) {
         c[i] = a[i] && b[i];
       }
       return c;
@@ -147,9 +146,9 @@ static void or_kernel_impl(TensorIterator& iter) {
   binary_kernel_reduce_vec(
     iter,
     [=](uint8_t a, uint8_t b) -> uint8_t { return a || b; },
-    [=](Vec256<uint8_t> a, Vec256<uint8_t> b) {
-      Vec256<uint8_t> c = Vec256<uint8_t>();
-      for (int i = 0; i != Vec256<uint8_t>::size(); i++) {
+    [=](vec::Vectorized<uint8_t> a, vec::Vectorized<uint8_t> b) {
+      vec::Vectorized<uint8_t> c = vec::Vectorized<uint8_t>();
+      for (int i = 0; i != vec::Vectorized<uint8_t>::size(); i++) {
         c[i] = a[i] || b[i];
       }
       return c;
@@ -162,7 +161,7 @@ static void min_values_kernel_impl(TensorIterator& iter) {
     binary_kernel_reduce_vec(
       iter,
       [](scalar_t a, scalar_t b) -> scalar_t { return min_impl(a, b); },
-      [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return minimum(a, b); });
+      [](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) { return vec::minimum(a, b); });
   });
 }
 
@@ -171,7 +170,7 @@ static void max_values_kernel_impl(TensorIterator& iter) {
     binary_kernel_reduce_vec(
       iter,
       [](scalar_t a, scalar_t b) -> scalar_t { return max_impl(a, b); },
-      [](Vec256<scalar_t> a, Vec256<scalar_t> b) { return maximum(a, b); });
+      [](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) { return vec::maximum(a, b); });
   });
 }
 
@@ -207,6 +206,21 @@ static void argmin_kernel_impl(TensorIterator &iter) {
   });
 }
 
+// min and max in a single pass over the input; NaN propagates to both
+static void aminmax_kernel_impl(TensorIterator& iter) {
+  AT_DISPATCH_ALL_TYPES(iter.dtype(), "aminmax_cpu", [&iter] {
+    binary_kernel_multi_reduce_vec(
+      iter,
+      std::make_tuple(
+        [](scalar_t a, scalar_t b) -> scalar_t { return (_isnan(a) || a < b) ? a : b; },
+        [](scalar_t a, scalar_t b) -> scalar_t { return (_isnan(a) || a > b) ? a : b; }),
+      std::make_tuple(
+        [](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) { return vec::minimum(a, b); },
+        [](vec::Vectorized<scalar_t> a, vec::Vectorized<scalar_t> b) { return vec::maximum(a, b); }),
+      std::array<scalar_t, 2>{{upper_bound<scalar_t>(), lower_bound<scalar_t>()}});
+  });
+}
+
 }  // anonymous namespace
 
 REGISTER_DISPATCH(sum_stub, &sum_kernel_impl);
@@ -220,5 +234,6 @@ REGISTER_DISPATCH(min_values_stub, &min_values_kernel_impl);
 REGISTER_DISPATCH(max_values_stub, &max_values_kernel_impl);
 REGISTER_DISPATCH(argmax_stub, &argmax_kernel_impl);
 REGISTER_DISPATCH(argmin_stub, &argmin_kernel_impl);
+REGISTER_DISPATCH(aminmax_stub, &aminmax_kernel_impl);
 
 }}  // namespace at::native
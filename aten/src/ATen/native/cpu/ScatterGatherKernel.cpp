@@ -1,6 +1,10 @@
 #include <ATen/native/ScatterGatherShapeChecks.h>
 #include <ATen/native/TensorIterator.h>
+#include <ATen/MemoryOverlap.h>
 #include <ATen/Parallel.h>
+#include <ATen/cpu/vec.h>
+
+#include <algorithm>
 
 namespace at { namespace native {
 
@@ -88,6 +92,121 @@ static Tensor restride_dim(
   return src.as_strided(replacement_shape, strides);
 }
 
+// Whether `index` only varies along `dim`, like the `index.view(-1, 1).expand_as(src)`
+// of message passing and embedding-style lookups, and `self` and `src` are
+// contiguous with the same sizes as `index` everywhere but along `dim`. Then
+// gather and scatter_add reduce to copying or adding whole rows of
+// `inner = prod(sizes[dim+1:])` elements.
+static bool is_row_index(
+  const Tensor& self, int64_t dim,
+  const Tensor& index, const Tensor& src
+) {
+  if (self.dim() != index.dim() || src.dim() != index.dim() || index.dim() < 2 ||
+      !self.is_contiguous() || !src.is_contiguous() ||
+      self.scalar_type() != src.scalar_type()) {
+    return false;
+  }
+  for (int64_t d = 0; d < index.dim(); ++d) {
+    if (d == dim) {
+      continue;
+    }
+    if ((index.stride(d) != 0 && index.size(d) != 1) ||
+        index.size(d) != self.size(d) || index.size(d) != src.size(d)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void check_row_index(const int64_t* index_data, int64_t index_dim_stride,
+                            int64_t index_dim_size, int64_t dim, int64_t self_dim_size) {
+  for (int64_t i = 0; i < index_dim_size; ++i) {
+    int64_t idx_dim = index_data[i * index_dim_stride];
+    TORCH_CHECK(idx_dim >= 0 && idx_dim < self_dim_size,
+      "index ", idx_dim,
+      " is out of bounds for dimension ", dim,
+      " with size ", self_dim_size);
+  }
+}
+
+// result[o, i, :] = self[o, index[i], :]
+static void cpu_gather_rows(Tensor& result, const Tensor& self, int64_t dim, const Tensor& index) {
+  const int64_t* index_data = index.data_ptr<int64_t>();
+  const int64_t index_dim_stride = index.stride(dim);
+  const int64_t index_dim_size = index.size(dim);
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t outer = self.numel() == 0 ? 0 : self.numel() / (self_dim_size * self.stride(dim));
+  const int64_t inner = self.stride(dim);
+  check_row_index(index_data, index_dim_stride, index_dim_size, dim, self_dim_size);
+
+  AT_DISPATCH_ALL_TYPES_AND2(
+    ScalarType::Bool, ScalarType::Half, self.scalar_type(),
+    "gather_out_cpu", [&] {
+      const scalar_t* self_data = self.data_ptr<scalar_t>();
+      scalar_t* result_data = result.data_ptr<scalar_t>();
+      const int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(inner, 1));
+      at::parallel_for(0, outer * index_dim_size, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t row = begin; row < end; ++row) {
+          const int64_t o = row / index_dim_size;
+          const int64_t i = row % index_dim_size;
+          const scalar_t* self_row =
+              self_data + (o * self_dim_size + index_data[i * index_dim_stride]) * inner;
+          std::copy(self_row, self_row + inner, result_data + row * inner);
+        }
+      });
+    }
+  );
+}
+
+// self[o, index[i], :] += src[o, i, :]
+//
+// Rows of `self` may be hit repeatedly, so threads split the outer rows (and,
+// when there are fewer of those than threads, the columns) instead of `i`.
+static void cpu_scatter_add_rows(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  const int64_t* index_data = index.data_ptr<int64_t>();
+  const int64_t index_dim_stride = index.stride(dim);
+  const int64_t index_dim_size = index.size(dim);
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t src_dim_size = src.size(dim);
+  const int64_t inner = self.stride(dim);
+  const int64_t outer = self.numel() == 0 ? 0 : self.numel() / (self_dim_size * inner);
+  check_row_index(index_data, index_dim_stride, index_dim_size, dim, self_dim_size);
+
+  AT_DISPATCH_ALL_TYPES_AND2(
+    ScalarType::Bool, ScalarType::Half, self.scalar_type(),
+    "scatter_add_", [&] {
+      using Vec = vec::Vectorized<scalar_t>;
+      scalar_t* self_data = self.data_ptr<scalar_t>();
+      const scalar_t* src_data = src.data_ptr<scalar_t>();
+      // columns are split in whole vectors so that threads never share one
+      const int64_t column_blocks = (inner + Vec::size() - 1) / Vec::size();
+      const int64_t grain_size = std::max<int64_t>(
+          1, at::internal::GRAIN_SIZE / std::max<int64_t>(index_dim_size * Vec::size(), 1));
+      at::parallel_for(0, outer * column_blocks, grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t block = begin; block < end;) {
+          const int64_t o = block / column_blocks;
+          const int64_t column_begin = (block % column_blocks) * Vec::size();
+          const int64_t block_end = std::min(end, (o + 1) * column_blocks);
+          const int64_t column_end = std::min(inner, (block_end - o * column_blocks) * Vec::size());
+          for (int64_t i = 0; i < index_dim_size; ++i) {
+            scalar_t* self_row =
+                self_data + (o * self_dim_size + index_data[i * index_dim_stride]) * inner;
+            const scalar_t* src_row = src_data + (o * src_dim_size + i) * inner;
+            int64_t j = column_begin;
+            for (; j + Vec::size() <= column_end; j += Vec::size()) {
+              (Vec::loadu(self_row + j) + Vec::loadu(src_row + j)).store(self_row + j);
+            }
+            for (; j < column_end; ++j) {
+              self_row[j] += src_row[j];
+            }
+          }
+          block = block_end;
+        }
+      });
+    }
+  );
+}
+
 template <typename func_t>
 void cpu_scatter_gather_base_kernel(
   Tensor& self, int64_t dim,
@@ -164,6 +283,11 @@ void gather_cpu_kernel(Tensor& result, const Tensor& self, int64_t dim, const Te
 
   gather_shape_check(self, dim, index);
 
+  if (is_row_index(self, dim, index, self) && result.is_contiguous()) {
+    cpu_gather_rows(result, self, dim, index);
+    return;
+  }
+
   int64_t index_dim_size = ensure_nonempty_size(index, dim);
   int64_t self_dim_size = ensure_nonempty_size(self, dim);
 
@@ -195,6 +319,12 @@ void scatter_add_cpu_kernel(Tensor& self, int64_t dim, const Tensor& index, cons
   
   scatter_shape_check(self, dim, index, src);
 
+  if (is_row_index(self, dim, index, src) &&
+      has_internal_overlap(self) == MemOverlap::NO) {
+    cpu_scatter_add_rows(self, dim, index, src);
+    return;
+  }
+
   int64_t index_dim_size = ensure_nonempty_size(index, dim);
   int64_t self_dim_size = ensure_nonempty_size(self, dim);
 
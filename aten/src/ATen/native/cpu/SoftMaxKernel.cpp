@@ -2,12 +2,13 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <numeric>
 
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
-#include <ATen/cpu/vec256/functional.h>
-#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/cpu/vec.h>
 #include <c10/util/Optional.h>
 
 // [Note AVX-SSE transitions] In general we avoid calls into cmath for code
@@ -28,7 +29,7 @@ inline void _vec_log_softmax_lastdim(
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec::Vectorized<scalar_t>;
   static constexpr int64_t CHUNK_SIZE = (128 / sizeof(scalar_t)) * Vec::size();
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size * CHUNK_SIZE);
   if (grain_size < CHUNK_SIZE)
@@ -48,8 +49,8 @@ inline void _vec_log_softmax_lastdim(
           for (int64_t j = 0; j < loop_end; j++) {
             int64_t i = ii + j;
             scalar_t* input_data = input_data_base + i * dim_size;
-            max_input_arr[j] = vec256::reduce_all<scalar_t>(
-                [](Vec& x, Vec& y) { return vec256::maximum(x, y); },
+            max_input_arr[j] = vec::reduce_all<scalar_t>(
+                [](Vec& x, Vec& y) { return vec::maximum(x, y); },
                 input_data,
                 dim_size);
           }
@@ -57,7 +58,7 @@ inline void _vec_log_softmax_lastdim(
             int64_t i = ii + j;
             scalar_t* input_data = input_data_base + i * dim_size;
             scalar_t max_input = max_input_arr[j];
-            tmp_sum_scalar[j] = vec256::map_reduce_all<scalar_t>(
+            tmp_sum_scalar[j] = vec::map_reduce_all<scalar_t>(
                 [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
                 [](Vec x, Vec y) { return x + y; },
                 input_data,
@@ -65,7 +66,7 @@ inline void _vec_log_softmax_lastdim(
           }
           // See [Note AVX-SSE transitions] for why this should call the
           // vectorized version (aside from perf improvements).
-          vec256::map(
+          vec::map(
               [](Vec x) { return x.log(); },
               tmp_sum_scalar,
               tmp_sum_scalar,
@@ -82,7 +83,7 @@ inline void _vec_log_softmax_lastdim(
             // is small, if we compute `max_input` plus `tmp_sum` before,
             // there would be a numerical problem. See an example in
             // https://github.com/pytorch/pytorch/issues/11752#issuecomment-422883379
-            vec256::map(
+            vec::map(
                 [tmp_sum, max_input](Vec x) { return x - Vec(max_input) - Vec(tmp_sum); },
                 output_data,
                 input_data,
@@ -98,7 +99,7 @@ inline void _vec_softmax_lastdim(
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec::Vectorized<scalar_t>;
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
   if (grain_size < 1)
     grain_size = 1;
@@ -111,19 +112,19 @@ inline void _vec_softmax_lastdim(
         for (int64_t i = begin; i < end; i++) {
           scalar_t* input_data = input_data_base + i * dim_size;
           scalar_t* output_data = output_data_base + i * dim_size;
-          scalar_t max_input = vec256::reduce_all<scalar_t>(
-              [](Vec& x, Vec& y) { return vec256::maximum(x, y); },
+          scalar_t max_input = vec::reduce_all<scalar_t>(
+              [](Vec& x, Vec& y) { return vec::maximum(x, y); },
               input_data,
               dim_size);
-          vec256::map(
+          vec::map(
               [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
               output_data,
               input_data,
               dim_size);
-          scalar_t tmp_sum = vec256::reduce_all<scalar_t>(
+          scalar_t tmp_sum = vec::reduce_all<scalar_t>(
               [](Vec x, Vec y) { return x + y; }, output_data, dim_size);
           tmp_sum = 1 / tmp_sum;
-          vec256::map(
+          vec::map(
               [tmp_sum](Vec x) { return x * Vec(tmp_sum); },
               output_data,
               output_data,
@@ -139,7 +140,7 @@ inline void _vec_host_softmax_backward_lastdim(
     scalar_t* output_data_base,
     int64_t outer_size,
     int64_t dim_size) {
-  using Vec = vec256::Vec256<scalar_t>;
+  using Vec = vec::Vectorized<scalar_t>;
   int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
   if (grain_size < 1)
     grain_size = 1;
@@ -155,10 +156,10 @@ inline void _vec_host_softmax_backward_lastdim(
           scalar_t* output_data = output_data_base + i * dim_size;
           scalar_t sum;
           if (log_softmax) {
-            sum = vec256::reduce_all<scalar_t>(
+            sum = vec::reduce_all<scalar_t>(
                 [](Vec& x, Vec& y) { return x + y; }, grad_data, dim_size);
           } else {
-            sum = vec256::map2_reduce_all<scalar_t>(
+            sum = vec::map2_reduce_all<scalar_t>(
                 [](Vec x, Vec y) { return x * y; },
                 [](Vec x, Vec y) { return x + y; },
                 grad_data,
@@ -166,14 +167,14 @@ inline void _vec_host_softmax_backward_lastdim(
                 dim_size);
           }
           if (log_softmax) {
-            vec256::map2(
+            vec::map2(
                 [sum](Vec x, Vec y) { return x - ((y.exp()) * Vec(sum)); },
                 grad_input_data,
                 grad_data,
                 output_data,
                 dim_size);
           } else {
-            vec256::map2(
+            vec::map2(
                 [sum](Vec x, Vec y) { return (x - Vec(sum)) * y; },
                 grad_input_data,
                 grad_data,
@@ -184,6 +185,314 @@ inline void _vec_host_softmax_backward_lastdim(
       });
 }
 
+// BFloat16 rows are widened into fp32 buffers, so that the max, the sum of
+// exponentials and the normalization are computed and accumulated in fp32 and
+// only the result is rounded back to BFloat16.
+template <bool log_softmax>
+inline void _vec_softmax_lastdim_bfloat16(
+    BFloat16* input_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  using Vec = vec::Vectorized<float>;
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        std::unique_ptr<float[]> buffer(new float[dim_size]);
+        float* buffer_data = buffer.get();
+        for (int64_t i = begin; i < end; i++) {
+          vec::convert(input_data_base + i * dim_size, buffer_data, dim_size);
+          float max_input = vec::reduce_all<float>(
+              [](Vec& x, Vec& y) { return vec::maximum(x, y); },
+              buffer_data,
+              dim_size);
+          if (log_softmax) {
+            float tmp_sum = vec::map_reduce_all<float>(
+                [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
+                [](Vec x, Vec y) { return x + y; },
+                buffer_data,
+                dim_size);
+            // See [Note AVX-SSE transitions] for why this should call the
+            // vectorized version.
+            vec::map([](Vec x) { return x.log(); }, &tmp_sum, &tmp_sum, 1);
+            vec::map(
+                [tmp_sum, max_input](Vec x) { return x - Vec(max_input) - Vec(tmp_sum); },
+                buffer_data,
+                buffer_data,
+                dim_size);
+          } else {
+            vec::map(
+                [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
+                buffer_data,
+                buffer_data,
+                dim_size);
+            float tmp_sum = vec::reduce_all<float>(
+                [](Vec x, Vec y) { return x + y; }, buffer_data, dim_size);
+            tmp_sum = 1 / tmp_sum;
+            vec::map(
+                [tmp_sum](Vec x) { return x * Vec(tmp_sum); },
+                buffer_data,
+                buffer_data,
+                dim_size);
+          }
+          vec::convert(buffer_data, output_data_base + i * dim_size, dim_size);
+        }
+      });
+}
+
+template <>
+inline void _vec_log_softmax_lastdim<BFloat16>(
+    BFloat16* input_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  _vec_softmax_lastdim_bfloat16<true>(
+      input_data_base, output_data_base, outer_size, dim_size);
+}
+
+template <>
+inline void _vec_softmax_lastdim<BFloat16>(
+    BFloat16* input_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  _vec_softmax_lastdim_bfloat16<false>(
+      input_data_base, output_data_base, outer_size, dim_size);
+}
+
+template <bool log_softmax>
+inline void _vec_softmax_backward_lastdim_bfloat16(
+    BFloat16* grad_input_data_base,
+    BFloat16* grad_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  using Vec = vec::Vectorized<float>;
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        std::unique_ptr<float[]> buffer(new float[2 * dim_size]);
+        float* grad_data = buffer.get();
+        float* output_data = grad_data + dim_size;
+        for (int64_t i = begin; i < end; i++) {
+          vec::convert(grad_data_base + i * dim_size, grad_data, dim_size);
+          vec::convert(output_data_base + i * dim_size, output_data, dim_size);
+          float sum;
+          if (log_softmax) {
+            sum = vec::reduce_all<float>(
+                [](Vec& x, Vec& y) { return x + y; }, grad_data, dim_size);
+            vec::map2(
+                [sum](Vec x, Vec y) { return x - ((y.exp()) * Vec(sum)); },
+                grad_data,
+                grad_data,
+                output_data,
+                dim_size);
+          } else {
+            sum = vec::map2_reduce_all<float>(
+                [](Vec x, Vec y) { return x * y; },
+                [](Vec x, Vec y) { return x + y; },
+                grad_data,
+                output_data,
+                dim_size);
+            vec::map2(
+                [sum](Vec x, Vec y) { return (x - Vec(sum)) * y; },
+                grad_data,
+                grad_data,
+                output_data,
+                dim_size);
+          }
+          vec::convert(grad_data, grad_input_data_base + i * dim_size, dim_size);
+        }
+      });
+}
+
+template <>
+inline void _vec_host_softmax_backward_lastdim<BFloat16, true>(
+    BFloat16* grad_input_data_base,
+    BFloat16* grad_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  _vec_softmax_backward_lastdim_bfloat16<true>(
+      grad_input_data_base, grad_data_base, output_data_base, outer_size, dim_size);
+}
+
+template <>
+inline void _vec_host_softmax_backward_lastdim<BFloat16, false>(
+    BFloat16* grad_input_data_base,
+    BFloat16* grad_data_base,
+    BFloat16* output_data_base,
+    int64_t outer_size,
+    int64_t dim_size) {
+  _vec_softmax_backward_lastdim_bfloat16<false>(
+      grad_input_data_base, grad_data_base, output_data_base, outer_size, dim_size);
+}
+
+// The fused cross entropy kernels read every row in blocks that fit in L1,
+// widened to fp32 for BFloat16. The max and the sum of exponentials of a row
+// are computed in one pass over memory: the running sum is rescaled whenever
+// a block raises the max, and the block is then summed while it is in cache.
+// The log-probabilities are never written out.
+template <typename scalar_t>
+struct cross_entropy_acc_type { using type = scalar_t; };
+template <>
+struct cross_entropy_acc_type<BFloat16> { using type = float; };
+
+inline float* _load_block(float* data, float*, int64_t) {
+  return data;
+}
+inline double* _load_block(double* data, double*, int64_t) {
+  return data;
+}
+inline float* _load_block(BFloat16* data, float* buffer, int64_t size) {
+  vec::convert(data, buffer, size);
+  return buffer;
+}
+
+inline float* _output_block(float* data, float*) {
+  return data;
+}
+inline double* _output_block(double* data, double*) {
+  return data;
+}
+inline float* _output_block(BFloat16*, float* buffer) {
+  return buffer;
+}
+
+inline void _flush_block(float*, const float*, int64_t) {}
+inline void _flush_block(double*, const double*, int64_t) {}
+inline void _flush_block(BFloat16* data, const float* buffer, int64_t size) {
+  vec::convert(buffer, data, size);
+}
+
+template <typename scalar_t>
+inline void _vec_softmax_cross_entropy(
+    scalar_t* input_data_base,
+    const int64_t* target_data,
+    scalar_t* losses_data,
+    scalar_t* logsumexp_data,
+    int64_t outer_size,
+    int64_t dim_size,
+    int64_t ignore_index) {
+  using acc_t = typename cross_entropy_acc_type<scalar_t>::type;
+  using Vec = vec::Vectorized<acc_t>;
+  static constexpr int64_t BLOCK_SIZE = 64 * Vec::size();
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        acc_t buffer[BLOCK_SIZE];
+        for (int64_t i = begin; i < end; i++) {
+          scalar_t* input_data = input_data_base + i * dim_size;
+          acc_t max_input = -std::numeric_limits<acc_t>::infinity();
+          acc_t tmp_sum = 0;
+          for (int64_t j = 0; j < dim_size; j += BLOCK_SIZE) {
+            const int64_t size = std::min(BLOCK_SIZE, dim_size - j);
+            acc_t* block = _load_block(input_data + j, buffer, size);
+            acc_t block_max = vec::reduce_all<acc_t>(
+                [](Vec& x, Vec& y) { return vec::maximum(x, y); },
+                block,
+                size);
+            if (block_max > max_input) {
+              // See [Note AVX-SSE transitions] for why this should call the
+              // vectorized version.
+              acc_t scale = max_input - block_max;
+              vec::map([](Vec x) { return x.exp(); }, &scale, &scale, 1);
+              tmp_sum *= scale;
+              max_input = block_max;
+            }
+            tmp_sum += vec::map_reduce_all<acc_t>(
+                [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
+                [](Vec x, Vec y) { return x + y; },
+                block,
+                size);
+          }
+          vec::map([](Vec x) { return x.log(); }, &tmp_sum, &tmp_sum, 1);
+          logsumexp_data[i] = max_input + tmp_sum;
+          const int64_t target = target_data[i];
+          if (target == ignore_index) {
+            losses_data[i] = 0;
+          } else {
+            // Same order of operations as in _vec_log_softmax_lastdim.
+            losses_data[i] =
+                -(static_cast<acc_t>(input_data[target]) - max_input - tmp_sum);
+          }
+        }
+      });
+}
+
+template <typename scalar_t>
+inline void _vec_softmax_cross_entropy_backward(
+    scalar_t* grad_input_data_base,
+    const scalar_t* grad_data,
+    scalar_t* input_data_base,
+    const int64_t* target_data,
+    const scalar_t* logsumexp_data,
+    int64_t outer_size,
+    int64_t dim_size,
+    int64_t ignore_index) {
+  using acc_t = typename cross_entropy_acc_type<scalar_t>::type;
+  using Vec = vec::Vectorized<acc_t>;
+  static constexpr int64_t BLOCK_SIZE = 64 * Vec::size();
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(
+      0,
+      outer_size,
+      grain_size,
+      [&](int64_t begin, int64_t end) {
+        acc_t input_buffer[BLOCK_SIZE];
+        acc_t output_buffer[BLOCK_SIZE];
+        for (int64_t i = begin; i < end; i++) {
+          scalar_t* input_data = input_data_base + i * dim_size;
+          scalar_t* grad_input_data = grad_input_data_base + i * dim_size;
+          const int64_t target = target_data[i];
+          if (target == ignore_index) {
+            std::fill(grad_input_data, grad_input_data + dim_size, scalar_t(0));
+            continue;
+          }
+          // grad * (softmax - one_hot(target)), with the softmax recomputed
+          // from the saved log-sum-exp.
+          const acc_t grad = grad_data[i];
+          const acc_t logsumexp = logsumexp_data[i];
+          for (int64_t j = 0; j < dim_size; j += BLOCK_SIZE) {
+            const int64_t size = std::min(BLOCK_SIZE, dim_size - j);
+            acc_t* block = _load_block(input_data + j, input_buffer, size);
+            acc_t* output = _output_block(grad_input_data + j, output_buffer);
+            vec::map(
+                [grad, logsumexp](Vec x) {
+                  return (x - Vec(logsumexp)).exp() * Vec(grad);
+                },
+                output,
+                block,
+                size);
+            _flush_block(grad_input_data + j, output, size);
+          }
+          grad_input_data[target] =
+              static_cast<acc_t>(grad_input_data[target]) - grad;
+        }
+      });
+}
+
 template <typename scalar_t, bool LogSoftMax>
 struct vec_host_softmax_lastdim {
   static void apply(Tensor& output, const Tensor& input) {
@@ -224,9 +533,10 @@ struct vec_host_softmax_backward_lastdim {
 };
 
 static void softmax_lastdim_kernel_impl(Tensor& result, const Tensor& self) {
-  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "softmax_lastdim_kernel_impl", [&] {
-    vec_host_softmax_lastdim<scalar_t, false>::apply(result, self);
-  });
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, self.scalar_type(),
+      "softmax_lastdim_kernel_impl",
+      [&] { vec_host_softmax_lastdim<scalar_t, false>::apply(result, self); });
 }
 
 static void log_softmax_lastdim_kernel_impl(
@@ -242,8 +552,9 @@ static void softmax_backward_lastdim_kernel_impl(
     Tensor& grad_input,
     const Tensor& grad,
     const Tensor& output) {
-  AT_DISPATCH_FLOATING_TYPES(
-      grad.scalar_type(), "softmax_backward_lastdim_kernel_impl", [&] {
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, grad.scalar_type(),
+      "softmax_backward_lastdim_kernel_impl", [&] {
         vec_host_softmax_backward_lastdim<scalar_t, false>::apply(
             grad_input, grad, output);
       });
@@ -261,6 +572,63 @@ static void log_softmax_backward_lastdim_kernel_impl(
       });
 }
 
+static void check_cross_entropy_targets(
+    const Tensor& target,
+    int64_t dim_size,
+    int64_t ignore_index) {
+  const int64_t* target_data = target.data_ptr<int64_t>();
+  for (int64_t i = 0; i < target.numel(); i++) {
+    const int64_t cur_target = target_data[i];
+    TORCH_CHECK_INDEX(
+        cur_target == ignore_index || (cur_target >= 0 && cur_target < dim_size),
+        "Target ", cur_target, " is out of bounds.");
+  }
+}
+
+static void softmax_cross_entropy_kernel_impl(
+    Tensor& losses,
+    Tensor& logsumexp,
+    const Tensor& self,
+    const Tensor& target,
+    int64_t ignore_index) {
+  check_cross_entropy_targets(target, self.size(1), ignore_index);
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, self.scalar_type(),
+      "softmax_cross_entropy_kernel_impl", [&] {
+        _vec_softmax_cross_entropy<scalar_t>(
+            self.data_ptr<scalar_t>(),
+            target.data_ptr<int64_t>(),
+            losses.data_ptr<scalar_t>(),
+            logsumexp.data_ptr<scalar_t>(),
+            self.size(0),
+            self.size(1),
+            ignore_index);
+      });
+}
+
+static void softmax_cross_entropy_backward_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& grad,
+    const Tensor& self,
+    const Tensor& target,
+    const Tensor& logsumexp,
+    int64_t ignore_index) {
+  check_cross_entropy_targets(target, self.size(1), ignore_index);
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, self.scalar_type(),
+      "softmax_cross_entropy_backward_kernel_impl", [&] {
+        _vec_softmax_cross_entropy_backward<scalar_t>(
+            grad_input.data_ptr<scalar_t>(),
+            grad.data_ptr<scalar_t>(),
+            self.data_ptr<scalar_t>(),
+            target.data_ptr<int64_t>(),
+            logsumexp.data_ptr<scalar_t>(),
+            self.size(0),
+            self.size(1),
+            ignore_index);
+      });
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(softmax_lastdim_kernel, &softmax_lastdim_kernel_impl);
@@ -271,5 +639,11 @@ REGISTER_DISPATCH(
 REGISTER_DISPATCH(
     log_softmax_backward_lastdim_kernel,
     &log_softmax_backward_lastdim_kernel_impl);
+REGISTER_DISPATCH(
+    softmax_cross_entropy_kernel,
+    &softmax_cross_entropy_kernel_impl);
+REGISTER_DISPATCH(
+    softmax_cross_entropy_backward_kernel,
+    &softmax_cross_entropy_backward_kernel_impl);
 
 }} // namespace at::native
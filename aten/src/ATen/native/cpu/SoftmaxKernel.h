@@ -8,11 +8,18 @@ namespace native {
 
 using forward_fn = void(*)(Tensor &, const Tensor &);
 using backward_fn = void(*)(Tensor &, const Tensor &, const Tensor&);
+// (losses, logsumexp, self, target, ignore_index)
+using cross_entropy_fn = void(*)(Tensor&, Tensor&, const Tensor&, const Tensor&, int64_t);
+// (grad_input, grad, self, target, logsumexp, ignore_index)
+using cross_entropy_backward_fn =
+    void(*)(Tensor&, const Tensor&, const Tensor&, const Tensor&, const Tensor&, int64_t);
 
 DECLARE_DISPATCH(forward_fn, softmax_lastdim_kernel);
 DECLARE_DISPATCH(forward_fn, log_softmax_lastdim_kernel);
 DECLARE_DISPATCH(backward_fn, softmax_backward_lastdim_kernel);
 DECLARE_DISPATCH(backward_fn, log_softmax_backward_lastdim_kernel);
+DECLARE_DISPATCH(cross_entropy_fn, softmax_cross_entropy_kernel);
+DECLARE_DISPATCH(cross_entropy_backward_fn, softmax_cross_entropy_backward_kernel);
 
 }
 }
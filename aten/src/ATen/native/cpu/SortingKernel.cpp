@@ -2,89 +2,516 @@
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
 #include <ATen/NumericUtils.h>
+#include <ATen/cpu/vec.h>
 #include <ATen/native/Sorting.h>
 #include <ATen/native/SortingUtils.h>
 
+#include <array>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
 namespace at { namespace native {
 
 namespace {
 
-static void topk_kernel(
+// Slices at least this long are sorted by all threads together when there are
+// too few slices to keep every thread busy with one slice each.
+constexpr int64_t kParallelSortMinSize = 1 << 16;
+// Chunks of a parallel slice sort are no shorter than this.
+constexpr int64_t kParallelSortMinChunk = 1 << 14;
+// The radix sort is used while at most this many of its 8-bit digit passes are
+// needed; wider key ranges (e.g. arbitrary 64-bit values) use the merge sort.
+constexpr int kMaxRadixPasses = 4;
+
+// we want NaN to be sorted as top for numpy compatibility
+template <typename scalar_t>
+struct SortLess {
+  bool operator()(scalar_t a, scalar_t b) const {
+    return (!_isnan<scalar_t>(a) && _isnan<scalar_t>(b)) || (a < b);
+  }
+};
+
+template <typename scalar_t>
+struct SortGreater {
+  bool operator()(scalar_t a, scalar_t b) const {
+    return (_isnan<scalar_t>(a) && !_isnan<scalar_t>(b)) || (a > b);
+  }
+};
+
+// Element offset of the start of the `slice`-th slice along `dim`.
+static int64_t slice_offset(const Tensor& t, int64_t dim, int64_t slice) {
+  int64_t offset = 0;
+  for (int64_t d = t.dim() - 1; d >= 0; d--) {
+    if (d != dim) {
+      offset += (slice % t.size(d)) * t.stride(d);
+      slice /= t.size(d);
+    }
+  }
+  return offset;
+}
+
+// Unsigned radix keys that order like SortLess: the sign bit is flipped for
+// signed integers, and floats map to their ordered bit patterns with NaN
+// canonicalized above +inf and -0.0 folded into 0.0, so that elements that
+// compare equal keep their input order in the stable sort.
+template <typename scalar_t>
+struct RadixKey {
+  using key_t = typename std::make_unsigned<scalar_t>::type;
+  static key_t get(scalar_t v) {
+    key_t k = static_cast<key_t>(v);
+    if (std::is_signed<scalar_t>::value) {
+      k ^= key_t(1) << (sizeof(key_t) * 8 - 1);
+    }
+    return k;
+  }
+};
+
+template <typename scalar_t, typename key_type>
+struct FloatRadixKey {
+  using key_t = key_type;
+  static key_t get(scalar_t v) {
+    if (_isnan(v)) {
+      v = std::numeric_limits<scalar_t>::quiet_NaN();
+    } else if (v == 0) {
+      v = 0;
+    }
+    key_t k;
+    std::memcpy(&k, &v, sizeof(k));
+    const key_t sign = key_t(1) << (sizeof(key_t) * 8 - 1);
+    return (k & sign) ? static_cast<key_t>(~k) : static_cast<key_t>(k | sign);
+  }
+};
+
+template <>
+struct RadixKey<float> : FloatRadixKey<float, uint32_t> {};
+
+template <>
+struct RadixKey<double> : FloatRadixKey<double, uint64_t> {};
+
+// Splits [0, n) into `nchunks` contiguous chunks and runs f(chunk, begin, end)
+// for each of them in parallel.
+template <typename F>
+static void for_each_chunk(int64_t n, int64_t nchunks, const F& f) {
+  at::parallel_for(0, nchunks, 1, [&](int64_t c_begin, int64_t c_end) {
+    for (int64_t c = c_begin; c < c_end; c++) {
+      f(c, c * n / nchunks, (c + 1) * n / nchunks);
+    }
+  });
+}
+
+// Stable LSD radix sort of one slice, one 8-bit digit per pass. The keys are
+// offset by their minimum, so only the bytes spanned by the key range are
+// sorted. In each pass every chunk counts its digits, the counts are scanned
+// digit-major across chunks, and every chunk scatters its elements to the
+// resulting offsets, which keeps the passes stable. Returns false, without
+// touching the slice, when the key range needs more than kMaxRadixPasses
+// passes.
+template <typename scalar_t>
+static bool parallel_radix_sort(
+    scalar_t* values, int64_t values_stride,
+    int64_t* indices, int64_t indices_stride,
+    int64_t n, bool descending, int64_t nchunks) {
+  using key_t = typename RadixKey<scalar_t>::key_t;
+
+  std::vector<key_t> keys(n);
+  std::vector<key_t> chunk_min(nchunks);
+  std::vector<key_t> chunk_max(nchunks);
+  for_each_chunk(n, nchunks, [&](int64_t c, int64_t begin, int64_t end) {
+    key_t kmin = std::numeric_limits<key_t>::max();
+    key_t kmax = 0;
+    for (int64_t i = begin; i < end; i++) {
+      key_t k = RadixKey<scalar_t>::get(values[i * values_stride]);
+      if (descending) {
+        k = static_cast<key_t>(~k);
+      }
+      keys[i] = k;
+      kmin = std::min(kmin, k);
+      kmax = std::max(kmax, k);
+    }
+    chunk_min[c] = kmin;
+    chunk_max[c] = kmax;
+  });
+  const key_t kmin = *std::min_element(chunk_min.begin(), chunk_min.end());
+  const key_t kmax = *std::max_element(chunk_max.begin(), chunk_max.end());
+  int npasses = 0;
+  for (uint64_t range = kmax - kmin; range != 0; range >>= 8) {
+    npasses++;
+  }
+  if (npasses > kMaxRadixPasses) {
+    return false;
+  }
+
+  std::vector<scalar_t> orig(n);
+  std::vector<int64_t> idx(n);
+  at::parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      orig[i] = values[i * values_stride];
+      idx[i] = i;
+    }
+  });
+
+  std::vector<key_t> keys_tmp(npasses > 0 ? n : 0);
+  std::vector<int64_t> idx_tmp(npasses > 0 ? n : 0);
+  key_t* src_keys = keys.data();
+  key_t* dst_keys = keys_tmp.data();
+  int64_t* src_idx = idx.data();
+  int64_t* dst_idx = idx_tmp.data();
+  std::vector<std::array<int64_t, 256>> offsets(nchunks);
+  for (int p = 0; p < npasses; p++) {
+    const int shift = 8 * p;
+    auto digit = [kmin, shift](key_t k) -> int {
+      return static_cast<int>((static_cast<uint64_t>(static_cast<key_t>(k - kmin)) >> shift) & 0xff);
+    };
+    for_each_chunk(n, nchunks, [&](int64_t c, int64_t begin, int64_t end) {
+      auto& hist = offsets[c];
+      hist.fill(0);
+      for (int64_t i = begin; i < end; i++) {
+        hist[digit(src_keys[i])]++;
+      }
+    });
+    int64_t offset = 0;
+    for (int b = 0; b < 256; b++) {
+      for (int64_t c = 0; c < nchunks; c++) {
+        int64_t count = offsets[c][b];
+        offsets[c][b] = offset;
+        offset += count;
+      }
+    }
+    for_each_chunk(n, nchunks, [&](int64_t c, int64_t begin, int64_t end) {
+      auto& offs = offsets[c];
+      for (int64_t i = begin; i < end; i++) {
+        int64_t pos = offs[digit(src_keys[i])]++;
+        dst_keys[pos] = src_keys[i];
+        dst_idx[pos] = src_idx[i];
+      }
+    });
+    std::swap(src_keys, dst_keys);
+    std::swap(src_idx, dst_idx);
+  }
+
+  at::parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      values[i * values_stride] = orig[src_idx[i]];
+      indices[i * indices_stride] = src_idx[i];
+    }
+  });
+  return true;
+}
+
+// Stable merge sort of one slice: the chunks are sorted in parallel, then
+// pairs of neighbouring runs are merged in parallel until one run is left.
+template <typename scalar_t, typename comp_t>
+static void parallel_merge_sort(
+    scalar_t* values, int64_t values_stride,
+    int64_t* indices, int64_t indices_stride,
+    int64_t n, comp_t comp, int64_t nchunks) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  auto elem_comp = [&comp](const elem_t& x, const elem_t& y) -> bool {
+    return comp(x.first, y.first);
+  };
+  std::vector<elem_t> buf(n);
+  std::vector<elem_t> buf_tmp(n);
+  for_each_chunk(n, nchunks, [&](int64_t /*c*/, int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      buf[i] = elem_t(values[i * values_stride], i);
+    }
+    std::stable_sort(buf.begin() + begin, buf.begin() + end, elem_comp);
+  });
+
+  // run r covers [r * n / nchunks, (r + width) * n / nchunks)
+  elem_t* src = buf.data();
+  elem_t* dst = buf_tmp.data();
+  for (int64_t width = 1; width < nchunks; width *= 2) {
+    const int64_t npairs = (nchunks + 2 * width - 1) / (2 * width);
+    at::parallel_for(0, npairs, 1, [&](int64_t p_begin, int64_t p_end) {
+      for (int64_t p = p_begin; p < p_end; p++) {
+        int64_t r = p * 2 * width;
+        int64_t begin = r * n / nchunks;
+        int64_t mid = std::min(r + width, nchunks) * n / nchunks;
+        int64_t end = std::min(r + 2 * width, nchunks) * n / nchunks;
+        std::merge(src + begin, src + mid, src + mid, src + end, dst + begin, elem_comp);
+      }
+    });
+    std::swap(src, dst);
+  }
+
+  at::parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      values[i * values_stride] = src[i].first;
+      indices[i * indices_stride] = src[i].second;
+    }
+  });
+}
+
+template <typename scalar_t, typename comp_t>
+static void sort_slice(
+    scalar_t* values, int64_t values_stride,
+    int64_t* indices, int64_t indices_stride,
+    int64_t n, comp_t comp, std::vector<std::pair<scalar_t, int64_t>>& buf) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  buf.resize(n);
+  for (int64_t i = 0; i < n; i++) {
+    buf[i] = elem_t(values[i * values_stride], i);
+  }
+  std::stable_sort(buf.begin(), buf.end(),
+    [&comp](const elem_t& x, const elem_t& y) -> bool {
+      return comp(x.first, y.first);
+    });
+  for (int64_t i = 0; i < n; i++) {
+    values[i * values_stride] = buf[i].first;
+    indices[i * indices_stride] = buf[i].second;
+  }
+}
+
+// Sorts `values` in place along `dim`, stably, and writes the permutation to
+// `indices`. Batches of slices are sorted one slice per thread; a few long
+// slices are each sorted by all threads with a radix sort, or with a merge
+// sort when the keys are too wide for the radix sort to pay off.
+static void sort_kernel(
+    Tensor& values,
+    Tensor& indices,
+    int64_t dim,
+    bool descending) {
+  if (values.numel() == 0) {
+    return;
+  }
+  const int64_t n = values.size(dim);
+  const int64_t nslices = values.numel() / n;
+  const int64_t values_stride = values.stride(dim);
+  const int64_t indices_stride = indices.stride(dim);
+  AT_DISPATCH_ALL_TYPES(values.scalar_type(), "sort_cpu", [&] {
+    scalar_t* values_data = values.data_ptr<scalar_t>();
+    int64_t* indices_data = indices.data_ptr<int64_t>();
+    const int64_t nchunks = std::min<int64_t>(
+        at::get_num_threads(), n / kParallelSortMinChunk);
+    if (n >= kParallelSortMinSize && nslices < at::get_num_threads() &&
+        nchunks > 1 && !at::in_parallel_region()) {
+      for (int64_t s = 0; s < nslices; s++) {
+        scalar_t* v = values_data + slice_offset(values, dim, s);
+        int64_t* i = indices_data + slice_offset(indices, dim, s);
+        if (parallel_radix_sort(v, values_stride, i, indices_stride, n, descending, nchunks)) {
+          continue;
+        }
+        if (descending) {
+          parallel_merge_sort(v, values_stride, i, indices_stride, n, SortGreater<scalar_t>(), nchunks);
+        } else {
+          parallel_merge_sort(v, values_stride, i, indices_stride, n, SortLess<scalar_t>(), nchunks);
+        }
+      }
+      return;
+    }
+    const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / n);
+    at::parallel_for(0, nslices, grain_size, [&](int64_t begin, int64_t end) {
+      std::vector<std::pair<scalar_t, int64_t>> buf;
+      for (int64_t s = begin; s < end; s++) {
+        scalar_t* v = values_data + slice_offset(values, dim, s);
+        int64_t* i = indices_data + slice_offset(indices, dim, s);
+        if (descending) {
+          sort_slice(v, values_stride, i, indices_stride, n, SortGreater<scalar_t>(), buf);
+        } else {
+          sort_slice(v, values_stride, i, indices_stride, n, SortLess<scalar_t>(), buf);
+        }
+      }
+    });
+  });
+}
+
+// Number of vectors whose best element is checked against the current
+// threshold at once by topk_candidates.
+constexpr int64_t kTopkSpanVecs = 8;
+// A slice at least this long is split across threads by topk when there are
+// too few slices to keep every thread busy with one slice each.
+constexpr int64_t kParallelTopkMinSize = 1 << 16;
+
+// Appends to `buf` the best k (under comp) of the contiguous x[begin, end),
+// unsorted; `begin` is also the index of x[begin] in the output. Once k
+// candidates are known, the worst of them is a threshold, and whole spans of
+// the input are skipped when the best of the span (a vectorized max or min)
+// does not beat it, so for small k most of the input is only read by the
+// vectorized reduction.
+template <typename scalar_t, typename comp_t>
+static void topk_candidates(
+    const scalar_t* x, int64_t begin, int64_t end,
+    int64_t k, bool largest, comp_t comp,
+    std::vector<std::pair<scalar_t, int64_t>>& buf) {
+  using Vec = vec::Vectorized<scalar_t>;
+  using elem_t = std::pair<scalar_t, int64_t>;
+  constexpr int64_t span = kTopkSpanVecs * Vec::size();
+  auto elem_comp = [&comp](const elem_t& a, const elem_t& b) -> bool {
+    return comp(a.first, b.first);
+  };
+  auto span_best = [&](const scalar_t* p) -> scalar_t {
+    Vec acc = Vec::loadu(p);
+    if (largest) {
+      for (int64_t j = 1; j < kTopkSpanVecs; j++) {
+        acc = vec::maximum(acc, Vec::loadu(p + j * Vec::size()));
+      }
+    } else {
+      for (int64_t j = 1; j < kTopkSpanVecs; j++) {
+        acc = vec::minimum(acc, Vec::loadu(p + j * Vec::size()));
+      }
+    }
+    scalar_t lanes[Vec::size()];
+    acc.store(lanes);
+    scalar_t best = lanes[0];
+    for (int64_t l = 0; l < Vec::size(); l++) {
+      if (_isnan(lanes[l])) {
+        return lanes[l];
+      }
+      if (comp(lanes[l], best)) {
+        best = lanes[l];
+      }
+    }
+    return best;
+  };
+
+  const size_t first = buf.size();
+  bool have_threshold = false;
+  scalar_t threshold = scalar_t(0);
+  for (int64_t s = begin; s < end; s += span) {
+    const int64_t s_end = std::min(s + span, end);
+    if (have_threshold && s_end - s == span) {
+      // a NaN from the NaN-propagating reduction may hide better elements,
+      // so such spans are always scanned
+      scalar_t best = span_best(x + s);
+      if (!_isnan(best) && !comp(best, threshold)) {
+        continue;
+      }
+    }
+    for (int64_t i = s; i < s_end; i++) {
+      if (!have_threshold || comp(x[i], threshold)) {
+        buf.emplace_back(x[i], i);
+      }
+    }
+    if (buf.size() - first >= static_cast<size_t>(2 * k)) {
+      std::nth_element(buf.begin() + first, buf.begin() + first + k - 1, buf.end(), elem_comp);
+      buf.resize(first + k);
+      threshold = buf.back().first;
+      have_threshold = true;
+    }
+  }
+  if (buf.size() - first > static_cast<size_t>(k)) {
+    std::nth_element(buf.begin() + first, buf.begin() + first + k - 1, buf.end(), elem_comp);
+    buf.resize(first + k);
+  }
+}
+
+// Moves the best k (under comp) of `buf` to its front, sorted if requested.
+template <typename scalar_t, typename comp_t>
+static void topk_select(
+    std::vector<std::pair<scalar_t, int64_t>>& buf,
+    int64_t k, bool sorted, comp_t comp) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  auto elem_comp = [&comp](const elem_t& a, const elem_t& b) -> bool {
+    return comp(a.first, b.first);
+  };
+  if (buf.size() > static_cast<size_t>(k)) {
+    std::nth_element(buf.begin(), buf.begin() + k - 1, buf.end(), elem_comp);
+  }
+  if (sorted) {
+    std::sort(buf.begin(), buf.begin() + k, elem_comp);
+  }
+}
+
+template <typename scalar_t, typename comp_t>
+static void topk_impl(
     Tensor& values,
     Tensor& indices,
     const Tensor& self,
     int64_t k,
     int64_t dim,
     bool largest,
-    bool sorted) {
-  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "topk_cpu", [&] {
-    dim_apply(
-        {self, values, indices},
-        dim,
-        [&](int64_t i, TensorList tl) {
-          auto tmp_values = tl[0].accessor<scalar_t, 1>();
-          auto mode_values = tl[1].accessor<scalar_t, 1>();
-          auto mode_indices = tl[2].accessor<int64_t, 1>();
-
-          auto n = tmp_values.size(0);
-          auto use_partial_sort = k * 64 <= n;
-
-          using elem_t = std::pair<scalar_t, int64_t>;
-          std::vector<elem_t> queue(n);
+    bool sorted,
+    comp_t comp) {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  const int64_t n = self.size(dim);
+  const int64_t nslices = self.numel() / n;
+
+  // a few long contiguous slices: every thread filters one chunk of the
+  // slice, and the best k of the chunk candidates are the best k overall
+  const int64_t nchunks = std::min<int64_t>(
+      at::get_num_threads(), n / kParallelTopkMinSize);
+  if (self.stride(dim) == 1 && k * 64 <= n && nslices < at::get_num_threads() &&
+      nchunks > 1 && !at::in_parallel_region()) {
+    const scalar_t* self_data = self.data_ptr<scalar_t>();
+    scalar_t* values_data = values.data_ptr<scalar_t>();
+    int64_t* indices_data = indices.data_ptr<int64_t>();
+    std::vector<std::vector<elem_t>> chunk_bufs(nchunks);
+    std::vector<elem_t> buf;
+    for (int64_t s = 0; s < nslices; s++) {
+      const scalar_t* x = self_data + slice_offset(self, dim, s);
+      for_each_chunk(n, nchunks, [&](int64_t c, int64_t begin, int64_t end) {
+        chunk_bufs[c].clear();
+        topk_candidates(x, begin, end, k, largest, comp, chunk_bufs[c]);
+      });
+      buf.clear();
+      for (const auto& chunk_buf : chunk_bufs) {
+        buf.insert(buf.end(), chunk_buf.begin(), chunk_buf.end());
+      }
+      topk_select(buf, k, sorted, comp);
+      scalar_t* v = values_data + slice_offset(values, dim, s);
+      int64_t* i = indices_data + slice_offset(indices, dim, s);
+      for (int64_t j = 0; j < k; j++) {
+        v[j * values.stride(dim)] = buf[j].first;
+        i[j * indices.stride(dim)] = buf[j].second;
+      }
+    }
+    return;
+  }
+
+  dim_apply(
+      {self, values, indices},
+      dim,
+      [&](int64_t i, TensorList tl) {
+        auto tmp_values = tl[0].accessor<scalar_t, 1>();
+        auto mode_values = tl[1].accessor<scalar_t, 1>();
+        auto mode_indices = tl[2].accessor<int64_t, 1>();
+
+        std::vector<elem_t> queue;
+        if (tmp_values.stride(0) == 1 && k * 64 <= n) {
+          // small k: filter the slice and select from the candidates
+          topk_candidates(tmp_values.data(), 0, n, k, largest, comp, queue);
+        } else {
+          queue.resize(n);
           for (int64_t j = 0; j < n; j++) {
             queue[j].first = tmp_values[j];
             queue[j].second = j;
           }
+        }
+        topk_select(queue, k, sorted, comp);
 
-          // we want NaN to be sorted as top for numpy compatibility
-          if (use_partial_sort) {
-            if (largest) {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-            } else {
-              std::partial_sort(queue.begin(), queue.begin() + k, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-            }
-          } else {
-            if (largest) {
-              std::nth_element(queue.begin(), queue.begin() + k - 1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k - 1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
-                  });
-              }
-            } else {
-              std::nth_element(queue.begin(), queue.begin() + k -1, queue.end(),
-                [](const elem_t& x, const elem_t& y) -> bool {
-                  return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                });
-              if (sorted) {
-                std::sort(queue.begin(), queue.begin() + k -1,
-                  [](const elem_t& x, const elem_t& y) -> bool {
-                    return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
-                  });
-              }
-            }
-          }
+        for (int64_t j = 0; j < k; j++) {
+          mode_values[j] = queue[j].first;
+          mode_indices[j] = queue[j].second;
+        }
+      });
+}
 
-          for (int64_t j = 0; j < k; j++) {
-            mode_values[j] = queue[j].first;
-            mode_indices[j] = queue[j].second;
-          }
-        });
+static void topk_kernel(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t k,
+    int64_t dim,
+    bool largest,
+    bool sorted) {
+  if (k == 0 || self.numel() == 0) {
+    return;
+  }
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "topk_cpu", [&] {
+    // we want NaN to be sorted as top for numpy compatibility
+    if (largest) {
+      topk_impl<scalar_t>(values, indices, self, k, dim, largest, sorted, SortGreater<scalar_t>());
+    } else {
+      topk_impl<scalar_t>(values, indices, self, k, dim, largest, sorted, SortLess<scalar_t>());
+    }
   });
 }
 
 } // anonymous namespace
 
 REGISTER_DISPATCH(topk_stub, &topk_kernel);
+REGISTER_DISPATCH(sort_stub, &sort_kernel);
 
 }} //at::native
@@ -0,0 +1,80 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/sparse/SparseTensorMath.h>
+
+namespace at { namespace native {
+namespace {
+
+template <typename scalar_t>
+void csr_mm_kernel_impl(
+    Tensor& r,
+    scalar_t alpha,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense) {
+  using Vec = vec256::Vec256<scalar_t>;
+  const int64_t dim_i = r.size(0);
+  const int64_t dim_k = r.size(1);
+  const int64_t nnz = values.numel();
+  const int64_t* crow_ptr = crow_indices.data_ptr<int64_t>();
+  const int64_t* col_ptr = col_indices.data_ptr<int64_t>();
+  const scalar_t* values_ptr = values.data_ptr<scalar_t>();
+  const scalar_t* dense_ptr = dense.data_ptr<scalar_t>();
+  scalar_t* r_ptr = r.data_ptr<scalar_t>();
+  const int64_t dense_stride0 = dense.stride(0);
+  const int64_t dense_stride1 = dense.stride(1);
+  const int64_t r_stride0 = r.stride(0);
+  const int64_t r_stride1 = r.stride(1);
+  const bool contiguous_rows = dense_stride1 == 1 && r_stride1 == 1;
+
+  // Every output row is owned by a single thread, so no two threads write
+  // the same memory; the grain size aims at GRAIN_SIZE multiply-adds.
+  const int64_t work_per_row = std::max<int64_t>(1, nnz / std::max<int64_t>(1, dim_i) * dim_k);
+  const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / work_per_row);
+  at::parallel_for(0, dim_i, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      scalar_t* out = r_ptr + row * r_stride0;
+      for (int64_t p = crow_ptr[row]; p < crow_ptr[row + 1]; p++) {
+        const scalar_t val = alpha * values_ptr[p];
+        const scalar_t* in = dense_ptr + col_ptr[p] * dense_stride0;
+        if (contiguous_rows) {
+          const Vec val_vec(val);
+          int64_t k = 0;
+          for (; k < dim_k - (dim_k % Vec::size()); k += Vec::size()) {
+            Vec out_vec = Vec::loadu(out + k) + val_vec * Vec::loadu(in + k);
+            out_vec.store(out + k);
+          }
+          for (; k < dim_k; k++) {
+            out[k] += val * in[k];
+          }
+        } else {
+          for (int64_t k = 0; k < dim_k; k++) {
+            out[k * r_stride1] += val * in[k * dense_stride1];
+          }
+        }
+      }
+    }
+  });
+}
+
+void csr_mm_kernel(
+    Tensor& r,
+    Scalar alpha,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense) {
+  AT_DISPATCH_ALL_TYPES(values.scalar_type(), "csr_mm", [&] {
+    csr_mm_kernel_impl<scalar_t>(
+        r, alpha.to<scalar_t>(), crow_indices, col_indices, values, dense);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(sparse_csr_mm_stub, &csr_mm_kernel);
+
+}} // namespace at::native
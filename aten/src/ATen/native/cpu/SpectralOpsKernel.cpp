@@ -0,0 +1,140 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/SpectralOpsUtils.h>
+
+#include <complex>
+#include <vector>
+
+namespace at { namespace native {
+
+namespace {
+
+using namespace vec256;
+
+// to[j] = conj(from[size - j]) for start <= j < size. The elements read are
+// read in reverse order, so every vector is loaded from the mirrored position
+// and flipped. The source and destination ranges never overlap: from[size - j]
+// for j >= start only reads elements below start.
+template <typename scalar_t>
+static inline void conj_mirror_copy(std::complex<scalar_t>* to, const std::complex<scalar_t>* from,
+                                    int64_t start, int64_t size) {
+  using Vec = Vec256<std::complex<scalar_t>>;
+  int64_t j = start;
+  for (; j + Vec::size() <= size; j += Vec::size()) {
+    auto mirrored = Vec::loadu(from + (size - j - Vec::size() + 1));
+    flip(mirrored).conj().store(to + j);
+  }
+  for (; j < size; j++) {
+    to[j] = std::conj(from[size - j]);
+  }
+}
+
+// In real-to-complex transform, MKL FFT only fills half of the values due to
+// conjugate symmetry. See native/SpectralUtils.h for more details.
+// The following structs are used to fill in the other half with symmetry in
+// case of real-to-complex transform with onesided=False flag.
+// See NOTE [ Fourier Transform Conjugate Symmetry ] in native/SpectralOpsUtils.h.
+
+template <typename scalar_t>
+static inline void _fft_fill_with_conjugate_symmetry_slice(Tensor& output,
+                       int64_t signal_ndim, int64_t size_last_dim,
+                       int64_t start_last_dim_idx, int64_t i, int64_t num) {
+  // The last dimension of output holds the real and the imaginary part of
+  // each value, so output can be read as a contiguous array of complex values.
+  auto *data = reinterpret_cast<std::complex<scalar_t>*>(output.data_ptr<scalar_t>());
+
+  // A slice means a slice of last dimension (of size size_last_dim)
+
+  // This function iterates through the slices to fill, i.e. to_slice_data
+  // (basically data_slices[i:i+num]), and keeps track of the slices it reads
+  // data from, i.e., from_slice_data, using from_slice_indices, a vector
+  // containing the index of the from_slice_data slice.
+
+  // Compute the indices for the first from_slice_data
+  std::vector<int64_t> from_slice_indices(signal_ndim);  // up to before last signal dim
+  int64_t remainder = i;
+  // set last signal dim values
+  int64_t from_slice_offset = 0;
+  for (int64_t d = signal_ndim - 1; d >= 0; d--) {
+    int64_t dim_size = output.size(d);
+    int64_t dim_idx = remainder % dim_size;
+    remainder = remainder / dim_size;
+    from_slice_indices[d] = dim_idx;
+    if (d == 0) {
+      from_slice_offset += dim_idx * output.stride(d);
+    } else if (dim_idx != 0) {
+      from_slice_offset += (dim_size - dim_idx) * output.stride(d);
+    }
+  }
+
+  // First to_slice_data and from_slice_data. Strides are in real values, and
+  // there are two of them per complex value.
+  std::complex<scalar_t> *to_slice_data = data + i * size_last_dim;
+  std::complex<scalar_t> *from_slice_data = data + from_slice_offset / 2;
+
+  while (num > 0) {
+    // Fill to_slice_data from values in from_slice_data
+    conj_mirror_copy(to_slice_data, from_slice_data, start_last_dim_idx, size_last_dim);
+    // Compute the next to_slice_data and from_slice_data slices
+    to_slice_data += size_last_dim;
+    for (int64_t d = signal_ndim - 1; d >= 0; d--) {
+      // Compute the next index at this dimension using conjugate symmetry
+      // Break out of this loop if nothing carries over
+      from_slice_indices[d] = (from_slice_indices[d] + 1) % output.size(d);
+      if (d > 0) {
+        // At d > 0 nonbatch dim, to get next from_slice_data offset
+        //   1. if this dim idx becomes 1, will need to add (size - 1) * stride
+        //   2. otherwise, will need to subtract stride
+        if (from_slice_indices[d] == 0) {
+          // Subtract. Carries over to previous dimension
+          from_slice_data -= output.stride(d) / 2;
+        } else if (from_slice_indices[d] == 1) {
+          // Dimension index becomes 1
+          // Doesn't carry over to previous dimension
+          from_slice_data += (output.size(d) - 1) * output.stride(d) / 2;
+          break;
+        } else {
+          // Subtract. Doesn't carry over to previous dimension
+          from_slice_data -= output.stride(d) / 2;
+          break;
+        }
+      } else {
+        // At d = 0 nonbatch dim, it means that to_slice_data ise now at a the
+        // beginning of a data sample. It maps to itself by conjugate symmetry.
+        from_slice_data = to_slice_data;
+      }
+    }
+    num--;
+  }
+}
+
+// input should be a contiguous batched tensor of same size as full (twosided)
+// signals, but only contains half (onesided) of the values.
+// This function modifies inplace.
+void _fft_fill_with_conjugate_symmetry_kernel(Tensor& input,
+                      int64_t signal_ndim, int64_t size_last_dim,
+                      int64_t last_dim_start_slice) {
+  if (last_dim_start_slice >= size_last_dim) {
+    return;
+  }
+
+  int64_t num = 1;
+  for (int64_t d = 0; d < signal_ndim; d++) {
+    num *= input.size(d);
+  }
+
+  at::parallel_for(0, num, 500, [&](int64_t start, int64_t end) {
+    AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "_fft_fill_with_conjugate_symmetry", [&] {
+      _fft_fill_with_conjugate_symmetry_slice<scalar_t>(input, signal_ndim, size_last_dim,
+          last_dim_start_slice, start, (end - start));
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(fft_fill_with_conjugate_symmetry_stub, &_fft_fill_with_conjugate_symmetry_kernel);
+
+}} // namespace at::native
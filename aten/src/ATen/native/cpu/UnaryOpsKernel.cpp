@@ -8,8 +8,7 @@
 #include <ATen/Parallel.h>
 
 #include <ATen/cpu/vml.h>
-#include <ATen/cpu/vec256/vec256.h>
-#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec.h>
 
 #include <ATen/native/Distributions.h>
 #include <ATen/native/TensorIterator.h>
@@ -28,17 +27,15 @@
 namespace at { namespace native {
 namespace {
 
-using namespace vec256;
-
 static void sigmoid_kernel(TensorIterator& iter) {
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(iter.dtype(), "sigmoid_cpu", [&]() {
+  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND1(kBFloat16, iter.dtype(), "sigmoid_cpu", [&]() {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return ((scalar_t)(1) / ((scalar_t)(1) + std::exp((-a)))); },
-        [=](Vec256<scalar_t> a) {
-          a = Vec256<scalar_t>((scalar_t)(0)) - a;
+        [=](vec::Vectorized<scalar_t> a) {
+          a = vec::Vectorized<scalar_t>((scalar_t)(0)) - a;
           a = a.exp();
-          a = Vec256<scalar_t>((scalar_t)(1)) + a;
+          a = vec::Vectorized<scalar_t>((scalar_t)(1)) + a;
           a = a.reciprocal();
           return a;
         });
@@ -55,11 +52,11 @@ uint8_t abs_impl(uint8_t v) {
 }
 
 static void abs_kernel(TensorIterator& iter) {
-  AT_DISPATCH_ALL_TYPES_AND_COMPLEX(iter.dtype(), "abs_cpu", [&]() {
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kBFloat16, iter.dtype(), "abs_cpu", [&]() {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return abs_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.abs(); });
+        [=](vec::Vectorized<scalar_t> a) { return a.abs(); });
   });
 }
 
@@ -68,7 +65,7 @@ static void angle_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return angle_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.angle(); });
+        [=](vec::Vectorized<scalar_t> a) { return a.angle(); });
   });
 }
 
@@ -77,7 +74,7 @@ static void real_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return real_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.real(); });
+        [=](vec::Vectorized<scalar_t> a) { return a.real(); });
   });
 }
 
@@ -86,7 +83,7 @@ static void imag_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return imag_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.imag(); });
+        [=](vec::Vectorized<scalar_t> a) { return a.imag(); });
   });
 }
 
@@ -95,7 +92,7 @@ static void conj_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return conj_impl(a); },
-        [=](Vec256<scalar_t> a) { return a.conj(); });
+        [=](vec::Vectorized<scalar_t> a) { return a.conj(); });
   });
 }
 
@@ -124,7 +121,7 @@ static void frac_kernel(TensorIterator& iter) {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return a - std::trunc(a); },
-        [=](Vec256<scalar_t> a) { return a.frac(); });
+        [=](vec::Vectorized<scalar_t> a) { return a.frac(); });
   });
 }
 
@@ -138,20 +135,20 @@ static void logical_not_kernel(TensorIterator& iter) {
 }
 
 static void reciprocal_kernel(TensorIterator& iter) {
-  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(iter.dtype(), "reciprocal_cpu", [&]() {
+  AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES_AND1(kBFloat16, iter.dtype(), "reciprocal_cpu", [&]() {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return decltype(a)(1.0) / a; },
-        [=](Vec256<scalar_t> a) { return a.reciprocal(); });
+        [=](vec::Vectorized<scalar_t> a) { return a.reciprocal(); });
   });
 }
 
 static void neg_kernel(TensorIterator& iter) {
-  AT_DISPATCH_ALL_TYPES_AND_COMPLEX(iter.dtype(), "neg_cpu", [&]() {
+  AT_DISPATCH_ALL_TYPES_AND_COMPLEX_AND(kBFloat16, iter.dtype(), "neg_cpu", [&]() {
     cpu_kernel_vec(
         iter,
         [=](scalar_t a) -> scalar_t { return -a; },
-        [=](Vec256<scalar_t> a) { return a.neg(); });
+        [=](vec::Vectorized<scalar_t> a) { return a.neg(); });
   });
 }
 
@@ -160,17 +157,17 @@ static void sign_kernel(TensorIterator& iter){
       cpu_kernel(iter, [=](bool x) -> bool { return x; });
   } else {
     AT_DISPATCH_ALL_TYPES_AND(ScalarType::Half, iter.dtype(), "sign_cpu", [&]() {
-        auto zero_vec = Vec256<scalar_t>((scalar_t)(0));
-        auto one_vec = Vec256<scalar_t>((scalar_t)(1));
+        auto zero_vec = vec::Vectorized<scalar_t>((scalar_t)(0));
+        auto one_vec = vec::Vectorized<scalar_t>((scalar_t)(1));
 
         cpu_kernel_vec(
             iter,
             [=](scalar_t a) -> scalar_t { return (0 < a) - (a < 0); },
-            [=](Vec256<scalar_t> self_vec){
+            [=](vec::Vectorized<scalar_t> self_vec){
 
                 // Comparision operators returns bitmask.
-                auto left = Vec256<scalar_t>::blendv(zero_vec, one_vec, zero_vec < self_vec);
-                auto right = Vec256<scalar_t>::blendv(zero_vec, one_vec, self_vec < zero_vec);
+                auto left = vec::Vectorized<scalar_t>::blendv(zero_vec, one_vec, zero_vec < self_vec);
+                auto right = vec::Vectorized<scalar_t>::blendv(zero_vec, one_vec, self_vec < zero_vec);
 
                 return left - right;
             });
@@ -223,11 +220,11 @@ static void clamp_kernel(TensorIterator& iter, Scalar min_scalar, Scalar max_sca
     ztype<scalar_t>::value_t (*zabs_)(scalar_t) = zabs;
     auto min = min_scalar.to<scalar_t>();
     auto max = max_scalar.to<scalar_t>();
-    auto min_vec = Vec256<scalar_t>(min);
-    auto max_vec = Vec256<scalar_t>(max);
+    auto min_vec = vec::Vectorized<scalar_t>(min);
+    auto max_vec = vec::Vectorized<scalar_t>(max);
     cpu_kernel_vec(iter,
      [=](scalar_t a) -> scalar_t { return zabs_(a) < zabs_(min) ? min : (zabs_(a) > zabs_(max) ? max : a); },
-     [=](Vec256<scalar_t> a) { return vec256::clamp(a, min_vec, max_vec); });
+     [=](vec::Vectorized<scalar_t> a) { return vec::clamp(a, min_vec, max_vec); });
   });
 }
 
@@ -235,10 +232,10 @@ static void clamp_max_kernel(TensorIterator& iter, Scalar max_scalar) {
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX(iter.dtype(), "clamp_max_cpu", [&]() {
     ztype<scalar_t>::value_t (*zabs_)(scalar_t) = zabs;
     auto max = max_scalar.to<scalar_t>();
-    auto max_vec = Vec256<scalar_t>(max);
+    auto max_vec = vec::Vectorized<scalar_t>(max);
     cpu_kernel_vec(iter,
      [=](scalar_t a) -> scalar_t { return zabs_(a) > zabs_(max) ? max : a; },
-     [=](Vec256<scalar_t> a) { return vec256::clamp_max(a, max_vec); });
+     [=](vec::Vectorized<scalar_t> a) { return vec::clamp_max(a, max_vec); });
   });
 }
 
@@ -246,10 +243,10 @@ static void clamp_min_kernel(TensorIterator& iter, Scalar min_scalar) {
   AT_DISPATCH_ALL_TYPES_AND_COMPLEX(iter.dtype(), "clamp_min_cpu", [&]() {
     ztype<scalar_t>::value_t (*zabs_)(scalar_t) = zabs;
     auto min = min_scalar.to<scalar_t>();
-    auto min_vec = Vec256<scalar_t>(min);
+    auto min_vec = vec::Vectorized<scalar_t>(min);
     cpu_kernel_vec(iter,
      [=](scalar_t a) -> scalar_t { return zabs_(a) < zabs_(min) ? min : a; },
-     [=](Vec256<scalar_t> a) { return vec256::clamp_min(a, min_vec); });
+     [=](vec::Vectorized<scalar_t> a) { return vec::clamp_min(a, min_vec); });
   });
 }
 
@@ -440,9 +437,51 @@ void normal_fill(Tensor& self, const scalar_t mean, const scalar_t std, Generato
   }
 }
 
+// See Note [Philox fill of large CPU tensors]. The Box-Muller transform pairs
+// elements j and j + 8 of each group of 16, so the threads get whole groups;
+// the leftover elements come from an extra group past the end of the tensor.
+template <typename scalar_t>
+void normal_fill_philox(Tensor& self, const scalar_t mean, const scalar_t std, Generator* gen) {
+  scalar_t *data = self.data_ptr<scalar_t>();
+  auto size = self.numel();
+  CPUGenerator* generator = get_generator_or_default<CPUGenerator>(gen, detail::getDefaultCPUGenerator());
+  const uint64_t seed = templates::philox_fill_seed(generator);
+  const int64_t num_groups = size / 16;
+  at::parallel_for(0, num_groups, at::internal::GRAIN_SIZE / 16, [&](int64_t begin, int64_t end) {
+    scalar_t* out = data + begin * 16;
+    templates::philox_uniform<scalar_t>(out, begin * 16, end * 16, seed);
+    for (int64_t group = begin; group < end; ++group, out += 16) {
+#ifdef __AVX2__
+      if (std::is_same<scalar_t, float>::value) {
+        const __m256 two_pi = _mm256_set1_ps(2.0f * M_PI);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 minus_two = _mm256_set1_ps(-2.0f);
+        const __m256 mean_v = _mm256_set1_ps(mean);
+        const __m256 std_v = _mm256_set1_ps(std);
+        normal_fill_16_AVX2(reinterpret_cast<float*>(out), &two_pi, &one, &minus_two, &mean_v, &std_v);
+        continue;
+      }
+#endif
+      normal_fill_16<scalar_t>(out, mean, std);
+    }
+  });
+  const int64_t remainder = size - num_groups * 16;
+  if (remainder > 0) {
+    scalar_t tail[16];
+    templates::philox_uniform<scalar_t>(tail, num_groups * 16, num_groups * 16 + 16, seed);
+    normal_fill_16<scalar_t>(tail, mean, std);
+    std::copy(tail, tail + remainder, data + num_groups * 16);
+  }
+}
+
 void normal_kernel(Tensor& self, double mean, double std, Generator* gen) {
   auto size = self.numel();
-  if (self.scalar_type() == ScalarType::Float && size >= 16 && self.is_contiguous()) {
+  if ((self.scalar_type() == ScalarType::Float || self.scalar_type() == ScalarType::Double) &&
+      size >= templates::philox_fill_min_numel && self.is_contiguous()) {
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "normal_philox_cpu", [&] {
+      normal_fill_philox<scalar_t>(self, static_cast<scalar_t>(mean), static_cast<scalar_t>(std), gen);
+    });
+  } else if (self.scalar_type() == ScalarType::Float && size >= 16 && self.is_contiguous()) {
 #ifdef __AVX2__
     normal_fill_AVX2(self, static_cast<float>(mean), static_cast<float>(std), gen);
 #else
@@ -465,6 +504,20 @@ void normal_kernel(Tensor& self, double mean, double std, Generator* gen) {
   }
 }
 
+void uniform_philox_kernel(Tensor& self, double from, double to, Generator* gen) {
+  CPUGenerator* generator = get_generator_or_default<CPUGenerator>(gen, detail::getDefaultCPUGenerator());
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "uniform_philox_cpu", [&] {
+    templates::philox_uniform_fill<scalar_t>(self, from, to, generator);
+  });
+}
+
+void bernoulli_philox_kernel(Tensor& self, double p, Generator* gen) {
+  CPUGenerator* generator = get_generator_or_default<CPUGenerator>(gen, detail::getDefaultCPUGenerator());
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "bernoulli_philox_cpu", [&] {
+    templates::philox_bernoulli_fill<scalar_t>(self, p, generator);
+  });
+}
+
 static void rsqrt_kernel(TensorIterator& iter) {
   AT_DISPATCH_FLOATING_AND_COMPLEX_TYPES(iter.dtype(), "rsqrt_cpu", [&] {
     cpu_kernel_vec(
@@ -472,7 +525,7 @@ static void rsqrt_kernel(TensorIterator& iter) {
         [=](scalar_t a) -> scalar_t {
           return ((scalar_t)1) / std::sqrt(a);
         },
-        [=](Vec256<scalar_t> a) { return a.rsqrt(); });
+        [=](vec::Vectorized<scalar_t> a) { return a.rsqrt(); });
   });
 }
 
@@ -550,6 +603,8 @@ REGISTER_DISPATCH(exponential_stub, &exponential_kernel);
 REGISTER_DISPATCH(geometric_stub, &geometric_kernel);
 REGISTER_DISPATCH(log_normal_stub, &log_normal_kernel);
 REGISTER_DISPATCH(normal_stub, &normal_kernel);
+REGISTER_DISPATCH(uniform_philox_stub, &uniform_philox_kernel);
+REGISTER_DISPATCH(bernoulli_philox_stub, &bernoulli_philox_kernel);
 REGISTER_DISPATCH(abs_stub, &abs_kernel);
 REGISTER_DISPATCH(angle_stub, &angle_kernel);
 REGISTER_DISPATCH(real_stub, &real_kernel);
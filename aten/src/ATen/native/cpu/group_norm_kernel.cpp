@@ -0,0 +1,424 @@
+#include <ATen/native/group_norm.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <ATen/CPUApplyUtils.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at {
+namespace native {
+
+namespace {
+
+// The kernels work in two layouts. For contiguous (NCHW) inputs every
+// channel is a run of HxW elements and every group a run of D * HxW
+// elements. For channels last (NHWC) inputs every pixel is a run of C
+// channels, so the per channel sums are accumulated pixel by pixel, vectorized
+// over the channels, and then folded into groups.
+
+// sum1[c] += x[c], sum2[c] += x[c] * x[c]
+template <typename T>
+void ChannelsLastMomentsRow(const T* x, int64_t C, T* sum1, T* sum2) {
+  using Vec = vec256::Vec256<T>;
+  int64_t c = 0;
+  for (; c + Vec::size() <= C; c += Vec::size()) {
+    const Vec x_vec = Vec::loadu(x + c);
+    (Vec::loadu(sum1 + c) + x_vec).store(sum1 + c);
+    (Vec::loadu(sum2 + c) + x_vec * x_vec).store(sum2 + c);
+  }
+  for (; c < C; ++c) {
+    sum1[c] += x[c];
+    sum2[c] += x[c] * x[c];
+  }
+}
+
+// y[c] = a[c] * x[c] + b[c]
+template <typename T>
+void ChannelsLastAffineRow(const T* x, const T* a, const T* b, int64_t C, T* y) {
+  using Vec = vec256::Vec256<T>;
+  int64_t c = 0;
+  for (; c + Vec::size() <= C; c += Vec::size()) {
+    (Vec::loadu(a + c) * Vec::loadu(x + c) + Vec::loadu(b + c)).store(y + c);
+  }
+  for (; c < C; ++c) {
+    y[c] = a[c] * x[c] + b[c];
+  }
+}
+
+template <typename T>
+void GroupNormKernelImplInternal(
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    T eps,
+    Tensor* Y,
+    Tensor* mean,
+    Tensor* rstd) {
+  using Vec = vec256::Vec256<T>;
+  DCHECK_EQ(X.numel(), N * C * HxW);
+  DCHECK(!gamma.defined() || gamma.numel() == C);
+  DCHECK(!beta.defined() || beta.numel() == C);
+  const int64_t G = group;
+  const int64_t D = C / G;
+  T* X_data = X.data_ptr<T>();
+  const T* gamma_data = gamma.defined() ? gamma.data_ptr<T>() : nullptr;
+  const T* beta_data = beta.defined() ? beta.data_ptr<T>() : nullptr;
+  T* Y_data = Y->data_ptr<T>();
+  T* mean_data = mean->data_ptr<T>();
+  T* rstd_data = rstd->data_ptr<T>();
+  const T s = T(1) / static_cast<T>(D * HxW);
+  const bool gamma_null = gamma_data == nullptr;
+  const bool beta_null = beta_data == nullptr;
+
+  if (X.is_contiguous()) {
+    at::parallel_for(0, N * G, 1, [&](int64_t start, int64_t end) {
+      for (int64_t i = start; i < end; ++i) {
+        T* X_ptr = X_data + i * D * HxW;
+        T* Y_ptr = Y_data + i * D * HxW;
+        T mean_val = vec256::reduce_all<T>(
+            [](Vec& x, Vec& y) { return x + y; },
+            X_ptr,
+            D * HxW);
+        T rstd_val = vec256::map_reduce_all<T>(
+            [](Vec x) { return x * x; },
+            [](Vec x, Vec y) { return x + y; },
+            X_ptr,
+            D * HxW);
+        mean_val *= s;
+        rstd_val = std::max(rstd_val * s - mean_val * mean_val, T(0));
+        rstd_val = T(1) / std::sqrt(rstd_val + eps);
+        const int64_t g = i % G;
+        for (int64_t j = 0; j < D; ++j) {
+          const int64_t c = g * D + j;
+          const T scale = rstd_val * (gamma_null ? T(1) : gamma_data[c]);
+          const T bias = -scale * mean_val + (beta_null ? T(0) : beta_data[c]);
+          vec256::map(
+              [scale, bias](Vec x) { return x * Vec(scale) + Vec(bias); },
+              Y_ptr + j * HxW,
+              X_ptr + j * HxW,
+              HxW);
+        }
+        mean_data[i] = mean_val;
+        rstd_data[i] = rstd_val;
+      }
+    });
+    return;
+  }
+
+  // Channels last: per sample moments first, then the affine transform of
+  // every pixel with per channel scale and bias.
+  std::vector<T> scale(N * C);
+  std::vector<T> bias(N * C);
+  at::parallel_for(0, N, 1, [&](int64_t start, int64_t end) {
+    std::vector<T> sum1(C);
+    std::vector<T> sum2(C);
+    for (int64_t n = start; n < end; ++n) {
+      std::fill(sum1.begin(), sum1.end(), T(0));
+      std::fill(sum2.begin(), sum2.end(), T(0));
+      const T* X_ptr = X_data + n * HxW * C;
+      for (int64_t m = 0; m < HxW; ++m) {
+        ChannelsLastMomentsRow<T>(X_ptr + m * C, C, sum1.data(), sum2.data());
+      }
+      for (int64_t g = 0; g < G; ++g) {
+        T mean_val = 0;
+        T rstd_val = 0;
+        for (int64_t j = 0; j < D; ++j) {
+          mean_val += sum1[g * D + j];
+          rstd_val += sum2[g * D + j];
+        }
+        mean_val *= s;
+        rstd_val = std::max(rstd_val * s - mean_val * mean_val, T(0));
+        rstd_val = T(1) / std::sqrt(rstd_val + eps);
+        for (int64_t j = 0; j < D; ++j) {
+          const int64_t c = g * D + j;
+          const T scale_val = rstd_val * (gamma_null ? T(1) : gamma_data[c]);
+          scale[n * C + c] = scale_val;
+          bias[n * C + c] =
+              -scale_val * mean_val + (beta_null ? T(0) : beta_data[c]);
+        }
+        mean_data[n * G + g] = mean_val;
+        rstd_data[n * G + g] = rstd_val;
+      }
+    }
+  });
+  at::parallel_for(0, N * HxW, 1, [&](int64_t start, int64_t end) {
+    for (int64_t i = start; i < end; ++i) {
+      const int64_t n = i / HxW;
+      ChannelsLastAffineRow<T>(
+          X_data + i * C,
+          scale.data() + n * C,
+          bias.data() + n * C,
+          C,
+          Y_data + i * C);
+    }
+  });
+}
+
+void GroupNormKernelImpl(
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps,
+    Tensor* Y,
+    Tensor* mean,
+    Tensor* rstd) {
+  AT_DISPATCH_FLOATING_TYPES(X.scalar_type(), "GroupNormKernelImpl", [&]() {
+    GroupNormKernelImplInternal<scalar_t>(
+        X,
+        gamma,
+        beta,
+        N,
+        C,
+        HxW,
+        group,
+        static_cast<scalar_t>(eps),
+        Y,
+        mean,
+        rstd);
+  });
+}
+
+// ds[c] += dy[c] * x[c], db[c] += dy[c]
+template <typename T>
+void ChannelsLastInternalGradientsRow(
+    const T* dy,
+    const T* x,
+    int64_t C,
+    T* ds,
+    T* db) {
+  using Vec = vec256::Vec256<T>;
+  int64_t c = 0;
+  for (; c + Vec::size() <= C; c += Vec::size()) {
+    const Vec dy_vec = Vec::loadu(dy + c);
+    (Vec::loadu(ds + c) + dy_vec * Vec::loadu(x + c)).store(ds + c);
+    (Vec::loadu(db + c) + dy_vec).store(db + c);
+  }
+  for (; c < C; ++c) {
+    ds[c] += dy[c] * x[c];
+    db[c] += dy[c];
+  }
+}
+
+// dx[c] = a[c] * dy[c] + b[c] * x[c] + e[c]
+template <typename T>
+void ChannelsLastBackwardRow(
+    const T* dy,
+    const T* x,
+    const T* a,
+    const T* b,
+    const T* e,
+    int64_t C,
+    T* dx) {
+  using Vec = vec256::Vec256<T>;
+  int64_t c = 0;
+  for (; c + Vec::size() <= C; c += Vec::size()) {
+    (Vec::loadu(a + c) * Vec::loadu(dy + c) +
+     Vec::loadu(b + c) * Vec::loadu(x + c) + Vec::loadu(e + c))
+        .store(dx + c);
+  }
+  for (; c < C; ++c) {
+    dx[c] = a[c] * dy[c] + b[c] * x[c] + e[c];
+  }
+}
+
+template <typename T>
+void GroupNormBackwardKernelImplInternal(
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    Tensor* dX,
+    Tensor* dgamma,
+    Tensor* dbeta) {
+  using Vec = vec256::Vec256<T>;
+  DCHECK_EQ(dY.numel(), N * C * HxW);
+  DCHECK_EQ(X.numel(), N * C * HxW);
+  DCHECK_EQ(mean.numel(), N * group);
+  DCHECK_EQ(rstd.numel(), N * group);
+  DCHECK(!gamma.defined() || gamma.numel() == C);
+  const int64_t G = group;
+  const int64_t D = C / G;
+  T* dY_data = dY.data_ptr<T>();
+  T* X_data = X.data_ptr<T>();
+  const T* mean_data = mean.data_ptr<T>();
+  const T* rstd_data = rstd.data_ptr<T>();
+  const T* gamma_data = gamma.defined() ? gamma.data_ptr<T>() : nullptr;
+  T* dX_data = dX->defined() ? dX->data_ptr<T>() : nullptr;
+  T* dgamma_data = dgamma->defined() ? dgamma->data_ptr<T>() : nullptr;
+  T* dbeta_data = dbeta->defined() ? dbeta->data_ptr<T>() : nullptr;
+  const bool gamma_null = gamma_data == nullptr;
+  const bool channels_last = !X.is_contiguous();
+
+  // ds[n, c] = sum(dY * X) and db[n, c] = sum(dY) over the HxW elements of
+  // each channel; everything below only needs these and the moments.
+  std::vector<T> ds(N * C);
+  std::vector<T> db(N * C);
+  if (!channels_last) {
+    at::parallel_for(0, N * C, 1, [&](int64_t start, int64_t end) {
+      for (int64_t i = start; i < end; ++i) {
+        ds[i] = vec256::map2_reduce_all<T>(
+            [](Vec x, Vec y) { return x * y; },
+            [](Vec x, Vec y) { return x + y; },
+            dY_data + i * HxW,
+            X_data + i * HxW,
+            HxW);
+        db[i] = vec256::reduce_all<T>(
+            [](Vec& x, Vec& y) { return x + y; },
+            dY_data + i * HxW,
+            HxW);
+      }
+    });
+  } else {
+    at::parallel_for(0, N, 1, [&](int64_t start, int64_t end) {
+      for (int64_t n = start; n < end; ++n) {
+        T* ds_ptr = ds.data() + n * C;
+        T* db_ptr = db.data() + n * C;
+        std::fill(ds_ptr, ds_ptr + C, T(0));
+        std::fill(db_ptr, db_ptr + C, T(0));
+        for (int64_t m = 0; m < HxW; ++m) {
+          const int64_t offset = (n * HxW + m) * C;
+          ChannelsLastInternalGradientsRow<T>(
+              dY_data + offset, X_data + offset, C, ds_ptr, db_ptr);
+        }
+      }
+    });
+  }
+
+  if (dX_data != nullptr) {
+    // dX = a * dY + b * X + e with a = rstd * gamma per channel and b, e per
+    // group.
+    const T s = T(1) / static_cast<T>(D * HxW);
+    std::vector<T> a(N * C);
+    std::vector<T> b(N * C);
+    std::vector<T> e(N * C);
+    at::parallel_for(0, N * G, 1, [&](int64_t start, int64_t end) {
+      for (int64_t i = start; i < end; ++i) {
+        const int64_t n = i / G;
+        const int64_t g = i % G;
+        T ds_val = 0;
+        T db_val = 0;
+        for (int64_t j = 0; j < D; ++j) {
+          const int64_t c = g * D + j;
+          const T gamma_v = gamma_null ? T(1) : gamma_data[c];
+          ds_val += ds[n * C + c] * gamma_v;
+          db_val += db[n * C + c] * gamma_v;
+        }
+        const T mean_val = mean_data[i];
+        const T rstd_val = rstd_data[i];
+        const T b_val =
+            (db_val * mean_val - ds_val) * rstd_val * rstd_val * rstd_val * s;
+        const T e_val = -b_val * mean_val - db_val * rstd_val * s;
+        for (int64_t j = 0; j < D; ++j) {
+          const int64_t c = g * D + j;
+          a[n * C + c] = rstd_val * (gamma_null ? T(1) : gamma_data[c]);
+          b[n * C + c] = b_val;
+          e[n * C + c] = e_val;
+        }
+      }
+    });
+    if (!channels_last) {
+      at::parallel_for(0, N * C, 1, [&](int64_t start, int64_t end) {
+        for (int64_t i = start; i < end; ++i) {
+          const Vec a_vec(a[i]);
+          const Vec b_vec(b[i]);
+          const Vec e_vec(e[i]);
+          const T* dY_ptr = dY_data + i * HxW;
+          const T* X_ptr = X_data + i * HxW;
+          T* dX_ptr = dX_data + i * HxW;
+          int64_t m = 0;
+          for (; m + Vec::size() <= HxW; m += Vec::size()) {
+            (a_vec * Vec::loadu(dY_ptr + m) + b_vec * Vec::loadu(X_ptr + m) +
+             e_vec)
+                .store(dX_ptr + m);
+          }
+          for (; m < HxW; ++m) {
+            dX_ptr[m] = a[i] * dY_ptr[m] + b[i] * X_ptr[m] + e[i];
+          }
+        }
+      });
+    } else {
+      at::parallel_for(0, N * HxW, 1, [&](int64_t start, int64_t end) {
+        for (int64_t i = start; i < end; ++i) {
+          const int64_t n = i / HxW;
+          ChannelsLastBackwardRow<T>(
+              dY_data + i * C,
+              X_data + i * C,
+              a.data() + n * C,
+              b.data() + n * C,
+              e.data() + n * C,
+              C,
+              dX_data + i * C);
+        }
+      });
+    }
+  }
+
+  if (dgamma_data != nullptr || dbeta_data != nullptr) {
+    at::parallel_for(0, C, 1, [&](int64_t start, int64_t end) {
+      for (int64_t c = start; c < end; ++c) {
+        const int64_t g = c / D;
+        T dgamma_val = 0;
+        T dbeta_val = 0;
+        for (int64_t n = 0; n < N; ++n) {
+          const int64_t i = n * G + g;
+          dgamma_val +=
+              (ds[n * C + c] - db[n * C + c] * mean_data[i]) * rstd_data[i];
+          dbeta_val += db[n * C + c];
+        }
+        if (dgamma_data != nullptr) {
+          dgamma_data[c] = dgamma_val;
+        }
+        if (dbeta_data != nullptr) {
+          dbeta_data[c] = dbeta_val;
+        }
+      }
+    });
+  }
+}
+
+void GroupNormBackwardKernelImpl(
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    Tensor* dX,
+    Tensor* dgamma,
+    Tensor* dbeta) {
+  AT_DISPATCH_FLOATING_TYPES(
+      X.scalar_type(), "GroupNormBackwardKernelImpl", [&]() {
+        GroupNormBackwardKernelImplInternal<scalar_t>(
+            dY, X, mean, rstd, gamma, N, C, HxW, group, dX, dgamma, dbeta);
+      });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(GroupNormKernel, &GroupNormKernelImpl);
+REGISTER_DISPATCH(GroupNormBackwardKernel, &GroupNormBackwardKernelImpl);
+
+} // namespace native
+} // namespace at
@@ -1,6 +1,8 @@
 #include <ATen/native/layer_norm.h>
 
 #include <cmath>
+#include <type_traits>
+#include <vector>
 
 #include <ATen/ATen.h>
 #include <ATen/CPUApplyUtils.h>
@@ -66,6 +68,69 @@ void LayerNormKernelImplInternal(
   });
 }
 
+// BFloat16 rows are widened to fp32 so that the moments and the affine
+// transform are computed in fp32; only Y, mean and rstd are rounded back.
+template <>
+void LayerNormKernelImplInternal<BFloat16>(
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t M,
+    int64_t N,
+    BFloat16 eps,
+    Tensor* Y,
+    Tensor* mean,
+    Tensor* rstd) {
+  using Vec = vec256::Vec256<float>;
+  DCHECK_EQ(X.numel(), M * N);
+  DCHECK(!gamma.defined() || gamma.numel() == N);
+  DCHECK(!beta.defined() || beta.numel() == N);
+  const BFloat16* X_data = X.data_ptr<BFloat16>();
+  BFloat16* Y_data = Y->data_ptr<BFloat16>();
+  BFloat16* mean_data = mean->data_ptr<BFloat16>();
+  BFloat16* rstd_data = rstd->data_ptr<BFloat16>();
+  // gamma and beta default to the identity transform.
+  std::vector<float> gamma_f(N, 1.0f);
+  std::vector<float> beta_f(N, 0.0f);
+  if (gamma.defined()) {
+    vec256::convert(gamma.data_ptr<BFloat16>(), gamma_f.data(), N);
+  }
+  if (beta.defined()) {
+    vec256::convert(beta.data_ptr<BFloat16>(), beta_f.data(), N);
+  }
+  const float* gamma_data = gamma_f.data();
+  const float* beta_data = beta_f.data();
+  const float c = 1.0f / static_cast<float>(N);
+  const float eps_f = static_cast<float>(eps);
+  at::parallel_for(0, M, 1, [&](int64_t start, int64_t end) {
+    std::vector<float> buffer(N);
+    float* X_ptr = buffer.data();
+    for (int64_t i = start; i < end; ++i) {
+      vec256::convert(X_data + i * N, X_ptr, N);
+      float mean_val = vec256::reduce_all<float>(
+          [](Vec& x, Vec& y) { return x + y; },
+          X_ptr,
+          N);
+      float rstd_val = vec256::map_reduce_all<float>(
+          [](Vec x) { return x * x; },
+          [](Vec x, Vec y) { return x + y; },
+          X_ptr,
+          N);
+      mean_val *= c;
+      rstd_val = std::max(rstd_val * c - mean_val * mean_val, 0.0f);
+      rstd_val = 1.0f / std::sqrt(rstd_val + eps_f);
+      const float scale = rstd_val;
+      const float bias = -rstd_val * mean_val;
+      for (int64_t j = 0; j < N; ++j) {
+        X_ptr[j] = (X_ptr[j] * scale + bias) * gamma_data[j] + beta_data[j];
+      }
+      vec256::convert(X_ptr, Y_data + i * N, N);
+      mean_data[i] = mean_val;
+      rstd_data[i] = rstd_val;
+    }
+  });
+}
+
 void LayerNormKernelImpl(
     const Tensor& X,
     const Tensor& gamma,
@@ -76,10 +141,11 @@ void LayerNormKernelImpl(
     Tensor* Y,
     Tensor* mean,
     Tensor* rstd) {
-  AT_DISPATCH_FLOATING_TYPES(X.scalar_type(), "LayerNormKernelImpl", [&]() {
-    LayerNormKernelImplInternal<scalar_t>(
-        X, gamma, beta, M, N, static_cast<scalar_t>(eps), Y, mean, rstd);
-  });
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, X.scalar_type(), "LayerNormKernelImpl", [&]() {
+        LayerNormKernelImplInternal<scalar_t>(
+            X, gamma, beta, M, N, static_cast<scalar_t>(eps), Y, mean, rstd);
+      });
 }
 
 template <typename T>
@@ -94,6 +160,10 @@ void LayerNormBackwardKernelImplInternal(
     Tensor* dX,
     Tensor* dgamma,
     Tensor* dbeta) {
+  // BFloat16 is accumulated in fp32, including dgamma and dbeta, which sum
+  // over all M rows.
+  using T_ACC =
+      typename std::conditional<std::is_same<T, BFloat16>::value, float, T>::type;
   DCHECK_EQ(dY.numel(), M * N);
   DCHECK_EQ(X.numel(), M * N);
   DCHECK_EQ(mean.numel(), M);
@@ -107,48 +177,50 @@ void LayerNormBackwardKernelImplInternal(
       gamma.defined() ? gamma.template data_ptr<T>() : nullptr;
   T* dX_data = dX->defined() ? dX->template data_ptr<T>() : nullptr;
   T* dgamma_data = dgamma->defined() ? dgamma->template data_ptr<T>() : nullptr;
-  if (dgamma_data != nullptr) {
-    std::memset(dgamma_data, 0, N * sizeof(T));
-  }
   T* dbeta_data = dbeta->defined() ? dbeta->template data_ptr<T>() : nullptr;
-  if (dbeta_data != nullptr) {
-    std::memset(dbeta_data, 0, N * sizeof(T));
-  }
-  const T scale = T(1) / static_cast<T>(N);
+  std::vector<T_ACC> dgamma_acc(dgamma_data != nullptr ? N : 0, T_ACC(0));
+  std::vector<T_ACC> dbeta_acc(dbeta_data != nullptr ? N : 0, T_ACC(0));
+  const T_ACC scale = T_ACC(1) / static_cast<T_ACC>(N);
   const bool gamma_null = gamma_data == nullptr;
   for (int64_t i = 0; i < M; ++i) {
     const T* dY_ptr = dY_data + i * N;
     const T* X_ptr = X_data + i * N;
+    const T_ACC mean_val = mean_data[i];
+    const T_ACC a = rstd_data[i];
     if (dX_data != nullptr) {
       T* dX_ptr = dX_data + i * N;
-      T ds = 0;
-      T db = 0;
+      T_ACC ds = 0;
+      T_ACC db = 0;
       for (int64_t j = 0; j < N; ++j) {
-        const T gamma_v = gamma_null ? T(1) : gamma_data[j];
-        ds += dY_ptr[j] * X_ptr[j] * gamma_v;
-        db += dY_ptr[j] * gamma_v;
+        const T_ACC gamma_v = gamma_null ? T_ACC(1) : T_ACC(gamma_data[j]);
+        ds += T_ACC(dY_ptr[j]) * T_ACC(X_ptr[j]) * gamma_v;
+        db += T_ACC(dY_ptr[j]) * gamma_v;
       }
-      const T a = rstd_data[i];
-      const T b = (db * mean_data[i] - ds) * a * a * a * scale;
-      const T c = -b * mean_data[i] - db * a * scale;
+      const T_ACC b = (db * mean_val - ds) * a * a * a * scale;
+      const T_ACC c = -b * mean_val - db * a * scale;
       for (int64_t j = 0; j < N; ++j) {
-        const T gamma_v = gamma_null ? T(1) : gamma_data[j];
-        dX_ptr[j] = a * dY_ptr[j] * gamma_v + b * X_ptr[j] + c;
+        const T_ACC gamma_v = gamma_null ? T_ACC(1) : T_ACC(gamma_data[j]);
+        dX_ptr[j] = a * T_ACC(dY_ptr[j]) * gamma_v + b * T_ACC(X_ptr[j]) + c;
       }
     }
     if (dgamma_data != nullptr) {
-      const T a = rstd_data[i];
-      const T b = -a * mean_data[i];
+      const T_ACC b = -a * mean_val;
       for (int64_t j = 0; j < N; ++j) {
-        dgamma_data[j] += dY_ptr[j] * (a * X_ptr[j] + b);
+        dgamma_acc[j] += T_ACC(dY_ptr[j]) * (a * T_ACC(X_ptr[j]) + b);
       }
     }
     if (dbeta_data != nullptr) {
       for (int64_t j = 0; j < N; ++j) {
-        dbeta_data[j] += dY_ptr[j];
+        dbeta_acc[j] += T_ACC(dY_ptr[j]);
       }
     }
   }
+  for (int64_t j = 0; j < static_cast<int64_t>(dgamma_acc.size()); ++j) {
+    dgamma_data[j] = dgamma_acc[j];
+  }
+  for (int64_t j = 0; j < static_cast<int64_t>(dbeta_acc.size()); ++j) {
+    dbeta_data[j] = dbeta_acc[j];
+  }
 }
 
 void LayerNormBackwardKernelImpl(
@@ -162,8 +234,8 @@ void LayerNormBackwardKernelImpl(
     Tensor* dX,
     Tensor* dgamma,
     Tensor* dbeta) {
-  AT_DISPATCH_FLOATING_TYPES(
-      X.scalar_type(), "LayerNormBackwardKernelImpl", [&]() {
+  AT_DISPATCH_FLOATING_TYPES_AND(
+      at::ScalarType::BFloat16, X.scalar_type(), "LayerNormBackwardKernelImpl", [&]() {
         LayerNormBackwardKernelImplInternal<scalar_t>(
             dY, X, mean, rstd, gamma, M, N, dX, dgamma, dbeta);
       });
@@ -193,6 +193,18 @@ inline int can_vectorize_up_to(array_t pointers) {
   return result;
 }
 
+// Number of elements each thread of the vectorized kernel handles: enough
+// for one 16 byte access of the widest operand of `f`, and at least 4.
+template<typename func_t>
+struct thread_work_size {
+  using traits = function_traits<func_t>;
+  using return_t = typename traits::result_type;
+  using arg_t = detail::arg_type::type<func_t>;
+  static constexpr int widest_vec_size = sizeof(return_t) > sizeof(arg_t) ?
+      memory::max_vec_size<return_t>::value : memory::max_vec_size<arg_t>::value;
+  static constexpr int value = widest_vec_size > 4 ? widest_vec_size : 4;
+};
+
 }  // namespace detail
 
 template<typename func_t, typename array_t, typename policy_t>
@@ -254,6 +266,14 @@ __global__ void elementwise_kernel(int N, func_t f, array_t data) {
   }
 }
 
+template<int vec_size, int nt, int vt, typename func_t, typename array_t>
+static inline void launch_vectorized_kernel(dim3 grid, dim3 block, cudaStream_t stream, int64_t N, const func_t& f, array_t data) {
+  // Pointers aligned for vec_size scalars are also aligned for any smaller
+  // power of two, so clamping to the per-thread work keeps every case valid.
+  constexpr int vec = vec_size < vt ? vec_size : vt;
+  elementwise_kernel<vec, nt, vt, func_t, array_t><<<grid, block, 0, stream>>>(N, f, data);
+}
+
 // TODO (@zasdfgbnm): this function assume trivial 1d and no dynamic casting
 template<int nt, int vt, typename func_t, typename array_t>
 static void launch_kernel(int64_t N, const func_t& f, array_t data) {
@@ -266,14 +286,20 @@ static void launch_kernel(int64_t N, const func_t& f, array_t data) {
   auto stream = at::cuda::getCurrentCUDAStream();
   int vec_size = detail::can_vectorize_up_to<func_t>(data);
   switch (vec_size) {
+  case 16:
+    launch_vectorized_kernel<16, nt, vt>(grid, block, stream, N, f, data);
+    break;
+  case 8:
+    launch_vectorized_kernel<8, nt, vt>(grid, block, stream, N, f, data);
+    break;
   case 4:
-    elementwise_kernel<4, nt, vt, func_t, array_t><<<grid, block, 0, stream>>>(N, f, data);
+    launch_vectorized_kernel<4, nt, vt>(grid, block, stream, N, f, data);
     break;
   case 2:
-    elementwise_kernel<2, nt, vt, func_t, array_t><<<grid, block, 0, stream>>>(N, f, data);
+    launch_vectorized_kernel<2, nt, vt>(grid, block, stream, N, f, data);
     break;
   case 1:
-    elementwise_kernel<1, nt, vt, func_t, array_t><<<grid, block, 0, stream>>>(N, f, data);
+    launch_vectorized_kernel<1, nt, vt>(grid, block, stream, N, f, data);
     break;
   default:
     TORCH_INTERNAL_ASSERT(false, "Unexpected vectorization size");
@@ -336,7 +362,7 @@ void gpu_kernel_impl(TensorIterator& iter, const func_t& f) {
         c10::cast_and_store<arg0_t>(dtypes[0], out, result);
       });
     } else if (iter.has_contiguous_first_dim()) {
-      modern::launch_kernel<C10_WARP_SIZE * 2, 4>(numel, f, data);
+      modern::launch_kernel<C10_WARP_SIZE * 2, modern::detail::thread_work_size<func_t>::value>(numel, f, data);
     } else {
       legacy::launch_kernel<launch_size_1d, 1>(numel, [=]GPU_LAMBDA(int idx) {
         arg0_t* out = (arg0_t*)(data[0] + strides[0] * idx);
@@ -9,11 +9,84 @@
 #include <ATen/native/cuda/Loops.cuh>
 #include <THC/THC.h>
 
+#include <limits>
+
 namespace at {
 namespace native {
 
 using namespace at::cuda;
 
+// The tiles of transposed copies are staged through shared memory, so that
+// both the reads of the source and the writes of the destination are
+// coalesced. Each block of kTransposeTile x kTransposeBlockRows threads
+// copies one tile of kTransposeTile x kTransposeTile elements.
+constexpr int kTransposeTile = 32;
+constexpr int kTransposeBlockRows = 8;
+
+template <typename scalar_t>
+__global__ void transpose_copy_kernel(const scalar_t* src, scalar_t* dst, TransposeCopy t) {
+  // the padding column avoids bank conflicts on the transposed accesses
+  __shared__ scalar_t tile[kTransposeTile][kTransposeTile + 1];
+  src += blockIdx.z * t.src_batch_stride;
+  dst += blockIdx.z * t.dst_batch_stride;
+  const int64_t row = static_cast<int64_t>(blockIdx.y) * kTransposeTile;
+  const int64_t col = static_cast<int64_t>(blockIdx.x) * kTransposeTile;
+
+  // read along the rows of the source
+  for (int i = threadIdx.y; i < kTransposeTile; i += kTransposeBlockRows) {
+    const int64_t r = row + i;
+    const int64_t c = col + threadIdx.x;
+    if (r < t.rows && c < t.cols) {
+      tile[i][threadIdx.x] = src[r * t.src_ld + c];
+    }
+  }
+  __syncthreads();
+  // write along the columns of the source, the rows of the destination
+  for (int i = threadIdx.y; i < kTransposeTile; i += kTransposeBlockRows) {
+    const int64_t r = row + threadIdx.x;
+    const int64_t c = col + i;
+    if (r < t.rows && c < t.cols) {
+      dst[c * t.dst_ld + r] = tile[threadIdx.x][i];
+    }
+  }
+}
+
+template <typename scalar_t>
+static void launch_transpose_copy(TensorIterator& iter, const TransposeCopy& t, cudaStream_t stream) {
+  const dim3 block(kTransposeTile, kTransposeBlockRows);
+  const dim3 grid(
+      (t.cols + kTransposeTile - 1) / kTransposeTile,
+      (t.rows + kTransposeTile - 1) / kTransposeTile,
+      t.batch);
+  transpose_copy_kernel<scalar_t><<<grid, block, 0, stream>>>(
+      static_cast<const scalar_t*>(iter.data_ptr(1)),
+      static_cast<scalar_t*>(iter.data_ptr(0)),
+      t);
+}
+
+// Copies with a tiled transpose kernel if `iter` is a TransposeCopy that fits
+// in a grid.
+static bool maybe_transpose_copy(TensorIterator& iter, cudaStream_t stream) {
+  auto transpose = as_transpose_copy(iter);
+  if (!transpose) {
+    return false;
+  }
+  const int64_t max_grid_yz = 65535;
+  if ((transpose->rows + kTransposeTile - 1) / kTransposeTile > max_grid_yz ||
+      (transpose->cols + kTransposeTile - 1) / kTransposeTile > std::numeric_limits<int32_t>::max() ||
+      transpose->batch > max_grid_yz) {
+    return false;
+  }
+  // only the bytes are copied
+  switch (iter.element_size(0)) {
+    case 1: launch_transpose_copy<uint8_t>(iter, *transpose, stream); return true;
+    case 2: launch_transpose_copy<uint16_t>(iter, *transpose, stream); return true;
+    case 4: launch_transpose_copy<uint32_t>(iter, *transpose, stream); return true;
+    case 8: launch_transpose_copy<uint64_t>(iter, *transpose, stream); return true;
+  }
+  return false;
+}
+
 // device-to-device copy, does type conversion
 void copy_device_to_device(TensorIterator& iter, bool non_blocking) {
   int64_t numel = iter.numel();
@@ -57,6 +130,8 @@ void copy_device_to_device(TensorIterator& iter, bool non_blocking) {
         numel * iter.element_size(0),
         cudaMemcpyDeviceToDevice,
         copy_stream));
+  } else if (maybe_transpose_copy(iter, copy_stream)) {
+    // copied by the tiled transpose kernel
   } else {
     AT_DISPATCH_ALL_TYPES_AND3(kHalf, kBool, kBFloat16, iter.dtype(0), "copy_", [&] {
       gpu_kernel(iter, []GPU_LAMBDA(scalar_t x) { return x; });
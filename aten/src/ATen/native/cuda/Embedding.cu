@@ -221,6 +221,32 @@ __global__ void renorm_kernel(
   }
 }
 
+// Sorts the inputs into sorted with the corresponding indices; we
+// don't need a stable or multidimensional sort, so just use Thrust
+// directly
+std::tuple<Tensor, Tensor> sort_embedding_indices(const Tensor & indices) {
+  using device_ptr = thrust::device_ptr<int64_t>;
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
+  auto policy = thrust::cuda::par(allocator).on(stream);
+  auto num_indices = indices.numel();
+
+  auto sorted_indices = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  auto orig_indices = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  sorted_indices.copy_(indices);
+
+  // Fill sortedOrigIndices with sequential indices
+  auto count_iter = thrust::counting_iterator<int64_t>(0);
+  auto orig_data = device_ptr(orig_indices.data_ptr<int64_t>());
+  thrust::copy(policy, count_iter, count_iter + num_indices, orig_data);
+
+  // Sort; a stable sort is not required
+  auto sorted_data = device_ptr(sorted_indices.data_ptr<int64_t>());
+  thrust::sort_by_key(policy, sorted_data, sorted_data + num_indices, orig_data,
+                      ThrustLTOp<int64_t>());
+  return std::make_tuple(sorted_indices, orig_indices);
+}
+
 } // anonymous namespace
 
 Tensor embedding_dense_backward_cuda(const Tensor & grad_, const Tensor & indices,
@@ -265,30 +291,10 @@ Tensor embedding_dense_backward_cuda(const Tensor & grad_, const Tensor & indice
     return grad_weight;
   }
 
-  auto sorted_indices = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
-  auto orig_indices = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor sorted_indices, orig_indices;
+  std::tie(sorted_indices, orig_indices) = sort_embedding_indices(indices);
   using device_ptr = thrust::device_ptr<int64_t>;
 
-  // Sort the inputs into sorted with the corresponding indices; we
-  // don't need a stable or multidimensional sort, so just use Thrust
-  // directly
-  {
-    sorted_indices.copy_(indices);
-
-    auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
-    auto policy = thrust::cuda::par(allocator).on(stream);
-
-    // Fill sortedOrigIndices with sequential indices
-    auto count_iter = thrust::counting_iterator<int64_t>(0);
-    auto orig_data = device_ptr(orig_indices.data_ptr<int64_t>());
-    thrust::copy(policy, count_iter, count_iter + num_indices, orig_data);
-
-    // Sort; a stable sort is not required
-    auto sorted_data = device_ptr(sorted_indices.data_ptr<int64_t>());
-    thrust::sort_by_key(policy, sorted_data, sorted_data + num_indices, orig_data,
-                        ThrustLTOp<int64_t>());
-  }
-
   Tensor count;
   if (scale_grad_by_freq) {
     count = at::empty_like(indices, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
@@ -327,6 +333,53 @@ Tensor embedding_dense_backward_cuda(const Tensor & grad_, const Tensor & indice
       sorted_indices, count, num_weights, padding_idx);
 }
 
+// Unlike the generic embedding_sparse_backward, which hands back one value row
+// per index and leaves the duplicates to coalesce(), this sums every unique
+// index into a single row with the segment reduction of the dense backward and
+// marks the result coalesced. The dense [num_weights, D] gradient is never
+// materialized, which is what makes sparse gradients worthwhile for very
+// large tables.
+Tensor embedding_sparse_backward_cuda(
+    const Tensor & grad_, const Tensor & indices_, int64_t num_weights,
+    int64_t padding_idx, bool scale_grad_by_freq) {
+  auto grad_arg = TensorArg(grad_, "grad", 1);
+  auto indices_arg = TensorArg(indices_, "indices", 2);
+  checkScalarType("embedding_backward", indices_arg, kLong);
+  checkSameGPU("embedding_backward", grad_arg, indices_arg);
+
+  // TODO: implement scale_grad_by_freq
+  if (scale_grad_by_freq) {
+    AT_ERROR(
+        "embedding_backward: scale_grad_by_freq not supported with sparse gradients");
+  }
+
+  int64_t num_features = grad_.size(-1);
+  auto weight_size = std::array<int64_t, 2>{{ num_weights, num_features }};
+  Tensor indices = indices_.reshape(-1);
+  Tensor grad = grad_.reshape({-1, num_features});
+  if (padding_idx != -1) {
+    auto c = indices != padding_idx;
+    indices = indices.index(c);
+    grad = grad.index(c);
+  }
+
+  // check if all our grad come from padding_idx
+  if (indices.numel() == 0) {
+    return at::_sparse_coo_tensor_unsafe(at::empty({1, 0}, indices_.options()),
+                                         at::empty({0, num_features}, grad.options()),
+                                         weight_size);
+  }
+
+  Tensor sorted_indices, orig_indices;
+  std::tie(sorted_indices, orig_indices) = sort_embedding_indices(indices.contiguous());
+
+  Tensor rows, values;
+  std::tie(rows, values) = embedding_backward_cuda_kernel_unique_rows(
+      grad.contiguous(), orig_indices, sorted_indices);
+  return at::_sparse_coo_tensor_unsafe(rows.view({1, -1}), values, weight_size)
+      ._coalesced_(true);
+}
+
 Tensor & embedding_renorm_cuda_(Tensor & self, const Tensor & indices,
                                 double max_norm, double norm_type) {
   auto self_arg = TensorArg(self, "self", 1);
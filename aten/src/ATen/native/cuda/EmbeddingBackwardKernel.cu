@@ -148,6 +148,8 @@ __global__ void compute_grad_weight(
 }
 
 // This kernel assumes that all input tensors are contiguous.
+// With `compact`, segment `id` is written to row `id` of `gradWeight` instead
+// of the row it belongs to, and `padding_idx` is ignored.
 template <typename scalar_t>
 __global__ void sum_and_scatter(
     int64_t *input, scalar_t *gradWeight, int64_t stride,
@@ -155,7 +157,8 @@ __global__ void sum_and_scatter(
     const acc_type<scalar_t, true> *grad_weight_per_segment,
     const int64_t *segment_sizes_offsets, int64_t num_of_partial_segments,
     const int64_t padding_idx,
-    const int64_t stride_warped) {
+    const int64_t stride_warped,
+    const bool compact) {
 
   const int gid = blockIdx.x * blockDim.x + threadIdx.x;
   const int id = gid / stride_warped;
@@ -173,40 +176,47 @@ __global__ void sum_and_scatter(
   for (int idx=idx_begin; idx < idx_end; ++idx) {
     weight += grad_weight_per_segment[idx*stride + startFeature];
   }
+  if (compact) {
+    gradWeight[id * stride + startFeature] = weight;
+    return;
+  }
   int64_t target_row = input[segment_offsets[id]];
   if (target_row != padding_idx) {
     gradWeight[target_row * stride + startFeature] = weight;
   }
 }
 
-} // anon namespace
-
-Tensor embedding_backward_cuda_kernel(
+// Sums the gradient of every segment (run of equal `sorted_indices`). Without
+// `compact` the sums are scattered into a dense [num_weights, D] gradient;
+// with it they are returned as [num_of_segments, D] rows, one per unique
+// index in sorted order, and `segment_offsets` gives where each segment
+// starts in `sorted_indices`.
+Tensor embedding_backward_cuda_kernel_impl(
         const Tensor &grad,
         const Tensor &orig_indices,
         const Tensor &sorted_indices,
         const Tensor &count,
         int64_t num_weights,
         int padding_idx,
-        bool scale_grad_by_freq,
         bool mode_mean,
         const Tensor &offset2bag,
         const Tensor &bag_size,
-        const Tensor &per_sample_weights) {
+        const Tensor &per_sample_weights,
+        bool compact,
+        Tensor &segment_offsets) {
 
   auto stream = at::cuda::getCurrentCUDAStream();
   auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
   auto policy = thrust::cuda::par(allocator).on(stream);
   const ptrdiff_t numel = sorted_indices.numel();
 
-  auto grad_weight = at::zeros({num_weights, grad.size(-1)}, grad.options());
-  const int64_t stride = grad_weight.stride(0);
+  const int64_t stride = grad.size(-1);
 
   // Compute the number of segments and their start position so that we do not have to
   // spawn a warp per index. In this context, a segment is a number of rows that should
   // be summarized.
   // Unit: index in `sorted_indices` and `orig_indices`
-  auto segment_offsets = at::empty({numel}, orig_indices.options());
+  segment_offsets = at::empty({numel}, orig_indices.options());
   int64_t num_of_segments;
   {
     auto sorted_indices_dev = thrust::device_ptr<int64_t>(sorted_indices.data_ptr<int64_t>());
@@ -221,6 +231,13 @@ Tensor embedding_backward_cuda_kernel(
             thrust::device_ptr<int64_t>(segment_offsets.data_ptr<int64_t>()));
     num_of_segments = thrust::get<0>(ends) - dummy_dev;
   }
+  segment_offsets = segment_offsets.narrow(0, 0, num_of_segments);
+
+  // Every row is written by `sum_and_scatter` in compact mode, so only the
+  // dense gradient needs to be zeroed.
+  auto grad_weight = compact
+      ? at::empty({num_of_segments, stride}, grad.options())
+      : at::zeros({num_weights, stride}, grad.options());
 
   // We split the segments up into sizes of `NROWS_PER_THREAD`
   // Compute the number partial-segments per segment (some partial-segments 
@@ -314,11 +331,47 @@ Tensor embedding_backward_cuda_kernel(
             num_of_segments, grad_weight_per_segment.data_ptr<partial_weight_t>(),
             partials_per_segment_offset.data_ptr<int64_t>(),
             num_of_partial_segments, 
-            padding_idx, 
-            stride_warped);
+            padding_idx,
+            stride_warped,
+            compact);
       THCudaCheck(cudaGetLastError());
   });
   return grad_weight;
 }
 
+} // anon namespace
+
+Tensor embedding_backward_cuda_kernel(
+        const Tensor &grad,
+        const Tensor &orig_indices,
+        const Tensor &sorted_indices,
+        const Tensor &count,
+        int64_t num_weights,
+        int padding_idx,
+        bool scale_grad_by_freq,
+        bool mode_mean,
+        const Tensor &offset2bag,
+        const Tensor &bag_size,
+        const Tensor &per_sample_weights) {
+  Tensor segment_offsets;
+  return embedding_backward_cuda_kernel_impl(
+      grad, orig_indices, sorted_indices, count, num_weights, padding_idx,
+      mode_mean, offset2bag, bag_size, per_sample_weights,
+      /*compact=*/false, segment_offsets);
+}
+
+std::tuple<Tensor, Tensor> embedding_backward_cuda_kernel_unique_rows(
+        const Tensor &grad,
+        const Tensor &orig_indices,
+        const Tensor &sorted_indices) {
+  Tensor segment_offsets;
+  auto values = embedding_backward_cuda_kernel_impl(
+      grad, orig_indices, sorted_indices, /*count=*/Tensor(),
+      /*num_weights=*/0, /*padding_idx=*/-1, /*mode_mean=*/false,
+      /*offset2bag=*/Tensor(), /*bag_size=*/Tensor(),
+      /*per_sample_weights=*/Tensor(), /*compact=*/true, segment_offsets);
+  auto rows = sorted_indices.index_select(0, segment_offsets);
+  return std::make_tuple(rows, values);
+}
+
 }}
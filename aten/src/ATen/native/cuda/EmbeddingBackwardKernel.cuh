@@ -33,4 +33,13 @@ Tensor embedding_backward_cuda_kernel(
     const Tensor &bag_size = Tensor(),
     const Tensor &per_sample_weights = Tensor());
 
+// Like embedding_backward_cuda_kernel without bags or scaling, but returns the
+// unique indices in ascending order and the summed gradient row of each,
+// i.e. the indices and values of a coalesced sparse gradient. Requires a
+// non-empty `sorted_indices`.
+std::tuple<Tensor, Tensor> embedding_backward_cuda_kernel_unique_rows(
+    const Tensor &grad,
+    const Tensor &orig_indices,
+    const Tensor &sorted_indices);
+
 }}
\ No newline at end of file
@@ -0,0 +1,260 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/FusedOptimizers.h>
+#include <ATen/native/cuda/MultiTensorApply.cuh>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <cmath>
+#include <type_traits>
+
+namespace at { namespace native {
+
+namespace {
+
+template <typename scalar_t>
+struct SGDFunctor {
+  using accscalar_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  __device__ void operator()(
+      void** addresses,
+      int64_t offset,
+      int64_t size,
+      accscalar_t lr,
+      accscalar_t weight_decay) const {
+    auto param = static_cast<scalar_t*>(addresses[0]) + offset;
+    auto grad = static_cast<const scalar_t*>(addresses[1]) + offset;
+    for (int64_t i = threadIdx.x; i < size; i += blockDim.x) {
+      const accscalar_t p = param[i];
+      param[i] = p - lr * (static_cast<accscalar_t>(grad[i]) + weight_decay * p);
+    }
+  }
+};
+
+template <typename scalar_t>
+struct SGDMomentumFunctor {
+  using accscalar_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  __device__ void operator()(
+      void** addresses,
+      int64_t offset,
+      int64_t size,
+      accscalar_t lr,
+      accscalar_t momentum,
+      accscalar_t dampening,
+      accscalar_t weight_decay,
+      bool nesterov) const {
+    auto param = static_cast<scalar_t*>(addresses[0]) + offset;
+    auto grad = static_cast<const scalar_t*>(addresses[1]) + offset;
+    auto buffer = static_cast<scalar_t*>(addresses[2]) + offset;
+    for (int64_t i = threadIdx.x; i < size; i += blockDim.x) {
+      const accscalar_t p = param[i];
+      const accscalar_t update =
+          static_cast<accscalar_t>(grad[i]) + weight_decay * p;
+      const accscalar_t buf =
+          momentum * static_cast<accscalar_t>(buffer[i]) +
+          (1 - dampening) * update;
+      buffer[i] = buf;
+      param[i] = p - lr * (nesterov ? update + momentum * buf : buf);
+    }
+  }
+};
+
+template <typename scalar_t>
+struct AdamFunctor {
+  using accscalar_t = acc_type<scalar_t, /*is_cuda=*/true>;
+
+  __device__ void operator()(
+      void** addresses,
+      int64_t offset,
+      int64_t size,
+      accscalar_t step_size,
+      accscalar_t bias_correction2,
+      accscalar_t beta1,
+      accscalar_t beta2,
+      accscalar_t eps,
+      accscalar_t weight_decay,
+      bool amsgrad) const {
+    auto param = static_cast<scalar_t*>(addresses[0]) + offset;
+    auto grad = static_cast<const scalar_t*>(addresses[1]) + offset;
+    auto exp_avg = static_cast<scalar_t*>(addresses[2]) + offset;
+    auto exp_avg_sq = static_cast<scalar_t*>(addresses[3]) + offset;
+    // Only valid with amsgrad, the lists have depth 5 then.
+    auto max_exp_avg_sq = amsgrad
+        ? static_cast<scalar_t*>(addresses[4]) + offset
+        : nullptr;
+    for (int64_t i = threadIdx.x; i < size; i += blockDim.x) {
+      const accscalar_t p = param[i];
+      const accscalar_t g = static_cast<accscalar_t>(grad[i]) + weight_decay * p;
+      const accscalar_t m =
+          beta1 * static_cast<accscalar_t>(exp_avg[i]) + (1 - beta1) * g;
+      accscalar_t v =
+          beta2 * static_cast<accscalar_t>(exp_avg_sq[i]) + (1 - beta2) * g * g;
+      exp_avg[i] = m;
+      exp_avg_sq[i] = v;
+      if (amsgrad) {
+        v = ::max(static_cast<accscalar_t>(max_exp_avg_sq[i]), v);
+        max_exp_avg_sq[i] = v;
+      }
+      param[i] = p - step_size * m / (::sqrt(v / bias_correction2) + eps);
+    }
+  }
+};
+
+// Splits the tensors of ``lists`` into the ones the kernels can update, which
+// are returned, and the others, which are passed to ``reference(index)``.
+template <typename reference_t>
+std::vector<std::vector<Tensor>> select_fused_tensors(
+    const std::vector<TensorList>& lists,
+    const reference_t& reference) {
+  std::vector<std::vector<Tensor>> fused(lists.size());
+  const auto& like = lists[0][0];
+  const bool supported_dtype = like.scalar_type() == kFloat ||
+      like.scalar_type() == kDouble || like.scalar_type() == kHalf;
+  for (size_t i = 0; i < lists[0].size(); i++) {
+    if (!supported_dtype || !can_use_fused_optimizer_kernel(lists, i, like)) {
+      reference(i);
+      continue;
+    }
+    for (size_t d = 0; d < lists.size(); d++) {
+      fused[d].push_back(lists[d][i]);
+    }
+  }
+  return fused;
+}
+
+} // namespace
+
+void _fused_sgd_cuda_(
+    TensorList self,
+    TensorList grads,
+    TensorList momentum_buffers,
+    double lr,
+    double momentum,
+    double dampening,
+    double weight_decay,
+    bool nesterov) {
+  check_fused_optimizer_list("_fused_sgd_", self, grads, "grads");
+  std::vector<TensorList> lists = {self, grads};
+  if (momentum != 0) {
+    check_fused_optimizer_list(
+        "_fused_sgd_", self, momentum_buffers, "momentum_buffers");
+    lists.push_back(momentum_buffers);
+  }
+  if (self.empty()) {
+    return;
+  }
+
+  auto fused = select_fused_tensors(lists, [&](size_t index) {
+    sgd_step_reference(
+        self[index],
+        grads[index],
+        momentum != 0 ? momentum_buffers[index] : Tensor(),
+        lr,
+        momentum,
+        dampening,
+        weight_decay,
+        nesterov);
+  });
+  if (fused[0].empty()) {
+    return;
+  }
+
+  const cuda::CUDAGuard device_guard(fused[0][0].device());
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+      fused[0][0].scalar_type(), "_fused_sgd_cuda_", [&] {
+        using accscalar_t = acc_type<scalar_t, /*is_cuda=*/true>;
+        if (momentum == 0) {
+          multi_tensor_apply<2>(
+              fused,
+              SGDFunctor<scalar_t>(),
+              static_cast<accscalar_t>(lr),
+              static_cast<accscalar_t>(weight_decay));
+        } else {
+          multi_tensor_apply<3>(
+              fused,
+              SGDMomentumFunctor<scalar_t>(),
+              static_cast<accscalar_t>(lr),
+              static_cast<accscalar_t>(momentum),
+              static_cast<accscalar_t>(dampening),
+              static_cast<accscalar_t>(weight_decay),
+              nesterov);
+        }
+      });
+}
+
+void _fused_adam_cuda_(
+    TensorList self,
+    TensorList grads,
+    TensorList exp_avgs,
+    TensorList exp_avg_sqs,
+    TensorList max_exp_avg_sqs,
+    int64_t step,
+    double lr,
+    double beta1,
+    double beta2,
+    double eps,
+    double weight_decay,
+    bool amsgrad) {
+  check_fused_optimizer_list("_fused_adam_", self, grads, "grads");
+  check_fused_optimizer_list("_fused_adam_", self, exp_avgs, "exp_avgs");
+  check_fused_optimizer_list("_fused_adam_", self, exp_avg_sqs, "exp_avg_sqs");
+  std::vector<TensorList> lists = {self, grads, exp_avgs, exp_avg_sqs};
+  if (amsgrad) {
+    check_fused_optimizer_list(
+        "_fused_adam_", self, max_exp_avg_sqs, "max_exp_avg_sqs");
+    lists.push_back(max_exp_avg_sqs);
+  }
+  TORCH_CHECK(step > 0, "_fused_adam_: expected a positive step, got ", step);
+  if (self.empty()) {
+    return;
+  }
+  const double bias_correction1 = 1 - std::pow(beta1, step);
+  const double bias_correction2 = 1 - std::pow(beta2, step);
+  const double step_size = lr / bias_correction1;
+
+  auto fused = select_fused_tensors(lists, [&](size_t index) {
+    adam_step_reference(
+        self[index],
+        grads[index],
+        exp_avgs[index],
+        exp_avg_sqs[index],
+        amsgrad ? max_exp_avg_sqs[index] : Tensor(),
+        step_size,
+        bias_correction2,
+        beta1,
+        beta2,
+        eps,
+        weight_decay,
+        amsgrad);
+  });
+  if (fused[0].empty()) {
+    return;
+  }
+
+  const cuda::CUDAGuard device_guard(fused[0][0].device());
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+      fused[0][0].scalar_type(), "_fused_adam_cuda_", [&] {
+        using accscalar_t = acc_type<scalar_t, /*is_cuda=*/true>;
+        auto apply = [&](auto depth) {
+          multi_tensor_apply<decltype(depth)::value>(
+              fused,
+              AdamFunctor<scalar_t>(),
+              static_cast<accscalar_t>(step_size),
+              static_cast<accscalar_t>(bias_correction2),
+              static_cast<accscalar_t>(beta1),
+              static_cast<accscalar_t>(beta2),
+              static_cast<accscalar_t>(eps),
+              static_cast<accscalar_t>(weight_decay),
+              amsgrad);
+        };
+        if (amsgrad) {
+          apply(std::integral_constant<int, 5>());
+        } else {
+          apply(std::integral_constant<int, 4>());
+        }
+      });
+}
+
+}} // namespace at::native
@@ -7,6 +7,7 @@
 #include <ATen/native/TensorIterator.h>
 #include <ATen/AccumulateType.h>
 
+#include <THC/THCAtomics.cuh>
 #include <THC/THCDeviceUtils.cuh>
 #include <THC/THCGeneral.h>
 #include <THC/THCTensorSort.cuh>
@@ -86,6 +87,27 @@ __global__ void indexing_backward_kernel(
   }
 }
 
+// Same layout as indexing_backward_kernel, but without the sorted indices:
+// every index gets its own warp and duplicates are resolved with atomic adds,
+// so the order in which they are summed is not deterministic.
+template <typename scalar_t>
+__global__ void indexing_backward_atomic_kernel(
+  int64_t* indices, scalar_t* grad_output, scalar_t* grad_weight,
+  int64_t numel, int64_t stride, int64_t stride_before, int64_t outer_dim) {
+  for (int z = blockIdx.z; z < outer_dim; z += gridDim.z){
+    int idx = blockIdx.x * blockDim.y + threadIdx.y;
+    if (idx < numel) {
+      const int weight_row = ((int) indices[idx]) * stride + z * stride_before;
+      const int grad_row = idx * stride + z * numel * stride;
+      for (int feature_dim = threadIdx.x + blockIdx.y * blockDim.x;
+           feature_dim < stride;
+           feature_dim += gridDim.y * blockDim.x) {
+        gpuAtomicAdd(&grad_weight[weight_row + feature_dim], grad_output[grad_row + feature_dim]);
+      }
+    }
+  }
+}
+
 
 }    
 
@@ -191,12 +213,43 @@ void index_put_accum_kernel(Tensor & self, TensorList indices, const Tensor & va
       const bool permuted = !src.is_contiguous();
       auto src_ = permuted ? src.contiguous() : src;
       linearIndex = linearIndex.view(-1);
+      const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+      linearIndex.div_(sliceSize);
+      TORCH_INTERNAL_ASSERT(linearIndex.numel()*sliceSize*nElemBefore == value.numel(), "number of flattened indices did not match number of elements in the value tensor", linearIndex.numel()*sliceSize*nElemBefore, value.numel());
+      TORCH_CHECK(self.numel() < std::numeric_limits<int>::max(), "index_put_ with accumulation is not supported on large tensors, number of source elements =", self.numel(), "file a support request on github");
+      TORCH_CHECK(value.numel() < std::numeric_limits<int>::max(), "index_put_ with accumulation is not supported on large tensors, number of source elements =", value.numel(), "file a support request on github");
+
+      // Sorting the indices is what makes the accumulation deterministic, and
+      // it usually costs more than the accumulation itself. Floating types
+      // with fast atomic adds skip it unless determinism was requested.
+      const auto scalar_type = value_.scalar_type();
+      if (!globalContext().deterministic() &&
+          (scalar_type == at::ScalarType::Float || scalar_type == at::ScalarType::Half)) {
+        const int indices_per_block = 4;
+        dim3 grid(THCCeilDiv(num_indices, (int64_t) indices_per_block),
+             std::min<int>(at::cuda::getCurrentDeviceProperties()->maxGridSize[1], THCCeilDiv(sliceSize, (int64_t) C10_WARP_SIZE)),
+             std::min(std::max<int>(1,nElemBefore), at::cuda::getCurrentDeviceProperties()->maxGridSize[2]));
+        dim3 block(C10_WARP_SIZE, indices_per_block);
+
+        AT_DISPATCH_FLOATING_TYPES_AND_HALF(scalar_type, "indexing_backward_atomic", [&] {
+        indexing_backward_atomic_kernel<scalar_t><<<grid, block, 0, stream>>>(
+          linearIndex.data_ptr<int64_t>(),
+          value_.data_ptr<scalar_t>(),
+          src_.data_ptr<scalar_t>(),
+          num_indices,
+          sliceSize,
+          strideBefore,
+          nElemBefore);
+        });
+        THCudaCheck(cudaGetLastError());
+        if (permuted)
+            self.copy_(src_.permute(inversePerm));
+        return;
+      }
+
       auto sorted_indices = at::empty_like(linearIndex, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
       auto orig_indices = at::empty_like(linearIndex, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
       using device_ptr = thrust::device_ptr<int64_t>;
-      const cudaStream_t stream = at::cuda::getCurrentCUDAStream();
-    
-      linearIndex.div_(sliceSize);
       {
       sorted_indices.copy_(linearIndex);
       auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
@@ -215,9 +268,6 @@ void index_put_accum_kernel(Tensor & self, TensorList indices, const Tensor & va
       auto sorted_data = device_ptr(sorted_indices.data_ptr<int64_t>());
       thrust::sort_by_key(policy, sorted_data, sorted_data + num_indices, orig_data, ThrustLTOp<int64_t>());
       }
-      TORCH_INTERNAL_ASSERT(linearIndex.numel()*sliceSize*nElemBefore == value.numel(), "number of flattened indices did not match number of elements in the value tensor", linearIndex.numel()*sliceSize*nElemBefore, value.numel());
-      TORCH_CHECK(self.numel() < std::numeric_limits<int>::max(), "index_put_ with accumulation is not supported on large tensors, number of source elements =", self.numel(), "file a support request on github");
-      TORCH_CHECK(value.numel() < std::numeric_limits<int>::max(), "index_put_ with accumulation is not supported on large tensors, number of source elements =", value.numel(), "file a support request on github");
       const int UNROLL = 4;
       const int indices_per_block = 4;
       dim3 grid(THCCeilDiv(num_indices, (int64_t) indices_per_block),
@@ -64,7 +64,7 @@ struct policies {
   // has its job to do. So the reminders should be handled by the the caller
   // manually.
 
-  template <int vec_size>  // vec_size: number of scalars, can be 1, 2, or 4.
+  template <int vec_size>  // vec_size: number of scalars, a power of two up to max_vec_size.
   struct vectorized : public common {
 
     static_assert(thread_work_size_ % vec_size == 0, "The workload per thread must be a multiple of vec_size");
@@ -95,6 +95,7 @@ struct policies {
       for (int i = 0; i < loop_size; i++) {
         int index = thread_idx + i * num_threads_;
         vec_t v;
+        #pragma unroll
         for (int j = 0; j < vec_size; j++) {
           v.val[j] = from(vec_size * i + j);
         }
@@ -104,17 +105,21 @@ struct policies {
   };
 };
 
+// Number of scalars in the widest access a thread can issue, which is 16
+// bytes: 4 floats, 8 halfs or bfloat16s, 16 bytes or bools.
+template<typename scalar_t>
+struct max_vec_size {
+  static constexpr int value = sizeof(scalar_t) >= 16 ? 1 : 16 / sizeof(scalar_t);
+};
+
 template<typename scalar_t>
 inline int can_vectorize_up_to(char *pointer) {
   uint64_t address = reinterpret_cast<uint64_t>(pointer);
-  constexpr int vec2_alignment = std::alignment_of<aligned_vector<scalar_t, 2>>::value;
-  constexpr int vec4_alignment = std::alignment_of<aligned_vector<scalar_t, 4>>::value;
-  if (address % vec4_alignment == 0) {
-    return 4;
-  } else if (address % vec2_alignment == 0) {
-    return 2;
+  int vec_size = max_vec_size<scalar_t>::value;
+  while (vec_size > 1 && address % (sizeof(scalar_t) * vec_size) != 0) {
+    vec_size /= 2;
   }
-  return 1;
+  return vec_size;
 }
 
 }}} // namespace at::native::memory
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/macros/Macros.h>
+
+#include <vector>
+
+// Applies an elementwise functor to lists of tensors with as few kernel
+// launches as possible. The tensors are split into chunks of
+// kMultiTensorChunkSize elements, and every block of a launch processes one
+// chunk. The addresses and sizes of the tensors are passed as kernel
+// arguments, which are limited to 4KB, so a launch covers at most
+// kMaxTensors tensors and kMaxBlocks chunks.
+
+namespace at { namespace native {
+
+namespace {
+
+constexpr int kMultiTensorChunkSize = 65536;
+constexpr int kMultiTensorBlockSize = 512;
+
+// Indexed by the depth (the number of tensor lists) minus one.
+constexpr int kMaxTensors[5] = {110, 64, 48, 36, 30};
+constexpr int kMaxBlocks[5] = {320, 320, 320, 320, 320};
+
+template <int depth>
+struct TensorListMetadata {
+  void* addresses[depth][kMaxTensors[depth - 1]];
+  int64_t sizes[kMaxTensors[depth - 1]];
+  unsigned char block_to_tensor[kMaxBlocks[depth - 1]];
+  int block_to_chunk[kMaxBlocks[depth - 1]];
+};
+
+template <int depth, typename functor_t, typename... args_t>
+C10_LAUNCH_BOUNDS_1(kMultiTensorBlockSize)
+__global__ void multi_tensor_apply_kernel(
+    TensorListMetadata<depth> metadata,
+    functor_t functor,
+    args_t... args) {
+  const int tensor = metadata.block_to_tensor[blockIdx.x];
+  const int chunk = metadata.block_to_chunk[blockIdx.x];
+  const int64_t offset = static_cast<int64_t>(chunk) * kMultiTensorChunkSize;
+  const int64_t size = metadata.sizes[tensor] - offset < kMultiTensorChunkSize
+      ? metadata.sizes[tensor] - offset
+      : kMultiTensorChunkSize;
+  void* addresses[depth];
+  #pragma unroll
+  for (int d = 0; d < depth; d++) {
+    addresses[d] = metadata.addresses[d][tensor];
+  }
+  functor(addresses, offset, size, args...);
+}
+
+// Calls ``functor(addresses, offset, size, args...)`` on the device for every
+// chunk of the tensors in ``lists``, where ``addresses[d]`` is the data of the
+// tensor in ``lists[d]``. The element ``i`` of the chunk is at ``offset + i``
+// for ``i < size``. All tensors must be non-empty, contiguous and on the
+// current device, and the tensors at the same index of the lists must have
+// the same number of elements.
+template <int depth, typename functor_t, typename... args_t>
+void multi_tensor_apply(
+    const std::vector<std::vector<Tensor>>& lists,
+    functor_t functor,
+    args_t... args) {
+  TORCH_INTERNAL_ASSERT(lists.size() == depth);
+  auto stream = at::cuda::getCurrentCUDAStream();
+
+  TensorListMetadata<depth> metadata;
+  int num_tensors = 0;
+  int num_blocks = 0;
+  for (size_t t = 0; t < lists[0].size(); t++) {
+    const auto numel = lists[0][t].numel();
+    metadata.sizes[num_tensors] = numel;
+    for (int d = 0; d < depth; d++) {
+      metadata.addresses[d][num_tensors] = lists[d][t].data_ptr();
+    }
+    num_tensors++;
+
+    const int num_chunks =
+        (numel + kMultiTensorChunkSize - 1) / kMultiTensorChunkSize;
+    for (int chunk = 0; chunk < num_chunks; chunk++) {
+      metadata.block_to_tensor[num_blocks] = num_tensors - 1;
+      metadata.block_to_chunk[num_blocks] = chunk;
+      num_blocks++;
+
+      const bool last_chunk = chunk == num_chunks - 1;
+      if (num_blocks < kMaxBlocks[depth - 1] &&
+          !(last_chunk && num_tensors == kMaxTensors[depth - 1])) {
+        continue;
+      }
+      multi_tensor_apply_kernel<<<
+          num_blocks,
+          kMultiTensorBlockSize,
+          0,
+          stream>>>(metadata, functor, args...);
+      AT_CUDA_CHECK(cudaGetLastError());
+      num_blocks = 0;
+      if (last_chunk) {
+        num_tensors = 0;
+      } else {
+        // The remaining chunks of this tensor go into the next launch.
+        metadata.sizes[0] = metadata.sizes[num_tensors - 1];
+        for (int d = 0; d < depth; d++) {
+          metadata.addresses[d][0] = metadata.addresses[d][num_tensors - 1];
+        }
+        num_tensors = 1;
+      }
+    }
+  }
+  if (num_blocks > 0) {
+    multi_tensor_apply_kernel<<<
+        num_blocks,
+        kMultiTensorBlockSize,
+        0,
+        stream>>>(metadata, functor, args...);
+    AT_CUDA_CHECK(cudaGetLastError());
+  }
+}
+
+} // namespace
+
+}} // namespace at::native
@@ -198,6 +198,25 @@ void argmin_kernel_cuda_impl(TensorIterator& iter) {
     thrust::pair<acc_t, int64_t>(at::numeric_limits<acc_t>::upper_bound(), 0));
 };
 
+template <typename scalar_t, typename acc_t=scalar_t>
+void aminmax_kernel_cuda_impl(TensorIterator& iter) {
+  gpu_reduce_kernel<scalar_t, scalar_t>(
+    iter,
+    MinMaxOps<scalar_t, acc_t, thrust::tuple<scalar_t, scalar_t>>{},
+    thrust::pair<acc_t, acc_t>(at::numeric_limits<acc_t>::upper_bound(),
+                               at::numeric_limits<acc_t>::lower_bound()));
+}
+
+void aminmax_kernel_cuda(TensorIterator& iter) {
+  if (iter.dtype() == kHalf) {
+    aminmax_kernel_cuda_impl<at::Half, float>(iter);
+  } else {
+    AT_DISPATCH_ALL_TYPES(iter.dtype(), "aminmax_cuda", [&]() {
+      aminmax_kernel_cuda_impl<scalar_t>(iter);
+    });
+  }
+}
+
 void argmax_kernel_cuda(TensorIterator& iter) {
   if (iter.dtype(1) == kHalf) {
     // Instead of implementing is_nan and warp_shfl_down
@@ -233,5 +252,6 @@ REGISTER_DISPATCH(max_values_stub, &max_values_kernel_cuda);
 REGISTER_DISPATCH(min_values_stub, &min_values_kernel_cuda);
 REGISTER_DISPATCH(argmax_stub, &argmax_kernel_cuda);
 REGISTER_DISPATCH(argmin_stub, &argmin_kernel_cuda);
+REGISTER_DISPATCH(aminmax_stub, &aminmax_kernel_cuda);
 
 }} // namespace at::native
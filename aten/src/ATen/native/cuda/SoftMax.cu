@@ -12,6 +12,7 @@
 #include <ATen/cuda/NumericLimits.cuh>
 #include <type_traits>
 
+#include <ATen/native/SoftMax.h>
 #include <ATen/native/cuda/PersistentSoftmax.cuh>
 
 namespace at {
@@ -292,14 +293,6 @@ __global__ void cunn_SpatialSoftMaxBackward(
 ////////////////////////////////////////////////////////////////////////////////
 
 
-template <typename T, typename AccumT>
-struct MaxFloat
-{
-  __device__ __forceinline__ AccumT operator()(AccumT max, T v) const {
-    return ::max(max, (AccumT)v);
-  }
-};
-
 template<typename T, typename AccumT>
 struct AddFloat
 {
@@ -308,17 +301,45 @@ struct AddFloat
   }
 };
 
-template<typename T, typename AccumT>
-struct SumExpFloat
-{
-  __device__ __forceinline__ SumExpFloat(AccumT v)
-    : max_k(v) {}
+// Running maximum and sum of exp(x - max_input) over part of a row.  Partial
+// results are merged with the online normalizer rule: whenever the maximum
+// grows the partial sum is rescaled, so both come out of a single pass over
+// the row instead of one pass for the max and another for the sum.
+template <typename AccumT>
+struct MaxSumExp {
+  using acc_t = AccumT;
+  AccumT max_input;
+  AccumT sum;
+};
 
-  __device__ __forceinline__ AccumT operator()(AccumT sum, T v) const {
-    return sum + std::exp(v - max_k);
+template <typename T, typename Pair>
+struct OnlineSumExpFloat
+{
+  __device__ __forceinline__ Pair operator()(Pair acc, T v) const {
+    using AccumT = typename Pair::acc_t;
+    const AccumT x = static_cast<AccumT>(v);
+    if (x > acc.max_input) {
+      acc.sum = acc.sum * std::exp(acc.max_input - x) + static_cast<AccumT>(1);
+      acc.max_input = x;
+    } else {
+      acc.sum += std::exp(x - acc.max_input);
+    }
+    return acc;
   }
+};
 
-  const AccumT max_k;
+template <typename Pair>
+struct OnlineSumExp
+{
+  __device__ __forceinline__ Pair operator()(Pair a, Pair b) const {
+    using AccumT = typename Pair::acc_t;
+    const AccumT max_input = ::max(a.max_input, b.max_input);
+    Pair out;
+    out.max_input = max_input;
+    out.sum = a.sum * std::exp(a.max_input - max_input) +
+        b.sum * std::exp(b.max_input - max_input);
+    return out;
+  }
 };
 
 template <template<typename> class Reduction, typename AccumT>
@@ -405,26 +426,22 @@ template <int ILP, typename scalar_t, typename accscalar_t, typename outscalar_t
 __global__ void
 cunn_SoftMaxForward(outscalar_t *output, scalar_t *input, int classes)
 {
+  using pair_t = MaxSumExp<accscalar_t>;
   extern __shared__ unsigned char smem[];
-  auto sdata = reinterpret_cast<accscalar_t*>(smem);
+  auto sdata = reinterpret_cast<pair_t*>(smem);
   // forward pointers to batch[blockIdx.x]
   // each block handles a sample in the mini-batch
   input += blockIdx.x * classes;
   output += blockIdx.x * classes;
 
-  // find the max
-  accscalar_t threadMax = ilpReduce<MaxFloat, ILP, scalar_t, accscalar_t>(
-      input, classes, MaxFloat<scalar_t, accscalar_t>(), -at::numeric_limits<accscalar_t>::max());
-  accscalar_t max_k = blockReduce<Max, accscalar_t>(
-      sdata, threadMax, Max<accscalar_t>(), -at::numeric_limits<accscalar_t>::max());
+  // find the max and the sum of exponentials in one pass
+  const pair_t init = {-at::numeric_limits<accscalar_t>::max(), static_cast<accscalar_t>(0)};
+  pair_t threadVal = ilpReduce<OnlineSumExpFloat, ILP, scalar_t, pair_t>(
+      input, classes, OnlineSumExpFloat<scalar_t, pair_t>(), init);
+  pair_t rowVal = blockReduce<OnlineSumExp, pair_t>(
+      sdata, threadVal, OnlineSumExp<pair_t>(), init);
 
-  // reduce all values
-  accscalar_t threadExp = ilpReduce<SumExpFloat, ILP, scalar_t, accscalar_t>(
-      input, classes, SumExpFloat<scalar_t, accscalar_t>(max_k), static_cast<accscalar_t>(0));
-  accscalar_t sumAll = blockReduce<Add, accscalar_t>(
-      sdata, threadExp, Add<accscalar_t>(), static_cast<accscalar_t>(0));
-
-  Epilogue<scalar_t, accscalar_t, outscalar_t> epilogue(max_k, sumAll);
+  Epilogue<scalar_t, accscalar_t, outscalar_t> epilogue(rowVal.max_input, rowVal.sum);
   int offset = threadIdx.x;
   int last = classes % (ILP * blockDim.x);
   for (; offset < classes - last; offset += blockDim.x * ILP) {
@@ -485,6 +502,78 @@ cunn_SoftMaxBackward(scalar_t *gradInput, outscalar_t *output, outscalar_t *grad
 
 
 
+// Fused log_softmax + nll_loss over rows of a [batch, classes] input: one
+// pass computes the log-sum-exp of the row and the loss is read off it
+// directly, so the probabilities are never written to global memory.
+template <int ILP, typename scalar_t, typename accscalar_t>
+__global__ void
+cunn_SoftMaxCrossEntropyForward(scalar_t *losses, accscalar_t *logsumexp, scalar_t *input,
+                                int64_t *target, int classes, int64_t ignore_index)
+{
+  using pair_t = MaxSumExp<accscalar_t>;
+  extern __shared__ unsigned char smem[];
+  auto sdata = reinterpret_cast<pair_t*>(smem);
+  input += blockIdx.x * classes;
+
+  const pair_t init = {-at::numeric_limits<accscalar_t>::max(), static_cast<accscalar_t>(0)};
+  pair_t threadVal = ilpReduce<OnlineSumExpFloat, ILP, scalar_t, pair_t>(
+      input, classes, OnlineSumExpFloat<scalar_t, pair_t>(), init);
+  pair_t rowVal = blockReduce<OnlineSumExp, pair_t>(
+      sdata, threadVal, OnlineSumExp<pair_t>(), init);
+
+  if (threadIdx.x == 0) {
+    const accscalar_t logsum = rowVal.max_input + std::log(rowVal.sum);
+    const int64_t t = target[blockIdx.x];
+    logsumexp[blockIdx.x] = logsum;
+    if (t == ignore_index) {
+      losses[blockIdx.x] = static_cast<scalar_t>(0);
+    } else {
+      CUDA_KERNEL_ASSERT(t >= 0 && t < classes);
+      losses[blockIdx.x] = static_cast<scalar_t>(logsum - static_cast<accscalar_t>(input[t]));
+    }
+  }
+}
+
+// gradInput = gradOutput * (softmax(input) - one_hot(target)), with the
+// softmax recomputed from the saved log-sum-exp of each row.
+template <int ILP, typename scalar_t, typename accscalar_t>
+__global__ void
+cunn_SoftMaxCrossEntropyBackward(scalar_t *gradInput, scalar_t *gradOutput, scalar_t *input,
+                                 accscalar_t *logsumexp, int64_t *target, int classes,
+                                 int64_t ignore_index)
+{
+  gradInput += blockIdx.x * classes;
+  input += blockIdx.x * classes;
+
+  const int64_t t = target[blockIdx.x];
+  const accscalar_t logsum = logsumexp[blockIdx.x];
+  const accscalar_t grad = t == ignore_index
+      ? static_cast<accscalar_t>(0)
+      : static_cast<accscalar_t>(gradOutput[blockIdx.x]);
+
+  int offset = threadIdx.x;
+  int last = classes % (ILP * blockDim.x);
+  for (; offset < classes - last; offset += blockDim.x * ILP) {
+    scalar_t tmp[ILP];
+
+#pragma unroll
+    for (int j = 0; j < ILP; ++j)
+      tmp[j] = input[offset + j * blockDim.x];
+
+#pragma unroll
+    for (int j = 0; j < ILP; ++j) {
+      const int k = offset + j * blockDim.x;
+      const accscalar_t p = std::exp(static_cast<accscalar_t>(tmp[j]) - logsum);
+      gradInput[k] = static_cast<scalar_t>(grad * (k == t ? p - 1 : p));
+    }
+  }
+
+  for (; offset < classes; offset += blockDim.x) {
+    const accscalar_t p = std::exp(static_cast<accscalar_t>(input[offset]) - logsum);
+    gradInput[offset] = static_cast<scalar_t>(grad * (offset == t ? p - 1 : p));
+  }
+}
+
 template<template<typename, typename, typename> class Epilogue, bool is_log_softmax>
 Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_to_float){
   if (half_to_float) AT_ASSERTM(input_.scalar_type() == ScalarType::Half,"conversion is supported for Half type only");
@@ -518,7 +607,7 @@ Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_t
               output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
         } else {
           cunn_SoftMaxForward<ILP, scalar_t, accscalar_t, scalar_t, Epilogue>
-            <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
+            <<<grid, block, block.x * sizeof(MaxSumExp<accscalar_t>), stream>>>(
               output.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(), dim_size
           );
         }
@@ -528,7 +617,7 @@ Tensor host_softmax(const Tensor & input_, const int64_t dim_, const bool half_t
               output.data_ptr<accscalar_t>(), input.data_ptr<scalar_t>(), dim_size, dim_size, outer_size);
         } else {
           cunn_SoftMaxForward<ILP, scalar_t, accscalar_t, accscalar_t, Epilogue>
-            <<<grid, block, block.x * sizeof(accscalar_t), stream>>>(
+            <<<grid, block, block.x * sizeof(MaxSumExp<accscalar_t>), stream>>>(
               output.data_ptr<accscalar_t>(), input.data_ptr<scalar_t>(), dim_size
           );
         }
@@ -678,5 +767,62 @@ Tensor softmax_backward_cuda(const Tensor &grad, const Tensor &output, int64_t d
   return host_softmax_backward<SoftMaxBackwardEpilogue,false>(tmp, output, dim, half_to_float);
 }
 
+std::tuple<Tensor, Tensor> softmax_cross_entropy_cuda(const Tensor &self, const Tensor &target, int64_t ignore_index){
+  check_softmax_cross_entropy_inputs(self, target);
+  auto input = self.contiguous();
+  auto target_ = target.contiguous();
+  const int64_t batch_size = input.size(0);
+  const int64_t classes = input.size(1);
+  Tensor losses = at::empty({batch_size}, input.options());
+  Tensor logsumexp = at::empty(
+      {batch_size}, input.options().dtype(toAccumulateType(input.scalar_type(), /*is_cuda=*/true)));
+  if (batch_size == 0) {
+    return std::make_tuple(losses, logsumexp);
+  }
+  const int ILP = 2;
+  dim3 grid(batch_size);
+  dim3 block = SoftMax_getBlockSize(ILP, classes);
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "softmax_cross_entropy_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    cunn_SoftMaxCrossEntropyForward<ILP, scalar_t, accscalar_t>
+      <<<grid, block, block.x * sizeof(MaxSumExp<accscalar_t>), stream>>>(
+        losses.data_ptr<scalar_t>(), logsumexp.data_ptr<accscalar_t>(), input.data_ptr<scalar_t>(),
+        target_.data_ptr<int64_t>(), classes, ignore_index
+    );
+  });
+  THCudaCheck(cudaGetLastError());
+  return std::make_tuple(losses, logsumexp);
+}
+
+Tensor softmax_cross_entropy_backward_cuda(const Tensor &grad, const Tensor &self, const Tensor &target,
+                                           const Tensor &logsumexp, int64_t ignore_index){
+  check_softmax_cross_entropy_inputs(self, target);
+  auto input = self.contiguous();
+  auto grad_ = grad.contiguous();
+  auto target_ = target.contiguous();
+  auto logsumexp_ = logsumexp.contiguous();
+  Tensor gI = at::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  const int64_t batch_size = input.size(0);
+  const int64_t classes = input.size(1);
+  if (batch_size == 0) {
+    return gI;
+  }
+  const int ILP = 2;
+  dim3 grid(batch_size);
+  dim3 block = SoftMax_getBlockSize(ILP, classes);
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(input.scalar_type(), "softmax_cross_entropy_backward_cuda", [&] {
+    using accscalar_t = acc_type<scalar_t, true>;
+    cunn_SoftMaxCrossEntropyBackward<ILP, scalar_t, accscalar_t>
+      <<<grid, block, 0, stream>>>(
+        gI.data_ptr<scalar_t>(), grad_.data_ptr<scalar_t>(), input.data_ptr<scalar_t>(),
+        logsumexp_.data_ptr<accscalar_t>(), target_.data_ptr<int64_t>(), classes, ignore_index
+    );
+  });
+  THCudaCheck(cudaGetLastError());
+  return gI;
+}
+
 }
 }
@@ -7,10 +7,13 @@
 #include <tuple>
 #include <iterator>
 #include <thrust/adjacent_difference.h>
+#include <thrust/for_each.h>
+#include <thrust/iterator/counting_iterator.h>
 #include <thrust/unique.h>
 #include <thrust/sort.h>
 #include <thrust/scan.h>
 #include <thrust/scatter.h>
+#include <thrust/transform.h>
 
 namespace at {
 namespace native{
@@ -118,6 +121,143 @@ std::tuple<Tensor, Tensor, Tensor> unique_cuda_template(
   return std::tuple<Tensor, Tensor, Tensor>(output, inverse_indices, counts);
 }
 
+// free slot of the hash table of unique_hash_cuda_template
+constexpr unsigned long long kEmptySlot = ~0ULL;
+
+// Equal values must hash alike, so every type is hashed through its value as
+// a double, with -0.0 folded into 0.0. Distinct int64 values that round to
+// the same double merely collide.
+template <typename scalar_t>
+__device__ uint64_t unique_hash(scalar_t value) {
+  const double d = static_cast<double>(value);
+  uint64_t h = d == 0 ? 0 : static_cast<uint64_t>(__double_as_longlong(d));
+  // finalizer of MurmurHash3
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+// Unsorted unique without sorting the input. Every element is inserted in an
+// open-addressing hash table of element indices with linear probing, whose
+// slot for a value ends up holding the index of its first occurrence. The
+// first occurrences are then numbered in input order, which gives the output
+// in the same order as on CPU. NaNs never compare equal, so each one is its
+// own unique value and is kept out of the table.
+template <typename scalar_t>
+std::tuple<Tensor, Tensor, Tensor> unique_hash_cuda_template(
+  const Tensor& self,
+  const bool return_inverse,
+  const bool return_counts
+) {
+
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  auto allocator = THCThrustAllocator(globalContext().lazyInitCUDA());
+  auto policy = thrust::cuda::par(allocator).on(stream);
+
+  auto options = self.options().dtype(kLong);
+  Tensor input = self.contiguous().reshape(-1);
+  int64_t num_inp = input.numel();
+  Tensor inverse_indices = at::empty({0}, options);
+  Tensor counts = at::empty({0}, options);
+  if (num_inp == 0) {
+    if (return_inverse) {
+      inverse_indices.resize_(self.sizes());
+    }
+    return std::tuple<Tensor, Tensor, Tensor>(
+        at::empty({0}, self.options()), inverse_indices, counts);
+  }
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+
+  // at most half full
+  int64_t capacity = 1;
+  while (capacity < 2 * num_inp) {
+    capacity *= 2;
+  }
+  const uint64_t mask = capacity - 1;
+  Tensor table = at::full({capacity}, -1, options);
+  auto table_ptr = reinterpret_cast<unsigned long long*>(table.data_ptr<int64_t>());
+  auto first = thrust::make_counting_iterator<int64_t>(0);
+  auto last = first + num_inp;
+
+  // Equal elements race for the same slot: the first to claim it compares
+  // equal for the others, which lower the slot to the smallest index.
+  thrust::for_each(policy, first, last, [=] __device__ (int64_t i) {
+    const scalar_t value = input_data[i];
+    if (value != value) {
+      return;
+    }
+    uint64_t slot = unique_hash(value) & mask;
+    while (true) {
+      unsigned long long prev = atomicCAS(
+          &table_ptr[slot], kEmptySlot, static_cast<unsigned long long>(i));
+      if (prev == kEmptySlot) {
+        return;
+      }
+      if (input_data[prev] == value) {
+        atomicMin(&table_ptr[slot], static_cast<unsigned long long>(i));
+        return;
+      }
+      slot = (slot + 1) & mask;
+    }
+  });
+
+  // first occurrence of the value of every element
+  Tensor firsts = at::empty({num_inp}, options);
+  int64_t* firsts_ptr = firsts.data_ptr<int64_t>();
+  thrust::for_each(policy, first, last, [=] __device__ (int64_t i) {
+    const scalar_t value = input_data[i];
+    if (value != value) {
+      firsts_ptr[i] = i;
+      return;
+    }
+    uint64_t slot = unique_hash(value) & mask;
+    while (!(input_data[table_ptr[slot]] == value)) {
+      slot = (slot + 1) & mask;
+    }
+    firsts_ptr[i] = table_ptr[slot];
+  });
+
+  // One past the id of every first occurrence, in input order.
+  Tensor ids = at::empty({num_inp}, options);
+  int64_t* ids_ptr = ids.data_ptr<int64_t>();
+  thrust::transform(policy, first, last, ids_ptr,
+    [=] __device__ (int64_t i) -> int64_t { return firsts_ptr[i] == i; });
+  thrust::inclusive_scan(policy, ids_ptr, ids_ptr + num_inp, ids_ptr);
+  int64_t num_out = ids[num_inp - 1].item<int64_t>();
+
+  Tensor output = at::empty({num_out}, self.options());
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  int64_t* inverse_ptr = nullptr;
+  if (return_inverse) {
+    inverse_indices = at::empty(self.sizes(), options);
+    inverse_ptr = inverse_indices.data_ptr<int64_t>();
+  }
+  unsigned long long* counts_ptr = nullptr;
+  if (return_counts) {
+    counts = at::zeros({num_out}, options);
+    counts_ptr = reinterpret_cast<unsigned long long*>(counts.data_ptr<int64_t>());
+  }
+  thrust::for_each(policy, first, last, [=] __device__ (int64_t i) {
+    const int64_t rep = firsts_ptr[i];
+    const int64_t id = ids_ptr[rep] - 1;
+    if (rep == i) {
+      output_data[id] = input_data[i];
+    }
+    if (inverse_ptr != nullptr) {
+      inverse_ptr[i] = id;
+    }
+    if (counts_ptr != nullptr) {
+      atomicAdd(&counts_ptr[id], 1ULL);
+    }
+  });
+
+  THCudaCheck(cudaGetLastError());
+  return std::tuple<Tensor, Tensor, Tensor>(output, inverse_indices, counts);
+}
+
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_dim_cuda_template(
   const Tensor& self,
@@ -222,10 +362,12 @@ std::tuple<Tensor, Tensor, Tensor> unique_dim_cuda_template(
 std::tuple<Tensor, Tensor>
 _unique_cuda(const Tensor& self, const bool sorted, const bool return_inverse) {
   return AT_DISPATCH_ALL_TYPES_AND2(kBool, kHalf, self.scalar_type(), "unique", [&] {
-    // The current CUDA implementation of unique always sort due to the
-    // lack of hashtable implementation in thrust
     Tensor output, inverse;
-    std::tie(output, inverse, std::ignore) = unique_cuda_template<scalar_t>(self, false, return_inverse, false);
+    if (sorted) {
+      std::tie(output, inverse, std::ignore) = unique_cuda_template<scalar_t>(self, false, return_inverse, false);
+    } else {
+      std::tie(output, inverse, std::ignore) = unique_hash_cuda_template<scalar_t>(self, return_inverse, false);
+    }
     return std::make_tuple(output, inverse);
   });
 }
@@ -233,9 +375,10 @@ _unique_cuda(const Tensor& self, const bool sorted, const bool return_inverse) {
 std::tuple<Tensor, Tensor, Tensor>
 _unique2_cuda(const Tensor& self, const bool sorted, const bool return_inverse, const bool return_counts) {
   return AT_DISPATCH_ALL_TYPES_AND2(kBool, kHalf, self.scalar_type(), "unique", [&] {
-    // The current CUDA implementation of unique always sort due to the
-    // lack of hashtable implementation in thrust
-    return unique_cuda_template<scalar_t>(self, false, return_inverse, return_counts);
+    if (sorted) {
+      return unique_cuda_template<scalar_t>(self, false, return_inverse, return_counts);
+    }
+    return unique_hash_cuda_template<scalar_t>(self, return_inverse, return_counts);
   });
 }
 
@@ -257,8 +400,6 @@ std::tuple<Tensor, Tensor, Tensor>
 unique_consecutive_cuda(const Tensor& self, const bool return_inverse, const bool return_counts, c10::optional<int64_t> dim) {
   if (!dim.has_value()) {
     return AT_DISPATCH_ALL_TYPES_AND2(kBool, kHalf, self.scalar_type(), "unique", [&] {
-      // The current CUDA implementation of unique always sort due to the
-      // lack of hashtable implementation in thrust
       return unique_cuda_template<scalar_t>(self, true, return_inverse, return_counts);
     });
   }
@@ -0,0 +1,447 @@
+#include <ATen/native/group_norm.h>
+
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/cuda/CUDAApplyUtils.cuh>
+#include <THC/THCDeviceUtils.cuh>
+
+#include <c10/cuda/CUDAMathCompat.h>
+
+namespace at {
+namespace native {
+
+namespace {
+
+constexpr int kCUDANumThreads = 256;
+constexpr int kCUDABlockReduceNumThreads = 512;
+
+template <typename T>
+__inline__ __device__ T WarpReduceSum(T val) {
+#pragma unroll
+  for (int offset = (C10_WARP_SIZE >> 1); offset > 0; offset >>= 1) {
+    val += WARP_SHFL_DOWN(val, offset);
+  }
+  return val;
+}
+
+template <typename T>
+__inline__ __device__ T BlockReduceSum(T val, T* shared) {
+  const int lid = threadIdx.x % C10_WARP_SIZE;
+  const int wid = threadIdx.x / C10_WARP_SIZE;
+  val = WarpReduceSum(val);
+  if (lid == 0) {
+    shared[wid] = val;
+  }
+  __syncthreads();
+  val = (threadIdx.x < blockDim.x / C10_WARP_SIZE) ? shared[lid] : 0;
+  if (wid == 0) {
+    val = WarpReduceSum(val);
+  }
+  return val;
+}
+
+// One block per (n, g), reducing its D * HxW contiguous elements.
+template <typename T>
+__global__ void RowwiseMomentsCUDAKernel(
+    int64_t N,
+    T eps,
+    const T* X,
+    T* mean,
+    T* rstd) {
+  using T_ACC = acc_type<T, true>;
+  __shared__ T_ACC m_shared[C10_WARP_SIZE];
+  __shared__ T_ACC v_shared[C10_WARP_SIZE];
+  const int64_t i = blockIdx.x;
+  T_ACC sum1 = 0;
+  T_ACC sum2 = 0;
+  for (int64_t j = threadIdx.x; j < N; j += blockDim.x) {
+    const int64_t index = i * N + j;
+    sum1 += static_cast<T_ACC>(X[index]);
+    sum2 += static_cast<T_ACC>(X[index]) * static_cast<T_ACC>(X[index]);
+  }
+  sum1 = BlockReduceSum<T_ACC>(sum1, m_shared);
+  sum2 = BlockReduceSum<T_ACC>(sum2, v_shared);
+  if (threadIdx.x == 0) {
+    const T_ACC scale = T_ACC(1) / static_cast<T_ACC>(N);
+    sum1 *= scale;
+    sum2 = c10::cuda::compat::max(sum2 * scale - sum1 * sum1, T_ACC(0));
+    mean[i] = sum1;
+    rstd[i] = c10::cuda::compat::rsqrt(sum2 + static_cast<T_ACC>(eps));
+  }
+}
+
+// a[n, c] = rstd[n, g] * gamma[c], b[n, c] = beta[c] - a[n, c] * mean[n, g]
+template <typename T>
+__global__ void ComputeFusedParamsCUDAKernel(
+    int64_t N,
+    int64_t C,
+    int64_t group,
+    const T* mean,
+    const T* rstd,
+    const T* gamma,
+    const T* beta,
+    acc_type<T, true>* a,
+    acc_type<T, true>* b) {
+  using T_ACC = acc_type<T, true>;
+  const int64_t index = blockIdx.x * blockDim.x + threadIdx.x;
+  if (index < N * C) {
+    const int64_t ng = index / (C / group);
+    const int64_t c = index % C;
+    const T_ACC scale = (gamma == nullptr)
+        ? static_cast<T_ACC>(rstd[ng])
+        : static_cast<T_ACC>(rstd[ng]) * static_cast<T_ACC>(gamma[c]);
+    a[index] = scale;
+    b[index] = -scale * static_cast<T_ACC>(mean[ng]) +
+        ((beta == nullptr) ? T_ACC(0) : static_cast<T_ACC>(beta[c]));
+  }
+}
+
+template <typename T>
+__global__ void GroupNormForwardCUDAKernel(
+    int64_t N,
+    int64_t HxW,
+    const T* X,
+    const acc_type<T, true>* a,
+    const acc_type<T, true>* b,
+    T* Y) {
+  using T_ACC = acc_type<T, true>;
+  const int64_t index = blockIdx.x * blockDim.x + threadIdx.x;
+  if (index < N * HxW) {
+    const int64_t nc = index / HxW;
+    Y[index] = a[nc] * static_cast<T_ACC>(X[index]) + b[nc];
+  }
+}
+
+// One block per (n, c): ds = sum(dY * X), db = sum(dY) over HxW.
+template <typename T>
+__global__ void ComputeInternalGradientsCUDAKernel(
+    int64_t HxW,
+    const T* dY,
+    const T* X,
+    acc_type<T, true>* ds,
+    acc_type<T, true>* db) {
+  using T_ACC = acc_type<T, true>;
+  __shared__ T_ACC ds_shared[C10_WARP_SIZE];
+  __shared__ T_ACC db_shared[C10_WARP_SIZE];
+  const int64_t nc = blockIdx.x;
+  T_ACC sum1 = 0;
+  T_ACC sum2 = 0;
+  for (int64_t hw = threadIdx.x; hw < HxW; hw += blockDim.x) {
+    const int64_t index = nc * HxW + hw;
+    sum1 += static_cast<T_ACC>(dY[index]) * static_cast<T_ACC>(X[index]);
+    sum2 += static_cast<T_ACC>(dY[index]);
+  }
+  sum1 = BlockReduceSum<T_ACC>(sum1, ds_shared);
+  sum2 = BlockReduceSum<T_ACC>(sum2, db_shared);
+  if (threadIdx.x == 0) {
+    ds[nc] = sum1;
+    db[nc] = sum2;
+  }
+}
+
+// dX = rstd * gamma * dY + c2 * X + c3 with c2 and c3 per (n, g).
+template <typename T>
+__global__ void ComputeBackwardFusedParamsCUDAKernel(
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    const T* mean,
+    const T* rstd,
+    const T* gamma,
+    const acc_type<T, true>* ds,
+    const acc_type<T, true>* db,
+    acc_type<T, true>* c2,
+    acc_type<T, true>* c3) {
+  using T_ACC = acc_type<T, true>;
+  const int64_t G = group;
+  const int64_t D = C / G;
+  const int64_t n = blockIdx.x;
+  const int64_t g = blockIdx.y;
+  const int64_t ng = n * G + g;
+  T_ACC sum1 = 0;
+  T_ACC sum2 = 0;
+  for (int64_t i = threadIdx.x; i < D; i += blockDim.x) {
+    const int64_t index = ng * D + i;
+    const int64_t c = g * D + i;
+    const T_ACC gamma_v =
+        gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma[c]);
+    sum1 += ds[index] * gamma_v;
+    sum2 += db[index] * gamma_v;
+  }
+  if (blockDim.x <= C10_WARP_SIZE) {
+    sum1 = WarpReduceSum<T_ACC>(sum1);
+    sum2 = WarpReduceSum<T_ACC>(sum2);
+  } else {
+    __shared__ T_ACC ds_shared[C10_WARP_SIZE];
+    __shared__ T_ACC db_shared[C10_WARP_SIZE];
+    sum1 = BlockReduceSum<T_ACC>(sum1, ds_shared);
+    sum2 = BlockReduceSum<T_ACC>(sum2, db_shared);
+  }
+  if (threadIdx.x == 0) {
+    const T_ACC s = T_ACC(1) / static_cast<T_ACC>(D * HxW);
+    const T_ACC x = (sum2 * static_cast<T_ACC>(mean[ng]) - sum1) *
+        static_cast<T_ACC>(rstd[ng]) * static_cast<T_ACC>(rstd[ng]) *
+        static_cast<T_ACC>(rstd[ng]) * s;
+    c2[ng] = x;
+    c3[ng] = -x * static_cast<T_ACC>(mean[ng]) -
+        sum2 * static_cast<T_ACC>(rstd[ng]) * s;
+  }
+}
+
+template <typename T>
+__global__ void GroupNormBackwardCUDAKernel(
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    const T* dY,
+    const T* X,
+    const T* rstd,
+    const T* gamma,
+    const acc_type<T, true>* c2,
+    const acc_type<T, true>* c3,
+    T* dX) {
+  using T_ACC = acc_type<T, true>;
+  const int64_t index = blockIdx.x * blockDim.x + threadIdx.x;
+  if (index < N * C * HxW) {
+    const int64_t nc = index / HxW;
+    const int64_t c = nc % C;
+    const int64_t ng = nc / (C / group);
+    const T_ACC c1 = (gamma == nullptr)
+        ? static_cast<T_ACC>(rstd[ng])
+        : static_cast<T_ACC>(rstd[ng]) * static_cast<T_ACC>(gamma[c]);
+    dX[index] = c1 * static_cast<T_ACC>(dY[index]) +
+        c2[ng] * static_cast<T_ACC>(X[index]) + c3[ng];
+  }
+}
+
+template <typename T>
+__global__ void GammaBetaBackwardCUDAKernel(
+    int64_t N,
+    int64_t C,
+    int64_t group,
+    const T* mean,
+    const T* rstd,
+    const acc_type<T, true>* ds,
+    const acc_type<T, true>* db,
+    T* dgamma,
+    T* dbeta) {
+  using T_ACC = acc_type<T, true>;
+  const int64_t c = blockIdx.x * blockDim.x + threadIdx.x;
+  if (c < C) {
+    const int64_t G = group;
+    const int64_t D = C / G;
+    T_ACC sum1 = 0;
+    T_ACC sum2 = 0;
+    for (int64_t n = 0; n < N; ++n) {
+      const int64_t nc = n * C + c;
+      const int64_t ng = n * G + c / D;
+      sum1 += (dgamma == nullptr)
+          ? T_ACC(0)
+          : ((ds[nc] - db[nc] * static_cast<T_ACC>(mean[ng])) *
+             static_cast<T_ACC>(rstd[ng]));
+      sum2 += (dbeta == nullptr) ? T_ACC(0) : db[nc];
+    }
+    if (dgamma != nullptr) {
+      dgamma[c] = sum1;
+    }
+    if (dbeta != nullptr) {
+      dbeta[c] = sum2;
+    }
+  }
+}
+
+template <typename T>
+void GroupNormKernelImplInternal(
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    T eps,
+    Tensor* Y,
+    Tensor* mean,
+    Tensor* rstd) {
+  using T_ACC = acc_type<T, true>;
+  DCHECK_EQ(X.numel(), N * C * HxW);
+  DCHECK(!gamma.defined() || gamma.numel() == C);
+  DCHECK(!beta.defined() || beta.numel() == C);
+  const int64_t G = group;
+  const int64_t D = C / G;
+  const T* X_data = X.data_ptr<T>();
+  const T* gamma_data = gamma.defined() ? gamma.data_ptr<T>() : nullptr;
+  const T* beta_data = beta.defined() ? beta.data_ptr<T>() : nullptr;
+  T* Y_data = Y->data_ptr<T>();
+  T* mean_data = mean->data_ptr<T>();
+  T* rstd_data = rstd->data_ptr<T>();
+  cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
+  const int64_t num_threads = D * HxW < kCUDABlockReduceNumThreads
+      ? C10_WARP_SIZE
+      : kCUDABlockReduceNumThreads;
+  RowwiseMomentsCUDAKernel<T><<<N * G, num_threads, 0, cuda_stream>>>(
+      D * HxW, eps, X_data, mean_data, rstd_data);
+  const auto kAccType = X.scalar_type() == kHalf ? kFloat : X.scalar_type();
+  Tensor a = at::empty({N, C}, X.options().dtype(kAccType));
+  Tensor b = at::empty({N, C}, X.options().dtype(kAccType));
+  T_ACC* a_data = a.data_ptr<T_ACC>();
+  T_ACC* b_data = b.data_ptr<T_ACC>();
+  const int64_t B = (N * C + kCUDANumThreads - 1) / kCUDANumThreads;
+  ComputeFusedParamsCUDAKernel<T><<<B, kCUDANumThreads, 0, cuda_stream>>>(
+      N, C, G, mean_data, rstd_data, gamma_data, beta_data, a_data, b_data);
+  const int64_t M = (N * C * HxW + kCUDANumThreads - 1) / kCUDANumThreads;
+  GroupNormForwardCUDAKernel<T><<<M, kCUDANumThreads, 0, cuda_stream>>>(
+      N * C, HxW, X_data, a_data, b_data, Y_data);
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+void GroupNormKernelImpl(
+    const Tensor& X,
+    const Tensor& gamma,
+    const Tensor& beta,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps,
+    Tensor* Y,
+    Tensor* mean,
+    Tensor* rstd) {
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+      X.scalar_type(), "GroupNormKernelImpl", [&]() {
+        GroupNormKernelImplInternal<scalar_t>(
+            X,
+            gamma,
+            beta,
+            N,
+            C,
+            HxW,
+            group,
+            static_cast<scalar_t>(eps),
+            Y,
+            mean,
+            rstd);
+      });
+}
+
+template <typename T>
+void GroupNormBackwardKernelImplInternal(
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    Tensor* dX,
+    Tensor* dgamma,
+    Tensor* dbeta) {
+  using T_ACC = acc_type<T, true>;
+  const int64_t G = group;
+  const int64_t D = C / G;
+  DCHECK_EQ(dY.numel(), N * C * HxW);
+  DCHECK_EQ(X.numel(), N * C * HxW);
+  DCHECK_EQ(mean.numel(), N * G);
+  DCHECK_EQ(rstd.numel(), N * G);
+  DCHECK(!gamma.defined() || gamma.numel() == C);
+  const T* dY_data = dY.data_ptr<T>();
+  const T* X_data = X.data_ptr<T>();
+  const T* mean_data = mean.data_ptr<T>();
+  const T* rstd_data = rstd.data_ptr<T>();
+  const T* gamma_data = gamma.defined() ? gamma.data_ptr<T>() : nullptr;
+  cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
+  const auto kAccType = X.scalar_type() == kHalf ? kFloat : X.scalar_type();
+  Tensor ds = at::empty({N, C}, X.options().dtype(kAccType));
+  Tensor db = at::empty({N, C}, X.options().dtype(kAccType));
+  T_ACC* ds_data = ds.data_ptr<T_ACC>();
+  T_ACC* db_data = db.data_ptr<T_ACC>();
+  const int64_t num_threads = HxW < kCUDABlockReduceNumThreads
+      ? C10_WARP_SIZE
+      : kCUDABlockReduceNumThreads;
+  ComputeInternalGradientsCUDAKernel<T>
+      <<<N * C, num_threads, 0, cuda_stream>>>(
+          HxW, dY_data, X_data, ds_data, db_data);
+  if (dX->defined()) {
+    Tensor c2 = at::empty({N, G}, X.options().dtype(kAccType));
+    Tensor c3 = at::empty({N, G}, X.options().dtype(kAccType));
+    T_ACC* c2_data = c2.data_ptr<T_ACC>();
+    T_ACC* c3_data = c3.data_ptr<T_ACC>();
+    const int64_t num_threads = D <= C10_WARP_SIZE
+        ? C10_WARP_SIZE
+        : kCUDABlockReduceNumThreads;
+    ComputeBackwardFusedParamsCUDAKernel<T>
+        <<<dim3(N, G), num_threads, 0, cuda_stream>>>(
+            C,
+            HxW,
+            G,
+            mean_data,
+            rstd_data,
+            gamma_data,
+            ds_data,
+            db_data,
+            c2_data,
+            c3_data);
+    const int64_t B = (N * C * HxW + kCUDANumThreads - 1) / kCUDANumThreads;
+    GroupNormBackwardCUDAKernel<T><<<B, kCUDANumThreads, 0, cuda_stream>>>(
+        N,
+        C,
+        HxW,
+        G,
+        dY_data,
+        X_data,
+        rstd_data,
+        gamma_data,
+        c2_data,
+        c3_data,
+        dX->data_ptr<T>());
+  }
+  if (dgamma->defined() || dbeta->defined()) {
+    T* dgamma_data = dgamma->defined() ? dgamma->data_ptr<T>() : nullptr;
+    T* dbeta_data = dbeta->defined() ? dbeta->data_ptr<T>() : nullptr;
+    const int64_t B = (C + kCUDANumThreads - 1) / kCUDANumThreads;
+    GammaBetaBackwardCUDAKernel<T><<<B, kCUDANumThreads, 0, cuda_stream>>>(
+        N,
+        C,
+        G,
+        mean_data,
+        rstd_data,
+        ds_data,
+        db_data,
+        dgamma_data,
+        dbeta_data);
+  }
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+void GroupNormBackwardKernelImpl(
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    Tensor* dX,
+    Tensor* dgamma,
+    Tensor* dbeta) {
+  AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+      X.scalar_type(), "GroupNormBackwardKernelImpl", [&]() {
+        GroupNormBackwardKernelImplInternal<scalar_t>(
+            dY, X, mean, rstd, gamma, N, C, HxW, group, dX, dgamma, dbeta);
+      });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(GroupNormKernel, &GroupNormKernelImpl);
+REGISTER_DISPATCH(GroupNormBackwardKernel, &GroupNormBackwardKernelImpl);
+
+} // namespace native
+} // namespace at
@@ -2,6 +2,7 @@
 
 #include <ATen/ATen.h>
 #include <ATen/AccumulateType.h>
+#include <ATen/CUDAGenerator.h>
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
@@ -9,6 +10,7 @@
 #include <THC/THCDeviceUtils.cuh>
 
 #include <c10/cuda/CUDAMathCompat.h>
+#include <curand_kernel.h>
 
 namespace at {
 namespace native {
@@ -96,6 +98,80 @@ __global__ void LayerNormForwardCUDAKernel(
   }
 }
 
+// One block per row: S = R + dropout(X + input_bias) is written together with
+// the dropout mask while its moments are accumulated, then Y = LayerNorm(S)
+// is computed from the values this thread has just written. Each thread
+// draws one uniform per element it owns from its own Philox subsequence.
+template <typename T>
+__global__ void FusedDropoutAddLayerNormCUDAKernel(
+    int64_t N,
+    float keep_prob,
+    acc_type<T, true> scale,
+    bool train,
+    std::pair<uint64_t, uint64_t> seeds,
+    T eps,
+    const T* X,
+    const T* R,
+    const T* input_bias,
+    const T* gamma,
+    const T* beta,
+    T* S,
+    uint8_t* mask,
+    T* mean,
+    T* rstd,
+    T* Y) {
+  using T_ACC = acc_type<T, true>;
+  __shared__ T_ACC m_shared[C10_WARP_SIZE];
+  __shared__ T_ACC v_shared[C10_WARP_SIZE];
+  __shared__ T_ACC mean_shared;
+  __shared__ T_ACC rstd_shared;
+  const int64_t i = blockIdx.x;
+  curandStatePhilox4_32_10_t state;
+  if (train) {
+    curand_init(seeds.first, i * blockDim.x + threadIdx.x, seeds.second, &state);
+  }
+  T_ACC sum1 = 0;
+  T_ACC sum2 = 0;
+  for (int64_t j = threadIdx.x; j < N; j += blockDim.x) {
+    const int64_t index = i * N + j;
+    T_ACC v = static_cast<T_ACC>(X[index]);
+    if (input_bias != nullptr) {
+      v += static_cast<T_ACC>(input_bias[j]);
+    }
+    if (train) {
+      const bool keep = curand_uniform(&state) < keep_prob;
+      mask[index] = static_cast<uint8_t>(keep);
+      v = keep ? v * scale : T_ACC(0);
+    }
+    S[index] = static_cast<T>(v + static_cast<T_ACC>(R[index]));
+    const T_ACC s = static_cast<T_ACC>(S[index]);
+    sum1 += s;
+    sum2 += s * s;
+  }
+  sum1 = BlockReduceSum<T_ACC>(sum1, m_shared);
+  sum2 = BlockReduceSum<T_ACC>(sum2, v_shared);
+  if (threadIdx.x == 0) {
+    const T_ACC s = T_ACC(1) / static_cast<T_ACC>(N);
+    sum1 *= s;
+    sum2 = c10::cuda::compat::max(sum2 * s - sum1 * sum1, T_ACC(0));
+    mean[i] = sum1;
+    rstd[i] = c10::cuda::compat::rsqrt(sum2 + static_cast<T_ACC>(eps));
+    mean_shared = static_cast<T_ACC>(mean[i]);
+    rstd_shared = static_cast<T_ACC>(rstd[i]);
+  }
+  __syncthreads();
+  for (int64_t j = threadIdx.x; j < N; j += blockDim.x) {
+    const int64_t index = i * N + j;
+    const T_ACC gamma_v =
+        gamma == nullptr ? T_ACC(1) : static_cast<T_ACC>(gamma[j]);
+    const T_ACC beta_v =
+        beta == nullptr ? T_ACC(0) : static_cast<T_ACC>(beta[j]);
+    Y[index] = (static_cast<T_ACC>(S[index]) - mean_shared) * rstd_shared *
+            gamma_v +
+        beta_v;
+  }
+}
+
 template <typename T>
 __global__ void ComputeInternalGradientsCUDAKernel(
     int64_t N,
@@ -439,6 +515,55 @@ void LayerNormBackwardKernelImpl(
       });
 }
 
+template <typename T>
+void FusedDropoutAddLayerNormKernelImplInternal(
+    const Tensor& X,
+    const Tensor& R,
+    const Tensor& input_bias,
+    const Tensor& gamma,
+    const Tensor& beta,
+    double p,
+    bool train,
+    std::pair<uint64_t, uint64_t> seeds,
+    int64_t M,
+    int64_t N,
+    T eps,
+    Tensor* S,
+    Tensor* mask,
+    Tensor* mean,
+    Tensor* rstd,
+    Tensor* Y) {
+  using T_ACC = acc_type<T, true>;
+  DCHECK_EQ(X.numel(), M * N);
+  DCHECK_EQ(R.numel(), M * N);
+  const T* input_bias_data =
+      input_bias.defined() ? input_bias.data_ptr<T>() : nullptr;
+  const T* gamma_data = gamma.defined() ? gamma.data_ptr<T>() : nullptr;
+  const T* beta_data = beta.defined() ? beta.data_ptr<T>() : nullptr;
+  uint8_t* mask_data = train ? mask->data_ptr<uint8_t>() : nullptr;
+  const T_ACC scale = p < 1 ? T_ACC(1) / static_cast<T_ACC>(1 - p) : T_ACC(0);
+  cudaStream_t cuda_stream = at::cuda::getCurrentCUDAStream();
+  FusedDropoutAddLayerNormCUDAKernel<T>
+      <<<M, kCUDABlockReduceNumThreads, 0, cuda_stream>>>(
+          N,
+          static_cast<float>(1 - p),
+          scale,
+          train,
+          seeds,
+          eps,
+          X.data_ptr<T>(),
+          R.data_ptr<T>(),
+          input_bias_data,
+          gamma_data,
+          beta_data,
+          S->data_ptr<T>(),
+          mask_data,
+          mean->data_ptr<T>(),
+          rstd->data_ptr<T>(),
+          Y->data_ptr<T>());
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
 } // namespace
 
 std::tuple<Tensor, Tensor, Tensor> layer_norm_cuda(
@@ -485,6 +610,64 @@ std::tuple<Tensor, Tensor, Tensor> layer_norm_backward_cuda(
   return std::make_tuple(std::move(dX), std::move(dgamma), std::move(dbeta));
 }
 
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor>
+fused_dropout_add_layer_norm_cuda(
+    const Tensor& input,
+    const Tensor& residual,
+    const Tensor& input_bias /* optional */,
+    const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */,
+    double p,
+    bool train,
+    int64_t M,
+    int64_t N,
+    double eps,
+    Generator* gen_) {
+  const bool apply_dropout = train && p > 0;
+  Tensor Y = at::native::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor S = at::native::empty_like(input, LEGACY_CONTIGUOUS_MEMORY_FORMAT);
+  Tensor mask = at::empty(
+      apply_dropout ? input.sizes() : IntArrayRef{0},
+      input.options().dtype(kByte));
+  Tensor mean = at::empty({M}, input.options());
+  Tensor rstd = at::empty({M}, input.options());
+  if (M > 0) {
+    std::pair<uint64_t, uint64_t> rng_engine_inputs;
+    if (apply_dropout) {
+      auto gen = get_generator_or_default<CUDAGenerator>(
+          gen_, cuda::detail::getDefaultCUDAGenerator());
+      // Each thread draws one 32-bit value per element it owns, the offset
+      // is rounded up to whole Philox outputs of four values.
+      const int64_t counter_offset =
+          ((N - 1) / (kCUDABlockReduceNumThreads * 4) + 1) * 4;
+      // See Note [Acquire lock when using random generators]
+      std::lock_guard<std::mutex> lock(gen->mutex_);
+      rng_engine_inputs = gen->philox_engine_inputs(counter_offset);
+    }
+    AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+        input.scalar_type(), "FusedDropoutAddLayerNormKernelImpl", [&]() {
+          FusedDropoutAddLayerNormKernelImplInternal<scalar_t>(
+              input,
+              residual,
+              input_bias,
+              weight,
+              bias,
+              p,
+              apply_dropout,
+              rng_engine_inputs,
+              M,
+              N,
+              static_cast<scalar_t>(eps),
+              &S,
+              &mask,
+              &mean,
+              &rstd,
+              &Y);
+        });
+  }
+  return std::make_tuple(
+      std::move(Y), std::move(S), std::move(mask), std::move(mean), std::move(rstd));
+}
 
 REGISTER_DISPATCH(LayerNormKernel, &LayerNormKernelImpl);
 REGISTER_DISPATCH(LayerNormBackwardKernel, &LayerNormBackwardKernelImpl);
@@ -4,6 +4,7 @@
 #include <ATen/Config.h>
 #include <ATen/cuda/CUDAConfig.h>
 #include <ATen/cuda/Exceptions.h>
+#include <ATen/cudnn/BenchmarkCache.h>
 #include <ATen/native/ConvUtils.h>
 
 #if !AT_CUDNN_ENABLED()
@@ -68,6 +69,14 @@ std::tuple<at::Tensor,at::Tensor> cudnn_convolution_transpose_backward(
   AT_ERROR("cudnn_convolution_transpose_backward: ATen not compiled with cuDNN support");
 }
 
+void cudnn_convolution_save_benchmark_cache(const std::string& filename) {
+  AT_ERROR("cudnn_convolution_save_benchmark_cache: ATen not compiled with cuDNN support");
+}
+
+bool cudnn_convolution_load_benchmark_cache(const std::string& filename) {
+  AT_ERROR("cudnn_convolution_load_benchmark_cache: ATen not compiled with cuDNN support");
+}
+
 }}
 
 #else  // AT_CUDNN_ENABLED
@@ -81,7 +90,10 @@ std::tuple<at::Tensor,at::Tensor> cudnn_convolution_transpose_backward(
 #include <ATen/native/utils/ParamsHash.h>
 
 #include <ATen/TensorUtils.h>
+#include <ATen/cuda/CUDAContext.h>
 
+#include <cstring>
+#include <fstream>
 #include <functional>
 #include <iterator>
 #include <sstream>
@@ -90,6 +102,7 @@ std::tuple<at::Tensor,at::Tensor> cudnn_convolution_transpose_backward(
 #include <mutex>
 #include <stdint.h>
 #include <unordered_map>
+#include <vector>
 
 // Note [behavior of cudnnFind and cudnnGet]
 // You'll notice that by default, in the ConvolutionDescriptor, we do the following:
@@ -292,6 +305,138 @@ BenchmarkCache<cudnnConvolutionFwdAlgoPerf_t> fwd_algos;
 BenchmarkCache<cudnnConvolutionBwdDataAlgoPerf_t> bwd_data_algos;
 BenchmarkCache<cudnnConvolutionBwdFilterAlgoPerf_t> bwd_filter_algos;
 
+// Note [cuDNN benchmark cache file]
+// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Both ConvolutionParams and the cudnn*AlgoPerf_t results are PODs (the
+// params are memset before being filled in), so the caches are written as
+// raw (params, perf) records. The header pins everything that would make
+// the records meaningless elsewhere: the record sizes of this build, the
+// cuDNN version and the GPU model of the current device. A file that does
+// not match is ignored instead of seeding the cache with bad algorithms.
+
+struct BenchmarkCacheFileHeader {
+  char magic[8];
+  uint32_t format_version;
+  uint32_t params_size;
+  uint32_t fwd_perf_size;
+  uint32_t bwd_data_perf_size;
+  uint32_t bwd_filter_perf_size;
+  int32_t device_major;
+  int32_t device_minor;
+  uint64_t cudnn_version;
+  char device_name[256];
+};
+
+static constexpr char kBenchmarkCacheMagic[8] = {'C', 'U', 'D', 'N', 'N', 'C', 'C', 'H'};
+static constexpr uint32_t kBenchmarkCacheFormatVersion = 1;
+
+static BenchmarkCacheFileHeader current_benchmark_cache_header() {
+  BenchmarkCacheFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kBenchmarkCacheMagic, sizeof(header.magic));
+  header.format_version = kBenchmarkCacheFormatVersion;
+  header.params_size = sizeof(ConvolutionParams);
+  header.fwd_perf_size = sizeof(cudnnConvolutionFwdAlgoPerf_t);
+  header.bwd_data_perf_size = sizeof(cudnnConvolutionBwdDataAlgoPerf_t);
+  header.bwd_filter_perf_size = sizeof(cudnnConvolutionBwdFilterAlgoPerf_t);
+  const cudaDeviceProp* prop = at::cuda::getCurrentDeviceProperties();
+  header.device_major = prop->major;
+  header.device_minor = prop->minor;
+  header.cudnn_version = cudnnGetVersion();
+  strncpy(header.device_name, prop->name, sizeof(header.device_name) - 1);
+  return header;
+}
+
+template <typename T>
+static void write_benchmark_cache(std::ostream& out, BenchmarkCache<T>& cache) {
+  std::lock_guard<std::mutex> guard(cache.mutex);
+  uint64_t count = cache.map.size();
+  out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  for (const auto& entry : cache.map) {
+    out.write(reinterpret_cast<const char*>(&entry.first), sizeof(entry.first));
+    out.write(reinterpret_cast<const char*>(&entry.second), sizeof(entry.second));
+  }
+}
+
+template <typename T>
+static bool read_benchmark_cache(std::istream& in, std::vector<std::pair<ConvolutionParams, T>>& entries) {
+  uint64_t count = 0;
+  if (!in.read(reinterpret_cast<char*>(&count), sizeof(count))) {
+    return false;
+  }
+  // Don't trust count for the allocation; a corrupted file runs out first.
+  for (uint64_t i = 0; i < count; ++i) {
+    std::pair<ConvolutionParams, T> entry;
+    if (!in.read(reinterpret_cast<char*>(&entry.first), sizeof(entry.first)) ||
+        !in.read(reinterpret_cast<char*>(&entry.second), sizeof(entry.second))) {
+      return false;
+    }
+    entries.push_back(entry);
+  }
+  return true;
+}
+
+void cudnn_convolution_save_benchmark_cache(const std::string& filename) {
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  TORCH_CHECK(out, "cudnn_convolution_save_benchmark_cache: could not open ", filename, " for writing");
+  const auto header = current_benchmark_cache_header();
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  write_benchmark_cache(out, fwd_algos);
+  write_benchmark_cache(out, bwd_data_algos);
+  write_benchmark_cache(out, bwd_filter_algos);
+  TORCH_CHECK(out, "cudnn_convolution_save_benchmark_cache: failed to write ", filename);
+}
+
+bool cudnn_convolution_load_benchmark_cache(const std::string& filename) {
+  std::ifstream in(filename, std::ios::binary);
+  TORCH_CHECK(in, "cudnn_convolution_load_benchmark_cache: could not open ", filename, " for reading");
+
+  BenchmarkCacheFileHeader header;
+  const auto expected = current_benchmark_cache_header();
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0 ||
+      header.format_version != expected.format_version ||
+      header.params_size != expected.params_size ||
+      header.fwd_perf_size != expected.fwd_perf_size ||
+      header.bwd_data_perf_size != expected.bwd_data_perf_size ||
+      header.bwd_filter_perf_size != expected.bwd_filter_perf_size) {
+    TORCH_WARN("cuDNN benchmark cache ", filename, " was not written by this build of PyTorch; ignoring it");
+    return false;
+  }
+  header.device_name[sizeof(header.device_name) - 1] = '\0';
+  if (header.cudnn_version != expected.cudnn_version ||
+      header.device_major != expected.device_major ||
+      header.device_minor != expected.device_minor ||
+      strcmp(header.device_name, expected.device_name) != 0) {
+    TORCH_WARN("cuDNN benchmark cache ", filename, " was written for ", header.device_name,
+               " with cuDNN ", header.cudnn_version, ", but the current device is ",
+               expected.device_name, " with cuDNN ", expected.cudnn_version, "; ignoring it");
+    return false;
+  }
+
+  // Read everything before touching the caches, so a truncated file
+  // doesn't leave them half updated.
+  std::vector<std::pair<ConvolutionParams, cudnnConvolutionFwdAlgoPerf_t>> fwd;
+  std::vector<std::pair<ConvolutionParams, cudnnConvolutionBwdDataAlgoPerf_t>> bwd_data;
+  std::vector<std::pair<ConvolutionParams, cudnnConvolutionBwdFilterAlgoPerf_t>> bwd_filter;
+  if (!read_benchmark_cache(in, fwd) ||
+      !read_benchmark_cache(in, bwd_data) ||
+      !read_benchmark_cache(in, bwd_filter)) {
+    TORCH_WARN("cuDNN benchmark cache ", filename, " is truncated; ignoring it");
+    return false;
+  }
+  for (const auto& entry : fwd) {
+    fwd_algos.insert(entry.first, entry.second);
+  }
+  for (const auto& entry : bwd_data) {
+    bwd_data_algos.insert(entry.first, entry.second);
+  }
+  for (const auto& entry : bwd_filter) {
+    bwd_filter_algos.insert(entry.first, entry.second);
+  }
+  return true;
+}
+
 // TODO: Stop manually allocating CUDA memory; allocate an ATen byte
 // tensor instead.
 struct Workspace {
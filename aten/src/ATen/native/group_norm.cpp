@@ -0,0 +1,171 @@
+#include <ATen/native/group_norm.h>
+
+#include <array>
+#include <functional>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+
+namespace at {
+namespace native {
+
+namespace {
+
+// Only the CPU kernels read channels last inputs directly, CUDA inputs are
+// made contiguous.
+MemoryFormat group_norm_memory_format(const Tensor& X) {
+  return X.device().is_cpu() ? X.suggest_memory_format()
+                             : MemoryFormat::Contiguous;
+}
+
+} // namespace
+
+std::tuple<Tensor, Tensor, Tensor> native_group_norm(
+    const Tensor& X,
+    const Tensor& gamma /* optional */,
+    const Tensor& beta /* optional */,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    double eps) {
+  const auto memory_format = group_norm_memory_format(X);
+  TORCH_CHECK(
+      X.is_contiguous(memory_format),
+      "native_group_norm expects a contiguous input");
+  Tensor Y = at::empty_like(X, memory_format);
+  Tensor mean = at::empty({N, group}, X.options());
+  Tensor rstd = at::empty({N, group}, X.options());
+  if (X.numel() > 0) {
+    GroupNormKernel(
+        X.device().type(), X, gamma, beta, N, C, HxW, group, eps, &Y, &mean, &rstd);
+  } else {
+    mean.zero_();
+    rstd.zero_();
+  }
+  return std::make_tuple(std::move(Y), std::move(mean), std::move(rstd));
+}
+
+std::tuple<Tensor, Tensor, Tensor> native_group_norm_backward(
+    const Tensor& dY,
+    const Tensor& X,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& gamma,
+    int64_t N,
+    int64_t C,
+    int64_t HxW,
+    int64_t group,
+    std::array<bool, 3> grad_input_mask) {
+  const auto memory_format = group_norm_memory_format(X);
+  Tensor dX;
+  Tensor dgamma;
+  Tensor dbeta;
+  if (grad_input_mask[0]) {
+    dX = at::empty_like(X, memory_format);
+  }
+  if (grad_input_mask[1]) {
+    dgamma = X.numel() > 0 ? at::empty({C}, X.options())
+                           : at::zeros({C}, X.options());
+  }
+  if (grad_input_mask[2]) {
+    dbeta = X.numel() > 0 ? at::empty({C}, X.options())
+                          : at::zeros({C}, X.options());
+  }
+  if (X.numel() > 0) {
+    GroupNormBackwardKernel(
+        X.device().type(),
+        dY.contiguous(memory_format),
+        X,
+        mean,
+        rstd,
+        gamma,
+        N,
+        C,
+        HxW,
+        group,
+        &dX,
+        &dgamma,
+        &dbeta);
+  }
+  return std::make_tuple(std::move(dX), std::move(dgamma), std::move(dbeta));
+}
+
+Tensor group_norm(
+    const Tensor& input,
+    int64_t num_groups,
+    const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */,
+    double eps,
+    bool cudnn_enabled) {
+  const Tensor& X = input;
+  const int64_t N = input.size(0);
+  const int64_t C = input.size(1);
+  TORCH_CHECK(
+      C % num_groups == 0,
+      "Expected number of channels in input to be divisible by ",
+      "num_groups, but got input of shape ",
+      input.sizes(),
+      " and "
+      "num_groups=",
+      num_groups);
+  TORCH_CHECK(
+      !weight.defined() || (weight.dim() == 1 && weight.numel() == C),
+      "Expected weight to be a vector of size equal to the number of ",
+      "channels in input, but got weight of shape ",
+      weight.sizes(),
+      " and input of shape ",
+      input.sizes());
+  TORCH_CHECK(
+      !bias.defined() || (bias.dim() == 1 && bias.numel() == C),
+      "Expected bias to be a vector of size equal to the number of ",
+      "channels in input, but got bias of shape ",
+      weight.sizes(),
+      " and input of shape ",
+      input.sizes());
+
+  // The kernels expect weight and bias of the input type; keep the old
+  // batch_norm based composition for mixed types such as half inputs with
+  // float parameters.
+  const bool same_type =
+      (!weight.defined() || weight.scalar_type() == X.scalar_type()) &&
+      (!bias.defined() || bias.scalar_type() == X.scalar_type());
+  if (!same_type) {
+    // view(..., -1) does not work for empty tensor
+    auto input_reshaped = input.contiguous().view({1, N * num_groups, N ? -1 : 1});
+    auto out = at::batch_norm(input_reshaped, {}, {}, {}, {}, true, 0, eps,
+                              cudnn_enabled);
+    out = out.view(input.sizes());
+    std::vector<int64_t> affine_param_shape(input.dim(), 1);
+    affine_param_shape[1] = C;
+    if (weight.defined() && bias.defined()) {
+      return bias.view(affine_param_shape).addcmul(out, weight.view(affine_param_shape), 1);
+    } else if (weight.defined()) {
+      return out.mul(weight.view(affine_param_shape));
+    } else {
+      return out.add(bias.view(affine_param_shape));
+    }
+  }
+
+  const auto input_shape = input.sizes();
+  const int64_t HxW = std::accumulate(
+      input_shape.cbegin() + 2,
+      input_shape.cend(),
+      1LL,
+      std::multiplies<int64_t>());
+  const auto memory_format = group_norm_memory_format(X);
+  const Tensor& X_contig = X.contiguous(memory_format);
+  const Tensor& gamma = weight.defined() ? weight.contiguous() : weight;
+  const Tensor& beta = bias.defined() ? bias.contiguous() : bias;
+  return std::get<0>(
+      at::native_group_norm(X_contig, gamma, beta, N, C, HxW, num_groups, eps));
+}
+
+DEFINE_DISPATCH(GroupNormKernel);
+DEFINE_DISPATCH(GroupNormBackwardKernel);
+
+} // namespace native
+} // namespace at
@@ -60,13 +60,15 @@ std::tuple<Tensor, Tensor, Tensor> layer_norm_backward_cpu(
   return std::make_tuple(std::move(dX), std::move(dgamma), std::move(dbeta));
 }
 
-Tensor layer_norm(
+namespace {
+
+// Checks the arguments of layer_norm and returns the number of rows M and
+// the length N of each normalized row.
+std::tuple<int64_t, int64_t> check_layer_norm_inputs(
     const Tensor& input,
     IntArrayRef normalized_shape,
     const Tensor& weight /* optional */,
-    const Tensor& bias /* optional */,
-    double eps,
-    bool /* cudnn_enable, deprecated */) {
+    const Tensor& bias /* optional */) {
   const int normalized_ndim = normalized_shape.size();
   TORCH_CHECK(
       normalized_ndim >= 1,
@@ -115,11 +117,161 @@ Tensor layer_norm(
       input_shape.cend(),
       1LL,
       std::multiplies<int64_t>());
+  return std::make_tuple(M, N);
+}
+
+// Flattens an optional per-row parameter of normalized_shape to length N.
+Tensor flatten_layer_norm_param(const Tensor& param, int64_t N) {
+  return param.defined() ? param.contiguous().view({N}) : param;
+}
+
+} // namespace
+
+Tensor layer_norm(
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */,
+    double eps,
+    bool /* cudnn_enable, deprecated */) {
+  int64_t M, N;
+  std::tie(M, N) = check_layer_norm_inputs(input, normalized_shape, weight, bias);
+
+  auto X = input.expect_contiguous();
+  auto gamma = weight.expect_contiguous();
+  auto beta = bias.expect_contiguous();
+  return std::get<0>(at::native_layer_norm(*X, *gamma, *beta, M, N, eps));
+}
+
+// Computes layer_norm(residual + dropout(input + input_bias, p, train)) with
+// a single pass over the activations on CUDA. The sum before normalization
+// and the dropout mask are returned by _fused_dropout_add_layer_norm so the
+// backward does not have to recompute them.
+Tensor dropout_add_layer_norm(
+    const Tensor& input,
+    const Tensor& residual,
+    IntArrayRef normalized_shape,
+    const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */,
+    const Tensor& input_bias /* optional */,
+    double p,
+    bool train,
+    double eps) {
+  TORCH_CHECK(
+      p >= 0 && p <= 1,
+      "dropout probability has to be between 0 and 1, but got ",
+      p);
+  TORCH_CHECK(
+      input.sizes().equals(residual.sizes()),
+      "Expected residual to be of same shape as input, but got residual of ",
+      "shape ",
+      residual.sizes(),
+      " and input of shape ",
+      input.sizes());
+  TORCH_CHECK(
+      !input_bias.defined() || input_bias.sizes().equals(normalized_shape),
+      "Expected input_bias to be of same shape as normalized_shape, but got ",
+      "input_bias of shape ",
+      input_bias.sizes(),
+      " and normalized_shape = ",
+      normalized_shape);
+  int64_t M, N;
+  std::tie(M, N) = check_layer_norm_inputs(input, normalized_shape, weight, bias);
+  return std::get<0>(at::_fused_dropout_add_layer_norm(
+      input.contiguous(),
+      residual.contiguous(),
+      flatten_layer_norm_param(input_bias, N),
+      flatten_layer_norm_param(weight, N),
+      flatten_layer_norm_param(bias, N),
+      p,
+      train,
+      M,
+      N,
+      eps));
+}
 
-  const auto& X = input.is_contiguous() ? input : input.contiguous();
-  const auto& gamma = weight.is_contiguous() ? weight : weight.contiguous();
-  const auto& beta = bias.is_contiguous() ? bias : bias.contiguous();
-  return std::get<0>(at::native_layer_norm(X, gamma, beta, M, N, eps));
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor>
+fused_dropout_add_layer_norm_cpu(
+    const Tensor& input,
+    const Tensor& residual,
+    const Tensor& input_bias /* optional */,
+    const Tensor& weight /* optional */,
+    const Tensor& bias /* optional */,
+    double p,
+    bool train,
+    int64_t M,
+    int64_t N,
+    double eps,
+    Generator* gen) {
+  Tensor sum = input_bias.defined() ? input.view({M, N}) + input_bias
+                                    : input.view({M, N}).clone();
+  Tensor mask = at::empty({0}, input.options().dtype(kByte));
+  if (train && p > 0) {
+    mask = at::empty({M, N}, input.options().dtype(kByte)).bernoulli_(1 - p, gen);
+    sum.mul_(mask.type_as(sum)).mul_(p < 1 ? 1 / (1 - p) : 0);
+    mask = mask.view(input.sizes());
+  }
+  sum.add_(residual.view({M, N}));
+  sum = sum.view(input.sizes());
+  Tensor Y, mean, rstd;
+  std::tie(Y, mean, rstd) = at::native_layer_norm(sum, weight, bias, M, N, eps);
+  return std::make_tuple(
+      std::move(Y), std::move(sum), std::move(mask), std::move(mean), std::move(rstd));
+}
+
+// output_mask and the returned gradients are ordered as input, residual,
+// input_bias, weight, bias.
+std::tuple<Tensor, Tensor, Tensor, Tensor, Tensor>
+_fused_dropout_add_layer_norm_backward(
+    const Tensor& grad_out,
+    const Tensor& sum,
+    const Tensor& mask,
+    const Tensor& mean,
+    const Tensor& rstd,
+    const Tensor& weight /* optional */,
+    double p,
+    bool train,
+    int64_t M,
+    int64_t N,
+    std::array<bool, 5> output_mask) {
+  const bool need_dsum = output_mask[0] || output_mask[1] || output_mask[2];
+  Tensor dsum;
+  Tensor dweight;
+  Tensor dbias;
+  std::tie(dsum, dweight, dbias) = at::native_layer_norm_backward(
+      grad_out.contiguous(),
+      sum,
+      mean,
+      rstd,
+      weight,
+      M,
+      N,
+      {need_dsum, output_mask[3], output_mask[4]});
+  Tensor dinput;
+  Tensor dresidual;
+  Tensor dinput_bias;
+  if (need_dsum) {
+    if (output_mask[1]) {
+      dresidual = dsum;
+    }
+    if (output_mask[0] || output_mask[2]) {
+      dinput = train && p > 0
+          ? dsum * (mask.type_as(dsum) * (p < 1 ? 1 / (1 - p) : 0))
+          : dsum;
+    }
+    if (output_mask[2]) {
+      dinput_bias = dinput.view({M, N}).sum(0);
+    }
+    if (!output_mask[0]) {
+      dinput = Tensor();
+    }
+  }
+  return std::make_tuple(
+      std::move(dinput),
+      std::move(dresidual),
+      std::move(dinput_bias),
+      std::move(dweight),
+      std::move(dbias));
 }
 
 DEFINE_DISPATCH(LayerNormKernel);
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/mkl/Descriptors.h>
+#include <ATen/mkl/Exceptions.h>
+#include <ATen/native/utils/ParamsHash.h>
+
+#include <cmath>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <mkl_dfti.h>
+
+namespace at { namespace native { namespace detail {
+
+constexpr int64_t mkl_fft_max_signal_ndim = 3;
+
+// This POD struct is the **key** to the MKL plan cache. It holds everything
+// that goes into the DFTI descriptor; strides and distances are in units of
+// the (real or complex) elements MKL sees.
+struct MKLFFTParams
+{
+  at::ScalarType scalar_type_;
+  int64_t batch_;
+  int64_t input_distance_;
+  int64_t output_distance_;
+  int64_t signal_sizes_[mkl_fft_max_signal_ndim];
+  int64_t input_strides_[mkl_fft_max_signal_ndim];
+  int64_t output_strides_[mkl_fft_max_signal_ndim];
+  uint8_t signal_ndim_;
+  bool complex_input_;
+  bool complex_output_;
+  bool inverse_;
+  bool normalized_;
+};
+
+// NB: This can't be a constructor, because then MKLFFTParams
+// would not be a POD anymore.
+static inline void setMKLFFTParams(MKLFFTParams* params,
+    const Tensor& input, const Tensor& output, int64_t signal_ndim,
+    bool complex_input, bool complex_output, bool inverse,
+    IntArrayRef checked_signal_sizes, bool normalized) {
+
+  memset(params, 0, sizeof(MKLFFTParams));
+  params->scalar_type_ = input.scalar_type();
+  params->batch_ = input.size(0);
+  params->input_distance_ = complex_input ? input.stride(0) >> 1 : input.stride(0);
+  params->output_distance_ = complex_output ? output.stride(0) >> 1 : output.stride(0);
+  for (int64_t i = 0; i < signal_ndim; i++) {
+    params->signal_sizes_[i] = checked_signal_sizes[i];
+    params->input_strides_[i] = complex_input ? input.stride(i + 1) >> 1 : input.stride(i + 1);
+    params->output_strides_[i] = complex_output ? output.stride(i + 1) >> 1 : output.stride(i + 1);
+  }
+  params->signal_ndim_ = (uint8_t) signal_ndim;
+  params->complex_input_ = complex_input;
+  params->complex_output_ = complex_output;
+  params->inverse_ = inverse;
+  params->normalized_ = normalized;
+}
+
+// This class will be the **value** in the plan cache. It holds a committed
+// DFTI descriptor through a shared_ptr, so a caller can keep running the
+// transform after dropping the cache lock even if the entry gets evicted in
+// the meantime. MKL allows a committed descriptor to be used by several
+// threads at once.
+class MKLFFTConfig {
+public:
+  MKLFFTConfig(const MKLFFTConfig&) = delete;
+  MKLFFTConfig& operator=(MKLFFTConfig const&) = delete;
+
+  explicit MKLFFTConfig(const MKLFFTParams& params) {
+    // precision
+    DFTI_CONFIG_VALUE prec = params.scalar_type_ == ScalarType::Double ? DFTI_DOUBLE : DFTI_SINGLE;
+    // signal type
+    DFTI_CONFIG_VALUE signal_type;
+    if (!params.inverse_) {
+      signal_type = params.complex_input_ ? DFTI_COMPLEX : DFTI_REAL;
+    } else {
+      signal_type = params.complex_output_ ? DFTI_COMPLEX : DFTI_REAL;
+    }
+    const int64_t signal_ndim = params.signal_ndim_;
+    // create descriptor with signal size
+    std::vector<MKL_LONG> mkl_signal_sizes(params.signal_sizes_, params.signal_sizes_ + signal_ndim);
+    descriptor_ = std::make_shared<DftiDescriptor>();
+    descriptor_->init(prec, signal_type, signal_ndim, mkl_signal_sizes.data());
+    auto desc = descriptor_->get();
+    // out of place FFT
+    MKL_DFTI_CHECK(DftiSetValue(desc, DFTI_PLACEMENT, DFTI_NOT_INPLACE));
+    // batch mode
+    MKL_DFTI_CHECK(DftiSetValue(desc, DFTI_NUMBER_OF_TRANSFORMS, (MKL_LONG) params.batch_));
+    // batch dim stride, i.e., dist between each data
+    MKL_DFTI_CHECK(DftiSetValue(desc, DFTI_INPUT_DISTANCE, (MKL_LONG) params.input_distance_));
+    MKL_DFTI_CHECK(DftiSetValue(desc, DFTI_OUTPUT_DISTANCE, (MKL_LONG) params.output_distance_));
+    // signal strides
+    // first val is offset, set to zero (ignored)
+    std::vector<MKL_LONG> mkl_istrides(1 + signal_ndim, 0), mkl_ostrides(1 + signal_ndim, 0);
+    for (int64_t i = 0; i < signal_ndim; i++) {
+      mkl_istrides[i + 1] = params.input_strides_[i];
+      mkl_ostrides[i + 1] = params.output_strides_[i];
+    }
+    MKL_DFTI_CHECK(DftiSetValue(desc, DFTI_INPUT_STRIDES, mkl_istrides.data()));
+    MKL_DFTI_CHECK(DftiSetValue(desc, DFTI_OUTPUT_STRIDES, mkl_ostrides.data()));
+    // if conjugate domain of real is involved, set standard CCE storage type
+    // this will become default in MKL in future
+    if (!params.complex_input_ || !params.complex_output_) {
+      MKL_DFTI_CHECK(DftiSetValue(desc, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX));
+    }
+    // rescale if needed by normalized flag or inverse transform
+    if (params.normalized_ || params.inverse_) {
+      int64_t signal_numel = 1;
+      for (int64_t i = 0; i < signal_ndim; i++) {
+        signal_numel *= params.signal_sizes_[i];
+      }
+      double double_scale;
+      if (params.normalized_) {
+        double_scale = 1.0 / std::sqrt(static_cast<double>(signal_numel));
+      } else {
+        double_scale = 1.0 / static_cast<double>(signal_numel);
+      }
+      MKL_DFTI_CHECK(DftiSetValue(desc,
+        params.inverse_ ? DFTI_BACKWARD_SCALE : DFTI_FORWARD_SCALE,
+        prec == DFTI_DOUBLE ? double_scale : static_cast<float>(double_scale)));
+    }
+    // finalize
+    MKL_DFTI_CHECK(DftiCommitDescriptor(desc));
+  }
+
+  const std::shared_ptr<DftiDescriptor>& descriptor() const { return descriptor_; }
+
+private:
+  std::shared_ptr<DftiDescriptor> descriptor_;
+};
+
+// The default is arbitrary, as for the cuFFT cache. Users can always
+// configure it via torch.backends.mkl.fft_plan_cache.max_size.
+constexpr size_t MKL_FFT_DEFAULT_CACHE_SIZE = 4096;
+
+// Like CuFFTParamsLRUCache in native/cuda/CuFFTPlanCache.h, this cache is
+// **NOT** thread-safe by itself. Hold its mutex while using it **AND** the
+// value returned from try_emplace_value.
+// The contract of using this cache is that try_emplace_value should only be
+// used when the max_size is positive.
+class MKLFFTParamsLRUCache {
+public:
+  using kv_t = typename std::pair<MKLFFTParams, MKLFFTConfig>;
+  using map_t = typename std::unordered_map<std::reference_wrapper<MKLFFTParams>,
+                                            typename std::list<kv_t>::iterator,
+                                            ParamsHash<MKLFFTParams>,
+                                            ParamsEqual<MKLFFTParams>>;
+  using map_kkv_iter_t = typename map_t::iterator;
+
+  MKLFFTParamsLRUCache() : MKLFFTParamsLRUCache(MKL_FFT_DEFAULT_CACHE_SIZE) {}
+
+  MKLFFTParamsLRUCache(int64_t max_size) {
+    _set_max_size(max_size);
+  }
+
+  // If key is in this cache, return the cached config. Otherwise, emplace the
+  // config in this cache using value_args and return it.
+  template<typename K, class ...VArgs>
+  const MKLFFTConfig &try_emplace_value(K&& key, VArgs&&... value_args) {
+    AT_ASSERT(_max_size > 0);
+
+    map_kkv_iter_t map_it = _cache_map.find(key);
+    // Hit, put to list front
+    if (map_it != _cache_map.end()) {
+      _usage_list.splice(_usage_list.begin(), _usage_list, map_it->second);
+      return map_it->second->second;
+    }
+
+    // Miss
+    // remove if needed
+    if (_usage_list.size() >= _max_size) {
+      auto last = _usage_list.end();
+      last--;
+      _cache_map.erase(last->first);
+      _usage_list.pop_back();
+    }
+
+    // construct new plan at list front, then insert into _cache_map
+    _usage_list.emplace_front(std::piecewise_construct,
+                       std::forward_as_tuple(key),
+                       std::forward_as_tuple(value_args...));
+    auto kv_it = _usage_list.begin();
+    _cache_map.emplace(std::piecewise_construct,
+                std::forward_as_tuple(kv_it->first),
+                std::forward_as_tuple(kv_it));
+    return kv_it->second;
+  }
+
+  void clear() {
+    _cache_map.clear();
+    _usage_list.clear();
+  }
+
+  void resize(int64_t new_size) {
+    _set_max_size(new_size);
+    auto cur_size = _usage_list.size();
+    if (cur_size > _max_size) {
+      auto delete_it = _usage_list.end();
+      for (size_t i = 0; i < cur_size - _max_size; i++) {
+        delete_it--;
+        _cache_map.erase(delete_it->first);
+      }
+      _usage_list.erase(delete_it, _usage_list.end());
+    }
+  }
+
+  size_t size() const { return _cache_map.size(); }
+
+  size_t max_size() const noexcept { return _max_size; }
+
+  std::mutex mutex;
+
+private:
+  // Only sets size and does value check. Does not resize the data structures.
+  void _set_max_size(int64_t new_size) {
+    TORCH_CHECK(new_size >= 0,
+             "MKL FFT plan cache size must be non-negative, but got ", new_size);
+    _max_size = static_cast<size_t>(new_size);
+  }
+
+  std::list<kv_t> _usage_list;
+  map_t _cache_map;
+  size_t _max_size;
+};
+
+}}} // namespace at::native::detail
@@ -1,8 +1,8 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/TensorIterator.h>
-#include <ATen/native/cpu/Loops.h>
-#include <c10/util/math_compat.h>
+#include <ATen/native/quantized/cpu/fake_quantize_core.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
 
 /* Core operations for fake-quantization shared between per tensor
  and per-channel fake quant */
@@ -27,18 +27,8 @@ void fake_quantize_slice(
     int64_t z_point,
     int64_t quant_min,
     int64_t quant_max) {
-  float inv_scale = 1.0f / sc;
-  auto iter = TensorIterator::unary_op(output, input);
-  cpu_kernel(iter, [&](float self) -> float {
-    return (std::fmin(
-                std::fmax(
-                    static_cast<int64_t>(
-                        std::nearbyint(self * inv_scale + z_point)),
-                    quant_min),
-                quant_max) -
-            z_point) *
-        sc;
-  });
+  fake_quant_tensor_stub(
+      input.device().type(), output, input, sc, z_point, quant_min, quant_max);
 }
 
 void fake_quantize_grad_slice(
@@ -49,13 +39,50 @@ void fake_quantize_grad_slice(
     int64_t z_point,
     int64_t quant_min,
     int64_t quant_max) {
-  float inv_scale = 1.0f / sc;
-  auto iter = TensorIterator::binary_op(input_grad, input, output_grad);
-  cpu_kernel(iter, [&](float x, float dy) -> float {
-    int64_t xq = static_cast<int64_t>(std::nearbyint(x * inv_scale + z_point));
-    return dy * (xq >= quant_min && xq <= quant_max);
-  });
+  fake_quant_grad_tensor_stub(
+      input.device().type(),
+      input_grad,
+      input,
+      output_grad,
+      sc,
+      z_point,
+      quant_min,
+      quant_max);
 }
 
+/* Fake quantize a tensor and record which elements fell inside
+ [quant_min, quant_max] in the same pass.
+Args:
+  output: output tensor.
+  mask: bool tensor, true where the gradient passes through.
+  input : input tensor.
+  sc:  scale to quantize the input tensor to
+  zero_point: zero_point
+  quant_min: minimum quantized value
+  quant_max: maximum quantized value
+*/
+void fake_quantize_cachemask_slice(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    float sc,
+    int64_t z_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  fake_quant_tensor_cachemask_stub(
+      input.device().type(),
+      output,
+      mask,
+      input,
+      sc,
+      z_point,
+      quant_min,
+      quant_max);
+}
+
+DEFINE_DISPATCH(fake_quant_tensor_stub);
+DEFINE_DISPATCH(fake_quant_grad_tensor_stub);
+DEFINE_DISPATCH(fake_quant_tensor_cachemask_stub);
+
 } // namespace native
 } // namespace at
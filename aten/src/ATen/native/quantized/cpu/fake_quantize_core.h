@@ -23,5 +23,14 @@ void fake_quantize_grad_slice(
     int64_t quant_min,
     int64_t quant_max);
 
+void fake_quantize_cachemask_slice(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    float sc,
+    int64_t z_point,
+    int64_t quant_min,
+    int64_t quant_max);
+
 } // namespace native
 } // namespace at
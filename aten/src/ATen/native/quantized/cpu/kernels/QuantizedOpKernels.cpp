@@ -1,5 +1,6 @@
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/UpSample.h>
 #include <ATen/native/cpu/Loops.h>
@@ -8,6 +9,7 @@
 #include <ATen/native/SortingUtils.h>
 
 #include <cmath>
+#include <cstring>
 
 namespace at {
 namespace native {
@@ -421,12 +423,13 @@ void qmaxpool_2d_nhwc_kernel(
     scalar_t* idata = static_cast<scalar_t*>(qx.data_ptr());
     scalar_t* odata = static_cast<scalar_t*>(qy.data_ptr());
 
-    // Loop over N
-    for (int64_t b = 0; b < qx.size(0); ++b) {
-      // Loop over H
-      auto* i_p =
-          reinterpret_cast<scalar_t::underlying*>(idata + b * iW * iH * iC);
-      for (int64_t row = 0; row < oH; ++row) {
+    // Output rows are independent, so split the N x oH rows across threads.
+    at::parallel_for(0, qx.size(0) * oH, 0, [&](int64_t begin, int64_t end) {
+      for (int64_t b_row = begin; b_row < end; ++b_row) {
+        const int64_t b = b_row / oH;
+        const int64_t row = b_row % oH;
+        auto* i_p =
+            reinterpret_cast<scalar_t::underlying*>(idata + b * iW * iH * iC);
         // Loop over W
         for (int64_t col = 0; col < oW; ++col) {
           // Pointer to output data for this specific N,H,W position
@@ -499,8 +502,8 @@ void qmaxpool_2d_nhwc_kernel(
             o_p[c] = max_val;
           } // for c
         } // for col
-      } // for row
-    } // for b
+      } // for b_row
+    });
   });
 }
 
@@ -524,6 +527,36 @@ void do_avg_pool_on_AVX2(
 #if defined(__AVX2__) && !defined(_MSC_VER)
   constexpr auto vec_width = Vec256<T>::size() / 4;
   if (vec_width == 8) {
+    // Interleaved 4x: one full Vec256<T> of 8-bit channels per iteration,
+    // widened into four int32 accumulators.
+    for (; c + 4 * vec_width <= channel_size; c += 4 * vec_width) {
+      Vec256<int32_t> acc(input_zero_point_m_size);
+      Vec256<int32_t> accs[4] = {acc, acc, acc, acc};
+      for (int64_t ih = hstart; ih < hend; ih++) {
+        for (int64_t iw = wstart; iw < wend; iw++) {
+          const auto* base = i_p +
+              (ih * stride_H + iw * stride_W) * channel_multiplier +
+              c * stride_D;
+          for (int i = 0; i < 4; ++i) {
+            accs[i] = accs[i] +
+                vec256::convert_to_int32<typename T::underlying>(
+                          base + i * vec_width * stride_D);
+          }
+        }
+      }
+      int32_t acc_int[4 * vec_width];
+      float acc_fp[4 * vec_width];
+      for (int i = 0; i < 4; ++i) {
+        accs[i].store(acc_int + i * vec_width);
+      }
+      vec256::convert(acc_int, acc_fp, 4 * vec_width);
+      at::quantize_vec<T>(
+          1.0f / multiplier,
+          output_zero_point,
+          acc_fp,
+          reinterpret_cast<T*>(o_p + c),
+          4 * vec_width);
+    }
     for (; c + vec_width <= channel_size; c += vec_width) {
       int64_t tcntr = 0;
 
@@ -811,13 +844,19 @@ void qupsample_bilinear2d_nhwc_kernel(
         const auto rwidth = area_pixel_compute_scale<float>(
             input_width, output_width, align_corners, scales_w);
 
-        for (int64_t b = 0; b < nbatch; ++b) {
-          auto* i_p = reinterpret_cast<typename scalar_t::underlying*>(
-              idata + b * input_height * input_width * channels);
-          auto* o_p = reinterpret_cast<typename scalar_t::underlying*>(
-              odata + b * output_height * output_width * channels);
+        at::parallel_for(
+            0,
+            nbatch * output_height,
+            0,
+            [&](int64_t begin, int64_t end) {
+          for (int64_t b_h2 = begin; b_h2 < end; ++b_h2) {
+            const int64_t b = b_h2 / output_height;
+            const int64_t h2 = b_h2 % output_height;
+            auto* i_p = reinterpret_cast<typename scalar_t::underlying*>(
+                idata + b * input_height * input_width * channels);
+            auto* o_p = reinterpret_cast<typename scalar_t::underlying*>(
+                odata + b * output_height * output_width * channels);
 
-          for (int64_t h2 = 0; h2 < output_height; ++h2) {
             const auto h1r = area_pixel_compute_source_index<float>(
                 rheight, h2, align_corners, /*cubic=*/false);
 
@@ -877,8 +916,8 @@ void qupsample_bilinear2d_nhwc_kernel(
                 pos2 += 1;
               } // c
             } // w2
-          } // h2
-        } // b
+          } // b_h2
+        });
       });
 }
 
@@ -955,6 +994,507 @@ void qtopk_kernel(Tensor& values,
   });
 }
 
+// Fake quantizes a float tensor:
+//   out = (clamp(round(x / sc + z_point), quant_min, quant_max) - z_point) * sc
+// The scalar path keeps the historical rounding (nearbyint on x * inv_scale +
+// z_point) so the vectorized and tail elements agree bit for bit.
+void fake_quantize_tensor_kernel(
+    Tensor& output,
+    const Tensor& input,
+    float sc,
+    int64_t z_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  float inv_scale = 1.0f / sc;
+  using Vec = Vec256<float>;
+  auto inv_scale_vec = Vec(inv_scale);
+  auto scale_vec = Vec(sc);
+  auto zero_point_vec = Vec(static_cast<float>(z_point));
+  auto quant_min_vec = Vec(static_cast<float>(quant_min));
+  auto quant_max_vec = Vec(static_cast<float>(quant_max));
+  auto iter = TensorIterator::unary_op(output, input);
+  cpu_kernel_vec(
+      iter,
+      [&](float self) -> float {
+        return (std::fmin(
+                    std::fmax(
+                        static_cast<int64_t>(
+                            std::nearbyint(self * inv_scale + z_point)),
+                        quant_min),
+                    quant_max) -
+                z_point) *
+            sc;
+      },
+      [&](Vec self) -> Vec {
+        auto xq = (self * inv_scale_vec + zero_point_vec).round();
+        return (vec256::clamp(xq, quant_min_vec, quant_max_vec) -
+                zero_point_vec) *
+            scale_vec;
+      });
+}
+
+// Straight-through estimator: the gradient passes where the rounded input
+// lies inside [quant_min, quant_max] and is zero elsewhere.
+void fake_quantize_grad_tensor_kernel(
+    Tensor& input_grad,
+    const Tensor& input,
+    const Tensor& output_grad,
+    float sc,
+    int64_t z_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  float inv_scale = 1.0f / sc;
+  using Vec = Vec256<float>;
+  auto inv_scale_vec = Vec(inv_scale);
+  auto zero_point_vec = Vec(static_cast<float>(z_point));
+  auto quant_min_vec = Vec(static_cast<float>(quant_min));
+  auto quant_max_vec = Vec(static_cast<float>(quant_max));
+  auto zero_vec = Vec(0.0f);
+  auto iter = TensorIterator::binary_op(input_grad, input, output_grad);
+  cpu_kernel_vec(
+      iter,
+      [&](float x, float dy) -> float {
+        int64_t xq =
+            static_cast<int64_t>(std::nearbyint(x * inv_scale + z_point));
+        return dy * (xq >= quant_min && xq <= quant_max);
+      },
+      [&](Vec x, Vec dy) -> Vec {
+        auto xq = (x * inv_scale_vec + zero_point_vec).round();
+        auto dx = Vec::blendv(zero_vec, dy, xq >= quant_min_vec);
+        return Vec::blendv(zero_vec, dx, xq <= quant_max_vec);
+      });
+}
+
+// Forward fake quantization that also writes the straight-through mask, so
+// the backward pass is a masked copy of the gradient instead of a second
+// quantization of the saved input.
+void fake_quantize_tensor_cachemask_kernel(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    float sc,
+    int64_t z_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  float inv_scale = 1.0f / sc;
+  using Vec = Vec256<float>;
+  auto inv_scale_vec = Vec(inv_scale);
+  auto scale_vec = Vec(sc);
+  auto zero_point_vec = Vec(static_cast<float>(z_point));
+  auto quant_min_vec = Vec(static_cast<float>(quant_min));
+  auto quant_max_vec = Vec(static_cast<float>(quant_max));
+  auto zero_vec = Vec(0.0f);
+  auto one_vec = Vec(1.0f);
+
+  auto iter = TensorIterator();
+  iter.add_output(output);
+  iter.add_output(mask);
+  iter.add_input(input);
+  iter.dont_compute_common_dtype();
+  iter.build();
+
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    int64_t i = 0;
+    if (strides[0] == sizeof(float) && strides[1] == sizeof(bool) &&
+        strides[2] == sizeof(float)) {
+      float* out_ptr = reinterpret_cast<float*>(data[0]);
+      bool* mask_ptr = reinterpret_cast<bool*>(data[1]);
+      const float* in_ptr = reinterpret_cast<const float*>(data[2]);
+      float mask_buf[Vec::size()];
+      for (; i + Vec::size() <= n; i += Vec::size()) {
+        auto xq = (Vec::loadu(in_ptr + i) * inv_scale_vec + zero_point_vec)
+                      .round();
+        ((vec256::clamp(xq, quant_min_vec, quant_max_vec) - zero_point_vec) *
+         scale_vec)
+            .store(out_ptr + i);
+        auto m = Vec::blendv(zero_vec, one_vec, xq >= quant_min_vec);
+        Vec::blendv(zero_vec, m, xq <= quant_max_vec).store(mask_buf);
+        for (int64_t j = 0; j < Vec::size(); ++j) {
+          mask_ptr[i + j] = mask_buf[j] != 0.0f;
+        }
+      }
+    }
+    for (; i < n; ++i) {
+      float x = *reinterpret_cast<float*>(data[2] + i * strides[2]);
+      int64_t xq =
+          static_cast<int64_t>(std::nearbyint(x * inv_scale + z_point));
+      *reinterpret_cast<float*>(data[0] + i * strides[0]) =
+          (std::min(std::max(xq, quant_min), quant_max) - z_point) * sc;
+      *reinterpret_cast<bool*>(data[1] + i * strides[1]) =
+          xq >= quant_min && xq <= quant_max;
+    }
+  });
+}
+
+#if defined(__AVX2__) && !defined(_MSC_VER)
+// Spreads the bit_rate-bit codes in the low bytes of `packed` out to one code
+// per byte, lowest bits first, so that they line up with the row's columns.
+template <int bit_rate>
+inline __m128i unpack_codes_epi8(__m128i packed);
+
+template <>
+inline __m128i unpack_codes_epi8<4>(__m128i packed) {
+  const __m128i mask = _mm_set1_epi8(0x0f);
+  const __m128i lo = _mm_and_si128(packed, mask);
+  const __m128i hi = _mm_and_si128(_mm_srli_epi16(packed, 4), mask);
+  return _mm_unpacklo_epi8(lo, hi);
+}
+
+template <>
+inline __m128i unpack_codes_epi8<2>(__m128i packed) {
+  const __m128i mask = _mm_set1_epi8(0x03);
+  const __m128i c0 = _mm_and_si128(packed, mask);
+  const __m128i c1 = _mm_and_si128(_mm_srli_epi16(packed, 2), mask);
+  const __m128i c2 = _mm_and_si128(_mm_srli_epi16(packed, 4), mask);
+  const __m128i c3 = _mm_and_si128(_mm_srli_epi16(packed, 6), mask);
+  return _mm_unpacklo_epi16(
+      _mm_unpacklo_epi8(c0, c1), _mm_unpacklo_epi8(c2, c3));
+}
+
+template <int bit_rate>
+inline __m128i load_codes_epi8(const uint8_t* row, int64_t num_codes) {
+  uint64_t bits = 0;
+  std::memcpy(&bits, row, num_codes * bit_rate / 8);
+  return unpack_codes_epi8<bit_rate>(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&bits)));
+}
+#endif
+
+// out[j] += scale * q[j] + bias over the block_size codes of one row. Codes
+// are packed lowest bits first, 8 / bit_rate per byte.
+template <int bit_rate>
+void qembedding_bag_nbit_accumulate_row(
+    const uint8_t* row,
+    int64_t block_size,
+    float scale,
+    float bias,
+    float* out) {
+  constexpr int64_t codes_per_byte = 8 / bit_rate;
+  constexpr uint8_t code_mask = (1 << bit_rate) - 1;
+  int64_t j = 0;
+#if defined(__AVX512F__) && !defined(_MSC_VER)
+  {
+    const __m512 vscale = _mm512_set1_ps(scale);
+    const __m512 vbias = _mm512_set1_ps(bias);
+    for (; j + 16 <= block_size; j += 16) {
+      const __m512 q = _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+          load_codes_epi8<bit_rate>(row + j / codes_per_byte, 16)));
+      _mm512_storeu_ps(
+          out + j,
+          _mm512_add_ps(
+              _mm512_fmadd_ps(q, vscale, vbias), _mm512_loadu_ps(out + j)));
+    }
+  }
+#endif
+#if defined(__AVX2__) && !defined(_MSC_VER)
+  {
+    const __m256 vscale = _mm256_set1_ps(scale);
+    const __m256 vbias = _mm256_set1_ps(bias);
+    for (; j + 8 <= block_size; j += 8) {
+      const __m256 q = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(
+          load_codes_epi8<bit_rate>(row + j / codes_per_byte, 8)));
+      _mm256_storeu_ps(
+          out + j,
+          _mm256_add_ps(
+              _mm256_fmadd_ps(q, vscale, vbias), _mm256_loadu_ps(out + j)));
+    }
+  }
+#endif
+  for (; j < block_size; ++j) {
+    const uint8_t q =
+        (row[j / codes_per_byte] >> ((j % codes_per_byte) * bit_rate)) &
+        code_mask;
+    out[j] += scale * q + bias;
+  }
+}
+
+template <int bit_rate>
+void qembedding_bag_nbit_impl(
+    int64_t block_size,
+    int64_t num_rows,
+    const uint8_t* weight,
+    const int64_t* indices,
+    const int64_t* offsets,
+    int64_t num_bags,
+    const float* per_sample_weights,
+    bool normalize_by_lengths,
+    float* out) {
+  constexpr int64_t codes_per_byte = 8 / bit_rate;
+  const int64_t packed_cols = block_size / codes_per_byte;
+  const int64_t row_bytes = packed_cols + 2 * sizeof(at::Half);
+  for (int64_t bag = 0; bag < num_bags; ++bag) {
+    float* bag_out = out + bag * block_size;
+    std::fill(bag_out, bag_out + block_size, 0.0f);
+    const int64_t begin = offsets[bag];
+    const int64_t end = offsets[bag + 1];
+    for (int64_t i = begin; i < end; ++i) {
+      const int64_t idx = indices[i];
+      TORCH_CHECK(
+          idx >= 0 && idx < num_rows,
+          "embedding_bag: index ", idx, " is out of range for ", num_rows,
+          " rows");
+      const uint8_t* row = weight + idx * row_bytes;
+      const at::Half* scale_bias =
+          reinterpret_cast<const at::Half*>(row + packed_cols);
+      const float weight_i = per_sample_weights ? per_sample_weights[i] : 1.0f;
+      qembedding_bag_nbit_accumulate_row<bit_rate>(
+          row,
+          block_size,
+          weight_i * static_cast<float>(scale_bias[0]),
+          weight_i * static_cast<float>(scale_bias[1]),
+          bag_out);
+    }
+    if (normalize_by_lengths && end > begin) {
+      const float inverse_length = 1.0f / (end - begin);
+      for (int64_t j = 0; j < block_size; ++j) {
+        bag_out[j] *= inverse_length;
+      }
+    }
+  }
+}
+
+void qembedding_bag_nbit_kernel(
+    int64_t bit_rate,
+    int64_t block_size,
+    int64_t num_rows,
+    const uint8_t* weight,
+    const int64_t* indices,
+    const int64_t* offsets,
+    int64_t num_bags,
+    const float* per_sample_weights,
+    bool normalize_by_lengths,
+    float* out) {
+  switch (bit_rate) {
+    case 4:
+      qembedding_bag_nbit_impl<4>(
+          block_size, num_rows, weight, indices, offsets, num_bags,
+          per_sample_weights, normalize_by_lengths, out);
+      break;
+    case 2:
+      qembedding_bag_nbit_impl<2>(
+          block_size, num_rows, weight, indices, offsets, num_bags,
+          per_sample_weights, normalize_by_lengths, out);
+      break;
+    default:
+      TORCH_CHECK(false, "embedding_bag: unsupported bit rate ", bit_rate);
+  }
+}
+
+// Mean and variance of the codes of one layer_norm row. int32 codes are
+// accumulated in double.
+void qlayer_norm_row_moments(
+    const int32_t* x,
+    int64_t N,
+    double& mean,
+    double& var) {
+  double sum = 0;
+  double sumsq = 0;
+  for (int64_t j = 0; j < N; ++j) {
+    sum += x[j];
+    sumsq += static_cast<double>(x[j]) * x[j];
+  }
+  mean = sum / N;
+  var = std::max(sumsq / N - mean * mean, 0.0);
+}
+
+// 8-bit codes are summed exactly in integers, 8 lanes at a time.
+template <typename underlying_t>
+void qlayer_norm_row_moments(
+    const underlying_t* x,
+    int64_t N,
+    double& mean,
+    double& var) {
+  int64_t sum = 0;
+  int64_t sumsq = 0;
+  int64_t j = 0;
+#if defined(__AVX2__) && !defined(_MSC_VER)
+  // An int32 lane holds 32768 squares of 8-bit codes before it can overflow.
+  constexpr int64_t kLaneIters = 32768;
+  constexpr int64_t kLanes = Vec256<int32_t>::size();
+  while (j + kLanes <= N) {
+    const int64_t chunk_end =
+        j + std::min((N - j) / kLanes, kLaneIters) * kLanes;
+    Vec256<int32_t> sum_vec(0);
+    Vec256<int32_t> sumsq_vec(0);
+    for (; j < chunk_end; j += kLanes) {
+      const auto v = vec256::convert_to_int32<underlying_t>(x + j);
+      sum_vec = sum_vec + v;
+      sumsq_vec = sumsq_vec + v * v;
+    }
+    int32_t sum_lanes[kLanes];
+    int32_t sumsq_lanes[kLanes];
+    sum_vec.store(sum_lanes);
+    sumsq_vec.store(sumsq_lanes);
+    for (int64_t k = 0; k < kLanes; ++k) {
+      sum += sum_lanes[k];
+      sumsq += sumsq_lanes[k];
+    }
+  }
+#endif
+  for (; j < N; ++j) {
+    sum += x[j];
+    sumsq += static_cast<int64_t>(x[j]) * x[j];
+  }
+  mean = static_cast<double>(sum) / N;
+  var = std::max(
+      (static_cast<double>(sumsq) - static_cast<double>(sum) * mean) / N, 0.0);
+}
+
+void qlayer_norm_kernel(
+    const Tensor& X,
+    int64_t M,
+    int64_t N,
+    const Tensor& gamma,
+    const Tensor& beta,
+    double eps,
+    Tensor& Y) {
+  AT_DISPATCH_QINT_TYPES(X.scalar_type(), "qlayer_norm", [&]() {
+    using Vec = Vec256<scalar_t>;
+    using fVec = Vec256<float>;
+    using underlying_t = typename scalar_t::underlying;
+    const double x_scale = X.q_scale();
+    const float y_scale = Y.q_scale();
+    const int64_t y_zero_point = Y.q_zero_point();
+    const float y_inverse_scale = 1.0f / y_scale;
+    const float* gamma_data = gamma.defined() ? gamma.data_ptr<float>() : nullptr;
+    const float* beta_data = beta.defined() ? beta.data_ptr<float>() : nullptr;
+    const scalar_t* X_data = X.data_ptr<scalar_t>();
+    scalar_t* Y_data = Y.data_ptr<scalar_t>();
+
+    at::parallel_for(0, M, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; ++i) {
+        const scalar_t* x = X_data + i * N;
+        scalar_t* y = Y_data + i * N;
+        double mean_q;
+        double var_q;
+        qlayer_norm_row_moments(
+            reinterpret_cast<const underlying_t*>(x), N, mean_q, var_q);
+        // The zero point cancels out of x - mean, so in terms of the codes
+        // x_hat = scale * rstd * (q - mean_q).
+        const float a =
+            x_scale / std::sqrt(x_scale * x_scale * var_q + eps);
+        const float shift = mean_q;
+        const fVec a_vec(a);
+        const fVec shift_vec(shift);
+        const fVec a_neg_shift_premul_vec(-a * shift);
+
+        int64_t j = 0;
+        for (; j + Vec::size() <= N; j += Vec::size()) {
+          auto x_hat = Vec::loadu(x + j).dequantize(
+              a_vec, shift_vec, a_neg_shift_premul_vec);
+          for (int k = 0; k < x_hat.size(); ++k) {
+            const int64_t c = j + k * fVec::size();
+            if (gamma_data) {
+              x_hat[k] = x_hat[k] * fVec::loadu(gamma_data + c);
+            }
+            if (beta_data) {
+              x_hat[k] = x_hat[k] + fVec::loadu(beta_data + c);
+            }
+          }
+          Vec::quantize(x_hat, y_scale, y_zero_point, y_inverse_scale)
+              .store(y + j);
+        }
+        for (; j < N; ++j) {
+          float x_hat = a * (x[j].val_ - shift);
+          if (gamma_data) {
+            x_hat *= gamma_data[j];
+          }
+          if (beta_data) {
+            x_hat += beta_data[j];
+          }
+          y[j] = at::quantize_val<scalar_t>(y_scale, y_zero_point, x_hat);
+        }
+      }
+    });
+  });
+}
+
+// Softmax over lines of dim_size codes that are `inner` apart. With 8-bit
+// codes q - max(q) takes at most 256 values, so the exponentials come from
+// exp_table and only the integer max and the sum are computed per line.
+template <typename scalar_t>
+void qsoftmax_impl(
+    const Tensor& qx,
+    int64_t outer,
+    int64_t dim_size,
+    int64_t inner,
+    const float* exp_table,
+    Tensor& qy) {
+  using Vec = Vec256<scalar_t>;
+  using underlying_t = typename scalar_t::underlying;
+  const scalar_t* x_data = qx.data_ptr<scalar_t>();
+  scalar_t* y_data = qy.data_ptr<scalar_t>();
+  const double y_scale = qy.q_scale();
+  const int64_t y_zero_point = qy.q_zero_point();
+
+  at::parallel_for(0, outer * inner, 1, [&](int64_t begin, int64_t end) {
+    std::vector<float> exp_values(dim_size);
+    for (int64_t line = begin; line < end; ++line) {
+      const int64_t base = (line / inner) * dim_size * inner + line % inner;
+      const scalar_t* x = x_data + base;
+      scalar_t* y = y_data + base;
+
+      int32_t max_q = std::numeric_limits<underlying_t>::lowest();
+      int64_t k = 0;
+      if (inner == 1 && dim_size >= Vec::size()) {
+        auto max_vec = Vec::loadu(x);
+        for (k = Vec::size(); k + Vec::size() <= dim_size; k += Vec::size()) {
+          max_vec = max_vec.maximum(Vec::loadu(x + k));
+        }
+        underlying_t lanes[Vec::size()];
+        max_vec.store(lanes);
+        for (int64_t l = 0; l < Vec::size(); ++l) {
+          max_q = std::max<int32_t>(max_q, lanes[l]);
+        }
+      }
+      for (; k < dim_size; ++k) {
+        max_q = std::max<int32_t>(max_q, x[k * inner].val_);
+      }
+
+      float sum = 0;
+      for (k = 0; k < dim_size; ++k) {
+        exp_values[k] = exp_table[max_q - x[k * inner].val_];
+        sum += exp_values[k];
+      }
+      // Dividing by the sum is folded into the output scale.
+      if (inner == 1) {
+        at::quantize_vec<scalar_t>(
+            y_scale * sum, y_zero_point, exp_values.data(), y, dim_size);
+      } else {
+        for (k = 0; k < dim_size; ++k) {
+          y[k * inner] = at::quantize_val<scalar_t>(
+              y_scale * sum, y_zero_point, exp_values[k]);
+        }
+      }
+    }
+  });
+}
+
+void qsoftmax_kernel(const Tensor& qx, int64_t dim, Tensor& qy) {
+  int64_t outer = 1;
+  int64_t inner = 1;
+  for (int64_t d = 0; d < dim; ++d) {
+    outer *= qx.size(d);
+  }
+  for (int64_t d = dim + 1; d < qx.dim(); ++d) {
+    inner *= qx.size(d);
+  }
+  const int64_t dim_size = qx.size(dim);
+  float exp_table[256];
+  const float x_scale = qx.q_scale();
+  for (int d = 0; d < 256; ++d) {
+    exp_table[d] = std::exp(-x_scale * d);
+  }
+  if (qx.scalar_type() == kQUInt8) {
+    qsoftmax_impl<c10::quint8>(qx, outer, dim_size, inner, exp_table, qy);
+  } else {
+    TORCH_CHECK(
+        qx.scalar_type() == kQInt8,
+        "quantized::softmax: expected a quint8 or qint8 input");
+    qsoftmax_impl<c10::qint8>(qx, outer, dim_size, inner, exp_table, qy);
+  }
+}
+
 } // namespace
 
 REGISTER_DISPATCH(qrelu_stub, &qrelu_kernel);
@@ -975,6 +1515,16 @@ REGISTER_DISPATCH(
 REGISTER_DISPATCH(qcat_nhwc_stub, &qcat_nhwc_kernel<false>);
 REGISTER_DISPATCH(qcat_relu_nhwc_stub, &qcat_nhwc_kernel<true>);
 REGISTER_DISPATCH(qtopk_stub, &qtopk_kernel);
+REGISTER_DISPATCH(fake_quant_tensor_stub, &fake_quantize_tensor_kernel);
+REGISTER_DISPATCH(
+    fake_quant_grad_tensor_stub,
+    &fake_quantize_grad_tensor_kernel);
+REGISTER_DISPATCH(
+    fake_quant_tensor_cachemask_stub,
+    &fake_quantize_tensor_cachemask_kernel);
+REGISTER_DISPATCH(qembedding_bag_nbit_stub, &qembedding_bag_nbit_kernel);
+REGISTER_DISPATCH(qlayer_norm_stub, &qlayer_norm_kernel);
+REGISTER_DISPATCH(qsoftmax_stub, &qsoftmax_kernel);
 
 } // namespace native
 } // namespace at
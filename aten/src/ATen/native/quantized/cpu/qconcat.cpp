@@ -17,14 +17,18 @@ DEFINE_DISPATCH(qcat_relu_nhwc_stub);
 
 namespace {
 
-bool is_cat_nhwc_fast_path(const c10::List<Tensor>& qxs, int dim) {
+bool is_cat_channels_last(const c10::List<Tensor>& qxs) {
   TORCH_CHECK(qxs.size() > 0);
-  bool is_fast_path = dim == 1;
+  bool channels_last = true;
   for (const at::Tensor& qx : qxs) {
-    is_fast_path &= qx.dim() == 4;
-    is_fast_path &= qx.is_contiguous(c10::MemoryFormat::ChannelsLast);
+    channels_last &= qx.dim() == 4;
+    channels_last &= qx.is_contiguous(c10::MemoryFormat::ChannelsLast);
   }
-  return is_fast_path;
+  return channels_last;
+}
+
+bool is_cat_nhwc_fast_path(const c10::List<Tensor>& qxs, int dim) {
+  return dim == 1 && is_cat_channels_last(qxs);
 }
 
 bool is_valid_quantization_scheme(const Tensor& t) {
@@ -71,6 +75,11 @@ Tensor quantized_cat_impl(
       });
     }
   });
+  // Keep channels-last inputs channels-last so the next NHWC kernel (e.g. an
+  // FBGEMM conv) does not have to re-layout the result.
+  if (is_cat_channels_last(qxs)) {
+    qy = qy.contiguous(MemoryFormat::ChannelsLast);
+  }
   return qy;
 }
 
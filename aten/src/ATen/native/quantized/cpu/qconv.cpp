@@ -7,8 +7,12 @@
 #include <ATen/SmallVector.h>
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
+#include <ATen/cpu/vec256/vec256.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/native/quantized/cpu/qengine_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
+#include <ATen/quantized/Quantizer.h>
 #include <caffe2/utils/threadpool/ThreadPoolMobile.h>
 
 namespace at {
@@ -80,6 +84,107 @@ SmallVector<int64_t, 5> MakeConvOutputShape<3>(
           output_image_shape[2]};
 }
 
+// Output pipeline stage chained after fbgemm::ReQuantizeOutput for
+// quantized::conv2d_add_relu. Every block of the conv output is requantized
+// to the conv scale first, then added to the same block of the residual and
+// clamped at zero while it is still in cache, which matches running
+// quantized::conv2d followed by quantized::add_relu.
+class ResidualAddReLU {
+ public:
+  using outType = std::uint8_t;
+  using inpType = std::uint8_t;
+
+  ResidualAddReLU() {}
+
+  ResidualAddReLU(
+      const Tensor& accum_nhwc,
+      double conv_scale,
+      int64_t conv_zero_point,
+      double output_scale,
+      int64_t output_zero_point)
+      : accum_(&accum_nhwc),
+        conv_scale_(conv_scale),
+        conv_zero_point_(conv_zero_point),
+        accum_scale_(accum_nhwc.q_scale()),
+        accum_zero_point_(accum_nhwc.q_zero_point()),
+        output_scale_(output_scale),
+        output_zero_point_(output_zero_point) {}
+
+  // Called once the conv output is allocated, before any block is computed.
+  void Bind(const Tensor& output) {
+    TORCH_CHECK(
+        accum_->sizes() == output.sizes(),
+        "quantized::conv2d_add_relu: expected the residual to have the conv "
+        "output shape ",
+        output.sizes(),
+        ", but got ",
+        accum_->sizes());
+    accum_data_ =
+        reinterpret_cast<const uint8_t*>(accum_->data_ptr<c10::quint8>());
+  }
+
+  template <fbgemm::inst_set_t instSet>
+  int f(
+      outType* out,
+      inpType* /* inp */,
+      const fbgemm::block_type_t& block,
+      int ld_out,
+      int /* ld_in */) const {
+    using namespace vec256;
+    using Vec = Vec256<c10::quint8>;
+    const auto conv_scale_vec = Vec256<float>(conv_scale_);
+    const auto conv_zp_vec = Vec256<float>(static_cast<float>(conv_zero_point_));
+    const auto conv_premul_vec = conv_scale_vec * conv_zp_vec.neg();
+    const auto accum_scale_vec = Vec256<float>(accum_scale_);
+    const auto accum_zp_vec = Vec256<float>(static_cast<float>(accum_zero_point_));
+    const auto accum_premul_vec = accum_scale_vec * accum_zp_vec.neg();
+    const float inv_scale = 1.0f / output_scale_;
+    for (int i = block.row_start; i < block.row_start + block.row_size; ++i) {
+      auto* out_row = reinterpret_cast<c10::quint8*>(
+          out + static_cast<int64_t>(i) * ld_out + block.col_start);
+      const auto* accum_row = reinterpret_cast<const c10::quint8*>(
+          accum_data_ + static_cast<int64_t>(i) * ld_out + block.col_start);
+      int j = 0;
+      for (; j + Vec::size() <= block.col_size; j += Vec::size()) {
+        const auto dc = Vec::loadu(out_row + j)
+                            .dequantize(conv_scale_vec, conv_zp_vec, conv_premul_vec);
+        const auto da = Vec::loadu(accum_row + j)
+                            .dequantize(accum_scale_vec, accum_zp_vec, accum_premul_vec);
+        Vec::float_vec_return_type sums;
+        for (int k = 0; k < Vec::float_num_vecs(); ++k) {
+          sums[k] = maximum(dc[k] + da[k], Vec256<float>(0.0f));
+        }
+        Vec::quantize(sums, output_scale_, output_zero_point_, inv_scale)
+            .store(out_row + j);
+      }
+      for (; j < block.col_size; ++j) {
+        const float sum =
+            at::dequantize_val(conv_scale_, conv_zero_point_, out_row[j]) +
+            at::dequantize_val(accum_scale_, accum_zero_point_, accum_row[j]);
+        out_row[j] = at::quantize_val<c10::quint8>(
+            output_scale_, output_zero_point_, std::max(sum, 0.0f));
+      }
+    }
+    return 0;
+  }
+
+ private:
+  const Tensor* accum_ = nullptr;
+  const uint8_t* accum_data_ = nullptr;
+  float conv_scale_ = 1.0f;
+  int64_t conv_zero_point_ = 0;
+  float accum_scale_ = 1.0f;
+  int64_t accum_zero_point_ = 0;
+  float output_scale_ = 1.0f;
+  int64_t output_zero_point_ = 0;
+};
+
+inline void BindConvOutput(fbgemm::DoNothing<>& /* next_op */, const Tensor& /* output */) {}
+
+inline void BindConvOutput(ResidualAddReLU& next_op, const Tensor& output) {
+  next_op.Bind(output);
+}
+
 #endif // USE_FBGEMM
 
 #ifdef USE_PYTORCH_QNNPACK
@@ -164,6 +269,8 @@ SmallVector<int64_t, 5> MakeConvOutputShape<3>(
  * is 32767.
  *
  */
+class QConvAddReLUInt8;
+
 template <int kSpatialDim, bool kReluFused>
 class QConvInt8 final : public c10::OperatorKernel {
  public:
@@ -176,10 +283,11 @@ class QConvInt8 final : public c10::OperatorKernel {
       int64_t groups,
       double output_scale,
       int64_t output_zero_point) {
-    auto& ctx = at::globalContext();
+    const auto engine =
+        qengine_utils::convPackedEngine<kSpatialDim>(packed_weight);
 
 #ifdef USE_FBGEMM
-    if (ctx.qEngine() == at::QEngine::FBGEMM) {
+    if (engine == at::QEngine::FBGEMM) {
       return FbgemmConv(
           act,
           packed_weight,
@@ -193,7 +301,7 @@ class QConvInt8 final : public c10::OperatorKernel {
 #endif // USE_FBGEMM
 
 #ifdef USE_PYTORCH_QNNPACK
-    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+    if (engine == at::QEngine::QNNPACK) {
       TORCH_CHECK(kSpatialDim == 2, "QNNPACK only suuports Conv2d now.");
       return QnnpackConv(
           act,
@@ -210,10 +318,12 @@ class QConvInt8 final : public c10::OperatorKernel {
     TORCH_CHECK(
         false,
         "Didn't find engine for operation quantized::conv ",
-        toString(ctx.qEngine()));
+        toString(engine));
   }
 
  private:
+  friend class QConvAddReLUInt8;
+
 #ifdef USE_FBGEMM
   static const float* GetBiasData(
       const PackedConvWeight<kSpatialDim>& pack_data,
@@ -256,6 +366,9 @@ class QConvInt8 final : public c10::OperatorKernel {
     }
   }
 
+  // next_op runs on every requantized block of the output, see
+  // ResidualAddReLU.
+  template <typename NextOp = fbgemm::DoNothing<>>
   at::Tensor FbgemmConv(
       Tensor act,
       Tensor packed_weight,
@@ -264,7 +377,8 @@ class QConvInt8 final : public c10::OperatorKernel {
       torch::List<int64_t> dilation,
       int64_t groups,
       double output_scale,
-      int64_t output_zero_point) {
+      int64_t output_zero_point,
+      NextOp next_op = NextOp()) {
     // Quantized kernels are all written with NHWC (channels last) layout in
     // mind. Ideally, we'd be compatible with conv2d behavior and preserve the
     // inputs layout as is (doing necessary upconversions).
@@ -432,18 +546,22 @@ class QConvInt8 final : public c10::OperatorKernel {
               device(kCPU).dtype(kQUInt8),
               output_scale,
               output_zero_point);
+    BindConvOutput(next_op, output);
     Tensor buffer = at::empty(output.sizes(), output.options().dtype(at::kInt));
     const int num_tasks = at::get_num_threads();
     at::parallel_for(0, num_tasks, 1, [&](int64_t begin, int64_t end) {
-      fbgemm::DoNothing<> kNoOpObj{};
+      NextOp task_next_op = next_op;
       for (int task_id = begin; task_id < end; ++task_id) {
         if (pack_data.q_scheme == kPerTensorAffine) {
           fbgemm::ReQuantizeOutput<
               kReluFused,
               fbgemm::QuantizationGranularity::TENSOR,
-              float>
+              float,
+              std::uint8_t,
+              std::int32_t,
+              NextOp>
               output_proc_obj(
-                  kNoOpObj,
+                  task_next_op,
                   output_multiplier_float.data(),
                   output_zero_point,
                   act_zero_point,
@@ -467,9 +585,12 @@ class QConvInt8 final : public c10::OperatorKernel {
           fbgemm::ReQuantizeOutput<
               kReluFused,
               fbgemm::QuantizationGranularity::OUT_CHANNEL,
-              float>
+              float,
+              std::uint8_t,
+              std::int32_t,
+              NextOp>
               output_proc_obj(
-                  kNoOpObj,
+                  task_next_op,
                   output_multiplier_float.data(),
                   output_zero_point,
                   act_zero_point,
@@ -637,6 +758,85 @@ class QConvInt8 final : public c10::OperatorKernel {
 #endif
 };
 
+// Residual block tail: relu(conv2d(act) + accum). The conv result is
+// requantized to (conv_scale, conv_zero_point) before the add, as in the
+// unfused quantized::conv2d -> quantized::add_relu sequence it replaces.
+class QConvAddReLUInt8 final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(
+      Tensor act,
+      Tensor packed_weight,
+      Tensor accum,
+      torch::List<int64_t> stride,
+      torch::List<int64_t> padding,
+      torch::List<int64_t> dilation,
+      int64_t groups,
+      double conv_scale,
+      int64_t conv_zero_point,
+      double output_scale,
+      int64_t output_zero_point) {
+    TORCH_CHECK(
+        accum.qscheme() == kPerTensorAffine && accum.scalar_type() == kQUInt8,
+        "quantized::conv2d_add_relu: expected a per tensor affine quint8 "
+        "residual");
+    QConvInt8<2, false> conv;
+
+#ifdef USE_FBGEMM
+    // Depthwise and groupwise convolutions take FBGEMM fast paths that
+    // requantize directly and skip the chained output stage, so only
+    // groups == 1 is fused into the conv.
+    if (qengine_utils::convPackedEngine<2>(packed_weight) ==
+            at::QEngine::FBGEMM &&
+        groups == 1) {
+      const Tensor accum_nhwc = accum.contiguous(MemoryFormat::ChannelsLast);
+      Tensor output = conv.FbgemmConv(
+          act,
+          packed_weight,
+          stride,
+          padding,
+          dilation,
+          groups,
+          conv_scale,
+          conv_zero_point,
+          ResidualAddReLU(
+              accum_nhwc,
+              conv_scale,
+              conv_zero_point,
+              output_scale,
+              output_zero_point));
+      output.set_quantizer_(make_per_tensor_affine_quantizer(
+          output_scale, output_zero_point, kQUInt8));
+      return output;
+    }
+#endif // USE_FBGEMM
+
+    Tensor conv_output = conv(
+        act,
+        packed_weight,
+        stride,
+        padding,
+        dilation,
+        groups,
+        conv_scale,
+        conv_zero_point);
+    TORCH_CHECK(
+        accum.sizes() == conv_output.sizes(),
+        "quantized::conv2d_add_relu: expected the residual to have the conv "
+        "output shape ",
+        conv_output.sizes(),
+        ", but got ",
+        accum.sizes());
+    Tensor output = at::_empty_affine_quantized(
+        conv_output.sizes(),
+        at::device(kCPU).dtype(kQUInt8),
+        output_scale,
+        output_zero_point,
+        MemoryFormat::ChannelsLast);
+    qadd_relu_stub(kCPU, output, conv_output, accum);
+    return output;
+  }
+};
+
 static auto registry =
     c10::RegisterOperators()
         .op("quantized::conv2d",
@@ -645,6 +845,12 @@ static auto registry =
         .op("quantized::conv2d_relu",
             c10::RegisterOperators::options().kernel<QConvInt8<2, true>>(
                 DispatchKey::QuantizedCPUTensorId))
+        .op("quantized::conv2d_add_relu(Tensor qx, Tensor weight, Tensor qaccum, "
+            "int[] stride, int[] padding, int[] dilation, int groups, "
+            "float conv_scale, int conv_zero_point, float output_scale, "
+            "int output_zero_point) -> Tensor",
+            c10::RegisterOperators::options().kernel<QConvAddReLUInt8>(
+                DispatchKey::QuantizedCPUTensorId))
         .op("quantized::conv3d",
             c10::RegisterOperators::options().kernel<QConvInt8<3, false>>(
                 DispatchKey::QuantizedCPUTensorId))
@@ -6,6 +6,7 @@
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/init_qnnpack.h>
+#include <ATen/native/quantized/cpu/qengine_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
 #include <ATen/quantized/Quantizer.h>
 
@@ -38,16 +39,17 @@ class QConvPackWeightInt8 final : public c10::OperatorKernel {
       torch::List<int64_t> padding,
       torch::List<int64_t> dilation,
       int64_t groups) {
-    auto& ctx = at::globalContext();
+    const auto engine =
+        qengine_utils::convPrepackEngine<kSpatialDim>(weight, groups);
 #ifdef USE_FBGEMM
-    if (ctx.qEngine() == at::QEngine::FBGEMM) {
+    if (engine == at::QEngine::FBGEMM) {
       return fbgemm_conv_prepack(
           weight, bias, stride, padding, dilation, groups);
     }
 #endif
 
 #ifdef USE_PYTORCH_QNNPACK
-    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+    if (engine == at::QEngine::QNNPACK) {
       TORCH_CHECK(
           kSpatialDim == 2,
           "quantized::conv2d_prepack (qnnpack): QNNPACK only supports Conv2d "
@@ -60,7 +62,7 @@ class QConvPackWeightInt8 final : public c10::OperatorKernel {
     TORCH_CHECK(
         false,
         "Didn't find engine for operation quantized::conv2d_prepack ",
-        toString(ctx.qEngine()));
+        toString(engine));
   }
 
  private:
@@ -5,6 +5,7 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/native/quantized/cpu/qengine_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
 
 namespace at {
@@ -23,16 +24,17 @@ class QConvUnpackWeightsInt8 final : public c10::OperatorKernel {
  public:
   std::tuple<at::Tensor, c10::optional<at::Tensor>> operator()(
       Tensor packed_weights) {
-    auto& ctx = at::globalContext();
+    const auto engine =
+        qengine_utils::convPackedEngine<kSpatialDim>(packed_weights);
 
 #ifdef USE_FBGEMM
-    if (ctx.qEngine() == at::QEngine::FBGEMM) {
+    if (engine == at::QEngine::FBGEMM) {
       return fbgemm_conv_unpack(packed_weights);
     }
 #endif
 
 #ifdef USE_PYTORCH_QNNPACK
-    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+    if (engine == at::QEngine::QNNPACK) {
       TORCH_CHECK(
           kSpatialDim == 2,
           "quantized::conv2d_unpack (qnnpack): QNNPACK only supports Conv2d "
@@ -44,7 +46,7 @@ class QConvUnpackWeightsInt8 final : public c10::OperatorKernel {
     TORCH_CHECK(
         false,
         "Didn't find engine for operation quantized::conv2d_unpack ",
-        toString(ctx.qEngine()));
+        toString(engine));
   }
 
  private:
@@ -0,0 +1,396 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
+#include <c10/util/Half.h>
+#include <caffe2/perfkernels/fused_8bit_rowwise_conversion.h>
+#include <caffe2/perfkernels/fused_8bit_rowwise_embedding_lookup_idx.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Embedding bags over rowwise quantized tables.
+//
+// The 8-bit ("byte") format stores each row of D values as D uint8 followed by
+// a float scale and a float bias, D + 8 bytes per row. The N-bit formats (4 and
+// 2 bit) pack 8 / N values per byte, lowest bits first, so the 4-bit format has
+// the even column in the low nibble, followed by an fp16 scale and an fp16
+// bias, ceil(D * N / 8) + 4 bytes per row. In all of them, a value is
+// q * scale + bias, with the row minimum as bias. Tables are built with
+// quantized::embedding_bag_{byte,4bit,2bit}_prepack from a float weight.
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(qembedding_bag_nbit_stub);
+
+namespace {
+
+constexpr int64_t kEmbeddingBagModeSum = 0;
+constexpr int64_t kEmbeddingBagModeMean = 1;
+
+// Offsets of all bags plus the end of the last one, as the perfkernels take.
+std::vector<int64_t> offsets_with_end(
+    const Tensor& indices,
+    const Tensor& offsets,
+    bool include_last_offset) {
+  const int64_t* offsets_data = offsets.data_ptr<int64_t>();
+  std::vector<int64_t> result(offsets_data, offsets_data + offsets.numel());
+  if (!include_last_offset) {
+    result.push_back(indices.numel());
+  }
+  return result;
+}
+
+void check_embedding_bag_args(
+    const Tensor& weight,
+    const Tensor& indices,
+    const Tensor& offsets,
+    int64_t mode,
+    const c10::optional<Tensor>& per_sample_weights,
+    bool include_last_offset) {
+  TORCH_CHECK(
+      weight.scalar_type() == at::kByte && weight.dim() == 2,
+      "embedding_bag: expected a 2-D uint8 prepacked weight");
+  TORCH_CHECK(
+      indices.dim() == 1 && indices.scalar_type() == at::kLong,
+      "embedding_bag: expected 1-D int64 indices");
+  TORCH_CHECK(
+      offsets.dim() == 1 && offsets.scalar_type() == at::kLong,
+      "embedding_bag: expected 1-D int64 offsets");
+  TORCH_CHECK(
+      !include_last_offset || offsets.numel() >= 1,
+      "include_last_offset: number of offset should be at least 1");
+  TORCH_CHECK(
+      mode == kEmbeddingBagModeSum || mode == kEmbeddingBagModeMean,
+      "embedding_bag: only mode='sum' and mode='mean' are supported for "
+      "quantized tables");
+  if (per_sample_weights.has_value()) {
+    TORCH_CHECK(
+        mode == kEmbeddingBagModeSum,
+        "embedding_bag: per_sample_weights only supported with mode='sum'");
+    TORCH_CHECK(
+        per_sample_weights->scalar_type() == at::kFloat &&
+            per_sample_weights->numel() == indices.numel(),
+        "embedding_bag: expected float per_sample_weights with one weight per "
+        "index");
+  }
+}
+
+Tensor embedding_bag_byte_prepack(const Tensor& weight) {
+  TORCH_CHECK(
+      weight.dim() == 2 && weight.scalar_type() == at::kFloat,
+      "embedding_bag_byte_prepack: expected a 2-D float weight");
+  const Tensor weight_contig = weight.contiguous();
+  const int64_t rows = weight.size(0);
+  const int64_t cols = weight.size(1);
+  Tensor packed = at::empty({rows, cols + 8}, weight.options().dtype(at::kByte));
+  caffe2::FloatToFused8BitRowwiseQuantized(
+      weight_contig.data_ptr<float>(), rows, cols, packed.data_ptr<uint8_t>());
+  return packed;
+}
+
+Tensor embedding_bag_byte_unpack(const Tensor& packed) {
+  TORCH_CHECK(
+      packed.dim() == 2 && packed.scalar_type() == at::kByte &&
+          packed.size(1) >= 8,
+      "embedding_bag_byte_unpack: expected a 2-D uint8 prepacked weight");
+  const Tensor packed_contig = packed.contiguous();
+  const int64_t rows = packed.size(0);
+  const int64_t cols = packed.size(1) - 8;
+  Tensor weight = at::empty({rows, cols}, packed.options().dtype(at::kFloat));
+  caffe2::Fused8BitRowwiseQuantizedToFloat(
+      packed_contig.data_ptr<uint8_t>(), rows, cols + 8, weight.data_ptr<float>());
+  return weight;
+}
+
+Tensor embedding_bag_nbit_prepack_helper(const Tensor& weight, int bit_rate) {
+  TORCH_CHECK(
+      weight.dim() == 2 && weight.scalar_type() == at::kFloat,
+      "embedding_bag_", bit_rate, "bit_prepack: expected a 2-D float weight");
+  const Tensor weight_contig = weight.contiguous();
+  const float* weight_data = weight_contig.data_ptr<float>();
+  const int64_t rows = weight.size(0);
+  const int64_t cols = weight.size(1);
+  const int64_t codes_per_byte = 8 / bit_rate;
+  const int64_t packed_cols = (cols + codes_per_byte - 1) / codes_per_byte;
+  const float max_code = (1 << bit_rate) - 1;
+  Tensor packed = at::zeros(
+      {rows, packed_cols + 4}, weight.options().dtype(at::kByte));
+  uint8_t* packed_data = packed.data_ptr<uint8_t>();
+
+  at::parallel_for(0, rows, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; ++row) {
+      const float* input_row = weight_data + row * cols;
+      uint8_t* output_row = packed_data + row * (packed_cols + 4);
+      float minimum = cols > 0 ? *std::min_element(input_row, input_row + cols) : 0;
+      float maximum = cols > 0 ? *std::max_element(input_row, input_row + cols) : 0;
+      // quantize against the fp16 values that are stored
+      const at::Half bias = minimum;
+      at::Half scale = (maximum - static_cast<float>(bias)) / max_code;
+      if (static_cast<float>(scale) == 0.0f) {
+        scale = 1.0f;
+      }
+      const float inverse_scale = 1.0f / static_cast<float>(scale);
+      for (int64_t col = 0; col < cols; ++col) {
+        float q = std::nearbyint((input_row[col] - static_cast<float>(bias)) * inverse_scale);
+        q = std::max(0.0f, std::min(q, max_code));
+        output_row[col / codes_per_byte] |= static_cast<uint8_t>(q)
+            << ((col % codes_per_byte) * bit_rate);
+      }
+      at::Half* scale_bias = reinterpret_cast<at::Half*>(output_row + packed_cols);
+      scale_bias[0] = scale;
+      scale_bias[1] = bias;
+    }
+  });
+  return packed;
+}
+
+Tensor embedding_bag_nbit_unpack_helper(const Tensor& packed, int bit_rate) {
+  TORCH_CHECK(
+      packed.dim() == 2 && packed.scalar_type() == at::kByte &&
+          packed.size(1) >= 4,
+      "embedding_bag_", bit_rate, "bit_unpack: expected a 2-D uint8 prepacked weight");
+  const Tensor packed_contig = packed.contiguous();
+  const uint8_t* packed_data = packed_contig.data_ptr<uint8_t>();
+  const int64_t rows = packed.size(0);
+  const int64_t codes_per_byte = 8 / bit_rate;
+  const uint8_t code_mask = (1 << bit_rate) - 1;
+  const int64_t packed_cols = packed.size(1) - 4;
+  const int64_t cols = packed_cols * codes_per_byte;
+  Tensor weight = at::empty({rows, cols}, packed.options().dtype(at::kFloat));
+  float* weight_data = weight.data_ptr<float>();
+  for (int64_t row = 0; row < rows; ++row) {
+    const uint8_t* input_row = packed_data + row * (packed_cols + 4);
+    const at::Half* scale_bias =
+        reinterpret_cast<const at::Half*>(input_row + packed_cols);
+    const float scale = scale_bias[0];
+    const float bias = scale_bias[1];
+    for (int64_t col = 0; col < cols; ++col) {
+      const uint8_t q = (input_row[col / codes_per_byte] >>
+                         ((col % codes_per_byte) * bit_rate)) &
+          code_mask;
+      weight_data[row * cols + col] = q * scale + bias;
+    }
+  }
+  return weight;
+}
+
+Tensor embedding_bag_byte_rowwise_offsets(
+    const Tensor& weight,
+    const Tensor& indices,
+    const c10::optional<Tensor>& offsets_in,
+    bool /* scale_grad_by_freq */,
+    int64_t mode,
+    bool /* sparse */,
+    const c10::optional<Tensor>& per_sample_weights,
+    bool include_last_offset) {
+  const Tensor offsets = offsets_in.has_value()
+      ? offsets_in->contiguous()
+      : at::zeros({1}, indices.options());
+  check_embedding_bag_args(
+      weight, indices, offsets, mode, per_sample_weights, include_last_offset);
+  const Tensor weight_contig = weight.contiguous();
+  const Tensor indices_contig = indices.contiguous();
+  const Tensor weights_contig = per_sample_weights.has_value()
+      ? per_sample_weights->contiguous()
+      : Tensor();
+
+  const int64_t block_size = weight.size(1) - 8;
+  const std::vector<int64_t> offsets_data =
+      offsets_with_end(indices, offsets, include_last_offset);
+  const int64_t output_size = offsets_data.size() - 1;
+  Tensor output =
+      at::empty({output_size, block_size}, weight.options().dtype(at::kFloat));
+  const int64_t* indices_data = indices_contig.data_ptr<int64_t>();
+  const float* weights_data =
+      weights_contig.defined() ? weights_contig.data_ptr<float>() : nullptr;
+  float* output_data = output.data_ptr<float>();
+
+  at::parallel_for(0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
+    caffe2::Fused8BitRowwiseEmbeddingLookupIdx(
+        /*block_size=*/block_size,
+        /*output_size=*/end_idx - start_idx,
+        /*index_size=*/offsets_data[end_idx] - offsets_data[start_idx],
+        /*data_size=*/weight.size(0),
+        /*input=*/weight_contig.data_ptr<uint8_t>(),
+        /*indices=*/indices_data + offsets_data[start_idx],
+        /*offsets=*/offsets_data.data() + start_idx,
+        /*weights=*/weights_data ? weights_data + offsets_data[start_idx] : nullptr,
+        /*normalize_by_lengths=*/mode == kEmbeddingBagModeMean,
+        /*out=*/output_data + start_idx * block_size);
+  });
+  return output;
+}
+
+Tensor embedding_bag_nbit_rowwise_offsets_helper(
+    const Tensor& weight,
+    const Tensor& indices,
+    const c10::optional<Tensor>& offsets_in,
+    int64_t mode,
+    const c10::optional<Tensor>& per_sample_weights,
+    bool include_last_offset,
+    int bit_rate) {
+  const Tensor offsets = offsets_in.has_value()
+      ? offsets_in->contiguous()
+      : at::zeros({1}, indices.options());
+  check_embedding_bag_args(
+      weight, indices, offsets, mode, per_sample_weights, include_last_offset);
+  const Tensor weight_contig = weight.contiguous();
+  const Tensor indices_contig = indices.contiguous();
+  const Tensor weights_contig = per_sample_weights.has_value()
+      ? per_sample_weights->contiguous()
+      : Tensor();
+
+  const int64_t num_rows = weight.size(0);
+  const int64_t block_size = (weight.size(1) - 4) * (8 / bit_rate);
+  const std::vector<int64_t> offsets_data =
+      offsets_with_end(indices, offsets, include_last_offset);
+  const int64_t output_size = offsets_data.size() - 1;
+  Tensor output =
+      at::empty({output_size, block_size}, weight.options().dtype(at::kFloat));
+  const uint8_t* weight_data = weight_contig.data_ptr<uint8_t>();
+  const int64_t* indices_data = indices_contig.data_ptr<int64_t>();
+  const float* weights_data =
+      weights_contig.defined() ? weights_contig.data_ptr<float>() : nullptr;
+  float* output_data = output.data_ptr<float>();
+
+  at::parallel_for(0, output_size, 1, [&](int64_t start_idx, int64_t end_idx) {
+    qembedding_bag_nbit_stub(
+        kCPU,
+        bit_rate,
+        block_size,
+        num_rows,
+        weight_data,
+        indices_data,
+        offsets_data.data() + start_idx,
+        end_idx - start_idx,
+        weights_data,
+        /*normalize_by_lengths=*/mode == kEmbeddingBagModeMean,
+        output_data + start_idx * block_size);
+  });
+  return output;
+}
+
+class QEmbeddingBagBytePrepack final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(const Tensor& weight) {
+    return embedding_bag_byte_prepack(weight);
+  }
+};
+
+class QEmbeddingBagByteUnpack final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(const Tensor& packed) {
+    return embedding_bag_byte_unpack(packed);
+  }
+};
+
+template <int bit_rate>
+class QEmbeddingBagNBitPrepack final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(const Tensor& weight) {
+    return embedding_bag_nbit_prepack_helper(weight, bit_rate);
+  }
+};
+
+template <int bit_rate>
+class QEmbeddingBagNBitUnpack final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(const Tensor& packed) {
+    return embedding_bag_nbit_unpack_helper(packed, bit_rate);
+  }
+};
+
+class QEmbeddingBagByteRowwiseOffsets final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(
+      const Tensor& weight,
+      const Tensor& indices,
+      const c10::optional<Tensor>& offsets,
+      bool scale_grad_by_freq,
+      int64_t mode,
+      bool sparse,
+      const c10::optional<Tensor>& per_sample_weights,
+      bool include_last_offset) {
+    return embedding_bag_byte_rowwise_offsets(
+        weight,
+        indices,
+        offsets,
+        scale_grad_by_freq,
+        mode,
+        sparse,
+        per_sample_weights,
+        include_last_offset);
+  }
+};
+
+template <int bit_rate>
+class QEmbeddingBagNBitRowwiseOffsets final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(
+      const Tensor& weight,
+      const Tensor& indices,
+      const c10::optional<Tensor>& offsets,
+      bool /* scale_grad_by_freq */,
+      int64_t mode,
+      bool /* sparse */,
+      const c10::optional<Tensor>& per_sample_weights,
+      bool include_last_offset) {
+    return embedding_bag_nbit_rowwise_offsets_helper(
+        weight,
+        indices,
+        offsets,
+        mode,
+        per_sample_weights,
+        include_last_offset,
+        bit_rate);
+  }
+};
+
+static auto registry =
+    c10::RegisterOperators()
+        .op("quantized::embedding_bag_byte_prepack(Tensor weight) -> Tensor",
+            c10::RegisterOperators::options()
+                .kernel<QEmbeddingBagBytePrepack>(DispatchKey::CPUTensorId))
+        .op("quantized::embedding_bag_byte_unpack(Tensor weight) -> Tensor",
+            c10::RegisterOperators::options()
+                .kernel<QEmbeddingBagByteUnpack>(DispatchKey::CPUTensorId))
+        .op("quantized::embedding_bag_4bit_prepack(Tensor weight) -> Tensor",
+            c10::RegisterOperators::options()
+                .kernel<QEmbeddingBagNBitPrepack<4>>(DispatchKey::CPUTensorId))
+        .op("quantized::embedding_bag_4bit_unpack(Tensor weight) -> Tensor",
+            c10::RegisterOperators::options()
+                .kernel<QEmbeddingBagNBitUnpack<4>>(DispatchKey::CPUTensorId))
+        .op("quantized::embedding_bag_2bit_prepack(Tensor weight) -> Tensor",
+            c10::RegisterOperators::options()
+                .kernel<QEmbeddingBagNBitPrepack<2>>(DispatchKey::CPUTensorId))
+        .op("quantized::embedding_bag_2bit_unpack(Tensor weight) -> Tensor",
+            c10::RegisterOperators::options()
+                .kernel<QEmbeddingBagNBitUnpack<2>>(DispatchKey::CPUTensorId))
+        .op("quantized::embedding_bag_byte_rowwise_offsets(Tensor weight, "
+            "Tensor indices, Tensor? offsets=None, bool scale_grad_by_freq=False, "
+            "int mode=0, bool sparse=False, Tensor? per_sample_weights=None, "
+            "bool include_last_offset=False) -> Tensor",
+            c10::RegisterOperators::options()
+                .kernel<QEmbeddingBagByteRowwiseOffsets>(
+                    DispatchKey::CPUTensorId))
+        .op("quantized::embedding_bag_4bit_rowwise_offsets(Tensor weight, "
+            "Tensor indices, Tensor? offsets=None, bool scale_grad_by_freq=False, "
+            "int mode=0, bool sparse=False, Tensor? per_sample_weights=None, "
+            "bool include_last_offset=False) -> Tensor",
+            c10::RegisterOperators::options()
+                .kernel<QEmbeddingBagNBitRowwiseOffsets<4>>(
+                    DispatchKey::CPUTensorId))
+        .op("quantized::embedding_bag_2bit_rowwise_offsets(Tensor weight, "
+            "Tensor indices, Tensor? offsets=None, bool scale_grad_by_freq=False, "
+            "int mode=0, bool sparse=False, Tensor? per_sample_weights=None, "
+            "bool include_last_offset=False) -> Tensor",
+            c10::RegisterOperators::options()
+                .kernel<QEmbeddingBagNBitRowwiseOffsets<2>>(
+                    DispatchKey::CPUTensorId));
+
+} // namespace
+} // namespace native
+} // namespace at
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/cpp_custom_type_hack.h>
+#include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/native/quantized/cpu/qnnpack_utils.h>
+
+#include <algorithm>
+
+// Per operator engine selection for the quantized ops that take prepacked
+// weights.
+//
+// By default every prepack op packs for at::globalContext().qEngine(). With
+// torch.backends.quantized.auto_select set, the prepack ops instead look the
+// weight shape up in the table below and pack for the engine that is expected
+// to be faster for it. The winner is recorded by the type of the packed weight
+// blob, so the run and unpack ops follow the packed weight rather than the
+// global engine.
+namespace at {
+namespace native {
+namespace qengine_utils {
+
+// On x86, FBGEMM's packing and requantization overhead dominates for tiny
+// fully connected layers and small depthwise convolutions, where QNNPACK's
+// micro-kernels win. Large GEMMs and dense convolutions stay on FBGEMM.
+constexpr int64_t kQnnpackLinearMaxWeightNumel = 64 * 64;
+constexpr int64_t kQnnpackDepthwiseMaxChannels = 64;
+
+inline bool autoSelectEnabled() {
+  auto& ctx = at::globalContext();
+  if (!ctx.qEngineAutoSelect()) {
+    return false;
+  }
+  const auto& engines = ctx.supportedQEngines();
+  return std::find(engines.begin(), engines.end(), at::kFBGEMM) !=
+      engines.end() &&
+      std::find(engines.begin(), engines.end(), at::kQNNPACK) != engines.end();
+}
+
+// Engine quantized::linear_prepack packs `weight` for.
+inline at::QEngine linearPrepackEngine(const Tensor& weight) {
+  if (!autoSelectEnabled()) {
+    return at::globalContext().qEngine();
+  }
+  // QNNPACK only supports per tensor quantized weights.
+  if (weight.qscheme() == kPerTensorAffine &&
+      weight.numel() <= kQnnpackLinearMaxWeightNumel) {
+    return at::kQNNPACK;
+  }
+  return at::kFBGEMM;
+}
+
+// Engine quantized::conv{2,3}d_prepack packs `weight` for.
+template <int kSpatialDim>
+at::QEngine convPrepackEngine(const Tensor& weight, int64_t groups) {
+  if (!autoSelectEnabled()) {
+    return at::globalContext().qEngine();
+  }
+  // Depthwise with a channel multiplier of one: weight is [C, 1, kH, kW].
+  const bool depthwise = weight.dim() == kSpatialDim + 2 && groups > 1 &&
+      weight.size(0) == groups && weight.size(1) == 1;
+  if (kSpatialDim == 2 && weight.qscheme() == kPerTensorAffine && depthwise &&
+      groups <= kQnnpackDepthwiseMaxChannels) {
+    return at::kQNNPACK;
+  }
+  return at::kFBGEMM;
+}
+
+// Engine that produced a quantized::linear_prepack blob. Falls back to the
+// global engine for anything that is not a recognized packed weight so the
+// caller reports the usual type mismatch.
+inline at::QEngine linearPackedEngine(const Tensor& packed_weight) {
+#ifdef USE_FBGEMM
+  if (cpp_custom_type_hack::isa<PackedLinearWeight>(packed_weight)) {
+    return at::kFBGEMM;
+  }
+#endif // USE_FBGEMM
+#ifdef USE_PYTORCH_QNNPACK
+  if (cpp_custom_type_hack::isa<PackedLinearWeightsQnnp>(packed_weight)) {
+    return at::kQNNPACK;
+  }
+#endif // USE_PYTORCH_QNNPACK
+  return at::globalContext().qEngine();
+}
+
+// Engine that produced a quantized::conv{2,3}d_prepack blob.
+template <int kSpatialDim>
+at::QEngine convPackedEngine(const Tensor& packed_weight) {
+#ifdef USE_FBGEMM
+  if (cpp_custom_type_hack::isa<PackedConvWeight<kSpatialDim>>(
+          packed_weight)) {
+    return at::kFBGEMM;
+  }
+#endif // USE_FBGEMM
+#ifdef USE_PYTORCH_QNNPACK
+  if (cpp_custom_type_hack::isa<PackedConvWeightsQnnp>(packed_weight)) {
+    return at::kQNNPACK;
+  }
+#endif // USE_PYTORCH_QNNPACK
+  return at::globalContext().qEngine();
+}
+
+} // namespace qengine_utils
+} // namespace native
+} // namespace at
@@ -3,6 +3,7 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/native/quantized/cpu/qengine_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
 #include <caffe2/utils/threadpool/ThreadPoolMobile.h>
 
@@ -331,16 +332,16 @@ class QLinearInt8 final : public torch::OperatorKernel {
       at::Tensor packed_weight,
       double output_scale,
       int64_t output_zero_point) {
-    auto& ctx = at::globalContext();
+    const auto engine = qengine_utils::linearPackedEngine(packed_weight);
 
 #ifdef USE_FBGEMM
-    if (ctx.qEngine() == at::QEngine::FBGEMM) {
+    if (engine == at::QEngine::FBGEMM) {
       return fbgemm_linear(
           input, packed_weight, output_scale, output_zero_point);
     }
 #endif
 #ifdef USE_PYTORCH_QNNPACK
-    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+    if (engine == at::QEngine::QNNPACK) {
       return qnnpack_linear(
           input, packed_weight, output_scale, output_zero_point);
     }
@@ -348,7 +349,7 @@ class QLinearInt8 final : public torch::OperatorKernel {
     TORCH_CHECK(
         false,
         "Didn't find engine for operation quantized::linear ",
-        toString(ctx.qEngine()));
+        toString(engine));
   }
 };
 
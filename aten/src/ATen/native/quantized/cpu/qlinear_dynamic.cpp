@@ -3,6 +3,7 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/native/quantized/cpu/qengine_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
 #include <ATen/native/quantized/cpu/quant_utils.h>
 #include <caffe2/utils/threadpool/ThreadPoolMobile.h>
@@ -317,22 +318,22 @@ class QLinearDynamicInt8 final : public torch::OperatorKernel {
   }
 #endif // USE_PYTORCH_QNNPACK
   at::Tensor operator()(at::Tensor input, at::Tensor packed_weight) {
-    auto& ctx = at::globalContext();
+    const auto engine = qengine_utils::linearPackedEngine(packed_weight);
 
 #ifdef USE_FBGEMM
-    if (ctx.qEngine() == at::QEngine::FBGEMM) {
+    if (engine == at::QEngine::FBGEMM) {
       return fbgemm_linear(input, packed_weight);
     }
 #endif
 #ifdef USE_PYTORCH_QNNPACK
-    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+    if (engine == at::QEngine::QNNPACK) {
       return qnnpack_linear(input, packed_weight);
     }
 #endif
     TORCH_CHECK(
         false,
         "Didn't find engine for operation quantized::linear ",
-        toString(ctx.qEngine()));
+        toString(engine));
   }
 };
 
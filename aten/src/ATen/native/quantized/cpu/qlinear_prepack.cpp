@@ -3,7 +3,9 @@
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
 #include <ATen/native/quantized/cpu/init_qnnpack.h>
+#include <ATen/native/quantized/cpu/qengine_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
+#include <ATen/native/quantized/cuda/cublas_utils.h>
 #include <ATen/quantized/Quantizer.h>
 #include <algorithm>
 #include <vector>
@@ -18,6 +20,9 @@ CAFFE_KNOWN_TYPE(PackedLinearWeightFp16);
 // Required for cpp_custom_type_hack to work
 CAFFE_KNOWN_TYPE(PackedLinearWeightsQnnp);
 #endif // USE_PYTORCH_QNNPACK
+// Registered here rather than next to the CUDA prepack op so that
+// quantized::linear_unpack, which runs on CPU, can recognize it too.
+CAFFE_KNOWN_TYPE(PackedLinearWeightCublas);
 } // namespace caffe2
 
 namespace at {
@@ -174,22 +179,22 @@ class QLinearPackWeightInt8 final : public c10::OperatorKernel {
   }
 #endif
   at::Tensor operator()(at::Tensor weight, c10::optional<Tensor> bias) {
-    auto& ctx = at::globalContext();
+    const auto engine = qengine_utils::linearPrepackEngine(weight);
 
 #ifdef USE_FBGEMM
-    if (ctx.qEngine() == at::QEngine::FBGEMM) {
+    if (engine == at::QEngine::FBGEMM) {
       return fbgemm_linear_prepack(weight, bias);
     }
 #endif
 #ifdef USE_PYTORCH_QNNPACK
-    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+    if (engine == at::QEngine::QNNPACK) {
       return qnnpack_linear_prepack(weight, bias);
     }
 #endif
     TORCH_CHECK(
         false,
         "Didn't find engine for operation quantized::linear_prepack ",
-        toString(ctx.qEngine()));
+        toString(engine));
   }
 };
 
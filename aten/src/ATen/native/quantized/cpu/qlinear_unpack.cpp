@@ -2,7 +2,9 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/native/quantized/cpu/qengine_utils.h>
 #include <ATen/native/quantized/cpu/qnnpack_utils.h>
+#include <ATen/native/quantized/cuda/cublas_utils.h>
 
 namespace at {
 namespace native {
@@ -66,22 +68,30 @@ class QLinearUnpackWeightInt8 final : public c10::OperatorKernel {
 #endif // USE_PYTORCH_QNNPACK
   std::tuple<at::Tensor, c10::optional<Tensor>> operator()(
       at::Tensor packed_weight) {
-    auto& ctx = at::globalContext();
+    // Weights packed for CUDA are wrapped in a CPU tensor too, so they end up
+    // here rather than at a CUDA kernel.
+    if (cpp_custom_type_hack::isa<PackedLinearWeightCublas>(packed_weight)) {
+      auto& pack_ptr =
+          cpp_custom_type_hack::cast<PackedLinearWeightCublas>(packed_weight);
+      return std::tuple<at::Tensor, c10::optional<Tensor>>(
+          pack_ptr.orig_weight, pack_ptr.bias);
+    }
+    const auto engine = qengine_utils::linearPackedEngine(packed_weight);
 
 #ifdef USE_FBGEMM
-    if (ctx.qEngine() == at::QEngine::FBGEMM) {
+    if (engine == at::QEngine::FBGEMM) {
       return fbgemm_linear_unpack(packed_weight);
     }
 #endif
 #ifdef USE_PYTORCH_QNNPACK
-    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+    if (engine == at::QEngine::QNNPACK) {
       return qnnpack_linear_unpack(packed_weight);
     }
 #endif
     TORCH_CHECK(
         false,
         "Didn't find engine for operation quantized::linear_unpack ",
-        toString(ctx.qEngine()));
+        toString(engine));
   }
 };
 
@@ -0,0 +1,90 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
+#include <ATen/quantized/Quantizer.h>
+
+#include <vector>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(qlayer_norm_stub);
+
+namespace {
+
+// Layer norm that reads and writes per tensor quantized tensors. The row
+// statistics are computed from the integer codes and the normalized values
+// are requantized with the given output parameters, so transformer blocks
+// need not dequantize around it.
+Tensor quantized_layer_norm_impl(
+    const Tensor& input,
+    IntArrayRef normalized_shape,
+    const Tensor& weight,
+    const Tensor& bias,
+    double eps,
+    double output_scale,
+    int64_t output_zero_point) {
+  TORCH_CHECK(
+      input.qscheme() == kPerTensorAffine,
+      "quantized::layer_norm only supports per tensor quantized inputs");
+  const int64_t normalized_ndim = normalized_shape.size();
+  TORCH_CHECK(
+      normalized_ndim >= 1 && input.dim() >= normalized_ndim &&
+          input.sizes().slice(input.dim() - normalized_ndim) ==
+              normalized_shape,
+      "quantized::layer_norm: normalized_shape ", normalized_shape,
+      " does not match the trailing dimensions of an input of size ",
+      input.sizes());
+  const int64_t N = prod_intlist(normalized_shape);
+  const int64_t M = N == 0 ? 0 : input.numel() / N;
+  for (const Tensor* param : {&weight, &bias}) {
+    TORCH_CHECK(
+        !param->defined() ||
+            (param->scalar_type() == kFloat && param->numel() == N),
+        "quantized::layer_norm: expected float weight and bias of ", N,
+        " elements");
+  }
+
+  const Tensor X = input.contiguous();
+  const Tensor gamma = weight.defined() ? weight.contiguous() : weight;
+  const Tensor beta = bias.defined() ? bias.contiguous() : bias;
+  Tensor Y = at::_empty_affine_quantized(
+      X.sizes(), X.options(), output_scale, output_zero_point);
+  if (M > 0) {
+    qlayer_norm_stub(X.device().type(), X, M, N, gamma, beta, eps, Y);
+  }
+  return Y;
+}
+
+class QLayerNorm final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(
+      Tensor input,
+      std::vector<int64_t> normalized_shape,
+      c10::optional<Tensor> weight,
+      c10::optional<Tensor> bias,
+      double eps,
+      double output_scale,
+      int64_t output_zero_point) {
+    return quantized_layer_norm_impl(
+        input,
+        normalized_shape,
+        weight.has_value() ? *weight : Tensor(),
+        bias.has_value() ? *bias : Tensor(),
+        eps,
+        output_scale,
+        output_zero_point);
+  }
+};
+
+static auto registry = c10::RegisterOperators().op(
+    "quantized::layer_norm(Tensor input, int[] normalized_shape, "
+    "Tensor? weight, Tensor? bias, float eps, float output_scale, "
+    "int output_zero_point) -> Tensor",
+    c10::RegisterOperators::options().kernel<QLayerNorm>(
+        DispatchKey::QuantizedCPUTensorId));
+
+} // namespace
+} // namespace native
+} // namespace at
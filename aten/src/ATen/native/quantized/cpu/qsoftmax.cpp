@@ -0,0 +1,56 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/WrapDimUtils.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
+#include <ATen/quantized/Quantizer.h>
+
+namespace at {
+namespace native {
+
+DEFINE_DISPATCH(qsoftmax_stub);
+
+namespace {
+
+Tensor quantized_softmax_impl(
+    const Tensor& qx,
+    int64_t dim,
+    double output_scale,
+    int64_t output_zero_point) {
+  TORCH_CHECK(
+      qx.qscheme() == kPerTensorAffine,
+      "quantized::softmax only supports per tensor quantized inputs");
+  TORCH_CHECK(
+      qx.scalar_type() == kQUInt8 || qx.scalar_type() == kQInt8,
+      "quantized::softmax only supports quint8 and qint8 inputs");
+  dim = maybe_wrap_dim(dim, qx.dim());
+  // a 0-dim input is a single line of one element
+  const Tensor input = qx.dim() == 0 ? qx.reshape({1}) : qx.contiguous();
+  Tensor qy = at::_empty_affine_quantized(
+      input.sizes(), input.options(), output_scale, output_zero_point);
+  if (input.numel() > 0) {
+    qsoftmax_stub(input.device().type(), input, dim, qy);
+  }
+  return qx.dim() == 0 ? qy.reshape({}) : qy;
+}
+
+class QSoftmax final : public c10::OperatorKernel {
+ public:
+  Tensor operator()(
+      Tensor qx,
+      int64_t dim,
+      double output_scale,
+      int64_t output_zero_point) {
+    return quantized_softmax_impl(qx, dim, output_scale, output_zero_point);
+  }
+};
+
+static auto registry = c10::RegisterOperators().op(
+    "quantized::softmax(Tensor qx, int dim, float output_scale, "
+    "int output_zero_point) -> Tensor",
+    c10::RegisterOperators::options().kernel<QSoftmax>(
+        DispatchKey::QuantizedCPUTensorId));
+
+} // namespace
+} // namespace native
+} // namespace at
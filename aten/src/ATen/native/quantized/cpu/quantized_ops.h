@@ -82,6 +82,55 @@ using qcat_nhwc_fn = Tensor (*)(
     double scale,
     int64_t zero_point);
 using qtopk_fn = void(*)(Tensor&, Tensor&, const Tensor&, int64_t, int64_t, bool, bool);
+using fake_quant_tensor_fn = void (*)(
+    Tensor& output,
+    const Tensor& input,
+    float sc,
+    int64_t z_point,
+    int64_t quant_min,
+    int64_t quant_max);
+using fake_quant_grad_tensor_fn = void (*)(
+    Tensor& input_grad,
+    const Tensor& input,
+    const Tensor& output_grad,
+    float sc,
+    int64_t z_point,
+    int64_t quant_min,
+    int64_t quant_max);
+using fake_quant_tensor_cachemask_fn = void (*)(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    float sc,
+    int64_t z_point,
+    int64_t quant_min,
+    int64_t quant_max);
+// Sum (or mean) of rows of a rowwise quantized table with bit_rate-bit
+// codes, see qembeddingbag.cpp for the layout. Bag b covers
+// indices[offsets[b], offsets[b + 1]) and is written to out + b * block_size.
+using qembedding_bag_nbit_fn = void (*)(
+    int64_t bit_rate,
+    int64_t block_size,
+    int64_t num_rows,
+    const uint8_t* weight,
+    const int64_t* indices,
+    const int64_t* offsets,
+    int64_t num_bags,
+    const float* per_sample_weights,
+    bool normalize_by_lengths,
+    float* out);
+// Normalizes each of the M contiguous rows of N elements of X into Y, which
+// carries the output quantization parameters. gamma and beta are optional
+// float affine parameters of N elements.
+using qlayer_norm_fn = void (*)(
+    const Tensor& X,
+    int64_t M,
+    int64_t N,
+    const Tensor& gamma,
+    const Tensor& beta,
+    double eps,
+    Tensor& Y);
+using qsoftmax_fn = void (*)(const Tensor& qx, int64_t dim, Tensor& qy);
 
 // using qavg_pool2d_fn
 DECLARE_DISPATCH(qrelu_fn, qrelu_stub);
@@ -98,6 +147,14 @@ DECLARE_DISPATCH(qupsample_bilinear2d_fn, qupsample_bilinear2d_nhwc_stub);
 DECLARE_DISPATCH(qcat_nhwc_fn, qcat_nhwc_stub);
 DECLARE_DISPATCH(qcat_nhwc_fn, qcat_relu_nhwc_stub);
 DECLARE_DISPATCH(qtopk_fn, qtopk_stub);
+DECLARE_DISPATCH(fake_quant_tensor_fn, fake_quant_tensor_stub);
+DECLARE_DISPATCH(fake_quant_grad_tensor_fn, fake_quant_grad_tensor_stub);
+DECLARE_DISPATCH(
+    fake_quant_tensor_cachemask_fn,
+    fake_quant_tensor_cachemask_stub);
+DECLARE_DISPATCH(qembedding_bag_nbit_fn, qembedding_bag_nbit_stub);
+DECLARE_DISPATCH(qlayer_norm_fn, qlayer_norm_stub);
+DECLARE_DISPATCH(qsoftmax_fn, qsoftmax_stub);
 
 } // namespace native
 } // namespace at
@@ -1,4 +1,5 @@
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 #include <ATen/native/UpSample.h>
 #include <ATen/native/cpu/Loops.h>
 #include <ATen/native/quantized/cpu/quantized_ops.h>
@@ -70,29 +71,33 @@ static void upsample_nearest2d_out_frame_nhwc(
   float height_scale = compute_scales_value<float>(scales_h, input_height, output_height);
   float width_scale = compute_scales_value<float>(scales_w, input_width, output_width);
 
-  for (int b = 0; b < nbatch; b++) {
-    auto* i_p = reinterpret_cast<typename scalar_t::underlying*>(idata + b * input_height * input_width * channels);
-    auto* o_p = reinterpret_cast<typename scalar_t::underlying*>(odata + b * output_height * output_width * channels);
-    // special case: just copy
-    if (input_height == output_height && input_width == output_width) {
-      std::memcpy(o_p, i_p, channels * input_height * input_width * sizeof(typename scalar_t::underlying));
-      return;
-    }
+  auto* i_p = reinterpret_cast<typename scalar_t::underlying*>(idata);
+  auto* o_p = reinterpret_cast<typename scalar_t::underlying*>(odata);
+
+  // special case: just copy
+  if (input_height == output_height && input_width == output_width) {
+    std::memcpy(o_p, i_p, nbatch * channels * input_height * input_width * sizeof(typename scalar_t::underlying));
+    return;
+  }
 
-    for (int64_t h2 = 0; h2 < output_height; ++h2) {
+  // Each output pixel is a contiguous run of `channels` values copied from
+  // one input pixel, so rows of the output are independent.
+  at::parallel_for(0, nbatch * output_height, 0, [&](int64_t begin, int64_t end) {
+    for (int64_t b_h2 = begin; b_h2 < end; ++b_h2) {
+      const int64_t b = b_h2 / output_height;
+      const int64_t h2 = b_h2 % output_height;
       const int64_t h1 =
           nearest_neighbor_compute_source_index(height_scale, h2, input_height);
+      const auto* i_row = i_p + (b * input_height + h1) * input_width * channels;
+      auto* o_row = o_p + (b * output_height + h2) * output_width * channels;
 
       for (int64_t w2 = 0; w2 < output_width; ++w2) {
         const int64_t w1 =
             nearest_neighbor_compute_source_index(width_scale, w2, input_width);
-
-        const auto* pos1 = &i_p[(h1 * input_width + w1)*channels];
-        auto* pos2 = &o_p[(h2 * output_width + w2)*channels];
-        std::memcpy(pos2, pos1, channels * sizeof(typename scalar_t::underlying));
+        std::memcpy(o_row + w2 * channels, i_row + w1 * channels, channels * sizeof(typename scalar_t::underlying));
       }
     }
-  }
+  });
 }
 
 Tensor quantized_upsample_nearest2d_cpu(
@@ -0,0 +1,161 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/detail/KernelUtils.h>
+#include <ATen/quantized/Quantizer.h>
+
+#include <limits>
+
+/* Per tensor affine quantized tensors on CUDA */
+namespace at {
+namespace native {
+
+using at::cuda::detail::CUDA_NUM_THREADS;
+using at::cuda::detail::GET_BLOCKS;
+
+namespace {
+
+// Rounds like fbgemm::Quantize, so that CUDA and CPU quantize alike.
+template <typename underlying_t>
+__global__ void quantize_per_tensor_affine_kernel(
+    const float* src,
+    underlying_t* dst,
+    float scale,
+    int64_t zero_point,
+    int64_t qmin,
+    int64_t qmax,
+    int64_t numel) {
+  CUDA_KERNEL_LOOP(i, numel) {
+    const float transformed = zero_point + src[i] / scale;
+    const int64_t q = static_cast<int64_t>(nearbyintf(transformed));
+    dst[i] = static_cast<underlying_t>(q < qmin ? qmin : (q > qmax ? qmax : q));
+  }
+}
+
+template <typename underlying_t>
+__global__ void dequantize_per_tensor_affine_kernel(
+    const underlying_t* src,
+    float* dst,
+    float scale,
+    int64_t zero_point,
+    int64_t numel) {
+  CUDA_KERNEL_LOOP(i, numel) {
+    dst[i] = (static_cast<float>(src[i]) - zero_point) * scale;
+  }
+}
+
+void check_kernel_numel(const char* fn_name, int64_t numel) {
+  TORCH_CHECK(
+      numel <= std::numeric_limits<int>::max(),
+      fn_name,
+      " supports at most ",
+      std::numeric_limits<int>::max(),
+      " elements on CUDA");
+}
+
+} // namespace
+
+Tensor empty_affine_quantized_cuda(
+    IntArrayRef size,
+    const TensorOptions& options,
+    double scale,
+    int64_t zero_point,
+    c10::optional<c10::MemoryFormat> optional_memory_format) {
+  TORCH_CHECK(
+      options.has_dtype(),
+      "Must provide data type for Tensor creation functions.");
+  return new_qtensor(
+      size,
+      options,
+      make_per_tensor_affine_quantizer(
+          scale, zero_point, typeMetaToScalarType(options.dtype())),
+      at::cuda::getCUDADeviceAllocator(),
+      optional_memory_format.value_or(MemoryFormat::Contiguous));
+}
+
+Tensor quantize_per_tensor_cuda(
+    const Tensor& self,
+    double scale,
+    int64_t zero_point,
+    ScalarType dtype) {
+  TORCH_CHECK(
+      self.scalar_type() == kFloat, "quantize only works on Float Tensor.");
+  Tensor qtensor = at::_empty_affine_quantized(
+      self.sizes(), self.options().dtype(dtype), scale, zero_point);
+  const int64_t numel = self.numel();
+  if (numel == 0) {
+    return qtensor;
+  }
+  check_kernel_numel("quantize_per_tensor", numel);
+  Tensor rtensor = self.contiguous();
+  AT_DISPATCH_QINT_TYPES(dtype, "quantize_per_tensor_cuda", [&]() {
+    TORCH_CHECK(
+        zero_point >= std::numeric_limits<underlying_t>::min() &&
+            zero_point <= std::numeric_limits<underlying_t>::max(),
+        "quantize_per_tensor zero_point ",
+        zero_point,
+        " is out of range.");
+    quantize_per_tensor_affine_kernel<underlying_t><<<
+        GET_BLOCKS(numel),
+        CUDA_NUM_THREADS,
+        0,
+        at::cuda::getCurrentCUDAStream()>>>(
+        rtensor.data_ptr<float>(),
+        reinterpret_cast<underlying_t*>(qtensor.data_ptr<scalar_t>()),
+        static_cast<float>(scale),
+        zero_point,
+        std::numeric_limits<underlying_t>::min(),
+        std::numeric_limits<underlying_t>::max(),
+        numel);
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+  return qtensor;
+}
+
+Tensor dequantize_quantized_cuda(const Tensor& self) {
+  TORCH_CHECK(
+      self.qscheme() == kPerTensorAffine,
+      "dequantize on CUDA only supports per tensor affine quantized tensors.");
+  Tensor rtensor = at::empty(self.sizes(), self.options().dtype(kFloat));
+  const int64_t numel = self.numel();
+  if (numel == 0) {
+    return rtensor;
+  }
+  check_kernel_numel("dequantize", numel);
+  Tensor qtensor = self.contiguous();
+  AT_DISPATCH_QINT_TYPES(self.scalar_type(), "dequantize_cuda", [&]() {
+    dequantize_per_tensor_affine_kernel<underlying_t><<<
+        GET_BLOCKS(numel),
+        CUDA_NUM_THREADS,
+        0,
+        at::cuda::getCurrentCUDAStream()>>>(
+        reinterpret_cast<underlying_t*>(qtensor.data_ptr<scalar_t>()),
+        rtensor.data_ptr<float>(),
+        static_cast<float>(qtensor.q_scale()),
+        qtensor.q_zero_point(),
+        numel);
+  });
+  AT_CUDA_CHECK(cudaGetLastError());
+  return rtensor;
+}
+
+Tensor int_repr_quantized_cuda(const Tensor& self) {
+  Tensor dst;
+  AT_DISPATCH_QINT_TYPES(self.scalar_type(), "int_repr_cuda", [&]() {
+    dst = at::empty(self.sizes(), self.options().dtype(UNDERLYING_TYPE));
+  });
+  if (self.numel() > 0) {
+    Tensor self_contig = self.contiguous();
+    AT_CUDA_CHECK(cudaMemcpyAsync(
+        dst.data_ptr(),
+        self_contig.data_ptr(),
+        self.nbytes(),
+        cudaMemcpyDeviceToDevice,
+        at::cuda::getCurrentCUDAStream()));
+  }
+  return dst;
+}
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <c10/util/Optional.h>
+
+// The packed weight of quantized::linear on CUDA, prepared by
+// quantized::linear_prepack from a per tensor affine qint8 weight of shape
+// [N, K]. cuBLAS only multiplies int8 matrices whose leading dimensions are
+// multiples of 4, so w holds the int8 representation of the weight padded
+// with zeros to [round_up(N, 4), round_up(K, 4)]. The column offsets are the
+// sums of the N weight rows, needed to correct for the activation zero point.
+struct PackedLinearWeightCublas {
+  at::Tensor w;
+  at::Tensor col_offsets;
+  at::Tensor orig_weight;
+  c10::optional<at::Tensor> bias;
+  double w_scale;
+  int64_t w_zp;
+};
+
+namespace at {
+namespace native {
+namespace cublas_utils {
+
+inline int64_t round_up_to_multiple_of_4(int64_t x) {
+  return (x + 3) / 4 * 4;
+}
+
+// Writes the activation `input`, a contiguous quint8 tensor viewed as
+// [M, K], into the int8 matrix `shifted` of shape [M, padded_K] as
+// input - 128. The padding columns of `shifted` are left alone and have to be
+// zero.
+void linear_shift_input_cuda(const Tensor& input, Tensor& shifted);
+
+// Requantizes the int32 accumulators `acc` of shape [M, padded_N], holding
+// (input - 128) * w^T, into the quint8 `output` of shape [M, N].
+// `row_offsets` are the sums of the M rows of the shifted input and are only
+// read when the weight zero point is not zero.
+void linear_requantize_cuda(
+    const Tensor& acc,
+    const Tensor& row_offsets,
+    const PackedLinearWeightCublas& pack,
+    double input_scale,
+    int64_t input_zero_point,
+    bool relu_fused,
+    Tensor& output);
+
+} // namespace cublas_utils
+} // namespace native
+} // namespace at
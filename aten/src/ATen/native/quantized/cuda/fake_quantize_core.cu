@@ -1,6 +1,8 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/cuda/CUDAApplyUtils.cuh>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cuda/Loops.cuh>
 #include <cmath>
 
 /* Fake quantize a tensor, common block for per-channel & per-tensor fake quant
@@ -24,17 +26,17 @@ void fake_quantize_slice_cuda(
     int64_t quant_min,
     int64_t quant_max) {
   float inv_scale = 1.0f / scale;
-  at::cuda::CUDA_tensor_apply2<float, float>(
-      input, output, [=] __device__(const float& input_val, float& result_val) {
-        result_val = (fminf(
-                          quant_max,
-                          fmaxf(
-                              quant_min,
-                              static_cast<int64_t>(std::nearbyint(
-                                  input_val * inv_scale + zero_point)))) -
-                      zero_point) *
-            scale;
-      });
+  auto iter = TensorIterator::unary_op(output, input);
+  gpu_kernel(iter, [=] GPU_LAMBDA(float input_val) -> float {
+    return (fminf(
+                quant_max,
+                fmaxf(
+                    quant_min,
+                    static_cast<int64_t>(
+                        std::nearbyint(input_val * inv_scale + zero_point)))) -
+            zero_point) *
+        scale;
+  });
 }
 
 void fake_quantize_grad_slice_cuda(
@@ -46,13 +48,31 @@ void fake_quantize_grad_slice_cuda(
     int64_t quant_min,
     int64_t quant_max) {
   float inv_scale = 1.0f / scale;
-  at::cuda::CUDA_tensor_apply3<float, float, float>(
-      output_grad,
+  auto iter = TensorIterator::binary_op(input_grad, input, output_grad);
+  gpu_kernel(iter, [=] GPU_LAMBDA(float x, float dy) -> float {
+    int64_t Xq = std::nearbyint(x * inv_scale + zero_point);
+    return (Xq >= quant_min && Xq <= quant_max) * dy;
+  });
+}
+
+void fake_quantize_cachemask_slice_cuda(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    float scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  float inv_scale = 1.0f / scale;
+  at::cuda::CUDA_tensor_apply3<float, float, bool>(
       input,
-      input_grad,
-      [=] __device__(const float& dy, const float& x, float& dx) {
-        int64_t Xq = std::nearbyint(x * inv_scale + zero_point);
-        dx = (Xq >= quant_min && Xq <= quant_max) * dy;
+      output,
+      mask,
+      [=] __device__(const float& input_val, float& result_val, bool& mask_val) {
+        int64_t Xq = std::nearbyint(input_val * inv_scale + zero_point);
+        mask_val = Xq >= quant_min && Xq <= quant_max;
+        result_val = (fminf(quant_max, fmaxf(quant_min, Xq)) - zero_point) *
+            scale;
       });
 }
 
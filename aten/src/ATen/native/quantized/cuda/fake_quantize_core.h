@@ -24,5 +24,14 @@ void fake_quantize_grad_slice_cuda(
     int64_t quant_min,
     int64_t quant_max);
 
+void fake_quantize_cachemask_slice_cuda(
+    Tensor& output,
+    Tensor& mask,
+    const Tensor& input,
+    float sc,
+    int64_t z_point,
+    int64_t quant_min,
+    int64_t quant_max);
+
 } // namespace native
 } // namespace at
@@ -38,6 +38,39 @@ Tensor fake_quantize_per_tensor_affine_cuda(
   return Y;
 }
 
+/* Fake-quantizes the 'inputs' tensor and saves the straight-through mask.
+Args:
+  self: Forward input tensor.
+  scale: scale of per tensor affine quantization
+  zero_point: zero_point of per tensor affine quantization
+  quant_min: minimum quantized value
+  quant_max: maximum quantized value
+Returns:
+  Fake quantized tensor and the bool mask used by the backward.
+*/
+std::tuple<Tensor, Tensor> fake_quantize_per_tensor_affine_cachemask_cuda(
+    const Tensor& self,
+    double scale,
+    int64_t zero_point,
+    int64_t quant_min,
+    int64_t quant_max) {
+  TORCH_CHECK(self.is_cuda());
+  TORCH_CHECK(self.scalar_type() == ScalarType::Float);
+  TORCH_CHECK(
+      quant_min <= quant_max,
+      "`quant_min` should be less than or \
+        equal to `quant_max`.");
+  TORCH_CHECK(
+      zero_point >= quant_min && zero_point <= quant_max,
+      "`zero_point` must be between `quant_min` and `quant_max`.");
+  auto Y = at::empty_like(self, self.options(), MemoryFormat::Preserve);
+  auto mask = at::empty_like(
+      self, self.options().dtype(at::kBool), MemoryFormat::Preserve);
+  fake_quantize_cachemask_slice_cuda(
+      Y, mask, self, scale, zero_point, quant_min, quant_max);
+  return std::make_tuple(Y, mask);
+}
+
 /* Backward path to fake-quantize the 'inputs' tensor.
 
 Args:
@@ -0,0 +1,115 @@
+#include <ATen/ATen.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/cpp_custom_type_hack.h>
+#include <ATen/cuda/CUDABlas.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/quantized/cuda/cublas_utils.h>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <vector>
+
+namespace at {
+namespace native {
+namespace {
+
+// uint8 * int8 -> uint8 through cuBLAS. The activation is shifted to int8,
+// multiplied with the padded int8 weight into int32 accumulators, and the
+// accumulators are corrected for the zero points and requantized.
+template <bool ReluFused>
+class QLinearInt8Cublas final : public torch::OperatorKernel {
+ public:
+  at::Tensor operator()(
+      at::Tensor input,
+      at::Tensor packed_weight,
+      double output_scale,
+      int64_t output_zero_point) {
+    TORCH_CHECK(
+        input.scalar_type() == kQUInt8 && input.qscheme() == kPerTensorAffine,
+        "quantized::linear on CUDA expects a per tensor affine quantized"
+        " quint8 input");
+    TORCH_CHECK(
+        cpp_custom_type_hack::isa<PackedLinearWeightCublas>(packed_weight),
+        "quantized::linear on CUDA expects a weight packed by"
+        " quantized::linear_prepack from a CUDA weight");
+    auto& pack =
+        cpp_custom_type_hack::cast<PackedLinearWeightCublas>(packed_weight);
+    TORCH_CHECK(
+        input.device() == pack.w.device(),
+        "quantized::linear expects the input on the device of the packed"
+        " weight, ",
+        pack.w.device(),
+        ", but got ",
+        input.device());
+    const cuda::OptionalCUDAGuard device_guard(device_of(input));
+    const cudaDeviceProp* prop = at::cuda::getCurrentDeviceProperties();
+    TORCH_CHECK(
+        prop->major * 10 + prop->minor >= 61,
+        "quantized::linear on CUDA needs int8 matrix multiplication, which"
+        " requires compute capability 6.1 or newer");
+
+    auto input_contig = input.contiguous();
+    TORCH_CHECK(input_contig.dim() >= 1, "quantized::linear expects a tensor input");
+    const int64_t K = input_contig.size(input_contig.dim() - 1);
+    const int64_t N = pack.orig_weight.size(0);
+    TORCH_CHECK(
+        K == pack.orig_weight.size(1),
+        "The number of rows in the packB should be equal to K: ",
+        K);
+    const int64_t M = input_contig.numel() / K;
+    const int64_t padded_K = pack.w.size(1);
+    const int64_t padded_N = pack.w.size(0);
+
+    std::vector<int64_t> out_sizes = input_contig.sizes().vec();
+    out_sizes.back() = N;
+    auto output = _empty_affine_quantized(
+        out_sizes,
+        at::device(input.device()).dtype(kQUInt8),
+        output_scale,
+        output_zero_point);
+    if (M == 0) {
+      return output;
+    }
+
+    auto shifted = at::zeros({M, padded_K}, input.options().dtype(kChar));
+    cublas_utils::linear_shift_input_cuda(input_contig, shifted);
+    auto acc = at::empty({M, padded_N}, input.options().dtype(kInt));
+    // Column-major acc^T = w_padded * shifted^T, i.e. row-major
+    // acc = shifted * w_padded^T.
+    at::cuda::blas::int8_gemm(
+        padded_N,
+        M,
+        padded_K,
+        pack.w.data_ptr<int8_t>(),
+        padded_K,
+        shifted.data_ptr<int8_t>(),
+        padded_K,
+        acc.data_ptr<int32_t>(),
+        padded_N);
+    Tensor row_offsets;
+    if (pack.w_zp != 0) {
+      row_offsets = shifted.sum(1, /*keepdim=*/false, kInt);
+    }
+    cublas_utils::linear_requantize_cuda(
+        acc,
+        row_offsets,
+        pack,
+        input_contig.q_scale(),
+        input_contig.q_zero_point(),
+        ReluFused,
+        output);
+    return output;
+  }
+};
+
+static auto registry =
+    torch::RegisterOperators()
+        .op("quantized::linear(Tensor X, Tensor W_prepack, float Y_scale_i, int Y_zero_point_i) -> Tensor Y",
+            torch::RegisterOperators::options().kernel<QLinearInt8Cublas<false>>(
+                DispatchKey::QuantizedCUDATensorId))
+        .op("quantized::linear_relu(Tensor X, Tensor W_prepack, float Y_scale_i, int Y_zero_point_i) -> Tensor Y",
+            torch::RegisterOperators::options().kernel<QLinearInt8Cublas<true>>(
+                DispatchKey::QuantizedCUDATensorId));
+
+} // namespace
+} // namespace native
+} // namespace at
@@ -0,0 +1,142 @@
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/detail/KernelUtils.h>
+#include <ATen/native/quantized/cuda/cublas_utils.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace at {
+namespace native {
+namespace cublas_utils {
+
+using at::cuda::detail::CUDA_NUM_THREADS;
+using at::cuda::detail::GET_BLOCKS;
+
+namespace {
+
+__global__ void linear_shift_input_kernel(
+    const uint8_t* input,
+    int8_t* shifted,
+    int64_t K,
+    int64_t padded_K,
+    int64_t numel) {
+  CUDA_KERNEL_LOOP(i, numel) {
+    const int64_t m = i / K;
+    const int64_t k = i % K;
+    shifted[m * padded_K + k] =
+        static_cast<int8_t>(static_cast<int32_t>(input[i]) - 128);
+  }
+}
+
+// With c = 128 - input_zero_point, the accumulator of the shifted input is
+// sum((x - 128) * w), and the product of the zero point corrected operands is
+//   sum((x - x_zp) * (w - w_zp))
+//     = acc + c * sum(w) - w_zp * sum(x - 128) - K * c * w_zp.
+__global__ void linear_requantize_kernel(
+    const int32_t* acc,
+    int64_t padded_N,
+    const int32_t* row_offsets,
+    const int32_t* col_offsets,
+    const float* bias,
+    int64_t N,
+    int64_t K,
+    int32_t input_shift,
+    int32_t w_zp,
+    float multiplier,
+    float inv_output_scale,
+    int32_t output_zero_point,
+    int32_t output_min,
+    uint8_t* output,
+    int64_t numel) {
+  CUDA_KERNEL_LOOP(i, numel) {
+    const int64_t m = i / N;
+    const int64_t n = i % N;
+    int64_t raw = static_cast<int64_t>(acc[m * padded_N + n]) +
+        static_cast<int64_t>(input_shift) * col_offsets[n] -
+        K * input_shift * w_zp;
+    if (row_offsets != nullptr) {
+      raw -= static_cast<int64_t>(w_zp) * row_offsets[m];
+    }
+    float y = static_cast<float>(raw) * multiplier;
+    if (bias != nullptr) {
+      y += bias[n] * inv_output_scale;
+    }
+    const int32_t q = static_cast<int32_t>(nearbyintf(y)) + output_zero_point;
+    output[i] = static_cast<uint8_t>(min(max(q, output_min), 255));
+  }
+}
+
+} // namespace
+
+void linear_shift_input_cuda(const Tensor& input, Tensor& shifted) {
+  const int64_t numel = input.numel();
+  if (numel == 0) {
+    return;
+  }
+  TORCH_CHECK(
+      numel <= std::numeric_limits<int>::max(),
+      "quantized::linear on CUDA supports at most ",
+      std::numeric_limits<int>::max(),
+      " input elements");
+  const int64_t K = input.size(input.dim() - 1);
+  linear_shift_input_kernel<<<
+      GET_BLOCKS(numel),
+      CUDA_NUM_THREADS,
+      0,
+      at::cuda::getCurrentCUDAStream()>>>(
+      reinterpret_cast<const uint8_t*>(input.data_ptr<c10::quint8>()),
+      shifted.data_ptr<int8_t>(),
+      K,
+      shifted.size(1),
+      numel);
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+void linear_requantize_cuda(
+    const Tensor& acc,
+    const Tensor& row_offsets,
+    const PackedLinearWeightCublas& pack,
+    double input_scale,
+    int64_t input_zero_point,
+    bool relu_fused,
+    Tensor& output) {
+  const int64_t numel = output.numel();
+  if (numel == 0) {
+    return;
+  }
+  TORCH_CHECK(
+      numel <= std::numeric_limits<int>::max(),
+      "quantized::linear on CUDA supports at most ",
+      std::numeric_limits<int>::max(),
+      " output elements");
+  const int64_t N = pack.orig_weight.size(0);
+  const int64_t K = pack.orig_weight.size(1);
+  const double output_scale = output.q_scale();
+  const int32_t output_zero_point = output.q_zero_point();
+  linear_requantize_kernel<<<
+      GET_BLOCKS(numel),
+      CUDA_NUM_THREADS,
+      0,
+      at::cuda::getCurrentCUDAStream()>>>(
+      acc.data_ptr<int32_t>(),
+      acc.size(1),
+      pack.w_zp != 0 ? row_offsets.data_ptr<int32_t>() : nullptr,
+      pack.col_offsets.data_ptr<int32_t>(),
+      pack.bias.has_value() ? pack.bias->data_ptr<float>() : nullptr,
+      N,
+      K,
+      static_cast<int32_t>(128 - input_zero_point),
+      static_cast<int32_t>(pack.w_zp),
+      static_cast<float>(input_scale * pack.w_scale / output_scale),
+      static_cast<float>(1.0 / output_scale),
+      output_zero_point,
+      relu_fused ? std::max<int32_t>(output_zero_point, 0) : 0,
+      reinterpret_cast<uint8_t*>(output.data_ptr<c10::quint8>()),
+      numel);
+  AT_CUDA_CHECK(cudaGetLastError());
+}
+
+} // namespace cublas_utils
+} // namespace native
+} // namespace at
@@ -0,0 +1,68 @@
+#include <ATen/ATen.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <ATen/cpp_custom_type_hack.h>
+#include <ATen/native/quantized/cuda/cublas_utils.h>
+#include <c10/cuda/CUDAGuard.h>
+
+namespace at {
+namespace native {
+namespace {
+
+class QLinearPackWeightInt8Cublas final : public c10::OperatorKernel {
+ public:
+  at::Tensor operator()(at::Tensor weight, c10::optional<Tensor> bias) {
+    TORCH_CHECK(
+        weight.dim() == 2,
+        "The weight tensor for quantized::linear_prepack (cuBLAS) should"
+        " be 2-dimensional.");
+    TORCH_CHECK(
+        weight.qscheme() == kPerTensorAffine &&
+            weight.scalar_type() == kQInt8,
+        "quantized::linear_prepack (cuBLAS) only supports per tensor affine"
+        " quantized qint8 weights");
+    const int64_t N = weight.size(0);
+    const int64_t K = weight.size(1);
+    TORCH_CHECK(
+        N > 0 && K > 0,
+        "quantized::linear_prepack (cuBLAS) expects a non-empty weight");
+    if (bias.has_value()) {
+      TORCH_CHECK(
+          bias->dim() == 1 && bias->size(0) == N,
+          "bias should be a vector (1D Tensor) of size ",
+          N);
+      TORCH_CHECK(
+          bias->scalar_type() == kFloat && bias->device() == weight.device(),
+          "quantized::linear_prepack (cuBLAS) expects a float bias on the"
+          " device of the weight");
+      bias = bias->contiguous();
+    }
+    const cuda::OptionalCUDAGuard device_guard(device_of(weight));
+
+    auto weight_int8 = weight.int_repr();
+    auto w = at::zeros(
+        {cublas_utils::round_up_to_multiple_of_4(N),
+         cublas_utils::round_up_to_multiple_of_4(K)},
+        weight_int8.options());
+    w.narrow(0, 0, N).narrow(1, 0, K).copy_(weight_int8);
+    auto col_offsets = weight_int8.sum(1, /*keepdim=*/false, kInt);
+
+    auto ret_ptr = std::make_unique<PackedLinearWeightCublas>(
+        PackedLinearWeightCublas{w,
+                                 col_offsets,
+                                 weight,
+                                 bias,
+                                 weight.q_scale(),
+                                 weight.q_zero_point()});
+    return cpp_custom_type_hack::create(std::move(ret_ptr), weight.options());
+  }
+};
+
+static auto registry = c10::RegisterOperators().op(
+    "quantized::linear_prepack(Tensor W, Tensor? B=None) -> Tensor W_prepack",
+    c10::RegisterOperators::options()
+        .kernel<QLinearPackWeightInt8Cublas>(
+            DispatchKey::QuantizedCUDATensorId));
+
+} // namespace
+} // namespace native
+} // namespace at
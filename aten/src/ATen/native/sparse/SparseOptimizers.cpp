@@ -0,0 +1,318 @@
+// Optimizer steps for sparse gradients that only update the touched rows.
+#include <ATen/native/sparse/SparseOptimizers.h>
+
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/SparseTensorUtils.h>
+
+#include <caffe2/perfkernels/adagrad.h>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace at { namespace native {
+
+using namespace at::sparse;
+
+SparseRowGrad sparse_row_grad(
+    const char* op,
+    const Tensor& self,
+    const SparseTensor& grad) {
+  TORCH_CHECK(grad.is_sparse(), op, ": expected a sparse gradient");
+  TORCH_CHECK(
+      grad.sizes() == self.sizes(),
+      op, ": expected a gradient of size ", self.sizes(), ", but got ",
+      grad.sizes());
+  TORCH_CHECK(
+      grad.scalar_type() == self.scalar_type(),
+      op, ": expected a gradient of dtype ", self.scalar_type(), ", but got ",
+      grad.scalar_type());
+
+  // The updates are non-linear, so the rows must be unique.
+  const auto coalesced = grad.coalesce();
+  const auto sparse_dim = coalesced.sparse_dim();
+  SparseRowGrad result;
+  result.num_rows = 1;
+  for (int64_t d = 0; d < sparse_dim; d++) {
+    result.num_rows *= self.size(d);
+  }
+  result.row_size = 1;
+  for (int64_t d = sparse_dim; d < self.dim(); d++) {
+    result.row_size *= self.size(d);
+  }
+  result.rows =
+      flatten_indices(coalesced._indices(), self.sizes()).contiguous();
+  result.values = coalesced._values()
+                      .reshape({result.rows.numel(), result.row_size})
+                      .contiguous();
+  return result;
+}
+
+void check_sparse_optimizer_state(
+    const char* op,
+    const Tensor& self,
+    const Tensor& state,
+    const char* state_name,
+    IntArrayRef expected_sizes) {
+  TORCH_CHECK(
+      state.sizes() == expected_sizes,
+      op, ": expected ", state_name, " of size ", expected_sizes,
+      ", but got ", state.sizes());
+  TORCH_CHECK(
+      state.scalar_type() == self.scalar_type() &&
+          state.device() == self.device(),
+      op, ": expected ", state_name, " to have the dtype and device of self");
+}
+
+Tensor contiguous_sparse_optimizer_state(
+    const Tensor& state,
+    IntArrayRef sizes) {
+  return state.contiguous().view(sizes);
+}
+
+void copy_sparse_optimizer_state_back(
+    Tensor& state,
+    const Tensor& contiguous) {
+  if (!contiguous.is_alias_of(state)) {
+    state.copy_(contiguous.view(state.sizes()));
+  }
+}
+
+void sparse_adagrad_reference(
+    Tensor param,
+    Tensor state_sum,
+    const SparseRowGrad& grad,
+    double lr,
+    double eps) {
+  const auto sum =
+      state_sum.index_select(0, grad.rows).addcmul_(grad.values, grad.values);
+  state_sum.index_copy_(0, grad.rows, sum);
+  param.index_add_(
+      0, grad.rows, grad.values.div(sum.sqrt_().add_(eps)).mul_(-lr));
+}
+
+void sparse_rowwise_adagrad_reference(
+    Tensor param,
+    Tensor state_sum,
+    const SparseRowGrad& grad,
+    double lr,
+    double eps) {
+  const auto sum = state_sum.index_select(0, grad.rows)
+                       .add_(grad.values.pow(2).mean(1));
+  state_sum.index_copy_(0, grad.rows, sum);
+  param.index_add_(
+      0,
+      grad.rows,
+      grad.values.div(sum.sqrt_().add_(eps).unsqueeze(1)).mul_(-lr));
+}
+
+void sparse_adam_reference(
+    Tensor param,
+    Tensor exp_avg,
+    Tensor exp_avg_sq,
+    const SparseRowGrad& grad,
+    double step_size,
+    double beta1,
+    double beta2,
+    double eps) {
+  const auto m = exp_avg.index_select(0, grad.rows)
+                     .mul_(beta1)
+                     .add_(grad.values, 1 - beta1);
+  const auto v = exp_avg_sq.index_select(0, grad.rows)
+                     .mul_(beta2)
+                     .addcmul_(grad.values, grad.values, 1 - beta2);
+  exp_avg.index_copy_(0, grad.rows, m);
+  exp_avg_sq.index_copy_(0, grad.rows, v);
+  param.index_add_(
+      0, grad.rows, m.div(v.sqrt().add_(eps)).mul_(-step_size));
+}
+
+namespace {
+
+// Number of touched rows updated by one task.
+int64_t rows_per_task(const SparseRowGrad& grad) {
+  return std::max<int64_t>(
+      1, at::internal::GRAIN_SIZE / std::max<int64_t>(grad.row_size, 1));
+}
+
+} // namespace
+
+Tensor& _sparse_adagrad_cpu_(
+    Tensor& self,
+    Tensor& state_sum,
+    const SparseTensor& grad,
+    double lr,
+    double eps) {
+  check_sparse_optimizer_state(
+      "_sparse_adagrad_", self, state_sum, "state_sum", self.sizes());
+  const auto g = sparse_row_grad("_sparse_adagrad_", self, grad);
+  if (g.rows.numel() == 0) {
+    return self;
+  }
+  auto param = contiguous_sparse_optimizer_state(
+      self, {g.num_rows, g.row_size});
+  auto sum = contiguous_sparse_optimizer_state(
+      state_sum, {g.num_rows, g.row_size});
+
+  if (self.scalar_type() == kFloat && g.row_size <= INT_MAX) {
+    const auto rows = g.rows.data_ptr<int64_t>();
+    const auto values = g.values.data_ptr<float>();
+    const auto param_data = param.data_ptr<float>();
+    const auto sum_data = sum.data_ptr<float>();
+    const int row_size = g.row_size;
+    at::parallel_for(
+        0, g.rows.numel(), rows_per_task(g), [&](int64_t begin, int64_t end) {
+          // The rows are unique, so the tasks update disjoint parameters.
+          const int num_rows = end - begin;
+          const int updated = caffe2::sparse_adagrad(
+              num_rows,
+              row_size,
+              param.numel(),
+              param_data,
+              values + begin * row_size,
+              sum_data,
+              rows + begin,
+              param_data,
+              sum_data,
+              eps,
+              -lr);
+          TORCH_CHECK(
+              updated == num_rows,
+              "_sparse_adagrad_: index ", rows[begin + updated],
+              " of the gradient is out of range");
+        });
+  } else {
+    sparse_adagrad_reference(param, sum, g, lr, eps);
+  }
+
+  copy_sparse_optimizer_state_back(self, param);
+  copy_sparse_optimizer_state_back(state_sum, sum);
+  return self;
+}
+
+Tensor& _sparse_rowwise_adagrad_cpu_(
+    Tensor& self,
+    Tensor& state_sum,
+    const SparseTensor& grad,
+    double lr,
+    double eps) {
+  TORCH_CHECK(
+      grad.is_sparse() && grad.sparse_dim() <= self.dim(),
+      "_sparse_rowwise_adagrad_: expected a sparse gradient");
+  check_sparse_optimizer_state(
+      "_sparse_rowwise_adagrad_",
+      self,
+      state_sum,
+      "state_sum",
+      self.sizes().slice(0, grad.sparse_dim()));
+  const auto g = sparse_row_grad("_sparse_rowwise_adagrad_", self, grad);
+  if (g.rows.numel() == 0) {
+    return self;
+  }
+  auto param = contiguous_sparse_optimizer_state(
+      self, {g.num_rows, g.row_size});
+  auto sum = contiguous_sparse_optimizer_state(state_sum, {g.num_rows});
+
+  if (self.scalar_type() == kFloat && g.row_size <= INT_MAX) {
+    const auto rows = g.rows.data_ptr<int64_t>();
+    const auto values = g.values.data_ptr<float>();
+    const auto param_data = param.data_ptr<float>();
+    const auto sum_data = sum.data_ptr<float>();
+    const int row_size = g.row_size;
+    at::parallel_for(
+        0, g.rows.numel(), rows_per_task(g), [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; i++) {
+            const auto row = rows[i];
+            // Prefetches the next row of the task.
+            const auto next = rows[std::min(i + 1, end - 1)];
+            caffe2::rowwise_adagrad_update(
+                row_size,
+                param_data + row * row_size,
+                param_data + next * row_size,
+                values + i * row_size,
+                sum_data + row,
+                sum_data + next,
+                eps,
+                -lr);
+          }
+        });
+  } else {
+    sparse_rowwise_adagrad_reference(param, sum, g, lr, eps);
+  }
+
+  copy_sparse_optimizer_state_back(self, param);
+  copy_sparse_optimizer_state_back(state_sum, sum);
+  return self;
+}
+
+Tensor& _sparse_adam_cpu_(
+    Tensor& self,
+    Tensor& exp_avg,
+    Tensor& exp_avg_sq,
+    const SparseTensor& grad,
+    int64_t step,
+    double lr,
+    double beta1,
+    double beta2,
+    double eps) {
+  check_sparse_optimizer_state(
+      "_sparse_adam_", self, exp_avg, "exp_avg", self.sizes());
+  check_sparse_optimizer_state(
+      "_sparse_adam_", self, exp_avg_sq, "exp_avg_sq", self.sizes());
+  TORCH_CHECK(step > 0, "_sparse_adam_: expected a positive step, got ", step);
+  const auto g = sparse_row_grad("_sparse_adam_", self, grad);
+  if (g.rows.numel() == 0) {
+    return self;
+  }
+  const double bias_correction1 = 1 - std::pow(beta1, step);
+  const double bias_correction2 = 1 - std::pow(beta2, step);
+  const double step_size = lr * std::sqrt(bias_correction2) / bias_correction1;
+  auto param = contiguous_sparse_optimizer_state(
+      self, {g.num_rows, g.row_size});
+  auto m = contiguous_sparse_optimizer_state(
+      exp_avg, {g.num_rows, g.row_size});
+  auto v = contiguous_sparse_optimizer_state(
+      exp_avg_sq, {g.num_rows, g.row_size});
+
+  if (self.scalar_type() == kFloat || self.scalar_type() == kDouble) {
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "_sparse_adam_cpu_", [&] {
+      const auto rows = g.rows.data_ptr<int64_t>();
+      const auto values = g.values.data_ptr<scalar_t>();
+      const auto param_data = param.data_ptr<scalar_t>();
+      const auto m_data = m.data_ptr<scalar_t>();
+      const auto v_data = v.data_ptr<scalar_t>();
+      const auto row_size = g.row_size;
+      const auto beta1_ = static_cast<scalar_t>(beta1);
+      const auto beta2_ = static_cast<scalar_t>(beta2);
+      const auto eps_ = static_cast<scalar_t>(eps);
+      const auto step_size_ = static_cast<scalar_t>(step_size);
+      at::parallel_for(
+          0, g.rows.numel(), rows_per_task(g), [&](int64_t begin, int64_t end) {
+            for (int64_t i = begin; i < end; i++) {
+              const auto grad_row = values + i * row_size;
+              const auto offset = rows[i] * row_size;
+              for (int64_t j = 0; j < row_size; j++) {
+                const scalar_t gj = grad_row[j];
+                const scalar_t mj = m_data[offset + j] =
+                    beta1_ * m_data[offset + j] + (1 - beta1_) * gj;
+                const scalar_t vj = v_data[offset + j] =
+                    beta2_ * v_data[offset + j] + (1 - beta2_) * gj * gj;
+                param_data[offset + j] -=
+                    step_size_ * mj / (std::sqrt(vj) + eps_);
+              }
+            }
+          });
+    });
+  } else {
+    sparse_adam_reference(param, m, v, g, step_size, beta1, beta2, eps);
+  }
+
+  copy_sparse_optimizer_state_back(self, param);
+  copy_sparse_optimizer_state_back(exp_avg, m);
+  copy_sparse_optimizer_state_back(exp_avg_sq, v);
+  return self;
+}
+
+}} // namespace at::native
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/SparseTensorUtils.h>
+
+// Helpers shared by the CPU and CUDA implementations of the sparse optimizer
+// steps (_sparse_adagrad_, _sparse_rowwise_adagrad_ and _sparse_adam_). They
+// view a parameter as a matrix with one row per element of the sparse
+// dimensions of its gradient and only update the rows the gradient touches.
+
+namespace at { namespace native {
+
+struct SparseRowGrad {
+  // Unique indices of the touched rows, a 1-D int64 tensor.
+  Tensor rows;
+  // Contiguous ``rows.numel() x row_size`` gradients of the touched rows.
+  Tensor values;
+  int64_t num_rows;
+  int64_t row_size;
+};
+
+// Coalesces ``grad``, a sparse gradient of ``self``, into the touched rows.
+CAFFE2_API SparseRowGrad sparse_row_grad(
+    const char* op,
+    const Tensor& self,
+    const sparse::SparseTensor& grad);
+
+// Checks that ``state`` has ``expected_sizes`` and the dtype and device of
+// ``self``.
+CAFFE2_API void check_sparse_optimizer_state(
+    const char* op,
+    const Tensor& self,
+    const Tensor& state,
+    const char* state_name,
+    IntArrayRef expected_sizes);
+
+// Returns ``state`` as a contiguous tensor of ``sizes``, a copy if ``state``
+// is not contiguous. The steps work on these and write them back to the
+// original tensors with copy_sparse_optimizer_state_back.
+CAFFE2_API Tensor contiguous_sparse_optimizer_state(
+    const Tensor& state,
+    IntArrayRef sizes);
+
+CAFFE2_API void copy_sparse_optimizer_state_back(
+    Tensor& state,
+    const Tensor& contiguous);
+
+// Updates the touched rows with regular tensor ops, for the dtypes the fused
+// kernels do not support. ``param`` and the states are the contiguous tensors
+// returned by contiguous_sparse_optimizer_state, ``state_sum`` of the
+// row-wise variant has one element per row.
+CAFFE2_API void sparse_adagrad_reference(
+    Tensor param,
+    Tensor state_sum,
+    const SparseRowGrad& grad,
+    double lr,
+    double eps);
+
+CAFFE2_API void sparse_rowwise_adagrad_reference(
+    Tensor param,
+    Tensor state_sum,
+    const SparseRowGrad& grad,
+    double lr,
+    double eps);
+
+CAFFE2_API void sparse_adam_reference(
+    Tensor param,
+    Tensor exp_avg,
+    Tensor exp_avg_sq,
+    const SparseRowGrad& grad,
+    double step_size,
+    double beta1,
+    double beta2,
+    double eps);
+
+}} // namespace at::native
@@ -352,6 +352,85 @@ SparseTensor& copy_sparse_(SparseTensor& self, const SparseTensor& src, bool non
   return self._coalesced_(src.is_coalesced());
 }
 
+namespace {
+
+// The coalesce helpers below keep per-chunk state (radix histograms, segment
+// counts), so the input is split into a fixed number of contiguous chunks
+// instead of leaving the partition to at::parallel_for.
+constexpr int kCoalesceRadixBits = 8;
+constexpr int64_t kCoalesceRadixSize = 1 << kCoalesceRadixBits;
+
+inline int64_t coalesce_num_chunks(int64_t n) {
+  int64_t max_chunks = (n + at::internal::GRAIN_SIZE - 1) / at::internal::GRAIN_SIZE;
+  return std::max<int64_t>(1, std::min<int64_t>(at::get_num_threads(), max_chunks));
+}
+
+inline std::pair<int64_t, int64_t> coalesce_chunk_range(int64_t chunk, int64_t num_chunks, int64_t n) {
+  int64_t chunk_size = (n + num_chunks - 1) / num_chunks;
+  int64_t begin = std::min(n, chunk * chunk_size);
+  return {begin, std::min(n, begin + chunk_size)};
+}
+
+template <typename F>
+inline void coalesce_for_each_chunk(int64_t num_chunks, const F& f) {
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      f(c);
+    }
+  });
+}
+
+// Stable LSD radix sort of the non-negative `keys`, carrying `perm` along.
+// `keys_tmp` and `perm_tmp` are scratch buffers of the same length; on return
+// `keys` and `perm` point at whichever pair of buffers holds the result.
+void coalesce_radix_sort(
+    int64_t*& keys, int64_t*& perm, int64_t*& keys_tmp, int64_t*& perm_tmp,
+    int64_t n, int num_bits, int64_t num_chunks) {
+  std::vector<int64_t> hist(num_chunks * kCoalesceRadixSize);
+  for (int shift = 0; shift < num_bits; shift += kCoalesceRadixBits) {
+    coalesce_for_each_chunk(num_chunks, [&](int64_t c) {
+      int64_t* h = hist.data() + c * kCoalesceRadixSize;
+      std::fill(h, h + kCoalesceRadixSize, 0);
+      auto range = coalesce_chunk_range(c, num_chunks, n);
+      for (int64_t i = range.first; i < range.second; i++) {
+        h[(static_cast<uint64_t>(keys[i]) >> shift) & (kCoalesceRadixSize - 1)]++;
+      }
+    });
+
+    // Exclusive scan in (digit, chunk) order, so that every chunk scatters
+    // into its own slots and the sort stays stable.
+    int64_t offset = 0;
+    bool single_digit = false;
+    for (int64_t d = 0; d < kCoalesceRadixSize; d++) {
+      int64_t digit_begin = offset;
+      for (int64_t c = 0; c < num_chunks; c++) {
+        int64_t count = hist[c * kCoalesceRadixSize + d];
+        hist[c * kCoalesceRadixSize + d] = offset;
+        offset += count;
+      }
+      single_digit = single_digit || (offset - digit_begin == n);
+    }
+    if (single_digit) {
+      // Every key shares this digit; the pass would be the identity.
+      continue;
+    }
+
+    coalesce_for_each_chunk(num_chunks, [&](int64_t c) {
+      int64_t* h = hist.data() + c * kCoalesceRadixSize;
+      auto range = coalesce_chunk_range(c, num_chunks, n);
+      for (int64_t i = range.first; i < range.second; i++) {
+        int64_t pos = h[(static_cast<uint64_t>(keys[i]) >> shift) & (kCoalesceRadixSize - 1)]++;
+        keys_tmp[pos] = keys[i];
+        perm_tmp[pos] = perm[i];
+      }
+    });
+    std::swap(keys, keys_tmp);
+    std::swap(perm, perm_tmp);
+  }
+}
+
+} // namespace
+
 SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   AT_ASSERT(self.defined());
   TORCH_INTERNAL_ASSERT(at::impl::variable_excluded_from_dispatch());
@@ -369,59 +448,124 @@ SparseTensor coalesce_sparse_cpu(const SparseTensor& self) {
   }
 
   LongTensor indices = self._indices();
-  Tensor values = self._values().contiguous();
+  Tensor values = self._values();
   int64_t sparse_dim = self.sparse_dim();
   int64_t dense_dim = self.dense_dim();
   int64_t nnz = self._nnz();
-
+  int64_t num_chunks = coalesce_num_chunks(nnz);
+
+  // Workspace rows: sort keys, permutation, and their radix scratch buffers.
+  LongTensor workspace = at::empty({4, nnz}, indices.options());
+  int64_t* keys = workspace[0].data_ptr<int64_t>();
+  int64_t* perm = workspace[1].data_ptr<int64_t>();
+  int64_t* keys_tmp = workspace[2].data_ptr<int64_t>();
+  int64_t* perm_tmp = workspace[3].data_ptr<int64_t>();
+
+  // flatten_indices may return a view of self's indices, so copy the keys
+  // into the workspace; the same pass checks whether they are already
+  // strictly increasing and collects the bit width needed to sort them.
   LongTensor indices_scalar = flatten_indices(indices, self.sizes());
+  auto indicesScalarAccessor = indices_scalar.accessor<int64_t, 1>();
+  std::vector<uint64_t> chunk_bits(num_chunks, 0);
+  std::vector<char> chunk_sorted(num_chunks, 1);
+  coalesce_for_each_chunk(num_chunks, [&](int64_t c) {
+    auto range = coalesce_chunk_range(c, num_chunks, nnz);
+    uint64_t bits = 0;
+    bool sorted = true;
+    for (int64_t i = range.first; i < range.second; i++) {
+      int64_t key = indicesScalarAccessor[i];
+      keys[i] = key;
+      perm[i] = i;
+      bits |= static_cast<uint64_t>(key);
+      sorted = sorted && (i == 0 || indicesScalarAccessor[i - 1] < key);
+    }
+    chunk_bits[c] = bits;
+    chunk_sorted[c] = sorted;
+  });
+
+  if (std::all_of(chunk_sorted.begin(), chunk_sorted.end(), [](char s) { return s; })) {
+    // Already sorted without duplicates: share indices and values with self
+    // and only record the flag, so nothing is copied.
+    SparseTensor dst = new_sparse(self.options());
+    get_sparse_impl(dst)->resize_(sparse_dim, dense_dim, self.sizes());
+    alias_into_sparse(dst, indices, values);
+    dst._coalesced_(true);
+    return dst;
+  }
+
+  uint64_t all_bits = 0;
+  for (auto bits : chunk_bits) {
+    all_bits |= bits;
+  }
+  int num_bits = 0;
+  while (num_bits < 64 && (all_bits >> num_bits) != 0) {
+    num_bits++;
+  }
+  coalesce_radix_sort(keys, perm, keys_tmp, perm_tmp, nnz, num_bits, num_chunks);
+
+  // Find the first position of every run of equal keys; the radix scratch
+  // buffer is free again after the sort and holds the run starts.
+  std::vector<int64_t> chunk_runs(num_chunks + 1, 0);
+  coalesce_for_each_chunk(num_chunks, [&](int64_t c) {
+    auto range = coalesce_chunk_range(c, num_chunks, nnz);
+    int64_t count = 0;
+    for (int64_t i = range.first; i < range.second; i++) {
+      count += (i == 0 || keys[i] != keys[i - 1]);
+    }
+    chunk_runs[c + 1] = count;
+  });
+  for (int64_t c = 0; c < num_chunks; c++) {
+    chunk_runs[c + 1] += chunk_runs[c];
+  }
+  int64_t newNnz = chunk_runs[num_chunks];
+  int64_t* run_starts = keys_tmp;
+  coalesce_for_each_chunk(num_chunks, [&](int64_t c) {
+    auto range = coalesce_chunk_range(c, num_chunks, nnz);
+    int64_t r = chunk_runs[c];
+    for (int64_t i = range.first; i < range.second; i++) {
+      if (i == 0 || keys[i] != keys[i - 1]) {
+        run_starts[r++] = i;
+      }
+    }
+  });
+  auto run_end = [&](int64_t r) { return r + 1 < newNnz ? run_starts[r + 1] : nnz; };
 
   SparseTensor dst = new_sparse(self.options());
   get_sparse_impl(dst)->resize_(sparse_dim, dense_dim, self.sizes());
-  // TODO: is there a more idiomatic way to do this?
-  LongTensor newIndices = at::empty(indices.sizes(), indices.options());
-  Tensor newValues = at::empty(values.sizes(), values.options());
+  LongTensor newIndices = at::empty({sparse_dim, newNnz}, indices.options());
+  Tensor newValues = new_values_with_size_of(values, newNnz);
   alias_into_sparse(dst, newIndices, newValues);
 
-  LongTensor indicesBuffer;
-  LongTensor indicesPermutation;
-  std::tie(indicesBuffer, indicesPermutation) = indices_scalar.sort(0);
-  // NB: The accessor accesses here rely on self._nnz() > 0 (tested earlier in this function)
   auto newIndicesAccessor = newIndices.accessor<int64_t, 2>();
   auto indicesAccessor = indices.accessor<int64_t, 2>();
-  auto indicesPermutationAccessor = indicesPermutation.accessor<int64_t, 1>();
-  auto indicesBufferAccessor = indicesBuffer.accessor<int64_t, 1>();
+  values = values.contiguous();
+  int64_t blockSize = values.numel() > 0 ? values.stride(0) : 0;
+  int64_t grain_size = std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, blockSize + sparse_dim));
 
-  int64_t i = -1;
+  // Each output row is written by exactly one run, so runs reduce in parallel.
   AT_DISPATCH_ALL_TYPES(
       values.scalar_type(), "coalesce", [&] {
-        int64_t prev = -1;
-        int64_t blockSize = values.stride(0);
         scalar_t* values_ptr = values.data_ptr<scalar_t>();
         scalar_t* newValues_ptr = newValues.data_ptr<scalar_t>();
-        for (int64_t j = 0; j < nnz; j++) {
-          int64_t pos = indicesPermutationAccessor[j];
-          int64_t curr = indicesBufferAccessor[j];
-          if (curr == prev) {
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
-            }
-          } else {
-            ++i;
+        at::parallel_for(0, newNnz, grain_size, [&](int64_t begin, int64_t end) {
+          for (int64_t r = begin; r < end; r++) {
+            int64_t first = run_starts[r];
+            int64_t pos = perm[first];
             for (int64_t d = 0; d < sparse_dim; d++) {
-              newIndicesAccessor[d][i] = indicesAccessor[d][pos];
+              newIndicesAccessor[d][r] = indicesAccessor[d][pos];
             }
-            if (values.numel() > 0) {  // if values is an empty tensor, there are no elements to copy
-              THBlas_copy<scalar_t>(blockSize, values_ptr + pos * blockSize, 1, newValues_ptr + i * blockSize, 1);
+            if (blockSize == 0) {  // if values is an empty tensor, there are no elements to copy
+              continue;
+            }
+            THBlas_copy<scalar_t>(blockSize, values_ptr + pos * blockSize, 1, newValues_ptr + r * blockSize, 1);
+            for (int64_t j = first + 1; j < run_end(r); j++) {
+              THBlas_axpy<scalar_t>(blockSize, 1, values_ptr + perm[j] * blockSize, 1, newValues_ptr + r * blockSize, 1);
             }
           }
-          prev = curr;
-        }
+        });
     });
 
   dst._coalesced_(true);
-  get_sparse_impl(dst)->set_nnz_and_narrow(i + 1);
-
   return dst;
 }
 
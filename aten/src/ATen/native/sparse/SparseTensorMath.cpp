@@ -43,6 +43,8 @@ namespace {
 
 }
 
+DEFINE_DISPATCH(sparse_csr_mm_stub);
+
 // --------------------------------------------------------------------
 // zero_(SparseTensor)
 // --------------------------------------------------------------------
@@ -265,14 +267,17 @@ SparseTensor& add_out_sparse_contiguous(SparseTensor& r, const SparseTensor& t,
 
     LongTensor r_indices = at::empty({src.sparse_dim(), max_nnz}, t._indices().options());
 
-    Tensor t_values = t._values().to(commonDtype);
-    Tensor s_values = src._values().to(commonDtype);
+    // The merge below walks the values with raw pointers; coalesced inputs with
+    // non-contiguous values are routed here too, so make them contiguous.
+    Tensor t_values = t._values().to(commonDtype).contiguous();
+    Tensor s_values = src._values().to(commonDtype).contiguous();
 
     Tensor r_values = new_values_with_size_of(s_values, max_nnz).zero_();
 
     int64_t blockSize = r_values.stride(0);
     int64_t cmp, d;
     int64_t r_i = 0, t_i = 0, s_i = 0;
+    bool increasing = !coalesced;
     auto t_indices = t._indices();
     auto src_indices = src._indices();
 
@@ -327,6 +332,17 @@ SparseTensor& add_out_sparse_contiguous(SparseTensor& r, const SparseTensor& t,
               }
               s_i++;
             }
+            // Uncoalesced inputs can still merge into strictly increasing
+            // indices; detect that here so the result skips a later coalesce.
+            if (increasing && r_i > 0) {
+              for (d = 0; d < sparse_dim; d++) {
+                if (r_indices_accessor[d][r_i - 1] != r_indices_accessor[d][r_i]) {
+                  break;
+                }
+              }
+              increasing = d < sparse_dim &&
+                  r_indices_accessor[d][r_i - 1] < r_indices_accessor[d][r_i];
+            }
             r_i++;
           }
         }
@@ -338,11 +354,7 @@ SparseTensor& add_out_sparse_contiguous(SparseTensor& r, const SparseTensor& t,
     get_sparse_impl(r)->set_indices_and_values_unsafe(r_indices, r_values);
     get_sparse_impl(r)->set_nnz_and_narrow(r_i);
 
-    // TODO: I think it may be possible to track inside the loop and
-    // detect when we are uncoalesced (e.g., by observing that an
-    // index goes backwards) which may be more precise than using the
-    // coalesced flag here.  But this is easy.
-    return r._coalesced_(coalesced);
+    return r._coalesced_(coalesced || increasing);
 }
 
 SparseTensor& add_out_sparse_non_contiguous(SparseTensor& r, const SparseTensor& t, const SparseTensor& src, Scalar value, ScalarType commonDtype) {
@@ -394,7 +406,10 @@ SparseTensor& add_out_sparse_cpu(SparseTensor& r, const SparseTensor& t, const S
 
   r.resize_as_(src);
 
-  if (src._values().is_contiguous() && t._values().is_contiguous()) {
+  // Two coalesced operands are merged even with non-contiguous values, so the
+  // sum stays coalesced instead of being concatenated.
+  bool coalesced = t.is_coalesced() && src.is_coalesced();
+  if (coalesced || (src._values().is_contiguous() && t._values().is_contiguous())) {
     return add_out_sparse_contiguous(r, t, src, value, commonDtype);
   } else {
     return add_out_sparse_non_contiguous(r, t, src, value, commonDtype);
@@ -609,10 +624,7 @@ SparseTensor& mul_out_sparse_cpu(SparseTensor& r, const Tensor& t_, const Tensor
 
 template <typename scalar_t>
 void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j, int64_t dim_k, Tensor& r, Scalar beta, const Tensor& t, Scalar alpha, const Tensor& indices, const Tensor& values, const Tensor& dense) {
-  int64_t i;
-
   // r_ = alpha * sparse * dense
-  scalar_t cast_alpha = alpha.to<scalar_t>();
   scalar_t cast_beta = beta.to<scalar_t>();
   if (cast_beta == 0) {
     r.zero_();
@@ -624,33 +636,24 @@ void s_addmm_out_sparse_dense_worker(int64_t nnz, int64_t dim_i, int64_t dim_j,
     at::mul_out(r, t, scalar_to_tensor(beta));
   }
 
+  // indices are coalesced, so the rows are sorted and only the first and
+  // last row need a bound check
   auto indices_accessor = indices.accessor<int64_t, 2>();
-
-  auto values_accessor = values.accessor<scalar_t, 1>();
-  scalar_t* dense_ptr = dense.data_ptr<scalar_t>();
-  scalar_t* r_ptr = r.data_ptr<scalar_t>();
-
-  int64_t dense_stride0 = dense.stride(0);
-  int64_t dense_stride1 = dense.stride(1);
-  int64_t r_stride0 = r.stride(0);
-  int64_t r_stride1 = r.stride(1);
-  for (i = 0; i < nnz; i++) {
-    scalar_t val = values_accessor[i];
-    int64_t row = indices_accessor[0][i];
-    int64_t col = indices_accessor[1][i];
-    if (col >= 0 && col < dim_j && row >= 0 && row < dim_i) {
-      THBlas_axpy<scalar_t>(dim_k,
-            cast_alpha * val,
-            dense_ptr + col * dense_stride0, dense_stride1,
-            r_ptr + row * r_stride0, r_stride1);
-    } else {
-      if (col < 0 || col >= dim_j) {
-        AT_ERROR("addmm: index out of column bound: ", col, " not between 1 and ", dim_j);
-      } else {
-        AT_ERROR("addmm: index out of row bound: ", row, " not between 1 and ", dim_i);
-      }
-    }
+  int64_t first_row = indices_accessor[0][0];
+  int64_t last_row = indices_accessor[0][nnz - 1];
+  if (first_row < 0 || last_row >= dim_i) {
+    AT_ERROR("addmm: index out of row bound: ", first_row < 0 ? first_row : last_row, " not between 1 and ", dim_i);
+  }
+  LongTensor col_indices = indices.select(0, 1);
+  int64_t min_col = col_indices.min().item<int64_t>();
+  int64_t max_col = col_indices.max().item<int64_t>();
+  if (min_col < 0 || max_col >= dim_j) {
+    AT_ERROR("addmm: index out of column bound: ", min_col < 0 ? min_col : max_col, " not between 1 and ", dim_j);
   }
+
+  // CSR row pointers let every output row be computed independently
+  LongTensor crow_indices = _to_csr(indices.data_ptr<int64_t>(), dim_i, nnz);
+  sparse_csr_mm_stub(kCPU, r, alpha, crow_indices, col_indices.contiguous(), values, dense);
 };
 
 Tensor& s_addmm_out_sparse_dense_cpu(
@@ -692,8 +695,10 @@ Tensor& s_addmm_out_sparse_dense_cpu(
     return r;
   }
 
-  LongTensor indices = sparse_._indices();
-  Tensor values      = sparse_._values();
+  SparseTensor sparse = sparse_.coalesce();
+  nnz                = sparse._nnz();
+  LongTensor indices = sparse._indices().contiguous();
+  Tensor values      = sparse._values().contiguous();
 
   AT_DISPATCH_ALL_TYPES(
       values.scalar_type(), "addmm_sparse_dense", [&] {
@@ -2,10 +2,18 @@
 
 #include <ATen/ATen.h>
 #include <ATen/SparseTensorUtils.h>
+#include <ATen/native/DispatchStub.h>
 
 namespace at { namespace native {
 
 TORCH_API sparse::SparseTensor& mul_out_sparse_scalar(sparse::SparseTensor& r, const sparse::SparseTensor& t, Scalar value);
 TORCH_API sparse::SparseTensor& mul_out_sparse_zerodim(sparse::SparseTensor& r, const sparse::SparseTensor& t, const Tensor& value);
 
+// r += alpha * A * dense, where the rows of the 2-D sparse matrix A are given
+// in CSR form: the entries of row i are values[crow_indices[i] : crow_indices[i + 1]]
+// in columns col_indices[crow_indices[i] : crow_indices[i + 1]].
+using csr_mm_fn = void(*)(Tensor& r, Scalar alpha, const Tensor& crow_indices, const Tensor& col_indices, const Tensor& values, const Tensor& dense);
+
+DECLARE_DISPATCH(csr_mm_fn, sparse_csr_mm_stub);
+
 }}
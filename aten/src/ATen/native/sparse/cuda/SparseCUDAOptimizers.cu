@@ -0,0 +1,294 @@
+#include <ATen/ATen.h>
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/native/sparse/SparseOptimizers.h>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace at { namespace native {
+
+using namespace at::sparse;
+
+namespace {
+
+constexpr int kThreads = 512;
+constexpr int64_t kMaxBlocks = 65535;
+
+int64_t num_blocks(int64_t n) {
+  return std::min((n + kThreads - 1) / kThreads, kMaxBlocks);
+}
+
+// The kernels run one thread per element of the touched rows, ``rows`` are
+// the indices of the touched rows and ``values`` their gradients.
+template <typename scalar_t, typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(kThreads)
+__global__ void sparse_adagrad_kernel(
+    scalar_t* param,
+    scalar_t* state_sum,
+    const int64_t* rows,
+    const scalar_t* values,
+    int64_t num_elements,
+    int64_t row_size,
+    accscalar_t lr,
+    accscalar_t eps) {
+  for (int64_t e = blockIdx.x * blockDim.x + threadIdx.x; e < num_elements;
+       e += blockDim.x * gridDim.x) {
+    const int64_t offset = rows[e / row_size] * row_size + e % row_size;
+    const accscalar_t g = values[e];
+    const accscalar_t sum = static_cast<accscalar_t>(state_sum[offset]) + g * g;
+    state_sum[offset] = sum;
+    param[offset] = static_cast<accscalar_t>(param[offset]) -
+        lr * g / (::sqrt(sum) + eps);
+  }
+}
+
+// Runs one block per touched row, which reduces the mean of the squared
+// gradients of the row.
+template <typename scalar_t, typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(kThreads)
+__global__ void sparse_rowwise_adagrad_kernel(
+    scalar_t* param,
+    scalar_t* state_sum,
+    const int64_t* rows,
+    const scalar_t* values,
+    int64_t num_touched,
+    int64_t row_size,
+    accscalar_t lr,
+    accscalar_t eps) {
+  __shared__ accscalar_t partial_sums[kThreads];
+  for (int64_t i = blockIdx.x; i < num_touched; i += gridDim.x) {
+    const auto grad_row = values + i * row_size;
+    accscalar_t partial_sum = 0;
+    for (int64_t j = threadIdx.x; j < row_size; j += blockDim.x) {
+      const accscalar_t g = grad_row[j];
+      partial_sum += g * g;
+    }
+    partial_sums[threadIdx.x] = partial_sum;
+    __syncthreads();
+    for (int stride = blockDim.x / 2; stride > 0; stride /= 2) {
+      if (threadIdx.x < stride) {
+        partial_sums[threadIdx.x] += partial_sums[threadIdx.x + stride];
+      }
+      __syncthreads();
+    }
+
+    const int64_t row = rows[i];
+    const accscalar_t sum = static_cast<accscalar_t>(state_sum[row]) +
+        partial_sums[0] / row_size;
+    const accscalar_t step = lr / (::sqrt(sum) + eps);
+    auto param_row = param + row * row_size;
+    for (int64_t j = threadIdx.x; j < row_size; j += blockDim.x) {
+      param_row[j] = static_cast<accscalar_t>(param_row[j]) -
+          step * static_cast<accscalar_t>(grad_row[j]);
+    }
+    // The partial sums are reused by the next row.
+    __syncthreads();
+    if (threadIdx.x == 0) {
+      state_sum[row] = sum;
+    }
+  }
+}
+
+template <typename scalar_t, typename accscalar_t>
+C10_LAUNCH_BOUNDS_1(kThreads)
+__global__ void sparse_adam_kernel(
+    scalar_t* param,
+    scalar_t* exp_avg,
+    scalar_t* exp_avg_sq,
+    const int64_t* rows,
+    const scalar_t* values,
+    int64_t num_elements,
+    int64_t row_size,
+    accscalar_t step_size,
+    accscalar_t beta1,
+    accscalar_t beta2,
+    accscalar_t eps) {
+  for (int64_t e = blockIdx.x * blockDim.x + threadIdx.x; e < num_elements;
+       e += blockDim.x * gridDim.x) {
+    const int64_t offset = rows[e / row_size] * row_size + e % row_size;
+    const accscalar_t g = values[e];
+    const accscalar_t m =
+        beta1 * static_cast<accscalar_t>(exp_avg[offset]) + (1 - beta1) * g;
+    const accscalar_t v = beta2 * static_cast<accscalar_t>(exp_avg_sq[offset]) +
+        (1 - beta2) * g * g;
+    exp_avg[offset] = m;
+    exp_avg_sq[offset] = v;
+    param[offset] = static_cast<accscalar_t>(param[offset]) -
+        step_size * m / (::sqrt(v) + eps);
+  }
+}
+
+bool is_fused_dtype(ScalarType dtype) {
+  return dtype == kFloat || dtype == kDouble || dtype == kHalf;
+}
+
+} // namespace
+
+Tensor& _sparse_adagrad_cuda_(
+    Tensor& self,
+    Tensor& state_sum,
+    const SparseTensor& grad,
+    double lr,
+    double eps) {
+  check_sparse_optimizer_state(
+      "_sparse_adagrad_", self, state_sum, "state_sum", self.sizes());
+  const cuda::CUDAGuard device_guard(self.device());
+  const auto g = sparse_row_grad("_sparse_adagrad_", self, grad);
+  if (g.rows.numel() == 0) {
+    return self;
+  }
+  auto param = contiguous_sparse_optimizer_state(
+      self, {g.num_rows, g.row_size});
+  auto sum = contiguous_sparse_optimizer_state(
+      state_sum, {g.num_rows, g.row_size});
+
+  if (is_fused_dtype(self.scalar_type())) {
+    const auto num_elements = g.values.numel();
+    AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+        self.scalar_type(), "_sparse_adagrad_cuda_", [&] {
+          using accscalar_t = acc_type<scalar_t, /*is_cuda=*/true>;
+          sparse_adagrad_kernel<scalar_t, accscalar_t><<<
+              num_blocks(num_elements),
+              kThreads,
+              0,
+              at::cuda::getCurrentCUDAStream()>>>(
+              param.data_ptr<scalar_t>(),
+              sum.data_ptr<scalar_t>(),
+              g.rows.data_ptr<int64_t>(),
+              g.values.data_ptr<scalar_t>(),
+              num_elements,
+              g.row_size,
+              static_cast<accscalar_t>(lr),
+              static_cast<accscalar_t>(eps));
+          AT_CUDA_CHECK(cudaGetLastError());
+        });
+  } else {
+    sparse_adagrad_reference(param, sum, g, lr, eps);
+  }
+
+  copy_sparse_optimizer_state_back(self, param);
+  copy_sparse_optimizer_state_back(state_sum, sum);
+  return self;
+}
+
+Tensor& _sparse_rowwise_adagrad_cuda_(
+    Tensor& self,
+    Tensor& state_sum,
+    const SparseTensor& grad,
+    double lr,
+    double eps) {
+  TORCH_CHECK(
+      grad.is_sparse() && grad.sparse_dim() <= self.dim(),
+      "_sparse_rowwise_adagrad_: expected a sparse gradient");
+  check_sparse_optimizer_state(
+      "_sparse_rowwise_adagrad_",
+      self,
+      state_sum,
+      "state_sum",
+      self.sizes().slice(0, grad.sparse_dim()));
+  const cuda::CUDAGuard device_guard(self.device());
+  const auto g = sparse_row_grad("_sparse_rowwise_adagrad_", self, grad);
+  if (g.rows.numel() == 0) {
+    return self;
+  }
+  auto param = contiguous_sparse_optimizer_state(
+      self, {g.num_rows, g.row_size});
+  auto sum = contiguous_sparse_optimizer_state(state_sum, {g.num_rows});
+
+  if (is_fused_dtype(self.scalar_type())) {
+    const auto num_touched = g.rows.numel();
+    AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+        self.scalar_type(), "_sparse_rowwise_adagrad_cuda_", [&] {
+          using accscalar_t = acc_type<scalar_t, /*is_cuda=*/true>;
+          sparse_rowwise_adagrad_kernel<scalar_t, accscalar_t><<<
+              std::min(num_touched, kMaxBlocks),
+              kThreads,
+              0,
+              at::cuda::getCurrentCUDAStream()>>>(
+              param.data_ptr<scalar_t>(),
+              sum.data_ptr<scalar_t>(),
+              g.rows.data_ptr<int64_t>(),
+              g.values.data_ptr<scalar_t>(),
+              num_touched,
+              g.row_size,
+              static_cast<accscalar_t>(lr),
+              static_cast<accscalar_t>(eps));
+          AT_CUDA_CHECK(cudaGetLastError());
+        });
+  } else {
+    sparse_rowwise_adagrad_reference(param, sum, g, lr, eps);
+  }
+
+  copy_sparse_optimizer_state_back(self, param);
+  copy_sparse_optimizer_state_back(state_sum, sum);
+  return self;
+}
+
+Tensor& _sparse_adam_cuda_(
+    Tensor& self,
+    Tensor& exp_avg,
+    Tensor& exp_avg_sq,
+    const SparseTensor& grad,
+    int64_t step,
+    double lr,
+    double beta1,
+    double beta2,
+    double eps) {
+  check_sparse_optimizer_state(
+      "_sparse_adam_", self, exp_avg, "exp_avg", self.sizes());
+  check_sparse_optimizer_state(
+      "_sparse_adam_", self, exp_avg_sq, "exp_avg_sq", self.sizes());
+  TORCH_CHECK(step > 0, "_sparse_adam_: expected a positive step, got ", step);
+  const cuda::CUDAGuard device_guard(self.device());
+  const auto g = sparse_row_grad("_sparse_adam_", self, grad);
+  if (g.rows.numel() == 0) {
+    return self;
+  }
+  const double bias_correction1 = 1 - std::pow(beta1, step);
+  const double bias_correction2 = 1 - std::pow(beta2, step);
+  const double step_size = lr * std::sqrt(bias_correction2) / bias_correction1;
+  auto param = contiguous_sparse_optimizer_state(
+      self, {g.num_rows, g.row_size});
+  auto m = contiguous_sparse_optimizer_state(
+      exp_avg, {g.num_rows, g.row_size});
+  auto v = contiguous_sparse_optimizer_state(
+      exp_avg_sq, {g.num_rows, g.row_size});
+
+  if (is_fused_dtype(self.scalar_type())) {
+    const auto num_elements = g.values.numel();
+    AT_DISPATCH_FLOATING_TYPES_AND_HALF(
+        self.scalar_type(), "_sparse_adam_cuda_", [&] {
+          using accscalar_t = acc_type<scalar_t, /*is_cuda=*/true>;
+          sparse_adam_kernel<scalar_t, accscalar_t><<<
+              num_blocks(num_elements),
+              kThreads,
+              0,
+              at::cuda::getCurrentCUDAStream()>>>(
+              param.data_ptr<scalar_t>(),
+              m.data_ptr<scalar_t>(),
+              v.data_ptr<scalar_t>(),
+              g.rows.data_ptr<int64_t>(),
+              g.values.data_ptr<scalar_t>(),
+              num_elements,
+              g.row_size,
+              static_cast<accscalar_t>(step_size),
+              static_cast<accscalar_t>(beta1),
+              static_cast<accscalar_t>(beta2),
+              static_cast<accscalar_t>(eps));
+          AT_CUDA_CHECK(cudaGetLastError());
+        });
+  } else {
+    sparse_adam_reference(param, m, v, g, step_size, beta1, beta2, eps);
+  }
+
+  copy_sparse_optimizer_state_back(self, param);
+  copy_sparse_optimizer_state_back(exp_avg, m);
+  copy_sparse_optimizer_state_back(exp_avg_sq, v);
+  return self;
+}
+
+}} // namespace at::native
@@ -72,9 +72,11 @@ SparseTensor coalesce_sparse_cuda(const SparseTensor& self) {
   thrust::copy(policy, countIterI, countIterI + nnz, origIndicesIter);
   thrust::copy(policy, countIterO, countIterO + nnz, uniqueOffsetsIter);
 
+  // No comparator: with the default ordering on integral keys Thrust picks
+  // its radix sort instead of the much slower merge sort.
   thrust::sort_by_key(policy,
     indicesIter, indicesIter + nnz,
-    origIndicesIter, ThrustLTOp<int64_t>()
+    origIndicesIter
   );
 
   // this forces device-host synchronization!
@@ -521,27 +521,17 @@ public:
 
 #endif
 
-inline Tensor new_qtensor_cpu(
+Tensor new_qtensor(
     IntArrayRef sizes,
     const TensorOptions& options,
     QuantizerPtr quantizer,
-    MemoryFormat memory_format=MemoryFormat::Contiguous) {
-  AT_ASSERT(options.device().is_cpu());
-
-  at::Allocator* allocator = at::getCPUAllocator();
-
-#ifdef USE_PYTORCH_QNNPACK
-  if (at::globalContext().qEngine() == at::QEngine::QNNPACK) {
-    static QAllocator qallocator;
-    allocator = &qallocator;
-  }
-#endif
-
+    Allocator* allocator,
+    MemoryFormat memory_format) {
   native::check_size_nonnegative(sizes);
   int64_t nelements = at::prod_intlist(sizes);
   auto dtype = options.dtype();
   TORCH_CHECK(isQIntType(typeMetaToScalarType(dtype)),
-           "ScalarType is not supported in new_qtensor_cpu.");
+           "ScalarType is not supported in new_qtensor.");
   auto storage = c10::make_intrusive<StorageImpl>(
       dtype,
       nelements,
@@ -549,12 +539,31 @@ inline Tensor new_qtensor_cpu(
       allocator,
       /*resizable=*/true);
   auto tensor = detail::make_tensor<QTensorImpl>(
-      storage, at::DispatchKeySet(at::DispatchKey::QuantizedCPUTensorId), quantizer);
+      storage, options.key_set(), quantizer);
   get_qtensorimpl(tensor)->set_sizes_contiguous(sizes);
   get_qtensorimpl(tensor)->empty_tensor_restride(memory_format);
   return tensor;
 }
 
+Tensor new_qtensor_cpu(
+    IntArrayRef sizes,
+    const TensorOptions& options,
+    QuantizerPtr quantizer,
+    MemoryFormat memory_format=MemoryFormat::Contiguous) {
+  AT_ASSERT(options.device().is_cpu());
+
+  at::Allocator* allocator = at::getCPUAllocator();
+
+#ifdef USE_PYTORCH_QNNPACK
+  if (at::globalContext().qEngine() == at::QEngine::QNNPACK) {
+    static QAllocator qallocator;
+    allocator = &qallocator;
+  }
+#endif
+
+  return new_qtensor(sizes, options, quantizer, allocator, memory_format);
+}
+
 Tensor PerTensorAffineQuantizer::quantize(Tensor rtensor) {
   TORCH_CHECK(
       rtensor.scalar_type() == kFloat,
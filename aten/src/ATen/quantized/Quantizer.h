@@ -269,4 +269,13 @@ CAFFE2_API Tensor new_qtensor_cpu(
     QuantizerPtr quantizer,
     MemoryFormat memory_format);
 
+// Same as new_qtensor_cpu, for any device: the storage comes from `allocator`,
+// which has to allocate on options.device().
+CAFFE2_API Tensor new_qtensor(
+    IntArrayRef sizes,
+    const TensorOptions& options,
+    QuantizerPtr quantizer,
+    Allocator* allocator,
+    MemoryFormat memory_format);
+
 } // namespace at
@@ -12,6 +12,7 @@
 #include <c10/core/UndefinedTensorImpl.h>
 #include <c10/util/Exception.h>
 #include <c10/util/Deprecated.h>
+#include <c10/util/MaybeOwned.h>
 #include <c10/util/Optional.h>
 #include <c10/util/intrusive_ptr.h>
 #include <ATen/core/DeprecatedTypePropertiesRegistry.h>
@@ -200,6 +201,15 @@ class CAFFE2_API Tensor {
     return impl_->is_contiguous(memory_format);
   }
 
+  /// Like contiguous(), but borrows *this instead of returning a copy of it
+  /// when it is contiguous already, which saves the refcount increment and
+  /// decrement. Use it where the tensor is expected to be contiguous on hot
+  /// paths; the result must not outlive *this.
+  c10::MaybeOwned<Tensor> expect_contiguous(at::MemoryFormat memory_format=at::MemoryFormat::Contiguous) const &;
+
+  // Borrowing from a temporary would dangle; use contiguous() instead.
+  c10::MaybeOwned<Tensor> expect_contiguous(at::MemoryFormat memory_format=at::MemoryFormat::Contiguous) && = delete;
+
   bool is_non_overlapping_and_dense() const {
     return impl_->is_non_overlapping_and_dense();
   }
@@ -478,6 +478,44 @@ TEST(DictTest, copyHasSeparateStorage) {
   EXPECT_EQ(0, dict3.size());
 }
 
+TEST(DictTest, givenUniqueDict_whenCopyingRvalue_thenTakesOverStorage) {
+  Dict<int64_t, string> dict1;
+  dict1.insert(3, "three");
+  Dict<int64_t, string> dict2 = std::move(dict1).copy();
+  EXPECT_EQ(0, dict1.size());
+  ASSERT_EQ(1, dict2.size());
+  EXPECT_EQ("three", dict2.at(3));
+}
+
+TEST(DictTest, givenSharedDict_whenCopyingRvalue_thenHasSeparateStorage) {
+  Dict<int64_t, string> dict1;
+  dict1.insert(3, "three");
+  Dict<int64_t, string> alias = dict1;
+  Dict<int64_t, string> dict2 = std::move(dict1).copy();
+
+  dict2.insert(4, "four");
+  EXPECT_EQ(1, alias.size());
+  EXPECT_EQ(2, dict2.size());
+}
+
+TEST(DictTest, givenEmptyDicts_whenInsertingAndClearing_thenWorks) {
+  // empty dicts share a static table, make sure none of them writes to it
+  Dict<int64_t, string> dict1;
+  Dict<int64_t, string> dict2;
+  Dict<int64_t, string> moved_from = dict1;
+  Dict<int64_t, string> dict3 = std::move(moved_from);
+  EXPECT_FALSE(dict2.contains(3));
+  dict1.insert(3, "three");
+  dict2.clear();
+  EXPECT_EQ(0, dict2.size());
+  EXPECT_FALSE(dict2.contains(3));
+  EXPECT_EQ(0, moved_from.size());
+  EXPECT_FALSE(moved_from.contains(3));
+  moved_from.insert(4, "four");
+  EXPECT_EQ(1, moved_from.size());
+  EXPECT_EQ(1, dict3.size());
+}
+
 TEST(DictTest, dictTensorAsKey) {
   Dict<at::Tensor, string> dict;
   at::Tensor key1 = at::tensor(3);
@@ -99,6 +99,27 @@ TEST(NamedTensorTest, internalSetNamesInplace) {
   ASSERT_TRUE(tensor.opt_names() == at::nullopt);
 }
 
+TEST(NamedTensorTest, namedTensorDispatchKey) {
+  auto tensor = at::zeros({3, 2});
+  auto N = dimnameFromString("N");
+  auto wildcard = Dimname::wildcard();
+  ASSERT_FALSE(tensor.key_set().has(c10::DispatchKey::NamedTensorId));
+
+  at::internal_set_names_inplace(tensor, std::vector<Dimname>{ N, wildcard });
+  ASSERT_TRUE(tensor.key_set().has(c10::DispatchKey::NamedTensorId));
+  ASSERT_TRUE(tensor.has_names());
+  ASSERT_EQ(legacyExtractDispatchKey(tensor), c10::DispatchKey::CPUTensorId);
+
+  // Names that are all None don't count as names.
+  at::internal_set_names_inplace(tensor, std::vector<Dimname>{ wildcard, wildcard });
+  ASSERT_FALSE(tensor.key_set().has(c10::DispatchKey::NamedTensorId));
+  ASSERT_FALSE(tensor.has_names());
+
+  at::internal_set_names_inplace(tensor, std::vector<Dimname>{ N, wildcard });
+  at::internal_set_names_inplace(tensor, at::nullopt);
+  ASSERT_FALSE(tensor.key_set().has(c10::DispatchKey::NamedTensorId));
+}
+
 TEST(NamedTensorTest, empty) {
   auto N = Dimname::fromSymbol(Symbol::dimname("N"));
   auto C = Dimname::fromSymbol(Symbol::dimname("C"));
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <ATen/ATen.h>
+#include <ATen/cuda/CUDABlas.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <thread>
+
+TEST(CUDABlasTest, HandlesAreBoundPerStream) {
+  if (!at::cuda::is_available()) return;
+  auto stream1 = at::cuda::getStreamFromPool();
+  auto stream2 = at::cuda::getStreamFromPool();
+  ASSERT_NE(stream1, stream2);
+
+  cublasHandle_t handle1, handle2;
+  {
+    c10::cuda::CUDAStreamGuard guard(stream1);
+    handle1 = at::cuda::getCurrentCUDABlasHandle();
+    ASSERT_EQ(at::cuda::getCurrentCUDABlasHandle(), handle1);
+  }
+  {
+    c10::cuda::CUDAStreamGuard guard(stream2);
+    handle2 = at::cuda::getCurrentCUDABlasHandle();
+  }
+  ASSERT_NE(handle1, handle2);
+
+  // another thread does not share the handles of this one
+  cublasHandle_t other_thread_handle = nullptr;
+  std::thread t([&] {
+    c10::cuda::CUDAStreamGuard guard(stream1);
+    other_thread_handle = at::cuda::getCurrentCUDABlasHandle();
+  });
+  t.join();
+  ASSERT_NE(other_thread_handle, handle1);
+}
+
+#if !defined(__HIP_PLATFORM_HCC__) && CUDART_VERSION >= 11000
+TEST(CUDABlasTest, GemmAndBiasMatchesAddmm) {
+  if (!at::cuda::is_available()) return;
+  using at::cuda::blas::GEMMAndBiasActivationEpilogue;
+  const int64_t batch = 33, in_features = 64, out_features = 17;
+  auto options = at::device(at::kCUDA).dtype(at::kFloat);
+  auto x = at::randn({batch, in_features}, options);
+  auto w = at::randn({out_features, in_features}, options);
+  auto b = at::randn({out_features}, options);
+
+  for (auto activation : {GEMMAndBiasActivationEpilogue::NONE,
+                          GEMMAndBiasActivationEpilogue::RELU}) {
+    auto y = at::empty({batch, out_features}, options);
+    at::cuda::blas::gemm_and_bias<float>(
+        true,
+        false,
+        out_features,
+        batch,
+        in_features,
+        1,
+        w.data_ptr<float>(),
+        in_features,
+        x.data_ptr<float>(),
+        in_features,
+        b.data_ptr<float>(),
+        y.data_ptr<float>(),
+        out_features,
+        activation);
+    auto expected = at::addmm(b, x, w.t());
+    if (activation == GEMMAndBiasActivationEpilogue::RELU) {
+      expected = expected.relu();
+    }
+    ASSERT_TRUE(y.allclose(expected, 1e-4, 1e-4));
+  }
+}
+#endif
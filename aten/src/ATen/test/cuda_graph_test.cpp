@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include <ATen/ATen.h>
+#include <ATen/CUDAGenerator.h>
+#include <ATen/cuda/CUDAContext.h>
+#include <ATen/cuda/CUDAGraph.h>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <cuda_runtime.h>
+
+namespace {
+
+bool graphs_available() {
+  return at::cuda::is_available() && CUDART_VERSION >= 10010;
+}
+
+} // namespace
+
+TEST(CUDAGraphTest, ReplayRecomputesFromUpdatedInputs) {
+  if (!graphs_available()) return;
+  auto x = at::ones({1024}, at::device(at::kCUDA));
+  at::Tensor y;
+  at::cuda::CUDAGraph graph;
+  auto stream = at::cuda::getStreamFromPool();
+  {
+    c10::cuda::CUDAStreamGuard guard(stream);
+    graph.capture_begin();
+    y = (x * 2).add_(1);
+    graph.capture_end();
+  }
+  // capture does not run the kernels
+  x.fill_(3);
+  graph.replay();
+  ASSERT_TRUE(y.cpu().eq(7).all().item<bool>());
+
+  x.fill_(-1);
+  graph.replay();
+  ASSERT_TRUE(y.cpu().eq(-1).all().item<bool>());
+}
+
+TEST(CUDAGraphTest, PrivatePoolIsNotReusedOutsideTheGraph) {
+  if (!graphs_available()) return;
+  auto x = at::ones({1 << 20}, at::device(at::kCUDA));
+  at::cuda::CUDAGraph graph;
+  auto stream = at::cuda::getStreamFromPool();
+  void* temporary_ptr = nullptr;
+  at::Tensor y;
+  {
+    c10::cuda::CUDAStreamGuard guard(stream);
+    graph.capture_begin();
+    {
+      // freed during capture, but the graph writes it on every replay
+      auto temporary = x * 2;
+      temporary_ptr = temporary.data_ptr();
+      y = temporary + 1;
+    }
+    graph.capture_end();
+    auto other = at::empty({1 << 20}, at::device(at::kCUDA));
+    ASSERT_NE(other.data_ptr(), temporary_ptr);
+  }
+  graph.replay();
+  ASSERT_TRUE(y.cpu().eq(3).all().item<bool>());
+}
+
+TEST(CUDAGraphTest, RandomNumbersCannotBeCaptured) {
+  if (!graphs_available()) return;
+  at::cuda::CUDAGraph graph;
+  auto stream = at::cuda::getStreamFromPool();
+  c10::cuda::CUDAStreamGuard guard(stream);
+  graph.capture_begin();
+  ASSERT_ANY_THROW(at::rand({16}, at::device(at::kCUDA)));
+  // the failed op leaves the capture usable
+  graph.capture_end();
+}
+
+TEST(CUDAGraphTest, ReplaysOfDropoutDrawNewNumbers) {
+  if (!graphs_available()) return;
+  auto x = at::ones({4096}, at::device(at::kCUDA));
+  auto gen = at::cuda::detail::getDefaultCUDAGenerator();
+  at::cuda::CUDAGraph graph;
+  auto stream = at::cuda::getStreamFromPool();
+  at::Tensor mask;
+  {
+    c10::cuda::CUDAStreamGuard guard(stream);
+    graph.capture_begin();
+    mask = std::get<1>(at::_fused_dropout(x, 0.5));
+    graph.capture_end();
+  }
+
+  uint64_t offset = gen->philox_engine_inputs(0).second;
+  graph.replay();
+  auto first = mask.clone();
+  // the replay reserved the offsets of the graph
+  ASSERT_GT(gen->philox_engine_inputs(0).second, offset);
+  graph.replay();
+  ASSERT_FALSE(first.equal(mask));
+}
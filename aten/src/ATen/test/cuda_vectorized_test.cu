@@ -24,11 +24,14 @@ void reset_buffers() {
 TEST(TestVectorizedMemoryAccess, CanVectorizeUpTo) {
   char *ptr = reinterpret_cast<char *>(buffer1);
 
-  ASSERT_EQ(can_vectorize_up_to<bool>(ptr), 4);
-  ASSERT_EQ(can_vectorize_up_to<int8_t>(ptr), 4);
-  ASSERT_EQ(can_vectorize_up_to<int16_t>(ptr), 4);
+  ASSERT_EQ(can_vectorize_up_to<bool>(ptr), 16);
+  ASSERT_EQ(can_vectorize_up_to<int8_t>(ptr), 16);
+  ASSERT_EQ(can_vectorize_up_to<int16_t>(ptr), 8);
+  ASSERT_EQ(can_vectorize_up_to<at::Half>(ptr), 8);
+  ASSERT_EQ(can_vectorize_up_to<at::BFloat16>(ptr), 8);
   ASSERT_EQ(can_vectorize_up_to<int>(ptr), 4);
-  ASSERT_EQ(can_vectorize_up_to<int64_t>(ptr), 4);
+  ASSERT_EQ(can_vectorize_up_to<int64_t>(ptr), 2);
+  ASSERT_EQ(can_vectorize_up_to<double>(ptr), 2);
 
   ASSERT_EQ(can_vectorize_up_to<bool>(ptr + 1), 1);
   ASSERT_EQ(can_vectorize_up_to<int8_t>(ptr + 1), 1);
@@ -42,9 +45,10 @@ TEST(TestVectorizedMemoryAccess, CanVectorizeUpTo) {
   ASSERT_EQ(can_vectorize_up_to<int16_t>(ptr + 4), 2);
   ASSERT_EQ(can_vectorize_up_to<int>(ptr + 4), 1);
 
-  ASSERT_EQ(can_vectorize_up_to<bool>(ptr + 8), 4);
-  ASSERT_EQ(can_vectorize_up_to<int8_t>(ptr + 8), 4);
+  ASSERT_EQ(can_vectorize_up_to<bool>(ptr + 8), 8);
+  ASSERT_EQ(can_vectorize_up_to<int8_t>(ptr + 8), 8);
   ASSERT_EQ(can_vectorize_up_to<int16_t>(ptr + 8), 4);
+  ASSERT_EQ(can_vectorize_up_to<at::Half>(ptr + 8), 4);
   ASSERT_EQ(can_vectorize_up_to<int>(ptr + 8), 2);
   ASSERT_EQ(can_vectorize_up_to<int64_t>(ptr + 8), 1);
 }
@@ -61,6 +65,15 @@ __global__ void vectorized_copy(scalar_t *dst, scalar_t *src) {
   policy.store(accessor, dst + 256 * blockIdx.x);
 }
 
+__global__ void vectorized_copy_bytes(int8_t *dst, int8_t *src) {
+  using vectorized = policies<64, 16>::vectorized<16>;
+  auto policy = vectorized();
+  int8_t buf[vectorized::thread_work_size];
+  auto accessor = [&](int index) -> int8_t & { return buf[index]; };
+  policy.load(accessor, src + 1024 * blockIdx.x);
+  policy.store(accessor, dst + 1024 * blockIdx.x);
+}
+
 TEST(TestVectorizedMemoryAccess, CopyKernel) {
   if (!at::cuda::is_available()) {
     return;
@@ -108,6 +121,19 @@ TEST(TestVectorizedMemoryAccess, CopyKernel) {
     ASSERT_EQ(buffer1[i].w, buffer2[i].w);
   }
 
+  // 16 byte accesses of 1 byte types
+  reset_buffers();
+  cudaDeviceSynchronize();
+  vectorized_copy_bytes<<<16, 64>>>(reinterpret_cast<int8_t *>(buffer2), reinterpret_cast<int8_t *>(buffer1));
+  cudaDeviceSynchronize();
+  ASSERT_EQ(cudaGetLastError(), cudaSuccess);
+  for (int i = 0; i < 512; i++) {
+    ASSERT_EQ(buffer1[i].x, buffer2[i].x);
+    ASSERT_EQ(buffer1[i].y, buffer2[i].y);
+    ASSERT_EQ(buffer1[i].z, buffer2[i].z);
+    ASSERT_EQ(buffer1[i].w, buffer2[i].w);
+  }
+
   // unaligned
   for (int i = 0; i < 16; i++) {
     for (int j = 0; j < 16; j++) {
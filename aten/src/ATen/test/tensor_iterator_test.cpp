@@ -224,3 +224,29 @@ TEST(TensorIteratorTest, FailNonPromotingBinaryOp) {
   iter.add_input(at::ones({1,1}, at::dtype(at::kInt)));
   ASSERT_ANY_THROW(iter.build());
 }
+
+// Iterators built from the plan cache must match the ones built from scratch.
+TEST(TensorIteratorTest, PlanCache) {
+  auto check = [](const Tensor& x, const Tensor& y) {
+    Tensor expected_out;
+    auto expected = TensorIterator::binary_op(expected_out, x, y);
+    at::globalContext().setTensorIteratorPlanCache(true);
+    for (int i = 0; i < 3; i++) {
+      Tensor out;
+      auto iter = TensorIterator::binary_op(out, x, y);
+      ASSERT_EQ(iter.shape(), expected.shape());
+      for (int arg = 0; arg < iter.ntensors(); arg++) {
+        ASSERT_EQ(iter.strides(arg), expected.strides(arg));
+      }
+      ASSERT_EQ(out.sizes(), expected_out.sizes());
+      ASSERT_EQ(out.strides(), expected_out.strides());
+    }
+    at::globalContext().setTensorIteratorPlanCache(false);
+  };
+  auto x = at::randn({4, 1, 3});
+  check(x, at::randn({5, 1}));
+  check(x.transpose(0, 2), at::randn({4}));
+  check(at::randn({2, 3, 4, 5}).contiguous(MemoryFormat::ChannelsLast),
+        at::randn({3, 1, 1}));
+  check(at::randn({6, 6}).t(), at::randn({6, 6}, kDouble));
+}
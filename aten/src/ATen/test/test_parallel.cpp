@@ -4,6 +4,7 @@
 #include <ATen/DLConvertor.h>
 #include <ATen/Parallel.h>
 
+#include <atomic>
 #include <iostream>
 #include <string.h>
 #include <sstream>
@@ -36,6 +37,41 @@ TEST(TestParallel, NestedParallel) {
   });
 }
 
+TEST(TestParallel, NestedParallelFor) {
+  // every element is visited exactly once, and the inner loops leave the
+  // outer task's thread number alone
+  std::vector<std::atomic<int>> visited(64 * 64);
+  at::parallel_for(0, 64, 1, [&](int64_t begin, int64_t end) {
+    const int thread_num = at::get_thread_num();
+    for (int64_t i = begin; i < end; ++i) {
+      at::parallel_for(0, 64, 1, [&](int64_t inner_begin, int64_t inner_end) {
+        ASSERT_LT(at::get_thread_num(), at::get_num_threads());
+        for (int64_t j = inner_begin; j < inner_end; ++j) {
+          visited[i * 64 + j]++;
+        }
+      });
+      ASSERT_EQ(at::get_thread_num(), thread_num);
+    }
+  });
+  for (auto& count : visited) {
+    ASSERT_EQ(count.load(), 1);
+  }
+
+  auto sum = at::parallel_reduce(0, 64, 1, (int64_t)0,
+      [&](int64_t begin, int64_t end, int64_t ident) {
+        return at::parallel_reduce(begin * 64, end * 64, 1, ident,
+            [](int64_t inner_begin, int64_t inner_end, int64_t acc) {
+              for (int64_t j = inner_begin; j < inner_end; ++j) {
+                acc += j;
+              }
+              return acc;
+            },
+            std::plus<int64_t>());
+      },
+      std::plus<int64_t>());
+  ASSERT_EQ(sum, (int64_t)(64 * 64) * (64 * 64 - 1) / 2);
+}
+
 TEST(TestParallel, Exceptions) {
   // parallel case
   ASSERT_THROW(
@@ -38,6 +38,49 @@ const char * unknown_filename = "filename not specified";
 const char * unknown_eventname = "eventname not specified";
 #endif
 
+#ifdef HAVE_MMAP
+/* Passes the access hints of a mapping on to the kernel. They are only hints,
+ * so advice that the kernel doesn't support or rejects is ignored.
+ * MAP_POPULATE is only requested for shared mappings (see the mmap call): it
+ * write-faults private writable mappings, which copies every page, while
+ * MADV_POPULATE_READ only reads them. */
+static void THMapAllocator_advise(void* ptr, size_t size, int hints, bool shared) {
+  if (hints & TH_ALLOCATOR_MAPPED_SEQUENTIAL) {
+#ifdef MADV_SEQUENTIAL
+    madvise(ptr, size, MADV_SEQUENTIAL);
+#endif
+  } else if (hints & TH_ALLOCATOR_MAPPED_RANDOM) {
+#ifdef MADV_RANDOM
+    madvise(ptr, size, MADV_RANDOM);
+#endif
+  }
+  if (hints & TH_ALLOCATOR_MAPPED_HUGEPAGES) {
+#ifdef MADV_HUGEPAGE
+    madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+  }
+  bool willneed = hints & TH_ALLOCATOR_MAPPED_WILLNEED;
+  if (hints & TH_ALLOCATOR_MAPPED_POPULATE) {
+#ifdef MAP_POPULATE
+    if (shared) {
+      return;
+    }
+#endif
+#ifdef MADV_POPULATE_READ
+    if (madvise(ptr, size, MADV_POPULATE_READ) == 0) {
+      return;
+    }
+#endif
+    willneed = true;
+  }
+  if (willneed) {
+#ifdef MADV_WILLNEED
+    madvise(ptr, size, MADV_WILLNEED);
+#endif
+  }
+}
+#endif
+
 THMapAllocator::THMapAllocator(WithFd, const char *filename, int fd, int flags, size_t size)
   : filename_(filename ? filename : unknown_filename)
   , flags_(0) // to be filled later
@@ -51,6 +94,9 @@ THMapAllocator::THMapAllocator(WithFd, const char *filename, int fd, int flags,
 #endif
   , base_ptr_(nullptr)
 {
+  // The hints don't affect how the file is opened and mapped
+  const int hints = flags & TH_ALLOCATOR_MAPPED_HINTS;
+  flags &= ~TH_ALLOCATOR_MAPPED_HINTS;
 
   if (!(flags & TH_ALLOCATOR_MAPPED_SHARED) && !(flags & TH_ALLOCATOR_MAPPED_SHAREDMEM)) {
     flags &= ~TH_ALLOCATOR_MAPPED_NOCREATE;
@@ -280,14 +326,23 @@ THMapAllocator::THMapAllocator(WithFd, const char *filename, int fd, int flags,
     size_ = size; /* if we are here, it must be the right size */
 
     /* map it */
-    if (flags_ & (TH_ALLOCATOR_MAPPED_SHARED | TH_ALLOCATOR_MAPPED_SHAREDMEM)) {
-      base_ptr_ = mmap(nullptr, size_, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    const bool shared = flags_ & (TH_ALLOCATOR_MAPPED_SHARED | TH_ALLOCATOR_MAPPED_SHAREDMEM);
+    if (shared) {
+      int mmap_flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+      if (hints & TH_ALLOCATOR_MAPPED_POPULATE) {
+        mmap_flags |= MAP_POPULATE;
+      }
+#endif
+      base_ptr_ = mmap(nullptr, size_, PROT_READ|PROT_WRITE, mmap_flags, fd, 0);
     } else {
       base_ptr_ = mmap(nullptr, size_, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0);
     }
 
     if (base_ptr_ == MAP_FAILED) {
       base_ptr_ = nullptr; /* let's be sure it is NULL */
+    } else if (hints) {
+      THMapAllocator_advise(base_ptr_, size_, hints, shared);
     }
 
     if (flags_ & TH_ALLOCATOR_MAPPED_KEEPFD) {
@@ -496,6 +551,13 @@ int THRefcountedMapAllocator::decref()
   return --map_info->refcount == 0;
 }
 
+bool THRefcountedMapAllocator::increfIfLast()
+{
+  THMapInfo *map_info = static_cast<THMapInfo*>(base_ptr_);
+  int expected = 1;
+  return map_info->refcount.compare_exchange_strong(expected, 2);
+}
+
 #else
 
 
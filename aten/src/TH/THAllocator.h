@@ -12,6 +12,28 @@
 #define TH_ALLOCATOR_MAPPED_FROMFD 32
 #define TH_ALLOCATOR_MAPPED_UNLINK 64
 
+/* Hints about how a mapping is going to be accessed. They are passed on to
+ * the kernel (with MAP_POPULATE and madvise) where it supports them, and are
+ * ignored elsewhere.
+ * POPULATE: fault in the whole mapping before returning it, so that the first
+ *   access of every page doesn't page-fault.
+ * WILLNEED: start reading the whole mapping in the background.
+ * SEQUENTIAL, RANDOM: the mapping will be read in order (read ahead
+ *   aggressively), or in random order (don't read ahead).
+ * HUGEPAGES: back the mapping by huge pages.
+ */
+#define TH_ALLOCATOR_MAPPED_POPULATE 128
+#define TH_ALLOCATOR_MAPPED_WILLNEED 256
+#define TH_ALLOCATOR_MAPPED_SEQUENTIAL 512
+#define TH_ALLOCATOR_MAPPED_RANDOM 1024
+#define TH_ALLOCATOR_MAPPED_HUGEPAGES 2048
+#define TH_ALLOCATOR_MAPPED_HINTS              \
+  (TH_ALLOCATOR_MAPPED_POPULATE |              \
+   TH_ALLOCATOR_MAPPED_WILLNEED |              \
+   TH_ALLOCATOR_MAPPED_SEQUENTIAL |            \
+   TH_ALLOCATOR_MAPPED_RANDOM |                \
+   TH_ALLOCATOR_MAPPED_HUGEPAGES)
+
 /* default malloc/free allocator. malloc and realloc raise an error (using
  * THError) on allocation failure.
  */
@@ -90,6 +112,10 @@ class CAFFE2_API THRefcountedMapAllocator
 
   void incref();
   int decref();
+  // Increments the refcount if this allocator holds the only reference to
+  // the shared memory, and returns whether it did. Lets the owner keep the
+  // memory around after close() for another allocator to reopen it.
+  bool increfIfLast();
   void close() override;
 
   virtual ~THRefcountedMapAllocator() { close(); }
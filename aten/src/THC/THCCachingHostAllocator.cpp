@@ -4,6 +4,7 @@
 
 
 #include <cuda_runtime_api.h>
+#include <algorithm>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -12,6 +13,7 @@
 #include <unordered_set>
 #include <set>
 #include <utility>
+#include <vector>
 
 namespace {
 
@@ -33,6 +35,16 @@ struct Block : public BlockSize
       BlockSize(size, ptr), allocated(allocated), event_count(0), streams() {}
 };
 
+struct PendingEvent
+{
+  cudaEvent_t event;  // event recorded on a stream that used the block
+  int         device; // device the event was created on
+  void*       ptr;    // host memory pointer of the block
+
+  PendingEvent(cudaEvent_t event, int device, void* ptr) :
+      event(event), device(device), ptr(ptr) {}
+};
+
 static bool BlockComparator(const BlockSize& a, const BlockSize& b)
 {
   // sort by size, break ties with pointer
@@ -56,7 +68,12 @@ struct HostAllocator
   std::set<BlockSize, Comparison> available;
 
   // outstanding cuda events
-  std::deque<std::pair<cudaEvent_t, void*>> cuda_events;
+  std::deque<PendingEvent> cuda_events;
+
+  // completed cuda events that can be reused, by device
+  std::vector<std::vector<cudaEvent_t>> free_events;
+
+  THCCachingHostAllocatorStats stats;
 
   HostAllocator() : available(BlockComparator) {}
 
@@ -79,9 +96,46 @@ struct HostAllocator
       block.allocated = true;
       *ptr = block.ptr;
       available.erase(it);
+      stats.num_hits++;
+      stats.allocated_bytes += block.size;
       return cudaSuccess;
     }
 
+    err = hostAlloc(ptr, size);
+    if (err != cudaSuccess) {
+      return err;
+    }
+
+    blocks.insert({*ptr, Block(size, *ptr, true)});
+    stats.num_misses++;
+    stats.allocated_bytes += size;
+    return cudaSuccess;
+  }
+
+  cudaError_t reserve(size_t size, size_t count)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (size_t i = 0; i < count; ++i) {
+      void* ptr;
+      cudaError_t err = hostAlloc(&ptr, size);
+      if (err != cudaSuccess) {
+        return err;
+      }
+      auto inserted = blocks.insert({ptr, Block(size, ptr, false)});
+      available.insert(inserted.first->second);
+    }
+    return cudaSuccess;
+  }
+
+  THCCachingHostAllocatorStats getStats()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+  }
+
+  cudaError_t hostAlloc(void** ptr, size_t size)
+  {
     // Pinned memory pointers allocated by any device can be directly used by any
     // other device, regardless of the current device at the time of allocation,
     // since we assume unified addressing.
@@ -96,13 +150,13 @@ struct HostAllocator
     // note that cudaHostAlloc may not touch pointer if size is 0
     *ptr = 0;
 
-    // allocate a new block if no cached allocation is found
-    err = cudaHostAlloc(ptr, size, cudaHostAllocDefault);
+    cudaError_t err = cudaHostAlloc(ptr, size, cudaHostAllocDefault);
     if (err != cudaSuccess) {
       return err;
     }
 
-    blocks.insert({*ptr, Block(size, *ptr, true)});
+    stats.reserved_bytes += size;
+    stats.peak_reserved_bytes = std::max(stats.peak_reserved_bytes, stats.reserved_bytes);
     return cudaSuccess;
   }
 
@@ -129,6 +183,7 @@ struct HostAllocator
     // free (on valid memory) shouldn't fail, so mark unallocated before
     // we process the streams.
     block.allocated = false;
+    stats.allocated_bytes -= block.size;
 
     // insert CUDA events for each stream on which this block was used. This
     err = insertEvents(block);
@@ -169,20 +224,16 @@ struct HostAllocator
     // the processing of some events may be delayed.
     while (!cuda_events.empty()) {
       auto& e = cuda_events.front();
-      cudaEvent_t event = e.first;
 
-      cudaError_t err = cudaEventQuery(event);
+      cudaError_t err = cudaEventQuery(e.event);
       if (err == cudaErrorNotReady) {
         break;
       } else if (err != cudaSuccess) {
         return err;
       }
-      err = cudaEventDestroy(event);
-      if (err != cudaSuccess) {
-        return err;
-      }
+      free_events[e.device].push_back(e.event);
 
-      Block& block = blocks.at(e.second);
+      Block& block = blocks.at(e.ptr);
       block.event_count--;
       if (block.event_count == 0 && !block.allocated) {
         available.insert(block);
@@ -197,17 +248,27 @@ struct HostAllocator
     std::lock_guard<std::mutex> lock(mutex);
 
     // remove events for freed blocks
+    std::deque<PendingEvent> remaining_events;
     for (auto it = cuda_events.begin(); it != cuda_events.end(); ++it) {
-      cudaEvent_t event = it->first;
-      Block& block = blocks.at(it->second);
+      Block& block = blocks.at(it->ptr);
       if (!block.allocated) {
-        THCudaCheckWarn(cudaEventDestroy(event));
+        THCudaCheckWarn(cudaEventDestroy(it->event));
         block.event_count--;
+      } else {
+        remaining_events.push_back(*it);
       }
     }
 
-    // all cuda_events have been processed
-    cuda_events.clear();
+    // events of blocks that are still allocated keep tracking their uses
+    std::swap(cuda_events, remaining_events);
+
+    // destroy pooled events
+    for (auto& events : free_events) {
+      for (cudaEvent_t event : events) {
+        THCudaCheckWarn(cudaEventDestroy(event));
+      }
+      events.clear();
+    }
 
     // clear list of available blocks
     available.clear();
@@ -217,6 +278,7 @@ struct HostAllocator
       Block& block = it->second;
       if (!block.allocated) {
         THCudaCheckWarn(cudaFreeHost(block.ptr));
+        stats.reserved_bytes -= block.size;
         it = blocks.erase(it);
       } else {
         ++it;
@@ -237,15 +299,29 @@ struct HostAllocator
       err = cudaSetDevice(it->device_index());
       if (err != cudaSuccess) break;
 
+      const int device = it->device_index();
+      if ((size_t)device >= free_events.size()) {
+        free_events.resize(device + 1);
+      }
+
       cudaEvent_t event;
-      err = cudaEventCreateWithFlags(&event, cudaEventDisableTiming);
-      if (err != cudaSuccess) break;
+      if (!free_events[device].empty()) {
+        event = free_events[device].back();
+        free_events[device].pop_back();
+      } else {
+        err = cudaEventCreateWithFlags(&event, cudaEventDisableTiming);
+        if (err != cudaSuccess) break;
+        stats.num_events_created++;
+      }
 
       err = cudaEventRecord(event, it->stream());
-      if (err != cudaSuccess) break;
+      if (err != cudaSuccess) {
+        free_events[device].push_back(event);
+        break;
+      }
 
       block.event_count++;
-      cuda_events.emplace_back(event, block.ptr);
+      cuda_events.emplace_back(event, device, block.ptr);
     }
 
     cudaSetDevice(prev_device);
@@ -267,6 +343,16 @@ void THCCachingHostAllocator_emptyCache()
   allocator.emptyCache();
 }
 
+cudaError_t THCCachingHostAllocator_reserve(size_t size, size_t count)
+{
+  return allocator.reserve(size, count);
+}
+
+THCCachingHostAllocatorStats THCCachingHostAllocator_getStats()
+{
+  return allocator.getStats();
+}
+
 static void THCCachingHostDeleter(void* ptr) {
   allocator.free(ptr);
 }
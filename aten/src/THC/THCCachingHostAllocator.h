@@ -19,10 +19,30 @@
 // copy_from_cpu_async_ and copy_to_cpu_async_.
 //
 // Note that this allocator does not split larger allocations into smaller
-// blocks, unlike the caching device allocator.
+// blocks, unlike the caching device allocator. A request is served by the
+// smallest free block that is at least as large.
+//
+// The CUDA events used to track stream uses are pooled per device and reused
+// instead of being created and destroyed for every recordEvent.
 //
 THC_API c10::Allocator* getTHCCachingHostAllocator(void);
 
+// Summary statistics of the caching host allocator.
+struct THCCachingHostAllocatorStats {
+  // COUNT: allocations served from the cache
+  int64_t num_hits = 0;
+  // COUNT: allocations that called cudaHostAlloc
+  int64_t num_misses = 0;
+  // SUM: bytes of currently allocated blocks
+  int64_t allocated_bytes = 0;
+  // SUM: bytes held by the allocator (both free and allocated)
+  int64_t reserved_bytes = 0;
+  // SUM: peak value of reserved_bytes
+  int64_t peak_reserved_bytes = 0;
+  // COUNT: CUDA events created (events are reused once their stream use ends)
+  int64_t num_events_created = 0;
+};
+
 // Records an event in the specified stream. The allocation 'ptr' will not be
 // re-used until the event has occurred.
 THC_API cudaError_t THCCachingHostAllocator_recordEvent(void *ptr, at::cuda::CUDAStream stream);
@@ -30,4 +50,11 @@ THC_API cudaError_t THCCachingHostAllocator_recordEvent(void *ptr, at::cuda::CUD
 // Releases cached pinned memory allocations via cudaHostFree
 THC_API void THCCachingHostAllocator_emptyCache(void);
 
+// Allocates `count` pinned blocks of `size` bytes up front and adds them to
+// the cache, so that later allocations of up to `size` bytes do not have to
+// call cudaHostAlloc.
+THC_API cudaError_t THCCachingHostAllocator_reserve(size_t size, size_t count);
+
+THC_API THCCachingHostAllocatorStats THCCachingHostAllocator_getStats(void);
+
 #endif
@@ -31,7 +31,6 @@ __global__ void THCTensor_copyToDiagonal(T* a, T* b, ptrdiff_t start, ptrdiff_t
   }
 }
 
-#define CAT_ARRAY_BATCH_SIZE 1024
 #define CAT_ARRAY_MAX_INPUT_DIMS 4
 
 inline bool getCatGrid(THCState* state, ptrdiff_t nTensors, dim3& grid) {
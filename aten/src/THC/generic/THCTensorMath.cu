@@ -81,9 +81,8 @@ void THCTensor_(catArray)(THCState *state, THCTensor *result,
   // to be "skipped".  We maintain this behavior for backwards compatibility, but only for this specific
   // size (i.e. other empty sizes are not skipped).
   // FIXME: warn if this is the case
-  int i, j, cohortMax;
+  int i, j;
   int64_t offset;
-  bool hasSkippedInput = false;
   THCTensor *notSkippedTensor = NULL;  // non-owning reference
   auto should_skip = [](THCTensor *t) { return t->is_empty() && t->dim() == 1; };
   int nDims = 0;
@@ -100,7 +99,6 @@ void THCTensor_(catArray)(THCState *state, THCTensor *result,
   for (i = 0; i < numInputs; i++)
   {
     if (should_skip(inputs[i])) {
-      hasSkippedInput = true;
       continue;
     }
     nDims = inputs[i]->dim();
@@ -141,15 +139,15 @@ void THCTensor_(catArray)(THCState *state, THCTensor *result,
   // We parallelize the copy if all 6 conditions pass:
   //
   // 1. There is more than one input tensor
-  // 2. No empty inputs
-  // 3. The result tensor is 32-bit indexable
-  // 4. The number of dimensions is <= 4
-  // 5. All input tensors are contiguous (output tensor may be non-contig)
-  // 6. All input tensors can use 32-bit indexing
-  // 7. All input tensors are on the same device
+  // 2. The result tensor is 32-bit indexable
+  // 3. The number of dimensions is <= 4
+  // 4. All input tensors are contiguous (output tensor may be non-contig)
+  // 5. All input tensors can use 32-bit indexing
+  // 6. All input tensors are on the same device
+  //
+  // Skipped inputs are simply left out of the metadata.
 
   if (numInputs > 1 &&
-      !hasSkippedInput &&
       result->dim() <= CAT_ARRAY_MAX_INPUT_DIMS &&
       THCTensor_canUse32BitIndexMath(state, result) &&
       THCTensor_allContiguous(state, inputs, numInputs) &&
@@ -160,10 +158,6 @@ void THCTensor_(catArray)(THCState *state, THCTensor *result,
     // for the output Tensor.
     scalar_t *data = THCTensor_(data)(state, result);
 
-    // Kernel Parameter
-    size_t tensorMetadataSize = sizeof(CatArrInputTensor<scalar_t, unsigned int>) * CAT_ARRAY_BATCH_SIZE;
-    auto d_inputs = static_cast<CatArrInputTensor<scalar_t, unsigned int> *>(THCudaMalloc(state, tensorMetadataSize));
-
     OutputTensorSizeStride<unsigned int, CAT_ARRAY_MAX_INPUT_DIMS> param;
 
     // Next, let's initialize the size, stride arrays for the output Tensor.
@@ -174,50 +168,60 @@ void THCTensor_(catArray)(THCState *state, THCTensor *result,
 
     at::cuda::CUDAStream stream = at::cuda::getCurrentCUDAStream();
 
-    // Template Declarations for dim = 1, 2, 3, 4
-#define HANDLE_CASE(DIMS) \
-  CatArrayBatchedCopy<scalar_t, unsigned int, DIMS><<<catGrid, applyBlock, 0, stream.stream()>>>(data, d_inputs, param, dimension, param.outputStride[dimension]);
-
-    // Now we loop
+    // The metadata of all inputs goes to the device in a single copy, so the
+    // host cost no longer grows with a per-batch allocation and copy.
+    size_t tensorMetadataSize = sizeof(CatArrInputTensor<scalar_t, unsigned int>) * numInputs;
+    auto stackInputs_owner = THCudaHostAlloc(state, tensorMetadataSize);
+    CatArrInputTensor<scalar_t, unsigned int>* stackInputs =
+        static_cast<CatArrInputTensor<scalar_t, unsigned int>*>(stackInputs_owner.get());
+    int numCatInputs = 0;
+    unsigned int maxElements = 0;
     offset = 0;
-    for (i = 0; i < numInputs; i += CAT_ARRAY_BATCH_SIZE) {
-      // Re-allocate stackInputs every iteration to avoid read-after-write hazard
-      {
-        auto stackInputs_owner = THCudaHostAlloc(state, tensorMetadataSize);
-        CatArrInputTensor<scalar_t, unsigned int>* stackInputs = static_cast<CatArrInputTensor<scalar_t, unsigned int>*>(stackInputs_owner.get());
-        cohortMax = 0;
-        for (j = 0; j < CAT_ARRAY_BATCH_SIZE && (i+j) < numInputs; ++j) {
-          int64_t dimSize = THCTensor_(size)(state, inputs[i+j], dimension);
-
-          stackInputs[j].input = THCTensor_(data)(state, inputs[i+j]);
-          stackInputs[j].offset = offset;
-          stackInputs[j].dimSize = dimSize;
-          stackInputs[j].nElements = THCTensor_(nElement)(state, inputs[i+j]);
-          cohortMax = cohortMax > (int) stackInputs[j].nElements ? cohortMax : (int) stackInputs[j].nElements;
-
-          // update offset
-          offset += dimSize;
-        }
-        THCudaCheck(cudaMemcpyAsync(
-            d_inputs,
-            stackInputs,
-            j * sizeof(CatArrInputTensor<scalar_t, unsigned int>),
-            cudaMemcpyHostToDevice,
-            stream.stream()));
-        THCudaHostRecord(state, stackInputs);
+    for (j = 0; j < numInputs; ++j) {
+      if (should_skip(inputs[j])) {
+        continue;
       }
+      int64_t dimSize = THCTensor_(size)(state, inputs[j], dimension);
+      stackInputs[numCatInputs].input = THCTensor_(data)(state, inputs[j]);
+      stackInputs[numCatInputs].offset = offset;
+      stackInputs[numCatInputs].dimSize = dimSize;
+      stackInputs[numCatInputs].nElements = THCTensor_(nElement)(state, inputs[j]);
+      maxElements = std::max(maxElements, stackInputs[numCatInputs].nElements);
+      ++numCatInputs;
+
+      // update offset
+      offset += dimSize;
+    }
+    auto d_inputs = static_cast<CatArrInputTensor<scalar_t, unsigned int> *>(
+        THCudaMalloc(state, std::max<size_t>(tensorMetadataSize, 1)));
+    THCudaCheck(cudaMemcpyAsync(
+        d_inputs,
+        stackInputs,
+        numCatInputs * sizeof(CatArrInputTensor<scalar_t, unsigned int>),
+        cudaMemcpyHostToDevice,
+        stream.stream()));
+    THCudaHostRecord(state, stackInputs);
+
+    // Next, let's consider how we set our kernel launch parameters.
+    // We borrow from THCApply, which the kernel's internal indexing
+    // is based on.
+    dim3 applyBlock = getApplyBlock();
+
+    // One block row per input, and no more blocks per row than the largest
+    // input can use: for many tiny inputs this is a single, narrow launch.
+    const int maxGridY = at::cuda::getCurrentDeviceProperties()->maxGridSize[1];
 
-      // Next, let's consider how we set our kernel launch parameters.
-      // We borrow from THCApply, which the kernel's internal indexing
-      // is based on.
-      dim3 applyBlock = getApplyBlock();
+    // Template Declarations for dim = 1, 2, 3, 4
+#define HANDLE_CASE(DIMS) \
+  CatArrayBatchedCopy<scalar_t, unsigned int, DIMS><<<catGrid, applyBlock, 0, stream.stream()>>>(data, d_inputs + i, param, dimension, param.outputStride[dimension]);
 
-      //Get grid where x dim fills half gpu and y dim is number of tensors.
-      //This will have cating two tensors fill the entire grid, but prevent
-      //many threads from needlessly load meta data if their sizes is small.
+    for (i = 0; i < numCatInputs; i += maxGridY) {
       dim3 catGrid;
-      getCatGrid(state, j, catGrid);
-
+      getCatGrid(state, std::min(numCatInputs - i, maxGridY), catGrid);
+      catGrid.x = std::min<unsigned int>(catGrid.x, THCCeilDiv(maxElements, applyBlock.x));
+      if (catGrid.x == 0) {
+        break;
+      }
 
       switch (nDims) {
         case 1:
@@ -12,8 +12,12 @@ from .runner import get_nn_runners
 
 BenchResult = namedtuple('BenchResult', [
     'name', 'avg_fwd', 'std_fwd', 'info_fwd', 'avg_bwd', 'std_bwd', 'info_bwd',
+    'mem_fwd_mb', 'allocs_fwd', 'kernels_fwd', 'mem_bwd_mb', 'allocs_bwd', 'kernels_bwd',
 ])
 
+# Memory, allocator and kernel stats of one forward or backward pass
+PhaseStats = namedtuple('PhaseStats', ['peak_mem_mb', 'allocs', 'kernels'])
+
 
 def fit_str(string, colwidth=16):
     if len(string) < colwidth:
@@ -42,6 +46,46 @@ def pretty_print(benchresult, colwidth=16, sep=' '):
     return sep.join(items)
 
 
+def measure_phase(fn):
+    # peak_mem_mb is the peak memory allocated during the phase on top of the
+    # memory allocated before it, allocs the number of allocations served by
+    # the caching allocator, and kernels the number of operators that ran CUDA
+    # work without calling other operators, about one kernel launch each.
+    torch.cuda.synchronize()
+    start_bytes = torch.cuda.memory_allocated()
+    start_allocs = torch.cuda.memory_stats()['allocation.all.allocated']
+    torch.cuda.reset_peak_memory_stats()
+    with torch.autograd.profiler.profile(use_cuda=True) as prof:
+        result = fn()
+    torch.cuda.synchronize()
+    prof.function_events.populate_cpu_children()
+    stats = PhaseStats(
+        peak_mem_mb=(torch.cuda.max_memory_allocated() - start_bytes) / 2 ** 20,
+        allocs=torch.cuda.memory_stats()['allocation.all.allocated'] - start_allocs,
+        kernels=sum(1 for evt in prof.function_events
+                    if evt.cuda_time_total > 0 and not evt.cpu_children))
+    return result, stats
+
+
+def measure_batch(modeldef):
+    # Runs one more iteration with the stats on, as the profiler skews the
+    # times of the timed iterations
+    forward_output, fwd_stats = measure_phase(
+        lambda: modeldef.forward(*modeldef.inputs))
+
+    if modeldef.backward_setup is not None:
+        backward_input = modeldef.backward_setup(forward_output)
+    else:
+        backward_input = forward_output
+
+    bwd_stats = PhaseStats(0, 0, 0)
+    if modeldef.backward is not None:
+        _, bwd_stats = measure_phase(lambda: modeldef.backward(*backward_input))
+        for param in modeldef.params:
+            param.grad.data.zero_()
+    return fwd_stats, bwd_stats
+
+
 def trainbench(name, rnn_creator, nloops=100, warmup=10,
                seqLength=100, numLayers=1, inputSize=512, hiddenSize=512,
                miniBatch=64, device='cuda', seed=None):
@@ -97,6 +141,7 @@ def trainbench(name, rnn_creator, nloops=100, warmup=10,
 
     results = [train_batch(modeldef) for _ in range(nloops)]
     fwd_times, bwd_times = zip(*results)
+    fwd_stats, bwd_stats = measure_batch(modeldef)
 
     fwd_times = torch.tensor(fwd_times)
     bwd_times = torch.tensor(bwd_times)
@@ -106,7 +151,13 @@ def trainbench(name, rnn_creator, nloops=100, warmup=10,
                        info_fwd=fwd_times,
                        avg_bwd=bwd_times.mean().item(),
                        std_bwd=bwd_times.std().item(),
-                       info_bwd=bwd_times)
+                       info_bwd=bwd_times,
+                       mem_fwd_mb=fwd_stats.peak_mem_mb,
+                       allocs_fwd=fwd_stats.allocs,
+                       kernels_fwd=fwd_stats.kernels,
+                       mem_bwd_mb=bwd_stats.peak_mem_mb,
+                       allocs_bwd=bwd_stats.allocs,
+                       kernels_bwd=bwd_stats.kernels)
 
 
 def print_stderr(*args, **kwargs):
@@ -125,6 +176,17 @@ def print_json_oss_format(results):
     print(json.dumps(oss_results))
 
 
+def print_json_stats_format(results):
+    # times and memory stats, without the times of each iteration
+    print(json.dumps({
+        group_name: {
+            model_name: {k: v for k, v in stats.items() if k != 'info'}
+            for model_name, stats in group_val.items()
+        }
+        for group_name, group_val in results.items()
+    }))
+
+
 def print_json_pep_format(results):
     # print the AI-PEP format json string for each model
     for group_name, group_val in results.items():
@@ -160,8 +222,12 @@ def bench(rnn_runners, group_name, print_json=False, sep=' ', **params):
                     raise
 
     return {
-        group_name: {k: {"avg": v.avg_fwd, "std": v.std_fwd, "info": v.info_fwd} for k, v in results.items()},
-        group_name + '-backward': {k: {"avg": v.avg_bwd, "std": v.std_bwd, "info": v.info_bwd} for k, v in results.items()},
+        group_name: {k: {"avg": v.avg_fwd, "std": v.std_fwd, "info": v.info_fwd,
+                         "peak_memory_mb": v.mem_fwd_mb, "allocations": v.allocs_fwd,
+                         "kernels": v.kernels_fwd} for k, v in results.items()},
+        group_name + '-backward': {k: {"avg": v.avg_bwd, "std": v.std_bwd, "info": v.info_bwd,
+                                       "peak_memory_mb": v.mem_bwd_mb, "allocations": v.allocs_bwd,
+                                       "kernels": v.kernels_bwd} for k, v in results.items()},
     }
 
 
@@ -193,7 +259,9 @@ if __name__ == '__main__':
                         'Note that some of these run really slowly '
                         'and that the `seqLength` flag will be ignored.')
     parser.add_argument('--sep', default=' ', type=str)
-    parser.add_argument('--print-json', nargs='?', default=None, const='oss')
+    parser.add_argument('--print-json', nargs='?', default=None, const='oss',
+                        help='Print the results as json: oss (average times only, '
+                        'the default), stats (times and memory stats) or pep')
     parser.add_argument('--rnns', nargs='*',
                         help='What to run. cudnn, aten, jit, etc')
     parser.add_argument('--cnns', nargs='*',
@@ -235,5 +303,7 @@ if __name__ == '__main__':
 
     if args.print_json == 'oss':
         print_json_oss_format(results)
+    elif args.print_json == 'stats':
+        print_json_stats_format(results)
     elif args.print_json == 'pep':
         print_json_pep_format(results)
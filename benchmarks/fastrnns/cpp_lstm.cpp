@@ -0,0 +1,68 @@
+// torch::nn::LSTM, exposed to the fastrnns benchmarks. Runs the same ATen
+// kernels as torch.nn.LSTM, so comparing the two measures the overhead of
+// the Python frontend.
+
+#include <torch/extension.h>
+
+#include <tuple>
+#include <vector>
+
+class CppLSTM {
+ public:
+  // Copies the weights of a torch.nn.LSTM, given in the order of its
+  // all_weights flattened: (w_ih, w_hh, b_ih, b_hh) for each layer.
+  CppLSTM(
+      int64_t input_size,
+      int64_t hidden_size,
+      int64_t num_layers,
+      const std::vector<torch::Tensor>& weights)
+      : lstm_(torch::nn::LSTMOptions(input_size, hidden_size)
+                  .layers(num_layers)) {
+    TORCH_CHECK(
+        static_cast<int64_t>(weights.size()) == 4 * num_layers,
+        "expected ", 4 * num_layers, " weights, got ", weights.size());
+    lstm_->to(weights[0].device());
+    {
+      torch::NoGradGuard no_grad;
+      for (int64_t layer = 0; layer < num_layers; layer++) {
+        lstm_->w_ih[layer].copy_(weights[4 * layer]);
+        lstm_->w_hh[layer].copy_(weights[4 * layer + 1]);
+        lstm_->b_ih[layer].copy_(weights[4 * layer + 2]);
+        lstm_->b_hh[layer].copy_(weights[4 * layer + 3]);
+      }
+    }
+    lstm_->flatten_parameters();
+  }
+
+  std::tuple<torch::Tensor, std::tuple<torch::Tensor, torch::Tensor>> forward(
+      const torch::Tensor& input,
+      std::tuple<torch::Tensor, torch::Tensor> hidden) {
+    auto result = lstm_->forward(
+        input, torch::stack({std::get<0>(hidden), std::get<1>(hidden)}));
+    return std::make_tuple(
+        result.output, std::make_tuple(result.state[0], result.state[1]));
+  }
+
+  // The parameters, in the same order as the weights of the constructor.
+  std::vector<torch::Tensor> parameters() {
+    std::vector<torch::Tensor> params;
+    for (size_t layer = 0; layer < lstm_->w_ih.size(); layer++) {
+      params.push_back(lstm_->w_ih[layer]);
+      params.push_back(lstm_->w_hh[layer]);
+      params.push_back(lstm_->b_ih[layer]);
+      params.push_back(lstm_->b_hh[layer]);
+    }
+    return params;
+  }
+
+ private:
+  torch::nn::LSTM lstm_;
+};
+
+PYBIND11_MODULE(TORCH_EXTENSION_NAME, m) {
+  py::class_<CppLSTM>(m, "CppLSTM")
+      .def(py::init<int64_t, int64_t, int64_t, const std::vector<torch::Tensor>&>())
+      .def("forward", &CppLSTM::forward)
+      .def("__call__", &CppLSTM::forward)
+      .def("parameters", &CppLSTM::parameters);
+}
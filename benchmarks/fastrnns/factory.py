@@ -62,6 +62,23 @@ def pytorch_lstm_creator(**kwargs):
         backward=simple_backward)
 
 
+def cpp_lstm_creator(**kwargs):
+    # torch::nn::LSTM, built on first use
+    import os
+    from torch.utils.cpp_extension import load
+    cpp_lstm = load(name='fastrnns_cpp_lstm',
+                    sources=[os.path.join(os.path.dirname(__file__), 'cpp_lstm.cpp')])
+    input, hidden, params, _ = lstm_inputs(return_module=False, **kwargs)
+    module = cpp_lstm.CppLSTM(kwargs['inputSize'], kwargs['hiddenSize'],
+                              kwargs['numLayers'], flatten_list(params))
+    return ModelDef(
+        inputs=[input, hidden],
+        params=module.parameters(),
+        forward=module,
+        backward_setup=lstm_backward_setup,
+        backward=simple_backward)
+
+
 def lstm_creator(script=True, **kwargs):
     input, hidden, params, _ = lstm_inputs(return_module=False, **kwargs)
     inputs = [input, hidden] + params[0]
@@ -1,6 +1,7 @@
 from __future__ import absolute_import, division, print_function, unicode_literals
 from utils import ms_to_us, benchmark_module, BenchmarkConfig, ModuleConfig
 import argparse
+import torch
 from C2Module import C2SimpleNet
 
 from SimpleAddModule import SimpleAddModule, add_tensors_loop
@@ -13,6 +14,12 @@ As of now runs only forward pass.
 Supports both graph mode and eager mode. In graph mode the module is traced via JIT tracing.
 Debug option prints the traced graph is graph_mode is enabled.
 Graph can be saved via save option. Saved in the directory where benchmark is run.
+The broadcast option adds tensors of different shapes, which TensorIterator can't
+set up with its fast path. tensor_iterator_plan_cache enables the TensorIterator
+plan cache, which helps in that case.
+In graph mode the interpreter fuses the operand loads, op and store of each op
+into one superinstruction; no_superinstructions turns that off to measure the
+per-op dispatch overhead it saves.
 Example build/run:
 To run PT benchmark:
 buck run @mode/opt <path-to-framework_overhead_benchmark>:framework_overhead_benchmark --
@@ -58,7 +65,15 @@ def benchmark_simple_fn(args, config, module_config, module_type, result):
         f_name = module_config.pt_fn.__name__ + ":Num Operands=" + str(module_config.num_params)
         graph_mode_str = "Graph mode" + ":" + str(module_config.graph_mode)
         result_key = ','.join((f_name, graph_mode_str))
-        module = WrapperModule(module_type, module_config, args.debug, args.save)
+        input_shapes = None
+        if args.broadcast:
+            input_shapes = [(4, 1)] + [(4,)] * (module_config.num_params - 1)
+            result_key += ",Broadcast"
+        if args.tensor_iterator_plan_cache:
+            result_key += ",TensorIterator plan cache"
+        if args.no_superinstructions:
+            result_key += ",No superinstructions"
+        module = WrapperModule(module_type, module_config, args.debug, args.save, input_shapes)
         latency_per_iter_ms = benchmark_module(config, module, args.use_throughput_benchmark)
         result[result_key] = latency_per_iter_ms
 
@@ -70,6 +85,9 @@ def main():
     parser.add_argument("--debug", default=False, dest="debug", action="store_true")
     parser.add_argument("--save", default=False, dest="save", action="store_true")
     parser.add_argument("--eager_mode", default=False, dest="eager_mode", action="store_true")
+    parser.add_argument("--broadcast", default=False, dest="broadcast", action="store_true")
+    parser.add_argument("--tensor_iterator_plan_cache", default=False, dest="tensor_iterator_plan_cache", action="store_true")
+    parser.add_argument("--no_superinstructions", default=False, dest="no_superinstructions", action="store_true")
     parser.add_argument("--num_warmup_iters", type=int, default=100)
     parser.add_argument("--num_iters", type=int, default=1000)
     args = parser.parse_args()
@@ -80,6 +98,11 @@ def main():
     assert not (args.benchmark_c2_net and args.use_throughput_benchmark), \
         "Benchmarking of C2 net via throughput benchmarking is not yet supported"
 
+    if args.tensor_iterator_plan_cache:
+        torch._C._set_tensor_iterator_plan_cache(True)
+    if args.no_superinstructions:
+        torch._C._jit_set_interpreter_superinstructions(False)
+
     num_warmup_iters = args.num_warmup_iters
     num_iters = args.num_iters
     config = BenchmarkConfig(num_warmup_iters, num_iters)
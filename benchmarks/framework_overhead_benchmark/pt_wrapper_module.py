@@ -4,7 +4,8 @@ import torch
 class WrapperModule(object):
     """ Wraps the instance of wrapped_type.
     For graph_mode traces the instance of wrapped_type.
-    Randomaly initializes num_params tensors with single float element.
+    Randomaly initializes num_params tensors with single float element, or
+    with the shapes in input_shapes.
     Args:
         wrapped_type:
             - Object type to be wrapped.
@@ -19,14 +20,18 @@ class WrapperModule(object):
             - Whether debug mode is enabled.
         save:
             - In graph mode, whether graph is to be saved.
+        input_shapes:
+            - Shape of each of the num_params inputs.
     """
-    def __init__(self, wrapped_type, module_config, debug, save=False):
+    def __init__(self, wrapped_type, module_config, debug, save=False, input_shapes=None):
         pt_fn = module_config.pt_fn
         self.module = wrapped_type(pt_fn)
         self.tensor_inputs = []
         self.module_name = wrapped_type.__name__
-        for _ in range(module_config.num_params):
-            self.tensor_inputs.append(torch.randn(1))
+        if input_shapes is None:
+            input_shapes = [(1,)] * module_config.num_params
+        for shape in input_shapes:
+            self.tensor_inputs.append(torch.randn(*shape))
         if module_config.graph_mode:
             self.module = torch.jit.trace(self.module, self.tensor_inputs)
             if save:
@@ -10,6 +10,7 @@ import json
 import torch
 import copy
 import ast
+import re
 
 # needs to be imported after torch
 import cpp_extension # noqa
@@ -361,7 +362,27 @@ class BenchmarkRunner(object):
 
         return False
 
+    def _export_cpp_config(self, test_case, out):
+        # One line per test: the module name, the test name, then the
+        # key=value pairs of its input config. The C++ harness only knows
+        # the forward path of the PyTorch ops it implements.
+        if test_case.framework != "PyTorch" or test_case.test_config.run_backward:
+            return
+        attrs = re.split(r', (?=\w+: )', test_case.test_config.input_config)
+        pairs = ['{}={}'.format(key, value.replace(' ', ''))
+                 for key, value in (attr.split(': ', 1) for attr in attrs)]
+        out.write(' '.join([test_case.op_bench.module_name(),
+                            test_case.test_config.test_name] + pairs) + '\n')
+
     def run(self):
+        if self.args.export_cpp_configs:
+            with open(self.args.export_cpp_configs, 'w') as out:
+                for test_metainfo in BENCHMARK_TESTER:
+                    for _, test_case in _build_test(*test_metainfo):
+                        if self._keep_test(test_case):
+                            self._export_cpp_config(test_case, out)
+            return
+
         self._print_header()
 
         for test_metainfo in BENCHMARK_TESTER:
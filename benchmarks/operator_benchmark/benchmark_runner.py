@@ -132,6 +132,12 @@ def main():
         help='Run tests on the provided architecture (cpu, cuda)',
         default='None')
 
+    parser.add_argument(
+        '--export_cpp_configs',
+        help='Write the configs of the selected PyTorch forward tests to this file, '
+             'as input of the C++ harness (binaries/aten_op_benchmark.cc), instead of running them',
+        default=None)
+
     args, _ = parser.parse_known_args()
 
     if args.omp_num_threads:
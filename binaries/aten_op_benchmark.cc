@@ -0,0 +1,318 @@
+// C++ harness for the operator benchmarks.
+//
+// Runs the forward path of the PyTorch operator_benchmark tests straight
+// on ATen, without the Python and argument parsing overhead that the Python
+// runner includes in its numbers. The tests come from the operator_benchmark
+// configs, exported with
+//
+//   cd benchmarks/operator_benchmark
+//   python -m benchmark_all_test --device cpu --export_cpp_configs configs.txt
+//
+// and run with
+//
+//   aten_op_benchmark --configs configs.txt --first_cpu 2 \
+//     --benchmark_out=results.json --benchmark_out_format=json
+//
+// Every iteration is timed on its own, after a warmup that brings the
+// inputs into the caches. Besides the mean time reported by Google
+// Benchmark, each test reports the median and p99 of the iteration times,
+// along with distribution-free 95% confidence intervals, as counters in us.
+// Only CPU tests are run.
+
+#include "benchmark/benchmark.h"
+
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <c10/util/Flags.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+C10_DEFINE_string(configs, "", "File of test configs, from --export_cpp_configs");
+C10_DEFINE_int(intra_op_threads, 1, "Number of intra-op threads");
+C10_DEFINE_int(
+    first_cpu,
+    -1,
+    "If not negative, pin the process to CPUs first_cpu to "
+    "first_cpu + intra_op_threads - 1");
+C10_DEFINE_int(warmup_iterations, 100, "Iterations to run before timing a test");
+
+namespace {
+
+// The key=value pairs of a test config.
+struct Config {
+  std::unordered_map<std::string, std::string> values;
+
+  const std::string& get(const std::string& key) const {
+    auto it = values.find(key);
+    TORCH_CHECK(it != values.end(), "missing config attribute ", key);
+    return it->second;
+  }
+  int64_t getInt(const std::string& key) const {
+    return std::stoll(get(key));
+  }
+  bool getBool(const std::string& key) const {
+    return get(key) == "True";
+  }
+};
+
+struct TestCase {
+  std::string module_name;
+  std::string test_name;
+  Config config;
+};
+
+// Builds the inputs of a test and returns a function running the op on them.
+using OpFactory = std::function<std::function<void()>(const Config&)>;
+
+std::unordered_map<std::string, OpFactory>& opRegistry() {
+  static std::unordered_map<std::string, OpFactory> registry;
+  return registry;
+}
+
+struct RegisterOp {
+  RegisterOp(const std::string& module_name, OpFactory factory) {
+    opRegistry().emplace(module_name, std::move(factory));
+  }
+};
+
+// The ops below mirror the init() and forward() of the benchmarks in
+// benchmarks/operator_benchmark/pt, keyed by their module names.
+
+RegisterOp add_op("add", [](const Config& c) {
+  auto a = at::rand({c.getInt("M"), c.getInt("N"), c.getInt("K")});
+  auto b = at::rand({c.getInt("M"), c.getInt("N"), c.getInt("K")});
+  return [=] { at::add(a, b); };
+});
+
+RegisterOp addmm_op("addmm", [](const Config& c) {
+  const int64_t M = c.getInt("M"), N = c.getInt("N"), K = c.getInt("K");
+  auto input = at::rand({M, K});
+  auto mat1 = at::rand({M, N});
+  auto mat2 = at::rand({N, K});
+  return [=] { at::addmm(input, mat1, mat2); };
+});
+
+RegisterOp matmul_op("matmul", [](const Config& c) {
+  const int64_t M = c.getInt("M"), N = c.getInt("N"), K = c.getInt("K");
+  auto a = c.getBool("trans_a") ? at::rand({M, N}) : at::rand({N, M}).t();
+  auto b = c.getBool("trans_b") ? at::rand({N, K}) : at::rand({K, N}).t();
+  return [=] { at::matmul(a, b); };
+});
+
+RegisterOp linear_op("linear", [](const Config& c) {
+  auto input = at::rand({c.getInt("N"), c.getInt("IN")});
+  auto weight = at::rand({c.getInt("OUT"), c.getInt("IN")});
+  auto bias = at::rand({c.getInt("OUT")});
+  return [=] { at::linear(input, weight, bias); };
+});
+
+// Conv{1,2,3}d and ConvTranspose{1,2,3}d, with the spatial sizes of the
+// input named by dims.
+OpFactory convolution(std::vector<std::string> dims, bool transposed) {
+  return [dims, transposed](const Config& c) {
+    const int64_t in_c = c.getInt("in_c"), out_c = c.getInt("out_c");
+    std::vector<int64_t> input_size{c.getInt("N"), in_c};
+    std::vector<int64_t> weight_size{
+        transposed ? in_c : out_c, transposed ? out_c : in_c};
+    for (const auto& dim : dims) {
+      input_size.push_back(c.getInt(dim));
+      weight_size.push_back(c.getInt("kernel"));
+    }
+    auto input = at::rand(input_size);
+    auto weight = at::rand(weight_size);
+    auto bias = at::rand({out_c});
+    const std::vector<int64_t> stride(dims.size(), c.getInt("stride"));
+    const std::vector<int64_t> zeros(dims.size(), 0);
+    const std::vector<int64_t> ones(dims.size(), 1);
+    return std::function<void()>([=] {
+      at::convolution(input, weight, bias, stride, zeros, ones, transposed, zeros, 1);
+    });
+  };
+}
+
+RegisterOp conv1d_op("Conv1d", convolution({"L"}, false));
+RegisterOp conv2d_op("Conv2d", convolution({"H", "W"}, false));
+RegisterOp conv3d_op("Conv3d", convolution({"D", "H", "W"}, false));
+RegisterOp conv_transpose1d_op("ConvTranspose1d", convolution({"L"}, true));
+RegisterOp conv_transpose2d_op("ConvTranspose2d", convolution({"H", "W"}, true));
+RegisterOp conv_transpose3d_op("ConvTranspose3d", convolution({"D", "H", "W"}, true));
+
+OpFactory softmax(bool log) {
+  return [log](const Config& c) {
+    auto input = at::rand({c.getInt("N"), c.getInt("C"), c.getInt("H"), c.getInt("W")});
+    return std::function<void()>([=] {
+      log ? at::log_softmax(input, 1) : at::softmax(input, 1);
+    });
+  };
+}
+
+// nn.Softmax() picks dim 1 for 4-d inputs, like Softmax2d.
+RegisterOp softmax_op("Softmax", softmax(false));
+RegisterOp softmax2d_op("Softmax2d", softmax(false));
+RegisterOp log_softmax_op("LogSoftmax", softmax(true));
+
+// Pointwise unary ops, on an (M, N) input.
+struct UnaryOps {
+  UnaryOps(std::initializer_list<std::pair<const char*, at::Tensor (*)(const at::Tensor&)>> ops) {
+    for (const auto& op : ops) {
+      auto fn = op.second;
+      RegisterOp(op.first, [fn](const Config& c) {
+        auto input = at::rand({c.getInt("M"), c.getInt("N")});
+        return std::function<void()>([=] { fn(input); });
+      });
+    }
+  }
+};
+
+#define UNARY_OP(name) {#name, [](const at::Tensor& t) { return at::name(t); }}
+#define UNARY_OP_(name) {#name "_", [](const at::Tensor& t) { return t.name##_(); }}
+
+UnaryOps unary_ops({
+    UNARY_OP(abs), UNARY_OP_(abs), UNARY_OP(ceil), UNARY_OP_(ceil),
+    UNARY_OP(cos), UNARY_OP_(cos), UNARY_OP(exp), UNARY_OP_(exp),
+    UNARY_OP(floor), UNARY_OP_(floor), UNARY_OP(log), UNARY_OP_(log),
+    UNARY_OP(neg), UNARY_OP_(neg), UNARY_OP(reciprocal), UNARY_OP_(reciprocal),
+    UNARY_OP(relu), UNARY_OP_(relu), UNARY_OP(round), UNARY_OP_(round),
+    UNARY_OP(rsqrt), UNARY_OP_(rsqrt), UNARY_OP(sigmoid), UNARY_OP_(sigmoid),
+    UNARY_OP(sin), UNARY_OP_(sin), UNARY_OP(sqrt), UNARY_OP_(sqrt),
+    UNARY_OP(tanh), UNARY_OP_(tanh), UNARY_OP(trunc), UNARY_OP_(trunc),
+});
+
+#undef UNARY_OP
+#undef UNARY_OP_
+
+std::vector<TestCase> readConfigs(const std::string& path) {
+  std::ifstream file(path);
+  TORCH_CHECK(file, "could not open ", path);
+  std::vector<TestCase> tests;
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream fields(line);
+    TestCase test;
+    if (!(fields >> test.module_name >> test.test_name)) {
+      continue;
+    }
+    std::string pair;
+    while (fields >> pair) {
+      const auto eq = pair.find('=');
+      if (eq != std::string::npos) {
+        test.config.values[pair.substr(0, eq)] = pair.substr(eq + 1);
+      }
+    }
+    tests.push_back(std::move(test));
+  }
+  return tests;
+}
+
+// Order statistic of sorted samples at rank (0-based, clamped).
+double rankValue(const std::vector<double>& sorted, double rank) {
+  const auto index = static_cast<int64_t>(rank);
+  return sorted[std::min<int64_t>(
+      std::max<int64_t>(index, 0), static_cast<int64_t>(sorted.size()) - 1)];
+}
+
+// Fills the counters with the q quantile of the samples and the bounds of
+// its 95% confidence interval. The number of samples below the quantile is
+// Binomial(n, q), so with the normal approximation the interval is given by
+// the order statistics at ranks n q -/+ 1.96 sqrt(n q (1 - q)).
+void reportQuantile(
+    benchmark::State& state,
+    const std::vector<double>& sorted,
+    double q,
+    const std::string& name) {
+  const double n = sorted.size();
+  const double half_width = 1.96 * std::sqrt(n * q * (1 - q));
+  state.counters[name + "_us"] = rankValue(sorted, n * q);
+  state.counters[name + "_ci_lo_us"] = rankValue(sorted, std::floor(n * q - half_width));
+  state.counters[name + "_ci_hi_us"] = rankValue(sorted, std::ceil(n * q + half_width));
+}
+
+void runTest(benchmark::State& state, const TestCase& test) {
+  auto op = opRegistry().at(test.module_name)(test.config);
+  for (int i = 0; i < FLAGS_warmup_iterations; i++) {
+    op();
+  }
+
+  using clock = std::chrono::steady_clock;
+  std::vector<double> samples_us;
+  for (auto _ : state) {
+    const auto start = clock::now();
+    op();
+    const auto end = clock::now();
+    samples_us.push_back(
+        std::chrono::duration<double, std::micro>(end - start).count());
+  }
+  std::sort(samples_us.begin(), samples_us.end());
+  reportQuantile(state, samples_us, 0.5, "median");
+  reportQuantile(state, samples_us, 0.99, "p99");
+}
+
+void pinThreads() {
+  if (FLAGS_first_cpu < 0) {
+    return;
+  }
+#ifdef __linux__
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  for (int i = 0; i < FLAGS_intra_op_threads; i++) {
+    CPU_SET(FLAGS_first_cpu + i, &cpus);
+  }
+  // Threads started from now on, including the intra-op pool, inherit the
+  // affinity.
+  TORCH_CHECK(
+      sched_setaffinity(0, sizeof(cpus), &cpus) == 0,
+      "could not pin the process to CPUs ", FLAGS_first_cpu, " to ",
+      FLAGS_first_cpu + FLAGS_intra_op_threads - 1);
+#else
+  std::cerr << "--first_cpu is only supported on Linux" << std::endl;
+#endif
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (!c10::ParseCommandLineFlags(&argc, &argv)) {
+    std::cerr << "Failed to parse command line flags" << std::endl;
+    return 1;
+  }
+  if (FLAGS_configs.empty()) {
+    std::cerr << "--configs is required" << std::endl;
+    return 1;
+  }
+  pinThreads();
+  at::init_num_threads();
+  at::set_num_threads(FLAGS_intra_op_threads);
+
+  const auto tests = readConfigs(FLAGS_configs);
+  for (const auto& test : tests) {
+    const auto device = test.config.values.find("device");
+    if (device != test.config.values.end() && device->second != "cpu") {
+      continue;
+    }
+    if (!opRegistry().count(test.module_name)) {
+      std::cerr << "Skipping " << test.test_name << ": " << test.module_name
+                << " is not implemented in C++" << std::endl;
+      continue;
+    }
+    benchmark::RegisterBenchmark(
+        test.test_name.c_str(),
+        [test](benchmark::State& state) { runTest(state, test); })
+        ->UseRealTime();
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
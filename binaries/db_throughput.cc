@@ -32,6 +32,15 @@ C10_DEFINE_int(
     num_read_threads,
     1,
     "The number of concurrent reading threads.");
+C10_DEFINE_int(
+    prefetch_cursors,
+    0,
+    "If positive, the reader prefetches with this many cursors, each over "
+    "its own key range. Implies --use_reader.");
+C10_DEFINE_int(
+    prefetch_buffer_size,
+    1024,
+    "The number of records the prefetching reader buffers.");
 
 using caffe2::db::Cursor;
 using caffe2::db::DB;
@@ -82,6 +91,10 @@ void TestThroughputWithReaderWorker(const DBReader* reader, int thread_id) {
 
 void TestThroughputWithReader() {
   caffe2::db::DBReader reader(FLAGS_input_db_type, FLAGS_input_db);
+  if (FLAGS_prefetch_cursors > 0) {
+    reader.StartPrefetching(FLAGS_prefetch_cursors, FLAGS_prefetch_buffer_size);
+  }
+  caffe2::Timer timer;
   std::vector<std::unique_ptr<std::thread>> reading_threads(
       FLAGS_num_read_threads);
   for (int i = 0; i < reading_threads.size(); ++i) {
@@ -91,11 +104,17 @@ void TestThroughputWithReader() {
   for (int i = 0; i < reading_threads.size(); ++i) {
     reading_threads[i]->join();
   }
+  double elapsed_seconds = timer.Seconds();
+  printf(
+      "Overall, took %4.5f seconds, throughput %f items/sec.\n",
+      elapsed_seconds,
+      static_cast<double>(FLAGS_num_read_threads) * FLAGS_repeat *
+          FLAGS_report_interval / elapsed_seconds);
 }
 
 int main(int argc, char** argv) {
   caffe2::GlobalInit(&argc, &argv);
-  if (FLAGS_use_reader) {
+  if (FLAGS_use_reader || FLAGS_prefetch_cursors > 0) {
     TestThroughputWithReader();
   } else {
     TestThroughputWithDB();
@@ -21,6 +21,8 @@ C10_DEFINE_int(benchmark_iter, 10, "Number of times to run benchmark")
 C10_DEFINE_bool(extra_stats, false,
     "Collect extra stats; warning: skews results");
 C10_DEFINE_string(task_type, "add", "Tensor operation: add or mm");
+C10_DEFINE_bool(nested_parallel_for, false,
+    "Split the task tree with nested at::parallel_for instead of at::launch");
 
 namespace {
 std::atomic<int> counter{0};
@@ -62,6 +64,13 @@ void _launch_tasks_tree(
         }
       }
     });
+  } else if (FLAGS_nested_parallel_for) {
+    at::parallel_for(0, 2, 1,
+        [&left, &right, level, end_level](int64_t begin, int64_t end) {
+      for (auto k = begin; k < end; ++k) {
+        _launch_tasks_tree(level + 1, end_level, left, right);
+      }
+    });
   } else {
     at::launch([&left, &right, level, end_level]() {
       _launch_tasks_tree(level + 1, end_level, left, right);
@@ -142,7 +151,9 @@ int main(int argc, char** argv) {
             << at::get_num_interop_threads() << " inter-op threads and "
             << at::get_num_threads() << " intra-op threads, "
             << "tensor dim: " << FLAGS_tensor_dim
-            << ", task type: " << FLAGS_task_type << std::endl;
+            << ", task type: " << FLAGS_task_type
+            << (FLAGS_nested_parallel_for ? ", nested parallel_for" : "")
+            << std::endl;
 
   std::vector<float> runtimes;
   for (auto bench_iter = 0; bench_iter < FLAGS_benchmark_iter; ++bench_iter) {
@@ -14,14 +14,29 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <vector>
 
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
 #include "ATen/ATen.h"
+#include "ATen/Parallel.h"
 #include "caffe2/core/timer.h"
 #include "caffe2/utils/string_utils.h"
 #include "torch/csrc/autograd/grad_mode.h"
 #include "torch/csrc/jit/import.h"
+#include "torch/csrc/jit/mobile/import.h"
+#include "torch/csrc/jit/mobile/observer.h"
 #include "torch/script.h"
 
 #include <chrono>
@@ -49,6 +64,37 @@ C10_DEFINE_bool(
   "Whether to print performance stats for AI-PEP.");
 
 C10_DEFINE_int(pytext_len, 0, "Length of input sequence.");
+C10_DEFINE_bool(
+  use_bytecode,
+  false,
+  "Whether the model is a bytecode model saved with _save_for_mobile, "
+  "to be run by the lite interpreter.");
+C10_DEFINE_bool(
+  report_ops,
+  false,
+  "Whether to report the latency, input shapes and allocated bytes of each "
+  "operator during the main runs. Requires --use_bytecode.");
+C10_DEFINE_int(
+  op_sample_rate,
+  1,
+  "With --report_ops, only measure one in this many operator runs.");
+C10_DEFINE_string(
+  concurrency,
+  "",
+  "Comma separated numbers of concurrent clients. If set, measure the "
+  "throughput of the model shared by that many threads, each sending --iter "
+  "requests, for each number of clients instead of the single stream "
+  "latency.");
+C10_DEFINE_string(
+  intra_op_threads,
+  "",
+  "With --concurrency, comma separated numbers of intra-op threads for each "
+  "client to sweep. Changing it between runs needs the OpenMP parallel "
+  "backend, the native backend keeps the first setting.");
+C10_DEFINE_int(
+  inter_op_threads,
+  0,
+  "If positive, the number of threads of the inter-op thread pool.");
 
 std::vector<std::string>
 split(char separator, const std::string& string, bool ignore_empty = true) {
@@ -63,6 +109,186 @@ split(char separator, const std::string& string, bool ignore_empty = true) {
   return pieces;
 }
 
+// Aggregates the operator stats reported by the lite interpreter, per
+// operator of the model.
+class OperatorStatsObserver final : public torch::MobileOperatorObserver {
+ public:
+  struct Totals {
+    std::string name;
+    std::vector<std::vector<int64_t>> input_shapes;
+    int64_t runs = 0;
+    int64_t latency_us = 0;
+    int64_t allocated_bytes = 0;
+  };
+  // The stats are shared with the caller, as the config owns the observer
+  explicit OperatorStatsObserver(
+      std::shared_ptr<std::map<size_t, Totals>> totals)
+      : totals_(std::move(totals)) {}
+
+  bool shouldObserve(const c10::OperatorName&) override {
+    return count_++ % FLAGS_op_sample_rate == 0;
+  }
+
+  void onOperator(const torch::MobileOperatorStats& stats) override {
+    auto& totals = (*totals_)[stats.op_idx];
+    if (totals.runs == 0) {
+      totals.name = stats.op_name->name;
+      if (!stats.op_name->overload_name.empty()) {
+        totals.name += "." + stats.op_name->overload_name;
+      }
+      totals.input_shapes = stats.input_shapes;
+    }
+    ++totals.runs;
+    totals.latency_us += stats.latency_us;
+    totals.allocated_bytes += stats.allocated_bytes;
+  }
+
+ private:
+  std::shared_ptr<std::map<size_t, Totals>> totals_;
+  int64_t count_ = 0;
+};
+
+std::string shapesToString(const std::vector<std::vector<int64_t>>& shapes) {
+  std::stringstream ss;
+  ss << "[";
+  for (size_t i = 0; i < shapes.size(); ++i) {
+    ss << (i > 0 ? ", " : "") << "[";
+    for (size_t j = 0; j < shapes[i].size(); ++j) {
+      ss << (j > 0 ? ", " : "") << shapes[i][j];
+    }
+    ss << "]";
+  }
+  ss << "]";
+  return ss.str();
+}
+
+void reportOperatorStats(
+    const std::map<size_t, OperatorStatsObserver::Totals>& all_totals) {
+  for (const auto& entry : all_totals) {
+    const auto& totals = entry.second;
+    const double latency_us =
+        static_cast<double>(totals.latency_us) / totals.runs;
+    const double allocated_bytes =
+        static_cast<double>(totals.allocated_bytes) / totals.runs;
+    if (FLAGS_report_pep) {
+      std::cout << "PyTorchObserver {\"type\": \"" << entry.first << ":"
+                << totals.name << "\", \"unit\": \"us\", \"metric\": "
+                << "\"latency\", \"value\": \"" << latency_us << "\"}"
+                << std::endl;
+      std::cout << "PyTorchObserver {\"type\": \"" << entry.first << ":"
+                << totals.name << "\", \"unit\": \"bytes\", \"metric\": "
+                << "\"allocated\", \"value\": \"" << allocated_bytes
+                << "\"}" << std::endl;
+    } else {
+      std::cout << "Op " << entry.first << " " << totals.name << " inputs "
+                << shapesToString(totals.input_shapes) << ": " << latency_us
+                << " us, " << allocated_bytes << " bytes allocated"
+                << std::endl;
+    }
+  }
+}
+
+std::vector<int> parseIntList(const std::string& flag) {
+  std::vector<int> values;
+  for (const auto& s : split(',', flag)) {
+    values.push_back(c10::stoi(s));
+    CAFFE_ENFORCE_GT(values.back(), 0, "Expected a positive number, got ", s);
+  }
+  return values;
+}
+
+// Peak resident set size of the process so far, in KB.
+long peakRssKb() {
+#ifndef _WIN32
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    return usage.ru_maxrss;
+  }
+#endif
+  return -1;
+}
+
+double percentile(const std::vector<double>& sorted, double q) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const size_t index = std::min(
+      sorted.size() - 1, static_cast<size_t>(q * sorted.size()));
+  return sorted[index];
+}
+
+// Runs FLAGS_iter requests from each of num_clients threads sharing the
+// model, and reports the throughput and latency percentiles as one JSON
+// line. The clients warm up on their own, then start together.
+void runConcurrentClients(
+    const std::function<c10::IValue()>& forward,
+    int num_clients,
+    int intra_op_threads) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  int ready = 0;
+  bool started = false;
+  std::vector<std::vector<double>> latencies_ms(num_clients);
+
+  std::vector<std::thread> clients;
+  for (int client = 0; client < num_clients; ++client) {
+    clients.emplace_back([&, client]() {
+      // the grad mode and the optimizer setting are thread local
+      torch::autograd::AutoGradMode guard(false);
+      torch::jit::GraphOptimizerEnabledGuard no_optimizer_guard(false);
+      at::set_num_threads(intra_op_threads);
+      for (int i = 0; i < FLAGS_warmup; ++i) {
+        forward();
+      }
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        ++ready;
+        cv.notify_all();
+        cv.wait(lock, [&] { return started; });
+      }
+      auto& latencies = latencies_ms[client];
+      latencies.reserve(FLAGS_iter);
+      for (int i = 0; i < FLAGS_iter; ++i) {
+        auto start = high_resolution_clock::now();
+        forward();
+        auto stop = high_resolution_clock::now();
+        latencies.push_back(
+            duration_cast<duration<double, std::milli>>(stop - start).count());
+      }
+    });
+  }
+
+  high_resolution_clock::time_point start;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return ready == num_clients; });
+    started = true;
+    start = high_resolution_clock::now();
+  }
+  cv.notify_all();
+  for (auto& client : clients) {
+    client.join();
+  }
+  const double seconds =
+      duration_cast<duration<double>>(high_resolution_clock::now() - start)
+          .count();
+
+  std::vector<double> all_latencies;
+  for (const auto& latencies : latencies_ms) {
+    all_latencies.insert(all_latencies.end(), latencies.begin(), latencies.end());
+  }
+  std::sort(all_latencies.begin(), all_latencies.end());
+  std::cout << "PyTorchThroughput {\"concurrency\": " << num_clients
+            << ", \"intra_op_threads\": " << intra_op_threads
+            << ", \"inter_op_threads\": " << at::get_num_interop_threads()
+            << ", \"requests\": " << all_latencies.size()
+            << ", \"requests_per_second\": " << all_latencies.size() / seconds
+            << ", \"latency_p50_ms\": " << percentile(all_latencies, 0.5)
+            << ", \"latency_p90_ms\": " << percentile(all_latencies, 0.9)
+            << ", \"latency_p99_ms\": " << percentile(all_latencies, 0.99)
+            << ", \"peak_rss_kb\": " << peakRssKb() << "}" << std::endl;
+}
+
 int main(int argc, char** argv) {
   c10::SetUsageMessage(
     "Run speed benchmark for pytorch model.\n"
@@ -77,6 +303,9 @@ int main(int argc, char** argv) {
     std::cerr << "Failed to parse command line flags!" << std::endl;
     return 1;
   }
+  if (FLAGS_inter_op_threads > 0) {
+    at::set_num_interop_threads(FLAGS_inter_op_threads);
+  }
 
   CAFFE_ENFORCE_GE(FLAGS_input_dims.size(), 0, "Input dims must be specified.");
   CAFFE_ENFORCE_GE(FLAGS_input_type.size(), 0, "Input type must be specified.");
@@ -117,11 +346,46 @@ int main(int argc, char** argv) {
   }
   torch::autograd::AutoGradMode guard(false);
   torch::jit::GraphOptimizerEnabledGuard no_optimizer_guard(false);
-  auto module = torch::jit::load(FLAGS_model);
-
-  module.eval();
+  CAFFE_ENFORCE(
+      !FLAGS_report_ops || FLAGS_use_bytecode,
+      "--report_ops requires --use_bytecode.");
+  CAFFE_ENFORCE(
+      !FLAGS_report_ops || FLAGS_concurrency.empty(),
+      "--report_ops can not be used with --concurrency.");
+  CAFFE_ENFORCE(
+      FLAGS_op_sample_rate > 0,
+      "Operator sample rate should be positive, provided ",
+      FLAGS_op_sample_rate,
+      ".");
+  torch::jit::script::Module module;
+  torch::jit::mobile::Module bc;
+  if (FLAGS_use_bytecode) {
+    bc = torch::jit::_load_for_mobile(FLAGS_model);
+  } else {
+    module = torch::jit::load(FLAGS_model);
+    module.eval();
+  }
+  std::function<c10::IValue()> forward = [&]() {
+    if (FLAGS_use_bytecode) {
+      return bc.forward(inputs);
+    }
+    return module.forward(inputs);
+  };
   if (FLAGS_print_output) {
-    std::cout << module.forward(inputs) << std::endl;
+    std::cout << forward() << std::endl;
+  }
+
+  if (!FLAGS_concurrency.empty()) {
+    auto intra_op_threads = parseIntList(FLAGS_intra_op_threads);
+    if (intra_op_threads.empty()) {
+      intra_op_threads.push_back(at::get_num_threads());
+    }
+    for (int threads : intra_op_threads) {
+      for (int num_clients : parseIntList(FLAGS_concurrency)) {
+        runConcurrentClients(forward, num_clients, threads);
+      }
+    }
+    return 0;
   }
 
   std::cout << "Starting benchmark." << std::endl;
@@ -132,7 +396,14 @@ int main(int argc, char** argv) {
       FLAGS_warmup,
       ".");
   for (int i = 0; i < FLAGS_warmup; ++i) {
-    module.forward(inputs);
+    forward();
+  }
+
+  auto op_totals =
+      std::make_shared<std::map<size_t, OperatorStatsObserver::Totals>>();
+  if (FLAGS_report_ops) {
+    torch::observerConfig().setOperatorObserver(
+        std::make_unique<OperatorStatsObserver>(op_totals));
   }
 
   std::cout << "Main runs." << std::endl;
@@ -146,12 +417,16 @@ int main(int argc, char** argv) {
   auto millis = timer.MilliSeconds();
   for (int i = 0; i < FLAGS_iter; ++i) {
     auto start = high_resolution_clock::now();
-    module.forward(inputs);
+    forward();
     auto stop = high_resolution_clock::now();
     auto duration = duration_cast<milliseconds>(stop - start);
     times.push_back(duration.count());
   }
   millis = timer.MilliSeconds();
+  if (FLAGS_report_ops) {
+    torch::observerConfig().setOperatorObserver(nullptr);
+    reportOperatorStats(*op_totals);
+  }
   if (FLAGS_report_pep) {
     for (auto t : times) {
       std::cout << "PyTorchObserver {\"type\": \"NET\", \"unit\": \"us\", \"metric\": \"latency\", \"value\": \"" << t << "\"}" << std::endl;
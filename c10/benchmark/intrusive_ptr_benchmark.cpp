@@ -1,8 +1,10 @@
+#include <c10/util/MaybeOwned.h>
 #include <c10/util/intrusive_ptr.h>
 
 #include <benchmark/benchmark.h>
 #include <memory>
 
+using c10::MaybeOwned;
 using c10::intrusive_ptr;
 using c10::intrusive_ptr_target;
 using c10::make_intrusive;
@@ -32,6 +34,15 @@ static void BM_IntrusivePtrCtorDtor(benchmark::State& state) {
 }
 BENCHMARK(BM_IntrusivePtrCtorDtor);
 
+static void BM_MaybeOwnedBorrowCtorDtor(benchmark::State& state) {
+  intrusive_ptr<Foo> var = make_intrusive<Foo>(0);
+  while (state.KeepRunning()) {
+    auto var2 = MaybeOwned<intrusive_ptr<Foo>>::borrowed(var);
+    benchmark::DoNotOptimize(var2);
+  }
+}
+BENCHMARK(BM_MaybeOwnedBorrowCtorDtor);
+
 static void BM_SharedPtrCtorDtor(benchmark::State& state) {
   std::shared_ptr<Bar> var = std::make_shared<Bar>(0);
   while (state.KeepRunning()) {
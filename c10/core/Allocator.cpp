@@ -1,5 +1,7 @@
 #include <c10/core/Allocator.h>
 
+#include <atomic>
+
 namespace c10 {
 
 static void deleteInefficientStdFunctionContext(void* ptr) {
@@ -28,4 +30,21 @@ at::Allocator* GetAllocator(const at::DeviceType& t) {
   return alloc;
 }
 
+static std::atomic<MemoryReporter*> memory_reporter{nullptr};
+
+void SetMemoryReporter(MemoryReporter* reporter) {
+  memory_reporter.store(reporter, std::memory_order_release);
+}
+
+bool MemoryProfilingEnabled() {
+  return memory_reporter.load(std::memory_order_relaxed) != nullptr;
+}
+
+void ReportMemoryUsage(void* ptr, int64_t alloc_size, Device device) {
+  MemoryReporter* reporter = memory_reporter.load(std::memory_order_acquire);
+  if (reporter) {
+    reporter->reportMemoryUsage(ptr, alloc_size, device);
+  }
+}
+
 } // namespace c10
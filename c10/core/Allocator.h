@@ -214,4 +214,23 @@ struct AllocatorRegisterer {
   static AllocatorRegisterer<t> g_allocator_d(f); \
   }
 
+/**
+ * An observer of memory usage, such as the autograd profiler. While one is
+ * set, the CPU allocators and the CUDA caching allocator report every
+ * allocation they hand out with its size, and every free with the negated
+ * size, from the thread doing it.
+ */
+struct C10_API MemoryReporter {
+  virtual ~MemoryReporter() = default;
+  virtual void reportMemoryUsage(void* ptr, int64_t alloc_size, Device device) = 0;
+};
+
+/**
+ * Sets the memory reporter, or clears it with nullptr. The reporter must
+ * outlive any allocation or free that may be running when it's cleared.
+ */
+C10_API void SetMemoryReporter(MemoryReporter* reporter);
+C10_API bool MemoryProfilingEnabled();
+C10_API void ReportMemoryUsage(void* ptr, int64_t alloc_size, Device device);
+
 } // namespace c10
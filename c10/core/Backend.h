@@ -25,7 +25,7 @@ namespace c10 {
  * or "SparseCUDA"; backend in torch.backends is something like "MKL" or
  * "CUDNN".
  */
-enum class Backend { CPU, CUDA, HIP, SparseCPU, SparseCUDA, SparseHIP, MSNPU, XLA, QuantizedCPU, ComplexCPU, ComplexCUDA, Undefined, MkldnnCPU, NumOptions };
+enum class Backend { CPU, CUDA, HIP, SparseCPU, SparseCUDA, SparseHIP, MSNPU, XLA, QuantizedCPU, QuantizedCUDA, ComplexCPU, ComplexCUDA, Undefined, MkldnnCPU, NumOptions };
 
 static inline Backend toSparse(Backend b) {
   switch (b) {
@@ -66,6 +66,8 @@ static inline Backend toDense(Backend b) {
       return Backend::HIP;
     case Backend::QuantizedCPU:
       return Backend::QuantizedCPU;
+    case Backend::QuantizedCUDA:
+      return Backend::QuantizedCUDA;
     case Backend::ComplexCPU:
       return Backend::ComplexCPU;
     case Backend::ComplexCUDA:
@@ -96,6 +98,8 @@ static inline Backend dispatchKeyToBackend(DispatchKey t) {
     return Backend::MkldnnCPU;
   } else if (t == DispatchKey::QuantizedCPUTensorId) {
     return Backend::QuantizedCPU;
+  } else if (t == DispatchKey::QuantizedCUDATensorId) {
+    return Backend::QuantizedCUDA;
   } else if (t == DispatchKey::ComplexCPUTensorId) {
     return Backend::ComplexCPU;
   } else if (t == DispatchKey::ComplexCUDATensorId) {
@@ -129,6 +133,8 @@ static inline DispatchKey backendToDispatchKey(Backend b) {
       return DispatchKey::MkldnnCPUTensorId;
     case Backend::QuantizedCPU:
       return DispatchKey::QuantizedCPUTensorId;
+    case Backend::QuantizedCUDA:
+      return DispatchKey::QuantizedCUDATensorId;
     case Backend::ComplexCPU:
       return DispatchKey::ComplexCPUTensorId;
     case Backend::ComplexCUDA:
@@ -162,6 +168,7 @@ static inline DeviceType backendToDeviceType(Backend b) {
     case Backend::QuantizedCPU:
     case Backend::ComplexCPU:
       return DeviceType::CPU;
+    case Backend::QuantizedCUDA:
     case Backend::ComplexCUDA:
       return DeviceType::CUDA;
     case Backend::Undefined:
@@ -191,6 +198,7 @@ static inline Backend backendToCPU(Backend b) {
     case Backend::MkldnnCPU:
       return Backend::MkldnnCPU;
     case Backend::QuantizedCPU:
+    case Backend::QuantizedCUDA:
       return Backend::QuantizedCPU;
     case Backend::ComplexCPU:
     case Backend::ComplexCUDA:
@@ -214,6 +222,9 @@ static inline Backend backendToCUDA(Backend b) {
     case Backend::SparseCUDA:
     case Backend::SparseHIP:
       return Backend::SparseCUDA;
+    case Backend::QuantizedCPU:
+    case Backend::QuantizedCUDA:
+      return Backend::QuantizedCUDA;
     case Backend::ComplexCPU:
     case Backend::ComplexCUDA:
       return Backend::ComplexCUDA;
@@ -266,6 +277,8 @@ static inline const char* toString(Backend b) {
       return "MkldnnCPU";
     case Backend::QuantizedCPU:
       return "QuantizedCPU";
+    case Backend::QuantizedCUDA:
+      return "QuantizedCUDA";
     case Backend::ComplexCPU:
       return "ComplexCPU";
     case Backend::ComplexCUDA:
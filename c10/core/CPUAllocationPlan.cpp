@@ -0,0 +1,310 @@
+#include <c10/core/CPUAllocationPlan.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace c10 {
+
+namespace {
+
+constexpr size_t kNotFreed = static_cast<size_t>(-1);
+constexpr size_t kNotInArena = static_cast<size_t>(-1);
+
+size_t round_up(size_t nbytes) {
+  return (nbytes + gAlignment - 1) / gAlignment * gAlignment;
+}
+
+/// In the CAFFE2_FB_LIMITED_MOBILE_CAPABILITY build setting,
+/// thread_local is not supported, so guards don't install their plan.
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+thread_local CPUAllocationPlan* current_plan = nullptr;
+#endif
+
+} // namespace
+
+// Shared by a plan and the allocations it handed out, which may outlive it.
+// A State records a single run and is replaced when a later run diverges from
+// that recording.
+struct CPUAllocationPlan::State {
+  struct ArenaSlot {
+    State* state;
+    size_t id;
+  };
+
+  struct RecordedAllocation {
+    State* state;
+    size_t id;
+    DataPtr data;
+  };
+
+  ~State() {
+    free_cpu(arena);
+  }
+
+  std::mutex mutex;
+  // One for the plan, plus one for every tracked allocation that is alive.
+  size_t refs = 1;
+
+  // The recording: the size of each allocation and the step (the number of
+  // allocations made so far) at which it was freed.
+  std::vector<size_t> sizes;
+  std::vector<size_t> lifetimes;
+  bool planned = false;
+
+  // The layout made from the recording.
+  std::vector<size_t> offsets;
+  // frees_due[i] is the number of arena allocations freed at step i.
+  std::vector<size_t> frees_due;
+  std::vector<ArenaSlot> slots;
+  void* arena = nullptr;
+  size_t arena_size = 0;
+
+  // The current run.
+  bool running = false;
+  bool recording = false;
+  bool following_plan = false;
+  size_t step = 0;
+  size_t frees_at_step = 0;
+  size_t live_in_arena = 0;
+  size_t run_arena_allocations = 0;
+  size_t last_arena_allocations = 0;
+
+  void layout();
+
+  static void release(State* state) {
+    bool last;
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      last = --state->refs == 0;
+    }
+    if (last) {
+      delete state;
+    }
+  }
+};
+
+// Places every allocation that was freed within the recorded run, largest
+// first, at the lowest offset that doesn't overlap an allocation that is
+// alive at the same time.
+void CPUAllocationPlan::State::layout() {
+  const size_t num_allocations = sizes.size();
+  offsets.assign(num_allocations, kNotInArena);
+  frees_due.assign(num_allocations + 1, 0);
+  slots.resize(num_allocations);
+
+  std::vector<size_t> order;
+  for (size_t id = 0; id < num_allocations; ++id) {
+    slots[id] = {this, id};
+    if (sizes[id] > 0 && lifetimes[id] != kNotFreed) {
+      order.push_back(id);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+    return sizes[a] > sizes[b];
+  });
+
+  std::vector<size_t> placed;
+  std::vector<std::pair<size_t, size_t>> taken;
+  for (const size_t id : order) {
+    taken.clear();
+    for (const size_t other : placed) {
+      if (other < lifetimes[id] && id < lifetimes[other]) {
+        taken.emplace_back(offsets[other], round_up(sizes[other]));
+      }
+    }
+    std::sort(taken.begin(), taken.end());
+    const size_t size = round_up(sizes[id]);
+    size_t offset = 0;
+    for (const auto& range : taken) {
+      if (range.first >= offset + size) {
+        break;
+      }
+      offset = std::max(offset, range.first + range.second);
+    }
+    offsets[id] = offset;
+    arena_size = std::max(arena_size, offset + size);
+    frees_due[lifetimes[id]]++;
+    placed.push_back(id);
+  }
+  arena = alloc_cpu(arena_size);
+  planned = true;
+}
+
+struct PlannedCPUAllocator final : at::Allocator {
+  DataPtr allocate(size_t nbytes) const override {
+    Allocator* allocator = GetAllocator(DeviceType::CPU);
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+    // StorageImpl keeps its allocator, so this is also called for resizes
+    // after the run ended, or on other threads.
+    if (current_plan == nullptr) {
+      return allocator->allocate(nbytes);
+    }
+    CPUAllocationPlan::State* state = current_plan->state_;
+    std::unique_lock<std::mutex> lock(state->mutex);
+    if (state->recording) {
+      lock.unlock();
+      auto recorded = new CPUAllocationPlan::State::RecordedAllocation{
+          state, 0, allocator->allocate(nbytes)};
+      void* data = recorded->data.get();
+      lock.lock();
+      recorded->id = state->step++;
+      state->sizes.push_back(nbytes);
+      state->lifetimes.push_back(kNotFreed);
+      ++state->refs;
+      return {data, recorded, &delete_recorded, Device(DeviceType::CPU)};
+    }
+
+    const size_t id = state->step++;
+    if (state->following_plan &&
+        (id >= state->sizes.size() || state->sizes[id] != nbytes ||
+         state->frees_at_step != state->frees_due[id])) {
+      state->following_plan = false;
+    }
+    state->frees_at_step = 0;
+    if (!state->following_plan || state->offsets[id] == kNotInArena) {
+      lock.unlock();
+      return allocator->allocate(nbytes);
+    }
+    ++state->refs;
+    ++state->live_in_arena;
+    ++state->run_arena_allocations;
+    lock.unlock();
+
+    void* data = static_cast<char*>(state->arena) + state->offsets[id];
+    if (FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+      memset(data, 0, nbytes);
+    } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+      memset_junk(data, nbytes);
+    }
+    ReportMemoryUsage(
+        data, static_cast<int64_t>(nbytes), Device(DeviceType::CPU));
+    return {data, &state->slots[id], &delete_arena, Device(DeviceType::CPU)};
+#else
+    return allocator->allocate(nbytes);
+#endif
+  }
+
+  static void delete_recorded(void* ctx) {
+    auto recorded =
+        static_cast<CPUAllocationPlan::State::RecordedAllocation*>(ctx);
+    CPUAllocationPlan::State* state = recorded->state;
+    const size_t id = recorded->id;
+    recorded->data.clear();
+    delete recorded;
+    {
+      // Only frees within the recorded run make it into the plan
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (state->recording) {
+        state->lifetimes[id] = state->step;
+      }
+    }
+    CPUAllocationPlan::State::release(state);
+  }
+
+  static void delete_arena(void* ctx) {
+    auto slot = static_cast<CPUAllocationPlan::State::ArenaSlot*>(ctx);
+    CPUAllocationPlan::State* state = slot->state;
+    ReportMemoryUsage(
+        static_cast<char*>(state->arena) + state->offsets[slot->id],
+        -static_cast<int64_t>(state->sizes[slot->id]),
+        Device(DeviceType::CPU));
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      --state->live_in_arena;
+      if (state->running && state->following_plan) {
+        if (state->lifetimes[slot->id] == state->step) {
+          ++state->frees_at_step;
+        } else {
+          state->following_plan = false;
+        }
+      }
+    }
+    CPUAllocationPlan::State::release(state);
+  }
+};
+
+static PlannedCPUAllocator g_planned_cpu_alloc;
+
+CPUAllocationPlan::CPUAllocationPlan() : state_(new State()) {}
+
+CPUAllocationPlan::~CPUAllocationPlan() {
+  State::release(state_);
+}
+
+size_t CPUAllocationPlan::arena_size() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->arena_size;
+}
+
+size_t CPUAllocationPlan::num_arena_allocations() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->last_arena_allocations;
+}
+
+Allocator* CPUAllocationPlan::current_allocator() {
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+  if (current_plan != nullptr) {
+    return &g_planned_cpu_alloc;
+  }
+#endif
+  return nullptr;
+}
+
+CPUAllocationPlan::Guard::Guard(CPUAllocationPlan& plan) {
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+  bool expected = false;
+  if (!plan.in_use_.compare_exchange_strong(expected, true)) {
+    return;
+  }
+  plan_ = &plan;
+  prev_plan_ = current_plan;
+  current_plan = &plan;
+  State* state = plan.state_;
+  std::lock_guard<std::mutex> lock(state->mutex);
+  state->running = true;
+  state->recording = !state->planned;
+  state->following_plan = state->planned;
+  state->step = 0;
+  state->frees_at_step = 0;
+  state->run_arena_allocations = 0;
+#endif
+}
+
+CPUAllocationPlan::Guard::~Guard() {
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+  if (plan_ == nullptr) {
+    return;
+  }
+  current_plan = prev_plan_;
+  State* state = plan_->state_;
+  bool diverged = false;
+  size_t arena_allocations = 0;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->running = false;
+    if (state->recording) {
+      state->recording = false;
+      state->layout();
+    } else {
+      state->last_arena_allocations = state->run_arena_allocations;
+      arena_allocations = state->run_arena_allocations;
+      // Arena memory that is still in use would be handed out again by the
+      // next run, so that also makes the plan unusable.
+      diverged = !state->following_plan ||
+          state->step != state->sizes.size() || state->live_in_arena > 0;
+    }
+  }
+  if (diverged) {
+    plan_->state_ = new State();
+    plan_->state_->last_arena_allocations = arena_allocations;
+    State::release(state);
+  }
+  plan_->in_use_ = false;
+#endif
+}
+
+} // namespace c10
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <c10/core/Allocator.h>
+#include <c10/macros/Macros.h>
+
+#include <atomic>
+
+namespace c10 {
+
+// Serves the CPU allocations of a workload that is run over and over with the
+// same shapes, e.g. a method of a lite interpreter module, from one arena that
+// is kept between runs.
+//
+// - The first run under a CPUAllocationPlan::Guard records the size of each
+//   CPU allocation the calling thread makes and when it is freed. At the end
+//   of that run, the allocations that were freed within it are laid out in an
+//   arena. Allocations that are never live at the same time share memory.
+// - Later runs take those allocations from the arena instead of the CPU
+//   allocator. Allocations that outlive the run, like its outputs, still come
+//   from the CPU allocator.
+// - An allocation is only taken from the arena after every allocation that
+//   was recorded to be freed before it has been freed. The first allocation
+//   or free that doesn't match the recording (e.g. because the shapes
+//   changed) sends the rest of the run to the CPU allocator, and the next run
+//   records a new plan.
+// - Allocations on other threads and arena memory freed after the run ended
+//   are handled, but never served from the arena.
+//
+// Memory from the arena doesn't support the raw allocator interface, so
+// raw_allocate() must not be used on the CPU allocator under a Guard.
+class C10_API CPUAllocationPlan final {
+ public:
+  CPUAllocationPlan();
+  ~CPUAllocationPlan();
+  C10_DISABLE_COPY_AND_ASSIGN(CPUAllocationPlan);
+
+  // Makes GetCPUAllocator() allocate through `plan` on this thread for the
+  // lifetime of the guard. If another thread is running under `plan`, the
+  // guard does nothing.
+  class C10_API Guard final {
+   public:
+    explicit Guard(CPUAllocationPlan& plan);
+    ~Guard();
+    C10_DISABLE_COPY_AND_ASSIGN(Guard);
+
+   private:
+    CPUAllocationPlan* plan_ = nullptr;
+    CPUAllocationPlan* prev_plan_ = nullptr;
+  };
+
+  // Size of the arena in bytes, or 0 if there is no plan yet.
+  size_t arena_size() const;
+  // Number of allocations the last finished run took from the arena.
+  size_t num_arena_allocations() const;
+
+  // The allocator GetCPUAllocator() returns while the calling thread runs
+  // under a plan, or nullptr.
+  static Allocator* current_allocator();
+
+ private:
+  struct State;
+  friend struct PlannedCPUAllocator;
+
+  State* state_;
+  std::atomic<bool> in_use_{false};
+};
+
+} // namespace c10
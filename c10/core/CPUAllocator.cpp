@@ -1,6 +1,15 @@
 #include <c10/core/CPUAllocator.h>
+#include <c10/core/CPUAllocationPlan.h>
+#include <c10/core/CPUCachingAllocator.h>
 #include <c10/core/DeviceType.h>
 
+#include <cstdlib>
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sys/mman.h>
+#define C10_CPU_ALLOCATOR_HAS_THP
+#endif
+
 // TODO: rename flags to C10
 C10_DEFINE_bool(
     caffe2_report_cpu_memory_usage,
@@ -17,6 +26,12 @@ C10_DEFINE_bool(
     false,
     "If set, fill memory with deterministic junk when allocating on CPU");
 
+C10_DEFINE_bool(
+    caffe2_cpu_allocator_use_huge_pages,
+    false,
+    "If set, align CPU allocations of at least 2 MiB to 2 MiB and back them "
+    "with transparent huge pages where the OS supports it");
+
 namespace c10 {
 
 void memset_junk(void* data, size_t num) {
@@ -36,6 +51,9 @@ void memset_junk(void* data, size_t num) {
   }
 }
 
+// Alignment used for allocations that may be backed by huge pages.
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
 void* alloc_cpu(size_t nbytes) {
   if (nbytes == 0) {
     return nullptr;
@@ -52,7 +70,10 @@ void* alloc_cpu(size_t nbytes) {
 #elif defined(_MSC_VER)
   data = _aligned_malloc(nbytes, gAlignment);
 #else
-  int err = posix_memalign(&data, gAlignment, nbytes);
+  const bool use_huge_pages =
+      FLAGS_caffe2_cpu_allocator_use_huge_pages && nbytes >= kHugePageSize;
+  int err = posix_memalign(
+      &data, use_huge_pages ? kHugePageSize : gAlignment, nbytes);
   if (err != 0) {
     CAFFE_THROW(
         "DefaultCPUAllocator: can't allocate memory: you tried to allocate ",
@@ -71,6 +92,14 @@ void* alloc_cpu(size_t nbytes) {
       nbytes,
       " bytes. Buy new RAM!");
 
+#ifdef C10_CPU_ALLOCATOR_HAS_THP
+  // Only a hint: ignore failures (e.g. when THP is disabled system-wide).
+  // This must happen before the memory is first touched below.
+  if (use_huge_pages) {
+    madvise(data, nbytes, MADV_HUGEPAGE);
+  }
+#endif
+
   // move data to a thread's NUMA node
   NUMAMove(data, nbytes, GetCurrentNUMANode());
   CHECK(
@@ -94,27 +123,13 @@ void free_cpu(void* data) {
 #endif
 }
 
-// A virtual struct that is used to report C10's memory allocation and
-// deallocation status
-class C10_API MemoryAllocationReporter {
- public:
-  MemoryAllocationReporter() : allocated_(0) {}
-  void New(void* ptr, size_t nbytes);
-  void Delete(void* ptr);
-
- private:
-  std::mutex mutex_;
-  std::unordered_map<void*, size_t> size_table_;
-  size_t allocated_;
-};
-
 struct C10_API DefaultCPUAllocator final : at::Allocator {
   DefaultCPUAllocator() {}
   ~DefaultCPUAllocator() override {}
   at::DataPtr allocate(size_t nbytes) const override {
     void* data = alloc_cpu(nbytes);
-    if (FLAGS_caffe2_report_cpu_memory_usage && nbytes > 0) {
-      getMemoryAllocationReporter().New(data, nbytes);
+    if (nbytes > 0 && ShouldReportCPUMemoryUsage()) {
+      GetMemoryAllocationReporter().New(data, nbytes);
       return {data, data, &ReportAndDelete, at::Device(at::DeviceType::CPU)};
     }
     return {data, data, &free_cpu, at::Device(at::DeviceType::CPU)};
@@ -124,28 +139,29 @@ struct C10_API DefaultCPUAllocator final : at::Allocator {
     if (!ptr) {
       return;
     }
-    getMemoryAllocationReporter().Delete(ptr);
+    GetMemoryAllocationReporter().Delete(ptr);
     free_cpu(ptr);
   }
 
   at::DeleterFnPtr raw_deleter() const override {
-    if (FLAGS_caffe2_report_cpu_memory_usage) {
+    if (ShouldReportCPUMemoryUsage()) {
       return &ReportAndDelete;
     }
     return &free_cpu;
   }
-
- protected:
-  static MemoryAllocationReporter& getMemoryAllocationReporter() {
-    static MemoryAllocationReporter reporter_;
-    return reporter_;
-  }
-
 };
 
+MemoryAllocationReporter& GetMemoryAllocationReporter() {
+  static MemoryAllocationReporter reporter_;
+  return reporter_;
+}
+
 void NoDelete(void*) {}
 
 at::Allocator* GetCPUAllocator() {
+  if (at::Allocator* planned = CPUAllocationPlan::current_allocator()) {
+    return planned;
+  }
   return GetAllocator(DeviceType::CPU);
 }
 
@@ -160,24 +176,52 @@ at::Allocator* GetDefaultCPUAllocator() {
   return &g_cpu_alloc;
 }
 
-REGISTER_ALLOCATOR(DeviceType::CPU, &g_cpu_alloc);
+// The caching allocator is opt-in; PYTORCH_CPU_CACHING_ALLOCATOR=1 installs it
+// as the CPU allocator at load time.
+static at::Allocator* GetInitialCPUAllocator() {
+  const char* env = getenv("PYTORCH_CPU_CACHING_ALLOCATOR");
+  if (env != nullptr && strcmp(env, "0") != 0) {
+    return CPUCachingAllocator::get();
+  }
+  return &g_cpu_alloc;
+}
+
+REGISTER_ALLOCATOR(DeviceType::CPU, GetInitialCPUAllocator());
 
 void MemoryAllocationReporter::New(void* ptr, size_t nbytes) {
-  std::lock_guard<std::mutex> guard(mutex_);
-  size_table_[ptr] = nbytes;
-  allocated_ += nbytes;
-  LOG(INFO) << "C10 alloc " << nbytes << " bytes, total alloc " << allocated_
-            << " bytes.";
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    size_table_[ptr] = nbytes;
+    allocated_ += nbytes;
+    if (FLAGS_caffe2_report_cpu_memory_usage) {
+      LOG(INFO) << "C10 alloc " << nbytes << " bytes, total alloc "
+                << allocated_ << " bytes.";
+    }
+  }
+  ReportMemoryUsage(ptr, static_cast<int64_t>(nbytes), Device(DeviceType::CPU));
 }
 
 void MemoryAllocationReporter::Delete(void* ptr) {
-  std::lock_guard<std::mutex> guard(mutex_);
-  auto it = size_table_.find(ptr);
-  CHECK(it != size_table_.end());
-  allocated_ -= it->second;
-  LOG(INFO) << "C10 deleted " << it->second << " bytes, total alloc "
-            << allocated_ << " bytes.";
-  size_table_.erase(it);
+  size_t nbytes;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = size_table_.find(ptr);
+    if (it == size_table_.end()) {
+      // Allocated before a MemoryReporter was set, and freed with the
+      // raw_deleter() of an allocator that now reports.
+      CHECK(!FLAGS_caffe2_report_cpu_memory_usage);
+      return;
+    }
+    nbytes = it->second;
+    allocated_ -= nbytes;
+    if (FLAGS_caffe2_report_cpu_memory_usage) {
+      LOG(INFO) << "C10 deleted " << nbytes << " bytes, total alloc "
+                << allocated_ << " bytes.";
+    }
+    size_table_.erase(it);
+  }
+  ReportMemoryUsage(
+      ptr, -static_cast<int64_t>(nbytes), Device(DeviceType::CPU));
 }
 
 } // namespace c10
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstring>
+#include <mutex>
 #include <unordered_map>
 
 #include <c10/core/Allocator.h>
@@ -11,6 +12,7 @@
 C10_DECLARE_bool(caffe2_report_cpu_memory_usage);
 C10_DECLARE_bool(caffe2_cpu_allocator_do_zero_fill);
 C10_DECLARE_bool(caffe2_cpu_allocator_do_junk_fill);
+C10_DECLARE_bool(caffe2_cpu_allocator_use_huge_pages);
 
 namespace c10 {
 
@@ -30,7 +32,8 @@ C10_API void memset_junk(void* data, size_t num);
 C10_API void* alloc_cpu(size_t nbytes);
 C10_API void free_cpu(void* data);
 
-// Get the CPU Allocator.
+// Get the CPU Allocator. Under a CPUAllocationPlan::Guard this is the
+// allocator of that plan.
 C10_API at::Allocator* GetCPUAllocator();
 // Sets the CPU allocator to the given allocator: the caller gives away the
 // ownership of the pointer.
@@ -39,4 +42,26 @@ C10_API void SetCPUAllocator(at::Allocator* alloc);
 // Get the Default CPU Allocator
 C10_API at::Allocator* GetDefaultCPUAllocator();
 
+// A virtual struct that is used to report C10's memory allocation and
+// deallocation status
+class C10_API MemoryAllocationReporter {
+ public:
+  MemoryAllocationReporter() : allocated_(0) {}
+  void New(void* ptr, size_t nbytes);
+  void Delete(void* ptr);
+
+ private:
+  std::mutex mutex_;
+  std::unordered_map<void*, size_t> size_table_;
+  size_t allocated_;
+};
+
+// Get the reporter used by CPU allocators when
+// FLAGS_caffe2_report_cpu_memory_usage is set or a MemoryReporter is.
+C10_API MemoryAllocationReporter& GetMemoryAllocationReporter();
+
+inline bool ShouldReportCPUMemoryUsage() {
+  return FLAGS_caffe2_report_cpu_memory_usage || MemoryProfilingEnabled();
+}
+
 } // namespace c10
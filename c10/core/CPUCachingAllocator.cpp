@@ -0,0 +1,333 @@
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/util/llvmMathExtras.h>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace c10 {
+namespace CPUCachingAllocator {
+
+namespace {
+
+constexpr size_t kMinBlockSize = 64;            // smallest size class
+constexpr size_t kMaxThreadCachedSize = 1048576; // larger blocks skip thread caches
+constexpr size_t kMaxThreadCachedBlocks = 64;   // per size class and thread
+// Every block starts with a header that records its size class. Keeping the
+// header the size of the alignment keeps the returned pointer aligned.
+constexpr size_t kHeaderSize = gAlignment;
+constexpr size_t kUncached = static_cast<size_t>(-1);
+
+static_assert(kMinBlockSize == 64, "size_class_index assumes 64 byte minimum");
+
+// Size classes are 64 bytes, then four classes per power of two:
+// 80, 96, 112, 128, 160, 192, 224, 256, 320, ...
+size_t size_class_index(size_t nbytes) {
+  if (nbytes <= kMinBlockSize) {
+    return 0;
+  }
+  const size_t p = llvm::Log2_64(nbytes - 1);
+  const size_t step = size_t(1) << (p - 2);
+  const size_t j = (nbytes - 1 - (size_t(1) << p)) / step;
+  return (p - 6) * 4 + j + 1;
+}
+
+size_t size_class_size(size_t index) {
+  if (index == 0) {
+    return kMinBlockSize;
+  }
+  const size_t p = (index - 1) / 4 + 6;
+  const size_t j = (index - 1) % 4;
+  return (size_t(1) << p) + (j + 1) * (size_t(1) << (p - 2));
+}
+
+const size_t kNumSizeClasses = size_class_index(kMaxCachedSize) + 1;
+
+struct AtomicStat {
+  std::atomic<int64_t> current{0};
+  std::atomic<int64_t> peak{0};
+  std::atomic<int64_t> allocated{0};
+  std::atomic<int64_t> freed{0};
+
+  void update(int64_t amount) {
+    const int64_t now = current.fetch_add(amount) + amount;
+    int64_t prev_peak = peak.load();
+    while (now > prev_peak && !peak.compare_exchange_weak(prev_peak, now)) {
+    }
+    if (amount > 0) {
+      allocated += amount;
+    } else {
+      freed += -amount;
+    }
+  }
+
+  Stat get() const {
+    Stat stat;
+    stat.current = current;
+    stat.peak = peak;
+    stat.allocated = allocated;
+    stat.freed = freed;
+    return stat;
+  }
+};
+
+struct AtomicAllocatorStats {
+  AtomicStat allocation;
+  AtomicStat allocated_bytes;
+  AtomicStat reserved_bytes;
+  std::atomic<int64_t> num_cache_hits{0};
+  std::atomic<int64_t> num_cache_misses{0};
+  std::atomic<int64_t> num_cache_flushes{0};
+};
+
+using FreeLists = std::vector<std::vector<void*>>;
+
+// Blocks shared between all threads. Intentionally leaked so that thread
+// caches can still be flushed into it while the process shuts down.
+struct GlobalPool {
+  std::mutex mutex;
+  FreeLists blocks{kNumSizeClasses};
+  AtomicAllocatorStats stats;
+
+  static GlobalPool& get() {
+    static GlobalPool* pool = new GlobalPool();
+    return *pool;
+  }
+};
+
+void free_blocks(std::vector<void*>& blocks, size_t index) {
+  const int64_t block_size = size_class_size(index) + kHeaderSize;
+  GlobalPool::get().stats.reserved_bytes.update(
+      -block_size * static_cast<int64_t>(blocks.size()));
+  for (void* base : blocks) {
+    free_cpu(base);
+  }
+  blocks.clear();
+}
+
+/// In the CAFFE2_FB_LIMITED_MOBILE_CAPABILITY build setting,
+/// thread_local is not supported, so every block goes through the global pool.
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+
+// Set once the calling thread's cache has been destroyed. Other thread_local
+// destructors that run later may still free tensors; those blocks go straight
+// to the global pool. Being trivially destructible, the flag itself stays
+// valid until the thread exits.
+thread_local bool thread_cache_destroyed = false;
+
+struct ThreadCache {
+  FreeLists blocks{size_class_index(kMaxThreadCachedSize) + 1};
+
+  ~ThreadCache() {
+    thread_cache_destroyed = true;
+    GlobalPool& pool = GlobalPool::get();
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    for (size_t index = 0; index < blocks.size(); ++index) {
+      auto& global = pool.blocks[index];
+      global.insert(global.end(), blocks[index].begin(), blocks[index].end());
+    }
+  }
+};
+
+thread_local ThreadCache thread_cache;
+
+// Returns the calling thread's cache, or nullptr if it is already gone.
+ThreadCache* local_thread_cache() {
+  return thread_cache_destroyed ? nullptr : &thread_cache;
+}
+
+#endif
+
+void* allocate_block(size_t index) {
+  GlobalPool& pool = GlobalPool::get();
+
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+  ThreadCache* cache = local_thread_cache();
+  if (cache && index < cache->blocks.size()) {
+    auto& local = cache->blocks[index];
+    if (!local.empty()) {
+      void* base = local.back();
+      local.pop_back();
+      pool.stats.num_cache_hits++;
+      return base;
+    }
+  }
+#endif
+
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    auto& global = pool.blocks[index];
+    if (!global.empty()) {
+      void* base = global.back();
+      global.pop_back();
+      pool.stats.num_cache_hits++;
+      return base;
+    }
+  }
+
+  pool.stats.num_cache_misses++;
+  const size_t block_size = size_class_size(index) + kHeaderSize;
+  void* base;
+  try {
+    base = alloc_cpu(block_size);
+  } catch (const c10::Error&) {
+    // Like the CUDA caching allocator: release the cache and retry once.
+    emptyCache();
+    base = alloc_cpu(block_size);
+  }
+  pool.stats.reserved_bytes.update(block_size);
+  return base;
+}
+
+void free_block(void* base, size_t index) {
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+  ThreadCache* cache = local_thread_cache();
+  if (cache && index < cache->blocks.size()) {
+    auto& local = cache->blocks[index];
+    if (local.size() < kMaxThreadCachedBlocks) {
+      local.push_back(base);
+      return;
+    }
+  }
+#endif
+
+  GlobalPool& pool = GlobalPool::get();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  pool.blocks[index].push_back(base);
+}
+
+void* header_of(void* data) {
+  return static_cast<char*>(data) - kHeaderSize;
+}
+
+void CachingDelete(void* data) {
+  if (!data) {
+    return;
+  }
+  void* base = header_of(data);
+  const size_t index = *static_cast<size_t*>(base);
+  AtomicAllocatorStats& stats = GlobalPool::get().stats;
+  stats.allocation.update(-1);
+  if (index == kUncached) {
+    const int64_t block_size = *(static_cast<size_t*>(base) + 1);
+    stats.allocated_bytes.update(-(block_size - int64_t(kHeaderSize)));
+    stats.reserved_bytes.update(-block_size);
+    free_cpu(base);
+    return;
+  }
+  stats.allocated_bytes.update(-int64_t(size_class_size(index)));
+  free_block(base, index);
+}
+
+void ReportAndCachingDelete(void* data) {
+  if (!data) {
+    return;
+  }
+  GetMemoryAllocationReporter().Delete(data);
+  CachingDelete(data);
+}
+
+struct CPUCachingAllocatorImpl final : at::Allocator {
+  at::DataPtr allocate(size_t nbytes) const override {
+    if (nbytes == 0) {
+      return {nullptr, nullptr, raw_deleter(), at::Device(at::DeviceType::CPU)};
+    }
+
+    AtomicAllocatorStats& stats = GlobalPool::get().stats;
+    void* base;
+    if (nbytes > kMaxCachedSize) {
+      const size_t block_size = nbytes + kHeaderSize;
+      base = alloc_cpu(block_size);
+      *static_cast<size_t*>(base) = kUncached;
+      *(static_cast<size_t*>(base) + 1) = block_size;
+      stats.num_cache_misses++;
+      stats.reserved_bytes.update(block_size);
+      stats.allocated_bytes.update(nbytes);
+    } else {
+      const size_t index = size_class_index(nbytes);
+      base = allocate_block(index);
+      *static_cast<size_t*>(base) = index;
+      stats.allocated_bytes.update(size_class_size(index));
+      // alloc_cpu only fills fresh memory, so recycled blocks need it too.
+      if (FLAGS_caffe2_cpu_allocator_do_zero_fill) {
+        memset(static_cast<char*>(base) + kHeaderSize, 0, nbytes);
+      } else if (FLAGS_caffe2_cpu_allocator_do_junk_fill) {
+        memset_junk(static_cast<char*>(base) + kHeaderSize, nbytes);
+      }
+    }
+    stats.allocation.update(1);
+
+    void* data = static_cast<char*>(base) + kHeaderSize;
+    if (ShouldReportCPUMemoryUsage()) {
+      GetMemoryAllocationReporter().New(data, nbytes);
+      return {data, data, &ReportAndCachingDelete, at::Device(at::DeviceType::CPU)};
+    }
+    return {data, data, &CachingDelete, at::Device(at::DeviceType::CPU)};
+  }
+
+  at::DeleterFnPtr raw_deleter() const override {
+    if (ShouldReportCPUMemoryUsage()) {
+      return &ReportAndCachingDelete;
+    }
+    return &CachingDelete;
+  }
+};
+
+} // namespace
+
+Allocator* get() {
+  static CPUCachingAllocatorImpl allocator;
+  return &allocator;
+}
+
+void emptyCache() {
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+  if (ThreadCache* cache = local_thread_cache()) {
+    for (size_t index = 0; index < cache->blocks.size(); ++index) {
+      free_blocks(cache->blocks[index], index);
+    }
+  }
+#endif
+  GlobalPool& pool = GlobalPool::get();
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  for (size_t index = 0; index < pool.blocks.size(); ++index) {
+    free_blocks(pool.blocks[index], index);
+  }
+  pool.stats.num_cache_flushes++;
+}
+
+AllocatorStats getStats() {
+  const AtomicAllocatorStats& stats = GlobalPool::get().stats;
+  AllocatorStats result;
+  result.allocation = stats.allocation.get();
+  result.allocated_bytes = stats.allocated_bytes.get();
+  result.reserved_bytes = stats.reserved_bytes.get();
+  result.num_cache_hits = stats.num_cache_hits;
+  result.num_cache_misses = stats.num_cache_misses;
+  result.num_cache_flushes = stats.num_cache_flushes;
+  return result;
+}
+
+void resetAccumulatedStats() {
+  AtomicAllocatorStats& stats = GlobalPool::get().stats;
+  for (AtomicStat* stat : {&stats.allocation, &stats.allocated_bytes, &stats.reserved_bytes}) {
+    stat->allocated = 0;
+    stat->freed = 0;
+  }
+  stats.num_cache_hits = 0;
+  stats.num_cache_misses = 0;
+  stats.num_cache_flushes = 0;
+}
+
+void resetPeakStats() {
+  AtomicAllocatorStats& stats = GlobalPool::get().stats;
+  for (AtomicStat* stat : {&stats.allocation, &stats.allocated_bytes, &stats.reserved_bytes}) {
+    stat->peak = stat->current.load();
+  }
+}
+
+} // namespace CPUCachingAllocator
+} // namespace c10
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <c10/core/Allocator.h>
+#include <c10/macros/Macros.h>
+
+namespace c10 {
+
+// A caching allocator for CPU memory.
+//
+// - Requests are rounded up to a size class (four classes per power of two,
+//   so at most 25% of a block is wasted) and freed blocks are kept around to
+//   serve later requests of the same class instead of going back to malloc.
+// - Each thread keeps a small cache of free blocks for each size class, which
+//   is used without any locking. When a thread cache overflows, or when the
+//   thread exits, its blocks move to a global pool that is shared by all
+//   threads and protected by a mutex.
+// - Blocks larger than kMaxCachedSize are not cached.
+// - If allocating fresh memory fails, the global pool is released and the
+//   allocation is retried once.
+//
+// The allocator is not used by default. It can be installed with
+// SetCPUAllocator(CPUCachingAllocator::get()), or by setting the environment
+// variable PYTORCH_CPU_CACHING_ALLOCATOR=1 before the process starts.
+//
+// Memory returned by this allocator must be released through the DataPtr
+// deleter (or raw_deleter()), never with free_cpu().
+
+namespace CPUCachingAllocator {
+
+constexpr size_t kMaxCachedSize = 64 * 1024 * 1024; // 64 MiB
+
+// Same layout as CUDACachingAllocator::Stat.
+struct Stat {
+  int64_t current = 0;
+  int64_t peak = 0;
+  int64_t allocated = 0;
+  int64_t freed = 0;
+};
+
+// Struct containing memory allocator summary statistics.
+struct AllocatorStats {
+  // COUNT: allocations requested by client code
+  Stat allocation;
+  // SUM: bytes handed out to client code (rounded up to the size class)
+  Stat allocated_bytes;
+  // SUM: bytes obtained from the system allocator (both cached and used)
+  Stat reserved_bytes;
+
+  // COUNT: allocations served from a thread cache or the global pool
+  int64_t num_cache_hits = 0;
+  // COUNT: allocations that had to call into the system allocator
+  int64_t num_cache_misses = 0;
+  // COUNT: number of times the global pool was released
+  int64_t num_cache_flushes = 0;
+};
+
+C10_API Allocator* get();
+
+// Returns all blocks in the global pool and in the calling thread's cache to
+// the system allocator. Blocks cached by other threads are not affected.
+C10_API void emptyCache();
+
+C10_API AllocatorStats getStats();
+C10_API void resetAccumulatedStats();
+C10_API void resetPeakStats();
+
+} // namespace CPUCachingAllocator
+} // namespace c10
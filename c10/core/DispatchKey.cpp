@@ -34,12 +34,18 @@ const char* toString(DispatchKey t) {
       return "MkldnnCPUTensorId";
     case DispatchKey::QuantizedCPUTensorId:
       return "QuantizedCPUTensorId";
+    case DispatchKey::QuantizedCUDATensorId:
+      return "QuantizedCUDATensorId";
     case DispatchKey::ComplexCPUTensorId:
       return "ComplexCPUTensorId";
     case DispatchKey::ComplexCUDATensorId:
       return "ComplexCUDATensorId";
     case DispatchKey::VariableTensorId:
       return "VariableTensorId";
+    case DispatchKey::NamedTensorId:
+      return "NamedTensorId";
+    case DispatchKey::AutocastTensorId:
+      return "AutocastTensorId";
     case DispatchKey::TESTING_ONLY_GenericModeTensorId:
       return "TESTING_ONLY_GenericModeTensorId";
     case DispatchKey::TESTING_ONLY_GenericWrapperTensorId:
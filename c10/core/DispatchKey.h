@@ -35,6 +35,7 @@ enum class DispatchKey : uint8_t {
   XLATensorId, // PyTorch only
   MkldnnCPUTensorId,
   QuantizedCPUTensorId, // PyTorch only
+  QuantizedCUDATensorId, // PyTorch only
   ComplexCPUTensorId, // PyTorch only
   ComplexCUDATensorId, // PyTorch only
 
@@ -57,6 +58,15 @@ enum class DispatchKey : uint8_t {
   //     (templatized kernels specialized for user-defined PRNG class)
   CustomRNGKeyId,
 
+  // Set on a tensor exactly while it has names, i.e. while its names are not
+  // all None (TensorImpl keeps it in sync with its NamedTensorMeta).  It sits
+  // below VariableTensorId so that name propagation runs after autograd, like
+  // the backend kernels.  Operators without a kernel for this key fall
+  // through, so unnamed tensors never pay for name inference, and checking
+  // whether any operand of an operator is named is a test on the union of
+  // their key sets.
+  NamedTensorId,
+
   VariableTensorId,
 
   // Pre-autograd backend keys allow backends to override the autograd behavior
@@ -72,6 +82,14 @@ enum class DispatchKey : uint8_t {
   // operators which support autograd.
   XLAPreAutograd,
 
+  // Autocast (automatic mixed precision) is a mode key: it is never set on a
+  // tensor, it is toggled on and off through the included TLS set (see
+  // at::autocast::set_enabled).  Kernels registered here cast their inputs to
+  // the precision appropriate for the operator and then redispatch with this
+  // key excluded.  It sits above VariableTensorId so that the casts are
+  // recorded by autograd.  Operators without an autocast kernel fall through.
+  AutocastTensorId,
+
   // TESTING: This is intended to be a generic testing tensor type id.
   // Don't use it for anything real; its only acceptable use is within a single
   // process test.  Use it by creating a TensorImpl with this DispatchKey, and
@@ -123,7 +123,7 @@ static inline DispatchKey legacyExtractDispatchKey(DispatchKeySet s) {
   // top of existing "normal" keys like CPU/CUDA, you need to add it
   // here.  At the moment, RequiresGrad (replacement for Variable)
   // is the most likely key that will need this treatment.
-  return s.highestPriorityTypeId();
+  return s.remove(DispatchKey::NamedTensorId).highestPriorityTypeId();
 }
 
 }
@@ -0,0 +1,21 @@
+#include <c10/core/InferenceMode.h>
+
+namespace c10 {
+
+/// In the CAFFE2_FB_LIMITED_MOBILE_CAPABILITY build setting,
+/// thread_local is not supported.
+#ifndef CAFFE2_FB_LIMITED_MOBILE_CAPABILITY
+thread_local bool InferenceMode_enabled = false;
+#else
+static bool InferenceMode_enabled = false;
+#endif
+
+bool InferenceMode::is_enabled() {
+  return InferenceMode_enabled;
+}
+
+void InferenceMode::set_enabled(bool enabled) {
+  InferenceMode_enabled = enabled;
+}
+
+} // namespace c10
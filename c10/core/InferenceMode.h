@@ -0,0 +1,17 @@
+#pragma once
+
+#include <c10/macros/Macros.h>
+
+namespace c10 {
+
+// Thread-local flag telling whether the current thread runs in inference
+// mode. Tensors created while it is set are inference tensors (see
+// TensorImpl::is_inference()), which can never require grad. Use
+// at::InferenceModeGuard, which also takes the Variable dispatch key out of
+// dispatch, rather than setting this directly.
+struct C10_API InferenceMode {
+  static bool is_enabled();
+  static void set_enabled(bool enabled);
+};
+
+} // namespace c10
@@ -1,10 +1,14 @@
 #pragma once
 
 #include <c10/core/Allocator.h>
+#include <c10/core/InferenceMode.h>
 #include <c10/core/ScalarType.h>
 
 #include <c10/util/intrusive_ptr.h>
 
+#include <cstddef>
+#include <cstring>
+
 namespace c10 {
 
 struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
@@ -20,6 +24,7 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
         numel_(numel),
         resizable_(resizable),
         received_cuda_(false),
+        is_inference_(InferenceMode::is_enabled()),
         allocator_(allocator) {
     if (resizable) {
       AT_ASSERTM(
@@ -45,13 +50,75 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
             allocator,
             resizable) {}
 
-  StorageImpl& operator=(StorageImpl&& other) = default;
+  // Storages of at most this many bytes can keep their data inside the
+  // StorageImpl, see makeWithInlineData
+  static constexpr size_t kInlineDataBytes = 64;
+
+  // Creates a CPU storage like the constructor above, except that data of at
+  // most kInlineDataBytes bytes is kept inside the StorageImpl, so that
+  // creating a scalar or another small tensor does not need a separate data
+  // allocation. The allocator is still used if the storage is resized. Inline
+  // data is not seen by the allocator, so it is neither reported to the
+  // memory profiler nor aligned to more than alignof(std::max_align_t).
+  static intrusive_ptr<StorageImpl> makeWithInlineData(
+      caffe2::TypeMeta data_type,
+      int64_t numel,
+      at::Allocator* allocator,
+      bool resizable) {
+    const size_t nbytes = data_type.itemsize() * numel;
+    if (nbytes == 0 || nbytes > kInlineDataBytes) {
+      return make_intrusive<StorageImpl>(data_type, numel, allocator, resizable);
+    }
+    auto storage_impl = make_intrusive<StorageImpl>(
+        data_type, numel, at::DataPtr(), allocator, resizable);
+    storage_impl->data_ptr_ =
+        at::DataPtr(storage_impl->inline_data_, at::Device(at::DeviceType::CPU));
+    return storage_impl;
+  }
+
+  // Inline data lives in the object, so moving a storage that uses it has
+  // to copy the data and point the moved-to storage at its own copy.
+  StorageImpl& operator=(StorageImpl&& other) {
+    if (this == &other) {
+      return *this;
+    }
+    const bool other_is_inline = other.has_inline_data();
+    data_type_ = other.data_type_;
+    data_ptr_ = std::move(other.data_ptr_);
+    numel_ = other.numel_;
+    resizable_ = other.resizable_;
+    received_cuda_ = other.received_cuda_;
+    is_inference_ = other.is_inference_;
+    allocator_ = other.allocator_;
+    if (other_is_inline) {
+      std::memcpy(inline_data_, other.inline_data_, kInlineDataBytes);
+      data_ptr_ = at::DataPtr(inline_data_, at::Device(at::DeviceType::CPU));
+    }
+    return *this;
+  }
   StorageImpl& operator=(const StorageImpl&) = delete;
   StorageImpl() = delete;
-  StorageImpl(StorageImpl&& other) = default;
+  StorageImpl(StorageImpl&& other)
+      : data_type_(other.data_type_),
+        data_ptr_(std::move(other.data_ptr_)),
+        numel_(other.numel_),
+        resizable_(other.resizable_),
+        received_cuda_(other.received_cuda_),
+        is_inference_(other.is_inference_),
+        allocator_(other.allocator_) {
+    if (data_ptr_.get() == static_cast<const void*>(other.inline_data_)) {
+      std::memcpy(inline_data_, other.inline_data_, kInlineDataBytes);
+      data_ptr_ = at::DataPtr(inline_data_, at::Device(at::DeviceType::CPU));
+    }
+  }
   StorageImpl(const StorageImpl&) = delete;
   ~StorageImpl() = default;
 
+  // Whether the data is kept inside the StorageImpl (see makeWithInlineData)
+  bool has_inline_data() const {
+    return data_ptr_.get() == static_cast<const void*>(inline_data_);
+  }
+
   void reset() {
     data_ptr_.clear();
     numel_ = 0;
@@ -221,6 +288,13 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
     return received_cuda_;
   }
 
+  // Whether the storage was created under at::InferenceModeGuard. Only such
+  // storages may be written to while the guard is active, see
+  // at::impl::check_inplace_in_inference_mode.
+  bool is_inference() const {
+    return is_inference_;
+  }
+
  private:
   caffe2::TypeMeta data_type_;
   DataPtr data_ptr_;
@@ -229,6 +303,8 @@ struct C10_API StorageImpl final : public c10::intrusive_ptr_target {
   // Identifies that Storage was received from another process and doesn't have
   // local to process cuda memory allocation
   bool received_cuda_;
+  bool is_inference_;
   Allocator* allocator_;
+  alignas(alignof(std::max_align_t)) char inline_data_[kInlineDataBytes];
 };
 } // namespace c10
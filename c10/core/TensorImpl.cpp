@@ -1,6 +1,7 @@
 #include <c10/core/TensorImpl.h>
 
 #include <c10/core/Backend.h>
+#include <c10/core/InferenceMode.h>
 #include <c10/core/WrapDimMinimal.h>
 #include <c10/core/impl/LocalDispatchKeySet.h>
 #include <c10/util/Optional.h>
@@ -58,7 +59,8 @@ TensorImpl::TensorImpl(Storage&& storage, DispatchKeySet key_set, const caffe2::
       numel_(0),
       data_type_(data_type),
       device_opt_(device_opt),
-      key_set_(key_set) {
+      key_set_(key_set),
+      is_inference_(InferenceMode::is_enabled()) {
   if (!key_set.empty()) {
     AT_ASSERT(data_type.id() ==  caffe2::TypeIdentifier::uninitialized() ||
               device_opt_.has_value());
@@ -207,6 +209,9 @@ AutogradMetaInterface::~AutogradMetaInterface() {}
 
 void TensorImpl::set_requires_grad(bool requires_grad) {
   if (!requires_grad && !autograd_meta_) return;
+  TORCH_CHECK(!requires_grad || !is_inference_,
+      "Setting requires_grad=True on a tensor created in inference mode is not allowed. "
+      "Clone it outside of inference mode to get a tensor that can require grad.");
   if (!autograd_meta_) autograd_meta_ = impl::GetAutogradMetaFactory()->make();
   // NB: In principle, setting requires_grad to false could result in
   // the AutogradMeta becoming equal to a default constructed state,
@@ -253,12 +258,14 @@ void TensorImpl::copy_tensor_metadata(
   dest_impl->is_channels_last_ = src_impl->is_channels_last_;
   dest_impl->is_non_overlapping_and_dense_ = src_impl->is_non_overlapping_and_dense_;
   dest_impl->is_wrapped_number_ = src_impl->is_wrapped_number_;
+  dest_impl->is_inference_ = src_impl->is_inference_;
   dest_impl->reserved_ = src_impl->reserved_;
   dest_impl->set_version_counter(version_counter);
   dest_impl->set_allow_tensor_metadata_change(allow_tensor_metadata_change);
   if (src_impl->named_tensor_meta_ != nullptr) {
     dest_impl->named_tensor_meta_ = src_impl->named_tensor_meta_->clone();
   }
+  dest_impl->refresh_named_tensor_key();
 }
 
 namespace impl {
@@ -178,6 +178,13 @@ struct C10_API NamedTensorMetaInterface {
       false,
       "Not implemented: NamedTensorMetaInterface::slow_dim");
   };
+  // Whether any of the names is not None; decides whether the tensor has
+  // DispatchKey::NamedTensorId in its key set.
+  virtual bool has_names() const {
+    TORCH_INTERNAL_ASSERT(
+      false,
+      "Not implemented: NamedTensorMetaInterface::has_names");
+  };
 };
 
 // NOTE [ Version Counter Sharing ]
@@ -430,13 +437,15 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
 
   bool is_quantized() const {
     // NB: This method is not virtual and avoid dispatches for performance reasons.
-    return key_set_.has(DispatchKey::QuantizedCPUTensorId);
+    return key_set_.has(DispatchKey::QuantizedCPUTensorId) ||
+           key_set_.has(DispatchKey::QuantizedCUDATensorId);
   }
 
   bool is_cuda() const {
     // NB: This method is not virtual and avoid dispatches for performance reasons.
     return key_set_.has(DispatchKey::CUDATensorId) ||
-           key_set_.has(DispatchKey::SparseCUDATensorId);
+           key_set_.has(DispatchKey::SparseCUDATensorId) ||
+           key_set_.has(DispatchKey::QuantizedCUDATensorId);
   }
 
   bool is_hip() const {
@@ -510,6 +519,16 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     is_wrapped_number_ = value;
   }
 
+  /**
+   * True if a tensor was created under at::InferenceModeGuard.  Inference
+   * tensors are created without going through autograd, so they never
+   * carry autograd history and cannot be made to require gradient;
+   * set_requires_grad(true) on them raises an error.
+   */
+  bool is_inference() const {
+    return is_inference_;
+  }
+
   // ~~~~~ Autograd API ~~~~~
   // Some methods below are defined in TensorImpl.cpp because Tensor is an
   // incomplete type.
@@ -810,6 +829,20 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     }
 #endif
     named_tensor_meta_ = std::move(named_tensor_meta);
+    refresh_named_tensor_key();
+  }
+
+  /**
+   * Adds DispatchKey::NamedTensorId to the key set if the tensor has names,
+   * and removes it otherwise.  Must be called after the names in the named
+   * tensor metadata were changed in place.
+   */
+  void refresh_named_tensor_key() {
+    if (named_tensor_meta_ && named_tensor_meta_->has_names()) {
+      key_set_ = key_set_.add(DispatchKey::NamedTensorId);
+    } else {
+      key_set_ = key_set_.remove(DispatchKey::NamedTensorId);
+    }
   }
 
   /**
@@ -863,6 +896,10 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
    * compatible with SparseCUDATensorId.
    */
   inline bool has_compatible_shallow_copy_type(DispatchKeySet from) {
+    // Names are part of the metadata that a shallow copy copies, not of the
+    // type of the tensor.
+    const auto self = key_set_.remove(DispatchKey::NamedTensorId);
+    from = from.remove(DispatchKey::NamedTensorId);
     auto is_dense = [](DispatchKeySet ts) {
       return ts.has(DispatchKey::CPUTensorId) ||
              ts.has(DispatchKey::CUDATensorId) ||
@@ -873,7 +910,7 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
              ts.has(DispatchKey::SparseCUDATensorId) ||
              ts.has(DispatchKey::SparseHIPTensorId);
     };
-    return (key_set_ == from) || (is_dense(key_set_) && is_dense(from)) || (is_sparse(key_set_) && is_sparse(from));
+    return (self == from) || (is_dense(self) && is_dense(from)) || (is_sparse(self) && is_sparse(from));
   }
 
   /**
@@ -1613,6 +1650,10 @@ protected:
 
   bool is_wrapped_number_ = false;
 
+  // See is_inference().  Set when the tensor is constructed and never
+  // changed afterwards.
+  bool is_inference_ = false;
+
   // NOTE [ Metadata Change for a Detached Tensor ]
   //
   // Normally, a user is allowed to change the tensor metadata
@@ -354,11 +354,16 @@ struct C10_API TensorOptions {
             }
             return DispatchKey::CPUTensorId;
             }
-          case DeviceType::CUDA:
-            if (isComplexType(typeMetaToScalarType(dtype()))) {
+          case DeviceType::CUDA: {
+            auto dtype_tmp = typeMetaToScalarType(dtype());
+            if (isComplexType(dtype_tmp)) {
               return DispatchKey::ComplexCUDATensorId;
             }
+            if (isQIntType(dtype_tmp)) {
+              return DispatchKey::QuantizedCUDATensorId;
+            }
             return DispatchKey::CUDATensorId;
+            }
           case DeviceType::MKLDNN:
             return DispatchKey::MKLDNNTensorId;
           case DeviceType::OPENGL:
@@ -593,6 +598,10 @@ inline DeviceType computeDeviceType(DispatchKey tid) {
     return DeviceType::HIP;
   } else if (tid == DispatchKey::MkldnnCPUTensorId) {
     return DeviceType::CPU;
+  } else if (tid == DispatchKey::QuantizedCPUTensorId) {
+    return DeviceType::CPU;
+  } else if (tid == DispatchKey::QuantizedCUDATensorId) {
+    return DeviceType::CUDA;
   } else if (tid == DispatchKey::ComplexCPUTensorId) {
     return DeviceType::CPU;
   } else if (tid == DispatchKey::ComplexCUDATensorId) {
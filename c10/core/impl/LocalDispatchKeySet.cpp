@@ -39,6 +39,11 @@ LocalDispatchKeySet tls_local_dispatch_key_set() {
   return raw_local_dispatch_key_set;
 }
 
+void _force_tls_local_dispatch_key_set(LocalDispatchKeySet key_set) {
+  raw_local_dispatch_key_set.set_included(key_set.included_);
+  raw_local_dispatch_key_set.set_excluded(key_set.excluded_);
+}
+
 // An RAII guard could snapshot and restore the entire state (entire DispatchKeySet) as
 // opposed to only snapshotting and restoring the state of its assigned DispatchKey.
 // I'm not sure which is better.  If only the RAII API is used, the two choices are
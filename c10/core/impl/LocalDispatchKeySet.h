@@ -56,6 +56,11 @@ struct C10_API LocalDispatchKeySet {
 
 C10_API LocalDispatchKeySet tls_local_dispatch_key_set();
 
+// Overwrites the whole thread-local dispatch state, e.g. to install a state
+// captured on another thread (see at::ThreadLocalState). Prefer the RAII
+// guards below everywhere else.
+C10_API void _force_tls_local_dispatch_key_set(LocalDispatchKeySet key_set);
+
 // RAII API for manipulating the thread-local dispatch state.
 
 class C10_API IncludeDispatchKeyGuard {
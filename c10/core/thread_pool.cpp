@@ -129,6 +129,169 @@ void ThreadPool::main_loop(std::size_t index) {
   } // while running_
 }
 
+namespace {
+// Identifies the WorkStealingThreadPool worker running on this thread, if any.
+thread_local const WorkStealingThreadPool* this_thread_pool = nullptr;
+thread_local std::size_t this_thread_index = 0;
+} // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(
+    int pool_size,
+    int numa_node_id,
+    std::function<void()> init_thread)
+    : threads_(pool_size < 0 ? defaultNumThreads() : pool_size),
+      running_(true),
+      pending_(0),
+      max_pending_(0),
+      active_(0),
+      steals_(0),
+      next_queue_(0),
+      numa_node_id_(numa_node_id) {
+  for (std::size_t i = 0; i < threads_.size(); ++i) {
+    queues_.emplace_back(new WorkerQueue());
+  }
+  for (std::size_t i = 0; i < threads_.size(); ++i) {
+    threads_[i] = std::thread([this, i, init_thread](){
+      if (init_thread) {
+        init_thread();
+      }
+      this->main_loop(i);
+    });
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    running_ = false;
+    condition_.notify_all();
+  }
+
+  for (auto& t : threads_) {
+    try {
+      t.join();
+    } catch (const std::exception&) {
+    }
+  }
+}
+
+size_t WorkStealingThreadPool::size() const {
+  return threads_.size();
+}
+
+size_t WorkStealingThreadPool::numAvailable() const {
+  return threads_.size() - active_;
+}
+
+bool WorkStealingThreadPool::inThreadPool() const {
+  return this_thread_pool == this;
+}
+
+size_t WorkStealingThreadPool::numSteals() const {
+  return steals_;
+}
+
+size_t WorkStealingThreadPool::numPendingTasks() const {
+  return pending_;
+}
+
+size_t WorkStealingThreadPool::maxPendingTasks() const {
+  return max_pending_;
+}
+
+void WorkStealingThreadPool::run(const std::function<void()>& func) {
+  if (threads_.size() == 0) {
+    throw std::runtime_error("No threads to run a task");
+  }
+
+  // Count the task before it becomes visible, otherwise a worker could pop
+  // it and decrement pending_ first, wrapping the counter around.
+  const std::size_t pending = ++pending_;
+  std::size_t max_pending = max_pending_;
+  while (pending > max_pending &&
+         !max_pending_.compare_exchange_weak(max_pending, pending)) {
+  }
+
+  if (this_thread_pool == this) {
+    auto& queue = *queues_[this_thread_index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_front(func);
+  } else {
+    auto& queue = *queues_[next_queue_++ % queues_.size()];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(func);
+  }
+
+  // Workers check pending_ under mutex_ before sleeping, so taking it here
+  // guarantees the notification cannot be lost.
+  { std::lock_guard<std::mutex> lock(mutex_); }
+  condition_.notify_one();
+}
+
+void WorkStealingThreadPool::waitWorkComplete() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (pending_ != 0 || active_ != 0) {
+    completed_.wait(lock);
+  }
+}
+
+bool WorkStealingThreadPool::pop_task(
+    std::size_t index,
+    std::function<void()>& task) {
+  {
+    auto& own = *queues_[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.front());
+      own.tasks.pop_front();
+      return true;
+    }
+  }
+  for (std::size_t i = 1; i < queues_.size(); ++i) {
+    auto& victim = *queues_[(index + i) % queues_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.back());
+      victim.tasks.pop_back();
+      ++steals_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::main_loop(std::size_t index) {
+  this_thread_pool = this;
+  this_thread_index = index;
+
+  std::function<void()> task;
+  while (running_) {
+    if (pop_task(index, task)) {
+      // Become active before the task stops counting as pending, so that
+      // waitWorkComplete never observes both counters at zero mid-handoff.
+      ++active_;
+      --pending_;
+      try {
+        task();
+      } catch (const std::exception&) {
+      }
+      // Destruct the task right away, see ThreadPool::main_loop.
+      task = nullptr;
+
+      if (--active_ == 0 && pending_ == 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        completed_.notify_all();
+      }
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (pending_ == 0 && running_) {
+      condition_.wait(lock);
+    }
+  }
+}
+
 C10_DEFINE_SHARED_REGISTRY(
     ThreadPoolRegistry,
     TaskThreadPoolBase,
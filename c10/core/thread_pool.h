@@ -1,7 +1,9 @@
 #pragma once
 
 #include <condition_variable>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -115,6 +117,86 @@ class C10_API TaskThreadPool : public c10::ThreadPool {
       }) {}
 };
 
+// A thread pool where every worker owns a task deque, so that submitting and
+// taking tasks does not contend on a single pool-wide lock.
+//
+// - Tasks submitted from a worker of this pool go to the front of that
+//   worker's own deque, and a worker takes tasks from the front of its own
+//   deque first (LIFO, which keeps forked subtasks cache-hot).
+// - Tasks submitted from other threads are distributed round-robin over the
+//   workers' deques.
+// - A worker whose deque is empty steals from the back of the other deques.
+class C10_API WorkStealingThreadPool : public c10::TaskThreadPoolBase {
+ public:
+  WorkStealingThreadPool() = delete;
+
+  explicit WorkStealingThreadPool(
+      int pool_size,
+      int numa_node_id = -1,
+      std::function<void()> init_thread = nullptr);
+
+  ~WorkStealingThreadPool();
+
+  size_t size() const override;
+
+  size_t numAvailable() const override;
+
+  bool inThreadPool() const override;
+
+  void run(const std::function<void()>& func) override;
+
+  /// @brief Wait for all deques to be empty and all workers to be idle
+  void waitWorkComplete();
+
+  /// Number of tasks that were run by a worker other than the one whose
+  /// deque they were submitted to.
+  size_t numSteals() const;
+
+  /// Number of tasks submitted but not yet started (current queue depth).
+  size_t numPendingTasks() const;
+
+  /// Largest queue depth observed since the pool was created.
+  size_t maxPendingTasks() const;
+
+ private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  bool pop_task(std::size_t index, std::function<void()>& task);
+
+  // @brief Entry point for pool threads.
+  void main_loop(std::size_t index);
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<std::thread> threads_;
+
+  // Protects sleeping and completion; never held while touching the deques.
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::condition_variable completed_;
+
+  std::atomic_bool running_;
+  std::atomic<std::size_t> pending_;
+  std::atomic<std::size_t> max_pending_;
+  std::atomic<std::size_t> active_;
+  std::atomic<std::size_t> steals_;
+  std::atomic<std::size_t> next_queue_;
+  int numa_node_id_;
+};
+
+class C10_API WorkStealingTaskThreadPool : public c10::WorkStealingThreadPool {
+ public:
+  explicit WorkStealingTaskThreadPool(
+      std::size_t pool_size,
+      int numa_node_id = -1)
+      : WorkStealingThreadPool(pool_size, numa_node_id, [numa_node_id](){
+        setThreadName("CaffeTaskThread");
+        NUMABind(numa_node_id);
+      }) {}
+};
+
 C10_DECLARE_SHARED_REGISTRY(
     ThreadPoolRegistry,
     TaskThreadPoolBase,
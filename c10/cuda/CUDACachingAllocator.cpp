@@ -1,13 +1,18 @@
 #include <c10/cuda/CUDACachingAllocator.h>
 
 #include <c10/cuda/CUDAGuard.h>
+#include <c10/cuda/CUDAEventPool.h>
 #include <c10/cuda/CUDAException.h>
 #include <c10/cuda/CUDAFunctions.h>
 #include <c10/util/UniqueVoidPtr.h>
 
+#include <cuda.h>
 #include <cuda_runtime_api.h>
 #include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <cstdlib>
+#include <cstring>
 #include <deque>
 #include <iterator>
 #include <map>
@@ -18,6 +23,13 @@
 #include <unordered_set>
 #include <vector>
 
+// Expandable segments are built on the CUDA virtual memory management driver
+// APIs (cuMemCreate/cuMemMap), which first shipped in CUDA 10.2.
+#if !defined(__HIP_PLATFORM_HCC__) && !defined(_WIN32) && defined(CUDA_VERSION) && CUDA_VERSION >= 10020
+#define C10_CUDA_HAS_EXPANDABLE_SEGMENTS 1
+#include <dlfcn.h>
+#endif
+
 namespace c10 {
 
 C10_DEFINE_REGISTRY(FreeCudaMemoryCallbacksRegistry, FreeMemoryCallback);
@@ -51,6 +63,34 @@ namespace CUDACachingAllocator {
 // ensure that the block is not reused before each recorded stream completes
 // work.
 //
+// Expandable segments (opt-in, PYTORCH_CUDA_EXPANDABLE_SEGMENTS=1):
+//
+// - Instead of calling cudaMalloc for every new large segment, the allocator
+//   reserves one virtual address range per (device, stream) that is as large
+//   as the device memory, and maps physical pages at its end on demand using
+//   the CUDA virtual memory management driver APIs.
+// - Because everything allocated on a stream lives in one contiguous address
+//   range, a free block at the end of the segment is simply extended when a
+//   larger request arrives, and neighbouring frees always coalesce. This
+//   avoids the pile-up of slightly-too-small free segments that variable size
+//   workloads otherwise produce.
+// - Releasing cached memory unmaps the free pages at the end of each
+//   expandable segment.
+// - Memory in expandable segments cannot be shared with cudaIpcGetMemHandle,
+//   so this mode should not be combined with CUDA tensor sharing between
+//   processes.
+//
+// CUDA graphs (see ATen/cuda/CUDAGraph.h):
+//
+// - A graph replays its kernels with the addresses they had during capture,
+//   so while a stream is captured, the allocations on it are served from a
+//   private pool of the graph (beginAllocateStreamToPool). Blocks freed back
+//   into a private pool are only reused by later captures into that pool,
+//   never by ordinary allocations, until the pool is released.
+// - Events cannot be queried or recorded outside of the graph while a capture
+//   is underway, so frees of blocks used on other streams are deferred until
+//   the last capture ends.
+//
 
 
 namespace {
@@ -98,8 +138,20 @@ void update_stat_array(StatArray& stat_array, int64_t amount, const StatTypes& s
 }
 
 struct Block;
+struct ExpandableSegment;
+struct PrivatePool;
 typedef bool (*Comparison)(const Block*, const Block*);
-typedef std::set<Block*, Comparison> BlockPool;
+static bool BlockComparator(const Block* a, const Block* b);
+
+struct BlockPool : public std::set<Block*, Comparison> {
+  BlockPool(bool small, PrivatePool* owner = nullptr) :
+    std::set<Block*, Comparison>(BlockComparator), is_small(small),
+    owner_private_pool(owner) { }
+
+  const bool is_small;
+  // the graph pool this pool belongs to, if any
+  PrivatePool* const owner_private_pool;
+};
 
 struct Block {
   int           device;      // gpu
@@ -112,21 +164,39 @@ struct Block {
   Block*        prev;        // prev block if split from a larger allocation
   Block*        next;        // next block if split from a larger allocation
   int           event_count; // number of outstanding CUDA events
+  ExpandableSegment* expandable_segment; // owning segment if not from cudaMalloc
 
   Block(int device, cudaStream_t stream, size_t size, BlockPool* pool, void* ptr) :
     device(device), stream(stream), stream_uses(), size(size), pool(pool),
-    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(ptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    expandable_segment(nullptr) { }
 
   // constructor for search key
   Block(int device, cudaStream_t stream, size_t size) :
     device(device), stream(stream), stream_uses(), size(size), pool(nullptr),
-    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0) { }
+    ptr(nullptr), allocated(0), prev(nullptr), next(nullptr), event_count(0),
+    expandable_segment(nullptr) { }
 
   bool is_split() const {
     return (prev != nullptr) || (next != nullptr);
   }
 };
 
+// The blocks of the allocations made during the captures into a graph pool.
+struct PrivatePool {
+  PrivatePool() :
+    large_blocks(/* small */ false, this),
+    small_blocks(/* small */ true, this) { }
+
+  // graphs that were captured into the pool and not released yet
+  int use_count = 1;
+  // segments cudaMalloc'd for the pool, which are freed once it is released
+  // and none of its blocks are allocated
+  int cudaMalloc_count = 0;
+  BlockPool large_blocks;
+  BlockPool small_blocks;
+};
+
 static bool BlockComparator(const Block* a, const Block* b)
 {
   if (a->device != b->device) {
@@ -141,6 +211,182 @@ static bool BlockComparator(const Block* a, const Block* b)
   return (uintptr_t)a->ptr < (uintptr_t)b->ptr;
 }
 
+#ifdef C10_CUDA_HAS_EXPANDABLE_SEGMENTS
+
+// The driver API is loaded lazily so that libc10_cuda keeps depending only on
+// the CUDA runtime, and only processes that opt into expandable segments need
+// libcuda to provide these entry points.
+struct DriverAPI {
+#define C10_FORALL_DRIVER_FUNCTIONS(_) \
+  _(cuGetErrorString)                  \
+  _(cuMemAddressReserve)               \
+  _(cuMemAddressFree)                  \
+  _(cuMemCreate)                       \
+  _(cuMemRelease)                      \
+  _(cuMemMap)                          \
+  _(cuMemUnmap)                        \
+  _(cuMemSetAccess)                    \
+  _(cuMemGetAllocationGranularity)
+#define CREATE_MEMBER(name) decltype(&name) name##_;
+  C10_FORALL_DRIVER_FUNCTIONS(CREATE_MEMBER)
+#undef CREATE_MEMBER
+
+  static const DriverAPI& get() {
+    static DriverAPI api = load();
+    return api;
+  }
+
+ private:
+  static DriverAPI load() {
+    void* handle = dlopen("libcuda.so.1", RTLD_LAZY | RTLD_LOCAL);
+    TORCH_CHECK(handle, "expandable segments require libcuda.so.1: ", dlerror());
+    DriverAPI api;
+#define LOOKUP_ENTRY(name)                                            \
+    api.name##_ = reinterpret_cast<decltype(&name)>(dlsym(handle, #name)); \
+    TORCH_CHECK(api.name##_, "expandable segments: cannot find ", #name, \
+                " in libcuda.so.1");
+    C10_FORALL_DRIVER_FUNCTIONS(LOOKUP_ENTRY)
+#undef LOOKUP_ENTRY
+    return api;
+  }
+#undef C10_FORALL_DRIVER_FUNCTIONS
+};
+
+#define C10_CUDA_DRIVER_CHECK(EXPR)                                 \
+  do {                                                              \
+    CUresult __err = EXPR;                                          \
+    if (__err != CUDA_SUCCESS) {                                    \
+      const char* err_str = nullptr;                                \
+      DriverAPI::get().cuGetErrorString_(__err, &err_str);          \
+      TORCH_CHECK(false, "CUDA driver error: ",                     \
+                  err_str ? err_str : "unknown error");             \
+    }                                                               \
+  } while (0)
+
+#endif // C10_CUDA_HAS_EXPANDABLE_SEGMENTS
+
+// A virtual address range reserved for all large allocations of one
+// (device, stream), backed by physical pages that are mapped in order from the
+// start of the range. The blocks carved out of it form an ordinary prev/next
+// chain that covers exactly the mapped prefix; `tail` is its last block.
+struct ExpandableSegment {
+  int device;
+  cudaStream_t stream;
+  char* base = nullptr;
+  size_t reserved_size = 0;
+  size_t page_size = 0;
+  Block* tail = nullptr;
+#ifdef C10_CUDA_HAS_EXPANDABLE_SEGMENTS
+  std::vector<CUmemGenericAllocationHandle> pages;
+
+  ExpandableSegment(int device, cudaStream_t stream)
+      : device(device), stream(stream) {
+    const auto& api = DriverAPI::get();
+    CUmemAllocationProp prop = {};
+    prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+    prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    prop.location.id = device;
+    C10_CUDA_DRIVER_CHECK(api.cuMemGetAllocationGranularity_(
+        &page_size, &prop, CU_MEM_ALLOC_GRANULARITY_RECOMMENDED));
+
+    size_t device_free;
+    size_t device_total;
+    C10_CUDA_CHECK(cudaMemGetInfo(&device_free, &device_total));
+    reserved_size = page_size * ((device_total + page_size - 1) / page_size);
+
+    CUdeviceptr ptr;
+    C10_CUDA_DRIVER_CHECK(
+        api.cuMemAddressReserve_(&ptr, reserved_size, 0, 0, 0));
+    base = reinterpret_cast<char*>(ptr);
+  }
+
+  ~ExpandableSegment() {
+    TORCH_INTERNAL_ASSERT(pages.empty());
+    DriverAPI::get().cuMemAddressFree_(
+        reinterpret_cast<CUdeviceptr>(base), reserved_size);
+  }
+
+  size_t mapped_size() const {
+    return pages.size() * page_size;
+  }
+
+  // Maps `size` more bytes (a multiple of page_size) at the end of the mapped
+  // range. Returns false, mapping nothing, if the device is out of memory.
+  bool grow(size_t size) {
+    TORCH_INTERNAL_ASSERT(size % page_size == 0);
+    if (mapped_size() + size > reserved_size) {
+      return false;
+    }
+    const auto& api = DriverAPI::get();
+    CUmemAllocationProp prop = {};
+    prop.type = CU_MEM_ALLOCATION_TYPE_PINNED;
+    prop.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    prop.location.id = device;
+
+    const size_t begin = mapped_size();
+    const size_t num_pages = size / page_size;
+    for (size_t i = 0; i < num_pages; ++i) {
+      CUmemGenericAllocationHandle handle;
+      CUresult err = api.cuMemCreate_(&handle, page_size, &prop, 0);
+      if (err == CUDA_SUCCESS) {
+        err = api.cuMemMap_(
+            reinterpret_cast<CUdeviceptr>(base + mapped_size()), page_size, 0,
+            handle, 0);
+        if (err != CUDA_SUCCESS) {
+          // The handle is not in pages yet, so shrink() won't release it.
+          api.cuMemRelease_(handle);
+        }
+      }
+      if (err != CUDA_SUCCESS) {
+        shrink(pages.size() * page_size - begin);
+        if (err == CUDA_ERROR_OUT_OF_MEMORY) {
+          return false;
+        }
+        C10_CUDA_DRIVER_CHECK(err);
+      }
+      pages.push_back(handle);
+    }
+
+    CUmemAccessDesc desc = {};
+    desc.location.type = CU_MEM_LOCATION_TYPE_DEVICE;
+    desc.location.id = device;
+    desc.flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE;
+    C10_CUDA_DRIVER_CHECK(api.cuMemSetAccess_(
+        reinterpret_cast<CUdeviceptr>(base + begin), size, &desc, 1));
+    return true;
+  }
+
+  // Unmaps the last `size` bytes (a multiple of page_size) of the mapped range.
+  void shrink(size_t size) {
+    TORCH_INTERNAL_ASSERT(size % page_size == 0 && size <= mapped_size());
+    const auto& api = DriverAPI::get();
+    for (size_t i = 0; i < size / page_size; ++i) {
+      C10_CUDA_DRIVER_CHECK(api.cuMemUnmap_(
+          reinterpret_cast<CUdeviceptr>(base + mapped_size() - page_size),
+          page_size));
+      C10_CUDA_DRIVER_CHECK(api.cuMemRelease_(pages.back()));
+      pages.pop_back();
+    }
+  }
+#else
+  ExpandableSegment(int device, cudaStream_t stream)
+      : device(device), stream(stream) {
+    AT_ERROR("expandable segments require CUDA 10.2 or newer on Linux");
+  }
+  size_t mapped_size() const { return 0; }
+  bool grow(size_t size) { return false; }
+  void shrink(size_t size) {}
+#endif
+};
+
+bool expandable_segments_enabled() {
+  static bool enabled = []() {
+    const char* env = getenv("PYTORCH_CUDA_EXPANDABLE_SEGMENTS");
+    return env != nullptr && strcmp(env, "0") != 0;
+  }();
+  return enabled;
+}
+
 static std::string format_size(uint64_t size) {
   std::ostringstream os;
   os.precision(2);
@@ -184,14 +430,42 @@ class THCCachingAllocator {
   // allocated blocks by device pointer
   std::unordered_map<void*, Block*> allocated_blocks;
 
-  // outstanding cuda events
-  std::deque<std::pair<cudaEvent_t, Block*>> cuda_events;
+  // outstanding cuda events, on the device of the stream they were recorded
+  // on; they come from and go back to the CUDAEventPool
+  struct BlockEvent {
+    cudaEvent_t event;
+    int device;
+    Block* block;
+  };
+  std::deque<BlockEvent> cuda_events;
+
+  // expandable segments, at most one per (device, stream)
+  std::vector<std::unique_ptr<ExpandableSegment>> expandable_segments;
+
+  // private pools of CUDA graphs
+  std::map<MempoolId_t, std::unique_ptr<PrivatePool>> graph_pools;
+
+  // the private pool that the allocations on a (device, stream) go to while
+  // the stream is captured
+  struct CaptureUnderway {
+    int device;
+    cudaStream_t stream;
+    PrivatePool* pool;
+  };
+  std::vector<CaptureUnderway> captures_underway;
+
+  // blocks whose frees need events, made while a capture was underway
+  std::vector<Block*> needs_events_deferred_until_no_capture;
+
+  // cudaIpcMemHandle_t of the segments shared through CUDA IPC, by segment
+  // address, erased when the segment is freed
+  std::unordered_map<void*, std::string> ipc_mem_handles;
 
  public:
 
   THCCachingAllocator() :
-      large_blocks(BlockComparator),
-      small_blocks(BlockComparator) {}
+      large_blocks(/* small */ false),
+      small_blocks(/* small */ true) {}
 
   std::mutex* getCudaFreeMutex() const {
     return &cuda_free_mutex;
@@ -208,13 +482,16 @@ class THCCachingAllocator {
     int device;
     C10_CUDA_CHECK(cudaGetDevice(&device));
 
-    // process outstanding cudaEvents
-    process_events();
+    // process outstanding cudaEvents, unless they cannot be queried because
+    // of a capture
+    if (captures_underway.empty()) {
+      process_events();
+    }
 
     size = round_size(size);
 
     Block search_key(device, stream, size);
-    auto& pool = get_pool(size);
+    auto& pool = get_pool(size, device, stream);
 
     DeviceStats& stats = get_stats_for_device(device);
     StatTypes stat_types;
@@ -246,13 +523,24 @@ class THCCachingAllocator {
     if (block == nullptr) {
       void* ptr;
       size_t alloc_size = get_allocation_size(size);
-      cudaError_t err = cuda_malloc_with_retry(device, &ptr, alloc_size);
+      cudaError_t err;
+
+      if (expandable_segments_enabled() && &pool == &large_blocks) {
+        alloc_size = size;
+        err = grow_expandable_segment_with_retry(device, stream, size, &block);
+      } else {
+        err = cuda_malloc_with_retry(device, &ptr, alloc_size);
+        if (err == cudaSuccess) {
+          block = new Block(device, stream, alloc_size, &pool, ptr);
+          if (pool.owner_private_pool) {
+            pool.owner_private_pool->cudaMalloc_count++;
+          }
+          update_stat_array(stats.segment, 1, stat_types);
+          update_stat_array(stats.reserved_bytes, alloc_size, stat_types);
+        }
+      }
 
-      if (err == cudaSuccess) {
-        block = new Block(device, stream, alloc_size, &pool, ptr);
-        update_stat_array(stats.segment, 1, stat_types);
-        update_stat_array(stats.reserved_bytes, alloc_size, stat_types);
-      } else if (err == cudaErrorMemoryAllocation) {
+      if (err == cudaErrorMemoryAllocation) {
         cudaGetLastError();  // clear CUDA error
 
         size_t device_free;
@@ -300,6 +588,7 @@ class THCCachingAllocator {
       remaining = block;
 
       block = new Block(device, stream, size, &pool, block->ptr);
+      block->expandable_segment = remaining->expandable_segment;
       block->prev = remaining->prev;
       if (block->prev) {
         block->prev->next = block;
@@ -335,6 +624,10 @@ class THCCachingAllocator {
     update_stat_array(stats.allocated_bytes, block->size, stat_types);
     update_stat_array(stats.active, 1, stat_types);
     update_stat_array(stats.active_bytes, block->size, stat_types);
+
+    c10::ReportMemoryUsage(
+        block->ptr, static_cast<int64_t>(block->size),
+        c10::Device(c10::DeviceType::CUDA, block->device));
   }
 
   void free(void* ptr)
@@ -360,13 +653,69 @@ class THCCachingAllocator {
     update_stat_array(stats.allocation, -1, {stat_types});
     update_stat_array(stats.allocated_bytes, -block->size, {stat_types});
 
+    c10::ReportMemoryUsage(
+        block->ptr, -static_cast<int64_t>(block->size),
+        c10::Device(c10::DeviceType::CUDA, block->device));
+
     if (!block->stream_uses.empty()) {
-      insert_events(block);
+      if (captures_underway.empty()) {
+        insert_events(block);
+      } else {
+        needs_events_deferred_until_no_capture.push_back(block);
+      }
     } else {
       free_block(block);
     }
   }
 
+  /** routes the allocations on a stream to a private pool while it is captured **/
+  void beginAllocateStreamToPool(int device, cudaStream_t stream, MempoolId_t mempool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    for (const auto& capture : captures_underway) {
+      TORCH_CHECK(
+          capture.device != device || capture.stream != stream,
+          "the stream is already allocating to a private pool");
+    }
+    auto& pool = graph_pools[mempool_id];
+    if (pool) {
+      // another graph shares the pool
+      pool->use_count++;
+    } else {
+      pool.reset(new PrivatePool());
+    }
+    captures_underway.push_back({device, stream, pool.get()});
+  }
+
+  /** ends the routing of beginAllocateStreamToPool **/
+  void endAllocateStreamToPool(int device, cudaStream_t stream) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = std::find_if(
+        captures_underway.begin(), captures_underway.end(),
+        [&](const CaptureUnderway& capture) {
+          return capture.device == device && capture.stream == stream;
+        });
+    TORCH_CHECK(
+        it != captures_underway.end(),
+        "the stream was not allocating to a private pool");
+    captures_underway.erase(it);
+    if (captures_underway.empty()) {
+      for (Block* block : needs_events_deferred_until_no_capture) {
+        insert_events(block);
+      }
+      needs_events_deferred_until_no_capture.clear();
+    }
+  }
+
+  /** called when a graph using the pool is destroyed; frees the pool's memory once no graph uses it **/
+  void releasePool(MempoolId_t mempool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = graph_pools.find(mempool_id);
+    TORCH_CHECK(it != graph_pools.end(), "unknown private pool");
+    TORCH_INTERNAL_ASSERT(it->second->use_count > 0);
+    it->second->use_count--;
+    free_released_pools();
+  }
+
   void* getBaseAllocation(void* ptr, size_t* outSize) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
     Block* block = find_allocated_block(ptr);
@@ -388,6 +737,29 @@ class THCCachingAllocator {
     return basePtr;
   }
 
+  std::string getIpcMemHandle(void* ptr) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    Block* block = find_allocated_block(ptr);
+    if (!block) {
+      AT_ERROR("invalid device pointer: ", ptr);
+    }
+    TORCH_CHECK(!block->expandable_segment,
+                "Memory of expandable segments cannot be shared through CUDA IPC");
+    while (block->prev) {
+      block = block->prev;
+    }
+    auto it = ipc_mem_handles.find(block->ptr);
+    if (it == ipc_mem_handles.end()) {
+      cuda::CUDAGuard device_guard(block->device);
+      cudaIpcMemHandle_t handle;
+      C10_CUDA_CHECK(cudaIpcGetMemHandle(&handle, block->ptr));
+      it = ipc_mem_handles.emplace(
+          block->ptr,
+          std::string(reinterpret_cast<const char*>(&handle), CUDA_IPC_HANDLE_SIZE)).first;
+    }
+    return it->second;
+  }
+
   void recordStream(const DataPtr& ptr, cuda::CUDAStream stream) {
     // Empty tensor's storage().data() might be a null ptr. As there is no
     // blocks associated with those tensors, it is fine to do nothing here.
@@ -420,8 +792,13 @@ class THCCachingAllocator {
   void emptyCache() {
     std::lock_guard<std::recursive_mutex> lock(mutex);
     synchronize_and_free_events(nullopt);
+    for (DeviceStats& stats : device_stats) {
+      stats.num_cache_flushes += 1;
+    }
     free_blocks(large_blocks, large_blocks.begin(), large_blocks.end());
     free_blocks(small_blocks, small_blocks.begin(), small_blocks.end());
+    release_expandable_segments(nullopt);
+    free_released_pools();
   }
 
   /** Retrieves info (total size + largest block) of the memory cache **/
@@ -455,6 +832,7 @@ class THCCachingAllocator {
 
     stats.num_alloc_retries = 0;
     stats.num_ooms = 0;
+    stats.num_cache_flushes = 0;
   }
 
   /** Resets the historical peak stats for the device **/
@@ -489,7 +867,9 @@ class THCCachingAllocator {
       SegmentInfo& segment_info = result.back();
       segment_info.device = head_block->device;
       segment_info.address = reinterpret_cast<int64_t>(head_block->ptr);
-      segment_info.is_large = (head_block->pool == &large_blocks);
+      segment_info.stream = reinterpret_cast<int64_t>(head_block->stream);
+      segment_info.is_large = !head_block->pool->is_small;
+      segment_info.is_expandable = (head_block->expandable_segment != nullptr);
 
       const Block* block = head_block;
       while (block != nullptr) {
@@ -497,6 +877,7 @@ class THCCachingAllocator {
         BlockInfo& block_info = segment_info.blocks.back();
 
         block_info.size = block->size;
+        block_info.stream = reinterpret_cast<int64_t>(block->stream);
         block_info.allocated = block->allocated;
         block_info.active = block->allocated || (block->event_count > 0);
 
@@ -538,6 +919,11 @@ class THCCachingAllocator {
     std::vector<const Block*> blocks;
     blocks.insert(blocks.end(), small_blocks.begin(), small_blocks.end());
     blocks.insert(blocks.end(), large_blocks.begin(), large_blocks.end());
+    for (const auto& item : graph_pools) {
+      const PrivatePool& pool = *item.second;
+      blocks.insert(blocks.end(), pool.small_blocks.begin(), pool.small_blocks.end());
+      blocks.insert(blocks.end(), pool.large_blocks.begin(), pool.large_blocks.end());
+    }
     for (const auto& item : allocated_blocks) {
       blocks.push_back(item.second);
     }
@@ -603,6 +989,10 @@ class THCCachingAllocator {
       }
     }
 
+    if (src->expandable_segment && src->expandable_segment->tail == src) {
+      src->expandable_segment->tail = dst;
+    }
+
     const size_t subsumed_size = src->size;
     dst->size += subsumed_size;
     pool.erase(src);
@@ -611,7 +1001,16 @@ class THCCachingAllocator {
     return subsumed_size;
   }
 
-  BlockPool& get_pool(size_t size) {
+  BlockPool& get_pool(size_t size, int device, cudaStream_t stream) {
+    for (const auto& capture : captures_underway) {
+      if (capture.device == device && capture.stream == stream) {
+        if (size <= kSmallSize) {
+          return capture.pool->small_blocks;
+        } else {
+          return capture.pool->large_blocks;
+        }
+      }
+    }
     if (size <= kSmallSize) {
       return small_blocks;
     } else {
@@ -620,23 +1019,35 @@ class THCCachingAllocator {
   }
 
   StatType get_stat_type_for_pool(const BlockPool& pool) {
-    if (&pool == &small_blocks) {
-      return StatType::SMALL_POOL;
-    } else if (&pool == &large_blocks) {
-      return StatType::LARGE_POOL;
-    } else {
-      AT_ERROR("get_stat_type_for_pool: invalid pool");
-    }
+    return pool.is_small ? StatType::SMALL_POOL : StatType::LARGE_POOL;
   }
 
   bool should_split(const Block* block, size_t size) {
     size_t remaining = block->size - size;
-    if (block->pool == &small_blocks) {
+    if (block->pool->is_small) {
       return remaining >= kMinBlockSize;
-    } else if (block->pool == &large_blocks) {
-      return remaining > kSmallSize;
     } else {
-      AT_ERROR("should_split: invalid pool");
+      return remaining > kSmallSize;
+    }
+  }
+
+  /** frees the cached segments of the graph pools that no graph uses anymore **/
+  void free_released_pools() {
+    for (auto it = graph_pools.begin(); it != graph_pools.end();) {
+      PrivatePool& pool = *it->second;
+      if (pool.use_count > 0) {
+        ++it;
+        continue;
+      }
+      free_blocks(pool.large_blocks, pool.large_blocks.begin(), pool.large_blocks.end());
+      free_blocks(pool.small_blocks, pool.small_blocks.begin(), pool.small_blocks.end());
+      // blocks that are still allocated keep the pool alive until they are
+      // freed back into it and the cache is emptied
+      if (pool.cudaMalloc_count == 0) {
+        it = graph_pools.erase(it);
+      } else {
+        ++it;
+      }
     }
   }
 
@@ -684,6 +1095,8 @@ class THCCachingAllocator {
     // outstanding events are returned to the pool.
     synchronize_and_free_events(device);
 
+    get_stats_for_device(device).num_cache_flushes += 1;
+
     // Free all non-split cached blocks on device
     Block lower_bound(device, nullptr, 0);
     Block upper_bound(device + 1, nullptr, 0);
@@ -696,6 +1109,160 @@ class THCCachingAllocator {
         small_blocks,
         small_blocks.lower_bound(&lower_bound),
         small_blocks.lower_bound(&upper_bound));
+    release_expandable_segments(device);
+  }
+
+  ExpandableSegment* get_expandable_segment(int device, cudaStream_t stream)
+  {
+    for (const auto& segment : expandable_segments) {
+      if (segment->device == device && segment->stream == stream) {
+        return segment.get();
+      }
+    }
+    expandable_segments.emplace_back(new ExpandableSegment(device, stream));
+
+    DeviceStats& stats = get_stats_for_device(device);
+    StatTypes stat_types;
+    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+    stat_types[static_cast<size_t>(StatType::LARGE_POOL)] = true;
+    update_stat_array(stats.segment, 1, stat_types);
+    return expandable_segments.back().get();
+  }
+
+  cudaError_t grow_expandable_segment_with_retry(int device, cudaStream_t stream, size_t size, Block** block)
+  {
+    // Like cuda_malloc_with_retry: if mapping more pages fails, release all
+    // cached memory on the device and try once more.
+    if (grow_expandable_segment(get_expandable_segment(device, stream), size, block)) {
+      return cudaSuccess;
+    }
+    DeviceStats& stats = get_stats_for_device(device);
+    stats.num_alloc_retries += 1;
+    free_cached_blocks(device);
+    // free_cached_blocks may have released the segment if it was empty
+    if (grow_expandable_segment(get_expandable_segment(device, stream), size, block)) {
+      return cudaSuccess;
+    }
+    return cudaErrorMemoryAllocation;
+  }
+
+  /** maps enough new pages into the segment to hold a free block of at least size bytes at its end */
+  bool grow_expandable_segment(ExpandableSegment* segment, size_t size, Block** out)
+  {
+    Block* tail = segment->tail;
+    // A free tail is always in the pool, and since the free block search
+    // failed it must be smaller than the request.
+    const bool extend_tail = tail && !tail->allocated && tail->event_count == 0;
+    AT_ASSERT(!extend_tail || tail->size < size);
+
+    const size_t needed = extend_tail ? size - tail->size : size;
+    const size_t grow_size = segment->page_size * ((needed + segment->page_size - 1) / segment->page_size);
+    char* end = segment->base + segment->mapped_size();
+    if (!segment->grow(grow_size)) {
+      return false;
+    }
+
+    DeviceStats& stats = get_stats_for_device(segment->device);
+    StatTypes stat_types;
+    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+    stat_types[static_cast<size_t>(StatType::LARGE_POOL)] = true;
+    update_stat_array(stats.reserved_bytes, grow_size, stat_types);
+
+    if (extend_tail) {
+      large_blocks.erase(tail);
+      if (tail->is_split()) {
+        update_stat_array(stats.inactive_split_bytes, grow_size, stat_types);
+      }
+      tail->size += grow_size;
+      *out = tail;
+    } else {
+      Block* block = new Block(segment->device, segment->stream, grow_size, &large_blocks, end);
+      block->expandable_segment = segment;
+      block->prev = tail;
+      if (tail) {
+        // the new block starts out as an inactive split block; malloc()
+        // accounts for it becoming active.
+        tail->next = block;
+        update_stat_array(stats.inactive_split, 1, stat_types);
+        update_stat_array(stats.inactive_split_bytes, grow_size, stat_types);
+      }
+      segment->tail = block;
+      *out = block;
+    }
+    return true;
+  }
+
+  void release_expandable_segments(optional<int> device)
+  {
+    // Unmaps the free pages at the end of expandable segments, limited to the
+    // given device if specified. Segments left without any block are freed.
+    for (auto it = expandable_segments.begin(); it != expandable_segments.end();) {
+      ExpandableSegment* segment = it->get();
+      if (device.has_value() && segment->device != *device) {
+        ++it;
+        continue;
+      }
+      cuda::CUDAGuard device_guard(segment->device);
+      if (shrink_expandable_segment(segment)) {
+        DeviceStats& stats = get_stats_for_device(segment->device);
+        StatTypes stat_types;
+        stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+        stat_types[static_cast<size_t>(StatType::LARGE_POOL)] = true;
+        update_stat_array(stats.segment, -1, stat_types);
+        it = expandable_segments.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  /** unmaps the free tail of the segment; returns true if the segment is now empty */
+  bool shrink_expandable_segment(ExpandableSegment* segment)
+  {
+    Block* tail = segment->tail;
+    if (!tail) {
+      return true;
+    }
+    if (tail->allocated || tail->event_count > 0) {
+      return false;
+    }
+
+    // The first page of the tail may be shared with the previous block.
+    const size_t offset = static_cast<char*>(tail->ptr) - segment->base;
+    const size_t page_size = segment->page_size;
+    const size_t keep = page_size * ((offset + page_size - 1) / page_size) - offset;
+    const size_t release = tail->size - keep;
+    if (release == 0) {
+      return false;
+    }
+
+    DeviceStats& stats = get_stats_for_device(segment->device);
+    StatTypes stat_types;
+    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+    stat_types[static_cast<size_t>(StatType::LARGE_POOL)] = true;
+
+    large_blocks.erase(tail);
+    segment->shrink(release);
+    update_stat_array(stats.reserved_bytes, -release, stat_types);
+
+    if (keep > 0) {
+      update_stat_array(stats.inactive_split_bytes, -release, stat_types);
+      tail->size = keep;
+      large_blocks.insert(tail);
+      return false;
+    }
+
+    if (tail->is_split()) {
+      update_stat_array(stats.inactive_split, -1, stat_types);
+      update_stat_array(stats.inactive_split_bytes, -tail->size, stat_types);
+    }
+    Block* prev = tail->prev;
+    if (prev) {
+      prev->next = nullptr;
+    }
+    segment->tail = prev;
+    delete tail;
+    return prev == nullptr;
   }
 
   void free_blocks(BlockPool& blocks, BlockPool::iterator it, BlockPool::iterator end)
@@ -703,8 +1270,9 @@ class THCCachingAllocator {
     // Frees all non-split blocks between `it` and `end`
     while (it != end) {
       Block* block = *it;
-      if (!block->prev && !block->next) {
+      if (!block->prev && !block->next && !block->expandable_segment) {
         C10_CUDA_CHECK(cudaFree((void*)block->ptr));
+        ipc_mem_handles.erase(block->ptr);
 
         DeviceStats& stats = get_stats_for_device(block->device);
         StatTypes stat_types;
@@ -712,6 +1280,9 @@ class THCCachingAllocator {
         stat_types[static_cast<size_t>(get_stat_type_for_pool(*(block->pool)))] = true;
         update_stat_array(stats.segment, -1, stat_types);
         update_stat_array(stats.reserved_bytes, -block->size, stat_types);
+        if (blocks.owner_private_pool) {
+          blocks.owner_private_pool->cudaMalloc_count--;
+        }
 
         auto cur = it;
         ++it;
@@ -730,15 +1301,14 @@ class THCCachingAllocator {
     auto remaining_events = decltype(cuda_events)();
 
     for (auto& e : cuda_events) {
-      cudaEvent_t event = e.first;
-      Block* block = e.second;
+      Block* block = e.block;
       if (device.has_value() && block->device != *device) {
         remaining_events.push_back(e);
         continue;
       }
 
-      C10_CUDA_CHECK(cudaEventSynchronize(event));
-      C10_CUDA_CHECK(cudaEventDestroy(event));
+      C10_CUDA_CHECK(cudaEventSynchronize(e.event));
+      CUDAEventPool::release(e.device, e.event);
 
       block->event_count--;
       if (block->event_count == 0) {
@@ -767,12 +1337,15 @@ class THCCachingAllocator {
     for (auto it = streams.begin(); it != streams.end(); ++it) {
       C10_CUDA_CHECK(cudaSetDevice(it->device_index()));
 
-      cudaEvent_t event;
-      C10_CUDA_CHECK(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
-      C10_CUDA_CHECK(cudaEventRecord(event, it->stream()));
+      cudaEvent_t event = CUDAEventPool::acquire(it->device_index());
+      cudaError_t err = cudaEventRecord(event, it->stream());
+      if (err != cudaSuccess) {
+        CUDAEventPool::release(it->device_index(), event);
+        C10_CUDA_CHECK(err);
+      }
 
       block->event_count++;
-      cuda_events.emplace_back(event, block);
+      cuda_events.push_back({event, it->device_index(), block});
     }
 
     C10_CUDA_CHECK(cudaSetDevice(prev_device));
@@ -787,10 +1360,9 @@ class THCCachingAllocator {
     // the processing of some events may be delayed.
     while (!cuda_events.empty()) {
       auto& e = cuda_events.front();
-      cudaEvent_t event = e.first;
-      Block* block = e.second;
+      Block* block = e.block;
 
-      cudaError_t err = cudaEventQuery(event);
+      cudaError_t err = cudaEventQuery(e.event);
       if (err == cudaErrorNotReady) {
         // ignore and clear the error if not ready
         cudaGetLastError();
@@ -799,7 +1371,7 @@ class THCCachingAllocator {
         C10_CUDA_CHECK(err);
       }
 
-      C10_CUDA_CHECK(cudaEventDestroy(event));
+      CUDAEventPool::release(e.device, e.event);
 
       block->event_count--;
       if (block->event_count == 0) {
@@ -864,11 +1436,37 @@ void* getBaseAllocation(void *ptr, size_t *size)
   return caching_allocator.getBaseAllocation(ptr, size);
 }
 
+std::string getIpcMemHandle(void* ptr)
+{
+  return caching_allocator.getIpcMemHandle(ptr);
+}
+
 void recordStream(const DataPtr& ptr, cuda::CUDAStream stream)
 {
   caching_allocator.recordStream(ptr, stream);
 }
 
+void beginAllocateStreamToPool(int device, cudaStream_t stream, MempoolId_t mempool_id)
+{
+  caching_allocator.beginAllocateStreamToPool(device, stream, mempool_id);
+}
+
+void endAllocateStreamToPool(int device, cudaStream_t stream)
+{
+  caching_allocator.endAllocateStreamToPool(device, stream);
+}
+
+void releasePool(MempoolId_t mempool_id)
+{
+  caching_allocator.releasePool(mempool_id);
+}
+
+MempoolId_t graphPoolHandle()
+{
+  static std::atomic<MempoolId_t> next_id{1};
+  return next_id++;
+}
+
 std::mutex* getFreeMutex()
 {
   return caching_allocator.getCudaFreeMutex();
@@ -81,11 +81,16 @@ struct DeviceStats {
 
   // COUNT: total number of OOMs (i.e. failed calls to CUDA after cache flush)
   int64_t num_ooms = 0;
+
+  // COUNT: total number of times cached blocks were released back to CUDA
+  // via cudaFree (either by emptyCache() or by a cudaMalloc retry).
+  int64_t num_cache_flushes = 0;
 };
 
 // Struct containing info of an allocation block (i.e. a fractional part of a cudaMalloc)..
 struct BlockInfo {
   int64_t size = 0;
+  int64_t stream = 0;
   bool allocated = false;
   bool active = false;
 };
@@ -94,13 +99,20 @@ struct BlockInfo {
 struct SegmentInfo {
   int64_t device = 0;
   int64_t address = 0;
+  int64_t stream = 0;
   int64_t total_size = 0;
   int64_t allocated_size = 0;
   int64_t active_size = 0;
   bool is_large = false;
+  bool is_expandable = false;
   std::vector<BlockInfo> blocks;
 };
 
+// Identifies a private memory pool for the allocations made while capturing
+// CUDA graphs. Graphs captured into the same pool may share memory, which is
+// safe as long as they are replayed in the order they were captured.
+typedef uint64_t MempoolId_t;
+
 C10_CUDA_API void* raw_alloc(size_t nbytes);
 C10_CUDA_API void raw_delete(void* ptr);
 
@@ -114,9 +126,24 @@ C10_CUDA_API void resetAccumulatedStats(int device);
 C10_CUDA_API void resetPeakStats(int device);
 C10_CUDA_API std::vector<SegmentInfo> snapshot();
 
+// Returns a new id for a private pool.
+C10_CUDA_API MempoolId_t graphPoolHandle();
+// Until endAllocateStreamToPool, allocations on `stream` of `device` are
+// served from the private pool `mempool_id`, which is created if needed.
+// Each begin counts as a use of the pool, so each needs a releasePool.
+C10_CUDA_API void beginAllocateStreamToPool(int device, cudaStream_t stream, MempoolId_t mempool_id);
+C10_CUDA_API void endAllocateStreamToPool(int device, cudaStream_t stream);
+// Drops a use of the pool; its memory is freed once it has no uses and none
+// of its blocks are allocated.
+C10_CUDA_API void releasePool(MempoolId_t mempool_id);
+
 C10_CUDA_API std::mutex* getFreeMutex();
 
 C10_CUDA_API std::shared_ptr<void> getIpcDevPtr(std::string handle);
+// Returns the cudaIpcMemHandle_t, as a string, of the segment that the
+// allocated `ptr` belongs to. The handle is cached until the segment is
+// freed, so sharing many tensors of a segment calls cudaIpcGetMemHandle once.
+C10_CUDA_API std::string getIpcMemHandle(void* ptr);
 } // namespace CUDACachingAllocator
 
 }} // namespace c10::cuda
@@ -0,0 +1,137 @@
+#include <c10/cuda/CUDAEventPool.h>
+#include <c10/cuda/CUDAException.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <c10/util/Exception.h>
+
+#include <mutex>
+#include <vector>
+
+namespace c10 {
+namespace cuda {
+namespace CUDAEventPool {
+
+namespace {
+
+struct DeviceEventPool {
+  std::mutex mutex;
+  std::vector<cudaEvent_t> events;
+  EventPoolStats stats;
+};
+
+// Leaked, like the stream pools: events may be released by the destructors
+// of other globals, and destroying events at exit may run after the CUDA
+// runtime is gone.
+DeviceEventPool* device_pools() {
+  static DeviceEventPool* pools =
+      new DeviceEventPool[C10_COMPILE_TIME_MAX_GPUS];
+  return pools;
+}
+
+DeviceEventPool& get_pool(DeviceIndex device) {
+  TORCH_CHECK(
+      device >= 0 && device < C10_COMPILE_TIME_MAX_GPUS,
+      "Invalid device index ",
+      device,
+      " for the CUDA event pool");
+  return device_pools()[device];
+}
+
+} // namespace
+
+cudaEvent_t acquire(DeviceIndex device) {
+  auto& pool = get_pool(device);
+  {
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    if (!pool.events.empty()) {
+      cudaEvent_t event = pool.events.back();
+      pool.events.pop_back();
+      pool.stats.num_reused++;
+      pool.stats.num_in_use++;
+      pool.stats.num_cached--;
+      return event;
+    }
+  }
+
+  // the driver call is made without holding the lock
+  cudaEvent_t event;
+  {
+    CUDAGuard guard(device);
+    C10_CUDA_CHECK(cudaEventCreateWithFlags(&event, cudaEventDisableTiming));
+  }
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  pool.stats.num_created++;
+  pool.stats.num_in_use++;
+  return event;
+}
+
+void release(DeviceIndex device, cudaEvent_t event) {
+  auto& pool = get_pool(device);
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  pool.events.push_back(event);
+  pool.stats.num_in_use--;
+  pool.stats.num_cached++;
+}
+
+EventPoolStats getStats(DeviceIndex device) {
+  auto& pool = get_pool(device);
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  return pool.stats;
+}
+
+void resetAccumulatedStats(DeviceIndex device) {
+  auto& pool = get_pool(device);
+  std::lock_guard<std::mutex> lock(pool.mutex);
+  pool.stats.num_created = 0;
+  pool.stats.num_reused = 0;
+}
+
+void emptyCache() {
+  for (DeviceIndex device = 0; device < C10_COMPILE_TIME_MAX_GPUS; ++device) {
+    auto& pool = device_pools()[device];
+    std::vector<cudaEvent_t> events;
+    {
+      std::lock_guard<std::mutex> lock(pool.mutex);
+      std::swap(events, pool.events);
+      pool.stats.num_cached = 0;
+    }
+    if (events.empty()) {
+      continue;
+    }
+    // events are destroyed on their device to avoid creating a context on
+    // another one
+    CUDAGuard guard(device);
+    for (cudaEvent_t event : events) {
+      C10_CUDA_CHECK(cudaEventDestroy(event));
+    }
+  }
+}
+
+} // namespace CUDAEventPool
+
+void streamWaitStream(
+    const CUDAStream& waiting,
+    const CUDAStream& signaling) {
+  if (waiting == signaling) {
+    return;
+  }
+  const DeviceIndex device = signaling.device_index();
+  cudaEvent_t event = CUDAEventPool::acquire(device);
+  cudaError_t err;
+  {
+    // cudaEventRecord must be called on the device of the event, and
+    // cudaStreamWaitEvent on the device of the waiting stream.
+    CUDAGuard guard(device);
+    err = cudaEventRecord(event, signaling.stream());
+    if (err == cudaSuccess) {
+      guard.set_index(waiting.device_index());
+      err = cudaStreamWaitEvent(waiting.stream(), event, 0);
+    }
+  }
+  // the wait has captured the recorded work, so the event can be reused
+  // right away
+  CUDAEventPool::release(device, event);
+  C10_CUDA_CHECK(err);
+}
+
+} // namespace cuda
+} // namespace c10
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <c10/core/Device.h>
+#include <c10/cuda/CUDAMacros.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <cuda_runtime_api.h>
+
+#include <cstdint>
+
+/*
+ * A per-device pool of cudaEventDisableTiming events.
+ *
+ * Creating and destroying an event costs a driver call each, which shows up
+ * in code that synchronizes streams with short-lived events, such as the
+ * caching allocator's recordStream path or the stream syncs of
+ * ProcessGroupNCCL. An event can be reused as soon as its last
+ * cudaEventRecord no longer needs to be queried: cudaStreamWaitEvent and
+ * cudaEventSynchronize snapshot the work recorded at the time of the call,
+ * so recording the event again does not affect them. The pool hands such
+ * events back out instead of destroying them.
+ *
+ * Cached events are never destroyed, except by emptyCache().
+ */
+
+namespace c10 {
+namespace cuda {
+namespace CUDAEventPool {
+
+struct EventPoolStats {
+  // number of events the pool created with cudaEventCreateWithFlags
+  int64_t num_created = 0;
+  // number of acquire() calls served from the cached events
+  int64_t num_reused = 0;
+  // number of events acquired and not yet released
+  int64_t num_in_use = 0;
+  // number of events cached in the pool
+  int64_t num_cached = 0;
+};
+
+// Returns an event of `device`, creating it if the pool is empty. The event
+// must be given back with release() on the same device, and must not be
+// destroyed by the caller.
+C10_CUDA_API cudaEvent_t acquire(DeviceIndex device);
+C10_CUDA_API void release(DeviceIndex device, cudaEvent_t event);
+
+C10_CUDA_API EventPoolStats getStats(DeviceIndex device);
+// Resets num_created and num_reused; the other stats are current values.
+C10_CUDA_API void resetAccumulatedStats(DeviceIndex device);
+
+// Destroys the cached events of all devices.
+C10_CUDA_API void emptyCache();
+
+} // namespace CUDAEventPool
+
+// Makes the work submitted to `waiting` after this call wait for the work
+// submitted to `signaling` so far, using a pooled event. Does nothing if the
+// streams are the same. Neither stream is synchronized with the host.
+C10_CUDA_API void streamWaitStream(
+    const CUDAStream& waiting,
+    const CUDAStream& signaling);
+
+} // namespace cuda
+} // namespace c10
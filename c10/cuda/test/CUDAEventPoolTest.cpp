@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <c10/cuda/CUDAEventPool.h>
+#include <c10/cuda/CUDAFunctions.h>
+#include <c10/cuda/CUDAStream.h>
+
+using namespace c10::cuda;
+
+TEST(CUDAEventPoolTest, ReleasedEventsAreReused) {
+  if (device_count() == 0) {
+    return;
+  }
+  CUDAEventPool::emptyCache();
+  CUDAEventPool::resetAccumulatedStats(0);
+
+  cudaEvent_t first = CUDAEventPool::acquire(0);
+  cudaEvent_t second = CUDAEventPool::acquire(0);
+  ASSERT_NE(first, second);
+  auto stats = CUDAEventPool::getStats(0);
+  EXPECT_EQ(stats.num_created, 2);
+  EXPECT_EQ(stats.num_in_use, 2);
+
+  CUDAEventPool::release(0, first);
+  EXPECT_EQ(CUDAEventPool::acquire(0), first);
+  stats = CUDAEventPool::getStats(0);
+  EXPECT_EQ(stats.num_created, 2);
+  EXPECT_EQ(stats.num_reused, 1);
+
+  CUDAEventPool::release(0, first);
+  CUDAEventPool::release(0, second);
+  stats = CUDAEventPool::getStats(0);
+  EXPECT_EQ(stats.num_in_use, 0);
+  EXPECT_EQ(stats.num_cached, 2);
+
+  CUDAEventPool::emptyCache();
+  EXPECT_EQ(CUDAEventPool::getStats(0).num_cached, 0);
+}
+
+TEST(CUDAEventPoolTest, StreamWaitStreamReusesOneEvent) {
+  if (device_count() == 0) {
+    return;
+  }
+  CUDAEventPool::emptyCache();
+  CUDAEventPool::resetAccumulatedStats(0);
+
+  auto producer = getStreamFromPool(/*isHighPriority=*/false, 0);
+  auto consumer = getStreamFromPool(/*isHighPriority=*/true, 0);
+  for (int i = 0; i < 100; ++i) {
+    streamWaitStream(consumer, producer);
+  }
+  consumer.synchronize();
+
+  auto stats = CUDAEventPool::getStats(0);
+  EXPECT_EQ(stats.num_created, 1);
+  EXPECT_EQ(stats.num_reused, 99);
+  EXPECT_EQ(stats.num_in_use, 0);
+
+  // waiting on itself is a no-op
+  streamWaitStream(consumer, consumer);
+  EXPECT_EQ(CUDAEventPool::getStats(0).num_reused, 99);
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocationPlan.h>
+#include <c10/core/CPUAllocator.h>
+
+#include <cstring>
+#include <thread>
+
+using namespace c10;
+
+namespace {
+
+struct Pointers {
+  void* x;
+  void* y;
+  void* z;
+  void* out;
+};
+
+// x and z are never alive at the same time, y overlaps both, and `out` is
+// returned from the run.
+DataPtr workload(CPUAllocationPlan& plan, Pointers& ptrs, size_t size = 1000) {
+  CPUAllocationPlan::Guard guard(plan);
+  Allocator* allocator = GetCPUAllocator();
+  DataPtr x = allocator->allocate(size);
+  DataPtr y = allocator->allocate(2000);
+  memset(x.get(), 1, size);
+  ptrs.x = x.get();
+  x.clear();
+  DataPtr z = allocator->allocate(size);
+  DataPtr out = allocator->allocate(500);
+  memset(y.get(), 2, 2000);
+  memset(z.get(), 3, size);
+  ptrs.y = y.get();
+  ptrs.z = z.get();
+  ptrs.out = out.get();
+  return out;
+}
+
+bool overlaps(void* a, size_t a_size, void* b, size_t b_size) {
+  auto a_begin = static_cast<char*>(a);
+  auto b_begin = static_cast<char*>(b);
+  return a_begin < b_begin + b_size && b_begin < a_begin + a_size;
+}
+
+} // namespace
+
+TEST(CPUAllocationPlanTest, ReusesArenaAcrossRuns) {
+  CPUAllocationPlan plan;
+  ASSERT_EQ(plan.arena_size(), 0);
+  ASSERT_EQ(CPUAllocationPlan::current_allocator(), nullptr);
+
+  Pointers first{};
+  DataPtr out1 = workload(plan, first);
+  // x and z share memory, `out` is not in the arena
+  ASSERT_EQ(plan.arena_size(), 2048 + 1024);
+  ASSERT_EQ(plan.num_arena_allocations(), 0);
+
+  Pointers second{};
+  DataPtr out2 = workload(plan, second);
+  ASSERT_EQ(plan.num_arena_allocations(), 3);
+  ASSERT_EQ(second.x, second.z);
+  ASSERT_FALSE(overlaps(second.y, 2000, second.z, 1000));
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(second.z) % gAlignment, 0);
+  ASSERT_FALSE(overlaps(second.out, 500, second.y, 3072));
+  ASSERT_NE(second.out, first.out);
+
+  Pointers third{};
+  workload(plan, third);
+  ASSERT_EQ(plan.num_arena_allocations(), 3);
+  ASSERT_EQ(third.y, second.y);
+  ASSERT_EQ(third.z, second.z);
+  ASSERT_EQ(CPUAllocationPlan::current_allocator(), nullptr);
+}
+
+TEST(CPUAllocationPlanTest, RecordsAgainWhenRunsDiffer) {
+  CPUAllocationPlan plan;
+  Pointers ptrs{};
+  workload(plan, ptrs);
+  ASSERT_EQ(plan.arena_size(), 2048 + 1024);
+
+  // The first allocation has another size, so nothing comes from the arena
+  workload(plan, ptrs, 4000);
+  ASSERT_EQ(plan.num_arena_allocations(), 0);
+  ASSERT_EQ(plan.arena_size(), 0);
+
+  workload(plan, ptrs, 4000);
+  ASSERT_EQ(plan.arena_size(), 2048 + 4032);
+  workload(plan, ptrs, 4000);
+  ASSERT_EQ(plan.num_arena_allocations(), 3);
+}
+
+TEST(CPUAllocationPlanTest, StopsUsingArenaAfterEarlyFree) {
+  CPUAllocationPlan plan;
+  Pointers ptrs{};
+  workload(plan, ptrs);
+
+  {
+    CPUAllocationPlan::Guard guard(plan);
+    Allocator* allocator = GetCPUAllocator();
+    DataPtr x = allocator->allocate(1000);
+    DataPtr y = allocator->allocate(2000);
+    x.clear();
+    // y was recorded to be freed at the end, after z was allocated
+    y.clear();
+    DataPtr z = allocator->allocate(1000);
+    memset(z.get(), 3, 1000);
+  }
+  ASSERT_EQ(plan.num_arena_allocations(), 2);
+}
+
+TEST(CPUAllocationPlanTest, ArenaMemoryOutlivesPlan) {
+  DataPtr kept;
+  {
+    CPUAllocationPlan plan;
+    Pointers ptrs{};
+    workload(plan, ptrs);
+    {
+      CPUAllocationPlan::Guard guard(plan);
+      Allocator* allocator = GetCPUAllocator();
+      kept = allocator->allocate(1000);
+      DataPtr y = allocator->allocate(2000);
+    }
+    // kept was recorded to be freed within the run, so the next run can't use
+    // the same arena
+    ASSERT_EQ(plan.arena_size(), 0);
+    workload(plan, ptrs);
+  }
+  memset(kept.get(), 4, 1000);
+}
+
+TEST(CPUAllocationPlanTest, OnlyOneThreadRunsUnderAPlan) {
+  CPUAllocationPlan plan;
+  CPUAllocationPlan::Guard guard(plan);
+  ASSERT_NE(CPUAllocationPlan::current_allocator(), nullptr);
+  ASSERT_EQ(GetCPUAllocator(), CPUAllocationPlan::current_allocator());
+  std::thread([&plan] {
+    CPUAllocationPlan::Guard other(plan);
+    ASSERT_EQ(CPUAllocationPlan::current_allocator(), nullptr);
+    ASSERT_EQ(GetCPUAllocator(), GetAllocator(DeviceType::CPU));
+  }).join();
+}
@@ -0,0 +1,25 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+
+using namespace c10;
+
+TEST(CPUAllocatorTest, DefaultAlignment) {
+  for (size_t nbytes : {1, 100, 4096, 3 * 1024 * 1024}) {
+    DataPtr ptr = GetDefaultCPUAllocator()->allocate(nbytes);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr.get()) % gAlignment, 0);
+  }
+}
+
+TEST(CPUAllocatorTest, HugePageAlignment) {
+  FLAGS_caffe2_cpu_allocator_use_huge_pages = true;
+  {
+    DataPtr large = GetDefaultCPUAllocator()->allocate(4 * 1024 * 1024);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(large.get()) % (2 * 1024 * 1024), 0);
+    memset(large.get(), 0, 4 * 1024 * 1024);
+    // small allocations keep the regular alignment
+    DataPtr small = GetDefaultCPUAllocator()->allocate(1024);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(small.get()) % gAlignment, 0);
+  }
+  FLAGS_caffe2_cpu_allocator_use_huge_pages = false;
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUCachingAllocator.h>
+
+#include <thread>
+#include <vector>
+
+using namespace c10;
+
+TEST(CPUCachingAllocatorTest, ReusesFreedBlocks) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  CPUCachingAllocator::resetAccumulatedStats();
+
+  void* first;
+  {
+    DataPtr ptr = allocator->allocate(1000);
+    first = ptr.get();
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(first) % 64, 0);
+  }
+  // same size class
+  DataPtr ptr = allocator->allocate(1010);
+  ASSERT_EQ(ptr.get(), first);
+
+  auto stats = CPUCachingAllocator::getStats();
+  ASSERT_EQ(stats.num_cache_misses, 1);
+  ASSERT_EQ(stats.num_cache_hits, 1);
+  ASSERT_EQ(stats.allocation.current, 1);
+  ASSERT_EQ(stats.allocation.allocated, 2);
+  ASSERT_EQ(stats.allocated_bytes.current, 1024);
+}
+
+TEST(CPUCachingAllocatorTest, SizeClasses) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  for (size_t nbytes : {1, 63, 64, 65, 80, 81, 129, 1000000, 3000001}) {
+    auto before = CPUCachingAllocator::getStats().allocated_bytes.current;
+    DataPtr ptr = allocator->allocate(nbytes);
+    auto rounded = CPUCachingAllocator::getStats().allocated_bytes.current - before;
+    ASSERT_GE(rounded, nbytes);
+    ASSERT_LE(rounded, std::max<size_t>(64, nbytes + nbytes / 4));
+    memset(ptr.get(), 0, nbytes);
+  }
+}
+
+TEST(CPUCachingAllocatorTest, LargeAllocationsAreNotCached) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  auto reserved = CPUCachingAllocator::getStats().reserved_bytes.current;
+  {
+    DataPtr ptr = allocator->allocate(CPUCachingAllocator::kMaxCachedSize + 1);
+    ASSERT_GT(CPUCachingAllocator::getStats().reserved_bytes.current, reserved);
+  }
+  ASSERT_EQ(CPUCachingAllocator::getStats().reserved_bytes.current, reserved);
+}
+
+TEST(CPUCachingAllocatorTest, EmptyCacheReleasesMemory) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  { DataPtr ptr = allocator->allocate(4096); }
+  ASSERT_GT(CPUCachingAllocator::getStats().reserved_bytes.current, 0);
+  CPUCachingAllocator::emptyCache();
+  ASSERT_EQ(CPUCachingAllocator::getStats().reserved_bytes.current, 0);
+}
+
+TEST(CPUCachingAllocatorTest, BlocksMoveBetweenThreads) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+
+  // blocks freed on an exiting thread end up in the global pool
+  std::thread([&]() {
+    std::vector<DataPtr> ptrs;
+    for (int i = 0; i < 100; ++i) {
+      ptrs.push_back(allocator->allocate(256));
+    }
+  }).join();
+
+  CPUCachingAllocator::resetAccumulatedStats();
+  std::vector<DataPtr> ptrs;
+  for (int i = 0; i < 100; ++i) {
+    ptrs.push_back(allocator->allocate(256));
+  }
+  ASSERT_EQ(CPUCachingAllocator::getStats().num_cache_misses, 0);
+}
+
+namespace {
+// Constructed before the allocator's thread cache, so it is destroyed after it.
+struct LateFree {
+  DataPtr ptr;
+};
+thread_local LateFree late_free;
+} // namespace
+
+TEST(CPUCachingAllocatorTest, FreeAfterThreadCacheDestroyed) {
+  Allocator* allocator = CPUCachingAllocator::get();
+  CPUCachingAllocator::emptyCache();
+  auto allocations = CPUCachingAllocator::getStats().allocation.current;
+
+  std::thread([&]() {
+    LateFree& holder = late_free;
+    holder.ptr = allocator->allocate(256);
+  }).join();
+
+  ASSERT_EQ(CPUCachingAllocator::getStats().allocation.current, allocations);
+  CPUCachingAllocator::resetAccumulatedStats();
+  DataPtr ptr = allocator->allocate(256);
+  ASSERT_EQ(CPUCachingAllocator::getStats().num_cache_hits, 1);
+}
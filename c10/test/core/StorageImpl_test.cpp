@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/StorageImpl.h>
+
+#include <utility>
+
+using namespace c10;
+
+TEST(StorageImplTest, SmallStorageKeepsDataInline) {
+  auto storage = StorageImpl::makeWithInlineData(
+      caffe2::TypeMeta::Make<double>(), 1, GetDefaultCPUAllocator(), true);
+  ASSERT_TRUE(storage->has_inline_data());
+  ASSERT_EQ(storage->numel(), 1);
+  ASSERT_EQ(
+      reinterpret_cast<uintptr_t>(storage->data()) % alignof(double), 0);
+  *storage->data<double>() = 3.5;
+  ASSERT_EQ(*storage->data<double>(), 3.5);
+}
+
+TEST(StorageImplTest, LargeOrEmptyStorageUsesAllocator) {
+  auto large = StorageImpl::makeWithInlineData(
+      caffe2::TypeMeta::Make<float>(),
+      StorageImpl::kInlineDataBytes / sizeof(float) + 1,
+      GetDefaultCPUAllocator(),
+      true);
+  ASSERT_FALSE(large->has_inline_data());
+  ASSERT_EQ(reinterpret_cast<uintptr_t>(large->data()) % gAlignment, 0);
+
+  auto empty = StorageImpl::makeWithInlineData(
+      caffe2::TypeMeta::Make<float>(), 0, GetDefaultCPUAllocator(), true);
+  ASSERT_FALSE(empty->has_inline_data());
+}
+
+TEST(StorageImplTest, MovingInlineStorageCopiesData) {
+  auto storage = StorageImpl::makeWithInlineData(
+      caffe2::TypeMeta::Make<int64_t>(), 2, GetDefaultCPUAllocator(), true);
+  storage->data<int64_t>()[0] = 1;
+  storage->data<int64_t>()[1] = 2;
+
+  StorageImpl moved(std::move(*storage));
+  ASSERT_TRUE(moved.has_inline_data());
+  ASSERT_EQ(moved.data<int64_t>()[0], 1);
+  ASSERT_EQ(moved.data<int64_t>()[1], 2);
+
+  auto other = StorageImpl::makeWithInlineData(
+      caffe2::TypeMeta::Make<int64_t>(), 100, GetDefaultCPUAllocator(), true);
+  *other = std::move(moved);
+  ASSERT_TRUE(other->has_inline_data());
+  ASSERT_EQ(other->numel(), 2);
+  ASSERT_EQ(other->data<int64_t>()[1], 2);
+}
+
+TEST(StorageImplTest, ResizingInlineStorageUsesAllocator) {
+  auto storage = StorageImpl::makeWithInlineData(
+      caffe2::TypeMeta::Make<float>(), 1, GetDefaultCPUAllocator(), true);
+  *storage->data<float>() = 1.5f;
+  DataPtr data = storage->allocator()->allocate(1024 * sizeof(float));
+  static_cast<float*>(data.get())[0] = *storage->data<float>();
+  storage->set_data_ptr(std::move(data));
+  storage->set_numel(1024);
+  ASSERT_FALSE(storage->has_inline_data());
+  ASSERT_EQ(storage->data<float>()[0], 1.5f);
+}
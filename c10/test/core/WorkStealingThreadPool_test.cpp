@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/thread_pool.h>
+
+#include <atomic>
+
+using namespace c10;
+
+TEST(WorkStealingThreadPoolTest, RunsAllTasks) {
+  WorkStealingThreadPool pool(4);
+  std::atomic<int> count{0};
+  for (int i = 0; i < 1000; ++i) {
+    pool.run([&count]() { ++count; });
+  }
+  pool.waitWorkComplete();
+  ASSERT_EQ(count, 1000);
+  ASSERT_EQ(pool.numPendingTasks(), 0);
+  ASSERT_EQ(pool.numAvailable(), 4);
+  ASSERT_GE(pool.maxPendingTasks(), 1);
+}
+
+TEST(WorkStealingThreadPoolTest, NestedTasksAreStolen) {
+  WorkStealingThreadPool pool(4);
+  std::atomic<int> count{0};
+  std::atomic<bool> in_pool{true};
+  // a single root task forks work onto its own deque; idle workers steal it
+  pool.run([&]() {
+    for (int i = 0; i < 100; ++i) {
+      pool.run([&]() {
+        in_pool = in_pool && pool.inThreadPool();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        ++count;
+      });
+    }
+  });
+  pool.waitWorkComplete();
+  ASSERT_EQ(count, 100);
+  ASSERT_TRUE(in_pool);
+  ASSERT_FALSE(pool.inThreadPool());
+  ASSERT_GT(pool.numSteals(), 0);
+}
+
+TEST(WorkStealingThreadPoolTest, ThreadInit) {
+  std::atomic<int> initialized{0};
+  {
+    WorkStealingThreadPool pool(3, -1, [&]() { ++initialized; });
+    pool.run([]() {});
+    pool.waitWorkComplete();
+  }
+  ASSERT_EQ(initialized, 3);
+}
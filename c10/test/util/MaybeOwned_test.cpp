@@ -0,0 +1,94 @@
+#include <c10/util/MaybeOwned.h>
+#include <c10/util/intrusive_ptr.h>
+
+#include <gtest/gtest.h>
+
+using c10::MaybeOwned;
+using c10::intrusive_ptr;
+using c10::intrusive_ptr_target;
+using c10::make_intrusive;
+
+namespace {
+
+class MyString : public intrusive_ptr_target {
+ public:
+  explicit MyString(std::string value) : value(std::move(value)) {}
+  std::string value;
+};
+
+TEST(MaybeOwnedTest, givenBorrowed_thenDoesNotCopy) {
+  auto ptr = make_intrusive<MyString>("borrowed");
+  auto borrowed = MaybeOwned<intrusive_ptr<MyString>>::borrowed(ptr);
+  EXPECT_TRUE(borrowed.is_borrowed());
+  EXPECT_EQ(&ptr, &*borrowed);
+  EXPECT_EQ("borrowed", (*borrowed)->value);
+  EXPECT_EQ(1, ptr.use_count());
+}
+
+TEST(MaybeOwnedTest, givenOwned_thenOwns) {
+  auto ptr = make_intrusive<MyString>("owned");
+  auto owned = MaybeOwned<intrusive_ptr<MyString>>::owned(std::move(ptr));
+  EXPECT_FALSE(owned.is_borrowed());
+  EXPECT_EQ("owned", (*owned)->value);
+  EXPECT_EQ(1, owned->use_count());
+}
+
+TEST(MaybeOwnedTest, givenOwnedInPlace_thenOwns) {
+  auto owned = MaybeOwned<std::string>::owned(c10::in_place, 3, 'a');
+  EXPECT_FALSE(owned.is_borrowed());
+  EXPECT_EQ("aaa", *owned);
+  EXPECT_EQ(3, owned->size());
+}
+
+TEST(MaybeOwnedTest, givenBorrowed_whenCopying_thenBorrowsSameObject) {
+  auto ptr = make_intrusive<MyString>("borrowed");
+  auto borrowed = MaybeOwned<intrusive_ptr<MyString>>::borrowed(ptr);
+  auto copy = borrowed;
+  EXPECT_TRUE(copy.is_borrowed());
+  EXPECT_EQ(&ptr, &*copy);
+  auto moved = std::move(copy);
+  EXPECT_TRUE(moved.is_borrowed());
+  EXPECT_EQ(&ptr, &*moved);
+  EXPECT_EQ(1, ptr.use_count());
+}
+
+TEST(MaybeOwnedTest, givenOwned_whenCopying_thenOwnsCopy) {
+  auto owned = MaybeOwned<intrusive_ptr<MyString>>::owned(
+      make_intrusive<MyString>("owned"));
+  auto copy = owned;
+  EXPECT_FALSE(copy.is_borrowed());
+  EXPECT_NE(&*owned, &*copy);
+  EXPECT_EQ(owned->get(), copy->get());
+  EXPECT_EQ(2, owned->use_count());
+}
+
+TEST(MaybeOwnedTest, givenOwned_whenMoving_thenMovesValue) {
+  auto owned = MaybeOwned<intrusive_ptr<MyString>>::owned(
+      make_intrusive<MyString>("owned"));
+  const MyString* target = owned->get();
+  auto moved = std::move(owned);
+  EXPECT_FALSE(moved.is_borrowed());
+  EXPECT_EQ(target, moved->get());
+  EXPECT_EQ(1, moved->use_count());
+}
+
+TEST(MaybeOwnedTest, whenAssigning_thenReleasesPreviousValue) {
+  auto ptr = make_intrusive<MyString>("borrowed");
+  auto other = make_intrusive<MyString>("owned");
+  auto maybe = MaybeOwned<intrusive_ptr<MyString>>::owned(
+      intrusive_ptr<MyString>(other));
+  EXPECT_EQ(2, other.use_count());
+  maybe = MaybeOwned<intrusive_ptr<MyString>>::borrowed(ptr);
+  EXPECT_EQ(1, other.use_count());
+  EXPECT_TRUE(maybe.is_borrowed());
+  EXPECT_EQ(&ptr, &*maybe);
+
+  auto owned = MaybeOwned<intrusive_ptr<MyString>>::owned(
+      intrusive_ptr<MyString>(other));
+  maybe = owned;
+  EXPECT_FALSE(maybe.is_borrowed());
+  EXPECT_EQ(3, other.use_count());
+  EXPECT_EQ(1, ptr.use_count());
+}
+
+} // namespace
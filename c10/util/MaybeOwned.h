@@ -0,0 +1,128 @@
+#pragma once
+
+#include <c10/util/in_place.h>
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace c10 {
+
+/// Either a borrowed reference to a T or an owned T.
+///
+/// Copying a Tensor (or any intrusive_ptr) costs an atomic increment and
+/// decrement of its refcount, which shows up on hot paths where the copy only
+/// exists to be read from, e.g. `const Tensor input = self.contiguous();` when
+/// self usually is contiguous already. MaybeOwned<T> lets such code borrow the
+/// original instead and only own a T when a new one had to be made.
+///
+/// MaybeOwned::borrowed() does not extend the lifetime of its argument: the
+/// caller MUST ensure that the borrowed-from object outlives the MaybeOwned
+/// and all of its copies. For that reason, prefer to only use MaybeOwned as a
+/// local variable, never as a member or a return value that outlives the call.
+template <typename T>
+class MaybeOwned final {
+  bool isBorrowed_;
+  union {
+    const T* borrow_;
+    T own_;
+  };
+
+  struct borrow_tag {};
+
+  MaybeOwned(borrow_tag, const T& t) : isBorrowed_(true), borrow_(&t) {}
+
+  template <class... Args>
+  explicit MaybeOwned(in_place_t, Args&&... args)
+      : isBorrowed_(false), own_(std::forward<Args>(args)...) {}
+
+  void construct_from(const MaybeOwned& rhs) {
+    if (rhs.isBorrowed_) {
+      borrow_ = rhs.borrow_;
+    } else {
+      new (&own_) T(rhs.own_);
+    }
+    isBorrowed_ = rhs.isBorrowed_;
+  }
+
+  void construct_from(MaybeOwned&& rhs) noexcept(
+      std::is_nothrow_move_constructible<T>::value) {
+    if (rhs.isBorrowed_) {
+      borrow_ = rhs.borrow_;
+    } else {
+      new (&own_) T(std::move(rhs.own_));
+    }
+    isBorrowed_ = rhs.isBorrowed_;
+  }
+
+  void destroy() noexcept {
+    if (!isBorrowed_) {
+      own_.~T();
+    }
+  }
+
+ public:
+  // Copying a borrow yields another borrow of the same object, like copying a
+  // T*. Copying an owned T yields another owned T, so that no copy ever
+  // references storage of another MaybeOwned.
+  MaybeOwned(const MaybeOwned& rhs) : isBorrowed_(true), borrow_(nullptr) {
+    construct_from(rhs);
+  }
+
+  MaybeOwned(MaybeOwned&& rhs) noexcept(
+      std::is_nothrow_move_constructible<T>::value)
+      : isBorrowed_(true), borrow_(nullptr) {
+    construct_from(std::move(rhs));
+  }
+
+  MaybeOwned& operator=(const MaybeOwned& rhs) {
+    if (this != &rhs) {
+      destroy();
+      isBorrowed_ = true;
+      construct_from(rhs);
+    }
+    return *this;
+  }
+
+  MaybeOwned& operator=(MaybeOwned&& rhs) noexcept(
+      std::is_nothrow_move_constructible<T>::value) {
+    if (this != &rhs) {
+      destroy();
+      isBorrowed_ = true;
+      construct_from(std::move(rhs));
+    }
+    return *this;
+  }
+
+  ~MaybeOwned() {
+    destroy();
+  }
+
+  static MaybeOwned borrowed(const T& t) {
+    return MaybeOwned(borrow_tag(), t);
+  }
+
+  static MaybeOwned owned(T&& t) noexcept(
+      std::is_nothrow_move_constructible<T>::value) {
+    return MaybeOwned(in_place, std::move(t));
+  }
+
+  template <class... Args>
+  static MaybeOwned owned(in_place_t, Args&&... args) {
+    return MaybeOwned(in_place, std::forward<Args>(args)...);
+  }
+
+  bool is_borrowed() const noexcept {
+    return isBorrowed_;
+  }
+
+  const T& operator*() const noexcept {
+    return isBorrowed_ ? *borrow_ : own_;
+  }
+
+  const T* operator->() const noexcept {
+    return isBorrowed_ ? borrow_ : &own_;
+  }
+};
+
+} // namespace c10
@@ -844,13 +844,14 @@ private:
       return sentinel;
     }
 
-    EntryPointer empty_default_table()
-    {
-        EntryPointer result = AllocatorTraits::allocate(*this, detailv3::min_lookups);
-        EntryPointer special_end_item = result + static_cast<ptrdiff_t>(detailv3::min_lookups - 1);
-        for (EntryPointer it = result; it != special_end_item; ++it)
-            it->distance_from_desired = -1;
-        special_end_item->distance_from_desired = Entry::special_end_value;
+    // All empty tables share one read-only table, so that default constructed
+    // (and moved-from) maps don't allocate. Nothing is ever written to it:
+    // emplace_new_key() grows the table before inserting when
+    // num_slots_minus_one == 0, and deallocate_data() skips it.
+    static EntryPointer empty_default_table()
+    {
+        static Entry result[detailv3::min_lookups] = { {}, {}, {}, {Entry::special_end_value} };
+        static_assert(detailv3::min_lookups == 4, "the initializer above assumes min_lookups == 4");
         return result;
     }
 
@@ -1018,7 +1019,8 @@ private:
 
     void deallocate_data(EntryPointer begin, uint64_t num_slots_minus_one, int8_t max_lookups)
     {
-        AllocatorTraits::deallocate(*this, begin, num_slots_minus_one + max_lookups + 1);
+        if (begin != empty_default_table())
+            AllocatorTraits::deallocate(*this, begin, num_slots_minus_one + max_lookups + 1);
     }
 
     void reset_to_empty_state()
@@ -1,5 +1,6 @@
 #include "caffe2/core/blob_serialization.h"
 
+#include <algorithm>
 #include <sstream>
 #include <mutex>
 
@@ -21,7 +22,54 @@ C10_DEFINE_bool(
     false,
     "Serialize FLOAT16 tensors using byte_data field");
 
+C10_DEFINE_bool(
+    caffe2_serialize_using_bytes_as_holder,
+    false,
+    "Serialize tensors of fixed size numeric types using byte_data field, "
+    "which is faster to write and parse than the typed repeated fields. "
+    "Builds that predate this option can't read such tensors.");
+
 namespace caffe2 {
+namespace {
+// The data types whose elements can be stored in byte_data as they are laid
+// out in memory.
+bool IsBytesHolderType(TensorProto::DataType data_type) {
+  switch (data_type) {
+    case TensorProto_DataType_FLOAT:
+    case TensorProto_DataType_INT32:
+    case TensorProto_DataType_BOOL:
+    case TensorProto_DataType_UINT8:
+    case TensorProto_DataType_INT8:
+    case TensorProto_DataType_UINT16:
+    case TensorProto_DataType_INT16:
+    case TensorProto_DataType_INT64:
+    case TensorProto_DataType_FLOAT16:
+    case TensorProto_DataType_DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool SerializeUsingBytes(TensorProto::DataType data_type) {
+  if (data_type == TensorProto_DataType_FLOAT16 &&
+      FLAGS_caffe2_serialize_fp16_as_bytes) {
+    return true;
+  }
+  return FLAGS_caffe2_serialize_using_bytes_as_holder &&
+      IsBytesHolderType(data_type);
+}
+
+void EnforceLittleEndian() {
+  const int kValue = 1;
+  CAFFE_ENFORCE_EQ(
+      reinterpret_cast<const char*>(&kValue)[0],
+      1,
+      "Serialization using byte_data on big endian platform "
+      "is not written yet.");
+}
+} // namespace
+
 /**
  * @brief StringSerializer is the serializer for String.
  *
@@ -148,8 +196,12 @@ void TensorSerializer::SerializeWithChunkSize(
   };
   std::vector<std::future<void>> futures;
   if (tensor.numel() > chunk_size) {
-    futures.reserve(FLAGS_caffe2_max_tensor_serializer_threads);
-    for (int i = 0; i < FLAGS_caffe2_max_tensor_serializer_threads; ++i) {
+    // No point in starting more threads than there are chunks
+    const int64_t num_chunks = (tensor.numel() + chunk_size - 1) / chunk_size;
+    const int num_threads = std::min<int64_t>(
+        FLAGS_caffe2_max_tensor_serializer_threads, num_chunks);
+    futures.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
       futures.emplace_back(std::async(std::launch::async, task));
     }
   }
@@ -226,6 +278,18 @@ void TensorSerializer::Serialize(
   // TODO: use CUDAGuard here instead of context and employ explicit sync
   // copy
   auto uniq_ptr = CreateContext(input.GetDevice());
+  if (SerializeUsingBytes(data_type)) {
+    EnforceLittleEndian();
+    const size_t itemsize = input.itemsize();
+    detail::CopyToProtoAsBytes(
+        chunkSize * itemsize,
+        chunkSize > 0
+            ? static_cast<const char*>(input.raw_data()) + chunkBegin * itemsize
+            : nullptr,
+        proto.mutable_byte_data(),
+        uniq_ptr.get());
+    return;
+  }
   // A lot of copypaste is error prone. Should we create a macro for this?
   switch (data_type) {
     case TensorProto_DataType_FLOAT:
@@ -296,31 +360,15 @@ void TensorSerializer::Serialize(
           proto.mutable_int64_data(),
           uniq_ptr.get());
       break;
-    case TensorProto_DataType_FLOAT16: {
-      if (FLAGS_caffe2_serialize_fp16_as_bytes) {
-        const int kValue = 1;
-        CAFFE_ENFORCE_EQ(
-            reinterpret_cast<const char*>(&kValue)[0],
-            1,
-            "Serialization of FLOAT16 on big endian platform "
-            "is not written yet.");
-        unique_ptr<char[]> buffer(new char[2 * chunkSize]);
-        this->context_->template CopyToCPU<char>(
-            2 * chunkSize,
-            reinterpret_cast<const char*>(
-                input.template data<at::Half>() + chunkBegin),
-            buffer.get());
-        this->context_->FinishDeviceComputation();
-        proto.set_byte_data(buffer.release(), 2 * chunkSize);
-      } else {
-        detail::CopyToProtoWithCast(
-            chunkSize,
-            reinterpret_cast<const uint16_t*>(input.template data<at::Half>()) +
-                chunkBegin,
-            proto.mutable_int32_data(),
-            uniq_ptr.get());
-      }
-    } break;
+    case TensorProto_DataType_FLOAT16:
+      // FLOAT16 in byte_data is handled above
+      detail::CopyToProtoWithCast(
+          chunkSize,
+          reinterpret_cast<const uint16_t*>(input.template data<at::Half>()) +
+              chunkBegin,
+          proto.mutable_int32_data(),
+          uniq_ptr.get());
+      break;
     case TensorProto_DataType_DOUBLE:
       detail::CopyToProtoAsIs(
           chunkSize,
@@ -511,6 +559,20 @@ void TensorDeserializer::DeserializeToTensor(
       tensor->numel());
   auto chunkSize = chunkEnd - chunkBegin;
 
+  if (tensor_proto.has_byte_data() &&
+      IsBytesHolderType(tensor_proto.data_type())) {
+    EnforceLittleEndian();
+    const TypeMeta& meta = DataTypeToTypeMeta(tensor_proto.data_type());
+    auto* data = static_cast<char*>(tensor->raw_mutable_data(meta));
+    detail::CopyFromProtoAsBytes(
+        chunkSize * meta.itemsize(),
+        tensor_proto.byte_data(),
+        data + chunkBegin * meta.itemsize(),
+        context);
+    context->FinishDeviceComputation();
+    return;
+  }
+
   switch (tensor_proto.data_type()) {
     case TensorProto_DataType_FLOAT:
       detail::CopyFromProtoAsIs(
@@ -590,31 +652,15 @@ void TensorDeserializer::DeserializeToTensor(
           context);
       break;
     case TensorProto_DataType_FLOAT16:
-      if (tensor_proto.has_byte_data()) {
-        const int kValue = 1;
-        CAFFE_ENFORCE_EQ(
-            reinterpret_cast<const char*>(&kValue)[0],
-            1,
-            "Serialization of FLOAT16 on big endian platform "
-            "is not written yet.");
-        CAFFE_ENFORCE_EQ(
-            2 * chunkSize,
-            tensor_proto.byte_data().size(),
-            "Incorrect proto field size.");
-        context->template CopyToCPU<at::Half>(
-            chunkSize,
-            reinterpret_cast<const at::Half*>(tensor_proto.byte_data().data()),
-            tensor->template mutable_data<at::Half>() + chunkBegin);
-      } else {
-        // Backward compatibility with models which used int32_data field
-        detail::CopyFromProtoWithCast(
-            chunkSize,
-            tensor_proto.int32_data(),
-            reinterpret_cast<uint16_t*>(
-                tensor->template mutable_data<at::Half>()) +
-                chunkBegin,
-            context);
-      }
+      // FLOAT16 in byte_data is handled above. This is backward compatibility
+      // with models which used int32_data field
+      detail::CopyFromProtoWithCast(
+          chunkSize,
+          tensor_proto.int32_data(),
+          reinterpret_cast<uint16_t*>(
+              tensor->template mutable_data<at::Half>()) +
+              chunkBegin,
+          context);
       break;
     case TensorProto_DataType_DOUBLE:
       detail::CopyFromProtoAsIs(
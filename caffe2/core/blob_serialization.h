@@ -161,10 +161,7 @@ inline void CopyToProtoAsIs(
       sizeof(SrcType) == sizeof(DstType),
       "The source type and dest type cannot be copied as-is. Did "
       "you mean CopyToProtoWithCast?");
-  field->Reserve(size);
-  for (size_t i = 0; i < size; ++i) {
-    field->Add(0);
-  }
+  field->Resize(size, 0);
   context->template CopyToCPU<SrcType>(
       size, src, reinterpret_cast<SrcType*>(field->mutable_data()));
   // Make sure that we finish the copy into the protobuf.
@@ -220,6 +217,32 @@ inline void CopyFromProtoWithCast(
   context->template CopyFromCPU<DstType>(size, buffer.get(), dst);
 }
 
+// Copies `size` bytes into a bytes field as they are laid out in memory,
+// without the per element overhead of repeated fields.
+inline void CopyToProtoAsBytes(
+    const size_t size,
+    const char* src,
+    std::string* bytes,
+    BaseContext* context) {
+  bytes->resize(size);
+  if (size > 0) {
+    context->template CopyToCPU<char>(size, src, &(*bytes)[0]);
+    // Make sure that we finish the copy into the protobuf.
+    context->FinishDeviceComputation();
+  }
+}
+
+inline void CopyFromProtoAsBytes(
+    const size_t size,
+    const std::string& bytes,
+    char* dst,
+    BaseContext* context) {
+  CAFFE_ENFORCE_EQ(size, bytes.size(), "Incorrect proto field size.");
+  if (size > 0) {
+    context->template CopyFromCPU<char>(size, bytes.data(), dst);
+  }
+}
+
 }  // namespace detail
 
 ////////////////////////////////////////////////////////////////////////////////
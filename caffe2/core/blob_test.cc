@@ -21,6 +21,7 @@
 C10_DEFINE_int64(caffe2_test_big_tensor_size, 100000000, "");
 C10_DECLARE_int(caffe2_tensor_chunk_size);
 C10_DECLARE_bool(caffe2_serialize_fp16_as_bytes);
+C10_DECLARE_bool(caffe2_serialize_using_bytes_as_holder);
 
 namespace caffe2 {
 using namespace ::caffe2::db;
@@ -667,6 +668,62 @@ TEST_SERIALIZATION_WITH_TYPE(uint8_t, int32_data)
 TEST_SERIALIZATION_WITH_TYPE(uint16_t, int32_data)
 TEST_SERIALIZATION_WITH_TYPE(int64_t, int64_data)
 
+template <typename T>
+void TestSerializationUsingBytes() {
+  const int64_t kSize = 1000;
+  const int kChunkSize = 128;
+  Blob blob;
+  Tensor* tensor = BlobGetMutableTensor(&blob, CPU);
+  tensor->Resize(kSize);
+  for (int i = 0; i < kSize; ++i) {
+    tensor->mutable_data<T>()[i] = static_cast<T>(i % 100);
+  }
+  FLAGS_caffe2_serialize_using_bytes_as_holder = true;
+  std::mutex mutex;
+  std::vector<string> chunks;
+  SerializeBlob(
+      blob,
+      "test",
+      [&](const string&, const string& chunk) {
+        std::lock_guard<std::mutex> guard(mutex);
+        chunks.push_back(chunk);
+      },
+      kChunkSize);
+  FLAGS_caffe2_serialize_using_bytes_as_holder = false;
+  EXPECT_EQ(chunks.size(), (kSize + kChunkSize - 1) / kChunkSize);
+
+  Blob new_blob;
+  for (const auto& chunk : chunks) {
+    BlobProto proto;
+    CHECK(proto.ParseFromString(chunk));
+    const TensorProto& tensor_proto = proto.tensor();
+    EXPECT_EQ(
+        tensor_proto.data_type(), TypeMetaToDataType(TypeMeta::Make<T>()));
+    const auto chunk_numel =
+        tensor_proto.segment().end() - tensor_proto.segment().begin();
+    EXPECT_EQ(tensor_proto.byte_data().size(), chunk_numel * sizeof(T));
+    EXPECT_NO_THROW(DeserializeBlob(proto, &new_blob));
+  }
+  const TensorCPU& new_tensor = new_blob.Get<TensorCPU>();
+  EXPECT_EQ(new_tensor.dim(), 1);
+  EXPECT_EQ(new_tensor.size(0), kSize);
+  for (int i = 0; i < kSize; ++i) {
+    EXPECT_EQ(new_tensor.data<T>()[i], tensor->data<T>()[i]);
+  }
+}
+
+TEST(TensorTest, TensorSerializationUsingBytes) {
+  TestSerializationUsingBytes<bool>();
+  TestSerializationUsingBytes<double>();
+  TestSerializationUsingBytes<float>();
+  TestSerializationUsingBytes<int>();
+  TestSerializationUsingBytes<int8_t>();
+  TestSerializationUsingBytes<int16_t>();
+  TestSerializationUsingBytes<uint8_t>();
+  TestSerializationUsingBytes<uint16_t>();
+  TestSerializationUsingBytes<int64_t>();
+}
+
 TEST(TensorTest, TensorSerialization_CustomType) {
   Blob blob;
   TensorCPU* tensor = BlobGetMutableTensor(&blob, CPU);
@@ -1,9 +1,11 @@
 #include <algorithm>
 #include <atomic>
 #include <cstdlib>
+#include <cstring>
 #include <string>
 #include <unordered_map>
 
+#include <THC/THCCachingHostAllocator.h>
 #include <c10/cuda/CUDACachingAllocator.h>
 #include "cub/util_allocator.cuh"
 
@@ -64,6 +66,11 @@ C10_DEFINE_int(
     caffe2_gpu_memory_report_interval_mb,
     128,
     "The threshold in MB on how frequently to report memory changes");
+C10_DEFINE_bool(
+    caffe2_cuda_pinned_staging,
+    false,
+    "If set, copies from pageable host memory to a GPU go through pinned "
+    "buffers of the caching host allocator, so that they are asynchronous");
 
 namespace at {
 
@@ -95,6 +102,10 @@ void CUDAContext::CopyBytesAsync(
   } else {
     LOG(FATAL) << "shouldn't be called with non-cuda device";
   }
+  if (src_device.type() == DeviceType::CPU) {
+    CopyBytesFromHost(nbytes, src, dst, gpu_id);
+    return;
+  }
   CUDA_ENFORCE(cudaMemcpyAsync(
       dst,
       src,
@@ -119,6 +130,50 @@ void CUDAContext::CopyBytesSync(
   // destructor of context synchronizes
 }
 
+namespace {
+
+// Whether `ptr` is page-locked host memory, which the GPU can copy from
+// without the driver staging it.
+bool IsPinnedHostPointer(const void* ptr) {
+  cudaPointerAttributes attr;
+  cudaError_t err = cudaPointerGetAttributes(&attr, ptr);
+  if (err == cudaErrorInvalidValue) {
+    // pageable memory that is unknown to CUDA; clear the error state as in
+    // GetGPUIDForPointer
+    err = cudaGetLastError();
+    CHECK(err == cudaErrorInvalidValue);
+    return false;
+  }
+  CUDA_ENFORCE(err);
+  return attr.CAFFE2_CUDA_PTRATTR_MEMTYPE == cudaMemoryTypeHost;
+}
+
+} // namespace
+
+void CUDAContext::CopyBytesFromHost(
+    size_t nbytes,
+    const void* src,
+    void* dst,
+    int gpu_id) {
+  auto stream = c10::cuda::getCurrentCUDAStream(gpu_id);
+  if (!FLAGS_caffe2_cuda_pinned_staging || nbytes == 0 ||
+      IsPinnedHostPointer(src)) {
+    CUDA_ENFORCE(cudaMemcpyAsync(
+        dst, src, nbytes, cudaMemcpyDefault, stream.stream()));
+    return;
+  }
+  // A copy from pageable memory makes the host wait until everything queued
+  // on the stream before it ran. Copying into a pinned buffer instead only
+  // costs a memcpy, and the GPU reads the buffer once the stream gets there.
+  auto staging = getTHCCachingHostAllocator()->allocate(nbytes);
+  memcpy(staging.get(), src, nbytes);
+  CUDA_ENFORCE(cudaMemcpyAsync(
+      dst, staging.get(), nbytes, cudaMemcpyHostToDevice, stream.stream()));
+  // The buffer goes back to the allocator when `staging` goes out of scope,
+  // but is only reused once the copy on `stream` finished.
+  CUDA_ENFORCE(THCCachingHostAllocator_recordEvent(staging.get(), stream));
+}
+
 // For the CPU context, we also allow a (probably expensive) function
 // to copy the data from a cuda context. Inside the function, we create
 // a temporary CUDAContext object to carry out the copy. From the caller's
@@ -3,6 +3,7 @@
 
 #include <ctime>
 #include <mutex>
+#include <type_traits>
 
 #include "caffe2/core/common.h"
 #include "caffe2/core/common_gpu.h"
@@ -261,6 +262,11 @@ class CAFFE2_CUDA_API CUDAContext final : public BaseContext {
 
   template <class SrcContext, class DstContext>
   inline void CopyBytes(size_t nbytes, const void* src, void* dst) {
+    if (std::is_same<SrcContext, CPUContext>::value &&
+        std::is_same<DstContext, CUDAContext>::value) {
+      CopyBytesFromHost(nbytes, src, dst, gpu_id_);
+      return;
+    }
     CUDA_ENFORCE(cudaMemcpyAsync(
         dst,
         src,
@@ -308,6 +314,14 @@ class CAFFE2_CUDA_API CUDAContext final : public BaseContext {
       void* dst,
       Device dst_device);
 
+  // Copies from host memory to GPU `gpu_id` on its current stream. With
+  // --caffe2_cuda_pinned_staging, pageable memory is first copied into a
+  // pinned buffer of the caching host allocator (shared with ATen), so that
+  // the copy is asynchronous and the host does not wait for the stream to
+  // finish the work queued before it.
+  static void
+  CopyBytesFromHost(size_t nbytes, const void* src, void* dst, int gpu_id);
+
   // By default CUDA operators have async device parts
   static bool HasAsyncPartDefault() {
     return true;
@@ -1,12 +1,16 @@
+#include <algorithm>
 #include <chrono>
 #include <future>
 #include <random>
 #include <thread>
 #include <array>
+#include <vector>
 
 #include "caffe2/core/context_gpu.h"
 #include <gtest/gtest.h>
 
+C10_DECLARE_bool(caffe2_cuda_pinned_staging);
+
 namespace caffe2 {
 
 TEST(CUDATest, HasCudaRuntime) {
@@ -158,4 +162,30 @@ TEST(CUDAContextTest, TestDifferntThreadDifferentobject) {
   EXPECT_NE(temp[0], temp[1]);
 }
 
+TEST(CUDAContextTest, CopyFromPageableMemoryWithPinnedStaging) {
+  if (!HasCudaGPU()) return;
+  FLAGS_caffe2_cuda_pinned_staging = true;
+  const int n = 1 << 16;
+  std::vector<float> src(n);
+  for (int i = 0; i < n; ++i) {
+    src[i] = i;
+  }
+  std::vector<float> dst(n);
+  {
+    CUDAContext context(0);
+    context.SwitchToDevice();
+    auto data = CUDAContext::New(n * sizeof(float));
+    auto* gpu = static_cast<float*>(data.get());
+    context.CopyFromCPU<float>(n, src.data(), gpu);
+    // the staged copy must not read the source after it returned
+    std::fill(src.begin(), src.end(), -1.f);
+    context.CopyToCPU<float>(n, gpu, dst.data());
+    context.FinishDeviceComputation();
+  }
+  FLAGS_caffe2_cuda_pinned_staging = false;
+  for (int i = 0; i < n; ++i) {
+    EXPECT_EQ(dst[i], i);
+  }
+}
+
 }  // namespace caffe2
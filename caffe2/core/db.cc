@@ -1,5 +1,6 @@
 #include "caffe2/core/db.h"
 
+#include <algorithm>
 #include <mutex>
 
 #include "caffe2/core/blob_serialization.h"
@@ -171,6 +172,125 @@ class MiniDB : public DB {
 REGISTER_CAFFE2_DB(MiniDB, MiniDB);
 REGISTER_CAFFE2_DB(minidb, MiniDB);
 
+DBReaderPrefetcher::DBReaderPrefetcher(size_t capacity) : capacity_(capacity) {
+  CAFFE_ENFORCE_GT(capacity_, 0);
+}
+
+DBReaderPrefetcher::~DBReaderPrefetcher() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stopped_ = true;
+  }
+  not_full_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void DBReaderPrefetcher::AddProducer(
+    std::function<void(string*, string*)> read) {
+  threads_.emplace_back([this, read]() { Produce(read); });
+}
+
+void DBReaderPrefetcher::Produce(
+    const std::function<void(string*, string*)>& read) {
+  string key, value;
+  while (true) {
+    try {
+      read(&key, &value);
+    } catch (...) {
+      std::lock_guard<std::mutex> guard(mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+      not_empty_.notify_all();
+      return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(
+        lock, [this]() { return stopped_ || records_.size() < capacity_; });
+    if (stopped_) {
+      return;
+    }
+    records_.emplace_back(std::move(key), std::move(value));
+    not_empty_.notify_one();
+  }
+}
+
+void DBReaderPrefetcher::Pop(string* key, string* value) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_empty_.wait(lock, [this]() { return !records_.empty() || error_; });
+  if (records_.empty()) {
+    std::rethrow_exception(error_);
+  }
+  *key = std::move(records_.front().first);
+  *value = std::move(records_.front().second);
+  records_.pop_front();
+  not_full_.notify_one();
+}
+
+void DBReader::StartPrefetching(int num_cursors, int buffer_size) {
+  CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
+  CAFFE_ENFORCE_GT(num_cursors, 0);
+  prefetcher_.reset();
+  auto prefetcher = make_unique<DBReaderPrefetcher>(buffer_size);
+
+  if (num_cursors == 1 || num_shards_ > 1 || !cursor_->SupportsSeek()) {
+    prefetcher->AddProducer(
+        [this](string* key, string* value) { ReadFromCursor(key, value); });
+    prefetcher_ = std::move(prefetcher);
+    return;
+  }
+
+  // Split the keys into ranges of about the same number of records, given by
+  // their first key and their number of records.
+  auto scan = db_->NewCursor();
+  int64_t num_records = 0;
+  for (scan->SeekToFirst(); scan->Valid(); scan->Next()) {
+    ++num_records;
+  }
+  CAFFE_ENFORCE_GT(num_records, 0, "Cannot prefetch from an empty db");
+  const int64_t num_ranges = std::min<int64_t>(num_cursors, num_records);
+  vector<string> first_keys;
+  int64_t index = 0;
+  for (scan->SeekToFirst(); scan->Valid(); scan->Next(), ++index) {
+    const int64_t range = first_keys.size();
+    if (range == num_ranges) {
+      break;
+    }
+    if (index == range * num_records / num_ranges) {
+      first_keys.push_back(scan->key());
+    }
+  }
+  scan.reset();
+
+  for (int64_t range = 0; range < num_ranges; ++range) {
+    const string first_key = first_keys[range];
+    const int64_t size = (range + 1) * num_records / num_ranges -
+        range * num_records / num_ranges;
+    std::shared_ptr<Cursor> cursor(db_->NewCursor());
+    cursor->Seek(first_key);
+    int64_t remaining = size;
+    // Each cursor loops over its own range.
+    prefetcher->AddProducer(
+        [cursor, first_key, size, remaining](
+            string* key, string* value) mutable {
+          CAFFE_ENFORCE(cursor->Valid(), "Db changed while prefetching");
+          *key = cursor->key();
+          *value = cursor->value();
+          if (--remaining == 0) {
+            cursor->Seek(first_key);
+            remaining = size;
+          } else {
+            cursor->Next();
+          }
+        });
+  }
+  VLOG(1) << "Prefetching " << num_records << " records in " << num_ranges
+          << " key ranges";
+  prefetcher_ = std::move(prefetcher);
+}
+
 void DBReaderSerializer::Serialize(
     const void* pointer,
     TypeMeta typeMeta,
@@ -182,7 +302,9 @@ void DBReaderSerializer::Serialize(
   proto.set_name(name);
   proto.set_source(reader.source_);
   proto.set_db_type(reader.db_type_);
-  if (reader.cursor() && reader.cursor()->SupportsSeek()) {
+  // The position of a prefetching reader is not that of its cursor.
+  if (!reader.prefetching() && reader.cursor() &&
+      reader.cursor()->SupportsSeek()) {
     proto.set_key(reader.cursor()->key());
   }
   BlobProto blob_proto;
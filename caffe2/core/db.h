@@ -1,7 +1,14 @@
 #ifndef CAFFE2_CORE_DB_H_
 #define CAFFE2_CORE_DB_H_
 
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "c10/util/Registry.h"
 #include "caffe2/core/blob_serialization.h"
@@ -138,6 +145,39 @@ inline bool DBExists(const string& db_type, const string& full_db_name) {
   }
 }
 
+/**
+ * Reads records on background threads into a bounded buffer. Each producer is
+ * a function that reads the next record; it runs on its own thread until the
+ * prefetcher is destroyed. Used by DBReader::StartPrefetching().
+ */
+class CAFFE2_API DBReaderPrefetcher {
+ public:
+  explicit DBReaderPrefetcher(size_t capacity);
+  ~DBReaderPrefetcher();
+
+  void AddProducer(std::function<void(string*, string*)> read);
+
+  /**
+   * Takes the oldest buffered record, waiting for one if the buffer is empty.
+   * Rethrows the error of a producer once the buffer is drained.
+   */
+  void Pop(string* key, string* value);
+
+ private:
+  void Produce(const std::function<void(string*, string*)>& read);
+
+  const size_t capacity_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<std::pair<string, string>> records_;
+  bool stopped_ = false;
+  std::exception_ptr error_;
+  std::vector<std::thread> threads_;
+
+  C10_DISABLE_COPY_AND_ASSIGN(DBReaderPrefetcher);
+};
+
 /**
  * A reader wrapper for DB that also allows us to serialize it.
  */
@@ -182,6 +222,7 @@ class CAFFE2_API DBReader {
       const int32_t shard_id = 0) {
     // Note(jiayq): resetting is needed when we re-open e.g. leveldb where no
     // concurrent access is allowed.
+    prefetcher_.reset();
     cursor_.reset();
     db_.reset();
     db_type_ = db_type;
@@ -201,6 +242,7 @@ class CAFFE2_API DBReader {
       unique_ptr<DB>&& db,
       const int32_t num_shards = 1,
       const int32_t shard_id = 0) {
+    prefetcher_.reset();
     cursor_.reset();
     db_.reset();
     db_ = std::move(db);
@@ -224,21 +266,35 @@ class CAFFE2_API DBReader {
    * bit: the state of the cursor is actually changed. However, this allows
    * us to pass in a DBReader to an Operator without the need of a duplicated
    * output blob.
+   *
+   * When prefetching, the record is taken from the prefetch buffer instead.
    */
   void Read(string* key, string* value) const {
-    CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
-    std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
-    *key = cursor_->key();
-    *value = cursor_->value();
-
-    // In sharded mode, each read skips num_shards_ records
-    for (uint32_t s = 0; s < num_shards_; s++) {
-      cursor_->Next();
-      if (!cursor_->Valid()) {
-        MoveToBeginning();
-        break;
-      }
+    if (prefetcher_) {
+      prefetcher_->Pop(key, value);
+      return;
     }
+    ReadFromCursor(key, value);
+  }
+
+  /**
+   * Starts reading records on background threads into a buffer of up to
+   * `buffer_size` records, from which Read() then takes them.
+   *
+   * With `num_cursors` > 1, if the db supports seeking and the reader is not
+   * sharded, the keys are split into `num_cursors` contiguous ranges of about
+   * the same number of records, each read sequentially by its own cursor and
+   * thread. This costs two passes over the keys when prefetching starts, and
+   * Read() then returns the records of the ranges interleaved, so records are
+   * no longer returned in key order. Otherwise, one thread reads the records
+   * in order, as Read() would.
+   *
+   * The cursor must not be used directly while prefetching.
+   */
+  void StartPrefetching(int num_cursors, int buffer_size);
+
+  bool prefetching() const {
+    return prefetcher_ != nullptr;
   }
 
   /**
@@ -274,6 +330,22 @@ class CAFFE2_API DBReader {
     SeekToFirst();
   }
 
+  void ReadFromCursor(string* key, string* value) const {
+    CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
+    std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
+    *key = cursor_->key();
+    *value = cursor_->value();
+
+    // In sharded mode, each read skips num_shards_ records
+    for (uint32_t s = 0; s < num_shards_; s++) {
+      cursor_->Next();
+      if (!cursor_->Valid()) {
+        MoveToBeginning();
+        break;
+      }
+    }
+  }
+
   void MoveToBeginning() const {
     cursor_->SeekToFirst();
     for (uint32_t s = 0; s < shard_id_; s++) {
@@ -290,6 +362,8 @@ class CAFFE2_API DBReader {
   mutable std::mutex reader_mutex_;
   uint32_t num_shards_{};
   uint32_t shard_id_{};
+  // Declared last so that its threads stop before the cursor and db go away.
+  unique_ptr<DBReaderPrefetcher> prefetcher_;
 
   C10_DISABLE_COPY_AND_ASSIGN(DBReader);
 };
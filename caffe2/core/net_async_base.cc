@@ -56,6 +56,11 @@ C10_DEFINE_bool(
     false,
     "Run root tasks in current thread instread of scheduling to threadpool");
 
+C10_DEFINE_bool(
+    caffe2_net_async_use_work_stealing,
+    false,
+    "Use work-stealing CPU thread pools and run a child task inline");
+
 namespace caffe2 {
 
 std::vector<int>& AsyncNetBase::getStreamCounters() {
@@ -157,7 +162,9 @@ TaskThreadPoolBase* AsyncNetBase::poolGetter(
   auto pool = pools[device_id][pool_size];
   if (!pool) {
     pool = c10::ThreadPoolRegistry()->Create(
-        DeviceTypeName(device_type),
+        options_.use_work_stealing_ && device_type == PROTO_CPU
+            ? "CPUWorkStealing"
+            : DeviceTypeName(device_type),
         device_id,
         pool_size,
         options_.use_per_net_pools_);
@@ -579,6 +586,7 @@ ExecutionOptions::ExecutionOptions(
     use_per_net_pools_ = FLAGS_caffe2_net_async_use_per_net_pools;
     is_blocking_ = false;
     report_stats_ = false;
+    use_work_stealing_ = FLAGS_caffe2_net_async_use_work_stealing;
   }
 
   use_dfs_scheduling_ = false;
@@ -593,6 +601,10 @@ ExecutionOptions::ExecutionOptions(
       CAFFE_ENFORCE(arg.has_i(), "deferrable_mode should be an int");
       use_dfs_scheduling_ = arg.i() == 1; // corr. to DFS scheduling
     }
+    if (arg.has_name() && arg.name() == "work_stealing") {
+      CAFFE_ENFORCE(arg.has_i(), "work_stealing should be an int");
+      use_work_stealing_ = arg.i() == 1;
+    }
   }
 
   if (FLAGS_caffe2_net_async_profile_operators) {
@@ -609,6 +621,12 @@ C10_REGISTER_CREATOR(
     ThreadPoolRegistry,
     CPU,
     caffe2::GetAsyncNetThreadPool<TaskThreadPool, caffe2::PROTO_CPU>);
+C10_REGISTER_CREATOR(
+    ThreadPoolRegistry,
+    CPUWorkStealing,
+    caffe2::GetAsyncNetThreadPool<
+        WorkStealingTaskThreadPool,
+        caffe2::PROTO_CPU>);
 C10_REGISTER_CREATOR(
     ThreadPoolRegistry,
     CUDA,
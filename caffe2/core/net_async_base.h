@@ -24,6 +24,7 @@ C10_DECLARE_bool(caffe2_net_async_use_single_pool);
 C10_DECLARE_bool(caffe2_net_async_use_per_net_pools);
 C10_DECLARE_bool(caffe2_net_async_run_root_tasks_inline);
 C10_DECLARE_bool(caffe2_net_async_profile_operators);
+C10_DECLARE_bool(caffe2_net_async_use_work_stealing);
 
 namespace caffe2 {
 
@@ -55,6 +56,9 @@ struct ExecutionOptions {
   bool use_dfs_scheduling_ = false;
   // run net's root tasks in RunAsync thread instead of in thread pool
   bool run_root_tasks_inline_ = false;
+  // run CPU tasks in a pool with per-thread task deques and work stealing,
+  // and continue a task's chain with one of its children on the same thread
+  bool use_work_stealing_ = false;
 };
 
 class CAFFE2_API AsyncNetBase : public NetBase {
@@ -4,6 +4,13 @@
 
 namespace caffe2 {
 
+namespace {
+// Depth of the tasks run inline on the current thread, bounded so that long
+// chains of inline tasks do not overflow the stack
+thread_local int inline_depth = 0;
+constexpr int kMaxInlineDepth = 64;
+} // namespace
+
 AsyncSchedulingNet::AsyncSchedulingNet(
     const std::shared_ptr<const NetDef>& net_def,
     Workspace* ws)
@@ -22,7 +29,7 @@ void AsyncSchedulingNet::Wait() {
 }
 
 bool AsyncSchedulingNet::isInlineTask(int parent_id, int child_id) const {
-  if (!options_.use_dfs_scheduling_) {
+  if (!options_.use_dfs_scheduling_ && !options_.use_work_stealing_) {
     return false;
   }
   const auto* last_parent_op = lastTaskOp(parent_id);
@@ -39,7 +46,10 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
   if (!testAndSetScheduled(task_id)) {
     return;
   }
-  auto schedule_func = [this, task_id]() {
+  // time when the task became ready, to report its latency
+  const long ready_us =
+      tracer_ && tracer_->isEnabled() ? tracer_->timestamp() : -1;
+  auto schedule_func = [this, task_id, ready_us]() {
     try {
       if (success_) {
         int stream_id = 0;
@@ -51,9 +61,14 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
                 << "Failed to select a stream: " << e.what();
           }
         }
+        const long start_us = ready_us >= 0 ? tracer_->timestamp() : -1;
         if (!run(task_id, stream_id)) {
           success_ = false;
         }
+        if (start_us >= 0) {
+          tracer_->recordTaskLatency(
+              start_us - ready_us, tracer_->timestamp() - start_us);
+        }
       }
 
       if (options_.report_stats_) {
@@ -72,6 +87,21 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
         }
       }
 
+      // With work stealing, only one child continues on this thread, after
+      // the others were pushed to the pool, where idle threads can steal them
+      int continuation_id = -1;
+      auto schedule_child = [this, task_id, &continuation_id](int child_id) {
+        bool run_inline = isInlineTask(task_id, child_id);
+        if (run_inline && !options_.use_dfs_scheduling_) {
+          if (continuation_id < 0) {
+            continuation_id = child_id;
+            return;
+          }
+          run_inline = false;
+        }
+        schedule(child_id, run_inline);
+      };
+
       for (auto child_id : children(task_id)) {
         int parent_count = updateParentCount(child_id);
         if (parent_count == 0) {
@@ -85,7 +115,7 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
               options_.finish_chain_ || canSchedule(child_id)) {
             // if DFS scheduling is enabled, run children inline,
             // ignore DFS scheduling in callbacks
-            schedule(child_id, isInlineTask(task_id, child_id));
+            schedule_child(child_id);
           } else {
             bool parent_failed = false;
             bool parent_needs_polling = false;
@@ -123,7 +153,7 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
             if (parent_failed) {
               // one of parents failed, set failure flag and wrap up execution
               success_ = false;
-              schedule(child_id, isInlineTask(task_id, child_id));
+              schedule_child(child_id);
             } else if (parent_needs_polling) {
               // some parents are blocking us from scheduling a child and don't
               // support callbacks, using polling
@@ -141,12 +171,16 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
               }
             } else {
               // we're ready to schedule a child
-              schedule(child_id, isInlineTask(task_id, child_id));
+              schedule_child(child_id);
             }
           }
         }
       }
 
+      if (continuation_id >= 0) {
+        schedule(continuation_id, /* run_inline */ true);
+      }
+
       // In case of net's failure, make sure all pending tasks are finished
       if (!success_) {
         CancelAndFinishAsyncTasks();
@@ -170,8 +204,10 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
     }
   };
 
-  if (run_inline) {
+  if (run_inline && inline_depth < kMaxInlineDepth) {
+    ++inline_depth;
     schedule_func();
+    --inline_depth;
   } else {
     const auto& device_option = event(task_id).GetDeviceOption();
     pool(device_option)->run(schedule_func);
@@ -73,6 +73,55 @@ void Tracer::recordEvent(const TracerEvent& event) {
   events_.push_back(event);
 }
 
+long Tracer::timestamp() {
+  return (long)caffe2::round(timer_.MicroSeconds());
+}
+
+void Tracer::recordTaskLatency(long wait_us, long run_us) {
+  std::lock_guard<std::mutex> lock(tracer_mutex_);
+  task_wait_us_.push_back(wait_us);
+  task_run_us_.push_back(run_us);
+}
+
+namespace {
+
+TaskLatencyPercentiles computePercentiles(std::vector<long> latencies) {
+  TaskLatencyPercentiles percentiles;
+  percentiles.num_tasks = latencies.size();
+  if (latencies.empty()) {
+    return percentiles;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  auto at = [&latencies](double q) {
+    return latencies[static_cast<size_t>(q * (latencies.size() - 1))];
+  };
+  percentiles.p50_us = at(0.5);
+  percentiles.p90_us = at(0.9);
+  percentiles.p99_us = at(0.99);
+  percentiles.max_us = latencies.back();
+  return percentiles;
+}
+
+std::string formatPercentiles(const TaskLatencyPercentiles& percentiles) {
+  std::stringstream formatted;
+  formatted << "p50 " << percentiles.p50_us << "us, p90 "
+            << percentiles.p90_us << "us, p99 " << percentiles.p99_us
+            << "us, max " << percentiles.max_us << "us";
+  return formatted.str();
+}
+
+} // namespace
+
+TaskLatencyPercentiles Tracer::taskWaitPercentiles() {
+  std::lock_guard<std::mutex> lock(tracer_mutex_);
+  return computePercentiles(task_wait_us_);
+}
+
+TaskLatencyPercentiles Tracer::taskRunPercentiles() {
+  std::lock_guard<std::mutex> lock(tracer_mutex_);
+  return computePercentiles(task_run_us_);
+}
+
 // Forward
 int getUniqueShardId(const OperatorDef& op_def);
 
@@ -271,6 +320,15 @@ int Tracer::bumpDumpingIter() {
 }
 
 void Tracer::dumpTracingResultAndClearEvents(const std::string& file_suffix) {
+  if (!task_wait_us_.empty()) {
+    LOG(INFO) << "Task latencies of " << filename_ << " over "
+              << task_wait_us_.size() << " tasks, waiting to start: "
+              << formatPercentiles(taskWaitPercentiles())
+              << "; running: " << formatPercentiles(taskRunPercentiles());
+    std::lock_guard<std::mutex> lock(tracer_mutex_);
+    task_wait_us_.clear();
+    task_run_us_.clear();
+  }
   if (events_.empty() || filename_.empty()) {
     return;
   }
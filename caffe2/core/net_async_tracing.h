@@ -70,6 +70,15 @@ struct TracingConfig {
   int64_t trace_for_n_ms = 1000; // 1sec
 };
 
+// Percentiles of a set of task latencies, in microseconds.
+struct CAFFE2_API TaskLatencyPercentiles {
+  size_t num_tasks = 0;
+  long p50_us = 0;
+  long p90_us = 0;
+  long p99_us = 0;
+  long max_us = 0;
+};
+
 class CAFFE2_API Tracer {
  public:
   Tracer(
@@ -91,6 +100,13 @@ class CAFFE2_API Tracer {
   int bumpIter();
   int getIter();
   int bumpDumpingIter();
+  // Microseconds since the tracer was created
+  long timestamp();
+  // Records how long a task waited to start after it became ready and how
+  // long it ran; percentiles are logged with every dump
+  void recordTaskLatency(long wait_us, long run_us);
+  TaskLatencyPercentiles taskWaitPercentiles();
+  TaskLatencyPercentiles taskRunPercentiles();
   // Dump the tracing result to file with given suffix, and then
   // clear current events.
   void dumpTracingResultAndClearEvents(const std::string& file_suffix);
@@ -101,6 +117,8 @@ class CAFFE2_API Tracer {
   const NetBase* net_ = nullptr;
   std::string filename_;
   std::vector<TracerEvent> events_;
+  std::vector<long> task_wait_us_;
+  std::vector<long> task_run_us_;
   std::mutex tracer_mutex_;
   bool enabled_ = false;
   Timer timer_;
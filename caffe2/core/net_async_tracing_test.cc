@@ -109,6 +109,25 @@ TEST(NetAsyncTracingTest, GlobalTimeSlice) {
   net->Run();
 }
 
+TEST(NetAsyncTracingTest, TaskLatencyPercentiles) {
+  Tracer tracer(nullptr, "task_latency_test");
+  for (long us = 1; us <= 100; ++us) {
+    tracer.recordTaskLatency(us, 2 * us);
+  }
+  const auto wait = tracer.taskWaitPercentiles();
+  EXPECT_EQ(wait.num_tasks, 100);
+  EXPECT_EQ(wait.p50_us, 50);
+  EXPECT_EQ(wait.p90_us, 90);
+  EXPECT_EQ(wait.p99_us, 99);
+  EXPECT_EQ(wait.max_us, 100);
+  const auto run = tracer.taskRunPercentiles();
+  EXPECT_EQ(run.p50_us, 100);
+  EXPECT_EQ(run.max_us, 200);
+
+  tracer.dumpTracingResultAndClearEvents("0");
+  EXPECT_EQ(tracer.taskWaitPercentiles().num_tasks, 0);
+}
+
 } // namespace tracing
 
 } // namespace caffe2
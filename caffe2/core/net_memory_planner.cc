@@ -0,0 +1,271 @@
+#include "caffe2/core/net_memory_planner.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "c10/core/CPUAllocator.h"
+#include "caffe2/core/tensor.h"
+#include "caffe2/utils/proto_utils.h"
+
+C10_DEFINE_bool(
+    caffe2_net_memory_planning,
+    false,
+    "If set, simple nets lay out their intermediate tensors in one arena "
+    "planned after their first run. Intermediates that are not external "
+    "outputs are overwritten later in the run, so fetching them after a run "
+    "returns garbage");
+
+namespace caffe2 {
+
+namespace {
+
+constexpr size_t kArenaAlignment = 64;
+
+size_t align(size_t offset) {
+  return (offset + kArenaAlignment - 1) / kArenaAlignment * kArenaAlignment;
+}
+
+// The tensors pointed into the arena share its ownership, so that it outlives
+// them even if the net is destroyed first.
+void deleteArenaRef(void* ctx) {
+  delete static_cast<std::shared_ptr<at::DataPtr>*>(ctx);
+}
+
+} // namespace
+
+NetMemoryPlanner::NetMemoryPlanner(const NetDef& net_def, Workspace* ws)
+    : op_outputs_(net_def.op_size()),
+      op_input_blobs_(net_def.op_size()),
+      op_output_blobs_(net_def.op_size()) {
+  const std::unordered_set<std::string> external(
+      net_def.external_input().begin(), net_def.external_input().end());
+  const std::unordered_set<std::string> external_outputs(
+      net_def.external_output().begin(), net_def.external_output().end());
+
+  std::unordered_map<std::string, int> indices;
+  std::unordered_set<std::string> consumed;
+  for (int idx = 0; idx < net_def.op_size(); ++idx) {
+    const auto& op_def = net_def.op(idx);
+    for (const auto& name : op_def.input()) {
+      auto it = indices.find(name);
+      if (it == indices.end()) {
+        // consumed before it is produced, so its value comes from outside
+        indices.emplace(name, -1);
+      } else if (it->second >= 0) {
+        intermediates_[it->second].last_op = idx;
+      }
+      op_input_blobs_[idx].push_back({ws->GetBlob(name), indices[name]});
+      consumed.insert(name);
+    }
+    for (const auto& name : op_def.output()) {
+      auto it = indices.find(name);
+      if (it == indices.end()) {
+        if (external.count(name) || external_outputs.count(name)) {
+          indices.emplace(name, -1);
+          op_output_blobs_[idx].push_back({ws->GetBlob(name), -1});
+          continue;
+        }
+        Intermediate intermediate;
+        intermediate.name = name;
+        intermediate.blob = ws->GetBlob(name);
+        intermediate.first_op = idx;
+        intermediate.last_op = idx;
+        intermediate.plannable = intermediate.blob != nullptr;
+        it = indices.emplace(name, intermediates_.size()).first;
+        intermediates_.push_back(std::move(intermediate));
+      }
+      op_output_blobs_[idx].push_back({ws->GetBlob(name), it->second});
+      if (it->second < 0) {
+        continue;
+      }
+      intermediates_[it->second].last_op = idx;
+      op_outputs_[idx].push_back(it->second);
+    }
+  }
+  // produced but never consumed blobs are results the user may read
+  for (auto& intermediate : intermediates_) {
+    if (!consumed.count(intermediate.name)) {
+      intermediate.plannable = false;
+    }
+  }
+}
+
+bool NetMemoryPlanner::IsEnabled(const NetDef& net_def) {
+  return GetFlagArgument(
+      net_def, "enable_memory_planning", FLAGS_caffe2_net_memory_planning);
+}
+
+void NetMemoryPlanner::StartRun() {
+  if (!planned_ || !arena_) {
+    return;
+  }
+  auto* arena = static_cast<char*>(arena_->get());
+  for (auto idx : planned_intermediates_) {
+    const auto& intermediate = intermediates_[idx];
+    const auto* tensor = BlobGetMutableTensor(intermediate.blob, CPU);
+    if (tensor->storage_initialized() && tensor->dtype() == intermediate.meta &&
+        tensor->sizes() == intermediate.sizes &&
+        tensor->raw_data() == arena + intermediate.offset) {
+      continue;
+    }
+    install(intermediate);
+  }
+}
+
+void NetMemoryPlanner::OpFinished(int op_idx) {
+  if (planned_) {
+    return;
+  }
+  excludeAliases(op_idx);
+  for (auto idx : op_outputs_[op_idx]) {
+    auto& intermediate = intermediates_[idx];
+    if (!intermediate.plannable) {
+      continue;
+    }
+    if (!BlobIsTensorType(*intermediate.blob, CPU)) {
+      intermediate.plannable = false;
+      continue;
+    }
+    const auto& tensor = intermediate.blob->Get<Tensor>();
+    if (!tensor.dtype_initialized() || tensor.numel() == 0) {
+      continue;
+    }
+    if (tensor.dtype().placementNew()) {
+      // types with constructors cannot share memory
+      intermediate.plannable = false;
+      continue;
+    }
+    if (tensor.nbytes() >= intermediate.nbytes) {
+      intermediate.meta = tensor.dtype();
+      intermediate.sizes = tensor.sizes().vec();
+      intermediate.nbytes = tensor.nbytes();
+    }
+  }
+}
+
+void NetMemoryPlanner::excludeAliases(int op_idx) {
+  const auto memory = [](const OpBlob& op_blob) -> const Tensor* {
+    if (op_blob.blob == nullptr || !BlobIsTensorType(*op_blob.blob, CPU)) {
+      return nullptr;
+    }
+    const auto& tensor = op_blob.blob->Get<Tensor>();
+    if (!tensor.storage_initialized() || tensor.nbytes() == 0) {
+      return nullptr;
+    }
+    return &tensor;
+  };
+  for (const auto& output : op_output_blobs_[op_idx]) {
+    const auto* out = memory(output);
+    if (out == nullptr) {
+      continue;
+    }
+    const auto* out_begin = static_cast<const char*>(out->raw_data());
+    for (const auto& input : op_input_blobs_[op_idx]) {
+      // In-place outputs have the name of their input, so their lifetime
+      // already covers both.
+      const auto* in = input.blob != output.blob ? memory(input) : nullptr;
+      if (in == nullptr) {
+        continue;
+      }
+      const auto* in_begin = static_cast<const char*>(in->raw_data());
+      if (out_begin < in_begin + in->nbytes() &&
+          in_begin < out_begin + out->nbytes()) {
+        if (output.intermediate >= 0) {
+          intermediates_[output.intermediate].plannable = false;
+        }
+        if (input.intermediate >= 0) {
+          intermediates_[input.intermediate].plannable = false;
+        }
+      }
+    }
+  }
+}
+
+void NetMemoryPlanner::FinishRun() {
+  if (planned_) {
+    return;
+  }
+  plan();
+  StartRun();
+}
+
+bool NetMemoryPlanner::IsPlanned(const Blob* blob) const {
+  for (auto idx : planned_intermediates_) {
+    if (intermediates_[idx].blob == blob) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t NetMemoryPlanner::planned_bytes() const {
+  size_t bytes = 0;
+  for (auto idx : planned_intermediates_) {
+    bytes += intermediates_[idx].nbytes;
+  }
+  return bytes;
+}
+
+void NetMemoryPlanner::plan() {
+  planned_ = true;
+  std::vector<int> candidates;
+  for (int idx = 0; idx < intermediates_.size(); ++idx) {
+    const auto& intermediate = intermediates_[idx];
+    if (intermediate.plannable && intermediate.nbytes > 0) {
+      candidates.push_back(idx);
+    }
+  }
+  // Placing the largest intermediates first leaves the smaller ones to fill
+  // the gaps between them.
+  std::stable_sort(candidates.begin(), candidates.end(), [this](int a, int b) {
+    return intermediates_[a].nbytes > intermediates_[b].nbytes;
+  });
+
+  for (auto idx : candidates) {
+    auto& intermediate = intermediates_[idx];
+    std::vector<std::pair<size_t, size_t>> busy;
+    for (auto other_idx : planned_intermediates_) {
+      const auto& other = intermediates_[other_idx];
+      if (other.last_op >= intermediate.first_op &&
+          other.first_op <= intermediate.last_op) {
+        busy.emplace_back(other.offset, other.offset + other.nbytes);
+      }
+    }
+    std::sort(busy.begin(), busy.end());
+    size_t offset = 0;
+    for (const auto& range : busy) {
+      if (offset + intermediate.nbytes <= range.first) {
+        break;
+      }
+      offset = std::max(offset, align(range.second));
+    }
+    intermediate.offset = offset;
+    arena_bytes_ = std::max(arena_bytes_, offset + intermediate.nbytes);
+    planned_intermediates_.push_back(idx);
+  }
+
+  if (arena_bytes_ > 0) {
+    arena_ = std::make_shared<at::DataPtr>(
+        GetCPUAllocator()->allocate(arena_bytes_));
+  }
+  VLOG(1) << "NetMemoryPlanner: planned " << planned_intermediates_.size()
+          << " intermediates of " << planned_bytes() << " bytes in an arena of "
+          << arena_bytes_ << " bytes";
+}
+
+void NetMemoryPlanner::install(const Intermediate& intermediate) {
+  auto* data = static_cast<char*>(arena_->get()) + intermediate.offset;
+  auto* tensor = BlobGetMutableTensor(intermediate.blob, CPU);
+  tensor->Resize(intermediate.sizes);
+  tensor->ShareExternalPointer(
+      at::DataPtr(
+          data,
+          new std::shared_ptr<at::DataPtr>(arena_),
+          &deleteArenaRef,
+          at::Device(CPU)),
+      intermediate.meta,
+      intermediate.nbytes);
+}
+
+} // namespace caffe2
@@ -0,0 +1,115 @@
+#ifndef CAFFE2_CORE_NET_MEMORY_PLANNER_H_
+#define CAFFE2_CORE_NET_MEMORY_PLANNER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "c10/util/Flags.h"
+#include "caffe2/core/blob.h"
+#include "caffe2/core/common.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/proto/caffe2_pb.h"
+
+C10_DECLARE_bool(caffe2_net_memory_planning);
+
+namespace caffe2 {
+
+// NetMemoryPlanner lays out the intermediate tensors of a net that runs its
+// operators in order (SimpleNet and SimpleRefCountNet) in one preallocated
+// arena. Intermediates are the blobs that are produced by an op before any op
+// consumes them, are later consumed, and are neither external inputs nor
+// external outputs of the net - the same blobs SimpleRefCountNet considers
+// temporary.
+//
+// The first run is a profiling run: after each op, the planner records the
+// size and type of the CPU tensors it produced. After that run, each
+// intermediate is assigned an offset in the arena, such that intermediates
+// whose lifetimes (first producer to last consumer) overlap never share
+// memory, and all of them are pointed into the arena. As long as the inputs
+// keep the shapes of the profiling run, later runs do not allocate: ops find
+// outputs that already have their shape and type.
+//
+// If an op needs a larger output, it is reallocated as usual, and it is
+// pointed back into the arena before the next run. Like with memonger, ops
+// must not depend on the previous contents of their outputs, and the
+// contents of intermediates are not meaningful after their last consumer
+// ran, even though they can still be fetched from the workspace.
+//
+// Lifetimes are tracked by blob name, so an op output that shares memory
+// with one of the op's inputs (e.g. Alias) would keep reading memory that
+// the planner considers free. The profiling run detects such outputs, and
+// neither they nor the inputs they alias are planned.
+//
+// Enabled by the net argument "enable_memory_planning" or the
+// --caffe2_net_memory_planning flag.
+class CAFFE2_API NetMemoryPlanner {
+ public:
+  NetMemoryPlanner(const NetDef& net_def, Workspace* ws);
+
+  // Whether memory planning is enabled for the net
+  static bool IsEnabled(const NetDef& net_def);
+
+  // Called before each run; once planned, points every intermediate that was
+  // moved out of the arena back into it
+  void StartRun();
+  // Called after op `op_idx` ran; records the intermediates it produced
+  // during the profiling run
+  void OpFinished(int op_idx);
+  // Called after each successful run; plans after the profiling run
+  void FinishRun();
+
+  bool planned() const {
+    return planned_;
+  }
+  // Whether `blob` is an intermediate laid out in the arena
+  bool IsPlanned(const Blob* blob) const;
+
+  // Size of the arena, and the total size of the planned intermediates
+  size_t arena_bytes() const {
+    return arena_bytes_;
+  }
+  size_t planned_bytes() const;
+
+ private:
+  struct OpBlob {
+    const Blob* blob;
+    // Index of the blob in intermediates_, or -1 if it is not an intermediate
+    int intermediate;
+  };
+
+  struct Intermediate {
+    std::string name;
+    Blob* blob = nullptr;
+    int first_op = -1;
+    int last_op = -1;
+    bool plannable = true;
+    TypeMeta meta;
+    std::vector<int64_t> sizes;
+    size_t nbytes = 0;
+    size_t offset = 0;
+  };
+
+  void excludeAliases(int op_idx);
+  void plan();
+  void install(const Intermediate& intermediate);
+
+  std::vector<Intermediate> intermediates_;
+  // Indices of the intermediates each op produces
+  std::vector<std::vector<int>> op_outputs_;
+  // All inputs and outputs of each op, to find outputs that alias inputs
+  std::vector<std::vector<OpBlob>> op_input_blobs_;
+  std::vector<std::vector<OpBlob>> op_output_blobs_;
+  // The intermediates that were given an offset in the arena
+  std::vector<int> planned_intermediates_;
+
+  bool planned_ = false;
+  std::shared_ptr<at::DataPtr> arena_;
+  size_t arena_bytes_ = 0;
+
+  C10_DISABLE_COPY_AND_ASSIGN(NetMemoryPlanner);
+};
+
+} // namespace caffe2
+
+#endif // CAFFE2_CORE_NET_MEMORY_PLANNER_H_
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "caffe2/core/net.h"
+#include "caffe2/core/net_memory_planner.h"
+#include "caffe2/core/operator.h"
+
+namespace caffe2 {
+
+namespace {
+
+class NetMemoryPlannerTestOp final : public Operator<CPUContext> {
+ public:
+  NetMemoryPlannerTestOp(const OperatorDef& operator_def, Workspace* ws)
+      : Operator<CPUContext>(operator_def, ws) {}
+  USE_OPERATOR_FUNCTIONS(CPUContext);
+
+  bool RunOnDevice() override {
+    const auto& input = Input(0);
+    auto* output = Output(0, input.sizes(), at::dtype<float>());
+    const auto* in = input.data<float>();
+    auto* out = output->mutable_data<float>();
+    for (int64_t i = 0; i < input.numel(); ++i) {
+      out[i] = in[i] + 1;
+    }
+    return true;
+  }
+};
+
+REGISTER_CPU_OPERATOR(NetMemoryPlannerTest, NetMemoryPlannerTestOp);
+
+OPERATOR_SCHEMA(NetMemoryPlannerTest).NumInputs(1).NumOutputs(1);
+
+// a -> b -> c -> d -> e, where b, c and d are intermediates
+NetDef chainNet(const std::string& type) {
+  NetDef net_def;
+  net_def.set_type(type);
+  auto* arg = net_def.add_arg();
+  arg->set_name("enable_memory_planning");
+  arg->set_i(1);
+  const std::vector<std::string> names = {"a", "b", "c", "d", "e"};
+  for (size_t i = 0; i + 1 < names.size(); ++i) {
+    net_def.add_op()->CopyFrom(CreateOperatorDef(
+        "NetMemoryPlannerTest", "", {names[i]}, {names[i + 1]}));
+  }
+  net_def.add_external_input("a");
+  net_def.add_external_output("e");
+  return net_def;
+}
+
+void feedInput(Workspace* ws, int64_t size) {
+  auto* a = BlobGetMutableTensor(ws->CreateBlob("a"), CPU);
+  a->Resize(size);
+  auto* data = a->mutable_data<float>();
+  for (int64_t i = 0; i < size; ++i) {
+    data[i] = i;
+  }
+}
+
+void checkOutput(Workspace* ws, int64_t size) {
+  const auto& e = ws->GetBlob("e")->Get<Tensor>();
+  ASSERT_EQ(e.numel(), size);
+  for (int64_t i = 0; i < size; ++i) {
+    EXPECT_EQ(e.data<float>()[i], i + 4);
+  }
+}
+
+const void* data(Workspace* ws, const std::string& name) {
+  return ws->GetBlob(name)->Get<Tensor>().raw_data();
+}
+
+TEST(NetMemoryPlannerTest, SharesMemoryOfDisjointLifetimes) {
+  Workspace ws;
+  feedInput(&ws, 1000);
+  std::unique_ptr<NetBase> net(CreateNet(chainNet("simple"), &ws));
+  ASSERT_TRUE(net->Run());
+  checkOutput(&ws, 1000);
+
+  ASSERT_TRUE(net->Run());
+  checkOutput(&ws, 1000);
+  // b is dead when d is produced, c is not
+  EXPECT_EQ(data(&ws, "b"), data(&ws, "d"));
+  EXPECT_NE(data(&ws, "b"), data(&ws, "c"));
+  const auto* b = data(&ws, "b");
+  const auto* c = data(&ws, "c");
+
+  // Later runs keep the planned layout
+  ASSERT_TRUE(net->Run());
+  checkOutput(&ws, 1000);
+  EXPECT_EQ(data(&ws, "b"), b);
+  EXPECT_EQ(data(&ws, "c"), c);
+}
+
+TEST(NetMemoryPlannerTest, HandlesLargerInputs) {
+  Workspace ws;
+  feedInput(&ws, 10);
+  std::unique_ptr<NetBase> net(CreateNet(chainNet("simple"), &ws));
+  ASSERT_TRUE(net->Run());
+  ASSERT_TRUE(net->Run());
+  feedInput(&ws, 1000);
+  ASSERT_TRUE(net->Run());
+  checkOutput(&ws, 1000);
+  feedInput(&ws, 10);
+  ASSERT_TRUE(net->Run());
+  checkOutput(&ws, 10);
+}
+
+TEST(NetMemoryPlannerTest, DoesNotPlanAliases) {
+  // b -> Alias -> c, and c is read again after d and f were produced. d would
+  // be placed in b's memory, which c still uses, if aliases were planned.
+  NetDef net_def;
+  net_def.set_type("simple");
+  auto* arg = net_def.add_arg();
+  arg->set_name("enable_memory_planning");
+  arg->set_i(1);
+  net_def.add_op()->CopyFrom(
+      CreateOperatorDef("NetMemoryPlannerTest", "", {"a"}, {"b"}));
+  net_def.add_op()->CopyFrom(CreateOperatorDef("Alias", "", {"b"}, {"c"}));
+  net_def.add_op()->CopyFrom(
+      CreateOperatorDef("NetMemoryPlannerTest", "", {"c"}, {"d"}));
+  net_def.add_op()->CopyFrom(
+      CreateOperatorDef("NetMemoryPlannerTest", "", {"d"}, {"f"}));
+  net_def.add_op()->CopyFrom(CreateOperatorDef("Sum", "", {"c", "f"}, {"e"}));
+  net_def.add_external_input("a");
+  net_def.add_external_output("e");
+
+  Workspace ws;
+  feedInput(&ws, 1000);
+  std::unique_ptr<NetBase> net(CreateNet(net_def, &ws));
+  for (int run = 0; run < 3; ++run) {
+    ASSERT_TRUE(net->Run());
+    const auto& e = ws.GetBlob("e")->Get<Tensor>();
+    ASSERT_EQ(e.numel(), 1000);
+    for (int64_t i = 0; i < 1000; ++i) {
+      ASSERT_EQ(e.data<float>()[i], 2 * i + 4);
+    }
+  }
+  EXPECT_EQ(data(&ws, "b"), data(&ws, "c"));
+  const auto* c = data(&ws, "c");
+  ASSERT_TRUE(net->Run());
+  EXPECT_EQ(data(&ws, "c"), c);
+}
+
+TEST(NetMemoryPlannerTest, SimpleRefCountNet) {
+  Workspace ws;
+  feedInput(&ws, 1000);
+  std::unique_ptr<NetBase> net(CreateNet(chainNet("simple_refcount"), &ws));
+  for (int run = 0; run < 3; ++run) {
+    ASSERT_TRUE(net->Run());
+    checkOutput(&ws, 1000);
+  }
+  EXPECT_EQ(data(&ws, "b"), data(&ws, "d"));
+}
+
+} // namespace
+} // namespace caffe2
@@ -49,12 +49,19 @@ SimpleNet::SimpleNet(
     }
     operators_.emplace_back(std::move(op));
   }
+  if (NetMemoryPlanner::IsEnabled(*net_def)) {
+    memory_planner_ = caffe2::make_unique<NetMemoryPlanner>(*net_def, ws);
+  }
 }
 
 bool SimpleNet::Run() {
   StartAllObservers();
   VLOG(1) << "Running net " << name_;
-  for (auto& op : operators_) {
+  if (memory_planner_) {
+    memory_planner_->StartRun();
+  }
+  for (int op_id = 0; op_id < operators_.size(); ++op_id) {
+    auto& op = operators_[op_id];
     VLOG(1) << "Running operator " << op->debug_def().name() << "("
             << op->debug_def().type() << ").";
 #ifdef CAFFE2_ENABLE_SDT
@@ -72,6 +79,12 @@ bool SimpleNet::Run() {
       LOG(ERROR) << "Operator failed: " << ProtoDebugString(op->debug_def());
       return false;
     }
+    if (memory_planner_) {
+      memory_planner_->OpFinished(op_id);
+    }
+  }
+  if (memory_planner_) {
+    memory_planner_->FinishRun();
   }
   StopAllObservers();
   return true;
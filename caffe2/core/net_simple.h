@@ -7,6 +7,7 @@
 #include "caffe2/core/common.h"
 #include "caffe2/core/logging.h"
 #include "caffe2/core/net.h"
+#include "caffe2/core/net_memory_planner.h"
 #include "caffe2/core/tensor.h"
 #include "caffe2/core/workspace.h"
 #include "caffe2/proto/caffe2_pb.h"
@@ -47,6 +48,8 @@ class CAFFE2_API SimpleNet : public NetBase {
   bool RunAsync() override;
 
   vector<unique_ptr<OperatorBase>> operators_;
+  // Set if the intermediates are laid out in a planned arena
+  std::unique_ptr<NetMemoryPlanner> memory_planner_;
 
   C10_DISABLE_COPY_AND_ASSIGN(SimpleNet);
 };
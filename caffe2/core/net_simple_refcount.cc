@@ -1,6 +1,7 @@
 #include "caffe2/core/net_simple_refcount.h"
 #include "caffe2/core/net.h"
 
+#include <algorithm>
 #include <iostream>
 #include <set>
 #include <unordered_map>
@@ -59,6 +60,9 @@ SimpleRefCountNet::SimpleRefCountNet(
 bool SimpleRefCountNet::Run() {
   StartAllObservers();
   VLOG(1) << "Running net " << name_;
+  if (memory_planner_) {
+    memory_planner_->StartRun();
+  }
   for (int op_id = 0; op_id < operators_.size(); ++op_id) {
     auto& op = operators_[op_id];
     VLOG(1) << "Running operator " << op->debug_def().name() << "("
@@ -68,10 +72,25 @@ bool SimpleRefCountNet::Run() {
       LOG(ERROR) << "Operator failed: " << ProtoDebugString(op->debug_def());
       return false;
     }
+    if (memory_planner_) {
+      memory_planner_->OpFinished(op_id);
+    }
     for (Blob* blob : delete_list_[op_id]) {
       blob->Reset();
     }
   }
+  if (memory_planner_ && !memory_planner_->planned()) {
+    memory_planner_->FinishRun();
+    // Planned intermediates share the arena, so freeing them saves nothing
+    for (auto& blobs : delete_list_) {
+      blobs.erase(
+          std::remove_if(
+              blobs.begin(),
+              blobs.end(),
+              [this](Blob* blob) { return memory_planner_->IsPlanned(blob); }),
+          blobs.end());
+    }
+  }
   StopAllObservers();
   return true;
 }
@@ -44,6 +44,7 @@ class SimpleRefCountNet final : public SimpleNet {
  protected:
   bool Run() override;
 
+  using SimpleNet::memory_planner_;
   using SimpleNet::operators_;
 
  private:
@@ -704,6 +704,50 @@ TEST(NetTest, AsyncEmptyNet) {
   }
 }
 
+TEST(NetTest, AsyncWorkStealing) {
+  NetDef net_def;
+  net_def.set_type("async_scheduling");
+  {
+    auto* arg = net_def.add_arg();
+    arg->set_name("work_stealing");
+    arg->set_i(1);
+  }
+  constexpr int kBranches = 8;
+  for (int i = 0; i < kBranches; ++i) {
+    const auto hidden = "hidden" + c10::to_string(i);
+    {
+      auto& op = *(net_def.add_op());
+      op.set_type("NetTestDummy");
+      op.add_input("in");
+      op.add_output(hidden);
+    }
+    {
+      auto& op = *(net_def.add_op());
+      op.set_type("NetTestDummy");
+      op.add_input(hidden);
+      op.add_output("branch" + c10::to_string(i));
+    }
+  }
+  {
+    auto& op = *(net_def.add_op());
+    op.set_type("NetTestDummy");
+    for (int i = 0; i < kBranches; ++i) {
+      op.add_input("branch" + c10::to_string(i));
+    }
+    op.add_output("out");
+  }
+  net_def.add_external_input("in");
+
+  Workspace ws;
+  ws.CreateBlob("in");
+  std::unique_ptr<NetBase> net(CreateNet(net_def, &ws));
+  counter.exchange(0);
+  for (int run = 0; run < 10; ++run) {
+    ASSERT_TRUE(net->Run());
+  }
+  ASSERT_EQ(counter.load(), 10 * net_def.op_size());
+}
+
 TEST(NetTest, DISABLED_RunAsyncFailure) {
   const auto spec = R"DOC(
         name: "example"
@@ -196,5 +196,42 @@ TEST(DBReaderShardedTest, Reader) {
   EXPECT_EQ(value, "05");
 }
 
+TEST(DBReaderPrefetchTest, OneCursorKeepsOrder) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+  DBReader reader("leveldb", name, 3, 1);
+  reader.StartPrefetching(1, 2);
+  EXPECT_TRUE(reader.prefetching());
+  string key;
+  string value;
+  for (const auto* expected : {"01", "04", "07", "01", "04"}) {
+    reader.Read(&key, &value);
+    EXPECT_EQ(key, expected);
+    EXPECT_EQ(value, expected);
+  }
+}
+
+TEST(DBReaderPrefetchTest, CursorsCoverAllKeys) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+  DBReader reader("leveldb", name);
+  reader.StartPrefetching(3, 4);
+  std::set<string> keys;
+  string key;
+  string value;
+  for (int i = 0; i < 100 * kMaxItems; ++i) {
+    reader.Read(&key, &value);
+    EXPECT_EQ(key, value);
+    keys.insert(key);
+  }
+  EXPECT_EQ(keys.size(), kMaxItems);
+
+  // Reopening stops the prefetching threads.
+  reader.Open("leveldb", name);
+  EXPECT_FALSE(reader.prefetching());
+  reader.Read(&key, &value);
+  EXPECT_EQ(key, "00");
+}
+
 }  // namespace db
 }  // namespace caffe2
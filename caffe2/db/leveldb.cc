@@ -8,6 +8,11 @@ C10_DEFINE_int(
     caffe2_leveldb_block_size,
     65536,
     "The caffe2 leveldb block size when writing a leveldb.");
+C10_DEFINE_bool(
+    caffe2_leveldb_fill_cache,
+    false,
+    "If set, the blocks read by leveldb cursors are kept in the block cache. "
+    "Cursors scan the whole db, so by default they do not evict the cache.");
 
 namespace caffe2 {
 namespace db {
@@ -15,7 +20,7 @@ namespace db {
 class LevelDBCursor : public Cursor {
  public:
   explicit LevelDBCursor(leveldb::DB* db)
-      : iter_(db->NewIterator(leveldb::ReadOptions())) {
+      : iter_(db->NewIterator(ReadOptions())) {
     SeekToFirst();
   }
   ~LevelDBCursor() override {}
@@ -28,6 +33,12 @@ class LevelDBCursor : public Cursor {
   bool Valid() override { return iter_->Valid(); }
 
  private:
+  static leveldb::ReadOptions ReadOptions() {
+    leveldb::ReadOptions options;
+    options.fill_cache = FLAGS_caffe2_leveldb_fill_cache;
+    return options;
+  }
+
   std::unique_ptr<leveldb::Iterator> iter_;
 };
 
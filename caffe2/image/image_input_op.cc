@@ -14,6 +14,11 @@ bool ImageInputOp<CPUContext>::ApplyTransformOnGPU(
   return false;
 }
 
+template <>
+bool ImageInputOp<CPUContext>::DecodeOnGPU(const int) {
+  return false;
+}
+
 REGISTER_CPU_OPERATOR(ImageInput, ImageInputOp<CPUContext>);
 
 OPERATOR_SCHEMA(ImageInput)
@@ -134,6 +139,11 @@ The dimension of the output image will always be cropxcrop
         "decode_threads",
         "Number of CPU decode/transform threads."
         " Defaults to 4")
+    .Arg(
+        "use_gpu_decode",
+        "1 if JPEG images should be decoded, cropped, resized and mirrored"
+        " on the GPU with nvJPEG. Images nvJPEG can't decode are decoded on"
+        " the CPU. Requires use_gpu_transform. Defaults to 0")
     .Arg("output_type", "If gpu_transform, can set to FLOAT or FLOAT16.")
     .Arg("db", "Name of the database (if not passed as input)")
     .Arg(
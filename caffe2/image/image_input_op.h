@@ -19,6 +19,7 @@
 namespace caffe2 {
 
 class CUDAContext;
+class NvJpegDecoder;
 
 template <class Context>
 class ImageInputOp final : public PrefetchOperator<Context> {
@@ -74,12 +75,15 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   // to be privatized per launch.
   using PerImageArg = struct { BoundingBox bounding_params; };
 
+  // If `encoded_image` is given and the image is encoded, the encoded image
+  // is returned in it instead of being decoded, and `img` is left empty.
   bool GetImageAndLabelAndInfoFromDBValue(
       const string& value,
       cv::Mat* img,
       PerImageArg& info,
       int item_id,
-      std::mt19937* randgen);
+      std::mt19937* randgen,
+      std::string* encoded_image = nullptr);
   void DecodeAndTransform(
       const std::string& value,
       float* image_data,
@@ -95,6 +99,25 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   bool ApplyTransformOnGPU(
       const std::vector<std::int64_t>& dims,
       const c10::Device& type);
+  // GPU decode path: parses the value and keeps the encoded image for
+  // DecodeOnGPU, or crops the image on the CPU right away if it isn't
+  // encoded.
+  void ParseForGPUDecode(
+      int item_id,
+      uint8_t* image_data,
+      const int channels,
+      std::size_t thread_index);
+  // The crop, resize and mirror that the CPU path applies to a decoded
+  // image of the given size, as the window CropResizeMirrorOnGPU takes.
+  CropResizeMirrorParams GetCropResizeMirrorParams(
+      int height,
+      int width,
+      PerImageArg info,
+      std::mt19937* randgen);
+  // Decodes the images kept by ParseForGPUDecode with nvJPEG and crops them
+  // into prefetched_image_on_device_. Images nvJPEG can't decode are decoded
+  // on the CPU instead, concurrently with the GPU decode.
+  bool DecodeOnGPU(const int channels);
 
   unique_ptr<db::DBReader> owned_reader_;
   const db::DBReader* reader_;
@@ -135,6 +158,7 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   bool is_test_;
   bool use_caffe_datum_;
   bool gpu_transform_;
+  bool gpu_decode_;
   bool mean_std_copied_ = false;
 
   // thread pool for parse + decode
@@ -154,6 +178,18 @@ class ImageInputOp final : public PrefetchOperator<Context> {
   // Working variables
   std::vector<std::mt19937> randgen_per_thread_;
 
+  // State of the GPU decode path, per image of the batch where applicable
+  std::vector<std::string> batch_values_;
+  std::vector<std::string> encoded_images_;
+  std::vector<PerImageArg> image_args_;
+  std::vector<char> needs_gpu_decode_;
+  std::vector<CropResizeMirrorParams> crop_params_;
+  Tensor crop_params_on_device_;
+  Tensor decoded_images_on_device_;
+  std::mt19937 gpu_decode_randgen_;
+  // Only created by the thread running Prefetch, which owns it from then on.
+  std::shared_ptr<NvJpegDecoder> gpu_decoder_;
+
   // number of exceptions produced by opencv while reading image data
   std::atomic<long> num_decode_errors_in_batch_{0};
   // opencv exceptions tolerance
@@ -205,6 +241,8 @@ ImageInputOp<Context>::ImageInputOp(
       gpu_transform_(OperatorBase::template GetSingleArgument<int>(
           "use_gpu_transform",
           0)),
+      gpu_decode_(
+          OperatorBase::template GetSingleArgument<int>("use_gpu_decode", 0)),
       num_decode_threads_(
           OperatorBase::template GetSingleArgument<int>("decode_threads", 4)),
       additional_output_sizes_(
@@ -311,6 +349,15 @@ ImageInputOp<Context>::ImageInputOp(
   CAFFE_ENFORCE(
       !use_caffe_datum_ || OutputSize() == 2,
       "There can only be 2 outputs if the Caffe datum format is used");
+#ifndef CAFFE2_USE_NVJPEG
+  CAFFE_ENFORCE(
+      !gpu_decode_,
+      "GPU decoding requires Caffe2 to be built with nvJPEG (USE_NVJPEG=1)");
+#endif
+  CAFFE_ENFORCE(
+      !gpu_decode_ ||
+          (gpu_transform_ && std::is_same<Context, CUDAContext>::value),
+      "GPU decoding requires use_gpu_transform in a CUDAContext");
 
   CAFFE_ENFORCE(
       random_scale_.size() == 2, "Must provide [scale_min, scale_max]");
@@ -339,6 +386,9 @@ ImageInputOp<Context>::ImageInputOp(
   if (gpu_transform_) {
     LOG(INFO) << "    Performing transformation on GPU";
   }
+  if (gpu_decode_) {
+    LOG(INFO) << "    Decoding JPEG images on GPU";
+  }
   LOG(INFO) << "    Outputting in batches of " << batch_size_ << " images;";
   LOG(INFO) << "    Treating input image as "
             << (color_ ? "color " : "grayscale ") << "image;";
@@ -390,6 +440,13 @@ ImageInputOp<Context>::ImageInputOp(
   for (int i = 0; i < num_decode_threads_; ++i) {
     randgen_per_thread_.emplace_back(meta_randgen());
   }
+  if (gpu_decode_) {
+    gpu_decode_randgen_.seed(meta_randgen());
+    batch_values_.resize(batch_size_);
+    encoded_images_.resize(batch_size_);
+    image_args_.resize(batch_size_);
+    needs_gpu_decode_.resize(batch_size_);
+  }
   ReinitializeTensor(
       &prefetched_image_,
       {int64_t(batch_size_),
@@ -451,7 +508,8 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
     cv::Mat* img,
     PerImageArg& info,
     int item_id,
-    std::mt19937* randgen) {
+    std::mt19937* randgen,
+    std::string* encoded_image) {
   //
   // recommend using --caffe2_use_fatal_for_enforce=1 when using ImageInputOp
   // as this function runs on a worker thread and the exceptions from
@@ -467,7 +525,9 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
     CAFFE_ENFORCE(datum.ParseFromString(value));
 
     prefetched_label_.mutable_data<int>()[item_id] = datum.label();
-    if (datum.encoded()) {
+    if (datum.encoded() && encoded_image) {
+      *encoded_image = datum.data();
+    } else if (datum.encoded()) {
       // encoded image in datum.
       // count the number of exceptions from opencv imdecode
       try {
@@ -538,7 +598,10 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
       info.bounding_params.width = bounding_proto.int32_data(3);
     }
 
-    if (image_proto.data_type() == TensorProto::STRING) {
+    if (image_proto.data_type() == TensorProto::STRING && encoded_image) {
+      DCHECK_EQ(image_proto.string_data_size(), 1);
+      *encoded_image = image_proto.string_data(0);
+    } else if (image_proto.data_type() == TensorProto::STRING) {
       // encoded image string.
       DCHECK_EQ(image_proto.string_data_size(), 1);
       const string& encoded_image_str = image_proto.string_data(0);
@@ -687,6 +750,11 @@ bool ImageInputOp<Context>::GetImageAndLabelAndInfoFromDBValue(
     }
   }
 
+  if (src.empty() && encoded_image) {
+    // The image is decoded later, along with the other images of the batch.
+    return true;
+  }
+
   //
   // convert source to the color format requested from Op
   //
@@ -1146,6 +1214,146 @@ void ImageInputOp<Context>::DecodeAndTransposeOnly(
       is_test_);
 }
 
+template <class Context>
+void ImageInputOp<Context>::ParseForGPUDecode(
+    int item_id,
+    uint8_t* image_data,
+    const int channels,
+    std::size_t thread_index) {
+  CAFFE_ENFORCE((int)thread_index < num_decode_threads_);
+
+  std::mt19937* randgen = &(randgen_per_thread_[thread_index]);
+
+  cv::Mat img;
+  encoded_images_[item_id].clear();
+  CHECK(GetImageAndLabelAndInfoFromDBValue(
+      batch_values_[item_id],
+      &img,
+      image_args_[item_id],
+      item_id,
+      randgen,
+      &encoded_images_[item_id]));
+  needs_gpu_decode_[item_id] = img.empty();
+  if (!needs_gpu_decode_[item_id]) {
+    std::bernoulli_distribution mirror_this_image(0.5f);
+    CropTransposeImage<Context>(
+        img,
+        channels,
+        image_data,
+        crop_,
+        mirror_,
+        randgen,
+        &mirror_this_image,
+        is_test_);
+  }
+}
+
+// Mirrors the bounding box, scaling and cropping of
+// GetImageAndLabelAndInfoFromDBValue and CropTransposeImage.
+template <class Context>
+CropResizeMirrorParams ImageInputOp<Context>::GetCropResizeMirrorParams(
+    int height,
+    int width,
+    PerImageArg info,
+    std::mt19937* randgen) {
+  CropResizeMirrorParams params;
+  params.height = height;
+  params.width = width;
+  params.x = 0;
+  params.y = 0;
+  params.w = width;
+  params.h = height;
+
+  if (info.bounding_params.valid &&
+      height >= info.bounding_params.ymin + info.bounding_params.height &&
+      width >= info.bounding_params.xmin + info.bounding_params.width) {
+    params.x = info.bounding_params.xmin;
+    params.y = info.bounding_params.ymin;
+    params.w = info.bounding_params.width;
+    params.h = info.bounding_params.height;
+  }
+
+  // The size of the image that is cropped, and the crop offsets in it.
+  int scaled_width = params.w, scaled_height = params.h;
+  bool inception_scale_jitter = false;
+  if (scale_jitter_type_ == INCEPTION_STYLE && !is_test_) {
+    const int area = scaled_height * scaled_width;
+    std::uniform_real_distribution<> area_dis(0.08, 1.0);
+    std::uniform_real_distribution<> aspect_ratio_dis(3.0 / 4.0, 4.0 / 3.0);
+    for (int i = 0; i < 10; ++i) {
+      int target_area = int(ceil(area_dis(*randgen) * area));
+      float aspect_ratio = aspect_ratio_dis(*randgen);
+      int nh = floor(std::sqrt(((float)target_area / aspect_ratio)));
+      int nw = floor(std::sqrt(((float)target_area * aspect_ratio)));
+      if (nh >= 1 && nh <= scaled_height && nw >= 1 && nw <= scaled_width) {
+        params.y += std::uniform_int_distribution<>(0, scaled_height - nh)(
+            *randgen);
+        params.x +=
+            std::uniform_int_distribution<>(0, scaled_width - nw)(*randgen);
+        params.w = nw;
+        params.h = nh;
+        scaled_width = crop_;
+        scaled_height = crop_;
+        inception_scale_jitter = true;
+        break;
+      }
+    }
+  }
+
+  if (!inception_scale_jitter) {
+    int scale_to_use = scale_ > 0 ? scale_ : minsize_;
+    if (random_scaling_) {
+      scale_to_use = std::uniform_int_distribution<>(
+          random_scale_[0], random_scale_[1])(*randgen);
+    }
+    int new_width, new_height;
+    if (warp_) {
+      new_width = scale_to_use;
+      new_height = scale_to_use;
+    } else if (scaled_height > scaled_width) {
+      new_width = scale_to_use;
+      new_height = static_cast<float>(scaled_height) * scale_to_use /
+          scaled_width;
+    } else {
+      new_height = scale_to_use;
+      new_width = static_cast<float>(scaled_width) * scale_to_use /
+          scaled_height;
+    }
+    if ((scale_ > 0 &&
+         (new_height != scaled_height || new_width != scaled_width)) ||
+        (new_height > scaled_height || new_width > scaled_width)) {
+      scaled_width = new_width;
+      scaled_height = new_height;
+    }
+  }
+
+  CAFFE_ENFORCE_GE(
+      scaled_height, crop_, "Image height must be bigger than crop.");
+  CAFFE_ENFORCE_GE(
+      scaled_width, crop_, "Image width must be bigger than crop.");
+  int width_offset, height_offset;
+  if (is_test_) {
+    width_offset = (scaled_width - crop_) / 2;
+    height_offset = (scaled_height - crop_) / 2;
+  } else {
+    width_offset =
+        std::uniform_int_distribution<>(0, scaled_width - crop_)(*randgen);
+    height_offset =
+        std::uniform_int_distribution<>(0, scaled_height - crop_)(*randgen);
+  }
+  std::bernoulli_distribution mirror_this_image(0.5f);
+  params.mirror = mirror_ && mirror_this_image(*randgen);
+
+  // Map the crop back to the window of the decoded image.
+  const float scale_x = params.w / scaled_width;
+  const float scale_y = params.h / scaled_height;
+  params.x += width_offset * scale_x;
+  params.y += height_offset * scale_y;
+  params.w = crop_ * scale_x;
+  params.h = crop_ * scale_y;
+  return params;
+}
+
 template <class Context>
 bool ImageInputOp<Context>::Prefetch() {
   if (!owned_reader_.get()) {
@@ -1218,7 +1426,20 @@ bool ImageInputOp<Context>::Prefetch() {
 
     // launch into thread pool for processing
     // TODO: support color jitter and color lighting in gpu_transform
-    if (gpu_transform_) {
+    if (gpu_decode_) {
+      // only images that are not encoded are cropped here, the others are
+      // decoded on the GPU once the whole batch is parsed.
+      uint8_t* image_data = prefetched_image_.mutable_data<uint8_t>() +
+          crop_ * crop_ * channels * item_id;
+      batch_values_[item_id] = std::move(value);
+      thread_pool_->runTaskWithID(std::bind(
+          &ImageInputOp<Context>::ParseForGPUDecode,
+          this,
+          item_id,
+          image_data,
+          channels,
+          std::placeholders::_1));
+    } else if (gpu_transform_) {
       // output of decode will still be int8
       uint8_t* image_data = prefetched_image_.mutable_data<uint8_t>() +
           crop_ * crop_ * channels * item_id;
@@ -1244,6 +1465,9 @@ bool ImageInputOp<Context>::Prefetch() {
     }
   }
   thread_pool_->waitWorkComplete();
+  if (gpu_decode_ && !DecodeOnGPU(channels)) {
+    return false;
+  }
 
   // we allow to get at most max_decode_error_ratio from
   // opencv imdecode until raising a runtime exception
@@ -1259,8 +1483,10 @@ bool ImageInputOp<Context>::Prefetch() {
   auto device = at::device(Context::GetDeviceType());
   if (!std::is_same<Context, CPUContext>::value) {
     // do sync copies
-    ReinitializeAndCopyFrom(
-        &prefetched_image_on_device_, device, prefetched_image_);
+    if (!gpu_decode_) {
+      ReinitializeAndCopyFrom(
+          &prefetched_image_on_device_, device, prefetched_image_);
+    }
     ReinitializeAndCopyFrom(
         &prefetched_label_on_device_, device, prefetched_label_);
 
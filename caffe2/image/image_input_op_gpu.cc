@@ -1,6 +1,7 @@
 #include "caffe2/core/common_gpu.h"
 #include "caffe2/core/context_gpu.h"
 #include "caffe2/image/image_input_op.h"
+#include "caffe2/image/nvjpeg_decoder.h"
 
 namespace caffe2 {
 
@@ -33,6 +34,119 @@ bool ImageInputOp<CUDAContext>::ApplyTransformOnGPU(
   return true;
 }
 
+template <>
+bool ImageInputOp<CUDAContext>::DecodeOnGPU(const int channels) {
+#ifdef CAFFE2_USE_NVJPEG
+  if (!gpu_decoder_) {
+    gpu_decoder_ = std::make_shared<NvJpegDecoder>(color_);
+  }
+
+  // Split the encoded images between nvJPEG and OpenCV, and lay out the
+  // images decoded by nvJPEG one after the other in a single buffer.
+  std::vector<int> gpu_items, cpu_items, widths;
+  std::vector<int64_t> offsets;
+  int64_t decoded_size = 0;
+  crop_params_.clear();
+  for (int item_id = 0; item_id < batch_size_; ++item_id) {
+    if (!needs_gpu_decode_[item_id]) {
+      continue;
+    }
+    int height, width;
+    if (!gpu_decoder_->GetImageInfo(
+            encoded_images_[item_id], &height, &width)) {
+      cpu_items.push_back(item_id);
+      continue;
+    }
+    auto params = GetCropResizeMirrorParams(
+        height, width, image_args_[item_id], &gpu_decode_randgen_);
+    params.offset = decoded_size;
+    params.output_index = item_id;
+    crop_params_.push_back(params);
+    gpu_items.push_back(item_id);
+    widths.push_back(width);
+    offsets.push_back(decoded_size);
+    decoded_size += static_cast<int64_t>(height) * width * channels;
+  }
+
+  auto decode_on_cpu = [&](const std::vector<int>& items) {
+    for (int item_id : items) {
+      thread_pool_->runTaskWithID(std::bind(
+          &ImageInputOp<CUDAContext>::DecodeAndTransposeOnly,
+          this,
+          std::cref(batch_values_[item_id]),
+          prefetched_image_.mutable_data<uint8_t>() +
+              crop_ * crop_ * channels * item_id,
+          item_id,
+          channels,
+          std::placeholders::_1));
+    }
+  };
+  // The images OpenCV decodes are decoded while nvJPEG runs.
+  decode_on_cpu(cpu_items);
+
+  if (!gpu_items.empty()) {
+    ReinitializeTensor(
+        &decoded_images_on_device_,
+        {decoded_size},
+        at::dtype<uint8_t>().device(CUDA));
+    uint8_t* decoded = decoded_images_on_device_.mutable_data<uint8_t>();
+    std::vector<const std::string*> images;
+    std::vector<uint8_t*> outputs;
+    for (size_t i = 0; i < gpu_items.size(); ++i) {
+      images.push_back(&encoded_images_[gpu_items[i]]);
+      outputs.push_back(decoded + offsets[i]);
+    }
+    if (!gpu_decoder_->DecodeBatch(
+            images, outputs, widths, context_.cuda_stream())) {
+      LOG(WARNING) << "nvJPEG failed to decode a batch of " << gpu_items.size()
+                   << " images, decoding them on the CPU instead";
+      decode_on_cpu(gpu_items);
+      gpu_items.clear();
+      crop_params_.clear();
+    }
+  }
+  thread_pool_->waitWorkComplete();
+
+  // Images cropped on the CPU are copied first, the kernel then writes the
+  // images decoded by nvJPEG over their slots. Both run on the stream of the
+  // operator, and the prefetch thread waits for them before returning.
+  ReinitializeTensor(
+      &prefetched_image_on_device_,
+      prefetched_image_.sizes(),
+      at::dtype<uint8_t>().device(CUDA));
+  if (static_cast<int>(gpu_items.size()) < batch_size_) {
+    context_.CopyBytesFromCPU(
+        prefetched_image_.nbytes(),
+        prefetched_image_.raw_data(),
+        prefetched_image_on_device_.raw_mutable_data());
+  }
+  if (!gpu_items.empty()) {
+    const size_t params_size =
+        crop_params_.size() * sizeof(CropResizeMirrorParams);
+    ReinitializeTensor(
+        &crop_params_on_device_,
+        {static_cast<int64_t>(params_size)},
+        at::dtype<uint8_t>().device(CUDA));
+    context_.CopyBytesFromCPU(
+        params_size,
+        crop_params_.data(),
+        crop_params_on_device_.mutable_data<uint8_t>());
+    CropResizeMirrorOnGPU<CUDAContext>(
+        decoded_images_on_device_.data<uint8_t>(),
+        reinterpret_cast<const CropResizeMirrorParams*>(
+            crop_params_on_device_.data<uint8_t>()),
+        crop_params_.size(),
+        channels,
+        crop_,
+        prefetched_image_on_device_.mutable_data<uint8_t>(),
+        &context_);
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
 REGISTER_CUDA_OPERATOR(ImageInput, ImageInputOp<CUDAContext>);
 
 } // namespace caffe2
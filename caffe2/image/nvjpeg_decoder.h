@@ -0,0 +1,48 @@
+#ifndef CAFFE2_IMAGE_NVJPEG_DECODER_H_
+#define CAFFE2_IMAGE_NVJPEG_DECODER_H_
+
+#include "caffe2/core/common.h"
+
+#ifdef CAFFE2_USE_NVJPEG
+
+#include <cuda_runtime.h>
+#include <nvjpeg.h>
+
+#include <string>
+#include <vector>
+
+namespace caffe2 {
+
+// Decodes JPEGs into device memory with nvJPEG, either as interleaved BGR
+// images, the layout OpenCV decodes to, or as grayscale images. An instance
+// must only be used by one thread at a time, with its device set as current.
+class NvJpegDecoder {
+ public:
+  explicit NvJpegDecoder(bool color);
+  ~NvJpegDecoder();
+  C10_DISABLE_COPY_AND_ASSIGN(NvJpegDecoder);
+
+  // Reads the size of an encoded image from its header. Returns false if
+  // nvJPEG cannot decode the image, e.g. because it is not a JPEG.
+  bool GetImageInfo(const std::string& data, int* height, int* width);
+
+  // Decodes all the images in one batch on `stream`. Image i is written to
+  // outputs[i], in rows of widths[i] * channels bytes. Returns false if the
+  // batch could not be decoded, in which case the outputs are undefined.
+  bool DecodeBatch(
+      const std::vector<const std::string*>& images,
+      const std::vector<uint8_t*>& outputs,
+      const std::vector<int>& widths,
+      cudaStream_t stream);
+
+ private:
+  const bool color_;
+  nvjpegHandle_t handle_;
+  nvjpegJpegState_t state_;
+};
+
+} // namespace caffe2
+
+#endif // CAFFE2_USE_NVJPEG
+
+#endif // CAFFE2_IMAGE_NVJPEG_DECODER_H_
@@ -0,0 +1,93 @@
+#include "caffe2/image/nvjpeg_decoder.h"
+
+#ifdef CAFFE2_USE_NVJPEG
+
+#include "caffe2/core/logging.h"
+
+#define NVJPEG_ENFORCE(condition)                                       \
+  do {                                                                  \
+    nvjpegStatus_t status = condition;                                  \
+    CAFFE_ENFORCE_EQ(                                                   \
+        status, NVJPEG_STATUS_SUCCESS, "nvJPEG error in ", #condition); \
+  } while (0)
+
+namespace caffe2 {
+
+NvJpegDecoder::NvJpegDecoder(bool color) : color_(color) {
+  NVJPEG_ENFORCE(nvjpegCreate(NVJPEG_BACKEND_DEFAULT, nullptr, &handle_));
+  NVJPEG_ENFORCE(nvjpegJpegStateCreate(handle_, &state_));
+}
+
+NvJpegDecoder::~NvJpegDecoder() {
+  nvjpegJpegStateDestroy(state_);
+  nvjpegDestroy(handle_);
+}
+
+bool NvJpegDecoder::GetImageInfo(
+    const std::string& data,
+    int* height,
+    int* width) {
+  int components = 0;
+  nvjpegChromaSubsampling_t subsampling;
+  int widths[NVJPEG_MAX_COMPONENT];
+  int heights[NVJPEG_MAX_COMPONENT];
+  if (nvjpegGetImageInfo(
+          handle_,
+          reinterpret_cast<const unsigned char*>(data.data()),
+          data.size(),
+          &components,
+          &subsampling,
+          widths,
+          heights) != NVJPEG_STATUS_SUCCESS) {
+    return false;
+  }
+  // CMYK and other exotic JPEGs are left to OpenCV.
+  if ((components != 1 && components != 3) ||
+      subsampling == NVJPEG_CSS_UNKNOWN) {
+    return false;
+  }
+  *height = heights[0];
+  *width = widths[0];
+  return *height > 0 && *width > 0;
+}
+
+bool NvJpegDecoder::DecodeBatch(
+    const std::vector<const std::string*>& images,
+    const std::vector<uint8_t*>& outputs,
+    const std::vector<int>& widths,
+    cudaStream_t stream) {
+  if (images.empty()) {
+    return true;
+  }
+  const int channels = color_ ? 3 : 1;
+  std::vector<const unsigned char*> data;
+  std::vector<size_t> lengths;
+  std::vector<nvjpegImage_t> destinations(images.size());
+  for (size_t i = 0; i < images.size(); ++i) {
+    data.push_back(reinterpret_cast<const unsigned char*>(images[i]->data()));
+    lengths.push_back(images[i]->size());
+    // Interleaved formats only use the first channel.
+    destinations[i].channel[0] = outputs[i];
+    destinations[i].pitch[0] = widths[i] * channels;
+  }
+  if (nvjpegDecodeBatchedInitialize(
+          handle_,
+          state_,
+          images.size(),
+          1,
+          color_ ? NVJPEG_OUTPUT_BGRI : NVJPEG_OUTPUT_Y) !=
+      NVJPEG_STATUS_SUCCESS) {
+    return false;
+  }
+  return nvjpegDecodeBatched(
+             handle_,
+             state_,
+             data.data(),
+             lengths.data(),
+             destinations.data(),
+             stream) == NVJPEG_STATUS_SUCCESS;
+}
+
+} // namespace caffe2
+
+#endif // CAFFE2_USE_NVJPEG
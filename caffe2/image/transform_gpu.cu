@@ -46,6 +46,46 @@ __global__ void transform_kernel(
   }
 }
 
+// One block per output image. Output pixel (h, w) samples the window at
+// the position matching the pixel center, so a window of the output size is
+// copied exactly.
+__global__ void crop_resize_mirror_kernel(
+    const int C,
+    const int crop,
+    const uint8_t* in,
+    const CropResizeMirrorParams* params,
+    uint8_t* out) {
+  const CropResizeMirrorParams p = params[blockIdx.x];
+  const uint8_t* input_ptr = in + p.offset;
+  uint8_t* output_ptr = out + static_cast<int64_t>(p.output_index) * crop * crop * C;
+  const float scale_y = p.h / crop;
+  const float scale_x = p.w / crop;
+
+  for (int h = threadIdx.y; h < crop; h += blockDim.y) {
+    float src_y = p.y + (h + 0.5f) * scale_y - 0.5f;
+    src_y = fminf(fmaxf(src_y, 0.f), p.height - 1.f);
+    const int y0 = static_cast<int>(src_y);
+    const int y1 = min(y0 + 1, p.height - 1);
+    const float fy = src_y - y0;
+    for (int w = threadIdx.x; w < crop; w += blockDim.x) {
+      const int out_w = p.mirror ? crop - 1 - w : w;
+      float src_x = p.x + (w + 0.5f) * scale_x - 0.5f;
+      src_x = fminf(fmaxf(src_x, 0.f), p.width - 1.f);
+      const int x0 = static_cast<int>(src_x);
+      const int x1 = min(x0 + 1, p.width - 1);
+      const float fx = src_x - x0;
+      const uint8_t* row0 = input_ptr + static_cast<int64_t>(y0) * p.width * C;
+      const uint8_t* row1 = input_ptr + static_cast<int64_t>(y1) * p.width * C;
+      for (int c = 0; c < C; ++c) {
+        const float top = row0[x0 * C + c] + (row0[x1 * C + c] - row0[x0 * C + c]) * fx;
+        const float bottom = row1[x0 * C + c] + (row1[x1 * C + c] - row1[x0 * C + c]) * fx;
+        output_ptr[(h * crop + out_w) * C + c] =
+            static_cast<uint8_t>(top + (bottom - top) * fy + 0.5f);
+      }
+    }
+  }
+}
+
 }
 
 template <typename T_IN, typename T_OUT, class Context>
@@ -81,4 +121,30 @@ template bool TransformOnGPU<uint8_t, at::Half, CUDAContext>(
     Tensor& std,
     CUDAContext* context);
 
+template <class Context>
+bool CropResizeMirrorOnGPU(
+    const uint8_t* in,
+    const CropResizeMirrorParams* params,
+    const int N,
+    const int C,
+    const int crop,
+    uint8_t* out,
+    Context* context) {
+  if (N == 0) {
+    return true;
+  }
+  crop_resize_mirror_kernel<<<N, dim3(16, 16), 0, context->cuda_stream()>>>(
+      C, crop, in, params, out);
+  return true;
+}
+
+template bool CropResizeMirrorOnGPU<CUDAContext>(
+    const uint8_t* in,
+    const CropResizeMirrorParams* params,
+    const int N,
+    const int C,
+    const int crop,
+    uint8_t* out,
+    CUDAContext* context);
+
 }  // namespace caffe2
@@ -38,6 +38,37 @@ bool TransformOnGPU(
     Tensor& std,
     Context* context);
 
+// Where an output image of CropResizeMirrorOnGPU is taken from: the window
+// [x, x + w) x [y, y + h) of a (height x width) interleaved image that starts
+// at byte `offset` of the input buffer.
+struct CropResizeMirrorParams {
+  int64_t offset;
+  int height;
+  int width;
+  float x;
+  float y;
+  float w;
+  float h;
+  int mirror;
+  // The index of the output image in the batch.
+  int output_index;
+};
+
+// Crops every window described by `params` (N of them, in device memory)
+// out of `in`, resizes it to crop x crop with bilinear interpolation and
+// mirrors it horizontally if requested, in a single kernel. The results are
+// written as uint8 NHWC images of C channels into the images of `out` at
+// their output index; the other images of `out` are left untouched.
+template <class Context>
+bool CropResizeMirrorOnGPU(
+    const uint8_t* in,
+    const CropResizeMirrorParams* params,
+    const int N,
+    const int C,
+    const int crop,
+    uint8_t* out,
+    Context* context);
+
 }  // namespace caffe2
 
 #endif
@@ -0,0 +1,96 @@
+#include "caffe2/observers/sampling_observer.h"
+
+namespace caffe2 {
+
+namespace {
+
+constexpr int kNumBuckets = 9;
+
+// The upper bound of histogram bucket `bucket`, in microseconds
+int64_t bucketBound(int bucket) {
+  return int64_t{1} << (2 * bucket);
+}
+
+} // namespace
+
+SampledLatencyStat::SampledLatencyStat(
+    const std::string& group,
+    const std::string& name)
+    : latency_(group, name + "/latency_ns") {
+  for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+    buckets_.emplace_back(
+        group,
+        name + "/latency/le_" + c10::to_string(bucketBound(bucket)) + "us");
+  }
+  buckets_.emplace_back(group, name + "/latency/inf");
+}
+
+void SampledLatencyStat::Add(int64_t nanos) {
+  latency_.increment(nanos);
+  int bucket = 0;
+  while (bucket < kNumBuckets && nanos > bucketBound(bucket) * 1000) {
+    ++bucket;
+  }
+  buckets_[bucket].increment();
+}
+
+SamplingNetObserver::SamplingNetObserver(
+    NetBase* subject,
+    int sample_rate,
+    const std::string& group)
+    : ObserverBase<NetBase>(subject),
+      sample_rate_(sample_rate),
+      operators_(subject->GetOperators()),
+      net_stat_(group + "/" + subject->Name(), "net") {
+  CAFFE_ENFORCE_GT(sample_rate_, 0);
+  for (size_t idx = 0; idx < operators_.size(); ++idx) {
+    auto* op = operators_[idx];
+    parked_.push_back(make_unique<SamplingOperatorObserver>(op));
+    op_observers_.push_back(parked_.back().get());
+    op_stats_.emplace_back(
+        group + "/" + subject->Name(),
+        c10::to_string(idx) + "_" + op->debug_def().type());
+  }
+}
+
+void SamplingNetObserver::Start() {
+  if (++num_runs_ % sample_rate_ != 0) {
+    return;
+  }
+  sampling_ = true;
+  for (size_t idx = 0; idx < operators_.size(); ++idx) {
+    op_observers_[idx]->Reset();
+    operators_[idx]->AttachObserver(std::move(parked_[idx]));
+  }
+  start_time_ = std::chrono::steady_clock::now();
+  start_ticks_ = SamplingTimestamp();
+}
+
+void SamplingNetObserver::Stop() {
+  if (!sampling_) {
+    return;
+  }
+  sampling_ = false;
+  const auto ticks = SamplingTimestamp() - start_ticks_;
+  const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - start_time_)
+                         .count();
+  const double nanos_per_tick =
+      ticks > 0 ? static_cast<double>(nanos) / ticks : 0.0;
+
+  net_stat_.Add(nanos);
+  for (size_t idx = 0; idx < operators_.size(); ++idx) {
+    auto* observer = op_observers_[idx];
+    if (observer->stopped()) {
+      op_stats_[idx].Add(
+          static_cast<int64_t>(observer->ticks() * nanos_per_tick));
+    }
+    auto detached = operators_[idx]->DetachObserver(observer);
+    CAFFE_ENFORCE(detached, "The sampling observer was detached elsewhere");
+    parked_[idx].reset(
+        static_cast<SamplingOperatorObserver*>(detached.release()));
+  }
+  ++num_sampled_runs_;
+}
+
+} // namespace caffe2
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CAFFE2_SAMPLING_OBSERVER_USE_TSC
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define CAFFE2_SAMPLING_OBSERVER_USE_TSC
+#endif
+
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/observer.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/stats.h"
+
+namespace caffe2 {
+
+// Returns a timestamp of the cheapest clock available: the time stamp counter
+// on x86, and the nanoseconds of the steady clock elsewhere. Ticks are
+// converted to nanoseconds with the steady clock time of each sampled run.
+inline uint64_t SamplingTimestamp() {
+#ifdef CAFFE2_SAMPLING_OBSERVER_USE_TSC
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+#endif
+}
+
+// The latency of a net or an operator, exported to the StatRegistry as
+// <group>/<name>/latency_ns/{sum,count}, and as a histogram of counters
+// <group>/<name>/latency/le_<bound>us (and latency/inf) with bounds growing
+// by powers of 4 from 1us.
+class CAFFE2_API SampledLatencyStat {
+ public:
+  SampledLatencyStat(const std::string& group, const std::string& name);
+
+  void Add(int64_t nanos);
+
+ private:
+  AvgExportedStat latency_;
+  std::vector<ExportedStat> buckets_;
+};
+
+class CAFFE2_API SamplingOperatorObserver final
+    : public ObserverBase<OperatorBase> {
+ public:
+  explicit SamplingOperatorObserver(OperatorBase* op)
+      : ObserverBase<OperatorBase>(op) {}
+
+  void Reset() {
+    stopped_ = false;
+  }
+  bool stopped() const {
+    return stopped_;
+  }
+  uint64_t ticks() const {
+    return stop_ - start_;
+  }
+
+ private:
+  void Start() override {
+    start_ = SamplingTimestamp();
+  }
+  void Stop() override {
+    stop_ = SamplingTimestamp();
+    stopped_ = true;
+  }
+
+  uint64_t start_ = 0;
+  uint64_t stop_ = 0;
+  bool stopped_ = false;
+};
+
+// Times one in `sample_rate` runs of a net and of each of its operators.
+//
+// Unlike TimeObserver, the operators only have an observer attached during
+// the sampled runs, so the other runs cost the operators nothing. During a
+// sampled run, each operator only takes two timestamps of the cheap clock
+// into its own observer, which no other thread writes to. When the run
+// finishes, the net observer adds the latencies to SampledLatencyStats of
+// group `group`/<net name>, named "net" and <op index>_<op type>.
+//
+// To sample every net, register it with
+//   AddGlobalNetObserverCreator([](NetBase* net) {
+//     return make_unique<SamplingNetObserver>(net, 1000);
+//   });
+class CAFFE2_API SamplingNetObserver final : public ObserverBase<NetBase> {
+ public:
+  SamplingNetObserver(
+      NetBase* subject,
+      int sample_rate,
+      const std::string& group = "sampled_latency");
+
+  int64_t num_sampled_runs() const {
+    return num_sampled_runs_;
+  }
+
+ private:
+  void Start() override;
+  void Stop() override;
+
+  const int sample_rate_;
+  int64_t num_runs_ = 0;
+  int64_t num_sampled_runs_ = 0;
+  bool sampling_ = false;
+
+  std::vector<OperatorBase*> operators_;
+  // The observer of each operator, which the operator owns while a run is
+  // sampled, and `parked_` owns otherwise.
+  std::vector<SamplingOperatorObserver*> op_observers_;
+  std::vector<std::unique_ptr<SamplingOperatorObserver>> parked_;
+
+  SampledLatencyStat net_stat_;
+  std::vector<SampledLatencyStat> op_stats_;
+
+  std::chrono::steady_clock::time_point start_time_;
+  uint64_t start_ticks_ = 0;
+};
+
+} // namespace caffe2
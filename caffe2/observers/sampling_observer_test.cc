@@ -0,0 +1,82 @@
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/stats.h"
+#include "caffe2/observers/sampling_observer.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+namespace caffe2 {
+
+namespace {
+
+class SamplingObserverTestOp final : public OperatorBase {
+ public:
+  using OperatorBase::OperatorBase;
+  bool Run(int /* unused */) override {
+    StartAllObservers();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    StopAllObservers();
+    return true;
+  }
+};
+
+REGISTER_CPU_OPERATOR(SamplingObserverTestOp, SamplingObserverTestOp);
+
+OPERATOR_SCHEMA(SamplingObserverTestOp).NumInputs(0, 1).NumOutputs(0, 1);
+
+unique_ptr<NetBase> CreateNetTestHelper(Workspace* ws) {
+  NetDef net_def;
+  net_def.set_name("sampled_net");
+  {
+    auto& op = *(net_def.add_op());
+    op.set_type("SamplingObserverTestOp");
+    op.add_input("in");
+    op.add_output("hidden");
+  }
+  {
+    auto& op = *(net_def.add_op());
+    op.set_type("SamplingObserverTestOp");
+    op.add_input("hidden");
+    op.add_output("out");
+  }
+  net_def.add_external_input("in");
+  net_def.add_external_output("out");
+  return CreateNet(net_def, ws);
+}
+
+} // namespace
+
+TEST(SamplingObserverTest, SamplesOneInN) {
+  Workspace ws;
+  ws.CreateBlob("in");
+  auto net = CreateNetTestHelper(&ws);
+  const auto* ob = static_cast<const SamplingNetObserver*>(
+      net->AttachObserver(make_unique<SamplingNetObserver>(
+          net.get(), 3, "sampling_observer_test")));
+  for (int i = 0; i < 7; ++i) {
+    EXPECT_TRUE(net->Run());
+    // Outside of sampled runs, operators have no observers.
+    for (auto* op : net->GetOperators()) {
+      EXPECT_EQ(op->NumObservers(), 0);
+    }
+  }
+  EXPECT_EQ(ob->num_sampled_runs(), 2);
+
+  auto stats = toMap(StatRegistry::get().publish());
+  const std::string prefix = "sampling_observer_test/sampled_net/";
+  EXPECT_EQ(stats[prefix + "net/latency_ns/count"], 2);
+  EXPECT_GE(stats[prefix + "net/latency_ns/sum"], 2 * 4000000);
+  for (const auto* op :
+       {"0_SamplingObserverTestOp", "1_SamplingObserverTestOp"}) {
+    EXPECT_EQ(stats[prefix + op + "/latency_ns/count"], 2);
+    EXPECT_GE(stats[prefix + op + "/latency_ns/sum"], 2 * 2000000);
+    // 2ms falls in the (1024us, 4096us] bucket
+    EXPECT_EQ(stats[prefix + op + "/latency/le_4096us"], 2);
+    EXPECT_EQ(stats[prefix + op + "/latency/le_1024us"], 0);
+  }
+}
+
+} // namespace caffe2
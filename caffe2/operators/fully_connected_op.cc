@@ -3,9 +3,52 @@
 #include <functional>
 
 #include "caffe2/operators/fc_inference.h"
+#include "caffe2/utils/eigen_utils.h"
 
 namespace caffe2 {
 
+FCActivation ParseFCActivation(const std::string& activation) {
+  if (activation.empty()) {
+    return FCActivation::NONE;
+  } else if (activation == "Relu") {
+    return FCActivation::RELU;
+  } else if (activation == "Sigmoid") {
+    return FCActivation::SIGMOID;
+  } else if (activation == "Tanh") {
+    return FCActivation::TANH;
+  }
+  CAFFE_THROW("Unsupported FC activation: ", activation);
+}
+
+template <>
+void FCAddBiasAndActivate<float, float, CPUContext>(
+    FCActivation activation,
+    int M,
+    int N,
+    const float* b,
+    float* Y,
+    CPUContext* /* context */) {
+  ConstEigenVectorArrayMap<float> bias(b, N);
+  // Row by row, so that each row is activated while still in cache.
+  for (int i = 0; i < M; ++i) {
+    EigenVectorArrayMap<float> y(Y + static_cast<int64_t>(i) * N, N);
+    switch (activation) {
+      case FCActivation::RELU:
+        y = (y + bias).cwiseMax(0.0f);
+        break;
+      case FCActivation::SIGMOID:
+        y = ((-(y + bias)).exp() + 1.0f).inverse();
+        break;
+      case FCActivation::TANH:
+        y = (y + bias).tanh();
+        break;
+      case FCActivation::NONE:
+        y += bias;
+        break;
+    }
+  }
+}
+
 REGISTER_CPU_OPERATOR(FC, FullyConnectedOp<CPUContext>);
 REGISTER_CPU_GRADIENT_OPERATOR(
     FCGradient,
@@ -184,6 +227,9 @@ Y:
     .Arg(
         "float16_compute",
         "*(type: bool; default: False)* Whether to use float-16 compute kernel.")
+    .Arg(
+        "activation",
+        "*(type: string; default: \"\")* An activation applied to $Y$ together with the bias, one of \"Relu\", \"Sigmoid\" and \"Tanh\". Set by the FuseFCActivation net transform. FC ops with an activation have no gradient.")
     .Input(
         0,
         "X",
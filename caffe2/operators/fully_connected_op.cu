@@ -0,0 +1,59 @@
+#include "caffe2/core/context_gpu.h"
+#include "caffe2/operators/fully_connected_op.h"
+
+namespace caffe2 {
+
+namespace {
+
+template <typename T_B, typename T_Y>
+__global__ void FCAddBiasAndActivateCUDAKernel(
+    const FCActivation activation,
+    const int size,
+    const int N,
+    const T_B* b,
+    T_Y* Y) {
+  CUDA_1D_KERNEL_LOOP(i, size) {
+    const float y = static_cast<float>(Y[i]) + static_cast<float>(b[i % N]);
+    switch (activation) {
+      case FCActivation::RELU:
+        Y[i] = static_cast<T_Y>(fmaxf(y, 0.0f));
+        break;
+      case FCActivation::SIGMOID:
+        Y[i] = static_cast<T_Y>(1.0f / (1.0f + expf(-y)));
+        break;
+      case FCActivation::TANH:
+        Y[i] = static_cast<T_Y>(tanhf(y));
+        break;
+      case FCActivation::NONE:
+        Y[i] = static_cast<T_Y>(y);
+        break;
+    }
+  }
+}
+
+} // namespace
+
+#define CAFFE2_SPECIALIZED_FC_ADD_BIAS_AND_ACTIVATE(T_B, T_Y)            \
+  template <>                                                            \
+  void FCAddBiasAndActivate<T_B, T_Y, CUDAContext>(                      \
+      FCActivation activation,                                           \
+      int M,                                                             \
+      int N,                                                             \
+      const T_B* b,                                                      \
+      T_Y* Y,                                                            \
+      CUDAContext* context) {                                            \
+    const int size = M * N;                                              \
+    if (size == 0) {                                                     \
+      return;                                                            \
+    }                                                                    \
+    FCAddBiasAndActivateCUDAKernel<T_B, T_Y>                             \
+        <<<CAFFE_GET_BLOCKS(size),                                       \
+           CAFFE_CUDA_NUM_THREADS,                                       \
+           0,                                                            \
+           context->cuda_stream()>>>(activation, size, N, b, Y);         \
+  }
+CAFFE2_SPECIALIZED_FC_ADD_BIAS_AND_ACTIVATE(float, float)
+CAFFE2_SPECIALIZED_FC_ADD_BIAS_AND_ACTIVATE(at::Half, at::Half)
+#undef CAFFE2_SPECIALIZED_FC_ADD_BIAS_AND_ACTIVATE
+
+} // namespace caffe2
@@ -13,6 +13,23 @@
 
 namespace caffe2 {
 
+// The activation that an FC applies to its output, given by its "activation"
+// argument, so that an activation op following it can be fused into it.
+enum class FCActivation { NONE, RELU, SIGMOID, TANH };
+
+CAFFE2_API FCActivation ParseFCActivation(const std::string& activation);
+
+// Computes Y = activation(Y + b) in one pass, where Y is an M x N row-major
+// matrix and b, of length N, is added to each of its rows.
+template <typename T_B, typename T_Y, class Context>
+void FCAddBiasAndActivate(
+    FCActivation activation,
+    int M,
+    int N,
+    const T_B* b,
+    T_Y* Y,
+    Context* context);
+
 // This is Caffe's InnerProductOp, with a name that fits its purpose better.
 template <
     class Context,
@@ -27,7 +44,9 @@ class FullyConnectedOp final : public Operator<Context> {
         axis_(this->template GetSingleArgument<int32_t>("axis", 1)),
         axis_w_(this->template GetSingleArgument<int32_t>("axis_w", 1)),
         float16_compute_(
-            this->template GetSingleArgument<bool>("float16_compute", false)) {}
+            this->template GetSingleArgument<bool>("float16_compute", false)),
+        activation_(ParseFCActivation(
+            this->template GetSingleArgument<std::string>("activation", ""))) {}
   ~FullyConnectedOp() {}
 
   template <
@@ -139,6 +158,17 @@ class FullyConnectedOp final : public Operator<Context> {
       t_begin = std::chrono::system_clock::now();
     }
 #endif
+    if (activation_ != FCActivation::NONE) {
+      FCAddBiasAndActivate<T_B, T_Y, Context>(
+          activation_,
+          M,
+          N,
+          b.template data<T_B>(),
+          Y->template mutable_data<T_Y>(),
+          &context_);
+      return true;
+    }
+
     // Add bias term
     if (!bias_multiplier_.has_value()) {
       bias_multiplier_ =
@@ -201,6 +231,7 @@ class FullyConnectedOp final : public Operator<Context> {
   c10::optional<Tensor> bias_multiplier_;
 
   bool float16_compute_;
+  FCActivation activation_;
 };
 
 template <
@@ -216,7 +247,12 @@ class FullyConnectedGradientOp : public Operator<Context> {
         axis_(this->template GetSingleArgument<int32_t>("axis", 1)),
         axis_w_(this->template GetSingleArgument<int32_t>("axis_w", 1)),
         float16_compute_(
-            this->template GetSingleArgument<bool>("float16_compute", false)) {}
+            this->template GetSingleArgument<bool>("float16_compute", false)) {
+    CAFFE_ENFORCE(
+        this->template GetSingleArgument<std::string>("activation", "")
+            .empty(),
+        "FC with a fused activation has no gradient");
+  }
   ~FullyConnectedGradientOp() {}
 
   template <
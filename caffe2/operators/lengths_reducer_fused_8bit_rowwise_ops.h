@@ -5,10 +5,13 @@
 #include "caffe2/core/logging.h"
 #include "caffe2/core/operator.h"
 #include "caffe2/operators/fused_rowwise_8bit_conversion_ops.h"
+#include "caffe2/operators/lengths_reducer_parallel.h"
 #include "caffe2/operators/reducer_functors.h"
 #include "caffe2/perfkernels/fused_8bit_rowwise_embedding_lookup.h"
 #include "caffe2/utils/math.h"
 #ifdef USE_FBGEMM
+#include <atomic>
+
 #include "fbgemm/Fbgemm.h"
 #endif
 
@@ -22,7 +25,8 @@ class SparseLengthsFused8BitRowwiseOp : public Operator<Context> {
       "Cannot have with_weights and is_mean a the same time");
 
   USE_OPERATOR_CONTEXT_FUNCTIONS;
-  USE_SIMPLE_CTOR_DTOR(SparseLengthsFused8BitRowwiseOp)
+  SparseLengthsFused8BitRowwiseOp(const OperatorDef& operator_def, Workspace* ws)
+      : Operator<Context>(operator_def, ws), ws_(ws) {}
 
   bool RunOnDevice() override {
     return DispatchHelper<TensorTypes<int32_t, int64_t>>::call(
@@ -87,28 +91,42 @@ class SparseLengthsFused8BitRowwiseOp : public Operator<Context> {
       }
     }
 
-    bool success;
-    if (std::is_same<IndexType, std::int32_t>::value) {
-      success = kernel32_(
-          output_size,
-          index_size,
-          data_size,
-          input_data,
-          indices.template data<std::int32_t>(),
-          lengths_data,
-          weights,
-          output_data);
-    } else {
-      success = kernel64_(
-          output_size,
-          index_size,
-          data_size,
-          input_data,
-          indices.template data<std::int64_t>(),
-          lengths_data,
-          weights,
-          output_data);
-    }
+    std::atomic<bool> success{true};
+    ParallelForSegments(
+        ws_,
+        lengths_data,
+        output_size,
+        index_size,
+        [&](int64_t segment_begin,
+            int64_t segment_end,
+            int64_t index_begin,
+            int64_t index_end) {
+          bool chunk_success;
+          if (std::is_same<IndexType, std::int32_t>::value) {
+            chunk_success = kernel32_(
+                segment_end - segment_begin,
+                index_end - index_begin,
+                data_size,
+                input_data,
+                indices.template data<std::int32_t>() + index_begin,
+                lengths_data + segment_begin,
+                weights ? weights + index_begin : nullptr,
+                output_data + segment_begin * block_size);
+          } else {
+            chunk_success = kernel64_(
+                segment_end - segment_begin,
+                index_end - index_begin,
+                data_size,
+                input_data,
+                indices.template data<std::int64_t>() + index_begin,
+                lengths_data + segment_begin,
+                weights ? weights + index_begin : nullptr,
+                output_data + segment_begin * block_size);
+          }
+          if (!chunk_success) {
+            success = false;
+          }
+        });
 
     if (success) {
       return true;
@@ -140,17 +158,27 @@ class SparseLengthsFused8BitRowwiseOp : public Operator<Context> {
 
     return false;
 #else
-    Fused8BitRowwiseEmbeddingLookup(
-        block_size,
+    ParallelForSegments(
+        ws_,
+        lengths_data,
         output_size,
         index_size,
-        data_size,
-        input_data,
-        indices.template data<IndexType>(),
-        lengths_data,
-        weights,
-        is_mean,
-        output_data);
+        [&](int64_t segment_begin,
+            int64_t segment_end,
+            int64_t index_begin,
+            int64_t index_end) {
+          Fused8BitRowwiseEmbeddingLookup(
+              block_size,
+              segment_end - segment_begin,
+              index_end - index_begin,
+              data_size,
+              input_data,
+              indices.template data<IndexType>() + index_begin,
+              lengths_data + segment_begin,
+              weights ? weights + index_begin : nullptr,
+              is_mean,
+              output_data + segment_begin * block_size);
+        });
 
     return true;
 #endif
@@ -163,8 +191,10 @@ class SparseLengthsFused8BitRowwiseOp : public Operator<Context> {
     LENGTHS = 2 + with_weights,
   };
 
-#ifdef USE_FBGEMM
  private:
+  Workspace* ws_;
+
+#ifdef USE_FBGEMM
   std::int64_t last_block_size{-1};
   fbgemm::EmbeddingSpMDMKernelSignature<std::uint8_t, std::int32_t>::Type
       kernel32_;
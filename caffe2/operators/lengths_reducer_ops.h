@@ -1,6 +1,7 @@
 #pragma once
 #include "caffe2/core/context.h"
 #include "caffe2/core/operator.h"
+#include "caffe2/operators/lengths_reducer_parallel.h"
 #include "caffe2/perfkernels/embedding_lookup.h"
 
 namespace caffe2 {
@@ -18,9 +19,8 @@ template <
 class CPUSparseLengthsReductionOp : public Operator<CPUContext> {
  public:
   USE_OPERATOR_FUNCTIONS(CPUContext);
-  template <class... Args>
-  explicit CPUSparseLengthsReductionOp(Args&&... args)
-      : Operator<CPUContext>(std::forward<Args>(args)...) {
+  CPUSparseLengthsReductionOp(const OperatorDef& operator_def, Workspace* ws)
+      : Operator<CPUContext>(operator_def, ws), ws_(ws) {
     static_assert(
         !(USE_WEIGHT & USE_MEAN), "Cannot both specify weight and mean.");
   }
@@ -76,19 +76,33 @@ class CPUSparseLengthsReductionOp : public Operator<CPUContext> {
       in_weight = weightInput.template data<T>();
     }
 
-    // delegate work to perfkernel that branches based on architecture
-    EmbeddingLookup<IndexType, InputType, T, USE_POSITIONAL_WEIGHT>(
-        D,
+    // delegate work to perfkernel that branches based on architecture, on
+    // large batches once per range of segments on each thread
+    ParallelForSegments(
+        ws_,
+        lengths,
         M,
         indices_size,
-        N,
-        in_data,
-        indices,
-        lengths,
-        in_weight,
-        nullptr, // scale_bias field is only used in SparseLengths8BitsRowwiseOp
-        USE_MEAN,
-        out_data);
+        [&](int64_t segment_begin,
+            int64_t segment_end,
+            int64_t index_begin,
+            int64_t index_end) {
+          EmbeddingLookup<IndexType, InputType, T, USE_POSITIONAL_WEIGHT>(
+              D,
+              segment_end - segment_begin,
+              index_end - index_begin,
+              N,
+              in_data,
+              indices + index_begin,
+              lengths + segment_begin,
+              // positional weights are indexed by the position in a segment
+              in_weight && !USE_POSITIONAL_WEIGHT ? in_weight + index_begin
+                                                  : in_weight,
+              nullptr, // scale_bias field is only used in
+                       // SparseLengths8BitsRowwiseOp
+              USE_MEAN,
+              out_data + segment_begin * D);
+        });
     return true;
   }
 
@@ -100,6 +114,9 @@ class CPUSparseLengthsReductionOp : public Operator<CPUContext> {
     LENGTHS = 2 + USE_WEIGHT, // 2 in SparseLengths[Sum, Mean],
                               // 3 in SparseLengthsWeightedSum
   };
+
+ private:
+  Workspace* ws_;
 };
 
 } // namespace caffe2
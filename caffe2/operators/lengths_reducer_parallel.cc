@@ -0,0 +1,53 @@
+#include "caffe2/operators/lengths_reducer_parallel.h"
+
+C10_DEFINE_int(
+    caffe2_sparse_lengths_parallel_min_indices,
+    8192,
+    "SparseLengths reductions with at least this many indices per thread of "
+    "the workspace thread pool are split between its threads. 0 disables "
+    "splitting");
+
+namespace caffe2 {
+
+bool PartitionSegmentsByLength(
+    const int* lengths,
+    int64_t num_segments,
+    int64_t index_size,
+    int num_chunks,
+    std::vector<int64_t>* segment_begin,
+    std::vector<int64_t>* index_begin) {
+  int64_t total = 0;
+  for (int64_t m = 0; m < num_segments; ++m) {
+    if (lengths[m] < 0) {
+      return false;
+    }
+    total += lengths[m];
+  }
+  if (total != index_size) {
+    return false;
+  }
+
+  const int64_t cost = index_size + num_segments;
+  segment_begin->assign(1, 0);
+  index_begin->assign(1, 0);
+  int64_t acc_cost = 0;
+  int64_t acc_indices = 0;
+  for (int64_t m = 0; m < num_segments; ++m) {
+    acc_cost += lengths[m] + 1;
+    acc_indices += lengths[m];
+    // Chunk c ends at the first segment by which c + 1 chunks' worth of the
+    // total cost is covered.
+    const int64_t c = segment_begin->size();
+    if (c < num_chunks && acc_cost * num_chunks >= cost * c) {
+      segment_begin->push_back(m + 1);
+      index_begin->push_back(acc_indices);
+    }
+  }
+  if (segment_begin->back() != num_segments) {
+    segment_begin->push_back(num_segments);
+    index_begin->push_back(index_size);
+  }
+  return true;
+}
+
+} // namespace caffe2
@@ -0,0 +1,97 @@
+#ifndef CAFFE2_OPERATORS_LENGTHS_REDUCER_PARALLEL_H_
+#define CAFFE2_OPERATORS_LENGTHS_REDUCER_PARALLEL_H_
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <vector>
+
+#include "c10/util/Flags.h"
+#include "caffe2/core/common.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/utils/threadpool/ThreadPool.h"
+
+C10_DECLARE_int(caffe2_sparse_lengths_parallel_min_indices);
+
+namespace caffe2 {
+
+// Splits the segments [0, num_segments) of a SparseLengths reduction into at
+// most `num_chunks` consecutive ranges of about the same cost, counting the
+// cost of a segment as its length plus one, so that a few long bags do not
+// end up on the same thread. On return, chunk c covers the segments
+// [(*segment_begin)[c], (*segment_begin)[c + 1]) and the indices
+// [(*index_begin)[c], (*index_begin)[c + 1]).
+//
+// Returns false, without partitioning, if a length is negative or the
+// lengths do not sum up to `index_size`.
+CAFFE2_API bool PartitionSegmentsByLength(
+    const int* lengths,
+    int64_t num_segments,
+    int64_t index_size,
+    int num_chunks,
+    std::vector<int64_t>* segment_begin,
+    std::vector<int64_t>* index_begin);
+
+// Runs f(segment_begin, segment_end, index_begin, index_end) over the
+// segments of a SparseLengths reduction, split between the threads of the
+// thread pool of `ws` when there are at least
+// --caffe2_sparse_lengths_parallel_min_indices indices per thread, and as a
+// single call on the calling thread otherwise (or if the lengths are
+// malformed, so that the kernel reports the error).
+// The first exception thrown by a chunk is rethrown after all of them ran.
+template <typename F>
+void ParallelForSegments(
+    Workspace* ws,
+    const int* lengths,
+    int64_t num_segments,
+    int64_t index_size,
+    F f) {
+  const int64_t min_indices = FLAGS_caffe2_sparse_lengths_parallel_min_indices;
+  ThreadPool* pool = nullptr;
+  int num_chunks = 1;
+  // the pool is only created once a reduction is large enough to use it
+  if (ws && min_indices > 0 && index_size >= 2 * min_indices) {
+    pool = ws->GetThreadPool();
+    num_chunks = static_cast<int>(std::min<int64_t>(
+        pool->getNumThreads(),
+        std::min(num_segments, index_size / min_indices)));
+  }
+  std::vector<int64_t> segment_begin;
+  std::vector<int64_t> index_begin;
+  if (num_chunks < 2 ||
+      !PartitionSegmentsByLength(
+          lengths,
+          num_segments,
+          index_size,
+          num_chunks,
+          &segment_begin,
+          &index_begin)) {
+    f(0, num_segments, 0, index_size);
+    return;
+  }
+
+  std::mutex error_mutex;
+  std::exception_ptr error;
+  pool->run(
+      [&](int /* thread_id */, size_t c) {
+        try {
+          f(segment_begin[c],
+            segment_begin[c + 1],
+            index_begin[c],
+            index_begin[c + 1]);
+        } catch (...) {
+          std::lock_guard<std::mutex> guard(error_mutex);
+          if (!error) {
+            error = std::current_exception();
+          }
+        }
+      },
+      segment_begin.size() - 1);
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+} // namespace caffe2
+
+#endif // CAFFE2_OPERATORS_LENGTHS_REDUCER_PARALLEL_H_
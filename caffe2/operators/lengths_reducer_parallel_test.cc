@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include "caffe2/operators/lengths_reducer_parallel.h"
+
+namespace caffe2 {
+
+TEST(PartitionSegmentsByLengthTest, BalancesSkewedLengths) {
+  // one long bag followed by many short ones
+  std::vector<int> lengths = {1000};
+  for (int i = 0; i < 999; ++i) {
+    lengths.push_back(1);
+  }
+  std::vector<int64_t> segment_begin;
+  std::vector<int64_t> index_begin;
+  ASSERT_TRUE(PartitionSegmentsByLength(
+      lengths.data(), lengths.size(), 1999, 2, &segment_begin, &index_begin));
+
+  // the first chunk takes the long bag and a quarter of the short ones, which
+  // cost about as much as the other three quarters
+  EXPECT_EQ(segment_begin, (std::vector<int64_t>{0, 251, 1000}));
+  EXPECT_EQ(index_begin, (std::vector<int64_t>{0, 1250, 1999}));
+}
+
+TEST(PartitionSegmentsByLengthTest, CoversAllSegments) {
+  const std::vector<int> lengths = {3, 0, 5, 2, 0, 0, 7, 1, 4};
+  std::vector<int64_t> segment_begin;
+  std::vector<int64_t> index_begin;
+  for (int num_chunks = 1; num_chunks <= 12; ++num_chunks) {
+    ASSERT_TRUE(PartitionSegmentsByLength(
+        lengths.data(),
+        lengths.size(),
+        22,
+        num_chunks,
+        &segment_begin,
+        &index_begin));
+    ASSERT_LE(segment_begin.size(), num_chunks + 1);
+    ASSERT_EQ(segment_begin.size(), index_begin.size());
+    EXPECT_EQ(segment_begin.front(), 0);
+    EXPECT_EQ(segment_begin.back(), lengths.size());
+    for (size_t c = 0; c + 1 < segment_begin.size(); ++c) {
+      EXPECT_LT(segment_begin[c], segment_begin[c + 1]);
+      int64_t indices = 0;
+      for (auto m = segment_begin[c]; m < segment_begin[c + 1]; ++m) {
+        indices += lengths[m];
+      }
+      EXPECT_EQ(index_begin[c + 1] - index_begin[c], indices);
+    }
+  }
+}
+
+TEST(PartitionSegmentsByLengthTest, RejectsMalformedLengths) {
+  std::vector<int64_t> segment_begin;
+  std::vector<int64_t> index_begin;
+  const std::vector<int> lengths = {2, 3};
+  EXPECT_FALSE(PartitionSegmentsByLength(
+      lengths.data(), lengths.size(), 4, 2, &segment_begin, &index_begin));
+  const std::vector<int> negative = {2, -1, 3};
+  EXPECT_FALSE(PartitionSegmentsByLength(
+      negative.data(), negative.size(), 4, 2, &segment_begin, &index_begin));
+}
+
+} // namespace caffe2
@@ -121,5 +121,201 @@ void fuseConvBN(nom::repr::NNModule* nn, caffe2::Workspace* ws) {
 
 REGISTER_WS_OPT_PASS_FROM_FUNC(FuseConvBN, fuseConvBN);
 
+void fuseFCActivation(repr::NNModule* nn) {
+  // FC ops whose engine, device or arguments do not allow an activation are
+  // left as they are.
+  auto should_fuse = [](const repr::FC& fc) {
+    const auto annotation = fc.getAnnotation();
+    if (!annotation || !isa<Caffe2Annotation>(annotation)) {
+      return false;
+    }
+    const auto& op = dyn_cast<Caffe2Annotation>(annotation)->getOperatorDef();
+    if (op.type() != "FC" || !op.engine().empty()) {
+      return false;
+    }
+    const auto device_type = op.device_option().device_type();
+    if (device_type != PROTO_CPU && device_type != PROTO_CUDA) {
+      return false;
+    }
+    for (const auto& arg : op.arg()) {
+      if (arg.name() == "activation") {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  for (const std::string activation : {"Relu", "Sigmoid", "Tanh"}) {
+    auto is_activation = [&activation](repr::NNGraph::NodeRef node) {
+      return repr::nn::is<repr::NeuralNetOperator>(node) &&
+          repr::nn::get<repr::NeuralNetOperator>(node)->getName() ==
+          activation;
+    };
+    auto postprocess = [&activation](repr::NNGraph::NodeRef fc_node) {
+      auto fc = repr::nn::get<repr::FC>(fc_node);
+      auto annotation = fc->getMutableAnnotation();
+      if (!annotation || !isa<Caffe2Annotation>(annotation)) {
+        return;
+      }
+      auto* op =
+          dyn_cast<Caffe2Annotation>(annotation)->getMutableOperatorDef();
+      auto* arg = op->add_arg();
+      arg->set_name("activation");
+      arg->set_s(activation);
+    };
+    fuseActivationIf<repr::FC>(nn, is_activation, should_fuse, postprocess);
+  }
+}
+
+REGISTER_OPT_PASS_FROM_FUNC(FuseFCActivation, fuseFCActivation);
+
+namespace {
+
+// How the inputs of a per-parameter optimizer op map to the inputs of its
+// multi-tensor variant, which takes the per-parameter inputs of every merged
+// op followed by the shared ones.
+struct MultiTensorOptimizer {
+  std::string type;
+  std::string multi_type;
+  std::vector<int> per_param_inputs;
+  std::vector<int> shared_inputs;
+  size_t num_outputs;
+};
+
+std::string blobName(repr::NNGraph::NodeRef node) {
+  return repr::nn::get<repr::NeuralNetData>(node)->getName();
+}
+
+// The merged op runs where the last op of the group was, so the ops in
+// between must not overwrite the blobs the earlier ops of the group read or
+// write.
+bool canMoveToLast(
+    const repr::BasicBlockType<repr::NNGraph>& bb,
+    const std::vector<repr::NNGraph::NodeRef>& group) {
+  const std::unordered_set<repr::NNGraph::NodeRef> members(
+      group.begin(), group.end());
+  std::unordered_set<std::string> blobs;
+  for (const auto& instr : bb.getInstructions()) {
+    if (instr == group.back()) {
+      return true;
+    }
+    if (members.count(instr)) {
+      for (const auto& input : repr::nn::getInputs(instr)) {
+        blobs.insert(blobName(input));
+      }
+      for (const auto& output : repr::nn::getOutputs(instr)) {
+        blobs.insert(blobName(output));
+      }
+      continue;
+    }
+    for (const auto& output : repr::nn::getOutputs(instr)) {
+      if (blobs.count(blobName(output))) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void fuseMultiTensorOptimizer(
+    repr::NNModule* nn,
+    const MultiTensorOptimizer& optimizer) {
+  const size_t num_inputs =
+      optimizer.per_param_inputs.size() + optimizer.shared_inputs.size();
+
+  for (auto& bbNode : nn->controlFlow.getMutableNodes()) {
+    auto* bb = bbNode->mutableData();
+
+    // Ops of the same group have the same shared inputs and the same
+    // OperatorDef, up to the inputs, outputs and name.
+    std::vector<std::vector<repr::NNGraph::NodeRef>> groups;
+    std::map<std::pair<std::vector<repr::NNGraph::NodeRef>, std::string>, size_t>
+        group_of_key;
+    for (const auto& instr : bb->getInstructions()) {
+      auto* nnOp = repr::nn::get<repr::NeuralNetOperator>(instr);
+      const auto annotation = nnOp->getAnnotation();
+      NOM_REQUIRE_OR_CONT(annotation && isa<Caffe2Annotation>(annotation));
+      auto op = dyn_cast<Caffe2Annotation>(annotation)->getOperatorDef();
+      NOM_REQUIRE_OR_CONT(op.type() == optimizer.type);
+
+      const auto inputs = repr::nn::getInputs(instr);
+      const auto outputs = repr::nn::getOutputs(instr);
+      NOM_REQUIRE_OR_CONT(inputs.size() == num_inputs);
+      NOM_REQUIRE_OR_CONT(outputs.size() == optimizer.num_outputs);
+      bool consumed = false;
+      for (const auto& output : outputs) {
+        consumed = consumed || repr::nn::hasConsumer(output);
+      }
+      NOM_REQUIRE_OR_CONT(!consumed);
+
+      std::vector<repr::NNGraph::NodeRef> shared;
+      for (int index : optimizer.shared_inputs) {
+        shared.push_back(inputs[index]);
+      }
+      op.clear_input();
+      op.clear_output();
+      op.clear_name();
+      auto key = std::make_pair(shared, op.SerializeAsString());
+      auto it = group_of_key.find(key);
+      if (it == group_of_key.end()) {
+        group_of_key.emplace(key, groups.size());
+        groups.push_back({instr});
+      } else {
+        groups[it->second].push_back(instr);
+      }
+    }
+
+    for (const auto& group : groups) {
+      NOM_REQUIRE_OR_CONT(group.size() > 1);
+      NOM_REQUIRE_OR_CONT(canMoveToLast(*bb, group));
+
+      auto multi_op = dyn_cast<Caffe2Annotation>(
+                          repr::nn::get<repr::NeuralNetOperator>(group.front())
+                              ->getAnnotation())
+                          ->getOperatorDef();
+      multi_op.set_type(optimizer.multi_type);
+      multi_op.clear_input();
+      multi_op.clear_output();
+      multi_op.clear_name();
+      auto multi_node =
+          nn->dataFlow.createNode(convertToNeuralNetOperator(multi_op));
+      // None of the merged ops has its outputs consumed, so they can all be
+      // computed where the last one was.
+      bb->insertInstructionBefore(multi_node, group.back());
+
+      const auto shared_inputs = repr::nn::getInputs(group.front());
+      for (const auto& node : group) {
+        const auto inputs = repr::nn::getInputs(node);
+        for (int index : optimizer.per_param_inputs) {
+          nn->dataFlow.createEdge(inputs[index], multi_node);
+        }
+      }
+      for (int index : optimizer.shared_inputs) {
+        nn->dataFlow.createEdge(shared_inputs[index], multi_node);
+      }
+      for (const auto& node : group) {
+        for (const auto& output : repr::nn::getOutputs(node)) {
+          nn->dataFlow.createEdge(multi_node, output);
+        }
+      }
+      for (const auto& node : group) {
+        nn->dataFlow.deleteNode(node);
+      }
+    }
+  }
+}
+
+} // namespace
+
+void fuseMultiTensorOptimizers(repr::NNModule* nn) {
+  // MomentumSGDUpdate takes (grad, moment, lr, param), Adam takes
+  // (param, moment_1, moment_2, grad, lr, iter).
+  fuseMultiTensorOptimizer(
+      nn, {"MomentumSGDUpdate", "MultiMomentumSGDUpdate", {0, 1, 3}, {2}, 3});
+  fuseMultiTensorOptimizer(nn, {"Adam", "MultiAdam", {0, 1, 2, 3}, {4, 5}, 3});
+}
+
+REGISTER_OPT_PASS_FROM_FUNC(FuseMultiTensorOptimizers, fuseMultiTensorOptimizers);
+
 } // namespace opt
 } // namespace caffe2
@@ -27,18 +27,32 @@ using namespace nom;
 
 CAFFE2_API void fuseConvBN(repr::NNModule* nn, caffe2::Workspace* ws);
 
-// Generic activation fusion helper.
+// Sets the "activation" argument of FC ops that are followed by a Relu,
+// Sigmoid or Tanh, and removes the activation op.
+CAFFE2_API void fuseFCActivation(repr::NNModule* nn);
+
+// Replaces the MomentumSGDUpdate (resp. Adam) ops of a basic block that share
+// their learning rate (and iteration), device and arguments by a single
+// MultiMomentumSGDUpdate (resp. MultiAdam) op, which updates all their
+// parameters with one kernel launch on CUDA. Only ops whose outputs are not
+// consumed in the net are merged, so that merging cannot create cycles.
+CAFFE2_API void fuseMultiTensorOptimizers(repr::NNModule* nn);
+
+// Generic activation fusion helper, for activations that are recognized by a
+// predicate rather than by their type.
 //
 // \tparam OperationT The operator to be fused.
-// \tparam ActivationT The activation to be fused.
 // \param nn Neural network module to be modified in place
+// \param is_activation Given the node consuming the output of the op, check
+// whether it is an activation to be fused
 // \param should_fuse Given a conv op, check whether we want to fuse it with
 // subsequent relu or not
 // \param postprocess Functor to postprocess the conv node,
 // attaching additional attributes if necessary
-template <typename OperationT, typename ActivationT>
-C10_EXPORT void fuseActivation(
+template <typename OperationT>
+C10_EXPORT void fuseActivationIf(
     repr::NNModule* nn,
+    std::function<bool(repr::NNGraph::NodeRef node)> is_activation,
     std::function<bool(const OperationT& conv)> should_fuse,
     std::function<void(repr::NNGraph::NodeRef conv_node)> postprocess) {
   for (auto node_pair : repr::nn::dataIterator<OperationT>(nn->dataFlow)) {
@@ -57,7 +71,7 @@ C10_EXPORT void fuseActivation(
     if (consumers.size() != 1) {
       continue;
     }
-    if (!repr::nn::is<ActivationT>(consumers.front())) {
+    if (!is_activation(consumers.front())) {
       continue;
     }
     auto relu_node = consumers.front();
@@ -116,6 +130,29 @@ C10_EXPORT void fuseActivation(
   }
 }
 
+// Generic activation fusion helper.
+//
+// \tparam OperationT The operator to be fused.
+// \tparam ActivationT The activation to be fused.
+// \param nn Neural network module to be modified in place
+// \param should_fuse Given a conv op, check whether we want to fuse it with
+// subsequent relu or not
+// \param postprocess Functor to postprocess the conv node,
+// attaching additional attributes if necessary
+template <typename OperationT, typename ActivationT>
+C10_EXPORT void fuseActivation(
+    repr::NNModule* nn,
+    std::function<bool(const OperationT& conv)> should_fuse,
+    std::function<void(repr::NNGraph::NodeRef conv_node)> postprocess) {
+  fuseActivationIf<OperationT>(
+      nn,
+      [](repr::NNGraph::NodeRef node) {
+        return repr::nn::is<ActivationT>(node);
+      },
+      should_fuse,
+      postprocess);
+}
+
 } // namespace opt
 } // namespace caffe2
 
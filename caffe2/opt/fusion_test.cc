@@ -0,0 +1,154 @@
+#include "caffe2/core/common.h"
+#include "caffe2/opt/converter.h"
+#include "caffe2/opt/fusion.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+caffe2::OperatorDef* addOp(
+    caffe2::NetDef* net,
+    const std::string& type,
+    const std::vector<std::string>& inputs,
+    const std::string& output) {
+  caffe2::OperatorDef* def = net->add_op();
+  def->set_type(type);
+  for (const auto& input : inputs) {
+    def->add_input(input);
+  }
+  def->add_output(output);
+  return def;
+}
+
+std::string activationOf(const caffe2::OperatorDef& op) {
+  for (const auto& arg : op.arg()) {
+    if (arg.name() == "activation") {
+      return arg.s();
+    }
+  }
+  return "";
+}
+
+} // namespace
+
+TEST(FusionTest, FCActivation) {
+  caffe2::NetDef net;
+  addOp(&net, "FC", {"X", "W0", "b0"}, "Y0");
+  addOp(&net, "Relu", {"Y0"}, "Z0");
+  addOp(&net, "FC", {"Z0", "W1", "b1"}, "Y1");
+  addOp(&net, "Sigmoid", {"Y1"}, "Z1");
+  addOp(&net, "FC", {"Z1", "W2", "b2"}, "Y2");
+  addOp(&net, "Tanh", {"Y2"}, "Z2");
+  net.add_external_input("X");
+  net.add_external_output("Z2");
+
+  auto nn = caffe2::convertToNNModule(net);
+  caffe2::opt::fuseFCActivation(&nn);
+  auto optimized_net = caffe2::convertToCaffe2Proto(nn, net);
+
+  ASSERT_EQ(optimized_net.op_size(), 3);
+  std::map<std::string, std::string> activations;
+  for (const auto& op : optimized_net.op()) {
+    EXPECT_EQ(op.type(), "FC");
+    activations[op.output(0)] = activationOf(op);
+  }
+  EXPECT_EQ(activations["Z0"], "Relu");
+  EXPECT_EQ(activations["Z1"], "Sigmoid");
+  EXPECT_EQ(activations["Z2"], "Tanh");
+}
+
+TEST(FusionTest, FCActivationNeedsSoleConsumer) {
+  caffe2::NetDef net;
+  addOp(&net, "FC", {"X", "W", "b"}, "Y");
+  addOp(&net, "Relu", {"Y"}, "Z");
+  addOp(&net, "Sum", {"Y", "Z"}, "S");
+  net.add_external_input("X");
+  net.add_external_output("S");
+
+  auto nn = caffe2::convertToNNModule(net);
+  caffe2::opt::fuseFCActivation(&nn);
+  auto optimized_net = caffe2::convertToCaffe2Proto(nn, net);
+
+  ASSERT_EQ(optimized_net.op_size(), 3);
+  for (const auto& op : optimized_net.op()) {
+    EXPECT_EQ(activationOf(op), "");
+  }
+}
+
+TEST(FusionTest, FCActivationSkipsEngines) {
+  caffe2::NetDef net;
+  addOp(&net, "FC", {"X", "W", "b"}, "Y")->set_engine("DNNLOWP");
+  addOp(&net, "Relu", {"Y"}, "Z");
+  net.add_external_input("X");
+  net.add_external_output("Z");
+
+  auto nn = caffe2::convertToNNModule(net);
+  caffe2::opt::fuseFCActivation(&nn);
+  auto optimized_net = caffe2::convertToCaffe2Proto(nn, net);
+
+  EXPECT_EQ(optimized_net.op_size(), 2);
+}
+
+namespace {
+
+caffe2::OperatorDef* addMomentumSGDUpdate(
+    caffe2::NetDef* net,
+    const std::string& param,
+    const std::string& lr) {
+  caffe2::OperatorDef* def = net->add_op();
+  def->set_type("MomentumSGDUpdate");
+  for (const auto& input :
+       {param + "_grad", param + "_momentum", lr, param}) {
+    def->add_input(input);
+  }
+  for (const auto& output : {param + "_grad", param + "_momentum", param}) {
+    def->add_output(output);
+  }
+  return def;
+}
+
+} // namespace
+
+TEST(FusionTest, MultiTensorMomentumSGD) {
+  caffe2::NetDef net;
+  addMomentumSGDUpdate(&net, "W0", "lr");
+  addMomentumSGDUpdate(&net, "W1", "lr");
+  addOp(&net, "Scale", {"lr"}, "lr2");
+  addMomentumSGDUpdate(&net, "W2", "lr");
+  addMomentumSGDUpdate(&net, "W3", "lr2");
+
+  auto nn = caffe2::convertToNNModule(net);
+  caffe2::opt::fuseMultiTensorOptimizers(&nn);
+  auto optimized_net = caffe2::convertToCaffe2Proto(nn, net);
+
+  ASSERT_EQ(optimized_net.op_size(), 3);
+  int num_multi = 0;
+  for (const auto& op : optimized_net.op()) {
+    if (op.type() != "MultiMomentumSGDUpdate") {
+      continue;
+    }
+    ++num_multi;
+    ASSERT_EQ(op.input_size(), 10);
+    ASSERT_EQ(op.output_size(), 9);
+    EXPECT_EQ(op.input(0), "W0_grad");
+    EXPECT_EQ(op.input(5), "W1");
+    EXPECT_EQ(op.input(8), "W2");
+    EXPECT_EQ(op.input(9), "lr");
+    EXPECT_EQ(op.output(7), "W2_momentum");
+  }
+  EXPECT_EQ(num_multi, 1);
+}
+
+TEST(FusionTest, MultiTensorMomentumSGDKeepsOverwrittenInputs) {
+  caffe2::NetDef net;
+  addMomentumSGDUpdate(&net, "W0", "lr");
+  // reads W0_grad before the gradient is overwritten
+  addOp(&net, "Scale", {"W1_grad"}, "W0_grad");
+  addMomentumSGDUpdate(&net, "W1", "lr");
+
+  auto nn = caffe2::convertToNNModule(net);
+  caffe2::opt::fuseMultiTensorOptimizers(&nn);
+  auto optimized_net = caffe2::convertToCaffe2Proto(nn, net);
+
+  EXPECT_EQ(optimized_net.op_size(), 3);
+}
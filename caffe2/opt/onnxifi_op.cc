@@ -2,6 +2,9 @@
 #include "caffe2/operators/slice_op.h"
 #include "caffe2/opt/bound_shape_inferencer.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace caffe2 {
 
 namespace {
@@ -198,10 +201,110 @@ OnnxifiOp<CPUContext>::buildInitializationList(
   return descs;
 }
 
+template <>
+void OnnxifiOp<CPUContext>::buildBatchBuckets(
+    Workspace* ws,
+    const std::vector<uint64_t>& property_pointers,
+    const std::vector<int>& batch_sizes) {
+  CAFFE_ENFORCE(
+      !use_onnx_, "Batch size buckets are only supported for Caffe2 models");
+  std::vector<int> sorted_batch_sizes(batch_sizes);
+  std::sort(sorted_batch_sizes.begin(), sorted_batch_sizes.end());
+  sorted_batch_sizes.erase(
+      std::unique(sorted_batch_sizes.begin(), sorted_batch_sizes.end()),
+      sorted_batch_sizes.end());
+  CAFFE_ENFORCE_GT(sorted_batch_sizes.front(), 0);
+  CAFFE_ENFORCE_LE(
+      sorted_batch_sizes.back(),
+      max_batch_size_,
+      "Batch size buckets cannot exceed max_batch_size");
+
+  // The shapes the model was compiled with, at max_batch_size
+  int shape_arg_idx = -1;
+  for (int i = 0; i < netdef_.arg_size(); ++i) {
+    if (netdef_.arg(i).name() == "input_shape_info") {
+      shape_arg_idx = i;
+      break;
+    }
+  }
+  CAFFE_ENFORCE_GE(
+      shape_arg_idx, 0, "Batch size buckets require input_shape_info");
+  std::unordered_map<std::string, ShapeInfo> max_shape_info(input_shape_info_);
+  std::unordered_set<std::string> batched_inputs;
+  for (const auto& t : netdef_.arg(shape_arg_idx).tensors()) {
+    std::vector<TensorBoundShape::DimType> dim_type;
+    for (const auto d : t.int32_data()) {
+      dim_type.push_back(static_cast<TensorBoundShape::DimType>(d));
+    }
+    TensorShape shape;
+    shape.set_data_type(t.data_type());
+    for (const auto d : t.dims()) {
+      shape.add_dims(d);
+    }
+    if (!dim_type.empty() && dim_type[0] == TensorBoundShape_DimType_BATCH) {
+      batched_inputs.emplace(t.name());
+    }
+    max_shape_info[t.name()] = ShapeInfo(dim_type, std::move(shape));
+  }
+  input_is_batched_.clear();
+  for (const auto& input : input_names_) {
+    input_is_batched_.push_back(batched_inputs.count(input) > 0);
+  }
+  CAFFE_ENFORCE(
+      input_is_batched_[nominal_batch_idx_],
+      "The nominal batch input ",
+      input_names_[nominal_batch_idx_],
+      " has no batch dimension");
+  padded_inputs_.clear();
+  for (size_t i = 0; i < input_names_.size(); ++i) {
+    padded_inputs_.emplace_back(CPU);
+  }
+
+  for (const int batch_size : sorted_batch_sizes) {
+    NetDef model(netdef_);
+    auto shape_info = max_shape_info;
+    for (auto& t : *model.mutable_arg(shape_arg_idx)->mutable_tensors()) {
+      if (batched_inputs.count(t.name())) {
+        t.set_dims(0, batch_size);
+        shape_info[t.name()].shape.set_dims(0, batch_size);
+      }
+    }
+    std::string model_str;
+    model.SerializeToString(&model_str);
+
+    BatchBucket bucket;
+    bucket.batch_size = batch_size;
+    bucket.key = c10::str(op_id_string_, ":batch_", batch_size);
+    bucket.backend_graph_info =
+        buildBackendGraph(ws, property_pointers, bucket.key, model_str);
+
+    // The output shapes do not change between the runs of a bucket, so they
+    // are inferred once here instead of at every run.
+    BoundShapeSpec spec(batch_size, max_seq_size_);
+    auto bound_shape_inferencer =
+        BoundShapeInferencerRegistry()->Create("C10", spec);
+    bound_shape_inferencer->InferBoundShapeAndType(
+        netdef_, shape_info, nullptr);
+    const auto& inferred = bound_shape_inferencer->shape_info();
+    for (const auto& output : output_names_) {
+      const auto it = inferred.find(output);
+      CAFFE_ENFORCE(
+          it != inferred.end(), "Cannot infer the shape of output ", output);
+      const auto& shape = it->second.shape;
+      bucket.output_dims.emplace_back(shape.dims().begin(), shape.dims().end());
+      bucket.output_is_batched.push_back(
+          shape.dims_size() > 0 &&
+          it->second.getDimType(0) == TensorBoundShape_DimType_BATCH);
+    }
+    batch_buckets_.push_back(std::move(bucket));
+  }
+}
+
 template <>
 void OnnxifiOp<CPUContext>::extractOutputBatchSizes() {
   output_reshape_info_.skip = false;
-  if (use_onnx_ || !adjust_output_batch_) {
+  // The outputs of a bucket are adjusted in RunOnDevice
+  if (use_onnx_ || !adjust_output_batch_ || current_bucket_) {
     output_reshape_info_.skip = true;
     return;
   }
@@ -302,8 +405,38 @@ void OnnxifiOp<CPUContext>::maybeAdjustOutputBatchSizes() {
 template <>
 bool OnnxifiOp<CPUContext>::RunOnDevice() {
   CAFFE_ENFORCE_EQ(input_desc_.size(), InputSize());
+  int64_t batch_size = 0;
+  current_bucket_ = nullptr;
+  if (!batch_buckets_.empty()) {
+    const auto& nominal_input = Input(nominal_batch_idx_);
+    CAFFE_ENFORCE_GT(nominal_input.dim(), 0);
+    batch_size = nominal_input.size(0);
+    current_bucket_ = findBatchBucket(batch_size);
+  }
+  const onnxGraph graph =
+      current_bucket_ ? current_bucket_->backend_graph_info->graph : graph_;
+  const onnxBackend backend =
+      current_bucket_ ? current_bucket_->backend_graph_info->backend : backend_;
+
   for (unsigned i = 0U; i < InputSize(); ++i) {
-    const auto& input_tensor = Input(i);
+    const Tensor* input_ptr = &Input(i);
+    if (current_bucket_ && input_is_batched_[i] &&
+        input_ptr->size(0) < current_bucket_->batch_size) {
+      // Pad the batch with zeros up to the batch size of the bucket
+      auto dims = input_ptr->sizes().vec();
+      dims[0] = current_bucket_->batch_size;
+      auto& padded = padded_inputs_[i];
+      padded.Resize(dims);
+      auto* padded_data =
+          static_cast<char*>(padded.raw_mutable_data(input_ptr->dtype()));
+      std::memcpy(padded_data, input_ptr->raw_data(), input_ptr->nbytes());
+      std::memset(
+          padded_data + input_ptr->nbytes(),
+          0,
+          padded.nbytes() - input_ptr->nbytes());
+      input_ptr = &padded;
+    }
+    const auto& input_tensor = *input_ptr;
     const at::IntArrayRef tensor_dims = input_tensor.sizes();
     auto& tensor_descriptor = input_desc_[i];
     tensor_descriptor.tag = ONNXIFI_TAG_TENSOR_DESCRIPTOR_V1;
@@ -322,6 +455,9 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     tensor_dims_int64_.clear();
     std::vector<size_t> tensor_dims;
     uint64_t type = SetOutputShapeAndType(i, &tensor_dims);
+    if (current_bucket_) {
+      tensor_dims = current_bucket_->output_dims[i];
+    }
     auto& tensor_descriptor = output_desc_[i];
     tensor_descriptor.tag = ONNXIFI_TAG_TENSOR_DESCRIPTOR_V1;
     tensor_descriptor.memoryType = ONNXIFI_MEMORY_TYPE_CPU;
@@ -375,7 +511,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     }
     CAFFE_ENFORCE_EQ(
         (*onnxSetIOAndRunGraphPointer_)(
-            graph_,
+            graph,
             input_desc_.size(),
             input_desc_.data(),
             output_desc_.size(),
@@ -393,7 +529,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
   if (!ext_supported) {
     CAFFE_ENFORCE_EQ(
         lib_->onnxSetGraphIO(
-            graph_,
+            graph,
             input_desc_.size(),
             input_desc_.data(),
             output_desc_.size(),
@@ -403,7 +539,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     input_fence.tag = ONNXIFI_TAG_MEMORY_FENCE_V1;
     input_fence.type = ONNXIFI_SYNCHRONIZATION_EVENT;
     CAFFE_ENFORCE_EQ(
-        lib_->onnxInitEvent(backend_, &input_fence.event),
+        lib_->onnxInitEvent(backend, &input_fence.event),
         ONNXIFI_STATUS_SUCCESS);
     output_fence.tag = ONNXIFI_TAG_MEMORY_FENCE_V1;
     output_fence.type = ONNXIFI_SYNCHRONIZATION_EVENT;
@@ -411,7 +547,7 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
     // Call the async run on backend, signal event on input fence and wait for
     // the event on output fence
     CAFFE_ENFORCE_EQ(
-        lib_->onnxRunGraph(graph_, &input_fence, &output_fence),
+        lib_->onnxRunGraph(graph, &input_fence, &output_fence),
         ONNXIFI_STATUS_SUCCESS);
     CAFFE_ENFORCE_EQ(
         lib_->onnxSignalEvent(input_fence.event), ONNXIFI_STATUS_SUCCESS);
@@ -426,7 +562,15 @@ bool OnnxifiOp<CPUContext>::RunOnDevice() {
         lib_->onnxReleaseEvent(output_fence.event), ONNXIFI_STATUS_SUCCESS);
   }
 
-  if (adjust_output_batch_) {
+  if (current_bucket_) {
+    // Drop the padding of the batched outputs
+    for (int i = 0; i < OutputSize(); ++i) {
+      if (current_bucket_->output_is_batched[i] &&
+          batch_size < current_bucket_->batch_size) {
+        Output(i)->ShrinkTo(batch_size);
+      }
+    }
+  } else if (adjust_output_batch_) {
     maybeAdjustOutputBatchSizes();
   }
   enable_tracing_ = false;
@@ -446,6 +590,12 @@ OPERATOR_SCHEMA(Onnxifi)
     .Arg(
         "initializers",
         "Initialization pair indicating the mapping of the name between NetDef and ONNX model")
+    .Arg(
+        "batch_buckets",
+        "(list of ints) Batch sizes to compile extra backend graphs for. A batch is "
+        "zero-padded to the smallest bucket that fits it, which keeps the shapes "
+        "seen by the backend fixed; batches larger than every bucket run on the "
+        "graph of max_batch_size")
     .Arg(
         "output_resize_hints",
         "A list of key/value pairs indicating which input index to look up for real batch size for the given max output batch size");
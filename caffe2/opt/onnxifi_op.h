@@ -33,6 +33,18 @@ class OnnxifiOp final : public Operator<Context> {
     bool skip{false};
   };
 
+  // A backend graph compiled for a fixed batch size. Batches up to that size
+  // are padded to it, so that the backend always sees the same shapes.
+  struct BatchBucket {
+    int batch_size;
+    onnx::SharedPtrBackendGraphInfo backend_graph_info;
+    std::string key;
+    // Output shapes at this batch size, and whether their first dimension is
+    // the batch
+    std::vector<std::vector<size_t>> output_dims;
+    std::vector<bool> output_is_batched;
+  };
+
  public:
   USE_OPERATOR_CONTEXT_FUNCTIONS;
   explicit OnnxifiOp(const OperatorDef& operator_def, Workspace* ws)
@@ -122,9 +134,20 @@ class OnnxifiOp final : public Operator<Context> {
     // cached backend and therefore there is no need to repeat the above
     // process.
     buildBackendAndGraph(ws, property_pointers, onnx_model_str);
+
+    // Compile one more graph for each batch size bucket
+    const auto batch_sizes =
+        this->template GetRepeatedArgument<int>("batch_buckets");
+    if (!batch_sizes.empty()) {
+      buildBatchBuckets(ws, property_pointers, batch_sizes);
+    }
   }
 
   ~OnnxifiOp() {
+    for (auto& bucket : batch_buckets_) {
+      bucket.backend_graph_info.reset();
+      backend_graph_map_ptr_->remove(bucket.key);
+    }
     backend_graph_shared_ptr_.reset();
     backend_graph_map_ptr_->remove(op_id_string_);
 #ifdef ONNXIFI_ENABLE_EXT
@@ -173,6 +196,24 @@ class OnnxifiOp final : public Operator<Context> {
         this->template GetSingleArgument<std::string>("model_id", "") + ":" +
         this->template GetSingleArgument<std::string>("net_pos", "");
 
+    backend_graph_shared_ptr_ = buildBackendGraph(
+        ws, property_pointers, op_id_string_, onnx_model_str);
+
+    backend_id_ = backend_graph_shared_ptr_->backend_id;
+    backend_ = backend_graph_shared_ptr_->backend;
+    graph_ = backend_graph_shared_ptr_->graph;
+    input_shape_info_ = backend_graph_shared_ptr_->weight_shape_info;
+
+    getExtFunctionPointers();
+  }
+
+  // Returns the backend graph of `onnx_model_str` cached under `key`,
+  // creating it if it is not cached yet.
+  onnx::SharedPtrBackendGraphInfo buildBackendGraph(
+      Workspace* ws,
+      const std::vector<uint64_t>& property_pointers,
+      const std::string& key,
+      const std::string& onnx_model_str) {
     auto initializers =
         this->template GetRepeatedArgument<std::string>("initializers");
     // Build the Onnxifi engine
@@ -263,15 +304,25 @@ class OnnxifiOp final : public Operator<Context> {
       return std::make_shared<onnx::BackendGraphInfo>(
           backend_id, backend, graph, lib_, std::move(weight_shape_info));
     };
-    backend_graph_shared_ptr_ =
-        backend_graph_map_ptr_->insert(op_id_string_, creator);
-
-    backend_id_ = backend_graph_shared_ptr_->backend_id;
-    backend_ = backend_graph_shared_ptr_->backend;
-    graph_ = backend_graph_shared_ptr_->graph;
-    input_shape_info_ = backend_graph_shared_ptr_->weight_shape_info;
+    return backend_graph_map_ptr_->insert(key, creator);
+  }
 
-    getExtFunctionPointers();
+  // Builds the graphs of batch_buckets_ from netdef_, with the first
+  // dimension of its batched inputs set to each of `batch_sizes`.
+  void buildBatchBuckets(
+      Workspace* ws,
+      const std::vector<uint64_t>& property_pointers,
+      const std::vector<int>& batch_sizes);
+
+  // Returns the bucket of the smallest batch size that fits `batch_size`, or
+  // nullptr if the batch should run on the graph of max_batch_size_.
+  const BatchBucket* findBatchBucket(int64_t batch_size) const {
+    for (const auto& bucket : batch_buckets_) {
+      if (batch_size <= bucket.batch_size) {
+        return &bucket;
+      }
+    }
+    return nullptr;
   }
 
   /// Set up function pointer if onnxifi_ext is enabled
@@ -394,6 +445,16 @@ class OnnxifiOp final : public Operator<Context> {
 
   // Whether we enable tracing in one run of inference
   bool enable_tracing_{false};
+
+  // The batch size buckets, sorted by batch size, and the bucket of the
+  // current run
+  std::vector<BatchBucket> batch_buckets_;
+  const BatchBucket* current_bucket_{nullptr};
+
+  // Whether the first dimension of each input is the batch, and the inputs
+  // padded to the batch size of current_bucket_
+  std::vector<bool> input_is_batched_;
+  std::vector<Tensor> padded_inputs_;
 };
 
 } // namespace caffe2
@@ -660,6 +660,9 @@ OperatorDef OnnxifiTransformer::buildOnnxifiOp(
   AddArgument("max_batch_size", opts_.bound_shape_spec.max_batch_size, &op);
   AddArgument("max_seq_size", opts_.bound_shape_spec.max_seq_size, &op);
   AddArgument("nominal_batch_idx", nominal_batch_idx, &op);
+  if (!opts_.use_onnx && !opts_.batch_buckets.empty()) {
+    AddArgument("batch_buckets", opts_.batch_buckets, &op);
+  }
 
   return op;
 }
@@ -34,6 +34,10 @@ struct OnnxifiTransformerOptions final : public BackendTransformOptions {
 
   // Enter loop test mode
   bool loop_test{false};
+
+  // Batch sizes, up to bound_shape_spec.max_batch_size, that the Onnxifi ops
+  // compile extra backend graphs for. Only used with Caffe2 models.
+  std::vector<int> batch_buckets;
 };
 
 class CAFFE2_API OnnxifiTransformer final : public BackendTransformerBase {
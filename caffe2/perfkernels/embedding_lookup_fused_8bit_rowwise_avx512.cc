@@ -0,0 +1,2460 @@
+//// --------------------------
+//// ATTENTION:
+//// THIS CODE IS AUTOGENERATED
+//// BY hp_emblookup_codegen.py
+//// DO NOT MODIFY!!!
+//// --------------------------
+
+#include <c10/util/Half.h>
+#include <immintrin.h>
+namespace caffe2 {
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool Fused8BitRowwiseEmbeddingLookup_int32_t_float_float__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const float* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  const int prefdist_T0 = 32;
+  const int fused_block_size = block_size + 2;
+  int dataInd = 0;
+  if (block_size == 128) {
+    // unrolling 8 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      __m512 vop32 = _mm512_setzero_ps();
+      __m512 vop48 = _mm512_setzero_ps();
+      __m512 vop64 = _mm512_setzero_ps();
+      __m512 vop80 = _mm512_setzero_ps();
+      __m512 vop96 = _mm512_setzero_ps();
+      __m512 vop112 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (0)), vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (16)), vop16);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[16]), _MM_HINT_T0);
+        vop32 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (32)), vop32);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[32]), _MM_HINT_T0);
+        vop48 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (48)), vop48);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[48]), _MM_HINT_T0);
+        vop64 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (64)), vop64);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[64]), _MM_HINT_T0);
+        vop80 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (80)), vop80);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[80]), _MM_HINT_T0);
+        vop96 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (96)), vop96);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[96]), _MM_HINT_T0);
+        vop112 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (112)), vop112);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[112]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[128]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[129]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+        _mm512_storeu_ps(&op[32], vop32);
+        _mm512_storeu_ps(&op[48], vop48);
+        _mm512_storeu_ps(&op[64], vop64);
+        _mm512_storeu_ps(&op[80], vop80);
+        _mm512_storeu_ps(&op[96], vop96);
+        _mm512_storeu_ps(&op[112], vop112);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+        _mm512_storeu_ps(&op[32], _mm512_mul_ps(vop32, vlen_inv));
+        _mm512_storeu_ps(&op[48], _mm512_mul_ps(vop48, vlen_inv));
+        _mm512_storeu_ps(&op[64], _mm512_mul_ps(vop64, vlen_inv));
+        _mm512_storeu_ps(&op[80], _mm512_mul_ps(vop80, vlen_inv));
+        _mm512_storeu_ps(&op[96], _mm512_mul_ps(vop96, vlen_inv));
+        _mm512_storeu_ps(&op[112], _mm512_mul_ps(vop112, vlen_inv));
+      }
+    }
+  } else if (block_size == 64) {
+    // unrolling 4 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      __m512 vop32 = _mm512_setzero_ps();
+      __m512 vop48 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (0)), vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (16)), vop16);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[16]), _MM_HINT_T0);
+        vop32 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (32)), vop32);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[32]), _MM_HINT_T0);
+        vop48 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (48)), vop48);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[48]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[64]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[65]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+        _mm512_storeu_ps(&op[32], vop32);
+        _mm512_storeu_ps(&op[48], vop48);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+        _mm512_storeu_ps(&op[32], _mm512_mul_ps(vop32, vlen_inv));
+        _mm512_storeu_ps(&op[48], _mm512_mul_ps(vop48, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 2 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (0)), vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (16)), vop16);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[16]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[32]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[33]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 1 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (0)), vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[16]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[17]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    const int64_t fused_block_bytes = fused_block_size * 4;
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 16 <= block_size; j += 16) {
+        _mm512_storeu_ps(op + j, _mm512_setzero_ps());
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        const char* ip_next_T0_bytes =
+            reinterpret_cast<const char*>(ip_next_T0);
+        for (int64_t k = 0; k < fused_block_bytes; k += 64) {
+          _mm_prefetch(ip_next_T0_bytes + k, _MM_HINT_T0);
+        }
+        _mm_prefetch(ip_next_T0_bytes + fused_block_bytes - 1, _MM_HINT_T0);
+        j = 0;
+        for (; j + 16 <= block_size; j += 16) {
+          _mm512_storeu_ps(
+              &op[j],
+              _mm512_fmadd_ps(
+                  vwgt, _mm512_loadu_ps(&ip[j]), _mm512_loadu_ps(&op[j])));
+        }
+        for (; j < block_size; j++) {
+          op[j] = std::fma(wgt, ip[j], op[j]);
+        }
+      }
+      if (normalize_by_lengths && lengths[rangeIndex]) {
+        float len_inv = 1.0f / lengths[rangeIndex];
+        __m512 vlen_inv = _mm512_set1_ps(len_inv);
+        j = 0;
+        for (; j + 16 <= block_size; j += 16) {
+          _mm512_storeu_ps(
+              &op[j], _mm512_mul_ps(_mm512_loadu_ps(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool Fused8BitRowwiseEmbeddingLookup_int32_t_float_float_false__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const float* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused8BitRowwiseEmbeddingLookup_int32_t_float_float__avx512<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+bool Fused8BitRowwiseEmbeddingLookup_int32_t_float_float_true__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const float* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused8BitRowwiseEmbeddingLookup_int32_t_float_float__avx512<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool Fused8BitRowwiseEmbeddingLookup_int64_t_float_float__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const float* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  const int64_t prefdist_T0 = 32;
+  const int64_t fused_block_size = block_size + 2;
+  int64_t dataInd = 0;
+  if (block_size == 128) {
+    // unrolling 8 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      __m512 vop32 = _mm512_setzero_ps();
+      __m512 vop48 = _mm512_setzero_ps();
+      __m512 vop64 = _mm512_setzero_ps();
+      __m512 vop80 = _mm512_setzero_ps();
+      __m512 vop96 = _mm512_setzero_ps();
+      __m512 vop112 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (0)), vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (16)), vop16);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[16]), _MM_HINT_T0);
+        vop32 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (32)), vop32);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[32]), _MM_HINT_T0);
+        vop48 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (48)), vop48);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[48]), _MM_HINT_T0);
+        vop64 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (64)), vop64);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[64]), _MM_HINT_T0);
+        vop80 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (80)), vop80);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[80]), _MM_HINT_T0);
+        vop96 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (96)), vop96);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[96]), _MM_HINT_T0);
+        vop112 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (112)), vop112);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[112]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[128]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[129]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+        _mm512_storeu_ps(&op[32], vop32);
+        _mm512_storeu_ps(&op[48], vop48);
+        _mm512_storeu_ps(&op[64], vop64);
+        _mm512_storeu_ps(&op[80], vop80);
+        _mm512_storeu_ps(&op[96], vop96);
+        _mm512_storeu_ps(&op[112], vop112);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+        _mm512_storeu_ps(&op[32], _mm512_mul_ps(vop32, vlen_inv));
+        _mm512_storeu_ps(&op[48], _mm512_mul_ps(vop48, vlen_inv));
+        _mm512_storeu_ps(&op[64], _mm512_mul_ps(vop64, vlen_inv));
+        _mm512_storeu_ps(&op[80], _mm512_mul_ps(vop80, vlen_inv));
+        _mm512_storeu_ps(&op[96], _mm512_mul_ps(vop96, vlen_inv));
+        _mm512_storeu_ps(&op[112], _mm512_mul_ps(vop112, vlen_inv));
+      }
+    }
+  } else if (block_size == 64) {
+    // unrolling 4 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      __m512 vop32 = _mm512_setzero_ps();
+      __m512 vop48 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (0)), vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (16)), vop16);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[16]), _MM_HINT_T0);
+        vop32 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (32)), vop32);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[32]), _MM_HINT_T0);
+        vop48 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (48)), vop48);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[48]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[64]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[65]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+        _mm512_storeu_ps(&op[32], vop32);
+        _mm512_storeu_ps(&op[48], vop48);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+        _mm512_storeu_ps(&op[32], _mm512_mul_ps(vop32, vlen_inv));
+        _mm512_storeu_ps(&op[48], _mm512_mul_ps(vop48, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 2 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (0)), vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (16)), vop16);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[16]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[32]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[33]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 1 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (0)), vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[16]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[17]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    const int64_t fused_block_bytes = fused_block_size * 4;
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 16 <= block_size; j += 16) {
+        _mm512_storeu_ps(op + j, _mm512_setzero_ps());
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const float* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const float* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        const char* ip_next_T0_bytes =
+            reinterpret_cast<const char*>(ip_next_T0);
+        for (int64_t k = 0; k < fused_block_bytes; k += 64) {
+          _mm_prefetch(ip_next_T0_bytes + k, _MM_HINT_T0);
+        }
+        _mm_prefetch(ip_next_T0_bytes + fused_block_bytes - 1, _MM_HINT_T0);
+        j = 0;
+        for (; j + 16 <= block_size; j += 16) {
+          _mm512_storeu_ps(
+              &op[j],
+              _mm512_fmadd_ps(
+                  vwgt, _mm512_loadu_ps(&ip[j]), _mm512_loadu_ps(&op[j])));
+        }
+        for (; j < block_size; j++) {
+          op[j] = std::fma(wgt, ip[j], op[j]);
+        }
+      }
+      if (normalize_by_lengths && lengths[rangeIndex]) {
+        float len_inv = 1.0f / lengths[rangeIndex];
+        __m512 vlen_inv = _mm512_set1_ps(len_inv);
+        j = 0;
+        for (; j + 16 <= block_size; j += 16) {
+          _mm512_storeu_ps(
+              &op[j], _mm512_mul_ps(_mm512_loadu_ps(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool Fused8BitRowwiseEmbeddingLookup_int64_t_float_float_false__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const float* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused8BitRowwiseEmbeddingLookup_int64_t_float_float__avx512<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+bool Fused8BitRowwiseEmbeddingLookup_int64_t_float_float_true__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const float* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused8BitRowwiseEmbeddingLookup_int64_t_float_float__avx512<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool Fused8BitRowwiseEmbeddingLookup_int32_t_half_float__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const at::Half* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  const int prefdist_T0 = 32;
+  const int fused_block_size = block_size + 4;
+  int dataInd = 0;
+  if (block_size == 128) {
+    // unrolling 8 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      __m512 vop32 = _mm512_setzero_ps();
+      __m512 vop48 = _mm512_setzero_ps();
+      __m512 vop64 = _mm512_setzero_ps();
+      __m512 vop80 = _mm512_setzero_ps();
+      __m512 vop96 = _mm512_setzero_ps();
+      __m512 vop112 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (0)))),
+            vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (16)))),
+            vop16);
+        vop32 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (32)))),
+            vop32);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[32]), _MM_HINT_T0);
+        vop48 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (48)))),
+            vop48);
+        vop64 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (64)))),
+            vop64);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[64]), _MM_HINT_T0);
+        vop80 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (80)))),
+            vop80);
+        vop96 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (96)))),
+            vop96);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[96]), _MM_HINT_T0);
+        vop112 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (112)))),
+            vop112);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[128]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[131]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+        _mm512_storeu_ps(&op[32], vop32);
+        _mm512_storeu_ps(&op[48], vop48);
+        _mm512_storeu_ps(&op[64], vop64);
+        _mm512_storeu_ps(&op[80], vop80);
+        _mm512_storeu_ps(&op[96], vop96);
+        _mm512_storeu_ps(&op[112], vop112);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+        _mm512_storeu_ps(&op[32], _mm512_mul_ps(vop32, vlen_inv));
+        _mm512_storeu_ps(&op[48], _mm512_mul_ps(vop48, vlen_inv));
+        _mm512_storeu_ps(&op[64], _mm512_mul_ps(vop64, vlen_inv));
+        _mm512_storeu_ps(&op[80], _mm512_mul_ps(vop80, vlen_inv));
+        _mm512_storeu_ps(&op[96], _mm512_mul_ps(vop96, vlen_inv));
+        _mm512_storeu_ps(&op[112], _mm512_mul_ps(vop112, vlen_inv));
+      }
+    }
+  } else if (block_size == 64) {
+    // unrolling 4 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      __m512 vop32 = _mm512_setzero_ps();
+      __m512 vop48 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (0)))),
+            vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (16)))),
+            vop16);
+        vop32 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (32)))),
+            vop32);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[32]), _MM_HINT_T0);
+        vop48 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (48)))),
+            vop48);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[64]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[67]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+        _mm512_storeu_ps(&op[32], vop32);
+        _mm512_storeu_ps(&op[48], vop48);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+        _mm512_storeu_ps(&op[32], _mm512_mul_ps(vop32, vlen_inv));
+        _mm512_storeu_ps(&op[48], _mm512_mul_ps(vop48, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 2 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (0)))),
+            vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (16)))),
+            vop16);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[32]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[35]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 1 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (0)))),
+            vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[19]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    alignas(64) at::Half vtmp1[8] = {0};
+    const int64_t fused_block_bytes = fused_block_size * 2;
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 16 <= block_size; j += 16) {
+        _mm512_storeu_ps(op + j, _mm512_setzero_ps());
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        const char* ip_next_T0_bytes =
+            reinterpret_cast<const char*>(ip_next_T0);
+        for (int64_t k = 0; k < fused_block_bytes; k += 64) {
+          _mm_prefetch(ip_next_T0_bytes + k, _MM_HINT_T0);
+        }
+        _mm_prefetch(ip_next_T0_bytes + fused_block_bytes - 1, _MM_HINT_T0);
+        j = 0;
+        for (; j + 16 <= block_size; j += 16) {
+          _mm512_storeu_ps(
+              &op[j],
+              _mm512_fmadd_ps(
+                  vwgt,
+                  _mm512_cvtph_ps(_mm256_loadu_si256(
+                      reinterpret_cast<const __m256i*>(&ip[j]))),
+                  _mm512_loadu_ps(&op[j])));
+        }
+        for (; j < block_size; j++) {
+          vtmp1[0] = ip[j];
+          __m256 vtmp2 =
+              _mm256_cvtph_ps(*(reinterpret_cast<const __m128i*>(vtmp1)));
+          op[j] = std::fma(wgt, ((float*)(&vtmp2))[0], op[j]);
+        }
+      }
+      if (normalize_by_lengths && lengths[rangeIndex]) {
+        float len_inv = 1.0f / lengths[rangeIndex];
+        __m512 vlen_inv = _mm512_set1_ps(len_inv);
+        j = 0;
+        for (; j + 16 <= block_size; j += 16) {
+          _mm512_storeu_ps(
+              &op[j], _mm512_mul_ps(_mm512_loadu_ps(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool Fused8BitRowwiseEmbeddingLookup_int32_t_half_float_false__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const at::Half* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused8BitRowwiseEmbeddingLookup_int32_t_half_float__avx512<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+bool Fused8BitRowwiseEmbeddingLookup_int32_t_half_float_true__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const at::Half* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused8BitRowwiseEmbeddingLookup_int32_t_half_float__avx512<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool Fused8BitRowwiseEmbeddingLookup_int64_t_half_float__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const at::Half* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  const int64_t prefdist_T0 = 32;
+  const int64_t fused_block_size = block_size + 4;
+  int64_t dataInd = 0;
+  if (block_size == 128) {
+    // unrolling 8 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      __m512 vop32 = _mm512_setzero_ps();
+      __m512 vop48 = _mm512_setzero_ps();
+      __m512 vop64 = _mm512_setzero_ps();
+      __m512 vop80 = _mm512_setzero_ps();
+      __m512 vop96 = _mm512_setzero_ps();
+      __m512 vop112 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (0)))),
+            vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (16)))),
+            vop16);
+        vop32 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (32)))),
+            vop32);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[32]), _MM_HINT_T0);
+        vop48 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (48)))),
+            vop48);
+        vop64 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (64)))),
+            vop64);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[64]), _MM_HINT_T0);
+        vop80 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (80)))),
+            vop80);
+        vop96 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (96)))),
+            vop96);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[96]), _MM_HINT_T0);
+        vop112 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (112)))),
+            vop112);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[128]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[131]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+        _mm512_storeu_ps(&op[32], vop32);
+        _mm512_storeu_ps(&op[48], vop48);
+        _mm512_storeu_ps(&op[64], vop64);
+        _mm512_storeu_ps(&op[80], vop80);
+        _mm512_storeu_ps(&op[96], vop96);
+        _mm512_storeu_ps(&op[112], vop112);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+        _mm512_storeu_ps(&op[32], _mm512_mul_ps(vop32, vlen_inv));
+        _mm512_storeu_ps(&op[48], _mm512_mul_ps(vop48, vlen_inv));
+        _mm512_storeu_ps(&op[64], _mm512_mul_ps(vop64, vlen_inv));
+        _mm512_storeu_ps(&op[80], _mm512_mul_ps(vop80, vlen_inv));
+        _mm512_storeu_ps(&op[96], _mm512_mul_ps(vop96, vlen_inv));
+        _mm512_storeu_ps(&op[112], _mm512_mul_ps(vop112, vlen_inv));
+      }
+    }
+  } else if (block_size == 64) {
+    // unrolling 4 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      __m512 vop32 = _mm512_setzero_ps();
+      __m512 vop48 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (0)))),
+            vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (16)))),
+            vop16);
+        vop32 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (32)))),
+            vop32);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[32]), _MM_HINT_T0);
+        vop48 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (48)))),
+            vop48);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[64]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[67]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+        _mm512_storeu_ps(&op[32], vop32);
+        _mm512_storeu_ps(&op[48], vop48);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+        _mm512_storeu_ps(&op[32], _mm512_mul_ps(vop32, vlen_inv));
+        _mm512_storeu_ps(&op[48], _mm512_mul_ps(vop48, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 2 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (0)))),
+            vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (16)))),
+            vop16);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[32]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[35]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 1 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtph_ps(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (0)))),
+            vop0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[19]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    alignas(64) at::Half vtmp1[8] = {0};
+    const int64_t fused_block_bytes = fused_block_size * 2;
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 16 <= block_size; j += 16) {
+        _mm512_storeu_ps(op + j, _mm512_setzero_ps());
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const at::Half* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const at::Half* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        const char* ip_next_T0_bytes =
+            reinterpret_cast<const char*>(ip_next_T0);
+        for (int64_t k = 0; k < fused_block_bytes; k += 64) {
+          _mm_prefetch(ip_next_T0_bytes + k, _MM_HINT_T0);
+        }
+        _mm_prefetch(ip_next_T0_bytes + fused_block_bytes - 1, _MM_HINT_T0);
+        j = 0;
+        for (; j + 16 <= block_size; j += 16) {
+          _mm512_storeu_ps(
+              &op[j],
+              _mm512_fmadd_ps(
+                  vwgt,
+                  _mm512_cvtph_ps(_mm256_loadu_si256(
+                      reinterpret_cast<const __m256i*>(&ip[j]))),
+                  _mm512_loadu_ps(&op[j])));
+        }
+        for (; j < block_size; j++) {
+          vtmp1[0] = ip[j];
+          __m256 vtmp2 =
+              _mm256_cvtph_ps(*(reinterpret_cast<const __m128i*>(vtmp1)));
+          op[j] = std::fma(wgt, ((float*)(&vtmp2))[0], op[j]);
+        }
+      }
+      if (normalize_by_lengths && lengths[rangeIndex]) {
+        float len_inv = 1.0f / lengths[rangeIndex];
+        __m512 vlen_inv = _mm512_set1_ps(len_inv);
+        j = 0;
+        for (; j + 16 <= block_size; j += 16) {
+          _mm512_storeu_ps(
+              &op[j], _mm512_mul_ps(_mm512_loadu_ps(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool Fused8BitRowwiseEmbeddingLookup_int64_t_half_float_false__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const at::Half* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused8BitRowwiseEmbeddingLookup_int64_t_half_float__avx512<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+bool Fused8BitRowwiseEmbeddingLookup_int64_t_half_float_true__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const at::Half* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused8BitRowwiseEmbeddingLookup_int64_t_half_float__avx512<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  const int prefdist_T0 = 32;
+  const int fused_block_size = block_size + 8;
+  int dataInd = 0;
+  if (block_size == 128) {
+    // unrolling 8 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      __m512 vop32 = _mm512_setzero_ps();
+      __m512 vop48 = _mm512_setzero_ps();
+      __m512 vop64 = _mm512_setzero_ps();
+      __m512 vop80 = _mm512_setzero_ps();
+      __m512 vop96 = _mm512_setzero_ps();
+      __m512 vop112 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const float* scale_bias = reinterpret_cast<const float*>(
+            &input[idx * fused_block_size + block_size]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m512 vbio = _mm512_set1_ps(bio);
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (0))))),
+            _mm512_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (16))))),
+            _mm512_add_ps(vop16, vbio));
+        vop32 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (32))))),
+            _mm512_add_ps(vop32, vbio));
+        vop48 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (48))))),
+            _mm512_add_ps(vop48, vbio));
+        vop64 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (64))))),
+            _mm512_add_ps(vop64, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[64]), _MM_HINT_T0);
+        vop80 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (80))))),
+            _mm512_add_ps(vop80, vbio));
+        vop96 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (96))))),
+            _mm512_add_ps(vop96, vbio));
+        vop112 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (112))))),
+            _mm512_add_ps(vop112, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[128]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[135]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+        _mm512_storeu_ps(&op[32], vop32);
+        _mm512_storeu_ps(&op[48], vop48);
+        _mm512_storeu_ps(&op[64], vop64);
+        _mm512_storeu_ps(&op[80], vop80);
+        _mm512_storeu_ps(&op[96], vop96);
+        _mm512_storeu_ps(&op[112], vop112);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+        _mm512_storeu_ps(&op[32], _mm512_mul_ps(vop32, vlen_inv));
+        _mm512_storeu_ps(&op[48], _mm512_mul_ps(vop48, vlen_inv));
+        _mm512_storeu_ps(&op[64], _mm512_mul_ps(vop64, vlen_inv));
+        _mm512_storeu_ps(&op[80], _mm512_mul_ps(vop80, vlen_inv));
+        _mm512_storeu_ps(&op[96], _mm512_mul_ps(vop96, vlen_inv));
+        _mm512_storeu_ps(&op[112], _mm512_mul_ps(vop112, vlen_inv));
+      }
+    }
+  } else if (block_size == 64) {
+    // unrolling 4 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      __m512 vop32 = _mm512_setzero_ps();
+      __m512 vop48 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const float* scale_bias = reinterpret_cast<const float*>(
+            &input[idx * fused_block_size + block_size]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m512 vbio = _mm512_set1_ps(bio);
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (0))))),
+            _mm512_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (16))))),
+            _mm512_add_ps(vop16, vbio));
+        vop32 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (32))))),
+            _mm512_add_ps(vop32, vbio));
+        vop48 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (48))))),
+            _mm512_add_ps(vop48, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[64]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[71]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+        _mm512_storeu_ps(&op[32], vop32);
+        _mm512_storeu_ps(&op[48], vop48);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+        _mm512_storeu_ps(&op[32], _mm512_mul_ps(vop32, vlen_inv));
+        _mm512_storeu_ps(&op[48], _mm512_mul_ps(vop48, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 2 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const float* scale_bias = reinterpret_cast<const float*>(
+            &input[idx * fused_block_size + block_size]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m512 vbio = _mm512_set1_ps(bio);
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (0))))),
+            _mm512_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (16))))),
+            _mm512_add_ps(vop16, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[39]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 1 times
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const float* scale_bias = reinterpret_cast<const float*>(
+            &input[idx * fused_block_size + block_size]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m512 vbio = _mm512_set1_ps(bio);
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (0))))),
+            _mm512_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[23]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    const int64_t fused_block_bytes = fused_block_size * 1;
+    for (int rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 16 <= block_size; j += 16) {
+        _mm512_storeu_ps(op + j, _mm512_setzero_ps());
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const float* scale_bias = reinterpret_cast<const float*>(
+            &input[idx * fused_block_size + block_size]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m512 vbio = _mm512_set1_ps(bio);
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        const char* ip_next_T0_bytes =
+            reinterpret_cast<const char*>(ip_next_T0);
+        for (int64_t k = 0; k < fused_block_bytes; k += 64) {
+          _mm_prefetch(ip_next_T0_bytes + k, _MM_HINT_T0);
+        }
+        _mm_prefetch(ip_next_T0_bytes + fused_block_bytes - 1, _MM_HINT_T0);
+        j = 0;
+        for (; j + 16 <= block_size; j += 16) {
+          _mm512_storeu_ps(
+              &op[j],
+              _mm512_fmadd_ps(
+                  vwgt,
+                  _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128(
+                      reinterpret_cast<const __m128i*>(&ip[j])))),
+                  _mm512_add_ps(_mm512_loadu_ps(&op[j]), vbio)));
+        }
+        for (; j < block_size; j++) {
+          op[j] = std::fma(wgt, (float)ip[j], bio + op[j]);
+        }
+      }
+      if (normalize_by_lengths && lengths[rangeIndex]) {
+        float len_inv = 1.0f / lengths[rangeIndex];
+        __m512 vlen_inv = _mm512_set1_ps(len_inv);
+        j = 0;
+        for (; j + 16 <= block_size; j += 16) {
+          _mm512_storeu_ps(
+              &op[j], _mm512_mul_ps(_mm512_loadu_ps(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float_false__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx512<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+bool Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float_true__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx512<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+
+template <bool IS_WEIGHT_POSITIONAL>
+static bool Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  const int64_t prefdist_T0 = 32;
+  const int64_t fused_block_size = block_size + 8;
+  int64_t dataInd = 0;
+  if (block_size == 128) {
+    // unrolling 8 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      __m512 vop32 = _mm512_setzero_ps();
+      __m512 vop48 = _mm512_setzero_ps();
+      __m512 vop64 = _mm512_setzero_ps();
+      __m512 vop80 = _mm512_setzero_ps();
+      __m512 vop96 = _mm512_setzero_ps();
+      __m512 vop112 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const float* scale_bias = reinterpret_cast<const float*>(
+            &input[idx * fused_block_size + block_size]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m512 vbio = _mm512_set1_ps(bio);
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (0))))),
+            _mm512_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (16))))),
+            _mm512_add_ps(vop16, vbio));
+        vop32 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (32))))),
+            _mm512_add_ps(vop32, vbio));
+        vop48 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (48))))),
+            _mm512_add_ps(vop48, vbio));
+        vop64 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (64))))),
+            _mm512_add_ps(vop64, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[64]), _MM_HINT_T0);
+        vop80 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (80))))),
+            _mm512_add_ps(vop80, vbio));
+        vop96 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (96))))),
+            _mm512_add_ps(vop96, vbio));
+        vop112 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (112))))),
+            _mm512_add_ps(vop112, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[128]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[135]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+        _mm512_storeu_ps(&op[32], vop32);
+        _mm512_storeu_ps(&op[48], vop48);
+        _mm512_storeu_ps(&op[64], vop64);
+        _mm512_storeu_ps(&op[80], vop80);
+        _mm512_storeu_ps(&op[96], vop96);
+        _mm512_storeu_ps(&op[112], vop112);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+        _mm512_storeu_ps(&op[32], _mm512_mul_ps(vop32, vlen_inv));
+        _mm512_storeu_ps(&op[48], _mm512_mul_ps(vop48, vlen_inv));
+        _mm512_storeu_ps(&op[64], _mm512_mul_ps(vop64, vlen_inv));
+        _mm512_storeu_ps(&op[80], _mm512_mul_ps(vop80, vlen_inv));
+        _mm512_storeu_ps(&op[96], _mm512_mul_ps(vop96, vlen_inv));
+        _mm512_storeu_ps(&op[112], _mm512_mul_ps(vop112, vlen_inv));
+      }
+    }
+  } else if (block_size == 64) {
+    // unrolling 4 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      __m512 vop32 = _mm512_setzero_ps();
+      __m512 vop48 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const float* scale_bias = reinterpret_cast<const float*>(
+            &input[idx * fused_block_size + block_size]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m512 vbio = _mm512_set1_ps(bio);
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (0))))),
+            _mm512_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (16))))),
+            _mm512_add_ps(vop16, vbio));
+        vop32 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (32))))),
+            _mm512_add_ps(vop32, vbio));
+        vop48 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (48))))),
+            _mm512_add_ps(vop48, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[64]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[71]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+        _mm512_storeu_ps(&op[32], vop32);
+        _mm512_storeu_ps(&op[48], vop48);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+        _mm512_storeu_ps(&op[32], _mm512_mul_ps(vop32, vlen_inv));
+        _mm512_storeu_ps(&op[48], _mm512_mul_ps(vop48, vlen_inv));
+      }
+    }
+  } else if (block_size == 32) {
+    // unrolling 2 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      __m512 vop16 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const float* scale_bias = reinterpret_cast<const float*>(
+            &input[idx * fused_block_size + block_size]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m512 vbio = _mm512_set1_ps(bio);
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (0))))),
+            _mm512_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        vop16 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (16))))),
+            _mm512_add_ps(vop16, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[39]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+        _mm512_storeu_ps(&op[16], vop16);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+        _mm512_storeu_ps(&op[16], _mm512_mul_ps(vop16, vlen_inv));
+      }
+    }
+  } else if (block_size == 16) {
+    // unrolling 1 times
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      __m512 vop0 = _mm512_setzero_ps();
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const float* scale_bias = reinterpret_cast<const float*>(
+            &input[idx * fused_block_size + block_size]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m512 vbio = _mm512_set1_ps(bio);
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        vop0 = _mm512_fmadd_ps(
+            vwgt,
+            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (0))))),
+            _mm512_add_ps(vop0, vbio));
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[0]), _MM_HINT_T0);
+        _mm_prefetch(
+            reinterpret_cast<const char*>(&ip_next_T0[23]), _MM_HINT_T0);
+      }
+      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {
+        _mm512_storeu_ps(&op[0], vop0);
+      } else {
+        __m512 vlen_inv = _mm512_set1_ps(1.0f / lengths[rangeIndex]);
+        _mm512_storeu_ps(&op[0], _mm512_mul_ps(vop0, vlen_inv));
+      }
+    }
+  } else {
+    // generic code
+    const int64_t fused_block_bytes = fused_block_size * 1;
+    for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+      float* op = &out[rangeIndex * block_size];
+      int64_t j = 0;
+      for (; j + 16 <= block_size; j += 16) {
+        _mm512_storeu_ps(op + j, _mm512_setzero_ps());
+      }
+      for (; j < block_size; j++) {
+        op[j] = 0.0f;
+      }
+      if (dataInd + lengths[rangeIndex] > index_size) {
+        return false;
+      }
+      for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+           ++dataInd) {
+        const int64_t idx = indices[dataInd];
+        if (idx < 0 || idx >= data_size) {
+          return false;
+        }
+        float wgt = 1.f;
+        float bio;
+        if (weights) {
+          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];
+        }
+        const float* scale_bias = reinterpret_cast<const float*>(
+            &input[idx * fused_block_size + block_size]);
+        bio = wgt * scale_bias[1];
+        wgt = wgt * scale_bias[0];
+        __m512 vbio = _mm512_set1_ps(bio);
+        __m512 vwgt = _mm512_set1_ps(wgt);
+        const uint8_t* ip = &input[idx * fused_block_size];
+        const int64_t next_T0 = (dataInd < index_size - prefdist_T0)
+            ? (dataInd + prefdist_T0)
+            : dataInd;
+        const int64_t idx_pref_T0 = indices[next_T0];
+        if (idx_pref_T0 < 0 || idx_pref_T0 >= data_size) {
+          return false;
+        }
+        const uint8_t* ip_next_T0 = &input[idx_pref_T0 * fused_block_size];
+        const char* ip_next_T0_bytes =
+            reinterpret_cast<const char*>(ip_next_T0);
+        for (int64_t k = 0; k < fused_block_bytes; k += 64) {
+          _mm_prefetch(ip_next_T0_bytes + k, _MM_HINT_T0);
+        }
+        _mm_prefetch(ip_next_T0_bytes + fused_block_bytes - 1, _MM_HINT_T0);
+        j = 0;
+        for (; j + 16 <= block_size; j += 16) {
+          _mm512_storeu_ps(
+              &op[j],
+              _mm512_fmadd_ps(
+                  vwgt,
+                  _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128(
+                      reinterpret_cast<const __m128i*>(&ip[j])))),
+                  _mm512_add_ps(_mm512_loadu_ps(&op[j]), vbio)));
+        }
+        for (; j < block_size; j++) {
+          op[j] = std::fma(wgt, (float)ip[j], bio + op[j]);
+        }
+      }
+      if (normalize_by_lengths && lengths[rangeIndex]) {
+        float len_inv = 1.0f / lengths[rangeIndex];
+        __m512 vlen_inv = _mm512_set1_ps(len_inv);
+        j = 0;
+        for (; j + 16 <= block_size; j += 16) {
+          _mm512_storeu_ps(
+              &op[j], _mm512_mul_ps(_mm512_loadu_ps(&op[j]), vlen_inv));
+        }
+        for (; j < block_size; j++) {
+          op[j] = len_inv * op[j];
+        }
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+bool Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_false__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx512<false>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+bool Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float_true__avx512(
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx512<true>(
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+
+} // namespace caffe2
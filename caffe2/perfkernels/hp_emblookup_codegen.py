@@ -6,11 +6,73 @@ import sys
 
 sizeof = {"float": 4, "at::Half": 2, "uint8_t": 1}
 
+# The vector type, the prefix of its intrinsics, the number of floats in a
+# register, the suffix of the generated functions, and the prefetch distance
+# (in indices) of each instruction set.
+isas = {
+    "avx2": {
+        "name": "avx2",
+        "vec": "__m256",
+        "mm": "_mm256",
+        "width": 8,
+        "suffix": "__avx2_fma",
+        "prefdist": 16,
+    },
+    # A row is processed in half as many instructions, so prefetching further
+    # ahead is needed to hide the DRAM latency of rows of large tables.
+    "avx512": {
+        "name": "avx512",
+        "vec": "__m512",
+        "mm": "_mm512",
+        "width": 16,
+        "suffix": "__avx512",
+        "prefdist": 32,
+    },
+}
+
+
+def prefetch_line(offset, indent):
+    return (
+        indent + "_mm_prefetch(\n"
+        + indent + "    reinterpret_cast<const char*>(&ip_next_T0[%d]), _MM_HINT_T0);"
+        % (offset)
+    )
+
 
 def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     def compute(regid, InType, use_weights, isa, prefetch):
         code = []
 
+        if isa["name"] == "avx512":
+            if InType == "float":
+                code.append(
+                    "        vop%d = _mm512_fmadd_ps(vwgt, _mm512_loadu_ps(ip + (%d)), vop%d);"  # noqa
+                    % (regid, regid, regid)
+                )
+            elif InType == "at::Half":
+                code.append(
+                    "        vop%d = _mm512_fmadd_ps(\n"
+                    "            vwgt,\n"
+                    "            _mm512_cvtph_ps(\n"
+                    "                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ip + (%d)))),\n"  # noqa
+                    "            vop%d);" % (regid, regid, regid)
+                )
+            elif InType == "uint8_t":
+                code.append(
+                    "        vop%d = _mm512_fmadd_ps(\n"
+                    "            vwgt,\n"
+                    "            _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(\n"
+                    "                _mm_loadu_si128(reinterpret_cast<const __m128i*>(ip + (%d))))),\n"  # noqa
+                    "            _mm512_add_ps(vop%d, vbio));" % (regid, regid, regid)
+                )
+            else:
+                assert False
+
+            # prefetch is a list of the offsets to prefetch here
+            for offset in prefetch:
+                code.append(prefetch_line(offset, "        "))
+            return code
+
         if InType == "float":
             code.append(
                 "        vop%d = _mm256_fmadd_ps(vwgt, _mm256_loadu_ps(ip + (%d)), vop%d);"  # noqa
@@ -66,8 +128,10 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
 
     code.append("      " + OutType + "* op = &out[rangeIndex * block_size];")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("      __m256 vop" + str(j) + " = _mm256_setzero_ps();")
+        j = isa["width"] * i
+        code.append(
+            "      {} vop{} = {}_setzero_ps();".format(isa["vec"], j, isa["mm"])
+        )
 
     # inner loop
     if use_offsets:
@@ -120,7 +184,9 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append(
+            "        {} vbio = {}_set1_ps(bio);".format(isa["vec"], isa["mm"])
+        )
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -128,7 +194,7 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        {} vwgt = {}_set1_ps(wgt);".format(isa["vec"], isa["mm"]))
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -149,12 +215,36 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
         "&input[idx_pref_T0 * fused_block_size];".format(InType)
     )
 
-    for i in range(0, uf):
-        j = 8 * i
-        cachelinesize = 64
-        byteoffset = sizeof[InType] * j
-        prefetch = (byteoffset % cachelinesize) == 0
-        code.extend(compute(j, InType, use_weights, isa, prefetch))
+    if not fused and InType == "uint8_t" and isa["name"] == "avx512":
+        code.append(
+            "        _mm_prefetch(\n"
+            "            reinterpret_cast<const char*>(&scale_bias[2 * idx_pref_T0]),\n"
+            "            _MM_HINT_T0);"
+        )
+
+    cachelinesize = 64
+    if isa["name"] == "avx512":
+        # Prefetch every cache line of the next row, including its scale and
+        # bias. Rows are not necessarily aligned to cache lines, so also
+        # prefetch the line of the last element of the row.
+        row_size = uf * isa["width"] + ((8 // sizeof[InType]) if fused else 0)
+        elems_per_line = cachelinesize // sizeof[InType]
+        lines = list(range(0, row_size, elems_per_line)) + [row_size - 1]
+        for i in range(0, uf):
+            j = isa["width"] * i
+            prefetch = [
+                o for o in lines if j <= o < j + isa["width"] and o % elems_per_line == 0
+            ]
+            code.extend(compute(j, InType, use_weights, isa, prefetch))
+        for offset in lines:
+            if offset >= uf * isa["width"] or offset % elems_per_line != 0:
+                code.append(prefetch_line(offset, "        "))
+    else:
+        for i in range(0, uf):
+            j = 8 * i
+            byteoffset = sizeof[InType] * j
+            prefetch = (byteoffset % cachelinesize) == 0
+            code.extend(compute(j, InType, use_weights, isa, prefetch))
     code.append("      }")
 
     if use_offsets:
@@ -162,23 +252,30 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
     else:
         code.append("      if (!normalize_by_lengths || lengths[rangeIndex] == 0) {")
     for i in range(0, uf):
-        j = 8 * i
-        code.append("        _mm256_storeu_ps(&op[" + str(j) + "], vop" + str(j) + ");")
+        j = isa["width"] * i
+        code.append(
+            "        {}_storeu_ps(&op[{}], vop{});".format(isa["mm"], j, j)
+        )
     code.append("      } else {")
     # inv of length
     if use_offsets:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / length);")
+        code.append(
+            "        {} vlen_inv = {}_set1_ps(1.0f / length);".format(
+                isa["vec"], isa["mm"]
+            )
+        )
     else:
-        code.append("        __m256 vlen_inv = _mm256_set1_ps(1.0f / lengths[rangeIndex]);")
+        code.append(
+            "        {} vlen_inv = {}_set1_ps(1.0f / lengths[rangeIndex]);".format(
+                isa["vec"], isa["mm"]
+            )
+        )
     for i in range(0, uf):
-        j = 8 * i
+        j = isa["width"] * i
         code.append(
-            "        _mm256_storeu_ps(&op["
-            + str(j)
-            + "], _mm256_mul_ps("
-            + "vop"
-            + str(j)
-            + ", vlen_inv));"
+            "        {0}_storeu_ps(&op[{1}], {0}_mul_ps(vop{1}, vlen_inv));".format(
+                isa["mm"], j
+            )
         )
     code.append("      }")
 
@@ -189,6 +286,39 @@ def unroll(uf, IndexType, InType, OutType, use_weights, isa, fused, use_offsets)
 def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     def compute(InType, use_weights, isa):
         code = []
+        if isa["name"] == "avx512":
+            if InType == "float":
+                code.append(
+                    "          _mm512_storeu_ps(\n"
+                    "              &op[j],\n"
+                    "              _mm512_fmadd_ps(\n"
+                    "                  vwgt, _mm512_loadu_ps(&ip[j]), _mm512_loadu_ps(&op[j])));"  # noqa
+                )
+            elif InType == "at::Half":
+                code.append(
+                    "          _mm512_storeu_ps(\n"
+                    "              &op[j],\n"
+                    "              _mm512_fmadd_ps(\n"
+                    "                  vwgt,\n"
+                    "                  _mm512_cvtph_ps(_mm256_loadu_si256(\n"
+                    "                      reinterpret_cast<const __m256i*>(&ip[j]))),\n"
+                    "                  _mm512_loadu_ps(&op[j])));"
+                )
+            elif InType == "uint8_t":
+                code.append(
+                    "          _mm512_storeu_ps(\n"
+                    "              &op[j],\n"
+                    "              _mm512_fmadd_ps(\n"
+                    "                  vwgt,\n"
+                    "                  _mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128(\n"  # noqa
+                    "                      reinterpret_cast<const __m128i*>(&ip[j])))),\n"
+                    "                  _mm512_add_ps(_mm512_loadu_ps(&op[j]), vbio)));"
+                )
+            else:
+                assert False
+            # the whole row is prefetched before the loop
+            return code
+
         if InType == "float":
             code.append(
                 "          _mm256_storeu_ps(\n"
@@ -229,6 +359,12 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     code = []
     if InType == "at::Half":
         code.append("    alignas(64) at::Half vtmp1[8] = {0};")
+    if isa["name"] == "avx512":
+        code.append(
+            "    const int64_t fused_block_bytes = fused_block_size * {};".format(
+                sizeof[InType]
+            )
+        )
 
 
 
@@ -249,8 +385,10 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
 
     # initialize to 0
     code.append("      int64_t j = 0;")
-    code.append("      for (; j + 8 <= block_size; j += 8) {")
-    code.append("        _mm256_storeu_ps(op + j, _mm256_setzero_ps());")
+    code.append(
+        "      for (; j + {0} <= block_size; j += {0}) {{".format(isa["width"])
+    )
+    code.append("        {0}_storeu_ps(op + j, {0}_setzero_ps());".format(isa["mm"]))
     code.append("      }")
     code.append("      for (; j < block_size; j++) {")
     code.append("        op[j] = 0.0f;")
@@ -307,7 +445,9 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
         else:
             code.append("        bio = wgt * scale_bias[2 * idx + 1];")
             code.append("        wgt = wgt * scale_bias[2 * idx];")
-        code.append("        __m256 vbio = _mm256_set1_ps(bio);")
+        code.append(
+            "        {} vbio = {}_set1_ps(bio);".format(isa["vec"], isa["mm"])
+        )
     else:
         code.append("        " + OutType + " wgt = 1.f;")
         code.append("        if (weights) {")
@@ -315,7 +455,7 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
             "          wgt = weights[IS_WEIGHT_POSITIONAL ? (dataInd - start) : dataInd];"  # noqa
         )
         code.append("        }")
-    code.append("        __m256 vwgt = _mm256_set1_ps(wgt);")
+    code.append("        {} vwgt = {}_set1_ps(wgt);".format(isa["vec"], isa["mm"]))
 
     code.append("        const {}* ip = &input[idx * fused_block_size];".format(InType))
     code.append(
@@ -335,9 +475,29 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
         "&input[idx_pref_T0 * fused_block_size];".format(InType)
     )
 
+    if isa["name"] == "avx512":
+        if not fused and InType == "uint8_t":
+            code.append(
+                "        _mm_prefetch(\n"
+                "            reinterpret_cast<const char*>(&scale_bias[2 * idx_pref_T0]),\n"
+                "            _MM_HINT_T0);"
+            )
+        # Rows are not necessarily aligned to cache lines, so also prefetch
+        # the line of the last byte of the row.
+        code.append(
+            "        const char* ip_next_T0_bytes =\n"
+            "            reinterpret_cast<const char*>(ip_next_T0);\n"
+            "        for (int64_t k = 0; k < fused_block_bytes; k += 64) {\n"
+            "          _mm_prefetch(ip_next_T0_bytes + k, _MM_HINT_T0);\n"
+            "        }\n"
+            "        _mm_prefetch(ip_next_T0_bytes + fused_block_bytes - 1, _MM_HINT_T0);"
+        )
+
     # compute and store main loop
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
+    code.append(
+        "        for (; j + {0} <= block_size; j += {0}) {{".format(isa["width"])
+    )
     code.extend(compute(InType, use_weights, isa))
     code.append("        }")
     # leftover
@@ -366,12 +526,18 @@ def generic(IndexType, InType, OutType, use_weights, isa, fused, use_offsets):
     else:
         code.append("      if (normalize_by_lengths && lengths[rangeIndex]) {")
         code.append("        float len_inv = 1.0f / lengths[rangeIndex];")
-    code.append("        __m256 vlen_inv = _mm256_set1_ps(len_inv);")
+    code.append(
+        "        {} vlen_inv = {}_set1_ps(len_inv);".format(isa["vec"], isa["mm"])
+    )
     code.append("        j = 0;")
-    code.append("        for (; j + 8 <= block_size; j += 8) {")
     code.append(
-        "          _mm256_storeu_ps(\n"
-        "              &op[j], _mm256_mul_ps(_mm256_loadu_ps(&op[j]), vlen_inv));"
+        "        for (; j + {0} <= block_size; j += {0}) {{".format(isa["width"])
+    )
+    code.append(
+        "          {0}_storeu_ps(\n"
+        "              &op[j], {0}_mul_ps({0}_loadu_ps(&op[j]), vlen_inv));".format(
+            isa["mm"]
+        )
     )
     code.append("        }")
     code.append("        for (; j < block_size; j++) {")
@@ -389,19 +555,21 @@ parser = argparse.ArgumentParser()
 parser.add_argument("-f", "--filename", help="file name")
 parser.add_argument("--fused", action="store_true")
 parser.add_argument("--use-offsets", action="store_true")
+parser.add_argument("--isa", choices=sorted(isas.keys()), default="avx2")
 opts = parser.parse_args()
+isa = isas[opts.isa]
 if opts.filename:
     filename = opts.filename
 elif opts.fused:
     if opts.use_offsets:
-        filename = "embedding_lookup_fused_8bit_rowwise_idx_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_fused_8bit_rowwise_avx2.cc"
+        filename = "embedding_lookup_fused_8bit_rowwise_{}.cc".format(opts.isa)
 else:
     if opts.use_offsets:
-        filename = "embedding_lookup_idx_avx2.cc"
+        filename = "embedding_lookup_idx_{}.cc".format(opts.isa)
     else:
-        filename = "embedding_lookup_avx2.cc"
+        filename = "embedding_lookup_{}.cc".format(opts.isa)
 
 options = [
     ["int32_t", "int", "float", "float", "float", "float"],
@@ -438,7 +606,7 @@ for o in options:
         fn_base = "{}EmbeddingLookup_{}_{}_{}".format(
             prefix, IndexTypeName, InTypeName, OutTypeName
         )
-    suffix = "__avx2_fma"
+    suffix = isa["suffix"]
     fn = "static bool " + fn_base + suffix
     code.append(fn + "(")
 
@@ -460,7 +628,9 @@ for o in options:
     args.append("    " + OutType + "* out) {")
     code += args
 
-    code.append("  const " + IndexType + " prefdist_T0 = 16;")
+    code.append(
+        "  const {} prefdist_T0 = {};".format(IndexType, isa["prefdist"])
+    )
     # block_size is the number of elements and fused_block_size is the size of
     # an entire row, including scale and bias.
     offset = (8 // sizeof[InType]) if opts.fused else 0
@@ -474,17 +644,23 @@ for o in options:
 
     # code.append("printf(\"calling " + fn + "\\n\");");
 
-    code.append("  if (block_size == 128) {")
-    code += unroll(16, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 64) {")
-    code += unroll(8, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 32) {")
-    code += unroll(4, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
-    code.append("  } else if (block_size == 16) {")
-    code += unroll(2, IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    for i, block_size in enumerate([128, 64, 32, 16]):
+        code.append(
+            "  {}if (block_size == {}) {{".format("} else " if i else "", block_size)
+        )
+        code += unroll(
+            block_size // isa["width"],
+            IndexType,
+            InType,
+            OutType,
+            True,
+            isa,
+            opts.fused,
+            opts.use_offsets,
+        )
     code.append("  } else {")
     code.append("    // generic code")
-    code += generic(IndexType, InType, OutType, True, "AVX2", opts.fused, opts.use_offsets)
+    code += generic(IndexType, InType, OutType, True, isa, opts.fused, opts.use_offsets)
     code.append("  }")
     code.append("  return dataInd == index_size;")
 
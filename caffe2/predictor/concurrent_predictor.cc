@@ -0,0 +1,298 @@
+#include "caffe2/predictor/concurrent_predictor.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "caffe2/core/context.h"
+
+namespace caffe2 {
+
+namespace {
+
+// Concatenates the inputs of the calls of a batch along their first
+// dimension, and stores the size of the first dimension of each call in
+// `sizes`.
+Predictor::TensorList concatInputs(
+    const std::vector<const Predictor::TensorList*>& calls,
+    std::vector<int64_t>* sizes) {
+  CPUContext context;
+  const auto& first = *calls.front();
+  sizes->assign(calls.size(), 0);
+  Predictor::TensorList batched;
+  for (size_t i = 0; i < first.size(); ++i) {
+    CAFFE_ENFORCE_GT(
+        first[i].dim(), 0, "Batched inputs must have a batch dimension");
+    auto dims = first[i].sizes().vec();
+    dims[0] = 0;
+    for (size_t c = 0; c < calls.size(); ++c) {
+      CAFFE_ENFORCE_EQ(calls[c]->size(), first.size());
+      const auto& input = (*calls[c])[i];
+      CAFFE_ENFORCE(
+          input.dtype() == first[i].dtype(),
+          "Batched inputs must have the same type");
+      CAFFE_ENFORCE_EQ(input.dim(), first[i].dim());
+      for (int d = 1; d < input.dim(); ++d) {
+        CAFFE_ENFORCE_EQ(
+            input.size(d),
+            first[i].size(d),
+            "Batched inputs must only differ in their first dimension");
+      }
+      if (i == 0) {
+        (*sizes)[c] = input.size(0);
+      }
+      CAFFE_ENFORCE_EQ(
+          input.size(0),
+          (*sizes)[c],
+          "All inputs of a batched call must have the same first dimension");
+      dims[0] += input.size(0);
+    }
+
+    Tensor tensor(dims, CPU);
+    auto* dst =
+        static_cast<char*>(tensor.raw_mutable_data(first[i].dtype()));
+    for (const auto* call : calls) {
+      const auto& input = (*call)[i];
+      if (input.numel() > 0) {
+        context.CopyItemsSameDevice(
+            input.dtype(), input.numel(), input.raw_data(), dst);
+        dst += input.nbytes();
+      }
+    }
+    batched.push_back(std::move(tensor));
+  }
+  return batched;
+}
+
+// Splits the outputs of a batch between its calls along their first
+// dimension.
+void splitOutputs(
+    const Predictor::TensorList& batched,
+    const std::vector<int64_t>& sizes,
+    const std::vector<Predictor::TensorList*>& calls) {
+  CPUContext context;
+  int64_t total = 0;
+  for (const auto size : sizes) {
+    total += size;
+  }
+  for (auto* outputs : calls) {
+    outputs->clear();
+  }
+  for (const auto& output : batched) {
+    CAFFE_ENFORCE(
+        output.dim() > 0 && output.size(0) == total,
+        "Batched outputs must have the batch as their first dimension");
+    const auto* src = static_cast<const char*>(output.raw_data());
+    for (size_t c = 0; c < calls.size(); ++c) {
+      auto dims = output.sizes().vec();
+      dims[0] = sizes[c];
+      Tensor tensor(dims, CPU);
+      auto* dst = tensor.raw_mutable_data(output.dtype());
+      if (tensor.numel() > 0) {
+        context.CopyItemsSameDevice(output.dtype(), tensor.numel(), src, dst);
+        src += tensor.nbytes();
+      }
+      calls[c]->push_back(std::move(tensor));
+    }
+  }
+}
+
+} // namespace
+
+ConcurrentPredictor::ConcurrentPredictor(
+    PredictorConfig config,
+    Options options)
+    : config_(std::move(config)), options_(options) {
+  CAFFE_ENFORCE_GT(options_.num_workspaces, 0);
+  CAFFE_ENFORCE_GT(options_.max_batch_size, 0);
+  const auto& net = *config_.predict_net;
+  const std::unordered_set<std::string> inputNames(
+      config_.input_names.begin(), config_.input_names.end());
+
+  for (int i = 0; i < options_.num_workspaces; ++i) {
+    auto worker = make_unique<Worker>();
+    worker->index = i;
+    worker->ws = make_unique<Workspace>(config_.ws.get());
+    // Inputs that are not initialized in the parent workspace are fed by the
+    // calls, so each workspace has its own blobs for them. Initialized ones
+    // are parameters and are shared.
+    for (const auto& name : net.external_input()) {
+      Blob* blob = nullptr;
+      if (inputNames.count(name) || !config_.ws->HasBlob(name)) {
+        blob = worker->ws->CreateLocalBlob(name);
+        BlobGetMutableTensor(blob, CPU);
+      }
+      worker->inputs.push_back(blob);
+    }
+    // Everything the net writes is private to the workspace, even if a blob
+    // of the same name exists in the parent workspace.
+    for (const auto& op : net.op()) {
+      for (const auto& output : op.output()) {
+        worker->ws->CreateLocalBlob(output);
+      }
+    }
+    for (const auto& name : net.external_output()) {
+      worker->outputs.push_back(worker->ws->CreateLocalBlob(name));
+    }
+    worker->net = worker->ws->CreateNet(config_.predict_net);
+    CAFFE_ENFORCE(worker->net, "Failed to create net ", net.name());
+    free_.push_back(worker.get());
+    workers_.push_back(std::move(worker));
+  }
+}
+
+ConcurrentPredictor::Worker* ConcurrentPredictor::tryAcquire() {
+  if (free_.empty()) {
+    return nullptr;
+  }
+  auto it = free_.end() - 1;
+  if (auto* last = lastWorker_.get()) {
+    auto found = std::find_if(free_.begin(), free_.end(), [last](Worker* w) {
+      return w->index == *last;
+    });
+    if (found != free_.end()) {
+      it = found;
+    }
+  }
+  auto* worker = *it;
+  free_.erase(it);
+  if (auto* last = lastWorker_.get()) {
+    *last = worker->index;
+  } else {
+    lastWorker_.reset(make_unique<size_t>(worker->index));
+  }
+  return worker;
+}
+
+void ConcurrentPredictor::release(Worker* worker) {
+  free_.push_back(worker);
+}
+
+bool ConcurrentPredictor::run(
+    Worker* worker,
+    const TensorList& inputs,
+    TensorList* outputs) {
+  CAFFE_ENFORCE_LE(inputs.size(), worker->inputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    CAFFE_ENFORCE(
+        worker->inputs[i],
+        "Input ",
+        def().external_input(i),
+        " is a parameter shared by all workspaces and cannot be fed");
+    // This is evil and shares the same underlying tensor
+    BlobSetTensor(worker->inputs[i], inputs[i].UnsafeSharedInstance());
+  }
+
+  if (!worker->net->Run()) {
+    return false;
+  }
+  outputs->clear();
+  for (auto* blob : worker->outputs) {
+    CAFFE_ENFORCE(BlobIsTensorType(*blob, CPU), "Output is not a CPU Tensor");
+    outputs->emplace_back(
+        BlobGetMutableTensor(blob, CPU)->UnsafeSharedInstance());
+    // The next run allocates a new tensor, so the caller keeps this one.
+    blob->Reset();
+  }
+  return true;
+}
+
+void ConcurrentPredictor::runBatch(
+    Worker* worker,
+    const std::vector<Request*>& batch) {
+  bool success = false;
+  std::exception_ptr error;
+  try {
+    if (batch.size() == 1) {
+      success = run(worker, *batch[0]->inputs, batch[0]->outputs);
+    } else {
+      std::vector<const TensorList*> inputs;
+      std::vector<TensorList*> outputs;
+      for (const auto* request : batch) {
+        inputs.push_back(request->inputs);
+        outputs.push_back(request->outputs);
+      }
+      std::vector<int64_t> sizes;
+      TensorList batchedOutputs;
+      success = run(worker, concatInputs(inputs, &sizes), &batchedOutputs);
+      if (success) {
+        splitOutputs(batchedOutputs, sizes, outputs);
+      }
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+  for (auto* request : batch) {
+    request->success = success;
+    request->error = error;
+  }
+}
+
+bool ConcurrentPredictor::operator()(
+    const TensorList& inputs,
+    TensorList* outputs) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (options_.max_batch_size == 1) {
+    Worker* worker = nullptr;
+    cv_.wait(lock, [&] { return (worker = tryAcquire()) != nullptr; });
+    lock.unlock();
+    bool success = false;
+    try {
+      success = run(worker, inputs, outputs);
+    } catch (...) {
+      lock.lock();
+      release(worker);
+      cv_.notify_one();
+      throw;
+    }
+    lock.lock();
+    release(worker);
+    cv_.notify_one();
+    return success;
+  }
+
+  Request request;
+  request.inputs = &inputs;
+  request.outputs = outputs;
+  pending_.push_back(&request);
+  cv_.notify_all();
+  while (!request.done) {
+    // Only one thread collects a batch at a time, so that calls arriving
+    // meanwhile join its batch rather than start their own.
+    Worker* worker =
+        !collecting_ && !pending_.empty() ? tryAcquire() : nullptr;
+    if (!worker) {
+      cv_.wait(lock);
+      continue;
+    }
+    const size_t maxBatchSize = options_.max_batch_size;
+    if (pending_.size() < maxBatchSize &&
+        options_.batch_timeout.count() > 0) {
+      collecting_ = true;
+      cv_.wait_for(lock, options_.batch_timeout, [&] {
+        return pending_.size() >= maxBatchSize;
+      });
+      collecting_ = false;
+    }
+    const auto batchSize = std::min(pending_.size(), maxBatchSize);
+    std::vector<Request*> batch(
+        pending_.begin(), pending_.begin() + batchSize);
+    pending_.erase(pending_.begin(), pending_.begin() + batchSize);
+    // Calls left pending can be taken by other threads now.
+    cv_.notify_all();
+
+    lock.unlock();
+    runBatch(worker, batch);
+    lock.lock();
+    release(worker);
+    for (auto* done : batch) {
+      done->done = true;
+    }
+    cv_.notify_all();
+  }
+  if (request.error) {
+    std::rethrow_exception(request.error);
+  }
+  return request.success;
+}
+
+} // namespace caffe2
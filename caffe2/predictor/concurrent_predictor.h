@@ -0,0 +1,114 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <vector>
+
+#include "caffe2/core/net.h"
+#include "caffe2/core/tensor.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/predictor/ThreadLocalPtr.h"
+#include "caffe2/predictor/predictor.h"
+#include "caffe2/predictor/predictor_config.h"
+
+namespace caffe2 {
+
+struct CAFFE2_API ConcurrentPredictorOptions {
+  // The number of child workspaces, i.e. of calls that run concurrently.
+  int num_workspaces = 1;
+  // The most calls that are run as one batch. 1 disables batching.
+  int max_batch_size = 1;
+  // How long a batch that has fewer than `max_batch_size` calls waits for
+  // more before it runs.
+  std::chrono::microseconds batch_timeout{0};
+};
+
+/**
+ * A predictor that can be called from many threads at once. The parameters
+ * live in the workspace of the config, which is shared by a pool of child
+ * workspaces, each with its own instance of the predict net. A call runs on
+ * a free child workspace, preferably the one the calling thread used last,
+ * and waits if all of them are busy.
+ *
+ * Optionally, concurrent calls are batched: the thread that gets a free
+ * workspace concatenates the inputs of up to `max_batch_size` pending calls
+ * along their first dimension, runs the net once and splits the outputs
+ * between the calls. This requires a net whose outputs have the batch as
+ * their first dimension.
+ */
+class CAFFE2_API ConcurrentPredictor {
+ public:
+  using TensorList = Predictor::TensorList;
+
+  using Options = ConcurrentPredictorOptions;
+
+  explicit ConcurrentPredictor(
+      PredictorConfig config,
+      Options options = Options());
+
+  ConcurrentPredictor(const ConcurrentPredictor&) = delete;
+  ConcurrentPredictor& operator=(const ConcurrentPredictor&) = delete;
+
+  // Executes the predict net on the inputs, which are shared with the first
+  // `inputs.size()` external inputs of the net, like Predictor does. Unlike
+  // the outputs of Predictor, the outputs are owned by the caller and stay
+  // valid after other calls.
+  //
+  // Returns true on success. Errors of the net are rethrown to every call of
+  // the batch that raised them.
+  bool operator()(const TensorList& inputs, TensorList* outputs);
+
+  const NetDef& def() const {
+    return *config_.predict_net;
+  }
+
+  // The parent workspace, which holds the parameters.
+  Workspace* ws() {
+    return config_.ws.get();
+  }
+
+ private:
+  struct Worker {
+    std::unique_ptr<Workspace> ws;
+    NetBase* net = nullptr;
+    std::vector<Blob*> inputs;
+    std::vector<Blob*> outputs;
+    size_t index = 0;
+  };
+
+  struct Request {
+    const TensorList* inputs = nullptr;
+    TensorList* outputs = nullptr;
+    bool done = false;
+    bool success = false;
+    std::exception_ptr error;
+  };
+
+  // Takes a free worker, or returns nullptr if there is none. Called with
+  // `mutex_` held.
+  Worker* tryAcquire();
+  void release(Worker* worker);
+
+  bool run(Worker* worker, const TensorList& inputs, TensorList* outputs);
+  void runBatch(Worker* worker, const std::vector<Request*>& batch);
+
+  PredictorConfig config_;
+  Options options_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<Worker*> free_;
+  std::deque<Request*> pending_;
+  // Whether a thread holds a worker while it waits for a batch to fill.
+  bool collecting_ = false;
+
+  // The index of the worker each thread used last, whose workspace is more
+  // likely to still be in the caches of the thread's core.
+  ThreadLocalPtr<size_t> lastWorker_;
+};
+
+} // namespace caffe2
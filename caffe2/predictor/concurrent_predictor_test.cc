@@ -0,0 +1,167 @@
+#include <thread>
+#include <vector>
+
+#include "caffe2/core/context.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/tensor.h"
+#include "caffe2/predictor/concurrent_predictor.h"
+#include "caffe2/utils/math.h"
+#include "caffe2/utils/proto_utils.h"
+
+#include <gtest/gtest.h>
+
+namespace caffe2 {
+
+namespace {
+
+const char* predictSpec = R"DOC(
+        name: "predict"
+        type: "dag"
+        external_input: "data"
+        external_input: "W"
+        external_input: "b"
+        external_output: "y"
+        op {
+          input: "data"
+          input: "W"
+          input: "b"
+          output: "y"
+          type: "FC"
+        }
+)DOC";
+
+const char* initSpec = R"DOC(
+        name: "init"
+        type: "dag"
+        op {
+          type: "ConstantFill"
+          output: "W"
+          arg {
+            name: "shape"
+            ints: 10
+            ints: 4
+          }
+          arg {
+            name: "value"
+            f: 2.0
+          }
+        }
+        op {
+          type: "ConstantFill"
+          output: "b"
+          arg {
+            name: "shape"
+            ints: 10
+          }
+          arg {
+            name: "value"
+            f: 2.0
+          }
+        }
+)DOC";
+
+NetDef parseNetDef(const std::string& value) {
+  NetDef def;
+  CAFFE_ENFORCE(
+      TextFormat::ParseFromString(value, &def),
+      "Failed to parse NetDef with value: ",
+      value);
+  return def;
+}
+
+Tensor randomTensor(const std::vector<int64_t>& dims, CPUContext* ctx) {
+  Tensor t(dims, CPU);
+  math::RandUniform<float, CPUContext>(
+      t.numel(), -1.0, 1.0, t.template mutable_data<float>(), ctx);
+  return t;
+}
+
+PredictorConfig makeConfig() {
+  return makePredictorConfig(parseNetDef(initSpec), parseNetDef(predictSpec));
+}
+
+void expectSameOutputs(
+    const Predictor::TensorList& actual,
+    const Predictor::TensorList& expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < actual.size(); ++i) {
+    ASSERT_EQ(actual[i].sizes(), expected[i].sizes());
+    for (int64_t j = 0; j < actual[i].numel(); ++j) {
+      EXPECT_FLOAT_EQ(actual[i].data<float>()[j], expected[i].data<float>()[j]);
+    }
+  }
+}
+
+class ConcurrentPredictorTest : public testing::Test {
+ public:
+  void SetUp() override {
+    DeviceOption op;
+    op.set_random_seed(1701);
+    ctx_ = std::make_unique<CPUContext>(op);
+    p_ = std::make_unique<Predictor>(makeConfig());
+    for (int i = 0; i < 16; ++i) {
+      inputs_.emplace_back();
+      inputs_.back().push_back(randomTensor({1 + i % 3, 4}, ctx_.get()));
+      expected_.emplace_back();
+      ASSERT_TRUE((*p_)(inputs_.back(), &expected_.back()));
+      // The outputs of Predictor are overwritten by its next run.
+      for (auto& output : expected_.back()) {
+        output = output.Clone();
+      }
+    }
+  }
+
+  // Runs all inputs on `predictor` from several threads at once.
+  void runConcurrently(ConcurrentPredictor& predictor) {
+    constexpr int kThreads = 4;
+    std::vector<Predictor::TensorList> outputs(inputs_.size());
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.emplace_back([&, t]() {
+        for (size_t i = t; i < inputs_.size(); i += kThreads) {
+          EXPECT_TRUE(predictor(inputs_[i], &outputs[i]));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (size_t i = 0; i < inputs_.size(); ++i) {
+      expectSameOutputs(outputs[i], expected_[i]);
+    }
+  }
+
+  std::unique_ptr<CPUContext> ctx_;
+  std::unique_ptr<Predictor> p_;
+  std::vector<Predictor::TensorList> inputs_;
+  std::vector<Predictor::TensorList> expected_;
+};
+
+} // namespace
+
+TEST_F(ConcurrentPredictorTest, MatchesPredictor) {
+  ConcurrentPredictor::Options options;
+  options.num_workspaces = 3;
+  ConcurrentPredictor predictor(makeConfig(), options);
+  runConcurrently(predictor);
+}
+
+TEST_F(ConcurrentPredictorTest, BatchesCalls) {
+  ConcurrentPredictor::Options options;
+  options.num_workspaces = 2;
+  options.max_batch_size = 4;
+  options.batch_timeout = std::chrono::milliseconds(1);
+  ConcurrentPredictor predictor(makeConfig(), options);
+  runConcurrently(predictor);
+}
+
+TEST_F(ConcurrentPredictorTest, OutputsOutliveLaterCalls) {
+  ConcurrentPredictor predictor(makeConfig());
+  Predictor::TensorList first, second;
+  ASSERT_TRUE(predictor(inputs_[0], &first));
+  ASSERT_TRUE(predictor(inputs_[1], &second));
+  expectSameOutputs(first, expected_[0]);
+  expectSameOutputs(second, expected_[1]);
+}
+
+} // namespace caffe2
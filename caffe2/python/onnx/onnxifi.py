@@ -26,9 +26,14 @@ def onnxifi_caffe2_net(
         merge_fp32_inputs_into_fp16=False,
         adjust_batch=True,
         black_list=None,
-        weight_names=None):
+        weight_names=None,
+        batch_buckets=None):
     """
     Transform the caffe2_net by collapsing ONNXIFI-runnable nodes into Onnxifi c2 ops
+
+    batch_buckets lists batch sizes, up to max_batch_size, for which the
+    Onnxifi ops compile extra backend graphs. Batches are padded to the
+    smallest bucket that fits them. It requires use_onnx=False.
     """
     shape_hints = {}
     for k, v in input_shapes.items():
@@ -42,7 +47,8 @@ def onnxifi_caffe2_net(
                              adjust_batch,
                              debug,
                              merge_fp32_inputs_into_fp16,
-                             use_onnx)
+                             use_onnx,
+                             batch_buckets if batch_buckets else [])
     pred_net_cut = caffe2_pb2.NetDef()
     pred_net_cut.ParseFromString(pred_net_str)
     return pred_net_cut
@@ -408,6 +408,52 @@ class TestAdam(hu.HypothesisTestCase):
                 beta1=beta1, beta2=beta2, epsilon=epsilon, output_grad=True),
             input_device_options=input_device_options)
 
+    @given(sizes=st.lists(st.integers(1, 100), min_size=1, max_size=40),
+           ITER=st.integers(min_value=0, max_value=10000),
+           LR=st.floats(min_value=0.01, max_value=0.99,
+                        allow_nan=False, allow_infinity=False),
+           **hu.gcs)
+    def test_multi_adam(self, sizes, ITER, LR, gc, dc):
+        beta1, beta2, epsilon = 0.9, 0.999, 1e-5
+        ITER = np.array([ITER], dtype=np.int64)
+        LR = np.array([LR], dtype=np.float32)
+        inputs = []
+        names = []
+        output_names = []
+        for i, n in enumerate(sizes):
+            inputs += [
+                np.random.rand(n).astype(np.float32),
+                np.random.rand(n).astype(np.float32),
+                np.random.rand(n).astype(np.float32),
+                np.random.rand(n).astype(np.float32),
+            ]
+            names += ["param_{}".format(i), "mom1_{}".format(i),
+                      "mom2_{}".format(i), "grad_{}".format(i)]
+            output_names += names[-4:-1]
+
+        def ref_multi_adam(*args):
+            outputs = []
+            for i in range(len(sizes)):
+                outputs += self.ref_adam(
+                    *(args[4 * i:4 * i + 4] + args[-2:]),
+                    beta1=beta1, beta2=beta2, epsilon=epsilon)
+            return outputs
+
+        op = core.CreateOperator(
+            "MultiAdam",
+            names + ["lr", "iter"],
+            output_names,
+            beta1=beta1, beta2=beta2, epsilon=epsilon)
+
+        # Iter lives on the CPU
+        input_device_options = {'iter': hu.cpu_do}
+
+        self.assertReferenceChecks(
+            gc, op,
+            inputs + [LR, ITER],
+            ref_multi_adam,
+            input_device_options=input_device_options)
+
 
 if __name__ == "__main__":
     import unittest
@@ -102,6 +102,39 @@ class TestFcOperator(serial.SerializedTestCase):
     def test_fc_transposed(self, **kwargs):
         self._run_test(transposed=True, **kwargs)
 
+    @given(n=st.integers(1, 5),
+           m=st.integers(0, 5),
+           k=st.integers(1, 5),
+           activation=st.sampled_from(['Relu', 'Sigmoid', 'Tanh']),
+           **hu.gcs)
+    def test_fc_activation(self, n, m, k, activation, gc, dc):
+        X = np.random.rand(m, k).astype(np.float32) - 0.5
+        W = np.random.rand(n, k).astype(np.float32) - 0.5
+        b = np.random.rand(n).astype(np.float32) - 0.5
+
+        activations = {
+            'Relu': lambda y: np.maximum(y, 0),
+            'Sigmoid': lambda y: 1. / (1. + np.exp(-y)),
+            'Tanh': np.tanh,
+        }
+
+        def fc_activation_op(X, W, b):
+            return [activations[activation](np.dot(X, W.transpose()) + b)]
+
+        op = core.CreateOperator(
+            'FC',
+            ['X', 'W', 'b'],
+            'out',
+            activation=activation,
+        )
+        self.assertReferenceChecks(
+            device_option=gc,
+            op=op,
+            inputs=[X, W, b],
+            reference=fc_activation_op,
+        )
+        self.assertDeviceChecks(dc, op, [X, W, b], [0])
+
 
 if __name__ == "__main__":
     import unittest
@@ -28,7 +28,10 @@ import hypothesis.strategies as st
 from caffe2.proto import caffe2_pb2
 import caffe2.python.hypothesis_test_util as hu
 
-from caffe2.python import workspace, core
+from caffe2.python import build, workspace, core
+
+HAS_NVJPEG = workspace.has_gpu_support and \
+    build.build_options.get('USE_NVJPEG', 'OFF').upper() in ('1', 'ON', 'TRUE')
 
 
 # Verification routines (applies transformations to image to
@@ -235,6 +238,65 @@ def create_test(output_dir, width, height, default_bound, minsize, crop, means,
     return expected_results
 
 
+# Creates a db of JPEGs for comparing the nvJPEG and the OpenCV decode paths.
+# Every third image is a CMYK JPEG and every third a PNG, which nvJPEG can't
+# decode, so they take the OpenCV fallback.
+def create_jpeg_test(output_dir, width, height, count):
+    LMDB_MAP_SIZE = 1 << 40
+    env = lmdb.open(output_dir, map_size=LMDB_MAP_SIZE, subdir=True)
+    with env.begin(write=True) as txn:
+        for index in range(count):
+            # smooth images, so that the lossy encoding stays close to them
+            y, x = np.mgrid[0:height, 0:width]
+            img_array = np.stack([
+                255 * x / width, 255 * y / height, 128 + 64 * np.sin(x / 7.)
+            ], axis=2).astype(np.uint8)
+            img_obj = Image.fromarray(img_array)
+            img_str = six.BytesIO()
+            if index % 3 == 0:
+                img_obj.save(img_str, 'JPEG', quality=95)
+            elif index % 3 == 1:
+                img_obj.convert('CMYK').save(img_str, 'JPEG', quality=95)
+            else:
+                img_obj.save(img_str, 'PNG')
+
+            tensor_protos = caffe2_pb2.TensorProtos()
+            image_tensor = tensor_protos.protos.add()
+            image_tensor.data_type = 4  # string data
+            image_tensor.string_data.append(img_str.getvalue())
+            img_str.close()
+            label_tensor = tensor_protos.protos.add()
+            label_tensor.data_type = 2  # int32 data
+            label_tensor.int32_data.append(index)
+            txn.put(
+                '{}'.format(index).encode('ascii'),
+                tensor_protos.SerializeToString()
+            )
+
+
+def run_decode(db, count, use_gpu_decode, **kwargs):
+    with hu.temp_workspace():
+        reader_net = core.Net('reader')
+        reader_net.CreateDB([], 'DB', db=db, db_type="lmdb")
+        workspace.RunNetOnce(reader_net)
+        imageop = core.CreateOperator(
+            'ImageInput',
+            ['DB'],
+            ['data', 'label'],
+            batch_size=count,
+            color=3,
+            is_test=1,
+            use_gpu_transform=True,
+            use_gpu_decode=use_gpu_decode,
+            **kwargs
+        )
+        imageop.device_option.CopyFrom(hu.gpu_do)
+        main_net = core.Net('main')
+        main_net.Proto().op.extend([imageop])
+        workspace.RunNetOnce(main_net)
+        return workspace.FetchBlob('data'), workspace.FetchBlob('label')
+
+
 def run_test(
         size_tuple, means, stds, label_type, num_labels, is_test, scale_jitter_type,
         color_jitter, color_lighting, dc, validator, output1=None, output2_size=None):
@@ -427,6 +489,36 @@ class TestImport(hu.HypothesisTestCase):
             validator, output1, output2_size)
     # End test_imageinput
 
+    @unittest.skipIf(not HAS_NVJPEG, 'Caffe2 is not built with CUDA and nvJPEG')
+    def test_imageinput_gpu_decode(self):
+        count = 6
+        out_dir = tempfile.mkdtemp()
+        try:
+            create_jpeg_test(out_dir, width=67, height=45, count=count)
+            for kwargs in [
+                # an exact crop of the decoded image
+                dict(minsize=40, crop=32),
+                # resized in the fused crop kernel
+                dict(scale=64, crop=48),
+                dict(minsize=40, crop=32, bounding_ymin=3, bounding_xmin=5,
+                     bounding_height=40, bounding_width=60),
+            ]:
+                cpu_data, cpu_label = run_decode(out_dir, count, False, **kwargs)
+                gpu_data, gpu_label = run_decode(out_dir, count, True, **kwargs)
+                np.testing.assert_array_equal(gpu_label, cpu_label)
+                self.assertEqual(gpu_data.shape, cpu_data.shape)
+                # nvJPEG and libjpeg may round differently, and the GPU
+                # resamples with a single bilinear pass
+                np.testing.assert_allclose(gpu_data, cpu_data, atol=12)
+                self.assertLess(np.abs(gpu_data - cpu_data).mean(), 2)
+                # the images nvJPEG can't decode go through OpenCV on both paths
+                if 'scale' not in kwargs:
+                    for i in range(count):
+                        if i % 3 != 0:
+                            np.testing.assert_array_equal(gpu_data[i], cpu_data[i])
+        finally:
+            shutil.rmtree(out_dir)
+
 
 if __name__ == '__main__':
     import unittest
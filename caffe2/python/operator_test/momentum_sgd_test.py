@@ -184,6 +184,63 @@ class TestMomentumSGD(serial.SerializedTestCase):
             threshold=threshold
         )
 
+    @given(
+        sizes=st.lists(st.integers(1, 100), min_size=1, max_size=40),
+        nesterov=st.booleans(),
+        **hu.gcs
+    )
+    def test_multi_momentum_sgd(self, sizes, nesterov, gc, dc):
+        momentum = 0.9
+        lr = np.random.rand(1).astype(np.float32)
+        inputs = []
+        for n in sizes:
+            inputs += [
+                np.random.rand(n).astype(np.float32),
+                np.random.rand(n).astype(np.float32),
+                np.random.rand(n).astype(np.float32),
+            ]
+        inputs.append(lr)
+
+        def multi_momentum_sgd(*args):
+            lr = args[-1]
+            outputs = []
+            for i in range(len(sizes)):
+                grad, param_momentum, param = args[3 * i:3 * i + 3]
+                if not nesterov:
+                    adjusted_gradient = lr * grad + momentum * param_momentum
+                    outputs += [
+                        adjusted_gradient,
+                        adjusted_gradient,
+                        param - adjusted_gradient,
+                    ]
+                else:
+                    m_new = momentum * param_momentum + lr * grad
+                    grad_new = (1 + momentum) * m_new - momentum * param_momentum
+                    outputs += [grad_new, m_new, param - grad_new]
+            return outputs
+
+        names = []
+        for i in range(len(sizes)):
+            names += [
+                "grad_{}".format(i),
+                "param_momentum_{}".format(i),
+                "param_{}".format(i),
+            ]
+        op = core.CreateOperator(
+            "MultiMomentumSGDUpdate",
+            names + ["lr"],
+            names,
+            momentum=momentum,
+            nesterov=int(nesterov),
+        )
+
+        self.assertReferenceChecks(
+            device_option=gc,
+            op=op,
+            inputs=inputs,
+            reference=multi_momentum_sgd
+        )
+
 
 if __name__ == "__main__":
     unittest.main()
@@ -1717,7 +1717,8 @@ void addGlobalMethods(py::module& m) {
          bool adjust_batch,
          bool debug_builder,
          bool merge_fp32_inputs_into_fp16,
-         bool use_onnx) -> py::bytes {
+         bool use_onnx,
+         const std::vector<int>& batch_buckets) -> py::bytes {
         caffe2::NetDef pred_net;
         CAFFE_ENFORCE(
             ParseProtoFromLargeString(
@@ -1737,6 +1738,7 @@ void addGlobalMethods(py::module& m) {
         opts.debug = debug_builder;
         opts.merge_fp32_inputs_into_fp16 = merge_fp32_inputs_into_fp16;
         opts.use_onnx = use_onnx;
+        opts.batch_buckets = batch_buckets;
         OnnxifiTransformer ts(opts);
         Workspace* curr_ws = GetCurrentWorkspace();
         std::unordered_set<int> blacklist_set(
@@ -1,6 +1,8 @@
 #include "caffe2/queue/blobs_queue.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
@@ -29,15 +31,18 @@ BlobsQueue::BlobsQueue(
     size_t numBlobs,
     bool enforceUniqueName,
     const std::vector<std::string>& fieldNames)
-    : numBlobs_(numBlobs), name_(queueName), stats_(queueName) {
+    : numBlobs_(numBlobs),
+      capacity_(capacity),
+      slots_(new Slot[capacity]),
+      name_(queueName),
+      stats_(queueName) {
   if (!fieldNames.empty()) {
     CAFFE_ENFORCE_EQ(
         fieldNames.size(), numBlobs, "Wrong number of fieldNames provided.");
     stats_.queue_dequeued_bytes.setDetails(fieldNames);
   }
-  queue_.reserve(capacity);
   for (size_t i = 0; i < capacity; ++i) {
-    std::vector<Blob*> blobs;
+    auto& blobs = slots_[i].blobs;
     blobs.reserve(numBlobs);
     for (size_t j = 0; j < numBlobs; ++j) {
       const auto blobName = queueName + "_" + to_string(i) + "_" + to_string(j);
@@ -49,9 +54,8 @@ BlobsQueue::BlobsQueue(
       }
       blobs.push_back(ws->CreateBlob(blobName));
     }
-    queue_.push_back(blobs);
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
   }
-  DCHECK_EQ(queue_.size(), capacity);
 }
 
 bool BlobsQueue::blockingRead(
@@ -61,44 +65,34 @@ bool BlobsQueue::blockingRead(
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_read_start, name, (void*)this, SDT_BLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
-  auto canRead = [this]() {
-    CAFFE_ENFORCE_LE(reader_, writer_);
-    return reader_ != writer_;
-  };
   // Decrease queue balance before reading to indicate queue read pressure
   // is being increased (-ve queue balance indicates more reads than writes)
   CAFFE_EVENT(stats_, queue_balance, -1);
-  if (timeout_secs > 0) {
-    std::chrono::milliseconds timeout_ms(int(timeout_secs * 1000));
-    cv_.wait_for(
-        g, timeout_ms, [this, canRead]() { return closing_ || canRead(); });
-  } else {
-    cv_.wait(g, [this, canRead]() { return closing_ || canRead(); });
-  }
-  if (!canRead()) {
-    if (timeout_secs > 0 && !closing_) {
-      LOG(ERROR) << "DequeueBlobs timed out in " << timeout_secs << " secs";
-      CAFFE_SDT(queue_read_end, name, (void*)this, SDT_TIMEOUT);
-    } else {
-      CAFFE_SDT(queue_read_end, name, (void*)this, SDT_CANCEL);
+  const auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(int(timeout_secs * 1000));
+  bool waited = false;
+  while (!tryReadSlot(inputs)) {
+    if (closing_ || (timeout_secs > 0 &&
+                     std::chrono::steady_clock::now() >= deadline)) {
+      if (timeout_secs > 0 && !closing_) {
+        LOG(ERROR) << "DequeueBlobs timed out in " << timeout_secs << " secs";
+        CAFFE_SDT(queue_read_end, name, (void*)this, SDT_TIMEOUT);
+      } else {
+        CAFFE_SDT(queue_read_end, name, (void*)this, SDT_CANCEL);
+      }
+      return false;
     }
-    return false;
-  }
-  DCHECK(canRead());
-  auto& result = queue_[reader_ % queue_.size()];
-  CAFFE_ENFORCE(inputs.size() >= result.size());
-  for (auto i = 0; i < result.size(); ++i) {
-    auto bytes = BlobStat::sizeBytes(*result[i]);
-    CAFFE_EVENT(stats_, queue_dequeued_bytes, bytes, i);
-    using std::swap;
-    swap(*(inputs[i]), *(result[i]));
+    waited = true;
+    waitUntil(
+        waitingReaders_,
+        notEmpty_,
+        [this]() { return canRead(); },
+        timeout_secs > 0 ? &deadline : nullptr);
   }
-  CAFFE_SDT(queue_read_end, name, (void*)this, writer_ - reader_);
-  CAFFE_EVENT(stats_, queue_dequeued_records);
-  ++reader_;
-  cv_.notify_all();
   CAFFE_EVENT(stats_, read_time_ns, readTimer.NanoSeconds());
+  if (waited) {
+    CAFFE_EVENT(stats_, read_wait_time_ns, readTimer.NanoSeconds());
+  }
   return true;
 }
 
@@ -107,16 +101,13 @@ bool BlobsQueue::tryWrite(const std::vector<Blob*>& inputs) {
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_write_start, name, (void*)this, SDT_NONBLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
-  if (!canWrite()) {
+  if (!tryWriteSlot(inputs)) {
     CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
     return false;
   }
-  // Increase queue balance before writing to indicate queue write pressure is
+  // Increase queue balance after writing to indicate queue write pressure is
   // being increased (+ve queue balance indicates more writes than reads)
   CAFFE_EVENT(stats_, queue_balance, 1);
-  DCHECK(canWrite());
-  doWrite(inputs);
   CAFFE_EVENT(stats_, write_time_ns, writeTimer.NanoSeconds());
   return true;
 }
@@ -126,18 +117,26 @@ bool BlobsQueue::blockingWrite(const std::vector<Blob*>& inputs) {
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_write_start, name, (void*)this, SDT_BLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
   // Increase queue balance before writing to indicate queue write pressure is
   // being increased (+ve queue balance indicates more writes than reads)
   CAFFE_EVENT(stats_, queue_balance, 1);
-  cv_.wait(g, [this]() { return closing_ || canWrite(); });
-  if (!canWrite()) {
-    CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
-    return false;
+  bool waited = false;
+  while (!tryWriteSlot(inputs)) {
+    if (closing_) {
+      CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
+      return false;
+    }
+    waited = true;
+    waitUntil(
+        waitingWriters_,
+        notFull_,
+        [this]() { return canWrite(); },
+        /*deadline=*/nullptr);
   }
-  DCHECK(canWrite());
-  doWrite(inputs);
   CAFFE_EVENT(stats_, write_time_ns, writeTimer.NanoSeconds());
+  if (waited) {
+    CAFFE_EVENT(stats_, write_wait_time_ns, writeTimer.NanoSeconds());
+  }
   return true;
 }
 
@@ -145,29 +144,137 @@ void BlobsQueue::close() {
   closing_ = true;
 
   std::lock_guard<std::mutex> g(mutex_);
-  cv_.notify_all();
+  notEmpty_.notify_all();
+  notFull_.notify_all();
 }
 
-bool BlobsQueue::canWrite() {
-  // writer is always within [reader, reader + size)
-  // we can write if reader is within [reader, reader + size)
-  CAFFE_ENFORCE_LE(reader_, writer_);
-  CAFFE_ENFORCE_LE(writer_, reader_ + queue_.size());
-  return writer_ != reader_ + queue_.size();
+bool BlobsQueue::canRead() const {
+  const auto reader = reader_.load(std::memory_order_relaxed);
+  return slots_[reader % capacity_].sequence.load(std::memory_order_acquire) ==
+      reader + 1;
 }
 
-void BlobsQueue::doWrite(const std::vector<Blob*>& inputs) {
-  auto& result = queue_[writer_ % queue_.size()];
+bool BlobsQueue::canWrite() const {
+  const auto writer = writer_.load(std::memory_order_relaxed);
+  return slots_[writer % capacity_].sequence.load(std::memory_order_acquire) ==
+      writer;
+}
+
+bool BlobsQueue::tryReadSlot(const std::vector<Blob*>& inputs) {
+  auto reader = reader_.load(std::memory_order_relaxed);
+  Slot* slot;
+  for (;;) {
+    slot = &slots_[reader % capacity_];
+    const auto sequence = slot->sequence.load(std::memory_order_acquire);
+    const auto diff = sequence - (reader + 1);
+    if (diff == 0) {
+      // The slot was written at this position: claim it.
+      if (reader_.compare_exchange_weak(
+              reader, reader + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The slot still holds the record of the previous lap, or was not
+      // written yet: the queue is empty.
+      return false;
+    } else {
+      // Another reader claimed this position.
+      reader = reader_.load(std::memory_order_relaxed);
+    }
+  }
+
+  auto& result = slot->blobs;
+  CAFFE_ENFORCE(inputs.size() >= result.size());
+  for (auto i = 0; i < result.size(); ++i) {
+    auto bytes = BlobStat::sizeBytes(*result[i]);
+    CAFFE_EVENT(stats_, queue_dequeued_bytes, bytes, i);
+    using std::swap;
+    swap(*(inputs[i]), *(result[i]));
+  }
+  // Releases the slot to the writer of the next lap.
+  slot->sequence.store(reader + capacity_, std::memory_order_release);
+  const auto depth = size();
+  CAFFE_SDT(queue_read_end, name_.c_str(), (void*)this, depth);
+  CAFFE_EVENT(stats_, queue_dequeued_records);
+  CAFFE_EVENT(stats_, queue_depth, depth);
+  notify(waitingWriters_, notFull_);
+  return true;
+}
+
+bool BlobsQueue::tryWriteSlot(const std::vector<Blob*>& inputs) {
+  auto writer = writer_.load(std::memory_order_relaxed);
+  Slot* slot;
+  for (;;) {
+    slot = &slots_[writer % capacity_];
+    const auto sequence = slot->sequence.load(std::memory_order_acquire);
+    const auto diff = sequence - writer;
+    if (diff == 0) {
+      if (writer_.compare_exchange_weak(
+              writer, writer + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The slot was not read in the previous lap yet: the queue is full.
+      return false;
+    } else {
+      writer = writer_.load(std::memory_order_relaxed);
+    }
+  }
+
+  auto& result = slot->blobs;
   CAFFE_ENFORCE(inputs.size() >= result.size());
-  const auto& name = name_.c_str();
   for (auto i = 0; i < result.size(); ++i) {
     using std::swap;
     swap(*(inputs[i]), *(result[i]));
   }
+  // Publishes the record to the reader of this position.
+  slot->sequence.store(writer + 1, std::memory_order_release);
+  const auto depth = size();
   CAFFE_SDT(
-      queue_write_end, name, (void*)this, reader_ + queue_.size() - writer_);
-  ++writer_;
-  cv_.notify_all();
+      queue_write_end, name_.c_str(), (void*)this, capacity_ - depth);
+  CAFFE_EVENT(stats_, queue_depth, depth);
+  notify(waitingReaders_, notEmpty_);
+  return true;
+}
+
+template <typename Ready>
+void BlobsQueue::waitUntil(
+    std::atomic<int>& waiters,
+    std::condition_variable& cv,
+    const Ready& ready,
+    const std::chrono::steady_clock::time_point* deadline) {
+  // Waiters are counted before they check `ready()`, and `notify()` checks
+  // the count after the slot was published. The fences order both, so either
+  // the waiter sees the slot or the notifier sees the waiter, and then wakes
+  // it up under the mutex.
+  ++waiters;
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  {
+    std::unique_lock<std::mutex> g(mutex_);
+    auto predicate = [this, &ready]() { return closing_ || ready(); };
+    if (deadline) {
+      cv.wait_until(g, *deadline, predicate);
+    } else {
+      cv.wait(g, predicate);
+    }
+  }
+  --waiters;
+}
+
+void BlobsQueue::notify(
+    std::atomic<int>& waiters,
+    std::condition_variable& cv) {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (waiters.load(std::memory_order_relaxed) > 0) {
+    std::lock_guard<std::mutex> g(mutex_);
+    cv.notify_one();
+  }
+}
+
+int64_t BlobsQueue::size() const {
+  const auto depth = writer_.load(std::memory_order_relaxed) -
+      reader_.load(std::memory_order_relaxed);
+  return std::max<int64_t>(0, std::min<int64_t>(depth, capacity_));
 }
 
 } // namespace caffe2
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
@@ -15,7 +16,11 @@
 namespace caffe2 {
 
 // A thread-safe, bounded, blocking queue.
-// Modelled as a circular buffer.
+// Modelled as a lock-free multi-producer multi-consumer circular buffer: each
+// slot carries a sequence number that says whether it is ready to be written
+// or read at a given position, and readers and writers claim positions with a
+// compare-and-swap. Threads only take the mutex to sleep when the queue is
+// empty (readers) or full (writers), and to wake such threads up.
 
 // Containing blobs are owned by the workspace.
 // On read, we swap out the underlying data for the blob passed in for blobs
@@ -45,17 +50,47 @@ class CAFFE2_API BlobsQueue : public std::enable_shared_from_this<BlobsQueue> {
   }
 
  private:
-  bool canWrite();
-  void doWrite(const std::vector<Blob*>& inputs);
+  struct Slot {
+    // The position the slot can be written at, or that position plus one once
+    // it was written and can be read.
+    std::atomic<int64_t> sequence;
+    std::vector<Blob*> blobs;
+  };
+
+  bool canRead() const;
+  bool canWrite() const;
+  // Return false if the queue is empty (full) instead of waiting.
+  bool tryReadSlot(const std::vector<Blob*>& inputs);
+  bool tryWriteSlot(const std::vector<Blob*>& inputs);
+  // Sleeps until `ready()` or the queue is closed, or until `deadline` if it is
+  // not null. `waiters` counts the threads that sleep on `cv`.
+  template <typename Ready>
+  void waitUntil(
+      std::atomic<int>& waiters,
+      std::condition_variable& cv,
+      const Ready& ready,
+      const std::chrono::steady_clock::time_point* deadline);
+  void notify(std::atomic<int>& waiters, std::condition_variable& cv);
+  int64_t size() const;
 
   std::atomic<bool> closing_{false};
 
   size_t numBlobs_;
-  std::mutex mutex_; // protects all variables in the class.
-  std::condition_variable cv_;
-  int64_t reader_{0};
-  int64_t writer_{0};
-  std::vector<std::vector<Blob*>> queue_;
+  size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  // The next positions to write and read. They are padded to separate cache
+  // lines, so writers and readers do not contend on them.
+  char padding0_[64];
+  std::atomic<int64_t> writer_{0};
+  char padding1_[64];
+  std::atomic<int64_t> reader_{0};
+  char padding2_[64];
+
+  std::mutex mutex_; // only used to sleep on the condition variables.
+  std::condition_variable notEmpty_;
+  std::condition_variable notFull_;
+  std::atomic<int> waitingReaders_{0};
+  std::atomic<int> waitingWriters_{0};
   const std::string name_;
 
   struct QueueStats {
@@ -65,6 +100,11 @@ class CAFFE2_API BlobsQueue : public std::enable_shared_from_this<BlobsQueue> {
     CAFFE_DETAILED_EXPORTED_STAT(queue_dequeued_bytes);
     CAFFE_AVG_EXPORTED_STAT(read_time_ns);
     CAFFE_AVG_EXPORTED_STAT(write_time_ns);
+    // The number of records in the queue after each read or write.
+    CAFFE_AVG_EXPORTED_STAT(queue_depth);
+    // The time reads (writes) that found the queue empty (full) waited.
+    CAFFE_AVG_EXPORTED_STAT(read_wait_time_ns);
+    CAFFE_AVG_EXPORTED_STAT(write_wait_time_ns);
   } stats_;
 };
 } // namespace caffe2
@@ -0,0 +1,73 @@
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "caffe2/core/workspace.h"
+#include "caffe2/queue/blobs_queue.h"
+#include <gtest/gtest.h>
+
+namespace caffe2 {
+namespace {
+
+TEST(BlobsQueueTest, TryWriteFailsWhenFull) {
+  Workspace ws;
+  auto queue = std::make_shared<BlobsQueue>(&ws, "queue", 2, 1, true);
+  Blob blob;
+  *blob.GetMutable<int>() = 1;
+  EXPECT_TRUE(queue->tryWrite({&blob}));
+  EXPECT_TRUE(queue->tryWrite({&blob}));
+  EXPECT_FALSE(queue->tryWrite({&blob}));
+
+  EXPECT_TRUE(queue->blockingRead({&blob}));
+  EXPECT_TRUE(queue->tryWrite({&blob}));
+}
+
+TEST(BlobsQueueTest, ReadsTimeOutAndStopWhenClosed) {
+  Workspace ws;
+  auto queue = std::make_shared<BlobsQueue>(&ws, "queue", 1, 1, true);
+  Blob blob;
+  EXPECT_FALSE(queue->blockingRead({&blob}, 0.01));
+
+  std::thread reader([&]() { EXPECT_FALSE(queue->blockingRead({&blob})); });
+  queue->close();
+  reader.join();
+}
+
+TEST(BlobsQueueTest, ManyReadersAndWriters) {
+  constexpr int kThreads = 4;
+  constexpr int kRecordsPerThread = 1000;
+  Workspace ws;
+  auto queue = std::make_shared<BlobsQueue>(&ws, "queue", 8, 1, true);
+
+  std::vector<std::thread> threads;
+  std::vector<int64_t> sums(kThreads, 0);
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&queue, t]() {
+      Blob blob;
+      for (int i = 0; i < kRecordsPerThread; ++i) {
+        *blob.GetMutable<int>() = t * kRecordsPerThread + i;
+        EXPECT_TRUE(queue->blockingWrite({&blob}));
+      }
+    });
+    threads.emplace_back([&queue, &sums, t]() {
+      Blob blob;
+      for (int i = 0; i < kRecordsPerThread; ++i) {
+        EXPECT_TRUE(queue->blockingRead({&blob}));
+        sums[t] += blob.Get<int>();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  int64_t sum = 0;
+  for (const auto s : sums) {
+    sum += s;
+  }
+  const int64_t n = kThreads * kRecordsPerThread;
+  EXPECT_EQ(sum, n * (n - 1) / 2);
+}
+
+} // namespace
+} // namespace caffe2
@@ -1,14 +1,32 @@
 #include "rebatching_queue.h"
-#include "caffe2/utils/smart_tensor_printer.h"
 
 namespace caffe2 {
 
 namespace {
 
+using ExampleTensor = RebatchingQueue::ExampleTensor;
+
+std::vector<int64_t> exampleDims(const ExampleTensor& example) {
+  auto dims = example.tensor->sizes().vec();
+  if (example.index >= 0) {
+    dims.erase(dims.begin());
+  }
+  return dims;
+}
+
+const void* exampleData(const ExampleTensor& example) {
+  const auto& tensor = *example.tensor;
+  if (example.index < 0) {
+    return tensor.raw_data();
+  }
+  return (const char*)tensor.raw_data() +
+      example.index * tensor.size_from_dim(1) * tensor.itemsize();
+}
+
 // This concat function will always create a new first dimension to concat
 void concat(
     CPUContext& context,
-    const std::vector<std::vector<TensorCPU>>& inputs,
+    const std::vector<std::vector<ExampleTensor>>& inputs,
     const std::vector<TensorCPU*>& outputs) {
   CAFFE_ENFORCE(!inputs.empty());
 
@@ -17,79 +35,77 @@ void concat(
   const auto numRows = inputs.size();
 
   // Precompute the output sizes to avoid resizing
+  std::vector<std::vector<int64_t>> exampleSizes(numTensors);
   std::vector<std::vector<int64_t>> outputDims(numTensors);
 
   for (size_t i = 0; i < numTensors; ++i) {
-    SmartTensorPrinter::PrintTensor(inputZero.at(i));
-    outputDims[i] = inputZero.at(i).sizes().vec();
+    exampleSizes[i] = exampleDims(inputZero.at(i));
+    outputDims[i] = exampleSizes[i];
     outputDims[i].insert(outputDims[i].begin(), numRows);
   }
 
-  // Resize to the final output size
-  std::vector<void*> destinations(numTensors);
-  for (size_t i = 0; i < numTensors; ++i) {
-    outputs[i]->Resize(outputDims[i]);
-    destinations[i] = outputs[i]->raw_mutable_data(inputZero[i].meta());
-  }
-
   for (size_t i = 0; i < numRows; ++i) {
     CAFFE_ENFORCE_EQ(inputs[i].size(), numTensors);
+  }
+
+  for (size_t j = 0; j < numTensors; ++j) {
+    const auto& meta = inputZero[j].tensor->dtype();
+    outputs[j]->Resize(outputDims[j]);
+    auto* destination = (char*)outputs[j]->raw_mutable_data(meta);
 
-    for (int j = 0; j < numTensors; ++j) {
+    for (size_t i = 0; i < numRows;) {
       const auto& input = inputs[i][j];
 
-      CAFFE_ENFORCE(inputZero[j].meta() == input.dtype());
-      CAFFE_ENFORCE_EQ(inputZero[j].itemsize(), input.itemsize());
-      CAFFE_ENFORCE_EQ(inputZero[j].ndim(), input.dim());
-      for (int k = 0; k < input.dim(); ++k) {
-        CAFFE_ENFORCE_EQ(input.sizes()[k], inputZero[j].size(k));
+      CAFFE_ENFORCE(meta == input.tensor->dtype());
+      const auto dims = exampleDims(input);
+      CAFFE_ENFORCE_EQ(exampleSizes[j].size(), dims.size());
+      for (size_t k = 0; k < dims.size(); ++k) {
+        CAFFE_ENFORCE_EQ(dims[k], exampleSizes[j][k]);
       }
 
-      // Skip empty tensors
-      if (input.numel() == 0) {
-        continue;
+      // Consecutive rows of the same batch are contiguous in memory and are
+      // copied at once
+      size_t rows = 1;
+      if (input.index >= 0) {
+        while (i + rows < numRows &&
+               inputs[i + rows][j].tensor == input.tensor &&
+               inputs[i + rows][j].index == input.index + (int64_t)rows) {
+          ++rows;
+        }
       }
 
-      context.CopyItemsToCPU(
-          input.dtype(),
-          input.numel(),
-          input.raw_data() /* src */,
-          destinations[j] /* dst */
-      );
+      const auto numel = rows * outputs[j]->size_from_dim(1);
 
-      destinations[j] =
-          (char*)destinations[j] + input.numel() * input.itemsize();
+      // Skip empty tensors
+      if (numel > 0) {
+        context.CopyItemsToCPU(
+            meta, numel, exampleData(input) /* src */, destination /* dst */);
+        destination += numel * meta.itemsize();
+      }
+      i += rows;
     }
   }
 }
 
-std::vector<std::vector<TensorCPU>> split(
-    CPUContext& context,
+// The rows of a batch are not copied, every example refers to its row of a
+// single copy of the batch
+std::vector<std::vector<ExampleTensor>> split(
     const std::vector<const TensorCPU*>& inputs) {
   CAFFE_ENFORCE(!inputs.empty());
 
   const auto outputSize = inputs[0]->sizes().at(0);
-  std::vector<std::vector<TensorCPU>> outputs(outputSize);
+  std::vector<std::vector<ExampleTensor>> outputs(outputSize);
 
   for (const auto* inputPtr : inputs) {
     CAFFE_ENFORCE(inputPtr);
 
     const auto& input = *inputPtr;
-    const auto innerSize = input.size_from_dim(1);
-    const auto itemSize = input.dtype().itemsize();
-
-    auto outputDims = input.sizes().vec();
-    CAFFE_ENFORCE(!outputDims.empty());
-    outputDims.erase(outputDims.begin());
+    CAFFE_ENFORCE(!input.sizes().empty());
     CAFFE_ENFORCE_EQ(input.sizes().at(0), outputSize);
 
-    for (int i = 0; i < outputSize; ++i) {
-      outputs[i].push_back(Tensor(outputDims, CPU));
-      context.CopyItemsToCPU(
-          input.dtype(),
-          innerSize,
-          (char*)input.raw_data() + i * innerSize * itemSize /* src */,
-          outputs[i].back().raw_mutable_data(input.dtype()) /* dst */);
+    auto batch = std::make_shared<const TensorCPU>(input.Clone());
+    for (int64_t i = 0; i < outputSize; ++i) {
+      outputs[i].push_back(ExampleTensor{batch, i});
     }
   }
 
@@ -112,7 +128,7 @@ bool RebatchingQueue::dequeue(
     CPUContext& context,
     size_t numElements,
     const std::vector<TensorCPU*>& outputs) {
-  std::vector<std::vector<TensorCPU>> results;
+  std::vector<std::vector<ExampleTensor>> results;
   results.reserve(numElements);
 
   for (;;) {
@@ -158,29 +174,30 @@ bool RebatchingQueue::canWrite() const {
 bool RebatchingQueue::enqueueOne(
     CPUContext& /*context*/,
     const std::vector<const TensorCPU*>& inputs) {
-  std::vector<std::vector<TensorCPU>> splittedInputs;
+  std::vector<std::vector<ExampleTensor>> splittedInputs;
   splittedInputs.emplace_back();
   auto& tensorVector = splittedInputs.back();
   tensorVector.reserve(inputs.size());
   for (const auto* tensorPtr : inputs) {
-    tensorVector.push_back(tensorPtr->Clone());
+    tensorVector.push_back(ExampleTensor{
+        std::make_shared<const TensorCPU>(tensorPtr->Clone()), -1});
   }
 
   return enqueue(std::move(splittedInputs));
 }
 
 bool RebatchingQueue::enqueueMany(
-    CPUContext& context,
+    CPUContext& /*context*/,
     const std::vector<const TensorCPU*>& inputs) {
   CAFFE_ENFORCE_EQ(numBlobs_, inputs.size());
 
-  std::vector<std::vector<TensorCPU>> splittedInputs;
-  splittedInputs = split(context, inputs);
+  std::vector<std::vector<ExampleTensor>> splittedInputs;
+  splittedInputs = split(inputs);
   return enqueue(std::move(splittedInputs));
 }
 
 bool RebatchingQueue::enqueue(
-    std::vector<std::vector<TensorCPU>> splittedInputs) {
+    std::vector<std::vector<ExampleTensor>> splittedInputs) {
   int idx = 0;
   for (;;) {
     if (idx >= splittedInputs.size()) {
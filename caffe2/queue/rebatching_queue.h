@@ -15,10 +15,19 @@ namespace caffe2 {
 
 // TODO: This is a very naive implementation with a single mutex. We can do the
 // atomic index + circular queue optimizations or pull something more
-// heavy-weight later
+// heavy-weight later. The critical sections only move ExampleTensors around,
+// the data of the examples is copied outside of them.
 
 class RebatchingQueue {
  public:
+  // An example of one blob: the index-th row of a batch that was enqueued by
+  // enqueueMany, or a whole tensor enqueued by enqueueOne (index -1). The rows
+  // of a batch share a single copy of it.
+  struct ExampleTensor {
+    std::shared_ptr<const TensorCPU> tensor;
+    int64_t index;
+  };
+
   RebatchingQueue(size_t capacity, size_t numBlobs);
 
   ~RebatchingQueue();
@@ -45,7 +54,7 @@ class RebatchingQueue {
   void close();
 
  private:
-  bool enqueue(std::vector<std::vector<TensorCPU>> splittedInputs);
+  bool enqueue(std::vector<std::vector<ExampleTensor>> splittedInputs);
 
   bool canWrite() const;
   bool canRead() const;
@@ -63,6 +72,6 @@ class RebatchingQueue {
   std::condition_variable cvEmpty_;
   std::condition_variable cvOverflow_;
 
-  std::vector<std::vector<TensorCPU>> queue_;
+  std::vector<std::vector<ExampleTensor>> queue_;
 };
 } // caffe2
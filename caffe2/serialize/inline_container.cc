@@ -244,6 +244,19 @@ size_t PyTorchStreamReader::getRecordOffset(const std::string& name) {
   return stat.m_local_header_ofs + MZ_ZIP_LOCAL_DIR_HEADER_SIZE + filename_len + extra_len;
 }
 
+size_t PyTorchStreamReader::getRecordSize(const std::string& name) {
+  mz_zip_archive_file_stat stat;
+  mz_zip_reader_file_stat(ar_.get(), getRecordID(name), &stat);
+  valid("retrieving file meta-data for ", name.c_str());
+  return stat.m_uncomp_size;
+}
+
+bool PyTorchStreamReader::isRecordCompressed(const std::string& name) {
+  mz_zip_archive_file_stat stat;
+  mz_zip_reader_file_stat(ar_.get(), getRecordID(name), &stat);
+  valid("retrieving file meta-data for ", name.c_str());
+  return stat.m_method != 0;
+}
 
 PyTorchStreamReader::~PyTorchStreamReader() {
   mz_zip_reader_end(ar_.get());
@@ -105,6 +105,10 @@ class CAFFE2_API PyTorchStreamReader final {
   // return dataptr, size
   std::tuple<at::DataPtr, size_t> getRecord(const std::string& name);
   size_t getRecordOffset(const std::string& name);
+  // the size of the record once extracted
+  size_t getRecordSize(const std::string& name);
+  // records that are not compressed are stored verbatim at getRecordOffset()
+  bool isRecordCompressed(const std::string& name);
   bool hasRecord(const std::string& name);
   std::vector<std::string> getAllRecords();
 
@@ -5,6 +5,7 @@
 #include <gtest/gtest.h>
 
 #include "caffe2/serialize/inline_container.h"
+#include "caffe2/serialize/mmap_file_adapter.h"
 
 namespace caffe2 {
 namespace serialize {
@@ -63,6 +64,48 @@ TEST(PyTorchStreamWriterAndReader, SaveAndLoad) {
   ASSERT_EQ(memcmp(the_file.c_str() + off2, data2.data(), data2.size()), 0);
 }
 
+TEST(PyTorchStreamWriterAndReader, MmapFileAdapter) {
+  std::ostringstream oss;
+  PyTorchStreamWriter writer([&](const void* b, size_t n) -> size_t {
+    oss.write(static_cast<const char*>(b), n);
+    return oss ? n : 0;
+  });
+  std::array<char, 127> data;
+  for (int i = 0; i < data.size(); ++i) {
+    data[i] = data.size() - i;
+  }
+  writer.writeRecord("key1", data.data(), data.size());
+  writer.writeEndOfFile();
+
+  std::string the_file = oss.str();
+  std::ofstream foo("output_mmap.zip", std::ios::binary);
+  foo.write(the_file.c_str(), the_file.size());
+  foo.close();
+
+  at::DataPtr alias_ptr;
+  {
+    auto adapter = std::make_unique<MmapFileAdapter>("output_mmap.zip");
+    const MmapFileAdapter* raw_adapter = adapter.get();
+    PyTorchStreamReader reader(std::move(adapter));
+    ASSERT_FALSE(reader.isRecordCompressed("key1"));
+    ASSERT_EQ(reader.getRecordSize("key1"), data.size());
+    alias_ptr = raw_adapter->alias(reader.getRecordOffset("key1"), data.size());
+  }
+  // the alias outlives the reader and its adapter, and is copy-on-write
+  ASSERT_EQ(memcmp(alias_ptr.get(), data.data(), data.size()), 0);
+  static_cast<char*>(alias_ptr.get())[0] = 0;
+  alias_ptr.clear();
+
+  {
+    MmapFileAdapter adapter("output_mmap.zip");
+    ASSERT_EQ(adapter.size(), the_file.size());
+    std::string contents(the_file.size(), '\0');
+    adapter.read(0, &contents[0], contents.size());
+    ASSERT_EQ(contents, the_file);
+  }
+  std::remove("output_mmap.zip");
+}
+
 } // namespace
 } // namespace serialize
 } // namespace caffe2
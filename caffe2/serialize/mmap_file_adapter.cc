@@ -0,0 +1,146 @@
+#include "caffe2/serialize/mmap_file_adapter.h"
+#include <c10/util/Exception.h>
+#include "caffe2/core/common.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace caffe2 {
+namespace serialize {
+
+struct MmapFileAdapter::Mapping {
+  explicit Mapping(const std::string& file_name);
+  ~Mapping();
+
+  char* data = nullptr;
+  size_t size = 0;
+#ifdef _WIN32
+  HANDLE file = INVALID_HANDLE_VALUE;
+  HANDLE mapping = nullptr;
+#endif
+};
+
+#ifdef _WIN32
+MmapFileAdapter::Mapping::Mapping(const std::string& file_name) {
+  file = CreateFileA(
+      file_name.c_str(),
+      GENERIC_READ,
+      FILE_SHARE_READ,
+      nullptr,
+      OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL,
+      nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    AT_ERROR("open file failed, file path: ", file_name);
+  }
+  LARGE_INTEGER file_size;
+  if (!GetFileSizeEx(file, &file_size)) {
+    CloseHandle(file);
+    AT_ERROR("getting the size of file failed, file path: ", file_name);
+  }
+  size = static_cast<size_t>(file_size.QuadPart);
+  if (size == 0) {
+    return;
+  }
+  mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  if (mapping) {
+    data = static_cast<char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+  }
+  if (!data) {
+    if (mapping) {
+      CloseHandle(mapping);
+    }
+    CloseHandle(file);
+    AT_ERROR("mmap of file failed, file path: ", file_name);
+  }
+}
+
+MmapFileAdapter::Mapping::~Mapping() {
+  if (data) {
+    UnmapViewOfFile(data);
+  }
+  if (mapping) {
+    CloseHandle(mapping);
+  }
+  if (file != INVALID_HANDLE_VALUE) {
+    CloseHandle(file);
+  }
+}
+#else
+MmapFileAdapter::Mapping::Mapping(const std::string& file_name) {
+  int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    AT_ERROR("open file failed, file path: ", file_name);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    AT_ERROR("getting the size of file failed, file path: ", file_name);
+  }
+  size = static_cast<size_t>(st.st_size);
+  if (size == 0) {
+    close(fd);
+    return;
+  }
+  // MAP_PRIVATE makes the mapping copy-on-write, so that tensors aliasing it
+  // can be modified in place
+  void* ptr =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  // the mapping keeps the file open
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    AT_ERROR("mmap of file failed, file path: ", file_name);
+  }
+  data = static_cast<char*>(ptr);
+}
+
+MmapFileAdapter::Mapping::~Mapping() {
+  if (data) {
+    munmap(data, size);
+  }
+}
+#endif
+
+MmapFileAdapter::MmapFileAdapter(const std::string& file_name)
+    : mapping_(std::make_shared<Mapping>(file_name)) {}
+
+size_t MmapFileAdapter::size() const {
+  return mapping_->size;
+}
+
+size_t MmapFileAdapter::read(uint64_t pos, void* buf, size_t n, const char* what)
+    const {
+  if (pos > mapping_->size || n > mapping_->size - pos) {
+    AT_ERROR("mmap reader failed: ", what, ".");
+  }
+  std::memcpy(buf, mapping_->data + pos, n);
+  return n;
+}
+
+static void deleteMapping(void* ctx) {
+  delete static_cast<std::shared_ptr<void>*>(ctx);
+}
+
+at::DataPtr MmapFileAdapter::alias(uint64_t pos, size_t n, const char* what)
+    const {
+  if (pos > mapping_->size || n > mapping_->size - pos) {
+    AT_ERROR("mmap reader failed: ", what, ".");
+  }
+  // The context is a reference to the mapping that is dropped along with
+  // the DataPtr
+  auto ctx = new std::shared_ptr<void>(mapping_);
+  return at::DataPtr(mapping_->data + pos, ctx, deleteMapping, at::kCPU);
+}
+
+MmapFileAdapter::~MmapFileAdapter() {}
+
+} // namespace serialize
+} // namespace caffe2
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <c10/core/Allocator.h>
+#include "c10/macros/Macros.h"
+#include "caffe2/serialize/read_adapter_interface.h"
+
+namespace caffe2 {
+namespace serialize {
+
+// Reads a file through a copy-on-write memory mapping of it. Unlike
+// FileAdapter, reads may run concurrently, and alias() hands out parts of
+// the mapping without copying them. The mapping lives until the adapter and
+// every DataPtr from alias() are gone, and writes through those DataPtrs
+// never reach the file.
+class CAFFE2_API MmapFileAdapter final : public ReadAdapterInterface {
+ public:
+  C10_DISABLE_COPY_AND_ASSIGN(MmapFileAdapter);
+  explicit MmapFileAdapter(const std::string& file_name);
+  size_t size() const override;
+  size_t read(uint64_t pos, void* buf, size_t n, const char* what = "")
+      const override;
+  // Returns a CPU DataPtr to the n bytes of the file starting at pos
+  at::DataPtr alias(uint64_t pos, size_t n, const char* what = "") const;
+  ~MmapFileAdapter();
+
+ private:
+  struct Mapping;
+  std::shared_ptr<Mapping> mapping_;
+};
+
+} // namespace serialize
+} // namespace caffe2
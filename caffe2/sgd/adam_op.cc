@@ -48,6 +48,41 @@ and returns (param_o, m1_o, m2_o, grad_o), in which grad_o is an optional output
     .Arg("beta2", "Default 0.999")
     .Arg("epsilon", "Default 1e-5");
 
+REGISTER_CPU_OPERATOR(MultiAdam, MultiAdamOp<float, CPUContext>);
+OPERATOR_SCHEMA(MultiAdam)
+    .NumInputs([](int n) { return n >= 6 && n % 4 == 2; })
+    .NumInputsOutputs([](int in, int out) { return out == (in - 2) / 4 * 3; })
+    .AllowInplace([](int in, int out) {
+      return in / 4 == out / 3 && in % 4 == out % 3;
+    })
+    .DeviceInferenceFunction([](const OperatorDef& def) {
+      auto op_device =
+          def.has_device_option() ? def.device_option() : DeviceOption();
+      vector<DeviceOption> in_dev(def.input_size(), op_device);
+      vector<DeviceOption> out_dev(def.output_size(), op_device);
+      // ITER input lives on CPU
+      in_dev[def.input_size() - 1] = DeviceOption();
+      return std::make_pair(in_dev, out_dev);
+    })
+    .SetDoc(R"DOC(
+
+Computes the Adam update of several parameters at once. Given inputs
+(param_0, m1_0, m2_0, grad_0, ..., param_{n-1}, m1_{n-1}, m2_{n-1},
+grad_{n-1}, lr, iter), it applies Adam to every (param_i, m1_i, m2_i, grad_i,
+lr, iter) and outputs (param_0, m1_0, m2_0, ..., param_{n-1}, m1_{n-1},
+m2_{n-1}). All the parameters share lr, iter and the beta1, beta2 and epsilon
+arguments. The optional effective gradient output of Adam is not supported.
+
+On CUDA, the parameters are updated by a single kernel launch (per group of
+parameters that fits in the kernel arguments) rather than one per parameter,
+which matters for nets with many small parameters. The
+FuseMultiTensorOptimizers optimization pass merges Adam ops into this op.
+
+)DOC")
+    .Arg("beta1", "Default 0.9")
+    .Arg("beta2", "Default 0.999")
+    .Arg("epsilon", "Default 1e-5");
+
 REGISTER_CPU_OPERATOR(SparseAdam, SparseAdamOp<float, CPUContext>);
 OPERATOR_SCHEMA(SparseAdam)
     .NumInputs(7)
@@ -113,6 +148,7 @@ OPERATOR_SCHEMA(RowWiseSparseAdam)
     .Arg("epsilon", "Default 1e-5");
 
 SHOULD_NOT_DO_GRADIENT(Adam);
+SHOULD_NOT_DO_GRADIENT(MultiAdam);
 SHOULD_NOT_DO_GRADIENT(SparseAdam);
 SHOULD_NOT_DO_GRADIENT(RowWiseSparseAdam);
 } // namespace caffe2
@@ -256,6 +256,125 @@ class AdamOp final : public Operator<Context> {
   OUTPUT_TAGS(OUTPUT_PARAM, OUTPUT_MOMENT_1, OUTPUT_MOMENT_2, OUTPUT_GRAD);
 };
 
+// Applies adam_compute to num_tensors (param, grad, moment_1, moment_2)
+// tuples, the i-th of which has N[i] elements. The CUDA specialization
+// updates all of them with as few kernel launches as it can.
+template <typename Context>
+void multi_adam_compute(
+    int num_tensors,
+    const int* N,
+    const float* const* w,
+    const float* const* g,
+    const float* const* m,
+    const float* const* v,
+    float* const* nw,
+    float* const* nm,
+    float* const* nv,
+    float beta1,
+    float beta2,
+    float eps_hat,
+    float correction,
+    const float* lr,
+    Context* context) {
+  for (int i = 0; i < num_tensors; ++i) {
+    adam_compute<Context>(
+        N[i],
+        w[i],
+        g[i],
+        m[i],
+        v[i],
+        nw[i],
+        nm[i],
+        nv[i],
+        beta1,
+        beta2,
+        eps_hat,
+        correction,
+        lr,
+        context);
+  }
+}
+
+template <typename T, class Context>
+class MultiAdamOp final : public Operator<Context> {
+ public:
+  USE_OPERATOR_CONTEXT_FUNCTIONS;
+  MultiAdamOp(const OperatorDef& operator_def, Workspace* ws)
+      : Operator<Context>(operator_def, ws),
+        beta1_(this->template GetSingleArgument<float>("beta1", 0.9f)),
+        beta2_(this->template GetSingleArgument<float>("beta2", 0.999f)),
+        epsilon_(this->template GetSingleArgument<float>("epsilon", 1e-5f)) {}
+  bool RunOnDevice() override {
+    CAFFE_ENFORCE_EQ(InputSize() % 4, 2);
+    const int num_tensors = InputSize() / 4;
+    const int lr_index = 4 * num_tensors;
+    const int iter_index = lr_index + 1;
+    // Iter live on the CPU
+    CAFFE_ENFORCE(OperatorBase::InputIsTensorType(iter_index, CPU));
+    const auto& lr = Input(lr_index);
+    CAFFE_ENFORCE_EQ(lr.numel(), 1);
+
+    std::vector<int> sizes(num_tensors);
+    std::vector<const T*> params(num_tensors);
+    std::vector<const T*> moments_1(num_tensors);
+    std::vector<const T*> moments_2(num_tensors);
+    std::vector<const T*> grads(num_tensors);
+    std::vector<T*> output_params(num_tensors);
+    std::vector<T*> output_moments_1(num_tensors);
+    std::vector<T*> output_moments_2(num_tensors);
+    for (int i = 0; i < num_tensors; ++i) {
+      const auto& param = Input(4 * i);
+      const auto& moment_1 = Input(4 * i + 1);
+      const auto& moment_2 = Input(4 * i + 2);
+      const auto& grad = Input(4 * i + 3);
+      CAFFE_ENFORCE_EQ(grad.numel(), param.numel());
+      CAFFE_ENFORCE_EQ(grad.numel(), moment_1.numel());
+      CAFFE_ENFORCE_EQ(grad.numel(), moment_2.numel());
+      Output(3 * i)->ResizeLike(param);
+      Output(3 * i + 1)->ResizeLike(moment_1);
+      Output(3 * i + 2)->ResizeLike(moment_2);
+
+      sizes[i] = grad.numel();
+      params[i] = param.template data<T>();
+      moments_1[i] = moment_1.template data<T>();
+      moments_2[i] = moment_2.template data<T>();
+      grads[i] = grad.template data<T>();
+      output_params[i] = Output(3 * i)->template mutable_data<T>();
+      output_moments_1[i] = Output(3 * i + 1)->template mutable_data<T>();
+      output_moments_2[i] = Output(3 * i + 2)->template mutable_data<T>();
+    }
+
+    const auto iter = OperatorBase::Input<Tensor>(iter_index, CPU)
+                          .template data<int64_t>()[0];
+
+    const auto t = iter + 1;
+    const auto correction =
+        std::sqrt(T(1.) - std::pow(beta2_, t)) / (T(1.) - std::pow(beta1_, t));
+    multi_adam_compute<Context>(
+        num_tensors,
+        sizes.data(),
+        params.data(),
+        grads.data(),
+        moments_1.data(),
+        moments_2.data(),
+        output_params.data(),
+        output_moments_1.data(),
+        output_moments_2.data(),
+        beta1_,
+        beta2_,
+        epsilon_,
+        correction,
+        lr.template data<T>(),
+        &context_);
+    return true;
+  }
+
+ protected:
+  T beta1_{0.9};
+  T beta2_{0.999};
+  T epsilon_{1e-8};
+};
+
 template <typename T, class Context>
 class SparseAdamOp final : public Operator<Context> {
  public:
@@ -144,6 +144,88 @@ void adam_compute_output_grad<CUDAContext>(
       N, w, g, m, v, nw, nm, nv, ng, beta1, beta2, eps_hat, correction, lr);
 }
 
+// The number of tensors one MultiAdamCompute launch updates, bounded by the
+// 4KB of kernel arguments.
+constexpr int kMultiAdamMaxTensors = 32;
+
+struct MultiAdamArgs {
+  int N[kMultiAdamMaxTensors];
+  const float* w[kMultiAdamMaxTensors];
+  const float* g[kMultiAdamMaxTensors];
+  const float* m[kMultiAdamMaxTensors];
+  const float* v[kMultiAdamMaxTensors];
+  float* nw[kMultiAdamMaxTensors];
+  float* nm[kMultiAdamMaxTensors];
+  float* nv[kMultiAdamMaxTensors];
+};
+
+// blockIdx.y picks the tensor, and the blocks along x loop over its elements.
+__global__ void MultiAdamCompute(
+    const MultiAdamArgs args,
+    float beta1,
+    float beta2,
+    float eps_hat,
+    float correction,
+    const float* lr) {
+  const int t = blockIdx.y;
+  const float* w = args.w[t];
+  const float* g = args.g[t];
+  const float* m = args.m[t];
+  const float* v = args.v[t];
+  float* nw = args.nw[t];
+  float* nm = args.nm[t];
+  float* nv = args.nv[t];
+  CUDA_1D_KERNEL_LOOP(i, args.N[t]) {
+    float gi = g[i];
+    float mi = nm[i] = m[i] * beta1 + gi * (1 - beta1);
+    float vi = nv[i] = v[i] * beta2 + gi * gi * (1 - beta2);
+    float ng = lr[0] * correction * mi / (sqrtf(vi) + eps_hat);
+    nw[i] = w[i] + ng;
+  }
+}
+
+template <>
+void multi_adam_compute<CUDAContext>(
+    int num_tensors,
+    const int* N,
+    const float* const* w,
+    const float* const* g,
+    const float* const* m,
+    const float* const* v,
+    float* const* nw,
+    float* const* nm,
+    float* const* nv,
+    float beta1,
+    float beta2,
+    float eps_hat,
+    float correction,
+    const float* lr,
+    CUDAContext* context) {
+  for (int begin = 0; begin < num_tensors; begin += kMultiAdamMaxTensors) {
+    const int count = std::min(num_tensors - begin, kMultiAdamMaxTensors);
+    MultiAdamArgs args;
+    int max_N = 0;
+    for (int i = 0; i < count; ++i) {
+      args.N[i] = N[begin + i];
+      args.w[i] = w[begin + i];
+      args.g[i] = g[begin + i];
+      args.m[i] = m[begin + i];
+      args.v[i] = v[begin + i];
+      args.nw[i] = nw[begin + i];
+      args.nm[i] = nm[begin + i];
+      args.nv[i] = nv[begin + i];
+      max_N = std::max(max_N, N[begin + i]);
+    }
+    const dim3 blocks(CAFFE_GET_BLOCKS(max_N), count);
+    MultiAdamCompute<<<
+        blocks,
+        CAFFE_CUDA_NUM_THREADS,
+        0,
+        context->cuda_stream()>>>(
+        args, beta1, beta2, eps_hat, correction, lr);
+  }
+}
+
 template <typename SIndex>
 __global__ void SparseAdamKernel(
     const size_t N,
@@ -263,6 +345,7 @@ bool SparseAdamOp<float, CUDAContext>::DoRunWithType() {
 }
 
 REGISTER_CUDA_OPERATOR(Adam, AdamOp<float, CUDAContext>);
+REGISTER_CUDA_OPERATOR(MultiAdam, MultiAdamOp<float, CUDAContext>);
 REGISTER_CUDA_OPERATOR(SparseAdam, SparseAdamOp<float, CUDAContext>);
 
 } // namespace caffe2
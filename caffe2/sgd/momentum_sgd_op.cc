@@ -72,6 +72,37 @@ but does not perform the parameter update.
 )DOC");
 SHOULD_NOT_DO_GRADIENT(MomentumSGDUpdate);
 
+REGISTER_CPU_OPERATOR(
+    MultiMomentumSGDUpdate,
+    MultiMomentumSGDUpdateOp<float, CPUContext>);
+OPERATOR_SCHEMA(MultiMomentumSGDUpdate)
+    .NumInputs([](int n) { return n >= 4 && n % 3 == 1; })
+    .NumInputsOutputs([](int in, int out) { return out == in - 1; })
+    .AllowInplace([](int in, int out) { return in == out; })
+    .EnforceInplace([](int in, int out) { return in == out && in % 3 == 2; })
+    .TensorInferenceFunction(
+        [](const OperatorDef& /* unused */, const vector<TensorShape>& in) {
+          return vector<TensorShape>(in.begin(), in.end() - 1);
+        })
+    .SetDoc(R"DOC(
+
+Performs the MomentumSGDUpdate of several parameters at once. Given inputs
+(grad_0, m_0, param_0, ..., grad_{n-1}, m_{n-1}, param_{n-1}, lr), it applies
+MomentumSGDUpdate to every (grad_i, m_i, lr, param_i) and outputs
+(grad_0, m_0, param_0, ..., grad_{n-1}, m_{n-1}, param_{n-1}). All the
+parameters share lr and the momentum and nesterov arguments.
+
+On CUDA, the parameters are updated by a single kernel launch (per group of
+parameters that fits in the kernel arguments) rather than one per parameter,
+which matters for nets with many small parameters. The
+FuseMultiTensorOptimizers optimization pass merges MomentumSGDUpdate ops into
+this op.
+
+)DOC")
+    .Arg("momentum", "Momentum hyperparameter.")
+    .Arg("nesterov", "(boolean) Whether to use Nesterov Accelerated Gradient.");
+SHOULD_NOT_DO_GRADIENT(MultiMomentumSGDUpdate);
+
 REGISTER_CPU_OPERATOR(
     SparseMomentumSGDUpdate,
     SparseMomentumSGDUpdateOp<float, CPUContext>);
@@ -115,6 +115,89 @@ class MomentumSGDUpdateOp final : public Operator<Context> {
   OUTPUT_TAGS(OUTPUT_GRAD, OUTPUT_MOMENTUM, OUTPUT_PARAM);
 };
 
+// Applies momentum_sgd_update to num_tensors (grad, momentum, param)
+// triples, the i-th of which has N[i] elements. The CUDA specialization
+// updates all of them with as few kernel launches as it can.
+template <typename Context>
+void multi_momentum_sgd_update(
+    const int num_tensors,
+    const int* N,
+    const float* const* g,
+    const float* const* m,
+    float* const* ng,
+    float* const* nm,
+    const float* lr,
+    const float momentum,
+    const bool nesterov,
+    float* const* param,
+    Context* context) {
+  for (int i = 0; i < num_tensors; ++i) {
+    momentum_sgd_update<Context>(
+        N[i], g[i], m[i], ng[i], nm[i], lr, momentum, nesterov, param[i],
+        context);
+  }
+}
+
+template <typename T, class Context>
+class MultiMomentumSGDUpdateOp final : public Operator<Context> {
+ public:
+  USE_OPERATOR_CONTEXT_FUNCTIONS;
+  MultiMomentumSGDUpdateOp(const OperatorDef& operator_def, Workspace* ws)
+      : Operator<Context>(operator_def, ws),
+        momentum_(this->template GetSingleArgument<T>("momentum", 0.0)),
+        nesterov_(this->template GetSingleArgument<int>("nesterov", 0)) {}
+
+  bool RunOnDevice() override {
+    auto device_type = Context::GetDeviceType();
+    CAFFE_ENFORCE_EQ(InputSize() % 3, 1);
+    const int num_tensors = InputSize() / 3;
+    const auto& lr = Input(InputSize() - 1);
+    CAFFE_ENFORCE_EQ(lr.numel(), 1);
+
+    std::vector<int> sizes(num_tensors);
+    std::vector<const T*> grads(num_tensors);
+    std::vector<const T*> moments(num_tensors);
+    std::vector<T*> output_grads(num_tensors);
+    std::vector<T*> output_moments(num_tensors);
+    std::vector<T*> output_params(num_tensors);
+    for (int i = 0; i < num_tensors; ++i) {
+      CAFFE_ENFORCE(OperatorBase::InputIsTensorType(3 * i, device_type));
+      CAFFE_ENFORCE(OperatorBase::InputIsTensorType(3 * i + 1, device_type));
+      const auto& grad = Input(3 * i);
+      const auto& moment = Input(3 * i + 1);
+      CAFFE_ENFORCE_EQ(grad.numel(), moment.numel());
+      CAFFE_ENFORCE_EQ(grad.numel(), Input(3 * i + 2).numel());
+      Output(3 * i)->ResizeLike(grad);
+      Output(3 * i + 1)->ResizeLike(moment);
+
+      sizes[i] = grad.numel();
+      grads[i] = grad.template data<T>();
+      moments[i] = moment.template data<T>();
+      output_grads[i] = Output(3 * i)->template mutable_data<T>();
+      output_moments[i] = Output(3 * i + 1)->template mutable_data<T>();
+      output_params[i] = Output(3 * i + 2)->template mutable_data<T>();
+    }
+
+    multi_momentum_sgd_update<Context>(
+        num_tensors,
+        sizes.data(),
+        grads.data(),
+        moments.data(),
+        output_grads.data(),
+        output_moments.data(),
+        lr.template data<T>(),
+        momentum_,
+        nesterov_,
+        output_params.data(),
+        &context_);
+    return true;
+  }
+
+ protected:
+  T momentum_{0.9};
+  bool nesterov_;
+};
+
 template <typename T, class Context>
 class SparseMomentumSGDUpdateOp final : public Operator<Context> {
  public:
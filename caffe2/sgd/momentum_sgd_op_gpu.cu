@@ -92,6 +92,91 @@ void momentum_sgd_update<CUDAContext>(
 }
 
 
+// The number of tensors one MultiMomentumSGDKernel launch updates, bounded by
+// the 4KB of kernel arguments.
+constexpr int kMultiMomentumSGDMaxTensors = 32;
+
+struct MultiMomentumSGDArgs {
+  int N[kMultiMomentumSGDMaxTensors];
+  const float* g[kMultiMomentumSGDMaxTensors];
+  const float* m[kMultiMomentumSGDMaxTensors];
+  float* ng[kMultiMomentumSGDMaxTensors];
+  float* nm[kMultiMomentumSGDMaxTensors];
+  float* param[kMultiMomentumSGDMaxTensors];
+};
+
+// blockIdx.y picks the tensor, and the blocks along x loop over its elements.
+template <bool nesterov>
+__global__ void MultiMomentumSGDKernel(
+    const MultiMomentumSGDArgs args,
+    const float* lr,
+    const float momentum) {
+  const int t = blockIdx.y;
+  const float LR = lr[0];
+  const float* g = args.g[t];
+  const float* m = args.m[t];
+  float* ng = args.ng[t];
+  float* nm = args.nm[t];
+  float* param = args.param[t];
+  CUDA_1D_KERNEL_LOOP(i, args.N[t]) {
+    if (nesterov) {
+      const float mi = m[i];
+      const float mi_new = momentum * mi + LR * g[i];
+      nm[i] = mi_new;
+      ng[i] = fmaf(momentum, mi_new - mi, mi_new);
+    } else {
+      const float adjusted_gradient = LR * g[i] + momentum * m[i];
+      nm[i] = adjusted_gradient;
+      ng[i] = adjusted_gradient;
+    }
+    if (param != nullptr) {
+      param[i] -= ng[i];
+    }
+  }
+}
+
+template <>
+void multi_momentum_sgd_update<CUDAContext>(
+    const int num_tensors,
+    const int* N,
+    const float* const* g,
+    const float* const* m,
+    float* const* ng,
+    float* const* nm,
+    const float* lr,
+    const float momentum,
+    const bool nesterov,
+    float* const* param,
+    CUDAContext* context) {
+  for (int begin = 0; begin < num_tensors;
+       begin += kMultiMomentumSGDMaxTensors) {
+    const int count =
+        std::min(num_tensors - begin, kMultiMomentumSGDMaxTensors);
+    MultiMomentumSGDArgs args;
+    int max_N = 0;
+    for (int i = 0; i < count; ++i) {
+      args.N[i] = N[begin + i];
+      args.g[i] = g[begin + i];
+      args.m[i] = m[begin + i];
+      args.ng[i] = ng[begin + i];
+      args.nm[i] = nm[begin + i];
+      args.param[i] = param[begin + i];
+      max_N = std::max(max_N, N[begin + i]);
+    }
+    const dim3 blocks(
+        std::min(CaffeGetBlocksSGD(max_N), CAFFE_MAXIMUM_NUM_BLOCKS), count);
+    if (nesterov) {
+      MultiMomentumSGDKernel<true>
+          <<<blocks, CAFFE_CUDA_NUM_THREADS, 0, context->cuda_stream()>>>(
+              args, lr, momentum);
+    } else {
+      MultiMomentumSGDKernel<false>
+          <<<blocks, CAFFE_CUDA_NUM_THREADS, 0, context->cuda_stream()>>>(
+              args, lr, momentum);
+    }
+  }
+}
+
 template <typename SIndex>
 __global__ void SparseMomentumSGDKernel(
     const size_t N,
@@ -155,6 +240,7 @@ bool SparseMomentumSGDUpdateOp<float, CUDAContext>::DoRunWithType() {
 
 REGISTER_CUDA_OPERATOR(MomentumSGD, MomentumSGDOp<float, CUDAContext>);
 REGISTER_CUDA_OPERATOR(MomentumSGDUpdate, MomentumSGDUpdateOp<float, CUDAContext>);
+REGISTER_CUDA_OPERATOR(MultiMomentumSGDUpdate, MultiMomentumSGDUpdateOp<float, CUDAContext>);
 REGISTER_CUDA_OPERATOR(SparseMomentumSGDUpdate, SparseMomentumSGDUpdateOp<float, CUDAContext>);
 
 }
@@ -899,6 +899,7 @@ if(USE_CUDA)
   set(CAFFE2_USE_CUDA ${USE_CUDA})
   set(CAFFE2_USE_CUDNN ${USE_CUDNN})
   set(CAFFE2_USE_NVRTC ${USE_NVRTC})
+  set(CAFFE2_USE_NVJPEG ${USE_NVJPEG})
   set(CAFFE2_USE_TENSORRT ${USE_TENSORRT})
   include(${CMAKE_CURRENT_LIST_DIR}/public/cuda.cmake)
   if(CAFFE2_USE_CUDA)
@@ -922,6 +923,11 @@ if(USE_CUDA)
     else()
       caffe2_update_option(USE_TENSORRT OFF)
     endif()
+    if(CAFFE2_USE_NVJPEG)
+      list(APPEND Caffe2_PUBLIC_CUDA_DEPENDENCY_LIBS caffe2::nvjpeg)
+    else()
+      caffe2_update_option(USE_NVJPEG OFF)
+    endif()
   else()
     message(WARNING
       "Not compiling with CUDA. Suppress this warning with "
@@ -929,10 +935,12 @@ if(USE_CUDA)
     caffe2_update_option(USE_CUDA OFF)
     caffe2_update_option(USE_CUDNN OFF)
     caffe2_update_option(USE_NVRTC OFF)
+    caffe2_update_option(USE_NVJPEG OFF)
     caffe2_update_option(USE_TENSORRT OFF)
     set(CAFFE2_USE_CUDA OFF)
     set(CAFFE2_USE_CUDNN OFF)
     set(CAFFE2_USE_NVRTC OFF)
+    set(CAFFE2_USE_NVJPEG OFF)
     set(CAFFE2_USE_TENSORRT OFF)
   endif()
 endif()
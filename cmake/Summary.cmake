@@ -83,6 +83,10 @@ function (caffe2_print_configuration_summary)
       message(STATUS "      TensorRT runtime library: ${TENSORRT_LIBRARY}")
       message(STATUS "      TensorRT include path   : ${TENSORRT_INCLUDE_DIR}")
     endif()
+    message(STATUS "    USE_NVJPEG          : ${USE_NVJPEG}")
+    if(${USE_NVJPEG})
+      message(STATUS "      nvJPEG library    : ${NVJPEG_LIBRARY}")
+    endif()
   endif()
   message(STATUS "  USE_ROCM              : ${USE_ROCM}")
   message(STATUS "  USE_EIGEN_FOR_BLAS    : ${CAFFE2_USE_EIGEN_FOR_BLAS}")
@@ -142,6 +142,23 @@ if(CAFFE2_USE_TENSORRT)
   endif()
 endif()
 
+# Optionally, find nvJPEG, which ships with CUDA 10 and later
+if(CAFFE2_USE_NVJPEG)
+  find_path(NVJPEG_INCLUDE_DIR nvjpeg.h
+    HINTS ${CUDA_TOOLKIT_ROOT_DIR}
+    PATH_SUFFIXES include)
+  find_library(NVJPEG_LIBRARY nvjpeg
+    HINTS ${CUDA_TOOLKIT_ROOT_DIR}
+    PATH_SUFFIXES lib lib64 lib/x64)
+  find_package_handle_standard_args(
+    NVJPEG DEFAULT_MSG NVJPEG_INCLUDE_DIR NVJPEG_LIBRARY)
+  if(NOT NVJPEG_FOUND)
+    message(WARNING
+      "Caffe2: Cannot find nvJPEG library. Turning the option off.")
+    set(CAFFE2_USE_NVJPEG OFF)
+  endif()
+endif()
+
 # ---[ Extract versions
 if(CAFFE2_USE_CUDNN)
   # Get cuDNN version
@@ -284,6 +301,17 @@ if(CAFFE2_USE_TENSORRT)
       ${TENSORRT_INCLUDE_DIR})
 endif()
 
+# nvJPEG
+if(CAFFE2_USE_NVJPEG)
+  add_library(caffe2::nvjpeg UNKNOWN IMPORTED)
+  set_property(
+      TARGET caffe2::nvjpeg PROPERTY IMPORTED_LOCATION
+      ${NVJPEG_LIBRARY})
+  set_property(
+      TARGET caffe2::nvjpeg PROPERTY INTERFACE_INCLUDE_DIRECTORIES
+      ${NVJPEG_INCLUDE_DIR})
+endif()
+
 # cublas. CUDA_CUBLAS_LIBRARIES is actually a list, so we will make an
 # interface library similar to cudart.
 add_library(caffe2::cublas INTERFACE IMPORTED)
@@ -291,7 +319,7 @@ if(CAFFE2_STATIC_LINK_CUDA AND NOT WIN32)
     set_property(
         TARGET caffe2::cublas PROPERTY INTERFACE_LINK_LIBRARIES
         "${CUDA_TOOLKIT_ROOT_DIR}/lib64/libcublas_static.a")
-    if (CUDA_VERSION VERSION_EQUAL 10.1)
+    if (NOT CUDA_VERSION VERSION_LESS 10.1)
       set_property(
         TARGET caffe2::cublas APPEND PROPERTY INTERFACE_LINK_LIBRARIES
         "${CUDA_TOOLKIT_ROOT_DIR}/lib64/libcublasLt_static.a")
@@ -300,6 +328,17 @@ else()
     set_property(
         TARGET caffe2::cublas PROPERTY INTERFACE_LINK_LIBRARIES
         ${CUDA_CUBLAS_LIBRARIES})
+    # cublasLt, used by at::cuda::blas::gemm_and_bias, ships with CUDA 10.1+
+    if (NOT CUDA_VERSION VERSION_LESS 10.1)
+      find_library(CUDA_CUBLASLT_LIB cublasLt
+          PATHS ${CUDA_TOOLKIT_ROOT_DIR}
+          PATH_SUFFIXES lib lib64 lib/x64)
+      if (CUDA_CUBLASLT_LIB)
+        set_property(
+            TARGET caffe2::cublas APPEND PROPERTY INTERFACE_LINK_LIBRARIES
+            ${CUDA_CUBLASLT_LIB})
+      endif()
+    endif()
 endif()
 set_property(
     TARGET caffe2::cublas PROPERTY INTERFACE_INCLUDE_DIRECTORIES
@@ -2,6 +2,8 @@
 
 #include <torch/torch.h>
 
+#include <torch/csrc/autograd/saved_tensor_hooks.h>
+
 #include <test/cpp/api/support.h>
 
 using namespace torch::autograd;
@@ -123,6 +125,42 @@ TEST(AutogradAPITests, GradUnreachableTest) {
   ASSERT_FALSE(grad_res[1].defined());
 }
 
+TEST(AutogradAPITests, InferenceModeTest) {
+  Variable x = torch::ones({2, 2}, torch::requires_grad());
+  ASSERT_FALSE(x.unsafeGetTensorImpl()->is_inference());
+  {
+    torch::InferenceModeGuard guard;
+    Variable y = x * 2 + 1;
+    ASSERT_FALSE(y.requires_grad());
+    ASSERT_FALSE(y.grad_fn());
+    ASSERT_TRUE(y.unsafeGetTensorImpl()->is_inference());
+    ASSERT_VARIABLE_EQ(y, torch::full({2, 2}, 3));
+    ASSERT_THROWS_WITH(y.requires_grad_(), "inference mode");
+  }
+  ASSERT_TRUE(GradMode::is_enabled());
+  Variable z = x * 2;
+  ASSERT_TRUE(z.requires_grad());
+  ASSERT_FALSE(z.unsafeGetTensorImpl()->is_inference());
+}
+
+TEST(AutogradAPITests, InferenceModeInplaceTest) {
+  Variable x = torch::ones({2, 2}, torch::requires_grad());
+  // y is saved for the backward of exp(), so writing to it would corrupt x.grad
+  Variable y = x.exp();
+  {
+    torch::InferenceModeGuard guard;
+    ASSERT_THROWS_WITH(y.add_(1), "inference mode");
+    ASSERT_THROWS_WITH(y.view({4}).add_(1), "inference mode");
+    ASSERT_THROWS_WITH(torch::add_out(y, x, x), "inference mode");
+    // tensors created under the guard can be written to
+    Variable z = y * 2;
+    z.add_(1);
+    ASSERT_VARIABLE_EQ(z, torch::full({2, 2}, 2 * std::exp(1.) + 1));
+  }
+  y.sum().backward();
+  ASSERT_VARIABLE_EQ(x.grad(), torch::full({2, 2}, std::exp(1.)));
+}
+
 TEST(CustomAutogradTest, CustomFunction) {
   struct MyFunction : public Function<MyFunction> {
     static Variable forward(AutogradContext *ctx, Variable var1, int mul, Variable var2) {
@@ -531,6 +569,117 @@ TEST(CustomAutogradTest, ReentrantPriority) {
   ASSERT_EQ(order.back(), 0);
 }
 
+TEST(CustomAutogradTest, NodePriority) {
+  static std::vector<int> order;
+
+  struct MyFunction : public Function<MyFunction> {
+    static Variable forward(AutogradContext* ctx, Variable x, int id) {
+      ctx->saved_data["id"] = id;
+      return x.clone();
+    }
+
+    static variable_list backward(AutogradContext* ctx, variable_list grad) {
+      order.push_back(ctx->saved_data["id"].toInt());
+      return {grad[0], Variable()};
+    }
+  };
+
+  auto x = torch::randn({2}, torch::requires_grad());
+  auto a = MyFunction::apply(x, 0);
+  auto b = MyFunction::apply(x, 1);
+
+  // by default, nodes created later run first
+  (a * b).sum().backward();
+  ASSERT_EQ(order, std::vector<int>({1, 0}));
+
+  order.clear();
+  a = MyFunction::apply(x, 0);
+  b = MyFunction::apply(x, 1);
+  a.grad_fn()->set_priority(1);
+  (a * b).sum().backward();
+  ASSERT_EQ(order, std::vector<int>({0, 1}));
+}
+
+TEST(CustomAutogradTest, SavedTensorHooks) {
+  struct CountingPack : public SavedTensorPack {
+    CountingPack(at::Tensor tensor, int& unpacked, int& prefetched)
+        : tensor_(std::move(tensor)), unpacked_(unpacked), prefetched_(prefetched) {}
+    at::Tensor unpack() override {
+      unpacked_++;
+      return tensor_.clone();
+    }
+    void prefetch() override {
+      prefetched_++;
+    }
+    at::Tensor tensor_;
+    int& unpacked_;
+    int& prefetched_;
+  };
+
+  struct CountingHooks : public SavedTensorHooks {
+    std::shared_ptr<SavedTensorPack> pack(const at::Tensor& tensor) override {
+      EXPECT_FALSE(GradMode::is_enabled());
+      packed++;
+      return std::make_shared<CountingPack>(tensor, unpacked, prefetched);
+    }
+    int packed = 0;
+    int unpacked = 0;
+    int prefetched = 0;
+  };
+
+  auto x = torch::randn({4, 4}, torch::requires_grad());
+  auto hooks = std::make_shared<CountingHooks>();
+  Variable y;
+  {
+    SavedTensorHooksGuard guard(hooks);
+    // exp saves its result, mul saves both inputs
+    y = (x.exp() * x).sum();
+  }
+  ASSERT_EQ(hooks->packed, 3);
+  y.backward();
+  ASSERT_EQ(hooks->unpacked, 3);
+  // the saved variables of exp are prefetched while mul's backward runs
+  ASSERT_GE(hooks->prefetched, 1);
+  ASSERT_VARIABLE_EQ(x.grad(), x.exp() * (x + 1));
+
+  // lossy compression
+  auto z = torch::randn({4, 4}, torch::requires_grad());
+  {
+    SavedTensorHooksGuard guard(
+        std::make_shared<CastSavedTensorHooks>(at::kHalf));
+    (z * z).sum().backward();
+  }
+  ASSERT_TRUE(torch::allclose(z.grad(), 2 * z, 1e-3, 1e-3));
+}
+
+TEST(CustomAutogradTest, Checkpoint) {
+  auto fn = [](const variable_list& inputs) -> variable_list {
+    auto h = torch::dropout(inputs[0].mm(inputs[1]).tanh(), 0.5, true);
+    return {h.mm(inputs[1]).sum()};
+  };
+
+  auto x = torch::randn({8, 8}, torch::requires_grad());
+  auto w = torch::randn({8, 8}, torch::requires_grad());
+
+  torch::manual_seed(0);
+  fn({x, w})[0].backward();
+  auto x_grad = x.grad().clone();
+  auto w_grad = w.grad().clone();
+  x.grad().zero_();
+  w.grad().zero_();
+
+  torch::manual_seed(0);
+  auto out = checkpoint(fn, {x, w});
+  ASSERT_EQ(out[0].grad_fn()->name(), "CheckpointBackward");
+  // something else consumes random numbers before backward
+  torch::rand({10});
+  out[0].backward();
+  ASSERT_VARIABLE_EQ(x.grad(), x_grad);
+  ASSERT_VARIABLE_EQ(w.grad(), w_grad);
+
+  ASSERT_THROWS_WITH(out[0].backward(), "Trying to backward through the graph a second time");
+}
+
 TEST(CustomAutogradTest, Hooks) {
   Variable x = torch::ones({5,5}, torch::requires_grad());
   Variable y = torch::ones({5,5})*4;
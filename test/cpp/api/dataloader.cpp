@@ -5,10 +5,12 @@
 #include <test/cpp/api/support.h>
 
 #include <c10/util/ArrayRef.h>
+#include <caffe2/serialize/inline_container.h>
 #include <c10/util/tempfile.h>
 
 #include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <future>
 #include <iostream>
 #include <iterator>
@@ -21,6 +23,10 @@
 #include <unordered_set>
 #include <vector>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 using namespace torch::data; // NOLINT
 
 const std::chrono::milliseconds kMillisecond(1);
@@ -450,6 +456,55 @@ TEST(DataTest, TensorDatasetConstructsFromInitializerListOfTensors) {
       torch::tensor({0, 0, 1, 0, 0}, torch::kFloat32).allclose(dataset.get(2)));
 }
 
+TEST(DataTest, MappedTensorDatasetMapsRawFile) {
+  auto tempfile = c10::make_tempfile();
+  // The first float is a header before the examples.
+  const auto values = torch::arange(25, torch::kFloat32);
+  {
+    std::ofstream stream(tempfile.name, std::ios::binary);
+    stream.write(
+        static_cast<const char*>(values.data_ptr()),
+        values.numel() * values.element_size());
+  }
+
+  datasets::MappedTensorDataset dataset(
+      tempfile.name,
+      torch::kFloat32,
+      {2, 3},
+      datasets::MappedTensorDataset::Access::kRandom,
+      /*offset=*/sizeof(float));
+  ASSERT_EQ(dataset.size().value(), 4);
+  ASSERT_TRUE(dataset.get(1).data.equal(
+      torch::arange(7, 13, torch::kFloat32).view({2, 3})));
+  auto batch = dataset.get_batch({3, 0, 1});
+  ASSERT_EQ(batch.size(), 3);
+  ASSERT_TRUE(batch[0].data.equal(
+      torch::arange(19, 25, torch::kFloat32).view({2, 3})));
+  ASSERT_TRUE(batch[2].data.equal(dataset.get(1).data));
+}
+
+TEST(DataTest, MappedTensorDatasetMapsArchiveRecord) {
+  auto tempfile = c10::make_tempfile();
+  const auto values = torch::arange(12, torch::kLong);
+  {
+    caffe2::serialize::PyTorchStreamWriter writer(tempfile.name);
+    writer.writeRecord(
+        "examples",
+        values.data_ptr(),
+        values.numel() * values.element_size());
+    writer.writeEndOfFile();
+  }
+
+  auto dataset = datasets::MappedTensorDataset::from_archive(
+      tempfile.name, "examples", torch::kLong, {4});
+  ASSERT_EQ(dataset.size().value(), 3);
+  ASSERT_TRUE(dataset.tensor().equal(values.view({3, 4})));
+  ASSERT_THROWS_WITH(
+      datasets::MappedTensorDataset::from_archive(
+          tempfile.name, "examples", torch::kLong, {5}),
+      "not a whole number of examples");
+}
+
 TEST(DataTest, StackTransformWorksForExample) {
   struct D : public datasets::Dataset<D> {
     Example<> get(size_t index) override {
@@ -1162,6 +1217,91 @@ TEST(DataLoaderTest, CanUseIteratorAlgorithms) {
   ASSERT_EQ(values, expected);
 }
 
+void check_device_batches(torch::Device device) {
+  auto data_loader = torch::data::make_data_loader(
+      datasets::TensorDataset(torch::arange(20).view({10, 2}))
+          .map(transforms::Stack<TensorExample>()),
+      DataLoaderOptions(3).workers(2).device(device).device_prefetch(2));
+
+  for (size_t epoch = 0; epoch < 2; ++epoch) {
+    int64_t next_value = 0;
+    for (auto& batch : *data_loader) {
+      ASSERT_EQ(batch.data.device(), device);
+      const auto expected = torch::arange(
+          next_value, next_value + batch.data.numel(), torch::kLong);
+      ASSERT_TRUE(batch.data.cpu().view({-1}).equal(expected));
+      next_value += batch.data.numel();
+      // Destroys the DataLoader while batches are still being copied.
+      if (epoch == 1) {
+        break;
+      }
+    }
+    ASSERT_EQ(next_value, epoch == 0 ? 20 : 6);
+  }
+}
+
+TEST(DataLoaderTest, CopiesBatchesToDevice) {
+  check_device_batches(torch::kCPU);
+}
+
+TEST(DataLoaderTest, CopiesBatchesToDevice_CUDA) {
+  check_device_batches(torch::Device(torch::kCUDA, 0));
+}
+
+#ifndef _WIN32
+struct ProcessIdDataset : datasets::Dataset<ProcessIdDataset> {
+  Example<> get(size_t index) override {
+    return {torch::full({2}, static_cast<int64_t>(index), torch::kLong),
+            torch::full({}, static_cast<int64_t>(getpid()), torch::kLong)};
+  }
+  torch::optional<size_t> size() const override {
+    return 10;
+  }
+};
+
+TEST(DataLoaderTest, WorkerProcessesSendBatches) {
+  auto data_loader = torch::data::make_data_loader(
+      ProcessIdDataset(),
+      samplers::SequentialSampler(10),
+      DataLoaderOptions(3).workers(2).worker_processes(true));
+
+  for (size_t epoch = 0; epoch < 2; ++epoch) {
+    int64_t next_index = 0;
+    for (auto& batch : *data_loader) {
+      for (auto& example : batch) {
+        ASSERT_TRUE(example.data.equal(
+            torch::full({2}, next_index++, torch::kLong)));
+        ASSERT_NE(example.target.item<int64_t>(), getpid());
+      }
+    }
+    ASSERT_EQ(next_index, 10);
+  }
+}
+
+TEST(DataLoaderTest, WorkerProcessesPropagateExceptions) {
+  struct D : datasets::Dataset<D, int> {
+    int get(size_t index) override {
+      throw std::invalid_argument("badness");
+    }
+    torch::optional<size_t> size() const override {
+      return 100;
+    }
+  };
+
+  auto data_loader = torch::data::make_data_loader(
+      D{},
+      samplers::RandomSampler(100),
+      DataLoaderOptions().workers(2).worker_processes(true));
+
+  try {
+    (void)*data_loader->begin();
+    FAIL() << "Expected a WorkerException";
+  } catch (torch::data::WorkerException& e) {
+    ASSERT_NE(std::string(e.what()).find("badness"), std::string::npos);
+  }
+}
+#endif // _WIN32
+
 TEST(DataLoaderTest, CallingBeginWhileOtherIteratorIsInFlightThrows) {
   DummyDataset dataset;
   auto data_loader =
@@ -350,6 +350,88 @@ TEST(OptimTest, ExternalVectorOfParameters) {
   ASSERT_TRUE(parameters[2].allclose(original_parameters[2] - 1.0));
 }
 
+TEST(OptimTest, FusedStepsMatchReference) {
+  torch::manual_seed(0);
+
+  // Small tensors, a tensor spanning several chunks and a non-contiguous one,
+  // which is updated without the fused kernel.
+  std::vector<torch::Tensor> params = {
+      torch::randn({3}),
+      torch::randn({7, 5}),
+      torch::randn({100000}),
+      torch::randn({6, 4}).t()};
+  std::vector<torch::Tensor> grads, momentum, exp_avgs, exp_avg_sqs;
+  for (const auto& p : params) {
+    grads.push_back(torch::randn_like(p));
+    momentum.push_back(torch::randn_like(p));
+    exp_avgs.push_back(torch::randn_like(p));
+    exp_avg_sqs.push_back(torch::rand_like(p));
+  }
+
+  torch::NoGradGuard guard;
+  std::vector<torch::Tensor> expected_params, expected_momentum;
+  for (size_t i = 0; i < params.size(); ++i) {
+    auto update = grads[i] + 1e-2 * params[i];
+    expected_momentum.push_back(0.9 * momentum[i] + 0.5 * update);
+    expected_params.push_back(
+        params[i] - 0.1 * (update + 0.9 * expected_momentum[i]));
+  }
+  torch::_fused_sgd_(
+      params, grads, momentum, 0.1, 0.9, 0.5, 1e-2, /*nesterov=*/true);
+  for (size_t i = 0; i < params.size(); ++i) {
+    ASSERT_TRUE(params[i].allclose(expected_params[i]));
+    ASSERT_TRUE(momentum[i].allclose(expected_momentum[i]));
+  }
+
+  const int64_t step = 3;
+  const double bias_correction1 = 1 - std::pow(0.9, step);
+  const double bias_correction2 = 1 - std::pow(0.999, step);
+  std::vector<torch::Tensor> expected_exp_avgs, expected_exp_avg_sqs;
+  expected_params.clear();
+  for (size_t i = 0; i < params.size(); ++i) {
+    expected_exp_avgs.push_back(0.9 * exp_avgs[i] + 0.1 * grads[i]);
+    expected_exp_avg_sqs.push_back(
+        0.999 * exp_avg_sqs[i] + 0.001 * grads[i] * grads[i]);
+    const auto denom =
+        (expected_exp_avg_sqs[i] / bias_correction2).sqrt() + 1e-8;
+    expected_params.push_back(
+        params[i] -
+        (1e-3 / bias_correction1) * expected_exp_avgs[i] / denom);
+  }
+  torch::_fused_adam_(
+      params, grads, exp_avgs, exp_avg_sqs, {}, step, 1e-3, 0.9, 0.999, 1e-8);
+  for (size_t i = 0; i < params.size(); ++i) {
+    ASSERT_TRUE(params[i].allclose(expected_params[i]));
+    ASSERT_TRUE(exp_avgs[i].allclose(expected_exp_avgs[i]));
+    ASSERT_TRUE(exp_avg_sqs[i].allclose(expected_exp_avg_sqs[i]));
+  }
+}
+
+TEST(OptimTest, SGDUpdatesSparseGradientsWithoutFusedKernel) {
+  torch::manual_seed(0);
+
+  std::vector<torch::Tensor> parameters = {
+      torch::randn({5, 3}), torch::randn({4})};
+  std::vector<torch::Tensor> original_parameters = {
+      parameters[0].clone(), parameters[1].clone()};
+  // The fused step has no kernel for sparse gradients, so only the second
+  // parameter goes through it.
+  const auto sparse_grad = torch::sparse_coo_tensor(
+      torch::tensor({{0, 3}}), torch::ones({2, 3}), {5, 3});
+  parameters[0].grad() = sparse_grad;
+  parameters[1].grad() = torch::ones({4});
+
+  SGD optimizer(parameters, SGDOptions(0.1).momentum(0.9));
+  optimizer.step();
+  optimizer.step();
+
+  // The momentum is the gradient after the first step and 1.9 times the
+  // gradient after the second.
+  ASSERT_TRUE(parameters[0].allclose(
+      original_parameters[0] - 0.29 * sparse_grad.to_dense()));
+  ASSERT_TRUE(parameters[1].allclose(original_parameters[1] - 0.29));
+}
+
 TEST(OptimTest, AddParameter_LBFGS) {
   torch::manual_seed(0);
 
@@ -1,4 +1,5 @@
 #include <memory>
+#include <thread>
 
 #include <gtest/gtest.h>
 
@@ -6,6 +7,7 @@
 #include <torch/csrc/distributed/autograd/context/container.h>
 #include <torch/csrc/distributed/autograd/context/context.h>
 #include <torch/csrc/distributed/autograd/engine/dist_engine.h>
+#include <torch/csrc/distributed/autograd/rpc_messages/propagate_gradients_req.h>
 #include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_autograd.h>
 #include <torch/csrc/distributed/autograd/utils.h>
 #include <torch/torch.h>
@@ -98,6 +100,57 @@ TEST_F(DistAutogradTest, TestInitializedContextCleanupSendFunction) {
   ASSERT_EQ(0, engine.numBackwardPasses());
 }
 
+TEST_F(DistAutogradTest, TestConcurrentBackwardPasses) {
+  auto& engine = DistEngine::getInstance();
+  ASSERT_EQ(0, engine.numBackwardPasses());
+
+  // Run the backward passes of several contexts from different threads.
+  constexpr int kNumThreads = 8;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([]() {
+      auto context = autogradContainer_->newContext();
+      auto options = at::TensorOptions().requires_grad(true);
+      auto t = torch::ones({1}, options);
+      auto tensors = std::vector<torch::Tensor>{t};
+      addSendRpcBackward(
+          context, AutogradMetadata(context->contextId(), 0), tensors);
+
+      auto sendFunction = context->retrieveSendFunction(0);
+      sendFunction->setGrads({t});
+      DistEngine::getInstance()
+          .executeSendFunctionAsync(
+              context, sendFunction, /*retrainGraph*/ false)
+          ->wait();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // Validate appropriate cleanup.
+  ASSERT_EQ(0, engine.numBackwardPasses());
+}
+
+TEST_F(DistAutogradTest, TestBatchedPropagateGradientsReq) {
+  std::vector<AutogradMetadata> autogradMetadata = {AutogradMetadata(1, 2),
+                                                    AutogradMetadata(1, 3)};
+  std::vector<std::vector<torch::autograd::Variable>> grads = {
+      {torch::ones({2}), torch::zeros({3})}, {}};
+  auto message = PropagateGradientsReq(
+                     autogradMetadata, grads, /*retainGraph*/ true)
+                     .toMessage();
+
+  auto req = PropagateGradientsReq::fromMessage(message);
+  ASSERT_TRUE(req->retainGraph());
+  ASSERT_EQ(2, req->getAutogradMetadata().size());
+  ASSERT_EQ(3, req->getAutogradMetadata()[1].autogradMessageId);
+  ASSERT_EQ(2, req->getGrads().size());
+  ASSERT_EQ(2, req->getGrads()[0].size());
+  ASSERT_TRUE(req->getGrads()[0][1].equal(torch::zeros({3})));
+  ASSERT_TRUE(req->getGrads()[1].empty());
+}
+
 } // namespace autograd
 } // namespace distributed
 } // namespace torch
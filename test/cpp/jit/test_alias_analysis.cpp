@@ -3,6 +3,10 @@
 #include "test/cpp/jit/test_base.h"
 #include "torch/csrc/jit/custom_operator.h"
 #include "torch/csrc/jit/passes/alias_analysis.h"
+#include "torch/csrc/jit/passes/common_subexpression_elimination.h"
+#include "torch/csrc/jit/passes/constant_propagation.h"
+#include "torch/csrc/jit/passes/dead_code_elimination.h"
+#include "torch/csrc/jit/testing/file_check.h"
 #include "torch/csrc/jit/script/compiler.h"
 #include "torch/csrc/utils/memory.h"
 
@@ -1150,6 +1154,56 @@ void testMemoryDAG() {
   }
 }
 
+void testSharedAliasDb() {
+  // Constant propagation, DCE and CSE all run on one AliasDb, which has to
+  // pick up the constants that constant propagation inserts.
+  auto graph = std::make_shared<Graph>();
+  std::unordered_map<std::string, Value*> vmap;
+  script::parseIR(
+      R"IR(
+graph(%x : Tensor, %z : Tensor):
+  %none : int? = prim::Constant()
+  %device : Device? = prim::Constant()
+  %pin : bool? = prim::Constant()
+  %c1 : int = prim::Constant[value=1]()
+  %c2 : int = prim::Constant[value=2]()
+  %sizes : int[] = prim::ListConstruct(%c2, %c2)
+  %ones : Tensor = aten::ones(%sizes, %none, %none, %device, %pin)
+  %w : Tensor = aten::mul(%x, %c2)
+  %a : Tensor = aten::mul(%z, %c2)
+  %b : Tensor = aten::mul(%z, %c2)
+  %dead : Tensor = aten::mul(%x, %c1)
+  %y : Tensor = aten::add_(%w, %ones, %c1)
+  %s : Tensor = aten::add(%a, %b, %c1)
+  return (%y, %s)
+)IR",
+      &*graph,
+      vmap);
+  auto w = vmap["w"];
+  AliasDb aliasDb(graph);
+
+  ConstantPropagation(graph, aliasDb);
+  Value* ones = nullptr;
+  for (auto node : graph->nodes()) {
+    if (node->kind() == prim::Constant &&
+        node->output()->type()->isSubtypeOf(TensorType::get())) {
+      ones = node->output();
+    }
+  }
+  ASSERT_TRUE(ones);
+  ASSERT_FALSE(aliasDb.mayAlias(ones, w));
+  ASSERT_FALSE(aliasDb.hasWriters(ones));
+  ASSERT_TRUE(aliasDb.hasWriters(w));
+
+  EliminateDeadCode(graph, aliasDb);
+  EliminateCommonSubexpression(graph, aliasDb);
+  testing::FileCheck()
+      .check_count("aten::mul", 2, /*exactly=*/true)
+      ->check("aten::add_")
+      ->check("aten::add")
+      ->run(*graph);
+}
+
 void testAliasRegistration() {
   {
     auto registry = torch::RegisterOperators().op(
@@ -12,6 +12,8 @@
 #include "c10/util/Exception.h"
 #define ASSERT_EQ(x, y) TORCH_INTERNAL_ASSERT((x) == (y))
 #define ASSERT_NE(x, y) TORCH_INTERNAL_ASSERT((x) != (y))
+#define ASSERT_GT(x, y) TORCH_INTERNAL_ASSERT((x) > (y))
+#define ASSERT_GE(x, y) TORCH_INTERNAL_ASSERT((x) >= (y))
 #define ASSERT_TRUE TORCH_INTERNAL_ASSERT
 #define ASSERT_FALSE(x) ASSERT_TRUE(!(x))
 #define ASSERT_THROWS_WITH(statement, substring)                         \
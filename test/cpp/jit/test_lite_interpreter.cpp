@@ -2,8 +2,11 @@
 #include <torch/csrc/jit/script/module.h>
 #include <torch/csrc/autograd/generated/variable_factories.h>
 #include <torch/csrc/jit/mobile/import.h>
+#include <torch/csrc/jit/mobile/interpreter.h>
 #include <torch/csrc/jit/mobile/module.h>
+#include <torch/csrc/jit/mobile/observer.h>
 #include <torch/csrc/jit/import.h>
+#include <c10/util/tempfile.h>
 
 // Tests go in torch::jit
 namespace torch {
@@ -176,5 +179,112 @@ void testLiteInterpreterPrim() {
   auto refi = ref.toInt();
   AT_ASSERT(resi == refi);
 }
+
+void testLiteInterpreterLoadMmap() {
+  script::Module m("m");
+  m.register_parameter("weight", torch::rand({16, 16}), false);
+  m.define(R"JIT(
+  def forward(self, x):
+      return torch.mm(x, self.weight)
+
+  def double(self, x):
+      return x + x
+  )JIT");
+
+  auto tempfile = c10::make_tempfile();
+  m._save_for_mobile(tempfile.name);
+  mobile::Module bc = _load_for_mobile_mmap(tempfile.name);
+
+  std::vector<IValue> inputs({torch::rand({4, 16})});
+  auto ref = m.forward(inputs).toTensor();
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(bc.forward(inputs).toTensor().equal(ref));
+  }
+  // methods are parsed on first lookup
+  auto res = bc.run_method("double", inputs).toTensor();
+  ASSERT_TRUE(res.equal(inputs[0].toTensor() * 2));
+  ASSERT_TRUE(bc.find_method("missing") == nullptr);
+}
+
+namespace {
+struct RecordingOperatorObserver : public MobileOperatorObserver {
+  explicit RecordingOperatorObserver(std::vector<MobileOperatorStats>* stats)
+      : stats_(stats) {}
+  bool shouldObserve(const c10::OperatorName& op_name) override {
+    return op_name.name == "aten::mm";
+  }
+  void onOperator(const MobileOperatorStats& stats) override {
+    stats_->push_back(stats);
+  }
+  std::vector<MobileOperatorStats>* stats_;
+};
+} // namespace
+
+void testLiteInterpreterOperatorObserver() {
+  script::Module m("m");
+  m.register_parameter("weight", torch::rand({16, 8}), false);
+  m.define(R"JIT(
+  def forward(self, x):
+      return torch.mm(x, self.weight) + 1
+  )JIT");
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+
+  std::vector<MobileOperatorStats> stats;
+  observerConfig().setOperatorObserver(
+      torch::make_unique<RecordingOperatorObserver>(&stats));
+  bc.forward({torch::rand({4, 16})});
+  observerConfig().setOperatorObserver(nullptr);
+
+  ASSERT_EQ(stats.size(), 1);
+  ASSERT_EQ(stats[0].op_name->name, "aten::mm");
+  ASSERT_EQ(stats[0].input_shapes.size(), 2);
+  ASSERT_EQ(stats[0].input_shapes[0], std::vector<int64_t>({4, 16}));
+  ASSERT_EQ(stats[0].input_shapes[1], std::vector<int64_t>({16, 8}));
+  ASSERT_GE(stats[0].latency_us, 0);
+  ASSERT_GE(
+      stats[0].allocated_bytes, static_cast<int64_t>(4 * 8 * sizeof(float)));
+
+  // nothing is reported once the observer is cleared
+  bc.forward({torch::rand({4, 16})});
+  ASSERT_EQ(stats.size(), 1);
+}
+
+void testLiteInterpreterAllocationPlan() {
+  script::Module m("m");
+  m.register_parameter("weight", torch::rand({16, 8}), false);
+  m.define(R"JIT(
+  def forward(self, x):
+      return torch.relu(torch.mm(x * 2, self.weight) + 1) * 3
+  )JIT");
+  std::stringstream ss;
+  m._save_for_mobile(ss);
+  mobile::Module bc = _load_for_mobile(ss);
+  const auto& plan = bc.find_method("forward")->get_code()->allocation_plan_;
+
+  std::vector<IValue> inputs({torch::rand({4, 16})});
+  auto ref = m.forward(inputs).toTensor();
+  std::vector<at::Tensor> results;
+  for (int i = 0; i < 3; ++i) {
+    results.push_back(bc.forward(inputs).toTensor());
+  }
+  // the intermediates come from the arena, the outputs that are still alive
+  // don't
+  ASSERT_GT(plan.arena_size(), 0);
+  const size_t reused = plan.num_arena_allocations();
+  ASSERT_GT(reused, 0);
+  for (const auto& res : results) {
+    ASSERT_TRUE(res.equal(ref));
+  }
+
+  // another shape records a new plan
+  std::vector<IValue> other_inputs({torch::rand({2, 16})});
+  auto other_ref = m.forward(other_inputs).toTensor();
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(bc.forward(other_inputs).toTensor().equal(other_ref));
+  }
+  ASSERT_EQ(plan.num_arena_allocations(), reused);
+}
 } // namespace torch
 } // namespace jit
@@ -17,6 +17,7 @@
 #include "torch/csrc/jit/code_template.h"
 #include "torch/csrc/jit/custom_operator.h"
 #include "torch/csrc/jit/fuser/interface.h"
+#include "torch/csrc/jit/graph_executor.h"
 #include "torch/csrc/jit/import.h"
 #include "torch/csrc/jit/interpreter.h"
 #include "torch/csrc/jit/irparser.h"
@@ -54,14 +55,19 @@
 #include "onnx/onnx_pb.h"
 
 #include <c10/util/Exception.h>
+#include <c10/util/tempfile.h>
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdio>
+#include <fstream>
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_set>
 #include <utility>
@@ -858,6 +864,91 @@ void testRecordFunction() {
   autograd::profiler::popCallback();
 }
 
+void testSamplingProfiler() {
+  auto run_ranges = [](int n) {
+    for (int k = 0; k < n; k++) {
+      RECORD_FUNCTION("sampled", std::vector<c10::IValue>());
+    }
+  };
+
+  // 1 in sample_every ranges is recorded
+  autograd::profiler::SamplingProfilerConfig config;
+  config.sample_every = 10;
+  autograd::profiler::enableSamplingProfiler(config);
+  TORCH_CHECK(autograd::profiler::samplingProfilerEnabled());
+  run_ranges(1000);
+  auto events = autograd::profiler::disableSamplingProfiler();
+  TORCH_CHECK(!autograd::profiler::samplingProfilerEnabled());
+  TORCH_CHECK(events.size() == 100);
+  for (const auto& event : events) {
+    TORCH_CHECK(
+        autograd::profiler::getInternedName(event.name_id) == "sampled");
+    TORCH_CHECK(event.thread_id == events[0].thread_id);
+    TORCH_CHECK(event.end_ns >= event.start_ns);
+  }
+
+  // events are delivered to the consumer, from every thread
+  std::mutex mutex;
+  std::vector<autograd::profiler::SampledEvent> consumed;
+  config.sample_every = 1;
+  config.flush_interval_ms = 1;
+  config.consumer =
+      [&](const std::vector<autograd::profiler::SampledEvent>& batch) {
+        std::lock_guard<std::mutex> guard(mutex);
+        consumed.insert(consumed.end(), batch.begin(), batch.end());
+      };
+  autograd::profiler::enableSamplingProfiler(config);
+  std::thread other([&] { run_ranges(100); });
+  run_ranges(100);
+  other.join();
+  events = autograd::profiler::disableSamplingProfiler();
+  TORCH_CHECK(events.empty());
+  TORCH_CHECK(consumed.size() == 200);
+  TORCH_CHECK(autograd::profiler::samplingProfilerDroppedEvents() == 0);
+  std::unordered_set<uint16_t> thread_ids;
+  for (const auto& event : consumed) {
+    thread_ids.insert(event.thread_id);
+  }
+  TORCH_CHECK(thread_ids.size() == 2);
+}
+
+void testStreamingProfile() {
+  auto tempfile = c10::make_tempfile();
+  std::vector<std::string> files;
+  {
+    autograd::profiler::RecordStreamingProfile guard(
+        tempfile.name, /*max_file_bytes=*/4096);
+    for (int k = 0; k < 200; k++) {
+      RECORD_FUNCTION("streamed", std::vector<c10::IValue>());
+    }
+  }
+  size_t count = 0;
+  for (size_t i = 0;; ++i) {
+    const std::string path =
+        i == 0 ? tempfile.name : tempfile.name + "." + std::to_string(i);
+    std::ifstream file(path);
+    if (!file) {
+      break;
+    }
+    std::stringstream ss;
+    ss << file.rdbuf();
+    const std::string trace = ss.str();
+    // every file is a complete trace
+    TORCH_CHECK(trace.front() == '[');
+    TORCH_CHECK(trace.find("]\n") == trace.size() - 2);
+    for (size_t pos = 0;
+         (pos = trace.find("\"streamed\"", pos)) != std::string::npos;
+         count++, pos++) {
+    }
+    if (i > 0) {
+      std::remove(path.c_str());
+    }
+    files.push_back(path);
+  }
+  TORCH_CHECK(count == 200);
+  TORCH_CHECK(files.size() > 1);
+}
+
 class TestThreadLocalDebugInfo
   : public at::ThreadLocalDebugInfoBase {
  public:
@@ -901,6 +992,27 @@ void testThreadLocalDebugInfo() {
   while (!done) {}
   checkDebugInfo();
 
+  // grad mode and the local dispatch key set are propagated along with it
+  {
+    at::NoGradGuard no_grad;
+    c10::impl::ExcludeDispatchKeyGuard exclude_variable(
+        c10::DispatchKey::VariableTensorId);
+    bool grad_mode_enabled = true;
+    bool variable_excluded = false;
+    done = false;
+    at::launch([&]() {
+      checkDebugInfo();
+      grad_mode_enabled = at::GradMode::is_enabled();
+      variable_excluded = c10::impl::tls_is_dispatch_key_excluded(
+          c10::DispatchKey::VariableTensorId);
+      done = true;
+    });
+    while (!done) {}
+    TORCH_CHECK(!grad_mode_enabled);
+    TORCH_CHECK(variable_excluded);
+  }
+  TORCH_CHECK(at::GradMode::is_enabled());
+
   // check that thread local debug info is propagated through backward pass
   autograd::profiler::pushCallback(
       [&checkDebugInfo](const autograd::profiler::RecordFunction& fn) {
@@ -1196,6 +1308,48 @@ void testProfiler() {
   checkShape(*tanh_n, eltwise);
 }
 
+void testProfilerMergesRuns() {
+  static const auto basic_example = R"JIT(
+  def basic(x, y):
+    return x + y
+  )JIT";
+
+  auto cu = compile(basic_example);
+  auto& fun = cu->get_function("basic");
+  const size_t old_num_runs = getNumProfiledRuns().exchange(2);
+  auto pr = ProfilingRecord::instrumentGraph(fun.graph());
+  getNumProfiledRuns() = old_num_runs;
+
+  auto nodes = pr->profiled_graph_->block()->nodes();
+  auto add = std::find_if(nodes.begin(), nodes.end(), [](Node* n) {
+    return n->kind() == aten::add;
+  });
+  ASSERT_NE(add, nodes.end());
+  auto profiled_type = [&]() {
+    return add->inputs().at(0)->node()->output()->type()->expect<TensorType>();
+  };
+
+  Code cd(pr->profiled_graph_);
+  auto run = [&](std::vector<int64_t> sizes) {
+    auto stack = createStack({at::randn(sizes), at::randn(sizes)});
+    InterpreterState is{cd};
+    is.run(stack);
+  };
+  // the profile is only published once the last profiling run has ended
+  run({2, 3});
+  ASSERT_FALSE(pr->ready());
+  ASSERT_FALSE(profiled_type()->sizes().size().has_value());
+  run({4, 3});
+  ASSERT_TRUE(pr->ready());
+  ASSERT_EQ(profiled_type()->sizes().size(), 2);
+  ASSERT_FALSE(profiled_type()->sizes()[0].has_value());
+  ASSERT_EQ(profiled_type()->sizes()[1], 3);
+  // and later runs leave it alone
+  run({5, 5});
+  ASSERT_FALSE(profiled_type()->sizes()[0].has_value());
+  ASSERT_EQ(profiled_type()->sizes()[1], 3);
+}
+
 void testCallStack() {
   const auto text = R"(
 def ham(x):
@@ -40,6 +40,7 @@ namespace jit {
   _(WriteTracking)                     \
   _(Wildcards)                         \
   _(MemoryDAG)                         \
+  _(SharedAliasDb)                     \
   _(IRParser)                          \
   _(ConstantPooling)                   \
   _(NetDefConverter)                   \
@@ -49,10 +50,13 @@ namespace jit {
   _(ClassParser)                       \
   _(UnifyTypes)                        \
   _(Profiler)                          \
+  _(ProfilerMergesRuns)                \
   _(InsertAndEliminateRedundantGuards) \
   _(InsertBailOuts)                    \
   _(PeepholeOptimize)                  \
   _(RecordFunction)                    \
+  _(SamplingProfiler)                  \
+  _(StreamingProfile)                  \
   _(ThreadLocalDebugInfo)              \
   _(SubgraphMatching)                  \
   _(SubgraphRewriter)                  \
@@ -77,6 +81,9 @@ namespace jit {
   _(LiteInterpreterTuple)              \
   _(LiteInterpreterPrimOverload)       \
   _(LiteInterpreterUpsampleNearest2d)  \
+  _(LiteInterpreterLoadMmap)           \
+  _(LiteInterpreterOperatorObserver)   \
+  _(LiteInterpreterAllocationPlan)     \
   _(CommonAncestor)                    \
   _(AutogradSymbols)                   \
   _(MobileTypeParser)                  \
@@ -49,3 +49,35 @@ TEST(WireSerialize, RecopySparseTensors) {
   EXPECT_TRUE(torch::equal(tiny, deser.second[0]));
   EXPECT_LT(ser.size(), (tiny.element_size() * k1K) + k1K);
 }
+
+TEST(WireSerialize, Detached) {
+  std::vector<char> payload = {'h', 'i'};
+  std::vector<at::Tensor> tensors = {
+      torch::randn({100, 100}), torch::empty({0}), torch::arange(10)};
+  auto ser = torch::distributed::rpc::wireSerializeDetached(payload, tensors);
+  EXPECT_EQ(tensors.size(), ser.second.size());
+
+  // The tensor data is not part of the message but aliases the storages.
+  EXPECT_LT(ser.first.size(), 1000u);
+  EXPECT_EQ(ser.second[0].data_ptr(), tensors[0].data_ptr());
+
+  // Receive the data into new buffers, as the transport would.
+  auto sizes = torch::distributed::rpc::wireDetachedTensorDataSizes(
+      ser.first.data(), ser.first.size());
+  ASSERT_EQ(sizes.size(), ser.second.size());
+  std::vector<at::Tensor> received;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    EXPECT_EQ(static_cast<int64_t>(sizes[i]), ser.second[i].numel());
+    received.push_back(ser.second[i].clone());
+  }
+
+  auto deser = torch::distributed::rpc::wireDeserializeDetached(
+      ser.first.data(), ser.first.size(), received);
+  EXPECT_EQ(payload, deser.first);
+  ASSERT_EQ(tensors.size(), deser.second.size());
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    EXPECT_TRUE(torch::equal(tensors[i], deser.second[i]));
+  }
+  // The deserialized tensors use the received buffers.
+  EXPECT_EQ(deser.second[0].data_ptr(), received[0].data_ptr());
+}
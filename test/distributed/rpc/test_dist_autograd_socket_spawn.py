@@ -0,0 +1,31 @@
+#!/usr/bin/env python3
+from __future__ import absolute_import, division, print_function, unicode_literals
+
+import torch.testing._internal.dist_utils
+
+# Run the distributed autograd tests over the SocketAgent. This has to be set
+# before the tests are imported, as their skip decorators read the backend name.
+torch.testing._internal.dist_utils.TEST_CONFIG.rpc_backend_name = "SOCKET"
+
+from torch.testing._internal.distributed.rpc.dist_autograd_test import DistAutogradTest, DistAutogradJitTest
+from torch.testing._internal.common_distributed import MultiProcessTestCase
+from torch.testing._internal.common_utils import TEST_WITH_ASAN, run_tests
+
+import unittest
+
+@unittest.skipIf(TEST_WITH_ASAN, "Skip ASAN as torch + multiprocessing spawn have known issues")
+class SocketDistAutogradTestWithSpawn(MultiProcessTestCase, DistAutogradTest):
+
+    def setUp(self):
+        super(SocketDistAutogradTestWithSpawn, self).setUp()
+        self._spawn_processes()
+
+@unittest.skipIf(TEST_WITH_ASAN, "Skip ASAN as torch + multiprocessing spawn have known issues")
+class SocketDistAutogradJitTestWithSpawn(MultiProcessTestCase, DistAutogradJitTest):
+
+    def setUp(self):
+        super(SocketDistAutogradJitTestWithSpawn, self).setUp()
+        self._spawn_processes()
+
+if __name__ == '__main__':
+    run_tests()
@@ -0,0 +1,18 @@
+#!/usr/bin/env python3
+from __future__ import absolute_import, division, print_function, unicode_literals
+
+from torch.testing._internal.distributed.rpc.dist_pipeline_test import DistPipelineTest
+from torch.testing._internal.common_distributed import MultiProcessTestCase
+from torch.testing._internal.common_utils import TEST_WITH_ASAN, run_tests
+
+import unittest
+
+@unittest.skipIf(TEST_WITH_ASAN, "Skip ASAN as torch + multiprocessing spawn have known issues")
+class DistPipelineTestWithSpawn(MultiProcessTestCase, DistPipelineTest):
+
+    def setUp(self):
+        super(DistPipelineTestWithSpawn, self).setUp()
+        self._spawn_processes()
+
+if __name__ == '__main__':
+    run_tests()
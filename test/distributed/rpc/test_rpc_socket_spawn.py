@@ -0,0 +1,24 @@
+#!/usr/bin/env python3
+from __future__ import absolute_import, division, print_function, unicode_literals
+
+import torch.testing._internal.dist_utils
+
+# Run the RPC tests over the SocketAgent. This has to be set before the tests
+# are imported, as their skip decorators read the backend name.
+torch.testing._internal.dist_utils.TEST_CONFIG.rpc_backend_name = "SOCKET"
+
+from torch.testing._internal.distributed.rpc.rpc_test import RpcTest
+from torch.testing._internal.common_distributed import MultiProcessTestCase
+from torch.testing._internal.common_utils import TEST_WITH_ASAN, run_tests
+
+import unittest
+
+@unittest.skipIf(TEST_WITH_ASAN, "Skip ASAN as torch + multiprocessing spawn have known issues")
+class SocketRpcTestWithSpawn(MultiProcessTestCase, RpcTest):
+
+    def setUp(self):
+        super(SocketRpcTestWithSpawn, self).setUp()
+        self._spawn_processes()
+
+if __name__ == '__main__':
+    run_tests()
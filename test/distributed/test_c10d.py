@@ -799,6 +799,54 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
         inputs = [torch.tensor([i + self.rank]).cuda() for i in range(1000)]
         self._test_allreduce_stress(inputs)
 
+    @skip_if_not_multigpu
+    @skip_if_rocm
+    def test_allreduce_chunked_cuda(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Large enough to be allreduced in several chunks, the last one partial.
+        values = torch.arange(3 * 1024 * 1024 + 1024, dtype=torch.float)
+        inputs = [
+            values.clone(),
+            # Dense tensors are chunked by memory, rather than by index.
+            values.view(1024, -1).t(),
+        ]
+        for input in inputs:
+            expected = input * self.world_size + \
+                self.world_size * (self.world_size - 1) / 2
+            tensor = (input + self.rank).cuda()
+            pg.allreduce(tensor).wait()
+            self.assertEqual(expected, tensor.cpu())
+
+    def test_allreduce_hierarchical(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        opts = self.opts(threads=8)
+        opts.hierarchical_allreduce = True
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, opts)
+
+        # Growing sizes make every process replace the shared memory segment.
+        inputs = [
+            torch.full([i * 1000 + 1], float(i + self.rank)) for i in range(20)
+        ]
+        work_handles = [pg.allreduce(input) for input in inputs]
+        for i, work_handle in enumerate(work_handles):
+            work_handle.wait()
+            expected = (i * self.world_size) + (self.world_size * (self.world_size - 1) / 2)
+            self.assertEqual(torch.full([i * 1000 + 1], float(expected)), inputs[i])
+
+        # Multiple inputs, which the hierarchical allreduce sums like a
+        # single one for SUM; the other reduction operations fall back to
+        # the regular allreduce.
+        tests = simple_multi_input_reduce_tests(self.rank, self.world_size)
+        for (op, inputs, output) in tests:
+            allreduce_opts = c10d.AllreduceOptions()
+            allreduce_opts.reduceOp = op
+            tensors = [input.clone() for input in inputs]
+            pg.allreduce(tensors, allreduce_opts).wait()
+            for tensor in tensors:
+                self.assertEqual(output, tensor)
+
     def test_allreduce_coalesced_checks(self):
         store = c10d.FileStore(self.file_name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
@@ -1016,6 +1064,55 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
     def test_scatter_basics_cuda(self):
         self._test_scatter_basics(lambda t: t.clone().cuda())
 
+    def test_alltoall_base_basics(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Equal splits: rank r sends [r * world_size + i] to rank i.
+        input = torch.arange(self.world_size, dtype=torch.float) + self.rank * self.world_size
+        output = torch.empty(self.world_size)
+        pg.alltoall_base(output, input, [], []).wait()
+        expected = torch.arange(self.world_size, dtype=torch.float) * self.world_size + self.rank
+        self.assertEqual(expected, output)
+
+        # Variable splits: rank r sends i + 1 rows of value r to rank i.
+        input_split_sizes = [i + 1 for i in range(self.world_size)]
+        output_split_sizes = [self.rank + 1] * self.world_size
+        input = torch.full((sum(input_split_sizes), 2), self.rank, dtype=torch.float)
+        output = torch.empty(sum(output_split_sizes), 2)
+        pg.alltoall_base(output, input, output_split_sizes, input_split_sizes).wait()
+        expected = torch.cat([
+            torch.full((self.rank + 1, 2), i, dtype=torch.float)
+            for i in range(self.world_size)])
+        self.assertEqual(expected, output)
+
+    def test_alltoall_base_checks(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        t = torch.empty(self.world_size)
+        with self.assertRaisesRegex(ValueError, "divide equally"):
+            pg.alltoall_base(t, torch.empty(self.world_size + 1), [], [])
+
+        with self.assertRaisesRegex(ValueError, "not equal to group size"):
+            pg.alltoall_base(t, t, [], [self.world_size])
+
+        with self.assertRaisesRegex(ValueError, "doesn't match"):
+            pg.alltoall_base(t, t, [], [2] * self.world_size)
+
+    def test_alltoall_basics(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        # Rank r sends r + i + 1 elements of value r to rank i.
+        inputs = [
+            torch.full((self.rank + i + 1,), self.rank, dtype=torch.float)
+            for i in range(self.world_size)]
+        outputs = [torch.empty(i + self.rank + 1) for i in range(self.world_size)]
+        pg.alltoall(outputs, inputs).wait()
+        for i in range(self.world_size):
+            self.assertEqual(torch.full((i + self.rank + 1,), i, dtype=torch.float), outputs[i])
+
     def _test_scatter_stress(self, inputs, fn):
         store = c10d.FileStore(self.file_name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts(threads=8))
@@ -1714,6 +1811,46 @@ class ProcessGroupNCCLTest(TestCase):
             for s_idx, t in enumerate(device_ts):
                 self.assertEqual(torch.tensor([s_idx]), t)
 
+    def test_comms_per_device(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupNCCL(
+            store, self.rank, self.world_size, comms_per_device=2)
+
+        # Consecutive collectives alternate between the two communicators,
+        # and can run concurrently on their streams.
+        tensors = [torch.full((10,), i).cuda(0) for i in range(4)]
+        works = [pg.allreduce([t]) for t in tensors]
+        for i, work in enumerate(works):
+            work.wait()
+            self.assertEqual(torch.full((10,), i * self.world_size), tensors[i])
+
+        with self.assertRaisesRegex(ValueError, "at least one communicator"):
+            c10d.ProcessGroupNCCL(store, self.rank, self.world_size, comms_per_device=0)
+
+    def test_high_priority_streams(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupNCCL(
+            store, self.rank, self.world_size, is_high_priority_stream=True)
+
+        tensors = [torch.full((10,), i).cuda(i) for i in range(self.num_gpus)]
+        pg.allreduce(tensors).wait()
+        for t in tensors:
+            self.assertEqual(
+                torch.full((10,), self.world_size * sum(range(self.num_gpus))), t)
+
+    def test_allgather_base_ops(self):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
+
+        input = torch.arange(4, dtype=torch.float).cuda(0)
+        output = torch.zeros(4 * self.world_size).cuda(0)
+        pg._allgather_base(output, input).wait()
+        self.assertEqual(input.repeat(self.world_size), output)
+
+        # The output buffer must hold world_size times the input.
+        with self.assertRaisesRegex(RuntimeError, "world_size times"):
+            pg._allgather_base(torch.zeros(3).cuda(0), input)
+
     def test_reduce_scatter_ops(self):
         store = c10d.FileStore(self.file.name, self.world_size)
         pg = c10d.ProcessGroupNCCL(store, self.rank, self.world_size)
@@ -2948,6 +3085,67 @@ class DistributedDataParallelTest(MultiProcessTestCase):
         ddp_parameter = next(ddp_model.parameters())
         self.assertEqual(vanilla_parameter.grad, ddp_parameter.grad)
 
+    def _test_sparse_gradients_coalesced(self, sparse_densify_threshold):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size)
+
+        class MultiTableModule(nn.Module):
+            def __init__(self):
+                super(MultiTableModule, self).__init__()
+                # Tables of different sizes, so that the small ones get
+                # denser gradients than the large one.
+                self.tables = nn.ModuleList([
+                    nn.EmbeddingBag(10, 10, sparse=True),
+                    nn.EmbeddingBag(3, 10, sparse=True),
+                    nn.EmbeddingBag(100, 10, sparse=True),
+                ])
+                self.fc = nn.Linear(30, 10)
+
+            def forward(self, x):
+                embedded = [table(x % table.num_embeddings) for table in self.tables]
+                return F.softmax(self.fc(torch.cat(embedded, dim=1)), dim=1)
+
+        torch.manual_seed(1337)
+
+        vanilla_model = MultiTableModule()
+        ddp_model = DistributedDataParallel(
+            copy.deepcopy(vanilla_model),
+            process_group=process_group,
+            sparse_densify_threshold=sparse_densify_threshold,
+        )
+
+        mult = 2
+        batch_size = mult * self.world_size
+        criterion = nn.CrossEntropyLoss()
+        for _ in range(2):
+            input = torch.randint(0, 100, [batch_size, 2])
+            target = torch.randint(0, 10, [batch_size])
+            vanilla_model.zero_grad()
+            ddp_model.zero_grad()
+            criterion(vanilla_model(input), target).backward()
+            partial_input = input.split(mult)[self.rank]
+            partial_target = target.split(mult)[self.rank]
+            criterion(ddp_model(partial_input), partial_target).backward()
+
+            for vanilla_parameter, ddp_parameter in zip(
+                    vanilla_model.parameters(), ddp_model.parameters()):
+                self.assertEqual(
+                    vanilla_parameter.grad.is_sparse,
+                    ddp_parameter.grad.is_sparse)
+                self.assertEqual(
+                    vanilla_parameter.grad.to_dense(),
+                    ddp_parameter.grad.to_dense())
+
+    @requires_gloo()
+    def test_sparse_gradients_coalesced(self):
+        self._test_sparse_gradients_coalesced(None)
+
+    @requires_gloo()
+    def test_sparse_gradients_coalesced_densify(self):
+        # Densifies the gradients of the small tables, but not of the large
+        # one.
+        self._test_sparse_gradients_coalesced(0.5)
+
 
 class ReducerModule(nn.Module):
     def __init__(self):
@@ -3002,13 +3200,17 @@ class ReducerTest(TestCase):
         buckets = [list(indices) for _, indices in group_by_type]
         dist.Reducer(parameters, buckets, self.process_group)
 
-    def _create_reducer_for_models(self, models):
+    def _create_reducer_for_models(self, models, gradient_as_bucket_view=False):
         parameters = [list(model.parameters()) for model in models]
         group_by_type = groupby(
             range(len(parameters[0])),
             key=lambda i: parameters[0][i].type())
         buckets = [list(indices) for _, indices in group_by_type]
-        return dist.Reducer(parameters, buckets, self.process_group)
+        return dist.Reducer(
+            parameters,
+            buckets,
+            self.process_group,
+            gradient_as_bucket_view=gradient_as_bucket_view)
 
     def test_forward_backward_single_replica(self):
         batch_size = 10
@@ -3082,6 +3284,118 @@ class ReducerTest(TestCase):
             output.backward()
             optimizer.step()
 
+    def test_forward_backward_gradient_as_bucket_view(self):
+        batch_size = 10
+        model = self._create_mixed_precision_model()
+        view_model = copy.deepcopy(model)
+        reducer = self._create_reducer_for_models([model])
+        view_reducer = self._create_reducer_for_models(
+            [view_model], gradient_as_bucket_view=True)
+        loss = nn.CrossEntropyLoss()
+        optimizer = torch.optim.SGD(model.parameters(), lr=0.1)
+        view_optimizer = torch.optim.SGD(view_model.parameters(), lr=0.1)
+        for i in range(4):
+            input = torch.rand([batch_size, 2], dtype=torch.double)
+            target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+            # Unused parameter in the first and the third iteration.
+            use_fc3 = i % 2 == 1
+            for m, r, o in ((model, reducer, optimizer),
+                            (view_model, view_reducer, view_optimizer)):
+                # zero_grad calls `detach_` and `zero_` on the gradients, which
+                # must keep working when they are views into the buckets.
+                o.zero_grad()
+                output = loss(m(input, use_fc3=use_fc3), target)
+                r.prepare_for_backward(output)
+                output.backward()
+                o.step()
+            for p, view_p in zip(model.parameters(), view_model.parameters()):
+                self.assertEqual(p.grad, view_p.grad)
+                self.assertEqual(p, view_p)
+
+    def test_rebuild_buckets(self):
+        batch_size = 10
+        model = self._create_mixed_precision_model()
+        reference_model = copy.deepcopy(model)
+        reducer = self._create_reducer_for_models([model])
+        loss = nn.CrossEntropyLoss()
+        # Nothing has been recorded before the first iteration.
+        self.assertFalse(reducer._rebuild_buckets())
+        for i in range(3):
+            # The buckets are rebuilt once, after the first iteration.
+            if i > 0:
+                self.assertEqual(reducer._rebuild_buckets(), i == 1)
+            input = torch.rand([batch_size, 2], dtype=torch.double)
+            target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+            for m in (model, reference_model):
+                m.zero_grad()
+                output = loss(m(input), target)
+                if m is model:
+                    reducer.prepare_for_backward(output)
+                output.backward()
+            # One bucket per dtype, each ready at some point after
+            # `prepare_for_backward`.
+            bucket_ready_stats = reducer.get_bucket_ready_stats()
+            self.assertEqual(len(bucket_ready_stats), 2)
+            self.assertTrue(all(t > 0 for t in bucket_ready_stats))
+            for p, reference_p in zip(model.parameters(), reference_model.parameters()):
+                self.assertEqual(p.grad, reference_p.grad)
+
+    def test_rebuild_buckets_find_unused_parameters(self):
+        model = self._create_mixed_precision_model()
+        parameters = [list(model.parameters())]
+        buckets = [[0], [1, 2]]
+        reducer = dist.Reducer(
+            parameters,
+            buckets,
+            self.process_group,
+            find_unused_parameters=True)
+        output = nn.CrossEntropyLoss()(
+            model(torch.rand([10, 2], dtype=torch.double)),
+            torch.LongTensor([random.randrange(4) for _ in range(10)]))
+        reducer.prepare_for_backward(output)
+        output.backward()
+        # The recorded order can be incomplete with unused parameters.
+        self.assertFalse(reducer._rebuild_buckets())
+
+    def test_fp16_compress_hook(self):
+        batch_size = 10
+        model = self._create_mixed_precision_model()
+        hook_model = copy.deepcopy(model)
+        reducer = self._create_reducer_for_models([model])
+        hook_reducer = self._create_reducer_for_models([hook_model])
+        hook_reducer._register_fp16_compress_hook(self.process_group)
+        # A reducer accepts a single communication hook.
+        with self.assertRaises(RuntimeError):
+            hook_reducer._register_fp16_compress_hook(self.process_group)
+        loss = nn.CrossEntropyLoss()
+        input = torch.rand([batch_size, 2], dtype=torch.double)
+        target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+        for m, r in ((model, reducer), (hook_model, hook_reducer)):
+            output = loss(m(input), target)
+            r.prepare_for_backward(output)
+            output.backward()
+        for p, hook_p in zip(model.parameters(), hook_model.parameters()):
+            self.assertEqual(p.grad, hook_p.grad, prec=1e-3)
+
+    def test_powersgd_hook(self):
+        batch_size = 10
+        model = self._create_mixed_precision_model()
+        reducer = self._create_reducer_for_models([model])
+        reducer._register_powersgd_hook(
+            self.process_group, matrix_approximation_rank=1)
+        loss = nn.CrossEntropyLoss()
+        for _ in range(2):
+            model.zero_grad()
+            input = torch.rand([batch_size, 2], dtype=torch.double)
+            target = torch.LongTensor([random.randrange(4) for _ in range(batch_size)])
+            output = loss(model(input), target)
+            reducer.prepare_for_backward(output)
+            output.backward()
+            # Matrices that benefit from compression are reduced as a
+            # rank-1 approximation of their gradient.
+            self.assertLessEqual(torch.matrix_rank(model.fc2.weight.grad).item(), 1)
+            self.assertLessEqual(torch.matrix_rank(model.fc3.weight.grad).item(), 1)
+
 
 class ComputeBucketAssignmentTest(TestCase):
     def test_single_limit_single_dtype(self):
@@ -3378,6 +3692,33 @@ class CommTest(MultiProcessTestCase):
         device = torch.device('cpu')
         self._test_broadcast_coalesced(process_group, device)
 
+    @requires_gloo()
+    def test_persistent_broadcast_gloo_cpu(self):
+        store = c10d.FileStore(self.file_name, self.world_size)
+        options = c10d.ProcessGroupGloo.Options()
+        options.devices = [c10d.ProcessGroupGloo.create_device(interface=LOOPBACK)]
+        process_group = c10d.ProcessGroupGloo(store, self.rank, self.world_size, options)
+
+        tensors = list(torch.zeros(12, dtype=torch.float32).chunk(3))
+        tensors += list(torch.zeros(12, dtype=torch.float64).chunk(3))
+        # Non-contiguous tensors can't view their bucket.
+        tensors.append(torch.zeros(4, 3).t())
+        broadcast = c10d._PersistentBroadcast(process_group, tensors, buffer_size=32)
+
+        for iteration in range(3):
+            if iteration == 2:
+                # The tensor stops viewing its bucket and is bound again.
+                tensors[1].data = torch.zeros(4)
+            for tensor in tensors:
+                tensor.fill_(iteration + 1 if self.rank == 0 else -1)
+            broadcast.run()
+            for tensor in tensors:
+                self.assertEqual(tensor, torch.full_like(tensor, iteration + 1))
+
+        with self.assertRaisesRegex(RuntimeError, "changed its size"):
+            tensors[0].data = torch.zeros(5)
+            broadcast.run()
+
 
 if __name__ == '__main__':
     assert not torch.cuda._initialized, "test_distributed must not have initialized CUDA context on main process"
@@ -10,6 +10,7 @@ pytorch_test_dir = os.path.dirname(os.path.dirname(os.path.realpath(__file__)))
 sys.path.append(pytorch_test_dir)
 from torch.testing._internal.jit_utils import JitTestCase, _inline_everything
 from torch.testing._internal.common_utils import TemporaryFileName
+from torch.testing import FileCheck
 
 class TestAsync(JitTestCase):
     def test_async_python(self):
@@ -420,6 +421,42 @@ class TestAsync(JitTestCase):
             extra_files['bar'] = ''
             torch.jit.load(buffer, _extra_files=extra_files)
 
+    def test_fork_independent_branches(self):
+        def towers(x, w1, w2, w3):
+            a = torch.mm(torch.relu(torch.mm(x, w1)), w2)
+            b = torch.mm(torch.sigmoid(torch.mm(x, w3)), w2)
+            # too cheap to be forked
+            c = torch.tanh(x)
+            return torch.cat([a, b, c.sum(1, keepdim=True)], 1)
+
+        scripted = torch.jit.script(towers)
+        graph = scripted.graph.copy()
+        torch._C._jit_pass_fork_independent_branches(graph)
+        # one of the two towers is forked, the other runs on the current thread
+        FileCheck().check("prim::fork").check("aten::mm").check("aten::wait") \
+            .check("aten::cat").run(str(graph))
+        FileCheck().check_count("aten::wait", 1, exactly=True).run(str(graph))
+
+        x, w1, w3 = torch.randn(4, 5), torch.randn(5, 6), torch.randn(5, 6)
+        w2 = torch.randn(6, 3)
+        old_mode = torch._C._jit_set_automatic_fork_mode(True)
+        try:
+            self.assertEqual(scripted(x, w1, w2, w3), towers(x, w1, w2, w3))
+            self.assertEqual(scripted(x, w1, w2, w3), towers(x, w1, w2, w3))
+        finally:
+            torch._C._jit_set_automatic_fork_mode(old_mode)
+
+    def test_fork_independent_branches_mutation(self):
+        def f(x, w1, w2):
+            a = torch.mm(x, w1)
+            b = torch.mm(x, w2)
+            x.add_(1)
+            return a + b
+
+        graph = torch.jit.script(f).graph.copy()
+        torch._C._jit_pass_fork_independent_branches(graph)
+        FileCheck().check_not("prim::fork").run(str(graph))
+
 
 if __name__ == '__main__':
     raise RuntimeError("This test file is not meant to be run directly, use:\n\n"
@@ -7,9 +7,13 @@ from torch.onnx import utils, OperatorExportTypes
 from torch.onnx.symbolic_helper import _set_opset_version
 
 import onnx
+from onnx import numpy_helper
 
 import io
 import copy
+import os
+import shutil
+import tempfile
 
 
 class TestUtilityFuns(TestCase):
@@ -308,6 +312,34 @@ class TestUtilityFuns(TestCase):
         # test strip_doc_string=False
         self.assertFalse(is_model_stripped(io.BytesIO(), False))
 
+    def test_export_external_data(self):
+        model = torch.nn.Linear(32, 16)
+        x = torch.randn(2, 32)
+        model_dir = tempfile.mkdtemp()
+        try:
+            model_file = os.path.join(model_dir, "model.onnx")
+            torch.onnx.export(model, x, model_file, opset_version=self.opset_version,
+                              use_external_data_format=True)
+            # Only the weight is large enough to be moved out of the model.
+            self.assertEqual(sorted(os.listdir(model_dir)), ["model.onnx", "weight"])
+            with open(os.path.join(model_dir, "weight"), "rb") as f:
+                self.assertEqual(len(f.read()), model.weight.numel() * 4)
+
+            onnx_model = onnx.load(model_file)
+            initializers = {init.name: init for init in onnx_model.graph.initializer}
+            self.assertEqual(initializers["weight"].data_location, onnx.TensorProto.EXTERNAL)
+            self.assertEqual(initializers["bias"].data_location, onnx.TensorProto.DEFAULT)
+            for name, param in model.named_parameters():
+                self.assertEqual(
+                    torch.from_numpy(numpy_helper.to_array(initializers[name])),
+                    param.detach())
+
+            with self.assertRaisesRegex(ValueError, "requires f to be a file path"):
+                torch.onnx.export(model, x, io.BytesIO(), opset_version=self.opset_version,
+                                  use_external_data_format=True)
+        finally:
+            shutil.rmtree(model_dir)
+
     # NB: remove this test once DataParallel can be correctly handled
     def test_error_on_data_parallel(self):
         model = torch.nn.DataParallel(torch.nn.ReflectionPad2d((1, 2, 3, 4)))
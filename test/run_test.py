@@ -76,6 +76,9 @@ if PY33:
         'distributed/rpc/test_rpc_spawn',
         'distributed/rpc/test_dist_autograd_spawn',
         'distributed/rpc/test_dist_optimizer_spawn',
+        'distributed/rpc/test_dist_pipeline_spawn',
+        'distributed/rpc/test_rpc_socket_spawn',
+        'distributed/rpc/test_dist_autograd_socket_spawn',
     ])
 
 # skip < 3.6 b/c fstrings added in 3.6
@@ -89,6 +92,9 @@ WINDOWS_BLACKLIST = [
     'distributed/rpc/test_rpc_spawn',
     'distributed/rpc/test_dist_autograd_spawn',
     'distributed/rpc/test_dist_optimizer_spawn',
+    'distributed/rpc/test_dist_pipeline_spawn',
+    'distributed/rpc/test_rpc_socket_spawn',
+    'distributed/rpc/test_dist_autograd_socket_spawn',
 ]
 
 ROCM_BLACKLIST = [
@@ -99,6 +105,8 @@ ROCM_BLACKLIST = [
     'test_multiprocessing',
     'distributed/rpc/test_rpc_spawn',
     'distributed/rpc/test_dist_autograd_spawn',
+    'distributed/rpc/test_rpc_socket_spawn',
+    'distributed/rpc/test_dist_autograd_socket_spawn',
 ]
 
 DISTRIBUTED_TESTS_CONFIG = {}
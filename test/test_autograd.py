@@ -2,6 +2,7 @@ import contextlib
 import gc
 import sys
 import math
+import os
 import tempfile
 import time
 import unittest
@@ -257,6 +258,33 @@ class TestAutograd(TestCase):
             torch.sparse_coo_tensor(torch.tensor([[1, 1]]).long(), torch.tensor([1., 1.])),
             True)
 
+    def test_accumulate_grad_inplace_fan_in(self):
+        # gradients of a node with many uses are summed in place, but only
+        # into buffers nothing else refers to
+        held = torch.ones(5)
+
+        class ReturnsHeld(Function):
+            @staticmethod
+            def forward(ctx, x):
+                return x.clone()
+
+            @staticmethod
+            def backward(ctx, grad):
+                return held
+
+        x = torch.randn(5, requires_grad=True)
+        y = x * 2
+        out = sum(ReturnsHeld.apply(y) for _ in range(3)) + sum(y * i for i in range(4))
+        out.sum().backward()
+        self.assertEqual(held, torch.ones(5))
+        self.assertEqual(x.grad, torch.full((5,), 2 * (3 + 6)))
+
+        # sparse .grad plus a dense gradient
+        w = torch.tensor([1.5, 1.5]).requires_grad_()
+        w.grad = torch.sparse_coo_tensor(torch.tensor([[1, 1]]).long(), torch.tensor([1., 1.]))
+        (w * torch.tensor([2., 3.])).sum().backward()
+        self.assertEqual(w.grad, torch.tensor([2., 5.]))
+
     @skipIfNoLapack
     def test_slogdet_sign(self):
         a = torch.randn(3, 3, requires_grad=True)
@@ -2650,6 +2678,68 @@ class TestAutograd(TestCase):
         print(prof.table())
         print(prof.key_averages(group_by_input_shape=True).table())
 
+    def test_profiler_memory(self):
+        x = torch.randn(256, 256)
+        with profile(profile_memory=True) as prof:
+            with record_function("outer"):
+                y = x.mm(x)
+                z = y.mm(y)  # noqa: F841
+                del y
+
+        nbytes = 256 * 256 * 4
+        events = {evt.name: evt for evt in prof.function_events}
+        # mm allocates its output directly
+        self.assertGreaterEqual(events["mm"].self_cpu_memory_usage, nbytes)
+        self.assertEqual(events["mm"].self_cuda_memory_usage, 0)
+        # y is freed in outer, but both outputs were alive at some point
+        self.assertLess(events["outer"].self_cpu_memory_usage, -nbytes // 2)
+        self.assertGreaterEqual(events["outer"].cpu_peak_memory_usage, 2 * nbytes)
+
+        avg = prof.key_averages()
+        mm = [evt for evt in avg if evt.key == "mm"][0]
+        self.assertGreaterEqual(mm.self_cpu_memory_usage, 2 * nbytes)
+        self.assertGreaterEqual(mm.cpu_peak_memory_usage, nbytes)
+        self.assertIn("CPU Peak Mem", avg.table())
+
+        with profile() as prof:
+            x.mm(x)
+        self.assertEqual(prof.function_events[0].self_cpu_memory_usage, 0)
+        self.assertNotIn("CPU Peak Mem", prof.table())
+
+    def test_profiler_flops(self):
+        a = torch.randn(64, 32)
+        b = torch.randn(32, 16)
+        with profile(with_flops=True, record_hw_counters=True) as prof:
+            a.mm(b)
+            a.add(1)
+
+        events = {evt.name: evt for evt in prof.function_events}
+        self.assertEqual(events["mm"].flops, 2 * 64 * 32 * 16)
+        self.assertEqual(events["mm"].bytes, (64 * 32 + 32 * 16 + 64 * 16) * 4)
+        self.assertEqual(events["add"].flops, 64 * 32)
+        self.assertEqual(events["add"].bytes, 2 * 64 * 32 * 4)
+        self.assertGreaterEqual(events["mm"].cycles, 0)
+
+        avg = prof.key_averages()
+        self.assertEqual([evt for evt in avg if evt.key == "mm"][0].flops, 2 * 64 * 32 * 16)
+        table = avg.table(sort_by="gflops_per_s")
+        self.assertIn("GFLOP/s", table)
+        self.assertIn("IPC", table)
+
+        x = torch.randn(2, 3, 10, 10, dtype=torch.double)
+        w = torch.randn(4, 3, 3, 3, dtype=torch.double)
+        with profile(with_flops=True) as prof:
+            torch.nn.functional.conv2d(x, w, stride=2, padding=1)
+        conv = [evt for evt in prof.function_events if evt.name == "conv2d"][0]
+        # 5x5 outputs per plane, each reduced over 3 * 3 * 3 inputs
+        self.assertEqual(conv.flops, 2 * 2 * 4 * 5 * 5 * 3 * 3 * 3)
+        self.assertEqual(conv.bytes, (x.numel() + w.numel() + 2 * 4 * 5 * 5) * 8)
+
+        with profile() as prof:
+            a.mm(b)
+        self.assertEqual(prof.function_events[0].flops, 0)
+        self.assertNotIn("GFLOP/s", prof.table())
+
     def test_profiler_no_cuda(self):
         print("")
         layer = torch.nn.Linear(20, 30)
@@ -2758,6 +2848,18 @@ class TestAutograd(TestCase):
 
         self.assertTrue('my_func' in str(p))
 
+    def test_record_function_without_callbacks(self):
+        self.assertFalse(torch.autograd._has_record_function_callbacks())
+        with record_function("unobserved"):
+            pass
+        with profile() as p:
+            self.assertTrue(torch.autograd._has_record_function_callbacks())
+            with record_function("observed"):
+                pass
+        self.assertFalse(torch.autograd._has_record_function_callbacks())
+        self.assertEqual([evt.name for evt in p.function_events if evt.name in ("observed", "unobserved")],
+                         ["observed"])
+
     def test_record_function_multithreaded(self):
         rf = record_function("outer")
         rf.__enter__()
@@ -3138,6 +3240,33 @@ class TestAutograd(TestCase):
                     out.backward()
             self.assertIn('MyFunc.apply', str(w[0].message))
 
+    def test_anomaly_detect_lightweight(self):
+        class MyFunc(Function):
+            @staticmethod
+            def forward(ctx, inp, value):
+                ctx.value = value
+                return inp.clone()
+
+            @staticmethod
+            def backward(ctx, gO):
+                return gO.clone().fill_(ctx.value), None
+
+        for value, msg in [(float('nan'), 'nan'), (float('inf'), 'inf')]:
+            inp = torch.rand(10, dtype=torch.double, requires_grad=True)
+            with self.assertRaisesRegex(RuntimeError, "Function 'MyFuncBackward' returned {} values in its 0th output.".format(msg)):
+                with warnings.catch_warnings(record=True) as w:
+                    with detect_anomaly(lightweight=True):
+                        out = MyFunc.apply(inp, value)
+                        out.sum().backward()
+                self.assertIn('MyFunc.apply', str(w[0].message))
+        self.assertFalse(torch.is_anomaly_enabled())
+
+        # huge finite values are not anomalies, even if their sum overflows
+        inp = torch.rand(10, dtype=torch.double, requires_grad=True)
+        with detect_anomaly(lightweight=True):
+            for _ in range(2):
+                MyFunc.apply(inp, 1e308).sum().backward()
+
     @skipIfNoLapack
     def test_symeig_no_eigenvectors(self):
         A = torch.tensor([[1., 2.], [2., 4.]], dtype=torch.float32, requires_grad=True)
@@ -3360,6 +3489,38 @@ for shape in [(1,), ()]:
         self.assertEqual(order.count("Reentrant"), 10)
         self.assertEqual(order[-1], "MyFunction")
 
+    def test_multithreaded_cpu_engine(self):
+        import subprocess
+        env = dict(os.environ, PYTORCH_AUTOGRAD_CPU_THREADS="4")
+        subprocess.check_call([sys.executable, '-c', """\
+import torch
+from torch.utils.checkpoint import checkpoint
+
+# independent towers are evaluated by different engine threads
+w = torch.randn(16, 16, requires_grad=True)
+towers = [torch.randn(16, 16, requires_grad=True) for _ in range(8)]
+def loss():
+    return sum((w.mm(t).tanh().mm(t)).sum() for t in towers)
+loss().backward()
+expected = [w.grad.clone()] + [t.grad.clone() for t in towers]
+
+w.grad = None
+for t in towers:
+    t.grad = None
+for _ in range(2):
+    loss().backward()
+grads = [w.grad] + [t.grad for t in towers]
+for g, e in zip(grads, expected):
+    assert torch.allclose(g, 2 * e), (g, e)
+
+# reentrant backward on a CPU engine thread
+x = torch.randn(8, 8, requires_grad=True)
+out = sum(checkpoint(lambda y: y.exp().sin(), x * i).sum() for i in range(4))
+out.backward()
+ref = sum((x.detach() * i).exp().cos() * (x.detach() * i).exp() * i for i in range(4))
+assert torch.allclose(x.grad, ref), (x.grad, ref)
+"""], env=env)
+
     @slowTest
     def test_checkpointing(self):
         num_inp = 2000
@@ -4335,6 +4496,8 @@ class TestAutogradDeviceType(TestCase):
         with torch.cuda.profiler.profile():
             with emit_nvtx():
                 a.add(1.0)
+            with emit_nvtx(names_only=True):
+                a.add(1.0)
 
     @onlyCUDA
     def test_rnn_backward_to_input_but_not_parameters(self, device):
@@ -278,6 +278,46 @@ class TestCuda(TestCase):
         for _ in self._test_memory_stats_generator(self):
             self._check_memory_stat_consistency()
 
+    def test_memory_snapshot_streams(self):
+        torch.cuda.empty_cache()
+        stream = torch.cuda.Stream()
+        with torch.cuda.stream(stream):
+            x = torch.cuda.FloatTensor(1024)
+        stream.synchronize()
+
+        segments = [s for s in torch.cuda.memory_snapshot() if s["stream"] == stream.cuda_stream]
+        self.assertEqual(len(segments), 1)
+        for block in segments[0]["blocks"]:
+            self.assertEqual(block["stream"], stream.cuda_stream)
+        del x
+
+        flushes = torch.cuda.memory_stats()["num_cache_flushes"]
+        torch.cuda.empty_cache()
+        self.assertEqual(torch.cuda.memory_stats()["num_cache_flushes"], flushes + 1)
+        torch.cuda.reset_accumulated_memory_stats()
+        self.assertEqual(torch.cuda.memory_stats()["num_cache_flushes"], 0)
+
+    @skipIfRocm
+    def test_memory_expandable_segments(self):
+        import subprocess
+        env = dict(os.environ, PYTORCH_CUDA_EXPANDABLE_SEGMENTS="1")
+        subprocess.check_call([sys.executable, '-c', """\
+import torch
+
+# growing requests of slightly different sizes all land in one segment
+xs = [torch.empty(int((16 + i) * 2 ** 20), dtype=torch.uint8, device='cuda') for i in range(8)]
+del xs[::2]
+y = torch.empty(40 * 2 ** 20, dtype=torch.uint8, device='cuda')
+large = [s for s in torch.cuda.memory_snapshot() if s["segment_type"] == "large"]
+assert len(large) == 1, large
+assert large[0]["is_expandable"]
+assert sum(b["size"] for b in large[0]["blocks"]) == large[0]["total_size"]
+
+del xs, y
+torch.cuda.empty_cache()
+assert torch.cuda.memory_reserved() == 0, torch.cuda.memory_reserved()
+"""], env=env)
+
     def test_cuda_get_device_name(self):
         # Testing the behaviour with None as an argument
         current_device = torch.cuda.current_device()
@@ -1468,6 +1508,34 @@ class TestCuda(TestCase):
         self.assertNotEqual(t.data_ptr(), ptr, 'allocation re-used too soon')
         self.assertEqual(list(gpu_tensor), [1])
 
+    def test_caching_pinned_memory_reserve(self):
+        size = 12345 * 4
+        torch.cuda.reserve_host_memory(size, count=2)
+        stats = torch.cuda.host_memory_stats()
+        self.assertGreaterEqual(stats["reserved_bytes"], 2 * size)
+
+        # reserved blocks serve later allocations without cudaHostAlloc
+        t1 = torch.empty(12345, dtype=torch.float).pin_memory()
+        t2 = torch.empty(12000, dtype=torch.float).pin_memory()
+        after = torch.cuda.host_memory_stats()
+        self.assertEqual(after["num_misses"], stats["num_misses"])
+        self.assertEqual(after["num_hits"], stats["num_hits"] + 2)
+        self.assertGreaterEqual(after["allocated_bytes"], stats["allocated_bytes"] + 2 * size)
+
+        # events tracking copies are reused across iterations
+        gpu_tensor = torch.cuda.FloatTensor(12345)
+        gpu_tensor.copy_(t1, non_blocking=True)
+        del t1
+        torch.cuda.synchronize()
+        t1 = torch.empty(12345, dtype=torch.float).pin_memory()
+        created = torch.cuda.host_memory_stats()["num_events_created"]
+        for _ in range(3):
+            gpu_tensor.copy_(t1, non_blocking=True)
+            del t1
+            torch.cuda.synchronize()
+            t1 = torch.empty(12345, dtype=torch.float).pin_memory()
+        self.assertEqual(torch.cuda.host_memory_stats()["num_events_created"], created)
+
     @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
     def test_caching_pinned_memory_multi_gpu(self):
         # checks that the events preventing pinned memory from being re-used
@@ -1960,6 +2028,55 @@ class TestCuda(TestCase):
         self.assertTrue(a.grad.sum().item() == 4 * size)
         self.assertTrue(b.grad.sum().item() == 4 * size)
 
+    def test_autocast(self):
+        import torch.cuda.amp
+        a = torch.randn(8, 8, device='cuda')
+        w = torch.randn(8, 8, device='cuda', requires_grad=True)
+        with torch.cuda.amp.autocast():
+            self.assertTrue(torch.is_autocast_enabled())
+            out = torch.mm(a, w)
+            self.assertEqual(out.dtype, torch.half)
+            # ops without an autocast kernel keep the dtype of their inputs
+            self.assertEqual((out + 1).dtype, torch.half)
+            self.assertEqual(torch.softmax(out, 1).dtype, torch.float)
+            self.assertEqual(torch.nn.functional.mse_loss(out, a).dtype, torch.float)
+            # double is never cast
+            self.assertEqual(torch.mm(a.double(), a.double()).dtype, torch.double)
+            with torch.cuda.amp.autocast(enabled=False):
+                self.assertEqual(torch.mm(a, a).dtype, torch.float)
+
+            # the cast of a weight is cached and differentiable
+            out2 = torch.mm(a, w)
+            self.assertEqual(out, out2)
+            (out.float().sum() + out2.float().sum()).backward()
+        self.assertFalse(torch.is_autocast_enabled())
+        self.assertEqual(w.grad.dtype, torch.float)
+        self.assertEqual(w.grad, 2 * a.t().mm(torch.ones(8, 8, device='cuda')), prec=1e-2)
+        self.assertEqual(torch.mm(a, w).dtype, torch.float)
+
+        # in-place updates of a weight invalidate its cached cast
+        with torch.cuda.amp.autocast():
+            before = torch.mm(a, w)
+            with torch.no_grad():
+                w.add_(1)
+            after = torch.mm(a, w)
+        self.assertEqual(after.float(), torch.mm(a, w.detach()), prec=1e-1)
+        self.assertNotEqual(before, after)
+
+        # a weight freed inside the region doesn't hand its cached cast to a
+        # new weight that reuses its TensorImpl
+        with torch.cuda.amp.autocast():
+            for size in (8, 4, 8, 4):
+                w = torch.randn(8, size, device='cuda', requires_grad=True)
+                out = torch.mm(a, w)
+                self.assertEqual(out.size(), (8, size))
+                self.assertEqual(out.float(), torch.mm(a, w.detach()), prec=1e-1)
+                del w, out
+
+        with torch.cuda.amp.autocast(dtype=torch.bfloat16):
+            self.assertEqual(torch.get_autocast_dtype(), torch.bfloat16)
+        self.assertEqual(torch.get_autocast_dtype(), torch.half)
+
     @unittest.skipIf(not TEST_MULTIGPU, "only one GPU detected")
     def test_cuda_init_race(self):
         # See https://github.com/pytorch/pytorch/issues/16559
@@ -1127,6 +1127,36 @@ class TestDataLoader(TestCase):
                 self.assertEqual(
                     reference, list(DataLoader(ds_cls(counting_ds_n), multiprocessing_context=ctx, **dl_common_args)))
 
+    @unittest.skipIf(IS_WINDOWS, "ring buffers are not supported on Windows")
+    def test_ring_buffer(self):
+        reference = list(DataLoader(self.dataset, batch_size=4))
+        # 1 MiB holds many batches, 64 bytes none of them (the batches fall
+        # back to the queue)
+        for ring_buffer_size in [1 << 20, 64]:
+            loader = DataLoader(self.dataset, batch_size=4, num_workers=2,
+                                ring_buffer_size=ring_buffer_size)
+            batches = list(loader)
+            self.assertEqual(len(batches), len(reference))
+            for (data, labels), (ref_data, ref_labels) in zip(batches, reference):
+                self.assertEqual(data, ref_data)
+                self.assertEqual(labels, ref_labels)
+
+        # held batches keep their memory, and freed ones are reused
+        ring = torch._C._ShmRingBuffer.create(1000)
+        self.assertEqual(ring.capacity, 1024)
+        first = ring.allocate(600)
+        self.assertEqual(first, (0, 640, 0))
+        self.assertIsNone(ring.allocate(600))
+        src = torch.randn(10, 15)
+        ring.write(first[2], src)
+        tensors = ring.take(first[0], first[1], [(first[2], src.dtype, list(src.size()))])
+        self.assertEqual(tensors[0], src)
+        self.assertEqual(ring.used(), 640)
+        del tensors
+        self.assertEqual(ring.used(), 0)
+        # does not fit before the end of the buffer, so it starts at 0
+        self.assertEqual(ring.allocate(600), (640, 1664, 0))
+
     def test_worker_seed(self):
         num_workers = 6
         batch_size = 1
@@ -10,6 +10,7 @@ from torch.testing._internal.common_utils import run_tests, TestCase
 from torch.quantization import FakeQuantize
 from torch.quantization import default_observer, default_per_channel_weight_observer
 import io
+import itertools
 import unittest
 
 # Reference method for fake quantize
@@ -105,6 +106,51 @@ class TestFakeQuantizePerTensor(TestCase):
         Y_prime.backward(dout)
         np.testing.assert_allclose(dX.cpu(), X.grad.cpu().detach().numpy(), rtol=tolerance, atol=tolerance)
 
+    @given(device=st.sampled_from(['cpu', 'cuda'] if torch.cuda.is_available() else ['cpu']),
+           X=hu.tensor(shapes=hu.array_shapes(1, 5,),
+                       qparams=hu.qparams(dtypes=torch.quint8)))
+    def test_forward_backward_per_tensor_cachemask(self, device, X):
+        r"""Tests the forward and backward of the cachemask variant against the
+        reference and the separate backward op.
+        """
+        np.random.seed(NP_RANDOM_SEED)
+        X, (scale, zero_point, torch_type) = X
+        quant_min = torch.iinfo(torch_type).min
+        quant_max = torch.iinfo(torch_type).max
+
+        X = to_tensor(X, device)
+        X.requires_grad_()
+        Y = _fake_quantize_per_tensor_affine_reference(X.detach().cpu(), scale, zero_point, quant_min, quant_max)
+        Y_prime, mask = torch._fake_quantize_per_tensor_affine_cachemask(
+            X, scale, zero_point, quant_min, quant_max)
+        np.testing.assert_allclose(Y, Y_prime.detach().cpu(), rtol=tolerance, atol=tolerance)
+        self.assertEqual(mask.dtype, torch.bool)
+        self.assertFalse(mask.requires_grad)
+
+        dout = torch.rand(X.shape, dtype=torch.float).to(device)
+        Y_prime.backward(dout)
+        dX = torch.fake_quantize_per_tensor_affine_backward(
+            dout, X.detach(), scale, zero_point, quant_min, quant_max)
+        np.testing.assert_allclose(dX.cpu(), X.grad.cpu().detach().numpy(), rtol=tolerance, atol=tolerance)
+
+    def test_per_tensor_vectorized_tail(self):
+        r"""Checks that lengths which are not a multiple of the vector width
+        and strided inputs agree with the reference.
+        """
+        scale, zero_point, quant_min, quant_max = 0.1, 3, 0, 255
+        devices = ['cpu', 'cuda'] if torch.cuda.is_available() else ['cpu']
+        for device, n in itertools.product(devices, [1, 7, 8, 9, 31, 33]):
+            X = torch.randn(n, 2, device=device) * 20
+            for x in [X, X.t()]:
+                Y = _fake_quantize_per_tensor_affine_reference(x.cpu(), scale, zero_point, quant_min, quant_max)
+                Y_prime = torch.fake_quantize_per_tensor_affine(x, scale, zero_point, quant_min, quant_max)
+                Y_cached, mask = torch._fake_quantize_per_tensor_affine_cachemask(
+                    x, scale, zero_point, quant_min, quant_max)
+                np.testing.assert_allclose(Y, Y_prime.cpu(), rtol=tolerance, atol=tolerance)
+                np.testing.assert_allclose(Y, Y_cached.cpu(), rtol=tolerance, atol=tolerance)
+                xq = torch.round(x.cpu() * (1.0 / scale) + zero_point)
+                self.assertEqual(mask.cpu(), (xq >= quant_min) & (xq <= quant_max))
+
     @given(device=st.sampled_from(['cpu', 'cuda'] if torch.cuda.is_available() else ['cpu']),
            X=hu.tensor(shapes=hu.array_shapes(1, 5,),
                        qparams=hu.qparams(dtypes=torch.quint8)))
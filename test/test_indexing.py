@@ -36,6 +36,34 @@ class TestIndexing(TestCase):
         self.assertEqual(v[0].tolist(), [0, 3, 0, 4])
         self.assertEqual(v[1:].sum(), 0)
 
+    def test_int_and_slice_views(self, device):
+        v = torch.arange(120, device=device).view(4, 5, 6).transpose(0, 2)[1:]
+        for index in [(1, 2), (slice(None), 3), (-1, slice(1, 4, 2)), (slice(1, -1), -2, slice(None, None, 5)),
+                      (slice(-100, 100), slice(3, 1)), (0, 4, 3)]:
+            result = v[index]
+            # A trailing ellipsis makes indexing take one select or slice per
+            # element of the index instead of a single view.
+            expected = v[index + (Ellipsis,)]
+            self.assertEqual(result, expected)
+            self.assertEqual(result.size(), expected.size())
+            self.assertEqual(result.stride(), expected.stride())
+            self.assertEqual(result.storage_offset(), expected.storage_offset())
+
+        # The result is a view, also for autograd.
+        w = torch.zeros(3, 4, device=device)
+        view = w[1, 1:3]
+        view.add_(1)
+        self.assertEqual(w.sum(), 2)
+        self.assertEqual(w._version, view._version)
+        w[2, ::3] = torch.tensor([5., 6.], device=device)
+        self.assertEqual(w[2].tolist(), [5, 0, 0, 6])
+
+        x = torch.randn(3, 4, device=device, requires_grad=True)
+        x[1, 1:3].sum().backward()
+        grad = torch.zeros(3, 4, device=device)
+        grad[1, 1:3] = 1
+        self.assertEqual(x.grad, grad)
+
     def test_bool_indices(self, device):
         v = torch.randn(5, 7, 3, device=device)
         boolIndices = torch.tensor([True, False, True, True, False], dtype=torch.bool, device=device)
@@ -115,6 +143,26 @@ class TestIndexing(TestCase):
         res = src.index_put_(indices, vals, accumulate=True)
         self.assertEqual(res.shape, src.shape)
 
+    @dtypes(torch.float, torch.double, torch.long)
+    @dtypesIfCUDA(torch.half, torch.float, torch.double, torch.long)
+    def test_index_put_accumulate_duplicates(self, device, dtype):
+        # many duplicates, with and without slices after and before the index
+        src = torch.zeros(50, 3, 7, device=device, dtype=dtype)
+        idx = torch.randint(0, 7, (2000,), device=device)
+        vals = torch.randint(0, 4, (50, 3, 2000), device=device).to(dtype)
+        expected = torch.zeros(50, 3, 7, dtype=torch.double)
+        expected.index_add_(2, idx.cpu(), vals.cpu().double())
+        old_deterministic = torch.is_deterministic()
+        try:
+            for deterministic in (False, True):
+                torch.set_deterministic(deterministic)
+                res = src.clone().index_put_((slice(None), slice(None), idx), vals, accumulate=True)
+                self.assertEqual(res.cpu().double(), expected)
+                res = src.clone().permute(2, 0, 1).index_put_((idx,), vals.permute(2, 0, 1), accumulate=True)
+                self.assertEqual(res.permute(1, 2, 0).cpu().double(), expected)
+        finally:
+            torch.set_deterministic(old_deterministic)
+
     @dtypes(torch.float, torch.bfloat16, torch.long, torch.bool)
     @dtypesIfCPU(torch.float, torch.long, torch.bfloat16, torch.bool)
     @dtypesIfCUDA(torch.half, torch.long, torch.bfloat16, torch.bool)
@@ -62,7 +62,7 @@ from torch.testing._internal.common_utils import run_tests, IS_WINDOWS, TEST_WIT
     freeze_rng_state, set_rng_seed, slowTest, TemporaryFileName, skipIfCompiledWithoutNumpy, \
     enable_profiling_mode
 from torch.testing._internal.jit_utils import JitTestCase, enable_cpu_fuser, disable_autodiff_subgraph_inlining, \
-    _trace, enable_cpu_fuser_if, do_input_map, \
+    _trace, enable_cpu_fuser_if, use_compiled_cpu_fuser, do_input_map, \
     execWrapper, _inline_everything, _tmp_donotuse_dont_inline_everything, \
     get_forward, get_forward_graph, get_module_method, \
     RUN_CUDA, RUN_CUDA_MULTI_GPU
@@ -386,6 +386,33 @@ class TestJit(JitTestCase):
         t2 = torch.rand(3, 4)
         self.assertEqual(r(t2), m.x + t2)
 
+    def test_trace_repeated_layers(self):
+        # the layers run from the same Python stack share their source ranges,
+        # and the temporaries freed during the trace must not be confused with
+        # the tensors allocated after them
+        class M(nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.layers = nn.ModuleList([nn.Linear(4, 4) for _ in range(20)])
+
+            def forward(self, x):
+                for layer in self.layers:
+                    x = torch.relu(layer(x) * 2 + 1)
+                return x
+
+        m = M()
+        x = torch.rand(3, 4)
+        traced = torch.jit.trace(m, x)
+        self.assertEqual(traced(x), m(x))
+        self.assertEqual(len(traced.graph.findAllNodes("aten::relu")), 20)
+
+        def fn(x):
+            for _ in range(100):
+                x = x * 2 + 1
+            return x
+
+        self.checkTrace(fn, (torch.rand(3),))
+
     def test_constants_pkl(self):
         # This test asserts that the serialization archive includes a `constants.pkl`
         # file. This file is used by `torch.load` to determine whether a zip file
@@ -525,6 +552,28 @@ class TestJit(JitTestCase):
         self.assertTrue(m2.b0.is_shared())
         self.assertEqual(m2.b0.storage().data_ptr(), m2.p0.storage().data_ptr())
 
+    @unittest.skipIf(not RUN_CUDA, "restore device requires CUDA")
+    def test_save_mixed_devices_on_side_stream(self):
+        class Foo(torch.jit.ScriptModule):
+            def __init__(self):
+                super(Foo, self).__init__()
+                self.p0 = nn.Parameter(torch.randn(128, 64, device='cuda'))
+                self.register_buffer('b0', torch.randn(7))
+                self.p1 = nn.Parameter(torch.randn(3, 5, device='cuda'))
+                self.register_buffer('b1', torch.randn(4, dtype=torch.double, device='cuda'))
+
+        m = Foo()
+        # storages are copied to the host on the streams current at save time
+        stream = torch.cuda.Stream()
+        with torch.cuda.stream(stream):
+            with torch.no_grad():
+                m.p0.mul_(2)
+            m2 = self.getExportImportCopy(m)
+        self.assertEqual(tuple(m.parameters()), tuple(m2.parameters()))
+        self.assertEqual(tuple(m.buffers()), tuple(m2.buffers()))
+        self.assertTrue(m2.p1.is_cuda)
+        self.assertFalse(m2.b0.is_cuda)
+
     def test_typeas_trace_check(self):
         a = torch.tensor([0.4], requires_grad=True)
         b = torch.tensor([0.7], requires_grad=True)
@@ -1421,6 +1470,30 @@ graph(%packed_params_module, %a, %a_scale, %a_zero_point, %a_dtype,
         %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
         %r_dequant = aten::dequantize(%r_quant)
         return (%r_dequant)""",
+            # aten::conv2d - aten::add_ - aten::relu --> quantized::conv2d_add_relu
+            """
+graph(%packed_params_module, %a, %a_scale, %a_zero_point, %a_dtype,
+%r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups,
+%accum_quant, %out_scale, %out_zero_point, %out_dtype):
+        %a_quant = aten::quantize_per_tensor(%a, %a_scale, %a_zero_point, %a_dtype)
+        %a_dequant = aten::dequantize(%a_quant)
+        %packed_params = prim::GetAttr[name="_packed_params"](%packed_params_module)
+        %w_quant : Tensor, %b : Tensor? = quantized::conv2d_unpack(%packed_params)
+        %w_dequant = aten::dequantize(%w_quant)
+        # CHECK: quantized::conv2d_add_relu
+        # CHECK-NOT: aten::conv2d
+        # CHECK-NOT: aten::add_
+        # CHECK-NOT: aten::relu
+        %r = aten::conv2d(%a_dequant, %w_dequant, %b, %stride, %padding, %dilation, %groups)
+        %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
+        %r_dequant = aten::dequantize(%r_quant)
+        %accum_dequant = aten::dequantize(%accum_quant)
+        %alpha = prim::Constant[value=1]()
+        %sum = aten::add_(%r_dequant, %accum_dequant, %alpha)
+        %sum_relu = aten::relu(%sum)
+        %out_quant = aten::quantize_per_tensor(%sum_relu, %out_scale, %out_zero_point, %out_dtype)
+        %out_dequant = aten::dequantize(%out_quant)
+        return (%out_dequant)""",
             # addmm -> quantized::linear
             """
 graph(%packed_params_module, %a, %a_scale, %a_zero_point, %a_dtype, %r_scale, %r_zero_point, %r_dtype, %4):
@@ -1610,6 +1683,141 @@ graph(%input, %weight):
             torch._C._jit_pass_fuse_linear(graph)
             FileCheck().run(input_str, graph)
 
+    def test_fuse_dropout_add_layer_norm(self):
+        input_strs = ["""
+graph(%input, %residual, %p, %train, %shape, %weight, %bias, %eps, %cudnn):
+    # CHECK-NOT: aten::dropout(
+    # CHECK-NOT: aten::add
+    # CHECK: aten::dropout_add_layer_norm
+    %alpha : int = prim::Constant[value=1]()
+    %dropped = aten::dropout(%input, %p, %train)
+    %sum = aten::add(%dropped, %residual, %alpha)
+    %res = aten::layer_norm(%sum, %shape, %weight, %bias, %eps, %cudnn)
+    return (%res)""", """
+graph(%input, %residual, %p, %train, %shape, %weight, %bias, %eps, %cudnn):
+    # CHECK-NOT: aten::dropout(
+    # CHECK-NOT: aten::add
+    # CHECK: aten::dropout_add_layer_norm
+    %alpha : int = prim::Constant[value=1]()
+    %dropped = aten::dropout(%input, %p, %train)
+    %sum = aten::add(%residual, %dropped, %alpha)
+    %res = aten::layer_norm(%sum, %shape, %weight, %bias, %eps, %cudnn)
+    return (%res)""", """
+graph(%input, %residual, %p, %train, %shape, %weight, %bias, %eps, %cudnn):
+    # CHECK: aten::dropout(
+    # CHECK: aten::add
+    # CHECK-NOT: aten::dropout_add_layer_norm
+    %alpha : int = prim::Constant[value=2]()
+    %dropped = aten::dropout(%input, %p, %train)
+    %sum = aten::add(%dropped, %residual, %alpha)
+    %res = aten::layer_norm(%sum, %shape, %weight, %bias, %eps, %cudnn)
+    return (%res)"""]
+        for input_str in input_strs:
+            graph = parse_ir(input_str)
+            torch._C._jit_pass_fuse_dropout_add_layer_norm(graph)
+            FileCheck().run(input_str, graph)
+
+    def test_freeze_module(self):
+        class Sub(torch.nn.Module):
+            def __init__(self):
+                super(Sub, self).__init__()
+                self.fc = torch.nn.Linear(4, 3)
+                self.scale = 2.0
+
+            def forward(self, x):
+                return self.fc(x) * self.scale
+
+        class M(torch.nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.sub = Sub()
+                self.register_buffer('offset', torch.ones(3))
+                self.calls = 0
+
+            def forward(self, x):
+                self.calls += 1
+                y = self.sub(x) + self.offset
+                if self.training:
+                    y = y * 0
+                return y
+
+        m = torch.jit.script(M().eval())
+        frozen = wrap_cpp_module(torch._C._jit_pass_freeze_module(m._c))
+        x = torch.randn(2, 4)
+        self.assertEqual(frozen(x), m(x))
+        # only the reassigned attribute is still read from self
+        FileCheck().check_count('prim::GetAttr[name="calls"]', 1, exactly=True) \
+                   .check_not("prim::If").run(frozen.graph)
+        FileCheck().check_count("prim::GetAttr", 1, exactly=True).run(frozen.graph)
+        FileCheck().check_not("prim::CallMethod").run(frozen.graph)
+        # the original module is left alone
+        FileCheck().check("prim::CallMethod").run(m.graph)
+
+    def test_static_runtime(self):
+        def fn(x, w, b):
+            h = torch.addmm(b, x, w)
+            a = torch.relu(h)
+            c = torch.sigmoid(a) * torch.tanh(h)
+            return (c + a).sum(), c - 1
+
+        scripted = torch.jit.script(fn)
+        runtime = torch._C.StaticRuntime(scripted.graph)
+        self.assertEqual(runtime.num_planned_values, 0)
+        for shape in [(4, 8), (4, 8), (3, 8), (3, 8)]:
+            inputs = (torch.randn(shape), torch.randn(8, 5), torch.randn(5))
+            out = runtime.run(list(inputs))
+            self.assertEqual(out, fn(*inputs))
+            # intermediates are planned, both outputs are not
+            self.assertGreater(runtime.num_planned_values, 0)
+            self.assertGreater(runtime.arena_bytes, 0)
+
+        # outputs of an earlier run are not overwritten by the arena
+        inputs = (torch.randn(3, 8), torch.randn(8, 5), torch.randn(5))
+        first = runtime.run(list(inputs))
+        runtime.run([torch.randn(3, 8), torch.randn(8, 5), torch.randn(5)])
+        self.assertEqual(first, fn(*inputs))
+
+    def test_static_runtime_module(self):
+        class M(torch.nn.Module):
+            def __init__(self):
+                super(M, self).__init__()
+                self.fc1 = torch.nn.Linear(6, 10)
+                self.fc2 = torch.nn.Linear(10, 4)
+
+            def forward(self, x):
+                return self.fc2(torch.relu(self.fc1(x)) * 2)
+
+        m = M().eval()
+        runtime = torch._C.StaticRuntime(torch.jit.script(m)._c)
+        with torch.no_grad():
+            for _ in range(2):
+                x = torch.randn(5, 6)
+                self.assertEqual(runtime.run([x]), m(x))
+
+    def test_insert_mkldnn_layout_conversions(self):
+        input_str = """
+graph(%input, %weight, %bias, %residual, %stride, %padding, %dilation, %groups):
+    # CHECK: aten::to_mkldnn(%input)
+    # CHECK: aten::conv2d
+    # CHECK: aten::relu
+    # CHECK: aten::to_mkldnn(%residual)
+    # CHECK: aten::add
+    # CHECK: aten::to_dense
+    # CHECK: aten::tanh
+    # CHECK: aten::to_dense
+    # CHECK: return
+    %alpha : int = prim::Constant[value=1]()
+    %conv = aten::conv2d(%input, %weight, %bias, %stride, %padding, %dilation, %groups)
+    %relu = aten::relu(%conv)
+    %sum = aten::add(%relu, %residual, %alpha)
+    %res = aten::tanh(%sum)
+    return (%res, %sum)"""
+        graph = parse_ir(input_str)
+        torch._C._jit_pass_insert_mkldnn_layout_conversions(graph)
+        FileCheck().run(input_str, graph)
+        FileCheck().check_count("aten::to_mkldnn", 2, exactly=True) \
+                   .check_count("aten::to_dense", 2, exactly=True).run(str(graph))
+
     @_tmp_donotuse_dont_inline_everything
     def test_fold_quantize(self):
         class M(torch.nn.Module):
@@ -3848,6 +4056,36 @@ graph(%Ra, %Rb):
         out = torch.jit.trace(fn, (torch.ones(2, 2),))
         check(out)
 
+    @unittest.skipIf(IS_WINDOWS, "mapped files cannot be removed on Windows")
+    def test_load_mmap(self):
+        class M(torch.jit.ScriptModule):
+            def __init__(self):
+                super(M, self).__init__()
+                self.weight = torch.nn.Parameter(torch.randn(4, 3))
+                self.register_buffer('bias', torch.randn(3, dtype=torch.double))
+
+            @torch.jit.script_method
+            def forward(self, x):
+                return torch.mm(x, self.weight) + self.bias.float() + torch.ones(3)
+
+        m = M()
+        x = torch.randn(2, 4)
+        with TemporaryFileName() as fname:
+            m.save(fname)
+            loaded = torch.jit.load(fname, mmap=True)
+            self.assertEqual(loaded.weight, m.weight)
+            self.assertEqual(loaded.bias, m.bias)
+            self.assertEqual(loaded(x), m(x))
+            # the mapping is copy-on-write
+            with torch.no_grad():
+                loaded.weight.add_(1)
+            self.assertEqual(torch.jit.load(fname).weight, m.weight)
+            with open(fname, 'rb') as f:
+                with self.assertRaisesRegex(ValueError, "requires a file name"):
+                    torch.jit.load(f, mmap=True)
+        # tensors outlive the file
+        self.assertEqual(loaded.weight, m.weight + 1)
+
     @unittest.skipIf(IS_WINDOWS or True, "TODO: need to fix this test case for "
                                          "Windows, re-enable with https://github.com/pytorch/pytorch/pull/29339")
     def test_torch_load_error(self):
@@ -3955,6 +4193,27 @@ graph(%Ra, %Rb):
         except subprocess.CalledProcessError as e:
             raise RuntimeError("Could not 'import torch' with PYTORCH_JIT=0")
 
+    def test_jit_log_times_passes(self):
+        import subprocess
+        env = os.environ.copy()
+        env['PYTORCH_JIT_LOG_LEVEL'] = 'graph_executor:profiling_graph_executor_impl'
+        code = dedent("""
+        import torch
+
+        @torch.jit.script
+        def fn(x):
+            return x * 2 + 1
+
+        for _ in range(3):
+            fn(torch.ones(2))
+        """)
+        proc = subprocess.Popen([sys.executable, '-c', code], env=env,
+                                stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        _, stderr = proc.communicate()
+        self.assertEqual(proc.returncode, 0, stderr.decode())
+        self.assertRegex(stderr.decode(),
+                         r'EliminateDeadCode\(.*\) took [0-9.e+-]+ ms')
+
     def test_print_op_module(self):
         # Issue #19351: python2 and python3 go through different paths.
         # python2 returns '<module 'torch.ops' (built-in)>'
@@ -4081,6 +4340,38 @@ class TestScript(JitTestCase):
             f(2)
             f(1)
 
+    @unittest.skipIf(GRAPH_EXECUTOR != ProfilingMode.PROFILING, "needs the profiling executor")
+    def test_specialization_cache(self):
+        with enable_profiling_mode():
+            def f(x):
+                return x * 2 + 1
+
+            def run(fn, shapes):
+                for shape in shapes:
+                    x = torch.rand(shape)
+                    for _ in range(2):
+                        self.assertEqual(fn(x), x * 2 + 1)
+                return fn.get_debug_state()
+
+            old_cache_size = torch._C._jit_set_specialization_cache_size(2)
+            try:
+                state = run(torch.jit.script(f), [(2, 3), (4, 3), (2, 3), (5, 3)])
+                self.assertEqual(state.specialization_cache_size, 2)
+                self.assertEqual(state.specialization_cache_misses, 3)
+                self.assertEqual(state.specialization_cache_hits, 5)
+                self.assertEqual(state.specialization_cache_evictions, 1)
+
+                # one specialization serves all batch sizes
+                old_batch_mode = torch._C._jit_set_symbolic_batch_mode(True)
+                try:
+                    state = run(torch.jit.script(f), [(2, 3), (4, 3), (5, 3)])
+                    self.assertEqual(state.specialization_cache_size, 1)
+                    self.assertEqual(state.specialization_cache_misses, 1)
+                finally:
+                    torch._C._jit_set_symbolic_batch_mode(old_batch_mode)
+            finally:
+                torch._C._jit_set_specialization_cache_size(old_cache_size)
+
     def test_bailout_loop_carried_deps_name_clash(self):
         with enable_profiling_mode():
             NUM_ITERATIONS = 10
@@ -4618,6 +4909,43 @@ def foo(x):
                 o2 = cu.f()
             self.assertEqual(o1, o2)
 
+    def test_interpreter_superinstructions(self):
+        code = dedent('''
+            def f(x, y, n: int):
+                z = x + y
+                for i in range(n):
+                    if i % 2 == 0:
+                        z = z * x + i
+                    else:
+                        z = torch.tanh(z) - y
+                while n > 0:
+                    n -= 1
+                    z = z + n
+                return z, x * y
+
+            def g(x, n: int):
+                if n > 2:
+                    x = x + 1
+                assert n < 5, "n is too large"
+                return x - n
+        ''')
+        x = torch.randn(3, 4)
+        y = torch.randn(3, 4)
+        results = []
+        for enabled in (False, True):
+            old_state = torch._C._jit_set_interpreter_superinstructions(enabled)
+            try:
+                # Code is emitted on the first call, so each setting gets a
+                # fresh compilation unit.
+                cu = torch.jit.CompilationUnit(code)
+                results.append([cu.f(x, y, n) for n in range(5)] +
+                               [cu.g(x, n) for n in range(5)])
+                with self.assertRaisesRegex(Exception, "n is too large"):
+                    cu.g(x, 5)
+            finally:
+                torch._C._jit_set_interpreter_superinstructions(old_state)
+        self.assertEqual(results[0], results[1])
+
     def test_cpp_module_iterator(self):
         a = nn.Module()
         a.name = 'a'
@@ -6651,6 +6979,7 @@ a")
     @unittest.skipIf(RUN_CUDA, 'This tests the CPU fuser')
     @unittest.skipIf(IS_SANDCASTLE, "NYI: fuser support for Sandcastle")
     @enable_cpu_fuser
+    @use_compiled_cpu_fuser
     def test_batchnorm_fuser_cpu(self):
         code = '''
             graph(%3 : Tensor,
@@ -6681,6 +7010,7 @@ a")
     @unittest.skipIf(RUN_CUDA, 'This tests the CPU fuser')
     @unittest.skipIf(IS_SANDCASTLE, "NYI: fuser support for Sandcastle")
     @enable_cpu_fuser
+    @use_compiled_cpu_fuser
     def test_fuser_double_float_codegen(self):
         fns = ['log', 'log10', 'log1p', 'log2', 'lgamma', 'exp', 'expm1', 'erf',
                'erfc', 'cos', 'acos', 'cosh', 'sin', 'asin', 'sinh', 'tan',
@@ -6735,6 +7065,7 @@ a")
     @unittest.skipIf(RUN_CUDA, 'This tests the CPU fuser')
     @unittest.skipIf(IS_SANDCASTLE, "NYI: fuser support for Sandcastle")
     @enable_cpu_fuser
+    @use_compiled_cpu_fuser
     def test_fuser_double_literal_precision(self):
         code = '''
         graph(%2 : Float(*, *)):
@@ -12259,6 +12590,31 @@ a")
             self.assertEqual(torch.autograd.grad(sout.sum(), inputs),
                              torch.autograd.grad(out.sum(), inputs))
 
+    def test_mm_batching_independent(self):
+        def heads(x0, x1, x2, x3, w0, w1, w2, w3, b0, b1, b2, b3):
+            m0 = torch.mm(x0, w0)
+            m1 = torch.mm(x1, w1)
+            m2 = torch.mm(x2, w2)
+            m3 = torch.mm(x3, w3)
+            a0 = torch.addmm(b0, x0, w0)
+            a1 = torch.addmm(b1, x0, w1)
+            a2 = torch.addmm(b2, x0, w2)
+            a3 = torch.addmm(b3, x0, w3)
+            return m0, m1, m2, m3, a0, a1, a2, a3
+
+        scripted = torch.jit.script(heads)
+        self.run_pass('batch_mm', scripted.graph)
+        FileCheck().check_count("prim::MMBatchIndependent", 2, exactly=True) \
+            .check_not("aten::mm").check_not("aten::addmm").run(scripted.graph)
+
+        # small products are batched, large ones and ones with different
+        # shapes are computed one by one
+        for n, shapes_differ in [(4, False), (128, False), (4, True)]:
+            xs = [torch.randn(n, n) for _ in range(4)]
+            ws = [torch.randn(n, n + i if shapes_differ else n) for i in range(4)]
+            bs = [torch.randn(n + i if shapes_differ else n) for i in range(4)]
+            self.assertEqual(scripted(*(xs + ws + bs)), heads(*(xs + ws + bs)))
+
     def test_loop_unrolling(self):
         def fn(x):
             y = 0
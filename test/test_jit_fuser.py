@@ -3,6 +3,9 @@ from __future__ import division
 from __future__ import print_function
 from __future__ import unicode_literals
 
+import os
+import shutil
+import tempfile
 import unittest
 import torch
 import torch.nn as nn
@@ -16,7 +19,7 @@ from itertools import product, permutations
 
 from test_jit import JitTestCase, enable_cpu_fuser, RUN_CUDA, RUN_CUDA_HALF, RUN_CUDA_MULTI_GPU, \
     backward_graph, all_backward_graphs, get_lstm_inputs, get_milstm_inputs, \
-    LSTMCellC, LSTMCellF, LSTMCellS, MiLSTMCell, _inline_everything
+    LSTMCellC, LSTMCellF, LSTMCellS, MiLSTMCell, _inline_everything, use_compiled_cpu_fuser
 
 if GRAPH_EXECUTOR == ProfilingMode.PROFILING:
     torch._C._jit_set_profiling_executor(True)
@@ -82,6 +85,98 @@ class TestFuser(JitTestCase):
     def test_abs_cuda(self):
         self._test_fused_abs(device="cuda")
 
+    @unittest.skipIf(IS_SANDCASTLE, "NYI: fuser CPU support for Sandcastle")
+    @enable_cpu_fuser
+    @use_compiled_cpu_fuser
+    def test_fuser_disk_cache_cpu(self):
+        def f(x, y):
+            return (x * y + x).sigmoid()
+
+        x = torch.randn(4, 4)
+        y = torch.randn(4, 4)
+        old_cache_dir = torch._C._jit_fuser_get_disk_cache_dir()
+        cache_dir = tempfile.mkdtemp()
+        try:
+            torch._C._jit_fuser_set_disk_cache_dir(cache_dir)
+            ge = self.checkScript(f, (x, y))
+            self.assertAllFused(ge.graph_for(x, y))
+            entries = [name for name in os.listdir(cache_dir) if name.startswith("fused_")]
+            self.assertGreater(len(entries), 0)
+        finally:
+            torch._C._jit_fuser_set_disk_cache_dir(old_cache_dir)
+            shutil.rmtree(cache_dir)
+
+    @unittest.skipIf(IS_SANDCASTLE, "NYI: fuser CPU support for Sandcastle")
+    @enable_cpu_fuser
+    def test_vectorized_cpu_fuser(self):
+        def f(x, y, z):
+            a = torch.sigmoid(x * 2 + y) - z.tanh()
+            b = torch.clamp(a, min=0.1) * y.exp()
+            return a, torch.max(a, b) / (1 + z.abs())
+
+        # contiguous, broadcast and transposed inputs, with sizes that are not
+        # a multiple of the vector width
+        for shape in [(5, 3), (37, 129)]:
+            x = torch.randn(shape)
+            y = torch.randn(shape[1])
+            z = torch.randn(shape[::-1]).t()
+            ge = self.checkScript(f, (x, y, z))
+            self.assertAllFused(ge.graph_for(x, y, z))
+
+        graph = torch._C.parse_ir('''
+            graph(%x : Float(*, *), %y : Float(*, *)):
+                %one : int = prim::Constant[value=1]()
+                %a : Float(*, *) = aten::mul(%x, %y)
+                %b : Float(*, *) = aten::sigmoid(%a)
+                %c : Float(*, *) = aten::add(%b, %x, %one)
+                return (%c)
+        ''')
+        inputs = [torch.rand(3, 4), torch.rand(3, 4)]
+        code = torch._C._jit_fuser_get_fused_kernel_code(graph, inputs)
+        # runs in process, and %b reuses the register of %a
+        FileCheck().check("r2 = Mul(r0, r1)").check("r2 = Sigmoid(r2)") \
+            .check("Add(r2, r0, 1)").run(code)
+
+    @unittest.skipIf(IS_SANDCASTLE, "NYI: fuser CPU support for Sandcastle")
+    @enable_cpu_fuser
+    def test_reduction_codegen_cpu(self):
+        graph = torch._C.parse_ir('''
+            graph(%x : Float(*, *), %y : Float(*, *)):
+                %dim : int[] = prim::Constant[value=[-1]]()
+                %keepdim : bool = prim::Constant[value=1]()
+                %none : None = prim::Constant()
+                %a : Float(*, *) = aten::mul(%x, %y)
+                %s : Float(*, *) = aten::sum(%a, %dim, %keepdim, %none)
+                %r : Float(*, *) = aten::reciprocal(%s)
+                %b : Float(*, *) = aten::mul(%a, %r)
+                return (%b, %r)
+        ''')
+        inputs = [torch.rand(5, 7), torch.rand(5, 7)]
+        code = torch._C._jit_fuser_get_fused_kernel_code(graph, inputs)
+        # the row is reduced, the reduced values are computed and stored once,
+        # and the values they are broadcast into are stored over the row
+        FileCheck().check("IndexType rowSize").check("acc += ") \
+            .check("1.f/(").check("linearIndex = row;") \
+            .check("rowSize + col").run(code)
+
+    @unittest.skipIf(not RUN_CUDA, "fuser requires CUDA")
+    def test_reductions_cuda(self):
+        def softmax_last_dim(x):
+            e = (x * 2).exp()
+            return e / e.sum(-1, keepdim=True)
+
+        def layer_norm_stats(x, y):
+            mean = (x + y).mean(-1, keepdim=True)
+            centered = x + y - mean
+            return centered, mean
+
+        x = torch.randn(37, 129, device='cuda')
+        y = torch.randn(129, device='cuda')
+        ge = self.checkScript(softmax_last_dim, (x,))
+        self.assertAllFused(ge.graph_for(x))
+        ge = self.checkScript(layer_norm_stats, (x, y))
+        self.assertAllFused(ge.graph_for(x, y))
+
     @unittest.skipIf(not RUN_CUDA, "requires CUDA")
     def test_zero_element_tensors(self):
         def decode(sin_t, cos_t):
@@ -327,6 +422,35 @@ class TestFuser(JitTestCase):
         graph = backward_graph(s, skip_check=True)
         self.assertAllFused(graph, except_for={'aten::div', 'prim::Constant'})
 
+    @unittest.skipIf(not RUN_CUDA, "fuser requires CUDA")
+    @unittest.skipIf(GRAPH_EXECUTOR != ProfilingMode.LEGACY, "temporaries are only recomputed with complete types")
+    def test_recompute_pointwise_temporaries_cuda(self):
+        def f(x, y):
+            z = x * y
+            return z.sigmoid() * z.tanh()
+
+        x = torch.randn(4, 4, dtype=torch.float, device='cuda', requires_grad=True)
+        y = torch.randn(4, 4, dtype=torch.float, device='cuda', requires_grad=True)
+        s = self.checkScript(f, (x, y))
+        c = s(x, y)
+        warmup_backward(c.sum(), [x, y])
+
+        # z, z.sigmoid() and z.tanh() are recomputed by the backward from x
+        # and y, so the fused forward only writes out its result
+        diff_graphs = [n for n in s.graph_for(x, y).nodes() if n.kind() == 'prim::DifferentiableGraph']
+        self.assertEqual(len(diff_graphs), 1)
+        tensor_outputs = [o for o in diff_graphs[0].g('Subgraph').outputs()
+                          if isinstance(o.type(), torch._C.TensorType)]
+        self.assertEqual(len(tensor_outputs), 1)
+        self.assertAllFused(backward_graph(s), except_for={'aten::_grad_sum_to_size'})
+
+        x.grad = y.grad = None
+        f(x, y).sum().backward()
+        expected = (x.grad.clone(), y.grad.clone())
+        x.grad = y.grad = None
+        s(x, y).sum().backward()
+        self.assertEqual((x.grad, y.grad), expected)
+
     @unittest.skipIf(not RUN_CUDA, "fuser requires CUDA")
     def test_comparison_eq_ne(self):
         def f(x, y):
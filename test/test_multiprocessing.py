@@ -93,6 +93,17 @@ def sum_tensors(inq, outq):
                       tensor.numel(), tensor.storage().size()))
 
 
+def sum_and_release_tensors(inq, outq, finished):
+    tensors = inq.get()
+    outq.put(sum(tensor.sum().item() for tensor in tensors))
+    del tensors
+    # the counters are returned asynchronously on the current stream
+    torch.cuda.synchronize()
+    outq.put(None)
+    # stay alive, so that nothing is unmapped by exiting
+    finished.wait()
+
+
 def queue_get_exception(inqueue, outqueue):
     os.close(2)  # hide expected error message
     try:
@@ -351,6 +362,35 @@ class TestMultiprocessing(TestCase):
             for _ in range(TEST_REPEATS):
                 queue_put()
 
+    @unittest.skipIf(IS_WINDOWS, "file_system strategy uses libshm only on POSIX")
+    def test_fs_segment_cache(self):
+        # the segment of a freed storage is reused by the next storage of the
+        # same size (rounded up to pages), and unlinked at exit
+        code = """\
+import os
+import torch
+x = torch.FloatStorage(100)
+x._share_filename_()
+name = x._share_filename_()[1]
+del x
+y = torch.FloatStorage(200)
+y._share_filename_()
+assert y._share_filename_()[1] == name
+del y
+z = torch.FloatStorage(2000)
+z._share_filename_()
+assert z._share_filename_()[1] != name
+print(name.decode('ascii'))
+"""
+        env = dict(os.environ, TORCH_SHM_CACHE_SIZE=str(1 << 20))
+        popen = subprocess.Popen([sys.executable, '-c', code], env=env,
+                                 stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        out, err = popen.communicate()
+        self.assertEqual(popen.returncode, 0, err.decode('ascii'))
+        if HAS_SHM_FILES:
+            name = out.decode('ascii').strip()
+            self.assertFalse(os.path.exists('/dev/shm' + name))
+
     def test_inherit_tensor(self):
         t = torch.zeros(5, 5)
         p = SubProcess(t.share_memory_())
@@ -457,6 +497,33 @@ class TestMultiprocessing(TestCase):
         # memory 'file' for performance reason
         torch.cuda.ipc_collect()
 
+    @unittest.skipIf(NO_MULTIPROCESSING_SPAWN, "Disabled for environments that \
+                     don't support multiprocessing with spawn start method")
+    @unittest.skipIf(not TEST_CUDA_IPC, 'CUDA IPC not available')
+    @unittest.skipIf(not HAS_SHM_FILES, "don't know how to check if shm files exist")
+    def test_cuda_ref_counter_file_released(self):
+        # Many small tensors, which share one segment of the caching allocator
+        # and one ref counter file
+        ctx = mp.get_context('spawn')
+        tensors = [torch.full((5,), i, device='cuda') for i in range(100)]
+
+        inq = ctx.Queue()
+        outq = ctx.Queue()
+        finished = ctx.Event()
+        p = ctx.Process(target=sum_and_release_tensors, args=(inq, outq, finished))
+        p.start()
+        inq.put(tensors)
+        self.assertEqual(outq.get(), 5 * sum(range(100)))
+        self.assertIsNone(outq.get())
+
+        # Once the consumer has released all of the tensors, it must no longer
+        # keep the ref counter file mapped, even though it is still running.
+        del tensors
+        torch.cuda.ipc_collect()
+        self.assertFalse(leak_checker(self).has_shm_files())
+        finished.set()
+        p.join()
+
     @unittest.skipIf(IS_WINDOWS, 'not applicable to Windows (only fails with fork)')
     @unittest.skipIf(not torch.cuda.is_available(), 'CUDA not available')
     def test_cuda_bad_call(self):
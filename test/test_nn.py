@@ -3632,6 +3632,43 @@ class TestNN(NNTestCase):
         self.assertTrue(ref_out.is_contiguous())
         self.assertEqual(out, ref_out)
 
+    def test_channels_last_cpu(self):
+        # double keeps convolution off mkldnn, so the native NHWC kernels run
+        modules = [
+            nn.Conv2d(8, 6, 3, stride=2, padding=1),
+            nn.Conv2d(8, 6, 1, bias=False),
+            nn.ConvTranspose2d(8, 6, 3, stride=2, padding=1, output_padding=1),
+            nn.ConvTranspose2d(8, 6, (2, 3), dilation=2, bias=False),
+            nn.MaxPool2d(3, stride=2, padding=1),
+            nn.AdaptiveAvgPool2d((3, 5)),
+            nn.AdaptiveAvgPool2d(1),
+            nn.BatchNorm2d(8),
+            nn.BatchNorm2d(8).eval(),
+            nn.Upsample(scale_factor=2, mode='bilinear', align_corners=False),
+            nn.Upsample(size=(9, 4), mode='bilinear', align_corners=True),
+        ]
+        for module in modules:
+            module = module.double()
+            ref_module = deepcopy(module)
+            module = module.to(memory_format=torch.channels_last)
+            input = torch.randn(3, 8, 7, 6, dtype=torch.double)
+            input = input.contiguous(memory_format=torch.channels_last).requires_grad_()
+            ref_input = input.detach().clone().contiguous().requires_grad_()
+
+            out = module(input)
+            ref_out = ref_module(ref_input)
+            grad = torch.randn_like(ref_out)
+            out.backward(grad.contiguous(memory_format=torch.channels_last))
+            ref_out.backward(grad)
+
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last), str(module))
+            self.assertEqual(out, ref_out)
+            self.assertEqual(input.grad, ref_input.grad)
+            for param, ref_param in zip(module.parameters(), ref_module.parameters()):
+                self.assertEqual(param.grad, ref_param.grad)
+            for buf, ref_buf in zip(module.buffers(), ref_module.buffers()):
+                self.assertEqual(buf, ref_buf)
+
     @unittest.skipIf(not TEST_MULTIGPU, "multi-GPU not supported")
     def test_broadcast_double_backwards_gpu(self):
         tensors = (torch.randn(4, 4, device='cuda', requires_grad=True),
@@ -3990,6 +4027,31 @@ class TestNN(NNTestCase):
             bias=True).cuda()
         result = m(x)
 
+    @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
+    @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
+    def test_cudnn_benchmark_cache_save_load(self):
+        x = torch.randn(2, 3, 9, 9, device='cuda', requires_grad=True)
+        m = nn.Conv2d(3, 4, 3).cuda()
+        with cudnn.flags(enabled=True, benchmark=True):
+            m(x).sum().backward()
+        with TemporaryFileName() as fname:
+            cudnn.save_benchmark_cache(fname)
+            self.assertTrue(cudnn.load_benchmark_cache(fname))
+            with open(fname, 'rb') as f:
+                data = f.read()
+            with open(fname, 'wb') as f:
+                f.write(b'not a cache' + data[11:])
+            with warnings.catch_warnings(record=True) as w:
+                warnings.simplefilter('always')
+                self.assertFalse(cudnn.load_benchmark_cache(fname))
+            self.assertEqual(len(w), 1)
+            with open(fname, 'wb') as f:
+                f.write(data[:len(data) - 1])
+            with warnings.catch_warnings(record=True) as w:
+                warnings.simplefilter('always')
+                self.assertFalse(cudnn.load_benchmark_cache(fname))
+            self.assertEqual(len(w), 1)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     @unittest.skipIf(not TEST_CUDNN, 'CUDNN not available')
     def test_Conv2d_inconsistent_types_on_GPU_with_cudnn(self):
@@ -4036,6 +4098,43 @@ class TestNN(NNTestCase):
         self.assertRaisesRegex(RuntimeError, 'Specify retain_graph=True',
                                lambda: o1.sum().backward())
 
+    def test_thnn_conv2d_columns(self):
+        # pointwise convolutions skip im2col, and the columns are only saved
+        # when the gradient of the weight needs them
+        for kernel_size, stride, padding in [((1, 1), (1, 1), (0, 0)), ((3, 2), (2, 1), (1, 0))]:
+            for memory_format in [torch.contiguous_format, torch.channels_last]:
+                x = torch.randn(3, 4, 7, 6, dtype=torch.double).contiguous(memory_format=memory_format)
+                w = torch.randn(5, 4, *kernel_size, dtype=torch.double)
+                b = torch.randn(5, dtype=torch.double)
+                cols = F.unfold(x, kernel_size, padding=padding, stride=stride)
+                expected = (w.view(5, -1).matmul(cols) + b.view(5, 1)).view_as(
+                    F.conv2d(x, w, b, stride=stride, padding=padding))
+
+                with torch.no_grad():
+                    output, finput, _ = torch._C._nn.thnn_conv2d_forward(x, w, kernel_size, b, stride, padding)
+                self.assertEqual(output, expected)
+                self.assertEqual(finput.numel(), 0)
+
+                w.requires_grad_()
+                output, finput, fgrad_input = torch._C._nn.thnn_conv2d_forward(x, w, kernel_size, b, stride, padding)
+                self.assertEqual(output, expected)
+                self.assertEqual(finput.numel() == 0, kernel_size == (1, 1))
+
+                grad_output = torch.randn_like(output)
+                grads = torch._C._nn.thnn_conv2d_backward(
+                    grad_output, x, w.detach(), kernel_size, stride, padding, finput, fgrad_input, [True, True, True])
+                # the columns are rebuilt when they were not saved
+                rebuilt = torch._C._nn.thnn_conv2d_backward(
+                    grad_output, x, w.detach(), kernel_size, stride, padding, torch.empty(0, dtype=torch.double),
+                    fgrad_input, [True, True, True])
+                grad_input_ref, grad_weight_ref = torch.autograd.grad(
+                    F.conv2d(x.requires_grad_(), w, b, stride=stride, padding=padding), (x, w), grad_output)
+                x.requires_grad_(False)
+                for g in (grads, rebuilt):
+                    self.assertEqual(g[0], grad_input_ref)
+                    self.assertEqual(g[1], grad_weight_ref)
+                    self.assertEqual(g[2], grad_output.sum((0, 2, 3)))
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     @repeat_test_for_types(ALL_TENSORTYPES2)
     def test_Conv2d_large_workspace(self, dtype=torch.float):
@@ -4241,6 +4340,43 @@ class TestNN(NNTestCase):
                                         m2.weight.grad.data], 0),
                              prec=dtype2prec[dtype])
 
+    def test_Conv2d_depthwise_cpu(self):
+        # compares the direct depthwise kernel against one convolution per
+        # input channel, for both memory formats
+        configs = [
+            # channels, multiplier, kernel_size, stride, padding, dilation
+            (3, 1, (3, 3), 1, 1, 1),
+            (4, 2, (5, 3), (2, 1), (2, 0), (1, 2)),
+            (17, 1, (2, 4), 3, (1, 2), 2),
+            (8, 3, (1, 1), 2, 0, 1),
+        ]
+        for (channels, multiplier, kernel_size, stride, padding, dilation), memory_format in \
+                product(configs, [torch.contiguous_format, torch.channels_last]):
+            m = nn.Conv2d(channels, channels * multiplier, kernel_size, stride=stride,
+                          padding=padding, dilation=dilation, groups=channels).double()
+            i = torch.randn(2, channels, 11, 12, dtype=torch.double)
+            i = i.contiguous(memory_format=memory_format).requires_grad_()
+            output = m(i)
+            self.assertTrue(output.is_contiguous(memory_format=memory_format))
+            grad_output = torch.randn_like(output)
+            output.backward(grad_output)
+
+            i_ref = i.detach().clone().requires_grad_()
+            weight_ref = m.weight.detach().clone().requires_grad_()
+            bias_ref = m.bias.detach().clone().requires_grad_()
+            output_ref = torch.cat([
+                F.conv2d(i_ref[:, c:c + 1],
+                         weight_ref[c * multiplier:(c + 1) * multiplier],
+                         bias_ref[c * multiplier:(c + 1) * multiplier],
+                         stride=stride, padding=padding, dilation=dilation)
+                for c in range(channels)], 1)
+            output_ref.backward(grad_output)
+
+            self.assertEqual(output, output_ref)
+            self.assertEqual(i.grad, i_ref.grad)
+            self.assertEqual(m.weight.grad, weight_ref.grad)
+            self.assertEqual(m.bias.grad, bias_ref.grad)
+
     def test_MaxUnpool2d_output_size(self):
         m = nn.MaxPool2d(3, stride=2, return_indices=True)
         mu = nn.MaxUnpool2d(3, stride=2)
@@ -4405,6 +4541,24 @@ class TestNN(NNTestCase):
         self.assertAlmostEqual(res_cpu, res_gpu, delta=1e-4)
         self.assertAlmostEqual(grad_cpu, grad_gpu, delta=1e-4)
 
+    def test_CTCLoss_vectorized_cpu(self):
+        # Targets long enough for the vectorized recursion, with repeated labels (where the transition from s-2
+        # is not allowed) and batch items of different lengths, on batch-major (non-contiguous) log_probs.
+        torch.manual_seed(0)
+        input_lengths = [60, 47, 31]
+        target_lengths = [20, 13, 1]
+        targets = torch.randint(1, 3, (sum(target_lengths),), dtype=torch.long)
+        for dtype in [torch.float, torch.double]:
+            log_probs = torch.randn(3, 60, 5, dtype=torch.double).log_softmax(2).transpose(0, 1)
+            log_probs = log_probs.to(dtype).requires_grad_()
+            res = torch.nn.functional.ctc_loss(log_probs, targets, input_lengths, target_lengths, reduction='sum')
+            expected = ctcloss_reference(log_probs, targets, input_lengths, target_lengths, reduction='sum')
+            grad, = torch.autograd.grad(res, log_probs)
+            expected_grad, = torch.autograd.grad(expected, log_probs)
+            prec = 1e-4 if dtype == torch.float else 1e-7
+            self.assertAlmostEqual(res, expected.to(dtype), delta=prec * expected.abs().item())
+            self.assertEqual(grad, expected_grad, prec=prec * 10)
+
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
     def test_CTCLoss_zero_infinity(self):
         target_lengths = [60, 25, 20]
@@ -5803,6 +5957,23 @@ class TestNN(NNTestCase):
                     self.assertEqual(hy.data[0][0][0], 10)
                     self.assertEqual(hy.data[1][0][0], output_val)
 
+    def test_RNN_cpu_inference_matches_training(self):
+        # without grad, CPU LSTM and GRU layers take a fused path; it must
+        # agree with the composite cells used when autograd is recording
+        for module, bias, bidirectional, dtype in product(
+                (nn.LSTM, nn.GRU), (True, False), (True, False), (torch.float, torch.double)):
+            rnn = module(7, 13, num_layers=2, bias=bias, bidirectional=bidirectional).to(dtype)
+            input = torch.randn(5, 3, 7, dtype=dtype)
+            num_directions = 2 if bidirectional else 1
+            hx = torch.randn(2 * num_directions, 3, 13, dtype=dtype)
+            if module is nn.LSTM:
+                hx = (hx, torch.randn(2 * num_directions, 3, 13, dtype=dtype))
+            expected_output, expected_hidden = rnn(input, hx)
+            with torch.no_grad():
+                output, hidden = rnn(input, hx)
+            self.assertEqual(output, expected_output)
+            self.assertEqual(hidden, expected_hidden)
+
     @unittest.skipIf(not (TEST_CUDNN and (TEST_CUDNN_VERSION if TEST_CUDNN_VERSION else 0) >= 5103), "needs cudnn >= 5.1")
     def test_RNN_dropout_state(self):
         for p in (0, 0.1234):
@@ -7380,7 +7551,7 @@ class TestNN(NNTestCase):
             kwargs = dict(mode='bicubic', align_corners=align_corners)
             # test float scale factor up & downsampling
             for device in device_list:
-                for scale_factor in [0.5, 1.5, 2]:
+                for scale_factor in [0.5, 1, 1.5, 2]:
                     in_t = torch.ones(2, 2, 2, 2).to(device)
                     out_t = F.interpolate(in_t, scale_factor=scale_factor, **kwargs)
                     out_size = int(math.floor(in_t.shape[-1] * scale_factor))
@@ -7960,6 +8131,42 @@ class TestNN(NNTestCase):
         self.assertEqual(input.grad.dtype, dtype)
         self.assertEqual(input.grad, inputf.grad.to(dtype), prec=0.1)
 
+    def test_softmax_cpu(self, dtype=torch.bfloat16):
+        for dim in [-1, 0]:
+            inputf = torch.rand(32, 100, device="cpu", dtype=torch.float, requires_grad=True)
+            input = inputf.to(dtype).detach().requires_grad_(True)
+            outf = F.softmax(inputf, dim=dim)
+            out = F.softmax(input, dim=dim)
+            self.assertEqual(out.dtype, dtype)
+            self.assertEqual(out, outf, prec=0.01)
+
+            grad = torch.randn(32, 100)
+            out.backward(grad.to(dtype))
+            outf.backward(grad)
+            self.assertEqual(input.grad.dtype, dtype)
+            self.assertEqual(input.grad, inputf.grad.to(dtype), prec=0.01)
+
+    def test_layer_norm_cpu(self, dtype=torch.bfloat16):
+        inputf = torch.randn(8, 64, device="cpu", dtype=torch.float, requires_grad=True)
+        input = inputf.to(dtype).detach().requires_grad_(True)
+        lnf = nn.LayerNorm(64)
+        ln = nn.LayerNorm(64).to(dtype)
+        with torch.no_grad():
+            lnf.weight.uniform_()
+            lnf.bias.uniform_()
+            ln.weight.copy_(lnf.weight)
+            ln.bias.copy_(lnf.bias)
+        outf = lnf(inputf)
+        out = ln(input)
+        self.assertEqual(out.dtype, dtype)
+        self.assertEqual(out, outf, prec=0.05)
+
+        out.sum().backward()
+        outf.sum().backward()
+        self.assertEqual(input.grad.dtype, dtype)
+        self.assertEqual(input.grad, inputf.grad.to(dtype), prec=0.05)
+        self.assertEqual(ln.weight.grad, lnf.weight.grad.to(dtype), prec=0.2)
+
     def test_adaptive_log_softmax(self):
         # args validation
         with self.assertRaises(ValueError):
@@ -9105,12 +9312,143 @@ class TestNNDeviceType(NNTestCase):
         if self.device_type == 'cuda':
             self._test_LayerNorm_cuda_half(device)
 
+    @dtypes(torch.float, torch.double)
+    def test_dropout_add_layer_norm(self, device, dtype):
+        normalized_shape = [3, 8]
+        input = torch.randn(4, 5, 3, 8, device=device, dtype=dtype)
+        residual = torch.randn_like(input)
+        input_bias = torch.randn(normalized_shape, device=device, dtype=dtype)
+        weight = torch.randn(normalized_shape, device=device, dtype=dtype)
+        bias = torch.randn(normalized_shape, device=device, dtype=dtype)
+
+        # without dropout it is exactly the unfused composition
+        for training, p in [(False, 0.5), (True, 0.)]:
+            out = F.dropout_add_layer_norm(input, residual, normalized_shape, weight, bias,
+                                           input_bias, p=p, training=training)
+            expected = F.layer_norm(residual + input + input_bias, normalized_shape, weight, bias)
+            self.assertEqual(out, expected)
+
+        # with dropout, the returned mask reproduces the output
+        p = 0.3
+        out, sum, mask, mean, rstd = torch._fused_dropout_add_layer_norm(
+            input, residual, input_bias.view(-1), weight.view(-1), bias.view(-1),
+            p, True, 20, 24, 1e-5)
+        self.assertEqual(mask.shape, input.shape)
+        self.assertTrue(((mask == 0) | (mask == 1)).all())
+        expected_sum = residual + (input + input_bias) * mask.type_as(input) / (1 - p)
+        self.assertEqual(sum, expected_sum)
+        self.assertEqual(out, F.layer_norm(expected_sum, normalized_shape, weight, bias))
+        big = torch.ones(1000, 1000, device=device, dtype=dtype)
+        _, _, mask, _, _ = torch._fused_dropout_add_layer_norm(
+            big, big, None, None, None, p, True, 1000, 1000, 1e-5)
+        self.assertEqual(mask.double().mean().item(), 1 - p, 1e-2)
+
+        # p = 1 drops every element of input
+        out = F.dropout_add_layer_norm(input, residual, normalized_shape, p=1.)
+        self.assertEqual(out, F.layer_norm(residual, normalized_shape))
+
+        if dtype == torch.double:
+            args = [t.clone().requires_grad_() for t in (input, residual, weight, bias, input_bias)]
+            self.assertTrue(gradcheck(
+                lambda x, r, w, b, ib: F.dropout_add_layer_norm(x, r, normalized_shape, w, b, ib, p=0.),
+                args))
+
+        with self.assertRaisesRegex(RuntimeError, "Expected residual to be of same shape"):
+            F.dropout_add_layer_norm(input, residual[0], normalized_shape)
+        with self.assertRaisesRegex(RuntimeError, "Expected input_bias to be of same shape"):
+            F.dropout_add_layer_norm(input, residual, normalized_shape, input_bias=input_bias[0])
+
     def test_GroupNorm_general(self, device):
         self._test_GroupNorm_general(device)
 
         if self.device_type == 'cuda':
             self._test_GroupNorm_cuda_half()
 
+    @dtypes(torch.float, torch.double)
+    def test_group_norm_native(self, device, dtype):
+        def reference(x, G, weight, bias, eps=1e-5):
+            N, C = x.shape[:2]
+            y = F.batch_norm(x.reshape(1, N * G, -1), None, None, training=True, eps=eps)
+            shape = [1, C] + [1] * (x.dim() - 2)
+            return y.view_as(x) * weight.view(shape) + bias.view(shape)
+
+        for shape, G in [((2, 6, 5, 4), 3), ((3, 8, 7), 2), ((4, 4), 4), ((2, 6, 3, 3, 2), 1)]:
+            x = torch.randn(shape, device=device, dtype=dtype)
+            weight = torch.randn(shape[1], device=device, dtype=dtype)
+            bias = torch.randn(shape[1], device=device, dtype=dtype)
+            inputs = [x]
+            if x.dim() == 4:
+                inputs.append(x.contiguous(memory_format=torch.channels_last))
+            for inp in inputs:
+                out = F.group_norm(inp, G, weight, bias)
+                self.assertEqual(out, reference(x, G, weight, bias))
+                if self.device_type == 'cpu':
+                    self.assertTrue(out.is_contiguous(memory_format=inp.suggest_memory_format()))
+                if dtype == torch.double:
+                    args = [t.clone().requires_grad_() for t in (inp, weight, bias)]
+                    self.assertTrue(gradcheck(lambda x, w, b: F.group_norm(x, G, w, b), args))
+                    self.assertTrue(gradgradcheck(lambda x, w, b: F.group_norm(x, G, w, b), args))
+                    self.assertTrue(gradcheck(lambda x: F.group_norm(x, G), args[:1]))
+
+    @dtypes(torch.float, torch.double)
+    def test_softmax_cross_entropy(self, device, dtype):
+        for batch, classes in [(8, 10), (3, 5000), (2, 100003)]:
+            input = torch.randn(batch, classes, device=device, dtype=dtype) * 5
+            target = torch.randint(classes, (batch,), device=device)
+            if batch > 2:
+                target[1] = -100
+            for reduction in ['none', 'mean', 'sum']:
+                expected = F.nll_loss(F.log_softmax(input, 1), target, reduction=reduction)
+                self.assertEqual(F.cross_entropy(input, target, reduction=reduction), expected, 1e-4)
+                self.assertEqual(torch.softmax_cross_entropy(input, target, torch.nn._reduction.get_enum(reduction)),
+                                 expected, 1e-4)
+
+        # long rows also go through the single-pass softmax kernel on CUDA
+        input = torch.randn(4, 100003, device=device, dtype=dtype) * 5
+        expected = (input.double() - input.double().logsumexp(1, keepdim=True))
+        self.assertEqual(F.log_softmax(input, 1).double(), expected, 1e-4)
+        self.assertEqual(F.softmax(input, 1).double(), expected.exp(), 1e-4)
+
+        if dtype == torch.double:
+            input = torch.randn(5, 7, device=device, dtype=dtype, requires_grad=True)
+            target = torch.tensor([0, 6, 3, 3, 1], device=device)
+            for reduction in [0, 1, 2]:
+                fn = lambda x: torch.softmax_cross_entropy(x, target, reduction, 3)
+                self.assertTrue(gradcheck(fn, (input,)))
+                self.assertTrue(gradgradcheck(fn, (input,)))
+            grad_output = torch.randn(5, device=device, dtype=dtype)
+            loss, lse = torch._softmax_cross_entropy(input, target, 3)
+            grad_input = torch._softmax_cross_entropy_backward(grad_output, input.detach(), target, lse, 3)
+            grad_input_double_backward, = torch.autograd.grad(loss, input, grad_output, create_graph=True)
+            self.assertEqual(grad_input, grad_input_double_backward)
+
+        if self.device_type == 'cpu':
+            input = torch.randn(6, 3000, dtype=dtype) * 5
+            target = torch.randint(3000, (6,))
+            target[2] = -100
+            loss, lse = torch._softmax_cross_entropy(input.bfloat16(), target, -100)
+            expected_loss, expected_lse = torch._softmax_cross_entropy(input.bfloat16().to(dtype), target, -100)
+            self.assertEqual(loss.to(dtype), expected_loss, 0.1)
+            self.assertEqual(lse.to(dtype), expected_lse, 0.1)
+            grad_output = torch.randn(6, dtype=dtype)
+            grad_input = torch._softmax_cross_entropy_backward(
+                grad_output.bfloat16(), input.bfloat16(), target, lse, -100)
+            expected_grad_input = torch._softmax_cross_entropy_backward(
+                grad_output.bfloat16().to(dtype), input.bfloat16().to(dtype), target, lse.to(dtype), -100)
+            self.assertEqual(grad_input.to(dtype), expected_grad_input, 1e-2)
+
+            # the fused kernel also takes non-contiguous inputs
+            input = torch.randn(7, 5, dtype=dtype).t()
+            target = torch.randint(7, (5,))
+            self.assertEqual(F.cross_entropy(input, target, reduction='none'),
+                             F.nll_loss(F.log_softmax(input, 1), target, reduction='none'))
+
+            with self.assertRaisesRegex(IndexError, "out of bounds"):
+                torch._softmax_cross_entropy(torch.randn(2, 3, dtype=dtype), torch.tensor([0, 3]), -100)
+
+        with self.assertRaisesRegex(RuntimeError, "expected input to be 2-D"):
+            torch.softmax_cross_entropy(torch.randn(2, 3, 4, device=device), torch.zeros(2, 3, device=device).long())
+
     def test_groupnorm_raises_error_if_less_than_one_value_per_channel(self, device):
         x = torch.rand(10)[None, :, None]
         with self.assertRaises(ValueError):
@@ -9335,24 +9673,51 @@ class TestNNDeviceType(NNTestCase):
         tensorTwice = tensorTwice.to(device)
         onesTwice = onesTwice.to(device)
 
+        # CUDA sums duplicate indices into a coalesced gradient, so compare
+        # the gradients as sparse tensors rather than index by index there
+        def check_grad(indices, values):
+            grad = embedding.weight.grad
+            if self.device_type == 'cuda':
+                expected = torch.sparse_coo_tensor(indices, values, grad.shape)
+                self.assertEqual(grad, expected)
+            else:
+                self.assertEqual(grad._indices(), indices)
+                self.assertEqual(grad._values(), values)
+
         embedding.zero_grad()
         embedding(tensor[0]).sum().backward()
-        self.assertEqual(embedding.weight.grad._indices(), tensor)
-        self.assertEqual(embedding.weight.grad._values(), ones)
+        check_grad(tensor, ones)
 
         embedding.zero_grad()
         embedding(tensor[0]).sum().backward()
         embedding(tensor[0]).sum().backward()
-        self.assertEqual(embedding.weight.grad._indices(), tensorTwice)
-        self.assertEqual(embedding.weight.grad._values(), onesTwice)
+        check_grad(tensorTwice, onesTwice)
 
         embedding.zero_grad()
         embedding(tensor[0]).sum().backward()
         tensor[0, 0] = 8
         embedding(tensor[0]).sum().backward()
         tensorTwice[0, 3] = 8
-        self.assertEqual(embedding.weight.grad._indices(), tensorTwice)
-        self.assertEqual(embedding.weight.grad._values(), onesTwice)
+        check_grad(tensorTwice, onesTwice)
+
+    @dtypesIfCUDA(torch.float16, torch.float32, torch.float64)
+    @dtypes(torch.float32, torch.float64)
+    def test_embedding_sparse_backward_matches_dense(self, device, dtype):
+        num_weights, dim = 1000, 37
+        # skewed, so that a few rows collect long segments
+        indices = (torch.rand(3000, device=device) ** 4 * num_weights).long()
+        grad = torch.randn(3000, dim, device=device, dtype=dtype)
+        for padding_idx in (None, 0):
+            grads = []
+            for sparse in (True, False):
+                weight = torch.randn(num_weights, dim, device=device, dtype=dtype, requires_grad=True)
+                F.embedding(indices, weight, padding_idx=padding_idx, sparse=sparse).backward(grad)
+                grads.append(weight.grad)
+            sparse, dense = grads
+            if self.device_type == 'cuda':
+                self.assertTrue(sparse.is_coalesced())
+                self.assertEqual(sparse._indices(), sparse._indices().unique().view(1, -1))
+            self.assertEqual(sparse.to_dense(), dense, prec=5e-2 if dtype == torch.half else 1e-4)
 
     def test_embedding_padding_idx(self, device):
         embedding = nn.Embedding(10, 20, padding_idx=0).to(device)
@@ -401,6 +401,28 @@ class TestOptim(TestCase):
              lambda opt: ReduceLROnPlateau(opt, threshold=1e-4)]
         )
 
+    def test_sparse_adagrad_embedding_rows(self):
+        # float embedding gradients with a repeated row, the rows they do not
+        # touch must be left alone
+        for op in [torch._sparse_adagrad_, torch._sparse_rowwise_adagrad_]:
+            rowwise = op is torch._sparse_rowwise_adagrad_
+            weight = torch.randn(10, 20)
+            state_sum = torch.rand(10) if rowwise else torch.rand(10, 20)
+            grad = torch.sparse_coo_tensor(
+                torch.tensor([[7, 2, 7]]), torch.randn(3, 20), (10, 20))
+            dense = grad.to_dense()
+            if rowwise:
+                expected_sum = state_sum + dense.pow(2).mean(1)
+                std = expected_sum.sqrt().add(1e-10).unsqueeze(1)
+            else:
+                expected_sum = state_sum + dense.pow(2)
+                std = expected_sum.sqrt().add(1e-10)
+            expected_weight = weight - 0.1 * dense / std
+
+            op(weight, state_sum, grad, 0.1)
+            self.assertEqual(weight, expected_weight)
+            self.assertEqual(state_sum, expected_sum)
+
     def test_adamax(self):
         self._test_basic_cases(
             lambda weight, bias: optim.Adamax([weight, bias], lr=1e-1)
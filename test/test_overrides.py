@@ -423,6 +423,7 @@ TENSOR_LIKE_TORCH_IMPLEMENTATIONS = (
     (torch.cartesian_prod, lambda *tensors: -1),
     (torch.cat, lambda tensors, dim=0, out=None: -1),
     (torch.cdist, lambda x1, c2, p=2, compute_mode=None: -1),
+    (torch.cdist_topk, lambda x1, x2, k, p=2, compute_mode=None: -1),
     (torch.ceil, lambda input, out=None: -1),
     (torch.celu, lambda input, alhpa=1., inplace=False: -1),
     (torch.chain_matmul, lambda *matrices: -1),
@@ -624,7 +625,8 @@ TENSOR_LIKE_TORCH_IMPLEMENTATIONS = (
     (torch.qr, lambda input, some=True, out=None: -1),
     (torch.quantize_per_channel, lambda input, scales, zero_points, axis, dtype: -1),
     (torch.quantize_per_tensor, lambda input, scale, zero_point, dtype: -1),
-    (torch.quantized_gru, lambda data, batch_sizes, hx, params, has_biases, num_layers, dropout, train, bidirectional: -1),
+    (torch.quantized_gru, lambda data, batch_sizes, hx, params, has_biases, num_layers, dropout, train, bidirectional,
+     dtype=None, use_dynamic=False: -1),
     (torch.quantized_gru_cell, lambda input, hx, w_ih, w_hh, b_ih, b_hh, packed_ih, packed_hh, col_offsets_ih, col_offsets_hh,
      scale_ih, scale_hh, zero_point_ih, zero_point_hh: -1),
     (torch.quantized_lstm, lambda input, hx, params, has_biases, num_layers, dropout, train, bidirectional, batch_first,
@@ -45,6 +45,7 @@ import torch.testing._internal.hypothesis_utils as hu
 hu.assert_deadline_disabled()
 import io
 import copy
+import itertools
 
 @unittest.skipUnless('fbgemm' in torch.backends.quantized.supported_engines,
                      " Quantized operations require FBGEMM. FBGEMM is only optimized for CPUs"
@@ -734,6 +735,48 @@ class PostTrainingDynamicQuantTest(QuantizationTestCase):
 
             y, (h, c) = cell_dq(x, (h, c))
 
+    def test_quantized_gru(self):
+        torch.manual_seed(0)
+        seq_len, batch, input_size, hidden_size = 6, 3, 4, 5
+        for dtype, bidirectional in itertools.product([torch.qint8, torch.float16], [False, True]):
+            ref = torch.nn.GRU(input_size, hidden_size, num_layers=2,
+                               bidirectional=bidirectional).eval()
+            model = torch.nn.Sequential(copy.deepcopy(ref))
+            model_q = quantize_dynamic(model=model, dtype=dtype)
+            cell_q = model_q[0]
+            self.assertEqual(type(cell_q), torch.nn.quantized.dynamic.GRU)
+            self.assertTrue('DynamicQuantizedGRU' in str(model_q))
+
+            num_directions = 2 if bidirectional else 1
+            x = torch.randn(seq_len, batch, input_size)
+            hx = torch.randn(2 * num_directions, batch, hidden_size)
+            ref_out, ref_hid = ref(x, hx)
+            out, hid = cell_q(x, hx)
+            self.assertEqual(out.size(), ref_out.size())
+            self.assertEqual(out, ref_out, prec=0.1)
+            self.assertEqual(hid, ref_hid, prec=0.1)
+
+            # packed sequences run through the same kernels step by step
+            packed_input = torch.nn.utils.rnn.pack_padded_sequence(x, torch.tensor([6, 4, 2]))
+            ref_out_packed, ref_hid_packed = ref(packed_input, hx)
+            out_packed, hid_packed = cell_q(packed_input, hx)
+            self.assertEqual(out_packed.data, ref_out_packed.data, prec=0.1)
+            self.assertEqual(hid_packed, ref_hid_packed, prec=0.1)
+
+            class ScriptWrapper(torch.nn.Module):
+                def __init__(self, cell):
+                    super(ScriptWrapper, self).__init__()
+                    self.cell = cell
+
+                def forward(self, x, hx):
+                    # type: (torch.Tensor, torch.Tensor) -> Tuple[torch.Tensor, torch.Tensor]
+                    return self.cell(x, hx)
+
+            cell_script = torch.jit.script(ScriptWrapper(cell_q))
+            out_script, hid_script = cell_script(x, hx)
+            self.assertEqual(out_script, out)
+            self.assertEqual(hid_script, hid)
+
 
 @unittest.skipUnless('fbgemm' in torch.backends.quantized.supported_engines,
                      " Quantized operations require FBGEMM. FBGEMM is only optimized for CPUs"
@@ -1,6 +1,7 @@
 from __future__ import division
 from builtins import round
 
+import itertools
 import numpy as np
 import unittest
 
@@ -16,6 +17,7 @@ import torch.testing._internal.hypothesis_utils as hu
 hu.assert_deadline_disabled()
 
 from torch.testing._internal.common_utils import TEST_WITH_UBSAN, TestCase, run_tests, IS_PPC, IS_MACOS
+from torch.testing._internal.common_cuda import TEST_CUDA
 from torch.testing._internal.common_quantized import _quantize, _dequantize, _calculate_dynamic_qparams, \
     override_quantized_engine
 
@@ -204,6 +206,56 @@ class TestQuantizedOps(TestCase):
         self.assertEqual(qY, qY_hat,
                          message="TanH failed: {} vs. {}".format(qY, qY_hat))
 
+    """Tests the correctness of the quantized::layer_norm op."""
+    def test_qlayer_norm(self):
+        torch.manual_seed(0)
+        for torch_type, shape, affine in itertools.product(
+                (torch.quint8, torch.qint8, torch.qint32),
+                ((4, 13), (2, 3, 40), (3, 5, 7)),
+                (True, False)):
+            X = torch.randn(shape) * 4 + 1
+            normalized_shape = list(shape[1:])
+            weight = torch.rand(normalized_shape) + 0.5 if affine else None
+            bias = torch.randn(normalized_shape) if affine else None
+            zero_point = 0 if torch_type == torch.qint32 else 3
+            qX = torch.quantize_per_tensor(X, scale=0.05, zero_point=zero_point,
+                                           dtype=torch_type)
+            Y = torch.nn.functional.layer_norm(qX.dequantize(), normalized_shape,
+                                               weight, bias, 1e-5)
+            output_scale = 0.05
+            output_zero_point = 0 if torch_type == torch.qint32 else 2
+            qY = torch.ops.quantized.layer_norm(qX, normalized_shape, weight, bias,
+                                                1e-5, output_scale, output_zero_point)
+            qY_ref = torch.quantize_per_tensor(Y, output_scale, output_zero_point,
+                                               torch_type)
+            self.assertEqual(qY.q_scale(), output_scale)
+            self.assertEqual(qY.q_zero_point(), output_zero_point)
+            # allow for rounding ties and float reassociation
+            diff = (qY.int_repr().to(torch.int64) - qY_ref.int_repr().to(torch.int64)).abs()
+            self.assertLessEqual(diff.max().item(), 1,
+                                 "layer_norm failed: {} vs. {}".format(qY, qY_ref))
+
+    """Tests the correctness of the quantized::softmax op."""
+    def test_qsoftmax(self):
+        torch.manual_seed(0)
+        for torch_type, shape, dim in itertools.product(
+                (torch.quint8, torch.qint8),
+                ((4, 40), (2, 3, 5), (3, 70, 2)),
+                (0, 1, -1)):
+            X = torch.randn(shape) * 3
+            zero_point = 128 if torch_type == torch.quint8 else 0
+            qX = torch.quantize_per_tensor(X, scale=0.04, zero_point=zero_point,
+                                           dtype=torch_type)
+            output_scale = 1.0 / 256
+            output_zero_point = 0 if torch_type == torch.quint8 else -128
+            qY = torch.ops.quantized.softmax(qX, dim, output_scale, output_zero_point)
+            Y = torch.softmax(qX.dequantize(), dim)
+            qY_ref = torch.quantize_per_tensor(Y, output_scale, output_zero_point,
+                                               torch_type)
+            diff = (qY.int_repr().to(torch.int64) - qY_ref.int_repr().to(torch.int64)).abs()
+            self.assertLessEqual(diff.max().item(), 1,
+                                 "softmax failed: {} vs. {}".format(qY, qY_ref))
+
     """Tests the correctness of the quantized::clamp op."""
     @given(X=hu.tensor(shapes=hu.array_shapes(1, 8, 1, 8),
                        elements=hu.floats(-1e6, 1e6, allow_nan=False),
@@ -986,6 +1038,29 @@ class TestQuantizedOps(TestCase):
         torch.testing.assert_allclose(out.dequantize(), ref.dequantize())
         self.assertNotEqual(out.stride(), sorted(out.stride()))
 
+    def test_cat_nhwc_other_dims(self):
+        """Concatenating channels-last tensors along a non-channel dim keeps
+        the result channels-last."""
+        X = torch.rand(2, 8, 4, 5)
+        qXs = [torch.quantize_per_tensor(X, 0.05, 2, torch.quint8).contiguous(
+            memory_format=torch.channels_last) for _ in range(2)]
+        for dim in (0, 2, 3):
+            out = torch.ops.quantized.cat(qXs, dim=dim, scale=0.05, zero_point=2)
+            ref = torch.cat([qX.int_repr() for qX in qXs], dim=dim)
+            self.assertEqual(out.int_repr(), ref)
+            self.assertTrue(out.is_contiguous(memory_format=torch.channels_last))
+
+    def test_upsample_nearest2d_nhwc_batch(self):
+        """Every batch element is upsampled on the NHWC path, including the
+        same-size copy."""
+        X = torch.randint(0, 255, (3, 40, 4, 4), dtype=torch.float)
+        qX = torch.quantize_per_tensor(X, 1.0, 0, torch.quint8).contiguous(
+            memory_format=torch.channels_last)
+        for size in [(4, 4), (7, 9)]:
+            ref = torch.nn.functional.interpolate(X, size=size, mode='nearest')
+            out = torch.nn.quantized.functional.interpolate(qX, size=size, mode='nearest')
+            self.assertEqual(out.int_repr().to(torch.float), ref)
+
     @given(X=hu.tensor(shapes=hu.array_shapes(min_dims=3, max_dims=3,
                                               min_side=1, max_side=2),
                        qparams=hu.qparams()),
@@ -1071,6 +1146,29 @@ class TestQuantizedOps(TestCase):
         self.assertEqual(qX.equal(qX), equal_ref(qX, qX))
         self.assertEqual(qX.equal(qX2), equal_ref(qX, qX2))
 
+    def test_embedding_bag_rowwise(self):
+        torch.manual_seed(0)
+        weight = torch.randn(50, 17)
+        indices = torch.randint(0, 50, (40,), dtype=torch.long)
+        offsets = torch.tensor([0, 3, 3, 10, 25], dtype=torch.long)
+        per_sample_weights = torch.rand(40)
+        # half a quantization step of the widest row range, plus fp16 rounding
+        precs = {'byte': 0.05, '4bit': 0.5, '2bit': 1.5}
+        for bits in ('byte', '4bit', '2bit'):
+            prepack = getattr(torch.ops.quantized, 'embedding_bag_%s_prepack' % bits)
+            unpack = getattr(torch.ops.quantized, 'embedding_bag_%s_unpack' % bits)
+            lookup = getattr(torch.ops.quantized, 'embedding_bag_%s_rowwise_offsets' % bits)
+            packed = prepack(weight)
+            dequantized = unpack(packed)
+            # N-bit rows hold 8 / N columns per byte, so other widths get padded
+            self.assertEqual(dequantized[:, :17], weight, prec=precs[bits])
+            for mode, psw in ((0, None), (1, None), (0, per_sample_weights)):
+                out = lookup(packed, indices, offsets, mode=mode, per_sample_weights=psw)
+                ref = torch.nn.functional.embedding_bag(
+                    indices, dequantized, offsets, mode=['sum', 'mean'][mode],
+                    per_sample_weights=psw)
+                self.assertEqual(out, ref, prec=1e-4)
+
 
 @unittest.skipUnless('fbgemm' in torch.backends.quantized.supported_engines,
                      " Quantized operations require FBGEMM. FBGEMM is only optimized for CPUs"
@@ -1454,6 +1552,98 @@ class TestQuantizedLinear(unittest.TestCase):
                 np.testing.assert_equal(
                     W_q.q_zero_point(), W_q_origin.q_zero_point())
 
+    """Tests that with engine auto selection the prepack ops pick the engine
+    per weight shape and the run and unpack ops follow the packed weight."""
+    def test_qlinear_engine_auto_select(self):
+        engines = torch.backends.quantized.supported_engines
+        if 'qnnpack' not in engines or 'fbgemm' not in engines or IS_PPC or TEST_WITH_UBSAN:
+            return
+        qlinear_prepack = torch.ops.quantized.linear_prepack
+        qlinear_unpack = torch.ops.quantized.linear_unpack
+        qlinear = torch.ops.quantized.linear
+        X_q = torch.quantize_per_tensor(torch.rand(4, 8) * 2 - 1, scale=0.02,
+                                        zero_point=127, dtype=torch.quint8)
+        # A tiny FC goes to QNNPACK, a large one stays on FBGEMM.
+        for output_channels, expected_engine in [(8, 'qnnpack'), (1024, 'fbgemm')]:
+            W_q = torch.quantize_per_tensor(torch.rand(output_channels, 8) - 0.5, scale=0.01,
+                                            zero_point=0, dtype=torch.qint8)
+            with override_quantized_engine(expected_engine):
+                Y_ref = qlinear(X_q, qlinear_prepack(W_q), 0.05, 10)
+            previous = torch.backends.quantized.auto_select
+            torch.backends.quantized.auto_select = True
+            try:
+                with override_quantized_engine('fbgemm'):
+                    W_prepack = qlinear_prepack(W_q)
+                # The packed weight, not the global engine, decides the kernel.
+                for qengine in ('fbgemm', 'qnnpack'):
+                    with override_quantized_engine(qengine):
+                        Y_q = qlinear(X_q, W_prepack, 0.05, 10)
+                        np.testing.assert_equal(Y_ref.int_repr().numpy(), Y_q.int_repr().numpy())
+                        np.testing.assert_equal(W_q.int_repr().numpy(),
+                                                qlinear_unpack(W_prepack)[0].int_repr().numpy())
+            finally:
+                torch.backends.quantized.auto_select = previous
+
+    """Tests the correctness of the quantized linear and linear_relu op on CUDA,
+    and that quantized::linear_unpack returns the weight packed for it."""
+    @unittest.skipIf(not TEST_CUDA, "CUDA unavailable")
+    @given(batch_size=st.integers(1, 4),
+           input_channels=st.integers(1, 37),
+           output_channels=st.integers(1, 9),
+           use_bias=st.booleans(),
+           use_relu=st.booleans(),
+           use_multi_dim_input=st.booleans(),
+           W_zp=st.integers(-10, 10))
+    def test_qlinear_cuda(self, batch_size, input_channels, output_channels, use_bias,
+                          use_relu, use_multi_dim_input, W_zp):
+        # cuBLAS multiplies int8 matrices only from compute capability 6.1 on.
+        if torch.cuda.get_device_capability() < (6, 1):
+            return
+        qlinear_prepack = torch.ops.quantized.linear_prepack
+        qlinear_unpack = torch.ops.quantized.linear_unpack
+        qlinear = torch.ops.quantized.linear_relu if use_relu else torch.ops.quantized.linear
+        if use_multi_dim_input:
+            batch_size *= 3
+        X_scale = 0.05
+        X_zp = 5
+        X_q0 = np.round(np.random.rand(batch_size, input_channels) * 255).astype(np.uint8)
+        W_scale = 0.02
+        W_q0 = np.round(np.random.rand(output_channels, input_channels) * 255 - 128).astype(np.int8)
+        b_q0 = np.round(np.random.rand(output_channels) * 200 - 100).astype(np.int32) if use_bias else None
+        Y_scale = 0.7
+        Y_zp = 128
+
+        X = torch.from_numpy(_dequantize(X_q0, X_scale, X_zp)).to(dtype=torch.float, device='cuda')
+        X_q = torch.quantize_per_tensor(X, scale=X_scale, zero_point=X_zp, dtype=torch.quint8)
+        W = torch.from_numpy(_dequantize(W_q0, W_scale, W_zp)).to(dtype=torch.float, device='cuda')
+        W_q = torch.quantize_per_tensor(W, scale=W_scale, zero_point=W_zp, dtype=torch.qint8)
+        b = torch.from_numpy(_dequantize(b_q0, X_scale * W_scale, 0)).to(
+            dtype=torch.float, device='cuda') if use_bias else None
+        np.testing.assert_equal(X_q.int_repr().cpu().numpy(), X_q0)
+        np.testing.assert_equal(W_q.int_repr().cpu().numpy(), W_q0)
+
+        W_prepack = qlinear_prepack(W_q, b)
+        if use_multi_dim_input:
+            X_q = X_q.view(3, int(batch_size / 3), input_channels)
+        Y_q = qlinear(X_q, W_prepack, Y_scale, Y_zp)
+        self.assertEqual(Y_q.device, X_q.device)
+
+        Y_q_ref = qlinear_ref(X_q0, X_scale, X_zp, W_q0, W_scale, W_zp, b_q0, Y_scale, Y_zp)
+        if use_relu:
+            Y_q_ref[Y_q_ref < Y_zp] = Y_zp
+        if use_multi_dim_input:
+            Y_q_ref = np.reshape(Y_q_ref, (3, int(batch_size / 3), output_channels))
+        # The requantization runs in float rather than double, which may round
+        # the other way.
+        np.testing.assert_array_almost_equal(Y_q_ref, Y_q.int_repr().cpu().numpy(), decimal=0)
+
+        W_q_origin, b_origin = qlinear_unpack(W_prepack)
+        np.testing.assert_equal(W_q_origin.int_repr().cpu().numpy(), W_q0)
+        self.assertEqual(W_q_origin.q_scale(), W_scale)
+        self.assertEqual(W_q_origin.q_zero_point(), W_zp)
+        if use_bias:
+            np.testing.assert_equal(b_origin.cpu().numpy(), b.cpu().numpy())
+
 class TestQuantizedConv(unittest.TestCase):
     def _test_qconv_unpack_impl(
         self, qconv_prepack_fn, qconv_unpack_fn, inputs, strides, pads,
@@ -1729,6 +1919,42 @@ class TestQuantizedConv(unittest.TestCase):
                 qconv_prepack, qconv_unpack, inputs, (stride_h, stride_w),
                 (pad_h, pad_w), channelwise)
 
+    def test_qconv2d_add_relu(self):
+        torch.manual_seed(0)
+        for qengine, groups, kernel in itertools.product(
+                ('fbgemm', 'qnnpack'), (1, 2), (1, 3)):
+            if qengine not in torch.backends.quantized.supported_engines:
+                continue
+            if qengine == 'qnnpack' and (IS_PPC or TEST_WITH_UBSAN):
+                continue
+            with override_quantized_engine(qengine):
+                X = torch.quantize_per_tensor(
+                    torch.randn(2, 4, 9, 7), 0.1, 3, torch.quint8)
+                W = torch.quantize_per_tensor(
+                    torch.randn(8, 4 // groups, kernel, kernel), 0.05, 0, torch.qint8)
+                bias = torch.randn(8)
+                stride, padding, dilation = [1, 1], [kernel // 2] * 2, [1, 1]
+                W_packed = torch.ops.quantized.conv2d_prepack(
+                    W, bias, stride, padding, dilation, groups)
+                accum = torch.quantize_per_tensor(
+                    torch.randn(2, 8, 9, 7), 0.2, 10, torch.quint8)
+
+                conv = torch.ops.quantized.conv2d(
+                    X, W_packed, stride, padding, dilation, groups, 0.3, 60)
+                ref = torch.ops.quantized.add_relu(conv, accum, 0.25, 5)
+                fused = torch.ops.quantized.conv2d_add_relu(
+                    X, W_packed, accum, stride, padding, dilation, groups,
+                    0.3, 60, 0.25, 5)
+                self.assertEqual(fused.q_scale(), 0.25)
+                self.assertEqual(fused.q_zero_point(), 5)
+                self.assertLessEqual(
+                    (fused.int_repr().int() - ref.int_repr().int()).abs().max().item(), 1)
+
+                with self.assertRaisesRegex(RuntimeError, "residual"):
+                    torch.ops.quantized.conv2d_add_relu(
+                        X, W_packed, accum[:, :4], stride, padding, dilation,
+                        groups, 0.3, 60, 0.25, 5)
+
     @given(batch_size=st.integers(1, 4),
            input_channels_per_group=st.sampled_from([2, 4, 5, 8, 16]),
            D=st.integers(4, 8),
@@ -671,6 +671,37 @@ class TestSerialization(TestCase, SerializationMixin):
 
         test(io.BytesIO())
 
+    def test_serialization_sharded(self):
+        directory = tempfile.mkdtemp()
+        try:
+            shared = torch.randn(6)
+            shards = [
+                {'a': shared[:2], 'b': shared[2:], 'c': {'step': 3}},
+                {'d': torch.arange(4), 'e': torch.randn(2, 3, dtype=torch.double)},
+            ]
+            for rank, state_dict in enumerate(shards):
+                torch.serialization.save_sharded(state_dict, directory, rank=rank)
+            self.assertEqual(sorted(os.listdir(directory)), ['shard_0.pt', 'shard_1.pt'])
+
+            everything = torch.serialization.load_sharded(directory)
+            self.assertEqual(sorted(everything.keys()), ['a', 'b', 'c', 'd', 'e'])
+            for state_dict in shards:
+                for key, value in state_dict.items():
+                    self.assertEqual(everything[key], value)
+            # storages shared by entries of a shard stay shared
+            self.assertEqual(everything['a'].storage().data_ptr(), everything['b'].storage().data_ptr())
+
+            some = torch.serialization.load_sharded(directory, keys=['e', 'b'])
+            self.assertEqual(sorted(some.keys()), ['b', 'e'])
+            self.assertEqual(some['e'], shards[1]['e'])
+
+            with self.assertRaisesRegex(KeyError, "not found"):
+                torch.serialization.load_sharded(directory, keys=['a', 'z'])
+            with self.assertRaisesRegex(ValueError, "string keys"):
+                torch.serialization.save_sharded({0: torch.ones(1)}, directory, rank=2)
+        finally:
+            shutil.rmtree(directory)
+
     def run(self, *args, **kwargs):
         with serialization_method(use_zip=True):
             return super(TestSerialization, self).run(*args, **kwargs)
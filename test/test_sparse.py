@@ -199,6 +199,35 @@ class TestSparse(TestCase):
             t, _, _ = self._gen_sparse(len(sparse_size), nnz, sparse_size + dense_size)
             self.safeCoalesce(t)  # this tests correctness
 
+    def test_coalesce_large(self):
+        # enough nonzeros and a wide enough key range for several sort passes
+        size = [300, 200, 100]
+        nnz = 100000
+        i = torch.stack([torch.randint(s, (nnz,), device=self.device) for s in size])
+        v = torch.randn(nnz, 3, dtype=self.value_dtype, device=self.device)
+        x = self.sparse_tensor(i, v, torch.Size(size + [3]))
+        y = x.coalesce()
+        self.assertTrue(y.is_coalesced())
+        self.assertEqual(y.to_dense(), x.to_dense())
+        flat = y._indices()[0] * 20000 + y._indices()[1] * 100 + y._indices()[2]
+        self.assertTrue((flat[1:] > flat[:-1]).all())
+
+        # already sorted and unique indices are recognised without a copy
+        z = self.sparse_tensor(y._indices(), y._values(), y.size())
+        self.assertFalse(z.is_coalesced())
+        zc = z.coalesce()
+        self.assertTrue(zc.is_coalesced())
+        self.assertEqual(zc._indices(), y._indices())
+        self.assertEqual(zc._values(), y._values())
+        self.assertFalse(z.is_coalesced())
+
+        # adding uncoalesced tensors whose merged indices increase keeps the flag
+        a = self.sparse_tensor(self.index_tensor([[0, 2]]), self.value_tensor([1., 2.]), torch.Size([4]))
+        b = self.sparse_tensor(self.index_tensor([[1, 3]]), self.value_tensor([3., 4.]), torch.Size([4]))
+        if not self.is_cuda:
+            self.assertTrue((a + b).is_coalesced())
+        self.assertEqual((a + b).to_dense(), self.value_tensor([1., 3., 2., 4.]))
+
     def test_ctor_size_checks(self):
         indices = self.index_tensor([
             [0, 0, 0],
@@ -985,6 +1014,25 @@ class TestSparse(TestCase):
         test_shape(1000, 100, 0, 0)
         test_shape(1000, 100, 0, 20)
 
+    def test_mm_strided_and_integral(self):
+        x = self._gen_sparse(2, 200, [300, 50])[0]
+        dense = self.safeToDense(x)
+
+        # non-contiguous dense operand and output
+        y = self.randn(70, 50).t()[:, ::2]
+        t = self.randn(300, 35)
+        out = self.randn(35, 300).t()
+        self.assertEqual(torch.mm(x, y), torch.mm(dense, y))
+        torch.addmm(t, x, y, beta=0.5, alpha=2, out=out)
+        self.assertEqual(out, 0.5 * t + 2 * torch.mm(dense, y))
+
+        if not self.is_cuda:
+            i = self.index_tensor([[5, 2, 0, 2], [3, 0, 1, 0]])
+            v = torch.tensor([1, 2, 3, 4])
+            x = self.sparse_tensor(i, v, torch.Size([6, 4]), dtype=torch.long)
+            y = torch.arange(12).view(4, 3)
+            self.assertEqual(torch.mm(x, y), torch.mm(x.to_dense(), y))
+
     @skipIfRocm
     def test_hsmm(self):
         def test_shape(di, dj, dk, nnz):
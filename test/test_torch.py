@@ -8,6 +8,7 @@ import copy
 import torch
 import torch.cuda
 import torch.backends.cuda
+import torch.backends.mkl
 import tempfile
 import unittest
 import warnings
@@ -18,6 +19,7 @@ from torch.utils.dlpack import from_dlpack, to_dlpack
 from torch._six import inf, nan, string_classes, istuple
 from itertools import product, combinations, combinations_with_replacement, permutations
 from functools import reduce
+from contextlib import contextmanager
 from random import randrange
 from torch import multiprocessing as mp
 from torch.testing._internal.common_methods_invocations import tri_tests_args, run_additional_tri_tests, \
@@ -1041,6 +1043,21 @@ class _TestTorchMixin(object):
         self.assertEqual(y[:, 0], range(100))
         self.assertEqual(y[:, 40], range(4000, 4100))
 
+    def test_copy_half_float(self):
+        # every half value, and floats rounded to half, match NumPy, also for
+        # lengths that are not a multiple of the vector size and strided copies
+        bits = np.arange(-2 ** 15, 2 ** 15 - 3, dtype=np.int16)
+        bits = bits[~np.isnan(bits.view(np.float16))]
+        h = torch.from_numpy(bits.view(np.float16).copy())
+        expected = torch.from_numpy(bits.view(np.float16).astype(np.float32))
+        self.assertEqual(h.float(), expected, 0)
+        self.assertEqual(h[::3].float(), expected[::3], 0)
+
+        f = torch.randn(10007) * torch.logspace(-30, 30, 10007, base=2)
+        expected = torch.from_numpy(f.numpy().astype(np.float16).view(np.int16))
+        self.assertEqual(torch.from_numpy(f.half().numpy().view(np.int16)), expected, 0)
+        self.assertEqual(torch.from_numpy(f[::2].half().numpy().view(np.int16)), expected[::2], 0)
+
     def test_device(self):
         cpu = torch.device('cpu')
         self.assertEqual('cpu', str(cpu))
@@ -1876,6 +1893,35 @@ class _TestTorchMixin(object):
         self.assertIsOrdered('descending', x, res2val, res2ind,
                              'random with NaNs')
 
+    @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+    def test_sort_large(self):
+        # long slices are sorted in parallel, by radix sort for narrow key
+        # ranges and by merge sort otherwise; both are stable
+        SIZE = 300000
+        cases = [
+            torch.randint(-50, 50, (SIZE,), dtype=torch.int32),
+            torch.randint(0, 256, (SIZE,), dtype=torch.uint8),
+            torch.randint(-2 ** 62, 2 ** 62, (SIZE,), dtype=torch.int64),
+            torch.randint(-50, 50, (SIZE,)).float() / 4,
+            torch.randn(SIZE, dtype=torch.double),
+        ]
+        cases[3][::1000] = float('NaN')
+        cases[3][1::1000] = -0.0
+        for x in cases:
+            values, indices = torch.sort(x)
+            self.assertEqual(indices, torch.from_numpy(np.argsort(x.numpy(), kind='stable')))
+            self.assertEqual(values, x[indices])
+            values, indices = torch.sort(x, descending=True)
+            self.assertIsOrdered('descending', x, values, indices, 'large')
+            # equal keys keep their input order
+            same = values[1:] == values[:-1]
+            self.assertTrue((indices[1:][same] > indices[:-1][same]).all())
+        # a single long column of a 2-D tensor
+        x = torch.randint(-1000, 1000, (SIZE, 2))
+        values, indices = torch.sort(x, 0)
+        self.assertEqual(values, x.gather(0, indices))
+        self.assertEqual(indices[:, 1], torch.from_numpy(np.argsort(x[:, 1].numpy(), kind='stable')))
+
     def test_topk(self):
         def topKViaSort(t, k, dim, dir):
             sorted, indices = t.sort(dim, dir)
@@ -1925,6 +1971,21 @@ class _TestTorchMixin(object):
         # Make sure True isn't mistakenly taken as the 2nd dimension (interpreted as 1)
         self.assertRaises(TypeError, lambda: q.topk(4, True))
 
+    def test_topk_small_k(self):
+        # small k on long contiguous slices filters the input before selecting,
+        # and a single huge slice is split across threads
+        for dtype in (torch.float, torch.double, torch.int32, torch.uint8):
+            for shape in ((250000,), (4, 70000), (3, 1000)):
+                t = torch.randint(0, 200, shape).to(dtype)
+                if dtype.is_floating_point:
+                    t.view(-1)[::997] = float('NaN')
+                for k in (1, 10):
+                    for largest in (True, False):
+                        values, indices = t.topk(k, -1, largest, True)
+                        expected = t.sort(-1, largest)[0].narrow(-1, 0, k)
+                        self.assertEqual(values, expected, 0)
+                        self.assertEqual(t.gather(-1, indices), values, 0)
+
     def test_median(self):
         for size in (155, 156):
             x = torch.rand(size, size)
@@ -2256,6 +2317,45 @@ class _TestTorchMixin(object):
     def test_fft_ifft_rfft_irfft(self):
         self._test_fft_ifft_rfft_irfft(self)
 
+    @unittest.skipIf(not TEST_MKL, "PyTorch is built without MKL support")
+    def test_fft_plan_cache_mkl(self):
+        plan_cache = torch.backends.mkl.fft_plan_cache
+
+        @contextmanager
+        def plan_cache_max_size(n):
+            original = plan_cache.max_size
+            plan_cache.max_size = n
+            yield
+            plan_cache.max_size = original
+
+        with plan_cache_max_size(max(1, plan_cache.size - 10)):
+            self._test_fft_ifft_rfft_irfft(self)
+
+        with plan_cache_max_size(0):
+            self._test_fft_ifft_rfft_irfft(self)
+            self.assertEqual(plan_cache.size, 0)
+
+        plan_cache.clear()
+        self.assertEqual(plan_cache.size, 0)
+
+        # check that it still works after clearing cache
+        with plan_cache_max_size(10):
+            self._test_fft_ifft_rfft_irfft(self)
+            self.assertLessEqual(plan_cache.size, 10)
+            x = torch.randn(4, 16, dtype=torch.double)
+            plan_cache.clear()
+            y = x.rfft(1)
+            self.assertEqual(plan_cache.size, 1)
+            # a cache hit gives the same result and doesn't add a plan
+            self.assertEqual(x.rfft(1), y)
+            self.assertEqual(plan_cache.size, 1)
+
+        with self.assertRaisesRegex(RuntimeError, r"must be non-negative"):
+            plan_cache.max_size = -1
+
+        with self.assertRaisesRegex(RuntimeError, r"read-only property"):
+            plan_cache.size = -1
+
     @unittest.skip("Not implemented yet")
     def test_conv2(self):
         x = torch.rand(math.floor(torch.uniform(50, 100)), math.floor(torch.uniform(50, 100)))
@@ -3711,6 +3811,81 @@ class _TestTorchMixin(object):
         num_zeros = (torch.bernoulli(b) == 0).sum()
         self.assertEqual(num_zeros, 0)
 
+    def test_philox_fill_thread_count_invariance(self):
+        # Large contiguous tensors are filled from a Philox stream in parallel,
+        # the samples must not depend on the number of threads.
+        def sample(num_threads, dtype):
+            torch.set_num_threads(num_threads)
+            torch.manual_seed(123)
+            u = torch.empty(100003, dtype=dtype).uniform_(-2, 3)
+            n = torch.empty(100003, dtype=dtype).normal_(1, 2)
+            b = torch.empty(100003, dtype=dtype).bernoulli_(0.3)
+            return u, n, b
+
+        num_threads = torch.get_num_threads()
+        try:
+            for dtype in [torch.float, torch.double]:
+                single = sample(1, dtype)
+                multi = sample(max(num_threads, 4), dtype)
+                for x, y in zip(single, multi):
+                    self.assertEqual(x, y, 0)
+                u, n, b = multi
+                self.assertTrue(u.min() >= -2 and u.max() < 3)
+                self.assertEqual(u.mean(), 0.5, 0.05)
+                self.assertEqual(n.mean(), 1, 0.05)
+                self.assertEqual(n.std(), 2, 0.05)
+                self.assertEqual(b.mean(), 0.3, 0.01)
+        finally:
+            torch.set_num_threads(num_threads)
+
+    def test_philox_rejection_sampling_thread_count_invariance(self):
+        # Large contiguous gamma, poisson and dirichlet parameters are sampled
+        # in parallel from per-element Philox streams.
+        def sample(num_threads, dtype):
+            torch.set_num_threads(num_threads)
+            torch.manual_seed(123)
+            g = torch._standard_gamma(torch.full((20000,), 2.5, dtype=dtype))
+            p = torch.poisson(torch.tensor([3., 30.], dtype=dtype).repeat(10000))
+            d = torch._sample_dirichlet(torch.full((5000, 4), 0.5, dtype=dtype))
+            return g, p, d
+
+        num_threads = torch.get_num_threads()
+        try:
+            for dtype in [torch.float, torch.double]:
+                single = sample(1, dtype)
+                multi = sample(max(num_threads, 4), dtype)
+                for x, y in zip(single, multi):
+                    self.assertEqual(x, y, 0)
+                g, p, d = multi
+                self.assertEqual(g.mean(), 2.5, 0.05)
+                self.assertEqual(g.var(), 2.5, 0.15)
+                self.assertEqual(p[0::2].mean(), 3, 0.1)
+                self.assertEqual(p[1::2].mean(), 30, 0.3)
+                self.assertEqual(p[1::2].var(), 30, 2)
+                self.assertEqual(d.sum(-1), torch.ones(5000, dtype=dtype), 1e-5)
+                self.assertEqual(d.mean(0), torch.full((4,), 0.25, dtype=dtype), 0.01)
+        finally:
+            torch.set_num_threads(num_threads)
+
+    def test_multinomial_alias_draw_parallel(self):
+        probs = torch.tensor([0.5, 0.3, 0.15, 0.05], dtype=torch.double)
+        alias_table, prob_table = torch._multinomial_alias_setup(probs)
+        n_samples = 400000
+
+        def draw(num_threads):
+            torch.set_num_threads(num_threads)
+            torch.manual_seed(123)
+            return torch._multinomial_alias_draw(prob_table, alias_table, n_samples)
+
+        num_threads = torch.get_num_threads()
+        try:
+            samples = draw(max(num_threads, 4))
+            self.assertEqual(samples, draw(1), 0)
+        finally:
+            torch.set_num_threads(num_threads)
+        freqs = torch.bincount(samples, minlength=4).double() / n_samples
+        self.assertEqual(freqs, probs, 0.01)
+
     def test_generator_cpu(self):
         # test default generators are equal
         self.assertEqual(torch.default_generator, torch.default_generator)
@@ -3847,6 +4022,18 @@ class _TestTorchMixin(object):
         self.assertRaises(TypeError,
                           lambda: torch.isclose(x, x, torch.tensor(1.5), torch.tensor(1., requires_grad=True)).all())
 
+    def test_parsing_repeated_calls(self):
+        # the signature matched by a call is reused for later calls with the
+        # same argument types, which must not change which calls parse
+        x = torch.ones(5, 5)
+        for _ in range(3):
+            self.assertEqual(torch.cumsum(x, 0), torch.cumsum(x, torch.tensor(0)))
+            self.assertRaises(TypeError, lambda: torch.cumsum(x, torch.tensor(0.)))
+            self.assertRaises(TypeError, lambda: torch.cumsum(x, torch.tensor([0])))
+            self.assertEqual(torch.Size([3, 4]), torch.ones(torch.tensor(3), torch.tensor(4)).shape)
+            self.assertRaises(TypeError, lambda: torch.ones(torch.tensor(3.), torch.tensor(4)))
+            self.assertEqual(x.sum(0), x.sum((0,)))
+
     def test_parsing_intlist(self):
         #  parse with integer variables
         self.assertEqual(torch.Size([3, 4]), torch.ones((torch.tensor(3), torch.tensor(4))).shape)
@@ -4017,6 +4204,22 @@ class _TestTorchMixin(object):
             t2.fill_(rnum)
             self.assertEqual(t1, t2, 0)
 
+    def test_from_file_hints(self):
+        size = 10000
+        with tempfile.NamedTemporaryFile() as f:
+            s1 = torch.FloatStorage.from_file(f.name, True, size)
+            t1 = torch.FloatTensor(s1).copy_(torch.randn(size))
+
+            for access in [None, 'sequential', 'random', 'willneed']:
+                for populate in [False, True]:
+                    for shared in [False, True]:
+                        s2 = torch.FloatStorage.from_file(f.name, shared, size, populate=populate,
+                                                          access=access, huge_pages=True)
+                        self.assertEqual(t1, torch.FloatTensor(s2), 0)
+
+            with self.assertRaisesRegex(ValueError, "invalid access"):
+                torch.FloatStorage.from_file(f.name, True, size, access='backwards')
+
     @unittest.skipIf(IS_WINDOWS, "TODO: need to fix this test case for Windows")
     def test_torch_from_file(self):
         size = 10000
@@ -6348,6 +6551,51 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(a, b)
         self.assertEqual(w[:6], y.view(-1)[:6])
 
+    @onlyCPU
+    def test_cat_out_amortized_growth(self, device):
+        # an output that grows across calls is not reallocated on every call
+        x = torch.randn(2, 3, device=device)
+        out = torch.empty(0, device=device)
+        reallocations = 0
+        for i in range(1, 101):
+            data_ptr = out.data_ptr()
+            torch.cat([x] * i, out=out)
+            reallocations += out.data_ptr() != data_ptr
+            self.assertEqual(out, torch.cat([x] * i))
+        self.assertLess(reallocations, 20)
+
+        index = torch.arange(100, device=device)
+        out = torch.empty(0, device=device)
+        for i in range(1, 101):
+            torch.index_select(x, 0, index[:i] % 2, out=out)
+            self.assertEqual(out, x.index_select(0, index[:i] % 2))
+            self.assertTrue(out.is_contiguous())
+
+    def test_cat_many_small(self, device):
+        # thousands of inputs, among them legacy-skipped and zero-size ones
+        for dim in range(3):
+            shapes = []
+            for i in range(3000):
+                shape = [2, 3, 4]
+                shape[dim] = i % 3
+                shapes.append(shape)
+            inputs = [torch.randn(shape, device=device) for shape in shapes]
+            inputs[5] = torch.randn(0, device=device)
+            res = torch.cat(inputs, dim)
+            offset = 0
+            for t in inputs:
+                if t.dim() == 1:
+                    continue
+                self.assertEqual(res.narrow(dim, offset, t.size(dim)), t, 0)
+                offset += t.size(dim)
+            self.assertEqual(res.size(dim), offset)
+            # non-contiguous inputs take the copy path
+            res_t = torch.cat([t.transpose(0, 2) for t in inputs if t.dim() == 3], 2 - dim)
+            self.assertEqual(res_t, res.transpose(0, 2), 0)
+
+        with self.assertRaisesRegex(RuntimeError, 'scalar type'):
+            torch.cat([torch.zeros(2, device=device), torch.zeros(2, dtype=torch.long, device=device)])
+
     def test_is_set_to(self, device):
         t1 = torch.empty(3, 4, 9, 10, device=device)
         t2 = torch.empty(3, 4, 9, 10, device=device)
@@ -6394,6 +6642,41 @@ class TestTorchDeviceType(TestCase):
         self.assertEqual(torch.matmul(matrices, matrices_inverse),
                          torch.eye(3).to(device).expand_as(matrices))
 
+    @skipCUDAIfNoMagma
+    @skipCPUIfNoLapack
+    @dtypes(torch.float, torch.double)
+    def test_small_matrix_batched_linalg(self, device, dtype):
+        from torch.testing._internal.common_utils import \
+            (random_fullrank_matrix_distinct_singular_value, random_symmetric_pd_matrix)
+
+        prec = 1e-3 if dtype == torch.float else 1e-8
+        # The CPU kernels for matrices up to 8x8 work on several matrices at a
+        # time; a batch of 37 leaves a partial block at the end.
+        for n in range(1, 10):
+            A = random_fullrank_matrix_distinct_singular_value(n, 37, dtype=dtype).to(device)
+            b = torch.randn(37, n, 3, dtype=dtype, device=device)
+            self.assertEqual(torch.inverse(A), torch.stack([m.inverse() for m in A]), prec)
+            x, lu = torch.solve(b, A)
+            self.assertEqual(x, torch.stack([torch.solve(bi, m)[0] for bi, m in zip(b, A)]), prec)
+            self.assertEqual(torch.matmul(A, x), b, prec)
+            A_LU, pivots = torch.lu(A)
+            for m, m_lu, m_pivots in zip(A, A_LU, pivots):
+                expected_lu, expected_pivots = torch.lu(m)
+                self.assertEqual(m_lu, expected_lu, prec)
+                self.assertEqual(m_pivots, expected_pivots)
+            self.assertEqual(lu, A_LU, prec)
+            S = random_symmetric_pd_matrix(n, 37, dtype=dtype, device=device)
+            for upper in [True, False]:
+                self.assertEqual(torch.cholesky(S, upper=upper),
+                                 torch.stack([m.cholesky(upper=upper) for m in S]), prec)
+
+            singular = A.clone()
+            singular[20].zero_()
+            with self.assertRaisesRegex(RuntimeError, 'For batch 20'):
+                torch.inverse(singular)
+            _, _, infos = torch.lu(singular, get_infos=True)
+            self.assertEqual(infos.nonzero().flatten().tolist(), [20])
+
     @skipCUDAIfNoMagma
     @skipCPUIfNoLapack
     @dtypes(torch.double)
@@ -9673,6 +9956,41 @@ class TestTorchDeviceType(TestCase):
             self.assertTrue(y.is_contiguous())
             self.assertTrue(torch.allclose(expected, actual))
 
+    def test_cdist_topk(self, device):
+        # spans several tiles of x1 and x2
+        x = torch.randn(1100, 3, device=device)
+        y = torch.randn(5000, 3, device=device)
+        for p in [0, 1, 2, 3, float('inf')]:
+            for cm in ['use_mm_for_euclid_dist_if_necessary', 'use_mm_for_euclid_dist', 'donot_use_mm_for_euclid_dist']:
+                values, indices = torch.cdist_topk(x, y, 5, p=p, compute_mode=cm)
+                expected = torch.cdist(x, y, p=p, compute_mode='donot_use_mm_for_euclid_dist').topk(5, largest=False)
+                self.assertEqual(values, expected.values, 1e-4)
+                if p != 0:
+                    self.assertEqual(indices, expected.indices)
+
+        for k in [0, 1, 7]:
+            values, indices = torch.cdist_topk(x[:4], y[:7], k)
+            self.assertEqual(values.shape, (4, k))
+            self.assertEqual(values, brute_cdist(x[:4], y[:7]).topk(k, largest=False).values)
+        values, indices = torch.cdist_topk(x[:0], y, 3)
+        self.assertEqual(values.shape, (0, 3))
+
+        # close neighbours far from the origin keep their distances
+        center = torch.full((1, 8), 1000., dtype=torch.double, device=device)
+        y = center + torch.randn(100, 8, dtype=torch.double, device=device) * 1e-3
+        x = y[:30] + 1e-6
+        values, indices = torch.cdist_topk(x, y, 1, compute_mode='use_mm_for_euclid_dist')
+        self.assertEqual(indices.view(-1), torch.arange(30, device=device))
+        self.assertTrue(torch.allclose(values, torch.full_like(values, 1e-6 * 8 ** 0.5), rtol=1e-6))
+
+        x = torch.randn(6, 4, dtype=torch.double, device=device, requires_grad=True)
+        y = torch.randn(9, 4, dtype=torch.double, device=device, requires_grad=True)
+        for p in [1, 2, 3]:
+            self.assertTrue(torch.autograd.gradcheck(lambda x, y: torch.cdist_topk(x, y, 3, p=p)[0], (x, y)))
+
+        with self.assertRaisesRegex(RuntimeError, "must be in the range"):
+            torch.cdist_topk(x, y, 10)
+
     def test_multinomial_constraints(self, device):
         x = torch.empty(1, 2, 3, dtype=torch.double, device=device)
         self.assertRaisesRegex(
@@ -9933,6 +10251,29 @@ class TestTorchDeviceType(TestCase):
         # Check that output maintained correct shape
         self.assertEqual(raw_tensor.shape, raw_tensor.grad.shape)
 
+    def test_cumsum_cumprod_long_dims(self, device):
+        # long scans of few slices are split among threads on CPU
+        for shape, dim in [((100003,), 0), ((2, 50001), 1), ((30001, 3), 0), ((3, 20001, 17), 1)]:
+            x = torch.randint(-100, 100, shape, device=device)
+            expected = torch.from_numpy(np.cumsum(x.cpu().numpy(), axis=dim))
+            self.assertEqual(torch.cumsum(x, dim).cpu(), expected, 0)
+            self.assertEqual(torch.cumsum(x.double(), dim).cpu(), expected.double(), 0)
+            # non-contiguous input
+            self.assertEqual(torch.cumsum(x.transpose(0, -1), x.dim() - 1 - dim).cpu(),
+                             expected.transpose(0, -1), 0)
+
+            y = torch.empty(shape, dtype=torch.double, device=device).uniform_(0.999, 1.001)
+            expected = torch.from_numpy(np.cumprod(y.cpu().numpy(), axis=dim))
+            self.assertEqual(torch.cumprod(y, dim).cpu(), expected, 1e-8)
+            # non-contiguous result
+            out = torch.empty(shape[::-1], dtype=torch.double, device=device).permute(*reversed(range(len(shape))))
+            torch.cumprod(y, dim, out=out)
+            self.assertEqual(out.cpu(), expected, 1e-8)
+
+        b = torch.zeros(100003, dtype=torch.bool, device=device)
+        b[70000] = True
+        self.assertEqual(torch.cumsum(b, 0), (torch.arange(100003, device=device) >= 70000).long())
+
     def test_cummax_cummin(self, device):
         def test_ops(op, string_of_function_name, expected_output):
             x = torch.rand(100, 100, device=device)
@@ -10214,6 +10555,25 @@ class TestTorchDeviceType(TestCase):
             # not the data
             self.assertEqual(x, y)
 
+    def test_copy_transpose_tiled(self, device):
+        # large transposed copies go through a tiled transpose
+        rows, cols = 67, 130
+        expected = (torch.arange(rows, device=device) * cols).unsqueeze(0) + torch.arange(cols, device=device).unsqueeze(1)
+        for dt in [torch.bool, torch.uint8, torch.int16, torch.half, torch.int, torch.float, torch.long, torch.double]:
+            x = torch.arange(rows * cols, device=device).reshape(rows, cols).to(dt)
+            y = x.t().contiguous()
+            self.assertTrue(y.is_contiguous())
+            self.assertEqual(y.long(), expected.to(dt).long(), 0)
+
+        x = torch.randn(3, 19, 37, 41, device=device)
+        y = x.contiguous(memory_format=torch.channels_last)
+        self.assertEqual(y, x, 0)
+        self.assertEqual(y.contiguous(), x, 0)
+
+        # transposes of views of larger tensors
+        x = torch.randn(200, 300, device=device)[10:150:2, 7:250]
+        self.assertEqual(x.t().contiguous().cpu(), torch.from_numpy(x.cpu().numpy().T.copy()), 0)
+
     def test_resize_all_dtypes_and_devices(self, device):
         shape = (2, 2)
         for dt in torch.testing.get_all_dtypes():
@@ -10574,6 +10934,50 @@ class TestTorchDeviceType(TestCase):
         dest = torch.index_select(src, 0, idx)
         self.assertEqual(torch.tensor([True]), dest)
 
+    @dtypes(torch.float, torch.double, torch.long, torch.bool)
+    def test_index_select_inner_dims(self, device, dtype):
+        src = torch.randint(0, 2 if dtype == torch.bool else 100, (4, 6, 5, 3), device=device).to(dtype)
+        idx = torch.tensor([5, 0, 0, 3], device=device)
+        for dim in range(src.dim()):
+            index = idx.remainder(src.size(dim))
+            dest = torch.index_select(src, dim, index)
+            for i in range(index.size(0)):
+                self.assertEqual(dest.select(dim, i), src.select(dim, index[i]))
+            # non-contiguous self takes the strided path
+            dest_t = torch.index_select(src.transpose(0, dim), 0, index)
+            self.assertEqual(dest_t, dest.transpose(0, dim))
+        if self.device_type == 'cpu':
+            self.assertRaises(IndexError, lambda: torch.index_select(src, 2, torch.tensor([5])))
+            self.assertRaises(IndexError, lambda: torch.index_select(src.view(-1), 0, torch.tensor([-1])))
+
+    @dtypes(torch.float, torch.double, torch.long)
+    def test_gather_scatter_add_row_index(self, device, dtype):
+        # message passing: one index per row, expanded along the features
+        num_nodes, num_edges, num_features = 13, 200, 19
+        edge_index = torch.randint(0, num_nodes, (num_edges,), device=device)
+        for dim, shape in ((0, (num_edges, num_features)), (1, (3, num_edges, num_features))):
+            index_shape = [1] * len(shape)
+            index_shape[dim] = num_edges
+            index = edge_index.view(index_shape).expand(shape)
+            src = torch.randint(-10, 10, shape, device=device).to(dtype)
+            self_shape = list(shape)
+            self_shape[dim] = num_nodes
+            nodes = torch.randint(-10, 10, self_shape, device=device).to(dtype)
+
+            self.assertEqual(nodes.gather(dim, index), nodes.gather(dim, index.contiguous()))
+            self.assertEqual(nodes.gather(dim, index), nodes.index_select(dim, edge_index))
+
+            expected = nodes.clone().index_add_(dim, edge_index, src)
+            self.assertEqual(nodes.clone().scatter_add_(dim, index, src), expected)
+            self.assertEqual(nodes.clone().scatter_add_(dim, index.contiguous(), src), expected)
+
+            if self.device_type == 'cpu':
+                bad_index = edge_index.clone()
+                bad_index[0] = num_nodes
+                bad_index = bad_index.view(index_shape).expand(shape)
+                self.assertRaises(RuntimeError, lambda: nodes.gather(dim, bad_index))
+                self.assertRaises(RuntimeError, lambda: nodes.clone().scatter_add_(dim, bad_index, src))
+
     def test_take_empty(self, device):
         for input_shape in [(0,), (0, 1, 2, 0), (1, 2, 3)]:
             for indices_shape in [(0,), (0, 1, 2, 0)]:
@@ -11824,6 +12228,22 @@ class TestTorchDeviceType(TestCase):
         b = torch.randn(1, device=device)
         self.assertRaises(RuntimeError, lambda: torch.ceil(a, out=b))
 
+    @onlyCUDA
+    @dtypes(torch.uint8, torch.int16, torch.half, torch.float, torch.double)
+    def test_elementwise_vectorized_offsets(self, device, dtype):
+        # offsets into the storage select every vectorized access width,
+        # sizes cover full blocks as well as the remainder
+        for offset in range(17):
+            for size in [1, 15, 1000, 4097]:
+                # small integers are exact in every dtype; the reference is
+                # computed in float since CPU half arithmetic is limited
+                a = torch.randint(0, 10, (offset + size,)).float()
+                b = torch.randint(0, 10, (offset + size,)).float()
+                a_cuda = a.to(device=device, dtype=dtype)[offset:]
+                b_cuda = b.to(device=device, dtype=dtype)[offset:]
+                self.assertEqual((a_cuda + b_cuda).cpu().float(), a[offset:] + b[offset:])
+                self.assertEqual(a_cuda.lt(b_cuda).cpu(), a[offset:].lt(b[offset:]))
+
 
     @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
     def test_has_storage_numpy(self, device):
@@ -12298,6 +12718,31 @@ class TestTorchDeviceType(TestCase):
                                     count += 1
                             self.assertEqual(j, count)
 
+    @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+    @dtypes(torch.float, torch.int32, torch.int64)
+    def test_unique_many(self, device, dtype):
+        x = torch.randint(-5000, 5000, (100000,), device=device).to(dtype)
+        expected_unique, expected_inverse, expected_counts = np.unique(
+            x.cpu().numpy(), return_inverse=True, return_counts=True)
+        unique, inverse, counts = torch.unique(x, sorted=True, return_inverse=True, return_counts=True)
+        self.assertEqual(unique.cpu(), torch.from_numpy(expected_unique))
+        self.assertEqual(inverse.cpu(), torch.from_numpy(expected_inverse))
+        self.assertEqual(counts.cpu(), torch.from_numpy(expected_counts))
+
+        unique, inverse, counts = torch.unique(x, sorted=False, return_inverse=True, return_counts=True)
+        self.assertEqual(unique.sort()[0].cpu(), torch.from_numpy(expected_unique))
+        self.assertEqual(unique[inverse], x)
+        self.assertEqual(counts.sum(), x.numel())
+        for j in range(0, unique.numel(), 97):
+            self.assertEqual(counts[j].item(), (x == unique[j]).sum().item())
+
+        # unsorted unique keeps the order of first occurrence on every device
+        cpu_unique, cpu_inverse, cpu_counts = torch.unique(
+            x.cpu(), sorted=False, return_inverse=True, return_counts=True)
+        self.assertEqual(unique.cpu(), cpu_unique)
+        self.assertEqual(inverse.cpu(), cpu_inverse)
+        self.assertEqual(counts.cpu(), cpu_counts)
+
     @dtypes(*set(torch.testing.get_all_dtypes()) - {torch.bfloat16})
     def test_unique_consecutive(self, device, dtype):
         if dtype is torch.half and self.device_type == 'cpu':
@@ -13476,6 +13921,46 @@ class TestTorchDeviceType(TestCase):
             self.assertRaises(RuntimeError, lambda: torch.bmm(b1, b2.cuda()))
             self.assertRaises(RuntimeError, lambda: torch.bmm(b1.cuda(), b2))
 
+    @onlyCPU
+    @dtypes(torch.complex64, torch.complex128)
+    def test_mm_bmm_complex(self, device, dtype):
+        real_dtype = torch.float if dtype == torch.complex64 else torch.double
+
+        def randn(*sizes):
+            re = torch.randn(*sizes, dtype=real_dtype, device=device)
+            im = torch.randn(*sizes, dtype=real_dtype, device=device)
+            return re, im
+
+        def to_complex(re, im):
+            return re.to(dtype) + im.to(dtype) * 1j
+
+        def check(res, re, im):
+            # Copying to a real dtype keeps the real part.
+            self.assertEqual(res.to(real_dtype), re)
+            self.assertEqual((res * -1j).to(real_dtype), im)
+
+        for n, m, p in [(2, 3, 4), (20, 10, 5), (1, 18, 1)]:
+            a_re, a_im = randn(n, m)
+            b_re, b_im = randn(m, p)
+            res_re = a_re.mm(b_re) - a_im.mm(b_im)
+            res_im = a_re.mm(b_im) + a_im.mm(b_re)
+            a, b = to_complex(a_re, a_im), to_complex(b_re, b_im)
+            check(torch.mm(a, b), res_re, res_im)
+            check(torch.mm(a.t().contiguous().t(), b.t().contiguous().t()), res_re, res_im)
+            out = torch.empty(0, dtype=dtype, device=device)
+            torch.mm(a, b, out=out)
+            check(out, res_re, res_im)
+
+        for M, N, O in [(2, 3, 4), (23, 8, 12)]:
+            a_re, a_im = randn(5, M, N)
+            b_re, b_im = randn(5, N, O)
+            res_re = a_re.bmm(b_re) - a_im.bmm(b_im)
+            res_im = a_re.bmm(b_im) + a_im.bmm(b_re)
+            a, b = to_complex(a_re, a_im), to_complex(b_re, b_im)
+            check(torch.bmm(a, b), res_re, res_im)
+            check(torch.bmm(a.transpose(1, 2).contiguous().transpose(1, 2), b), res_re, res_im)
+            check(torch.baddbmm(torch.bmm(a, b), a, b, beta=0.5, alpha=2), 2.5 * res_re, 2.5 * res_im)
+
     @onlyCPU
     @dtypes(torch.float)
     def test_addbmm(self, device, dtype):
@@ -13979,6 +14464,31 @@ class TestDevicePrecision(TestCase):
             self.assertEqual(actual[~torch.isnan(actual)],
                              expected[~torch.isnan(expected)], 'nans for {}'.format(name))
 
+    @dtypesIfCUDA(torch.half, torch.float, torch.double, torch.int, torch.long, torch.uint8)
+    @dtypes(torch.float, torch.double, torch.int, torch.long, torch.uint8)
+    def test_aminmax(self, device, dtype):
+        # sizes cover the vectorized body and the scalar tail, contiguous or not
+        for shape in [(1,), (5, 7), (3, 1031), (64, 130)]:
+            x = torch.randint(0, 100, shape, device=device).to(dtype)
+            mn, mx = torch._aminmax(x)
+            self.assertEqual(mn, x.min())
+            self.assertEqual(mx, x.max())
+            for dim in range(x.dim()):
+                for keepdim in [False, True]:
+                    mn, mx = torch._aminmax(x, dim, keepdim)
+                    self.assertEqual(mn, x.min(dim, keepdim)[0])
+                    self.assertEqual(mx, x.max(dim, keepdim)[0])
+            mn, mx = torch._aminmax(x.t(), 0)
+            self.assertEqual(mn, x.t().min(0)[0])
+            self.assertEqual(mx, x.t().max(0)[0])
+        if dtype.is_floating_point:
+            x = torch.arange(1000.0, device=device).to(dtype)
+            x[517] = nan
+            mn, mx = torch._aminmax(x)
+            self.assertTrue(torch.isnan(mn) and torch.isnan(mx))
+        with self.assertRaisesRegex(RuntimeError, 'no elements'):
+            torch._aminmax(torch.empty(0, device=device, dtype=dtype))
+
     @dtypesIfCUDA(torch.half, torch.float, torch.double,
                   torch.int8, torch.short, torch.int, torch.long,
                   torch.uint8)
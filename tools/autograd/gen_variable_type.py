@@ -92,6 +92,13 @@ DONT_PROFILE = {
     'size', 'storage_offset', 'stride',
 }
 
+# The profiler estimates the FLOPs of these from their int arguments (the
+# geometry of the convolution), so they are recorded along with the tensors
+# and scalars.
+RECORD_INT_ARGUMENTS = {
+    'conv1d', 'conv2d', 'conv3d', 'convolution', '_convolution',
+}
+
 # We don't set or modify grad_fn on these methods. Generally, they return
 # tensors that have requires_grad=False. In-place functions listed here will
 # not examine or modify requires_grad or grad_fn.
@@ -267,8 +274,10 @@ if (${cond}) {
 }
 """)
 
+# The symbol is interned once, instead of on every traced call
 OP_NAME = CodeTemplate("""\
-op_name = jit::Symbol::fromQualString("aten::${trace_name}");
+static const auto trace_op_name = jit::Symbol::fromQualString("aten::${trace_name}");
+op_name = trace_op_name;
 """)
 
 PRE_RECORD_TRACE = CodeTemplate("""\
@@ -922,6 +931,8 @@ def emit_body(declaration):
         return ['increment_version({});'.format(arg['name']) for arg in differentiable_outputs]
 
     def check_record_function_input_type(simple_type):
+        if base_name in RECORD_INT_ARGUMENTS and simple_type in ['IntArrayRef', 'int64_t', 'bool']:
+            return True
         return simple_type in ['Tensor', 'Scalar']
 
     def record_function_input_names():
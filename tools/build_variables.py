@@ -35,6 +35,7 @@ libtorch_sources = [
     "torch/csrc/autograd/VariableTypeManual.cpp",
     "torch/csrc/autograd/anomaly_mode.cpp",
     "torch/csrc/autograd/autograd.cpp",
+    "torch/csrc/autograd/checkpoint.cpp",
     "torch/csrc/autograd/custom_function.cpp",
     "torch/csrc/autograd/cpp_hook.cpp",
     "torch/csrc/autograd/engine.cpp",
@@ -48,6 +49,7 @@ libtorch_sources = [
     "torch/csrc/autograd/profiler.cpp",
     "torch/csrc/autograd/record_function.cpp",
     "torch/csrc/autograd/record_function_ops.cpp",
+    "torch/csrc/autograd/saved_tensor_hooks.cpp",
     "torch/csrc/autograd/saved_variable.cpp",
     "torch/csrc/autograd/variable.cpp",
     "torch/csrc/distributed/autograd/utils.cpp",
@@ -101,6 +103,7 @@ libtorch_sources = [
     "torch/csrc/jit/jit_log.cpp",
     "torch/csrc/jit/netdef_converter.cpp",
     "torch/csrc/jit/register_c10_ops.cpp",
+    "torch/csrc/jit/static_runtime.cpp",
     "torch/csrc/jit/subgraph_matcher.cpp",
     "torch/csrc/jit/symbolic_script.cpp",
     "torch/csrc/jit/profiling_graph_executor_impl.cpp",
@@ -120,6 +123,7 @@ libtorch_sources = [
     "torch/csrc/jit/passes/dead_code_elimination.cpp",
     "torch/csrc/jit/passes/erase_number_types.cpp",
     "torch/csrc/jit/passes/fixup_trace_scope_blocks.cpp",
+    "torch/csrc/jit/passes/fork_independent_branches.cpp",
     "torch/csrc/jit/passes/graph_fuser.cpp",
     "torch/csrc/jit/passes/guard_elimination.cpp",
     "torch/csrc/jit/passes/inline_autodiff_subgraphs.cpp",
@@ -137,6 +141,9 @@ libtorch_sources = [
     "torch/csrc/jit/passes/python_print.cpp",
     "torch/csrc/jit/passes/quantization.cpp",
     "torch/csrc/jit/passes/fuse_linear.cpp",
+    "torch/csrc/jit/passes/freeze_module.cpp",
+    "torch/csrc/jit/passes/fuse_dropout_add_layer_norm.cpp",
+    "torch/csrc/jit/passes/mkldnn_layout.cpp",
     "torch/csrc/jit/passes/remove_expands.cpp",
     "torch/csrc/jit/passes/requires_grad_analysis.cpp",
     "torch/csrc/jit/passes/shape_analysis.cpp",
@@ -174,11 +181,13 @@ libtorch_sources = [
     "torch/csrc/jit/script/object.cpp",
     "torch/csrc/jit/script/string_to_type.cpp",
     "torch/csrc/jit/tracer.cpp",
+    "torch/csrc/jit/fuser/disk_cache.cpp",
     "torch/csrc/jit/fuser/kernel_cache.cpp",
     "torch/csrc/jit/fuser/compiler.cpp",
     "torch/csrc/jit/fuser/executor.cpp",
     "torch/csrc/jit/fuser/codegen.cpp",
     "torch/csrc/jit/fuser/fallback.cpp",
+    "torch/csrc/jit/fuser/cpu/vectorized_kernel.cpp",
     "torch/csrc/jit/fuser/cpu/fused_kernel.cpp",
     "torch/csrc/jit/fuser/interface.cpp",
     "torch/csrc/jit/function.cpp",
@@ -189,6 +198,7 @@ libtorch_sources = [
     "torch/csrc/jit/mobile/module.cpp",
     "torch/csrc/jit/mobile/register_mobile_ops.cpp",
     "torch/csrc/jit/mobile/interpreter.cpp",
+    "torch/csrc/jit/mobile/observer.cpp",
     "torch/csrc/jit/mobile/type_parser.cpp",
     "torch/csrc/utils/byte_order.cpp",
     "torch/csrc/utils/tensor_flatten.cpp",
@@ -216,7 +226,9 @@ def add_torch_libs():
 
     torch_cpp_srcs = [
         "torch/csrc/api/src/cuda.cpp",  # this just forwards stuff, no real CUDA
+        "torch/csrc/api/src/data/datasets/mapped_tensor.cpp",
         "torch/csrc/api/src/data/datasets/mnist.cpp",
+        "torch/csrc/api/src/data/detail/worker_process.cpp",
         "torch/csrc/api/src/data/samplers/distributed.cpp",
         "torch/csrc/api/src/data/samplers/random.cpp",
         "torch/csrc/api/src/data/samplers/sequential.cpp",
@@ -286,6 +298,7 @@ def add_torch_libs():
         "torch/csrc/Module.cpp",
         "torch/csrc/PtrWrapper.cpp",
         "torch/csrc/python_dimname.cpp",
+        "torch/csrc/ShmRingBuffer.cpp",
         "torch/csrc/Size.cpp",
         "torch/csrc/Storage.cpp",
         "torch/csrc/TypeInfo.cpp",
@@ -310,6 +323,7 @@ def add_torch_libs():
         "torch/csrc/distributed/rpc/python_functions.cpp",
         "torch/csrc/distributed/rpc/python_rpc_handler.cpp",
         "torch/csrc/distributed/rpc/request_callback_impl.cpp",
+        "torch/csrc/distributed/rpc/socket_agent.cpp",
         "torch/csrc/jit/init.cpp",
         "torch/csrc/jit/passes/inline_fork_wait.cpp",
         "torch/csrc/jit/passes/onnx.cpp",
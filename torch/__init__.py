@@ -22,6 +22,7 @@ from ._six import string_classes as _string_classes
 
 __all__ = [
     'typename', 'is_tensor', 'is_storage', 'set_default_tensor_type',
+    'set_deterministic', 'is_deterministic',
     'set_rng_state', 'get_rng_state', 'manual_seed', 'initial_seed', 'seed',
     'save', 'load', 'set_printoptions', 'chunk', 'split', 'stack', 'matmul',
     'no_grad', 'enable_grad', 'rand', 'randn',
@@ -216,6 +217,29 @@ def set_default_dtype(d):
     """
     _C._set_default_dtype(d)
 
+
+def set_deterministic(d):
+    r"""Sets whether operators that have both a deterministic and a faster
+    nondeterministic implementation must use the deterministic one.
+
+    Off by default. Currently this selects the sort-based instead of the
+    atomic-add based accumulation of :meth:`~Tensor.index_put_` with
+    ``accumulate=True`` on CUDA. cuDNN is controlled separately by
+    ``torch.backends.cudnn.deterministic``.
+
+    Args:
+        d (bool): whether to require deterministic implementations
+    """
+    _C._set_deterministic(d)
+
+
+def is_deterministic():
+    r"""Returns whether deterministic implementations are required, see
+    :func:`torch.set_deterministic`.
+    """
+    return _C._get_deterministic()
+
+
 # If you edit these imports, please update torch/__init__.py.in as well
 from .random import set_rng_state, get_rng_state, manual_seed, initial_seed, seed
 from .serialization import save, load
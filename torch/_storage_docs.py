@@ -28,7 +28,7 @@ def add_docstr_all(method, docstr):
 
 add_docstr_all('from_file',
                """
-from_file(filename, shared=False, size=0) -> Storage
+from_file(filename, shared=False, size=0, populate=False, access=None, huge_pages=False) -> Storage
 
 If `shared` is `True`, then memory is shared between all processes.
 All changes are written to the file. If `shared` is `False`, then the changes on
@@ -39,8 +39,20 @@ then the file must contain at least `size * sizeof(Type)` bytes
 (`Type` is the type of storage). If `shared` is `True` the file will be
 created if needed.
 
+The file is mapped lazily: every page is read from the file on its first
+access. `populate`, `access` and `huge_pages` tell the kernel how the storage
+is going to be used, to avoid the page faults that this incurs. They are only
+hints, and are ignored where the platform doesn't support them.
+
 Args:
     filename (str): file name to map
     shared (bool): whether to share memory
     size (int): number of elements in the storage
+    populate (bool): read the whole file before returning, instead of on the
+        first access of every page
+    access (str, optional): how the storage is going to be read:
+        ``'sequential'`` (read ahead aggressively), ``'random'`` (don't read
+        ahead) or ``'willneed'`` (start reading the whole file in the
+        background)
+    huge_pages (bool): back the storage by huge pages
 """)
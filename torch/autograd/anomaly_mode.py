@@ -14,6 +14,15 @@ class detect_anomaly(object):
         This mode should be enabled only for debugging as the different tests
         will slow down your program execution.
 
+    With ``lightweight=True``, the forward pass only records a compact id of
+    the stack of each operation, and the traceback is formatted when an error
+    is reported. Backward computations generating "inf" values also raise an
+    error. This mode is much cheaper and can stay enabled on long runs.
+
+    Arguments:
+        lightweight (bool, optional): Whether to use the lightweight mode.
+            Default: ``False``.
+
     Example:
 
         >>> import torch
@@ -65,14 +74,16 @@ class detect_anomaly(object):
 
     """
 
-    def __init__(self):
+    def __init__(self, lightweight=False):
         self.prev = torch.is_anomaly_enabled()
+        self.prev_lightweight = torch._C._is_anomaly_lightweight()
+        self.lightweight = lightweight
 
     def __enter__(self):
-        torch.set_anomaly_enabled(True)
+        torch.set_anomaly_enabled(True, self.lightweight)
 
     def __exit__(self, *args):
-        torch.set_anomaly_enabled(self.prev)
+        torch.set_anomaly_enabled(self.prev, self.prev_lightweight)
         return False
 
 
@@ -88,16 +99,19 @@ class set_detect_anomaly(object):
     Arguments:
         mode (bool): Flag whether to enable anomaly detection (``True``),
                      or disable (``False``).
+        lightweight (bool, optional): Whether to use the lightweight mode of
+            ``detect_anomaly``. Default: ``False``.
 
     """
 
-    def __init__(self, mode):
+    def __init__(self, mode, lightweight=False):
         self.prev = torch.is_anomaly_enabled()
-        torch.set_anomaly_enabled(mode)
+        self.prev_lightweight = torch._C._is_anomaly_lightweight()
+        torch.set_anomaly_enabled(mode, lightweight)
 
     def __enter__(self):
         pass
 
     def __exit__(self, *args):
-        torch.set_anomaly_enabled(self.prev)
+        torch.set_anomaly_enabled(self.prev, self.prev_lightweight)
         return False
@@ -24,9 +24,15 @@ class EventList(list):
     """A list of Events (for pretty printing)"""
     def __init__(self, *args, **kwargs):
         use_cuda = kwargs.pop('use_cuda', True)
+        profile_memory = kwargs.pop('profile_memory', False)
+        with_flops = kwargs.pop('with_flops', False)
+        record_hw_counters = kwargs.pop('record_hw_counters', False)
         super(EventList, self).__init__(*args, **kwargs)
         self._cpu_children_populated = False
         self._use_cuda = use_cuda
+        self._profile_memory = profile_memory
+        self._with_flops = with_flops
+        self._record_hw_counters = record_hw_counters
 
     def __str__(self):
         return self.table()
@@ -100,13 +106,20 @@ class EventList(list):
             sort_by (str, optional): Attribute used to sort entries. By default
                 they are printed in the same order as they were registered.
                 Valid keys include: ``cpu_time``, ``cuda_time``, ``cpu_time_total``,
-                ``cuda_time_total``, ``count``.
+                ``cuda_time_total``, ``count``, and with memory profiling
+                ``self_cpu_memory_usage``, ``cpu_peak_memory_usage``,
+                ``self_cuda_memory_usage`` and ``cuda_peak_memory_usage``, with
+                FLOP estimates ``flops``, ``bytes``, ``gflops_per_s`` and
+                ``gbytes_per_s``, and with hardware counters ``cycles``,
+                ``instructions`` and ``llc_misses``.
 
         Returns:
             A string containing the table.
         """
         return build_table(
-            self, sort_by=sort_by, row_limit=row_limit, header=header, use_cuda=self._use_cuda)
+            self, sort_by=sort_by, row_limit=row_limit, header=header, use_cuda=self._use_cuda,
+            profile_memory=self._profile_memory, with_flops=self._with_flops,
+            record_hw_counters=self._record_hw_counters)
 
     def export_chrome_trace(self, path):
         """Exports an EventList as a Chrome tracing tools file.
@@ -189,7 +202,8 @@ class EventList(list):
         for evt in self:
             stats[get_key(evt, group_by_input_shapes)].add(
                 evt, group_by_input_shapes)
-        return EventList(stats.values(), use_cuda=self._use_cuda)
+        return EventList(stats.values(), use_cuda=self._use_cuda, profile_memory=self._profile_memory,
+                         with_flops=self._with_flops, record_hw_counters=self._record_hw_counters)
 
     def total_average(self):
         """Averages all events.
@@ -230,6 +244,23 @@ class profile(object):
             self cpu time might be artificially increased because of the shape
             collection.
 
+        profile_memory (bool, optional): Records the allocations and frees of
+            the CPU allocators and the CUDA caching allocator, and reports for
+            each function the memory it allocated itself and its peak memory
+            usage: the most memory allocated by it and its children that was
+            not freed yet, at any point while it ran. Default: ``False``
+
+        with_flops (bool, optional): Estimates the floating point operations
+            and the bytes read and written by matrix multiplies, convolutions
+            and pointwise ops from the shapes of their inputs, and reports the
+            achieved GFLOP/s and GB/s of each function, over its CUDA time if
+            ``use_cuda`` is set and over its CPU time otherwise. Default: ``False``
+
+        record_hw_counters (bool, optional): Samples the CPU cycles,
+            instructions and last level cache misses of the thread, in user
+            space, at the start and end of each function. Linux only, and
+            subject to ``/proc/sys/kernel/perf_event_paranoid``. Default: ``False``
+
     .. warning:
         This context managers should not be called recursively, i.e. at most one
         instance should be enabled at any given time.
@@ -259,7 +290,8 @@ class profile(object):
         -----------------------------------  ---------------  ---------------  ---------------
 
     """
-    def __init__(self, enabled=True, use_cuda=False, record_shapes=False):
+    def __init__(self, enabled=True, use_cuda=False, record_shapes=False, profile_memory=False,
+                 with_flops=False, record_hw_counters=False):
         self.enabled = enabled
         self.use_cuda = use_cuda
         self.function_events = None
@@ -267,6 +299,9 @@ class profile(object):
             return
         self.entered = False
         self.record_shapes = record_shapes
+        self.profile_memory = profile_memory
+        self.with_flops = with_flops
+        self.record_hw_counters = record_hw_counters
 
     def __enter__(self):
         if not self.enabled:
@@ -277,14 +312,17 @@ class profile(object):
         profiler_kind = torch.autograd.ProfilerState.CUDA if self.use_cuda \
             else torch.autograd.ProfilerState.CPU
         torch.autograd._enable_profiler(
-            torch.autograd.ProfilerConfig(profiler_kind, self.record_shapes))
+            torch.autograd.ProfilerConfig(profiler_kind, self.record_shapes, self.profile_memory,
+                                          self.with_flops, self.record_hw_counters))
         return self
 
     def __exit__(self, exc_type, exc_val, exc_tb):
         if not self.enabled:
             return
         records = torch.autograd._disable_profiler()
-        self.function_events = EventList(parse_cpu_trace(records), use_cuda=self.use_cuda)
+        self.function_events = EventList(
+            parse_cpu_trace(records), use_cuda=self.use_cuda, profile_memory=self.profile_memory,
+            with_flops=self.with_flops, record_hw_counters=self.record_hw_counters)
         return False
 
     def __repr__(self):
@@ -366,12 +404,17 @@ class record_function(ContextDecorator):
     """
     def __init__(self, name):
         self.name = name
+        self.handle = None
 
     def __enter__(self):
-        self.handle = torch.ops.profiler._record_function_enter(self.name)
+        # Nothing would observe the range, skip the ops.
+        if torch.autograd._has_record_function_callbacks():
+            self.handle = torch.ops.profiler._record_function_enter(self.name)
 
     def __exit__(self, *args):
-        torch.ops.profiler._record_function_exit(self.handle)
+        if self.handle is not None:
+            torch.ops.profiler._record_function_exit(self.handle)
+            self.handle = None
         return False
 
 
@@ -404,6 +447,9 @@ class emit_nvtx(object):
             Arguments will be listed in the order they are received by the backend op.
             Please note that this order may not match the order in which those arguments were passed
             on the Python side.  Also note that shape recording may increase the overhead of nvtx range creation.
+        names_only (bool, optional, default=False): If ``names_only=True``, ranges are only named after
+            the op, without sequence numbers or shapes, and are emitted directly from the op's
+            ``RecordFunction``, which makes them much cheaper. Can't be combined with ``record_shapes``.
 
     Example:
         >>> with torch.cuda.profiler.profile():
@@ -456,10 +502,13 @@ class emit_nvtx(object):
         backward Function object.  You may need to make a judgment based on analytic knowledge of what
         the expected correspondence should be.
     """
-    def __init__(self, enabled=True, record_shapes=False):
+    def __init__(self, enabled=True, record_shapes=False, names_only=False):
+        if names_only and record_shapes:
+            raise ValueError("emit_nvtx: names_only can't be combined with record_shapes")
         self.enabled = enabled
         self.entered = False
         self.record_shapes = record_shapes
+        self.names_only = names_only
 
     def __enter__(self):
         if not self.enabled:
@@ -468,19 +517,25 @@ class emit_nvtx(object):
             raise RuntimeError("NVTX annotation context manager is not reentrant")
         self.entered = True
         torch.cuda.synchronize()
-        torch.autograd._enable_profiler(
-            torch.autograd.ProfilerConfig(
-                torch.autograd.ProfilerState.NVTX,
-                self.record_shapes
+        if self.names_only:
+            torch.autograd._enable_nvtx_ranges()
+        else:
+            torch.autograd._enable_profiler(
+                torch.autograd.ProfilerConfig(
+                    torch.autograd.ProfilerState.NVTX,
+                    self.record_shapes
+                )
             )
-        )
         return self
 
     def __exit__(self, exc_type, exc_val, exc_tb):
         if not self.enabled:
             return
         torch.cuda.synchronize()
-        torch.autograd._disable_profiler()
+        if self.names_only:
+            torch.autograd._disable_nvtx_ranges()
+        else:
+            torch.autograd._disable_profiler()
         return False
 
 
@@ -515,6 +570,36 @@ def format_time_share(time_us, total_time_us):
     return '{:.2f}%'.format(time_us * 100.0 / total_time_us)
 
 
+def format_memory(nbytes):
+    """Returns a formatted memory size string"""
+    KB = 1024
+    MB = 1024 * KB
+    GB = 1024 * MB
+    if abs(nbytes) >= GB:
+        return '{:.2f} Gb'.format(nbytes * 1.0 / GB)
+    elif abs(nbytes) >= MB:
+        return '{:.2f} Mb'.format(nbytes * 1.0 / MB)
+    elif abs(nbytes) >= KB:
+        return '{:.2f} Kb'.format(nbytes * 1.0 / KB)
+    else:
+        return str(nbytes) + ' b'
+
+
+def format_count(count):
+    """Returns a formatted large count, e.g. of hardware events"""
+    for scale, suffix in ((1e12, 'T'), (1e9, 'G'), (1e6, 'M'), (1e3, 'K')):
+        if abs(count) >= scale:
+            return '{:.2f}{}'.format(count / scale, suffix)
+    return str(count)
+
+
+def format_rate(amount, time_us):
+    """Returns amount / time_us as a per second rate, in units of 10^9"""
+    if amount == 0 or time_us <= 0:
+        return ''
+    return '{:.2f}'.format(amount / (time_us * 1e3))
+
+
 def attr_formatter(name):
     return property(lambda self: format_time(getattr(self, name)))
 
@@ -539,6 +624,32 @@ class FormattedTimesMixin(object):
         return 0.0 if self.count == 0 else 1.0 * self.cuda_time_total / self.count
 
 
+class CostMixin(object):
+    """Achieved rates of FunctionEvent and FunctionEventAvg.
+
+    The subclass should define `flops`, `bytes`, `cpu_time_total` and
+    `cuda_time_total`. GPU work is measured against the CUDA time, which is
+    only recorded with ``use_cuda``.
+    """
+    @property
+    def _cost_time_us(self):
+        return self.cuda_time_total if self.cuda_time_total > 0 else self.cpu_time_total
+
+    @property
+    def gflops_per_s(self):
+        time_us = self._cost_time_us
+        return 0.0 if time_us <= 0 else self.flops / (time_us * 1e3)
+
+    @property
+    def gbytes_per_s(self):
+        time_us = self._cost_time_us
+        return 0.0 if time_us <= 0 else self.bytes / (time_us * 1e3)
+
+    @property
+    def ipc(self):
+        return 0.0 if not self.cycles else 1.0 * self.instructions / self.cycles
+
+
 class Interval(object):
     def __init__(self, start, end):
         self.start = start
@@ -552,9 +663,17 @@ Kernel = namedtuple('Kernel', ['name', 'device', 'interval'])
 
 
 # TODO: record TID too
-class FunctionEvent(FormattedTimesMixin):
-    """Profiling information about a single function."""
-    def __init__(self, id, name, thread, cpu_start, cpu_end, input_shapes=None):
+class FunctionEvent(FormattedTimesMixin, CostMixin):
+    """Profiling information about a single function.
+
+    ``flops`` and ``bytes`` are the estimated cost of the function itself, and
+    ``cycles``, ``instructions`` and ``llc_misses`` the hardware counts over
+    its whole range, children included.
+    """
+    def __init__(self, id, name, thread, cpu_start, cpu_end, input_shapes=None,
+                 memory=None, flops=0, bytes=0, hw_counters=None):
+        if memory is None:
+            memory = RangeMemoryUsage()
         self.id = id
         self.name = name
         self.cpu_interval = Interval(cpu_start, cpu_end)
@@ -563,6 +682,13 @@ class FunctionEvent(FormattedTimesMixin):
         self.count = 1
         self.cpu_children = []
         self.input_shapes = input_shapes
+        self.self_cpu_memory_usage = memory.self_cpu
+        self.self_cuda_memory_usage = memory.self_cuda
+        self.cpu_peak_memory_usage = memory.peak_cpu
+        self.cuda_peak_memory_usage = memory.peak_cuda
+        self.flops = flops
+        self.bytes = bytes
+        self.cycles, self.instructions, self.llc_misses = hw_counters or (0, 0, 0)
 
     def append_kernel(self, name, device, start, end):
         self.kernels.append(Kernel(name, device, Interval(start, end)))
@@ -611,7 +737,7 @@ class FunctionEvent(FormattedTimesMixin):
         )
 
 
-class FunctionEventAvg(FormattedTimesMixin):
+class FunctionEventAvg(FormattedTimesMixin, CostMixin):
     """Used to average stats over multiple FunctionEvent objects."""
     def __init__(self):
         self.key = None
@@ -620,6 +746,15 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.cuda_time_total = 0
         self.self_cpu_time_total = 0
         self.input_shapes = None
+        self.self_cpu_memory_usage = 0
+        self.self_cuda_memory_usage = 0
+        self.cpu_peak_memory_usage = 0
+        self.cuda_peak_memory_usage = 0
+        self.flops = 0
+        self.bytes = 0
+        self.cycles = 0
+        self.instructions = 0
+        self.llc_misses = 0
 
     def add(self, other, group_by_input_shapes=False):
         if self.key is None:
@@ -636,6 +771,15 @@ class FunctionEventAvg(FormattedTimesMixin):
         self.cpu_time_total += other.cpu_time_total
         self.cuda_time_total += other.cuda_time_total
         self.self_cpu_time_total += other.self_cpu_time_total
+        self.self_cpu_memory_usage += other.self_cpu_memory_usage
+        self.self_cuda_memory_usage += other.self_cuda_memory_usage
+        self.cpu_peak_memory_usage = max(self.cpu_peak_memory_usage, other.cpu_peak_memory_usage)
+        self.cuda_peak_memory_usage = max(self.cuda_peak_memory_usage, other.cuda_peak_memory_usage)
+        self.flops += other.flops
+        self.bytes += other.bytes
+        self.cycles += other.cycles
+        self.instructions += other.instructions
+        self.llc_misses += other.llc_misses
         self.count += other.count
         return self
 
@@ -667,6 +811,28 @@ class StringTable(defaultdict):
 ################################################################################
 # CPU checkpoints
 
+class RangeMemoryUsage(object):
+    """Memory allocated while a range was open, in bytes.
+
+    The self counts are the net allocations made directly in the range, the
+    peaks are the most memory allocated by the range and its children and not
+    freed yet, at any point while it was open.
+    """
+    def __init__(self):
+        self.self_cpu = 0
+        self.self_cuda = 0
+        self.current_cpu = 0
+        self.current_cuda = 0
+        self.peak_cpu = 0
+        self.peak_cuda = 0
+
+    def add(self, cpu, cuda):
+        self.current_cpu += cpu
+        self.current_cuda += cuda
+        self.peak_cpu = max(self.peak_cpu, self.current_cpu)
+        self.peak_cuda = max(self.peak_cuda, self.current_cuda)
+
+
 def parse_cpu_trace(thread_records):
     next_id = 0
     start_record = None
@@ -698,17 +864,34 @@ def parse_cpu_trace(thread_records):
         if record.kind() == 'mark':
             continue
         elif record.kind() == 'push':
-            record_stack.append((next_id, record))
+            record_stack.append((next_id, record, RangeMemoryUsage()))
             next_id += 1
+        elif record.kind() == 'memory_alloc':
+            # The records of a thread are contiguous, so the ranges on the
+            # stack are the ones open on the thread that allocated.
+            if record_stack:
+                cpu, cuda = record.cpu_memory_usage(), record.cuda_memory_usage()
+                record_stack[-1][2].self_cpu += cpu
+                record_stack[-1][2].self_cuda += cuda
+                for _, _, memory in record_stack:
+                    memory.add(cpu, cuda)
         elif record.kind() == 'pop':
-            function_id, start = record_stack.pop()
+            function_id, start, memory = record_stack.pop()
+            start_counters, end_counters = start.hw_counters(), record.hw_counters()
+            hw_counters = None
+            if start_counters and end_counters:
+                hw_counters = [end - begin for begin, end in zip(start_counters, end_counters)]
             fe = FunctionEvent(
                 id=function_id,
                 name=string_table[start.name()],
                 thread=start.thread_id(),
                 cpu_start=start_record.cpu_elapsed_us(start),
                 cpu_end=start_record.cpu_elapsed_us(record),
-                input_shapes=start.shapes())
+                input_shapes=start.shapes(),
+                memory=memory,
+                flops=start.flops(),
+                bytes=start.bytes(),
+                hw_counters=hw_counters)
             if start.has_cuda():
                 cuda_start = adjusted_time(start)
                 cuda_end = adjusted_time(record)
@@ -802,7 +985,8 @@ def parse_nvprof_trace(path):
 # Pretty printer
 
 
-def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True):
+def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True, profile_memory=False,
+                with_flops=False, record_hw_counters=False):
     """Prints a summary of events (which can be a list of FunctionEvent or FunctionEventAvg)."""
     if len(events) == 0:
         return ""
@@ -810,7 +994,8 @@ def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True)
     if sort_by is not None:
         events = EventList(sorted(
             events, key=lambda evt: getattr(evt, sort_by), reverse=True
-        ), use_cuda=use_cuda)
+        ), use_cuda=use_cuda, profile_memory=profile_memory, with_flops=with_flops,
+            record_hw_counters=record_hw_counters)
 
     has_input_shapes = any(
         [event.input_shapes is not None for event in events])
@@ -832,6 +1017,27 @@ def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True)
             'CUDA total',
             'CUDA time avg',
         ])
+    if profile_memory:
+        headers.extend([
+            'Self CPU Mem',
+            'CPU Peak Mem',
+        ])
+        if use_cuda:
+            headers.extend([
+                'Self CUDA Mem',
+                'CUDA Peak Mem',
+            ])
+    if with_flops:
+        headers.extend([
+            'GFLOP/s',
+            'GB/s',
+        ])
+    if record_hw_counters:
+        headers.extend([
+            'Cycles',
+            'IPC',
+            'LLC Misses',
+        ])
     headers.append(
         'Number of Calls'
     )
@@ -896,6 +1102,27 @@ def build_table(events, sort_by=None, header=None, row_limit=100, use_cuda=True)
                 evt.cuda_time_total_str,
                 evt.cuda_time_str,  # Cuda time avg
             ])
+        if profile_memory:
+            row_values.extend([
+                format_memory(evt.self_cpu_memory_usage),
+                format_memory(evt.cpu_peak_memory_usage),
+            ])
+            if use_cuda:
+                row_values.extend([
+                    format_memory(evt.self_cuda_memory_usage),
+                    format_memory(evt.cuda_peak_memory_usage),
+                ])
+        if with_flops:
+            row_values.extend([
+                format_rate(evt.flops, evt._cost_time_us),
+                format_rate(evt.bytes, evt._cost_time_us),
+            ])
+        if record_hw_counters:
+            row_values.extend([
+                format_count(evt.cycles),
+                '{:.2f}'.format(evt.ipc),
+                format_count(evt.llc_misses),
+            ])
         row_values.append(
             evt.count,  # Number of calls
         )
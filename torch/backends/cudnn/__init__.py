@@ -95,6 +95,27 @@ def is_available():
     return torch._C.has_cudnn
 
 
+def save_benchmark_cache(path):
+    r"""Writes the convolution algorithms chosen so far with
+    ``torch.backends.cudnn.benchmark = True`` to the file ``path``.
+
+    The file records the cuDNN version and the GPU model of the current
+    device, and can be read back with :func:`load_benchmark_cache` to skip
+    benchmarking shapes that were already seen.
+    """
+    torch._C._cudnn_save_benchmark_cache(path)
+
+
+def load_benchmark_cache(path):
+    r"""Adds the algorithms stored in ``path`` by :func:`save_benchmark_cache`
+    to the benchmark cache.
+
+    Returns ``False``, and leaves the cache unchanged, when the file was
+    written with another cuDNN version or for another GPU model.
+    """
+    return torch._C._cudnn_load_benchmark_cache(path)
+
+
 def is_acceptable(tensor):
     if not torch._C._get_cudnn_enabled():
         return False
@@ -38,6 +38,13 @@ class _SupportedQEnginesProp(object):
     def __set__(self, obj, val):
         raise RuntimeError("Assignment not supported")
 
+class _QEngineAutoSelectProp(object):
+    def __get__(self, obj, objtype):
+        return torch._C._get_qengine_auto_select()
+
+    def __set__(self, obj, val):
+        torch._C._set_qengine_auto_select(val)
+
 class QuantizedEngine(types.ModuleType):
     def __init__(self, m, name):
         super(QuantizedEngine, self).__init__(name)
@@ -48,6 +55,9 @@ class QuantizedEngine(types.ModuleType):
 
     engine = _QEngineProp()
     supported_engines = _SupportedQEnginesProp()
+    # When set, prepack ops choose FBGEMM or QNNPACK per weight shape and the
+    # run ops follow whichever engine packed the weight.
+    auto_select = _QEngineAutoSelectProp()
 
 # This is the sys.modules replacement trick, see
 # https://stackoverflow.com/questions/2447353/getattr-on-a-module/7668273#7668273
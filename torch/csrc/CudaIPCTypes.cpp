@@ -4,6 +4,7 @@
 #include <map>
 #include <mutex>
 #include <random>
+#include <unordered_map>
 
 #ifdef _MSC_VER
 #include <windows.h>
@@ -221,6 +222,149 @@ at::DataPtr GetNewRefCountedSentData(void* data, at::Device device) {
   return at::DataPtr(data, sent_data, CudaIPCSentDataDelete, device);
 }
 
+namespace {
+
+// The ref counter files of producers mapped by this (consumer) process, so
+// that releasing the storages received from a producer does not map its file
+// for every storage. A file stays mapped only while storages that were
+// received with a counter in it are alive: the producer's file is unlinked
+// once the last process unmaps it, so keeping it mapped any longer would keep
+// rotated files alive in /dev/shm.
+struct CudaIPCReceivedRefCountersFiles final {
+  // Called for every received storage, before its counter is returned.
+  void acquire(const std::string& handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++files_[handle].outstanding;
+  }
+
+  // Throws if the producer has terminated and removed the file.
+  std::shared_ptr<at::DataPtr> get(const std::string& handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = files_.find(handle);
+    if (it != files_.end() && it->second.file) {
+      return it->second.file;
+    }
+    int flags = TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE;
+    auto file = std::make_shared<at::DataPtr>(THRefcountedMapAllocator::makeDataPtr(
+        handle.c_str(),
+        flags,
+        sizeof(int64_t) * CUDA_IPC_REF_COUNTER_FILE_SIZE,
+        nullptr));
+    // Only cache the mapping while acquired counters may still use it.
+    if (it != files_.end()) {
+      it->second.file = file;
+    }
+    return file;
+  }
+
+  // Decrements the counter at `offset` of `file`, if there is one. If the
+  // counter was acquired, the mapping is dropped with the last of them.
+  void decrement(
+      const std::string& handle,
+      const at::DataPtr* file,
+      int64_t offset,
+      bool acquired) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file) {
+      *(static_cast<int64_t*>(file->get()) + offset) -= 1;
+    }
+    if (!acquired) {
+      return;
+    }
+    auto it = files_.find(handle);
+    if (it != files_.end() && --it->second.outstanding == 0) {
+      files_.erase(it);
+    }
+  }
+
+ private:
+  struct File {
+    std::shared_ptr<at::DataPtr> file;
+    int64_t outstanding = 0;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, File> files_;
+};
+
+// Leaked, since stream callbacks may still run during static destruction.
+CudaIPCReceivedRefCountersFiles& received_ref_counters_files() {
+  static auto* files = new CudaIPCReceivedRefCountersFiles();
+  return *files;
+}
+
+#if !defined(__HIP_PLATFORM_HCC__) && CUDART_VERSION >= 10000
+struct PendingRefCounterReturn {
+  std::string handle;
+  std::shared_ptr<at::DataPtr> file;
+  int64_t offset;
+};
+
+// Runs on a CUDA callback thread, which must not call into CUDA. Unmapping the
+// file, if this was its last counter, is fine.
+void CUDART_CB returnRefCounterCallback(void* data) {
+  std::unique_ptr<PendingRefCounterReturn> pending(
+      static_cast<PendingRefCounterReturn*>(data));
+  received_ref_counters_files().decrement(
+      pending->handle, pending->file.get(), pending->offset, /*acquired=*/true);
+}
+#endif
+
+void returnRefCounter(const std::string& handle, int64_t offset, bool acquired) {
+  // We don't want to break existing code, so resource deletion is best
+  // effort basis. Exception expected if producer process terminated
+  // before consumer released data.
+  std::shared_ptr<at::DataPtr> file;
+  try {
+    file = received_ref_counters_files().get(handle);
+  } catch (c10::Error& err) {
+    // Already warned inside of producer process
+  }
+  received_ref_counters_files().decrement(handle, file.get(), offset, acquired);
+}
+
+} // namespace
+
+void AcquireReceivedRefCounter(const std::string& handle) {
+  received_ref_counters_files().acquire(handle);
+}
+
+void ReturnReceivedRefCounter(const std::string& handle, int64_t offset) {
+  returnRefCounter(handle, offset, /*acquired=*/false);
+}
+
+void ReturnReceivedRefCounterAfterStream(
+    const std::string& handle,
+    int64_t offset,
+    const c10::cuda::CUDAStream& stream) {
+#if !defined(__HIP_PLATFORM_HCC__) && CUDART_VERSION >= 10000
+  std::shared_ptr<at::DataPtr> file;
+  try {
+    file = received_ref_counters_files().get(handle);
+  } catch (c10::Error& err) {
+    // Already warned inside of producer process
+    received_ref_counters_files().decrement(
+        handle, nullptr, offset, /*acquired=*/true);
+    return;
+  }
+  // The counter is decremented by a host function queued on the stream,
+  // instead of synchronizing the stream here, so releasing a batch of
+  // storages costs a launch per storage rather than a GPU round trip.
+  auto pending = new PendingRefCounterReturn{handle, std::move(file), offset};
+  cudaError_t err =
+      cudaLaunchHostFunc(stream.stream(), returnRefCounterCallback, pending);
+  if (err != cudaSuccess) {
+    delete pending;
+    cudaGetLastError();
+    cudaStreamSynchronize(stream.stream());
+    returnRefCounter(handle, offset, /*acquired=*/true);
+  }
+#else
+  cudaStreamSynchronize(stream.stream());
+  returnRefCounter(handle, offset, /*acquired=*/true);
+#endif
+}
+
 bool CudaIPCCollect() {
   bool freed_memory = cuda_ipc_global_entities.CudaIPCSentDataLimbo_.collect();
   if (cuda_ipc_global_entities.CudaIPCSentDataLimbo_.size() == 0) {
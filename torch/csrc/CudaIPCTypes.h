@@ -49,6 +49,25 @@ struct CudaIPCSentData final {
 
 at::DataPtr GetNewRefCountedSentData(void* data, at::Device device);
 
+// Consumer side: drops the reference that a received storage holds on the
+// counter at `offset` of the producer's ref counter file `handle`. Does
+// nothing if the producer has already terminated.
+void ReturnReceivedRefCounter(const std::string& handle, int64_t offset);
+
+// Registers a received storage whose counter is in the ref counter file
+// `handle`, and which will be released by ReturnReceivedRefCounterAfterStream.
+// The file stays mapped while such storages are alive, so releasing the
+// storages of a file maps it once, and is unmapped with the last of them.
+void AcquireReceivedRefCounter(const std::string& handle);
+
+// Releases a storage registered with AcquireReceivedRefCounter, like
+// ReturnReceivedRefCounter, but once the work queued on `stream` so far has
+// completed, without blocking the calling thread.
+void ReturnReceivedRefCounterAfterStream(
+    const std::string& handle,
+    int64_t offset,
+    const c10::cuda::CUDAStream& stream);
+
 namespace {
 
 constexpr int64_t CUDA_IPC_REF_COUNTER_FILE_SIZE = 10000;
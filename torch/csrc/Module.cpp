@@ -9,7 +9,9 @@
 #include <cstdlib>
 #include <libshm.h>
 #include <TH/TH.h>
+#include <c10/core/CPUAllocator.h>
 #include <c10/util/Logging.h>
+#include <c10/util/numa.h>
 #include <ATen/ATen.h>
 #include <ATen/ExpandUtils.h>
 #include <ATen/dlpack.h>
@@ -24,6 +26,7 @@
 #include <torch/csrc/Device.h>
 #include <torch/csrc/Dtype.h>
 #include <torch/csrc/DataLoader.h>
+#include <torch/csrc/ShmRingBuffer.h>
 #include <torch/csrc/Generator.h>
 #include <torch/csrc/Layout.h>
 #include <torch/csrc/MemoryFormat.h>
@@ -49,6 +52,7 @@
 
 #ifdef USE_CUDNN
 #include <cudnn.h>
+#include <ATen/cudnn/BenchmarkCache.h>
 #endif
 
 #ifdef USE_DISTRIBUTED
@@ -446,6 +450,20 @@ PyObject *THPModule_deterministicCuDNN(PyObject *_unused, PyObject *noargs)
   else Py_RETURN_FALSE;
 }
 
+PyObject *THPModule_setDeterministic(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_deterministic expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setDeterministic(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_deterministic(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().deterministic()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
 PyObject *THPModule_setBenchmarkCuDNN(PyObject *_unused, PyObject *arg)
 {
   THPUtils_assert(PyBool_Check(arg), "set_benchmark_cudnn expects a bool, "
@@ -460,6 +478,48 @@ PyObject *THPModule_benchmarkCuDNN(PyObject *_unused, PyObject *noargs)
   else Py_RETURN_FALSE;
 }
 
+PyObject *THPModule_setTensorIteratorPlanCache(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_tensor_iterator_plan_cache expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setTensorIteratorPlanCache(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_tensorIteratorPlanCache(PyObject *_unused, PyObject *noargs)
+{
+  if (at::globalContext().tensorIteratorPlanCache()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_setCPUNumaEnabled(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_cpu_numa_enabled expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  FLAGS_caffe2_cpu_numa_enabled = (arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_cpuNumaEnabled(PyObject *_unused, PyObject *noargs)
+{
+  if (c10::IsNUMAEnabled()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
+PyObject *THPModule_setCPUHugePagesEnabled(PyObject *_unused, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_cpu_huge_pages_enabled expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  FLAGS_caffe2_cpu_allocator_use_huge_pages = (arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_cpuHugePagesEnabled(PyObject *_unused, PyObject *noargs)
+{
+  if (FLAGS_caffe2_cpu_allocator_use_huge_pages) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
 PyObject *THPModule_setFlushDenormal(PyObject *_unused, PyObject *arg) {
   THPUtils_assert(PyBool_Check(arg), "flush_denormal expects a bool, "
           "but got %s", THPUtils_typename(arg));
@@ -500,6 +560,20 @@ PyObject *THPModule_qEngine(PyObject */* unused */)
   return THPUtils_packInt64(static_cast<int>(at::globalContext().qEngine()));
 }
 
+PyObject *THPModule_setQEngineAutoSelect(PyObject */* unused */, PyObject *arg)
+{
+  THPUtils_assert(PyBool_Check(arg), "set_qengine_auto_select expects a bool, "
+          "but got %s", THPUtils_typename(arg));
+  at::globalContext().setQEngineAutoSelect(arg == Py_True);
+  Py_RETURN_NONE;
+}
+
+PyObject *THPModule_qEngineAutoSelect(PyObject */* unused */)
+{
+  if (at::globalContext().qEngineAutoSelect()) Py_RETURN_TRUE;
+  else Py_RETURN_FALSE;
+}
+
 PyObject *THPModule_supportedQEngines(PyObject */* unused */)
 {
   auto qengines = at::globalContext().supportedQEngines();
@@ -540,12 +614,20 @@ static PyMethodDef TorchMethods[] = {
   {"set_num_interop_threads", (PyCFunction)THPModule_setNumInteropThreads,     METH_O,       nullptr},
   {"_get_cudnn_enabled", (PyCFunction)THPModule_userEnabledCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_enabled", (PyCFunction)THPModule_setUserEnabledCuDNN, METH_O,  nullptr},
+  {"_get_cpu_numa_enabled", (PyCFunction)THPModule_cpuNumaEnabled, METH_NOARGS,     nullptr},
+  {"_set_cpu_numa_enabled", (PyCFunction)THPModule_setCPUNumaEnabled, METH_O,  nullptr},
+  {"_get_cpu_huge_pages_enabled", (PyCFunction)THPModule_cpuHugePagesEnabled, METH_NOARGS,     nullptr},
+  {"_set_cpu_huge_pages_enabled", (PyCFunction)THPModule_setCPUHugePagesEnabled, METH_O,  nullptr},
   {"_get_mkldnn_enabled", (PyCFunction)THPModule_userEnabledMkldnn, METH_NOARGS,     nullptr},
   {"_set_mkldnn_enabled", (PyCFunction)THPModule_setUserEnabledMkldnn, METH_O,  nullptr},
   {"_get_cudnn_benchmark", (PyCFunction)THPModule_benchmarkCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_benchmark", (PyCFunction)THPModule_setBenchmarkCuDNN, METH_O,  nullptr},
   {"_get_cudnn_deterministic", (PyCFunction)THPModule_deterministicCuDNN, METH_NOARGS,     nullptr},
   {"_set_cudnn_deterministic", (PyCFunction)THPModule_setDeterministicCuDNN, METH_O,  nullptr},
+  {"_get_deterministic", (PyCFunction)THPModule_deterministic, METH_NOARGS,     nullptr},
+  {"_set_deterministic", (PyCFunction)THPModule_setDeterministic, METH_O,  nullptr},
+  {"_get_tensor_iterator_plan_cache", (PyCFunction)THPModule_tensorIteratorPlanCache, METH_NOARGS,     nullptr},
+  {"_set_tensor_iterator_plan_cache", (PyCFunction)THPModule_setTensorIteratorPlanCache, METH_O,  nullptr},
   {"_to_dlpack",      (PyCFunction)THPModule_toDLPack,          METH_O,       nullptr},
   {"_from_dlpack",    (PyCFunction)THPModule_fromDLPack,        METH_O,       nullptr},
   {"set_flush_denormal", (PyCFunction)THPModule_setFlushDenormal, METH_O,     nullptr},
@@ -554,6 +636,8 @@ static PyMethodDef TorchMethods[] = {
   {"_get_qengine", (PyCFunction)THPModule_qEngine, METH_NOARGS, nullptr},
   {"_set_qengine", (PyCFunction)THPModule_setQEngine, METH_O, nullptr},
   {"_supported_qengines", (PyCFunction)THPModule_supportedQEngines, METH_NOARGS, nullptr},
+  {"_get_qengine_auto_select", (PyCFunction)THPModule_qEngineAutoSelect, METH_NOARGS, nullptr},
+  {"_set_qengine_auto_select", (PyCFunction)THPModule_setQEngineAutoSelect, METH_O, nullptr},
   {nullptr, nullptr, 0, nullptr}
 };
 
@@ -601,8 +685,32 @@ static PyObject * THCUDNN_cudnn_version(PyObject *self, PyObject *args)
   return PyLong_FromLong(CUDNN_VERSION);
 }
 
+static PyObject * THCUDNN_save_benchmark_cache(PyObject *self, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkString(arg), "_cudnn_save_benchmark_cache expects a str, "
+          "but got %s", THPUtils_typename(arg));
+  at::native::cudnn_convolution_save_benchmark_cache(THPUtils_unpackString(arg));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * THCUDNN_load_benchmark_cache(PyObject *self, PyObject *arg)
+{
+  HANDLE_TH_ERRORS
+  THPUtils_assert(THPUtils_checkString(arg), "_cudnn_load_benchmark_cache expects a str, "
+          "but got %s", THPUtils_typename(arg));
+  if (at::native::cudnn_convolution_load_benchmark_cache(THPUtils_unpackString(arg))) {
+    Py_RETURN_TRUE;
+  }
+  Py_RETURN_FALSE;
+  END_HANDLE_TH_ERRORS
+}
+
 static PyMethodDef _THCUDNN_methods[] = {
   {"_cudnn_version", (PyCFunction)THCUDNN_cudnn_version, METH_VARARGS, nullptr},
+  {"_cudnn_save_benchmark_cache", (PyCFunction)THCUDNN_save_benchmark_cache, METH_O, nullptr},
+  {"_cudnn_load_benchmark_cache", (PyCFunction)THCUDNN_load_benchmark_cache, METH_O, nullptr},
   {nullptr}
 };
 
@@ -683,6 +791,7 @@ PyObject* initModule() {
   torch::onnx::initONNXBindings(module);
   torch::jit::initJITBindings(module);
   torch::throughput_benchmark::initThroughputBenchmarkBindings(module);
+  torch::dataloader::initShmRingBufferBindings(module);
   torch::autograd::initNNFunctions(module);
   torch::autograd::init_legacy_variable(module);
   torch::python::init_bindings(module);
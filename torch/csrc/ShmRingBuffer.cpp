@@ -0,0 +1,318 @@
+#include <torch/csrc/ShmRingBuffer.h>
+
+#include <torch/csrc/Dtype.h>
+#include <torch/csrc/autograd/variable.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
+#include <random>
+
+namespace torch {
+namespace dataloader {
+
+#ifndef _WIN32
+
+namespace {
+
+uint64_t roundUp(uint64_t nbytes) {
+  const uint64_t alignment = ShmRingBuffer::kAlignment;
+  return (nbytes + alignment - 1) / alignment * alignment;
+}
+
+void* mapSegment(int fd, size_t size, const std::string& name) {
+  void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  TORCH_CHECK(
+      base != MAP_FAILED,
+      "Unable to mmap the ring buffer ",
+      name,
+      ": ",
+      strerror(errno));
+  return base;
+}
+
+} // namespace
+
+constexpr int64_t ShmRingBuffer::kAlignment;
+constexpr size_t ShmRingBuffer::kHeaderSize;
+
+std::shared_ptr<ShmRingBuffer> ShmRingBuffer::create(int64_t capacity) {
+  TORCH_CHECK(capacity > 0, "Ring buffer capacity must be positive, got ", capacity);
+  const uint64_t rounded = roundUp(capacity);
+  const size_t size = kHeaderSize + rounded;
+
+  static std::atomic<uint64_t> counter{0};
+  std::random_device rd;
+  std::string name;
+  int fd = -1;
+  // names may collide with the rings of another process or a leaked one
+  for (int attempt = 0; attempt < 64 && fd < 0; ++attempt) {
+    name = "/torch_ring_" + std::to_string(getpid()) + "_" +
+        std::to_string(counter++) + "_" + std::to_string(rd());
+    fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    TORCH_CHECK(
+        fd >= 0 || errno == EEXIST,
+        "Unable to create the ring buffer ",
+        name,
+        ": ",
+        strerror(errno));
+  }
+  TORCH_CHECK(fd >= 0, "Unable to find a free name for a ring buffer");
+
+  void* base = nullptr;
+  if (ftruncate(fd, size) != 0) {
+    const int err = errno;
+    close(fd);
+    shm_unlink(name.c_str());
+    TORCH_CHECK(
+        false,
+        "Unable to allocate ",
+        size,
+        " bytes for the ring buffer ",
+        name,
+        ": ",
+        strerror(err));
+  }
+  try {
+    base = mapSegment(fd, size, name);
+  } catch (...) {
+    close(fd);
+    shm_unlink(name.c_str());
+    throw;
+  }
+  close(fd);
+
+  auto header = new (base) Header();
+  header->head.store(0);
+  header->tail.store(0);
+  header->capacity = rounded;
+  return std::shared_ptr<ShmRingBuffer>(
+      new ShmRingBuffer(std::move(name), base, size, /*owner=*/true));
+}
+
+std::shared_ptr<ShmRingBuffer> ShmRingBuffer::attach(const std::string& name) {
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  TORCH_CHECK(
+      fd >= 0,
+      "Unable to open the ring buffer ",
+      name,
+      ": ",
+      strerror(errno));
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(kHeaderSize)) {
+    close(fd);
+    TORCH_CHECK(false, "Invalid ring buffer ", name);
+  }
+  void* base = nullptr;
+  try {
+    base = mapSegment(fd, st.st_size, name);
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+  close(fd);
+  return std::shared_ptr<ShmRingBuffer>(
+      new ShmRingBuffer(name, base, st.st_size, /*owner=*/false));
+}
+
+ShmRingBuffer::ShmRingBuffer(
+    std::string name,
+    void* base,
+    size_t mapped_size,
+    bool owner)
+    : name_(std::move(name)),
+      base_(base),
+      mapped_size_(mapped_size),
+      header_(static_cast<Header*>(base)),
+      data_(static_cast<uint8_t*>(base) + kHeaderSize),
+      capacity_(header_->capacity),
+      owner_(owner) {
+  TORCH_INTERNAL_ASSERT(kHeaderSize + capacity_ <= mapped_size_);
+}
+
+ShmRingBuffer::~ShmRingBuffer() {
+  munmap(base_, mapped_size_);
+  if (owner_ && !unlinked_) {
+    shm_unlink(name_.c_str());
+  }
+}
+
+c10::optional<ShmRingBuffer::Region> ShmRingBuffer::allocate(int64_t nbytes) {
+  TORCH_CHECK(nbytes >= 0, "Invalid size ", nbytes);
+  const uint64_t capacity = capacity_;
+  const uint64_t size = roundUp(nbytes);
+  if (size > capacity) {
+    return c10::nullopt;
+  }
+  const uint64_t head = header_->head.load(std::memory_order_relaxed);
+  // pairs with the release of the consumer, so that its reads of a region
+  // are done before we write to it again
+  const uint64_t tail = header_->tail.load(std::memory_order_acquire);
+  const uint64_t pos = head % capacity;
+  const uint64_t skipped = pos + size > capacity ? capacity - pos : 0;
+  if (head + skipped + size - tail > capacity) {
+    return c10::nullopt;
+  }
+  header_->head.store(head + skipped + size, std::memory_order_release);
+  return Region{static_cast<int64_t>(head),
+                static_cast<int64_t>(head + skipped + size),
+                static_cast<int64_t>((pos + skipped) % capacity)};
+}
+
+void ShmRingBuffer::write(int64_t offset, const at::Tensor& tensor) {
+  TORCH_CHECK(
+      tensor.device().is_cpu() && tensor.layout() == at::kStrided,
+      "Only strided CPU tensors can be written to a ring buffer");
+  auto contiguous = tensor.contiguous();
+  const int64_t nbytes = contiguous.numel() * contiguous.element_size();
+  TORCH_CHECK(
+      offset >= 0 && offset + nbytes <= capacity_,
+      "Writing ",
+      nbytes,
+      " bytes at offset ",
+      offset,
+      " overflows a ring buffer of ",
+      capacity_,
+      " bytes");
+  if (nbytes > 0) {
+    std::memcpy(data_ + offset, contiguous.data_ptr(), nbytes);
+  }
+}
+
+std::vector<at::Tensor> ShmRingBuffer::take(
+    int64_t begin,
+    int64_t end,
+    const std::vector<TensorSpec>& specs) {
+  TORCH_CHECK(
+      0 <= begin && begin <= end && end - begin <= capacity_,
+      "Invalid ring buffer region [",
+      begin,
+      ", ",
+      end,
+      ")");
+  // released when the last tensor of the batch is freed
+  struct Lease {
+    std::shared_ptr<ShmRingBuffer> ring;
+    uint64_t begin;
+    uint64_t end;
+    ~Lease() {
+      ring->release(begin, end);
+    }
+  };
+  auto lease = std::make_shared<Lease>(
+      Lease{shared_from_this(), static_cast<uint64_t>(begin),
+            static_cast<uint64_t>(end)});
+
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(specs.size());
+  for (const auto& spec : specs) {
+    int64_t numel = 1;
+    for (auto size : spec.sizes) {
+      TORCH_CHECK(size >= 0, "Invalid size ", spec.sizes);
+      numel *= size;
+    }
+    const int64_t nbytes = numel * c10::elementSize(spec.dtype);
+    TORCH_CHECK(
+        spec.offset >= 0 && spec.offset + nbytes <= capacity_,
+        "Tensor of ",
+        nbytes,
+        " bytes at offset ",
+        spec.offset,
+        " is out of a ring buffer of ",
+        capacity_,
+        " bytes");
+    auto tensor = at::from_blob(
+        data_ + spec.offset,
+        spec.sizes,
+        [lease](void*) {},
+        at::TensorOptions().dtype(spec.dtype));
+    tensors.push_back(autograd::make_variable(std::move(tensor)));
+  }
+  return tensors;
+}
+
+void ShmRingBuffer::release(uint64_t begin, uint64_t end) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  released_.emplace(begin, end);
+  uint64_t tail = header_->tail.load(std::memory_order_relaxed);
+  for (auto it = released_.find(tail); it != released_.end();
+       it = released_.find(tail)) {
+    tail = it->second;
+    released_.erase(it);
+  }
+  header_->tail.store(tail, std::memory_order_release);
+}
+
+void ShmRingBuffer::unlink() {
+  if (owner_ && !unlinked_) {
+    shm_unlink(name_.c_str());
+    unlinked_ = true;
+  }
+}
+
+int64_t ShmRingBuffer::used() const {
+  return header_->head.load(std::memory_order_acquire) -
+      header_->tail.load(std::memory_order_acquire);
+}
+
+void initShmRingBufferBindings(PyObject* module) {
+  auto m = py::handle(module).cast<py::module>();
+  py::class_<ShmRingBuffer, std::shared_ptr<ShmRingBuffer>>(
+      m, "_ShmRingBuffer")
+      .def_static("create", &ShmRingBuffer::create)
+      .def_static("attach", &ShmRingBuffer::attach)
+      .def_property_readonly("name", &ShmRingBuffer::name)
+      .def_property_readonly("capacity", &ShmRingBuffer::capacity)
+      .def("used", &ShmRingBuffer::used)
+      .def(
+          "allocate",
+          [](ShmRingBuffer& self, int64_t nbytes) -> py::object {
+            auto region = self.allocate(nbytes);
+            if (!region) {
+              return py::none();
+            }
+            return py::make_tuple(region->begin, region->end, region->offset);
+          })
+      .def(
+          "write",
+          &ShmRingBuffer::write,
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "take",
+          [](ShmRingBuffer& self,
+             int64_t begin,
+             int64_t end,
+             const std::vector<py::tuple>& specs) {
+            // specs are (offset, dtype, sizes) tuples
+            std::vector<ShmRingBuffer::TensorSpec> tensor_specs;
+            tensor_specs.reserve(specs.size());
+            for (const auto& spec : specs) {
+              TORCH_CHECK(spec.size() == 3, "Invalid tensor spec");
+              py::handle dtype = spec[1];
+              TORCH_CHECK(
+                  THPDtype_Check(dtype.ptr()),
+                  "Expected a torch.dtype in the tensor spec");
+              tensor_specs.push_back(
+                  {spec[0].cast<int64_t>(),
+                   reinterpret_cast<THPDtype*>(dtype.ptr())->scalar_type,
+                   spec[2].cast<std::vector<int64_t>>()});
+            }
+            return self.take(begin, end, tensor_specs);
+          })
+      .def("unlink", &ShmRingBuffer::unlink);
+}
+
+#else
+
+void initShmRingBufferBindings(PyObject* module) {}
+
+#endif
+
+} // namespace dataloader
+} // namespace torch
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <c10/util/Optional.h>
+#include <torch/csrc/utils/pybind.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace dataloader {
+
+// A ring buffer of bytes in POSIX shared memory, through which a DataLoader
+// worker sends the tensors of its batches to the main process.
+//
+// The worker (the only producer) reserves one region of the ring per batch
+// with allocate(), copies the tensors of the batch into it with write(), and
+// sends only the offsets over its queue. The main process (the only
+// consumer) turns the offsets back into tensors with take(); those tensors
+// view the ring directly, and the region is given back to the worker once
+// the last of them is freed. This avoids the per-tensor file descriptor
+// exchange of sharing every tensor through libshm, at the price of a bounded
+// amount of memory per worker: a batch that does not fit in the free part of
+// the ring is not allocated, and the caller falls back to the regular path.
+// The RPC SocketAgent uses it the same way between workers on the same host.
+//
+// Positions in the ring are offsets in the stream of bytes ever reserved,
+// which grows forever; the physical offset in the buffer is the position
+// modulo the capacity. Regions never wrap around: when a region does not fit
+// before the end of the buffer, the bytes up to the end are reserved too.
+//
+// Not available on Windows.
+class ShmRingBuffer : public std::enable_shared_from_this<ShmRingBuffer> {
+ public:
+  // All regions and tensors are aligned to this many bytes.
+  static constexpr int64_t kAlignment = 64;
+
+  struct Region {
+    // [begin, end) are positions in the ring, including the bytes skipped
+    // to the end of the buffer, if any
+    int64_t begin;
+    int64_t end;
+    // offset of the data of the region in the buffer
+    int64_t offset;
+  };
+
+  // A tensor of a batch: a contiguous tensor of `sizes` at `offset` in the
+  // buffer.
+  struct TensorSpec {
+    int64_t offset;
+    at::ScalarType dtype;
+    std::vector<int64_t> sizes;
+  };
+
+  // Creates a ring of at least `capacity` bytes under a new unique name. The
+  // creator owns the name: it is unlinked by unlink() or the destructor.
+  static std::shared_ptr<ShmRingBuffer> create(int64_t capacity);
+  // Maps the ring created under `name`, typically in a worker process.
+  static std::shared_ptr<ShmRingBuffer> attach(const std::string& name);
+
+  ~ShmRingBuffer();
+
+  ShmRingBuffer(const ShmRingBuffer&) = delete;
+  ShmRingBuffer& operator=(const ShmRingBuffer&) = delete;
+
+  // Producer side. Reserves a region of `nbytes` (rounded up to
+  // kAlignment), or returns nullopt if the free part of the ring is too
+  // small. Never blocks.
+  c10::optional<Region> allocate(int64_t nbytes);
+  // Copies the data of the CPU tensor `tensor`, in contiguous order, to
+  // `offset` in the buffer.
+  void write(int64_t offset, const at::Tensor& tensor);
+
+  // Consumer side. Returns the tensors of the batch held by the region
+  // [begin, end). The region is released when all of them are freed, and
+  // regions may be released in any order.
+  std::vector<at::Tensor> take(
+      int64_t begin,
+      int64_t end,
+      const std::vector<TensorSpec>& specs);
+
+  // Removes the name of the ring; mappings made so far stay valid.
+  void unlink();
+
+  const std::string& name() const {
+    return name_;
+  }
+  int64_t capacity() const {
+    return capacity_;
+  }
+  // Number of bytes reserved and not released yet.
+  int64_t used() const;
+
+ private:
+  struct Header {
+    // end of the reserved regions, only written by the producer
+    std::atomic<uint64_t> head;
+    // begin of the regions not released yet, only written by the consumer
+    std::atomic<uint64_t> tail;
+    uint64_t capacity;
+  };
+  static constexpr size_t kHeaderSize = kAlignment;
+  static_assert(sizeof(Header) <= kHeaderSize, "Header does not fit");
+
+  ShmRingBuffer(std::string name, void* base, size_t mapped_size, bool owner);
+
+  void release(uint64_t begin, uint64_t end);
+
+  std::string name_;
+  void* base_;
+  size_t mapped_size_;
+  Header* header_;
+  uint8_t* data_;
+  int64_t capacity_;
+  bool owner_;
+  bool unlinked_ = false;
+
+  // regions released out of order, from their begin to their end
+  std::mutex mutex_;
+  std::map<uint64_t, uint64_t> released_;
+};
+
+void initShmRingBufferBindings(PyObject* module);
+
+} // namespace dataloader
+} // namespace torch
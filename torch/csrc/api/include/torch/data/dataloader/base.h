@@ -2,7 +2,9 @@
 
 #include <torch/data/dataloader_options.h>
 #include <torch/data/detail/data_shuttle.h>
+#include <torch/data/detail/device_transfer.h>
 #include <torch/data/detail/sequencers.h>
+#include <torch/data/detail/worker_process.h>
 #include <torch/data/iterator.h>
 #include <torch/data/samplers/random.h>
 #include <torch/data/worker_exception.h>
@@ -11,9 +13,14 @@
 #include <torch/csrc/utils/memory.h>
 #include <torch/csrc/utils/variadic.h>
 
+#include <ATen/Context.h>
+#include <c10/core/Event.h>
+#include <c10/core/StreamGuard.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
 #include <c10/util/Exception.h>
 
 #include <cstddef>
+#include <deque>
 #include <exception>
 #include <memory>
 #include <thread>
@@ -41,6 +48,7 @@ class DataLoaderBase {
 
   virtual ~DataLoaderBase() {
     join();
+    clear_device_transfers();
   }
 
   /// Returns an iterator into the DataLoader. The lifetime of the iterator is
@@ -88,6 +96,7 @@ class DataLoaderBase {
     for (auto& worker : workers_) {
       worker.join();
     }
+    worker_processes_.clear();
     joined_ = true;
   }
 
@@ -136,6 +145,7 @@ class DataLoaderBase {
   /// Resets the internal state of the DataLoader, optionally pre-fetching
   /// new jobs.
   virtual void reset() {
+    clear_device_transfers();
     shuttle_.drain();
     sequence_number_ = 0;
     sequencer_ = new_sequencer();
@@ -163,6 +173,30 @@ class DataLoaderBase {
   /// is exhausted. This operation will block until a batch is available if one
   /// is still expected.
   optional<BatchType> next() {
+    if (!options_.device) {
+      return next_host_batch();
+    }
+    while (device_transfers_.size() <= options_.device_prefetch) {
+      auto batch = next_host_batch();
+      if (!batch) {
+        break;
+      }
+      device_transfers_.push_back(start_device_transfer(std::move(*batch)));
+    }
+    if (device_transfers_.empty()) {
+      return nullopt;
+    }
+    auto transfer = std::move(device_transfers_.front());
+    device_transfers_.pop_front();
+    if (transfer.copied) {
+      const c10::impl::VirtualGuardImpl guard_impl(options_.device->type());
+      transfer.copied->block(guard_impl.getStream(transfer.stream->device()));
+    }
+    return std::move(transfer.batch);
+  }
+
+  /// Like `next()`, but returns the batch as the dataset produced it.
+  optional<BatchType> next_host_batch() {
     if (options_.workers > 0) {
       while (optional<Result> result = this->pop_result()) {
         if (result->exception) {
@@ -180,13 +214,33 @@ class DataLoaderBase {
 
   /// The function that worker threads run.
   void worker_thread(Dataset& dataset) {
+    run_worker([&dataset](BatchRequest request) {
+      return dataset.get_batch(std::move(request));
+    });
+  }
+
+  /// The function that worker threads run when they fetch the batches from a
+  /// worker process.
+  void worker_thread(detail::WorkerProcess& process) {
+    run_worker([&process](const BatchRequest& request) {
+      return detail::fetch_batch<Batch>(process, request);
+    });
+  }
+
+  /// Answers jobs with `get_batch(batch_request)` until told to quit.
+  template <typename GetBatch>
+  void run_worker(const GetBatch& get_batch) {
     while (true) {
       auto job = shuttle_.pop_job();
       if (job.quit) {
         break;
       }
       try {
-        auto batch = dataset.get_batch(std::move(*job.batch_request));
+        auto batch = get_batch(std::move(*job.batch_request));
+        if (options_.device && options_.device->is_cuda()) {
+          // Takes the copy into pinned memory off the main thread.
+          batch = detail::pin_memory(std::move(batch));
+        }
         shuttle_.push_result({std::move(batch), job.sequence_number});
       } catch (...) {
         shuttle_.push_result({std::current_exception(), job.sequence_number});
@@ -194,6 +248,69 @@ class DataLoaderBase {
     }
   }
 
+  /// A batch whose tensors are being copied to `options_.device`.
+  struct DeviceTransfer {
+    BatchType batch;
+    /// For CUDA devices, the stream that was current when the copies were
+    /// issued, on which the memory of the copies was allocated.
+    optional<c10::Stream> stream;
+    /// Recorded on the copy stream after the copies.
+    optional<c10::Event> copied;
+  };
+
+  /// Issues the copies of the tensors of `batch` to `options_.device`.
+  DeviceTransfer start_device_transfer(BatchType batch) {
+    const auto device = *options_.device;
+    if (!device.is_cuda()) {
+      auto copy = detail::map_tensors(
+          std::move(batch),
+          [&device](const Tensor& tensor) { return tensor.to(device); });
+      return {std::move(copy), nullopt, nullopt};
+    }
+
+    const c10::impl::VirtualGuardImpl guard_impl(device.type());
+    const auto stream = guard_impl.getStream(
+        device.has_index() ? device : guard_impl.getDevice());
+    if (!copy_stream_ || copy_stream_->device() != stream.device()) {
+      copy_stream_ =
+          at::detail::getCUDAHooks().getStreamFromPool(stream.device_index());
+    }
+    // The copies are allocated on the current stream, which may still use the
+    // memory they get for earlier kernels.
+    c10::Event allocated(device.type());
+    allocated.record(stream);
+    allocated.block(*copy_stream_);
+
+    auto copy = detail::map_tensors(
+        std::move(batch), [this, &stream](const Tensor& tensor) {
+          const auto source =
+              tensor.device().is_cpu() && tensor.layout() == kStrided &&
+                  !tensor.is_pinned()
+              ? tensor.pin_memory()
+              : tensor;
+          auto copy = torch::empty(
+              source.sizes(), source.options().device(stream.device()));
+          const c10::StreamGuard stream_guard(*this->copy_stream_);
+          copy.copy_(source, /*non_blocking=*/true);
+          return copy;
+        });
+    c10::Event copied(device.type());
+    copied.record(*copy_stream_);
+    return {std::move(copy), stream, std::move(copied)};
+  }
+
+  /// Drops the batches that are being copied. Since their memory was
+  /// allocated on the stream that was current, that stream first waits for the
+  /// copies, so the memory is not reused before they finish.
+  void clear_device_transfers() {
+    for (auto& transfer : device_transfers_) {
+      if (transfer.copied) {
+        transfer.copied->block(*transfer.stream);
+      }
+    }
+    device_transfers_.clear();
+  }
+
   /// Convenience method that calls `shuttle_.push_job()` with the next sequence
   /// number.
   template <typename T>
@@ -233,6 +350,10 @@ class DataLoaderBase {
   /// The worker threads, running the `worker_thread()` method.
   std::vector<std::thread> workers_;
 
+  /// With the `worker_processes` option, the processes the worker threads
+  /// fetch the batches from, one per thread.
+  std::vector<std::unique_ptr<detail::WorkerProcess>> worker_processes_;
+
   /// The `DataShuttle` which takes care of the life cycle of a job.
   detail::DataShuttle<Job, Result> shuttle_;
 
@@ -241,6 +362,13 @@ class DataLoaderBase {
 
   /// True if the DataLoader has joined its worker threads.
   bool joined_ = false;
+
+  /// The batches being copied to `options_.device`, in the order they are
+  /// returned.
+  std::deque<DeviceTransfer> device_transfers_;
+
+  /// The stream on which the batches are copied to a CUDA device.
+  optional<c10::Stream> copy_stream_;
 };
 } // namespace data
 } // namespace torch
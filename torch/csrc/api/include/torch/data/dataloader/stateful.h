@@ -2,6 +2,8 @@
 
 #include <torch/data/dataloader/base.h>
 
+#include <c10/util/Exception.h>
+
 #include <cstddef>
 #include <thread>
 #include <utility>
@@ -38,6 +40,10 @@ class StatefulDataLoader : public DataLoaderBase<
       : super(
             std::move(options),
             torch::make_unique<Dataset>(std::move(dataset))) {
+    TORCH_CHECK(
+        !this->options_.worker_processes,
+        "Worker processes are only supported for stateless datasets, "
+        "because the workers of stateful datasets share their state");
     for (size_t w = 0; w < this->options_.workers; ++w) {
       // As opposed to the stateless case, here all worker threads access the
       // same underlying dataset.
@@ -40,13 +40,28 @@ class StatelessDataLoader : public DataLoaderBase<
       Sampler sampler,
       DataLoaderOptions options)
       : super(std::move(options)), sampler_(std::move(sampler)) {
-    for (size_t w = 0; w < this->options_.workers; ++w) {
-      // Here we copy the dataset into the worker thread closure. Each worker
-      // has its own copy of the dataset. This means the dataset must be
-      // trivially copiable, or else we don't expect more than one worker to
-      // be in use.
-      this->workers_.emplace_back(
-          [this, dataset]() mutable { this->worker_thread(dataset); });
+    if (this->options_.worker_processes) {
+      // All processes are forked before any worker thread starts, so none of
+      // them is forked while a worker thread holds a lock.
+      for (size_t w = 0; w < this->options_.workers; ++w) {
+        this->worker_processes_.push_back(
+            detail::make_worker_process<
+                typename super::BatchType,
+                BatchRequestType>(dataset));
+      }
+      for (size_t w = 0; w < this->options_.workers; ++w) {
+        this->workers_.emplace_back(
+            [this, w] { this->worker_thread(*this->worker_processes_[w]); });
+      }
+    } else {
+      for (size_t w = 0; w < this->options_.workers; ++w) {
+        // Here we copy the dataset into the worker thread closure. Each worker
+        // has its own copy of the dataset. This means the dataset must be
+        // trivially copiable, or else we don't expect more than one worker to
+        // be in use.
+        this->workers_.emplace_back(
+            [this, dataset]() mutable { this->worker_thread(dataset); });
+      }
     }
     if (this->options_.workers == 0) {
       this->main_thread_dataset_ =
@@ -37,6 +37,27 @@ struct DataLoaderOptions {
   /// Whether to omit the last batch if it contains less than `batch_size`
   /// examples.
   TORCH_ARG(bool, drop_last) = false;
+
+  /// The device to copy the tensors of the batches to before they are
+  /// returned. For CUDA devices, the batches are copied into pinned memory
+  /// (by the worker threads, if there are any) and then asynchronously to the
+  /// device on a separate stream, `device_prefetch` batches ahead of the one
+  /// that is returned. The current stream waits for the copies of a batch
+  /// when it is returned.
+  TORCH_ARG(optional<Device>, device);
+
+  /// The number of batches to copy to `device` ahead of time.
+  TORCH_ARG(size_t, device_prefetch) = 2;
+
+  /// Whether each worker thread fetches its batches from a separate process,
+  /// forked with a copy of the dataset when the DataLoader is constructed.
+  /// The processes send the tensors of the batches back in shared memory, so
+  /// only their metadata is copied. Only supported for stateless datasets
+  /// whose batches consist of tensors, `Example`s, vectors and optionals, and
+  /// not on Windows. The datasets must not use CUDA. Call `libshm_init()`
+  /// first, so that the libshm manager frees the shared memory if the process
+  /// dies.
+  TORCH_ARG(bool, worker_processes) = false;
 };
 
 /// Like `DataLoaderOptions`, but without any unconfigured state.
@@ -52,7 +73,10 @@ struct FullDataLoaderOptions {
         max_jobs(options.max_jobs().value_or(2 * workers)),
         timeout(options.timeout()),
         enforce_ordering(options.enforce_ordering()),
-        drop_last(options.drop_last()) {}
+        drop_last(options.drop_last()),
+        device(options.device()),
+        device_prefetch(options.device_prefetch()),
+        worker_processes(options.worker_processes()) {}
 
   size_t batch_size;
   size_t workers;
@@ -60,6 +84,9 @@ struct FullDataLoaderOptions {
   optional<std::chrono::milliseconds> timeout;
   bool enforce_ordering;
   bool drop_last;
+  optional<Device> device;
+  size_t device_prefetch;
+  bool worker_processes;
 };
 } // namespace data
 } // namespace torch
@@ -39,26 +39,18 @@ class ChunkDataReader {
 
 namespace detail {
 /// BatchDataBuffer manages a queue of UnwrappedBatchData. After a new chunk is
-/// loaded, BatchDataBuffer splits it into small batches and push them into the
-/// queue. When get_batch is called from data loader, it pops cached batches and
-/// return. If the cache is empty, it either waits to load more chunks or return
-/// null if all chunks are loaded.
-template <
-    typename UnwrappedBatch,
-    typename ExampleSampler = samplers::RandomSampler>
+/// loaded and its examples are shuffled, BatchDataBuffer splits it into small
+/// batches and push them into the queue. When get_batch is called from data
+/// loader, it pops cached batches and return. If the cache is empty, it either
+/// waits to load more chunks or return null if all chunks are loaded.
+template <typename UnwrappedBatch>
 class BatchDataBuffer {
  public:
   using UnwrappedBatchType = UnwrappedBatch;
   using BatchType = torch::optional<UnwrappedBatchType>;
-  using BatchRequestType = typename ExampleSampler::BatchRequestType;
 
-  BatchDataBuffer(
-      size_t batch_size,
-      ExampleSampler& example_sampler,
-      size_t queue_capacity)
-      : batch_size_(batch_size),
-        example_sampler_(example_sampler),
-        queue_capacity_(queue_capacity) {}
+  BatchDataBuffer(size_t batch_size, size_t queue_capacity)
+      : batch_size_(batch_size), queue_capacity_(queue_capacity) {}
 
   /// Return batch data from the queue. Called from the ChunkDataset main
   /// thread.
@@ -87,11 +79,12 @@ class BatchDataBuffer {
     lock.unlock();
     cv_write_.notify_all();
 
-    return batch.batch_data;
+    return std::move(batch.batch_data);
   }
 
-  /// Push preloaded chunks to batch queue. Called from the ChunkDataset worker
-  /// threads.
+  /// Push preloaded chunks to batch queue. The examples of ``data`` must
+  /// already be in the order in which they are to be returned. Called from
+  /// the ChunkDataset worker threads.
   void add_chunk_data(UnwrappedBatchType data) {
     std::unique_lock<std::mutex> lock(queue_mutex_);
     cv_write_.wait(lock, [this] {
@@ -105,19 +98,15 @@ class BatchDataBuffer {
       return;
     }
 
+    // The examples were sampled by the preloader without holding the lock,
+    // only moving them into batches happens here.
     auto data_size = data.size();
     auto remaining_size = data_size;
-    example_sampler_.reset(data_size);
+    size_t next_example = 0;
 
     auto fill_batch = [&](size_t example_count, UnwrappedBatchType& batch) {
-      auto batch_example_indices = this->example_sampler_.next(example_count);
-      AT_ASSERT(
-          batch_example_indices &&
-          batch_example_indices.value().size() == example_count);
-      BatchRequestType& indices = batch_example_indices.value();
-      for (size_t i : indices) {
-        TORCH_CHECK(i < data_size, "Index out of range");
-        batch.emplace_back(std::move(data[i]));
+      for (size_t i = 0; i < example_count; ++i) {
+        batch.emplace_back(std::move(data[next_example++]));
       }
       remaining_size -= example_count;
     };
@@ -228,8 +217,6 @@ class BatchDataBuffer {
   std::condition_variable cv_read_;
   std::condition_variable cv_write_;
 
-  ExampleSampler& example_sampler_;
-
   // configurable maximun number of elements the queue can hold at one time.
   size_t queue_capacity_;
 
@@ -383,11 +370,13 @@ class ChunkDataset final
 
     // Throw out any existing cached batch in the buffer and re-creates a new
     // chunk buffer.
-    batch_buffer_ = torch::make_unique<
-        detail::BatchDataBuffer<UnwrappedBatchType, ExampleSamplerType>>(
-        options_.batch_size(),
-        example_sampler_,
-        options_.cache_size());
+    batch_buffer_ =
+        torch::make_unique<detail::BatchDataBuffer<UnwrappedBatchType>>(
+            options_.batch_size(), options_.cache_size());
+
+    // Every preloader shuffles the examples of its chunks with its own copy
+    // of the example sampler, so they do not wait for each other to do so.
+    example_samplers_.assign(options_.preloader_count(), example_sampler_);
 
     // create new workers for this new epoch.
     quit_worker_ = false;
@@ -445,7 +434,8 @@ class ChunkDataset final
           preprocessing_policy_(data);
         }
         if (!data.empty()) { // skip empty chunks.
-          batch_buffer_->add_chunk_data(std::move(data));
+          batch_buffer_->add_chunk_data(
+              sample_examples(std::move(data), example_samplers_[id]));
         }
       } catch (...) {
         batch_buffer_->add_chunk_data(std::current_exception());
@@ -459,6 +449,25 @@ class ChunkDataset final
     }
   }
 
+  /// Returns the examples of ``data`` in the order in which
+  /// ``example_sampler`` samples them.
+  UnwrappedBatchType sample_examples(
+      UnwrappedBatchType data,
+      ExampleSamplerType& example_sampler) {
+    const auto data_size = data.size();
+    example_sampler.reset(data_size);
+    auto example_indices = example_sampler.next(data_size);
+    AT_ASSERT(example_indices && example_indices.value().size() == data_size);
+
+    UnwrappedBatchType examples;
+    examples.reserve(data_size);
+    for (size_t i : example_indices.value()) {
+      TORCH_CHECK(i < data_size, "Index out of range");
+      examples.emplace_back(std::move(data[i]));
+    }
+    return examples;
+  }
+
   /// Block the current thread until the workers finish execution and exit.
   void free_workers() {
     if (!quit_worker_.load()) {
@@ -481,9 +490,11 @@ class ChunkDataset final
   // example sampler to shuffle examples in a specific chunk
   ExampleSamplerType example_sampler_;
 
+  // copies of example_sampler_ used by the preloaders, indexed by preloader id.
+  std::vector<ExampleSamplerType> example_samplers_;
+
   // batch data buffer which holds chunk data from preloading thread.
-  std::shared_ptr<detail::BatchDataBuffer<UnwrappedBatchType, ExampleSamplerType>>
-      batch_buffer_;
+  std::shared_ptr<detail::BatchDataBuffer<UnwrappedBatchType>> batch_buffer_;
 
   // worker thread pool
   std::vector<std::thread> preload_threads_;
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <torch/data/datasets/base.h>
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <c10/util/ArrayRef.h>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+
+/// A dataset of the rows of a tensor that is memory-mapped from a file, so
+/// that datasets larger than memory can be used without loading them first.
+/// The examples alias the mapping: the file is read by the OS as they are
+/// accessed. The mapping is private, so writes to the examples never reach
+/// the file.
+class TORCH_API MappedTensorDataset
+    : public Dataset<MappedTensorDataset, TensorExample> {
+ public:
+  /// The order in which the examples will be accessed, which the OS uses to
+  /// decide how far to read ahead of the accessed pages.
+  enum class Access { kNormal, kSequential, kRandom };
+
+  /// Maps the examples stored in the file at `path`, starting at `offset`
+  /// bytes, as a contiguous tensor of `dtype` whose rows have
+  /// `example_sizes`. Uses `length` bytes, or the rest of the file, which
+  /// must hold a whole number of examples.
+  MappedTensorDataset(
+      const std::string& path,
+      ScalarType dtype,
+      IntArrayRef example_sizes,
+      Access access = Access::kNormal,
+      size_t offset = 0,
+      optional<size_t> length = nullopt);
+
+  /// Maps the examples stored in the record `record` of the zip archive at
+  /// `path`, as read by `caffe2::serialize::PyTorchStreamReader`. The record
+  /// must be stored uncompressed, as `PyTorchStreamWriter` does.
+  static MappedTensorDataset from_archive(
+      const std::string& path,
+      const std::string& record,
+      ScalarType dtype,
+      IntArrayRef example_sizes,
+      Access access = Access::kNormal);
+
+  /// Returns the example at `index`, which aliases the mapping.
+  TensorExample get(size_t index) override;
+
+  /// Returns the examples at `indices`. Before they are returned, the OS is
+  /// asked to read all of them in, so the reads of a batch overlap rather than
+  /// page fault one after another when the examples are first accessed.
+  std::vector<TensorExample> get_batch(ArrayRef<size_t> indices) override;
+
+  /// Returns the number of examples.
+  optional<size_t> size() const override;
+
+  /// Returns the mapped tensor, whose first dimension indexes the examples.
+  const Tensor& tensor() const;
+
+ private:
+  Tensor tensor_;
+};
+} // namespace datasets
+} // namespace data
+} // namespace torch
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <c10/util/Optional.h>
+
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// Replaces every tensor of a batch with `function(tensor)`. Batches may be
+/// tensors, `Example`s, or vectors or optionals of those. Batches of any other
+/// type are returned unchanged.
+template <typename T, typename F>
+T map_tensors(T value, const F& function);
+template <typename F>
+Tensor map_tensors(Tensor tensor, const F& function);
+template <typename Data, typename Target, typename F>
+Example<Data, Target> map_tensors(
+    Example<Data, Target> example,
+    const F& function);
+template <typename Data, typename F>
+Example<Data, example::NoTarget> map_tensors(
+    Example<Data, example::NoTarget> example,
+    const F& function);
+template <typename T, typename F>
+std::vector<T> map_tensors(std::vector<T> values, const F& function);
+template <typename T, typename F>
+optional<T> map_tensors(optional<T> value, const F& function);
+
+template <typename T, typename F>
+T map_tensors(T value, const F& /*function*/) {
+  return value;
+}
+
+template <typename F>
+Tensor map_tensors(Tensor tensor, const F& function) {
+  if (!tensor.defined()) {
+    return tensor;
+  }
+  return function(tensor);
+}
+
+template <typename Data, typename Target, typename F>
+Example<Data, Target> map_tensors(
+    Example<Data, Target> example,
+    const F& function) {
+  example.data = map_tensors(std::move(example.data), function);
+  example.target = map_tensors(std::move(example.target), function);
+  return example;
+}
+
+template <typename Data, typename F>
+Example<Data, example::NoTarget> map_tensors(
+    Example<Data, example::NoTarget> example,
+    const F& function) {
+  example.data = map_tensors(std::move(example.data), function);
+  return example;
+}
+
+template <typename T, typename F>
+std::vector<T> map_tensors(std::vector<T> values, const F& function) {
+  for (auto& value : values) {
+    value = map_tensors(std::move(value), function);
+  }
+  return values;
+}
+
+template <typename T, typename F>
+optional<T> map_tensors(optional<T> value, const F& function) {
+  if (value) {
+    value = map_tensors(std::move(*value), function);
+  }
+  return value;
+}
+
+/// Copies the dense CPU tensors of a batch into pinned memory, from which they
+/// can be copied to a CUDA device asynchronously.
+template <typename Batch>
+Batch pin_memory(Batch batch) {
+  return map_tensors(std::move(batch), [](const Tensor& tensor) {
+    if (tensor.device().is_cpu() && tensor.layout() == kStrided &&
+        !tensor.is_pinned()) {
+      return tensor.pin_memory();
+    }
+    return tensor;
+  });
+}
+
+} // namespace detail
+} // namespace data
+} // namespace torch
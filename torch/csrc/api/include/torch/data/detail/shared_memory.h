@@ -0,0 +1,31 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <c10/core/Allocator.h>
+
+#include <cstddef>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// Maps the shared memory region `filename` of `size` bytes, with the
+/// signature of `THManagedMapAllocator::makeDataPtr` from libshm.
+using SharedMemoryAllocator = at::DataPtr (*)(
+    const char* manager_handle,
+    const char* filename,
+    int flags,
+    ptrdiff_t size);
+
+/// Sets the function with which the trainer maps the tensors that DataLoader
+/// worker processes send it. `libshm_init()` sets it to
+/// `THManagedMapAllocator::makeDataPtr`, so that the libshm manager frees the
+/// shared memory if the trainer dies. Until then, or if `allocator` is null,
+/// the memory is mapped with `THRefcountedMapAllocator`, which frees it when
+/// the last process that maps it closes it.
+TORCH_API void set_shared_memory_allocator(SharedMemoryAllocator allocator);
+
+} // namespace detail
+} // namespace data
+} // namespace torch
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/data/detail/shared_memory.h>
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <torch/csrc/utils/memory.h>
+
+#include <c10/util/Optional.h>
+#include <c10/util/Type.h>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace detail {
+
+/// Serializes the batches and batch requests exchanged with DataLoader worker
+/// processes. Tensors are copied into shared memory and only their metadata
+/// and the name of their shared memory region are written.
+class TORCH_API BatchWriter {
+ public:
+  /// Appends `size` bytes at `data` to the buffer.
+  void write(const void* data, size_t size);
+
+  /// Writes a dense CPU `tensor`, which is copied into shared memory. The copy
+  /// stays alive until the writer is cleared, so the process that reads the
+  /// buffer must have done so by then.
+  void write_tensor(const Tensor& tensor);
+
+  /// Returns the serialized bytes.
+  const std::string& buffer() const noexcept {
+    return buffer_;
+  }
+
+  /// Clears the buffer and releases the shared memory of the tensors written.
+  void clear();
+
+ private:
+  std::string buffer_;
+  std::vector<Tensor> shared_tensors_;
+};
+
+/// Reads what a `BatchWriter` wrote, mapping the shared memory of its tensors.
+class TORCH_API BatchReader {
+ public:
+  explicit BatchReader(std::string buffer) : buffer_(std::move(buffer)) {}
+
+  /// Reads the next `size` bytes into `data`.
+  void read(void* data, size_t size);
+
+  /// Reads a tensor written by `BatchWriter::write_tensor`.
+  Tensor read_tensor();
+
+ private:
+  std::string buffer_;
+  size_t position_ = 0;
+};
+
+/// Throws the error for a batch (or batch request) type that cannot be sent
+/// to or from worker processes.
+[[noreturn]] TORCH_API void unsupported_worker_process_type(const char* type);
+
+/// Writes and reads values of type `T` with a `BatchWriter` and a
+/// `BatchReader`. Tensors, `Example`s, vectors, optionals and strings of those
+/// and trivially copyable values are supported. For other types, the
+/// functions throw, so DataLoaders of any batch type compile, but only those
+/// can use worker processes.
+template <typename T>
+struct BatchCodec {
+  static void write(BatchWriter& writer, const T& value) {
+    write(writer, value, std::is_trivially_copyable<T>());
+  }
+  static T read(BatchReader& reader) {
+    return read(reader, std::is_trivially_copyable<T>());
+  }
+
+ private:
+  static void write(BatchWriter& writer, const T& value, std::true_type) {
+    writer.write(&value, sizeof(T));
+  }
+  static T read(BatchReader& reader, std::true_type) {
+    T value;
+    reader.read(&value, sizeof(T));
+    return value;
+  }
+  static void write(
+      BatchWriter& /*writer*/,
+      const T& /*value*/,
+      std::false_type) {
+    unsupported_worker_process_type(c10::demangle_type<T>());
+  }
+  static T read(BatchReader& /*reader*/, std::false_type) {
+    unsupported_worker_process_type(c10::demangle_type<T>());
+  }
+};
+
+template <>
+struct BatchCodec<Tensor> {
+  static void write(BatchWriter& writer, const Tensor& tensor) {
+    writer.write_tensor(tensor);
+  }
+  static Tensor read(BatchReader& reader) {
+    return reader.read_tensor();
+  }
+};
+
+template <>
+struct BatchCodec<std::string> {
+  static void write(BatchWriter& writer, const std::string& value) {
+    BatchCodec<size_t>::write(writer, value.size());
+    writer.write(value.data(), value.size());
+  }
+  static std::string read(BatchReader& reader) {
+    std::string value(BatchCodec<size_t>::read(reader), '\0');
+    reader.read(&value[0], value.size());
+    return value;
+  }
+};
+
+template <typename Data, typename Target>
+struct BatchCodec<Example<Data, Target>> {
+  static void write(BatchWriter& writer, const Example<Data, Target>& value) {
+    BatchCodec<Data>::write(writer, value.data);
+    BatchCodec<Target>::write(writer, value.target);
+  }
+  static Example<Data, Target> read(BatchReader& reader) {
+    // Braced initializers are evaluated in order.
+    return Example<Data, Target>{BatchCodec<Data>::read(reader),
+                                 BatchCodec<Target>::read(reader)};
+  }
+};
+
+template <typename Data>
+struct BatchCodec<Example<Data, example::NoTarget>> {
+  static void write(
+      BatchWriter& writer,
+      const Example<Data, example::NoTarget>& value) {
+    BatchCodec<Data>::write(writer, value.data);
+  }
+  static Example<Data, example::NoTarget> read(BatchReader& reader) {
+    return Example<Data, example::NoTarget>(BatchCodec<Data>::read(reader));
+  }
+};
+
+template <typename T>
+struct BatchCodec<std::vector<T>> {
+  static void write(BatchWriter& writer, const std::vector<T>& values) {
+    BatchCodec<size_t>::write(writer, values.size());
+    for (const auto& value : values) {
+      BatchCodec<T>::write(writer, value);
+    }
+  }
+  static std::vector<T> read(BatchReader& reader) {
+    const auto size = BatchCodec<size_t>::read(reader);
+    std::vector<T> values;
+    values.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+      values.push_back(BatchCodec<T>::read(reader));
+    }
+    return values;
+  }
+};
+
+template <typename T>
+struct BatchCodec<optional<T>> {
+  static void write(BatchWriter& writer, const optional<T>& value) {
+    BatchCodec<bool>::write(writer, value.has_value());
+    if (value) {
+      BatchCodec<T>::write(writer, *value);
+    }
+  }
+  static optional<T> read(BatchReader& reader) {
+    if (!BatchCodec<bool>::read(reader)) {
+      return nullopt;
+    }
+    return BatchCodec<T>::read(reader);
+  }
+};
+
+/// A process forked by a DataLoader, which answers the requests of one worker
+/// thread. The process only runs `handler` (and whatever it calls), so it
+/// must not depend on other threads of the DataLoader's process, or on its
+/// CUDA context.
+class TORCH_API WorkerProcess {
+ public:
+  using Handler = std::function<std::string(std::string)>;
+
+  /// Forks a process that answers each request with `handler(request)`, until
+  /// the `WorkerProcess` is destroyed.
+  explicit WorkerProcess(Handler handler);
+
+  /// Closes the connection to the process, after which it exits, and waits
+  /// for it.
+  ~WorkerProcess();
+
+  WorkerProcess(const WorkerProcess&) = delete;
+  WorkerProcess& operator=(const WorkerProcess&) = delete;
+
+  /// Sends `request` to the process and returns its reply. If the handler
+  /// threw, throws an error with its message instead, and if the process
+  /// died, one that says how. Called by one thread at a time.
+  std::string request(const std::string& request);
+
+ private:
+  /// Waits for the process after it died and describes how it exited.
+  std::string reap();
+
+  /// This process' end of the socket connected to the worker process.
+  int socket_ = -1;
+  int pid_ = -1;
+};
+
+/// Forks a process that answers batch requests with the batches `dataset`
+/// returns for them. A batch stays in shared memory until the next request,
+/// by which time the worker thread has mapped it.
+template <typename Batch, typename BatchRequest, typename Dataset>
+std::unique_ptr<WorkerProcess> make_worker_process(Dataset dataset) {
+  auto writer = std::make_shared<BatchWriter>();
+  return torch::make_unique<WorkerProcess>(
+      [dataset, writer](std::string request) mutable {
+        BatchReader reader(std::move(request));
+        auto batch_request = BatchCodec<BatchRequest>::read(reader);
+        writer->clear();
+        BatchCodec<Batch>::write(
+            *writer, dataset.get_batch(std::move(batch_request)));
+        return writer->buffer();
+      });
+}
+
+/// Returns the batch a process made by `make_worker_process` returns for
+/// `request`. Its tensors map the shared memory the process wrote them to.
+template <typename Batch, typename BatchRequest>
+Batch fetch_batch(WorkerProcess& process, const BatchRequest& request) {
+  BatchWriter writer;
+  BatchCodec<BatchRequest>::write(writer, request);
+  BatchReader reader(process.request(writer.buffer()));
+  return BatchCodec<Batch>::read(reader);
+}
+
+} // namespace detail
+} // namespace data
+} // namespace torch
@@ -83,6 +83,11 @@ class TORCH_API OptimizerParamGroup {
 
 namespace detail {
 
+/// Whether the fused optimizer steps (`_fused_sgd_` and `_fused_adam_`) have
+/// a kernel for `tensor`, i.e. it is a dense CPU or CUDA tensor. Optimizers
+/// update the other parameters with regular tensor ops.
+TORCH_API bool has_fused_step_kernel(const Tensor& tensor);
+
 /// Base class for all optimizers, that does not yet define a `step()`
 /// mechanism. All it specifies is that optimizers must be supplied with a
 /// vector of parameters. It also defines certain methods that all optimizers
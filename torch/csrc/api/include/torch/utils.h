@@ -8,6 +8,8 @@ namespace torch {
 
 using NoGradGuard = at::NoGradGuard;
 
+using InferenceModeGuard = at::InferenceModeGuard;
+
 /// Sets the global random seed for all newly created CPU and CUDA tensors.
 using at::manual_seed;
 
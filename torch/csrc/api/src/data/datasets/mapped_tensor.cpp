@@ -0,0 +1,168 @@
+#include <torch/data/datasets/mapped_tensor.h>
+
+#include <torch/data/example.h>
+#include <torch/types.h>
+
+#include <TH/THAllocator.h>
+#include <c10/util/Exception.h>
+#include <caffe2/serialize/inline_container.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace data {
+namespace datasets {
+namespace {
+#ifndef _WIN32
+/// Passes `advice` to `madvise()` for the pages that overlap the `length`
+/// bytes at `data`. Advice is only a hint, so errors are ignored.
+void advise(const void* data, size_t length, int advice) {
+  static const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  const auto begin = reinterpret_cast<uintptr_t>(data) & ~(page_size - 1);
+  const auto end = reinterpret_cast<uintptr_t>(data) + length;
+  madvise(reinterpret_cast<void*>(begin), end - begin, advice);
+}
+#endif
+} // namespace
+
+MappedTensorDataset::MappedTensorDataset(
+    const std::string& path,
+    ScalarType dtype,
+    IntArrayRef example_sizes,
+    Access access,
+    size_t offset,
+    optional<size_t> length) {
+  const auto type_meta = c10::scalarTypeToTypeMeta(dtype);
+  TORCH_CHECK(
+      offset % type_meta.itemsize() == 0,
+      "The offset of a MappedTensorDataset must be a multiple of the size of ",
+      type_meta.name(),
+      ", but got ",
+      offset);
+
+  size_t file_size = 0;
+  auto data_ptr = THMapAllocator::makeDataPtr(
+      path.c_str(), /*flags=*/0, /*size=*/0, &file_size);
+  TORCH_CHECK(
+      offset <= file_size && length.value_or(0) <= file_size - offset,
+      "The examples of a MappedTensorDataset must be within the ",
+      file_size,
+      " bytes of ",
+      path);
+#ifndef _WIN32
+  switch (access) {
+    case Access::kSequential:
+      advise(data_ptr.get(), file_size, MADV_SEQUENTIAL);
+      break;
+    case Access::kRandom:
+      advise(data_ptr.get(), file_size, MADV_RANDOM);
+      break;
+    case Access::kNormal:
+      break;
+  }
+#endif
+
+  int64_t example_numel = 1;
+  for (const auto size : example_sizes) {
+    example_numel *= size;
+  }
+  const size_t example_bytes = example_numel * type_meta.itemsize();
+  const size_t bytes = length.value_or(file_size - offset);
+  TORCH_CHECK(
+      example_bytes > 0 && bytes % example_bytes == 0,
+      "The ",
+      bytes,
+      " bytes of ",
+      path,
+      " are not a whole number of examples of size ",
+      example_sizes,
+      " and type ",
+      type_meta.name());
+
+  std::vector<int64_t> sizes = {static_cast<int64_t>(bytes / example_bytes)};
+  sizes.insert(sizes.end(), example_sizes.begin(), example_sizes.end());
+  at::Storage storage(
+      type_meta,
+      file_size / type_meta.itemsize(),
+      std::move(data_ptr),
+      /*allocator=*/nullptr,
+      /*resizable=*/false);
+  tensor_ = torch::empty({0}, torch::dtype(dtype))
+                .set_(storage, offset / type_meta.itemsize(), sizes);
+}
+
+MappedTensorDataset MappedTensorDataset::from_archive(
+    const std::string& path,
+    const std::string& record,
+    ScalarType dtype,
+    IntArrayRef example_sizes,
+    Access access) {
+  caffe2::serialize::PyTorchStreamReader reader(path);
+  TORCH_CHECK(
+      reader.hasRecord(record), "No record ", record, " in archive ", path);
+  TORCH_CHECK(
+      !reader.isRecordCompressed(record),
+      "Record ",
+      record,
+      " of archive ",
+      path,
+      " is compressed and cannot be mapped");
+  return MappedTensorDataset(
+      path,
+      dtype,
+      example_sizes,
+      access,
+      reader.getRecordOffset(record),
+      reader.getRecordSize(record));
+}
+
+TensorExample MappedTensorDataset::get(size_t index) {
+  return tensor_[index];
+}
+
+std::vector<TensorExample> MappedTensorDataset::get_batch(
+    ArrayRef<size_t> indices) {
+#ifndef _WIN32
+  // Consecutive indices are advised as one range.
+  const size_t example_bytes =
+      tensor_.numel() / std::max<int64_t>(tensor_.size(0), 1) *
+      tensor_.element_size();
+  const auto data = static_cast<const char*>(tensor_.data_ptr());
+  for (size_t i = 0; i < indices.size();) {
+    size_t end = i + 1;
+    while (end < indices.size() && indices[end] == indices[end - 1] + 1) {
+      ++end;
+    }
+    if (indices[i] < static_cast<size_t>(tensor_.size(0))) {
+      const auto examples = std::min<size_t>(
+          end - i, static_cast<size_t>(tensor_.size(0)) - indices[i]);
+      advise(
+          data + indices[i] * example_bytes,
+          examples * example_bytes,
+          MADV_WILLNEED);
+    }
+    i = end;
+  }
+#endif
+  return Dataset::get_batch(indices);
+}
+
+optional<size_t> MappedTensorDataset::size() const {
+  return tensor_.size(0);
+}
+
+const Tensor& MappedTensorDataset::tensor() const {
+  return tensor_;
+}
+} // namespace datasets
+} // namespace data
+} // namespace torch
@@ -0,0 +1,355 @@
+#include <torch/data/detail/shared_memory.h>
+#include <torch/data/detail/worker_process.h>
+#include <torch/types.h>
+#include <torch/utils.h>
+
+#include <ATen/Parallel.h>
+#include <TH/THAllocator.h>
+#include <c10/util/Exception.h>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+#endif
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+
+namespace torch {
+namespace data {
+namespace detail {
+namespace {
+std::atomic<SharedMemoryAllocator> shared_memory_allocator{nullptr};
+
+at::DataPtr map_shared_memory(const char* filename, int flags, size_t size) {
+  if (auto allocator = shared_memory_allocator.load()) {
+    return allocator(/*manager_handle=*/"", filename, flags, size);
+  }
+  return THRefcountedMapAllocator::makeDataPtr(
+      filename, flags, size, /*actual_size_out=*/nullptr);
+}
+
+/// Returns a new name for a shared memory region, like the ones Python's
+/// `torch.multiprocessing` uses.
+std::string new_shared_memory_name() {
+  static std::mutex mutex;
+  static std::random_device random;
+  std::lock_guard<std::mutex> lock(mutex);
+  std::string name = "/torch_";
+#ifndef _WIN32
+  name += std::to_string(getpid());
+#endif
+  name += "_";
+  name += std::to_string(random());
+  return name;
+}
+
+Tensor map_shared_tensor(
+    const std::string& filename,
+    int flags,
+    ScalarType dtype,
+    IntArrayRef sizes,
+    size_t nbytes) {
+  const auto type_meta = c10::scalarTypeToTypeMeta(dtype);
+  at::Storage storage(
+      type_meta,
+      nbytes / type_meta.itemsize(),
+      map_shared_memory(filename.c_str(), flags, nbytes),
+      /*allocator=*/nullptr,
+      /*resizable=*/false);
+  return torch::empty({0}, torch::dtype(dtype)).set_(storage).view(sizes);
+}
+} // namespace
+
+void set_shared_memory_allocator(SharedMemoryAllocator allocator) {
+  shared_memory_allocator = allocator;
+}
+
+void BatchWriter::write(const void* data, size_t size) {
+  buffer_.append(static_cast<const char*>(data), size);
+}
+
+void BatchWriter::write_tensor(const Tensor& tensor) {
+  BatchCodec<bool>::write(*this, tensor.defined());
+  if (!tensor.defined()) {
+    return;
+  }
+  TORCH_CHECK(
+      tensor.device().is_cpu() && tensor.layout() == kStrided,
+      "DataLoader worker processes can only send dense CPU tensors, "
+      "but got a tensor of type ",
+      tensor.toString());
+  BatchCodec<ScalarType>::write(*this, tensor.scalar_type());
+  BatchCodec<std::vector<int64_t>>::write(*this, tensor.sizes().vec());
+  const size_t nbytes = tensor.numel() * tensor.element_size();
+  // Shared memory regions cannot be empty.
+  std::string filename;
+  if (nbytes > 0) {
+    filename = new_shared_memory_name();
+    auto shared = map_shared_tensor(
+        filename,
+        TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_EXCLUSIVE,
+        tensor.scalar_type(),
+        tensor.sizes(),
+        nbytes);
+    {
+      NoGradGuard guard;
+      shared.copy_(tensor);
+    }
+    shared_tensors_.push_back(std::move(shared));
+  }
+  BatchCodec<std::string>::write(*this, filename);
+}
+
+void BatchWriter::clear() {
+  buffer_.clear();
+  shared_tensors_.clear();
+}
+
+void BatchReader::read(void* data, size_t size) {
+  TORCH_CHECK(
+      size <= buffer_.size() - position_,
+      "Unexpected end of a message from a DataLoader worker process");
+  std::memcpy(data, buffer_.data() + position_, size);
+  position_ += size;
+}
+
+Tensor BatchReader::read_tensor() {
+  if (!BatchCodec<bool>::read(*this)) {
+    return Tensor();
+  }
+  const auto dtype = BatchCodec<ScalarType>::read(*this);
+  const auto sizes = BatchCodec<std::vector<int64_t>>::read(*this);
+  const auto filename = BatchCodec<std::string>::read(*this);
+  if (filename.empty()) {
+    return torch::empty(sizes, torch::dtype(dtype));
+  }
+  size_t numel = 1;
+  for (const auto size : sizes) {
+    numel *= size;
+  }
+  return map_shared_tensor(
+      filename,
+      TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE,
+      dtype,
+      sizes,
+      numel * c10::elementSize(dtype));
+}
+
+void unsupported_worker_process_type(const char* type) {
+  TORCH_CHECK(
+      false,
+      "DataLoader worker processes cannot send values of type ",
+      type,
+      ". Only tensors, Examples, vectors, optionals and strings of those and "
+      "trivially copyable values are supported");
+}
+
+#ifndef _WIN32
+namespace {
+/// Our ends of the sockets of all worker processes, which the processes
+/// forked later close, so that each worker process sees its socket close when
+/// its `WorkerProcess` is destroyed.
+std::mutex worker_sockets_mutex;
+std::set<int> worker_sockets;
+
+bool send_all(int socket, const char* data, size_t size) {
+#ifdef MSG_NOSIGNAL
+  const int flags = MSG_NOSIGNAL;
+#else
+  const int flags = 0;
+#endif
+  while (size > 0) {
+    const auto sent = send(socket, data, size, flags);
+    if (sent < 0 && errno == EINTR) {
+      continue;
+    } else if (sent <= 0) {
+      return false;
+    }
+    data += sent;
+    size -= sent;
+  }
+  return true;
+}
+
+bool receive_all(int socket, char* data, size_t size) {
+  while (size > 0) {
+    const auto received = recv(socket, data, size, 0);
+    if (received < 0 && errno == EINTR) {
+      continue;
+    } else if (received <= 0) {
+      return false;
+    }
+    data += received;
+    size -= received;
+  }
+  return true;
+}
+
+/// Messages are their size followed by their bytes. Returns false if the
+/// other process closed the socket.
+bool send_message(int socket, const std::string& message) {
+  const uint64_t size = message.size();
+  return send_all(
+             socket, reinterpret_cast<const char*>(&size), sizeof(size)) &&
+      send_all(socket, message.data(), message.size());
+}
+
+bool receive_message(int socket, std::string* message) {
+  uint64_t size = 0;
+  if (!receive_all(socket, reinterpret_cast<char*>(&size), sizeof(size))) {
+    return false;
+  }
+  message->resize(size);
+  return size == 0 || receive_all(socket, &(*message)[0], size);
+}
+
+/// Replies start with one of these.
+constexpr char kReplyOk = 0;
+constexpr char kReplyError = 1;
+
+[[noreturn]] void run_worker_process(
+    int socket,
+    WorkerProcess::Handler handler) {
+  // The manager connection of libshm belongs to the trainer, so the worker
+  // creates its shared memory without it. The trainer registers the memory
+  // with the manager when it maps it.
+  set_shared_memory_allocator(nullptr);
+  // The thread pool of the trainer was not forked with this thread.
+  at::set_num_threads(1);
+
+  std::string request;
+  while (receive_message(socket, &request)) {
+    std::string reply(1, kReplyOk);
+    try {
+      reply += handler(std::move(request));
+    } catch (const std::exception& e) {
+      reply = std::string(1, kReplyError) + e.what();
+    } catch (...) {
+      reply = std::string(1, kReplyError) + "Unknown exception";
+    }
+    if (!send_message(socket, reply)) {
+      break;
+    }
+  }
+  // `_exit()` skips destructors, but the shared memory of the last batch must
+  // be released to drop its reference count.
+  handler = nullptr;
+  _exit(EXIT_SUCCESS);
+}
+} // namespace
+
+WorkerProcess::WorkerProcess(Handler handler) {
+  int sockets[2];
+  TORCH_CHECK(
+      socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0,
+      "Failed to create a socket for a DataLoader worker process: ",
+      std::strerror(errno));
+#ifdef SO_NOSIGPIPE
+  const int enable = 1;
+  setsockopt(sockets[0], SOL_SOCKET, SO_NOSIGPIPE, &enable, sizeof(enable));
+#endif
+
+  std::lock_guard<std::mutex> lock(worker_sockets_mutex);
+  const auto parent = getpid();
+  pid_ = fork();
+  if (pid_ == 0) {
+#ifdef __linux__
+    // Dies with the trainer, unless it died before this was set.
+    if (prctl(PR_SET_PDEATHSIG, SIGKILL) != 0 || getppid() != parent) {
+      _exit(EXIT_FAILURE);
+    }
+#endif
+    close(sockets[0]);
+    for (const auto socket : worker_sockets) {
+      close(socket);
+    }
+    run_worker_process(sockets[1], std::move(handler));
+  }
+  const auto error = errno;
+  close(sockets[1]);
+  if (pid_ < 0) {
+    close(sockets[0]);
+    TORCH_CHECK(
+        false,
+        "Failed to fork a DataLoader worker process: ",
+        std::strerror(error));
+  }
+  socket_ = sockets[0];
+  worker_sockets.insert(socket_);
+}
+
+WorkerProcess::~WorkerProcess() {
+  {
+    std::lock_guard<std::mutex> lock(worker_sockets_mutex);
+    worker_sockets.erase(socket_);
+  }
+  close(socket_);
+  if (pid_ > 0) {
+    reap();
+  }
+}
+
+std::string WorkerProcess::request(const std::string& request) {
+  std::string reply;
+  if (pid_ < 0 || !send_message(socket_, request) ||
+      !receive_message(socket_, &reply) || reply.empty()) {
+    TORCH_CHECK(false, "DataLoader worker process exited unexpectedly", reap());
+  }
+  TORCH_CHECK(reply[0] == kReplyOk, reply.substr(1));
+  return reply.substr(1);
+}
+
+std::string WorkerProcess::reap() {
+  if (pid_ < 0) {
+    return "";
+  }
+  const auto pid = pid_;
+  pid_ = -1;
+  int status = 0;
+  while (waitpid(pid, &status, 0) < 0) {
+    if (errno != EINTR) {
+      return "";
+    }
+  }
+  if (WIFSIGNALED(status)) {
+    return " (pid " + std::to_string(pid) + " was killed by signal " +
+        strsignal(WTERMSIG(status)) + ")";
+  }
+  return " (pid " + std::to_string(pid) + " exited with code " +
+      std::to_string(WEXITSTATUS(status)) + ")";
+}
+#else
+WorkerProcess::WorkerProcess(Handler handler) {
+  TORCH_CHECK(
+      false, "DataLoader worker processes are not supported on Windows");
+}
+
+WorkerProcess::~WorkerProcess() = default;
+
+std::string WorkerProcess::request(const std::string& request) {
+  TORCH_CHECK(
+      false, "DataLoader worker processes are not supported on Windows");
+}
+
+std::string WorkerProcess::reap() {
+  return "";
+}
+#endif
+} // namespace detail
+} // namespace data
+} // namespace torch
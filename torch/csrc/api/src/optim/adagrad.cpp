@@ -76,22 +76,10 @@ void Adagrad::step() {
           (1 + static_cast<double>(state.step() - 1) * options.lr_decay());
 
       if (grad.is_sparse()) {
-        grad = grad.coalesce();
-        auto grad_indices = grad._indices();
-        auto grad_values = grad._values();
-        auto size = grad.sizes();
-
-        auto make_sparse = [&] (const Tensor& values) -> Tensor {
-          if (grad_indices.dim() == 0 || values.dim() == 0) {
-            return torch::empty({0}, grad.options()).resize_as_(grad);
-          }
-          return torch::sparse_coo_tensor(grad_indices, values, size, grad.options());
-        };
-        state.sum(state.sum().add_(make_sparse(grad_values.pow(2))));
-        auto std = state.sum().sparse_mask(grad);
-        const auto std_values = std._values().sqrt_().add_(options.eps());
-
-        p.data().add_(make_sparse(grad_values / std_values), -clr);
+        // Only updates the rows of the parameter that the gradient touches.
+        auto param = p.data();
+        auto sum = state.sum();
+        torch::_sparse_adagrad_(param, sum, grad, clr, options.eps());
       }
       else {
         state.sum(state.sum().addcmul_(grad, grad, 1.0));
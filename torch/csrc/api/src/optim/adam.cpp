@@ -9,6 +9,8 @@
 
 #include <cmath>
 #include <functional>
+#include <map>
+#include <vector>
 
 namespace torch {
 namespace optim {
@@ -16,44 +18,77 @@ AdamOptions::AdamOptions(double learning_rate)
     : learning_rate_(learning_rate) {}
 
 void Adam::step() {
+  // The bias corrections depend on the step count, so the parameters are
+  // updated in one fused call per distinct step count.
+  struct Group {
+    std::vector<Tensor> params;
+    std::vector<Tensor> grads;
+    std::vector<Tensor> exp_averages;
+    std::vector<Tensor> exp_average_sqs;
+    std::vector<Tensor> max_exp_average_sqs;
+  };
+  std::map<int64_t, Group> groups;
   for (size_t i = 0; i < parameters_.size(); ++i) {
     Tensor p = parameters_.at(i);
     if (!p.grad().defined()) {
       continue;
     }
 
-    if (options.weight_decay() > 0) {
+    const auto step = ++buffer_at(step_buffers, i);
+    if (!detail::has_fused_step_kernel(p) ||
+        !detail::has_fused_step_kernel(p.grad())) {
       NoGradGuard guard;
-      p.grad() = p.grad() + options.weight_decay() * p;
+      auto grad = p.grad();
+      if (options.weight_decay() > 0) {
+        grad = grad + options.weight_decay() * p;
+      }
+      auto& exp_average = buffer_at(exp_average_buffers, i);
+      auto& exp_average_sq = buffer_at(exp_average_sq_buffers, i);
+      const auto bias_correction1 = 1 - std::pow(options.beta1(), step);
+      const auto bias_correction2 = 1 - std::pow(options.beta2(), step);
+      exp_average.mul_(options.beta1()).add_(grad, 1 - options.beta1());
+      exp_average_sq.mul_(options.beta2())
+          .addcmul_(grad, grad, 1 - options.beta2());
+      Tensor denom;
+      if (options.amsgrad()) {
+        auto& max_exp_average_sq = buffer_at(max_exp_average_sq_buffers, i);
+        max_exp_average_sq = torch::max(max_exp_average_sq, exp_average_sq);
+        denom = max_exp_average_sq / bias_correction2;
+      } else {
+        denom = exp_average_sq / bias_correction2;
+      }
+      const auto step_size = options.learning_rate() / bias_correction1;
+      p.addcdiv_(exp_average, denom.sqrt() + options.eps(), -step_size);
+      continue;
     }
 
-    auto& exp_average = buffer_at(exp_average_buffers, i);
-    auto& exp_average_sq = buffer_at(exp_average_sq_buffers, i);
-
-    buffer_at(step_buffers, i) += 1;
-    const auto bias_correction1 =
-        1 - std::pow(options.beta1(), buffer_at(step_buffers, i));
-    const auto bias_correction2 =
-        1 - std::pow(options.beta2(), buffer_at(step_buffers, i));
-
-    exp_average.mul_(options.beta1()).add_(p.grad(), 1 - options.beta1());
-    exp_average_sq.mul_(options.beta2())
-        .addcmul_(p.grad(), p.grad(), 1 - options.beta2());
-
-    Tensor denom;
+    auto& group = groups[step];
+    group.params.push_back(p);
+    group.grads.push_back(p.grad());
+    group.exp_averages.push_back(buffer_at(exp_average_buffers, i));
+    group.exp_average_sqs.push_back(buffer_at(exp_average_sq_buffers, i));
     if (options.amsgrad()) {
-      auto& max_exp_average_sq = buffer_at(max_exp_average_sq_buffers, i);
-      max_exp_average_sq = torch::max(max_exp_average_sq, exp_average_sq);
-      denom = max_exp_average_sq / bias_correction2;
-    } else {
-      denom = exp_average_sq / bias_correction2;
+      group.max_exp_average_sqs.push_back(
+          buffer_at(max_exp_average_sq_buffers, i));
     }
+  }
 
-    const auto step_size =
-        options.learning_rate() / bias_correction1;
-
-    NoGradGuard guard;
-    p.addcdiv_(exp_average, denom.sqrt() + options.eps(), -step_size);
+  NoGradGuard guard;
+  for (auto& entry : groups) {
+    auto& group = entry.second;
+    torch::_fused_adam_(
+        group.params,
+        group.grads,
+        group.exp_averages,
+        group.exp_average_sqs,
+        group.max_exp_average_sqs,
+        entry.first,
+        options.learning_rate(),
+        options.beta1(),
+        options.beta2(),
+        options.eps(),
+        options.weight_decay(),
+        options.amsgrad());
   }
 }
 
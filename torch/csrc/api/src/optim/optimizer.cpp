@@ -153,6 +153,11 @@ const ska::flat_hash_map<std::string, std::unique_ptr<OptimizerParamState>>& Opt
   return state_;
 }
 
+bool has_fused_step_kernel(const Tensor& tensor) {
+  return tensor.layout() == kStrided &&
+      (tensor.device().is_cpu() || tensor.device().is_cuda());
+}
+
 Tensor& OptimizerBase::buffer_at(std::vector<Tensor>& buffers, size_t index) {
   if (buffers.size() <= index) {
     buffers.reserve(index);
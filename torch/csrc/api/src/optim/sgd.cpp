@@ -10,41 +10,64 @@
 #include <ATen/ATen.h>
 
 #include <functional>
+#include <vector>
 
 namespace torch {
 namespace optim {
 SGDOptions::SGDOptions(double learning_rate) : learning_rate_(learning_rate) {}
 
 void SGD::step() {
+  std::vector<Tensor> params;
+  std::vector<Tensor> grads;
+  std::vector<Tensor> momentum;
   for (size_t i = 0; i < parameters_.size(); ++i) {
     Tensor p = parameters_.at(i);
-
     if (!p.grad().defined()) {
       continue;
     }
-
-    auto update = p.grad();
-
-    if (options.weight_decay() > 0) {
+    if (!detail::has_fused_step_kernel(p) ||
+        !detail::has_fused_step_kernel(p.grad())) {
+      auto update = p.grad();
       NoGradGuard guard;
-      update += options.weight_decay() * p;
+      if (options.weight_decay() > 0) {
+        update = update + options.weight_decay() * p;
+      }
+      if (options.momentum() != 0) {
+        const auto dampening = iteration_ == 0 ? 1 : 1 - options.dampening();
+        auto& buffer = buffer_at(momentum_buffers, i);
+        buffer = (options.momentum() * buffer) + (dampening * update);
+        if (options.nesterov()) {
+          // See github.com/lisa-lab/pylearn2/pull/136#issuecomment-10381617
+          // for notes on this implementation of nesterov momentum.
+          update = update + options.momentum() * buffer;
+        } else {
+          update = buffer;
+        }
+      }
+      p.add_(-options.learning_rate() * update);
+      continue;
     }
-
+    params.push_back(p);
+    grads.push_back(p.grad());
     if (options.momentum() != 0) {
-      const auto dampening = iteration_ == 0 ? 1 : 1 - options.dampening();
-      auto& momentum = buffer_at(momentum_buffers, i);
-      momentum = (options.momentum() * momentum) + (dampening * update);
-      if (options.nesterov()) {
-        // See github.com/lisa-lab/pylearn2/pull/136#issuecomment-10381617
-        // for notes on this implementation of nesterov momentum.
-        update += options.momentum() * momentum;
-      } else {
-        update = momentum;
-      }
+      momentum.push_back(buffer_at(momentum_buffers, i));
     }
+  }
 
+  if (!params.empty()) {
+    // The momentum buffers start out as zeros, so not dampening the first
+    // update initializes them with the gradients.
+    const auto dampening = iteration_ == 0 ? 0 : options.dampening();
     NoGradGuard guard;
-    p.add_(-options.learning_rate() * update);
+    torch::_fused_sgd_(
+        params,
+        grads,
+        momentum,
+        options.learning_rate(),
+        options.momentum(),
+        dampening,
+        options.weight_decay(),
+        options.nesterov());
   }
   iteration_ += 1;
 }
@@ -3,6 +3,7 @@
 namespace torch { namespace autograd {
 
 bool AnomalyMode::_enabled = false;
+bool AnomalyMode::_lightweight = false;
 
 AnomalyMetadata::~AnomalyMetadata() = default;
 
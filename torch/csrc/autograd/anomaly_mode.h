@@ -8,12 +8,20 @@ struct TORCH_API AnomalyMode {
   static bool is_enabled() {
     return _enabled;
   }
-  static void set_enabled(bool enabled) {
+  // The lightweight mode only records an interned id of the stack of each
+  // Node, which is formatted when an anomaly is reported, and also reports
+  // infinite values.
+  static bool is_lightweight() {
+    return _lightweight;
+  }
+  static void set_enabled(bool enabled, bool lightweight = false) {
     _enabled = enabled;
+    _lightweight = enabled && lightweight;
   }
 
 private:
   static bool _enabled;
+  static bool _lightweight;
 };
 
 
@@ -0,0 +1,219 @@
+#include <torch/csrc/autograd/checkpoint.h>
+
+#include <torch/csrc/autograd/autograd.h>
+#include <torch/csrc/autograd/custom_function.h>
+#include <torch/csrc/autograd/engine.h>
+#include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/grad_mode.h>
+#include <torch/csrc/autograd/saved_variable.h>
+#include <torch/csrc/utils/memory.h>
+
+#include <ATen/CPUGenerator.h>
+#include <ATen/detail/CUDAHooksInterface.h>
+
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace torch { namespace autograd {
+
+namespace {
+
+// State of the default CPU generator and of the default CUDA generators of
+// some devices.
+struct RNGState {
+  // Captures the generators used by computations on `inputs`.
+  static RNGState capture(const variable_list& inputs) {
+    RNGState state;
+    auto* cpu_generator = at::detail::getDefaultCPUGenerator();
+    {
+      std::lock_guard<std::mutex> lock(cpu_generator->mutex_);
+      state.cpu_ = cpu_generator->clone();
+    }
+    for (const auto& input : inputs) {
+      if (!input.defined() || !input.is_cuda()) {
+        continue;
+      }
+      const auto index = input.device().index();
+      bool seen = false;
+      for (const auto& cuda_state : state.cuda_) {
+        seen = seen || cuda_state.first == index;
+      }
+      if (seen) {
+        continue;
+      }
+      auto* generator =
+          at::detail::getCUDAHooks().getDefaultCUDAGenerator(index);
+      std::lock_guard<std::mutex> lock(generator->mutex_);
+      state.cuda_.emplace_back(index, generator->clone());
+    }
+    return state;
+  }
+
+  void restore() const {
+    auto* cpu_generator = at::detail::getDefaultCPUGenerator();
+    {
+      std::lock_guard<std::mutex> lock(cpu_generator->mutex_);
+      cpu_generator->set_engine(cpu_->engine());
+      cpu_generator->set_next_float_normal_sample(
+          cpu_->next_float_normal_sample());
+      cpu_generator->set_next_double_normal_sample(
+          cpu_->next_double_normal_sample());
+    }
+    for (const auto& cuda_state : cuda_) {
+      auto* generator =
+          at::detail::getCUDAHooks().getDefaultCUDAGenerator(cuda_state.first);
+      std::lock_guard<std::mutex> lock(generator->mutex_);
+      at::detail::getCUDAHooks().setCUDAGeneratorState(
+          generator, *cuda_state.second);
+    }
+  }
+
+ private:
+  std::shared_ptr<at::CPUGenerator> cpu_;
+  std::vector<std::pair<c10::DeviceIndex, std::shared_ptr<at::Generator>>>
+      cuda_;
+};
+
+// Sets the generators to `state` and puts them back on destruction, like
+// torch.random.fork_rng.
+struct RNGStateGuard {
+  RNGStateGuard(const RNGState& state, const variable_list& inputs)
+      : prev_(RNGState::capture(inputs)) {
+    state.restore();
+  }
+
+  ~RNGStateGuard() {
+    prev_.restore();
+  }
+
+ private:
+  RNGState prev_;
+};
+
+// Stands in for the part of the graph that checkpoint() didn't record.
+struct CheckpointBackward : public Node {
+  CheckpointBackward(CheckpointFunction function, bool preserve_rng_state)
+      : function_(std::move(function)),
+        preserve_rng_state_(preserve_rng_state) {}
+
+  variable_list apply(variable_list&& grads) override;
+
+  std::string name() const override {
+    return "CheckpointBackward";
+  }
+
+  void release_variables() override {
+    inputs_.clear();
+    released_ = true;
+  }
+
+  void prefetch_saved_variables() override {
+    for (const auto& input : inputs_) {
+      input.prefetch();
+    }
+  }
+
+  CheckpointFunction function_;
+  std::vector<SavedVariable> inputs_;
+  bool released_ = false;
+  const bool preserve_rng_state_;
+  RNGState rng_state_;
+};
+
+variable_list CheckpointBackward::apply(variable_list&& grads) {
+  TORCH_CHECK(!released_, ERR_BACKWARD_TWICE);
+  TORCH_CHECK(
+      Engine::get_default_engine().is_checkpoint_valid(),
+      "checkpoint is not compatible with torch::autograd::grad(), ",
+      "please use torch::autograd::backward() instead");
+
+  // The rerun builds its own graph, rooted at detached copies of the inputs.
+  variable_list inputs;
+  inputs.reserve(inputs_.size());
+  for (const auto& saved : inputs_) {
+    auto input = saved.unpack();
+    if (input.defined()) {
+      const bool requires_grad = input.requires_grad();
+      input = input.detach();
+      input.requires_grad_(requires_grad);
+    }
+    inputs.push_back(std::move(input));
+  }
+
+  variable_list outputs;
+  {
+    std::unique_ptr<RNGStateGuard> rng_guard;
+    if (preserve_rng_state_) {
+      rng_guard = torch::make_unique<RNGStateGuard>(rng_state_, inputs);
+    }
+    AutoGradMode enable_grad(true);
+    outputs = function_(inputs);
+  }
+  TORCH_CHECK(
+      outputs.size() == grads.size(),
+      "checkpoint: the function returned ", outputs.size(),
+      " outputs when run again in backward, but ", grads.size(),
+      " in forward");
+
+  variable_list outputs_with_grad;
+  variable_list grad_outputs;
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    if (outputs[i].defined() && outputs[i].requires_grad() &&
+        grads[i].defined()) {
+      outputs_with_grad.push_back(outputs[i]);
+      grad_outputs.push_back(grads[i]);
+    }
+  }
+  if (!outputs_with_grad.empty()) {
+    backward(outputs_with_grad, grad_outputs);
+  }
+
+  variable_list grad_inputs;
+  grad_inputs.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    grad_inputs.push_back(input.defined() ? input.grad() : Variable());
+  }
+  return grad_inputs;
+}
+
+} // namespace
+
+variable_list checkpoint(
+    const CheckpointFunction& function,
+    const variable_list& inputs,
+    bool preserve_rng_state) {
+  if (!GradMode::is_enabled() || !any_variable_requires_grad(inputs)) {
+    return function(inputs);
+  }
+
+  std::shared_ptr<CheckpointBackward> node(
+      new CheckpointBackward(function, preserve_rng_state), deleteNode);
+  if (preserve_rng_state) {
+    node->rng_state_ = RNGState::capture(inputs);
+  }
+
+  variable_list outputs;
+  {
+    AutoGradMode no_grad(false);
+    outputs = function(inputs);
+  }
+
+  node->set_next_edges(collect_next_edges(inputs));
+  node->inputs_.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    node->inputs_.emplace_back(input, /*is_output=*/false);
+  }
+
+  std::unordered_set<at::TensorImpl*> non_differentiable;
+  for (const auto& output : outputs) {
+    if (output.defined() && !isFloatingType(output.scalar_type())) {
+      non_differentiable.insert(output.unsafeGetTensorImpl());
+    }
+  }
+  return _wrap_outputs(inputs, non_differentiable, {}, outputs, node);
+}
+
+}} // namespace torch::autograd
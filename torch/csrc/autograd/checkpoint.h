@@ -0,0 +1,31 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/variable.h>
+
+#include <functional>
+
+namespace torch { namespace autograd {
+
+using CheckpointFunction = std::function<variable_list(const variable_list&)>;
+
+/// Runs `function` on `inputs` without recording its interior in the
+/// autograd graph, and records a single `CheckpointBackward` node instead.
+/// Only `inputs` are saved. In backward, `function` is run again with grad
+/// mode enabled and its result is differentiated, trading compute for the
+/// memory its activations would have used.
+///
+/// With `preserve_rng_state`, the default CPU generator and the default CUDA
+/// generators of the devices of `inputs` are restored for the rerun, so
+/// random ops (e.g. dropout) produce the same values as in forward.
+///
+/// `function` must compute the same thing when called again: it should not
+/// depend on state that changes between forward and backward. Gradients of
+/// tensors it uses that are not in `inputs` (e.g. module parameters) are
+/// accumulated during the rerun, as with torch.utils.checkpoint.
+TORCH_API variable_list checkpoint(
+    const CheckpointFunction& function,
+    const variable_list& inputs,
+    bool preserve_rng_state = true);
+
+}} // namespace torch::autograd
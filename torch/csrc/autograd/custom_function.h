@@ -143,6 +143,7 @@ struct CppNode : public Node {
   std::vector<VariableInfo> output_info_;
 
   void release_variables() override;
+  void prefetch_saved_variables() override;
 
   void set_ctx_grad_fn(const std::shared_ptr<Node> &node);
   void save_variables_to_ctx();
@@ -295,6 +296,13 @@ void CppNode<T>::release_variables() {
   ctx_.has_freed_buffers_ = true;
 }
 
+template<class T>
+void CppNode<T>::prefetch_saved_variables() {
+  for (const auto& var : ctx_.saved_variables_) {
+    var.prefetch();
+  }
+}
+
 template<class T>
 void CppNode<T>::save_variables_to_ctx() {
   ctx_.save_variables();
@@ -1,9 +1,11 @@
 #include <torch/csrc/autograd/engine.h>
 
 #include <torch/csrc/autograd/function.h>
+#include <torch/csrc/autograd/functions/accumulate_grad.h>
 #include <torch/csrc/autograd/functions/basic_ops.h>
 #include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/autograd/anomaly_mode.h>
+#include <torch/csrc/autograd/saved_variable.h>
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/utils/memory.h>
 
@@ -17,9 +19,12 @@
 #include <c10/util/Optional.h>
 #include <c10/core/StreamGuard.h>
 
+#include <array>
 #include <atomic>
+#include <cmath>
 #include <condition_variable>
 #include <cstdint>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -52,6 +57,12 @@ static thread_local bool checkpoint_valid = true;
 // executed at the same time). Adding multiple threads per-device or removing
 // engine thread affinity to the device can break this invariant, and we depend
 // on it in a few places (e.g. AccumulateGrad function).
+//
+// The one exception is set_num_cpu_threads(), which lets several threads drain
+// the CPU ReadyQueue. Nodes of a single GraphTask still run at most once each,
+// but two concurrent backward calls may now enter the same Node at the same
+// time, so AccumulateGrad nodes are serialized with accumulate_grad_mutexes
+// (see evaluate_function).
 
 // Number of nested reentrant backwards calls currently on this thread
 static thread_local int current_depth = 0;
@@ -59,7 +70,9 @@ static thread_local int current_depth = 0;
 static thread_local int total_depth = 0;
 
 // Returns true when t2 should be (weakly) BEFORE t1 in the queue.
-// Shutdown tasks are first and then empty NodeTask are next.
+// Shutdown tasks are first and then empty NodeTask are next. Other tasks are
+// ordered by reentrant depth, then by Node::priority(), then by sequence
+// number.
 struct CompareNodeTaskTime {
   bool operator()(NodeTask const & t1, NodeTask const & t2) {
     if (t2.isShutdownTask_) {
@@ -69,6 +82,9 @@ struct CompareNodeTaskTime {
     } else if (!t2.fn_) {
       return true;
     } else if (t1.getReentrantDepth() == t2.getReentrantDepth()) {
+      if (t1.fn_->priority() != t2.fn_->priority()) {
+        return t1.fn_->priority() < t2.fn_->priority();
+      }
       return t1.fn_->sequence_nr() < t2.fn_->sequence_nr();
     } else {
       return t1.getReentrantDepth() < t2.getReentrantDepth();
@@ -90,6 +106,14 @@ struct ReadyQueue {
   void push(NodeTask item, bool incrementOutstandingTasks = true);
   void pushShutdownTask();
   NodeTask pop();
+  // Like pop(), but gives up and returns false once graph_task's future has
+  // been completed.
+  // Used by reentrant backward calls on CPU threads when several threads share
+  // the CPU queue, since the task that wakes the owner may be taken by
+  // another thread.
+  bool pop(NodeTask& task, const std::shared_ptr<GraphTask>& graph_task);
+  // Wakes every thread blocked in pop(task, graph_task)
+  void notifyWaiters();
   size_t size() const;
 };
 
@@ -206,8 +230,56 @@ auto ReadyQueue::pop() -> NodeTask {
   return task;
 }
 
+auto ReadyQueue::pop(
+    NodeTask& task,
+    const std::shared_ptr<GraphTask>& graph_task) -> bool {
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_empty_.wait(lock, [this, &graph_task]{
+    return !heap_.empty() || graph_task->future_result_->completed();
+  });
+  if (heap_.empty()) {
+    return false;
+  }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  task = std::move(const_cast<NodeTask&>(heap_.top())); heap_.pop();
+  return true;
+}
+
+auto ReadyQueue::notifyWaiters() -> void {
+  // Taking the mutex orders this with the predicate check in pop()
+  { std::lock_guard<std::mutex> lock(mutex_); }
+  not_empty_.notify_all();
+}
+
+// Number of threads draining the CPU ReadyQueue, read once when the engine
+// threads start. Can be set with PYTORCH_AUTOGRAD_CPU_THREADS.
+static int default_num_cpu_threads() {
+  const char* env = std::getenv("PYTORCH_AUTOGRAD_CPU_THREADS");
+  if (env) {
+    int num_threads = std::atoi(env);
+    if (num_threads > 0) {
+      return num_threads;
+    }
+  }
+  return 1;
+}
+
+// AccumulateGrad must never run concurrently for the same variable. Only
+// needed when there is more than one CPU thread; a small set of striped
+// mutexes keeps unrelated parameters from contending with each other.
+static constexpr size_t kNumAccumulateGradMutexes = 64;
+static std::array<std::recursive_mutex, kNumAccumulateGradMutexes>
+    accumulate_grad_mutexes;
+
+static std::recursive_mutex& accumulate_grad_mutex(Node* fn) {
+  return accumulate_grad_mutexes[
+      std::hash<Node*>()(fn) % kNumAccumulateGradMutexes];
+}
+
 // This limit is based on the default python recursion limit which is 1000
-Engine::Engine() : max_recursion_depth_(100) {}
+Engine::Engine()
+    : max_recursion_depth_(100),
+      num_cpu_threads_(default_num_cpu_threads()) {}
 
 // Send shutdown tasks to all ReadyQueues if no backward tasks are running
 // Even though readyQueue should be empty, shutdown tasks have the highest
@@ -219,8 +291,12 @@ Engine::~Engine() {
     noBackward =  noBackward && queue->heap_.empty();
   }
   if (noBackward) {
-    for (auto& queue : ready_queues_) {
-     queue->pushShutdownTask();
+    for (size_t i = 0; i < ready_queues_.size(); ++i) {
+      // one shutdown task per thread draining the queue
+      int num_threads = i == 0 ? num_cpu_threads_ : 1;
+      for (int j = 0; j < num_threads; ++j) {
+        ready_queues_[i]->pushShutdownTask();
+      }
     }
   }
   // Othewise threads are leaked
@@ -292,10 +368,23 @@ auto Engine::thread_main(
   TORCH_INTERNAL_ASSERT(reentrant_thread != (graph_task == nullptr));
 
   auto queue = ready_queues_[worker_device + 1];
+  // With several CPU threads, the dummy task sent to wake up the owner of
+  // graph_task can be picked up by a different thread, so the owner also
+  // stops waiting once the graph task is done.
+  const bool shared_queue = worker_device == -1 && num_cpu_threads_ > 1;
   // Why the test on graph_task->outstanding_tasks_?  See
   // Note [Reentrant backwards]
-  while (!reentrant_thread || graph_task->outstanding_tasks_ > 0) {
-    NodeTask task = queue->pop();
+  while (!reentrant_thread ||
+         (shared_queue ? !graph_task->future_result_->completed()
+                       : graph_task->outstanding_tasks_ > 0)) {
+    NodeTask task({}, nullptr, InputBuffer(0));
+    if (reentrant_thread && shared_queue) {
+      if (!queue->pop(task, graph_task)) {
+        break;
+      }
+    } else {
+      task = queue->pop();
+    }
     // This will only work if the worker is running a non backward task
     // TODO Needs to be fixed this to work in all cases
     if (task.isShutdownTask_) {
@@ -351,6 +440,12 @@ auto Engine::thread_main(
       ready_queue_by_index(base_owner)
           .push(NodeTask(local_graph_task, nullptr, InputBuffer(0)));
     }
+    if (base_owner == -1 && num_cpu_threads_ > 1 && gt_completed) {
+      // The owner is one of several CPU threads and may be blocked in
+      // ReadyQueue::pop(task, graph_task); the dummy task above (if any) can
+      // be taken by any of them.
+      ready_queue_by_index(-1).notifyWaiters();
+    }
   }
 }
 
@@ -389,7 +484,7 @@ void GraphTask::set_exception(
   std::lock_guard<std::mutex> lock(mutex_);
   if (!has_error_.load()) {
     if (AnomalyMode::is_enabled() && fn) {
-      fn->metadata()->print_stack();
+      fn->print_anomaly_stack();
     }
     has_error_ = true;
     if (!future_result_->completed()) {
@@ -400,6 +495,29 @@ void GraphTask::set_exception(
   }
 }
 
+// Throws if the i-th output of fn holds NaN values, or infinite values in
+// the lightweight anomaly mode. The common case costs a single reduction:
+// the sum of a dense floating point output, accumulated in double, is finite
+// unless the output holds a NaN or an infinity (or its values are huge, in
+// which case the exact checks below find nothing).
+static void validate_anomaly_output(Node& fn, const Variable& output, int i) {
+  if (output.layout() == at::kStrided && at::isFloatingType(output.scalar_type()) &&
+      std::isfinite(output.sum(at::kDouble).item<double>())) {
+    return;
+  }
+  if (isnan(output).any().item<uint8_t>()) {
+    std::stringstream ss;
+    ss << "Function '" << fn.name() << "' returned nan values in its " << i << "th output.";
+    throw std::runtime_error(ss.str());
+  }
+  if (AnomalyMode::is_lightweight() && at::isFloatingType(output.scalar_type()) &&
+      isinf(output).any().item<uint8_t>()) {
+    std::stringstream ss;
+    ss << "Function '" << fn.name() << "' returned inf values in its " << i << "th output.";
+    throw std::runtime_error(ss.str());
+  }
+}
+
 static variable_list call_pre_hooks(Node& fn, variable_list inputs) {
   for (const auto& hook : fn.pre_hooks()) {
     inputs = (*hook)(inputs);
@@ -556,7 +674,23 @@ void Engine::evaluate_function(
   const auto opt_parent_stream = (*func).stream(c10::DeviceType::CUDA);
   c10::OptionalStreamGuard parent_stream_guard{opt_parent_stream};
 
-  auto outputs = call_function(graph_task, func, inputs);
+  // Lets packed saved variables of the functions that are likely to run next
+  // come back while this one runs. See SavedTensorHooks.
+  if (saved_tensor_hooks_used()) {
+    for (const auto& next : func->next_edges()) {
+      if (next.is_valid()) {
+        next.function->prefetch_saved_variables();
+      }
+    }
+  }
+
+  variable_list outputs;
+  if (num_cpu_threads_ > 1 && dynamic_cast<AccumulateGrad*>(func)) {
+    std::lock_guard<std::recursive_mutex> lock(accumulate_grad_mutex(func));
+    outputs = call_function(graph_task, func, inputs);
+  } else {
+    outputs = call_function(graph_task, func, inputs);
+  }
 
   auto& fn = *func;
   if (!graph_task->keep_graph_) {
@@ -579,10 +713,8 @@ void Engine::evaluate_function(
     for (int i = 0; i < num_outputs; ++i) {
       auto& output = outputs[i];
       at::OptionalDeviceGuard guard(device_of(output));
-      if (output.defined() && isnan(output).any().item<uint8_t>()) {
-        std::stringstream ss;
-        ss << "Function '" << fn.name() << "' returned nan values in its " << i << "th output.";
-        throw std::runtime_error(ss.str());
+      if (output.defined()) {
+        validate_anomaly_output(fn, output, i);
       }
     }
   }
@@ -854,6 +986,24 @@ void Engine::queue_callback(std::function<void()> callback) {
   final_callbacks_.emplace_back(std::move(callback));
 }
 
+void Engine::set_num_cpu_threads(int num_threads) {
+  TORCH_CHECK(num_threads > 0, "Expected a positive number of CPU threads");
+  bool started = true;
+  std::call_once(start_threads_flag_, [&]() {
+    started = false;
+    num_cpu_threads_ = num_threads;
+    start_threads();
+  });
+  TORCH_CHECK(
+      !started || num_threads == num_cpu_threads_,
+      "Cannot change the number of autograd CPU threads after backward ",
+      "has run; the engine is already using ", num_cpu_threads_, " thread(s)");
+}
+
+int Engine::get_num_cpu_threads() const {
+  return num_cpu_threads_;
+}
+
 bool Engine::is_checkpoint_valid() {
   return checkpoint_valid;
 }
@@ -904,8 +1054,13 @@ auto Engine::start_threads() -> void {
   thread_pool_shared_ = std::make_shared<ThreadPoolShared>();
 
   for (int i = 0; i < num_threads; ++i) {
-    std::thread t(&Engine::thread_init, this, i - 1);
-    t.detach();
+    // the CPU queue may be drained by several threads,
+    // see Engine::set_num_cpu_threads
+    int queue_threads = i == 0 ? num_cpu_threads_ : 1;
+    for (int j = 0; j < queue_threads; ++j) {
+      std::thread t(&Engine::thread_init, this, i - 1);
+      t.detach();
+    }
   }
 }
 
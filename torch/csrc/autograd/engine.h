@@ -191,10 +191,28 @@ struct TORCH_API Engine {
     return nullptr;
   }
 
+  // Interns the current stack for the lightweight anomaly mode and returns
+  // its id, or 0 if there is no stack to record.
+  virtual uint32_t intern_anomaly_stack() {
+    return 0;
+  }
+
+  // Formats a stack interned by intern_anomaly_stack().
+  virtual std::string format_anomaly_stack(uint32_t stack_id) {
+    return std::string();
+  }
+
   void queue_callback(std::function<void()> callback);
 
   bool is_checkpoint_valid();
 
+  // Sets how many threads run CPU NodeTasks. With more than one, independent
+  // branches of a graph (e.g. separate towers or embedding tables) are
+  // evaluated concurrently on CPU. Must be called before the first backward
+  // call; defaults to PYTORCH_AUTOGRAD_CPU_THREADS if set, else 1.
+  void set_num_cpu_threads(int num_threads);
+  int get_num_cpu_threads() const;
+
   size_t ready_queue_size(at::Device device);
 
  protected:
@@ -227,6 +245,8 @@ struct TORCH_API Engine {
   std::mutex post_callbacks_lock_;
   // How many nested reentrant calls are allowed until a new thread is used
   int max_recursion_depth_;
+  // Number of threads draining the CPU ReadyQueue; fixed once threads start
+  int num_cpu_threads_;
 
   struct ThreadPoolShared {
     // Data structures used by the threads for executing reentrant backwards
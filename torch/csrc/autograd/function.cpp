@@ -38,6 +38,23 @@ AnomalyMetadata* Node::metadata() noexcept {
   return anomaly_metadata_.get();
 }
 
+void Node::store_anomaly_stack() {
+  if (AnomalyMode::is_lightweight()) {
+    anomaly_stack_id_ = Engine::get_default_engine().intern_anomaly_stack();
+  } else {
+    metadata()->store_stack();
+  }
+}
+
+void Node::print_anomaly_stack() {
+  if (anomaly_stack_id_ == 0) {
+    metadata()->print_stack();
+    return;
+  }
+  AT_WARN("Traceback of forward call that caused the error:\n",
+          Engine::get_default_engine().format_anomaly_stack(anomaly_stack_id_));
+}
+
 static void gatherFunctions(
     Node* func,
     std::vector<std::shared_ptr<Node>>& stack) {
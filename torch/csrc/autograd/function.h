@@ -95,7 +95,7 @@ struct TORCH_API Node : std::enable_shared_from_this<Node> {
       : sequence_nr_(sequence_nr),
       next_edges_(std::move(next_edges)) {
     if (AnomalyMode::is_enabled()) {
-      metadata()->store_stack();
+      store_anomaly_stack();
     }
   }
 
@@ -222,6 +222,18 @@ struct TORCH_API Node : std::enable_shared_from_this<Node> {
     return sequence_nr_;
   }
 
+  /// The scheduling priority of this `Node`. Among the ready nodes of
+  /// the same (reentrant) graph task depth, the engine runs the ones with the
+  /// highest priority first, and breaks ties by sequence number. Defaults to 0.
+  /// Should not be changed while a backward pass that uses this node runs.
+  int64_t priority() const noexcept {
+    return priority_;
+  }
+
+  void set_priority(int64_t priority) noexcept {
+    priority_ = priority;
+  }
+
   /// Returns the name of the dynamic type of the function, for debugging.
   virtual std::string name() const;
 
@@ -258,6 +270,13 @@ struct TORCH_API Node : std::enable_shared_from_this<Node> {
   /// If none exist, creates a new empty one.
   AnomalyMetadata* metadata() noexcept;
 
+  /// Records the stack of the forward call creating this `Node`, in the
+  /// anomaly metadata or as an interned id in the lightweight anomaly mode.
+  void store_anomaly_stack();
+
+  /// Warns with the stack recorded by `store_anomaly_stack()`.
+  void print_anomaly_stack();
+
   // Hook API
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
@@ -307,6 +326,11 @@ struct TORCH_API Node : std::enable_shared_from_this<Node> {
   /// Releases saved variables if the operation won't be reused.
   virtual void release_variables() {}
 
+  /// Starts unpacking saved variables that were packed by `SavedTensorHooks`.
+  /// The engine calls this on the next functions of a node while that node
+  /// runs.
+  virtual void prefetch_saved_variables() {}
+
   /// Called before an apply if `release_variables()` is going to be called.
   /// Allows larger ops like `InterpreterAutogradFunction` to incrementally
   /// release variables as they run.
@@ -347,9 +371,14 @@ struct TORCH_API Node : std::enable_shared_from_this<Node> {
   // fields.
   const uint64_t sequence_nr_;
 
+  // See priority()
+  int64_t priority_ = 0;
+
   edge_list next_edges_;
   PyObject* pyobj_ = nullptr; // weak reference
   std::unique_ptr<AnomalyMetadata> anomaly_metadata_ = nullptr;
+  // Interned stack of the lightweight anomaly mode, 0 if none
+  uint32_t anomaly_stack_id_ = 0;
   std::vector<std::unique_ptr<FunctionPreHook>> pre_hooks_;
   std::vector<std::unique_ptr<FunctionPostHook>> post_hooks_;
   at::SmallVector<InputMetadata, 2> input_metadata_;
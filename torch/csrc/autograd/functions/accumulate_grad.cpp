@@ -70,7 +70,13 @@ auto AccumulateGrad::apply(variable_list&& grads) -> variable_list {
       // store the result. However, changing the TensorImpl type of a tensor requires
       // changing the tensor itself, and thus in this case we have to change the grad
       // tensor.
-      grad_variable = new_grad + grad_variable;
+      if (can_accumulate_inplace(new_grad, grad_variable, 1 + !post_hooks().empty())) {
+        // new_grad is not referenced anywhere else, so it can hold the sum
+        new_grad.add_(grad_variable);
+        grad_variable = new_grad.detach();
+      } else {
+        grad_variable = new_grad + grad_variable;
+      }
     } else {
       // In this case we can avoid changing the grad tensor. There are three scenarios
       // when we'll hit this case:
@@ -26,6 +26,27 @@ TORCH_API variable_list wrap_outputs(const variable_list& inputs, tensor_list&&
 /// items are not nullptr. If not specified, `required_args` defaults to `args`.
 TORCH_API void check_input_variables(const char* name, const variable_list& inputs, int args, int required_args=-1);
 
+/// Checks whether the gradient `grad` can be overwritten with its sum with
+/// `other`, so that gradients are accumulated without a new buffer for each
+/// sum: no graph of the backward pass is being built, `grad` is dense, the sum
+/// has the dtype, sizes and device of `grad`, and no tensor other than the
+/// `expected_uses` references of the caller shares its storage.
+inline bool can_accumulate_inplace(
+    const Variable& grad,
+    const Variable& other,
+    size_t expected_uses = 1) {
+  // the storage use count also rules out views of `grad`
+  return !GradMode::is_enabled()
+      && !grad.requires_grad()
+      && grad.layout() == at::kStrided
+      && grad.is_non_overlapping_and_dense()
+      && grad.scalar_type() == other.scalar_type()
+      && grad.device() == other.device()
+      && grad.sizes() == other.sizes()
+      && grad.use_count() <= expected_uses
+      && grad.storage().use_count() == 1;
+}
+
 struct ComputeRequiresGrad : IterArgs<ComputeRequiresGrad> {
   bool out = false;
   using IterArgs<ComputeRequiresGrad>::operator();
@@ -1,7 +1,11 @@
 #include <torch/csrc/python_headers.h>
 
+#include <ATen/autocast_mode.h>
+#include <torch/csrc/Dtype.h>
+#include <torch/csrc/DynamicTypes.h>
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/utils/pybind.h>
+#include <torch/csrc/utils/python_numbers.h>
 #include <torch/csrc/autograd/grad_mode.h>
 #include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/autograd/python_function.h>
@@ -36,7 +40,9 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       .value("NVTX", ProfilerState::NVTX);
 
   py::class_<ProfilerConfig>(m, "ProfilerConfig")
-      .def(py::init<ProfilerState, bool>());
+      .def(py::init<ProfilerState, bool>())
+      .def(py::init<ProfilerState, bool, bool>())
+      .def(py::init<ProfilerState, bool, bool, bool, bool>());
 
   py::class_<Event>(m, "ProfilerEvent")
       .def("kind", &Event::kind)
@@ -46,11 +52,19 @@ PyObject* THPAutograd_initExtension(PyObject* _unused, PyObject *unused) {
       .def("cpu_elapsed_us", &Event::cpu_elapsed_us)
       .def("cuda_elapsed_us", &Event::cuda_elapsed_us)
       .def("has_cuda", &Event::has_cuda)
-      .def("shapes", &Event::shapes);
+      .def("shapes", &Event::shapes)
+      .def("cpu_memory_usage", &Event::cpu_memory_usage)
+      .def("cuda_memory_usage", &Event::cuda_memory_usage)
+      .def("flops", &Event::flops)
+      .def("bytes", &Event::bytes)
+      .def("hw_counters", &Event::hw_counters);
 
   m.def("_enable_profiler", enableProfiler);
   m.def("_disable_profiler", disableProfiler);
   m.def("_profiler_enabled", profilerEnabled);
+  m.def("_enable_nvtx_ranges", enableNvtxRanges);
+  m.def("_disable_nvtx_ranges", disableNvtxRanges);
+  m.def("_has_record_function_callbacks", []() { return hasCallbacks(); });
 
   m.def("_push_range", [](std::string name) { pushRange(std::move(name)); });
   m.def("_pop_range", []() { popRange(); });
@@ -84,12 +98,22 @@ static PyObject * is_grad_enabled(PyObject* _unused, PyObject *arg) {
   END_HANDLE_TH_ERRORS
 }
 
-static PyObject * set_anomaly_mode_enabled(PyObject* _unused, PyObject *arg) {
+static PyObject * set_anomaly_mode_enabled(PyObject* _unused, PyObject *args, PyObject *kwargs) {
   HANDLE_TH_ERRORS
-  if (!PyBool_Check(arg)) {
-    throw TypeError("enabled must be a bool (got %s)", Py_TYPE(arg)->tp_name);
+  const char* kwlist[] = {"enabled", "lightweight", nullptr};
+  PyObject* enabled = nullptr;
+  PyObject* lightweight = Py_False;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|O", const_cast<char**>(kwlist),
+                                   &enabled, &lightweight)) {
+    return nullptr;
+  }
+  if (!PyBool_Check(enabled)) {
+    throw TypeError("enabled must be a bool (got %s)", Py_TYPE(enabled)->tp_name);
+  }
+  if (!PyBool_Check(lightweight)) {
+    throw TypeError("lightweight must be a bool (got %s)", Py_TYPE(lightweight)->tp_name);
   }
-  AnomalyMode::set_enabled(arg == Py_True);
+  AnomalyMode::set_enabled(enabled == Py_True, lightweight == Py_True);
   Py_RETURN_NONE;
   END_HANDLE_TH_ERRORS
 }
@@ -104,12 +128,87 @@ static PyObject * is_anomaly_mode_enabled(PyObject* _unused, PyObject *arg) {
   END_HANDLE_TH_ERRORS
 }
 
+static PyObject * is_anomaly_mode_lightweight(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (AnomalyMode::is_lightweight()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * set_autocast_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!PyBool_Check(arg)) {
+    throw TypeError("enabled must be a bool (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  at::autocast::set_enabled(arg == Py_True);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * is_autocast_enabled(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (at::autocast::is_enabled()) {
+    Py_RETURN_TRUE;
+  } else {
+    Py_RETURN_FALSE;
+  }
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * set_autocast_dtype(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  if (!THPDtype_Check(arg)) {
+    throw TypeError("dtype must be a torch.dtype (got %s)", Py_TYPE(arg)->tp_name);
+  }
+  at::autocast::set_autocast_dtype(reinterpret_cast<THPDtype*>(arg)->scalar_type);
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * get_autocast_dtype(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  auto dtype = (PyObject*)torch::getDtype(at::autocast::get_autocast_dtype());
+  Py_INCREF(dtype);
+  return dtype;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * clear_autocast_cache(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  at::autocast::clear_cache();
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * autocast_increment_nesting(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  return THPUtils_packInt64(at::autocast::increment_nesting());
+  END_HANDLE_TH_ERRORS
+}
+
+static PyObject * autocast_decrement_nesting(PyObject* _unused, PyObject *arg) {
+  HANDLE_TH_ERRORS
+  return THPUtils_packInt64(at::autocast::decrement_nesting());
+  END_HANDLE_TH_ERRORS
+}
+
 // autograd methods on torch._C
 static PyMethodDef methods[] = {
   {"set_grad_enabled", (PyCFunction)set_grad_enabled, METH_O, nullptr},
   {"is_grad_enabled", (PyCFunction)is_grad_enabled, METH_NOARGS, nullptr},
-  {"set_anomaly_enabled", (PyCFunction)set_anomaly_mode_enabled, METH_O, nullptr},
+  {"set_anomaly_enabled", (PyCFunction)(void(*)())set_anomaly_mode_enabled, METH_VARARGS | METH_KEYWORDS, nullptr},
   {"is_anomaly_enabled", (PyCFunction)is_anomaly_mode_enabled, METH_NOARGS, nullptr},
+  {"_is_anomaly_lightweight", (PyCFunction)is_anomaly_mode_lightweight, METH_NOARGS, nullptr},
+  {"set_autocast_enabled", (PyCFunction)set_autocast_enabled, METH_O, nullptr},
+  {"is_autocast_enabled", (PyCFunction)is_autocast_enabled, METH_NOARGS, nullptr},
+  {"set_autocast_dtype", (PyCFunction)set_autocast_dtype, METH_O, nullptr},
+  {"get_autocast_dtype", (PyCFunction)get_autocast_dtype, METH_NOARGS, nullptr},
+  {"clear_autocast_cache", (PyCFunction)clear_autocast_cache, METH_NOARGS, nullptr},
+  {"autocast_increment_nesting", (PyCFunction)autocast_increment_nesting, METH_NOARGS, nullptr},
+  {"autocast_decrement_nesting", (PyCFunction)autocast_decrement_nesting, METH_NOARGS, nullptr},
   {nullptr, nullptr, 0, nullptr}
 };
 
@@ -1,5 +1,7 @@
 #include <torch/csrc/autograd/input_buffer.h>
 
+#include <torch/csrc/autograd/functions/utils.h>
+
 #include <c10/core/DeviceGuard.h>
 #include <c10/core/StreamGuard.h>
 #include <c10/core/Event.h>
@@ -28,6 +30,12 @@ namespace torch { namespace autograd {
     } else {
       if (var.is_sparse() && !old_var.is_sparse() && old_var.is_contiguous() && old_var.storage().use_count() == 1) {
           buffer[pos] = old_var.add_(var);
+      } else if (can_accumulate_inplace(old_var, var)) {
+          // the buffer is the only owner of old_var, so reuse it for the sum
+          // instead of allocating one for each incoming gradient
+          old_var.add_(var);
+      } else if (can_accumulate_inplace(var, old_var)) {
+          buffer[pos] = var.add_(old_var);
       } else {
           buffer[pos] = old_var + var;
       }
@@ -1,13 +1,32 @@
 #include <torch/csrc/autograd/profiler.h>
 #include <torch/csrc/jit/code_template.h>
 
+#include <ATen/ExpandUtils.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
+#include <iomanip>
 #include <list>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace torch { namespace autograd { namespace profiler {
 
 CUDAStubs default_stubs;
@@ -21,6 +40,7 @@ void registerCUDAMethods(CUDAStubs* stubs) {
 }
 
 ProfilerState state = ProfilerState::Disabled;
+bool record_hw_counters = false;
 uint16_t next_thread_id = 0;
 // Protects access to next_thread_id and all_event_lists_map.
 std::mutex all_event_lists_map_mutex;
@@ -64,13 +84,14 @@ bool profilerEnabled() {
   return state != ProfilerState::Disabled;
 }
 
-void pushRangeImpl(
+// Returns the PushRange event, or nullptr if none was recorded.
+Event* pushRangeImpl(
     const StringView& name,
     const char* msg = "",
     int64_t sequence_nr = -1,
     std::vector<std::vector<int64_t>>&& shapes = {}) {
   if (state == ProfilerState::Disabled) {
-    return;
+    return nullptr;
   }
   if (state == ProfilerState::NVTX) {
     if(sequence_nr >= 0 || shapes.size() > 0) {
@@ -100,16 +121,241 @@ void pushRangeImpl(
     } else {
       cuda_stubs->nvtxRangePushA(name.str());
     }
+    return nullptr;
+  }
+  return &getEventList().record(
+      EventKind::PushRange,
+      name,
+      thread_id,
+      state == ProfilerState::CUDA,
+      std::move(shapes));
+}
+
+namespace {
+
+// FLOP and byte estimates
+//
+// The inputs are the ones given to RECORD_FUNCTION: the tensors and scalars
+// of the op, plus the int arguments of convolutions (see
+// gen_variable_type.py). Matrix multiplies and convolutions count a multiply
+// and an add per MAC, pointwise ops one operation per output element. The
+// bytes are those of the inputs and outputs, as if each was accessed once.
+
+const at::Tensor* tensorInput(const std::vector<c10::IValue>& inputs, size_t i) {
+  if (i >= inputs.size() || !inputs[i].isTensor()) {
+    return nullptr;
+  }
+  const at::Tensor& t = inputs[i].toTensor();
+  return t.defined() ? &t : nullptr;
+}
+
+int64_t tensorBytes(const at::Tensor* t) {
+  return t ? t->numel() * static_cast<int64_t>(t->element_size()) : 0;
+}
+
+bool matmulFlops(
+    const at::Tensor& a,
+    const at::Tensor& b,
+    int64_t& flops,
+    int64_t& output_numel) {
+  const int64_t da = a.dim();
+  const int64_t db = b.dim();
+  if (da == 0 || db == 0) {
+    return false;
+  }
+  const int64_t m = da >= 2 ? a.size(-2) : 1;
+  const int64_t k = a.size(-1);
+  const int64_t n = db >= 2 ? b.size(-1) : 1;
+  if ((db >= 2 ? b.size(-2) : b.size(0)) != k) {
+    return false;
+  }
+  const auto a_batch = da > 2 ? a.sizes().slice(0, da - 2) : at::IntArrayRef();
+  const auto b_batch = db > 2 ? b.sizes().slice(0, db - 2) : at::IntArrayRef();
+  int64_t batch = 1;
+  for (int64_t size : at::infer_size(a_batch, b_batch)) {
+    batch *= size;
+  }
+  flops = 2 * batch * m * k * n;
+  output_numel = batch * m * n;
+  return true;
+}
+
+int64_t intListAt(const c10::List<int64_t>& list, size_t i) {
+  return list.size() == 1 ? list.get(0) : list.get(i);
+}
+
+// Forward convolutions, with inputs (input, weight, bias, stride, padding,
+// dilation, ...). transposed_index is the index of the transposed flag, -1 if
+// the op has none.
+bool convolutionFlops(
+    const std::vector<c10::IValue>& inputs,
+    int transposed_index,
+    int64_t& flops,
+    int64_t& bytes) {
+  const at::Tensor* input = tensorInput(inputs, 0);
+  const at::Tensor* weight = tensorInput(inputs, 1);
+  if (!input || !weight || inputs.size() < 6 || input->dim() < 3 ||
+      input->dim() != weight->dim()) {
+    return false;
+  }
+  for (size_t i = 3; i < 6; i++) {
+    if (!inputs[i].isIntList()) {
+      return false;
+    }
+  }
+  const auto stride = inputs[3].toIntList();
+  const auto padding = inputs[4].toIntList();
+  const auto dilation = inputs[5].toIntList();
+  bool transposed = false;
+  c10::List<int64_t> output_padding;
+  if (transposed_index >= 0) {
+    if (inputs.size() <= transposed_index + 1 ||
+        !inputs[transposed_index].isBool() ||
+        !inputs[transposed_index + 1].isIntList()) {
+      return false;
+    }
+    transposed = inputs[transposed_index].toBool();
+    output_padding = inputs[transposed_index + 1].toIntList();
+  }
+  const int64_t spatial = input->dim() - 2;
+  for (const auto* list : {&stride, &padding, &dilation}) {
+    if (list->size() != 1 && list->size() != spatial) {
+      return false;
+    }
+  }
+  if (transposed && output_padding.size() != 1 && output_padding.size() != spatial) {
+    return false;
+  }
+
+  int64_t kernel_numel = 1;
+  int64_t output_numel = input->size(0) * (transposed ? weight->size(1) : weight->size(0));
+  int64_t input_pixels = 1;
+  for (int64_t d = 0; d < spatial; d++) {
+    const int64_t k = weight->size(d + 2);
+    const int64_t extent = intListAt(dilation, d) * (k - 1) + 1;
+    const int64_t in = input->size(d + 2);
+    const int64_t out = transposed
+        ? (in - 1) * intListAt(stride, d) - 2 * intListAt(padding, d) + extent +
+            intListAt(output_padding, d)
+        : (in + 2 * intListAt(padding, d) - extent) / intListAt(stride, d) + 1;
+    if (out <= 0) {
+      return false;
+    }
+    kernel_numel *= k;
+    input_pixels *= in;
+    output_numel *= out;
+  }
+  if (transposed) {
+    // Every input pixel is scattered to weight.size(1) * kernel_numel outputs
+    // of its group.
+    flops = 2 * input->size(0) * input->size(1) * input_pixels *
+        weight->size(1) * kernel_numel;
   } else {
-    getEventList().record(
-        EventKind::PushRange,
-        name,
-        thread_id,
-        state == ProfilerState::CUDA,
-        std::move(shapes));
+    // Every output is reduced over weight.size(1) * kernel_numel inputs.
+    flops = 2 * output_numel * weight->size(1) * kernel_numel;
+  }
+  bytes = tensorBytes(input) + tensorBytes(weight) +
+      tensorBytes(tensorInput(inputs, 2)) +
+      output_numel * static_cast<int64_t>(input->element_size());
+  return true;
+}
+
+bool isPointwise(const std::string& name) {
+  static const std::unordered_set<std::string> pointwise_ops = {
+      "add", "sub", "mul", "div", "neg", "abs", "relu", "sigmoid", "tanh",
+      "threshold", "clamp", "exp", "log", "sqrt", "rsqrt", "pow", "reciprocal",
+      "addcmul", "addcdiv", "lerp", "gelu", "hardtanh", "leaky_relu", "elu",
+      "softplus", "sin", "cos", "erf", "floor", "ceil", "round", "sign"};
+  // In-place variants have the same cost.
+  if (!name.empty() && name.back() == '_') {
+    return pointwise_ops.count(name.substr(0, name.size() - 1)) > 0;
+  }
+  return pointwise_ops.count(name) > 0;
+}
+
+bool estimateFlops(
+    const RecordFunction& fn,
+    int64_t& flops,
+    int64_t& bytes) {
+  const std::string name = fn.name().str();
+  const auto& inputs = fn.inputs();
+  if (name == "mm" || name == "bmm" || name == "matmul" || name == "mv" ||
+      name == "dot" || name == "addmm" || name == "baddbmm" ||
+      name == "addbmm" || name == "addmv" || name == "addmm_" ||
+      name == "baddbmm_" || name == "addbmm_" || name == "addmv_") {
+    // The add* ops take the tensor to accumulate into first.
+    const size_t mat = name.compare(0, 3, "add") == 0 ||
+        name.compare(0, 4, "badd") == 0 ? 1 : 0;
+    const at::Tensor* a = tensorInput(inputs, mat);
+    const at::Tensor* b = tensorInput(inputs, mat + 1);
+    int64_t output_numel = 0;
+    if (!a || !b || !matmulFlops(*a, *b, flops, output_numel)) {
+      return false;
+    }
+    if (name == "addbmm" || name == "addbmm_") {
+      // The batches are summed into a single matrix.
+      output_numel /= a->size(0);
+    }
+    bytes = tensorBytes(a) + tensorBytes(b) +
+        (mat ? tensorBytes(tensorInput(inputs, 0)) : 0) +
+        output_numel * static_cast<int64_t>(a->element_size());
+    return true;
+  }
+  if (name == "conv1d" || name == "conv2d" || name == "conv3d") {
+    return convolutionFlops(inputs, -1, flops, bytes);
+  }
+  if (name == "convolution" || name == "_convolution") {
+    return convolutionFlops(inputs, 6, flops, bytes);
   }
+  if (isPointwise(name)) {
+    std::vector<int64_t> output_size;
+    int64_t input_bytes = 0;
+    const at::Tensor* first = nullptr;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      const at::Tensor* t = tensorInput(inputs, i);
+      if (!t) {
+        continue;
+      }
+      output_size = first ? at::infer_size(output_size, t->sizes()) : t->sizes().vec();
+      first = first ? first : t;
+      input_bytes += tensorBytes(t);
+    }
+    if (!first) {
+      return false;
+    }
+    int64_t output_numel = 1;
+    for (int64_t size : output_size) {
+      output_numel *= size;
+    }
+    flops = output_numel;
+    bytes = input_bytes + output_numel * static_cast<int64_t>(first->element_size());
+    return true;
+  }
+  return false;
 }
 
+} // namespace
+
+namespace {
+
+// Records the allocations reported by c10 as MemoryAlloc events, in the event
+// list of the thread doing them, between the ranges that enclose them.
+struct ProfilerMemoryReporter final : public c10::MemoryReporter {
+  void reportMemoryUsage(void* ptr, int64_t alloc_size, c10::Device device)
+      override {
+    if (state == ProfilerState::Disabled || state == ProfilerState::NVTX) {
+      return;
+    }
+    auto& list = getEventList();
+    list.record(EventKind::MemoryAlloc, StringView(""), thread_id, false)
+        .updateMemoryStats(alloc_size, device);
+  }
+};
+
+ProfilerMemoryReporter memory_reporter;
+
+} // namespace
+
 void pushRange(std::string name) {
   pushRangeImpl(StringView(std::move(name)));
 }
@@ -141,6 +387,7 @@ void enableProfiler(ProfilerConfig config) {
   pushCallback(
       [config](const RecordFunction& fn) {
         auto* msg = (fn.seqNr() >= 0) ? ", seq = " : "";
+        Event* event = nullptr;
         if (config.report_input_shapes) {
           std::vector<std::vector<int64_t>> inputSizes;
           inputSizes.reserve(fn.inputs().size());
@@ -156,9 +403,14 @@ void enableProfiler(ProfilerConfig config) {
               inputSizes.emplace_back();
             }
           }
-          pushRangeImpl(fn.name(), msg, fn.seqNr(), std::move(inputSizes));
+          event = pushRangeImpl(fn.name(), msg, fn.seqNr(), std::move(inputSizes));
         } else {
-          pushRangeImpl(fn.name(), msg, fn.seqNr(), {});
+          event = pushRangeImpl(fn.name(), msg, fn.seqNr(), {});
+        }
+        int64_t flops = 0;
+        int64_t bytes = 0;
+        if (event && config.with_flops && estimateFlops(fn, flops, bytes)) {
+          event->setFlops(flops, bytes);
         }
       },
       [](const RecordFunction& fn) {
@@ -180,18 +432,29 @@ void enableProfiler(ProfilerConfig config) {
                 fn.getThreadId());
 
             auto& eventList = eventListIter->second;
+            // The counters sampled here are the ones of another thread.
             eventList->record(
                       EventKind::PopRange,
                       StringView(""),
                       fn.getThreadId(),
-                      state == ProfilerState::CUDA);
+                      state == ProfilerState::CUDA)
+                .clearHwCounters();
           }
         } else {
           popRange();
         }
       },
-      config.report_input_shapes);
+      config.report_input_shapes || config.with_flops);
   state = new_state;
+  if (config.profile_memory && state != ProfilerState::NVTX) {
+    c10::SetMemoryReporter(&memory_reporter);
+  }
+#ifndef __linux__
+  if (config.record_hw_counters) {
+    TORCH_WARN("Hardware counters are only supported by the profiler on Linux");
+  }
+#endif
+  record_hw_counters = config.record_hw_counters && state != ProfilerState::NVTX;
 
   if(state == ProfilerState::CUDA) {
     // event recording appears to have some startup overhead, so we need to
@@ -221,7 +484,9 @@ thread_event_lists disableProfiler() {
   mark("__stop_profile");
 
   popCallback();
+  c10::SetMemoryReporter(nullptr);
   state = ProfilerState::Disabled;
+  record_hw_counters = false;
 
   if (old_state == ProfilerState::NVTX) {
     return thread_event_lists();
@@ -244,12 +509,136 @@ thread_event_lists disableProfiler() {
   }
 }
 
+namespace {
+bool nvtx_ranges_enabled = false;
+} // namespace
+
+void enableNvtxRanges() {
+  TORCH_CHECK(
+      cuda_stubs->enabled(),
+      "Can't emit NVTX ranges - PyTorch was compiled without CUDA");
+  TORCH_CHECK(!nvtx_ranges_enabled, "NVTX ranges are already enabled");
+  pushCallback(
+      [](const RecordFunction& fn) {
+        cuda_stubs->nvtxRangePushA(fn.name().str());
+      },
+      [](const RecordFunction&) { cuda_stubs->nvtxRangePop(); });
+  nvtx_ranges_enabled = true;
+}
+
+void disableNvtxRanges() {
+  TORCH_CHECK(nvtx_ranges_enabled, "NVTX ranges are not enabled");
+  popCallback();
+  nvtx_ranges_enabled = false;
+}
+
+namespace {
+
+// The hardware counters of the calling thread, as one perf_event group so
+// they are scheduled together and read in a single syscall. Opened by the
+// first range the thread records with record_hw_counters on, then kept for
+// the life of the thread.
+struct HwCounterGroup {
+  HwCounterGroup() {
+    fds_.fill(-1);
+  }
+  ~HwCounterGroup() {
+#ifdef __linux__
+    for (int fd : fds_) {
+      if (fd >= 0) {
+        close(fd);
+      }
+    }
+#endif
+  }
+
+  // Fills values with the current counts, or leaves them untouched if the
+  // counters are unavailable.
+  void read(std::array<int64_t, kNumHwCounters>& values) {
+#ifdef __linux__
+    if (!opened_) {
+      open();
+    }
+    if (fds_[0] < 0) {
+      return;
+    }
+    // PERF_FORMAT_GROUP: the number of counters, then their values.
+    uint64_t buffer[1 + kNumHwCounters];
+    if (::read(fds_[0], buffer, sizeof(buffer)) != sizeof(buffer)) {
+      return;
+    }
+    for (size_t i = 0; i < kNumHwCounters; i++) {
+      values[i] = static_cast<int64_t>(buffer[1 + i]);
+    }
+#endif
+  }
+
+ private:
+#ifdef __linux__
+  void open() {
+    opened_ = true;
+    const uint64_t configs[kNumHwCounters] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES};
+    for (size_t i = 0; i < kNumHwCounters; i++) {
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = configs[i];
+      attr.read_format = PERF_FORMAT_GROUP;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      fds_[i] = syscall(
+          __NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+          /*group_fd=*/i == 0 ? -1 : fds_[0], /*flags=*/0);
+      if (fds_[i] < 0) {
+        TORCH_WARN_ONCE(
+            "Can't open the hardware counters for the profiler (",
+            strerror(errno), "), check /proc/sys/kernel/perf_event_paranoid");
+        for (size_t j = 0; j < i; j++) {
+          close(fds_[j]);
+          fds_[j] = -1;
+        }
+        return;
+      }
+    }
+  }
+#endif
+
+  std::array<int, kNumHwCounters> fds_;
+  bool opened_ = false;
+};
+
+thread_local HwCounterGroup hw_counter_group;
+
+} // namespace
+
 void Event::record(bool record_cuda) {
+  // Keep the profiler's own work out of the counts of the range.
+  const bool sample_counters = record_hw_counters &&
+      (kind_ == EventKind::PushRange || kind_ == EventKind::PopRange);
+  if (sample_counters && kind_ == EventKind::PopRange) {
+    hw_counter_group.read(hw_counters_);
+  }
   if (record_cuda) {
     cuda_stubs->record(&device_, &event, &cpu_ns_);
-    return;
+  } else {
+    cpu_ns_ = getTime();
+  }
+  if (sample_counters && kind_ == EventKind::PushRange) {
+    hw_counter_group.read(hw_counters_);
+  }
+}
+
+void Event::updateMemoryStats(int64_t alloc_size, c10::Device device) {
+  if (device.is_cuda()) {
+    cuda_memory_usage_ = alloc_size;
+    device_ = device.index();
+  } else {
+    cpu_memory_usage_ = alloc_size;
   }
-  cpu_ns_ = getTime();
 }
 
 double Event::cuda_elapsed_us(const Event & e) {
@@ -339,4 +728,436 @@ void RecordProfile::processEvents(const std::vector<Event*>& events) {
   out_ << "]\n";
 }
 
+namespace {
+
+struct NameTable {
+  std::mutex mutex;
+  std::unordered_map<std::string, uint32_t> ids;
+  std::deque<std::string> names;
+};
+
+NameTable& nameTable() {
+  static NameTable table;
+  return table;
+}
+
+// Ring buffer of SampledEvents. Only the thread that owns it pushes, and
+// only one thread at a time drains it (under SamplingSession::mutex).
+struct SampleBuffer {
+  SampleBuffer(size_t capacity, uint16_t thread_id)
+      : thread_id(thread_id), events_(capacity) {}
+
+  void push(const SampledEvent& event) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == events_.size()) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    events_[head % events_.size()] = event;
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  void drain(std::vector<SampledEvent>& out) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t head = head_.load(std::memory_order_acquire);
+    for (; tail != head; ++tail) {
+      out.push_back(events_[tail % events_.size()]);
+    }
+    tail_.store(tail, std::memory_order_release);
+  }
+
+  const uint16_t thread_id;
+  std::atomic<uint64_t> dropped{0};
+
+ private:
+  std::vector<SampledEvent> events_;
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> tail_{0};
+};
+
+struct SamplingSession {
+  SamplingSession(SamplingProfilerConfig config, uint64_t id)
+      : config(std::move(config)), id(id), thread_([this] { run(); }) {}
+
+  ~SamplingSession() {
+    if (thread_.joinable()) {
+      stop();
+    }
+  }
+
+  std::shared_ptr<SampleBuffer> registerThread() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    buffers_.push_back(
+        std::make_shared<SampleBuffer>(config.buffer_size, ++next_thread_id_));
+    return buffers_.back();
+  }
+
+  // Drains every buffer and hands the events to the consumer.
+  void flush() {
+    std::vector<SampledEvent> events;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      for (auto it = buffers_.begin(); it != buffers_.end();) {
+        // A buffer only referenced from here belongs to a thread that exited.
+        // The fence makes its last pushes visible to the drain.
+        const bool orphaned = it->use_count() == 1;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        (*it)->drain(events);
+        if (orphaned) {
+          dropped_ += (*it)->dropped.load(std::memory_order_relaxed);
+          it = buffers_.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    if (events.empty()) {
+      return;
+    }
+    if (config.consumer) {
+      config.consumer(events);
+    } else {
+      std::lock_guard<std::mutex> guard(mutex_);
+      collected_.insert(collected_.end(), events.begin(), events.end());
+    }
+  }
+
+  std::vector<SampledEvent> stop() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stopped_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    flush();
+    std::lock_guard<std::mutex> guard(mutex_);
+    return std::move(collected_);
+  }
+
+  uint64_t droppedEvents() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    uint64_t dropped = dropped_;
+    for (const auto& buffer : buffers_) {
+      dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+  }
+
+  const SamplingProfilerConfig config;
+  const uint64_t id;
+  // Whether we are in a sampling window, maintained by the background
+  // thread so the recording threads don't have to read the clock.
+  std::atomic<bool> window_open{true};
+
+ private:
+  // Flushes the buffers every flush_interval_ms, and opens and closes the
+  // sampling windows.
+  void run() {
+    using clock = std::chrono::steady_clock;
+    const auto start = clock::now();
+    const auto flush_interval =
+        std::chrono::milliseconds(config.flush_interval_ms);
+    auto next_flush = start + flush_interval;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopped_) {
+      auto wake = next_flush;
+      if (config.period_ns > 0) {
+        const auto now = clock::now();
+        const int64_t phase =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - start)
+                .count() %
+            config.period_ns;
+        const bool open = phase < config.window_ns;
+        window_open.store(open, std::memory_order_relaxed);
+        const auto edge = now +
+            std::chrono::duration_cast<clock::duration>(std::chrono::nanoseconds(
+                open ? config.window_ns - phase : config.period_ns - phase));
+        wake = std::min(wake, edge);
+      }
+      cv_.wait_until(lock, wake);
+      if (!stopped_ && clock::now() >= next_flush) {
+        lock.unlock();
+        flush();
+        lock.lock();
+        next_flush = clock::now() + flush_interval;
+      }
+    }
+  }
+
+  // Protects everything below but the thread.
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopped_ = false;
+  std::vector<std::shared_ptr<SampleBuffer>> buffers_;
+  uint16_t next_thread_id_ = 0;
+  // Dropped events of the buffers that were released.
+  uint64_t dropped_ = 0;
+  std::vector<SampledEvent> collected_;
+  std::thread thread_;
+};
+
+struct OpenRange {
+  const RecordFunction* fn;
+  SampledEvent event;
+};
+
+struct SamplerThreadState {
+  uint64_t session_id = 0;
+  std::shared_ptr<SampleBuffer> buffer;
+  // Sampled ranges started on this thread and not ended yet.
+  std::vector<OpenRange> open;
+  uint64_t countdown = 0;
+};
+
+thread_local SamplerThreadState sampler_thread_state;
+
+std::shared_ptr<SamplingSession> sampling_session;
+uint64_t sampling_session_id = 0;
+uint64_t last_sampling_dropped = 0;
+
+void samplingStart(SamplingSession& session, const RecordFunction& fn) {
+  if (!session.window_open.load(std::memory_order_relaxed)) {
+    return;
+  }
+  auto& state = sampler_thread_state;
+  if (state.session_id != session.id) {
+    state.session_id = session.id;
+    state.buffer = session.registerThread();
+    state.open.clear();
+    state.countdown = session.config.sample_every;
+  }
+  if (--state.countdown != 0) {
+    return;
+  }
+  state.countdown = session.config.sample_every;
+  SampledEvent event;
+  event.name_id = internName(fn.name().str());
+  event.thread_id = state.buffer->thread_id;
+  event.sequence_nr = fn.seqNr();
+  event.end_ns = 0;
+  event.start_ns = getTime();
+  state.open.push_back({&fn, event});
+}
+
+void samplingEnd(SamplingSession& session, const RecordFunction& fn) {
+  auto& state = sampler_thread_state;
+  if (state.open.empty() || state.session_id != session.id) {
+    return;
+  }
+  // Ranges end in the reverse order they started on a thread, except for the
+  // ones ended on another thread (see RecordFunction::setThreadId), which
+  // are dropped here once an enclosing range ends.
+  for (size_t i = state.open.size(); i-- > 0;) {
+    if (state.open[i].fn == &fn) {
+      SampledEvent event = state.open[i].event;
+      event.end_ns = getTime();
+      state.open.resize(i);
+      state.buffer->push(event);
+      return;
+    }
+  }
+}
+
+} // namespace
+
+uint32_t internName(const char* name) {
+  // Ids a thread has seen are cached, so the table is only locked for names
+  // that are new to the thread.
+  thread_local std::unordered_map<std::string, uint32_t> cache;
+  auto it = cache.find(name);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  auto& table = nameTable();
+  uint32_t id;
+  {
+    std::lock_guard<std::mutex> guard(table.mutex);
+    auto result = table.ids.emplace(name, table.names.size());
+    if (result.second) {
+      table.names.emplace_back(name);
+    }
+    id = result.first->second;
+  }
+  cache.emplace(name, id);
+  return id;
+}
+
+std::string getInternedName(uint32_t id) {
+  auto& table = nameTable();
+  std::lock_guard<std::mutex> guard(table.mutex);
+  TORCH_CHECK(id < table.names.size(), "unknown interned name id ", id);
+  return table.names[id];
+}
+
+void enableSamplingProfiler(SamplingProfilerConfig config) {
+  TORCH_CHECK(!sampling_session, "the sampling profiler is already enabled");
+  TORCH_CHECK(config.sample_every > 0, "sample_every must be positive");
+  TORCH_CHECK(config.buffer_size > 0, "buffer_size must be positive");
+  TORCH_CHECK(
+      config.flush_interval_ms > 0, "flush_interval_ms must be positive");
+  TORCH_CHECK(
+      config.period_ns <= 0 ||
+          (config.window_ns > 0 && config.window_ns <= config.period_ns),
+      "window_ns must be in (0, period_ns], got ", config.window_ns,
+      " and ", config.period_ns);
+
+  auto session = std::make_shared<SamplingSession>(
+      std::move(config), ++sampling_session_id);
+  pushCallback(
+      [session](const RecordFunction& fn) { samplingStart(*session, fn); },
+      [session](const RecordFunction& fn) { samplingEnd(*session, fn); });
+  sampling_session = std::move(session);
+}
+
+std::vector<SampledEvent> disableSamplingProfiler() {
+  TORCH_CHECK(
+      sampling_session,
+      "can't disable the sampling profiler when it's not running");
+  popCallback();
+  auto events = sampling_session->stop();
+  last_sampling_dropped = sampling_session->droppedEvents();
+  sampling_session.reset();
+  if (last_sampling_dropped > 0) {
+    TORCH_WARN(
+        "The sampling profiler dropped ", last_sampling_dropped,
+        " events because buffers were full, consider increasing buffer_size ",
+        "or decreasing flush_interval_ms");
+  }
+  return events;
+}
+
+bool samplingProfilerEnabled() {
+  return sampling_session != nullptr;
+}
+
+uint64_t samplingProfilerDroppedEvents() {
+  return sampling_session ? sampling_session->droppedEvents()
+                          : last_sampling_dropped;
+}
+
+ChromeTraceStream::ChromeTraceStream(std::string path, size_t max_file_bytes)
+    : path_(std::move(path)),
+      max_file_bytes_(max_file_bytes),
+      start_ns_(getTime()) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  TORCH_CHECK(open(), "could not open ", path_);
+}
+
+ChromeTraceStream::~ChromeTraceStream() {
+  close();
+}
+
+bool ChromeTraceStream::open() {
+  const std::string filename = files_.empty()
+      ? path_
+      : path_ + "." + std::to_string(files_.size());
+  file_.reset(new std::ofstream(filename));
+  if (!*file_) {
+    file_.reset();
+    return false;
+  }
+  files_.push_back(filename);
+  *file_ << "[\n";
+  file_bytes_ = 2;
+  first_event_ = true;
+  return true;
+}
+
+void ChromeTraceStream::closeFile() {
+  *file_ << "\n]\n";
+  file_->close();
+  file_.reset();
+}
+
+const std::string& ChromeTraceStream::name(uint32_t id) {
+  if (id >= names_.size()) {
+    names_.resize(id + 1);
+  }
+  if (names_[id].empty()) {
+    names_[id] = getInternedName(id);
+  }
+  return names_[id];
+}
+
+void ChromeTraceStream::write(const std::vector<SampledEvent>& events) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (closed_) {
+    return;
+  }
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3);
+  for (const auto& event : events) {
+    if (max_file_bytes_ > 0 && file_bytes_ >= max_file_bytes_) {
+      closeFile();
+      if (!open()) {
+        TORCH_WARN(
+            "could not open ", path_, ".", files_.size(),
+            ", dropping the rest of the trace");
+        closed_ = true;
+        return;
+      }
+    }
+    out.str("");
+    if (!first_event_) {
+      out << ",\n";
+    }
+    first_event_ = false;
+    out << "{\"name\": \"";
+    for (char c : name(event.name_id)) {
+      if (c == '"' || c == '\\') {
+        out << '\\';
+      }
+      out << c;
+    }
+    out << "\", \"ph\": \"X\", \"ts\": " << (event.start_ns - start_ns_) / 1000.0
+        << ", \"dur\": " << (event.end_ns - event.start_ns) / 1000.0
+        << ", \"tid\": " << event.thread_id
+        << ", \"pid\": \"CPU Functions\", \"args\": {\"seq\": "
+        << event.sequence_nr << "}}";
+    const std::string record = out.str();
+    file_->write(record.data(), record.size());
+    file_bytes_ += record.size();
+  }
+  file_->flush();
+}
+
+void ChromeTraceStream::close() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (closed_) {
+    return;
+  }
+  closeFile();
+  closed_ = true;
+}
+
+std::vector<std::string> ChromeTraceStream::files() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return files_;
+}
+
+SamplingProfilerConfig RecordStreamingProfile::defaultConfig() {
+  SamplingProfilerConfig config;
+  config.sample_every = 1;
+  config.buffer_size = 1 << 16;
+  config.flush_interval_ms = 50;
+  return config;
+}
+
+RecordStreamingProfile::RecordStreamingProfile(
+    const std::string& filename,
+    size_t max_file_bytes,
+    SamplingProfilerConfig config)
+    : stream_(std::make_shared<ChromeTraceStream>(filename, max_file_bytes)) {
+  auto stream = stream_;
+  config.consumer = [stream](const std::vector<SampledEvent>& events) {
+    stream->write(events);
+  };
+  enableSamplingProfiler(std::move(config));
+}
+
+RecordStreamingProfile::~RecordStreamingProfile() {
+  disableSamplingProfiler();
+  stream_->close();
+}
+
 }}}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <functional>
 #include <iostream>
 #include <mutex>
 #include <memory>
@@ -107,17 +109,45 @@ enum class TORCH_API ProfilerState {
 };
 
 struct TORCH_API ProfilerConfig {
-  ProfilerConfig(ProfilerState state, bool report_input_shapes)
-      : state(state), report_input_shapes(report_input_shapes) {}
+  ProfilerConfig(
+      ProfilerState state,
+      bool report_input_shapes,
+      bool profile_memory = false,
+      bool with_flops = false,
+      bool record_hw_counters = false)
+      : state(state),
+        report_input_shapes(report_input_shapes),
+        profile_memory(profile_memory),
+        with_flops(with_flops),
+        record_hw_counters(record_hw_counters) {}
   ~ProfilerConfig();
   ProfilerState state;
   bool report_input_shapes;
+  // Record the allocations and frees of the CPU allocators and the CUDA
+  // caching allocator as MemoryAlloc events.
+  bool profile_memory;
+  // Estimate the floating point operations and the bytes accessed by matrix
+  // multiplies, convolutions and pointwise ops from their inputs.
+  bool with_flops;
+  // Sample the hardware counters of the thread (see HwCounter) at the start
+  // and end of every range. Linux only.
+  bool record_hw_counters;
 };
 
+// Hardware counters read through perf_event, counting user space only.
+enum class TORCH_API HwCounter : uint8_t {
+  Cycles,
+  Instructions,
+  LLCMisses,
+  NumCounters
+};
+constexpr size_t kNumHwCounters = static_cast<size_t>(HwCounter::NumCounters);
+
 enum class TORCH_API EventKind : uint16_t {
   Mark,
   PushRange,
-  PopRange
+  PopRange,
+  MemoryAlloc
 };
 #ifndef _MSC_VER
 #  pragma GCC diagnostic pop
@@ -143,6 +173,7 @@ struct TORCH_API Event final {
       case EventKind::Mark: return "mark";
       case EventKind::PushRange: return "push";
       case EventKind::PopRange: return "pop";
+      case EventKind::MemoryAlloc: return "memory_alloc";
     }
     throw std::runtime_error("unknown EventKind");
   }
@@ -165,6 +196,37 @@ struct TORCH_API Event final {
   int device() const {
     return device_;
   }
+  // Bytes allocated (freed if negative) by a MemoryAlloc event.
+  int64_t cpu_memory_usage() const {
+    return cpu_memory_usage_;
+  }
+  int64_t cuda_memory_usage() const {
+    return cuda_memory_usage_;
+  }
+  void updateMemoryStats(int64_t alloc_size, c10::Device device);
+  // Estimated cost of the range started by a PushRange event, zero if it is
+  // unknown.
+  int64_t flops() const {
+    return flops_;
+  }
+  int64_t bytes() const {
+    return bytes_;
+  }
+  void setFlops(int64_t flops, int64_t bytes) {
+    flops_ = flops;
+    bytes_ = bytes;
+  }
+  // Values of the hardware counters when the event was recorded, indexed by
+  // HwCounter, or empty if they weren't sampled.
+  std::vector<int64_t> hw_counters() const {
+    if (hw_counters_[0] < 0) {
+      return {};
+    }
+    return std::vector<int64_t>(hw_counters_.begin(), hw_counters_.end());
+  }
+  void clearHwCounters() {
+    hw_counters_.fill(-1);
+  }
 private:
   // signed to allow for negative intervals, initialized for safety.
   int64_t cpu_ns_ = 0;
@@ -174,6 +236,11 @@ private:
   std::vector<std::vector<int64_t>> shapes_;
   int device_ = -1;
   struct CUevent_st* event = nullptr;
+  int64_t cpu_memory_usage_ = 0;
+  int64_t cuda_memory_usage_ = 0;
+  int64_t flops_ = 0;
+  int64_t bytes_ = 0;
+  std::array<int64_t, kNumHwCounters> hw_counters_{{-1, -1, -1}};
 };
 
 // a linked-list of fixed sized vectors, to avoid
@@ -201,11 +268,12 @@ struct RangeEventList {
   }
 
   template<typename... Args>
-  void record(Args&&... args) {
+  Event& record(Args&&... args) {
     if (blocks.empty() || blocks.front().size() == num_block_elements) {
       allocBlock();
     }
     blocks.front().emplace_back(std::forward<Args>(args)...);
+    return blocks.front().back();
   }
 
   std::vector<Event> consolidate() {
@@ -234,6 +302,14 @@ TORCH_API void enableProfiler(ProfilerConfig);
 TORCH_API thread_event_lists disableProfiler();
 TORCH_API bool profilerEnabled();
 
+// Emits an NVTX (roctx on ROCm) range for every RecordFunction, named after
+// it, straight from the RecordFunction callbacks. Unlike the NVTX profiler
+// state, ranges carry no sequence numbers or shapes, so there is no string to
+// build per op. Enabling and disabling are **NOT THREAD SAFE** either, and
+// must nest with other users of pushCallback().
+TORCH_API void enableNvtxRanges();
+TORCH_API void disableNvtxRanges();
+
 
 // Usage:
 //   {
@@ -253,6 +329,114 @@ private:
   void processEvents(const std::vector<Event*>& events);
 };
 
+// Sampling profiler
+//
+// A lighter-weight mode meant to be left on, e.g. while serving traffic. It
+// records a subset of the RecordFunction ranges as fixed-size SampledEvents
+// into per-thread ring buffers without taking locks, and a background thread
+// drains the buffers and hands the events to a consumer. Names are interned
+// into integer ids, use getInternedName() to get them back.
+//
+// It is independent of enableProfiler(), but shares the RecordFunction
+// callback stack with it: enabling and disabling must nest with other users
+// of pushCallback()/popCallback(), and is **NOT THREAD SAFE** either.
+
+struct TORCH_API SampledEvent {
+  int64_t start_ns;
+  int64_t end_ns;
+  int64_t sequence_nr;
+  uint32_t name_id;
+  // Numbered from 1 in the order threads record their first event, per
+  // session.
+  uint16_t thread_id;
+};
+
+struct TORCH_API SamplingProfilerConfig {
+  // Each thread records one in every `sample_every` ranges it starts.
+  uint64_t sample_every = 100;
+  // If `period_ns` is positive, only ranges starting in the first
+  // `window_ns` of every `period_ns` are considered.
+  int64_t window_ns = 0;
+  int64_t period_ns = 0;
+  // Capacity of each thread's buffer. Events recorded while it is full are
+  // dropped, and counted.
+  size_t buffer_size = 4096;
+  int64_t flush_interval_ms = 100;
+  // Called from the background thread with each batch of events drained
+  // from the buffers, and from disableSamplingProfiler() with the last one.
+  // If not set, the events are kept until disableSamplingProfiler() returns
+  // them.
+  std::function<void(const std::vector<SampledEvent>&)> consumer;
+};
+
+TORCH_API void enableSamplingProfiler(SamplingProfilerConfig config);
+// Flushes the buffers and stops the sampling profiler. Ranges that are still
+// open are not recorded.
+TORCH_API std::vector<SampledEvent> disableSamplingProfiler();
+TORCH_API bool samplingProfilerEnabled();
+// Number of events dropped because a buffer was full, in the current or
+// last session.
+TORCH_API uint64_t samplingProfilerDroppedEvents();
+
+// Interned names are never freed, they are meant for the bounded set of
+// operator and function names.
+TORCH_API uint32_t internName(const char* name);
+TORCH_API std::string getInternedName(uint32_t id);
+
+// Writes SampledEvents to Chrome trace files as they arrive, so long
+// profiles neither accumulate in memory nor need a conversion at the end.
+// Once a file holds max_file_bytes (if non-zero) it is completed, and the
+// next events go to `path`.1, `path`.2, ... Every file is a trace of its
+// own, with times relative to the creation of the stream.
+struct TORCH_API ChromeTraceStream {
+  explicit ChromeTraceStream(std::string path, size_t max_file_bytes = 0);
+  ~ChromeTraceStream();
+
+  void write(const std::vector<SampledEvent>& events);
+  // Completes the current file. Later writes are ignored.
+  void close();
+  // Paths of the files written so far.
+  std::vector<std::string> files() const;
+
+ private:
+  bool open();
+  void closeFile();
+  const std::string& name(uint32_t id);
+
+  const std::string path_;
+  const size_t max_file_bytes_;
+  const int64_t start_ns_;
+  mutable std::mutex mutex_;
+  std::unique_ptr<std::ofstream> file_;
+  size_t file_bytes_ = 0;
+  bool first_event_ = true;
+  bool closed_ = false;
+  std::vector<std::string> files_;
+  // Names by interned id, filled as they are needed.
+  std::vector<std::string> names_;
+};
+
+// Usage:
+//   {
+//     RecordStreamingProfile guard("filename.trace", 256 * 1024 * 1024);
+//     // code you want to profile
+//   }
+// Like RecordProfile, but all ranges are streamed to the trace files through
+// the sampling profiler while the code runs. Ranges are only dropped if a
+// thread records more than config.buffer_size of them between two flushes.
+struct TORCH_API RecordStreamingProfile {
+  explicit RecordStreamingProfile(
+      const std::string& filename,
+      size_t max_file_bytes = 0,
+      SamplingProfilerConfig config = defaultConfig());
+  ~RecordStreamingProfile();
+
+  static SamplingProfilerConfig defaultConfig();
+
+ private:
+  std::shared_ptr<ChromeTraceStream> stream_;
+};
+
 
 } // namespace profiler
 }} // namespace torch::autograd
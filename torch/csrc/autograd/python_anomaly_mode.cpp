@@ -4,13 +4,105 @@
 #include <torch/csrc/Exceptions.h>
 #include <torch/csrc/python_headers.h>
 #include <torch/csrc/utils/auto_gil.h>
+#include <torch/csrc/utils/hash.h>
 #include <torch/csrc/utils/object_ptr.h>
 #include <torch/csrc/utils/python_strings.h>
 
+#include <frameobject.h>
+
 #include <iostream>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace torch { namespace autograd {
 
+namespace {
+
+// The code object and line number of each frame, innermost first
+using StackFrames = std::vector<std::pair<PyCodeObject*, int>>;
+
+struct StackFramesHash {
+  size_t operator()(const StackFrames& frames) const {
+    size_t hash = frames.size();
+    for (const auto& frame : frames) {
+      hash = torch::hash_combine(hash, std::hash<PyCodeObject*>()(frame.first));
+      hash = torch::hash_combine(hash, frame.second);
+    }
+    return hash;
+  }
+};
+
+// Guarded by the GIL. The interned stacks hold a reference to their code
+// objects and are never freed, a program only has so many creation sites.
+struct InternedStacks {
+  std::unordered_map<StackFrames, uint32_t, StackFramesHash> ids;
+  // the stack of id i is stacks[i - 1], the keys of ids are stable
+  std::vector<const StackFrames*> stacks;
+};
+
+InternedStacks& interned_stacks() {
+  static InternedStacks* stacks = new InternedStacks();
+  return *stacks;
+}
+
+} // namespace
+
+uint32_t intern_python_stack() {
+  pybind11::gil_scoped_acquire gil;
+  StackFrames frames;
+  for (PyFrameObject* frame = PyEval_GetFrame(); frame != nullptr; frame = frame->f_back) {
+    frames.emplace_back(frame->f_code, PyFrame_GetLineNumber(frame));
+  }
+  if (frames.empty()) {
+    return 0;
+  }
+
+  auto& table = interned_stacks();
+  auto it = table.ids.find(frames);
+  if (it != table.ids.end()) {
+    return it->second;
+  }
+  for (const auto& frame : frames) {
+    Py_INCREF(frame.first);
+  }
+  const uint32_t id = table.stacks.size() + 1;
+  it = table.ids.emplace(std::move(frames), id).first;
+  table.stacks.push_back(&it->first);
+  return id;
+}
+
+std::string format_python_stack(uint32_t stack_id) {
+  pybind11::gil_scoped_acquire gil;
+  auto& table = interned_stacks();
+  TORCH_INTERNAL_ASSERT(stack_id > 0 && stack_id <= table.stacks.size());
+  const StackFrames& frames = *table.stacks[stack_id - 1];
+
+  THPObjectPtr linecache(PyImport_ImportModule("linecache"));
+  if (!linecache) {
+    throw python_error();
+  }
+  std::stringstream ss;
+  for (auto frame = frames.rbegin(); frame != frames.rend(); ++frame) {
+    PyCodeObject* code = frame->first;
+    ss << "  File \"" << THPUtils_unpackString(code->co_filename) << "\", line "
+       << frame->second << ", in " << THPUtils_unpackString(code->co_name) << "\n";
+    THPObjectPtr line(PyObject_CallMethod(
+        linecache.get(), "getline", "Oi", code->co_filename, frame->second));
+    if (!line) {
+      throw python_error();
+    }
+    const std::string source = THPUtils_unpackString(line.get());
+    const auto begin = source.find_first_not_of(" \t\r\n");
+    if (begin != std::string::npos) {
+      const auto end = source.find_last_not_of(" \t\r\n");
+      ss << "    " << source.substr(begin, end - begin + 1) << "\n";
+    }
+  }
+  return ss.str();
+}
+
 void PyAnomalyMetadata::store_stack() {
   pybind11::gil_scoped_acquire gil;
   THPObjectPtr mod(PyImport_ImportModule("traceback"));
@@ -29,4 +29,14 @@ private:
   PyObject* dict_;
 };
 
+// The stacks of the lightweight anomaly mode. A stack is interned as the
+// code objects and line numbers of its frames, which is much cheaper than
+// formatting it; the source is only looked up by format_python_stack().
+
+// Interns the current Python stack and returns its id, 0 if there is none.
+uint32_t intern_python_stack();
+
+// Formats an interned stack like traceback.format_stack().
+std::string format_python_stack(uint32_t stack_id);
+
 }}
@@ -55,6 +55,14 @@ std::unique_ptr<AnomalyMetadata> PythonEngine::make_anomaly_metadata() {
   return std::unique_ptr<AnomalyMetadata>(new PyAnomalyMetadata());
 }
 
+uint32_t PythonEngine::intern_anomaly_stack() {
+  return intern_python_stack();
+}
+
+std::string PythonEngine::format_anomaly_stack(uint32_t stack_id) {
+  return format_python_stack(stack_id);
+}
+
 variable_list PythonEngine::execute(
     const edge_list& roots,
     const variable_list& inputs,
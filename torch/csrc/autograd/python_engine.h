@@ -26,6 +26,8 @@ struct PythonEngine : public Engine {
       const std::shared_ptr<GraphTask>& graph_task,
       std::shared_ptr<Node> graph_root) override;
   std::unique_ptr<AnomalyMetadata> make_anomaly_metadata() override;
+  uint32_t intern_anomaly_stack() override;
+  std::string format_anomaly_stack(uint32_t stack_id) override;
 };
 
 }}} // namespace torch::autograd::python
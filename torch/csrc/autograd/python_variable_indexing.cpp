@@ -18,6 +18,7 @@
 #include <ATen/ExpandUtils.h>
 #include <c10/core/TensorOptions.h>
 #include <ATen/core/LegacyTypeDispatch.h>
+#include <ATen/core/grad_mode.h>
 
 #include <vector>
 #include <tuple>
@@ -161,6 +162,82 @@ static Variable boolToIndexingTensor(const Variable& self, bool value) {
   }
 }
 
+// Indexes self by a tuple of only integers and slices with a single view,
+// computing its sizes, strides and storage offset at once instead of calling
+// select or slice for every element of the tuple. Returns an undefined
+// Variable if the tuple holds anything else, or if the views must be taken
+// one by one: while tracing, so that the trace records them; for named and
+// quantized tensors and backends other than CPU and CUDA, which don't all
+// support as_strided; and for tensors that require grad, as the backward of
+// select and slice is cheaper than the one of as_strided.
+static Variable applySlicingFast(const Variable& self, PyObject* index) {
+  int64_t size = PyTuple_GET_SIZE(index); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+  if (size == 0 || size > self.dim() || jit::tracer::isTracing() ||
+      self.layout() != kStrided || self.is_quantized() || self.has_names() ||
+      !(self.device().is_cpu() || self.device().is_cuda()) ||
+      (self.requires_grad() && GradMode::is_enabled())) {
+    return Variable();
+  }
+  for (int64_t i = 0; i < size; i++) {
+    PyObject* obj = PyTuple_GET_ITEM(index, i); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+    if (!THPUtils_checkLong(obj) && !PySlice_Check(obj)) {
+      return Variable();
+    }
+  }
+
+  std::vector<int64_t> sizes;
+  std::vector<int64_t> strides;
+  sizes.reserve(self.dim());
+  strides.reserve(self.dim());
+  int64_t storage_offset = self.storage_offset();
+  for (int64_t i = 0; i < size; i++) {
+    PyObject* obj = PyTuple_GET_ITEM(index, i); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+    int64_t length = self.size(i);
+    int64_t stride = self.stride(i);
+    if (THPUtils_checkLong(obj)) {
+      // Same checks and wrapping as select.
+      int64_t unpacked_index = THPUtils_unpackLong(obj);
+      if (unpacked_index < -length || unpacked_index >= length) {
+        throw IndexError("index %lld is out of bounds for dimension %lld with size %lld",
+          unpacked_index, i, length);
+      }
+      if (unpacked_index < 0) {
+        unpacked_index += length;
+      }
+      storage_offset += unpacked_index * stride;
+      continue;
+    }
+    // Same checks and clamping as applySlice and slice.
+    Py_ssize_t start, stop, step;
+    if (!THPUtils_unpackSlice(obj, &start, &stop, &step)) {
+      throw python_error();
+    }
+    if (step == 0) {
+      throw ValueError("step cannot be zero");
+    }
+    if (step < 0) {
+      // TODO: implement negative step
+      throw ValueError("negative step not yet supported");
+    }
+    if (start < 0) {
+      start += length;
+    }
+    if (stop < 0) {
+      stop += length;
+    }
+    start = std::min<int64_t>(std::max<int64_t>(start, 0), length);
+    stop = std::min<int64_t>(std::max<int64_t>(stop, start), length);
+    storage_offset += start * stride;
+    sizes.push_back((stop - start + step - 1) / step);
+    strides.push_back(stride * step);
+  }
+  for (int64_t d = size; d < self.dim(); d++) {
+    sizes.push_back(self.size(d));
+    strides.push_back(self.stride(d));
+  }
+  return self.as_strided(sizes, strides, storage_offset);
+}
+
 static Variable applySlicing(const Variable& self, PyObject* index, variable_list& outIndices) {
   int64_t size = PyTuple_GET_SIZE(index); // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
   int64_t dim = 0;
@@ -323,6 +400,11 @@ PyObject* THPVariable_getitem(PyObject* self, PyObject* index) {
   // wrap index in a tuple if it's not already one
   THPObjectPtr holder = wrapTuple(index);
 
+  Variable view = applySlicingFast(self_, holder.get());
+  if (view.defined()) {
+    return wrap(view);
+  }
+
   variable_list variableIndices;
   Variable sliced = applySlicing(self_, holder.get(), variableIndices);
   if (variableIndices.empty()) {
@@ -399,6 +481,12 @@ int THPVariable_setitem(PyObject* self, PyObject* index, PyObject* py_value) {
   // wrap index in a tuple if it's not already one
   THPObjectPtr holder = wrapTuple(index);
 
+  Variable view = applySlicingFast(self_, holder.get());
+  if (view.defined()) {
+    copy_to(view, value);
+    return 0;
+  }
+
   variable_list variableIndices;
   Variable sliced = applySlicing(self_, holder.get(), variableIndices);
   if (variableIndices.empty()) {
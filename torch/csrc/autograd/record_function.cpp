@@ -46,6 +46,8 @@ class CallbackManager {
     if (sampled) {
       ++num_sampled_callbacks;
     }
+    detail::num_callbacks.store(
+        start_callbacks.size(), std::memory_order_relaxed);
   }
 
   void popCallback() {
@@ -61,10 +63,8 @@ class CallbackManager {
       --num_sampled_callbacks;
     }
     is_callback_sampled.pop_back();
-  }
-
-  bool hasCallbacks() {
-    return !start_callbacks.empty();
+    detail::num_callbacks.store(
+        start_callbacks.size(), std::memory_order_relaxed);
   }
 
   bool needsInputs() {
@@ -101,6 +101,10 @@ CallbackManager& manager() {
 
 } // namespace
 
+namespace detail {
+std::atomic<size_t> num_callbacks{0};
+} // namespace detail
+
 void setSamplingProbability(double prob) {
   manager().setSamplingProbability(prob);
 }
@@ -126,10 +130,6 @@ void popCallback() {
   manager().popCallback();
 }
 
-bool hasCallbacks() {
-  return manager().hasCallbacks();
-}
-
 bool needsInputs() {
   return manager().needsInputs();
 }
@@ -207,7 +207,7 @@ void RecordFunction::setThreadId() {
   threadId_ = threadId;
 }
 
-RecordFunction::~RecordFunction() {
+void RecordFunction::endNoThrow() {
   try {
     end();
   } catch (const std::exception &e) {
@@ -4,6 +4,8 @@
 #include <c10/util/SmallVector.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
+#include <atomic>
+
 namespace torch { namespace autograd {
 
 struct Node;
@@ -75,7 +77,11 @@ struct TORCH_API RecordFunction {
   }
 
   // Destructor calls end callbacks
-  virtual ~RecordFunction();
+  virtual ~RecordFunction() {
+    if (initialized_) {
+      endNoThrow();
+    }
+  }
 
   inline Node* func() const {
     return fn_;
@@ -123,6 +129,7 @@ struct TORCH_API RecordFunction {
 
  private:
   void processCallbacks();
+  void endNoThrow();
 
   Node* fn_ = nullptr;
   StringView name_;
@@ -139,7 +146,17 @@ struct TORCH_API RecordFunction {
   uint16_t threadId_ = 0;
 };
 
-TORCH_API bool hasCallbacks();
+namespace detail {
+// Number of callbacks pushed with pushCallback(). Kept here so that
+// checking for callbacks is a load, not a call into libtorch.
+TORCH_API extern std::atomic<size_t> num_callbacks;
+} // namespace detail
+
+// Without callbacks, RECORD_FUNCTION doesn't evaluate its arguments: neither
+// the name nor the inputs are built.
+inline bool hasCallbacks() {
+  return detail::num_callbacks.load(std::memory_order_relaxed) > 0;
+}
 TORCH_API bool needsInputs();
 TORCH_API bool hasNonSampledCallbacks();
 
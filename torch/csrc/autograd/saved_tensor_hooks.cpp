@@ -0,0 +1,189 @@
+#include <torch/csrc/autograd/saved_tensor_hooks.h>
+
+#include <ATen/ATen.h>
+#include <c10/core/DeviceGuard.h>
+#include <c10/core/Event.h>
+#include <c10/core/StreamGuard.h>
+#include <c10/core/impl/VirtualGuardImpl.h>
+
+namespace torch { namespace autograd {
+
+// A tensor offloaded to pinned host memory. Device memory for the copy back
+// is allocated on the stream that will consume it, so the caching allocator
+// never hands it out while the transfer stream may still write to it.
+struct OffloadedTensor : public SavedTensorPack {
+  OffloadedTensor(const at::Tensor& tensor, c10::optional<c10::Stream> stream)
+      : device_(tensor.device()),
+        stream_(std::move(stream)),
+        offloaded_(device_.type()),
+        restored_(device_.type()) {
+    host_ = at::empty_strided(
+        tensor.sizes(),
+        tensor.strides(),
+        tensor.options().device(at::kCPU).pinned_memory(true));
+    const c10::impl::VirtualGuardImpl impl(device_.type());
+    const c10::Stream current = impl.getStream(device_);
+    if (stream_) {
+      // The transfer stream must see everything that produced `tensor`.
+      c10::Event produced(device_.type());
+      produced.record(current);
+      produced.block(*stream_);
+      c10::StreamGuard guard(*stream_);
+      host_.copy_(tensor, /*non_blocking=*/true);
+      offloaded_.record(*stream_);
+      // Keep the device memory alive until the copy is done, it was
+      // allocated for the current stream.
+      device_data_ = tensor;
+    } else {
+      c10::OptionalDeviceGuard guard(device_);
+      host_.copy_(tensor, /*non_blocking=*/true);
+      offloaded_.record(current);
+    }
+  }
+
+  ~OffloadedTensor() override {
+    if (restore_stream_) {
+      // device_data_ was prefetched but never unpacked: the memory goes back
+      // to restore_stream_, which must not reuse it before the copy is done.
+      restored_.block(*restore_stream_);
+    }
+  }
+
+  // Drops the device tensor kept alive by the constructor once the copy to
+  // the host is done. Returns false if it's still running.
+  bool release_original() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (restore_stream_ || !device_data_.defined()) {
+      return true;
+    }
+    if (!offloaded_.query()) {
+      return false;
+    }
+    device_data_.reset();
+    return true;
+  }
+
+  void prefetch() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    prefetch_locked();
+  }
+
+  at::Tensor unpack() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    prefetch_locked();
+    const c10::impl::VirtualGuardImpl impl(device_.type());
+    restored_.block(impl.getStream(device_));
+    restore_stream_ = c10::nullopt;
+    // Don't hold on to device memory if the graph is retained; the next
+    // unpack copies again.
+    return std::move(device_data_);
+  }
+
+ private:
+  void prefetch_locked() {
+    if (restore_stream_) {
+      return;
+    }
+    if (device_data_.defined()) {
+      // Still the original tensor, the offload hasn't been released yet.
+      restore_stream_ = c10::impl::VirtualGuardImpl(device_.type())
+          .getStream(device_);
+      return;
+    }
+    const c10::impl::VirtualGuardImpl impl(device_.type());
+    const c10::Stream current = impl.getStream(device_);
+    c10::OptionalDeviceGuard device_guard(device_);
+    device_data_ = at::empty_strided(
+        host_.sizes(), host_.strides(), host_.options().device(device_));
+    if (stream_) {
+      c10::Event allocated(device_.type());
+      allocated.record(current);
+      allocated.block(*stream_);
+      c10::StreamGuard guard(*stream_);
+      device_data_.copy_(host_, /*non_blocking=*/true);
+      restored_.record(*stream_);
+    } else {
+      device_data_.copy_(host_, /*non_blocking=*/true);
+    }
+    restore_stream_ = current;
+  }
+
+  const at::Device device_;
+  const c10::optional<c10::Stream> stream_;
+  at::Tensor host_;
+  // The original tensor until the offload is done, then the restored one
+  // between prefetch() and unpack().
+  at::Tensor device_data_;
+  // Stream device_data_ was restored for, set between prefetch and unpack.
+  c10::optional<c10::Stream> restore_stream_;
+  c10::Event offloaded_;
+  c10::Event restored_;
+  std::mutex mutex_;
+};
+
+OffloadSavedTensorHooks::OffloadSavedTensorHooks(
+    size_t min_bytes,
+    c10::optional<c10::Stream> stream)
+    : min_bytes_(min_bytes), stream_(std::move(stream)) {}
+
+std::shared_ptr<SavedTensorPack> OffloadSavedTensorHooks::pack(
+    const at::Tensor& tensor) {
+  if (tensor.device().is_cpu() || tensor.is_sparse() ||
+      tensor.is_quantized() || !tensor.is_non_overlapping_and_dense() ||
+      tensor.numel() * tensor.element_size() < min_bytes_) {
+    return nullptr;
+  }
+  if (stream_) {
+    TORCH_CHECK(
+        stream_->device() == tensor.device(),
+        "OffloadSavedTensorHooks: tensor on ", tensor.device(),
+        " but the transfer stream is on ", stream_->device());
+  }
+  auto packed = std::make_shared<OffloadedTensor>(tensor, stream_);
+  if (stream_) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!in_flight_.empty() && in_flight_.front()->release_original()) {
+      in_flight_.pop_front();
+    }
+    in_flight_.push_back(packed);
+  }
+  return packed;
+}
+
+namespace {
+
+struct CastTensor : public SavedTensorPack {
+  CastTensor(const at::Tensor& tensor, at::ScalarType dtype)
+      : dtype_(tensor.scalar_type()), data_(tensor.to(dtype)) {}
+
+  at::Tensor unpack() override {
+    return data_.to(dtype_);
+  }
+
+ private:
+  const at::ScalarType dtype_;
+  const at::Tensor data_;
+};
+
+} // namespace
+
+CastSavedTensorHooks::CastSavedTensorHooks(
+    at::ScalarType dtype,
+    size_t min_bytes)
+    : dtype_(dtype), min_bytes_(min_bytes) {
+  TORCH_CHECK(
+      at::isFloatingType(dtype),
+      "CastSavedTensorHooks: expected a floating point dtype, got ", dtype);
+}
+
+std::shared_ptr<SavedTensorPack> CastSavedTensorHooks::pack(
+    const at::Tensor& tensor) {
+  if (!at::isFloatingType(tensor.scalar_type()) || tensor.is_sparse() ||
+      at::elementSize(tensor.scalar_type()) <= at::elementSize(dtype_) ||
+      tensor.numel() * tensor.element_size() < min_bytes_) {
+    return nullptr;
+  }
+  return std::make_shared<CastTensor>(tensor, dtype_);
+}
+
+}} // namespace torch::autograd
@@ -0,0 +1,66 @@
+#pragma once
+
+// Built-in SavedTensorHooks. Install them for a forward pass with
+//
+//   SavedTensorHooksGuard guard(std::make_shared<OffloadSavedTensorHooks>());
+//
+// The tensors saved while the guard is alive are packed when they are saved
+// and unpacked when backward needs them. While a node runs, the engine
+// prefetches the saved tensors of the nodes it feeds, which is usually enough
+// to hide the transfer.
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/autograd/saved_variable.h>
+
+#include <c10/core/Stream.h>
+#include <c10/util/Optional.h>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace torch { namespace autograd {
+
+struct OffloadedTensor;
+
+/// Moves saved non-CPU tensors of at least `min_bytes` to pinned host memory
+/// and copies them back in backward.
+///
+/// If `stream` is given, both copies run on it, so they can overlap with
+/// compute on the current stream. The current streams wait on it as
+/// needed. Otherwise the copies are issued on the current stream, without
+/// blocking the host.
+///
+/// Tensors whose elements don't cover their memory exactly, such as
+/// expanded or strided views, are saved as they are.
+struct TORCH_API OffloadSavedTensorHooks : public SavedTensorHooks {
+  explicit OffloadSavedTensorHooks(
+      size_t min_bytes = 1024 * 1024,
+      c10::optional<c10::Stream> stream = c10::nullopt);
+
+  std::shared_ptr<SavedTensorPack> pack(const at::Tensor& tensor) override;
+
+ private:
+  const size_t min_bytes_;
+  const c10::optional<c10::Stream> stream_;
+
+  // Offloads whose device memory still has to be kept alive until the copy
+  // on stream_ is done. Released in pack() once that is the case.
+  std::mutex mutex_;
+  std::deque<std::shared_ptr<OffloadedTensor>> in_flight_;
+};
+
+/// Saves floating point tensors of at least `min_bytes` cast to `dtype`
+/// (e.g. at::kHalf or at::kBFloat16) and casts them back when unpacked.
+/// This is lossy: backward sees the rounded values.
+struct TORCH_API CastSavedTensorHooks : public SavedTensorHooks {
+  explicit CastSavedTensorHooks(at::ScalarType dtype, size_t min_bytes = 0);
+
+  std::shared_ptr<SavedTensorPack> pack(const at::Tensor& tensor) override;
+
+ private:
+  const at::ScalarType dtype_;
+  const size_t min_bytes_;
+};
+
+}} // namespace torch::autograd
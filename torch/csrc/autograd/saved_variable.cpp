@@ -4,9 +4,11 @@
 #include <torch/csrc/autograd/function.h>
 #include <torch/csrc/autograd/variable.h>
 #include <torch/csrc/autograd/anomaly_mode.h>
+#include <torch/csrc/autograd/grad_mode.h>
 
 #include <ATen/Tensor.h>
 
+#include <atomic>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -14,6 +16,28 @@
 
 namespace torch { namespace autograd {
 
+namespace {
+
+thread_local std::shared_ptr<SavedTensorHooks> saved_tensor_hooks;
+std::atomic<bool> any_saved_tensor_hooks{false};
+
+} // namespace
+
+SavedTensorHooksGuard::SavedTensorHooksGuard(
+    std::shared_ptr<SavedTensorHooks> hooks)
+    : prev_hooks_(std::move(saved_tensor_hooks)) {
+  saved_tensor_hooks = std::move(hooks);
+  any_saved_tensor_hooks.store(true, std::memory_order_relaxed);
+}
+
+SavedTensorHooksGuard::~SavedTensorHooksGuard() {
+  saved_tensor_hooks = std::move(prev_hooks_);
+}
+
+bool saved_tensor_hooks_used() {
+  return any_saved_tensor_hooks.load(std::memory_order_relaxed);
+}
+
 SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_inplace_view) {
   if (variable.defined()) {
     was_default_constructed_ = false;
@@ -24,6 +48,15 @@ SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_i
     // These copies are all shared_ptr copies, so slightly more expensive.
     // Do them here instead of in the init list in case data is undefined.
     data_ = variable.tensor_data();
+    if (saved_tensor_hooks) {
+      // Tensor operations done by the hooks must not be recorded or packed.
+      AutoGradMode grad_mode(false);
+      SavedTensorHooksGuard no_hooks(nullptr);
+      packed_ = saved_tensor_hooks->pack(data_);
+      if (packed_) {
+        data_.reset();
+      }
+    }
     if (variable.is_leaf()) {
       grad_accumulator_ = impl::grad_accumulator(variable);
     } else if (!is_output) {
@@ -37,7 +70,7 @@ SavedVariable::SavedVariable(const Variable& variable, bool is_output, bool is_i
 }
 
 Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
-  if (!data_.defined()) {
+  if (!data_.defined() && !packed_) {
     if (!was_default_constructed_) {
       throw std::runtime_error(ERR_BACKWARD_TWICE);
     }
@@ -54,11 +87,13 @@ Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
     grad_fn = std::move(saved_for);
   }
 
+  const at::Tensor data = packed_ ? packed_->unpack() : data_;
+
   if (saved_version_ != version_counter_.current_version()) {
     std::stringstream message;
     message << "one of the variables needed for gradient computation has been "
-        "modified by an inplace operation: [" << data_.toString() << " "
-        << data_.sizes() << "]";
+        "modified by an inplace operation: [" << data.toString() << " "
+        << data.sizes() << "]";
     if (grad_fn) {
         message << ", which is output " << output_nr_
             << " of " << grad_fn->name() << ",";
@@ -83,9 +118,9 @@ Variable SavedVariable::unpack(std::shared_ptr<Node> saved_for) const {
   // in-place functions on unpacked variables.
   Variable var;
   if (grad_fn) {
-    var = make_variable(data_, Edge(std::move(grad_fn), output_nr_));
+    var = make_variable(data, Edge(std::move(grad_fn), output_nr_));
   } else {
-    var = make_variable(data_, requires_grad_);
+    var = make_variable(data, requires_grad_);
   }
   impl::set_version_counter(var, saved_version_);
 
@@ -14,6 +14,45 @@ struct Node;
 
 TORCH_API extern const char* ERR_BACKWARD_TWICE;
 
+/// The packed form of a saved tensor, as produced by `SavedTensorHooks::pack`.
+struct TORCH_API SavedTensorPack {
+  virtual ~SavedTensorPack() = default;
+
+  /// Returns the saved tensor. Called every time the owning `SavedVariable`
+  /// is unpacked, i.e. more than once if the graph is retained.
+  virtual at::Tensor unpack() = 0;
+
+  /// Called by the engine ahead of `unpack()`, so that an expensive unpack
+  /// (e.g. a copy back to the device) can start early. Can be called from any
+  /// thread, and more than once.
+  virtual void prefetch() {}
+};
+
+/// Lets tensors saved for backward be kept in another form (offloaded to the
+/// host, compressed, ...) until backward needs them. See
+/// torch/csrc/autograd/saved_tensor_hooks.h for the built-in ones.
+struct TORCH_API SavedTensorHooks {
+  virtual ~SavedTensorHooks() = default;
+
+  /// Returns the packed form of `tensor`, or nullptr to save it as is.
+  /// Runs with grad mode disabled and without any hooks installed.
+  virtual std::shared_ptr<SavedTensorPack> pack(const at::Tensor& tensor) = 0;
+};
+
+/// Uses `hooks` for all variables saved on this thread while the guard is
+/// alive. Guards can be nested; a null `hooks` disables packing.
+struct TORCH_API SavedTensorHooksGuard {
+  explicit SavedTensorHooksGuard(std::shared_ptr<SavedTensorHooks> hooks);
+  ~SavedTensorHooksGuard();
+
+ private:
+  std::shared_ptr<SavedTensorHooks> prev_hooks_;
+};
+
+/// True once any `SavedTensorHooksGuard` has been created in this process.
+/// The engine only prefetches saved variables after that.
+TORCH_API bool saved_tensor_hooks_used();
+
 /// A snapshot of a variable at a certain version. A `SavedVariable` stores
 /// enough information to reconstruct a variable from a certain point in time.
 class TORCH_API SavedVariable {
@@ -28,7 +67,15 @@ class TORCH_API SavedVariable {
   /// circular reference.
   Variable unpack(std::shared_ptr<Node> saved_for = nullptr) const;
 
+  /// Starts unpacking a packed variable early, see `SavedTensorPack`.
+  void prefetch() const {
+    if (packed_) {
+      packed_->prefetch();
+    }
+  }
+
   void reset_data() {
+    packed_.reset();
     return data_.reset();
   }
 
@@ -38,6 +85,8 @@ class TORCH_API SavedVariable {
 
  private:
   at::Tensor data_;
+  // Set instead of data_ if the variable was packed by SavedTensorHooks.
+  std::shared_ptr<SavedTensorPack> packed_;
 
   // The gradient function associated with this node. If has_grad_fn
   // is false, then this is a leaf node. Note that the grad_fn is not saved if
@@ -292,6 +292,7 @@ PyObject * THCPModule_memoryStats(PyObject *_unused, PyObject *arg)
   py::dict result;
   result["num_alloc_retries"] = stats.num_alloc_retries;
   result["num_ooms"] = stats.num_ooms;
+  result["num_cache_flushes"] = stats.num_cache_flushes;
   result["allocation"] = statArrayToDict(stats.allocation);
   result["segment"] = statArrayToDict(stats.segment);
   result["active"] = statArrayToDict(stats.active);
@@ -336,15 +337,18 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
     py::dict segmentDict;
     segmentDict["device"] = segmentInfo.device;
     segmentDict["address"] = segmentInfo.address;
+    segmentDict["stream"] = segmentInfo.stream;
     segmentDict["total_size"] = segmentInfo.total_size;
     segmentDict["allocated_size"] = segmentInfo.allocated_size;
     segmentDict["active_size"] = segmentInfo.active_size;
     segmentDict["segment_type"] = (segmentInfo.is_large ? "large" : "small");
+    segmentDict["is_expandable"] = segmentInfo.is_expandable;
 
     py::list blocks;
     for (const auto& blockInfo : segmentInfo.blocks) {
       py::dict blockDict;
       blockDict["size"] = blockInfo.size;
+      blockDict["stream"] = blockInfo.stream;
       blockDict["state"] = (blockInfo.allocated ? "active_allocated" : (blockInfo.active ? "active_pending_free" : "inactive"));
       blocks.append(blockDict);
     }
@@ -364,6 +368,44 @@ PyObject * THCPModule_memorySnapshot(PyObject *_unused, PyObject *noargs)
   END_HANDLE_TH_ERRORS
 }
 
+PyObject * THCPModule_hostMemoryStats(PyObject *_unused, PyObject *noargs)
+{
+  HANDLE_TH_ERRORS
+  const THCCachingHostAllocatorStats stats = THCCachingHostAllocator_getStats();
+
+  py::dict result;
+  result["num_hits"] = stats.num_hits;
+  result["num_misses"] = stats.num_misses;
+  result["allocated_bytes"] = stats.allocated_bytes;
+  result["reserved_bytes"] = stats.reserved_bytes;
+  result["peak_reserved_bytes"] = stats.peak_reserved_bytes;
+  result["num_events_created"] = stats.num_events_created;
+
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject * THCPModule_reserveHostMemory(PyObject *_unused, PyObject *args)
+{
+  HANDLE_TH_ERRORS
+  PyObject* size_o = nullptr;
+  PyObject* count_o = nullptr;
+  if (!PyArg_ParseTuple(args, "OO", &size_o, &count_o) ||
+      !THPUtils_checkLong(size_o) || !THPUtils_checkLong(count_o)) {
+    THPUtils_invalidArguments(args, nullptr, "_cuda_reserveHostMemory", 1, "(int size, int count)");
+    return nullptr;
+  }
+  const int64_t size = THPUtils_unpackLong(size_o);
+  const int64_t count = THPUtils_unpackLong(count_o);
+  THPUtils_assert(size >= 0 && count >= 0, "size and count must be non-negative");
+  {
+    pybind11::gil_scoped_release no_gil;
+    THCudaCheck(THCCachingHostAllocator_reserve(size, count));
+  }
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Cuda module initialization
 ////////////////////////////////////////////////////////////////////////////////
@@ -487,6 +529,8 @@ static struct PyMethodDef _THCPModule_methods[] = {
   {"_cuda_resetPeakMemoryStats", (PyCFunction) THCPModule_resetPeakMemoryStats, METH_O,  nullptr},
   {"_cuda_memorySnapshot", (PyCFunction) THCPModule_memorySnapshot, METH_NOARGS, nullptr},
   {"_cuda_cudaHostAllocator", (PyCFunction)THCPModule_cudaHostAllocator, METH_NOARGS, nullptr},
+  {"_cuda_hostMemoryStats", (PyCFunction) THCPModule_hostMemoryStats, METH_NOARGS, nullptr},
+  {"_cuda_reserveHostMemory", (PyCFunction) THCPModule_reserveHostMemory, METH_VARARGS, nullptr},
   {"_cuda_synchronize", (PyCFunction)THCPModule_cudaSynchronize, METH_NOARGS, nullptr},
   {"_cuda_ipc_collect", (PyCFunction)THCPModule_cudaIPCCollect, METH_NOARGS, nullptr},
   {"_cuda_sleep", (PyCFunction)THCPModule_cudaSleep, METH_O, nullptr},
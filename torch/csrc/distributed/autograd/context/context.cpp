@@ -1,12 +1,31 @@
+#include <array>
 #include <functional>
 
 #include <c10/util/Exception.h>
+#include <torch/csrc/autograd/input_buffer.h>
 #include <torch/csrc/distributed/autograd/context/context.h>
+#include <torch/csrc/distributed/autograd/rpc_messages/propagate_gradients_req.h>
 
 namespace torch {
 namespace distributed {
 namespace autograd {
 
+namespace {
+
+// Gradients must never be accumulated concurrently into the same variable. A
+// small set of striped mutexes keeps unrelated variables from contending with
+// each other.
+constexpr size_t kNumAccumulateGradMutexes = 64;
+std::array<std::mutex, kNumAccumulateGradMutexes> accumulateGradMutexes;
+
+std::mutex& accumulateGradMutex(const torch::autograd::Variable& variable) {
+  return accumulateGradMutexes
+      [std::hash<c10::TensorImpl*>()(variable.unsafeGetTensorImpl()) %
+       kNumAccumulateGradMutexes];
+}
+
+} // namespace
+
 DistAutogradContext::DistAutogradContext(int64_t contextId)
     : contextId_(contextId) {}
 
@@ -67,19 +86,23 @@ void DistAutogradContext::accumulateGrad(
   TORCH_INTERNAL_ASSERT(grad.defined());
   TORCH_INTERNAL_ASSERT(variable.requires_grad());
 
-  std::lock_guard<std::mutex> guard(lock_);
+  std::lock_guard<std::mutex> accumulateGuard(accumulateGradMutex(variable));
+  std::unique_lock<std::mutex> lock(lock_);
   auto it = accumulatedGrads_.find(variable);
   if (it != accumulatedGrads_.end()) {
-    // Accumulate multiple grads on the same variable.
-    it->value().add_(grad);
+    // Accumulate multiple grads on the same variable. Tensors are shared, so
+    // the addition can run without holding the context lock.
+    auto accumulatedGrad = it->value();
+    lock.unlock();
+    accumulatedGrad.add_(grad);
   } else {
+    lock.unlock();
     // First grad for this variable.
-    if (grad.is_sparse()) {
-      accumulatedGrads_.insert(variable, grad.clone());
-    } else {
-      accumulatedGrads_.insert(
-          variable, grad.clone(at::MemoryFormat::Contiguous));
-    }
+    auto accumulatedGrad = grad.is_sparse()
+        ? grad.clone()
+        : grad.clone(at::MemoryFormat::Contiguous);
+    lock.lock();
+    accumulatedGrads_.insert(variable, std::move(accumulatedGrad));
   }
 }
 
@@ -91,16 +114,74 @@ std::shared_ptr<torch::autograd::GraphTask> DistAutogradContext::
 }
 
 void DistAutogradContext::setGraphTask(
-    std::shared_ptr<torch::autograd::GraphTask> graphTask) {
+    std::shared_ptr<torch::autograd::GraphTask> graphTask,
+    std::shared_ptr<torch::autograd::Node> sendPendingGradientsFn) {
   std::lock_guard<std::mutex> guard(lock_);
   TORCH_INTERNAL_ASSERT(
       !graphTask_,
       "Cannot set GraphTask multiple times for the same autograd context");
   graphTask_ = std::move(graphTask);
+  sendPendingGradientsFn_ = std::move(sendPendingGradientsFn);
 }
 
 void DistAutogradContext::resetGraphTask() {
+  std::lock_guard<std::mutex> guard(lock_);
   graphTask_ = nullptr;
+  sendPendingGradientsFn_ = nullptr;
+  // Gradients can only be left over if the backward pass failed.
+  pendingGradients_.clear();
+  sendPendingGradientsQueued_ = false;
+}
+
+void DistAutogradContext::addPendingGradients(
+    rpc::worker_id_t workerId,
+    const AutogradMetadata& autogradMetadata,
+    torch::autograd::variable_list grads) {
+  std::unique_lock<std::mutex> lock(lock_);
+  TORCH_INTERNAL_ASSERT(graphTask_ && sendPendingGradientsFn_);
+  auto& pending = pendingGradients_[workerId];
+  pending.autogradMetadata.push_back(autogradMetadata);
+  pending.grads.push_back(std::move(grads));
+  if (sendPendingGradientsQueued_) {
+    return;
+  }
+  sendPendingGradientsQueued_ = true;
+  auto graphTask = graphTask_;
+  auto sendPendingGradientsFn = sendPendingGradientsFn_;
+  lock.unlock();
+
+  // Count the function as a task of the GraphTask, so that the backward pass
+  // does not complete before the gradients are sent. The 'recv' function that
+  // calls this is still running, so the GraphTask cannot complete meanwhile.
+  graphTask->outstanding_tasks_++;
+  torch::autograd::Engine::get_default_engine().enqueue_blocked_task_on_cpu(
+      torch::autograd::NodeTask(
+          graphTask,
+          std::move(sendPendingGradientsFn),
+          torch::autograd::InputBuffer(0)));
+}
+
+void DistAutogradContext::sendPendingGradients() {
+  std::unique_lock<std::mutex> lock(lock_);
+  auto pendingGradients = std::move(pendingGradients_);
+  pendingGradients_.clear();
+  sendPendingGradientsQueued_ = false;
+  const bool retainGraph = graphTask_->keep_graph_;
+  lock.unlock();
+
+  auto rpcAgent = rpc::RpcAgent::getCurrentRpcAgent();
+  for (auto& entry : pendingGradients) {
+    // Send the gradients over to the appropriate node.
+    PropagateGradientsReq gradCall(
+        std::move(entry.second.autogradMetadata),
+        std::move(entry.second.grads),
+        retainGraph);
+    auto futureMessage = rpcAgent->send(
+        rpcAgent->getWorkerInfo(entry.first), std::move(gradCall).toMessage());
+
+    // Record the future in the context.
+    addOutstandingRpc(futureMessage);
+  }
 }
 
 void DistAutogradContext::addOutstandingRpc(
@@ -4,6 +4,7 @@
 #include <torch/csrc/autograd/engine.h>
 #include <torch/csrc/distributed/autograd/functions/recvrpc_backward.h>
 #include <torch/csrc/distributed/autograd/functions/sendrpc_backward.h>
+#include <torch/csrc/distributed/autograd/rpc_messages/autograd_metadata.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 #include <cstdint>
 
@@ -50,6 +51,10 @@ class TORCH_API DistAutogradContext {
   void addOutstandingRpc(
       const std::shared_ptr<rpc::FutureMessage>& futureMessage);
 
+  // Sends the gradients recorded by addPendingGradients(), one request per
+  // worker.
+  void sendPendingGradients();
+
   // Returns all gradients.
   const c10::Dict<torch::Tensor, torch::Tensor> getGradients() const;
 
@@ -73,7 +78,8 @@ class TORCH_API DistAutogradContext {
   friend class RecvRpcBackward;
 
   // Record that we would like to accumulate the provided gradient on the given
-  // variable.
+  // variable. Gradients for different variables are accumulated concurrently,
+  // ``lock_`` is only held to look up the accumulated gradient.
   void accumulateGrad(
       const torch::autograd::Variable& variable,
       const torch::Tensor& grad);
@@ -82,8 +88,11 @@ class TORCH_API DistAutogradContext {
   std::shared_ptr<torch::autograd::GraphTask> retrieveGraphTask();
 
   // Set the appropriate graph task for the backward pass. Can be called only
-  // once.
-  void setGraphTask(std::shared_ptr<torch::autograd::GraphTask> graphTask);
+  // once. ``sendPendingGradientsFn`` is the function that sends the pending
+  // gradients of this backward pass when run by the local autograd engine.
+  void setGraphTask(
+      std::shared_ptr<torch::autograd::GraphTask> graphTask,
+      std::shared_ptr<torch::autograd::Node> sendPendingGradientsFn);
 
   // Resets the graph task to ensure we can run another distributed backward
   // pass for the same autograd context.
@@ -93,6 +102,27 @@ class TORCH_API DistAutogradContext {
   // outstanding rpcs held in this context. This should be called only once.
   std::shared_ptr<rpc::FutureMessage> clearAndWaitForOutstandingRpcsAsync();
 
+  // Note [Batched Gradient Propagation]
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  //
+  // A 'recv' function does not send its gradients right away. They are
+  // recorded as pending gradients for the worker the RPC came from, and the
+  // first pending gradient queues sendPendingGradientsFn_ in the local
+  // autograd engine. That function has the lowest priority, so it runs once
+  // the engine has run all other functions that are ready at that point, and
+  // sends all pending gradients with one PropagateGradientsReq per worker.
+  // The receiving worker then runs one backward execution for all of them.
+  // It never waits for functions that are not ready yet, as those might
+  // depend on gradients that come back from other workers.
+
+  // Records the gradients that a 'recv' function propagates to ``workerId``,
+  // they are sent by
+  // sendPendingGradients().
+  void addPendingGradients(
+      rpc::worker_id_t workerId,
+      const AutogradMetadata& autogradMetadata,
+      torch::autograd::variable_list grads);
+
   const int64_t contextId_;
 
   // Set containing known worker IDs, used in cleaning up autograd context.
@@ -116,6 +146,20 @@ class TORCH_API DistAutogradContext {
   // The autograd GraphTask for the backward pass on this node for this context.
   std::shared_ptr<torch::autograd::GraphTask> graphTask_;
 
+  // Sends pendingGradients_, see [Batched Gradient Propagation].
+  std::shared_ptr<torch::autograd::Node> sendPendingGradientsFn_;
+
+  struct PendingGradients {
+    std::vector<AutogradMetadata> autogradMetadata;
+    std::vector<torch::autograd::variable_list> grads;
+  };
+
+  // Gradients of 'recv' functions that still need to be sent, per worker.
+  std::unordered_map<rpc::worker_id_t, PendingGradients> pendingGradients_;
+
+  // Whether sendPendingGradientsFn_ is queued in the local autograd engine.
+  bool sendPendingGradientsQueued_{false};
+
   // List of futures for RPCs initiated by this node to propagate gradients to
   // other nodes. The distributed autograd engine on this node can return
   // successfully only if all these futures are done and are successful.
@@ -123,6 +167,10 @@ class TORCH_API DistAutogradContext {
 
   // Lock to protect concurrent modification of the context.
   mutable std::mutex lock_;
+
+  // Serializes setting up and tearing down the backward pass of this context
+  // in DistEngine, without blocking the backward passes of other contexts.
+  std::mutex backwardPassInitLock_;
 };
 
 using ContextPtr = std::shared_ptr<DistAutogradContext>;
@@ -1,3 +1,4 @@
+#include <limits>
 #include <queue>
 
 #include <torch/csrc/autograd/functions/accumulate_grad.h>
@@ -24,6 +25,31 @@ static constexpr char* kEngineCPUQueueSize =
     "local_autograd_engine_cpu_queue_size";
 static constexpr char* kNumAutogradContexts = "num_autograd_contexts";
 
+namespace {
+
+// Sends the pending gradients of 'recv' functions of an autograd context. It
+// has the lowest priority, see [Batched Gradient Propagation].
+class SendPendingGradients : public Node {
+ public:
+  explicit SendPendingGradients(const ContextPtr& autogradContext)
+      : autogradContext_(autogradContext) {
+    set_priority(std::numeric_limits<int64_t>::min());
+  }
+
+  variable_list apply(variable_list&& /* unused */) override {
+    // The context holds this function, so it outlives the backward pass.
+    auto autogradContext = autogradContext_.lock();
+    TORCH_INTERNAL_ASSERT(autogradContext);
+    autogradContext->sendPendingGradients();
+    return variable_list();
+  }
+
+ private:
+  std::weak_ptr<DistAutogradContext> autogradContext_;
+};
+
+} // namespace
+
 DistEngine::DistEngine()
     : initializedContextIds_(), engine_(Engine::get_default_engine()) {}
 
@@ -96,6 +122,9 @@ void DistEngine::computeDependencies(
     queue.push(mapEntry.second.get());
   }
 
+  auto sendPendingGradientsFn =
+      std::make_shared<SendPendingGradients>(autogradContext);
+
   edge_list recvBackwardEdges;
   // Traverse the graph.
   auto& dependencies = graphTask->dependencies_;
@@ -173,10 +202,15 @@ void DistEngine::computeDependencies(
     for (const auto& recvBackwardEdge : recvBackwardEdges) {
       graphTask->exec_info_[recvBackwardEdge.function.get()].needed_ = true;
     }
+
+    // The function sending the gradients of 'RecvRpcBackward' is not part of
+    // the graph, but needs to be executed as well.
+    graphTask->exec_info_[sendPendingGradientsFn.get()].needed_ = true;
   }
 
   // Let autograd context take ownership of the GraphTask.
-  autogradContext->setGraphTask(std::move(graphTask));
+  autogradContext->setGraphTask(
+      std::move(graphTask), std::move(sendPendingGradientsFn));
 }
 
 std::shared_ptr<rpc::FutureMessage> DistEngine::runEngineAndAccumulateGradients(
@@ -227,9 +261,18 @@ std::shared_ptr<rpc::FutureMessage> DistEngine::executeSendFunctionAsync(
     const ContextPtr& autogradContext,
     const std::shared_ptr<Node>& sendFunction,
     bool retainGraph) {
-  std::unique_lock<std::mutex> lock(initializedContextIdsLock_);
-  if (initializedContextIds_.find(autogradContext->contextId()) ==
-      initializedContextIds_.end()) {
+  return executeSendFunctionsAsync(
+      autogradContext, {sendFunction}, retainGraph);
+}
+
+std::shared_ptr<rpc::FutureMessage> DistEngine::executeSendFunctionsAsync(
+    const ContextPtr& autogradContext,
+    const std::vector<std::shared_ptr<Node>>& sendFunctions,
+    bool retainGraph) {
+  // Only the lock of this context is held while computing dependencies, so
+  // send functions of other contexts can run their backward passes meanwhile.
+  std::unique_lock<std::mutex> initLock(autogradContext->backwardPassInitLock_);
+  if (!isInitialized(autogradContext->contextId())) {
     edge_list outputEdges;
     // Pass in a dummy graphRoot since all send functions are the roots.
     auto dummyRoot = std::make_shared<GraphRoot>(edge_list(), variable_list());
@@ -237,13 +280,14 @@ std::shared_ptr<rpc::FutureMessage> DistEngine::executeSendFunctionAsync(
         autogradContext, {}, {}, dummyRoot, outputEdges, retainGraph);
 
     // Mark the autograd context id as initialized and unlock.
-    initializedContextIds_.insert(autogradContext->contextId());
-    lock.unlock();
+    {
+      std::lock_guard<std::mutex> guard(initializedContextIdsLock_);
+      initializedContextIds_.insert(autogradContext->contextId());
+    }
+    initLock.unlock();
 
-    // Enqueue the current send function.
-    auto graphTask = autogradContext->retrieveGraphTask();
-    engine_.enqueue_blocked_task_on_cpu(torch::autograd::NodeTask(
-        graphTask, sendFunction, torch::autograd::InputBuffer(0)));
+    // Enqueue the current send functions.
+    enqueueSendFunctions(autogradContext, sendFunctions);
 
     // Run the autograd engine.
     auto futureGrads = runEngineAndAccumulateGradients(
@@ -289,11 +333,19 @@ std::shared_ptr<rpc::FutureMessage> DistEngine::executeSendFunctionAsync(
     // Return the future which waits for all async processing to be done.
     return callbackFuture;
   } else {
-    lock.unlock();
-    auto graphTask = autogradContext->retrieveGraphTask();
+    initLock.unlock();
+    enqueueSendFunctions(autogradContext, sendFunctions);
+    return std::make_shared<rpc::FutureMessage>(rpc::Message());
+  }
+}
+
+void DistEngine::enqueueSendFunctions(
+    const ContextPtr& autogradContext,
+    const std::vector<std::shared_ptr<Node>>& sendFunctions) {
+  auto graphTask = autogradContext->retrieveGraphTask();
+  for (const auto& sendFunction : sendFunctions) {
     engine_.enqueue_blocked_task_on_cpu(torch::autograd::NodeTask(
         graphTask, sendFunction, torch::autograd::InputBuffer(0)));
-    return std::make_shared<rpc::FutureMessage>(rpc::Message());
   }
 }
 
@@ -313,16 +365,16 @@ void DistEngine::execute(const variable_list& roots, bool retainGraph) {
   // Compute dependencies locally, starting from all roots and all 'send'
   // functions.
   {
-    std::lock_guard<std::mutex> guard(initializedContextIdsLock_);
+    std::lock_guard<std::mutex> initGuard(
+        autogradContext->backwardPassInitLock_);
     // Context should not have been initialized already.
-    TORCH_INTERNAL_ASSERT(
-        initializedContextIds_.find(autogradContext->contextId()) ==
-        initializedContextIds_.end());
+    TORCH_INTERNAL_ASSERT(!isInitialized(autogradContext->contextId()));
 
     computeDependencies(
         autogradContext, rootEdges, grads, graphRoot, outputEdges, retainGraph);
 
     // Mark the autograd context id as initialized.
+    std::lock_guard<std::mutex> guard(initializedContextIdsLock_);
     initializedContextIds_.insert(autogradContext->contextId());
   }
 
@@ -338,6 +390,10 @@ void DistEngine::execute(const variable_list& roots, bool retainGraph) {
 }
 
 void DistEngine::cleanupBackwardPass(const ContextPtr& autogradContext) {
+  // A send function that arrives now either sees the old backward pass with
+  // its GraphTask, or starts a new one.
+  std::lock_guard<std::mutex> initGuard(autogradContext->backwardPassInitLock_);
+
   // Reset the graph task once we're done with all processing.
   autogradContext->resetGraphTask();
 
@@ -347,6 +403,11 @@ void DistEngine::cleanupBackwardPass(const ContextPtr& autogradContext) {
   initializedContextIds_.erase(autogradContext->contextId());
 }
 
+bool DistEngine::isInitialized(int64_t contextId) const {
+  std::lock_guard<std::mutex> guard(initializedContextIdsLock_);
+  return initializedContextIds_.find(contextId) != initializedContextIds_.end();
+}
+
 size_t DistEngine::numBackwardPasses() const {
   std::lock_guard<std::mutex> guard(initializedContextIdsLock_);
   return initializedContextIds_.size();
@@ -24,6 +24,11 @@ class BackwardPassCleanupGuard;
 // Unlike the vanilla autograd engine, the distributed autograd engine
 // accumulates the gradients in the appropriate DistAutogradContext. This avoids
 // multiple trainer nodes stomping on each others gradients.
+
+// Backward passes of different autograd contexts are independent: they only
+// share the threads of the local autograd engine, so they run concurrently
+// when the engine uses several CPU threads (see
+// Engine::set_num_cpu_threads).
 class TORCH_API DistEngine {
  public:
   // Retrieve the singleton instance.
@@ -46,6 +51,14 @@ class TORCH_API DistEngine {
       const std::shared_ptr<torch::autograd::Node>& sendFunction,
       bool retainGraph);
 
+  // Same as executeSendFunctionAsync, for all send functions that got their
+  // gradients in the same request (see [Batched Gradient Propagation]). They
+  // are run by a single backward execution of the autograd context.
+  std::shared_ptr<rpc::FutureMessage> executeSendFunctionsAsync(
+      const ContextPtr& autogradContext,
+      const std::vector<std::shared_ptr<torch::autograd::Node>>& sendFunctions,
+      bool retainGraph);
+
   // Number of backward passes currently running for the Distributed Engine.
   size_t numBackwardPasses() const;
 
@@ -93,11 +106,22 @@ class TORCH_API DistEngine {
       const std::shared_ptr<torch::autograd::Node>& graphRoot,
       const torch::autograd::edge_list& outputEdges);
 
+  // Enqueues the given send functions in the local autograd engine, for the
+  // GraphTask of the autograd context.
+  void enqueueSendFunctions(
+      const ContextPtr& autogradContext,
+      const std::vector<std::shared_ptr<torch::autograd::Node>>& sendFunctions);
+
   // Run after the backward pass is done to appropriately cleanup structures.
   void cleanupBackwardPass(const ContextPtr& autogradContext);
 
+  // Whether the backward pass of the given context has been initialized.
+  bool isInitialized(int64_t contextId) const;
+
   // Set of autograd context_ids, which we have already initialized for
-  // distributed autograd on this node (e.g.: already computed dependencies)
+  // distributed autograd on this node (e.g.: already computed dependencies).
+  // Initializing a context is serialized by its backwardPassInitLock_,
+  // initializedContextIdsLock_ only protects the set itself.
   std::unordered_set<int64_t> initializedContextIds_;
 
   mutable std::mutex initializedContextIdsLock_;
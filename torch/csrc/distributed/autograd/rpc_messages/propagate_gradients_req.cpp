@@ -13,20 +13,37 @@ PropagateGradientsReq::PropagateGradientsReq(
     const AutogradMetadata& autogradMetadata,
     std::vector<Variable> grads,
     bool retainGraph)
-    : autogradMetadata_(autogradMetadata),
+    : PropagateGradientsReq(
+          std::vector<AutogradMetadata>{autogradMetadata},
+          std::vector<std::vector<Variable>>{std::move(grads)},
+          retainGraph) {}
+
+PropagateGradientsReq::PropagateGradientsReq(
+    std::vector<AutogradMetadata> autogradMetadata,
+    std::vector<std::vector<Variable>> grads,
+    bool retainGraph)
+    : autogradMetadata_(std::move(autogradMetadata)),
       grads_(std::move(grads)),
-      retainGraph_(retainGraph) {}
+      retainGraph_(retainGraph) {
+  TORCH_INTERNAL_ASSERT(autogradMetadata_.size() == grads_.size());
+}
 
 Message PropagateGradientsReq::toMessage() && {
   std::vector<at::IValue> ivalues;
   // Add all the grad tensors.
-  for (const auto& grad : grads_) {
-    ivalues.emplace_back(grad);
+  for (const auto& grads : grads_) {
+    for (const auto& grad : grads) {
+      ivalues.emplace_back(grad);
+    }
   }
 
-  // Now add autograd metadata.
-  ivalues.emplace_back(autogradMetadata_.autogradContextId);
-  ivalues.emplace_back(autogradMetadata_.autogradMessageId);
+  // Now add autograd metadata and the number of grads for every entry.
+  for (size_t i = 0; i < autogradMetadata_.size(); i++) {
+    ivalues.emplace_back(autogradMetadata_[i].autogradContextId);
+    ivalues.emplace_back(autogradMetadata_[i].autogradMessageId);
+    ivalues.emplace_back((int64_t)grads_[i].size());
+  }
+  ivalues.emplace_back((int64_t)autogradMetadata_.size());
 
   // Add retain graph.
   ivalues.emplace_back(retainGraph_);
@@ -52,37 +69,55 @@ std::unique_ptr<PropagateGradientsReq> PropagateGradientsReq::fromMessage(
   std::vector<at::IValue> tupleElements = tuple.toTuple()->elements();
 
   // Build PropagateGradientsReq.
-  TORCH_INTERNAL_ASSERT(tupleElements.size() >= 3);
+  TORCH_INTERNAL_ASSERT(tupleElements.size() >= 2);
 
   // Retrieve retainGraph.
   bool retainGraph = tupleElements.back().toBool();
   tupleElements.pop_back();
 
-  // Build AutogradMetadata.
-  int64_t autogradContextId, autogradMessageId;
-  autogradMessageId = tupleElements.back().toInt();
-  tupleElements.pop_back();
-  autogradContextId = tupleElements.back().toInt();
+  // Retrieve the number of entries.
+  const auto numEntries = tupleElements.back().toInt();
   tupleElements.pop_back();
-
-  AutogradMetadata autogradMetadata(autogradContextId, autogradMessageId);
+  TORCH_INTERNAL_ASSERT(
+      numEntries >= 0 && tupleElements.size() >= 3 * (size_t)numEntries);
+
+  // Build AutogradMetadata and retrieve the number of grads of every entry.
+  const size_t metadataOffset = tupleElements.size() - 3 * numEntries;
+  std::vector<AutogradMetadata> autogradMetadata;
+  std::vector<size_t> numGrads;
+  autogradMetadata.reserve(numEntries);
+  numGrads.reserve(numEntries);
+  size_t totalNumGrads = 0;
+  for (int64_t i = 0; i < numEntries; i++) {
+    const auto offset = metadataOffset + 3 * i;
+    autogradMetadata.emplace_back(
+        tupleElements[offset].toInt(), tupleElements[offset + 1].toInt());
+    numGrads.push_back(tupleElements[offset + 2].toInt());
+    totalNumGrads += numGrads.back();
+  }
+  TORCH_INTERNAL_ASSERT(totalNumGrads == metadataOffset);
 
   // Retrieve the gradient tensors.
-  std::vector<Variable> grads(tupleElements.size());
-  for (size_t i = 0; i < tupleElements.size(); i++) {
-    grads[i] = tupleElements[i].toTensor();
+  std::vector<std::vector<Variable>> grads(numEntries);
+  size_t gradOffset = 0;
+  for (int64_t i = 0; i < numEntries; i++) {
+    grads[i].reserve(numGrads[i]);
+    for (size_t j = 0; j < numGrads[i]; j++) {
+      grads[i].push_back(tupleElements[gradOffset++].toTensor());
+    }
   }
 
-  return std::unique_ptr<PropagateGradientsReq>(
-      new PropagateGradientsReq(autogradMetadata, grads, retainGraph));
+  return std::unique_ptr<PropagateGradientsReq>(new PropagateGradientsReq(
+      std::move(autogradMetadata), std::move(grads), retainGraph));
 }
 
-const AutogradMetadata& PropagateGradientsReq::getAutogradMetadata() {
+const std::vector<AutogradMetadata>& PropagateGradientsReq::
+    getAutogradMetadata() {
   return autogradMetadata_;
 }
 
-const std::vector<torch::autograd::Variable>& PropagateGradientsReq::
-    getGrads() {
+const std::vector<std::vector<torch::autograd::Variable>>&
+PropagateGradientsReq::getGrads() {
   return grads_;
 }
 
@@ -11,7 +11,9 @@ namespace autograd {
 
 // Used to propagate gradients from one node to another during a distributed
 // backwards pass. This RPC call is invoked when we hit a `recv` autograd
-// function during backward pass execution.
+// function during backward pass execution. The gradients of several `recv`
+// functions of the same autograd context that are headed for the same node are
+// batched into one request.
 class TORCH_API PropagateGradientsReq : public rpc::RpcCommandBase {
  public:
   PropagateGradientsReq(
@@ -19,9 +21,15 @@ class TORCH_API PropagateGradientsReq : public rpc::RpcCommandBase {
       std::vector<torch::autograd::Variable> grads,
       bool retainGraph = false);
 
-  const AutogradMetadata& getAutogradMetadata();
+  // One entry of autogradMetadata and grads for every `recv` function.
+  PropagateGradientsReq(
+      std::vector<AutogradMetadata> autogradMetadata,
+      std::vector<std::vector<torch::autograd::Variable>> grads,
+      bool retainGraph = false);
+
+  const std::vector<AutogradMetadata>& getAutogradMetadata();
 
-  const std::vector<torch::autograd::Variable>& getGrads();
+  const std::vector<std::vector<torch::autograd::Variable>>& getGrads();
 
   // Serialization and deserialization methods.
   rpc::Message toMessage() && override;
@@ -32,8 +40,8 @@ class TORCH_API PropagateGradientsReq : public rpc::RpcCommandBase {
   bool retainGraph();
 
  private:
-  AutogradMetadata autogradMetadata_;
-  std::vector<torch::autograd::Variable> grads_;
+  std::vector<AutogradMetadata> autogradMetadata_;
+  std::vector<std::vector<torch::autograd::Variable>> grads_;
   bool retainGraph_;
 };
 
@@ -1,7 +1,9 @@
 #include <torch/csrc/distributed/c10d/comm.h>
 
+#include <algorithm>
 #include <deque>
 
+#include <ATen/CPUGenerator.h>
 #include <ATen/core/functional.h>
 #include <torch/csrc/distributed/c10d/reducer.h>
 #include <torch/csrc/utils/tensor_flatten.h>
@@ -79,4 +81,503 @@ void broadcast_coalesced(
   }
 }
 
+PersistentBroadcast::PersistentBroadcast(
+    std::shared_ptr<ProcessGroup> process_group,
+    std::vector<at::Tensor> tensors,
+    size_t buffer_size)
+    : process_group_(std::move(process_group)), tensors_(std::move(tensors)) {
+  const auto bucket_indices =
+      compute_bucket_assignment_by_size(tensors_, {buffer_size});
+  buckets_.reserve(bucket_indices.size());
+  for (const auto& indices : bucket_indices) {
+    Bucket bucket;
+    int64_t numel = 0;
+    for (const auto index : indices) {
+      TORCH_CHECK(
+          !tensors_[index].is_sparse(),
+          "PersistentBroadcast only supports dense tensors.");
+      numel += tensors_[index].numel();
+    }
+    bucket.contents =
+        at::empty({numel}, tensors_[indices.front()].options());
+
+    // The views are created below autograd, like the bucket views of the
+    // Reducer, so that they don't become (differentiable) views of contents.
+    at::AutoNonVariableTypeMode non_var_guard;
+    int64_t offset = 0;
+    for (const auto index : indices) {
+      const auto& tensor = tensors_[index];
+      bucket.views.push_back(
+          bucket.contents.narrow(0, offset, tensor.numel())
+              .view(tensor.sizes()));
+      offset += tensor.numel();
+    }
+    bucket.tensor_indices = indices;
+    buckets_.push_back(std::move(bucket));
+  }
+
+  for (const auto& bucket : buckets_) {
+    for (size_t i = 0; i < bucket.tensor_indices.size(); i++) {
+      bind(bucket.tensor_indices[i], bucket.views[i]);
+    }
+  }
+}
+
+bool PersistentBroadcast::bind(size_t index, const at::Tensor& view) {
+  auto& tensor = tensors_[index];
+  if (tensor.data_ptr() == view.data_ptr() &&
+      tensor.sizes() == view.sizes() && tensor.strides() == view.strides()) {
+    return true;
+  }
+  TORCH_CHECK(
+      tensor.sizes() == view.sizes() &&
+          tensor.options().type_equal(view.options()),
+      "PersistentBroadcast: a broadcast tensor changed its size, type or "
+      "device from ",
+      view.toString(),
+      view.sizes(),
+      " to ",
+      tensor.toString(),
+      tensor.sizes());
+  at::AutoNonVariableTypeMode non_var_guard;
+  view.copy_(tensor);
+  if (!tensor.is_contiguous()) {
+    return false;
+  }
+  // Make the tensor itself share the storage of the bucket. It is the same
+  // TensorImpl as the one the caller holds, so e.g. the tensor registered as
+  // a module buffer becomes the view.
+  tensor.set_(
+      view.storage(), view.storage_offset(), view.sizes(), view.strides());
+  return true;
+}
+
+void PersistentBroadcast::run() {
+  // The tensors that can't view their bucket and get their result copied.
+  std::vector<std::pair<size_t, at::Tensor>> copy_back;
+  // The bucket contents, each in its own vector because
+  // c10d::ProcessGroup::broadcast takes a vector argument, which has to stay
+  // alive until the work is done.
+  std::vector<std::vector<at::Tensor>> inputs;
+  std::vector<std::shared_ptr<ProcessGroup::Work>> works;
+  inputs.reserve(buckets_.size());
+  works.reserve(buckets_.size());
+  for (auto& bucket : buckets_) {
+    for (size_t i = 0; i < bucket.tensor_indices.size(); i++) {
+      if (!bind(bucket.tensor_indices[i], bucket.views[i])) {
+        copy_back.emplace_back(bucket.tensor_indices[i], bucket.views[i]);
+      }
+    }
+    // No memory beyond the bucket contents is used, so all the broadcasts can
+    // be in flight at once.
+    inputs.push_back({bucket.contents});
+    works.push_back(process_group_->broadcast(inputs.back()));
+  }
+  for (auto& work : works) {
+    work->wait();
+  }
+
+  at::AutoNonVariableTypeMode non_var_guard;
+  for (auto& entry : copy_back) {
+    tensors_[entry.first].copy_(entry.second);
+  }
+}
+
+ChainedWork::ChainedWork(
+    std::shared_ptr<ProcessGroup::Work> work,
+    std::function<std::vector<at::Tensor>()> then)
+    : work_(std::move(work)), then_(std::move(then)) {}
+
+bool ChainedWork::wait() {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (completed_) {
+      if (exception_) {
+        std::rethrow_exception(exception_);
+      }
+      return true;
+    }
+  }
+  try {
+    work_->wait();
+    result_ = then_();
+  } catch (...) {
+    finish(std::current_exception());
+    throw;
+  }
+  finish();
+  return true;
+}
+
+std::vector<at::Tensor> ChainedWork::result() const {
+  return result_;
+}
+
+namespace {
+
+// Number of elements of every index of a sparse tensor, i.e. of every slice
+// of its values.
+int64_t sparse_row_numel(const at::Tensor& tensor) {
+  int64_t numel = 1;
+  for (int64_t dim = tensor.sparse_dim(); dim < tensor.dim(); dim++) {
+    numel *= tensor.size(dim);
+  }
+  return numel;
+}
+
+// Gathers `input`, zero padded to `length` elements, from all processes.
+std::shared_ptr<ProcessGroup::Work> allgather_padded(
+    const std::shared_ptr<ProcessGroup>& process_group,
+    const at::Tensor& input,
+    int64_t length,
+    std::vector<at::Tensor>& outputs) {
+  std::vector<at::Tensor> inputs = {at::zeros({length}, input.options())};
+  inputs[0].narrow(0, 0, input.numel()).copy_(input);
+  std::vector<std::vector<at::Tensor>> output_lists(1);
+  for (int64_t i = 0; i < process_group->getSize(); i++) {
+    output_lists[0].push_back(at::empty({length}, input.options()));
+  }
+  outputs = output_lists[0];
+  return process_group->allgather(output_lists, inputs);
+}
+
+} // namespace
+
+std::shared_ptr<ProcessGroup::Work> allreduce_sparse_coalesced(
+    const std::shared_ptr<ProcessGroup>& process_group,
+    std::vector<at::Tensor> tensors,
+    double densify_threshold) {
+  TORCH_CHECK(!tensors.empty(), "Expected at least one tensor.");
+  const auto scalar_type = tensors.front().scalar_type();
+  const auto device = tensors.front().device();
+  std::vector<int64_t> nnz;
+  nnz.reserve(tensors.size());
+  for (auto& tensor : tensors) {
+    TORCH_CHECK(tensor.is_sparse(), "Expected sparse tensors.");
+    TORCH_CHECK(
+        tensor.scalar_type() == scalar_type && tensor.device() == device,
+        "Expected sparse tensors of the same dtype, on the same device.");
+    tensor = tensor.coalesce();
+    nnz.push_back(tensor._nnz());
+  }
+
+  const auto index_options = at::TensorOptions().dtype(at::kLong).device(device);
+  std::vector<at::Tensor> local_nnz = {
+      at::tensor(nnz, at::kLong).to(index_options.device())};
+  std::vector<std::vector<at::Tensor>> all_nnz(1);
+  for (int64_t i = 0; i < process_group->getSize(); i++) {
+    all_nnz[0].push_back(at::empty_like(local_nnz[0]));
+  }
+  auto work = process_group->allgather(all_nnz, local_nnz);
+
+  return std::make_shared<ChainedWork>(
+      std::move(work),
+      [process_group, tensors, densify_threshold, all_nnz, index_options]() {
+        const auto world_size = process_group->getSize();
+        const auto tensor_count = tensors.size();
+        const auto nnz = at::stack(all_nnz[0]).cpu();
+        const auto nnz_accessor = nnz.accessor<int64_t, 2>();
+
+        // The nonzeros of all processes are known, so every process takes
+        // the same decision for every tensor.
+        std::vector<bool> densify(tensor_count, false);
+        for (size_t i = 0; i < tensor_count; i++) {
+          const auto numel = tensors[i].numel();
+          int64_t total_nnz = 0;
+          for (int64_t rank = 0; rank < world_size; rank++) {
+            total_nnz += nnz_accessor[rank][i];
+          }
+          densify[i] = numel > 0 &&
+              static_cast<double>(total_nnz) * sparse_row_numel(tensors[i]) >
+                  densify_threshold * numel;
+        }
+
+        // Gather the indices and values of the sparse tensors, padded to the
+        // longest ones of any process.
+        int64_t indices_length = 0;
+        int64_t values_length = 0;
+        for (int64_t rank = 0; rank < world_size; rank++) {
+          int64_t rank_indices_length = 0;
+          int64_t rank_values_length = 0;
+          for (size_t i = 0; i < tensor_count; i++) {
+            if (!densify[i]) {
+              rank_indices_length +=
+                  nnz_accessor[rank][i] * tensors[i].sparse_dim();
+              rank_values_length +=
+                  nnz_accessor[rank][i] * sparse_row_numel(tensors[i]);
+            }
+          }
+          indices_length = std::max(indices_length, rank_indices_length);
+          values_length = std::max(values_length, rank_values_length);
+        }
+        std::vector<at::Tensor> local_indices;
+        std::vector<at::Tensor> local_values;
+        std::vector<at::Tensor> dense;
+        for (size_t i = 0; i < tensor_count; i++) {
+          if (densify[i]) {
+            dense.push_back(tensors[i].to_dense());
+          } else {
+            local_indices.push_back(tensors[i]._indices().reshape({-1}));
+            local_values.push_back(tensors[i]._values().reshape({-1}));
+          }
+        }
+        std::vector<std::shared_ptr<ProcessGroup::Work>> works;
+        std::vector<at::Tensor> all_indices(
+            world_size, at::empty({0}, index_options));
+        std::vector<at::Tensor> all_values(
+            world_size, at::empty({0}, tensors.front()._values().options()));
+        if (indices_length > 0) {
+          works.push_back(allgather_padded(
+              process_group,
+              at::cat(local_indices),
+              indices_length,
+              all_indices));
+        }
+        if (values_length > 0) {
+          works.push_back(allgather_padded(
+              process_group,
+              at::cat(local_values),
+              values_length,
+              all_values));
+        }
+        std::vector<at::Tensor> flat_dense;
+        if (!dense.empty()) {
+          flat_dense = {torch::utils::flatten_dense_tensors(dense)};
+          works.push_back(process_group->allreduce(flat_dense));
+        }
+        for (auto& pending : works) {
+          pending->wait();
+        }
+
+        std::vector<at::Tensor> result;
+        result.reserve(tensor_count);
+        std::vector<int64_t> indices_offsets(world_size, 0);
+        std::vector<int64_t> values_offsets(world_size, 0);
+        size_t dense_index = 0;
+        if (!dense.empty()) {
+          dense = torch::utils::unflatten_dense_tensors(flat_dense[0], dense);
+        }
+        for (size_t i = 0; i < tensor_count; i++) {
+          const auto& tensor = tensors[i];
+          if (densify[i]) {
+            result.push_back(dense[dense_index++].to_sparse(tensor.sparse_dim()));
+            continue;
+          }
+          const auto sparse_dim = tensor.sparse_dim();
+          const auto row_numel = sparse_row_numel(tensor);
+          auto values_sizes = tensor._values().sizes().vec();
+          std::vector<at::Tensor> indices;
+          std::vector<at::Tensor> values;
+          for (int64_t rank = 0; rank < world_size; rank++) {
+            const auto rank_nnz = nnz_accessor[rank][i];
+            values_sizes[0] = rank_nnz;
+            indices.push_back(
+                all_indices[rank]
+                    .narrow(0, indices_offsets[rank], rank_nnz * sparse_dim)
+                    .view({sparse_dim, rank_nnz}));
+            values.push_back(
+                all_values[rank]
+                    .narrow(0, values_offsets[rank], rank_nnz * row_numel)
+                    .view(values_sizes));
+            indices_offsets[rank] += rank_nnz * sparse_dim;
+            values_offsets[rank] += rank_nnz * row_numel;
+          }
+          result.push_back(at::_sparse_coo_tensor_unsafe(
+                               at::cat(indices, 1),
+                               at::cat(values),
+                               tensor.sizes(),
+                               tensor.options())
+                               .coalesce());
+        }
+        return result;
+      });
+}
+
+FP16CompressCommHook::FP16CompressCommHook(
+    std::shared_ptr<ProcessGroup> process_group)
+    : process_group_(std::move(process_group)) {}
+
+std::shared_ptr<ProcessGroup::Work> FP16CompressCommHook::runHook(
+    GradBucket& bucket) {
+  std::vector<at::Tensor> compressed;
+  compressed.reserve(bucket.tensors.size());
+  for (const auto& tensor : bucket.tensors) {
+    compressed.push_back(tensor.to(at::kHalf));
+  }
+  auto work = process_group_->allreduce(compressed);
+  auto tensors = bucket.tensors;
+  return std::make_shared<ChainedWork>(
+      std::move(work), [compressed, tensors]() {
+        for (size_t i = 0; i < tensors.size(); i++) {
+          tensors[i].copy_(compressed[i]);
+        }
+        return tensors;
+      });
+}
+
+ReduceScatterCommHook::ReduceScatterCommHook(
+    std::shared_ptr<ProcessGroup> process_group)
+    : process_group_(std::move(process_group)) {}
+
+std::shared_ptr<ProcessGroup::Work> ReduceScatterCommHook::runHook(
+    GradBucket& bucket) {
+  TORCH_CHECK(
+      bucket.tensors.size() == 1,
+      "ReduceScatterCommHook only supports a single model replica.");
+  const auto flat = bucket.tensors[0];
+  const int64_t world_size = process_group_->getSize();
+  const int64_t rank = process_group_->getRank();
+  const auto shard_size = (flat.numel() + world_size - 1) / world_size;
+
+  auto padded = at::zeros({shard_size * world_size}, flat.options());
+  padded.narrow(0, 0, flat.numel()).copy_(flat);
+  std::vector<std::vector<at::Tensor>> inputs(1);
+  inputs[0].reserve(world_size);
+  for (int64_t i = 0; i < world_size; i++) {
+    inputs[0].push_back(padded.narrow(0, i * shard_size, shard_size));
+  }
+  std::vector<at::Tensor> outputs = {
+      at::empty({shard_size}, flat.options())};
+  auto work = process_group_->reduce_scatter(outputs, inputs);
+
+  return std::make_shared<ChainedWork>(
+      std::move(work), [flat, outputs, rank, shard_size]() {
+        // The last shards can be partially or entirely padding.
+        const auto begin = std::min(rank * shard_size, flat.numel());
+        const auto end = std::min(begin + shard_size, flat.numel());
+        flat.zero_();
+        flat.narrow(0, begin, end - begin)
+            .copy_(outputs.front().narrow(0, 0, end - begin));
+        return std::vector<at::Tensor>{flat};
+      });
+}
+
+PowerSGDCommHook::PowerSGDCommHook(
+    std::shared_ptr<ProcessGroup> process_group,
+    int64_t matrix_approximation_rank)
+    : process_group_(std::move(process_group)),
+      matrix_approximation_rank_(matrix_approximation_rank) {
+  TORCH_CHECK(
+      matrix_approximation_rank_ >= 1,
+      "PowerSGD needs a matrix approximation rank of at least 1.");
+}
+
+namespace {
+
+// Orthonormalizes the columns of matrix in place with Gram-Schmidt.
+void orthogonalize(at::Tensor& matrix) {
+  const auto num_cols = matrix.size(1);
+  for (int64_t i = 0; i < num_cols; i++) {
+    auto col = matrix.narrow(1, i, 1);
+    if (i > 0) {
+      auto rest = matrix.narrow(1, 0, i);
+      col.sub_(rest.mm(rest.t().mm(col)));
+    }
+    col.div_(col.norm().add_(1e-8));
+  }
+}
+
+} // namespace
+
+std::shared_ptr<ProcessGroup::Work> PowerSGDCommHook::runHook(
+    GradBucket& bucket) {
+  TORCH_CHECK(
+      bucket.tensors.size() == 1,
+      "PowerSGDCommHook only supports a single model replica.");
+  const auto flat = bucket.tensors[0];
+  const auto world_size = process_group_->getSize();
+  const auto variable_count = bucket.sizes.size();
+  auto& states = states_[bucket.index];
+  if (states.size() != variable_count) {
+    states.clear();
+    states.resize(variable_count);
+  }
+
+  // The gradients that are sent as they are, and the matrices that are sent
+  // compressed together with their index in the bucket.
+  std::vector<at::Tensor> uncompressed;
+  std::vector<at::Tensor> matrices;
+  std::vector<size_t> matrix_indices;
+  std::vector<at::Tensor> ps;
+  for (size_t i = 0; i < variable_count; i++) {
+    auto grad = flat.narrow(0, bucket.offsets[i], bucket.lengths[i]);
+    const auto& sizes = bucket.sizes[i];
+    const int64_t n = sizes.size() >= 2 ? sizes[0] : 0;
+    const int64_t m = n > 0 ? bucket.lengths[i] / n : 0;
+    const int64_t rank =
+        std::min(matrix_approximation_rank_, std::min(n, m));
+    // Compression only pays off if the factors are smaller than the matrix.
+    if (n == 0 || (n + m) * rank >= n * m) {
+      uncompressed.push_back(grad);
+      continue;
+    }
+
+    auto matrix = grad.view({n, m});
+    auto& state = states[i];
+    if (!state.q.defined() || state.q.size(0) != m ||
+        state.q.size(1) != rank || state.error.size(0) != n) {
+      // Every process has to start from the same Q.
+      auto generator = at::detail::createCPUGenerator(/*seed_val=*/0);
+      state.q = at::randn({m, rank}, generator.get(), matrix.options().device(at::kCPU))
+                    .to(matrix.device());
+      state.error = at::zeros_like(matrix);
+    }
+
+    // Error feedback: add what the previous approximation missed. The error
+    // is kept in the scale of the undivided gradient.
+    matrix.add_(state.error, 1.0 / world_size);
+    // Warm start from the previous Q.
+    ps.push_back(matrix.mm(state.q));
+    matrices.push_back(matrix);
+    matrix_indices.push_back(i);
+  }
+
+  // First round: the uncompressed gradients and the P factors.
+  std::vector<at::Tensor> first_inputs(uncompressed);
+  first_inputs.insert(first_inputs.end(), ps.begin(), ps.end());
+  std::vector<at::Tensor> first_flat = {
+      torch::utils::flatten_dense_tensors(first_inputs)};
+  auto work = process_group_->allreduce(first_flat);
+
+  auto process_group = process_group_;
+  return std::make_shared<ChainedWork>(
+      std::move(work),
+      [this, process_group, flat, world_size, first_flat, first_inputs,
+       uncompressed, matrices, matrix_indices, index = bucket.index]() {
+        auto first_outputs = torch::utils::unflatten_dense_tensors(
+            first_flat.front(), first_inputs);
+        for (size_t i = 0; i < uncompressed.size(); i++) {
+          uncompressed[i].copy_(first_outputs[i]);
+        }
+        if (matrices.empty()) {
+          return std::vector<at::Tensor>{flat};
+        }
+
+        // Second round: Q = M^T P for the orthonormalized P.
+        std::vector<at::Tensor> ps;
+        std::vector<at::Tensor> qs;
+        for (size_t i = 0; i < matrices.size(); i++) {
+          auto p = first_outputs[uncompressed.size() + i].clone();
+          orthogonalize(p);
+          qs.push_back(matrices[i].t().mm(p));
+          ps.push_back(std::move(p));
+        }
+        std::vector<at::Tensor> q_flat = {
+            torch::utils::flatten_dense_tensors(qs)};
+        process_group->allreduce(q_flat)->wait();
+        auto q_outputs =
+            torch::utils::unflatten_dense_tensors(q_flat.front(), qs);
+
+        auto& states = states_[index];
+        for (size_t i = 0; i < matrices.size(); i++) {
+          auto& state = states[matrix_indices[i]];
+          state.q.copy_(q_outputs[i]);
+          auto approximation = ps[i].mm(q_outputs[i].t());
+          state.error = matrices[i].mul(world_size).sub_(approximation);
+          matrices[i].copy_(approximation);
+        }
+        return std::vector<at::Tensor>{flat};
+      });
+}
+
 } // namespace c10d
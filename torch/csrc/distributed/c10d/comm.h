@@ -1,6 +1,10 @@
 #pragma once
 
+#include <functional>
+#include <limits>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include <ATen/ATen.h>
 #include <c10d/ProcessGroup.hpp>
@@ -13,4 +17,160 @@ void broadcast_coalesced(
     at::TensorList tensors,
     size_t buffer_size);
 
+// Broadcasts the same tensors from rank 0 over and over, e.g. the buffers of
+// a model on every iteration. The tensors are bucketed like in
+// broadcast_coalesced, but every tensor is turned into a view of a flat
+// tensor that is kept per bucket, so that a broadcast runs directly on the
+// flat tensors, without flattening and unflattening the tensors. A tensor
+// that no longer views its bucket, e.g. because its data was replaced, is
+// copied into the bucket and, if it is contiguous, made a view of it again;
+// otherwise its contents are copied back after the broadcast.
+class PersistentBroadcast {
+ public:
+  PersistentBroadcast(
+      std::shared_ptr<ProcessGroup> process_group,
+      std::vector<at::Tensor> tensors,
+      size_t buffer_size);
+
+  void run();
+
+ private:
+  struct Bucket {
+    // The flat tensor that is broadcast.
+    at::Tensor contents;
+    // The indices of the tensors of the bucket, and their views of contents.
+    std::vector<size_t> tensor_indices;
+    std::vector<at::Tensor> views;
+  };
+
+  // Makes sure that the tensor at `index` holds the same data as `view`
+  // before the broadcast. Returns false if the tensor can't view the bucket
+  // and the result has to be copied back.
+  bool bind(size_t index, const at::Tensor& view);
+
+  std::shared_ptr<ProcessGroup> process_group_;
+  std::vector<at::Tensor> tensors_;
+  std::vector<Bucket> buckets_;
+};
+
+// A bucket of dense gradients, as handed to a communication hook by the
+// Reducer. It holds one flat tensor per model replica; the gradient of every
+// variable in the bucket occupies `lengths[i]` elements at `offsets[i]` of it
+// and has shape `sizes[i]`.
+struct GradBucket {
+  size_t index;
+  std::vector<at::Tensor> tensors;
+  std::vector<size_t> offsets;
+  std::vector<size_t> lengths;
+  std::vector<std::vector<int64_t>> sizes;
+};
+
+// Replaces the allreduce that the Reducer runs for every dense bucket, e.g.
+// to compress gradients before sending them. The tensors of the bucket are
+// already divided by the process group size, so the hook has to compute (an
+// approximation of) their sum across processes.
+class CommHookInterface {
+ public:
+  virtual ~CommHookInterface() = default;
+
+  // Starts the communication for a bucket. The Reducer waits on the returned
+  // work before it unflattens the bucket; its result() must then be one
+  // tensor per model replica with the reduced contents of the bucket (which
+  // may be the bucket tensors themselves, if reduced in place).
+  virtual std::shared_ptr<ProcessGroup::Work> runHook(GradBucket& bucket) = 0;
+};
+
+// Work that waits on another one and then computes its result with `then`,
+// on the thread that waits on it. Lets communication hooks decompress or run
+// further communication once their first collective has finished.
+class ChainedWork : public ProcessGroup::Work {
+ public:
+  ChainedWork(
+      std::shared_ptr<ProcessGroup::Work> work,
+      std::function<std::vector<at::Tensor>()> then);
+
+  bool wait() override;
+
+  std::vector<at::Tensor> result() const override;
+
+ protected:
+  std::shared_ptr<ProcessGroup::Work> work_;
+  std::function<std::vector<at::Tensor>()> then_;
+  std::vector<at::Tensor> result_;
+};
+
+// Sums sparse COO tensors across processes, like an allreduce of each of
+// them, but with the same number of collectives however many tensors there
+// are: the number of nonzeros of every tensor is gathered first, then the
+// indices and the values of all tensors are gathered at once, flattened and
+// concatenated. A tensor whose nonzeros, summed over all processes, cover
+// more than `densify_threshold` of its elements is instead made dense and
+// reduced with a single allreduce together with all other such tensors, and
+// turned back into a sparse tensor afterwards. All tensors must have the same
+// dtype and be on the same device. The collectives after the first one run
+// when the returned work is waited on; its result() holds the coalesced sums
+// in the order of `tensors`.
+std::shared_ptr<ProcessGroup::Work> allreduce_sparse_coalesced(
+    const std::shared_ptr<ProcessGroup>& process_group,
+    std::vector<at::Tensor> tensors,
+    double densify_threshold = std::numeric_limits<double>::infinity());
+
+// Casts the bucket to half precision for the allreduce, halving the amount
+// of data sent, and casts the result back.
+class FP16CompressCommHook : public CommHookInterface {
+ public:
+  explicit FP16CompressCommHook(std::shared_ptr<ProcessGroup> process_group);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(GradBucket& bucket) override;
+
+ private:
+  std::shared_ptr<ProcessGroup> process_group_;
+};
+
+// Reduces every bucket with reduce_scatter instead of allreduce, for sharded
+// data parallel training. Each bucket, padded to a multiple of the process
+// group size, is split into one shard per rank, and only the shard of the
+// local rank, i.e. elements [rank * shard_size, (rank + 1) * shard_size), is
+// reduced; the rest of the bucket is zeroed. Every rank thereby updates only
+// the parameters in its shards, after which `Reducer::sync_sharded_parameters`
+// reconstitutes the full parameters with allgather. Only a single model
+// replica is supported.
+class ReduceScatterCommHook : public CommHookInterface {
+ public:
+  explicit ReduceScatterCommHook(std::shared_ptr<ProcessGroup> process_group);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(GradBucket& bucket) override;
+
+ private:
+  std::shared_ptr<ProcessGroup> process_group_;
+};
+
+// PowerSGD gradient compression (Vogels et al., 2019). The gradient of every
+// variable with at least two dimensions is viewed as an n x m matrix M and
+// sent as two factors P (n x rank) and Q (m x rank), both of which are
+// allreduced: P = M Q is reduced and orthogonalized, then Q = M^T P is
+// reduced and M is approximated by P Q^T. The error of the approximation is
+// added to the next gradient of the variable, and Q is reused as the starting
+// point of the next iteration. Gradients of lower dimensionality are
+// allreduced uncompressed. Only a single model replica is supported.
+class PowerSGDCommHook : public CommHookInterface {
+ public:
+  PowerSGDCommHook(
+      std::shared_ptr<ProcessGroup> process_group,
+      int64_t matrix_approximation_rank = 1);
+
+  std::shared_ptr<ProcessGroup::Work> runHook(GradBucket& bucket) override;
+
+ private:
+  // Per variable state, kept across iterations.
+  struct VariableState {
+    at::Tensor q;
+    at::Tensor error;
+  };
+
+  std::shared_ptr<ProcessGroup> process_group_;
+  const int64_t matrix_approximation_rank_;
+  std::unordered_map<size_t, std::vector<VariableState>> states_;
+};
+
 } // namespace c10d
@@ -25,6 +25,7 @@
 #include <torch/csrc/distributed/c10d/comm.h>
 #include <torch/csrc/distributed/c10d/ddp.h>
 #include <torch/csrc/distributed/c10d/reducer.h>
+#include <torch/csrc/utils/memory.h>
 #include <torch/csrc/utils/object_ptr.h>
 #include <torch/csrc/utils/pybind.h>
 
@@ -116,21 +117,36 @@ PyObject* c10d_init(PyObject* _unused) {
 
   auto module = py::handle(c10d_module).cast<py::module>();
 
+  module.attr("_DEFAULT_FIRST_BUCKET_BYTES") = ::c10d::kDefaultFirstBucketBytes;
+
   shared_ptr_class_<::c10d::Reducer>(module, "Reducer")
       .def(
           py::init<
               std::vector<std::vector<torch::autograd::Variable>>,
               std::vector<std::vector<size_t>>,
               std::shared_ptr<::c10d::ProcessGroup>,
-              std::vector<std::vector<bool>>>(),
+              std::vector<std::vector<bool>>,
+              bool,
+              int64_t,
+              bool,
+              double>(),
           py::arg("replicas"),
           py::arg("bucket_indices"),
           py::arg("process_group"),
-          py::arg("expect_sparse_gradients") = std::vector<std::vector<bool>>())
+          py::arg("expect_sparse_gradients") = std::vector<std::vector<bool>>(),
+          py::arg("gradient_as_bucket_view") = false,
+          py::arg("bucket_bytes_cap") = ::c10d::kDefaultBucketBytesCap,
+          py::arg("find_unused_parameters") = false,
+          py::arg("sparse_densify_threshold") =
+              std::numeric_limits<double>::infinity())
       .def(
           "initialize_buckets",
           &::c10d::Reducer::initialize_buckets,
           py::call_guard<py::gil_scoped_release>())
+      .def(
+          "_rebuild_buckets",
+          &::c10d::Reducer::rebuild_buckets,
+          py::call_guard<py::gil_scoped_release>())
       .def(
           "prepare_for_backward",
           &::c10d::Reducer::prepare_for_backward,
@@ -140,7 +156,41 @@ PyObject* c10d_init(PyObject* _unused) {
           [](::c10d::Reducer& reducer, const torch::autograd::Variable& output)
               -> void { reducer.prepare_for_backward({output}); },
           py::call_guard<py::gil_scoped_release>())
-      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats);
+      .def("get_backward_stats", &::c10d::Reducer::get_backward_stats)
+      .def("get_bucket_ready_stats", &::c10d::Reducer::get_bucket_ready_stats)
+      .def(
+          "_register_fp16_compress_hook",
+          [](::c10d::Reducer& reducer,
+             std::shared_ptr<::c10d::ProcessGroup> process_group) {
+            reducer.register_comm_hook(
+                torch::make_unique<::c10d::FP16CompressCommHook>(
+                    std::move(process_group)));
+          },
+          py::arg("process_group"))
+      .def(
+          "_register_powersgd_hook",
+          [](::c10d::Reducer& reducer,
+             std::shared_ptr<::c10d::ProcessGroup> process_group,
+             int64_t matrix_approximation_rank) {
+            reducer.register_comm_hook(
+                torch::make_unique<::c10d::PowerSGDCommHook>(
+                    std::move(process_group), matrix_approximation_rank));
+          },
+          py::arg("process_group"),
+          py::arg("matrix_approximation_rank") = 1)
+      .def(
+          "_register_reduce_scatter_hook",
+          [](::c10d::Reducer& reducer,
+             std::shared_ptr<::c10d::ProcessGroup> process_group) {
+            reducer.register_comm_hook(
+                torch::make_unique<::c10d::ReduceScatterCommHook>(
+                    std::move(process_group)));
+          },
+          py::arg("process_group"))
+      .def(
+          "_sync_sharded_parameters",
+          &::c10d::Reducer::sync_sharded_parameters,
+          py::call_guard<py::gil_scoped_release>());
 
   py::enum_<::c10d::ReduceOp>(module, "ReduceOp", R"(
 An enum-like class for available reduction operations: ``SUM``, ``PRODUCT``,
@@ -200,6 +250,10 @@ They are used in specifying strategies for reduction collectives, e.g.,
       .def_readwrite("reduceOp", &::c10d::ReduceScatterOptions::reduceOp)
       .def_readwrite("timeout", &::c10d::ReduceScatterOptions::timeout);
 
+  py::class_<::c10d::AllToAllOptions>(module, "AllToAllOptions")
+      .def(py::init<>())
+      .def_readwrite("timeout", &::c10d::AllToAllOptions::timeout);
+
   py::class_<::c10d::BarrierOptions>(module, "BarrierOptions")
       .def(py::init<>())
       .def_readwrite("timeout", &::c10d::BarrierOptions::timeout);
@@ -377,6 +431,14 @@ They are used in specifying strategies for reduction collectives, e.g.,
               py::arg("input_tensor"),
               py::call_guard<py::gil_scoped_release>())
 
+          .def(
+              "_allgather_base",
+              &::c10d::ProcessGroup::allgather_base,
+              py::arg("output"),
+              py::arg("input"),
+              py::arg("opts") = ::c10d::AllgatherOptions(),
+              py::call_guard<py::gil_scoped_release>())
+
           .def(
               "allgather_coalesced",
               &::c10d::ProcessGroup::allgather_coalesced,
@@ -457,6 +519,24 @@ They are used in specifying strategies for reduction collectives, e.g.,
               py::arg("input_tensor"),
               py::call_guard<py::gil_scoped_release>())
 
+          .def(
+              "alltoall_base",
+              &::c10d::ProcessGroup::alltoall_base,
+              py::arg("output_tensor"),
+              py::arg("input_tensor"),
+              py::arg("output_split_sizes"),
+              py::arg("input_split_sizes"),
+              py::arg("opts") = ::c10d::AllToAllOptions(),
+              py::call_guard<py::gil_scoped_release>())
+
+          .def(
+              "alltoall",
+              &::c10d::ProcessGroup::alltoall,
+              py::arg("output_tensors"),
+              py::arg("input_tensors"),
+              py::arg("opts") = ::c10d::AllToAllOptions(),
+              py::call_guard<py::gil_scoped_release>())
+
           .def(
               "send",
               &::c10d::ProcessGroup::send,
@@ -503,7 +583,10 @@ They are used in specifying strategies for reduction collectives, e.g.,
       .def(py::init<>())
       .def_readwrite("devices", &::c10d::ProcessGroupGloo::Options::devices)
       .def_readwrite("timeout", &::c10d::ProcessGroupGloo::Options::timeout)
-      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads);
+      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads)
+      .def_readwrite(
+          "hierarchical_allreduce",
+          &::c10d::ProcessGroupGloo::Options::hierarchicalAllreduce);
 
   processGroupGloo.def_static(
       "create_device",
@@ -568,12 +651,16 @@ They are used in specifying strategies for reduction collectives, e.g.,
               const std::shared_ptr<::c10d::Store>&,
               int,
               int,
-              const std::chrono::milliseconds&>(),
+              const std::chrono::milliseconds&,
+              int,
+              bool>(),
           py::arg("store"),
           py::arg("rank"),
           py::arg("size"),
           py::arg("timeout") = std::chrono::milliseconds(
-              ::c10d::ProcessGroupNCCL::kProcessGroupNCCLOpTimeoutMillis));
+              ::c10d::ProcessGroupNCCL::kProcessGroupNCCLOpTimeoutMillis),
+          py::arg("comms_per_device") = 1,
+          py::arg("is_high_priority_stream") = false);
 #endif
 
 #ifdef USE_C10D_MPI
@@ -583,9 +670,14 @@ They are used in specifying strategies for reduction collectives, e.g.,
   // Define static create function instead of a constructor, because
   // this function may return null. This happens if this process is not
   // part of a sub group that is to be created.
-  processGroupMPI.def_static("create", [](std::vector<int> ranks) {
-    return ::c10d::ProcessGroupMPI::createProcessGroupMPI(ranks);
-  });
+  processGroupMPI.def_static(
+      "create",
+      [](std::vector<int> ranks, int num_worker_threads) {
+        return ::c10d::ProcessGroupMPI::createProcessGroupMPI(
+            ranks, num_worker_threads);
+      },
+      py::arg("ranks"),
+      py::arg("num_worker_threads") = 1);
 #endif
 
   shared_ptr_class_<::c10d::ProcessGroup::Work>(module, "Work")
@@ -673,6 +765,21 @@ They are used in specifying strategies for reduction collectives, e.g.,
       py::arg("buffer_size"),
       py::call_guard<py::gil_scoped_release>());
 
+  shared_ptr_class_<::c10d::PersistentBroadcast>(module, "_PersistentBroadcast")
+      .def(
+          py::init<
+              std::shared_ptr<::c10d::ProcessGroup>,
+              std::vector<at::Tensor>,
+              size_t>(),
+          py::arg("process_group"),
+          py::arg("tensors"),
+          py::arg("buffer_size"),
+          py::call_guard<py::gil_scoped_release>())
+      .def(
+          "run",
+          &::c10d::PersistentBroadcast::run,
+          py::call_guard<py::gil_scoped_release>());
+
   module.def(
       "_test_python_store",
       // Define a function that takes a c10d store and runs a few tests.
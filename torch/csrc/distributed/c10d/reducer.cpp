@@ -43,10 +43,19 @@ Reducer::Reducer(
     std::vector<std::vector<torch::autograd::Variable>> replicas,
     std::vector<std::vector<size_t>> bucket_indices,
     std::shared_ptr<c10d::ProcessGroup> process_group,
-    std::vector<std::vector<bool>> expect_sparse_gradients)
+    std::vector<std::vector<bool>> expect_sparse_gradients,
+    bool gradient_as_bucket_view,
+    int64_t bucket_bytes_cap,
+    bool find_unused_parameters,
+    double sparse_densify_threshold)
     : replicas_(std::move(replicas)),
       process_group_(std::move(process_group)),
       expect_sparse_gradients_(std::move(expect_sparse_gradients)),
+      gradient_as_bucket_view_(gradient_as_bucket_view),
+      bucket_bytes_cap_(bucket_bytes_cap),
+      find_unused_parameters_(find_unused_parameters),
+      sparse_densify_threshold_(sparse_densify_threshold),
+      has_rebuilt_bucket_(false),
       expect_autograd_hooks_(false),
       require_finalize_(false),
       next_bucket_(0),
@@ -151,6 +160,9 @@ Reducer::Reducer(
     }
   }
 
+  // Now that the gradient accumulators exist, order them by bucket.
+  set_grad_accumulator_priorities();
+
   // Initialize backward stats vector.
   {
     const auto replica_count = replicas_.size();
@@ -230,14 +242,29 @@ void Reducer::mark_variable_ready_dense(VariableIndex index) {
         bucket_view.toString(),
         ", got ",
         grad.toString());
-    // Assert that the grad tensor and the bucket don't share storage.
-    // If they did, we could avoid the copy altogether.
-    // The reason for not doing this is that existing code calls
-    // `detach_` from `zero_grad`, which is incompatible with views.
+    if (gradient_as_bucket_view_ && grad.is_alias_of(bucket_view)) {
+      // The gradient was accumulated in place into the bucket, so there is
+      // nothing to copy. If the parameter went unused, the gradient is left
+      // from an earlier iteration and must stay untouched if it turns out to
+      // be unused globally (see `finalize_bucket_dense`). It still takes part
+      // in the reduction, so give the parameter a copy of it.
+      if (local_used_maps_[replica_index]
+              .data_ptr<int>()[variable_index] == 0) {
+        grad = grad.clone();
+      }
+      return;
+    }
+    // With `gradient_as_bucket_view_` set, the grad tensor and the bucket
+    // only don't share storage if the gradient was replaced since the last
+    // iteration (e.g. set to None and accumulated anew). Copy it, and have
+    // the parameter use the bucket view again.
     TORCH_INTERNAL_ASSERT(!grad.is_alias_of(bucket_view));
     TORCH_INTERNAL_ASSERT(grad.device() == bucket_view.device());
     TORCH_INTERNAL_ASSERT(grad.numel() == bucket_view.numel());
     bucket_view.copy_(grad.view({-1}), /* non_blocking */ true);
+    if (gradient_as_bucket_view_) {
+      grad = replica.bucket_views[bucket_index.intra_bucket_index];
+    }
   } else {
     bucket_view.zero_();
   }
@@ -282,6 +309,13 @@ void Reducer::autograd_hook(VariableIndex index) {
     return;
   }
 
+  // Record the order in which gradients are ready, to rebuild the buckets
+  // in that order before the next iteration.
+  if (should_rebuild_buckets() && index.replica_index == 0) {
+    rebuilt_params_.push_back(replicas_[0][index.variable_index]);
+    rebuilt_param_indices_.push_back(index.variable_index);
+  }
+
   // If there are model parameters that went unused when computing the model
   // output, they won't be part of the autograd graph, and won't receive
   // gradients. These parameters are discovered in the `prepare_for_backward`
@@ -360,6 +394,8 @@ void Reducer::mark_variable_ready(VariableIndex index) {
     replica.contents.div_(process_group_->getSize());
     // Kick off reduction if all replicas for this bucket are ready.
     if (--bucket.pending == 0) {
+      bucket_ready_stats_[bucket_index.bucket_index] =
+          current_time_in_nanos() - backward_stats_base_;
       mark_bucket_ready(bucket_index.bucket_index);
     }
   }
@@ -386,9 +422,11 @@ void Reducer::mark_variable_ready(VariableIndex index) {
 void Reducer::mark_bucket_ready(size_t bucket_index) {
   TORCH_INTERNAL_ASSERT(bucket_index >= next_bucket_);
 
-  // Buckets are reduced in sequence. Ignore this bucket if
-  // it's not its turn to be reduced.
-  if (bucket_index > next_bucket_) {
+  // Buckets are reduced in sequence. Ignore this bucket if it's not its turn
+  // to be reduced, unless it completes the sparse group that's next.
+  if (bucket_index > next_bucket_ &&
+      bucket_index >=
+          next_bucket_ + buckets_[next_bucket_].sparse_group_size) {
     return;
   }
 
@@ -398,6 +436,20 @@ void Reducer::mark_bucket_ready(size_t bucket_index) {
   for (; next_bucket_ < buckets_.size() && buckets_[next_bucket_].pending == 0;
        next_bucket_++) {
     auto& bucket = buckets_[next_bucket_];
+    if (bucket.sparse_group_size > 0) {
+      // A group of sparse buckets is only reduced once all of them are ready.
+      // Every bucket of the group calls this function when it becomes ready,
+      // so this is tried again for the last one.
+      const auto end = next_bucket_ + bucket.sparse_group_size;
+      for (auto i = next_bucket_ + 1; i < end; i++) {
+        if (buckets_[i].pending != 0) {
+          return;
+        }
+      }
+      reduce_sparse_buckets(next_bucket_);
+      next_bucket_ = end - 1;
+      continue;
+    }
     std::vector<at::Tensor> tensors;
     tensors.reserve(bucket.replicas.size());
     for (const auto& replica : bucket.replicas) {
@@ -412,7 +464,104 @@ void Reducer::mark_bucket_ready(size_t bucket_index) {
       //
       tensors.push_back(replica.contents);
     }
-    bucket.work = process_group_->allreduce(tensors);
+    if (comm_hook_ && !bucket.expect_sparse_gradient) {
+      const auto& replica = bucket.replicas.front();
+      GradBucket grad_bucket{next_bucket_, std::move(tensors),
+                             replica.offsets, replica.lengths, {}};
+      grad_bucket.sizes.reserve(replica.variables.size());
+      for (const auto& variable : replica.variables) {
+        grad_bucket.sizes.push_back(variable.sizes().vec());
+      }
+      bucket.work = comm_hook_->runHook(grad_bucket);
+    } else {
+      bucket.work = process_group_->allreduce(tensors);
+    }
+  }
+}
+
+void Reducer::reduce_sparse_buckets(size_t bucket_index) {
+  const auto end = bucket_index + buckets_[bucket_index].sparse_group_size;
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(end - bucket_index);
+  for (auto i = bucket_index; i < end; i++) {
+    tensors.push_back(buckets_[i].replicas.front().contents);
+  }
+  auto work = allreduce_sparse_coalesced(
+      process_group_, std::move(tensors), sparse_densify_threshold_);
+
+  // Give every bucket a work that yields its own gradient, so that
+  // `finalize_bucket_sparse` treats the buckets like any sparse bucket.
+  for (auto i = bucket_index; i < end; i++) {
+    const auto offset = i - bucket_index;
+    buckets_[i].work = std::make_shared<ChainedWork>(work, [work, offset]() {
+      return std::vector<at::Tensor>{work->result()[offset]};
+    });
+  }
+}
+
+void Reducer::register_comm_hook(std::unique_ptr<CommHookInterface> hook) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TORCH_CHECK(
+      !expect_autograd_hooks_,
+      "`register_comm_hook` must NOT be called during autograd execution.");
+  TORCH_CHECK(
+      comm_hook_ == nullptr,
+      "register_comm_hook can only be called once.");
+  comm_hook_ = std::move(hook);
+}
+
+void Reducer::sync_sharded_parameters() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TORCH_CHECK(
+      !expect_autograd_hooks_,
+      "`sync_sharded_parameters` must NOT be called during autograd execution.");
+  TORCH_CHECK(
+      replicas_.size() == 1,
+      "Sharded parameters only support a single model replica.");
+  const int64_t world_size = process_group_->getSize();
+  const int64_t rank = process_group_->getRank();
+  at::AutoGradMode no_grad(false);
+
+  // Flatten the parameters of every bucket in the layout of its contents,
+  // padded like `ReduceScatterCommHook` pads it, and gather all shards.
+  std::vector<at::Tensor> flats;
+  std::vector<at::Tensor> shards;
+  std::vector<size_t> bucket_indices;
+  flats.reserve(buckets_.size());
+  shards.reserve(buckets_.size());
+  for (size_t bucket_index = 0; bucket_index < buckets_.size();
+       bucket_index++) {
+    const auto& bucket = buckets_[bucket_index];
+    if (bucket.expect_sparse_gradient) {
+      continue;
+    }
+    const auto& replica = bucket.replicas.front();
+    const auto numel = replica.contents.numel();
+    const auto shard_size = (numel + world_size - 1) / world_size;
+    auto flat = at::zeros({shard_size * world_size}, replica.contents.options());
+    for (size_t i = 0; i < replica.variables.size(); i++) {
+      flat.narrow(0, replica.offsets[i], replica.lengths[i])
+          .copy_(replica.variables[i].reshape({-1}));
+    }
+    shards.push_back(flat.narrow(0, rank * shard_size, shard_size).clone());
+    flats.push_back(std::move(flat));
+    bucket_indices.push_back(bucket_index);
+  }
+
+  std::vector<std::shared_ptr<c10d::ProcessGroup::Work>> works;
+  works.reserve(flats.size());
+  for (size_t i = 0; i < flats.size(); i++) {
+    works.push_back(process_group_->allgather_base(flats[i], shards[i]));
+  }
+  for (size_t i = 0; i < flats.size(); i++) {
+    works[i]->wait();
+    auto& replica = buckets_[bucket_indices[i]].replicas.front();
+    for (size_t j = 0; j < replica.variables.size(); j++) {
+      auto& variable = replica.variables[j];
+      variable.copy_(flats[i]
+                         .narrow(0, replica.offsets[j], replica.lengths[j])
+                         .view(variable.sizes()));
+    }
   }
 }
 
@@ -502,6 +651,24 @@ void Reducer::initialize_buckets(
 
         // Allocate bucket contents tensor.
         replica.contents = at::empty({static_cast<long>(offset)}, options);
+
+        // Create the views into it. They are created below autograd, so that
+        // they don't become (differentiable) views of `contents`.
+        at::AutoNonVariableTypeMode non_var_guard;
+        for (size_t i = 0; i < replica.variables.size(); i++) {
+          auto& variable = replica.variables[i];
+          replica.bucket_views.push_back(
+              replica.contents.narrow(0, replica.offsets[i], replica.lengths[i])
+                  .view(variable.sizes()));
+          // Gradients that already exist move into the bucket, so that they
+          // keep being accumulated in place after buckets are reassigned.
+          auto& grad = variable.grad();
+          if (gradient_as_bucket_view_ && grad.defined() &&
+              grad.options().type_equal(options)) {
+            replica.bucket_views.back().copy_(grad);
+            grad = replica.bucket_views.back();
+          }
+        }
       }
 
       // Add bucket replica to enclosing bucket.
@@ -524,6 +691,150 @@ void Reducer::initialize_buckets(
 
     buckets_.push_back(std::move(bucket));
   }
+  bucket_ready_stats_.assign(bucket_count, 0);
+
+  // Group consecutive sparse buckets of the same dtype and device, so that
+  // `reduce_sparse_buckets` reduces them with a fixed number of collectives.
+  // Since the bucket assignment is identical across processes, so are the
+  // groups.
+  if (replica_count == 1) {
+    size_t group_index = 0;
+    for (size_t bucket_index = 0; bucket_index < bucket_count; bucket_index++) {
+      auto& bucket = buckets_[bucket_index];
+      if (!bucket.expect_sparse_gradient) {
+        continue;
+      }
+      const auto& variable = bucket.replicas.front().variables.front();
+      if (bucket_index > 0 &&
+          buckets_[bucket_index - 1].expect_sparse_gradient) {
+        const auto& previous =
+            buckets_[bucket_index - 1].replicas.front().variables.front();
+        if (previous.scalar_type() == variable.scalar_type() &&
+            previous.device() == variable.device()) {
+          buckets_[group_index].sparse_group_size++;
+          continue;
+        }
+      }
+      group_index = bucket_index;
+      bucket.sparse_group_size = 1;
+    }
+  }
+
+  // Gradient accumulators don't exist yet when this is called from the
+  // constructor; the constructor sets their priorities itself.
+  set_grad_accumulator_priorities();
+}
+
+bool Reducer::rebuild_buckets() {
+  std::vector<std::vector<size_t>> bucket_indices;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!should_rebuild_buckets() || rebuilt_params_.empty()) {
+      return false;
+    }
+
+    // The recorded order is usable only if every gradient was ready exactly
+    // once, which is not the case if the previous backward pass failed.
+    // Record it again in the next iteration.
+    if (rebuilt_params_.size() != replicas_[0].size()) {
+      rebuilt_params_.clear();
+      rebuilt_param_indices_.clear();
+      return false;
+    }
+
+    std::vector<bool> expect_sparse_gradient;
+    expect_sparse_gradient.reserve(rebuilt_param_indices_.size());
+    for (const auto variable_index : rebuilt_param_indices_) {
+      expect_sparse_gradient.push_back(
+          expect_sparse_gradients_[0][variable_index]);
+    }
+    bucket_indices = compute_bucket_assignment_by_size(
+        rebuilt_params_,
+        {static_cast<size_t>(kDefaultFirstBucketBytes),
+         static_cast<size_t>(bucket_bytes_cap_)},
+        expect_sparse_gradient);
+
+    // Map the positions in the recorded order back to variable indices.
+    for (auto& bucket : bucket_indices) {
+      for (auto& index : bucket) {
+        index = rebuilt_param_indices_[index];
+      }
+    }
+
+    rebuilt_params_.clear();
+    rebuilt_param_indices_.clear();
+    has_rebuilt_bucket_ = true;
+  }
+
+  // Processes may have seen their gradients in different orders, but they
+  // must reduce the same buckets in the same order.
+  sync_bucket_indices(bucket_indices);
+  initialize_buckets(std::move(bucket_indices));
+  return true;
+}
+
+void Reducer::sync_bucket_indices(
+    std::vector<std::vector<size_t>>& bucket_indices) {
+  if (process_group_->getSize() == 1) {
+    return;
+  }
+
+  // Pack the assignment as the number of buckets, the bucket sizes and the
+  // variable indices. Every variable is in exactly one bucket, so this never
+  // takes more than `2 * variable_count + 1` elements.
+  const auto variable_count = replicas_[0].size();
+  auto packed = at::empty(
+      {static_cast<int64_t>(2 * variable_count + 1)}, at::kLong);
+  auto packed_accessor = packed.accessor<int64_t, 1>();
+  int64_t position = 0;
+  packed_accessor[position++] = bucket_indices.size();
+  for (const auto& bucket : bucket_indices) {
+    packed_accessor[position++] = bucket.size();
+  }
+  for (const auto& bucket : bucket_indices) {
+    for (const auto variable_index : bucket) {
+      packed_accessor[position++] = variable_index;
+    }
+  }
+
+  // Backends such as NCCL only broadcast tensors on the replica's device.
+  std::vector<at::Tensor> tensors = {
+      packed.to(replicas_[0][0].device())};
+  process_group_->broadcast(tensors)->wait();
+  packed = tensors.front().cpu();
+  packed_accessor = packed.accessor<int64_t, 1>();
+
+  position = 0;
+  const auto bucket_count = packed_accessor[position++];
+  std::vector<size_t> bucket_sizes;
+  bucket_sizes.reserve(bucket_count);
+  for (int64_t i = 0; i < bucket_count; i++) {
+    bucket_sizes.push_back(packed_accessor[position++]);
+  }
+  bucket_indices.clear();
+  bucket_indices.reserve(bucket_count);
+  for (const auto bucket_size : bucket_sizes) {
+    std::vector<size_t> bucket;
+    bucket.reserve(bucket_size);
+    for (size_t i = 0; i < bucket_size; i++) {
+      bucket.push_back(packed_accessor[position++]);
+    }
+    bucket_indices.push_back(std::move(bucket));
+  }
+}
+
+void Reducer::set_grad_accumulator_priorities() {
+  if (grad_accumulators_.empty()) {
+    return;
+  }
+  const auto bucket_count = buckets_.size();
+  for (size_t bucket_index = 0; bucket_index < bucket_count; bucket_index++) {
+    for (const auto variable_index : buckets_[bucket_index].variable_indices) {
+      for (const auto& replica : grad_accumulators_) {
+        replica[variable_index]->set_priority(bucket_count - bucket_index);
+      }
+    }
+  }
 }
 
 // Traverse the autograd graph starting at the specified output.
@@ -628,8 +939,6 @@ void Reducer::finalize_bucket_dense(Bucket& bucket) {
          intra_bucket_index < replica.variables.size();
          intra_bucket_index++) {
       auto& variable = replica.variables[intra_bucket_index];
-      const auto offset = replica.offsets[intra_bucket_index];
-      const auto length = replica.lengths[intra_bucket_index];
 
       // Determine if this param has been used globally or not.
       //
@@ -665,12 +974,19 @@ void Reducer::finalize_bucket_dense(Bucket& bucket) {
         local_used_maps_reduced_ = true;
       }
 
-      auto bucket_view =
-          replica.contents.narrow(0, offset, length).view(variable.sizes());
+      const auto& bucket_view = replica.bucket_views[intra_bucket_index];
       auto& grad = variable.grad();
 
       // If a parameter is globally unused, we keep its grad untouched.
       if (!global_unused) {
+        if (gradient_as_bucket_view_) {
+          // The reduction was done in place, so a gradient that is a view
+          // into the bucket is already up to date.
+          if (!grad.defined() || !grad.is_alias_of(bucket_view)) {
+            grad = bucket_view;
+          }
+          continue;
+        }
         if (!grad.defined()) {
           grad = at::empty(bucket_view.sizes(), bucket_view.options());
         }
@@ -711,9 +1027,20 @@ void Reducer::finalize_backward() {
     bucket.work->wait();
     if (bucket.expect_sparse_gradient) {
       finalize_bucket_sparse(bucket);
-    } else {
-      finalize_bucket_dense(bucket);
+      continue;
+    }
+    if (comm_hook_) {
+      // The hook may not have reduced the bucket in place.
+      const auto result = bucket.work->result();
+      TORCH_INTERNAL_ASSERT(result.size() == bucket.replicas.size());
+      for (size_t i = 0; i < bucket.replicas.size(); i++) {
+        auto& contents = bucket.replicas[i].contents;
+        if (!result[i].is_same(contents)) {
+          contents.copy_(result[i]);
+        }
+      }
     }
+    finalize_bucket_dense(bucket);
   }
 
   // Reset unused parameter accounting.
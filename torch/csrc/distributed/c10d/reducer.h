@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <tuple>
@@ -9,10 +10,14 @@
 
 #include <c10d/ProcessGroup.hpp>
 #include <torch/csrc/autograd/function.h>
+#include <torch/csrc/distributed/c10d/comm.h>
 #include <torch/csrc/autograd/variable.h>
 
 namespace c10d {
 
+constexpr int kDefaultFirstBucketBytes = int(1024 * 1024);
+constexpr int kDefaultBucketBytesCap = int(25 * 1024 * 1024);
+
 class Reducer {
  public:
   // The constructor takes a list of variables for every model replica.
@@ -23,7 +28,12 @@ class Reducer {
       std::vector<std::vector<torch::autograd::Variable>> replicas,
       std::vector<std::vector<size_t>> bucket_indices,
       std::shared_ptr<c10d::ProcessGroup> process_group,
-      std::vector<std::vector<bool>> expect_sparse_gradients);
+      std::vector<std::vector<bool>> expect_sparse_gradients,
+      bool gradient_as_bucket_view = false,
+      int64_t bucket_bytes_cap = kDefaultBucketBytesCap,
+      bool find_unused_parameters = false,
+      double sparse_densify_threshold =
+          std::numeric_limits<double>::infinity());
 
   ~Reducer() noexcept(false);
 
@@ -33,6 +43,16 @@ class Reducer {
   // all live on the same device and have the same dimensionality.
   void initialize_buckets(std::vector<std::vector<size_t>> bucket_indices);
 
+  // The bucket assignment passed to the constructor approximates the order
+  // in which gradients become ready by the reverse order of the parameters.
+  // During the first iteration the reducer records the order in which the
+  // autograd hooks actually fire. This function, called before the next
+  // `prepare_for_backward`, reassigns the buckets in that order (taking the
+  // order of rank 0, so that all processes agree). It does so only once, and
+  // not if unused parameters are expected, since the recorded order is then
+  // incomplete. Returns true if the buckets were rebuilt.
+  bool rebuild_buckets();
+
   // This function is called when the forward function has produced an output,
   // and the user wishes to reduce gradients in the backwards pass.
   // If they don't, and wish to accumulate gradients before reducing them,
@@ -47,6 +67,25 @@ class Reducer {
     return backward_stats_;
   }
 
+  // Returns the relative time in nanoseconds when every bucket had all of its
+  // gradients ready, with respect to the time `prepare_for_backward` was
+  // called, indexed by bucket in the current bucket assignment.
+  std::vector<int64_t> get_bucket_ready_stats() const {
+    return bucket_ready_stats_;
+  }
+
+  // Replaces the allreduce of every bucket with dense gradients by the given
+  // communication hook. Buckets with a sparse gradient are still allreduced.
+  // Can be called only once, and not during autograd execution.
+  void register_comm_hook(std::unique_ptr<CommHookInterface> hook);
+
+  // Counterpart of `ReduceScatterCommHook`: every rank holds the up to date
+  // values of the parameters in its shard of every dense bucket, and
+  // allgathers those shards so that all ranks have the full parameters
+  // again. Sparse buckets are skipped, since they are allreduced and thus
+  // updated on every rank. To be called after the optimizer step.
+  void sync_sharded_parameters();
+
  protected:
   // Forward declaration.
   struct Bucket;
@@ -62,6 +101,31 @@ class Reducer {
   std::shared_ptr<c10d::ProcessGroup> process_group_;
   std::vector<std::vector<bool>> expect_sparse_gradients_;
 
+  // If true, the `.grad` of every dense parameter is made a view into the
+  // contents of its bucket replica, so that gradient accumulation writes
+  // straight into the tensor that is reduced and the result of the reduction
+  // needs no copy back.
+  const bool gradient_as_bucket_view_;
+
+  // Size limit in bytes of the buckets that `rebuild_buckets` assigns, after
+  // the first one, which is limited to `kDefaultFirstBucketBytes`.
+  const int64_t bucket_bytes_cap_;
+  const bool find_unused_parameters_;
+
+  // Sparse gradients whose nonzeros, summed over all processes, cover more
+  // than this fraction of their elements are allreduced as dense tensors,
+  // see `allreduce_sparse_coalesced`.
+  const double sparse_densify_threshold_;
+
+  // Parameters of the first replica, and their indices, in the order their
+  // gradients became ready, recorded until the buckets are rebuilt.
+  std::vector<at::Tensor> rebuilt_params_;
+  std::vector<size_t> rebuilt_param_indices_;
+  bool has_rebuilt_bucket_;
+
+  // Communication hook that reduces dense buckets, if registered.
+  std::unique_ptr<CommHookInterface> comm_hook_;
+
   std::vector<std::vector<std::shared_ptr<torch::autograd::Node>>>
       grad_accumulators_;
   std::unordered_map<torch::autograd::Node*, VariableIndex> func_;
@@ -102,6 +166,23 @@ class Reducer {
 
   void mark_bucket_ready(size_t bucket_index);
 
+  // Reduces the sparse gradients of the `sparse_group_size` buckets starting
+  // at `bucket_index` with a single `allreduce_sparse_coalesced`, instead of
+  // one sparse allreduce per bucket.
+  void reduce_sparse_buckets(size_t bucket_index);
+
+  bool should_rebuild_buckets() const {
+    return !find_unused_parameters_ && !has_rebuilt_bucket_;
+  }
+
+  // Replaces the bucket assignment by that of rank 0.
+  void sync_bucket_indices(std::vector<std::vector<size_t>>& bucket_indices);
+
+  // Gives the gradient accumulators of earlier buckets a higher autograd
+  // scheduling priority, so that when several are ready at once the engine
+  // runs the ones that let the next bucket be reduced first.
+  void set_grad_accumulator_priorities();
+
   void finalize_bucket_dense(Bucket& replica);
 
   void finalize_bucket_sparse(Bucket& replica);
@@ -132,6 +213,12 @@ class Reducer {
     std::vector<size_t> offsets;
     std::vector<size_t> lengths;
 
+    // Per-variable views into the flat bucket contents tensor, shaped like
+    // the variable. These are not tracked by autograd, so that they can be
+    // assigned to `.grad` (see `gradient_as_bucket_view_`) and then be
+    // detached in place by `zero_grad`.
+    std::vector<at::Tensor> bucket_views;
+
     // Number of tensors to be added before this bucket is complete.
     // This is reset to `variables.size()` every iteration.
     size_t pending;
@@ -163,6 +250,12 @@ class Reducer {
     // If this bucket should expect a single sparse gradient.
     // Implies: replicas[i].variables.size() == 1.
     bool expect_sparse_gradient = false;
+
+    // Consecutive sparse buckets of the same dtype and device are reduced
+    // together, once all of them are ready. The first bucket of such a group
+    // holds the number of buckets in it, the other ones zero. Only used with
+    // a single model replica; zero for all buckets otherwise.
+    size_t sparse_group_size = 0;
   };
 
   std::vector<Bucket> buckets_;
@@ -186,6 +279,7 @@ class Reducer {
   // the point in time buckets were ready, or ideal bucket assignment/ordering.
   int64_t backward_stats_base_;
   std::vector<std::vector<int64_t>> backward_stats_;
+  std::vector<int64_t> bucket_ready_stats_;
 };
 
 std::vector<std::vector<size_t>> compute_bucket_assignment_by_size(
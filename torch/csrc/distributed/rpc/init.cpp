@@ -6,6 +6,7 @@
 #include <torch/csrc/distributed/rpc/python_rpc_handler.h>
 #include <torch/csrc/distributed/rpc/rpc_agent.h>
 #include <torch/csrc/distributed/rpc/rref_context.h>
+#include <torch/csrc/distributed/rpc/socket_agent.h>
 #include <torch/csrc/distributed/rpc/torchscript_functions.h>
 #include <torch/csrc/distributed/rpc/types.h>
 #include <torch/csrc/jit/pybind_utils.h>
@@ -173,6 +174,35 @@ PyObject* rpc_init(PyObject* /* unused */) {
                   to the local node and returns it. If the current node is the
                   owner, returns a reference to the local value.
               )")
+          .def(
+              "to_here_async",
+              &PyRRef::toHereAsync,
+              py::call_guard<py::gil_scoped_release>(),
+              R"(
+                  Non-blocking version of ``to_here()``. Returns a ``Future``
+                  whose ``wait()`` returns a copy of the value. Cannot be called
+                  on the owner, which should use ``local_value()``.
+              )")
+          .def(
+              "mark_immutable",
+              &PyRRef::markImmutable,
+              py::call_guard<py::gil_scoped_release>(),
+              R"(
+                  Declares that the value of this ``RRef`` never changes. A user
+                  then fetches the value from the owner only once and serves
+                  later ``to_here()`` and ``to_here_async()`` calls from a local
+                  copy, except when they run in a distributed autograd context.
+                  Values served from the copy share their tensors, so they must
+                  not be modified in-place.
+              )")
+          .def(
+              // not releasing GIL here to avoid context switch on getters
+              "is_immutable",
+              &PyRRef::isImmutable,
+              R"(
+                  Returns whether ``mark_immutable()`` was called on this
+                  ``RRef``.
+              )")
           .def(
               "local_value",
               &PyRRef::localValue,
@@ -214,7 +244,20 @@ If the future completes with an error, an exception is thrown.
       .def(py::init<>())
       .def_readwrite(
           "num_send_recv_threads",
-          &ProcessGroupRpcBackendOptions::numSendRecvThreads);
+          &ProcessGroupRpcBackendOptions::numSendRecvThreads)
+      .def_readwrite(
+          "coalesce_window", &ProcessGroupRpcBackendOptions::coalesceWindow)
+      .def_readwrite(
+          "coalesce_max_bytes",
+          &ProcessGroupRpcBackendOptions::coalesceMaxBytes);
+
+  py::class_<
+      SocketRpcBackendOptions,
+      ProcessGroupRpcBackendOptions,
+      std::shared_ptr<SocketRpcBackendOptions>>(
+      module, "SocketRpcBackendOptions")
+      .def(py::init<>())
+      .def_readwrite("num_io_threads", &SocketRpcBackendOptions::numIoThreads);
 
   shared_ptr_class_<ProcessGroupAgent>(module, "ProcessGroupAgent", rpcAgent)
       .def(
@@ -222,11 +265,16 @@ If the future completes with an error, an exception is thrown.
               std::string,
               std::shared_ptr<::c10d::ProcessGroup>,
               int,
-              std::chrono::milliseconds>(),
+              std::chrono::milliseconds,
+              std::chrono::microseconds,
+              int64_t>(),
           py::arg("name"),
           py::arg("process_group"),
           py::arg("num_send_recv_threads"),
-          py::arg("rpc_timeout"))
+          py::arg("rpc_timeout"),
+          py::arg("coalesce_window") = std::chrono::microseconds(0),
+          py::arg("coalesce_max_bytes") =
+              ProcessGroupAgent::kDefaultCoalesceMaxBytes)
       .def(
           "get_worker_info",
           (const WorkerInfo& (ProcessGroupAgent::*)(void)const) &
@@ -255,6 +303,29 @@ If the future completes with an error, an exception is thrown.
           &ProcessGroupAgent::sync,
           py::call_guard<py::gil_scoped_release>());
 
+  // SocketAgent inherits the methods bound for ProcessGroupAgent above.
+  py::class_<SocketAgent, ProcessGroupAgent, std::shared_ptr<SocketAgent>>(
+      module, "SocketAgent")
+      .def(
+          py::init<
+              std::string,
+              std::shared_ptr<::c10d::ProcessGroup>,
+              std::shared_ptr<::c10d::Store>,
+              int,
+              int,
+              std::chrono::milliseconds,
+              std::chrono::microseconds,
+              int64_t>(),
+          py::arg("name"),
+          py::arg("process_group"),
+          py::arg("store"),
+          py::arg("num_send_recv_threads"),
+          py::arg("num_io_threads"),
+          py::arg("rpc_timeout"),
+          py::arg("coalesce_window") = std::chrono::microseconds(0),
+          py::arg("coalesce_max_bytes") =
+              ProcessGroupAgent::kDefaultCoalesceMaxBytes);
+
   module.def("_is_current_rpc_agent_set", &RpcAgent::isCurrentRpcAgentSet);
 
   module.def("_get_current_rpc_agent", &RpcAgent::getCurrentRpcAgent);
@@ -46,6 +46,7 @@ enum MessageType {
 
   // Other internal message types
   EXCEPTION = 55,
+  MESSAGE_BATCH = 56, // Several messages coalesced by ProcessGroupAgent
   UNKNOWN = 60
 };
 
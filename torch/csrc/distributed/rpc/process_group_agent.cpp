@@ -50,10 +50,72 @@ double ProcessGroupAgent::AverageMetricsTracker::computeAverage() {
 const ProcessGroupAgent::steady_clock_time_point
     ProcessGroupAgent::kInfiniteTimeoutTimePoint =
         std::chrono::time_point<std::chrono::steady_clock>::max();
+constexpr int64_t ProcessGroupAgent::kDefaultCoalesceMaxBytes;
 const std::string kNumPendingRequests = "agent.num_pending_requests";
 const std::string kThreadPoolSize = "agent.thread_pool_size";
 const std::string kNumIdleThreads = "agent.num_idle_threads";
 const std::string kGilAverageWaitTime = "agent.gil_average_wait_time_us";
+const std::string kNumCoalescedMessages = "agent.num_coalesced_messages";
+const std::string kNumCoalescedBatches = "agent.num_coalesced_batches";
+
+namespace {
+
+// Size of the type, id and length that precede every message in a batch.
+constexpr size_t kBatchMetaSize = 3;
+
+// Estimates the number of bytes that a message takes on the wire.
+int64_t estimateMessageSize(const Message& message) {
+  int64_t size = message.payload().size();
+  for (const auto& tensor : message.tensors()) {
+    size += tensor.numel() * tensor.element_size();
+  }
+  return size;
+}
+
+// A batch holds the type, id and length of every message, followed by the
+// message serialized with wireSerialize(). The tensor data of coalesced
+// messages is small, so it is copied into the batch.
+Message serializeBatch(const std::vector<SendWork>& works) {
+  std::vector<char> payload;
+  for (const auto& work : works) {
+    const auto& message = work.message_;
+    auto serialized = wireSerialize(message.payload(), message.tensors());
+    int64_t meta[kBatchMetaSize] = {(int64_t)message.type(),
+                                    message.id(),
+                                    (int64_t)serialized.size()};
+    const char* metaData = reinterpret_cast<const char*>(meta);
+    payload.insert(payload.end(), metaData, metaData + sizeof(meta));
+    payload.insert(payload.end(), serialized.begin(), serialized.end());
+  }
+  return Message(std::move(payload), {}, MessageType::MESSAGE_BATCH);
+}
+
+std::vector<Message> deserializeBatch(const Message& batch) {
+  std::vector<Message> messages;
+  const auto& payload = batch.payload();
+  size_t offset = 0;
+  while (offset < payload.size()) {
+    int64_t meta[kBatchMetaSize];
+    TORCH_CHECK(
+        offset + sizeof(meta) <= payload.size(), "Truncated message batch");
+    memcpy(meta, payload.data() + offset, sizeof(meta));
+    offset += sizeof(meta);
+    const auto size = meta[2];
+    TORCH_CHECK(
+        size >= 0 && offset + size <= payload.size(),
+        "Truncated message batch");
+    auto data = wireDeserialize(payload.data() + offset, size);
+    offset += size;
+    messages.emplace_back(
+        std::move(data.first),
+        std::move(data.second),
+        MessageType(meta[0]),
+        meta[1]);
+  }
+  return messages;
+}
+
+} // namespace
 
 void ProcessGroupAgent::collectNames() {
   const std::string& workerName = workerInfo_.name_;
@@ -90,16 +152,21 @@ ProcessGroupAgent::ProcessGroupAgent(
     std::string workerName,
     std::shared_ptr<c10d::ProcessGroup> pg,
     int numSendRecvThreads,
-    std::chrono::milliseconds rpcTimeout)
+    std::chrono::milliseconds rpcTimeout,
+    std::chrono::microseconds coalesceWindow,
+    int64_t coalesceMaxBytes)
     : RpcAgent(
           WorkerInfo(std::move(workerName), pg->getRank()),
-          std::make_unique<RequestCallbackImpl>(),
+          std::make_unique<RequestCallbackImpl>(numSendRecvThreads),
           rpcTimeout),
       pg_(std::move(pg)),
       sendCounts_(pg_->getSize()),
       recvCounts_(pg_->getSize()),
       nextId_(0),
       sendMutexes_(pg_->getSize()),
+      coalesceWindow_(coalesceWindow),
+      coalesceMaxBytes_(coalesceMaxBytes),
+      pendingBatches_(pg_->getSize()),
       threadPool_(numSendRecvThreads) {
   // initialize metric info counters
   metrics_.resize(ProcessGroupAgentMetrics::N_METRICS);
@@ -223,7 +290,11 @@ void ProcessGroupAgent::sync() {
   pg_->barrier()->wait();
   // block until all peers agree that all sent messages have been processed.
   do {
-    // Finish all send/recv tasks in the thread pool
+    // Finish all send/recv tasks in the thread pool, and the requests the
+    // callback runs on its own threads, whose responses are sent from the
+    // thread pool again.
+    threadPool_.waitWorkComplete();
+    cb_->waitWorkComplete();
     threadPool_.waitWorkComplete();
     // As there could be nested RPC calls, or response callback could also
     // trigger more messages to be sent, we need to wait for the thread pool
@@ -239,6 +310,13 @@ void ProcessGroupAgent::start() {
   listenerThread_ = std::thread(&ProcessGroupAgent::listenLoop, this);
   futureTimeoutThread_ =
       std::thread(&ProcessGroupAgent::pollTimedOutRPCs, this);
+  if (coalesceWindow_.count() > 0) {
+    {
+      std::lock_guard<std::mutex> guard(coalesceMutex_);
+      coalesceRunning_ = true;
+    }
+    coalesceThread_ = std::thread(&ProcessGroupAgent::coalesceLoop, this);
+  }
 }
 
 void ProcessGroupAgent::shutdown() {
@@ -250,16 +328,29 @@ void ProcessGroupAgent::shutdown() {
   lock.unlock();
   futureTimeoutCV_.notify_one();
   futureTimeoutThread_.join();
-  {
-    std::unique_lock<std::mutex> lock(recvWorkMutex_);
-    if (recvWork_) {
-      recvWork_->abort();
+  if (coalesceThread_.joinable()) {
+    // Sends pending batches before it returns.
+    {
+      std::lock_guard<std::mutex> guard(coalesceMutex_);
+      coalesceRunning_ = false;
     }
+    coalesceCV_.notify_one();
+    coalesceThread_.join();
   }
+  interruptListenLoop();
+  threadPool_.waitWorkComplete();
+  cb_->waitWorkComplete();
   threadPool_.waitWorkComplete();
   listenerThread_.join();
 }
 
+void ProcessGroupAgent::interruptListenLoop() {
+  std::unique_lock<std::mutex> lock(recvWorkMutex_);
+  if (recvWork_) {
+    recvWork_->abort();
+  }
+}
+
 std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
     const WorkerInfo& to,
     Message&& message) {
@@ -320,11 +411,18 @@ std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
           // Unlike the other cases, need to add a tensor deleter, since the
           // data outlives the scope of this function. It's shared_ptr<> due
           // to c++11 lambda capture limitations with unique_ptr<>.
-          auto payload = std::make_unique<std::string>(
-              wireSerialize(message.payload(), message.tensors()));
+          auto serialized =
+              wireSerializeDetached(message.payload(), message.tensors());
+          auto payload =
+              std::make_unique<std::string>(std::move(serialized.first));
           const char* data = payload->data();
           size_t len = payload->length();
           std::string* delete_when_done = payload.release();
+          // The receiver must not share storage with the sender's tensors.
+          std::vector<torch::Tensor> tensorData;
+          for (const auto& tensor : serialized.second) {
+            tensorData.push_back(tensor.clone());
+          }
           enqueueRecv(RecvWork(
               getWorkerInfo(pg_->getRank()),
               message.type(),
@@ -333,7 +431,8 @@ std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
                   (void*)data,
                   len,
                   [delete_when_done](void*) { delete delete_when_done; },
-                  {torch::kChar})));
+                  {torch::kChar}),
+              std::move(tensorData)));
         },
         std::move(message)));
     return future;
@@ -353,8 +452,11 @@ std::shared_ptr<FutureMessage> ProcessGroupAgent::send(
 }
 
 void ProcessGroupAgent::handleSend(const SendWork& work) {
-  std::string serializedPayload =
-      wireSerialize(work.message_.payload(), work.message_.tensors());
+  // The tensor data is not copied into the serialized message, but sent
+  // as separate buffers straight from the tensor storages.
+  auto serialized =
+      wireSerializeDetached(work.message_.payload(), work.message_.tensors());
+  const std::string& serializedPayload = serialized.first;
 
   std::vector<torch::Tensor> preamble = {torch::tensor(
       {(int64_t)pg_->getRank(),
@@ -371,131 +473,251 @@ void ProcessGroupAgent::handleSend(const SendWork& work) {
       (void*)serializedPayload.c_str(),
       serializedPayload.length(),
       {torch::kChar})};
-  pendingSends.reserve(2);
+  std::vector<std::vector<torch::Tensor>> tensorData;
+  tensorData.reserve(serialized.second.size());
+  for (auto& data : serialized.second) {
+    // Empty buffers are not sent; the receiver knows their sizes.
+    if (data.numel() > 0) {
+      tensorData.push_back({std::move(data)});
+    }
+  }
+  pendingSends.reserve(2 + tensorData.size());
 
-  sendCounts_.increment(dst);
+  countSend(work);
 
   {
     std::lock_guard<std::mutex> guard(sendMutexes_[dst]);
     pendingSends.emplace_back(pg_->send(preamble, dst, dst /* channelTag */));
     pendingSends.emplace_back(pg_->send(payload, dst, dst /* channelTag */));
+    for (auto& data : tensorData) {
+      pendingSends.emplace_back(pg_->send(data, dst, dst /* channelTag */));
+    }
   }
   for (auto& pendingSend : pendingSends) {
     pendingSend->wait();
   }
 }
 
+void ProcessGroupAgent::countSend(const SendWork& work) {
+  if (work.message_.type() != MessageType::MESSAGE_BATCH) {
+    sendCounts_.increment(work.to_.id_);
+  }
+}
+
+void ProcessGroupAgent::markSendError(
+    const SendWork& work,
+    const std::exception& e) {
+  if (work.message_.isRequest()) {
+    std::ostringstream ss;
+    ss << "Encountered exception in ProcessGroupAgent::enqueueSend: "
+       << e.what();
+    auto exceptionMsg = rpc::createExceptionResponse(work.message_, ss.str());
+    markFutureWithError(exceptionMsg);
+  }
+}
+
 void ProcessGroupAgent::enqueueSend(SendWork work) {
+  if (coalesceWindow_.count() > 0 && coalesceSend(work)) {
+    return;
+  }
   // NB: this can be changed to use a native move capture when moved to C++14
   threadPool_.run(std::bind(
       [this](const SendWork& work) {
         try {
           handleSend(work);
         } catch (std::exception& e) {
-          if (work.message_.isRequest()) {
-            std::ostringstream ss;
-            ss << "Encountered exception in ProcessGroupAgent::enqueueSend: "
-               << e.what();
-            auto exceptionMsg =
-                rpc::createExceptionResponse(work.message_, ss.str());
-            markFutureWithError(exceptionMsg);
-          }
+          markSendError(work, e);
         }
       },
       std::move(work)));
 }
 
+bool ProcessGroupAgent::coalesceSend(SendWork& work) {
+  const auto size = estimateMessageSize(work.message_);
+  std::lock_guard<std::mutex> guard(coalesceMutex_);
+  if (!coalesceRunning_) {
+    return false;
+  }
+  auto& batch = pendingBatches_[work.to_.id_];
+  if (size >= coalesceMaxBytes_) {
+    // Send the batch right away instead of letting it wait behind the large
+    // message.
+    if (!batch.works_.empty()) {
+      flushBatch(batch);
+    }
+    return false;
+  }
+  // The message is counted now, as its batch is not counted when it is sent.
+  sendCounts_.increment(work.to_.id_);
+  if (batch.works_.empty()) {
+    batch.deadline_ = std::chrono::steady_clock::now() + coalesceWindow_;
+    coalesceCV_.notify_one();
+  }
+  batch.works_.push_back(std::move(work));
+  batch.bytes_ += size;
+  if (batch.bytes_ >= coalesceMaxBytes_) {
+    flushBatch(batch);
+  }
+  return true;
+}
+
+void ProcessGroupAgent::flushBatch(PendingBatch& batch) {
+  std::vector<SendWork> works;
+  works.swap(batch.works_);
+  batch.bytes_ = 0;
+  numCoalescedMessages_ += works.size();
+  ++numCoalescedBatches_;
+  threadPool_.run(std::bind(
+      [this](const std::vector<SendWork>& works) {
+        try {
+          handleSend(SendWork(works.front().to_, serializeBatch(works)));
+        } catch (std::exception& e) {
+          for (const auto& work : works) {
+            markSendError(work, e);
+          }
+        }
+      },
+      std::move(works)));
+}
+
+void ProcessGroupAgent::coalesceLoop() {
+  std::unique_lock<std::mutex> lock(coalesceMutex_);
+  while (coalesceRunning_) {
+    auto minDeadline = kInfiniteTimeoutTimePoint;
+    for (const auto& batch : pendingBatches_) {
+      if (!batch.works_.empty()) {
+        minDeadline = std::min(minDeadline, batch.deadline_);
+      }
+    }
+    if (minDeadline == kInfiniteTimeoutTimePoint) {
+      coalesceCV_.wait(lock);
+    } else {
+      coalesceCV_.wait_until(lock, minDeadline);
+    }
+    const auto now = std::chrono::steady_clock::now();
+    for (auto& batch : pendingBatches_) {
+      if (!batch.works_.empty() && batch.deadline_ <= now) {
+        flushBatch(batch);
+      }
+    }
+  }
+  for (auto& batch : pendingBatches_) {
+    if (!batch.works_.empty()) {
+      flushBatch(batch);
+    }
+  }
+}
+
 void ProcessGroupAgent::enqueueRecv(RecvWork work) {
   threadPool_.run(std::bind(
       [&](RecvWork& work) {
         torch::Tensor& payload = work.payload_;
-        auto data = wireDeserialize(payload.storage().data(), payload.numel());
+        auto data = wireDeserializeDetached(
+            payload.storage().data(), payload.numel(), work.tensorData_);
         Message message(
             std::move(data.first),
             std::move(data.second),
             work.type_,
             work.id_);
-        if (message.isRequest()) {
-          auto futureResponse = cb_->operator()(message);
-          if (futureResponse->completed()) {
-            if (!futureResponse->hasError()) {
-              send(work.from_, std::move(*futureResponse).moveValue());
-            } else {
-              send(
-                  work.from_,
-                  createExceptionResponse(
-                      message, futureResponse->error()->what()));
-            }
-          } else {
-            auto fromId = work.from_.id_;
-            auto requestId = work.id_;
-            futureResponse->addCallback(
-                [this, fromId, requestId, futureResponse](
-                    const Message& /* unused */,
-                    const c10::optional<utils::FutureError>& err) {
-                  if (!err) {
-                    send(
-                        getWorkerInfo(fromId),
-                        std::move(*futureResponse).moveValue());
-                  } else {
-                    std::string errStr = err->what();
-                    std::vector<char> payload(errStr.begin(), errStr.end());
-                    Message m(
-                        std::move(payload),
-                        {},
-                        MessageType::EXCEPTION,
-                        requestId);
-                    send(getWorkerInfo(fromId), std::move(m));
-                  }
-                });
-          }
-        } else if (message.isResponse()) {
-          auto id = message.id();
-          std::shared_ptr<FutureMessage> fm = nullptr;
-          {
-            std::lock_guard<std::mutex> lock{futureMutex_};
-            const auto& futureInfo = futures_.find(id);
-            if (futureInfo == futures_.end()) {
-              // Received a completion for a timed out future, drop the recv.
-              // RecvCounts will not be incremented here, it will be incremented
-              // by the sender who has determined the future has timed out.
-              return;
-            }
-            // Use futureInfo before destructing it.
-            fm = futureInfo->second.future_;
-            auto endTime = futureInfo->second.endTime_;
-            futures_.erase(id);
-            // look up the corresponding future by its time out and request ID,
-            // and remove it from the timeouts map
-            auto& futuresAtTime = futureTimeouts_[endTime];
-            auto it = futuresAtTime.find(id);
-            TORCH_INTERNAL_ASSERT(
-                it != futuresAtTime.end(),
-                "Error: could not find future in futureTimeouts map, race condition.");
-            futuresAtTime.erase(it);
-            if (futuresAtTime.empty()) {
-              // remove the key from futureTimeouts_
-              futureTimeouts_.erase(endTime);
-            }
-          }
-          futureCV_.notify_all();
-          if (message.type() == MessageType::EXCEPTION) {
-            fm->setError(std::string(
-                message.payload().begin(), message.payload().end()));
-          } else {
-            fm->markCompleted(std::move(message));
+        if (message.type() == MessageType::MESSAGE_BATCH) {
+          // Process the coalesced messages independently, as each of them
+          // might block, see [Message Coalescing].
+          const WorkerInfo* from = &work.from_;
+          for (auto& coalesced : deserializeBatch(message)) {
+            threadPool_.run(std::bind(
+                [this, from](Message& coalesced) {
+                  processMessage(*from, std::move(coalesced));
+                },
+                std::move(coalesced)));
           }
-        } else {
-          // TODO: pass the error back to the caller instead of crashing here.
-          TORCH_INTERNAL_ASSERT(
-              false, "unrecognized message type ", message.type());
+          return;
         }
-
-        recvCounts_.increment(work.from_.id_);
+        processMessage(work.from_, std::move(message));
       },
       std::move(work)));
 }
 
+void ProcessGroupAgent::processMessage(
+    const WorkerInfo& from,
+    Message&& message) {
+  if (message.isRequest()) {
+    auto futureResponse = cb_->operator()(message);
+    if (futureResponse->completed()) {
+      if (!futureResponse->hasError()) {
+        send(from, std::move(*futureResponse).moveValue());
+      } else {
+        send(
+            from,
+            createExceptionResponse(message, futureResponse->error()->what()));
+      }
+    } else {
+      auto fromId = from.id_;
+      auto requestId = message.id();
+      futureResponse->addCallback(
+          [this, fromId, requestId, futureResponse](
+              const Message& /* unused */,
+              const c10::optional<utils::FutureError>& err) {
+            if (!err) {
+              send(
+                  getWorkerInfo(fromId),
+                  std::move(*futureResponse).moveValue());
+            } else {
+              std::string errStr = err->what();
+              std::vector<char> payload(errStr.begin(), errStr.end());
+              Message m(
+                  std::move(payload),
+                  {},
+                  MessageType::EXCEPTION,
+                  requestId);
+              send(getWorkerInfo(fromId), std::move(m));
+            }
+          });
+    }
+  } else if (message.isResponse()) {
+    auto id = message.id();
+    std::shared_ptr<FutureMessage> fm = nullptr;
+    {
+      std::lock_guard<std::mutex> lock{futureMutex_};
+      const auto& futureInfo = futures_.find(id);
+      if (futureInfo == futures_.end()) {
+        // Received a completion for a timed out future, drop the recv.
+        // RecvCounts will not be incremented here, it will be incremented
+        // by the sender who has determined the future has timed out.
+        return;
+      }
+      // Use futureInfo before destructing it.
+      fm = futureInfo->second.future_;
+      auto endTime = futureInfo->second.endTime_;
+      futures_.erase(id);
+      // look up the corresponding future by its time out and request ID,
+      // and remove it from the timeouts map
+      auto& futuresAtTime = futureTimeouts_[endTime];
+      auto it = futuresAtTime.find(id);
+      TORCH_INTERNAL_ASSERT(
+          it != futuresAtTime.end(),
+          "Error: could not find future in futureTimeouts map, race condition.");
+      futuresAtTime.erase(it);
+      if (futuresAtTime.empty()) {
+        // remove the key from futureTimeouts_
+        futureTimeouts_.erase(endTime);
+      }
+    }
+    futureCV_.notify_all();
+    if (message.type() == MessageType::EXCEPTION) {
+      fm->setError(std::string(
+          message.payload().begin(), message.payload().end()));
+    } else {
+      fm->markCompleted(std::move(message));
+    }
+  } else {
+    // TODO: pass the error back to the caller instead of crashing here.
+    TORCH_INTERNAL_ASSERT(
+        false, "unrecognized message type ", message.type());
+  }
+
+  recvCounts_.increment(from.id_);
+}
+
 void ProcessGroupAgent::markFutureWithError(Message& message) {
   TORCH_INTERNAL_ASSERT(
       message.type() == MessageType::EXCEPTION,
@@ -556,8 +778,26 @@ void ProcessGroupAgent::listenLoop() {
     std::vector<torch::Tensor> tensors = {torch::empty({size}, {torch::kChar})};
     pg_->recv(tensors, srcRank, pg_->getRank())->wait();
 
-    enqueueRecv(
-        RecvWork(allWorkerInfo_[srcRank], type, id, std::move(tensors[0])));
+    // Receive the tensor data buffers that follow the message straight
+    // into the storages that the deserialized tensors will use.
+    const auto& payload = tensors[0];
+    std::vector<torch::Tensor> tensorData;
+    for (auto dataSize :
+         wireDetachedTensorDataSizes(payload.storage().data(), size)) {
+      std::vector<torch::Tensor> data = {
+          torch::empty({(int64_t)dataSize}, {torch::kChar})};
+      if (dataSize > 0) {
+        pg_->recv(data, srcRank, pg_->getRank())->wait();
+      }
+      tensorData.push_back(std::move(data[0]));
+    }
+
+    enqueueRecv(RecvWork(
+        allWorkerInfo_[srcRank],
+        type,
+        id,
+        std::move(tensors[0]),
+        std::move(tensorData)));
   }
 }
 
@@ -661,6 +901,8 @@ std::unordered_map<std::string, std::string> ProcessGroupAgent::getMetrics() {
   }
   metrics[kThreadPoolSize] = c10::to_string(threadPool_.size());
   metrics[kNumIdleThreads] = c10::to_string(threadPool_.numAvailable());
+  metrics[kNumCoalescedMessages] = c10::to_string(numCoalescedMessages_.load());
+  metrics[kNumCoalescedBatches] = c10::to_string(numCoalescedBatches_.load());
   if (isGILProfilingEnabled()) {
     // Add time-series based metrics, just GIL wait times for now.
     {
@@ -15,6 +15,9 @@ namespace rpc {
 struct ProcessGroupRpcBackendOptions : public RpcBackendOptions {
   ProcessGroupRpcBackendOptions() = default;
   int numSendRecvThreads;
+  // See [Message Coalescing] in ProcessGroupAgent.
+  std::chrono::microseconds coalesceWindow;
+  int64_t coalesceMaxBytes;
 };
 
 // SendWork and RecvWork will be put into a task queue, and later picked up by
@@ -29,18 +32,25 @@ struct SendWork {
 
 // SendWork wraps a Message and RecvWork wraps a Tensor. The difference here is
 // to allow us to run serialization/deserialization in the worker threads.
+// The tensor data of the message is received into separate buffers.
 struct RecvWork {
   RecvWork(
       const WorkerInfo& from,
       MessageType type,
       int64_t id,
-      torch::Tensor&& payload)
-      : from_(from), type_(type), id_(id), payload_(payload) {}
+      torch::Tensor&& payload,
+      std::vector<torch::Tensor>&& tensorData)
+      : from_(from),
+        type_(type),
+        id_(id),
+        payload_(payload),
+        tensorData_(std::move(tensorData)) {}
 
   const WorkerInfo& from_;
   const MessageType type_;
   const int64_t id_;
   torch::Tensor payload_;
+  std::vector<torch::Tensor> tensorData_;
 };
 
 class ProcessGroupAgent : public RpcAgent {
@@ -49,7 +59,12 @@ class ProcessGroupAgent : public RpcAgent {
       std::string workerName,
       std::shared_ptr<c10d::ProcessGroup> pg,
       int numSendRecvThreads,
-      std::chrono::milliseconds rpcTimeout);
+      std::chrono::milliseconds rpcTimeout,
+      std::chrono::microseconds coalesceWindow = std::chrono::microseconds(0),
+      int64_t coalesceMaxBytes = kDefaultCoalesceMaxBytes);
+
+  // Messages of at least this size are never coalesced by default.
+  static constexpr int64_t kDefaultCoalesceMaxBytes = 64 * 1024;
 
   const WorkerInfo& getWorkerInfo(const std::string& workerName) const override;
 
@@ -76,6 +91,27 @@ class ProcessGroupAgent : public RpcAgent {
   std::shared_ptr<FutureMessage> send(const WorkerInfo& to, Message&& message)
       override;
 
+  // The methods below move messages over the wire. The ProcessGroup is always
+  // used to resolve names and detect termination, but subclasses can replace
+  // how messages are sent and received by overriding these.
+
+  // handle a SendWork request. This serializes the payload inside the work
+  // object, and sends the message to the receiver using the underlying
+  // ProcessGroup.
+  virtual void handleSend(const SendWork& work);
+  // receiving messages, runs on the listener thread until shutdown. Received
+  // messages are passed to enqueueRecv.
+  virtual void listenLoop();
+  // called during shutdown to make listenLoop return.
+  virtual void interruptListenLoop();
+  // put RecvWork into a queue and notify the worker thread
+  void enqueueRecv(RecvWork work);
+  // record that the message of ``work`` is sent, see [Termination Detection].
+  // handleSend must call this before the message can reach the receiver.
+  // Coalesced messages are already counted when they are added to a batch,
+  // so this does nothing for their batch.
+  void countSend(const SendWork& work);
+
  private:
   using steady_clock_time_point =
       std::chrono::time_point<std::chrono::steady_clock>;
@@ -129,17 +165,37 @@ class ProcessGroupAgent : public RpcAgent {
     FutureInfo() = delete;
   };
 
+  // Note [Message Coalescing]
+  // ~~~~~~~~~~~~~~~~~~~~~~~~~~
+  //
+  // Sending many small messages to the same peer is dominated by the cost of
+  // the individual sends. When coalesceWindow_ is positive, messages smaller
+  // than coalesceMaxBytes_ are not sent right away but appended to a batch for
+  // their destination. A batch is sent as a single MESSAGE_BATCH message once
+  // it has waited for coalesceWindow_ or has grown to coalesceMaxBytes_,
+  // whichever comes first. Larger messages flush the batch of their
+  // destination before they are sent, so they do not overtake it. The receiver
+  // splits the batch and processes its messages independently.
+  struct PendingBatch {
+    std::vector<SendWork> works_;
+    int64_t bytes_ = 0;
+    steady_clock_time_point deadline_;
+  };
+
   void collectNames();
   // put SendWork into a queue and notify the worker thread
   void enqueueSend(SendWork work);
-  // handle a SendWork request. This serializes the payload inside the work
-  // object, and sends the message to the receiver using the underlying
-  // ProcessGroup.
-  void handleSend(const SendWork& work);
-  // put RecvWork into a queue and notify the worker thread
-  void enqueueRecv(RecvWork work);
-  // receiving messages
-  void listenLoop();
+  // append SendWork to the batch of its destination, returns false if
+  // coalescing has stopped.
+  bool coalesceSend(SendWork& work);
+  // send the messages of a batch, must be called with coalesceMutex_ held.
+  void flushBatch(PendingBatch& batch);
+  // flush batches once their deadline has passed, runs until shutdown.
+  void coalesceLoop();
+  // fail the future of a message that could not be sent.
+  void markSendError(const SendWork& work, const std::exception& e);
+  // process a received message on a thread of the thread pool
+  void processMessage(const WorkerInfo& from, Message&& message);
   // poll for timed out RPCs
   void pollTimedOutRPCs();
   // process timed out futures
@@ -203,6 +259,17 @@ class ProcessGroupAgent : public RpcAgent {
   // one mutex per ProcessGroup rank, as ProcessGroup::send is not thread-safe
   // when using the same tag.
   std::vector<std::mutex> sendMutexes_;
+  // Coalescing of small messages, see [Message Coalescing]. The batches are
+  // indexed by destination rank and protected by coalesceMutex_.
+  const std::chrono::microseconds coalesceWindow_;
+  const int64_t coalesceMaxBytes_;
+  std::vector<PendingBatch> pendingBatches_;
+  bool coalesceRunning_{false};
+  std::mutex coalesceMutex_;
+  std::condition_variable coalesceCV_;
+  std::thread coalesceThread_;
+  std::atomic<int64_t> numCoalescedMessages_{0};
+  std::atomic<int64_t> numCoalescedBatches_{0};
   std::thread listenerThread_;
   // A thread to poll existing futures and check for timed out ones.
   std::thread futureTimeoutThread_;
@@ -85,28 +85,32 @@ py::object PyRRef::toHere() {
   if (rref_->isOwner()) {
     return localValue();
   } else {
-    // toHere() calls python_rpc_handler which acquires GIL when UserRRef holds
+    // toPyObj() calls python_rpc_handler which acquires GIL when UserRRef holds
     // a python object
-    std::vector<IValue> rawValues =
-        std::static_pointer_cast<UserRRef>(rref_)->toHere();
-    IValue value;
-    if (rref_->isPyObj()) {
-      value = jit::toIValue(
-          PythonRpcHandler::getInstance().deserialize(
-              SerializedPyObj::fromIValues(std::move(rawValues))),
-          PyObjectType::get());
-    } else {
-      value = std::move(rawValues).front();
-    }
-    {
-      // acquiring GIL as torch::jit::toPyObject creates new py::object
-      // without grabbing the GIL.
-      pybind11::gil_scoped_acquire ag;
-      return torch::jit::toPyObject(std::move(value));
-    }
+    return toPyObj(toHereAsync()->wait());
   }
 }
 
+std::shared_ptr<FutureMessage> PyRRef::toHereAsync() {
+  TORCH_CHECK(
+      !rref_->isOwner(),
+      "Cannot call to_here_async() on the owner of an RRef, use "
+      "local_value() instead.");
+  return std::static_pointer_cast<UserRRef>(rref_)->toHereAsync();
+}
+
+void PyRRef::markImmutable() {
+  // The owner always reads the local value, there is nothing to cache.
+  if (!rref_->isOwner()) {
+    std::static_pointer_cast<UserRRef>(rref_)->markImmutable();
+  }
+}
+
+bool PyRRef::isImmutable() const {
+  return !rref_->isOwner() &&
+      std::static_pointer_cast<UserRRef>(rref_)->isImmutable();
+}
+
 py::object PyRRef::localValue() {
   TORCH_CHECK(
       rref_->isOwner(),
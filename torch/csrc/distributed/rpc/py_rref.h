@@ -19,6 +19,9 @@ class PyRRef {
   bool isOwner() const;
   WorkerInfo owner() const;
   py::object toHere();
+  std::shared_ptr<FutureMessage> toHereAsync();
+  void markImmutable();
+  bool isImmutable() const;
   py::object localValue();
   std::string str() const;
   py::tuple pickle() const;
@@ -119,6 +119,21 @@ py::object toPyObjInternal(RpcCommandBase& rpc, MessageType messageType) {
       return PythonRpcHandler::getInstance().loadPythonUDFResult(
           resp.pickledPayload(), resp.tensors());
     }
+    case MessageType::SCRIPT_RREF_FETCH_RET: {
+      auto& ret = static_cast<RRefFetchRet&>(rpc);
+      IValue value = ret.values().front();
+      {
+        pybind11::gil_scoped_acquire ag;
+        // torch::jit::toPyObject creates new py::object without grabbing the
+        // GIL.
+        return torch::jit::toPyObject(std::move(value));
+      }
+    }
+    case MessageType::PYTHON_RREF_FETCH_RET: {
+      auto& ret = static_cast<RRefFetchRet&>(rpc);
+      return PythonRpcHandler::getInstance().deserialize(
+          SerializedPyObj::fromIValues(ret.values()));
+    }
     default: {
       TORCH_CHECK(false, "Unrecognized response message type ", messageType);
     }
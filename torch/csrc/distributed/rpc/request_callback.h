@@ -16,6 +16,11 @@ class TORCH_API RequestCallback {
 
   virtual ~RequestCallback() {}
 
+  // Blocks until all requests that the callback handed off to threads of its
+  // own have been processed. RpcAgent implementations should call this when
+  // they drain their own threads, e.g. in sync() and shutdown().
+  virtual void waitWorkComplete() const {}
+
  protected:
   // RpcAgent implementation should invoke ``RequestCallback`` to process
   // received requests. There is no restriction on the implementation's
@@ -29,6 +29,117 @@ namespace rpc {
 
 using namespace torch::distributed::autograd;
 
+namespace {
+
+// The parts of a ScriptCall that are needed to run it after the request, which
+// owns the ScriptCall, has been destroyed.
+struct ScriptTask {
+  explicit ScriptTask(ScriptCall& scriptCall)
+      : op(scriptCall.hasOp() ? scriptCall.op() : nullptr),
+        qualifiedName(
+            scriptCall.hasQualifiedName()
+                ? c10::make_optional(scriptCall.qualifiedName())
+                : c10::nullopt),
+        stack(std::move(scriptCall.stackRef())) {}
+
+  // Runs the builtin operator or TorchScript function and returns its result.
+  IValue run() {
+    if (op) {
+      op->getOperation()(stack);
+    } else {
+      PythonRpcHandler::getInstance()
+          .jitCompilationUnit()
+          ->get_function(*qualifiedName)
+          .run(stack);
+    }
+
+    TORCH_INTERNAL_ASSERT(
+        stack.size() == 1,
+        "Return value of a builtin operator or a "
+        "TorchScript function should be a single IValue, got a vector of "
+        "size ",
+        stack.size());
+    return std::move(stack.front());
+  }
+
+  std::shared_ptr<Operator> op;
+  c10::optional<c10::QualifiedName> qualifiedName;
+  std::vector<IValue> stack;
+};
+
+using OwnerRRefCallback = std::function<void(
+    const std::shared_ptr<OwnerRRef>&,
+    const c10::optional<utils::FutureError>&)>;
+
+// Invokes cb once the OwnerRRef for rrefId exists and has a value, inline if
+// that is already the case. A to_here() request can arrive before the remote
+// call that creates the OwnerRRef, and the value is set asynchronously by the
+// remote call, so waiting for either would hold up one of the agent's threads.
+void whenOwnerRRefReady(const RRefId& rrefId, OwnerRRefCallback cb) {
+  RRefContext::getInstance().getOwnerRRefAsync(rrefId)->addCallback(
+      [cb](
+          const std::shared_ptr<OwnerRRef>& rref,
+          const c10::optional<utils::FutureError>& error) {
+        if (error) {
+          cb(rref, error);
+          return;
+        }
+        rref->getFuture()->addCallback(
+            [cb, rref](
+                const Message& /* unused */,
+                const c10::optional<utils::FutureError>& error) {
+              cb(rref, error);
+            });
+      });
+}
+
+} // namespace
+
+RequestCallbackImpl::RequestCallbackImpl(int numScriptThreads)
+    : scriptThreadPool_(numScriptThreads) {}
+
+void RequestCallbackImpl::waitWorkComplete() const {
+  scriptThreadPool_.waitWorkComplete();
+}
+
+std::shared_ptr<FutureMessage> RequestCallbackImpl::runOnScriptThreadPool(
+    std::function<Message()> fn,
+    int64_t messageId) const {
+  auto responseFuture = std::make_shared<FutureMessage>();
+  auto& autogradContainer = DistAutogradContainer::getInstance();
+  // The current autograd context is thread local, it has to be set on the
+  // thread that runs the request so that nested RPCs are attached to it.
+  c10::optional<int64_t> contextId;
+  if (autogradContainer.hasValidContext()) {
+    contextId = autogradContainer.currentContext()->contextId();
+  }
+  scriptThreadPool_.run([fn, messageId, contextId, responseFuture]() {
+    auto& autogradContainer = DistAutogradContainer::getInstance();
+    if (contextId) {
+      autogradContainer.setCurrentContextId(*contextId);
+    }
+    // Completing the future runs the agent's callbacks, which must not
+    // happen inside the try block: their errors aren't the request's errors.
+    c10::optional<Message> response;
+    std::string error;
+    try {
+      response = fn();
+      response->setId(messageId);
+    } catch (std::exception& e) {
+      LOG(ERROR) << "Received error while processing TorchScript request: "
+                 << e.what();
+      error = e.what();
+    }
+    autogradContainer.clearCurrentContext();
+    if (response) {
+      responseFuture->markCompleted(std::move(*response));
+    } else {
+      responseFuture->setError(std::move(error));
+    }
+  });
+  return responseFuture;
+}
+
 std::shared_ptr<FutureMessage> RequestCallbackImpl::processRpc(
     RpcCommandBase& rpc,
     MessageType messageType,
@@ -46,27 +157,13 @@ std::shared_ptr<FutureMessage> RequestCallbackImpl::processRpc(
   // to a python object.
   switch (messageType) {
     case MessageType::SCRIPT_CALL: {
-      auto& scriptCall = static_cast<ScriptCall&>(rpc);
-
-      // scriptCall is only alive within this block, use reference to avoid copy
-      auto& stack = scriptCall.stackRef();
-      if (scriptCall.hasOp()) {
-        scriptCall.op()->getOperation()(stack);
-      } else {
-        PythonRpcHandler::getInstance()
-            .jitCompilationUnit()
-            ->get_function(scriptCall.qualifiedName())
-            .run(stack);
-      }
-
-      TORCH_INTERNAL_ASSERT(
-          stack.size() == 1,
-          "Return value of a builtin operator or a "
-          "TorchScript function should be a single IValue, got a vector of "
-          "size ",
-          stack.size());
-
-      return wrap(std::move(ScriptResp(std::move(stack.front()))).toMessage());
+      // scriptCall is only alive within this block, move its arguments to
+      // the task instead of copying them.
+      auto task =
+          std::make_shared<ScriptTask>(static_cast<ScriptCall&>(rpc));
+      return runOnScriptThreadPool(
+          [task]() { return std::move(ScriptResp(task->run())).toMessage(); },
+          messageId);
     }
     case MessageType::PYTHON_CALL: {
       auto& pyCall = static_cast<PythonCall&>(rpc);
@@ -95,35 +192,23 @@ std::shared_ptr<FutureMessage> RequestCallbackImpl::processRpc(
                          .type();
       }
 
+      // Create the OwnerRRef right away, so that to_here() requests that
+      // arrive while the function runs only wait for its value.
       auto ownerRRef =
           ctx.getOrCreateOwnerRRef(scriptRemoteCall.retRRefId(), returnType);
 
-      // TODO: make this asynchronous
-      // scriptRemoteCall is only alive within this block, use reference to
-      // avoid copy
-      auto& stack = scriptRemoteCall.stackRef();
-      if (scriptRemoteCall.hasOp()) {
-        scriptRemoteCall.op()->getOperation()(stack);
-      } else {
-        PythonRpcHandler::getInstance()
-            .jitCompilationUnit()
-            ->get_function(scriptRemoteCall.qualifiedName())
-            .run(stack);
-      }
-
-      TORCH_INTERNAL_ASSERT(
-          stack.size() == 1,
-          "Return value of a builtin operator or a "
-          "TorchScript function should be a single IValue, got a vector of "
-          "size ",
-          stack.size());
-
-      ownerRRef->setValue(std::move(stack.front()));
-      ctx.addForkOfOwner(
-          scriptRemoteCall.retRRefId(), scriptRemoteCall.retForkId());
-      return wrap(
-          RemoteRet(scriptRemoteCall.retRRefId(), scriptRemoteCall.retForkId())
-              .toMessage());
+      // scriptRemoteCall is only alive within this block, move its arguments
+      // to the task instead of copying them.
+      auto task = std::make_shared<ScriptTask>(scriptRemoteCall);
+      auto rrefId = scriptRemoteCall.retRRefId();
+      auto forkId = scriptRemoteCall.retForkId();
+      return runOnScriptThreadPool(
+          [task, ownerRRef, rrefId, forkId]() {
+            ownerRRef->setValue(task->run());
+            RRefContext::getInstance().addForkOfOwner(rrefId, forkId);
+            return RemoteRet(rrefId, forkId).toMessage();
+          },
+          messageId);
     }
     case MessageType::PYTHON_REMOTE_CALL: {
       auto& prc = static_cast<PythonRemoteCall&>(rpc);
@@ -155,18 +240,13 @@ std::shared_ptr<FutureMessage> RequestCallbackImpl::processRpc(
     }
     case MessageType::SCRIPT_RREF_FETCH_CALL: {
       auto& srf = static_cast<ScriptRRefFetchCall&>(rpc);
-      auto& ctx = RRefContext::getInstance();
-      std::shared_ptr<OwnerRRef> rref = ctx.getOwnerRRef(srf.rrefId());
-      if (rref->hasValue()) { // optional fast-path
-        return wrap(ScriptRRefFetchRet({rref->getValue()}).toMessage());
-      }
-      auto whenValueSet = rref->getFuture();
       auto responseFuture = std::make_shared<FutureMessage>();
 
-      // Our response is satisfied when the rpcs come back.
-      whenValueSet->addCallback(
-          [responseFuture, messageId, rref](
-              const rpc::Message& /* unused */,
+      // Our response is satisfied when the value is set.
+      whenOwnerRRefReady(
+          srf.rrefId(),
+          [responseFuture, messageId](
+              const std::shared_ptr<OwnerRRef>& rref,
               const c10::optional<utils::FutureError>& error) {
             if (!error) {
               Message m = ScriptRRefFetchRet({rref->getValue()}).toMessage();
@@ -180,27 +260,13 @@ std::shared_ptr<FutureMessage> RequestCallbackImpl::processRpc(
     }
     case MessageType::PYTHON_RREF_FETCH_CALL: {
       auto& prf = static_cast<PythonRRefFetchCall&>(rpc);
-      auto& ctx = RRefContext::getInstance();
-      std::shared_ptr<OwnerRRef> rref = ctx.getOwnerRRef(prf.rrefId());
-      if (rref->hasValue()) { // optional fast-path
-        auto value = rref->getValue();
-        py::object pyValue;
-        {
-          pybind11::gil_scoped_acquire ag;
-          pyValue = torch::jit::toPyObject(std::move(value));
-        }
-        SerializedPyObj result =
-            PythonRpcHandler::getInstance().serialize(pyValue);
-        return wrap(PythonRRefFetchRet(result.toIValues()).toMessage());
-      }
-
-      auto whenValueSet = rref->getFuture();
       auto responseFuture = std::make_shared<FutureMessage>();
 
-      // Our response is satisfied when the rpcs come back.
-      whenValueSet->addCallback(
-          [responseFuture, messageId, rref](
-              const rpc::Message& /* unused */,
+      // Our response is satisfied when the value is set.
+      whenOwnerRRefReady(
+          prf.rrefId(),
+          [responseFuture, messageId](
+              const std::shared_ptr<OwnerRRef>& rref,
               const c10::optional<utils::FutureError>& error) {
             if (!error) {
               auto value = rref->getValue();
@@ -294,25 +360,37 @@ std::shared_ptr<FutureMessage> RequestCallbackImpl::processRpc(
     case MessageType::BACKWARD_AUTOGRAD_REQ: {
       auto& gradientsCall = static_cast<PropagateGradientsReq&>(rpc);
       const auto& autogradMetadata = gradientsCall.getAutogradMetadata();
+      const auto& grads = gradientsCall.getGrads();
+      TORCH_INTERNAL_ASSERT(!autogradMetadata.empty());
 
-      // Retrieve the appropriate autograd context.
+      // Retrieve the appropriate autograd context. All gradients of a request
+      // belong to the same context.
       auto autogradContext =
           DistAutogradContainer::getInstance().retrieveContext(
-              autogradMetadata.autogradContextId);
-
-      // Lookup the appropriate 'send' function to enqueue.
-      std::shared_ptr<SendRpcBackward> sendFunction =
-          autogradContext->retrieveSendFunction(
-              autogradMetadata.autogradMessageId);
-
-      // Attach the gradients to the send function.
-      sendFunction->setGrads(gradientsCall.getGrads());
+              autogradMetadata.front().autogradContextId);
+
+      std::vector<std::shared_ptr<torch::autograd::Node>> sendFunctions;
+      sendFunctions.reserve(autogradMetadata.size());
+      for (size_t i = 0; i < autogradMetadata.size(); ++i) {
+        TORCH_INTERNAL_ASSERT(
+            autogradMetadata[i].autogradContextId ==
+            autogradContext->contextId());
+
+        // Lookup the appropriate 'send' function to enqueue.
+        std::shared_ptr<SendRpcBackward> sendFunction =
+            autogradContext->retrieveSendFunction(
+                autogradMetadata[i].autogradMessageId);
+
+        // Attach the gradients to the send function.
+        sendFunction->setGrads(grads[i]);
+        sendFunctions.push_back(std::move(sendFunction));
+      }
 
       auto responseFuture = std::make_shared<rpc::FutureMessage>();
 
       // Now execute the autograd graph using the "distributed engine."
-      auto execFuture = DistEngine::getInstance().executeSendFunctionAsync(
-          autogradContext, sendFunction, gradientsCall.retainGraph());
+      auto execFuture = DistEngine::getInstance().executeSendFunctionsAsync(
+          autogradContext, sendFunctions, gradientsCall.retainGraph());
 
       // Our response is satisfied when the rpcs come back.
       execFuture->addCallback(
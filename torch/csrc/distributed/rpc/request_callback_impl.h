@@ -1,23 +1,43 @@
 #pragma once
 
+#include <c10/core/thread_pool.h>
 #include <torch/csrc/distributed/rpc/message.h>
 #include <torch/csrc/distributed/rpc/request_callback.h>
 #include <torch/csrc/distributed/rpc/rpc_command_base.h>
 
+#include <functional>
+
 namespace torch {
 namespace distributed {
 namespace rpc {
 
 class TORCH_API RequestCallbackImpl : public RequestCallback {
  public:
+  // TorchScript requests (SCRIPT_CALL and SCRIPT_REMOTE_CALL) don't need the
+  // GIL, so they run on a pool of numScriptThreads threads of their own
+  // instead of the agent's threads. This way they can't get stuck behind
+  // Python UDFs that occupy all of the agent's threads waiting for the GIL.
+  explicit RequestCallbackImpl(int numScriptThreads);
+
   std::shared_ptr<FutureMessage> processMessage(
       Message& request) const override;
 
+  void waitWorkComplete() const override;
+
  private:
   std::shared_ptr<FutureMessage> processRpc(
       RpcCommandBase& rpc,
       MessageType messageType,
       int64_t messageId) const;
+
+  // Runs fn on scriptThreadPool_ and returns a future to the message it
+  // returns, or to the error it throws. The autograd context of the calling
+  // thread is carried over.
+  std::shared_ptr<FutureMessage> runOnScriptThreadPool(
+      std::function<Message()> fn,
+      int64_t messageId) const;
+
+  mutable c10::ThreadPool scriptThreadPool_;
 };
 
 } // namespace rpc
@@ -44,6 +44,7 @@ std::vector<std::shared_ptr<RRef>> RRefContext::destroyInstance(
     }
   }
   ctx.owners_.clear();
+  ctx.pendingOwners_.clear();
   return deletedRRefs;
 }
 
@@ -174,7 +175,7 @@ std::shared_ptr<RRef> RRefContext::getOrCreateRRef(
 std::shared_ptr<OwnerRRef> RRefContext::getOrCreateOwnerRRef(
     const RRefId& rrefId,
     const TypePtr& type) {
-  std::lock_guard<std::mutex> lock(mutex_);
+  std::unique_lock<std::mutex> lock(mutex_);
   const auto iter = owners_.find(rrefId);
   if (iter == owners_.end()) {
     // Scenario (1) the first time this owner knows about this RRef
@@ -184,7 +185,18 @@ std::shared_ptr<OwnerRRef> RRefContext::getOrCreateOwnerRRef(
     auto rref =
         std::shared_ptr<OwnerRRef>(new OwnerRRef(getWorkerId(), rrefId, type));
     owners_[rref->rrefId()] = rref;
+    std::shared_ptr<utils::Future<std::shared_ptr<OwnerRRef>>> pending;
+    const auto pendingIter = pendingOwners_.find(rrefId);
+    if (pendingIter != pendingOwners_.end()) {
+      pending = std::move(pendingIter->second);
+      pendingOwners_.erase(pendingIter);
+    }
+    lock.unlock();
     ownerCV_.notify_all();
+    // Callbacks run inline, so this must not hold mutex_.
+    if (pending) {
+      pending->markCompleted(rref);
+    }
     return rref;
   } else {
     // Scenario (2) retrieving an existing RRef
@@ -216,6 +228,23 @@ std::shared_ptr<OwnerRRef> RRefContext::getOwnerRRef(const RRefId& rrefId) {
   }
 }
 
+std::shared_ptr<utils::Future<std::shared_ptr<OwnerRRef>>> RRefContext::
+    getOwnerRRefAsync(const RRefId& rrefId) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto iter = owners_.find(rrefId);
+  if (iter != owners_.end()) {
+    return std::make_shared<utils::Future<std::shared_ptr<OwnerRRef>>>(
+        std::static_pointer_cast<OwnerRRef>(iter->second));
+  }
+  // RRef is used before it is created, getOrCreateOwnerRRef() completes the
+  // future.
+  auto& pending = pendingOwners_[rrefId];
+  if (!pending) {
+    pending = std::make_shared<utils::Future<std::shared_ptr<OwnerRRef>>>();
+  }
+  return pending;
+}
+
 RRefForkData RRefContext::prepareChildFork(const std::shared_ptr<RRef>& rref) {
   auto rrefForkData = rref->fork();
   if (rref->isOwner()) {
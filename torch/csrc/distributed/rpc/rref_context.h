@@ -82,6 +82,11 @@ class TORCH_API RRefContext {
 
   std::shared_ptr<OwnerRRef> getOwnerRRef(const RRefId& rrefId);
 
+  // Same as getOwnerRRef(), but instead of blocking until the OwnerRRef has
+  // been created, returns a future that is completed with it.
+  std::shared_ptr<utils::Future<std::shared_ptr<OwnerRRef>>> getOwnerRRefAsync(
+      const RRefId& rrefId);
+
   // Adding the RRefId of an OwnerRRef into the forks_ map. This is useful when
   // making a remote call to self, which as for now, still goes through serde
   // and invokes request callback. In this case, the OwnerRRef has already been
@@ -177,6 +182,13 @@ class TORCH_API RRefContext {
   // TODO: As OwnerRRef::getValue() is always called after
   // OwnerRRef::setValue(), we should be able to remove the CV from OwnerRRef.
   std::condition_variable ownerCV_;
+  // Futures handed out by getOwnerRRefAsync() for OwnerRRefs that haven't
+  // been created yet. The same reasoning as for ownerCV_ applies.
+  std::unordered_map<
+      RRefId,
+      std::shared_ptr<utils::Future<std::shared_ptr<OwnerRRef>>>,
+      RRefId::Hash>
+      pendingOwners_;
   // Tracks known living UserRRefs of an OwnerRRef
   std::unordered_map<
       RRefId,
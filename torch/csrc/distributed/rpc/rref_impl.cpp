@@ -1,5 +1,6 @@
 #include <torch/csrc/distributed/rpc/rref_impl.h>
 
+#include <torch/csrc/distributed/autograd/context/container.h>
 #include <torch/csrc/distributed/autograd/rpc_messages/rpc_with_autograd.h>
 #include <torch/csrc/distributed/autograd/utils.h>
 #include <torch/csrc/distributed/rpc/rref_context.h>
@@ -78,6 +79,33 @@ const ForkId& UserRRef::forkId() const {
 }
 
 std::vector<IValue> UserRRef::toHere() {
+  const Message& message = toHereAsync()->wait();
+  MessageType msgType = message.type();
+  auto response = deserializeResponse(message, msgType);
+  TORCH_INTERNAL_ASSERT(
+      msgType == MessageType::SCRIPT_RREF_FETCH_RET ||
+          msgType == MessageType::PYTHON_RREF_FETCH_RET,
+      "Message type should either be SCRIPT_RREF_FETCH_RET "
+      "or PYTHON_RREF_FETCH_RET");
+  RpcCommandBase& rpc = *response;
+  auto& rrefFetchRet = static_cast<RRefFetchRet&>(rpc);
+  return rrefFetchRet.values();
+}
+
+std::shared_ptr<FutureMessage> UserRRef::toHereAsync() {
+  const bool useCache = immutable_ &&
+      !autograd::DistAutogradContainer::getInstance().hasValidContext();
+  std::unique_lock<std::mutex> lock(cacheMutex_, std::defer_lock);
+  if (useCache) {
+    // Concurrent fetches wait for the same response. A failed fetch is
+    // retried.
+    lock.lock();
+    if (cachedValue_ &&
+        !(cachedValue_->completed() && cachedValue_->hasError())) {
+      return cachedValue_;
+    }
+  }
+
   auto agent = RpcAgent::getCurrentRpcAgent();
 
   // ScriptRRefFetchCall message always carries autograd context id even if
@@ -97,17 +125,18 @@ std::vector<IValue> UserRRef::toHere() {
       std::move(msgToSend),
       true /* forceGradRecording */);
 
-  const Message& message = futureResponse->wait();
-  MessageType msgType = message.type();
-  auto response = deserializeResponse(message, msgType);
-  TORCH_INTERNAL_ASSERT(
-      msgType == MessageType::SCRIPT_RREF_FETCH_RET ||
-          msgType == MessageType::PYTHON_RREF_FETCH_RET,
-      "Message type should either be SCRIPT_RREF_FETCH_RET "
-      "or PYTHON_RREF_FETCH_RET");
-  RpcCommandBase& rpc = *response;
-  auto& rrefFetchRet = static_cast<RRefFetchRet&>(rpc);
-  return rrefFetchRet.values();
+  if (useCache) {
+    cachedValue_ = futureResponse;
+  }
+  return futureResponse;
+}
+
+void UserRRef::markImmutable() {
+  immutable_ = true;
+}
+
+bool UserRRef::isImmutable() const {
+  return immutable_;
 }
 
 //////////////////////////  OwnerRRef  /////////////////////////////////////
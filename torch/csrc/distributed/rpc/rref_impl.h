@@ -239,6 +239,19 @@ class TORCH_API UserRRef final : public RRef {
   // yet, this call will block.
   std::vector<IValue> toHere();
 
+  // Non-blocking version of toHere(). The returned future completes with the
+  // SCRIPT_RREF_FETCH_RET or PYTHON_RREF_FETCH_RET response of the owner.
+  // For an immutable RRef, the future of the first fetch is cached and
+  // returned again by later calls, unless a distributed autograd context is
+  // active, as fetching then records autograd functions in that context.
+  std::shared_ptr<FutureMessage> toHereAsync();
+
+  // Declares that the value of this RRef never changes, which allows caching
+  // it locally (see toHereAsync()). Values served from the cache share their
+  // tensors, so they must not be modified in-place either.
+  void markImmutable();
+  bool isImmutable() const;
+
   // Upon destruction, this ``UserRRef`` will tell the owner to deref.
   ~UserRRef() override;
 
@@ -252,6 +265,11 @@ class TORCH_API UserRRef final : public RRef {
       TypePtr type);
 
   const ForkId forkId_;
+
+  std::atomic<bool> immutable_{false};
+  // Guards cachedValue_, which holds the fetch of an immutable RRef.
+  std::mutex cacheMutex_;
+  std::shared_ptr<FutureMessage> cachedValue_;
 };
 
 // Keep the template only on the derived class because ``RRefContext`` needs to
@@ -0,0 +1,437 @@
+#include <torch/csrc/distributed/rpc/socket_agent.h>
+
+#include <c10d/Utils.hpp>
+#include <torch/csrc/ShmRingBuffer.h>
+#include <torch/csrc/distributed/rpc/utils.h>
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <system_error>
+
+namespace torch {
+namespace distributed {
+namespace rpc {
+
+namespace {
+
+const std::string kStoreKeyPrefix = "SocketAgent/";
+
+std::string getKey(const std::string& name, worker_id_t id) {
+  return kStoreKeyPrefix + name + "/" + c10::to_string(id);
+}
+
+std::string getValue(c10d::Store& store, const std::string& key) {
+  auto value = store.get(key);
+  return std::string(value.begin(), value.end());
+}
+
+void setValue(
+    c10d::Store& store,
+    const std::string& key,
+    const std::string& value) {
+  store.set(key, std::vector<uint8_t>(value.begin(), value.end()));
+}
+
+// Every message starts with its type, its id, the size of the serialized
+// message written by wireSerializeDetached() and the region of the ring that
+// holds the message: its begin and end, and the offset of its data in the
+// buffer. The begin is -1 for a message sent over the socket, where the
+// serialized message and the tensor data buffers follow. Otherwise the sizes
+// of the tensor data buffers follow, and the serialized message and the
+// buffers are laid out one after the other in the region.
+constexpr size_t kMessageMetaSize = 6;
+
+// Capacity of the ring to every worker on the same host. Shared memory is
+// only backed by pages once they are written, so this mostly bounds the size
+// of the messages that go through the ring.
+constexpr int64_t kShmRingCapacity = 64 * 1024 * 1024;
+
+int64_t alignedSize(int64_t nbytes) {
+  const auto alignment = dataloader::ShmRingBuffer::kAlignment;
+  return (nbytes + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+SocketAgent::SocketAgent(
+    std::string workerName,
+    std::shared_ptr<c10d::ProcessGroup> pg,
+    std::shared_ptr<c10d::Store> store,
+    int numSendRecvThreads,
+    int numIoThreads,
+    std::chrono::milliseconds rpcTimeout,
+    std::chrono::microseconds coalesceWindow,
+    int64_t coalesceMaxBytes)
+    : ProcessGroupAgent(
+          std::move(workerName),
+          std::move(pg),
+          numSendRecvThreads,
+          rpcTimeout,
+          coalesceWindow,
+          coalesceMaxBytes),
+      numIoThreads_(numIoThreads) {
+  TORCH_CHECK(
+      numIoThreads_ > 0,
+      "SocketAgent requires at least one I/O thread, but got ",
+      numIoThreads_);
+  if (pipe(controlPipeFd_.data()) == -1) {
+    throw std::system_error(errno, std::system_category());
+  }
+  connect(*store);
+}
+
+SocketAgent::~SocketAgent() {
+  shutdown();
+  for (auto& connection : connections_) {
+    if (connection->socket != -1) {
+      ::close(connection->socket);
+    }
+  }
+  for (auto fd : controlPipeFd_) {
+    if (fd != -1) {
+      ::close(fd);
+    }
+  }
+}
+
+// Every worker publishes the address of a listening socket in the store. It
+// then connects to all workers with a larger id and accepts connections from
+// all workers with a smaller id. Connecting first never blocks on a peer that
+// is accepting, as connections complete in the listen backlog.
+void SocketAgent::connect(c10d::Store& store) {
+  const auto rank = workerInfo_.id_;
+  const auto worldSize = (worker_id_t)getWorkerInfos().size();
+
+  int listenSocket;
+  c10d::PortType port;
+  std::tie(listenSocket, port) = c10d::tcputil::listen(0);
+  c10d::ResourceGuard listenGuard([listenSocket] { ::close(listenSocket); });
+
+  const auto hostNameMax = sysconf(_SC_HOST_NAME_MAX);
+  std::vector<char> hostnameBuffer(hostNameMax + 1, 0);
+  SYSCHECK_ERR_RETURN_NEG1(gethostname(hostnameBuffer.data(), hostNameMax));
+  const std::string hostname(hostnameBuffer.data());
+  setValue(store, getKey("host", rank), hostname);
+  setValue(store, getKey("port", rank), c10::to_string(port));
+
+  connections_.reserve(worldSize);
+  for (worker_id_t peer = 0; peer < worldSize; ++peer) {
+    connections_.emplace_back(std::make_unique<Connection>());
+  }
+
+  for (worker_id_t peer = rank + 1; peer < worldSize; ++peer) {
+    auto peerHost = getValue(store, getKey("host", peer));
+    auto peerPort = c10::stoi(getValue(store, getKey("port", peer)));
+    // Use the loopback interface for workers on the same host.
+    if (peerHost == hostname) {
+      peerHost = "127.0.0.1";
+    }
+    int socket = c10d::tcputil::connect(
+        peerHost, peerPort, /* wait */ true, c10d::Store::kDefaultTimeout);
+    c10d::tcputil::sendValue<worker_id_t>(socket, rank);
+    connections_[peer]->socket = socket;
+  }
+
+  for (worker_id_t i = 0; i < rank; ++i) {
+    int socket = std::get<0>(
+        c10d::tcputil::accept(listenSocket, c10d::Store::kDefaultTimeout));
+    auto peer = c10d::tcputil::recvValue<worker_id_t>(socket);
+    if (peer < 0 || peer >= rank || connections_[peer]->socket != -1) {
+      ::close(socket);
+      TORCH_CHECK(
+          false, "SocketAgent got an unexpected connection from worker ", peer);
+    }
+    connections_[peer]->socket = socket;
+  }
+
+  std::vector<worker_id_t> localPeers;
+  for (worker_id_t peer = 0; peer < worldSize; ++peer) {
+    if (peer != rank && getValue(store, getKey("host", peer)) == hostname) {
+      localPeers.push_back(peer);
+    }
+  }
+  connectShmRings(localPeers);
+}
+
+// Every worker creates a ring for its messages to each worker on the same
+// host and sends its name over their socket. Once the peer has mapped it, the
+// name is removed, so that the ring goes away with the two workers. A
+// direction whose ring could not be created or mapped keeps using the socket.
+// All names are sent before any is received, so no pair of workers waits on
+// each other.
+void SocketAgent::connectShmRings(const std::vector<worker_id_t>& localPeers) {
+  for (auto peer : localPeers) {
+    auto& connection = *connections_[peer];
+    try {
+      connection.sendRing =
+          dataloader::ShmRingBuffer::create(kShmRingCapacity);
+    } catch (const std::exception& e) {
+      LOG(WARNING) << "SocketAgent sends to worker " << peer
+                   << " over its socket: " << e.what();
+    }
+    c10d::tcputil::sendString(
+        connection.socket,
+        connection.sendRing ? connection.sendRing->name() : std::string());
+  }
+
+  for (auto peer : localPeers) {
+    auto& connection = *connections_[peer];
+    auto name = c10d::tcputil::recvString(connection.socket);
+    if (!name.empty()) {
+      try {
+        connection.recvRing = dataloader::ShmRingBuffer::attach(name);
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "SocketAgent receives from worker " << peer
+                     << " over its socket: " << e.what();
+      }
+    }
+    c10d::tcputil::sendValue<uint8_t>(
+        connection.socket, connection.recvRing ? 1 : 0);
+  }
+
+  for (auto peer : localPeers) {
+    auto& connection = *connections_[peer];
+    auto attached = c10d::tcputil::recvValue<uint8_t>(connection.socket);
+    if (connection.sendRing) {
+      connection.sendRing->unlink();
+      if (!attached) {
+        connection.sendRing.reset();
+      }
+    }
+  }
+}
+
+void SocketAgent::start() {
+  ProcessGroupAgent::start();
+  for (int i = 1; i < numIoThreads_; ++i) {
+    ioThreads_.emplace_back(&SocketAgent::ioLoop, this, i);
+  }
+}
+
+void SocketAgent::shutdown() {
+  ProcessGroupAgent::shutdown();
+  for (auto& thread : ioThreads_) {
+    thread.join();
+  }
+  ioThreads_.clear();
+}
+
+void SocketAgent::handleSend(const SendWork& work) {
+  // The tensor data is written straight from the tensor storages.
+  auto serialized =
+      wireSerializeDetached(work.message_.payload(), work.message_.tensors());
+  const auto& header = serialized.first;
+  const auto& tensorData = serialized.second;
+
+  int64_t meta[kMessageMetaSize] = {(int64_t)work.message_.type(),
+                                    work.message_.id(),
+                                    (int64_t)header.size(),
+                                    -1,
+                                    -1,
+                                    -1};
+
+  const auto dst = work.to_.id_;
+  auto& connection = *connections_[dst];
+  TORCH_CHECK(
+      connection.socket != -1, "SocketAgent has no connection to worker ", dst);
+
+  countSend(work);
+
+  if (sendThroughRing(connection, meta, header, tensorData)) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> guard(connection.sendMutex);
+  c10d::tcputil::sendBytes<int64_t>(
+      connection.socket, meta, kMessageMetaSize, true);
+  c10d::tcputil::sendBytes<char>(
+      connection.socket, header.data(), header.size(), !tensorData.empty());
+  for (size_t i = 0; i < tensorData.size(); ++i) {
+    c10d::tcputil::sendBytes<char>(
+        connection.socket,
+        static_cast<const char*>(tensorData[i].data_ptr()),
+        tensorData[i].numel(),
+        (i != tensorData.size() - 1));
+  }
+}
+
+bool SocketAgent::sendThroughRing(
+    Connection& connection,
+    int64_t* meta,
+    const std::string& header,
+    const std::vector<torch::Tensor>& tensorData) {
+  if (!connection.sendRing) {
+    return false;
+  }
+  int64_t nbytes = alignedSize(header.size());
+  std::vector<int64_t> dataSizes;
+  dataSizes.reserve(tensorData.size());
+  for (const auto& data : tensorData) {
+    dataSizes.push_back(data.numel());
+    nbytes += alignedSize(data.numel());
+  }
+
+  c10::optional<dataloader::ShmRingBuffer::Region> region;
+  {
+    std::lock_guard<std::mutex> guard(connection.sendMutex);
+    region = connection.sendRing->allocate(nbytes);
+  }
+  if (!region) {
+    return false;
+  }
+
+  // The region is ours, so the copy does not hold up other senders to the
+  // same worker. Their messages may take over this one on the socket, which
+  // the ring allows as regions are released in any order.
+  auto& ring = *connection.sendRing;
+  int64_t offset = region->offset;
+  ring.write(
+      offset,
+      torch::from_blob(
+          const_cast<char*>(header.data()),
+          {(int64_t)header.size()},
+          {torch::kChar}));
+  offset += alignedSize(header.size());
+  for (const auto& data : tensorData) {
+    ring.write(offset, data);
+    offset += alignedSize(data.numel());
+  }
+
+  meta[3] = region->begin;
+  meta[4] = region->end;
+  meta[5] = region->offset;
+  std::lock_guard<std::mutex> guard(connection.sendMutex);
+  c10d::tcputil::sendBytes<int64_t>(
+      connection.socket, meta, kMessageMetaSize, true);
+  c10d::tcputil::sendVector<int64_t>(connection.socket, dataSizes);
+  return true;
+}
+
+void SocketAgent::listenLoop() {
+  ioLoop(0);
+}
+
+void SocketAgent::interruptListenLoop() {
+  if (controlPipeFd_[1] != -1) {
+    // close the write end of the pipe to wake up all I/O threads
+    ::close(controlPipeFd_[1]);
+    controlPipeFd_[1] = -1;
+  }
+}
+
+void SocketAgent::ioLoop(int index) {
+  // Every I/O thread waits on every numIoThreads_-th socket.
+  std::vector<struct pollfd> fds;
+  std::vector<worker_id_t> peers;
+  auto addFd = [&](int fd, short events, worker_id_t peer) {
+    struct pollfd pfd {};
+    pfd.fd = fd;
+    pfd.events = events;
+    fds.push_back(pfd);
+    peers.push_back(peer);
+  };
+  addFd(controlPipeFd_[0], POLLHUP, -1);
+  for (size_t peer = index; peer < connections_.size();
+       peer += numIoThreads_) {
+    if (connections_[peer]->socket != -1) {
+      addFd(connections_[peer]->socket, POLLIN, peer);
+    }
+  }
+
+  while (true) {
+    for (auto& fd : fds) {
+      fd.revents = 0;
+    }
+
+    SYSCHECK_ERR_RETURN_NEG1(::poll(fds.data(), fds.size(), -1));
+
+    // The control pipe is closed when the agent shuts down.
+    if (fds[0].revents != 0) {
+      return;
+    }
+
+    for (size_t i = 1; i < fds.size(); ++i) {
+      if (fds[i].revents == 0) {
+        continue;
+      }
+      try {
+        recvMessage(peers[i]);
+      } catch (const std::exception& e) {
+        // The peer closed the connection, which is expected once it has shut
+        // down. Messages that were still expected from it will time out.
+        LOG(INFO) << "SocketAgent stops receiving from worker " << peers[i]
+                  << ": " << e.what();
+        fds.erase(fds.begin() + i);
+        peers.erase(peers.begin() + i);
+        --i;
+      }
+    }
+  }
+}
+
+void SocketAgent::recvMessage(worker_id_t peer) {
+  auto& connection = *connections_[peer];
+  const auto socket = connection.socket;
+
+  int64_t meta[kMessageMetaSize];
+  c10d::tcputil::recvBytes<int64_t>(socket, meta, kMessageMetaSize);
+  auto type = MessageType(meta[0]);
+  auto id = meta[1];
+  auto size = meta[2];
+
+  if (meta[3] != -1) {
+    TORCH_CHECK(
+        connection.recvRing,
+        "SocketAgent got a message in shared memory from worker ",
+        peer,
+        " without a ring");
+    // The tensors view the ring, and the region is released once the
+    // deserialized message is done with all of them.
+    auto dataSizes = c10d::tcputil::recvVector<int64_t>(socket);
+    std::vector<dataloader::ShmRingBuffer::TensorSpec> specs;
+    specs.reserve(dataSizes.size() + 1);
+    int64_t offset = meta[5];
+    specs.push_back({offset, torch::kChar, {size}});
+    offset += alignedSize(size);
+    for (auto dataSize : dataSizes) {
+      specs.push_back({offset, torch::kChar, {dataSize}});
+      offset += alignedSize(dataSize);
+    }
+    auto tensors = connection.recvRing->take(meta[3], meta[4], specs);
+    torch::Tensor payload = std::move(tensors[0]);
+    tensors.erase(tensors.begin());
+    enqueueRecv(RecvWork(
+        getWorkerInfo(peer),
+        type,
+        id,
+        std::move(payload),
+        std::move(tensors)));
+    return;
+  }
+
+  torch::Tensor payload = torch::empty({size}, {torch::kChar});
+  c10d::tcputil::recvBytes<char>(
+      socket, static_cast<char*>(payload.data_ptr()), size);
+
+  // Receive the tensor data straight into the storages that the deserialized
+  // tensors will use.
+  std::vector<torch::Tensor> tensorData;
+  for (auto dataSize : wireDetachedTensorDataSizes(payload.data_ptr(), size)) {
+    torch::Tensor data = torch::empty({(int64_t)dataSize}, {torch::kChar});
+    c10d::tcputil::recvBytes<char>(
+        socket, static_cast<char*>(data.data_ptr()), dataSize);
+    tensorData.push_back(std::move(data));
+  }
+
+  enqueueRecv(RecvWork(
+      getWorkerInfo(peer),
+      type,
+      id,
+      std::move(payload),
+      std::move(tensorData)));
+}
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
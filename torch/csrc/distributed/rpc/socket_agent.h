@@ -0,0 +1,105 @@
+#pragma once
+
+#include <c10d/Store.hpp>
+#include <torch/csrc/distributed/rpc/process_group_agent.h>
+
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace torch {
+namespace dataloader {
+class ShmRingBuffer;
+} // namespace dataloader
+
+namespace distributed {
+namespace rpc {
+
+struct SocketRpcBackendOptions : public ProcessGroupRpcBackendOptions {
+  SocketRpcBackendOptions() = default;
+  // Same default as DEFAULT_NUM_IO_THREADS in torch/distributed/rpc.
+  int numIoThreads = 4;
+};
+
+// ``SocketAgent`` is an ``RpcAgent`` that sends messages over its own TCP
+// connections instead of through the ProcessGroup, which is only used to
+// resolve names and to detect termination (see ProcessGroupAgent).
+//
+// Every pair of workers is connected by one socket, set up through the store
+// during construction. Messages are written directly by the thread that sends
+// them, so sends to different peers run in parallel and the tensor data is
+// written straight from the tensor storages. A fixed pool of I/O threads
+// receives messages; each of them waits on a subset of the sockets, so
+// receiving is no longer capped by a single listener thread.
+//
+// Workers on the same host connect over the loopback interface, and in
+// addition set up a shared memory ring (see dataloader::ShmRingBuffer) for
+// each direction. The sender copies a message into its ring outside of the
+// per connection lock and only sends the location of the message over the
+// socket; the receiver's tensors view the ring directly, and their part of it
+// is freed with them. Messages that do not fit in the free part of the ring
+// are sent over the socket.
+class SocketAgent : public ProcessGroupAgent {
+ public:
+  SocketAgent(
+      std::string workerName,
+      std::shared_ptr<c10d::ProcessGroup> pg,
+      std::shared_ptr<c10d::Store> store,
+      int numSendRecvThreads,
+      int numIoThreads,
+      std::chrono::milliseconds rpcTimeout,
+      std::chrono::microseconds coalesceWindow = std::chrono::microseconds(0),
+      int64_t coalesceMaxBytes = kDefaultCoalesceMaxBytes);
+
+  void start() override;
+
+  void shutdown() override;
+
+  ~SocketAgent() override;
+
+ protected:
+  void handleSend(const SendWork& work) override;
+  // Runs the first I/O thread on the listener thread.
+  void listenLoop() override;
+  void interruptListenLoop() override;
+
+ private:
+  struct Connection {
+    int socket = -1;
+    // Writes of different messages to the same socket must not interleave.
+    std::mutex sendMutex;
+    // Shared memory rings to and from a worker on the same host, if any.
+    std::shared_ptr<dataloader::ShmRingBuffer> sendRing;
+    std::shared_ptr<dataloader::ShmRingBuffer> recvRing;
+  };
+
+  // Connects to every other worker, see the constructor.
+  void connect(c10d::Store& store);
+  // Sets up the shared memory rings with the workers on the same host.
+  void connectShmRings(const std::vector<worker_id_t>& localPeers);
+  // Copies the message into the ring of ``connection`` and sends its
+  // location. Returns false, without sending anything, if there is no ring or
+  // the message does not fit in its free part.
+  bool sendThroughRing(
+      Connection& connection,
+      int64_t* meta,
+      const std::string& header,
+      const std::vector<torch::Tensor>& tensorData);
+  // Waits for messages on the sockets of the I/O thread ``index``.
+  void ioLoop(int index);
+  // Receives one message from ``peer`` and enqueues it for processing.
+  void recvMessage(worker_id_t peer);
+
+  const int numIoThreads_;
+  // Indexed by worker id, the entry of this worker has no socket.
+  std::vector<std::unique_ptr<Connection>> connections_;
+  // Closing the write end wakes up the I/O threads during shutdown.
+  std::vector<int> controlPipeFd_{-1, -1};
+  // I/O threads other than the listener thread.
+  std::vector<std::thread> ioThreads_;
+};
+
+} // namespace rpc
+} // namespace distributed
+} // namespace torch
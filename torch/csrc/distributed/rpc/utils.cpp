@@ -156,10 +156,16 @@ namespace {
 //    - "meta"    - metadata for the unpickler
 //    - "0" ...   - tensor sections for the unpickler
 //
+// In the detached format written by wireSerializeDetached(), the tensor
+// sections are listed in the header but their bits are not part of the
+// message; they are transferred as separate buffers.
+//
 // Note that per the header comments, the format is subject to change,
 // and is best used for rpcs, rather than persistent disk storage.
-std::unordered_map<std::string, std::pair<const char*, size_t>>
-parseWireSections(const void* data, size_t data_size) {
+std::vector<std::pair<std::string, size_t>> parseWireHeader(
+    const void* data,
+    size_t data_size,
+    const char** body) {
   const char* ptr = static_cast<const char*>(data);
   const char* endp = ptr + data_size;
 
@@ -198,9 +204,35 @@ parseWireSections(const void* data, size_t data_size) {
   if (!ok) {
     throw std::runtime_error("failed parse");
   }
+  *body = ptr;
+  return headerEnts;
+}
+
+static const char* kMeta = "meta";
+static const char* kPayload = "payload";
 
-  std::unordered_map<std::string, std::pair<const char*, size_t>> out;
+bool isTensorSection(const std::string& name) {
+  return name != kMeta && name != kPayload;
+}
+
+using WireSections =
+    std::unordered_map<std::string, std::pair<const char*, size_t>>;
+
+// Maps the sections in the message to their data. If `detached` is set,
+// the tensor sections are not part of the message and are skipped.
+WireSections parseWireSections(
+    const void* data,
+    size_t data_size,
+    bool detached) {
+  const char* ptr;
+  auto headerEnts = parseWireHeader(data, data_size, &ptr);
+  const char* endp = static_cast<const char*>(data) + data_size;
+
+  WireSections out;
   for (const auto& headerEnt : headerEnts) {
+    if (detached && isTensorSection(headerEnt.first)) {
+      continue;
+    }
     out[headerEnt.first] = {ptr, headerEnt.second};
     ptr += headerEnt.second;
   }
@@ -210,34 +242,10 @@ parseWireSections(const void* data, size_t data_size) {
   return out;
 }
 
-static const char* kMeta = "meta";
-static const char* kPayload = "payload";
-}; // namespace
-
-c10::List<at::Tensor> cloneSparseTensors(
-    const std::vector<at::Tensor>& tensors) {
-  // Sanity-check: If the majority of bits don't need to go over the wire,
-  // force a clone(). Some Tensors are effectively small views, only using
-  // ~1% of the underlying Storage.
-  auto worthRecopying = [](const at::Tensor& t) -> bool {
-    auto storageSize = t.storage().elementSize() * t.storage().numel();
-    auto usefulSize = t.element_size() * t.numel();
-    constexpr size_t kMinMultiple = 2;
-    constexpr size_t kMinRecopyBytes = 8 * 1024;
-    return storageSize >= kMinRecopyBytes &&
-        storageSize >= usefulSize * kMinMultiple;
-  };
-  c10::List<at::Tensor> pTensors;
-  pTensors.reserve(tensors.size());
-  for (const auto& t : tensors) {
-    pTensors.push_back(worthRecopying(t) ? t.clone() : t);
-  }
-  return pTensors;
-}
-
-std::string wireSerialize(
+std::string wireSerializeImpl(
     const std::vector<char>& payload,
-    const std::vector<at::Tensor>& tensors) {
+    const std::vector<at::Tensor>& tensors,
+    std::vector<at::Tensor>* detachedTensorData) {
   struct Ent {
     std::string name;
     const char* data;
@@ -245,7 +253,8 @@ std::string wireSerialize(
   };
   std::vector<Ent> entries;
   std::string metaEntry;
-  std::vector<jit::WriteableTensorData> tensorData;
+  // Shared so that detached tensor data can keep the data() pointers valid.
+  auto tensorData = std::make_shared<std::vector<jit::WriteableTensorData>>();
 
   if (!payload.empty()) {
     entries.push_back({kPayload, payload.data(), payload.size()});
@@ -261,13 +270,12 @@ std::string wireSerialize(
     pickler.protocol();
     pickler.pushIValue(cloneSparseTensors(tensors));
     pickler.stop();
-    // tensorData is in function scope so that the data() pointers stay valid.
-    tensorData = pickler.tensorData();
+    *tensorData = pickler.tensorData();
     entries.push_back({kMeta, metaEntry.data(), metaEntry.size()});
-    for (size_t i = 0; i < tensorData.size(); i++) {
+    for (size_t i = 0; i < tensorData->size(); i++) {
       entries.push_back({c10::to_string(i),
-                         tensorData[i].data(),
-                         tensorData[i].sizeInBytes()});
+                         (*tensorData)[i].data(),
+                         (*tensorData)[i].sizeInBytes()});
     }
   }
 
@@ -286,16 +294,22 @@ std::string wireSerialize(
   out.reserve(header.size() + tot);
   out.append(header);
   for (const auto& e : entries) {
-    out.append(e.data, e.size);
+    if (detachedTensorData && isTensorSection(e.name)) {
+      detachedTensorData->push_back(at::from_blob(
+          const_cast<char*>(e.data),
+          {static_cast<int64_t>(e.size)},
+          [tensorData](void*) {},
+          at::kChar));
+    } else {
+      out.append(e.data, e.size);
+    }
   }
   return out;
 }
 
-std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
-    const void* data,
-    size_t data_size) {
-  auto sections = parseWireSections(data, data_size);
-
+std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserializeImpl(
+    const WireSections& sections,
+    const std::function<at::DataPtr(const std::string&)>& sectionReadFunc) {
   std::vector<char> payload;
   auto payloadIt = sections.find(kPayload);
   if (payloadIt != sections.end() && payloadIt->second.second != 0) {
@@ -318,18 +332,6 @@ std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
       metaDataPos += toCopy;
       return toCopy;
     };
-    auto sectionReadFunc = [&](const std::string& ename) -> at::DataPtr {
-      auto it = sections.find(ename);
-      if (it == sections.end()) {
-        throw std::runtime_error("Couldn't find entity " + ename);
-      }
-      const auto& idat = it->second;
-      auto dptr = at::getCPUAllocator()->allocate(idat.second);
-      if (idat.second != 0) {
-        memcpy(dptr.get(), idat.first, idat.second);
-      }
-      return dptr;
-    };
 
     torch::jit::Unpickler unpickler(
         metaDataReadFunc, nullptr, nullptr, sectionReadFunc, {});
@@ -341,6 +343,94 @@ std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
   return {std::move(payload), std::move(tensors)};
 }
 
+} // namespace
+
+c10::List<at::Tensor> cloneSparseTensors(
+    const std::vector<at::Tensor>& tensors) {
+  // Sanity-check: If the majority of bits don't need to go over the wire,
+  // force a clone(). Some Tensors are effectively small views, only using
+  // ~1% of the underlying Storage.
+  auto worthRecopying = [](const at::Tensor& t) -> bool {
+    auto storageSize = t.storage().elementSize() * t.storage().numel();
+    auto usefulSize = t.element_size() * t.numel();
+    constexpr size_t kMinMultiple = 2;
+    constexpr size_t kMinRecopyBytes = 8 * 1024;
+    return storageSize >= kMinRecopyBytes &&
+        storageSize >= usefulSize * kMinMultiple;
+  };
+  c10::List<at::Tensor> pTensors;
+  pTensors.reserve(tensors.size());
+  for (const auto& t : tensors) {
+    pTensors.push_back(worthRecopying(t) ? t.clone() : t);
+  }
+  return pTensors;
+}
+
+std::string wireSerialize(
+    const std::vector<char>& payload,
+    const std::vector<at::Tensor>& tensors) {
+  return wireSerializeImpl(payload, tensors, nullptr);
+}
+
+std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
+    const void* data,
+    size_t data_size) {
+  auto sections = parseWireSections(data, data_size, /* detached */ false);
+  return wireDeserializeImpl(sections, [&](const std::string& ename) {
+    auto it = sections.find(ename);
+    if (it == sections.end()) {
+      throw std::runtime_error("Couldn't find entity " + ename);
+    }
+    const auto& idat = it->second;
+    auto dptr = at::getCPUAllocator()->allocate(idat.second);
+    if (idat.second != 0) {
+      memcpy(dptr.get(), idat.first, idat.second);
+    }
+    return dptr;
+  });
+}
+
+std::pair<std::string, std::vector<at::Tensor>> wireSerializeDetached(
+    const std::vector<char>& payload,
+    const std::vector<at::Tensor>& tensors) {
+  std::vector<at::Tensor> tensorData;
+  auto serialized = wireSerializeImpl(payload, tensors, &tensorData);
+  return {std::move(serialized), std::move(tensorData)};
+}
+
+std::vector<size_t> wireDetachedTensorDataSizes(
+    const void* data,
+    size_t data_size) {
+  const char* body;
+  std::vector<size_t> sizes;
+  for (const auto& headerEnt : parseWireHeader(data, data_size, &body)) {
+    if (isTensorSection(headerEnt.first)) {
+      sizes.push_back(headerEnt.second);
+    }
+  }
+  return sizes;
+}
+
+std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserializeDetached(
+    const void* data,
+    size_t data_size,
+    const std::vector<at::Tensor>& tensorData) {
+  auto sections = parseWireSections(data, data_size, /* detached */ true);
+  return wireDeserializeImpl(sections, [&](const std::string& ename) {
+    size_t index = c10::stoll(ename);
+    if (index >= tensorData.size()) {
+      throw std::runtime_error("Couldn't find entity " + ename);
+    }
+    // Hand the received storage to the unpickler without copying it.
+    auto storage = tensorData[index].storage();
+    return at::DataPtr(
+        storage.data(),
+        new c10::Storage(storage),
+        [](void* ctx) { delete static_cast<c10::Storage*>(ctx); },
+        at::kCPU);
+  });
+}
+
 } // namespace rpc
 } // namespace distributed
 } // namespace torch
@@ -39,6 +39,30 @@ TORCH_API std::pair<std::vector<char>, std::vector<at::Tensor>> wireDeserialize(
     const void* data,
     size_t data_size);
 
+// Variant of wireSerialize() that leaves the tensor data out of the returned
+// string, which only holds the header, the payload and the tensor metadata.
+// The tensor data is returned as byte tensors that alias the storages, so
+// transports can send it as separate buffers instead of copying it into one
+// contiguous message.
+TORCH_API std::pair<std::string, std::vector<at::Tensor>> wireSerializeDetached(
+    const std::vector<char>& payload,
+    const std::vector<at::Tensor>& tensors);
+
+// Returns the sizes in bytes of the tensor data buffers that belong to a
+// message serialized by wireSerializeDetached(), so that the receiver can
+// allocate them before receiving the data.
+TORCH_API std::vector<size_t> wireDetachedTensorDataSizes(
+    const void* data,
+    size_t data_size);
+
+// Counterpart of wireSerializeDetached(). The deserialized tensors use the
+// storages of the received `tensorData` buffers without copying them.
+TORCH_API std::pair<std::vector<char>, std::vector<at::Tensor>>
+wireDeserializeDetached(
+    const void* data,
+    size_t data_size,
+    const std::vector<at::Tensor>& tensorData);
+
 // Some Tensors are effectively views of larger Tensors, where only a small
 // subset of the Storage data is referenced. This normally is good and avoids
 // copies when kept locally, but if we naively push the whole Storage over the
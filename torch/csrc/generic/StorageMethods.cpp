@@ -198,14 +198,34 @@ static PyObject * THPStorage_(fromFile)(PyObject *_unused, PyObject *args, PyObj
   const char *filename;
   Py_ssize_t size = 0;
   int shared = 0;
-  static char *kwlist[] = {"filename", "shared", "size", nullptr};
-  if (!PyArg_ParseTupleAndKeywords(args, keywds, "s|in", kwlist,
-              &filename, &shared, &size)) {
+  int populate = 0;
+  const char *access = nullptr;
+  int huge_pages = 0;
+  static char *kwlist[] = {"filename", "shared", "size", "populate", "access", "huge_pages", nullptr};
+  if (!PyArg_ParseTupleAndKeywords(args, keywds, "s|inizi", kwlist,
+              &filename, &shared, &size, &populate, &access, &huge_pages)) {
     return nullptr;
   }
-  if (shared)
-    shared = TH_ALLOCATOR_MAPPED_SHARED;
-  THWStorage *storage = THWStorage_(newWithMapping)(LIBRARY_STATE filename, size, shared);
+  int flags = shared ? TH_ALLOCATOR_MAPPED_SHARED : 0;
+  if (populate)
+    flags |= TH_ALLOCATOR_MAPPED_POPULATE;
+  if (huge_pages)
+    flags |= TH_ALLOCATOR_MAPPED_HUGEPAGES;
+  if (access) {
+    if (strcmp(access, "sequential") == 0) {
+      flags |= TH_ALLOCATOR_MAPPED_SEQUENTIAL;
+    } else if (strcmp(access, "random") == 0) {
+      flags |= TH_ALLOCATOR_MAPPED_RANDOM;
+    } else if (strcmp(access, "willneed") == 0) {
+      flags |= TH_ALLOCATOR_MAPPED_WILLNEED;
+    } else {
+      PyErr_Format(PyExc_ValueError,
+        "invalid access '%s' (expected 'sequential', 'random', or 'willneed')",
+        access);
+      return nullptr;
+    }
+  }
+  THWStorage *storage = THWStorage_(newWithMapping)(LIBRARY_STATE filename, size, flags);
   return (PyObject*)THPStorage_(New)(storage);
   END_HANDLE_TH_ERRORS
 }
@@ -1,11 +1,13 @@
 #include <torch/csrc/jit/autodiff.h>
 
 #include <ATen/core/functional.h>
+#include <torch/csrc/jit/fuser/interface.h>
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/operator.h>
 #include <torch/csrc/jit/passes/common_subexpression_elimination.h>
 #include <torch/csrc/jit/passes/constant_pooling.h>
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/inliner.h>
 #include <torch/csrc/jit/passes/lower_tuples.h>
 #include <torch/csrc/jit/script/compiler.h>
@@ -653,6 +655,116 @@ static void Optimize(Gradient& grad_desc, ReverseDetails& rev_info) {
   eliminateDeadCode(rev_info);
 }
 
+// Temporaries of f are captured by writing them out as extra outputs of f, so
+// when f is going to be fused, every temporary saved for df costs a write in
+// the fused forward kernel and a read in the backward one, where it could
+// often be recomputed from values that df reads anyway. Temporaries computed
+// by short chains of fusable pointwise ops, from inputs or outputs of f, are
+// therefore recomputed at the start of the reverse block. The clones are
+// plain pointwise ops, so the fuser merges them into the backward kernels.
+static constexpr size_t kMaxRecomputeDepth = 3;
+
+static bool isInBlock(Node* node, Block* block) {
+  for (Block* b = node->owningBlock(); b != nullptr;) {
+    if (b == block) {
+      return true;
+    }
+    Node* owner = b->owningNode();
+    b = owner ? owner->owningBlock() : nullptr;
+  }
+  return false;
+}
+
+static bool isFusedOnItsDevice(Value* v) {
+  auto type = v->type()->cast<TensorType>();
+  if (!type || !type->device()) {
+    return false;
+  }
+  if (type->device()->is_cuda()) {
+    return canFuseOnGPU();
+  }
+  return type->device()->is_cpu() && canFuseOnCPU();
+}
+
+static void recomputeFusableTemporaries(
+    Gradient& grad_desc,
+    ReverseDetails& rev_info) {
+  auto& graph = *grad_desc.f;
+  Block* reverse_block = rev_info.reverse_block;
+
+  // df can read these without adding outputs to f
+  std::unordered_set<Value*> free_values(
+      graph.inputs().begin(), graph.inputs().end());
+  free_values.insert(graph.outputs().begin(), graph.outputs().end());
+
+  // Memoized on the depth the value was found at; a value that can't be
+  // recomputed with the depth left can't be recomputed with less.
+  std::unordered_map<Value*, size_t> recomputable;
+  std::function<bool(Value*, size_t)> canRecompute = [&](Value* v,
+                                                         size_t depth) {
+    if (free_values.count(v) || v->node()->kind() == prim::Constant) {
+      return true;
+    }
+    auto it = recomputable.find(v);
+    if (it != recomputable.end() && it->second <= depth) {
+      return true;
+    }
+    Node* n = v->node();
+    if (depth == 0 || n->owningBlock() != graph.block() ||
+        n->outputs().size() != 1 || !isSimpleMap(n) ||
+        n->kind() == aten::rand_like || !isFusedOnItsDevice(v)) {
+      return false;
+    }
+    for (Value* input : n->inputs()) {
+      if (!canRecompute(input, depth - 1)) {
+        return false;
+      }
+    }
+    recomputable[v] = depth;
+    return true;
+  };
+
+  WithInsertPoint guard(reverse_block->nodes().front());
+  std::unordered_map<Value*, Value*> recomputed;
+  std::function<Value*(Value*)> recompute = [&](Value* v) -> Value* {
+    if (free_values.count(v)) {
+      return v;
+    }
+    auto it = recomputed.find(v);
+    if (it != recomputed.end()) {
+      return it->second;
+    }
+    Node* clone = graph.insertNode(graph.createClone(v->node(), recompute));
+    recomputed[v] = clone->output();
+    return clone->output();
+  };
+
+  for (Node* node : graph.nodes()) {
+    if (node->outputs().size() != 1) {
+      continue;
+    }
+    Value* v = node->output();
+    std::vector<Use> reverse_uses;
+    for (const Use& use : v->uses()) {
+      if (isInBlock(use.user, reverse_block)) {
+        reverse_uses.push_back(use);
+      }
+    }
+    if (reverse_uses.empty() || free_values.count(v) ||
+        node->kind() == prim::Constant ||
+        !canRecompute(v, kMaxRecomputeDepth)) {
+      continue;
+    }
+    Value* clone = recompute(v);
+    GRAPH_DEBUG(
+        "Recomputing ", v->debugName(), " as ", clone->debugName(),
+        " instead of capturing it");
+    for (const Use& use : reverse_uses) {
+      use.user->replaceInput(use.offset, clone);
+    }
+  }
+}
+
 // Takes a grad_desc.f returned from `addReverseInline` and splits off the
 // reverse_block into its own graph, storing it in df.
 // All intermediates needed in the second stage are added to
@@ -824,6 +936,7 @@ Gradient differentiate(std::shared_ptr<Graph>& graph) {
   // Fills in df_input_vjps and df_output_vjps
   auto rev_info = addReverseInline(grad_desc);
   Optimize(grad_desc, rev_info);
+  recomputeFusableTemporaries(grad_desc, rev_info);
   // Clean up old nodes which has been replaced by forward graphs in torchscript
   EliminateDeadCode(grad_desc.f->block());
 
@@ -13,9 +13,13 @@
 #include <onnx/proto_utils.h>
 
 #include <ATen/ATen.h>
+#include <c10/core/StreamGuard.h>
+#include <c10/core/impl/DeviceGuardImplInterface.h>
 #include <c10/util/Optional.h>
 
+#include <cctype>
 #include <fstream>
+#include <future>
 #include <memory>
 #include <set>
 #include <sstream>
@@ -31,10 +35,44 @@ void writeArchiveAndTensors(
     size_t size,
     const std::vector<WriteableTensorData>& tensors,
     caffe2::serialize::PyTorchStreamWriter& out) {
+  // Storages left on their devices by the pickler are copied to the CPU on
+  // another thread, one record ahead of the one being written, so that the
+  // copies overlap with the writes and at most two of them are held in host
+  // memory at once. The copies are made on the streams that are current here.
+  auto copyToCpu = [&](size_t i) {
+    const auto& td = tensors[i];
+    const auto device = td.device();
+    const auto stream =
+        c10::impl::getDeviceGuardImpl(device.type())->getStream(device);
+    return std::async(std::launch::async, [&td, stream] {
+      c10::StreamGuard guard(stream);
+      return td.toCpu();
+    });
+  };
+  auto nextOnDevice = [&](size_t i) {
+    while (i < tensors.size() && !tensors[i].onDevice()) {
+      ++i;
+    }
+    return i;
+  };
+
   std::string prefix = archive_name + "/";
-  size_t i = 0;
-  for (const auto& td : tensors) {
-    std::string fname = prefix + std::to_string(i++);
+  size_t copying = nextOnDevice(0);
+  std::future<WriteableTensorData> copy;
+  if (copying < tensors.size()) {
+    copy = copyToCpu(copying);
+  }
+  for (size_t i = 0; i < tensors.size(); ++i) {
+    std::string fname = prefix + std::to_string(i);
+    if (i != copying) {
+      out.writeRecord(fname, tensors[i].data(), tensors[i].sizeInBytes());
+      continue;
+    }
+    const auto td = copy.get();
+    copying = nextOnDevice(i + 1);
+    if (copying < tensors.size()) {
+      copy = copyToCpu(copying);
+    }
     out.writeRecord(fname, td.data(), td.sizeInBytes());
   }
   std::string fname = archive_name + ".pkl";
@@ -469,6 +507,10 @@ void EncoderBase::AddAttribute(
   }
 }
 
+// Initializers smaller than this are kept in the model proto even when
+// exporting in the external data format.
+constexpr size_t kExternalDataSizeThreshold = 1024;
+
 class GraphEncoder : public EncoderBase {
  public:
   GraphEncoder(
@@ -481,7 +523,9 @@ class GraphEncoder : public EncoderBase {
       bool strip_doc,
       bool keep_initializers_as_inputs,
       const std::map<std::string, int>& custom_opsets,
-      bool add_node_names);
+      bool add_node_names,
+      bool use_external_data_format,
+      const std::string& onnx_file_path);
 
   RawDataExportMap get_raw_data_export_map() {
     return raw_data_export_map_;
@@ -493,8 +537,18 @@ class GraphEncoder : public EncoderBase {
       const at::Tensor& tensor,
       const c10::optional<std::string> external_ref = {}) override;
 
+  // Writes the data of an initializer to its own file next to the model and
+  // points the tensor proto to it, instead of embedding the data.
+  void EncodeExternalData(
+      onnx::TensorProto* tensor_proto,
+      const at::Tensor& tensor,
+      const std::string& name);
+
   RawDataExportMap raw_data_export_map_;
   bool defer_weight_export_;
+  bool use_external_data_format_;
+  std::string onnx_file_path_;
+  std::set<std::string> external_data_locations_;
 };
 
 GraphEncoder::GraphEncoder(
@@ -507,9 +561,17 @@ GraphEncoder::GraphEncoder(
     bool strip_doc,
     bool keep_initializers_as_inputs,
     const std::map<std::string, int>& custom_opsets,
-    bool add_node_names)
+    bool add_node_names,
+    bool use_external_data_format,
+    const std::string& onnx_file_path)
     : EncoderBase(operator_export_type, strip_doc),
-      defer_weight_export_(defer_weight_export) {
+      defer_weight_export_(defer_weight_export),
+      use_external_data_format_(use_external_data_format),
+      onnx_file_path_(onnx_file_path) {
+  TORCH_CHECK(
+      !use_external_data_format || !onnx_file_path.empty(),
+      "The ONNX file path is required to export a model in the external "
+      "data format.");
   if (operator_export_type != onnx_torch::OperatorExportTypes::RAW) {
     validateGraph(graph, operator_export_type);
   }
@@ -569,11 +631,67 @@ void GraphEncoder::EncodeTensor(
     AT_ASSERT(raw_data_export_map_.count(external_ref.value()) == 0);
     raw_data_export_map_[external_ref.value()] = t;
     tensor_proto->set_raw_data("__EXTERNAL");
+  } else if (
+      use_external_data_format_ && external_ref &&
+      t.element_size() * t.numel() >= kExternalDataSizeThreshold) {
+    EncodeExternalData(tensor_proto, t, external_ref.value());
   } else {
     AT_ASSERT(t.is_contiguous());
-    tensor_proto->set_raw_data(std::string(
-        static_cast<char*>(t.data_ptr()), t.element_size() * t.numel()));
+    // Copy the data into the proto directly, without going through a
+    // temporary string.
+    tensor_proto->set_raw_data(
+        t.data_ptr(), t.element_size() * t.numel());
+  }
+}
+
+void GraphEncoder::EncodeExternalData(
+    onnx::TensorProto* tensor_proto,
+    const at::Tensor& tensor,
+    const std::string& name) {
+  AT_ASSERT(tensor.is_contiguous());
+  // The file is named after the initializer, with the characters that can't
+  // appear in a file name replaced. Names that end up the same are told
+  // apart by a suffix.
+  std::string location = name;
+  for (auto& c : location) {
+    if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' &&
+        c != '_' && c != '-') {
+      c = '_';
+    }
   }
+  if (location.empty() || location[0] == '.') {
+    location = "_" + location;
+  }
+  const std::string base_location = location;
+  for (size_t i = 1; !external_data_locations_.insert(location).second; ++i) {
+    location = base_location + "_" + std::to_string(i);
+  }
+
+  // ONNX resolves the location relative to the directory of the model.
+  const auto separator = onnx_file_path_.find_last_of("/\\");
+  const std::string directory = separator == std::string::npos
+      ? std::string()
+      : onnx_file_path_.substr(0, separator + 1);
+  {
+    // Written straight from the tensor, so that the data of large models is
+    // never copied into the proto, which can't exceed 2GB anyway.
+    std::ofstream file(
+        directory + location, std::ios::out | std::ios::binary);
+    TORCH_CHECK(
+        file.good(), "Failed to open ", directory + location,
+        " to export the data of initializer ", name);
+    file.write(
+        static_cast<const char*>(tensor.data_ptr()),
+        tensor.element_size() * tensor.numel());
+    TORCH_CHECK(
+        file.good(), "Failed to write the data of initializer ", name,
+        " to ", directory + location);
+  }
+
+  tensor_proto->set_data_location(onnx::TensorProto_DataLocation_EXTERNAL);
+  auto* entry = tensor_proto->add_external_data();
+  entry->set_key("location");
+  entry->set_value(location);
 }
 
 // Pretty printing for ONNX
@@ -773,7 +891,9 @@ std::string pretty_print_onnx(
       true,
       keep_initializers_as_inputs,
       custom_opsets,
-      add_node_names);
+      add_node_names,
+      false,
+      std::string());
   if (google_printer) {
     return graph_encoder.get_model_proto().DebugString();
   }
@@ -795,7 +915,9 @@ std::tuple<std::string, RawDataExportMap> export_onnx(
     bool strip_doc_string,
     bool keep_initializers_as_inputs,
     const std::map<std::string, int>& custom_opsets,
-    bool add_node_names) {
+    bool add_node_names,
+    bool use_external_data_format,
+    const std::string& onnx_file_path) {
   auto graph_encoder = GraphEncoder(
       graph,
       onnx_opset_version,
@@ -806,7 +928,9 @@ std::tuple<std::string, RawDataExportMap> export_onnx(
       strip_doc_string,
       keep_initializers_as_inputs,
       custom_opsets,
-      add_node_names);
+      add_node_names,
+      use_external_data_format,
+      onnx_file_path);
   return std::make_tuple(
       graph_encoder.get_model_proto().SerializeAsString(),
       graph_encoder.get_raw_data_export_map());
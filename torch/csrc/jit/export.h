@@ -21,6 +21,12 @@ namespace jit {
 // file contents being the raw tensor data.
 using RawDataExportMap = std::unordered_map<std::string, at::Tensor>;
 
+// When `use_external_data_format` is true, the data of every initializer of
+// at least 1KB is written to a file of its own in the directory of
+// `onnx_file_path` as it is encoded, and the model only references it, as
+// specified by the ONNX external data format. This keeps models larger than
+// the 2GB protobuf limit exportable.
+
 TORCH_API std::tuple<std::string, RawDataExportMap> export_onnx(
     const std::shared_ptr<Graph>& graph,
     const std::map<std::string, at::Tensor>& initializers,
@@ -32,7 +38,9 @@ TORCH_API std::tuple<std::string, RawDataExportMap> export_onnx(
     bool strip_doc_string = true,
     bool keep_initializers_as_inputs = true,
     const std::map<std::string, int>& custom_opsets = {},
-    bool add_node_names = true);
+    bool add_node_names = true,
+    bool use_external_data_format = false,
+    const std::string& onnx_file_path = std::string());
 
 TORCH_API void check_onnx_proto(const std::string& proto_string);
 
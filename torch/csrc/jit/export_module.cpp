@@ -71,17 +71,16 @@ class ScriptModuleSerializer {
         },
         nullptr,
         &memorizedClassTypes);
+    data_pickle.deferDeviceCopies();
     data_pickle.protocol();
     data_pickle.pushIValue(value);
     data_pickle.stop();
-    size_t i = 0;
-    std::string prefix = archive_name + "/";
-    for (const auto& td : data_pickle.tensorData()) {
-      std::string fname = prefix + c10::to_string(i++);
-      writer_.writeRecord(fname, td.data(), td.sizeInBytes());
-    }
-    std::string fname = archive_name + ".pkl";
-    writer_.writeRecord(fname, data.data(), data.size());
+    writeArchiveAndTensors(
+        archive_name,
+        data.data(),
+        data.size(),
+        data_pickle.tensorData(),
+        writer_);
 
     // serialize all the captured run-time class types
     for (const c10::ClassTypePtr& wroteType : memorizedClassTypes) {
@@ -151,7 +150,10 @@ class ScriptModuleSerializer {
       const auto& func = method.function();
       auto graph = func.graph()->copy();
       Inline(*graph);
-      torch::jit::Code code(graph);
+      torch::jit::Code code(
+          graph,
+          /*remaining_bailout_depth=*/0,
+          /*allow_superinstructions=*/false);
       // Make a copy of opnames. Some of them may be changed for mobile later.
       std::vector<c10::OperatorName> opnames;
       for (size_t i = 0; i < code.instructions().size(); ++i) {
@@ -313,6 +313,183 @@ static void emitIndexingFor(
   }
 }
 
+const Node* findReduction(const Graph& graph) {
+  for (const Node* n : graph.nodes()) {
+    if (n->kind() == aten::sum || n->kind() == aten::mean) {
+      return n;
+    }
+  }
+  return nullptr;
+}
+
+std::unordered_set<const Value*> reducedValues(const Graph& graph) {
+  std::unordered_set<const Value*> reduced;
+  const Node* reduction = findReduction(graph);
+  if (!reduction) {
+    return reduced;
+  }
+  reduced.insert(reduction->output());
+  for (const Node* n = reduction->next(); n != graph.return_node();
+       n = n->next()) {
+    // type_as takes its shape from self alone
+    const auto inputs = n->kind() == aten::type_as ? n->inputs().slice(0, 1)
+                                                    : n->inputs();
+    bool any_tensor = false;
+    bool all_reduced = true;
+    for (const Value* input : inputs) {
+      if (!input->type()->isSubtypeOf(TensorType::get())) {
+        continue;
+      }
+      any_tensor = true;
+      all_reduced &= reduced.count(input) > 0;
+    }
+    if (any_tensor && all_reduced) {
+      reduced.insert(n->outputs().begin(), n->outputs().end());
+    }
+  }
+  return reduced;
+}
+
+// Returns the statement that reads the given (flattened) input
+static std::string loadInput(
+    const Value* value,
+    const c10::optional<TensorDesc>& desc,
+    const size_t formal,
+    const bool use_cuda,
+    bool& has_half_tensor) {
+  TemplateEnv env;
+  env.s("node", valueName(value));
+  env.d("formal", formal);
+
+  // Acquires and converts (if needed) inputs
+  // Note: conversion from half is only supported for CUDA kernels.
+  //  The conversion immediately converts fp16 inputs to float.
+  //  Access for other types is common to CUDA and CPU kernels.
+  if (desc.has_value()) {
+    const auto is_half = desc->scalar_type == at::ScalarType::Half;
+    const auto is_bool = desc->scalar_type == at::ScalarType::Bool;
+    if (is_half) {
+      AT_ASSERT(use_cuda);
+      env.s(
+          "access",
+          format("__half2float(t${formal}.data[t${formal}_offset])", env));
+      has_half_tensor = true;
+    } else if (use_cuda) {
+      // No __ldg overload for bool
+      if (is_bool) {
+        env.s("access", format("t${formal}.data[t${formal}_offset]", env));
+      } else {
+        env.s("access", format("__ldg(&t${formal}.data[t${formal}_offset])", env));
+      }
+    } else {
+      env.s("access", format("t${formal}.data[t${formal}_offset]", env));
+    }
+    env.s("lhs_type", calcScalarTypeName(desc->scalar_type));
+  } else {
+    env.s("access", format("s${formal}", env));
+    env.s("lhs_type", variableType(value->type()));
+  }
+  return format("${lhs_type} ${node} = ${access};\n", env);
+}
+
+// Returns the statement computing the output of n, or an empty string for
+// nodes that are not computed in the kernel body
+static std::string computeNode(
+    const Node* n,
+    const bool use_cuda,
+    bool& has_random) {
+  // Note: FusedConcat nodes work by narrowing the output Tensors before the
+  // kernel runs
+  if (n->kind() == prim::FusedConcat)
+    return "";
+  if (n->kind() == prim::ConstantChunk)
+    return "";
+  if (n->mustBeNone())
+    return "";
+  if (n->kind() == aten::rand_like) {
+    AT_ASSERT(use_cuda);
+    has_random = true;
+  }
+  TemplateEnv env;
+  // Always emit double for prim::Constant. This will be narrowed later based
+  // on either:
+  //  - Tensor-Scalar operator type rules
+  //  - Math function rules
+  if (n->kind() == prim::Constant) {
+    const auto val = toIValue(n->output()).value();
+    std::string rhs;
+    if (val.isDouble()) {
+      rhs = scalarValue(val.toDouble());
+    } else if (val.isBool()) {
+      rhs = scalarValue(val.toBool());
+    } else if (val.isIntList()) {
+      // The dims of a reduction, which are implied by the kernel
+      return "";
+    } else {
+      AT_ASSERT(val.isInt());
+      rhs = scalarValue(val.toInt());
+    }
+    env.s("node", valueName(n->output()));
+    env.s("rhs", rhs);
+    env.s("lhs_type", variableType(n->output()->type()));
+  } else {
+    env.s("node", valueName(n->output()));
+    env.s("rhs", encodeRHS(n));
+    env.s("lhs_type", variableType(n->output()->type()));
+  }
+  return format("${lhs_type} ${node} = ${rhs};\n", env);
+}
+
+// Returns the statement that writes value to the given output
+static std::string storeOutput(
+    const Value* value,
+    const TensorDesc& desc,
+    const size_t formal,
+    const bool use_cuda,
+    bool& has_half_tensor) {
+  TemplateEnv env;
+  env.d("formal", formal);
+  env.s("access", format("t${formal}.data[t${formal}_offset]", env));
+  env.s("node", valueName(value));
+
+  // Acquires and converts (if needed) outputs
+  // Note: conversion to half is only supported for CUDA kernels.
+  const auto is_half = (desc.scalar_type == at::ScalarType::Half);
+  if (is_half) {
+    AT_ASSERT(use_cuda);
+    has_half_tensor = true;
+    return format("${access} = __float2half(${node});\n", env);
+  }
+  return format("${access} = ${node};\n", env);
+}
+
+// Returns the nodes the given values are computed from, stopping at graph
+// inputs (which are added to inputs), constants and values in available.
+static std::unordered_set<const Node*> nodesComputing(
+    const std::vector<const Value*>& values,
+    const std::unordered_set<const Value*>& available,
+    std::unordered_set<const Value*>& inputs) {
+  std::unordered_set<const Node*> nodes;
+  std::vector<const Value*> queue = values;
+  while (!queue.empty()) {
+    const Value* value = queue.back();
+    queue.pop_back();
+    const Node* producer = value->node();
+    if (producer->kind() == prim::Param) {
+      inputs.insert(value);
+      continue;
+    }
+    if (producer->kind() == prim::Constant || available.count(value) > 0 ||
+        !nodes.insert(producer).second) {
+      continue;
+    }
+    for (const Value* input : producer->inputs()) {
+      queue.push_back(input);
+    }
+  }
+  return nodes;
+}
+
 // TODO: handle cases where we need to generate > 2^32 element tensors
 std::string generateKernel(
     const std::string& name,
@@ -326,10 +503,10 @@ std::string generateKernel(
       "IndexType",
       "unsigned int"); // Note: not uint32_t to avoid including cstdint
 
-  std::stringstream body;
-  std::stringstream tensorOffsets;
   std::vector<std::string> formals;
   std::vector<std::string> argument_loads;
+  // Offset computation of each tensor formal, empty for scalars
+  std::vector<std::string> tensor_offsets;
 
   // Lambda for writing arguments
   auto emitFormal = [&](const Value* n, const TensorDesc& desc) {
@@ -342,7 +519,9 @@ std::string generateKernel(
           c10::to_string(
               formals.size()); // can't be unique() because Param may be an output
       const auto nDim = desc.nDim();
-      emitIndexingFor(tensorOffsets, tensor, nDim, desc.lastIsContiguous());
+      std::stringstream offsets;
+      emitIndexingFor(offsets, tensor, nDim, desc.lastIsContiguous());
+      tensor_offsets.push_back(offsets.str());
       env.s("tensor", tensor);
       env.d("nDim", nDim);
       env.s("scalar_type", scalarTypeName(desc.scalar_type));
@@ -368,6 +547,7 @@ std::string generateKernel(
             1); // + 1 because the first argument is the linearIndex
     env.s("scalar", scalar);
     env.s("scalar_type", variableType(n->type()));
+    tensor_offsets.emplace_back();
     formals.push_back(format("${scalar_type} ${scalar}", env));
     argument_loads.push_back(format(
     "*static_cast<${scalar_type}*>(args[${formal_index}])", env));
@@ -388,107 +568,147 @@ std::string generateKernel(
     emitFormal(output.first, output.second);
   }
 
-  // Acquires input values
-  bool has_half_tensor = false;
-  size_t formal_count = 0;
-  for (const auto& input : inputs) {
-    auto p = input.first;
-    env.s("node", valueName(p));
-    env.d("formal", formal_count++);
-
-    // Acquires and converts (if needed) inputs
-    // Note: conversion from half is only supported for CUDA kernels.
-    //  The conversion immediately converts fp16 inputs to float.
-    //  Access for other types is common to CUDA and CPU kernels.
-    if (input.second.has_value()) {
-      const auto is_half = input.second.has_value() && ((*input.second).scalar_type == at::ScalarType::Half);
-      const auto is_bool = input.second.has_value() && ((*input.second).scalar_type == at::ScalarType::Bool);
-      if (is_half) {
-        AT_ASSERT(use_cuda);
-        env.s(
-            "access",
-            format("__half2float(t${formal}.data[t${formal}_offset])", env));
-        has_half_tensor = true;
-      } else if (use_cuda) {
-        // No __ldg overload for bool
-        if (is_bool) {
-          env.s("access", format("t${formal}.data[t${formal}_offset]", env));
-        } else {
-          env.s("access", format("__ldg(&t${formal}.data[t${formal}_offset])", env));
-        }
-      } else {
-        env.s("access", format("t${formal}.data[t${formal}_offset]", env));
-      }
-      env.s("lhs_type", calcScalarTypeName(input.second.value().scalar_type));
-    } else {
-      env.s("access", format("s${formal}", env));
-      env.s("lhs_type", variableType(input.first->type()));
-    }
-    body << format("${lhs_type} ${node} = ${access};\n", env);
+  // Kernels with a reduction take the size of the reduced (last) dimension
+  // of the map size after the outputs
+  const Node* reduction = findReduction(graph);
+  if (reduction) {
+    env.d("formal_index", formals.size() + 1);
+    formals.emplace_back("IndexType rowSize");
+    argument_loads.push_back(
+        format("*static_cast<IndexType*>(args[${formal_index}])", env));
   }
 
+  bool has_half_tensor = false;
   bool has_random = false;
-  // Generates code for intermediate nodes
-  // Note: Concat and Chunk are implicitly generated
-  // Note: Random number generation is only supported for CUDA kernels.
-  // Note: Constant None node is ignored and we will handle it in the
-  //       places where the constant None node is used
-  for (const auto& n : graph.nodes()) {
-    // Note: FusedConcat nodes work by narrowing the output Tensors before the
-    // kernel runs
-    if (n->kind() == prim::FusedConcat)
-      continue;
-    if (n->kind() == prim::ConstantChunk)
-      continue;
-    if (n->mustBeNone())
-      continue;
-    if (n->kind() == aten::rand_like) {
-      AT_ASSERT(use_cuda);
-      has_random = true;
+  std::string code_string;
+  if (!reduction) {
+    std::stringstream body;
+    std::stringstream tensorOffsets;
+    for (const auto& offsets : tensor_offsets) {
+      tensorOffsets << offsets;
     }
-    // Always emit double for prim::Constant. This will be narrowed later based
-    // on either:
-    //  - Tensor-Scalar operator type rules
-    //  - Math function rules
-    if (n->kind() == prim::Constant) {
-      const auto val = toIValue(n->output()).value();
-      std::string rhs;
-      if (val.isDouble()) {
-        rhs = scalarValue(val.toDouble());
-      } else if (val.isBool()) {
-        rhs = scalarValue(val.toBool());
-      } else {
-        AT_ASSERT(val.isInt());
-        rhs = scalarValue(val.toInt());
-      }
-      env.s("node", valueName(n->output()));
-      env.s("rhs", rhs);
-      env.s("lhs_type", variableType(n->output()->type()));
-    } else {
-      env.s("node", valueName(n->output()));
-      env.s("rhs", encodeRHS(n));
-      env.s("lhs_type", variableType(n->output()->type()));
+
+    // Acquires input values
+    size_t formal_count = 0;
+    for (const auto& input : inputs) {
+      body << loadInput(
+          input.first, input.second, formal_count++, use_cuda, has_half_tensor);
     }
 
-    body << format("${lhs_type} ${node} = ${rhs};\n", env);
-  }
+    // Generates code for intermediate nodes
+    // Note: Concat and Chunk are implicitly generated
+    // Note: Random number generation is only supported for CUDA kernels.
+    // Note: Constant None node is ignored and we will handle it in the
+    //       places where the constant None node is used
+    for (const auto& n : graph.nodes()) {
+      body << computeNode(n, use_cuda, has_random);
+    }
 
-  // Generates writes to output tensors
-  for (const auto& output : outputs) {
-    env.d("formal", formal_count++);
-    env.s("access", format("t${formal}.data[t${formal}_offset]", env));
-    env.s("node", valueName(output.first));
+    // Generates writes to output tensors
+    for (const auto& output : outputs) {
+      body << storeOutput(
+          output.first,
+          output.second,
+          formal_count++,
+          use_cuda,
+          has_half_tensor);
+    }
 
-    // Acquires and converts (if needed) outputs
-    // Note: conversion to half is only supported for CUDA kernels.
-    const auto is_half = (output.second.scalar_type == at::ScalarType::Half);
-    if (is_half) {
-      AT_ASSERT(use_cuda);
-      body << format("${access} = __float2half(${node});\n", env);
-      has_half_tensor = true;
-    } else {
-      body << format("${access} = ${node};\n", env);
+    env.s("tensorOffsets", tensorOffsets.str());
+    env.s("kernelBody", body.str());
+  } else {
+    // Each row of the map size is processed in three steps: the values the
+    // reduction consumes are accumulated over the row, the values of the
+    // reduced shape are computed once, and then the values they are
+    // broadcast into are computed and stored over the row again.
+    const auto reduced = reducedValues(graph);
+
+    std::stringstream row_prologue;
+    for (const auto& n : graph.nodes()) {
+      TORCH_INTERNAL_ASSERT(
+          n->kind() != prim::FusedConcat && n->kind() != prim::ConstantChunk,
+          "chunks and concats cannot be fused with a reduction");
+      if (n->kind() == prim::Constant) {
+        row_prologue << computeNode(n, use_cuda, has_random);
+      }
+    }
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      if (!inputs[i].second.has_value()) {
+        row_prologue << loadInput(
+            inputs[i].first, inputs[i].second, i, use_cuda, has_half_tensor);
+      }
+    }
+
+    // Emits the offsets, input loads and nodes in graph order computing
+    // values from the tensor inputs and the values in available
+    auto emitStep = [&](const std::vector<const Value*>& values,
+                        const std::unordered_set<const Value*>& available,
+                        std::ostream& offsets,
+                        std::ostream& body) {
+      std::unordered_set<const Value*> used_inputs;
+      const auto nodes = nodesComputing(values, available, used_inputs);
+      for (size_t i = 0; i < inputs.size(); ++i) {
+        if (inputs[i].second.has_value() && used_inputs.count(inputs[i].first)) {
+          offsets << tensor_offsets[i];
+          body << loadInput(
+              inputs[i].first, inputs[i].second, i, use_cuda, has_half_tensor);
+        }
+      }
+      for (const auto& n : graph.nodes()) {
+        if (nodes.count(n) > 0) {
+          body << computeNode(n, use_cuda, has_random);
+        }
+      }
+    };
+
+    std::stringstream reduce_offsets;
+    std::stringstream reduce_body;
+    emitStep({reduction->input(0)}, {}, reduce_offsets, reduce_body);
+    env.s("node", valueName(reduction->input(0)));
+    env.s("acc_type", variableType(reduction->input(0)->type()));
+    reduce_body << format("acc += static_cast<${acc_type}>(${node});\n", env);
+
+    std::stringstream row_body;
+    env.s("node", valueName(reduction->output()));
+    env.s("lhs_type", variableType(reduction->output()->type()));
+    env.s("rhs", reduction->kind() == aten::mean ? "acc / rowSize" : "acc");
+    row_body << format("${lhs_type} ${node} = ${rhs};\n", env);
+    for (const auto& n : graph.nodes()) {
+      if (n != reduction && reduced.count(n->output()) > 0) {
+        row_body << computeNode(n, use_cuda, has_random);
+      }
     }
+
+    std::stringstream row_offsets;
+    std::stringstream row_stores;
+    std::stringstream map_offsets;
+    std::stringstream map_body;
+    std::vector<const Value*> map_outputs;
+    for (const auto& output : outputs) {
+      if (reduced.count(output.first) == 0) {
+        map_outputs.push_back(output.first);
+      }
+    }
+    emitStep(map_outputs, reduced, map_offsets, map_body);
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      const size_t formal = inputs.size() + i;
+      const auto& output = outputs[i];
+      const bool is_reduced = reduced.count(output.first) > 0;
+      (is_reduced ? row_offsets : map_offsets) << tensor_offsets[formal];
+      (is_reduced ? row_stores : map_body) << storeOutput(
+          output.first, output.second, formal, use_cuda, has_half_tensor);
+    }
+
+    TORCH_INTERNAL_ASSERT(
+        !has_random, "random numbers cannot be fused with a reduction");
+    env.s("rowPrologue", row_prologue.str());
+    env.s("reduceOffsets", reduce_offsets.str());
+    env.s("reduceBody", reduce_body.str());
+    env.s("rowBody", row_body.str());
+    env.s("rowOffsets", row_offsets.str());
+    env.s("rowStores", row_stores.str());
+    env.s("mapOffsets", map_offsets.str());
+    env.s("mapBody", map_body.str());
   }
 
   // Includes headers
@@ -510,16 +730,21 @@ std::string generateKernel(
   }
 
   // Instantiates the CUDA or CPU-specific templates
-  env.s("tensorOffsets", tensorOffsets.str());
-  env.s("kernelBody", body.str());
   env.v("formals", formals);
   env.v("argument_loads", argument_loads);
-  std::string code_string;
   if (use_cuda) {
     env.s("type_declarations", cuda::type_declarations_template.format(env));
-    code_string = cuda::cuda_compilation_unit_template.format(env);
+    env.s("WarpSize", cuda::warp_size);
+    env.s("WarpShuffleXor", cuda::warp_shuffle_xor);
+    code_string = reduction
+        ? cuda::cuda_reduction_compilation_unit_template.format(env)
+        : cuda::cuda_compilation_unit_template.format(env);
   } else {
     env.s("type_declarations", cpu::type_declarations_template.format(env));
+    env.s(
+        "kernelDefinition",
+        reduction ? cpu::cpu_reduction_kernel_template.format(env)
+                  : cpu::cpu_pointwise_kernel_template.format(env));
     code_string = cpu::cpu_compilation_unit_template.format(env);
   }
 
@@ -9,12 +9,23 @@
 #include <iostream>
 #include <string>
 #include <tuple>
+#include <unordered_set>
 #include <vector>
 
 namespace torch {
 namespace jit {
 namespace fuser {
 
+// Returns the aten::sum or aten::mean of a fusion group graph, or nullptr if
+// it is a pointwise group. The fuser only fuses reductions over the last
+// dimension with keepdim, and at most one per group.
+TORCH_API const Node* findReduction(const Graph& graph);
+
+// Returns the values of a fusion group graph with the shape of its
+// reduction: the reduction itself and the nodes all of whose tensor inputs
+// have that shape. All other values have the map size.
+TORCH_API std::unordered_set<const Value*> reducedValues(const Graph& graph);
+
 // Creates a CPU or CUDA kernel for the given graph.
 // Returns the C++ or CUDA string implementing the kernel.
 TORCH_API std::string generateKernel(
@@ -5,6 +5,7 @@
 #include <c10/util/Exception.h>
 #include <torch/csrc/jit/code_template.h>
 #include <torch/csrc/jit/fuser/codegen.h>
+#include <torch/csrc/jit/fuser/cpu/vectorized_kernel.h>
 #include <torch/csrc/jit/fuser/interface.h>
 #include <torch/csrc/jit/fuser/kernel_cache.h>
 #include <torch/csrc/jit/fuser/tensor_desc.h>
@@ -156,6 +157,31 @@ static void setInputBroadcastGroups(KernelSpec& spec) {
       broadcast_groups.insert(getInputDependencies(output));
     }
   }
+  // The reduction reads whole rows of the map size, and the tensors its
+  // result is combined with must not broadcast it into a smaller shape, so
+  // they get the map size on their own.
+  if (const Node* reduction = findReduction(*spec.graph())) {
+    const auto reduced = reducedValues(*spec.graph());
+    broadcast_groups.insert(getInputDependencies(reduction->input(0)));
+    for (const Node* n : spec.graph()->nodes()) {
+      if (reduced.count(n->output()) > 0) {
+        continue;
+      }
+      const bool uses_reduced = std::any_of(
+          n->inputs().begin(), n->inputs().end(), [&](const Value* input) {
+            return reduced.count(input) > 0;
+          });
+      if (!uses_reduced) {
+        continue;
+      }
+      for (const Value* input : n->inputs()) {
+        if (input->type()->isSubtypeOf(TensorType::get()) &&
+            reduced.count(input) == 0) {
+          broadcast_groups.insert(getInputDependencies(input));
+        }
+      }
+    }
+  }
   std::copy(
       broadcast_groups.begin(),
       broadcast_groups.end(),
@@ -171,9 +197,16 @@ static void setInputBroadcastGroups(KernelSpec& spec) {
 // or their descendants are involved in, which means that in a DAG of
 // pointwise operations all tensors are expandable to the (single) output.
 // Note: The logic is slightly complicated by concatenation and chunking.
+// Note: A reduction over the last dimension is fused along with its
+// producers and consumers, which requires its input and the tensors its
+// result is combined with to have the map size.
 static void upfrontCompilation(KernelSpec& spec) {
   setInputBroadcastGroups(spec);
   setInputChunkDescriptors(spec);
+  const auto reduced = reducedValues(*spec.graph());
+  for (const Value* output : spec.graph()->outputs()) {
+    spec.reducedOutputs().push_back(reduced.count(output) > 0);
+  }
 }
 
 int64_t registerFusion(const Node* fusion_group) {
@@ -253,15 +286,22 @@ std::shared_ptr<FusedKernel> compileKernel(
   std::vector<TensorDesc> output_desc;
   std::vector<PartitionDesc> concat_desc;
   std::vector<std::pair<const Value*, const TensorDesc>> flat_outputs;
-  for (const Value* o : graph->outputs()) {
+  for (size_t i = 0; i < graph->outputs().size(); ++i) {
+    const Value* o = graph->outputs()[i];
     // Creates output description
     std::vector<int64_t> sizes = map_size;
     if (o->node()->kind() == prim::FusedConcat) {
       sizes.at(o->node()->i(attr::dim)) *= o->node()->inputs().size();
+    } else if (spec.reducedOutputs()[i]) {
+      sizes.back() = 1;
     }
 
     auto scalar_type = o->type()->expect<TensorType>()->scalarType();
     TORCH_INTERNAL_ASSERT(scalar_type);
+    // Reductions accumulate in the type of their input
+    if (spec.hasReduction() && !at::isFloatingType(*scalar_type)) {
+      return nullptr;
+    }
     auto type = TensorType::createContiguous(*scalar_type, device, sizes);
     output_desc.emplace_back(type);
     const auto& desc = output_desc.back();
@@ -281,6 +321,20 @@ std::shared_ptr<FusedKernel> compileKernel(
 
   const bool use_cuda = device.is_cuda();
   const std::string name = "kernel_" + c10::to_string(next_kernel_id++);
+  // Float pointwise groups run in process on CPU, without a host compiler.
+  if (!use_cuda && !spec.hasReduction() && useVectorizedCPUFuser()) {
+    if (auto kernel = cpu::compileVectorizedKernel(
+            name,
+            *graph,
+            flat_inputs,
+            flat_outputs,
+            input_desc,
+            output_desc,
+            chunk_desc,
+            concat_desc)) {
+      return kernel;
+    }
+  }
   std::string code =
       generateKernel(name, *graph, flat_inputs, flat_outputs, use_cuda);
   const FusedKernelConstructor& kernel_ctor =
@@ -23,6 +23,8 @@ TORCH_API int64_t registerFusion(const Node* fusion_group);
 // Performs device-specific "runtime" compilation of the given kernel
 //  with the runtime arguments specified in ArgSpec.
 //  Outputs are allocated using map_size on the specified device.
+//  Returns nullptr if the kernel cannot be built on this host, in which case
+//  the fallback runs the fusion group instead.
 TORCH_API std::shared_ptr<FusedKernel> compileKernel(
     const KernelSpec& spec,
     const ArgSpec& arg_spec,
@@ -33,6 +35,7 @@ TORCH_API size_t nCompiledKernels();
 
 TORCH_API int debugFuser();
 
+// May return nullptr if the backend cannot build kernels on this host.
 using FusedKernelConstructor = std::function<std::shared_ptr<FusedKernel>(
     int16_t device,
     std::string name,
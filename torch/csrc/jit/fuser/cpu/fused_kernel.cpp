@@ -4,6 +4,7 @@
 #include <torch/csrc/jit/code_template.h>
 #include <torch/csrc/jit/fuser/compiler.h>
 #include <torch/csrc/jit/fuser/cpu/temp_file.h>
+#include <torch/csrc/jit/fuser/disk_cache.h>
 #include <torch/csrc/utils/memory.h>
 
 #ifdef _MSC_VER
@@ -11,7 +12,9 @@
 #endif
 
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -202,6 +205,37 @@ static CompilerConfig& getConfig() {
   return config;
 }
 
+// Identifies the host compiler in disk cache keys, so that upgrading it
+// invalidates the shared libraries it built
+static const std::string& getCompilerVersion() {
+  static const std::string version = [] {
+    std::string result;
+#ifdef _MSC_VER
+    for (const auto& envvar : env_list) {
+      if (envvar.compare(0, 15, "VCToolsVersion=") == 0) {
+        result = envvar;
+      }
+    }
+    const char* tools_version = getenv("VCToolsVersion");
+    if (result.empty() && tools_version) {
+      result = tools_version;
+    }
+#else
+    const std::string cmd = "\"" + getConfig().cxx + "\" --version 2>/dev/null";
+    std::unique_ptr<FILE, decltype(&pclose)> pipe(
+        popen(cmd.c_str(), "r"), pclose);
+    if (pipe) {
+      char buffer[128];
+      while (fgets(buffer, sizeof(buffer), pipe.get()) != nullptr) {
+        result += buffer;
+      }
+    }
+#endif
+    return result;
+  }();
+  return version;
+}
+
 // NB: -march=native not supported on PPC64 g++.  It's a bit annoying
 // to do a configure-style test to decide whether or not the g++
 // actually supports it or not, so we heuristically use the host
@@ -290,18 +324,48 @@ FusedKernelCPU::FusedKernelCPU(
           std::move(chunk_desc),
           std::move(concat_desc),
           has_random) {
-  TempFile so_file(so_template, so_suffix_len);
-  TempFile cpp_file(cpp_template, cpp_suffix_len);
-  cpp_file.write(code_);
-  cpp_file.sync();
+  // A shared library built by an earlier process for the same code and
+  // compiler is loaded straight from the disk cache
+  const auto& config = getConfig();
+  const auto so_suffix = so_template.substr(so_template.size() - so_suffix_len);
+  std::string cache_key;
+  if (!getDiskCacheDir().empty() && !getCompilerVersion().empty()) {
+    cache_key = diskCacheKey(
+        {"cpu",
+         code_,
+         config.cxx,
+         getCompilerVersion(),
+         compile_string,
+         config.openmp ? config.openmp_flags : ""});
+    const auto cached_so = lookupDiskCache(cache_key, so_suffix);
+    if (!cached_so.empty()) {
+      so_lib = make_unique<at::DynamicLibrary>(cached_so.c_str());
+    }
+  }
+
+  if (!so_lib) {
+    TempFile so_file(so_template, so_suffix_len);
+    TempFile cpp_file(cpp_template, cpp_suffix_len);
+    cpp_file.write(code_);
+    cpp_file.sync();
 #ifdef _MSC_VER
-  so_file.close();
-  cpp_file.close();
+    so_file.close();
+    cpp_file.close();
 #endif
-  runCompiler(cpp_file.name(), so_file.name());
-  if (debugFuser() >= 2)
-    disas(so_file.name());
-  so_lib = make_unique<at::DynamicLibrary>(so_file.name().c_str());
+    runCompiler(cpp_file.name(), so_file.name());
+    if (debugFuser() >= 2)
+      disas(so_file.name());
+    so_lib = make_unique<at::DynamicLibrary>(so_file.name().c_str());
+    if (!cache_key.empty()) {
+      std::ifstream so(so_file.name(), std::ios::binary);
+      writeDiskCache(
+          cache_key,
+          so_suffix,
+          std::string(
+              std::istreambuf_iterator<char>(so),
+              std::istreambuf_iterator<char>()));
+    }
+  }
 #pragma GCC diagnostic ignored "-Wpedantic"
   kernel =
       reinterpret_cast<void (*)(uint32_t, void**)>(so_lib->sym(name_.c_str()));
@@ -317,6 +381,9 @@ static std::shared_ptr<FusedKernel> createFusionKernel(
     std::vector<PartitionDesc> chunk_desc,
     std::vector<PartitionDesc> concat_desc,
     bool has_random) {
+  if (getConfig().cxx.empty()) {
+    return nullptr;
+  }
   return std::make_shared<FusedKernelCPU>(
       std::move(name),
       std::move(code),
@@ -77,6 +77,21 @@ using int_same_size_t = typename int_of_size<sizeof(T)>::type;
 #endif
 
 #define OMP_THRESHOLD 100000
+${kernelDefinition}
+
+#ifdef _WIN32
+#define JIT_API __declspec(dllexport)
+#else
+#define JIT_API
+#endif
+
+extern "C"
+JIT_API void ${kernelName}(IndexType totalElements, void ** args) {
+  ${kernelName}_kernel(totalElements ${,argument_loads});
+}
+)");
+
+static auto cpu_pointwise_kernel_template = CodeTemplate(R"(
 static void ${kernelName}_kernel(IndexType totalElements, ${formals}) {
   #pragma omp parallel for if(totalElements > OMP_THRESHOLD)
   for (IndexTypeLoop linearIndex = 0;
@@ -88,16 +103,36 @@ static void ${kernelName}_kernel(IndexType totalElements, ${formals}) {
       ${kernelBody}
     }
 }
+)");
 
-#ifdef _WIN32
-#define JIT_API __declspec(dllexport)
-#else
-#define JIT_API
-#endif
-
-extern "C"
-JIT_API void ${kernelName}(IndexType totalElements, void ** args) {
-  ${kernelName}_kernel(totalElements ${,argument_loads});
+// Kernels with a reduction over the last dimension split the map size into
+// rows of rowSize elements. Each row is first reduced, then the values of
+// the reduced shape are computed and stored, and the values they are
+// broadcast into are computed and stored over the row again.
+static auto cpu_reduction_kernel_template = CodeTemplate(R"(
+static void ${kernelName}_kernel(IndexType totalElements, ${formals}) {
+  const IndexType numRows = totalElements / rowSize;
+  #pragma omp parallel for if(totalElements > OMP_THRESHOLD)
+  for (IndexTypeLoop row = 0; row < ToIndexTypeLoop(numRows); row += 1) {
+    ${rowPrologue}
+    ${acc_type} acc = 0;
+    for (IndexType col = 0; col < rowSize; col += 1) {
+      const IndexType linearIndex = row * rowSize + col;
+      ${reduceOffsets}
+      ${reduceBody}
+    }
+    ${rowBody}
+    {
+      const IndexType linearIndex = row;
+      ${rowOffsets}
+      ${rowStores}
+    }
+    for (IndexType col = 0; col < rowSize; col += 1) {
+      const IndexType linearIndex = row * rowSize + col;
+      ${mapOffsets}
+      ${mapBody}
+    }
+  }
 }
 )");
 
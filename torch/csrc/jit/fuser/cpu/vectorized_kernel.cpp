@@ -0,0 +1,586 @@
+#include <torch/csrc/jit/fuser/cpu/vectorized_kernel.h>
+
+#include <ATen/Parallel.h>
+#include <c10/util/Exception.h>
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/fuser/compiler.h>
+#include <torch/csrc/jit/fuser/tensor_info.h>
+
+#include <algorithm>
+#include <initializer_list>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+namespace cpu {
+
+using at::native::PointwiseInstruction;
+using at::native::PointwiseOp;
+using at::native::PointwiseProgram;
+using at::native::kPointwiseProgramBlockSize;
+
+namespace {
+
+constexpr int32_t kNoRegister = -1;
+
+const std::unordered_map<NodeKind, PointwiseOp>& unaryOps() {
+  static const std::unordered_map<NodeKind, PointwiseOp> ops = {
+      {aten::abs, PointwiseOp::Abs},
+      {aten::neg, PointwiseOp::Neg},
+      {aten::reciprocal, PointwiseOp::Reciprocal},
+      {aten::relu, PointwiseOp::Relu},
+      {aten::sigmoid, PointwiseOp::Sigmoid},
+      {aten::tanh, PointwiseOp::Tanh},
+      {aten::exp, PointwiseOp::Exp},
+      {aten::expm1, PointwiseOp::Expm1},
+      {aten::log, PointwiseOp::Log},
+      {aten::log10, PointwiseOp::Log10},
+      {aten::log1p, PointwiseOp::Log1p},
+      {aten::log2, PointwiseOp::Log2},
+      {aten::sqrt, PointwiseOp::Sqrt},
+      {aten::rsqrt, PointwiseOp::Rsqrt},
+      {aten::sin, PointwiseOp::Sin},
+      {aten::cos, PointwiseOp::Cos},
+      {aten::tan, PointwiseOp::Tan},
+      {aten::asin, PointwiseOp::Asin},
+      {aten::acos, PointwiseOp::Acos},
+      {aten::atan, PointwiseOp::Atan},
+      {aten::erf, PointwiseOp::Erf},
+      {aten::erfc, PointwiseOp::Erfc},
+      {aten::ceil, PointwiseOp::Ceil},
+      {aten::floor, PointwiseOp::Floor},
+      {aten::round, PointwiseOp::Round},
+      {aten::trunc, PointwiseOp::Trunc},
+      {aten::frac, PointwiseOp::Frac},
+  };
+  return ops;
+}
+
+const std::unordered_map<NodeKind, PointwiseOp>& binaryOps() {
+  static const std::unordered_map<NodeKind, PointwiseOp> ops = {
+      {aten::mul, PointwiseOp::Mul},
+      {aten::div, PointwiseOp::Div},
+      {aten::pow, PointwiseOp::Pow},
+      {aten::atan2, PointwiseOp::Atan2},
+      {aten::min, PointwiseOp::Min},
+      {aten::max, PointwiseOp::Max},
+      {aten::_sigmoid_backward, PointwiseOp::SigmoidBackward},
+      {aten::_tanh_backward, PointwiseOp::TanhBackward},
+  };
+  return ops;
+}
+
+const char* opName(PointwiseOp op) {
+  switch (op) {
+#define OP_NAME(name)       \
+  case PointwiseOp::name: \
+    return #name;
+    OP_NAME(Fill)
+    OP_NAME(ScalarArg)
+    OP_NAME(Abs)
+    OP_NAME(Neg)
+    OP_NAME(Reciprocal)
+    OP_NAME(Relu)
+    OP_NAME(Sigmoid)
+    OP_NAME(Tanh)
+    OP_NAME(Exp)
+    OP_NAME(Expm1)
+    OP_NAME(Log)
+    OP_NAME(Log10)
+    OP_NAME(Log1p)
+    OP_NAME(Log2)
+    OP_NAME(Sqrt)
+    OP_NAME(Rsqrt)
+    OP_NAME(Sin)
+    OP_NAME(Cos)
+    OP_NAME(Tan)
+    OP_NAME(Asin)
+    OP_NAME(Acos)
+    OP_NAME(Atan)
+    OP_NAME(Erf)
+    OP_NAME(Erfc)
+    OP_NAME(Ceil)
+    OP_NAME(Floor)
+    OP_NAME(Round)
+    OP_NAME(Trunc)
+    OP_NAME(Frac)
+    OP_NAME(Add)
+    OP_NAME(Sub)
+    OP_NAME(Mul)
+    OP_NAME(Div)
+    OP_NAME(Pow)
+    OP_NAME(Atan2)
+    OP_NAME(Min)
+    OP_NAME(Max)
+    OP_NAME(Addcmul)
+    OP_NAME(Lerp)
+    OP_NAME(Clamp)
+    OP_NAME(Threshold)
+    OP_NAME(SigmoidBackward)
+    OP_NAME(TanhBackward)
+#undef OP_NAME
+  }
+  return "";
+}
+
+bool isFloatTensor(const Value* v) {
+  const auto type = v->type()->cast<TensorType>();
+  return type && type->scalarType() == at::kFloat;
+}
+
+c10::optional<float> constantScalar(const Value* v) {
+  const auto ivalue = toIValue(v);
+  if (!ivalue) {
+    return c10::nullopt;
+  }
+  if (ivalue->isDouble()) {
+    return static_cast<float>(ivalue->toDouble());
+  } else if (ivalue->isInt()) {
+    return static_cast<float>(ivalue->toInt());
+  } else if (ivalue->isBool()) {
+    return ivalue->toBool() ? 1.f : 0.f;
+  }
+  return c10::nullopt;
+}
+
+// Lowers the nodes of a fusion group to a PointwiseProgram, reusing the
+// register of a value once its last user has read it.
+struct ProgramBuilder {
+  ProgramBuilder(
+      const Graph& graph,
+      const std::vector<
+          std::pair<const Value*, const c10::optional<TensorDesc>>>&
+          flat_inputs,
+      const std::vector<std::pair<const Value*, const TensorDesc>>&
+          flat_outputs)
+      : graph_(graph), flat_outputs_(flat_outputs) {
+    int32_t num_scalar_args = 0;
+    for (const auto& input : flat_inputs) {
+      if (input.second) {
+        registers_[input.first] = program_.num_inputs++;
+      } else {
+        scalar_args_[input.first] = num_scalar_args++;
+      }
+    }
+    program_.num_registers = program_.num_inputs;
+    live_values_.resize(program_.num_inputs, 1);
+    pinned_.resize(program_.num_inputs, true);
+    for (const auto& output : flat_outputs) {
+      outputs_.insert(output.first);
+    }
+    size_t index = 0;
+    for (const Node* n : graph_.nodes()) {
+      for (const Value* input : n->inputs()) {
+        last_use_[input] = index;
+      }
+      ++index;
+    }
+  }
+
+  c10::optional<PointwiseProgram> build() {
+    size_t index = 0;
+    for (const Node* n : graph_.nodes()) {
+      if (!lower(n, index++)) {
+        return c10::nullopt;
+      }
+    }
+    for (const auto& output : flat_outputs_) {
+      const int32_t r = operand(output.first);
+      if (r == kNoRegister) {
+        return c10::nullopt;
+      }
+      program_.outputs.push_back(r);
+    }
+    return program_;
+  }
+
+ private:
+  int32_t allocate(const Value* v) {
+    int32_t r;
+    if (free_registers_.empty()) {
+      r = program_.num_registers++;
+      live_values_.push_back(0);
+      pinned_.push_back(false);
+    } else {
+      r = free_registers_.back();
+      free_registers_.pop_back();
+    }
+    bind(v, r);
+    return r;
+  }
+
+  void bind(const Value* v, int32_t r) {
+    registers_[v] = r;
+    ++live_values_[r];
+    if (outputs_.count(v)) {
+      pinned_[r] = true;
+    }
+  }
+
+  void release(const Value* v) {
+    const auto it = registers_.find(v);
+    if (it == registers_.end()) {
+      return;
+    }
+    const int32_t r = it->second;
+    if (--live_values_[r] == 0 && !pinned_[r]) {
+      free_registers_.push_back(r);
+    }
+  }
+
+  void emit(
+      PointwiseOp op,
+      int32_t dst,
+      int32_t a = kNoRegister,
+      int32_t b = kNoRegister,
+      int32_t c = kNoRegister,
+      float scalar = 0.f) {
+    program_.instructions.push_back(
+        PointwiseInstruction{op, dst, a, b, c, scalar});
+  }
+
+  // Register holding v, materializing constants and scalar arguments on
+  // their first use. Returns kNoRegister if v cannot be a float operand.
+  int32_t operand(const Value* v) {
+    const auto it = registers_.find(v);
+    if (it != registers_.end()) {
+      return it->second;
+    }
+    const auto scalar_arg = scalar_args_.find(v);
+    if (scalar_arg != scalar_args_.end()) {
+      const int32_t r = allocate(v);
+      emit(PointwiseOp::ScalarArg, r, scalar_arg->second);
+      return r;
+    }
+    if (const auto value = constantScalar(v)) {
+      const int32_t r = allocate(v);
+      emit(PointwiseOp::Fill, r, kNoRegister, kNoRegister, kNoRegister, *value);
+      return r;
+    }
+    return kNoRegister;
+  }
+
+  bool lower(const Node* n, size_t index) {
+    const NodeKind kind = n->kind();
+    // Chunks and concats are handled by the flattened inputs and outputs,
+    // constants are materialized by their users.
+    if (kind == prim::FusedConcat || kind == prim::ConstantChunk ||
+        kind == prim::Constant) {
+      return true;
+    }
+    if (n->outputs().size() != 1 || !isFloatTensor(n->output())) {
+      return false;
+    }
+    const auto& inputs = n->inputs();
+
+    PointwiseOp op;
+    std::vector<int32_t> operands;
+    float scalar = 0.f;
+    auto addOperand = [&](const Value* v) {
+      operands.push_back(operand(v));
+      return operands.back() != kNoRegister;
+    };
+    auto addOptionalOperand = [&](const Value* v) {
+      if (v->node()->mustBeNone()) {
+        operands.push_back(kNoRegister);
+        return true;
+      }
+      return addOperand(v);
+    };
+
+    if (kind == aten::_cast_Float || kind == aten::type_as) {
+      if (!isFloatTensor(inputs[0]) || !addOperand(inputs[0])) {
+        return false;
+      }
+      releaseDeadInputs(n, index);
+      bind(n->output(), operands[0]);
+      return true;
+    } else if (unaryOps().count(kind) && inputs.size() == 1) {
+      op = unaryOps().at(kind);
+      if (!addOperand(inputs[0])) {
+        return false;
+      }
+    } else if (binaryOps().count(kind) && inputs.size() == 2) {
+      op = binaryOps().at(kind);
+      if (!addOperand(inputs[0]) || !addOperand(inputs[1])) {
+        return false;
+      }
+    } else if ((kind == aten::add || kind == aten::sub) && inputs.size() == 3) {
+      op = kind == aten::add ? PointwiseOp::Add : PointwiseOp::Sub;
+      const auto alpha = constantScalar(inputs[2]);
+      if (!alpha || !addOperand(inputs[0]) || !addOperand(inputs[1])) {
+        return false;
+      }
+      scalar = *alpha;
+    } else if (kind == aten::addcmul && inputs.size() == 4) {
+      op = PointwiseOp::Addcmul;
+      const auto value = constantScalar(inputs[3]);
+      if (!value || !addOperand(inputs[0]) || !addOperand(inputs[1]) ||
+          !addOperand(inputs[2])) {
+        return false;
+      }
+      scalar = *value;
+    } else if (
+        (kind == aten::lerp || kind == aten::threshold) && inputs.size() == 3) {
+      op = kind == aten::lerp ? PointwiseOp::Lerp : PointwiseOp::Threshold;
+      if (!addOperand(inputs[0]) || !addOperand(inputs[1]) ||
+          !addOperand(inputs[2])) {
+        return false;
+      }
+    } else if (kind == aten::clamp && inputs.size() == 3) {
+      op = PointwiseOp::Clamp;
+      if (!addOperand(inputs[0]) || !addOptionalOperand(inputs[1]) ||
+          !addOptionalOperand(inputs[2]) ||
+          (operands[1] == kNoRegister && operands[2] == kNoRegister)) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+
+    operands.resize(3, kNoRegister);
+    // Elementwise ops may write over their own inputs, so the registers of
+    // inputs that die here can already hold the result.
+    releaseDeadInputs(n, index);
+    const int32_t dst = allocate(n->output());
+    emit(op, dst, operands[0], operands[1], operands[2], scalar);
+    return true;
+  }
+
+  void releaseDeadInputs(const Node* n, size_t index) {
+    std::unordered_set<const Value*> seen;
+    for (const Value* input : n->inputs()) {
+      if (seen.insert(input).second && last_use_.at(input) == index) {
+        release(input);
+      }
+    }
+  }
+
+  const Graph& graph_;
+  const std::vector<std::pair<const Value*, const TensorDesc>>& flat_outputs_;
+  PointwiseProgram program_;
+  std::unordered_map<const Value*, int32_t> registers_;
+  std::unordered_map<const Value*, int32_t> scalar_args_;
+  std::unordered_set<const Value*> outputs_;
+  std::unordered_map<const Value*, size_t> last_use_;
+  // number of live values held by each register
+  std::vector<int32_t> live_values_;
+  // registers that must survive to the end: inputs and outputs
+  std::vector<bool> pinned_;
+  std::vector<int32_t> free_registers_;
+};
+
+std::string dumpProgram(const std::string& name, const PointwiseProgram& p) {
+  std::ostringstream out;
+  out << name << "(inputs: r0.." << p.num_inputs << ", registers: "
+      << p.num_registers << ")\n";
+  for (const PointwiseInstruction& inst : p.instructions) {
+    out << "  r" << inst.dst << " = " << opName(inst.op) << "(";
+    if (inst.op == PointwiseOp::Fill) {
+      out << inst.scalar;
+    } else if (inst.op == PointwiseOp::ScalarArg) {
+      out << "s" << inst.a;
+    } else {
+      const char* sep = "";
+      for (int32_t r : {inst.a, inst.b, inst.c}) {
+        if (r != kNoRegister) {
+          out << sep << "r" << r;
+          sep = ", ";
+        }
+      }
+      if (inst.op == PointwiseOp::Add || inst.op == PointwiseOp::Sub ||
+          inst.op == PointwiseOp::Addcmul) {
+        out << sep << inst.scalar;
+      }
+    }
+    out << ")\n";
+  }
+  out << "  return (";
+  for (size_t i = 0; i < p.outputs.size(); ++i) {
+    out << (i > 0 ? ", " : "") << "r" << p.outputs[i];
+  }
+  out << ")\n";
+  return out.str();
+}
+
+// A 1-d, stride 1 TensorInfo, which the program can read or write in place.
+bool isFlat(const TensorDesc& desc) {
+  return desc.nDim() == 1 && desc.lastIsContiguous();
+}
+
+// Offset of the element at linear_index, as computed by the generated
+// kernels.
+uint32_t offsetOf(TensorInfo* info, size_t ndim, uint32_t linear_index) {
+  const uint32_t* sizes = info->sizes(ndim);
+  const uint32_t* strides = info->strides(ndim);
+  uint32_t offset = 0;
+  for (size_t d = ndim; d > 0; --d) {
+    offset += (linear_index % sizes[d - 1]) * strides[d - 1];
+    linear_index /= sizes[d - 1];
+  }
+  return offset;
+}
+
+} // namespace
+
+VectorizedKernelCPU::VectorizedKernelCPU(
+    std::string name,
+    PointwiseProgram program,
+    std::vector<TensorDesc> flat_input_desc,
+    size_t num_scalar_inputs,
+    std::vector<TensorDesc> flat_output_desc,
+    std::vector<TensorDesc> input_desc,
+    std::vector<TensorDesc> output_desc,
+    std::vector<PartitionDesc> chunk_desc,
+    std::vector<PartitionDesc> concat_desc)
+    : FusedKernel(
+          name,
+          dumpProgram(name, program),
+          std::move(input_desc),
+          std::move(output_desc),
+          std::move(chunk_desc),
+          std::move(concat_desc),
+          /*has_random=*/false),
+      program_(std::move(program)),
+      flat_input_desc_(std::move(flat_input_desc)),
+      num_scalar_inputs_(num_scalar_inputs),
+      flat_output_desc_(std::move(flat_output_desc)) {
+  if (debugFuser()) {
+    std::cerr << "fusion code:" << code_ << std::endl;
+  }
+}
+
+void VectorizedKernelCPU::launch_raw(
+    const uint32_t numel,
+    std::vector<void*>& arguments) const {
+  // arguments: numel, tensor inputs, scalar inputs, outputs (see
+  // launchFusion)
+  const size_t num_inputs = flat_input_desc_.size();
+  const size_t num_outputs = flat_output_desc_.size();
+  auto inputInfo = [&](size_t i) {
+    return static_cast<TensorInfo*>(arguments[1 + i]);
+  };
+  auto outputInfo = [&](size_t i) {
+    return static_cast<TensorInfo*>(
+        arguments[1 + num_inputs + num_scalar_inputs_ + i]);
+  };
+  std::vector<float> scalars(num_scalar_inputs_);
+  for (size_t i = 0; i < num_scalar_inputs_; ++i) {
+    scalars[i] =
+        static_cast<float>(*static_cast<double*>(arguments[1 + num_inputs + i]));
+  }
+
+  at::parallel_for(
+      0,
+      static_cast<int64_t>(numel),
+      at::internal::GRAIN_SIZE,
+      [&](int64_t begin, int64_t end) {
+        const int64_t block = kPointwiseProgramBlockSize;
+        std::vector<float> scratch(
+            (program_.num_registers - program_.num_inputs) * block);
+        // copies of the elements of tensors that are not flat
+        std::vector<float> staging((num_inputs + num_outputs) * block);
+        std::vector<const float*> inputs(num_inputs);
+        std::vector<float*> outputs(num_outputs);
+
+        for (int64_t start = begin; start < end; start += block) {
+          const int64_t n = std::min(block, end - start);
+          for (size_t i = 0; i < num_inputs; ++i) {
+            TensorInfo* info = inputInfo(i);
+            const float* data = static_cast<const float*>(info->data);
+            if (isFlat(flat_input_desc_[i])) {
+              inputs[i] = data + start;
+              continue;
+            }
+            float* copy = staging.data() + i * block;
+            const size_t ndim = flat_input_desc_[i].nDim();
+            for (int64_t k = 0; k < n; ++k) {
+              copy[k] = data[offsetOf(info, ndim, start + k)];
+            }
+            inputs[i] = copy;
+          }
+          for (size_t i = 0; i < num_outputs; ++i) {
+            outputs[i] = isFlat(flat_output_desc_[i])
+                ? static_cast<float*>(outputInfo(i)->data) + start
+                : staging.data() + (num_inputs + i) * block;
+          }
+
+          at::native::pointwise_program_stub(
+              at::kCPU,
+              program_,
+              n,
+              inputs.data(),
+              scalars.data(),
+              outputs.data(),
+              scratch.data());
+
+          for (size_t i = 0; i < num_outputs; ++i) {
+            if (isFlat(flat_output_desc_[i])) {
+              continue;
+            }
+            TensorInfo* info = outputInfo(i);
+            float* data = static_cast<float*>(info->data);
+            const size_t ndim = flat_output_desc_[i].nDim();
+            for (int64_t k = 0; k < n; ++k) {
+              data[offsetOf(info, ndim, start + k)] = outputs[i][k];
+            }
+          }
+        }
+      });
+}
+
+std::shared_ptr<FusedKernel> compileVectorizedKernel(
+    const std::string& name,
+    const Graph& graph,
+    const std::vector<std::pair<const Value*, const c10::optional<TensorDesc>>>&
+        flat_inputs,
+    const std::vector<std::pair<const Value*, const TensorDesc>>& flat_outputs,
+    const std::vector<TensorDesc>& input_desc,
+    const std::vector<TensorDesc>& output_desc,
+    const std::vector<PartitionDesc>& chunk_desc,
+    const std::vector<PartitionDesc>& concat_desc) {
+  std::vector<TensorDesc> flat_input_desc;
+  size_t num_scalar_inputs = 0;
+  for (const auto& input : flat_inputs) {
+    if (!input.second) {
+      ++num_scalar_inputs;
+      continue;
+    }
+    // Tensor arguments are passed ahead of all scalar arguments.
+    if (num_scalar_inputs > 0 || input.second->scalar_type != at::kFloat) {
+      return nullptr;
+    }
+    flat_input_desc.push_back(*input.second);
+  }
+  std::vector<TensorDesc> flat_output_desc;
+  for (const auto& output : flat_outputs) {
+    if (output.second.scalar_type != at::kFloat) {
+      return nullptr;
+    }
+    flat_output_desc.push_back(output.second);
+  }
+
+  auto program = ProgramBuilder(graph, flat_inputs, flat_outputs).build();
+  if (!program) {
+    return nullptr;
+  }
+  return std::make_shared<VectorizedKernelCPU>(
+      name,
+      std::move(*program),
+      std::move(flat_input_desc),
+      num_scalar_inputs,
+      std::move(flat_output_desc),
+      input_desc,
+      output_desc,
+      chunk_desc,
+      concat_desc);
+}
+
+} // namespace cpu
+} // namespace fuser
+} // namespace jit
+} // namespace torch
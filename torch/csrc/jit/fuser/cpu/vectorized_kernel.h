@@ -0,0 +1,72 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/PointwiseProgram.h>
+#include <c10/util/Optional.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/fuser/fused_kernel.h>
+#include <torch/csrc/jit/ir.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+namespace cpu {
+
+// Runs a fusion group in process: the group is lowered to an
+// at::native::PointwiseProgram, which is evaluated with Vec256 loops over
+// blocks of kPointwiseProgramBlockSize elements, the blocks being split
+// between threads with at::parallel_for. Nothing is compiled, so the kernel
+// is ready as soon as it is constructed.
+struct TORCH_API VectorizedKernelCPU : public ::torch::jit::fuser::FusedKernel {
+  VectorizedKernelCPU(
+      std::string name,
+      at::native::PointwiseProgram program,
+      std::vector<TensorDesc> flat_input_desc,
+      size_t num_scalar_inputs,
+      std::vector<TensorDesc> flat_output_desc,
+      std::vector<TensorDesc> input_desc,
+      std::vector<TensorDesc> output_desc,
+      std::vector<PartitionDesc> chunk_desc,
+      std::vector<PartitionDesc> concat_desc);
+
+  at::Backend backend() const override {
+    return at::Backend::CPU;
+  }
+
+  void launch_raw(const uint32_t numel, std::vector<void*>& arguments)
+      const override;
+
+ private:
+  const at::native::PointwiseProgram program_;
+  // descriptions of the TensorInfo arguments, after chunks and concats have
+  // been flattened
+  const std::vector<TensorDesc> flat_input_desc_;
+  const size_t num_scalar_inputs_;
+  const std::vector<TensorDesc> flat_output_desc_;
+};
+
+// Builds a VectorizedKernelCPU for the fusion group graph, or returns nullptr
+// if it uses an op, or a dtype other than float, that PointwiseProgram
+// cannot express. The inputs and outputs are the flattened ones of
+// compileKernel.
+TORCH_API std::shared_ptr<FusedKernel> compileVectorizedKernel(
+    const std::string& name,
+    const Graph& graph,
+    const std::vector<std::pair<const Value*, const c10::optional<TensorDesc>>>&
+        flat_inputs,
+    const std::vector<std::pair<const Value*, const TensorDesc>>& flat_outputs,
+    const std::vector<TensorDesc>& input_desc,
+    const std::vector<TensorDesc>& output_desc,
+    const std::vector<PartitionDesc>& chunk_desc,
+    const std::vector<PartitionDesc>& concat_desc);
+
+} // namespace cpu
+} // namespace fuser
+} // namespace jit
+} // namespace torch
@@ -1,5 +1,6 @@
 #include <torch/csrc/jit/fuser/cuda/fused_kernel.h>
 #include <torch/csrc/jit/fuser/compiler.h>
+#include <torch/csrc/jit/fuser/disk_cache.h>
 
 #include <ATen/ATen.h>
 #include <ATen/cuda/CUDAContext.h>
@@ -64,6 +65,34 @@ static void getMajorMinor(
   }
 }
 
+// Compiles code with NVRTC and returns the PTX
+static std::vector<char> compileToPTX(
+    const std::string& code,
+    const std::vector<const char*>& args) {
+  nvrtcProgram program;
+  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcCreateProgram(
+      &program, code.c_str(), nullptr, 0, nullptr, nullptr));
+  const auto result =
+      nvrtc().nvrtcCompileProgram(program, args.size(), args.data());
+  if (result != NVRTC_SUCCESS) {
+    size_t logsize;
+    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetProgramLogSize(program, &logsize));
+    std::vector<char> log(logsize);
+    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetProgramLog(program, log.data()));
+    std::stringstream cu;
+    cu << log.data();
+    throw std::runtime_error(cu.str());
+  }
+  ResourceGuard holdProgram(
+      [&] { AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcDestroyProgram(&program)); });
+  AT_CUDA_NVRTC_CHECK(result);
+  size_t ptx_size;
+  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTXSize(program, &ptx_size));
+  std::vector<char> ptx(ptx_size);
+  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTX(program, ptx.data()));
+  return ptx;
+}
+
 // Compiles the specified kernel and stores the metadata required to run it
 FusedKernelCUDA::FusedKernelCUDA(
     int16_t device,
@@ -103,11 +132,6 @@ FusedKernelCUDA::FusedKernelCUDA(
   int major, minor;
   getMajorMinor(prop_, major, minor);
 
-  // Creates the NVRTC program
-  nvrtcProgram program;
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcCreateProgram(
-      &program, code_.c_str(), nullptr, 0, nullptr, nullptr));
-
 #ifdef __HIP_PLATFORM_HCC__
   std::vector<const char*> args = {};
 #else
@@ -116,24 +140,31 @@ FusedKernelCUDA::FusedKernelCUDA(
   const std::vector<const char*> args = {
       "--std=c++14", compute.c_str(), "-default-device"};
 #endif
-  const auto result =
-      nvrtc().nvrtcCompileProgram(program, args.size(), args.data());
-  if (result != NVRTC_SUCCESS) {
-    size_t logsize;
-    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetProgramLogSize(program, &logsize));
-    std::vector<char> log(logsize);
-    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetProgramLog(program, log.data()));
-    std::stringstream cu;
-    cu << log.data();
-    throw std::runtime_error(cu.str());
+
+  // PTX compiled by an earlier process for the same code, arch and NVRTC
+  // version is read from the disk cache
+  std::string cache_key;
+  if (!getDiskCacheDir().empty()) {
+    int nvrtc_major, nvrtc_minor;
+    AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcVersion(&nvrtc_major, &nvrtc_minor));
+    std::vector<std::string> key_parts = {
+        "cuda",
+        code_,
+        std::to_string(nvrtc_major) + "." + std::to_string(nvrtc_minor)};
+    key_parts.insert(key_parts.end(), args.begin(), args.end());
+    cache_key = diskCacheKey(key_parts);
+    std::string cached_ptx;
+    if (readDiskCache(cache_key, ".ptx", cached_ptx)) {
+      ptx_.assign(cached_ptx.begin(), cached_ptx.end());
+    }
+  }
+
+  if (ptx_.empty()) {
+    ptx_ = compileToPTX(code_, args);
+    if (!cache_key.empty()) {
+      writeDiskCache(cache_key, ".ptx", std::string(ptx_.begin(), ptx_.end()));
+    }
   }
-  ResourceGuard holdProgram(
-      [&] { AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcDestroyProgram(&program)); });
-  AT_CUDA_NVRTC_CHECK(result);
-  size_t ptx_size;
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTXSize(program, &ptx_size));
-  ptx_.resize(ptx_size);
-  AT_CUDA_NVRTC_CHECK(nvrtc().nvrtcGetPTX(program, ptx_.data()));
 
   AT_CUDA_DRIVER_CHECK(nvrtc().cuModuleLoadData(&module_, ptx_.data()));
   AT_CUDA_DRIVER_CHECK(
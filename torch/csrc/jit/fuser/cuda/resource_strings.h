@@ -182,6 +182,63 @@ void ${kernelName}(IndexType totalElements, ${formals} ${RandParam}) {
 }
 )");
 
+// Kernels with a reduction over the last dimension split the map size into
+// rows of rowSize elements, each of which is processed by one warp: the
+// lanes accumulate strided columns of the row and combine them with
+// shuffles, then every lane computes the values of the reduced shape, lane 0
+// stores them, and the lanes compute and store the values they are
+// broadcast into over the row again.
+static auto cuda_reduction_compilation_unit_template = CodeTemplate(R"(
+${type_declarations}
+
+#define FUSER_WARP_SIZE ${WarpSize}
+
+template <typename T>
+__device__ __forceinline__ T warpSum(T value) {
+  for (int offset = FUSER_WARP_SIZE / 2; offset > 0; offset /= 2) {
+    value += ${WarpShuffleXor};
+  }
+  return value;
+}
+
+extern "C" __global__
+void ${kernelName}(IndexType totalElements, ${formals}) {
+  const IndexType numRows = totalElements / rowSize;
+  const IndexType lane = threadIdx.x % FUSER_WARP_SIZE;
+  for (IndexType row = (blockIdx.x * blockDim.x + threadIdx.x) / FUSER_WARP_SIZE;
+        row < numRows;
+        row += (gridDim.x * blockDim.x) / FUSER_WARP_SIZE) {
+    ${rowPrologue}
+    ${acc_type} acc = 0;
+    for (IndexType col = lane; col < rowSize; col += FUSER_WARP_SIZE) {
+      const IndexType linearIndex = row * rowSize + col;
+      ${reduceOffsets}
+      ${reduceBody}
+    }
+    acc = warpSum(acc);
+    ${rowBody}
+    if (lane == 0) {
+      const IndexType linearIndex = row;
+      ${rowOffsets}
+      ${rowStores}
+    }
+    for (IndexType col = lane; col < rowSize; col += FUSER_WARP_SIZE) {
+      const IndexType linearIndex = row * rowSize + col;
+      ${mapOffsets}
+      ${mapBody}
+    }
+  }
+}
+)");
+
+#ifdef __HIP_PLATFORM_HCC__
+constexpr auto warp_size = "64";
+constexpr auto warp_shuffle_xor = "__shfl_xor(value, offset)";
+#else
+constexpr auto warp_size = "32";
+constexpr auto warp_shuffle_xor = "__shfl_xor_sync(0xffffffff, value, offset)";
+#endif
+
 // This snippet enables half support in the jit. Following the pattern for
 // reductions, fp16 input data is immediately upconverted to float
 // with __half2float(). All mathematical operations are done on float
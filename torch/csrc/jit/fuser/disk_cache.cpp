@@ -0,0 +1,174 @@
+#include <torch/csrc/jit/fuser/disk_cache.h>
+#include <torch/csrc/jit/fuser/compiler.h>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#include <process.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+
+#ifdef _WIN32
+static const char path_separator = '\\';
+#else
+static const char path_separator = '/';
+#endif
+
+static std::mutex dir_mutex;
+
+// XXX: Does not grab dir_mutex
+static std::string& nolock_cacheDir() {
+  static std::string dir = [] {
+    const char* dir_env = getenv("PYTORCH_FUSER_CACHE_DIR");
+    return dir_env ? std::string(dir_env) : std::string();
+  }();
+  return dir;
+}
+
+std::string getDiskCacheDir() {
+  std::lock_guard<std::mutex> guard{dir_mutex};
+  return nolock_cacheDir();
+}
+
+void setDiskCacheDir(std::string dir) {
+  std::lock_guard<std::mutex> guard{dir_mutex};
+  nolock_cacheDir() = std::move(dir);
+}
+
+// 64-bit FNV-1a. Unlike std::hash its value is fixed, which entries shared
+// between builds and processes rely on.
+static uint64_t fnv1a(const std::string& s, uint64_t hash) {
+  for (const char c : s) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+std::string diskCacheKey(const std::vector<std::string>& parts) {
+  // Two hashes with different offset bases give a 128-bit key; each part is
+  // prefixed with its length so that the parts cannot run into each other.
+  uint64_t hi = 14695981039346656037ULL;
+  uint64_t lo = 0x9e3779b97f4a7c15ULL;
+  for (const auto& part : parts) {
+    const std::string length = std::to_string(part.size()) + ":";
+    hi = fnv1a(part, fnv1a(length, hi));
+    lo = fnv1a(part, fnv1a(length, lo));
+  }
+  char key[33];
+  snprintf(
+      key,
+      sizeof(key),
+      "%016llx%016llx",
+      static_cast<unsigned long long>(hi),
+      static_cast<unsigned long long>(lo));
+  return key;
+}
+
+static std::string entryPath(
+    const std::string& dir,
+    const std::string& key,
+    const std::string& suffix) {
+  return dir + path_separator + "fused_" + key + suffix;
+}
+
+static bool fileExists(const std::string& path) {
+#ifdef _WIN32
+  return _access(path.c_str(), 0) == 0;
+#else
+  return access(path.c_str(), R_OK) == 0;
+#endif
+}
+
+std::string lookupDiskCache(const std::string& key, const std::string& suffix) {
+  const auto dir = getDiskCacheDir();
+  if (dir.empty()) {
+    return "";
+  }
+  auto path = entryPath(dir, key, suffix);
+  if (!fileExists(path)) {
+    return "";
+  }
+  if (debugFuser()) {
+    std::cerr << "fuser disk cache hit: " << path << std::endl;
+  }
+  return path;
+}
+
+bool readDiskCache(
+    const std::string& key,
+    const std::string& suffix,
+    std::string& data) {
+  const auto path = lookupDiskCache(key, suffix);
+  if (path.empty()) {
+    return false;
+  }
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  data.assign(
+      std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return !file.bad();
+}
+
+void writeDiskCache(
+    const std::string& key,
+    const std::string& suffix,
+    const std::string& data) {
+  const auto dir = getDiskCacheDir();
+  if (dir.empty()) {
+    return;
+  }
+#ifdef _WIN32
+  _mkdir(dir.c_str());
+  const int pid = _getpid();
+#else
+  mkdir(dir.c_str(), 0777);
+  const int pid = getpid();
+#endif
+  // Writes to a file of this process and renames it over the entry, so
+  // that readers never see a partially written entry.
+  const auto path = entryPath(dir, key, suffix);
+  const auto tmp_path = path + ".tmp" + std::to_string(pid);
+  bool written;
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), data.size());
+    file.close();
+    written = !file.fail();
+  }
+  if (!written) {
+    if (debugFuser()) {
+      std::cerr << "fuser disk cache: failed to write " << tmp_path
+                << std::endl;
+    }
+    std::remove(tmp_path.c_str());
+    return;
+  }
+  // On Windows rename fails if another process stored the entry first,
+  // which is as good as succeeding.
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+  } else if (debugFuser()) {
+    std::cerr << "fuser disk cache store: " << path << std::endl;
+  }
+}
+
+} // namespace fuser
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <torch/csrc/WindowsTorchApiMacro.h>
+
+#include <string>
+#include <vector>
+
+namespace torch {
+namespace jit {
+namespace fuser {
+
+// An optional on-disk cache of compiled kernels (PTX on CUDA, shared
+// libraries on CPU), so that a process does not have to recompile the
+// kernels of an earlier run. It is disabled unless a directory is given,
+// either through PYTORCH_FUSER_CACHE_DIR or setDiskCacheDir(). Entries are
+// written atomically, so several processes can share a directory, and any
+// failure to read or write it just means the kernel is compiled.
+
+// Returns the cache directory, or an empty string if the cache is disabled
+TORCH_API std::string getDiskCacheDir();
+
+// Sets the cache directory; an empty string disables the cache
+TORCH_API void setDiskCacheDir(std::string dir);
+
+// Hashes everything the compiled kernel depends on (generated code, device
+// arch, compiler and its version, flags) into the name of a cache entry
+TORCH_API std::string diskCacheKey(const std::vector<std::string>& parts);
+
+// Returns the path of the entry key + suffix if it exists, or an empty string
+TORCH_API std::string lookupDiskCache(
+    const std::string& key,
+    const std::string& suffix);
+
+// Reads the entry key + suffix into data; returns false if it does not exist
+TORCH_API bool readDiskCache(
+    const std::string& key,
+    const std::string& suffix,
+    std::string& data);
+
+// Stores data as the entry key + suffix, creating the cache directory if
+// needed. Does nothing if the cache is disabled.
+TORCH_API void writeDiskCache(
+    const std::string& key,
+    const std::string& suffix,
+    const std::string& data);
+
+} // namespace fuser
+} // namespace jit
+} // namespace torch
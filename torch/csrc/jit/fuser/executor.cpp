@@ -188,6 +188,7 @@ static void compressContiguous(
 // Launches the requested fusion on the given device with the given inputs.
 // Output pointers are stored in outputs (to be put on the stack later).
 void launchFusion(
+    const KernelSpec& spec,
     const FusedKernel& fusion,
     const at::Device device,
     const at::ArrayRef<at::Tensor>& inputs,
@@ -242,7 +243,7 @@ void launchFusion(
 
   // A vector of arguments to the kernel (numel, *input_desc_s, *output_desc_s)
   std::vector<void*> arguments;
-  arguments.reserve(3 + scalar_inputs.size() + flat_inputs_size + flat_outputs_size);
+  arguments.reserve(4 + scalar_inputs.size() + flat_inputs_size + flat_outputs_size);
   arguments.push_back(&numel);
 
   auto addTensorInfoRaw = [&](const TensorDesc& desc,
@@ -292,7 +293,13 @@ void launchFusion(
   const auto& ref_options = inputs[0].options();
   for (size_t i = 0; i < fusion.outputDesc().size(); ++i) {
     const auto& c = fusion.concatDesc()[i];
-    if (c.isNoop()) {
+    if (spec.reducedOutputs()[i]) {
+      std::vector<int64_t> reduced_size(map_size.begin(), map_size.end());
+      reduced_size.back() = 1;
+      outputs.push_back(at::empty(
+          reduced_size, ref_options.dtype(fusion.outputDesc()[i].scalar_type)));
+      addTensorInfo(fusion.outputDesc()[i], outputs[i]);
+    } else if (c.isNoop()) {
       outputs.push_back(at::empty(
           map_size, ref_options.dtype(fusion.outputDesc()[i].scalar_type)));
       addTensorInfo(fusion.outputDesc()[i], outputs[i]);
@@ -313,6 +320,12 @@ void launchFusion(
       }
     }
   }
+  // Kernels with a reduction take the length of the reduced rows last
+  uint32_t row_size = 0;
+  if (spec.hasReduction()) {
+    row_size = map_size.back();
+    arguments.push_back(&row_size);
+  }
   // Skip launching the kernel for zero-element tensor inputs
   // launches are skipped, empty zero-sized output is returned
   if (numel > 0) {
@@ -371,6 +384,11 @@ bool runFusion(const int64_t key, Stack& stack, std::string* code_out) {
     if (hasBroadcast)
       return false;
   }
+  // Reductions need rows to reduce, and an empty row is not worth a kernel
+  if (spec.hasReduction() &&
+      (maybe_map_size->empty() || maybe_map_size->back() == 0)) {
+    return false;
+  }
   expandArgs(spec, inputs, *maybe_map_size, /*dry_run=*/false);
 
   // Retrieves the kernel, compiling (and caching) if necessary
@@ -382,6 +400,11 @@ bool runFusion(const int64_t key, Stack& stack, std::string* code_out) {
   }
   maybe_kernel = spec.findKernel(arg_spec);
   AT_ASSERT(maybe_kernel);
+  // The kernel could not be built for these arguments, which is cached as
+  // well so they go straight to the fallback from now on.
+  if (!*maybe_kernel) {
+    return false;
+  }
 
   if (code_out) {
     *code_out = maybe_kernel.value()->code();
@@ -389,7 +412,7 @@ bool runFusion(const int64_t key, Stack& stack, std::string* code_out) {
 
   // Launches fusion
   std::vector<at::Tensor> outputs;
-  launchFusion(*(*maybe_kernel), device, inputs, all_inputs, outputs);
+  launchFusion(spec, *(*maybe_kernel), device, inputs, all_inputs, outputs);
 
   // Updates stack
   drop(stack, spec.nInputs());
@@ -12,8 +12,10 @@ namespace jit {
 
 namespace detail {
 
-// Note: CPU fusion is currently disabled due to test flakiness
-bool cpu_fuser_enabled = false;
+// CPU fusion groups that VectorizedKernelCPU can express run in process,
+// the others are compiled with the host compiler, if there is one.
+bool cpu_fuser_enabled = true;
+bool vectorized_cpu_fuser_enabled = true;
 
 } // namespace detail
 
@@ -40,6 +42,14 @@ void overrideCanFuseOnCPU(bool value) {
   detail::cpu_fuser_enabled = value;
 }
 
+bool useVectorizedCPUFuser() {
+  return detail::vectorized_cpu_fuser_enabled;
+}
+
+void overrideUseVectorizedCPUFuser(bool value) {
+  detail::vectorized_cpu_fuser_enabled = value;
+}
+
 // Uses the above interface by stuffing the graph into a node and treating that
 // node as a fusion group.
 std::vector<at::Tensor> debugLaunchGraph(
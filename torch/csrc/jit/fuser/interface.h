@@ -28,10 +28,15 @@ TORCH_API void runFusion(const int64_t key, Stack& stack);
 TORCH_API bool canFuseOnCPU();
 TORCH_API bool canFuseOnGPU();
 
-// Sets whether fusion on the CPU is allowed (disabled by default due to
-// flakiness)
+// Sets whether fusion on the CPU is allowed (enabled by default)
 TORCH_API void overrideCanFuseOnCPU(bool value);
 
+// Whether CPU fusion groups of float pointwise ops run in process, on
+// Vec256 loops, rather than as code compiled with the host compiler
+// (enabled by default)
+TORCH_API bool useVectorizedCPUFuser();
+TORCH_API void overrideUseVectorizedCPUFuser(bool value);
+
 // Treats the given graph as a fusion group and launches it on the
 // specified device with the given inputs.
 // Returns the outputs.
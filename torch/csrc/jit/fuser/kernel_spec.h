@@ -64,12 +64,15 @@ struct TORCH_API KernelSpec {
         nTensorInputs_{},
         inputBroadcastGroups_{},
         inputChunks_{},
+        reducedOutputs_{},
         has_random_{false},
+        has_reduction_{false},
         kernels_{} {
     for (const auto& n : graph_->nodes()) {
       if (n->kind() == aten::rand_like) {
         has_random_ = true;
-        break;
+      } else if (n->kind() == aten::sum || n->kind() == aten::mean) {
+        has_reduction_ = true;
       }
     }
     nTensorInputs_ = std::count_if(
@@ -109,10 +112,23 @@ struct TORCH_API KernelSpec {
     return inputChunks_;
   }
 
+  // Whether each output has the shape of the group's reduction, which is
+  // the map size with a last dimension of one, instead of the map size
+  std::vector<bool>& reducedOutputs() {
+    return reducedOutputs_;
+  }
+  const std::vector<bool>& reducedOutputs() const {
+    return reducedOutputs_;
+  }
+
   bool hasRandom() const {
     return has_random_;
   }
 
+  bool hasReduction() const {
+    return has_reduction_;
+  }
+
   // Cache functions
   c10::optional<std::shared_ptr<FusedKernel>> findKernel(
       const ArgSpec& arg_spec) const {
@@ -136,7 +152,9 @@ struct TORCH_API KernelSpec {
   uint64_t nTensorInputs_;
   std::vector<std::vector<int64_t>> inputBroadcastGroups_;
   std::vector<PartitionInfo> inputChunks_;
+  std::vector<bool> reducedOutputs_;
   bool has_random_;
+  bool has_reduction_;
   mutable std::mutex mutex_;
   mutable std::
       unordered_map<ArgSpec, std::shared_ptr<FusedKernel>, torch::hash<ArgSpec>>
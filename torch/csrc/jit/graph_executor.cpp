@@ -11,6 +11,7 @@
 #include <torch/csrc/jit/ir.h>
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/pass_manager.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
 #include <torch/csrc/jit/passes/batch_mm.h>
 #include <torch/csrc/jit/passes/canonicalize_ops.h>
 #include <torch/csrc/jit/passes/common_subexpression_elimination.h>
@@ -19,6 +20,7 @@
 #include <torch/csrc/jit/passes/create_autodiff_subgraphs.h>
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
 #include <torch/csrc/jit/passes/decompose_ops.h>
+#include <torch/csrc/jit/passes/fork_independent_branches.h>
 #include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/inline_autodiff_subgraphs.h>
 #include <torch/csrc/jit/passes/inliner.h>
@@ -554,29 +556,29 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
 
     // Phase 0. Inline functions, then clean up any artifacts that the inliner
     //          left in that may inhibit optimization
-    Inline(*opt_graph);
-    LowerGradOf(*opt_graph);
-    specializeAutogradZero(*opt_graph);
-    LowerSimpleTuples(opt_graph);
-    ConstantPooling(opt_graph);
+    GRAPH_TIMED(Inline(*opt_graph));
+    GRAPH_TIMED(LowerGradOf(*opt_graph));
+    GRAPH_TIMED(specializeAutogradZero(*opt_graph));
+    GRAPH_TIMED(LowerSimpleTuples(opt_graph));
+    GRAPH_TIMED(ConstantPooling(opt_graph));
 
     // Phase 1. Specialize to input definedness (this is very important for
     //          gradient graphs), and run required passes to bring the graph
     //          to an executable form.
-    runRequiredPasses(opt_graph);
+    GRAPH_TIMED(runRequiredPasses(opt_graph));
 
     // Phase 2. Propagate detailed information about the spec through the
     //          graph (enabled more specializations in later passes).
     //          Shape propagation sometimes depends on certain arguments being
     //          constants, and constant propagation doesn't need shape
     //          information anyway, so it's better to run it first.
-    ConstantPropagation(opt_graph);
-    PropagateInputShapes(opt_graph);
-    PropagateRequiresGrad(opt_graph);
+    GRAPH_TIMED(ConstantPropagation(opt_graph));
+    GRAPH_TIMED(PropagateInputShapes(opt_graph));
+    GRAPH_TIMED(PropagateRequiresGrad(opt_graph));
 
     // Phase 3. Run differentiable optimizations (i.e. simple graph rewrites
     //          that we can still execute using autograd).
-    runOptimization(opt_graph);
+    GRAPH_TIMED(runOptimization(opt_graph));
 
     // Phase 4. If this graph will be differentiated, we need to slice out the
     //          symbolically differentiable subgraphs for further optimizations.
@@ -594,20 +596,23 @@ struct GraphExecutorImpl : public GraphExecutorImplBase {
         // control flows and miss shape information on nodes, so we run shape
         // prop and differentiable optimizations to ensure the graph is
         // optimized
-        PropagateInputShapes(gradient.f);
-        runOptimization(gradient.f);
+        GRAPH_TIMED(PropagateInputShapes(gradient.f));
+        GRAPH_TIMED(runOptimization(gradient.f));
         // run non diff optimization on the forward graph
-        runNondiffOptimization(gradient.f);
+        GRAPH_TIMED(runNondiffOptimization(gradient.f));
         packGradient(gradient, dnode);
       }
       InlineAutodiffSubgraphs(
           opt_graph,
           autodiff_subgraph_inlining ? autodiffSubgraphInlineThreshold : 1);
     } else {
-      runNondiffOptimization(opt_graph);
+      GRAPH_TIMED(runNondiffOptimization(opt_graph));
     }
     // Make sure there are no leftovers from any passes.
-    EliminateDeadCode(opt_graph);
+    GRAPH_TIMED(EliminateDeadCode(opt_graph));
+    if (getAutomaticForkMode()) {
+      GRAPH_TIMED(ForkIndependentBranches(opt_graph));
+    }
     return ExecutionPlan(opt_graph);
   }
 
@@ -657,9 +662,9 @@ void runRequiredPasses(const std::shared_ptr<Graph>& g) {
   // when used inside script methods that might have unstable shapes
   // we remove the implicitly created ones, and have shape analysis
   // add valid expand nodes when the shapes are stable
-  RemoveExpands(g);
-  CanonicalizeOps(g);
-  EliminateDeadCode(g);
+  GRAPH_TIMED(RemoveExpands(g));
+  GRAPH_TIMED(CanonicalizeOps(g));
+  GRAPH_TIMED(EliminateDeadCode(g));
 }
 
 void packGradient(const Gradient& gradient, Node* dnode) {
@@ -711,20 +716,20 @@ void runNondiffOptimization(std::shared_ptr<Graph>& graph) {
   // decomposition pass, decompose certain ops that will be used in the
   // following passes (like batchmm and jit fusion)
   if (!getProfilingMode()) {
-    DecomposeOps(graph);
+    GRAPH_TIMED(DecomposeOps(graph));
   }
 
   // TupleConstruct / TupleUnpack pairs can still be present at this point
   // and must be removed for fusion.
-  LowerSimpleTuples(graph);
+  GRAPH_TIMED(LowerSimpleTuples(graph));
 
   // Rewrite subgraphs with many MMs into expressions that batch them.
-  BatchMM(graph);
+  GRAPH_TIMED(BatchMM(graph));
 
   // Fuse the dequant - op - quant patterns into quantized ops
-  QuantFusion(graph);
+  GRAPH_TIMED(QuantFusion(graph));
 
-  FuseGraph(graph);
+  GRAPH_TIMED(FuseGraph(graph));
 
   // Run custom passes that different backends can register.
   // This is done last to give internal optimization passes priority.
@@ -734,20 +739,24 @@ void runNondiffOptimization(std::shared_ptr<Graph>& graph) {
 }
 
 void runOptimization(std::shared_ptr<Graph>& graph) {
-  // Basic graph preprocessing to eliminate noise.
-  EliminateDeadCode(graph);
-  EliminateCommonSubexpression(graph);
+  // Basic graph preprocessing to eliminate noise. DCE keeps the alias
+  // analysis up to date, so CSE can reuse it.
+  {
+    AliasDb aliasDb(graph);
+    GRAPH_TIMED(EliminateDeadCode(graph, aliasDb));
+    GRAPH_TIMED(EliminateCommonSubexpression(graph, aliasDb));
+  }
 
-  PeepholeOptimize(graph);
-  ConstantPropagation(graph);
-  ConstantPooling(graph);
+  GRAPH_TIMED(PeepholeOptimize(graph));
+  GRAPH_TIMED(ConstantPropagation(graph));
+  GRAPH_TIMED(ConstantPooling(graph));
 
   // Unroll small loops, and eliminate expressions that are the same at every
   // iteration.
-  UnrollLoops(graph);
-  EliminateCommonSubexpression(graph);
+  GRAPH_TIMED(UnrollLoops(graph));
+  GRAPH_TIMED(EliminateCommonSubexpression(graph));
 
-  CheckInplace(graph);
+  GRAPH_TIMED(CheckInplace(graph));
 }
 
 } // namespace jit
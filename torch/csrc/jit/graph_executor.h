@@ -37,6 +37,11 @@ struct GraphExecutorState {
   const Graph* graph = nullptr;
   ExecutionPlan fallback; // XXX: members of this field are optional
   std::unordered_map<ArgumentSpec, ExecutionPlan> execution_plans;
+  // statistics of the specialization cache of the profiling executor
+  size_t specialization_cache_size = 0;
+  size_t specialization_cache_hits = 0;
+  size_t specialization_cache_misses = 0;
+  size_t specialization_cache_evictions = 0;
 };
 
 struct GraphExecutorImplBase;
@@ -77,6 +82,15 @@ TORCH_API std::atomic<bool> &getProfilingMode();
 TORCH_API std::atomic<bool>& getExecutorMode();
 TORCH_API std::atomic<size_t>& getNumProfiledRuns();
 TORCH_API std::atomic<size_t>& getBailoutDepth();
+// Maximum number of input specializations the profiling executor keeps
+// optimized plans for, the least recently used one being evicted first
+TORCH_API std::atomic<size_t>& getSpecializationCacheSize();
+// If set, the profiling executor does not specialize to the size of the
+// first dimension of tensors, so that one plan serves all batch sizes
+TORCH_API std::atomic<bool>& getSymbolicBatchMode();
+// If set, optimized graphs run their independent branches concurrently on
+// the inter-op thread pool, see ForkIndependentBranches
+TORCH_API std::atomic<bool>& getAutomaticForkMode();
 
 struct TORCH_API GraphOptimizerEnabledGuard {
   GraphOptimizerEnabledGuard(bool state)
@@ -15,8 +15,10 @@
 #include "caffe2/serialize/file_adapter.h"
 #include "caffe2/serialize/inline_container.h"
 #include "caffe2/serialize/istream_adapter.h"
+#include "caffe2/serialize/mmap_file_adapter.h"
 
 #include <ATen/ATen.h>
+#include <ATen/Parallel.h>
 
 #include <fstream>
 #include <string>
@@ -28,6 +30,7 @@ namespace jit {
 
 using caffe2::serialize::FileAdapter;
 using caffe2::serialize::IStreamAdapter;
+using caffe2::serialize::MmapFileAdapter;
 using caffe2::serialize::PyTorchStreamReader;
 using caffe2::serialize::ReadAdapterInterface;
 
@@ -59,7 +62,9 @@ IValue readArchiveAndTensors(
     c10::optional<ClassResolver> class_resolver,
     c10::optional<ObjLoader> obj_loader,
     c10::optional<at::Device> device,
-    PyTorchStreamReader& stream_reader) {
+    PyTorchStreamReader& stream_reader,
+    c10::optional<std::function<at::DataPtr(const std::string&)>>
+        read_record_override) {
   std::string picklename = archive_name + ".pkl";
   at::DataPtr pickle_ptr;
   size_t pickle_size;
@@ -82,6 +87,9 @@ IValue readArchiveAndTensors(
   std::string archive_name_plus_slash = archive_name + "/";
   auto read_record = [&](const std::string& name) {
     std::string ss = archive_name_plus_slash + name;
+    if (read_record_override) {
+      return (*read_record_override)(ss);
+    }
     return std::get<0>(stream_reader.getRecord(ss));
   };
 
@@ -104,11 +112,14 @@ namespace {
 // the constant table and the script module.
 class ScriptModuleDeserializer final {
  public:
+  // mapped_file is the adapter of reader if it reads a memory-mapped file
   ScriptModuleDeserializer(
       std::shared_ptr<script::CompilationUnit> cu,
-      std::unique_ptr<PyTorchStreamReader> reader)
+      std::unique_ptr<PyTorchStreamReader> reader,
+      const MmapFileAdapter* mapped_file = nullptr)
       : compilation_unit_(cu),
         reader_(std::move(reader)),
+        mapped_file_(mapped_file),
         source_importer_(
             compilation_unit_,
             &constants_table_,
@@ -124,9 +135,12 @@ class ScriptModuleDeserializer final {
 
  private:
   IValue readArchive(const std::string& archive_name);
+  std::function<at::DataPtr(const std::string&)> readMappedRecords(
+      const std::string& archive_name);
 
   std::shared_ptr<script::CompilationUnit> compilation_unit_;
   std::unique_ptr<PyTorchStreamReader> reader_;
+  const MmapFileAdapter* mapped_file_;
   c10::optional<at::Device> device_;
   std::vector<at::Tensor> constants_table_;
   script::SourceImporter source_importer_;
@@ -173,8 +187,74 @@ IValue ScriptModuleDeserializer::readArchive(const std::string& archive_name) {
     }
   };
 
+  c10::optional<std::function<at::DataPtr(const std::string&)>> read_record;
+  if (mapped_file_) {
+    read_record = readMappedRecords(archive_name);
+  }
   return readArchiveAndTensors(
-      archive_name, class_resolver, obj_loader, device_, *reader_.get());
+      archive_name,
+      class_resolver,
+      obj_loader,
+      device_,
+      *reader_.get(),
+      std::move(read_record));
+}
+
+// Returns a reader of the tensor records of the archive. Records stored
+// aligned alias the mapped file. The ones stored unaligned are copied out of
+// it up front on the intra-op thread pool, as copies from the mapping can run
+// concurrently, and compressed ones are extracted by the reader on demand.
+std::function<at::DataPtr(const std::string&)> ScriptModuleDeserializer::
+    readMappedRecords(const std::string& archive_name) {
+  struct Copy {
+    std::string name;
+    size_t offset;
+    size_t size;
+  };
+  auto records = std::make_shared<std::unordered_map<std::string, at::DataPtr>>();
+  std::vector<Copy> copies;
+  const std::string records_prefix = archive_name + "/";
+  for (const auto& path : reader_->getAllRecords()) {
+    // drop the name of the zip folder all the records are in
+    const auto slash = path.find('/');
+    if (slash == std::string::npos) {
+      continue;
+    }
+    auto name = path.substr(slash + 1);
+    if (name.compare(0, records_prefix.size(), records_prefix) != 0 ||
+        reader_->isRecordCompressed(name)) {
+      continue;
+    }
+    const size_t offset = reader_->getRecordOffset(name);
+    const size_t size = reader_->getRecordSize(name);
+    if (offset % caffe2::serialize::kFieldAlignment == 0) {
+      (*records)[name] = mapped_file_->alias(offset, size, "aliasing record");
+    } else {
+      copies.push_back({std::move(name), offset, size});
+    }
+  }
+
+  std::vector<at::DataPtr> copied(copies.size());
+  at::parallel_for(0, copies.size(), 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; ++i) {
+      void* ptr = malloc(copies[i].size);
+      copied[i] = at::DataPtr(ptr, ptr, free, at::kCPU);
+      mapped_file_->read(copies[i].offset, ptr, copies[i].size, "copying record");
+    }
+  });
+  for (size_t i = 0; i < copies.size(); ++i) {
+    (*records)[copies[i].name] = std::move(copied[i]);
+  }
+
+  return [this, records](const std::string& name) {
+    auto it = records->find(name);
+    if (it == records->end()) {
+      return std::get<0>(reader_->getRecord(name));
+    }
+    auto data = std::move(it->second);
+    records->erase(it);
+    return data;
+  };
 }
 
 script::Module ScriptModuleDeserializer::deserialize(
@@ -240,6 +320,19 @@ script::Module import_ir_module(
   return deserializer.deserialize(device, extra_files);
 }
 
+script::Module import_ir_module_mmap(
+    std::shared_ptr<script::CompilationUnit> cu,
+    const std::string& filename,
+    c10::optional<at::Device> device,
+    script::ExtraFilesMap& extra_files) {
+  auto rai = torch::make_unique<MmapFileAdapter>(filename);
+  const MmapFileAdapter* mapped_file = rai.get();
+  auto reader = torch::make_unique<PyTorchStreamReader>(std::move(rai));
+  ScriptModuleDeserializer deserializer(
+      std::move(cu), std::move(reader), mapped_file);
+  return deserializer.deserialize(device, extra_files);
+}
+
 script::Module load(
     std::istream& in,
     c10::optional<at::Device> device,
@@ -291,5 +384,13 @@ script::Module load(
   return deserializer.deserialize(device, extra_files);
 }
 
+script::Module load_mmap(
+    const std::string& filename,
+    c10::optional<c10::Device> device,
+    script::ExtraFilesMap& extra_files) {
+  auto cu = std::make_shared<script::CompilationUnit>();
+  return import_ir_module_mmap(std::move(cu), filename, device, extra_files);
+}
+
 } // namespace jit
 } // namespace torch
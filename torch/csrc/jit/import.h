@@ -36,6 +36,12 @@ TORCH_API script::Module import_ir_module(
     c10::optional<c10::Device> device = c10::nullopt,
     script::ExtraFilesMap& extra_files = default_extra_files);
 
+TORCH_API script::Module import_ir_module_mmap(
+    std::shared_ptr<script::CompilationUnit> cu,
+    const std::string& filename,
+    c10::optional<c10::Device> device = c10::nullopt,
+    script::ExtraFilesMap& extra_files = default_extra_files);
+
 /// Loads a serialized `script::Module` from the given `istream`.
 ///
 /// The istream must contain a serialized `script::Module`, exported via
@@ -65,12 +71,30 @@ TORCH_API script::Module load(
     c10::optional<c10::Device> device = c10::nullopt,
     script::ExtraFilesMap& extra_files = default_extra_files);
 
+/// Loads a serialized `script::Module` from the given `filename` by memory
+/// mapping the file.
+///
+/// Tensor records that are stored uncompressed and aligned, as
+/// `ScriptModule.save()` writes them, become storages aliasing the mapping
+/// instead of being copied, so loading takes no memory for them up front and
+/// their pages are only read on first use. The mapping is copy-on-write and
+/// lives as long as any of these storages. The other tensor records are
+/// copied out of the mapping in parallel.
+TORCH_API script::Module load_mmap(
+    const std::string& filename,
+    c10::optional<c10::Device> device = c10::nullopt,
+    script::ExtraFilesMap& extra_files = default_extra_files);
+
+// Reads the tensor records with read_record if given, which is passed record
+// names relative to the archive root, and with stream_reader otherwise.
 TORCH_API IValue readArchiveAndTensors(
     const std::string& archive_name,
     c10::optional<ClassResolver> class_resolver,
     c10::optional<ObjLoader> obj_loader,
     c10::optional<at::Device> device,
-    caffe2::serialize::PyTorchStreamReader& stream_reader);
+    caffe2::serialize::PyTorchStreamReader& stream_reader,
+    c10::optional<std::function<at::DataPtr(const std::string&)>>
+        read_record = c10::nullopt);
 
 } // namespace jit
 } // namespace torch
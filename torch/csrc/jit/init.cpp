@@ -3,12 +3,14 @@
 #include <torch/csrc/jit/argument_spec.h>
 #include <torch/csrc/jit/autodiff.h>
 #include <torch/csrc/jit/export.h>
+#include <torch/csrc/jit/fuser/disk_cache.h>
 #include <torch/csrc/jit/fuser/interface.h>
 #include <torch/csrc/jit/fuser/kernel_cache.h>
 #include <torch/csrc/jit/graph_executor.h>
 #include <torch/csrc/jit/import.h>
 #include <torch/csrc/jit/irparser.h>
 #include <torch/csrc/jit/operator.h>
+#include <torch/csrc/jit/passes/batch_mm.h>
 #include <torch/csrc/jit/passes/canonicalize.h>
 #include <torch/csrc/jit/passes/canonicalize_ops.h>
 #include <torch/csrc/jit/passes/common_subexpression_elimination.h>
@@ -18,8 +20,12 @@
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
 #include <torch/csrc/jit/passes/decompose_ops.h>
 #include <torch/csrc/jit/passes/erase_number_types.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/fuse_dropout_add_layer_norm.h>
+#include <torch/csrc/jit/passes/mkldnn_layout.h>
 #include <torch/csrc/jit/passes/fuse_linear.h>
 #include <torch/csrc/jit/passes/graph_fuser.h>
+#include <torch/csrc/jit/passes/fork_independent_branches.h>
 #include <torch/csrc/jit/passes/inline_fork_wait.h>
 #include <torch/csrc/jit/passes/inliner.h>
 #include <torch/csrc/jit/passes/loop_unrolling.h>
@@ -54,6 +60,7 @@
 #include <torch/csrc/jit/script/jit_exception.h>
 #include <torch/csrc/jit/script/module.h>
 #include <torch/csrc/jit/script/python_tree_views.h>
+#include <torch/csrc/jit/static_runtime.h>
 #include <torch/csrc/jit/tracer.h>
 
 #include <c10/macros/Export.h>
@@ -110,6 +117,10 @@ void initJITBindings(PyObject* module) {
       .def(
           "_jit_debug_fuser_num_cached_kernel_specs",
           torch::jit::fuser::debugNumCachedKernelSpecs)
+      .def(
+          "_jit_fuser_set_disk_cache_dir", torch::jit::fuser::setDiskCacheDir)
+      .def(
+          "_jit_fuser_get_disk_cache_dir", torch::jit::fuser::getDiskCacheDir)
       .def("_jit_pass_onnx_remove_print", RemovePrintOps)
       .def("_jit_pass_onnx_preprocess_caffe2", PreprocessCaffe2Ops)
       .def("_jit_pass_onnx", ToONNX)
@@ -197,12 +208,20 @@ void initJITBindings(PyObject* module) {
           [](std::shared_ptr<Graph>& g) { return QuantFusion(g); })
       .def("_jit_pass_fold_convbn", &FoldConvBatchNorm2d)
       .def("_jit_pass_fuse_linear", &FuseLinear)
+      .def(
+          "_jit_pass_fuse_dropout_add_layer_norm", &FuseDropoutAddLayerNorm)
+      .def(
+          "_jit_pass_insert_mkldnn_layout_conversions",
+          &InsertMkldnnLayoutConversions)
       .def(
           "_jit_pass_fold_quantize",
           [](script::Module& module, const std::string& method_name) {
             FoldQuantizeCallIntoBuffer(module, method_name);
           })
       .def("_jit_pass_fold_prepack", &FoldPrepackedWeightIntoModule)
+      .def(
+          "_jit_pass_freeze_module",
+          [](const script::Module& module) { return freeze_module(module); })
       .def("_jit_pass_dedup_module_uses", &DedupModuleUses)
       .def(
           "_jit_pass_pattern_based_rewrite",
@@ -270,6 +289,9 @@ void initJITBindings(PyObject* module) {
       .def("_jit_pass_remove_expands", RemoveExpands)
       .def("_jit_pass_erase_number_types", EraseNumberTypes)
       .def("_jit_pass_inline_fork_wait", InlineForkWait)
+      .def(
+          "_jit_pass_fork_independent_branches",
+          [](std::shared_ptr<Graph>& g) { return ForkIndependentBranches(g); })
       .def("_jit_pass_inline", Inline)
       .def("_jit_pass_prepare_division_for_onnx", PrepareDivisionForONNX)
       .def(
@@ -319,8 +341,14 @@ void initJITBindings(PyObject* module) {
       .def("_jit_pass_fixup_onnx_conditionals", FixupONNXConditionals)
       .def("_jit_pass_canonicalize_ops", CanonicalizeOps)
       .def("_jit_pass_decompose_ops", DecomposeOps)
+      .def("_jit_pass_batch_mm", BatchMM)
       .def("_jit_pass_specialize_autogradzero", specializeAutogradZero)
       .def("_jit_override_can_fuse_on_cpu", &overrideCanFuseOnCPU)
+      .def("_jit_can_fuse_on_cpu", &canFuseOnCPU)
+      .def(
+          "_jit_override_use_vectorized_cpu_fuser",
+          &overrideUseVectorizedCPUFuser)
+      .def("_jit_use_vectorized_cpu_fuser", &useVectorizedCPUFuser)
       .def(
           "_jit_differentiate",
           [](Graph& g) {
@@ -352,6 +380,13 @@ void initJITBindings(PyObject* module) {
             getExecutorMode() = profiling_flag;
             return oldState;
           })
+      .def(
+          "_jit_set_interpreter_superinstructions",
+          [](bool enabled) {
+            bool oldState = getInterpreterSuperinstructions();
+            getInterpreterSuperinstructions() = enabled;
+            return oldState;
+          })
       .def(
           "_jit_set_num_profiled_runs",
           [](size_t num) {
@@ -366,6 +401,27 @@ void initJITBindings(PyObject* module) {
             getBailoutDepth() = depth;
             return old_depth;
           })
+      .def(
+          "_jit_set_specialization_cache_size",
+          [](size_t size) {
+            size_t old_size = getSpecializationCacheSize();
+            getSpecializationCacheSize() = size;
+            return old_size;
+          })
+      .def(
+          "_jit_set_symbolic_batch_mode",
+          [](bool enabled) {
+            bool old_state = getSymbolicBatchMode();
+            getSymbolicBatchMode() = enabled;
+            return old_state;
+          })
+      .def(
+          "_jit_set_automatic_fork_mode",
+          [](bool enabled) {
+            bool old_state = getAutomaticForkMode();
+            getAutomaticForkMode() = enabled;
+            return old_state;
+          })
       .def(
           "_jit_set_inline_everything_mode",
           [](bool enabled) { script::getInlineEverythingMode() = enabled; })
@@ -427,6 +483,24 @@ void initJITBindings(PyObject* module) {
         c.request_bailout(index);
       });
 
+  py::class_<StaticRuntime>(m, "StaticRuntime")
+      .def(py::init<std::shared_ptr<Graph>>())
+      .def(py::init<const script::Module&>())
+      .def(
+          "run",
+          [](StaticRuntime& self, const std::vector<at::Tensor>& inputs) {
+            std::vector<IValue> outputs =
+                self.run(std::vector<IValue>(inputs.begin(), inputs.end()));
+            if (outputs.size() == 1) {
+              return toPyObject(std::move(outputs[0]));
+            }
+            return toPyObject(c10::ivalue::Tuple::create(std::move(outputs)));
+          })
+      .def_property_readonly("graph", &StaticRuntime::graph)
+      .def_property_readonly("arena_bytes", &StaticRuntime::arenaBytes)
+      .def_property_readonly(
+          "num_planned_values", &StaticRuntime::numPlannedValues);
+
   py::class_<ExecutionPlan>(m, "ExecutionPlan")
       .def_property_readonly("graph", [](ExecutionPlan& s) { return s.graph; })
       .def_property_readonly("code", [](ExecutionPlan& s) { return s.code; });
@@ -454,7 +528,21 @@ void initJITBindings(PyObject* module) {
           "execution_plans",
           [](GraphExecutorState& s) { return s.execution_plans; })
       .def_property_readonly(
-          "fallback", [](GraphExecutorState& s) { return s.fallback; });
+          "fallback", [](GraphExecutorState& s) { return s.fallback; })
+      .def_property_readonly(
+          "specialization_cache_size",
+          [](GraphExecutorState& s) { return s.specialization_cache_size; })
+      .def_property_readonly(
+          "specialization_cache_hits",
+          [](GraphExecutorState& s) { return s.specialization_cache_hits; })
+      .def_property_readonly(
+          "specialization_cache_misses",
+          [](GraphExecutorState& s) { return s.specialization_cache_misses; })
+      .def_property_readonly(
+          "specialization_cache_evictions",
+          [](GraphExecutorState& s) {
+            return s.specialization_cache_evictions;
+          });
 
   py::class_<PyTorchStreamWriter>(m, "PyTorchFileWriter")
       .def(py::init<std::string>())
@@ -16,6 +16,7 @@ namespace jit {
 // F - index into function table
 // T - index into the type table, used for guard instructions
 // S - index into object slots
+// U - index into the superinstruction table
 
 #define FORALL_OPCODES(_)                                                   \
   _(OP, "O") /* invoke operator X */                                        \
@@ -38,7 +39,8 @@ namespace jit {
   _(TAIL_CALL, "F") /* replace current frame with function F */             \
   _(INTERFACE_CALL, "CI") /* call method X on the first argument (of N) */  \
   _(GET_ATTR, "S") /* get attribute from slot X in an Object */             \
-  _(SET_ATTR, "S") /* set attribute to slot X in an Object */
+  _(SET_ATTR, "S") /* set attribute to slot X in an Object */               \
+  _(OPR, "U") /* push operands, invoke an operator, store its result */
 
 enum OpCode : uint8_t {
 #define DEFINE_OP(op, _) op,
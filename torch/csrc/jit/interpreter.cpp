@@ -18,6 +18,7 @@
 #include <torch/csrc/jit/script/compilation_unit.h>
 #include <torch/csrc/jit/script/jit_exception.h>
 
+#include <atomic>
 #include <exception>
 #include <iostream>
 #include <memory>
@@ -340,6 +341,21 @@ struct BailoutBlock {
   std::vector<Instruction> instructions; // ends in a TAIL_CALL
 };
 
+// An OPR instruction replaces the run of LOAD, MOVE and LOADC instructions
+// that pushes the operands of an operator, the OP itself and the STORE of its
+// result, so the whole sequence costs one dispatch through the interpreter
+// loop instead of one per instruction.
+struct Superinstruction {
+  int32_t op; // index into the operator table
+  std::vector<Instruction> inputs; // LOAD, MOVE or LOADC, in push order
+  int32_t output; // register the result is stored to, 0 to leave it pushed
+};
+
+std::atomic<bool>& getInterpreterSuperinstructions() {
+  static std::atomic<bool> enabled{true};
+  return enabled;
+}
+
 struct CodeImpl {
   friend struct InterpreterState;
   std::vector<Instruction> instructions_;
@@ -353,7 +369,12 @@ struct CodeImpl {
   std::vector<Operation> operator_table_;
   std::vector<Function*> function_table_;
   std::vector<TypePtr> type_table_;
+  std::vector<Superinstruction> superinstruction_table_;
   int register_size_ = 0;
+  // the stack size that earlier runs peaked at on top of their inputs. Runs
+  // reserve it up front instead of growing the stack as they go, and it is
+  // updated without synchronization as it is only a hint.
+  std::atomic<size_t> stack_size_hint_{0};
   size_t n_outputs;
   size_t n_inputs;
   TypePtr return_type_;
@@ -384,7 +405,10 @@ struct CodeImpl {
   std::vector<std::unique_ptr<Function>> bailout_functions_;
   size_t remaining_bailout_depth_;
 
-  CodeImpl(const std::shared_ptr<Graph>& graph, size_t remaining_bailout_depth)
+  CodeImpl(
+      const std::shared_ptr<Graph>& graph,
+      size_t remaining_bailout_depth,
+      bool allow_superinstructions)
       : preprocess_(*graph),
         current_node_(preprocess_.graph->return_node()),
         remaining_bailout_depth_(remaining_bailout_depth) {
@@ -403,6 +427,9 @@ struct CodeImpl {
     // we deferred the emission of bailout blocks so they appear at the end
     // emit them now and patch up the jumps
     insertBailoutBlocks();
+    if (allow_superinstructions && getInterpreterSuperinstructions()) {
+      emitSuperinstructions();
+    }
   }
 
   const std::vector<c10::IValue>& constant_table() const {
@@ -681,6 +708,94 @@ struct CodeImpl {
           instructions_source_[block.jf_instruction_index]);
     }
   }
+
+  static bool isOperandLoad(OpCode op) {
+    return op == LOAD || op == MOVE || op == LOADC;
+  }
+
+  static bool isJump(OpCode op) {
+    return op == JF || op == JMP || op == LOOP;
+  }
+
+  // Peephole over the finished instruction list: every OP, together with the
+  // operand loads right before it and the STORE right after it, becomes one
+  // OPR. Instructions are only folded into a superinstruction that starts
+  // before them if no jump lands on them, and jump offsets are recomputed for
+  // the shorter list.
+  void emitSuperinstructions() {
+    const size_t n = instructions_.size();
+    std::vector<bool> is_jump_target(n + 1, false);
+    for (size_t i = 0; i < n; ++i) {
+      if (isJump(instructions_[i].op)) {
+        is_jump_target[i + instructions_[i].X] = true;
+      }
+    }
+
+    // fused_end[begin] is one past the last instruction folded into the
+    // superinstruction starting at begin, 0 where none starts.
+    std::vector<size_t> fused_end(n, 0);
+    for (size_t i = 0; i < n; ++i) {
+      if (instructions_[i].op != OP) {
+        continue;
+      }
+      size_t begin = i;
+      while (begin > 0 && isOperandLoad(instructions_[begin - 1].op) &&
+             !is_jump_target[begin]) {
+        --begin;
+      }
+      size_t end = i + 1;
+      if (end < n && instructions_[end].op == STORE && !is_jump_target[end]) {
+        ++end;
+      }
+      if (end - begin > 1) {
+        fused_end[begin] = end;
+      }
+    }
+
+    std::vector<Instruction> instructions;
+    std::vector<Node*> instructions_source;
+    // position of the instruction that covers each original instruction.
+    std::vector<size_t> new_index(n + 1);
+    for (size_t i = 0; i < n;) {
+      const size_t index = instructions.size();
+      if (fused_end[i] == 0) {
+        new_index[i] = index;
+        instructions.push_back(instructions_[i]);
+        instructions_source.push_back(instructions_source_[i]);
+        ++i;
+        continue;
+      }
+      const size_t end = fused_end[i];
+      Superinstruction fused{0, {}, 0};
+      Node* source = nullptr;
+      for (; i < end; ++i) {
+        new_index[i] = index;
+        const Instruction& inst = instructions_[i];
+        if (inst.op == OP) {
+          fused.op = inst.X;
+          source = instructions_source_[i];
+        } else if (inst.op == STORE) {
+          fused.output = inst.X;
+        } else {
+          fused.inputs.push_back(inst);
+        }
+      }
+      instructions.emplace_back(OPR, superinstruction_table_.size(), 0);
+      instructions_source.push_back(source);
+      superinstruction_table_.push_back(std::move(fused));
+    }
+    new_index[n] = instructions.size();
+
+    for (size_t i = 0; i < n; ++i) {
+      if (isJump(instructions_[i].op)) {
+        Instruction& jump = instructions[new_index[i]];
+        jump.X = new_index[i + jump.X] - new_index[i];
+      }
+    }
+    instructions_ = std::move(instructions);
+    instructions_source_ = std::move(instructions_source);
+  }
+
   void emitInterfaceCall(
       std::string method_name_str,
       c10::ArrayRef<Value*> inputs) {
@@ -757,7 +872,8 @@ struct CodeImpl {
 
   void dump(std::ostream& out, size_t i) const {
     out << i << " " << instructions_[i];
-    if (instructions_[i].op == OP || instructions_[i].op == CALL) {
+    if (instructions_[i].op == OP || instructions_[i].op == OPR ||
+        instructions_[i].op == CALL) {
       out << " # " << *instructions_source_[i];
     } else {
       out << "\n";
@@ -783,6 +899,9 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
   // answer: to where it was when we were called, not
   // including any inputs to this function
   int64_t stack_start_ = -1;
+  // the largest the stack got during this run, including the part below
+  // stack_start_ that belongs to the caller
+  size_t peak_stack_size_ = 0;
   c10::intrusive_ptr<Future> future_;
 
   // this holds all the tensors for this interpreter run
@@ -822,6 +941,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     Operation* operators;
     Function** functions;
     TypePtr* types;
+    Superinstruction* superinstructions;
 
     ActiveFrame(const Frame& frame)
         : pc(frame.pc),
@@ -829,7 +949,9 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
           constants(frame.function->constant_table_.data()),
           operators(frame.function->operator_table_.data()),
           functions(frame.function->function_table_.data()),
-          types(frame.function->type_table_.data()) {}
+          types(frame.function->type_table_.data()),
+          superinstructions(
+              frame.function->superinstruction_table_.data()) {}
   };
 
   std::vector<Frame> frames;
@@ -865,6 +987,15 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     }
   }
 
+  void recordStackSize() {
+    auto& hint = frames.back().function->stack_size_hint_;
+    const size_t needed =
+        peak_stack_size_ - static_cast<size_t>(stack_start_);
+    if (needed > hint.load(std::memory_order_relaxed)) {
+      hint.store(needed, std::memory_order_relaxed);
+    }
+  }
+
   bool runImpl(Stack& stack) {
     // if we have never run before, then we might have to return the
     // stack when we suspend, record where it starts so we return the right
@@ -872,6 +1003,10 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     if (stack_start_ == -1) {
       TORCH_INTERNAL_ASSERT(stack.size() >= frames.back().function->n_inputs);
       stack_start_ = stack.size() - frames.back().function->n_inputs;
+      stack.reserve(
+          stack.size() +
+          frames.back().function->stack_size_hint_.load(
+              std::memory_order_relaxed));
     } else {
       // during restarts, all of the stack is always our own, so we leave
       // nothing
@@ -881,6 +1016,9 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
     ActiveFrame af(frames.back());
     try {
       while (true) {
+        if (stack.size() > peak_stack_size_) {
+          peak_stack_size_ = stack.size();
+        }
 //         std::cout << "RUNNING ";
 //         frames.back().function->dump(std::cout, af.pc);
         Instruction inst = af.instructions[af.pc];
@@ -889,6 +1027,23 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
             af.operators[inst.X](stack);
             ++af.pc;
             break;
+          case OPR: {
+            const Superinstruction& fused = af.superinstructions[inst.X];
+            for (const Instruction& input : fused.inputs) {
+              if (input.op == LOAD) {
+                stack.emplace_back(reg(input.X));
+              } else if (input.op == MOVE) {
+                stack.emplace_back(std::move(reg(input.X)));
+              } else {
+                stack.emplace_back(af.constants[input.X]);
+              }
+            }
+            af.operators[fused.op](stack);
+            if (fused.output != 0) {
+              reg(fused.output) = pop(stack);
+            }
+            ++af.pc;
+          } break;
           case OPN:
             AT_ERROR("OPN is currently supported in mobile mode only.");
             break;
@@ -1007,6 +1162,7 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
               af = ActiveFrame(frames.back());
               break;
             }
+            recordStackSize();
             if (future_) {
               auto num_outputs = frames.back().function->n_outputs;
               if (num_outputs == 1) {
@@ -1031,14 +1187,15 @@ struct InterpreterStateImpl : c10::intrusive_ptr_target {
                     : state_(std::move(state)), stack_(std::move(stack)) {}
                 void operator()() {
                   at::launch(InterpreterContinuation(
-                      state_,
-                      std::move(stack_),
-                      autograd::GradMode::is_enabled()));
+                      state_, std::move(stack_), std::move(thread_locals_)));
                 }
 
                private:
                 InterpreterState state_;
                 Stack stack_;
+                // the state of the suspended thread, not of the one that
+                // completes the future
+                at::ThreadLocalState thread_locals_;
               };
 
               // we are suspending, so we need to reset the stack to where we
@@ -1197,8 +1354,14 @@ std::ostream& operator<<(std::ostream& out, const Code& code) {
   return out;
 }
 
-Code::Code(const std::shared_ptr<Graph>& graph, size_t remaining_bailout_depth)
-    : pImpl(new CodeImpl(graph, remaining_bailout_depth)) {}
+Code::Code(
+    const std::shared_ptr<Graph>& graph,
+    size_t remaining_bailout_depth,
+    bool allow_superinstructions)
+    : pImpl(new CodeImpl(
+          graph,
+          remaining_bailout_depth,
+          allow_superinstructions)) {}
 Code::~Code() = default;
 
 const std::vector<GraphExecutor*>& Code::grad_executors() {
@@ -1258,7 +1421,7 @@ InterpreterState::InterpreterState(
     : pImpl(std::move(pImpl_)) {}
 
 void InterpreterContinuation::operator()() {
-  autograd::AutoGradMode grad_mode(grad_mode_enabled);
+  at::ThreadLocalStateGuard guard(std::move(thread_locals));
   state.runAsync(stack);
 }
 } // namespace jit
@@ -1,8 +1,10 @@
 #pragma once
 #include <c10/util/Optional.h>
+#include <atomic>
 #include <memory>
 #include <vector>
 
+#include <ATen/ThreadLocalState.h>
 #include <ATen/core/ivalue.h>
 #include <torch/csrc/WindowsTorchApiMacro.h>
 
@@ -35,10 +37,13 @@ struct TORCH_API Code {
   Code() : pImpl(nullptr) {}
   // remaining_bailout_depth is irrelevant in a `Code` object unless the `Code`
   // is directly created by `GraphExecutor` in which case it's likely to contain
-  // `prim::BailOut`s to control the maximum depth of bailout chains
+  // `prim::BailOut`s to control the maximum depth of bailout chains.
+  // allow_superinstructions = false keeps the instructions to the base set
+  // understood by the mobile interpreter.
   explicit Code(
       const std::shared_ptr<Graph>& graph,
-      size_t remaining_bailout_depth = 0);
+      size_t remaining_bailout_depth = 0,
+      bool allow_superinstructions = true);
   ~Code();
 
   const std::vector<GraphExecutor*>& grad_executors();
@@ -88,23 +93,31 @@ struct Suspend : public std::exception {
   c10::intrusive_ptr<Future> future;
 };
 
+// Resumes an interpreter, e.g. the one of a forked graph, on the inter-op
+// thread pool. It runs with the thread local state (grad mode, debug info,
+// ...) captured when it was created, not the state of the thread that
+// launches it, which for a wait on a future is the one completing it.
 struct InterpreterContinuation {
   InterpreterContinuation(
       InterpreterState state_,
       Stack stack_,
-      bool grad_mode_enabled_)
+      at::ThreadLocalState thread_locals_ = at::ThreadLocalState())
       : state(state_),
         stack(std::move(stack_)),
-        grad_mode_enabled(grad_mode_enabled_) {}
+        thread_locals(std::move(thread_locals_)) {}
 
   void operator()();
 
  private:
   InterpreterState state;
   Stack stack;
-  bool grad_mode_enabled;
+  at::ThreadLocalState thread_locals;
 };
 
+// Whether new Code fuses operand loads, OP and STORE sequences into OPR
+// superinstructions. Code that has already been created is not affected.
+TORCH_API std::atomic<bool>& getInterpreterSuperinstructions();
+
 // what is the tensors type, including state from the current execution context
 // that modifies how the tensor behaves. For instance if no_grad is enabled
 // this will cause the TensorType to have requires_grad=False.
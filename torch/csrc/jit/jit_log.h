@@ -1,4 +1,5 @@
 #pragma once
+#include <chrono>
 #include <memory>
 #include <string>
 #include <torch/csrc/WindowsTorchApiMacro.h>
@@ -86,5 +87,24 @@ TORCH_API std::ostream& operator<<(std::ostream& out, JitLoggingLevels level);
 // use GRAPH_DEBUG to provide information useful for debugging a particular opt
 // pass
 #define GRAPH_DEBUG(...) JIT_LOG(JitLoggingLevels::GRAPH_DEBUG, __VA_ARGS__);
+
+// use GRAPH_TIMED to report how long a statement, e.g. an optimization pass,
+// takes at the GRAPH_UPDATE level, which helps to find the passes that
+// dominate the compilation time of large graphs
+#define GRAPH_TIMED(...)                                                       \
+  if (is_enabled(__FILE__, JitLoggingLevels::GRAPH_UPDATE)) {                  \
+    const auto graph_timed_start = std::chrono::steady_clock::now();           \
+    __VA_ARGS__;                                                               \
+    const std::chrono::duration<double, std::milli> graph_timed_ms =           \
+        std::chrono::steady_clock::now() - graph_timed_start;                  \
+    JIT_LOG(                                                                   \
+        JitLoggingLevels::GRAPH_UPDATE,                                        \
+        #__VA_ARGS__,                                                          \
+        " took ",                                                              \
+        graph_timed_ms.count(),                                                \
+        " ms");                                                                \
+  } else {                                                                     \
+    __VA_ARGS__;                                                               \
+  }
 } // namespace jit
 } // namespace torch
@@ -43,7 +43,18 @@ void Function::append_operator(const std::string& name,
   }
   auto op = c10::Dispatcher::singleton().findSchema(opname);
   TORCH_CHECK(op.has_value(), opname.name, ".", opname.overload_name, " cannot be found.");
-  code_->operators_.emplace_back(op);
+  auto handle = *op;
+  code_->operator_input_sizes_.emplace_back(
+      handle.schema().arguments().size());
+  const auto& dispatcher = c10::Dispatcher::singleton();
+  // Lite interpreter operators only have CPU kernels, or catch-all kernels
+  // that are called for every key.
+  const auto* kernel =
+      dispatcher.lookupKernel(handle, c10::DispatchKey::CPUTensorId);
+  const bool exclude_variable = kernel != nullptr &&
+      kernel != dispatcher.lookupKernel(
+          handle, c10::DispatchKey::VariableTensorId);
+  code_->operators_.push_back({handle, kernel, exclude_variable});
 }
 
 void Function::build_vararg_operator_table() {
@@ -85,7 +96,12 @@ void Function::set_register_size(size_t size) {
   code_->register_size_ = size;
 }
 
+std::shared_ptr<Code> Function::get_code() const {
+  return code_;
+}
+
 bool Function::run(Stack& stack) const {
+  c10::CPUAllocationPlan::Guard plan_guard(code_->allocation_plan_);
   InterpreterState interp_state(code_);
   return interp_state.run(stack);
 }
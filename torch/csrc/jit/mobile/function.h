@@ -25,6 +25,7 @@ class Function{
   void build_vararg_operator_table();
   void append_constant(const c10::IValue& constant);
   void set_register_size(size_t size);
+  std::shared_ptr<Code> get_code() const;
 
  private:
   c10::QualifiedName name_;
@@ -3,6 +3,7 @@
 #include <torch/csrc/jit/script/compilation_unit.h>
 #include <torch/csrc/jit/unpickler.h>
 #include <caffe2/serialize/inline_container.h>
+#include <caffe2/serialize/mmap_file_adapter.h>
 #include <torch/csrc/jit/instruction.h>
 
 
@@ -36,94 +37,126 @@ namespace torch {
 namespace jit {
 using caffe2::serialize::PyTorchStreamReader;
 using caffe2::serialize::IStreamAdapter;
+using caffe2::serialize::MmapFileAdapter;
 using caffe2::serialize::ReadAdapterInterface;
 
 OpCode parseOpCode(const char *str);
 namespace {
-void parseMethods(const std::vector<IValue>& vals, std::shared_ptr<mobile::CompilationUnit> mcu) {
-  for (const auto& element : vals) {
-    const auto& m_tuple = element.toTuple()->elements();
+std::unique_ptr<mobile::Function> parseMethod(const IValue& element) {
+  const auto& m_tuple = element.toTuple()->elements();
 
-    auto function = std::unique_ptr<mobile::Function>(new mobile::Function(
-        c10::QualifiedName(m_tuple[0].toString()->string())));
-    auto comps = m_tuple[1].toTuple()->elements();
-
-    // The sequence of the named tuple is 0: instructions, 1: operators,
-    // 2: constants, 3: register_size
-    auto named_ins = comps[0].toTuple()->elements();
-    auto ins_name = named_ins[0].toString()->string();
-    TORCH_CHECK(ins_name == "instructions",
-                "instruction is expected, but get", ins_name);
-    auto ins_list = named_ins[1].toTuple()->elements();
-
-    auto named_ops = comps[1].toTuple()->elements();
-    auto ops_name = named_ops[0].toString()->string();
-    TORCH_CHECK(ops_name == "operators",
-                "operator is expected, but get", ops_name);
-    auto ops_list = named_ops[1].toTuple()->elements();
-
-    for (const auto& ins : ins_list) {
-      auto ins_item = ins.toTuple()->elements();
-      TORCH_CHECK(ins_item.size() == 3,
-                  "There should be three parts in an instruction.");
-      OpCode op_code = parseOpCode(ins_item[0].toString()->string().c_str());
-      int X = ins_item[1].toInt();
-      int N = ins_item[2].toInt();
-      function->append_instruction(op_code, X, N);
-    }
+  auto function = std::unique_ptr<mobile::Function>(new mobile::Function(
+      c10::QualifiedName(m_tuple[0].toString()->string())));
+  auto comps = m_tuple[1].toTuple()->elements();
 
-    for (const auto& op : ops_list) {
-      auto op_item = op.toTuple()->elements();
-      TORCH_CHECK(op_item.size() == 2,
-                  "There should be two parts in an operator name.");
-      function->append_operator(op_item[0].toString()->string(),
-                           op_item[1].toString()->string());
-    }
+  // The sequence of the named tuple is 0: instructions, 1: operators,
+  // 2: constants, 3: register_size
+  auto named_ins = comps[0].toTuple()->elements();
+  auto ins_name = named_ins[0].toString()->string();
+  TORCH_CHECK(ins_name == "instructions",
+              "instruction is expected, but get", ins_name);
+  auto ins_list = named_ins[1].toTuple()->elements();
 
-    // vararg operators are stored in a separate table.
-    function->build_vararg_operator_table();
+  auto named_ops = comps[1].toTuple()->elements();
+  auto ops_name = named_ops[0].toString()->string();
+  TORCH_CHECK(ops_name == "operators",
+              "operator is expected, but get", ops_name);
+  auto ops_list = named_ops[1].toTuple()->elements();
 
-    auto named_consts = comps[2].toTuple()->elements();
-    auto consts_name = named_consts[0].toString()->string();
-    TORCH_CHECK(consts_name == "constants",
-                "constant is expected, but get", consts_name);
-    auto consts_list = named_consts[1].toTuple()->elements();
-    for (const auto& constant : consts_list) {
-      function->append_constant(constant);
-    }
+  for (const auto& ins : ins_list) {
+    auto ins_item = ins.toTuple()->elements();
+    TORCH_CHECK(ins_item.size() == 3,
+                "There should be three parts in an instruction.");
+    OpCode op_code = parseOpCode(ins_item[0].toString()->string().c_str());
+    int X = ins_item[1].toInt();
+    int N = ins_item[2].toInt();
+    function->append_instruction(op_code, X, N);
+  }
+
+  for (const auto& op : ops_list) {
+    auto op_item = op.toTuple()->elements();
+    TORCH_CHECK(op_item.size() == 2,
+                "There should be two parts in an operator name.");
+    function->append_operator(op_item[0].toString()->string(),
+                         op_item[1].toString()->string());
+  }
+
+  // vararg operators are stored in a separate table.
+  function->build_vararg_operator_table();
+
+  auto named_consts = comps[2].toTuple()->elements();
+  auto consts_name = named_consts[0].toString()->string();
+  TORCH_CHECK(consts_name == "constants",
+              "constant is expected, but get", consts_name);
+  auto consts_list = named_consts[1].toTuple()->elements();
+  for (const auto& constant : consts_list) {
+    function->append_constant(constant);
+  }
 
-    auto named_agg_size = comps[3].toTuple()->elements();
-    auto size_name = named_agg_size[0].toString()->string();
-    TORCH_CHECK(size_name == "register_size",
-                "register_size is expected, but get", ops_name);
-    function->set_register_size(named_agg_size[1].toInt());
+  auto named_agg_size = comps[3].toTuple()->elements();
+  auto size_name = named_agg_size[0].toString()->string();
+  TORCH_CHECK(size_name == "register_size",
+              "register_size is expected, but get", ops_name);
+  function->set_register_size(named_agg_size[1].toInt());
+
+  return function;
+}
+
+void parseMethods(const std::vector<IValue>& vals, std::shared_ptr<mobile::CompilationUnit> mcu) {
+  for (const auto& element : vals) {
+    mcu->register_function(parseMethod(element));
+  }
+}
 
-    mcu->register_function(std::move(function));
+// Defers parsing each method, including looking up its operators, until it
+// is first run.
+void registerLazyMethods(
+    const std::vector<IValue>& vals,
+    std::shared_ptr<mobile::CompilationUnit> mcu) {
+  for (const auto& element : vals) {
+    const auto& m_tuple = element.toTuple()->elements();
+    auto basename =
+        c10::QualifiedName(m_tuple[0].toString()->string()).name();
+    mcu->register_lazy_function(
+        std::move(basename), [element]() { return parseMethod(element); });
   }
 }
 
 // The deserializer class which loads the bytecode package from bc files.
 class BytecodeDeserializer final {
  public:
-  explicit BytecodeDeserializer(std::unique_ptr<PyTorchStreamReader> reader);
+  // mapped_file is the adapter of reader if it reads a memory-mapped file
+  explicit BytecodeDeserializer(
+      std::unique_ptr<PyTorchStreamReader> reader,
+      const MmapFileAdapter* mapped_file = nullptr);
   mobile::Module deserialize(c10::optional<at::Device> device);
 
  private:
   c10::IValue readArchive(const std::string& archive_name);
+  at::DataPtr readRecord(const std::string& name);
   std::shared_ptr<script::CompilationUnit> compilation_unit_;
   std::unordered_set<std::string> imported_libs_;
   std::unique_ptr<PyTorchStreamReader> reader_;
+  const MmapFileAdapter* mapped_file_;
   c10::optional<at::Device> device_;
 };
 
-BytecodeDeserializer::BytecodeDeserializer(std::unique_ptr<PyTorchStreamReader> reader)
-    : compilation_unit_(std::make_shared<script::CompilationUnit>()), reader_(std::move(reader)) {}
+BytecodeDeserializer::BytecodeDeserializer(
+    std::unique_ptr<PyTorchStreamReader> reader,
+    const MmapFileAdapter* mapped_file)
+    : compilation_unit_(std::make_shared<script::CompilationUnit>()),
+      reader_(std::move(reader)),
+      mapped_file_(mapped_file) {}
 
 mobile::Module BytecodeDeserializer::deserialize(c10::optional<at::Device> device) {
   device_ = device;
   auto bvals = readArchive("bytecode").toTuple()->elements();
   auto mcu = std::make_shared<mobile::CompilationUnit>();
-  parseMethods(bvals, mcu);
+  if (mapped_file_) {
+    registerLazyMethods(bvals, mcu);
+  } else {
+    parseMethods(bvals, mcu);
+  }
 
   return mobile::Module(readArchive("data").toObject(), mcu);
 }
@@ -131,9 +164,8 @@ mobile::Module BytecodeDeserializer::deserialize(c10::optional<at::Device> devic
 c10::IValue BytecodeDeserializer::readArchive(const std::string& archive_name) {
   std::stringstream picklename;
   picklename << archive_name << ".pkl";
-  at::DataPtr pickle_ptr;
-  size_t pickle_size;
-  std::tie(pickle_ptr, pickle_size) = reader_->getRecord(picklename.str());
+  at::DataPtr pickle_ptr = readRecord(picklename.str());
+  size_t pickle_size = reader_->getRecordSize(picklename.str());
 
   size_t bytes_read = 0;
   auto data = reinterpret_cast<const char*>(pickle_ptr.get());
@@ -173,7 +205,7 @@ c10::IValue BytecodeDeserializer::readArchive(const std::string& archive_name) {
   auto read_record = [&](const std::string& name) {
     std::stringstream ss;
     ss << archive_name << "/" << name;
-    return std::get<0>(reader_->getRecord(ss.str()));
+    return readRecord(ss.str());
   };
 
   Unpickler unpickler(reader, std::move(class_resolver),
@@ -181,6 +213,19 @@ c10::IValue BytecodeDeserializer::readArchive(const std::string& archive_name) {
   return unpickler.parse_ivalue();
 }
 
+// Records of a mapped file that are stored uncompressed and aligned alias the
+// mapping, all others are extracted by the reader.
+at::DataPtr BytecodeDeserializer::readRecord(const std::string& name) {
+  if (mapped_file_ && !reader_->isRecordCompressed(name)) {
+    const size_t offset = reader_->getRecordOffset(name);
+    if (offset % caffe2::serialize::kFieldAlignment == 0) {
+      return mapped_file_->alias(
+          offset, reader_->getRecordSize(name), "aliasing record");
+    }
+  }
+  return std::get<0>(reader_->getRecord(name));
+}
+
 } // namespace
 
 mobile::Module _load_for_mobile(
@@ -208,5 +253,15 @@ mobile::Module _load_for_mobile(
   return deserializer.deserialize(device);
 }
 
+mobile::Module _load_for_mobile_mmap(
+    const std::string& filename,
+    c10::optional<c10::Device> device) {
+  auto rai = torch::make_unique<MmapFileAdapter>(filename);
+  const MmapFileAdapter* mapped_file = rai.get();
+  auto reader = torch::make_unique<PyTorchStreamReader>(std::move(rai));
+  BytecodeDeserializer deserializer(std::move(reader), mapped_file);
+  return deserializer.deserialize(device);
+}
+
 } // namespace jit
 } // namespace torch
@@ -23,5 +23,14 @@ TORCH_API mobile::Module _load_for_mobile(
 TORCH_API mobile::Module _load_for_mobile(
     std::unique_ptr<ReadAdapterInterface> rai,
     c10::optional<c10::Device> device = c10::nullopt);
+
+// Loads the model by memory mapping filename. Weights stored uncompressed
+// and aligned, as _save_for_mobile writes them, alias the copy-on-write
+// mapping instead of being copied to the heap, and so does the bytecode
+// pickle. Each method is only parsed, and its operators looked up, when it
+// is first run, so errors about unknown operators surface then.
+TORCH_API mobile::Module _load_for_mobile_mmap(
+    const std::string& filename,
+    c10::optional<c10::Device> device = c10::nullopt);
 } // namespace jit
 } // namespace torch
@@ -1,17 +1,31 @@
 #include "interpreter.h"
 #include <torch/csrc/jit/mobile/function.h>
 #include <ATen/core/operator_name.h>
+#include <ATen/core/LegacyTypeDispatch.h>
+#include <torch/csrc/jit/mobile/observer.h>
 
 #if defined(PYTORCH_MOBILE_OPERATOR_OBSERVER)
 #include <torch/csrc/autograd/record_function.h>
-#include <torch/csrc/jit/mobile/observer.h>
 #endif
 
+#include <chrono>
+
 namespace torch{
 namespace jit{
 char const * toString(OpCode op);
 std::ostream& operator<<(std::ostream& out, Instruction inst);
 namespace mobile {
+void OperatorFunction::operator()(Stack& stack) const {
+  if (C10_UNLIKELY(kernel == nullptr)) {
+    c10::Dispatcher::singleton().callBoxed(handle, &stack);
+  } else if (exclude_variable) {
+    at::AutoNonVariableTypeMode non_var_type_mode(true);
+    kernel->callBoxed(handle, &stack);
+  } else {
+    kernel->callBoxed(handle, &stack);
+  }
+}
+
 InterpreterState::InterpreterState(std::shared_ptr<Code> code) : code_(code) {
   registers_.resize(code_->register_size_);
 }
@@ -25,6 +39,40 @@ void listConstruct(Stack& stack, int num_inputs) {
   drop(stack, num_inputs);
   push(stack, std::move(vals));
 }
+
+void runObservedOperator(
+    MobileOperatorObserver& observer,
+    const Code& code,
+    size_t pc,
+    size_t op,
+    Stack& stack) {
+  const auto& op_name = code.op_names_[op];
+  if (!observer.shouldObserve(op_name)) {
+    code.operators_[op](stack);
+    return;
+  }
+  MobileOperatorStats stats;
+  stats.op_name = &op_name;
+  stats.op_idx = pc;
+  const size_t num_inputs =
+      std::min(code.operator_input_sizes_[op], stack.size());
+  for (const auto& input : last(stack, num_inputs)) {
+    if (input.isTensor() && input.toTensor().defined()) {
+      stats.input_shapes.push_back(input.toTensor().sizes().vec());
+    } else {
+      stats.input_shapes.emplace_back();
+    }
+  }
+  const int64_t allocated_before = mobileThreadAllocatedBytes();
+  const auto start = std::chrono::steady_clock::now();
+  code.operators_[op](stack);
+  const auto end = std::chrono::steady_clock::now();
+  stats.latency_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+          .count();
+  stats.allocated_bytes = mobileThreadAllocatedBytes() - allocated_before;
+  observer.onOperator(stats);
+}
 }
 
 bool InterpreterState::run(Stack& stack) {
@@ -57,7 +105,12 @@ bool InterpreterState::run(Stack& stack) {
         RECORD_FUNCTION(code_->op_names_[inst.X].name, stack);
 #endif
 
-        c10::Dispatcher::singleton().callBoxed(*code_->operators_[inst.X], &stack);
+        auto* op_observer = observerConfig().getOperatorObserver();
+        if (C10_UNLIKELY(op_observer != nullptr)) {
+          runObservedOperator(*op_observer, *code_, pc, inst.X, stack);
+        } else {
+          code_->operators_[inst.X](stack);
+        }
         ++pc;
       } break;
       case OPN: {
@@ -3,19 +3,40 @@
 #include <ATen/core/operator_name.h>
 #include <torch/csrc/jit/instruction.h>
 #include <ATen/core/dispatch/Dispatcher.h>
+#include <c10/core/CPUAllocationPlan.h>
 
 namespace torch{
 namespace jit{
 namespace mobile {
 using Stack = std::vector<c10::IValue>;
 using VarargFuncton = std::function<void(int, Stack&)>;
+// An operator of a Code, resolved when the function is loaded. The lite
+// interpreter only runs on CPU, so it calls the kernel the dispatcher would
+// resolve for CPU tensors without going through the dispatcher.
+struct OperatorFunction {
+  c10::OperatorHandle handle;
+  // nullptr if the operator has no CPU kernel, then it is dispatched as usual.
+  const c10::KernelFunction* kernel;
+  // Whether the dispatcher reaches the kernel through the VariableTensorId
+  // fallback, which calls it with Variable dispatch excluded.
+  bool exclude_variable;
+
+  void operator()(Stack& stack) const;
+};
+
 struct Code {
   std::vector<Instruction> instructions_;
   std::vector<c10::OperatorName> op_names_;
-  std::vector<c10::optional<c10::OperatorHandle>> operators_;
+  // Operators are looked up when the function is loaded, so that running OP
+  // only has to call them.
+  std::vector<OperatorFunction> operators_;
+  // number of inputs of each operator, for observers
+  std::vector<size_t> operator_input_sizes_;
   std::vector<VarargFuncton> vararg_operators_;
   std::vector<c10::IValue> constants_;
   size_t register_size_; // Aggregated output size.
+  // Runs reuse the memory of their intermediate CPU tensors through this.
+  c10::CPUAllocationPlan allocation_plan_;
 };
 
 struct InterpreterState {
@@ -19,9 +19,35 @@ const std::string& Function::name() const {
 }
 
 void CompilationUnit::register_function(std::unique_ptr<Function> fn) {
+  std::lock_guard<std::mutex> guard(mutex_);
   methods_.emplace_back(std::move(fn));
 }
 
+void CompilationUnit::register_lazy_function(
+    std::string basename,
+    std::function<std::unique_ptr<Function>()> parse) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  lazy_methods_.emplace_back(std::move(basename), std::move(parse));
+}
+
+Function* CompilationUnit::find_function(const std::string& basename) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto& fn : methods_) {
+    if (fn->name() == basename) {
+      return fn.get();
+    }
+  }
+  for (auto it = lazy_methods_.begin(); it != lazy_methods_.end(); ++it) {
+    if (it->first == basename) {
+      auto fn = it->second();
+      lazy_methods_.erase(it);
+      methods_.emplace_back(std::move(fn));
+      return methods_.back().get();
+    }
+  }
+  return nullptr;
+}
+
 c10::IValue Module::run_method(const std::string& method_name, Stack stack) {
 #if defined(PYTORCH_MOBILE_OBSERVER)
   auto observer = torch::observerConfig().getModuleObserver();
@@ -44,12 +70,7 @@ c10::IValue Module::run_method(const std::string& method_name, Stack stack) {
 }
 
 Function* Module::find_method(const std::string& basename) const {
-  for (auto& fn : cu_->methods()) {
-    if (fn->name() == basename) {
-      return fn.get();
-    }
-  }
-  return nullptr;
+  return cu_->find_function(basename);
 }
 
 } // namespace mobile
@@ -2,6 +2,9 @@
 //#include <ATen/core/function_schema.h>
 #include <torch/csrc/jit/mobile/function.h>
 
+#include <functional>
+#include <mutex>
+
 namespace torch{
 namespace jit{
 namespace mobile {
@@ -11,9 +14,18 @@ using Stack = std::vector<c10::IValue>;
 class CompilationUnit {
  public:
   void register_function(std::unique_ptr<Function> fn);
+  // Registers the method called basename, which is only built by parse when
+  // it is first looked up
+  void register_lazy_function(
+      std::string basename,
+      std::function<std::unique_ptr<Function>()> parse);
   std::vector<std::unique_ptr<Function>>& methods() {return methods_;}
+  Function* find_function(const std::string& basename);
  private:
   std::vector<std::unique_ptr<Function>> methods_;
+  std::vector<std::pair<std::string, std::function<std::unique_ptr<Function>()>>>
+      lazy_methods_;
+  std::mutex mutex_;
 };
 
 class TORCH_API Module {
@@ -1,10 +1,39 @@
 #include <torch/csrc/jit/mobile/observer.h>
 
+#include <c10/core/Allocator.h>
+
 namespace torch {
 
+namespace {
+
+thread_local int64_t thread_allocated_bytes = 0;
+
+struct AllocatedBytesReporter final : public c10::MemoryReporter {
+  void reportMemoryUsage(void* ptr, int64_t alloc_size, c10::Device device)
+      override {
+    if (alloc_size > 0 && device.is_cpu()) {
+      thread_allocated_bytes += alloc_size;
+    }
+  }
+};
+
+AllocatedBytesReporter allocated_bytes_reporter;
+
+} // namespace
+
 MobileObserverConfig& observerConfig() {
   static MobileObserverConfig instance;
   return instance;
 }
 
+void MobileObserverConfig::setOperatorObserver(
+    std::unique_ptr<MobileOperatorObserver> observer) {
+  c10::SetMemoryReporter(observer ? &allocated_bytes_reporter : nullptr);
+  operator_observer_ = std::move(observer);
+}
+
+int64_t mobileThreadAllocatedBytes() {
+  return thread_allocated_bytes;
+}
+
 } // namespace torch
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 #include <ATen/ThreadLocalDebugInfo.h>
+#include <ATen/core/operator_name.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
 
 namespace torch {
 
@@ -48,6 +53,30 @@ class MobileModuleObserver {
     virtual void onExit() {}
 };
 
+// What the lite interpreter measured about one run of an operator
+struct MobileOperatorStats {
+  const c10::OperatorName* op_name;
+  // index of the OP instruction in the method's bytecode
+  size_t op_idx;
+  // sizes of the inputs; empty for inputs that are not tensors
+  std::vector<std::vector<int64_t>> input_shapes;
+  int64_t latency_us;
+  // bytes the operator allocated on CPU, including ones it already freed
+  int64_t allocated_bytes;
+};
+
+class MobileOperatorObserver {
+ public:
+  virtual ~MobileOperatorObserver() = default;
+
+  // Called before each operator runs. Only operators it returns true for
+  // are measured and reported, so observers can sample to keep the cost low.
+  virtual bool shouldObserve(const c10::OperatorName& op_name) {
+    return true;
+  }
+  virtual void onOperator(const MobileOperatorStats& stats) {}
+};
+
 class MobileObserverConfig {
   public:
   void setModuleObserver(std::unique_ptr<MobileModuleObserver> reporter) {
@@ -57,10 +86,25 @@ class MobileObserverConfig {
     return module_observer_.get();
   }
 
+  // Reporting allocated bytes makes the CPU allocators account for every
+  // allocation while an operator observer is set, and replaces the memory
+  // reporter of the autograd profiler. Must not be called while the lite
+  // interpreter is running.
+  TORCH_API void setOperatorObserver(
+      std::unique_ptr<MobileOperatorObserver> observer);
+  MobileOperatorObserver* getOperatorObserver() {
+    return operator_observer_.get();
+  }
+
 private:
   std::unique_ptr<MobileModuleObserver> module_observer_;
+  std::unique_ptr<MobileOperatorObserver> operator_observer_;
 };
 
-MobileObserverConfig& observerConfig();
+TORCH_API MobileObserverConfig& observerConfig();
+
+// Bytes allocated on CPU by the calling thread since an operator observer
+// was set
+TORCH_API int64_t mobileThreadAllocatedBytes();
 
 } // namespace torch
@@ -332,6 +332,7 @@ void AliasDb::analyzeImpl(Node* node) {
     case prim::FusedConcat:
     case prim::MMTreeReduce:
     case prim::MMBatchSide:
+    case prim::MMBatchIndependent:
     case prim::BroadcastSizes:
     case prim::ChunkSizes:
     case prim::Function:
@@ -892,6 +893,36 @@ void AliasDb::giveFreshAlias(const Value* value) {
   addContainedTypesToFreshElement(new_elem, *maybe_mut_type);
 }
 
+void AliasDb::createValue(const Value* value) {
+  // The value may live at the address of one that was erased without us being
+  // told, so don't keep whatever element was recorded for it.
+  elementMap_.erase(value);
+  giveFreshAlias(value);
+}
+
+void AliasDb::removeValue(const Value* value) {
+  // The element stays in the memory DAG, so values that pointed to it through
+  // `value` keep their memory locations.
+  elementMap_.erase(value);
+}
+
+void AliasDb::removeNode(Node* n) {
+  if (writeIndex_.erase(n)) {
+    isWriteCacheStale_ = true;
+  }
+  for (const auto output : n->outputs()) {
+    removeValue(output);
+  }
+  for (const auto block : n->blocks()) {
+    for (const auto input : block->inputs()) {
+      removeValue(input);
+    }
+    for (const auto node : block->nodes()) {
+      removeNode(node);
+    }
+  }
+}
+
 Element* AliasDb::getOrCreateElement(const Value* value) {
   if (!elementMap_.count(value)) {
     giveFreshAlias(value);
@@ -1251,6 +1282,7 @@ bool aliasAnalysisHasSpecialCaseFor(Symbol symbol) {
       prim::GradOf,
       prim::MMTreeReduce,
       prim::MMBatchSide,
+      prim::MMBatchIndependent,
       prim::BroadcastSizes,
       prim::ChunkSizes,
       prim::Function,
@@ -1375,6 +1407,8 @@ c10::optional<Element*> AliasDb::setWildcard(const Value* v) {
 }
 
 void AliasDb::rebuildWriteCache() const {
+  // removeNode may have dropped writes, so start over
+  writeCache_.clear();
   for (const auto& pr : writeIndex_) {
     const auto& writtenLocs = pr.second;
       writeCache_ |= writtenLocs;
@@ -105,6 +105,20 @@ class AliasDb {
   bool couldMoveAfterTopologically(Node* n, Node* movePoint);
   bool couldMoveBeforeTopologically(Node* n, Node* movePoint);
 
+  // Incremental updates, so that a pass that inserts and deletes nodes can
+  // hand its AliasDb on to the next pass instead of having it rebuilt.
+  //
+  // Register `value`, a value that was added to the graph after the analysis
+  // and doesn't alias anything (e.g. the output of a new prim::Constant).
+  TORCH_API void createValue(const Value* value);
+
+  // Forget `value`, which is about to be erased from the graph.
+  TORCH_API void removeValue(const Value* value);
+
+  // Forget `n`, its outputs and the contents of its blocks, which are about to
+  // be destroyed. The writes `n` made no longer count.
+  TORCH_API void removeNode(Node* n);
+
   // For debugging: print alias db state to stdout
   TORCH_API void dump() const;
   TORCH_API std::string toString() const;
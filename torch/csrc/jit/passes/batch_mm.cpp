@@ -58,6 +58,12 @@ c10::OperatorOptions aliasAnalysisIsSpecialCase() {
 // |      |      | |      |
 // +------+------+ +------+
 
+// Finally, the pass batches independent mm (and addmm) nodes that share no
+// operand at all, as found in multi-head and multi-tower models, where each
+// head multiplies its input with its own weights. If the products have equal
+// shapes and are small enough, they are stacked and computed by a single bmm
+// (or baddbmm) instead. See BatchMMIndependent.
+
 // Note [Further optimizations]
 // It would be straightforward to extend the TreeToken class to also detect if
 // all MMs had the same lhs/rhs. In such case it's more efficient to expand the
@@ -368,31 +374,47 @@ RegisterOperators mm_batch_side_reg({Operator(
     },
     aliasAnalysisIsSpecialCase())});
 
+// Sorts mms topologically and removes the ones that could not be moved next to
+// an earlier one, so that the rest can all be computed at once.
+std::vector<Node*> filterDependentMMs(std::vector<Node*> mms, AliasDb& alias_db) {
+  if (mms.size() == 0) {
+    return mms;
+  }
+  std::sort(mms.begin(), mms.end(), [](Node* n, Node* m) {
+    return n->isBefore(m);
+  });
+  // Filter out dependent MMs. This algorithm might do very badly if e.g. you
+  // have a lot of independent MMs, that depend on the first one, but I doubt
+  // this will be a common scenario.
+  for (size_t i = 0; i < mms.size(); ++i) {
+    if (mms[i] == nullptr)
+      continue;
+    for (size_t j = i + 1; j < mms.size(); ++j) {
+      if (mms[j] == nullptr)
+        continue;
+      if (!alias_db.couldMoveBeforeTopologically(mms[j], mms[i])) {
+        mms[j] = nullptr;
+      }
+    }
+  }
+  return c10::filter(mms, [](Node* n) { return n != nullptr; });
+}
+
+// Moves the nodes, which filterDependentMMs returned, right before the last
+// of them.
+void moveNextToEachOther(std::vector<Node*>& mms, AliasDb& alias_db) {
+  AT_ASSERT(!mms.empty());
+  for (int64_t i = static_cast<int64_t>(mms.size()) - 2; i >= 0; --i) {
+    bool move_ok = alias_db.moveBeforeTopologicallyValid(mms[i], mms[i + 1]);
+    AT_ASSERT(move_ok);
+  }
+}
+
 std::pair<std::vector<Node*>, std::vector<Node*>> gatherIndependentMMUses(
     Value* value,
     AliasDb& alias_db) {
   const auto postprocess = [&](std::vector<Node*> mms) {
-    if (mms.size() == 0) {
-      return mms;
-    }
-    std::sort(mms.begin(), mms.end(), [](Node* n, Node* m) {
-      return n->isBefore(m);
-    });
-    // Filter out dependent MMs. This algorithm might do very badly if e.g. you
-    // have a lot of independent MMs, that depend on the first one, but I doubt
-    // this will be a common scenario.
-    for (size_t i = 0; i < mms.size(); ++i) {
-      if (mms[i] == nullptr)
-        continue;
-      for (size_t j = i + 1; j < mms.size(); ++j) {
-        if (mms[j] == nullptr)
-          continue;
-        if (!alias_db.couldMoveBeforeTopologically(mms[j], mms[i])) {
-          mms[j] = nullptr;
-        }
-      }
-    }
-    return c10::filter(mms, [](Node* n) { return n != nullptr; });
+    return filterDependentMMs(std::move(mms), alias_db);
   };
 
   Block* block = value->node()->owningBlock();
@@ -415,11 +437,7 @@ void BatchMMSide(Block* block, AliasDb& alias_db) {
   // NB: 8 is the current loop unrolling factor
   static constexpr size_t how_many_is_many = 8;
   const auto batch_side = [&](std::vector<Node*>& mms, Side side) {
-    AT_ASSERT(!mms.empty());
-    for (int64_t i = static_cast<int64_t>(mms.size()) - 2; i >= 0; --i) {
-      bool move_ok = alias_db.moveBeforeTopologicallyValid(mms[i], mms[i + 1]);
-      AT_ASSERT(move_ok);
-    }
+    moveNextToEachOther(mms, alias_db);
     WithInsertPoint insert_guard{mms[0]};
     Graph* graph = mms[0]->owningGraph();
     Node* batch_mm = graph->create(
@@ -459,6 +477,164 @@ void BatchMMSide(Block* block, AliasDb& alias_db) {
   }
 }
 
+bool have_same_options(at::TensorList inputs) {
+  const auto& expected = inputs[0];
+  return std::all_of(
+      inputs.begin(), inputs.end(), [&expected](const at::Tensor& t) {
+        return t.scalar_type() == expected.scalar_type() &&
+            t.device() == expected.device();
+      });
+}
+
+bool shape_is_fast_for_batch(const at::Tensor& lhs, const at::Tensor& rhs) {
+  // Stacking copies both operands of every product, which only pays off when
+  // the products are small enough for the overhead of each mm call to
+  // dominate. The cutoff is a conservative one.
+  return lhs.dim() == 2 && rhs.dim() == 2 &&
+      lhs.size(0) * lhs.size(1) * rhs.size(1) <= 64 * 64 * 64;
+}
+
+RegisterOperators mm_batch_independent_reg({Operator(
+    prim::MMBatchIndependent,
+    [](const Node* node) -> Operation {
+      size_t num_mms = node->outputs().size();
+      bool has_bias = node->i(Symbol::attr("has_bias"));
+      size_t num_inputs = num_mms * (has_bias ? 3 : 2);
+      return [num_mms, has_bias, num_inputs](Stack& stack) {
+        std::vector<at::Tensor> inputs;
+        inputs.reserve(num_inputs);
+        for (auto it = stack.end() - num_inputs; it != stack.end(); ++it) {
+          inputs.push_back(std::move(*it).toTensor());
+        }
+        drop(stack, num_inputs);
+
+        auto lhs_inputs = at::TensorList(inputs).slice(0, num_mms);
+        auto rhs_inputs = at::TensorList(inputs).slice(num_mms, num_mms);
+        auto bias_inputs = has_bias ? at::TensorList(inputs).slice(2 * num_mms)
+                                    : at::TensorList();
+        if (have_same_shape(lhs_inputs) && have_same_shape(rhs_inputs) &&
+            have_same_options(inputs) &&
+            shape_is_fast_for_batch(lhs_inputs[0], rhs_inputs[0]) &&
+            (!has_bias ||
+             (have_same_shape(bias_inputs) && bias_inputs[0].dim() <= 2))) {
+          auto lhs = at::stack(lhs_inputs);
+          auto rhs = at::stack(rhs_inputs);
+          at::Tensor out;
+          if (has_bias) {
+            // addmm broadcasts its bias to the size of the product
+            auto bias_sizes = bias_inputs[0].sizes();
+            auto bias = at::stack(bias_inputs)
+                            .view({static_cast<int64_t>(num_mms),
+                                   bias_sizes.size() == 2 ? bias_sizes[0] : 1,
+                                   bias_sizes.empty() ? 1 : bias_sizes.back()})
+                            .expand({static_cast<int64_t>(num_mms),
+                                     lhs.size(1),
+                                     rhs.size(2)});
+            out = at::baddbmm(bias, lhs, rhs);
+          } else {
+            out = at::bmm(lhs, rhs);
+          }
+          auto outputs = at::unbind(out, 0);
+          stack.insert(
+              stack.end(),
+              std::make_move_iterator(outputs.begin()),
+              std::make_move_iterator(outputs.end()));
+        } else {
+          for (size_t i = 0; i < num_mms; ++i) {
+            stack.emplace_back(
+                has_bias ? at::addmm(bias_inputs[i], lhs_inputs[i], rhs_inputs[i])
+                         : at::mm(lhs_inputs[i], rhs_inputs[i]));
+          }
+        }
+        return 0;
+      };
+    },
+    aliasAnalysisIsSpecialCase())});
+
+// Returns whether node is an mm, or an addmm with beta and alpha equal to 1
+// (which DecomposeOps has not decomposed), that BatchMMIndependent can batch.
+bool isBatchableMM(Node* node, bool& has_bias) {
+  if (node->matches("aten::mm(Tensor self, Tensor mat2) -> Tensor")) {
+    has_bias = false;
+    return true;
+  }
+  if (node->matches(
+          "aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta, Scalar alpha) -> Tensor",
+          /*const_inputs=*/{attr::beta, attr::alpha}) &&
+      node->get<at::Scalar>(attr::alpha)->toDouble() == 1.0 &&
+      node->get<at::Scalar>(attr::beta)->toDouble() == 1.0) {
+    has_bias = true;
+    return true;
+  }
+  return false;
+}
+
+void BatchMMIndependent(Block* block, AliasDb& alias_db) {
+  static constexpr size_t min_batch_size = 4;
+  // Candidates are grouped by the types of their operands, so that ones known
+  // to have different shapes are not batched.
+  std::unordered_map<std::string, std::vector<Node*>> groups;
+  std::vector<std::string> group_keys;
+  for (Node* node : block->nodes()) {
+    bool has_bias = false;
+    if (isBatchableMM(node, has_bias)) {
+      // the mms batched by BatchMMSide have no uses left
+      if (node->output()->uses().empty()) {
+        continue;
+      }
+      std::string key = has_bias ? "addmm" : "mm";
+      for (Value* input : node->inputs()) {
+        if (input->type()->isSubtypeOf(TensorType::get())) {
+          key += " " + input->type()->str();
+        }
+      }
+      auto& group = groups[key];
+      if (group.empty()) {
+        group_keys.push_back(key);
+      }
+      group.push_back(node);
+    } else {
+      for (Block* subblock : node->blocks()) {
+        BatchMMIndependent(subblock, alias_db);
+      }
+    }
+  }
+
+  for (const auto& key : group_keys) {
+    auto mms = filterDependentMMs(std::move(groups[key]), alias_db);
+    if (mms.size() < min_batch_size) {
+      continue;
+    }
+    bool has_bias = false;
+    isBatchableMM(mms[0], has_bias);
+    const size_t lhs_offset = has_bias ? 1 : 0;
+    moveNextToEachOther(mms, alias_db);
+    WithInsertPoint insert_guard{mms[0]};
+    Graph* graph = mms[0]->owningGraph();
+    Node* batch_mm = graph->create(
+        prim::MMBatchIndependent,
+        /*inputs=*/{},
+        /*num_outputs=*/mms.size());
+    graph->insertNode(batch_mm);
+    batch_mm->i_(Symbol::attr("has_bias"), has_bias);
+    for (Node* mm : mms) {
+      batch_mm->addInput(mm->inputs().at(lhs_offset));
+    }
+    for (Node* mm : mms) {
+      batch_mm->addInput(mm->inputs().at(lhs_offset + 1));
+    }
+    if (has_bias) {
+      for (Node* mm : mms) {
+        batch_mm->addInput(mm->inputs().at(0));
+      }
+    }
+    for (size_t i = 0; i < mms.size(); ++i) {
+      batch_mm->outputs().at(i)->setType(mms[i]->output()->type());
+      mms[i]->output()->replaceAllUsesWith(batch_mm->outputs().at(i));
+    }
+  }
+}
+
 bool hasMutableOperators(Block* block) {
   for (auto n : block->nodes()) {
     if (n->kind().is_aten() && n->schema().is_mutable())
@@ -479,6 +655,7 @@ void BatchMM(std::shared_ptr<Graph>& graph) {
   AliasDb alias_db(graph);
   BatchMMTreeReduce(graph->block());
   BatchMMSide(graph->block(), alias_db);
+  BatchMMIndependent(graph->block(), alias_db);
   EliminateDeadCode(graph);
   // It's possible that transpose rearrangements have created sequences of
   // consecutive transposes that didn't exist before.
@@ -5,7 +5,16 @@
 namespace torch {
 namespace jit {
 
+class AliasDb;
+
 TORCH_API void EliminateCommonSubexpression(
     const std::shared_ptr<Graph>& graph);
+
+// Same as above, but uses `aliasDb`, which must be up to date for `graph`,
+// instead of building a new one. Replacing values changes what aliases what,
+// so `aliasDb` is out of date for `graph` afterwards.
+TORCH_API void EliminateCommonSubexpression(
+    const std::shared_ptr<Graph>& graph,
+    const AliasDb& aliasDb);
 }
 } // namespace torch
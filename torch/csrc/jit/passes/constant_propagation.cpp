@@ -10,7 +10,6 @@
 #include <torch/csrc/jit/operator.h>
 #include <torch/csrc/jit/passes/alias_analysis.h>
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
-#include <torch/csrc/utils/memory.h>
 
 namespace torch {
 namespace jit {
@@ -50,15 +49,18 @@ std::unordered_set<Symbol> skip_list = {
 
 struct ConstantPropagator {
   // Runs constant propagation with an aliasing db and checks if inputs or
-  // outputs might be mutated in the graph
-  static ConstantPropagator WithAliasDb(std::shared_ptr<Graph> graph) {
-    return ConstantPropagator(graph, true);
+  // outputs might be mutated in the graph. The db is updated as nodes are
+  // folded and removed.
+  static ConstantPropagator WithAliasDb(
+      std::shared_ptr<Graph> graph,
+      AliasDb& aliasDb) {
+    return ConstantPropagator(std::move(graph), &aliasDb);
   }
 
   // Runs constant propagation only on ops that clearly do not have aliased
   // inputs or outputs without computing aliasing information
   static ConstantPropagator NoAliasDb(std::shared_ptr<Graph> graph) {
-    return ConstantPropagator(graph, false);
+    return ConstantPropagator(std::move(graph), nullptr);
   }
 
   void run() {
@@ -66,14 +68,8 @@ struct ConstantPropagator {
   }
 
  private:
-  ConstantPropagator(std::shared_ptr<Graph> graph, bool aliasing_types)
-      : graph_(std::move(graph)) {
-    if (aliasing_types) {
-      aliasDb_ = torch::make_unique<AliasDb>(graph_);
-    } else {
-      aliasDb_ = nullptr;
-    }
-  }
+  ConstantPropagator(std::shared_ptr<Graph> graph, AliasDb* aliasDb)
+      : graph_(std::move(graph)), aliasDb_(aliasDb) {}
 
   std::vector<IValue> runNode(Node* n) {
     auto op = getOperation(n);
@@ -123,6 +119,9 @@ struct ConstantPropagator {
         if (outputs[i].isNone()) {
           (*new_output)->setType(n->outputs()[i]->type());
         }
+        if (aliasDb_) {
+          aliasDb_->createValue(*new_output);
+        }
         n->outputs()[i]->replaceAllUsesWith(*new_output);
       }
       // If we cannot insert the IValue as a constant, give up replacing the
@@ -136,6 +135,9 @@ struct ConstantPropagator {
       n->outputs().at(i)->replaceAllUsesWith(
           n->inputs().at(i + loop_input_offset));
     }
+    if (aliasDb_) {
+      aliasDb_->removeNode(n);
+    }
     n->destroy();
   }
 
@@ -173,6 +175,9 @@ struct ConstantPropagator {
     }
     // NB: destroy the node here, because it might contain side effects, like
     // print
+    if (aliasDb_) {
+      aliasDb_->removeNode(n);
+    }
     n->destroy();
   }
 
@@ -191,6 +196,9 @@ struct ConstantPropagator {
 
   void replaceAndRemoveIfOutput(Node* n, size_t i, Value* replacement) {
     n->outputs().at(i)->replaceAllUsesWith(replacement);
+    if (aliasDb_) {
+      aliasDb_->removeValue(n->outputs().at(i));
+    }
     n->eraseOutput(i);
     n->blocks().at(0)->eraseOutput(i);
     n->blocks().at(1)->eraseOutput(i);
@@ -219,6 +227,9 @@ struct ConstantPropagator {
       auto eq = EqualNode();
       if (maybe_const && eq(t_out->node(), f_out->node())) {
         auto new_const = graph->insertConstant(*maybe_const);
+        if (aliasDb_) {
+          aliasDb_->createValue(new_const);
+        }
         replaceAndRemoveIfOutput(n, i, new_const);
         continue;
       }
@@ -245,6 +256,10 @@ struct ConstantPropagator {
         loop_body->inputs()
             .at(loop_body_offset + i)
             ->replaceAllUsesWith(node_input);
+        if (aliasDb_) {
+          aliasDb_->removeValue(node->outputs().at(i));
+          aliasDb_->removeValue(loop_body->inputs().at(loop_body_offset + i));
+        }
         node->eraseOutput(i);
         node->removeInput(loop_input_offset + i);
         loop_body->eraseInput(loop_body_offset + i);
@@ -326,14 +341,19 @@ struct ConstantPropagator {
   }
 
   std::shared_ptr<Graph> graph_;
-  std::unique_ptr<AliasDb> aliasDb_;
+  AliasDb* aliasDb_;
 };
 } // anonymous namespace
 
 void ConstantPropagation(std::shared_ptr<Graph>& graph) {
-  ConstantPropagator cp = ConstantPropagator::WithAliasDb(graph);
+  AliasDb aliasDb(graph);
+  ConstantPropagation(graph, aliasDb);
+}
+
+void ConstantPropagation(std::shared_ptr<Graph>& graph, AliasDb& aliasDb) {
+  ConstantPropagator cp = ConstantPropagator::WithAliasDb(graph, aliasDb);
   cp.run();
-  EliminateDeadCode(graph);
+  EliminateDeadCode(graph, aliasDb);
   GRAPH_DUMP("After ConstantPropagation: ", graph);
 }
 
@@ -5,8 +5,16 @@
 namespace torch {
 namespace jit {
 
+class AliasDb;
+
 TORCH_API void ConstantPropagation(std::shared_ptr<Graph>& graph);
 
+// Same as above, but uses `aliasDb`, which must be up to date for `graph`,
+// instead of building a new one, and keeps it up to date for the next pass.
+TORCH_API void ConstantPropagation(
+    std::shared_ptr<Graph>& graph,
+    AliasDb& aliasDb);
+
 // runs constant propagation only on ops that have non-aliasing inputs & outputs
 TORCH_API void ConstantPropagationImmutableTypes(std::shared_ptr<Graph>& graph);
 
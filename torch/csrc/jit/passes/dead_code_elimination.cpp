@@ -17,7 +17,9 @@ using namespace ::c10::prim;
 class DeadCodeEliminator {
  public:
   explicit DeadCodeEliminator(std::shared_ptr<Graph> graph, DCESideEffectPolicy sideEffectPolicy)
-      : sideEffectPolicy_(sideEffectPolicy), aliasDb_(torch::make_unique<AliasDb>(std::move(graph))) {}
+      : sideEffectPolicy_(sideEffectPolicy), ownedAliasDb_(torch::make_unique<AliasDb>(std::move(graph))), aliasDb_(ownedAliasDb_.get()) {}
+  DeadCodeEliminator(AliasDb& aliasDb, DCESideEffectPolicy sideEffectPolicy)
+      : sideEffectPolicy_(sideEffectPolicy), aliasDb_(&aliasDb) {}
   DeadCodeEliminator(DCESideEffectPolicy sideEffectPolicy)
   : sideEffectPolicy_(sideEffectPolicy) {}
 
@@ -280,6 +282,9 @@ class DeadCodeEliminator {
             (node->outputs().size() > 0 ? node->outputs().at(0)->debugName()
                                         : "n/a"),
             " will be removed");
+        if (aliasDb_) {
+          aliasDb_->removeNode(node);
+        }
         it.destroyCurrent();
       }
     }
@@ -337,6 +342,9 @@ class DeadCodeEliminator {
             " of node ",
             node->kind().toQualString(),
             " will be removed");
+        if (aliasDb_) {
+          aliasDb_->removeValue(node->outputs().at(i));
+        }
         node->eraseOutput(i);
         for (Block* b : node->blocks()) {
           GRAPH_UPDATE(
@@ -362,6 +370,10 @@ class DeadCodeEliminator {
       if (!node->outputs().at(i)->hasUses() &&
           !loop_body->inputs().at(loop_body_offset + i)->hasUses()) {
         logDeadLoopOutputs(node, i, loop_input_offset, loop_body_offset);
+        if (aliasDb_) {
+          aliasDb_->removeValue(node->outputs().at(i));
+          aliasDb_->removeValue(loop_body->inputs().at(loop_body_offset + i));
+        }
         node->eraseOutput(i);
         node->removeInput(loop_input_offset + i);
         loop_body->eraseInput(loop_body_offset + i);
@@ -403,7 +415,8 @@ class DeadCodeEliminator {
   }
 
   DCESideEffectPolicy sideEffectPolicy_;
-  std::unique_ptr<AliasDb> aliasDb_ = nullptr;
+  std::unique_ptr<AliasDb> ownedAliasDb_ = nullptr;
+  AliasDb* aliasDb_ = nullptr;
   std::unordered_map<Node*, bool> memo_;
   std::unordered_set<Node*> marked_;
   std::unordered_set<const Value*> liveValues_;
@@ -416,6 +429,15 @@ void EliminateDeadCode(const std::shared_ptr<Graph>& graph, DCESideEffectPolicy
   GRAPH_DUMP("After EliminateDeadCode: ", graph);
 }
 
+void EliminateDeadCode(
+    const std::shared_ptr<Graph>& graph,
+    AliasDb& aliasDb,
+    DCESideEffectPolicy sideEffectPolicy) {
+  DeadCodeEliminator(aliasDb, sideEffectPolicy)
+      .run(graph->block(), /*recurse=*/true);
+  GRAPH_DUMP("After EliminateDeadCode: ", graph);
+}
+
 void EliminateDeadCode(Block* block, bool recurse, DCESideEffectPolicy sideEffectPolicy) {
   DeadCodeEliminator(sideEffectPolicy).run(block, recurse);
 }
@@ -5,6 +5,8 @@
 namespace torch {
 namespace jit {
 
+class AliasDb;
+
 // If given a top-level graph, DCE will construct do alias analysis that allows
 // for "smarter" dead code elimination (we will eliminate mutable ops if we can
 // prove the mutated values are not used). Otherwise, we will not allow DCE to
@@ -22,6 +24,9 @@ enum class DCESideEffectPolicy : uint8_t {
 };
 
 TORCH_API void EliminateDeadCode(const std::shared_ptr<Graph>& graph, DCESideEffectPolicy sideEffectPolicy = DCESideEffectPolicy::DONT_DELETE_NODES_WITH_SIDE_EFFECTS);
+// Same as above, but uses `aliasDb`, which must be up to date for `graph`,
+// instead of building a new one, and keeps it up to date for the next pass.
+TORCH_API void EliminateDeadCode(const std::shared_ptr<Graph>& graph, AliasDb& aliasDb, DCESideEffectPolicy sideEffectPolicy = DCESideEffectPolicy::DONT_DELETE_NODES_WITH_SIDE_EFFECTS);
 TORCH_API void EliminateDeadCode(Block* block, bool recurse = true, DCESideEffectPolicy sideEffectPolicy = DCESideEffectPolicy::DONT_DELETE_NODES_WITH_SIDE_EFFECTS);
 
 // Invoke the user-provided callback on all live values before deleting anything
@@ -0,0 +1,316 @@
+#include <torch/csrc/jit/passes/fork_independent_branches.h>
+
+#include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+#include <torch/csrc/utils/memory.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Branches with fewer nodes than this are only forked if they contain one of
+// the ops of isExpensive(), launching a task costing about as much as running
+// a handful of small ops.
+constexpr size_t kMinBranchSize = 16;
+
+bool isExpensive(const Node* n) {
+  switch (n->kind()) {
+    case aten::mm:
+    case aten::addmm:
+    case aten::matmul:
+    case aten::bmm:
+    case aten::baddbmm:
+    case aten::linear:
+    case aten::conv1d:
+    case aten::conv2d:
+    case aten::conv3d:
+    case aten::conv_transpose1d:
+    case aten::_convolution:
+    case aten::lstm:
+    case aten::gru:
+    case aten::rnn_tanh:
+    case aten::rnn_relu:
+    case aten::embedding_bag:
+      return true;
+    case prim::DifferentiableGraph: {
+      for (const Node* inner : n->g(attr::Subgraph)->nodes()) {
+        if (isExpensive(inner)) {
+          return true;
+        }
+      }
+      return false;
+    }
+    default:
+      return false;
+  }
+}
+
+bool containsBailOut(Node* n) {
+  if (n->kind() == prim::BailOut || n->kind() == prim::BailoutTemplate) {
+    return true;
+  }
+  for (Block* b : n->blocks()) {
+    for (Node* inner : b->nodes()) {
+      if (containsBailOut(inner)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+struct ForkIndependentBranchesImpl {
+  ForkIndependentBranchesImpl(std::shared_ptr<Graph> graph)
+      : graph_(std::move(graph)) {}
+
+  void run() {
+    while (forkOneJoin()) {
+    }
+  }
+
+ private:
+  bool isMovable(Node* n) const {
+    if (n->owningBlock() != graph_->block()) {
+      return false;
+    }
+    const auto kind = n->kind();
+    if (!kind.is_aten() && kind != prim::FusionGroup &&
+        kind != prim::DifferentiableGraph && kind != prim::ListConstruct &&
+        kind != prim::TupleConstruct && kind != prim::ListUnpack &&
+        kind != prim::TupleUnpack && kind != prim::ConstantChunk) {
+      return false;
+    }
+    if (kind == aten::wait || !n->blocks().empty() || n->hasSideEffects() ||
+        n->isNondeterministic()) {
+      return false;
+    }
+    for (const Value* output : n->outputs()) {
+      if (output->type()->kind() == TypeKind::FutureType) {
+        return false;
+      }
+    }
+    return !alias_db_->isMutable(n) && !alias_db_->hasWriters(n);
+  }
+
+  // the movable nodes the value is computed from
+  std::unordered_set<Node*> cone(Value* v) const {
+    std::unordered_set<Node*> result;
+    std::vector<Node*> stack;
+    if (isMovable(v->node())) {
+      stack.push_back(v->node());
+      result.insert(v->node());
+    }
+    while (!stack.empty()) {
+      Node* n = stack.back();
+      stack.pop_back();
+      for (Value* input : n->inputs()) {
+        Node* producer = input->node();
+        if (!result.count(producer) && isMovable(producer)) {
+          result.insert(producer);
+          stack.push_back(producer);
+        }
+      }
+    }
+    return result;
+  }
+
+  // The branches of the inputs of join, the nodes of each one in
+  // topological order, if it is worth forking at least two of them
+  std::vector<std::vector<Node*>> branchesOf(Node* join) const {
+    std::vector<Value*> inputs;
+    std::vector<std::unordered_set<Node*>> cones;
+    std::unordered_map<Node*, size_t> num_cones;
+    for (Value* input : join->inputs()) {
+      if (std::find(inputs.begin(), inputs.end(), input) != inputs.end()) {
+        continue;
+      }
+      auto c = cone(input);
+      if (c.empty()) {
+        continue;
+      }
+      for (Node* n : c) {
+        num_cones[n]++;
+      }
+      inputs.push_back(input);
+      cones.push_back(std::move(c));
+    }
+
+    std::vector<std::vector<Node*>> branches;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      auto& branch = cones[i];
+      for (auto it = branch.begin(); it != branch.end();) {
+        it = num_cones.at(*it) > 1 ? branch.erase(it) : std::next(it);
+      }
+      // nodes whose outputs are needed by nodes other than join and the ones
+      // of the branch have to stay in the graph, and so do their inputs
+      bool changed = true;
+      while (changed) {
+        changed = false;
+        for (auto it = branch.begin(); it != branch.end();) {
+          bool used_outside = false;
+          for (Value* output : (*it)->outputs()) {
+            for (const Use& use : output->uses()) {
+              if (use.user != join && !branch.count(use.user)) {
+                used_outside = true;
+              }
+            }
+          }
+          if (used_outside) {
+            it = branch.erase(it);
+            changed = true;
+          } else {
+            ++it;
+          }
+        }
+      }
+      if (!branch.count(inputs[i]->node())) {
+        continue;
+      }
+      bool expensive = branch.size() >= kMinBranchSize;
+      std::vector<Node*> nodes;
+      for (Node* n : graph_->nodes()) {
+        if (branch.count(n)) {
+          nodes.push_back(n);
+          expensive = expensive || isExpensive(n);
+        }
+      }
+      if (expensive) {
+        branches.push_back(std::move(nodes));
+      }
+    }
+    if (branches.size() < 2) {
+      return {};
+    }
+    return branches;
+  }
+
+  // Moves the nodes of branch, whose only output used outside of it is the
+  // last node's output, into a prim::fork waited for right before join.
+  // Returns false if a bailout would have to capture the future.
+  bool fork(const std::vector<Node*>& branch, Node* join) {
+    std::unordered_set<Node*> in_branch(branch.begin(), branch.end());
+    Value* result = nullptr;
+    for (Value* output : branch.back()->outputs()) {
+      for (const Use& use : output->uses()) {
+        if (use.user == join) {
+          result = output;
+        }
+      }
+    }
+    AT_ASSERT(result);
+
+    // the fork goes right after the last node an input of the branch comes
+    // from, or at the start of the graph
+    Node* fork_point = graph_->block()->param_node();
+    for (Node* n : graph_->nodes()) {
+      if (n == join) {
+        break;
+      }
+      if (in_branch.count(n) || n->kind() == prim::Constant) {
+        continue;
+      }
+      for (Value* output : n->outputs()) {
+        for (const Use& use : output->uses()) {
+          if (in_branch.count(use.user)) {
+            fork_point = n;
+          }
+        }
+      }
+    }
+    for (Node* n = fork_point->next(); n != join; n = n->next()) {
+      if (containsBailOut(n)) {
+        return false;
+      }
+    }
+
+    auto subgraph = std::make_shared<Graph>(graph_->current_scope());
+    Node* fork_node =
+        graph_->create(prim::fork, 1)->insertAfter(fork_point);
+    std::unordered_map<Value*, Value*> env;
+    auto value_map = [&](Value* v) -> Value* {
+      auto it = env.find(v);
+      if (it != env.end()) {
+        return it->second;
+      }
+      if (v->node()->kind() == prim::Constant) {
+        Node* constant = subgraph->insertNode(
+            subgraph->createClone(v->node(), [](Value* v) { return v; }));
+        return env[v] = constant->output();
+      }
+      fork_node->addInput(v);
+      return env[v] = subgraph->addInput()->copyMetadata(v);
+    };
+    for (Node* n : branch) {
+      Node* copy = subgraph->insertNode(subgraph->createClone(n, value_map));
+      for (size_t i = 0; i < n->outputs().size(); ++i) {
+        env[n->outputs()[i]] = copy->outputs()[i];
+      }
+    }
+    subgraph->registerOutput(env.at(result));
+    fork_node->g_(attr::Subgraph, subgraph);
+    fork_node->output()->setType(FutureType::create(result->type()));
+
+    Node* wait_node =
+        graph_->create(aten::wait, {fork_node->output()})->insertBefore(join);
+    wait_node->output()->copyMetadata(result);
+    result->replaceAllUsesWith(wait_node->output());
+    for (auto it = branch.rbegin(); it != branch.rend(); ++it) {
+      (*it)->destroy();
+    }
+    forked_.push_back(std::move(subgraph));
+    return true;
+  }
+
+  bool forkOneJoin() {
+    alias_db_ = torch::make_unique<AliasDb>(graph_);
+    std::vector<Node*> joins = {graph_->return_node()};
+    for (auto it = graph_->nodes().rbegin(); it != graph_->nodes().rend();
+         ++it) {
+      joins.push_back(*it);
+    }
+    for (Node* join : joins) {
+      auto branches = branchesOf(join);
+      if (branches.empty()) {
+        continue;
+      }
+      // the last branch runs on the current thread
+      branches.pop_back();
+      bool forked = false;
+      for (const auto& branch : branches) {
+        forked = fork(branch, join) || forked;
+      }
+      if (forked) {
+        GRAPH_UPDATE("Forked branches of ", *join, " in:\n", *graph_);
+        return true;
+      }
+    }
+    return false;
+  }
+
+ public:
+  std::vector<std::shared_ptr<Graph>> forked_;
+
+ private:
+  std::shared_ptr<Graph> graph_;
+  std::unique_ptr<AliasDb> alias_db_;
+};
+
+} // namespace
+
+void ForkIndependentBranches(std::shared_ptr<Graph>& graph) {
+  ForkIndependentBranchesImpl impl(graph);
+  impl.run();
+  // the towers of a multi-tower model may have independent branches as well
+  for (auto& subgraph : impl.forked_) {
+    ForkIndependentBranches(subgraph);
+  }
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+// Runs independent branches of the graph concurrently, as if they had been
+// written with torch.jit._fork. For every node joining the values of several
+// branches, the nodes only needed by one of its inputs form the branch of that
+// input. If at least two of them are expensive enough to amortize launching a
+// task, all but the last one are moved into prim::fork subgraphs, which run on
+// the inter-op thread pool, and the join waits for their results.
+//
+// Only pure nodes are moved: nodes without side effects that are neither
+// nondeterministic nor in-place and whose inputs and outputs no node writes
+// to, so that running them on another thread cannot be observed. Nodes with
+// blocks are left where they are.
+TORCH_API void ForkIndependentBranches(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
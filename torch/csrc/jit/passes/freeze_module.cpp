@@ -0,0 +1,118 @@
+#include <torch/csrc/jit/passes/freeze_module.h>
+
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+#include <torch/csrc/jit/passes/constant_propagation.h>
+#include <torch/csrc/jit/passes/dead_code_elimination.h>
+#include <torch/csrc/jit/passes/inliner.h>
+
+#include <set>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+using ObjectPtr = c10::intrusive_ptr<c10::ivalue::Object>;
+
+void collectAttributeNodes(Block* block, std::vector<Node*>& nodes) {
+  for (Node* node : block->nodes()) {
+    if (node->kind() == prim::GetAttr || node->kind() == prim::SetAttr) {
+      nodes.push_back(node);
+    }
+    for (Block* sub_block : node->blocks()) {
+      collectAttributeNodes(sub_block, nodes);
+    }
+  }
+}
+
+class AttributeFreezer {
+ public:
+  explicit AttributeFreezer(const script::Module& module) : module_(module) {}
+
+  void run() {
+    std::vector<std::shared_ptr<Graph>> graphs;
+    for (const script::Method& method : module_.get_methods()) {
+      auto graph = method.graph();
+      Inline(*graph);
+      graphs.push_back(graph);
+    }
+    // Any method may assign an attribute, so find all assignments before
+    // folding in any of them.
+    for (const auto& graph : graphs) {
+      resolveObjects(*graph);
+      for (Node* node : attribute_nodes_) {
+        if (node->kind() == prim::SetAttr && objects_.count(node->inputs()[0])) {
+          mutated_.emplace(
+              objects_.at(node->inputs()[0]).get(), node->s(attr::name));
+        }
+      }
+    }
+    for (auto& graph : graphs) {
+      resolveObjects(*graph);
+      foldAttributes(graph);
+      ConstantPropagation(graph);
+      EliminateDeadCode(graph);
+    }
+  }
+
+ private:
+  // The objects GetAttr chains from `self` read in `graph`.
+  void resolveObjects(Graph& graph) {
+    attribute_nodes_.clear();
+    objects_.clear();
+    collectAttributeNodes(graph.block(), attribute_nodes_);
+    objects_[graph.inputs().at(0)] = module_._ivalue();
+    for (Node* node : attribute_nodes_) {
+      if (node->kind() != prim::GetAttr || !objects_.count(node->input())) {
+        continue;
+      }
+      IValue attr =
+          objects_.at(node->input())->getAttr(node->s(attr::name));
+      if (attr.isObject()) {
+        objects_[node->output()] = attr.toObject();
+      }
+    }
+  }
+
+  void foldAttributes(std::shared_ptr<Graph>& graph) {
+    AliasDb alias_db(graph);
+    for (Node* node : attribute_nodes_) {
+      if (node->kind() != prim::GetAttr || !objects_.count(node->input())) {
+        continue;
+      }
+      const ObjectPtr& object = objects_.at(node->input());
+      const std::string& name = node->s(attr::name);
+      if (mutated_.count({object.get(), name})) {
+        continue;
+      }
+      IValue attr = object->getAttr(name);
+      if (attr.isObject() || alias_db.hasWriters(node->output())) {
+        continue;
+      }
+      if (attr.isTensor()) {
+        attr = attr.toTensor().detach();
+      }
+      WithInsertPoint guard(node);
+      if (auto constant = tryInsertConstant(*graph, attr)) {
+        node->output()->replaceAllUsesWith(*constant);
+      }
+    }
+  }
+
+  const script::Module& module_;
+  std::vector<Node*> attribute_nodes_;
+  std::unordered_map<Value*, ObjectPtr> objects_;
+  std::set<std::pair<const c10::ivalue::Object*, std::string>> mutated_;
+};
+
+} // namespace
+
+script::Module freeze_module(const script::Module& module) {
+  script::Module frozen = module.clone();
+  AttributeFreezer(frozen).run();
+  return frozen;
+}
+
+} // namespace jit
+} // namespace torch
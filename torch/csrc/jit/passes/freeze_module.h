@@ -0,0 +1,25 @@
+/** \brief Fold the attributes of a scripted module into its methods
+ */
+#pragma once
+
+#include <torch/csrc/jit/script/module.h>
+
+namespace torch {
+namespace jit {
+
+/** \brief Returns a copy of `module` whose methods read its state as
+ * constants.
+ *
+ * Calls to submodule methods are inlined. Parameters, buffers and other
+ * attributes of the module and its submodules then become graph constants,
+ * after which constant propagation and dead code elimination run, so
+ * anything computed only from them (e.g. branches on `self.training`) is
+ * evaluated once here. Methods keep their `self` argument but no longer use
+ * it. Attributes that are assigned with prim::SetAttr, and tensors that may
+ * be written in place, are left as attribute reads. Parameters are folded as
+ * detached tensors, so the result is meant for inference.
+ */
+TORCH_API script::Module freeze_module(const script::Module& module);
+
+} // namespace jit
+} // namespace torch
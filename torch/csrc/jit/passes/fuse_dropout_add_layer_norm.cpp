@@ -0,0 +1,51 @@
+#include <torch/csrc/jit/passes/fuse_dropout_add_layer_norm.h>
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/subgraph_rewrite.h>
+#include <torch/csrc/jit/subgraph_matcher.h>
+
+namespace torch {
+namespace jit {
+
+void FuseDropoutAddLayerNorm(std::shared_ptr<Graph>& graph) {
+  std::string dropout_add_pattern = R"IR(
+    graph(%input, %residual, %p, %train, %alpha, %normalized_shape, %weight, %bias, %eps, %cudnn_enable):
+        %dropped = aten::dropout(%input, %p, %train)
+        %sum = aten::add(%dropped, %residual, %alpha)
+        %res = aten::layer_norm(%sum, %normalized_shape, %weight, %bias, %eps, %cudnn_enable)
+        return (%res))IR";
+  std::string add_dropout_pattern = R"IR(
+    graph(%input, %residual, %p, %train, %alpha, %normalized_shape, %weight, %bias, %eps, %cudnn_enable):
+        %dropped = aten::dropout(%input, %p, %train)
+        %sum = aten::add(%residual, %dropped, %alpha)
+        %res = aten::layer_norm(%sum, %normalized_shape, %weight, %bias, %eps, %cudnn_enable)
+        return (%res))IR";
+  std::string fused_dropout_add_layer_norm = R"IR(
+    graph(%input, %residual, %p, %train, %alpha, %normalized_shape, %weight, %bias, %eps, %cudnn_enable):
+        %input_bias: Tensor? = prim::Constant()
+        %res = aten::dropout_add_layer_norm(%input, %residual, %normalized_shape, %weight, %bias, %input_bias, %p, %train, %eps)
+        return (%res))IR";
+
+  // Only fuse a tensor-tensor add with alpha == 1
+  auto filter = [](const Match& match,
+                   const std::unordered_map<std::string, Value*>& vmap) {
+    const auto& match_vmap = match.values_map;
+    const Value* residual = match_vmap.at(vmap.at("residual"));
+    if (!residual->type()->isSubtypeOf(TensorType::get())) {
+      return false;
+    }
+    auto alpha = toIValue(match_vmap.at(vmap.at("alpha")));
+    return alpha && alpha->isInt() && alpha->toInt() == 1;
+  };
+
+  SubgraphRewriter dropout_add_to_fused;
+  dropout_add_to_fused.RegisterRewritePattern(
+      dropout_add_pattern, fused_dropout_add_layer_norm);
+  dropout_add_to_fused.runOnGraph(graph, filter);
+
+  SubgraphRewriter add_dropout_to_fused;
+  add_dropout_to_fused.RegisterRewritePattern(
+      add_dropout_pattern, fused_dropout_add_layer_norm);
+  add_dropout_to_fused.runOnGraph(graph, filter);
+}
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,18 @@
+/** \brief Fusing dropout + residual add + layer_norm into a single
+ * aten::dropout_add_layer_norm
+ */
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+/** \brief Match layer_norm(dropout(input) + residual) and fuse it into a
+ * single aten::dropout_add_layer_norm, which runs as one kernel on CUDA.
+ * Both orders of the add operands are matched; the add must have alpha = 1
+ * and the intermediate values must not be used outside of the pattern.
+ */
+TORCH_API void FuseDropoutAddLayerNorm(std::shared_ptr<Graph>& graph);
+} // namespace jit
+} // namespace torch
@@ -18,8 +18,6 @@
 namespace torch {
 namespace jit {
 
-namespace {
-
 // What is a simple mappable operator?  It:
 //    - Has a single tensor output
 //    - Output and all tensor inputs have the same shape
@@ -119,6 +117,60 @@ bool isSimpleMap(Node* node) {
   return true;
 }
 
+namespace {
+
+// Reductions that can be fused:
+//    - Sum or mean over the last dimension, with keepdim=True and no dtype
+//    - Input is a floating point tensor on a CUDA device
+// A fusion group contains at most one of them, and no chunks, concats or
+// random numbers along with it. Its other nodes are simple maps of the
+// tensor the reduction reads, of the reduced tensor and of both.
+bool isFusableReduction(Node* node) {
+  static OperatorSet reductions{{
+      "aten::sum(Tensor self, int[] dim, bool keepdim, *, int? dtype) -> Tensor",
+      "aten::mean(Tensor self, int[] dim, bool keepdim, *, int? dtype) -> Tensor",
+  }};
+  if (!reductions.find(node)) {
+    return false;
+  }
+  auto dims = node->get<c10::List<int64_t>>(attr::dim);
+  auto keepdim = node->get<bool>(attr::keepdim);
+  if (!dims || dims->size() != 1 || dims->get(0) != -1 || !keepdim ||
+      !*keepdim || !node->namedInput(attr::dtype)->mustBeNone()) {
+    return false;
+  }
+  auto type = node->input(0)->type()->cast<TensorType>();
+  if (!type || !type->scalarType() || !at::isFloatingType(*type->scalarType())) {
+    return false;
+  }
+  auto device = type->device();
+  return device && device->is_cuda();
+}
+
+// Returns true if node, or a node of the fusion group node, matches pred
+template <typename Pred>
+bool anyFusedNode(Node* node, Pred pred) {
+  if (node->kind() != prim::FusionGroup) {
+    return pred(node);
+  }
+  auto nodes = node->g(attr::Subgraph)->nodes();
+  return std::any_of(nodes.begin(), nodes.end(), pred);
+}
+
+bool hasReduction(Node* node) {
+  return anyFusedNode(node, [](Node* n) {
+    return n->kind() == aten::sum || n->kind() == aten::mean;
+  });
+}
+
+// Nodes a fusion group with a reduction cannot contain
+bool isUnfusableWithReduction(Node* node) {
+  return anyFusedNode(node, [](Node* n) {
+    return n->kind() == prim::ConstantChunk ||
+        n->kind() == prim::FusedConcat || n->kind() == aten::rand_like;
+  });
+}
+
 Value* broadcastSizes(at::ArrayRef<Value*> sizes) {
   AT_ASSERT(!sizes.empty());
   Graph* graph = sizes[0]->owningGraph();
@@ -207,7 +259,8 @@ struct GraphFuser {
     // are not necessarily correct.
     if (node->owningBlock() != block_)
       return false;
-    return node->kind() == prim::FusionGroup || isSimpleMap(node);
+    return node->kind() == prim::FusionGroup || isSimpleMap(node) ||
+        isFusableReduction(node);
   }
 
   bool isFusableCatNode(Node* node) {
@@ -425,6 +478,17 @@ struct GraphFuser {
       return at::nullopt;
     }
 
+    // Only one reduction per group, and none along with chunks, concats or
+    // random numbers
+    Node* producer_node = producer->node();
+    if (hasReduction(consumer)
+            ? hasReduction(producer_node) ||
+                isUnfusableWithReduction(producer_node)
+            : hasReduction(producer_node) &&
+                isUnfusableWithReduction(consumer)) {
+      return at::nullopt;
+    }
+
     if ((consumer->inputs().size() + consumer->outputs().size() +
          producer->node()->inputs().size() +
          producer->node()->outputs().size()) > subgraph_arg_limit_) {
@@ -457,7 +521,7 @@ struct GraphFuser {
   }
 
   bool canFuseChunk(Node* consumer, Value* producer) {
-    if (consumer->kind() != prim::FusionGroup) {
+    if (consumer->kind() != prim::FusionGroup || hasReduction(consumer)) {
       return false;
     }
     // Does the chunk have constant chunks/dim?
@@ -692,6 +756,8 @@ struct GraphFuser {
     if (chunk->kind() != prim::ConstantChunk &&
         chunk->kind() != prim::BroadcastingChunk)
       return false;
+    if (hasReduction(consumer))
+      return false;
 
     // try to find a producer to move after the chunk/bchunk. The producer must
     // be fusible into the consumer.
@@ -700,6 +766,7 @@ struct GraphFuser {
         chunk->inputs().end(),
         [&](Value* producer_for_chunk) {
           return isFusableMap(producer_for_chunk->node()) &&
+              !hasReduction(producer_for_chunk->node()) &&
               allUsersAreThisConsumerOrCalcSizes(chunk, producer_for_chunk);
         });
     if (it == chunk->inputs().end()) {
@@ -957,9 +1024,19 @@ struct GraphFuser {
         shape_of.emplace(outputs.at(outputs.size() - 1), last_size);
         continue;
       }
+      // The shape of a reduction is not that of its input, so neither it
+      // nor the values computed from it get a shape expression
+      if (n->kind() == aten::sum || n->kind() == aten::mean) {
+        continue;
+      }
       auto tensor_inputs = filter(n->inputs(), [](Value* v) {
         return v->type()->isSubtypeOf(TensorType::get());
       });
+      if (std::any_of(tensor_inputs.begin(), tensor_inputs.end(), [&](Value* v) {
+            return shape_of.count(v) == 0;
+          })) {
+        continue;
+      }
       auto shapes =
           fmap(tensor_inputs, [&](Value* v) { return shape_of.at(v); });
       AT_ASSERT(!shapes.empty());
@@ -1001,7 +1078,7 @@ struct GraphFuser {
   }
 
   bool canFuseWithConcat(Value* producer, Node* before_check) {
-    if (!isFusable(producer->node())) {
+    if (!isFusable(producer->node()) || hasReduction(producer->node())) {
       return false;
     }
     // NB: it is important that this check happens after isFusable, which checks
@@ -1123,7 +1200,7 @@ struct GraphFuser {
         any_changed |= changed;
       }
     }
-    refreshAliasDb();
+    // the last iteration didn't change the graph, so aliasDb_ is up to date
 
     fuseConcats();
 
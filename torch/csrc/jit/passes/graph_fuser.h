@@ -10,6 +10,10 @@ namespace jit {
 // On Windows will noop, NYI
 TORCH_API void FuseGraph(std::shared_ptr<Graph>& graph);
 
+// Whether FuseGraph can fuse node as an elementwise map of its tensor
+// inputs, see the definition for the exact requirements.
+TORCH_API bool isSimpleMap(Node* node);
+
 // \brief Custom fusion pass using a node-level callback to
 // determine the inclusion of nodes in a subgraph.
 //
@@ -0,0 +1,118 @@
+#include <torch/csrc/jit/passes/mkldnn_layout.h>
+
+#include <unordered_map>
+#include <unordered_set>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Ops with an MKLDNN kernel, mapped to the inputs that carry activations.
+// Only those inputs are converted; weights, biases and running stats are
+// passed through as they are.
+const std::unordered_map<Symbol, std::vector<size_t>>& mkldnnActivationInputs() {
+  static const std::unordered_map<Symbol, std::vector<size_t>> ops = {
+      {Symbol::aten("conv2d"), {0}},
+      {Symbol::aten("linear"), {0}},
+      {Symbol::aten("batch_norm"), {0}},
+      {Symbol::aten("relu"), {0}},
+      {Symbol::aten("relu_"), {0}},
+      {Symbol::aten("sigmoid"), {0}},
+      {Symbol::aten("sigmoid_"), {0}},
+      {Symbol::aten("softmax"), {0}},
+      {Symbol::aten("max_pool2d"), {0}},
+      {Symbol::aten("avg_pool2d"), {0}},
+      {Symbol::aten("adaptive_avg_pool2d"), {0}},
+      {Symbol::aten("add"), {0, 1}},
+      {Symbol::aten("add_"), {0, 1}},
+      {Symbol::aten("mul"), {0, 1}},
+      {Symbol::aten("mul_"), {0, 1}},
+      {Symbol::aten("reshape"), {0}},
+      {Symbol::aten("transpose"), {0}},
+      {Symbol::aten("clone"), {0}},
+  };
+  return ops;
+}
+
+bool isInplace(Node* n) {
+  static const std::unordered_set<Symbol> inplace_ops = {
+      Symbol::aten("relu_"),
+      Symbol::aten("sigmoid_"),
+      Symbol::aten("add_"),
+      Symbol::aten("mul_"),
+  };
+  return inplace_ops.count(n->kind()) > 0;
+}
+
+// Users that only read metadata, which MKLDNN tensors carry as well.
+bool isLayoutAgnostic(Node* n) {
+  return n->kind() == aten::size || n->kind() == aten::dim;
+}
+
+bool areTensors(Node* n, const std::vector<size_t>& positions) {
+  for (size_t i : positions) {
+    if (i >= n->inputs().size() ||
+        !n->input(i)->type()->isSubtypeOf(TensorType::get())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+void InsertMkldnnLayoutConversions(std::shared_ptr<Graph>& graph) {
+  const auto& ops = mkldnnActivationInputs();
+  Block* block = graph->block();
+
+  std::unordered_set<Node*> mkldnn_nodes;
+  std::unordered_set<Value*> mkldnn_values;
+  // Kept in graph order so the inserted conversions are deterministic.
+  std::vector<Value*> mkldnn_order;
+
+  // Entries: convert dense activations right before the op that consumes
+  // them. Chains of supported ops then see MKLDNN inputs and need nothing.
+  for (Node* n : block->nodes()) {
+    auto op = ops.find(n->kind());
+    if (op == ops.end() || !areTensors(n, op->second)) {
+      continue;
+    }
+    if (isInplace(n) && !mkldnn_values.count(n->input(0))) {
+      continue;
+    }
+    for (size_t i : op->second) {
+      Value* v = n->input(i);
+      if (mkldnn_values.count(v)) {
+        continue;
+      }
+      WithInsertPoint guard(n);
+      n->replaceInput(i, graph->insert(Symbol::aten("to_mkldnn"), {v}));
+    }
+    mkldnn_nodes.insert(n);
+    for (Value* output : n->outputs()) {
+      if (output->type()->isSubtypeOf(TensorType::get()) &&
+          mkldnn_values.insert(output).second) {
+        mkldnn_order.push_back(output);
+      }
+    }
+  }
+
+  // Exits: every other user of an MKLDNN value gets a dense copy, inserted
+  // right before it so in-place updates made in MKLDNN layout are seen.
+  for (Value* v : mkldnn_order) {
+    const auto uses = v->uses();
+    for (const Use& use : uses) {
+      Node* user = use.user;
+      if (user->owningBlock() == block &&
+          (mkldnn_nodes.count(user) || isLayoutAgnostic(user))) {
+        continue;
+      }
+      WithInsertPoint guard(user);
+      user->replaceInput(use.offset, graph->insert(aten::to_dense, {v}));
+    }
+  }
+}
+
+} // namespace jit
+} // namespace torch
@@ -0,0 +1,27 @@
+/** \brief Keep inference graphs in MKLDNN layout between supported ops
+ */
+#pragma once
+
+#include <torch/csrc/jit/ir.h>
+
+namespace torch {
+namespace jit {
+
+/** \brief Run chains of ops that have MKLDNN kernels (conv2d, linear,
+ * batch_norm, relu, pooling, add, ...) on MKLDNN tensors.
+ *
+ * An aten::to_mkldnn is inserted only where a dense activation enters such a
+ * chain and an aten::to_dense only where an MKLDNN result leaves it (a graph
+ * output, a nested block or an op without an MKLDNN kernel), so the blocked
+ * layout is kept across the whole chain instead of being reordered around
+ * every op. Weights and other parameters are not converted; use
+ * torch.utils.mkldnn.to_mkldnn to prepack module parameters once. In-place
+ * ops are only kept in MKLDNN layout when their self is already an MKLDNN
+ * value, so mutations stay visible to the original dense tensor.
+ *
+ * The graph is expected to run inference on float CPU tensors.
+ */
+TORCH_API void InsertMkldnnLayoutConversions(std::shared_ptr<Graph>& graph);
+
+} // namespace jit
+} // namespace torch
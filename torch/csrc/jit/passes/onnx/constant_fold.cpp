@@ -393,11 +393,25 @@ void ConstantFoldONNX(Block* b, ParamMap& paramsDict, int opset_version) {
     // an initializer (not onnx::Constant) then they are all removed
     // by eraseUnusedBlockInputs() call (below) outside the loop.
     auto onnxConstParents = getOnnxConstParentsToRemove(node);
+    std::vector<Value*> paramInputs;
+    for (auto* input : node->inputs()) {
+      if (valsToParamsMap.count(input)) {
+        paramInputs.push_back(input);
+      }
+    }
     node->removeAllInputs();
     for (auto* n : onnxConstParents) {
       n->destroy();
     }
     it.destroyCurrent();
+    // Drop the initializers that were only used by the folded node right
+    // away, so that the intermediate results of a chain of folded nodes are
+    // freed as we go instead of all being kept alive until the end of the pass.
+    for (auto* input : paramInputs) {
+      if (!input->hasUses()) {
+        valsToParamsMap.erase(input);
+      }
+    }
   }
   eraseUnusedValuesFromMap(valsToParamsMap);
   eraseUnusedBlockInputs(b);
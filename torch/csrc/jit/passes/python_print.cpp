@@ -1423,6 +1423,7 @@ bool printerHasSpecialCaseFor(Symbol sym) {
       prim::Load, // used in interpreter only
       prim::MMTreeReduce, // used as an optimization
       prim::MMBatchSide, // used as an optimization
+      prim::MMBatchIndependent, // used as an optimization
       prim::Store, // used in interpreter only
       prim::profile, // used in interpreter only
 
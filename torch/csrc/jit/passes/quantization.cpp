@@ -431,10 +431,26 @@ graph(%input, %weight, %bias, %4):
      %intermediate_val = aten::matmul(%input, %weight_t)
      %res = aten::add_(%intermediate_val, %bias, %4)
      return (%res) )");
+  // The sum in a residual add - relu is consumed by the fused
+  // quantized::conv2d_add_relu, so it is not observed either.
+  const PatternInfo add_functional_relu = PatternInfo::parse_from_str(R"(
+graph(%a, %b, %alpha, %inplace):
+    %relu = prim::Constant[name="relu"]()
+    %intermediate_val = aten::add_(%a, %b, %alpha)
+    %r = prim::CallFunction(%relu, %intermediate_val, %inplace)
+    return (%r) )");
+  const PatternInfo add_relu_module = PatternInfo::parse_from_str(R"(
+graph(%self, %a, %b, %alpha):
+    %intermediate_val = aten::add_(%a, %b, %alpha)
+    %relu = match::module[name="ReLU"](%self)
+    %r = prim::CallMethod[name="forward"](%relu, %intermediate_val)
+    return (%r) )");
   const std::vector<std::reference_wrapper<const PatternInfo>> patterns = {
       conv_functional_relu,
       conv_relu_module,
-      matmul_add};
+      matmul_add,
+      add_functional_relu,
+      add_relu_module};
 };
 
 // Check if `use` is an aten function of name `func_name` and if value
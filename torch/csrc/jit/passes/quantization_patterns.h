@@ -1,12 +1,15 @@
 #pragma once
 
 #include <string>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace torch {
 namespace jit {
 
-std::unordered_map<std::string, std::string> quant_fusion_pattern_and_replacements() {
+// Patterns are rewritten in order, so fused patterns that contain a smaller
+// pattern (e.g. conv2d - add_ - relu contains conv2d) come first.
+std::vector<std::pair<std::string, std::string>> quant_fusion_pattern_and_replacements() {
 
   std::string conv2d = R"(
 graph(%a_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups):
@@ -22,6 +25,33 @@ graph(%a_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %pad
         %r_quant = quantized::conv2d(%a_quant, %packed_params, %stride, %padding, %dilation, %groups, %r_scale, %r_zero_point)
         return (%r_quant) )";
 
+  // Residual block: relu(conv2d(a) + accum), with the conv output quantized
+  // as observed before it is added.
+  std::string conv2d_add_relu_template = R"(
+graph(%a_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups, %accum_quant, %out_scale, %out_zero_point, %out_dtype):
+        %a_dequant = aten::dequantize(%a_quant)
+        %w_quant : Tensor, %b : Tensor? = quantized::conv2d_unpack(%packed_params)
+        %w_dequant = aten::dequantize(%w_quant)
+        %r = aten::conv2d(%a_dequant, %w_dequant, %b, %stride, %padding, %dilation, %groups)
+        %r_quant = aten::quantize_per_tensor(%r, %r_scale, %r_zero_point, %r_dtype)
+        %r_dequant = aten::dequantize(%r_quant)
+        %accum_dequant = aten::dequantize(%accum_quant)
+        %alpha = prim::Constant[value=1]()
+        %sum = aten::add_(%r_dequant, %accum_dequant, %alpha)
+        %sum_relu = aten::RELU(%sum)
+        %out_quant = aten::quantize_per_tensor(%sum_relu, %out_scale, %out_zero_point, %out_dtype)
+        return (%out_quant) )";
+  auto conv2d_add_relu_with = [&](const std::string& relu) {
+    std::string pattern = conv2d_add_relu_template;
+    pattern.replace(pattern.find("RELU"), 4, relu);
+    return pattern;
+  };
+
+  std::string quantized_conv2d_add_relu = R"(
+graph(%a_quant, %packed_params, %r_scale, %r_zero_point, %r_dtype, %stride, %padding, %dilation, %groups, %accum_quant, %out_scale, %out_zero_point, %out_dtype):
+        %out_quant = quantized::conv2d_add_relu(%a_quant, %packed_params, %accum_quant, %stride, %padding, %dilation, %groups, %r_scale, %r_zero_point, %out_scale, %out_zero_point)
+        return (%out_quant) )";
+
   std::string addmm = R"(
 graph(%packed_params, %a_quant, %r_scale, %r_zero_point, %r_dtype, %4):
         %a_dequant = aten::dequantize(%a_quant)
@@ -64,6 +94,8 @@ graph(%packed_params, %a_quant, %r_scale, %r_zero_point, %r_dtype):
         return (%r) )";
 
   return {
+    {conv2d_add_relu_with("relu"), quantized_conv2d_add_relu},
+    {conv2d_add_relu_with("relu_"), quantized_conv2d_add_relu},
     {conv2d, quantized_conv2d},
     {addmm, quantized_linear},
     {matmul_with_bias, quantized_linear},
@@ -1337,6 +1337,35 @@ class ShapePropagator {
               node, /*num_reduce_dim=*/*maybe_keepdim?0:1, /*integer_upcast=*/true, opt_dtype);
         }};
 
+    // Requirements:
+    //   dims           : preserved if keepdim == true, smaller by the number
+    //   of reduced dims otherwise
+    //   scalar type    : dtype if specified. For sum, preserved if floating
+    //    point, otherwise long/int64, for mean preserved
+    //   device         : preserved
+    //   tensor inputs  : 1
+    //   tensor outputs : 1
+    // Additionally:
+    //   - First input should be the only tensor input
+    //   - has bool keepdim and int[] dim arguments
+    static const register_formula_for multidim_reduce_ops_with_dtype{
+        {
+            "aten::sum(Tensor self, int[] dim, bool keepdim, *, int? dtype) -> Tensor",
+            "aten::mean(Tensor self, int[] dim, bool keepdim, *, int? dtype) -> Tensor",
+        },
+        [](Node* node) -> type_vec_t {
+          auto maybe_keepdim = node->get<bool>(attr::keepdim);
+          auto maybe_dims = node->get<c10::List<int64_t>>(attr::dim);
+          if (!maybe_keepdim || !maybe_dims)
+            return {};
+          at::optional<IValue> opt_dtype = node->get(attr::dtype);
+          return reduce_op_handler(
+              node,
+              /*num_reduced_dim=*/*maybe_keepdim ? 0 : maybe_dims->size(),
+              /*upcast_integer=*/node->kind() == aten::sum,
+              opt_dtype);
+        }};
+
     // Requirements:
     //   dims           : preserved
     //   scalar type    : dtype if specified, preserved if floating point,
@@ -1929,8 +1958,12 @@ class ShapePropagator {
       auto sizes = tp->sizes().concrete_sizes().value();
       auto dims = node->get<c10::List<int64_t>>(attr::dim).value();
       bool keepdim = node->get<bool>(attr::keepdim).value();
-      std::reverse(dims.begin(), dims.end());
+      std::vector<int64_t> wrapped_dims;
       for (int64_t dim : dims) {
+        wrapped_dims.push_back(wrapDim(dim, sizes));
+      }
+      std::sort(wrapped_dims.rbegin(), wrapped_dims.rend());
+      for (int64_t dim : wrapped_dims) {
         SHAPE_ASSERT(dim >= 0 && static_cast<size_t>(dim) < sizes.size());
         if (keepdim) {
           sizes.at(dim) = 1;
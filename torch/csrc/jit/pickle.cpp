@@ -45,6 +45,7 @@ std::vector<char> pickle_save(const at::IValue& ivalue) {
       },
       /*tensor_table=*/nullptr,
       /*class_table=*/nullptr);
+  pickler.deferDeviceCopies();
   pickler.protocol();
   pickler.pushIValue(ivalue);
   pickler.stop();
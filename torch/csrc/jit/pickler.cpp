@@ -261,7 +261,8 @@ void Pickler::pushStorageOfTensor(const at::Tensor& tensor) {
 
   // TODO: Skip this if not writing tensors
   memoized_storage_map_[addr] = pushNextBinPut();
-  tensor_data_.push_back(getWriteableTensorData(tensor));
+  tensor_data_.push_back(
+      getWriteableTensorData(tensor, /*to_cpu=*/!defer_device_copies_));
 }
 
 void Pickler::pushBytes(const std::string& string) {
@@ -529,12 +530,14 @@ void Pickler::pushTuple(const IValue& ivalue) {
   }
 }
 
-WriteableTensorData getWriteableTensorData(const at::Tensor& tensor) {
+WriteableTensorData getWriteableTensorData(
+    const at::Tensor& tensor,
+    bool to_cpu) {
   WriteableTensorData result;
   result.tensor_ = tensor;
   result.size_ = tensor.element_size() * tensor.storage().size();
   // TODO HIP support
-  if (tensor.storage().device_type() == at::DeviceType::CUDA) {
+  if (to_cpu && tensor.storage().device_type() == at::DeviceType::CUDA) {
     // NB: This new tensor is created to support cuda tensors.
     // Storages can be mutated when converting tensors from cuda to cpu,
     // and we need a cpu tensor to copy data from.
@@ -554,6 +557,10 @@ WriteableTensorData getWriteableTensorData(const at::Tensor& tensor) {
   return result;
 }
 
+WriteableTensorData WriteableTensorData::toCpu() const {
+  return getWriteableTensorData(tensor_, /*to_cpu=*/true);
+}
+
 bool checkHasValidSetGetState(const std::shared_ptr<c10::ClassType>& cls) {
   // Check that the schemas for __getstate__ and __setstate__ are correct
   auto getstate = cls->getMethod("__getstate__");
@@ -99,9 +99,21 @@ struct WriteableTensorData {
   size_t numel() const {
     return tensor_.storage().numel();
   }
+  // Whether the storage was left on its CUDA device, in which case data()
+  // cannot be read before it is copied to the CPU with toCpu()
+  bool onDevice() const {
+    return tensor_.storage().device_type() == at::DeviceType::CUDA;
+  }
+  WriteableTensorData toCpu() const;
+  // The device of the storage of the tensor the data was taken from
+  at::Device device() const {
+    return tensor_.storage().device();
+  }
 
  private:
-  friend WriteableTensorData getWriteableTensorData(const at::Tensor& tensor);
+  friend WriteableTensorData getWriteableTensorData(
+      const at::Tensor& tensor,
+      bool to_cpu);
   at::Tensor tensor_;
   uint64_t size_;
 };
@@ -134,6 +146,13 @@ class Pickler {
     return tensor_data_;
   }
 
+  // Leaves the storages in tensorData() on their devices instead of copying
+  // them to the CPU while pickling, so that writeArchiveAndTensors can copy
+  // them one at a time while it writes the records.
+  void deferDeviceCopies() {
+    defer_device_copies_ = true;
+  }
+
   void pushEmptyDict();
   void pushDict(const IValue& ivalue);
   void pushInt(int64_t value);
@@ -237,6 +256,7 @@ class Pickler {
   // similar to ivalues, they are memoized using BINPUT
   std::vector<WriteableTensorData> tensor_data_;
   std::unordered_map<const void*, uint32_t> memoized_storage_map_;
+  bool defer_device_copies_ = false;
 
   std::unordered_map<std::string, uint32_t> memoized_globals_map_;
   std::unordered_map<std::string, uint32_t> memoized_strings_map_;
@@ -244,8 +264,10 @@ class Pickler {
 };
 
 // returns a (tensor, record_size) for a tensor, converting it to a CPU tensor
-// if necessary
-WriteableTensorData getWriteableTensorData(const at::Tensor& tensor);
+// if necessary and to_cpu is set
+WriteableTensorData getWriteableTensorData(
+    const at::Tensor& tensor,
+    bool to_cpu = true);
 
 // return the value of the tensor's storage pointer
 uint64_t getStorageKey(const at::Tensor& tensor);
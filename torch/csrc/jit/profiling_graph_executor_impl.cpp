@@ -1,4 +1,5 @@
 #include <torch/csrc/jit/jit_log.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
 #include <torch/csrc/jit/passes/bailout_graph.h>
 #include <torch/csrc/jit/passes/canonicalize_ops.h>
 #include <torch/csrc/jit/passes/clear_undefinedness.h>
@@ -8,6 +9,7 @@
 #include <torch/csrc/jit/passes/create_autodiff_subgraphs.h>
 #include <torch/csrc/jit/passes/dead_code_elimination.h>
 #include <torch/csrc/jit/passes/decompose_ops.h>
+#include <torch/csrc/jit/passes/fork_independent_branches.h>
 #include <torch/csrc/jit/passes/graph_fuser.h>
 #include <torch/csrc/jit/passes/guard_elimination.h>
 #include <torch/csrc/jit/passes/inline_autodiff_subgraphs.h>
@@ -34,6 +36,9 @@ static std::atomic<bool> profiling_mode{true};
 
 static std::atomic<size_t> num_profiled_runs{1};
 static std::atomic<size_t> bailout_depth{1};
+static std::atomic<size_t> specialization_cache_size{8};
+static std::atomic<bool> symbolic_batch_mode{false};
+static std::atomic<bool> automatic_fork_mode{false};
 
 std::atomic<bool>& getProfilingMode() {
   return profiling_mode;
@@ -50,6 +55,93 @@ std::atomic<size_t>& getBailoutDepth() {
   return bailout_depth;
 }
 
+std::atomic<size_t>& getSpecializationCacheSize() {
+  return specialization_cache_size;
+}
+
+std::atomic<bool>& getSymbolicBatchMode() {
+  return symbolic_batch_mode;
+}
+
+std::atomic<bool>& getAutomaticForkMode() {
+  return automatic_fork_mode;
+}
+
+// Forgets the size of the first dimension of a tensor type
+static TypePtr withoutBatchSize(const TypePtr& type) {
+  auto tt = type->cast<TensorType>();
+  if (!tt || !tt->sizes().size() || *tt->sizes().size() == 0) {
+    return type;
+  }
+  auto sizes = *tt->sizes().sizes();
+  sizes[0] = c10::nullopt;
+  return TensorType::create(
+      tt->scalarType(),
+      tt->device(),
+      c10::VaryingShape(sizes),
+      tt->strides(),
+      tt->requiresGrad(),
+      tt->undefined());
+}
+
+static void generalizeBatchSizes(Block* b) {
+  for (auto n : b->nodes()) {
+    if (n->kind() == prim::profile) {
+      n->output()->setType(withoutBatchSize(n->output()->type()));
+    }
+    for (auto ib : n->blocks()) {
+      generalizeBatchSizes(ib);
+    }
+  }
+}
+
+// The profiled types of the tensor inputs on the stack
+static std::vector<TypePtr> specializationKey(
+    const Stack& stack,
+    size_t num_inputs) {
+  std::vector<TypePtr> key;
+  for (const IValue& v : last(stack, num_inputs)) {
+    if (!v.isTensor()) {
+      continue;
+    }
+    const auto& t = v.toTensor();
+    TypePtr type = t.defined() ? tensorTypeInCurrentExecutionContext(t)
+                               : TensorType::get()->withUndefined();
+    key.push_back(getSymbolicBatchMode() ? withoutBatchSize(type) : type);
+  }
+  return key;
+}
+
+static bool sameKey(
+    const std::vector<TypePtr>& a,
+    const std::vector<TypePtr>& b) {
+  return a.size() == b.size() &&
+      std::equal(a.begin(), a.end(), b.begin(), [](const TypePtr& x,
+                                                   const TypePtr& y) {
+           return *x == *y;
+         });
+}
+
+// Profiling plans run copies of the graph of their record, whose profile
+// nodes record into it. The copies share ownership of the record, so that
+// evicting a specialization cannot free it under a running profiling plan.
+static void keepRecordAlive(
+    Block* b,
+    const std::shared_ptr<ProfilingRecord>& pr) {
+  for (auto n : b->nodes()) {
+    if (n->kind() == prim::profile) {
+      auto op = n->cast<ProfileOp>();
+      auto callback = op->getCallback();
+      if (callback) {
+        op->setCallback([pr, callback](Stack& stack) { callback(stack); });
+      }
+    }
+    for (auto ib : n->blocks()) {
+      keepRecordAlive(ib, pr);
+    }
+  }
+}
+
 static bool needsGradientInProfilingMode(Block* b) {
   for (auto n : b->nodes()) {
     if (n->kind() == prim::BailOut) {
@@ -71,21 +163,21 @@ static bool needsGradientInProfilingMode(Block* b) {
 void ProfilingGraphExecutorImpl::runProfilingOptimizations(
     std::shared_ptr<Graph>& copy) {
   if (!getGraphExecutorOptimize()) {
-    LowerGradOf(*copy);
-    runRequiredPasses(copy);
+    GRAPH_TIMED(LowerGradOf(*copy));
+    GRAPH_TIMED(runRequiredPasses(copy));
     return;
   }
 
-  InsertGuards(copy);
-  LowerGradOf(*copy);
-  EliminateRedundantGuards(copy);
-  InsertBailOuts(copy);
+  GRAPH_TIMED(InsertGuards(copy));
+  GRAPH_TIMED(LowerGradOf(*copy));
+  GRAPH_TIMED(EliminateRedundantGuards(copy));
+  GRAPH_TIMED(InsertBailOuts(copy));
   GRAPH_DUMP("After InsertBailOuts: ", copy);
-  specializeAutogradZero(*copy);
+  GRAPH_TIMED(specializeAutogradZero(*copy));
 
-  runRequiredPasses(copy);
-  ConstantPropagation(copy);
-  runOptimization(copy);
+  GRAPH_TIMED(runRequiredPasses(copy));
+  GRAPH_TIMED(ConstantPropagation(copy));
+  GRAPH_TIMED(runOptimization(copy));
 
   if (needsGradientInProfilingMode(copy->block())) {
     auto diff_nodes = CreateAutodiffSubgraphs(
@@ -94,9 +186,9 @@ void ProfilingGraphExecutorImpl::runProfilingOptimizations(
     for (Node* dnode : diff_nodes) {
       auto diff_graph = std::move(dnode->g(attr::Subgraph));
       Gradient gradient = differentiate(diff_graph);
-      runOptimization(gradient.f);
+      GRAPH_TIMED(runOptimization(gradient.f));
       // run non diff optimization on the forward graph
-      runNondiffOptimization(gradient.f);
+      GRAPH_TIMED(runNondiffOptimization(gradient.f));
       packGradient(gradient, dnode);
     }
     InlineAutodiffSubgraphs(
@@ -104,48 +196,94 @@ void ProfilingGraphExecutorImpl::runProfilingOptimizations(
         getAutodiffSubgraphInlining() ? autodiffSubgraphInlineThreshold : 1);
 
   } else {
-    runNondiffOptimization(copy);
+    GRAPH_TIMED(runNondiffOptimization(copy));
+  }
+  GRAPH_TIMED(EliminateDeadCode(copy));
+  if (getAutomaticForkMode()) {
+    GRAPH_TIMED(ForkIndependentBranches(copy));
   }
-  EliminateDeadCode(copy);
   GRAPH_DUMP("Optimized Graph : ", copy);
 }
 
 void ProfilingGraphExecutorImpl::runProfilingInsensitiveOptimizations(
     std::shared_ptr<Graph>& copy) {
-  LowerGradOf(*copy);
+  GRAPH_TIMED(LowerGradOf(*copy));
   GRAPH_DUMP("runProfilingInsensitiveOptimizations", copy);
   // clear any residual undefinedness
   // as double backward graph inputs'
   // may carry over undefinedness
   // from profiled backward graphs
-  ClearUndefinedness(copy);
-  runRequiredPasses(copy);
+  GRAPH_TIMED(ClearUndefinedness(copy));
+  GRAPH_TIMED(runRequiredPasses(copy));
   if (!getGraphExecutorOptimize()) {
     return;
   }
 
-  DecomposeOps(copy);
-  ConstantPropagation(copy);
-  EliminateDeadCode(copy);
-  EliminateCommonSubexpression(copy);
-  ConstantPooling(copy);
-  PeepholeOptimize(copy);
-  EliminateDeadCode(copy);
-  CheckInplace(copy);
+  GRAPH_TIMED(DecomposeOps(copy));
+  // Constant propagation and DCE keep the alias analysis up to date, so the
+  // three passes below share one.
+  {
+    AliasDb aliasDb(copy);
+    GRAPH_TIMED(ConstantPropagation(copy, aliasDb));
+    GRAPH_TIMED(EliminateDeadCode(copy, aliasDb));
+    GRAPH_TIMED(EliminateCommonSubexpression(copy, aliasDb));
+  }
+  GRAPH_TIMED(ConstantPooling(copy));
+  GRAPH_TIMED(PeepholeOptimize(copy));
+  GRAPH_TIMED(EliminateDeadCode(copy));
+  GRAPH_TIMED(CheckInplace(copy));
 }
 
 ProfilingGraphExecutorImpl::ProfilingGraphExecutorImpl(
     const std::shared_ptr<Graph>& graph)
     : GraphExecutorImplBase(graph) {}
 
+// Returns the specialization for the inputs on the stack, making it the most
+// recently used one. Creates it if needed, evicting the least recently used
+// specialization if the cache is full.
+// XXX: Must be called with compile_mutex held
+SpecializedPlan& ProfilingGraphExecutorImpl::getSpecialization(
+    const Stack& stack) {
+  auto key = specializationKey(stack, graph->inputs().size());
+  auto it = std::find_if(
+      specializations_.begin(),
+      specializations_.end(),
+      [&](const SpecializedPlan& s) { return sameKey(s.key, key); });
+  if (it != specializations_.end()) {
+    cache_hits_++;
+    specializations_.splice(
+        specializations_.begin(), specializations_, it);
+    return specializations_.front();
+  }
+
+  cache_misses_++;
+  const size_t capacity = std::max<size_t>(getSpecializationCacheSize(), 1);
+  while (specializations_.size() >= capacity) {
+    GRAPH_DEBUG("Evicting a specialization of ", this);
+    specializations_.pop_back();
+    cache_evictions_++;
+  }
+  specializations_.emplace_front();
+  auto& spec = specializations_.front();
+  spec.key = std::move(key);
+  auto copy = graph->copy();
+  runProfilingInsensitiveOptimizations(copy);
+  spec.pr = ProfilingRecord::instrumentGraph(copy);
+  auto pr_copy = spec.pr->graph()->copy();
+  keepRecordAlive(pr_copy->block(), spec.pr);
+  GRAPH_DUMP("Profiled Graph: ", pr_copy);
+  spec.profiling_plan = ExecutionPlan(pr_copy);
+  return spec;
+}
+
 ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
     Stack& stack,
     size_t remaining_bailout_depth) {
   std::lock_guard<std::mutex> lock(compile_mutex);
   GRAPH_DEBUG("Running ProfilingGraphExecutorImpl ", this);
 
-  if (optimized_plan_) {
-    return *optimized_plan_;
+  if (simple_plan_) {
+    return *simple_plan_;
   }
 
   // simple executor
@@ -153,38 +291,46 @@ ExecutionPlan ProfilingGraphExecutorImpl::getPlanFor(
     auto copy = graph->copy();
     runProfilingInsensitiveOptimizations(copy);
     GRAPH_DUMP("Optimized SimpleExecutor Graph : ", copy);
-    optimized_plan_ = ExecutionPlan(copy);
-    return *optimized_plan_;
+    simple_plan_ = ExecutionPlan(copy);
+    return *simple_plan_;
   }
 
-  // if a profiling graph hasn't been created yet
-  if (!pr_) {
-    auto copy = graph->copy();
-    runProfilingInsensitiveOptimizations(copy);
-    pr_ = ProfilingRecord::instrumentGraph(copy);
-    auto pr_copy = pr_->graph()->copy();
-    GRAPH_DUMP("Profiled Graph: ", pr_copy);
-    profiling_plan_ = ExecutionPlan(pr_copy);
-    // fall-through
+  auto& spec = getSpecialization(stack);
+  if (spec.optimized_plan) {
+    return *spec.optimized_plan;
   }
 
   // profile until a graph is ready
-  if (!pr_->ready()) {
-    return *profiling_plan_;
+  if (!spec.pr->ready()) {
+    return *spec.profiling_plan;
   }
 
-  auto copy = pr_->graph()->copy();
+  auto copy = spec.pr->graph()->copy();
+  if (getSymbolicBatchMode()) {
+    generalizeBatchSizes(copy->block());
+  }
   runProfilingOptimizations(copy);
   // cache
-  optimized_plan_ = ExecutionPlan(copy, remaining_bailout_depth);
-  return *optimized_plan_;
+  spec.optimized_plan = ExecutionPlan(copy, remaining_bailout_depth);
+  return *spec.optimized_plan;
 }
 
 GraphExecutorState ProfilingGraphExecutorImpl::getDebugState() {
   GraphExecutorState state;
-  TORCH_INTERNAL_ASSERT(optimized_plan_);
-  auto opt_plan = *optimized_plan_;
-  state.execution_plans.emplace(ArgumentSpec{0, 0}, opt_plan);
+  // the plan of the most recently used specialization
+  c10::optional<ExecutionPlan> opt_plan = simple_plan_;
+  for (const auto& spec : specializations_) {
+    if (opt_plan) {
+      break;
+    }
+    opt_plan = spec.optimized_plan;
+  }
+  TORCH_INTERNAL_ASSERT(opt_plan);
+  state.execution_plans.emplace(ArgumentSpec{0, 0}, *opt_plan);
+  state.specialization_cache_size = specializations_.size();
+  state.specialization_cache_hits = cache_hits_;
+  state.specialization_cache_misses = cache_misses_;
+  state.specialization_cache_evictions = cache_evictions_;
   return state;
 }
 
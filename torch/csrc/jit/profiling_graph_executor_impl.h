@@ -1,9 +1,20 @@
 #pragma once
 #include <torch/csrc/jit/graph_executor_impl.h>
 
+#include <list>
+
 namespace torch {
 namespace jit {
 
+// An optimized plan specialized to the profiled types of the tensor inputs
+// it was compiled for, along with the profiling record it was built from.
+struct SpecializedPlan {
+  std::vector<TypePtr> key;
+  std::shared_ptr<ProfilingRecord> pr;
+  c10::optional<ExecutionPlan> profiling_plan;
+  c10::optional<ExecutionPlan> optimized_plan;
+};
+
 struct ProfilingGraphExecutorImpl : public GraphExecutorImplBase {
   ProfilingGraphExecutorImpl(const std::shared_ptr<Graph>& graph);
 
@@ -15,10 +26,14 @@ struct ProfilingGraphExecutorImpl : public GraphExecutorImplBase {
  private:
   void runProfilingInsensitiveOptimizations(std::shared_ptr<Graph>& graph);
   void runProfilingOptimizations(std::shared_ptr<Graph>& graph);
-  std::unique_ptr<ProfilingRecord> pr_;
-  c10::optional<ExecutionPlan>
-      profiling_plan_; // plan to run in order to profiling the code
-  c10::optional<ExecutionPlan> optimized_plan_;
+  SpecializedPlan& getSpecialization(const Stack& stack);
+  // plan of the simple executor, used when remaining_bailout_depth is 0
+  c10::optional<ExecutionPlan> simple_plan_;
+  // specializations, the most recently used first
+  std::list<SpecializedPlan> specializations_;
+  size_t cache_hits_ = 0;
+  size_t cache_misses_ = 0;
+  size_t cache_evictions_ = 0;
 };
 
 } // namespace jit
@@ -3,11 +3,44 @@
 #include <torch/csrc/jit/interpreter.h>
 #include <torch/csrc/jit/passes/constant_propagation.h>
 
+#include <algorithm>
+
 namespace torch {
 namespace jit {
 
+namespace {
+// The slots of a profiling run that is in progress on this thread
+struct ProfilingRun {
+  const ProfilingRecord* record;
+  std::vector<TensorTypePtr> types;
+};
+
+// More than one run is active when a profiled graph calls into another one.
+// A run that throws never ends, so it is dropped when the next run of its
+// record starts on this thread.
+thread_local std::vector<ProfilingRun> active_runs;
+
+ProfilingRun* findActiveRun(const ProfilingRecord* record) {
+  for (auto it = active_runs.rbegin(); it != active_runs.rend(); ++it) {
+    if (it->record == record) {
+      return &*it;
+    }
+  }
+  return nullptr;
+}
+
+void eraseActiveRun(const ProfilingRecord* record) {
+  active_runs.erase(
+      std::remove_if(
+          active_runs.begin(),
+          active_runs.end(),
+          [record](const ProfilingRun& run) { return run.record == record; }),
+      active_runs.end());
+}
+} // namespace
+
 ProfilingRecord::ProfilingRecord(std::shared_ptr<Graph> g)
-    : profiled_graph_(std::move(g)), profiling_count_(getNumProfiledRuns()) {}
+    : profiled_graph_(std::move(g)), profiling_count_(getNumProfiledRuns().load()) {}
 
 ProfileOp* ProfilingRecord::createProfileNode(
     const std::function<void(Stack&)>& fp,
@@ -51,26 +84,21 @@ void ProfilingRecord::insertShapeProfile(Node *n, Value *i) {
 
   auto pn = createProfileNode(nullptr, {i});
   auto pno = pn->addOutput();
-  bool first = true;
   pno->setType(TensorType::get());
-  std::function<void(Stack &)> shape_profiler = [this, pno,
-                                                 first](Stack &stack) mutable {
+  const size_t slot = profiled_values_.size();
+  profiled_values_.push_back(pno);
+  std::function<void(Stack &)> shape_profiler = [this, slot](Stack &stack) {
     IValue t;
     pop(stack, t);
-    if (t.isTensor()) {
-
+    // runs that start after profiling has finished don't record anything
+    auto run = findActiveRun(this);
+    if (run && t.isTensor()) {
+      auto& type = run->types[slot];
       if (t.toTensor().defined()) {
         auto pttp = tensorTypeInCurrentExecutionContext(t.toTensor());
-        std::lock_guard<std::mutex> lock(this->mutex_);
-        if (auto type = pno->type()->cast<TensorType>()) {
-          if (!first) {
-            pttp = pttp->merge(type);
-          }
-          pno->setType(pttp);
-          first = false;
-        }
+        type = type ? pttp->merge(type) : pttp;
       } else {
-        pno->setType(TensorType::get()->withUndefined());
+        type = TensorType::get()->withUndefined();
       }
     }
 
@@ -84,6 +112,44 @@ void ProfilingRecord::insertShapeProfile(Node *n, Value *i) {
   n->replaceInputWith(i, pn->output());
 }
 
+void ProfilingRecord::beginRun() {
+  eraseActiveRun(this);
+  if (profiling_count_ > 0) {
+    active_runs.push_back(
+        {this, std::vector<TensorTypePtr>(profiled_values_.size())});
+  }
+}
+
+void ProfilingRecord::endRun() {
+  auto run = findActiveRun(this);
+  if (!run) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // other runs may have finished profiling while this one was in progress
+    if (profiling_count_ > 0) {
+      for (size_t slot = 0; slot < profiled_types_.size(); slot++) {
+        auto& type = profiled_types_[slot];
+        const auto& run_type = run->types[slot];
+        if (run_type) {
+          type = type ? run_type->merge(type) : run_type;
+        }
+      }
+      if (profiling_count_ == 1) {
+        for (size_t slot = 0; slot < profiled_values_.size(); slot++) {
+          if (profiled_types_[slot]) {
+            profiled_values_[slot]->setType(profiled_types_[slot]);
+          }
+        }
+      }
+      // the types are set before the record becomes ready()
+      profiling_count_--;
+    }
+  }
+  eraseActiveRun(this);
+}
+
 void ProfilingRecord::instrumentBlock(Block *block) {
   for (auto it = block->nodes().begin(); it != block->nodes().end(); ++it) {
     auto n = *it;
@@ -116,14 +182,12 @@ std::unique_ptr<ProfilingRecord> ProfilingRecord::instrumentGraph(
       pr->insertShapeProfile(new_g->return_node(), i);
     }
   }
-  std::function<void(Stack&)> counter = [raw_pr](Stack&) {
-    std::lock_guard<std::mutex> lock(raw_pr->mutex_);
-    if (raw_pr->profiling_count_ > 0)
-    {
-        raw_pr->profiling_count_--;
-    }
-  };
+  pr->profiled_types_.resize(pr->profiled_values_.size());
+
+  std::function<void(Stack&)> begin = [raw_pr](Stack&) { raw_pr->beginRun(); };
+  std::function<void(Stack&)> counter = [raw_pr](Stack&) { raw_pr->endRun(); };
 
+  new_g->prependNode(pr->createProfileNode(begin, {}));
   auto pop = pr->createProfileNode(counter, {});
   new_g->appendNode(pop);
   return pr;
@@ -7,7 +7,9 @@
 #include <ATen/core/stack.h>
 #include <torch/csrc/jit/ir.h>
 
+#include <atomic>
 #include <list>
+#include <mutex>
 #include <vector>
 
 namespace torch {
@@ -15,6 +17,14 @@ namespace jit {
 
 using ::c10::TensorTypePtr;
 
+// Records the types of the tensors that flow into every node of a graph
+// over its first getNumProfiledRuns() runs.
+//
+// Every profiled value has a slot. A run records the types it sees into
+// slots of its own, which belong to the thread that runs it, so the profile
+// nodes don't synchronize. The types of a run are merged into the record
+// once, when the run ends, and are set on the outputs of the profile nodes
+// of profiled_graph_ when the last profiling run ends.
 struct ProfilingRecord {
   // N.B. ProfilingRecord's copy and move c-tor are disabled, so we won't
   // end up accidentally copying or moving ProfilingRecords whose addresses
@@ -26,7 +36,7 @@ struct ProfilingRecord {
 
   std::shared_ptr<Graph> profiled_graph_;
   std::mutex mutex_;
-  size_t profiling_count_;
+  std::atomic<size_t> profiling_count_;
   bool ready() const {
     return profiling_count_ == 0;
   }
@@ -39,7 +49,15 @@ struct ProfilingRecord {
       at::ArrayRef<Value*> inputs);
   void instrumentBlock(Block* block);
   void insertShapeProfile(Node *n, Value *i);
+  void beginRun();
+  void endRun();
   ProfilingRecord(std::shared_ptr<Graph> g);
+
+  // the output of the profile node of every slot
+  std::vector<Value*> profiled_values_;
+  // the types merged from the profiling runs that have ended, nullptr for
+  // the slots that no run has reached
+  std::vector<TensorTypePtr> profiled_types_;
 };
 
 } // namespace jit
@@ -7,11 +7,15 @@
 #include <torch/csrc/jit/pybind.h>
 #include <torch/csrc/jit/python_tracer.h>
 #include <torch/csrc/jit/tracer.h>
+#include <torch/csrc/utils/hash.h>
 #include <torch/csrc/utils/python_strings.h>
 
 #include <c10/util/Exception.h>
 
 #include <sstream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 using namespace torch::autograd;
 using namespace torch::jit;
@@ -49,6 +53,72 @@ SourceRange getPythonInterpreterSourceRange() {
   return SourceRange(source, 0, stack_trace_text.size());
 }
 
+namespace {
+
+// The source ranges of the Python stacks seen during the current trace, keyed
+// on the code object and instruction of each frame. Ops traced from the same
+// stack, e.g. the layers of a model applied in a loop, share one source range
+// instead of formatting the whole stack for every node. Only used with the
+// GIL held.
+using StackKey = std::vector<std::pair<PyCodeObject*, int>>;
+
+struct StackKeyHash {
+  size_t operator()(const StackKey& key) const {
+    size_t hash = 0;
+    for (const auto& frame : key) {
+      hash = torch::hash_combine(hash, std::hash<PyCodeObject*>()(frame.first));
+      hash = torch::hash_combine(hash, std::hash<int>()(frame.second));
+    }
+    return hash;
+  }
+};
+
+struct CachedSourceRange {
+  SourceRange range;
+  // keep the code objects of the key alive, so their addresses are not reused
+  std::vector<py::object> code;
+};
+
+// leaked, as the code objects must not be released after the interpreter
+// is finalized
+std::unordered_map<StackKey, CachedSourceRange, StackKeyHash>&
+sourceRangeCache() {
+  static auto cache =
+      new std::unordered_map<StackKey, CachedSourceRange, StackKeyHash>();
+  return *cache;
+}
+
+struct ClearSourceRangeCache {
+  ClearSourceRangeCache() {
+    sourceRangeCache().clear();
+  }
+  ~ClearSourceRangeCache() {
+    sourceRangeCache().clear();
+  }
+};
+
+SourceRange getCachedPythonInterpreterSourceRange() {
+  pybind11::gil_scoped_acquire gil;
+  StackKey key;
+  for (PyFrameObject* frame = PyEval_GetFrame(); frame != nullptr;
+       frame = frame->f_back) {
+    key.emplace_back(frame->f_code, frame->f_lasti);
+  }
+  auto& cache = sourceRangeCache();
+  auto it = cache.find(key);
+  if (it == cache.end()) {
+    CachedSourceRange entry{getPythonInterpreterSourceRange(), {}};
+    for (const auto& frame : key) {
+      entry.code.push_back(
+          py::reinterpret_borrow<py::object>(reinterpret_cast<PyObject*>(frame.first)));
+    }
+    it = cache.emplace(std::move(key), std::move(entry)).first;
+  }
+  return it->second.range;
+}
+
+} // namespace
+
 std::pair<std::shared_ptr<Graph>, Stack> createGraphByTracing(
     const py::function& func,
     Stack trace_inputs,
@@ -56,6 +126,7 @@ std::pair<std::shared_ptr<Graph>, Stack> createGraphByTracing(
     bool force_outplace,
     script::Module* self) {
   C10_LOG_API_USAGE_ONCE("torch.tracer");
+  ClearSourceRangeCache clear_source_range_cache;
 
   auto lookup_fn_adapter =
       [var_name_lookup_fn](const Variable& var) -> std::string {
@@ -111,7 +182,7 @@ Node* preRecordPythonTrace(
 }
 
 void pythonRecordSourceLocation(Node* n) {
-  n->setSourceRange(getPythonInterpreterSourceRange());
+  n->setSourceRange(getCachedPythonInterpreterSourceRange());
 }
 
 void pythonWarn(const std::string& reason) {
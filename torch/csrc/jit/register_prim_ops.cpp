@@ -1232,8 +1232,7 @@ RegisterOperators reg(
              InterpreterState forked_interprester(code);
              InterpreterContinuation continuation(
                  forked_interprester,
-                 Stack(stack.end() - n_inputs, stack.end()),
-                 autograd::GradMode::is_enabled());
+                 Stack(stack.end() - n_inputs, stack.end()));
              drop(stack, n_inputs);
 
              push(stack, forked_interprester.getFuture());
@@ -1809,8 +1808,7 @@ Operation listExtend(const Node* node) {
 template <typename T>
 Operation listCopy(const Node* node) {
   return [](Stack& stack) {
-    c10::List<T> list = pop(stack).to<c10::List<T>>();
-    push(stack, list.copy());
+    push(stack, pop(stack).to<c10::List<T>>().copy());
     return 0;
   };
 }
@@ -1890,8 +1888,7 @@ int listNe<at::Tensor>(Stack& stack) {
 
 template <typename T>
 int listList(Stack& stack) {
-  c10::List<T> a = pop(stack).to<c10::List<T>>();
-  push(stack, a.copy());
+  push(stack, pop(stack).to<c10::List<T>>().copy());
   return 0;
 }
 
@@ -1914,14 +1911,7 @@ int listAdd(Stack& stack) {
   c10::List<T> b = pop(stack).to<c10::List<T>>();
   c10::List<T> a = pop(stack).to<c10::List<T>>();
 
-  c10::List<T> ret = make_result_list<T>(a.elementType());
-
-  if (a.use_count() == 1) {
-    ret = std::move(a);
-  } else {
-    ret = a.copy();
-  }
-
+  c10::List<T> ret = std::move(a).copy();
   ret.append(std::move(b));
 
   push(stack, std::move(ret));
@@ -2044,8 +2034,7 @@ int listSort<at::Tensor>(Stack& stack) {
 
 template <typename T>
 int listCopyAndSort(Stack& stack) {
-  c10::List<T> list = pop(stack).to<c10::List<T>>();
-  auto list_copied = list.copy();
+  auto list_copied = pop(stack).to<c10::List<T>>().copy();
   std::sort(list_copied.begin(), list_copied.end(), [](const T& a, const T& b) {
     // "strict weak ordering" issue - see other sort
     if (a == b) {
@@ -2060,8 +2049,7 @@ int listCopyAndSort(Stack& stack) {
 // Specialization for at::Tensor
 template <>
 int listCopyAndSort<at::Tensor>(Stack& stack) {
-  c10::List<at::Tensor> list = pop(stack).toTensorList();
-  auto list_copied = list.copy();
+  auto list_copied = pop(stack).toTensorList().copy();
   std::sort(
       list_copied.begin(),
       list_copied.end(),
@@ -3271,7 +3259,7 @@ Operation sort_op(
     bool reverse = has_reverse_arg ? pop(stack).toBool() : false;
     auto g_list = pop(stack).toList();
     if (copy_return_list) {
-      g_list = g_list.copy();
+      g_list = std::move(g_list).copy();
     }
     Stack sort_stack;
     std::sort(
@@ -1150,6 +1150,21 @@ void initJitScriptBindings(PyObject* module) {
         return import_ir_module(
             std::move(cu), filename, optional_device, extra_files);
       });
+  m.def(
+      "import_ir_module_mmap",
+      [](std::shared_ptr<CompilationUnit> cu,
+         const std::string& filename,
+         py::object map_location,
+         ExtraFilesMap& extra_files) {
+        c10::optional<at::Device> optional_device;
+        if (!map_location.is(py::none())) {
+          AT_ASSERT(THPDevice_Check(map_location.ptr()));
+          optional_device =
+              reinterpret_cast<THPDevice*>(map_location.ptr())->device;
+        }
+        return import_ir_module_mmap(
+            std::move(cu), filename, optional_device, extra_files);
+      });
   m.def(
       "import_ir_module_from_buffer",
       [](std::shared_ptr<CompilationUnit> cu,
@@ -0,0 +1,389 @@
+#include <torch/csrc/jit/static_runtime.h>
+
+#include <ATen/ATen.h>
+#include <torch/csrc/jit/constants.h>
+#include <torch/csrc/jit/passes/alias_analysis.h>
+#include <torch/csrc/jit/passes/freeze_module.h>
+#include <torch/csrc/jit/passes/inliner.h>
+#include <torch/csrc/jit/passes/liveness.h>
+
+#include <algorithm>
+
+namespace torch {
+namespace jit {
+
+namespace {
+
+// Arena offsets are aligned like the CPU allocator's own allocations.
+constexpr size_t kArenaAlignment = 64;
+
+c10::optional<at::Scalar> toOptionalScalar(const IValue& v) {
+  if (v.isNone()) {
+    return c10::nullopt;
+  }
+  return v.toScalar();
+}
+
+const std::vector<std::pair<const char*, OutVariant>>& outVariants() {
+  static const std::vector<std::pair<const char*, OutVariant>> out_variants = {
+      {"aten::add(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+       [](const std::vector<IValue>& in, at::Tensor& out) {
+         at::add_out(out, in[0].toTensor(), in[1].toTensor(), in[2].toScalar());
+       }},
+      {"aten::sub(Tensor self, Tensor other, *, Scalar alpha=1) -> Tensor",
+       [](const std::vector<IValue>& in, at::Tensor& out) {
+         at::sub_out(out, in[0].toTensor(), in[1].toTensor(), in[2].toScalar());
+       }},
+      {"aten::mul(Tensor self, Tensor other) -> Tensor",
+       [](const std::vector<IValue>& in, at::Tensor& out) {
+         at::mul_out(out, in[0].toTensor(), in[1].toTensor());
+       }},
+      {"aten::div(Tensor self, Tensor other) -> Tensor",
+       [](const std::vector<IValue>& in, at::Tensor& out) {
+         at::div_out(out, in[0].toTensor(), in[1].toTensor());
+       }},
+      {"aten::relu(Tensor self) -> Tensor",
+       [](const std::vector<IValue>& in, at::Tensor& out) {
+         at::threshold_out(out, in[0].toTensor(), 0, 0);
+       }},
+      {"aten::threshold(Tensor self, Scalar threshold, Scalar value) -> Tensor",
+       [](const std::vector<IValue>& in, at::Tensor& out) {
+         at::threshold_out(
+             out, in[0].toTensor(), in[1].toScalar(), in[2].toScalar());
+       }},
+      {"aten::clamp(Tensor self, Scalar? min=None, Scalar? max=None) -> Tensor",
+       [](const std::vector<IValue>& in, at::Tensor& out) {
+         at::clamp_out(
+             out,
+             in[0].toTensor(),
+             toOptionalScalar(in[1]),
+             toOptionalScalar(in[2]));
+       }},
+      {"aten::sigmoid(Tensor self) -> Tensor",
+       [](const std::vector<IValue>& in, at::Tensor& out) {
+         at::sigmoid_out(out, in[0].toTensor());
+       }},
+      {"aten::tanh(Tensor self) -> Tensor",
+       [](const std::vector<IValue>& in, at::Tensor& out) {
+         at::tanh_out(out, in[0].toTensor());
+       }},
+      {"aten::mm(Tensor self, Tensor mat2) -> Tensor",
+       [](const std::vector<IValue>& in, at::Tensor& out) {
+         at::mm_out(out, in[0].toTensor(), in[1].toTensor());
+       }},
+      {"aten::bmm(Tensor self, Tensor mat2) -> Tensor",
+       [](const std::vector<IValue>& in, at::Tensor& out) {
+         at::bmm_out(out, in[0].toTensor(), in[1].toTensor());
+       }},
+      {"aten::matmul(Tensor self, Tensor other) -> Tensor",
+       [](const std::vector<IValue>& in, at::Tensor& out) {
+         at::matmul_out(out, in[0].toTensor(), in[1].toTensor());
+       }},
+      {"aten::addmm(Tensor self, Tensor mat1, Tensor mat2, *, Scalar beta=1, Scalar alpha=1) -> Tensor",
+       [](const std::vector<IValue>& in, at::Tensor& out) {
+         at::addmm_out(
+             out,
+             in[0].toTensor(),
+             in[1].toTensor(),
+             in[2].toTensor(),
+             in[3].toScalar(),
+             in[4].toScalar());
+       }},
+      {"aten::cat(Tensor[] tensors, int dim=0) -> Tensor",
+       [](const std::vector<IValue>& in, at::Tensor& out) {
+         at::cat_out(out, in[0].toTensorList().vec(), in[1].toInt());
+       }},
+  };
+  return out_variants;
+}
+
+bool hasSpecialExecution(const Node* node) {
+  switch (node->kind()) {
+    case prim::If:
+    case prim::Loop:
+    case prim::CallFunction:
+    case prim::CallMethod:
+    case prim::BailOut:
+    case prim::GetAttr:
+    case prim::SetAttr:
+    case aten::wait:
+      return true;
+    default:
+      return !node->blocks().empty();
+  }
+}
+
+// What a planned run requires of a runtime input, so that the profiled sizes
+// still hold.
+bool sameInputShape(
+    const IValue& input,
+    const std::vector<int64_t>& sizes,
+    const IValue& scalar) {
+  if (input.isTensor()) {
+    return scalar.isNone() && !input.toTensor().requires_grad() &&
+        input.toTensor().sizes() == sizes;
+  }
+  if (input.isInt() && scalar.isInt()) {
+    return input.toInt() == scalar.toInt();
+  }
+  if (input.isDouble() && scalar.isDouble()) {
+    return input.toDouble() == scalar.toDouble();
+  }
+  if (input.isBool() && scalar.isBool()) {
+    return input.toBool() == scalar.toBool();
+  }
+  return false;
+}
+
+} // namespace
+
+const OutVariant* getOutVariant(const Node* node) {
+  for (const auto& entry : outVariants()) {
+    if (node->matches(entry.first)) {
+      return &entry.second;
+    }
+  }
+  return nullptr;
+}
+
+StaticRuntime::StaticRuntime(std::shared_ptr<Graph> graph)
+    : graph_(graph->copy()) {
+  Inline(*graph_);
+  init();
+}
+
+StaticRuntime::StaticRuntime(const script::Module& module)
+    : graph_(freeze_module(module).get_method("forward").graph()->copy()) {
+  TORCH_CHECK(
+      !graph_->inputs().at(0)->hasUses(),
+      "StaticRuntime: forward still uses self after freezing the module");
+  graph_->eraseInput(0);
+  init();
+}
+
+void StaticRuntime::init() {
+  auto index_of = [&](Value* v) {
+    auto it = value_to_index_.find(v);
+    if (it != value_to_index_.end()) {
+      return it->second;
+    }
+    const size_t index = values_.size();
+    value_to_index_.emplace(v, index);
+    values_.emplace_back();
+    return index;
+  };
+
+  for (Value* input : graph_->inputs()) {
+    graph_inputs_.push_back(index_of(input));
+  }
+  for (Node* node : graph_->nodes()) {
+    if (node->kind() == prim::Constant) {
+      values_[index_of(node->output())] = *toIValue(node->output());
+      continue;
+    }
+    TORCH_CHECK(
+        !hasSpecialExecution(node),
+        "StaticRuntime only runs straight-line graphs of operators, got ",
+        node->kind().toQualString());
+    ProcessedNode processed{node, {}, {}, getOperation(node), nullptr};
+    for (Value* input : node->inputs()) {
+      processed.inputs.push_back(index_of(input));
+    }
+    for (Value* output : node->outputs()) {
+      processed.outputs.push_back(index_of(output));
+    }
+    if (node->outputs().size() == 1 &&
+        node->output()->type()->isSubtypeOf(TensorType::get())) {
+      processed.out_variant = getOutVariant(node);
+    }
+    nodes_.push_back(std::move(processed));
+  }
+  for (Value* output : graph_->outputs()) {
+    graph_outputs_.push_back(index_of(output));
+  }
+}
+
+std::vector<IValue> StaticRuntime::run(const std::vector<IValue>& inputs) {
+  TORCH_CHECK(
+      inputs.size() == graph_inputs_.size(),
+      "StaticRuntime: expected ",
+      graph_inputs_.size(),
+      " inputs, got ",
+      inputs.size());
+  const bool planned = matchesPlan(inputs);
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    values_[graph_inputs_[i]] = inputs[i];
+  }
+
+  Stack stack;
+  for (const ProcessedNode& pnode : nodes_) {
+    for (size_t input : pnode.inputs) {
+      stack.push_back(values_[input]);
+    }
+    if (planned && pnode.out_variant) {
+      auto it = planned_by_value_.find(pnode.outputs[0]);
+      if (it != planned_by_value_.end()) {
+        at::Tensor& out = planned_[it->second].buffer;
+        (*pnode.out_variant)(stack, out);
+        stack.clear();
+        values_[pnode.outputs[0]] = out;
+        continue;
+      }
+    }
+    pnode.op(stack);
+    for (size_t i = pnode.outputs.size(); i > 0; --i) {
+      values_[pnode.outputs[i - 1]] = pop(stack);
+    }
+  }
+
+  std::vector<IValue> outputs;
+  outputs.reserve(graph_outputs_.size());
+  for (size_t output : graph_outputs_) {
+    outputs.push_back(values_[output]);
+  }
+  if (!planned) {
+    plan(inputs);
+  }
+  // Drop the references to inputs and intermediates, constants stay.
+  for (size_t input : graph_inputs_) {
+    values_[input] = IValue();
+  }
+  for (const ProcessedNode& pnode : nodes_) {
+    for (size_t output : pnode.outputs) {
+      values_[output] = IValue();
+    }
+  }
+  return outputs;
+}
+
+bool StaticRuntime::matchesPlan(const std::vector<IValue>& inputs) const {
+  if (planned_input_sizes_.size() != inputs.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    if (!sameInputShape(
+            inputs[i], planned_input_sizes_[i], planned_input_scalars_[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void StaticRuntime::plan(const std::vector<IValue>& inputs) {
+  planned_.clear();
+  planned_by_value_.clear();
+  arena_ = at::Tensor();
+  arena_bytes_ = 0;
+  planned_input_sizes_.clear();
+  planned_input_scalars_.clear();
+
+  // Only inputs with a comparable value can key the plan.
+  for (const IValue& input : inputs) {
+    if (input.isTensor() && !input.toTensor().requires_grad()) {
+      planned_input_sizes_.push_back(input.toTensor().sizes().vec());
+      planned_input_scalars_.emplace_back();
+    } else if (input.isInt() || input.isDouble() || input.isBool()) {
+      planned_input_sizes_.emplace_back();
+      planned_input_scalars_.push_back(input);
+    } else {
+      planned_input_sizes_.clear();
+      planned_input_scalars_.clear();
+      return;
+    }
+  }
+
+  AliasDb alias_db(graph_);
+  const auto liveness = BuildLivenessSets(graph_);
+  std::unordered_map<const Value*, size_t> node_index;
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    for (Value* output : nodes_[i].node->outputs()) {
+      node_index[output] = i;
+    }
+  }
+
+  struct Candidate {
+    size_t planned;
+    size_t bytes;
+    size_t first;
+    size_t last;
+  };
+  std::vector<Candidate> candidates;
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    const ProcessedNode& pnode = nodes_[i];
+    if (!pnode.out_variant) {
+      continue;
+    }
+    Value* v = pnode.node->output();
+    const IValue& profiled = values_[pnode.outputs[0]];
+    if (!profiled.isTensor()) {
+      continue;
+    }
+    const at::Tensor& t = profiled.toTensor();
+    if (!t.defined() || t.device() != at::kCPU || t.is_sparse() ||
+        !t.is_contiguous() || t.requires_grad() ||
+        alias_db.mayContainAlias(v, graph_->outputs())) {
+      continue;
+    }
+    // The buffer lives as long as anything that may alias it.
+    size_t last = i;
+    for (size_t j = i; j < nodes_.size(); ++j) {
+      for (Value* live : liveness.at(nodes_[j].node)) {
+        if (live == v || alias_db.mayAlias(live, v)) {
+          last = j;
+          break;
+        }
+      }
+    }
+    const size_t bytes =
+        (t.numel() * t.element_size() + kArenaAlignment - 1) /
+        kArenaAlignment * kArenaAlignment;
+    candidates.push_back({planned_.size(), bytes, i, last});
+    planned_.push_back({pnode.outputs[0],
+                        t.sizes().vec(),
+                        t.options(),
+                        0,
+                        at::Tensor()});
+  }
+
+  // Greedy by size: each buffer takes the lowest offset that does not
+  // overlap a placed buffer whose lifetime intersects its own.
+  std::vector<Candidate> order = candidates;
+  std::stable_sort(
+      order.begin(), order.end(), [](const Candidate& a, const Candidate& b) {
+        return a.bytes > b.bytes;
+      });
+  std::vector<Candidate> placed;
+  for (const Candidate& c : order) {
+    std::vector<std::pair<size_t, size_t>> busy;
+    for (const Candidate& p : placed) {
+      if (p.first <= c.last && c.first <= p.last) {
+        const size_t offset = planned_[p.planned].offset;
+        busy.emplace_back(offset, offset + p.bytes);
+      }
+    }
+    std::sort(busy.begin(), busy.end());
+    size_t offset = 0;
+    for (const auto& range : busy) {
+      if (offset + c.bytes <= range.first) {
+        break;
+      }
+      offset = std::max(offset, range.second);
+    }
+    planned_[c.planned].offset = offset;
+    arena_bytes_ = std::max(arena_bytes_, offset + c.bytes);
+    placed.push_back(c);
+  }
+
+  if (arena_bytes_ > 0) {
+    arena_ = at::empty({static_cast<int64_t>(arena_bytes_)}, at::kByte);
+  }
+  uint8_t* arena_data = arena_bytes_ > 0 ? arena_.data_ptr<uint8_t>() : nullptr;
+  for (size_t i = 0; i < planned_.size(); ++i) {
+    PlannedValue& p = planned_[i];
+    p.buffer = at::from_blob(arena_data + p.offset, p.sizes, p.options);
+    planned_by_value_[p.value] = i;
+  }
+}
+
+} // namespace jit
+} // namespace torch
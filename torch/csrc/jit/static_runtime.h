@@ -0,0 +1,104 @@
+#pragma once
+
+#include <ATen/core/ivalue.h>
+#include <torch/csrc/WindowsTorchApiMacro.h>
+#include <torch/csrc/jit/ir.h>
+#include <torch/csrc/jit/operator.h>
+#include <torch/csrc/jit/script/module.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace torch {
+namespace jit {
+
+// Writes the result of `node` for `inputs` into `out`, which the memory plan
+// allocated with the sizes and dtype profiled for the node's output.
+using OutVariant =
+    std::function<void(const std::vector<IValue>& inputs, at::Tensor& out)>;
+
+// Returns the out variant registered for the schema of `node`, or nullptr
+// if the node has to allocate its own output.
+TORCH_API const OutVariant* getOutVariant(const Node* node);
+
+/** \brief Inference-only executor for straight-line graphs that places
+ * intermediate tensors in one preallocated arena.
+ *
+ * The first run of a new set of input shapes executes every node
+ * normally and records the sizes of the tensors produced by nodes that have
+ * an out variant. The lifetime of each such tensor, extended over everything
+ * that may alias it, comes from BuildLivenessSets; tensors whose lifetimes
+ * do not overlap share arena offsets. Later runs with the same input shapes
+ * make the out variants write into views of the arena, so they do not touch
+ * the allocator. A run with different input shapes plans again.
+ *
+ * Graph outputs, and anything that may alias them, are always freshly
+ * allocated, so results stay valid after the next run. Autograd is not
+ * supported and the graph may not contain blocks (prim::If, prim::Loop).
+ */
+class TORCH_API StaticRuntime {
+ public:
+  explicit StaticRuntime(std::shared_ptr<Graph> graph);
+  // Runs module.forward, frozen with freeze_module, so later changes to the
+  // module's attributes are not seen.
+  explicit StaticRuntime(const script::Module& module);
+
+  std::vector<IValue> run(const std::vector<IValue>& inputs);
+
+  const std::shared_ptr<Graph>& graph() const {
+    return graph_;
+  }
+  // Bytes of the arena of the current plan, 0 before the first planned run.
+  size_t arenaBytes() const {
+    return arena_bytes_;
+  }
+  // Number of intermediates placed in the arena by the current plan.
+  size_t numPlannedValues() const {
+    return planned_.size();
+  }
+
+ private:
+  struct ProcessedNode {
+    Node* node;
+    std::vector<size_t> inputs;
+    std::vector<size_t> outputs;
+    Operation op;
+    const OutVariant* out_variant;
+  };
+
+  struct PlannedValue {
+    size_t value;
+    std::vector<int64_t> sizes;
+    at::TensorOptions options;
+    size_t offset;
+    at::Tensor buffer;
+  };
+
+  void init();
+  // Plans the arena from the intermediates left in values_ by a run with
+  // `inputs`.
+  void plan(const std::vector<IValue>& inputs);
+  bool matchesPlan(const std::vector<IValue>& inputs) const;
+
+  std::shared_ptr<Graph> graph_;
+  std::vector<ProcessedNode> nodes_;
+  // Runtime values by index: graph inputs, then constants, then node outputs.
+  std::vector<IValue> values_;
+  std::vector<size_t> graph_inputs_;
+  std::vector<size_t> graph_outputs_;
+  std::unordered_map<const Value*, size_t> value_to_index_;
+  // Index into planned_ of each value placed in the arena.
+  std::unordered_map<size_t, size_t> planned_by_value_;
+
+  // The inputs the current plan was made for: tensor sizes, or the value of
+  // int, float and bool inputs.
+  std::vector<std::vector<int64_t>> planned_input_sizes_;
+  std::vector<IValue> planned_input_scalars_;
+  std::vector<PlannedValue> planned_;
+  at::Tensor arena_;
+  size_t arena_bytes_ = 0;
+};
+
+} // namespace jit
+} // namespace torch
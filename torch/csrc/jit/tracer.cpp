@@ -60,13 +60,12 @@ void delValueTrace(const IValue& var) {
   getTracingState()->delValue(var);
 }
 void TracingState::delValue(const IValue& var) {
-  for (size_t i = 0; i < env_stack.size(); ++i) {
-    auto& value_map = env_stack.at(env_stack.size() - 1 - i);
-    auto it = value_map.find(var);
-    if (it == value_map.end()) {
-      continue;
+  for (auto& frame : env_stack) {
+    if (var.isTensor()) {
+      frame.tensors.erase(var.unsafeToTensorImpl());
+    } else {
+      frame.others.erase(var);
     }
-    value_map.erase(it);
   }
 }
 
@@ -87,6 +86,56 @@ void TracingState::delValue(const IValue& var) {
 Value* getValueTrace(const IValue& var) {
   return getTracingState()->getValue(var);
 }
+Value* getValueTrace(const at::Tensor& var) {
+  return getTracingState()->getValue(var);
+}
+TracingState::TensorEntry* TracingState::findTensor(const at::Tensor& var) {
+  auto impl = var.unsafeGetTensorImpl();
+  for (auto frame = env_stack.rbegin(); frame != env_stack.rend(); ++frame) {
+    auto it = frame->tensors.find(impl);
+    if (it != frame->tensors.end()) {
+      return &it->second;
+    }
+  }
+  return nullptr;
+}
+Value* TracingState::getValue(const at::Tensor& ten) {
+  if (!ten.defined()) {
+    Node* n = graph->createNone();
+    return graph->insertNode(n)->output();
+  }
+  if (TensorEntry* entry = findTensor(ten)) {
+    if (!entry->name_looked_up) {
+      entry->name_looked_up = true;
+      if (!entry->value->hasDebugName()) {
+        auto unique_name = lookup_var_name_fn(ten);
+        if (!unique_name.empty()) {
+          entry->value->setDebugName(unique_name);
+        }
+      }
+    }
+    return entry->value;
+  }
+
+  // Didn't find it. Bake in a constant
+  if (ten.requires_grad()) {
+    pauseTracing();
+    std::ostringstream oss;
+    oss << "Cannot insert a Tensor that requires grad as a constant. "
+        << "Consider making it a parameter or input, or detaching the gradient\n"
+        << "Tensor:\n"
+        << ten;
+    throw std::runtime_error(oss.str());
+  }
+
+  Value* constant = graph->insertConstant(ten);
+  recordSourceLocation(constant->node());
+  constant->inferTypeFrom(ten);
+  env_stack.back().tensors.emplace(
+      ten.unsafeGetTensorImpl(),
+      TensorEntry(WeakTensorImpl(ten.getIntrusivePtr()), constant));
+  return constant;
+}
 Value* TracingState::getValue(const IValue& var) {
   // allow tracing of tuples passed to List[Tensor] or Tuple[Tensor...] arguments
   if (var.isTensorList()) {
@@ -95,7 +144,7 @@ Value* TracingState::getValue(const IValue& var) {
             TensorType::get(),
             fmap(
                 var.toTensorVector(),
-                [&](const IValue& val) { return getValue(val); })))
+                [&](const at::Tensor& val) { return getValue(val); })))
         ->output();
   } else if (var.isTuple()) {
     return graph
@@ -104,45 +153,10 @@ Value* TracingState::getValue(const IValue& var) {
             [&](const IValue& val) { return getValue(val); })))
         ->output();
   } if (var.isTensor()) {
-    auto ten = var.toTensor();
-    if (!ten.defined()) {
-      Node* n = graph->createNone();
-      return graph->insertNode(n)->output();
-    }
-    for (size_t i = 0; i < env_stack.size(); ++i) {
-      auto& value_map = env_stack.at(env_stack.size() - 1 - i);
-      auto it = value_map.find(var);
-      if (it == value_map.end()) {
-        continue;
-      }
-      if (!it->second->hasDebugName()) {
-        auto unique_name = getTracingState()->lookup_var_name_fn(ten);
-        if (!unique_name.empty()) {
-          it->second->setDebugName(unique_name);
-        }
-      }
-      return it->second;
-    }
-
-    // Didn't find it. Bake in a constant
-    if (ten.requires_grad()) {
-      pauseTracing();
-      std::ostringstream oss;
-      oss << "Cannot insert a Tensor that requires grad as a constant. "
-          << "Consider making it a parameter or input, or detaching the gradient\n"
-          << "Tensor:\n"
-          << ten;
-      throw std::runtime_error(oss.str());
-    }
-
-    Value* constant = graph->insertConstant(ten);
-    recordSourceLocation(constant->node());
-    constant->inferTypeFrom(ten);
-    auto it = env_stack.back().emplace(var, constant);
-    return it.first->second;
+    return getValue(var.toTensor());
   } else if (var.isFuture() || var.isObject()) {
     for (size_t i = 0; i < env_stack.size(); ++i) {
-      auto& future_map = env_stack.at(env_stack.size() - 1 - i);
+      auto& future_map = env_stack.at(env_stack.size() - 1 - i).others;
       auto it = future_map.find(var);
       if (it == future_map.end()) {
         continue;
@@ -158,7 +172,7 @@ Value* TracingState::getValue(const IValue& var) {
       if (custom_class_type) {
         auto capsule = var.toObject()->getAttr("capsule");
         for (size_t i = 0; i < env_stack.size(); ++i) {
-          auto& value_map = env_stack.at(env_stack.size() - 1 - i);
+          auto& value_map = env_stack.at(env_stack.size() - 1 - i).others;
           auto it = value_map.find(capsule);
           if (it == value_map.end()) {
             continue;
@@ -193,7 +207,8 @@ Value* TracingState::getValue(const IValue& var) {
 }
 bool TracingState::hasValue(const IValue& var) const {
   for(const auto & frame : env_stack) {
-    if (frame.count(var)) {
+    if (var.isTensor() ? frame.tensors.count(var.unsafeToTensorImpl())
+                       : frame.others.count(var)) {
       return true;
     }
   }
@@ -209,8 +224,8 @@ Value* TracingState::getOutput(const IValue& iv, size_t i) {
        return graph->insertNode(n)->output();
      }
 
-     auto &value_map = getTracingState()->env_stack.back();
-     auto it = value_map.find(iv);
+     auto &value_map = env_stack.back().tensors;
+     auto it = value_map.find(var.unsafeGetTensorImpl());
      if (it == value_map.end()) {
        std::ostringstream os;
        os << "output " << i << " (" << var << ") of traced region did not have observable "
@@ -219,7 +234,7 @@ Value* TracingState::getOutput(const IValue& iv, size_t i) {
           << "cannot be understood by the tracer.";
        throw std::runtime_error(os.str());
      }
-     return it->second;
+     return it->second.value;
   } else if (iv.isTensorList()) {
     return graph
         ->insertNode(graph->createList(
@@ -411,7 +426,16 @@ void TracingState::setValue(const IValue& v, Value* value) {
   if (v.isTensor()) {
     auto var = v.toTensor();
     AT_ASSERT(var.defined());
-    env_stack.back()[v] = value;
+    auto& tensors = env_stack.back().tensors;
+    auto it = tensors.find(var.unsafeGetTensorImpl());
+    if (it == tensors.end()) {
+      tensors.emplace(
+          var.unsafeGetTensorImpl(),
+          TensorEntry(WeakTensorImpl(var.getIntrusivePtr()), value));
+    } else {
+      it->second.value = value;
+      it->second.name_looked_up = false;
+    }
   } else if (v.isTensorList()) {
     auto outputs = v.toTensorList();
     Node* unpack_node =
@@ -434,9 +458,9 @@ void TracingState::setValue(const IValue& v, Value* value) {
     }
   } else if (isCustomClass(v)) {
     auto capsule = v.toObject()->getAttr("capsule");
-    env_stack.back()[capsule] = value;
+    env_stack.back().others[capsule] = value;
   } else if (v.isFuture() || v.isObject()) {
-    env_stack.back()[v] = value;
+    env_stack.back().others[v] = value;
   } else {
     std::ostringstream os;
     os << "Tracer cannot set value trace for type " << v.tagKind() << ". "
@@ -600,10 +624,14 @@ void addInputs(
   if (allow_undefined) {
     // if allow undefined, we create a list of optional tensors
     list_node = g->insertNode(
-        g->createList(OptionalType::ofTensor(), fmap(value, getValueTrace)));
+        g->createList(OptionalType::ofTensor(), fmap(value, [](const at::Tensor& t) {
+          return getValueTrace(t);
+        })));
   } else {
     list_node = g->insertNode(
-        g->createList(TensorType::get(), fmap(value, getValueTrace)));
+        g->createList(TensorType::get(), fmap(value, [](const at::Tensor& t) {
+          return getValueTrace(t);
+        })));
   }
   n->addInput(list_node->output());
 }
@@ -702,7 +730,11 @@ void setTracingState(std::shared_ptr<TracingState> state) {
 }
 
 TracingState::TracingState()
-    : graph(new Graph()), env_stack{Frame()} {}
+    : graph(new Graph()), env_stack{Frame()} {
+  // Sized for the parameters and activations of a large model, so that the
+  // map of the traced function is rarely rehashed
+  env_stack.back().tensors.reserve(4096);
+}
 
 TracingState::~TracingState() = default;
 
@@ -5,6 +5,9 @@
 #include <torch/csrc/WindowsTorchApiMacro.h>
 #include <ATen/core/jit_type.h>
 #include <ATen/core/Dimname.h>
+#include <c10/core/TensorImpl.h>
+#include <c10/core/UndefinedTensorImpl.h>
+#include <c10/util/intrusive_ptr.h>
 
 #include <torch/csrc/jit/script/object.h>
 #include <torch/csrc/utils/variadic.h>
@@ -63,11 +66,28 @@ struct TORCH_API TracingState
   void setValue(const IValue& v, Value* value);
   void delValue(const IValue& var);
   Value* getValue(const IValue& var);
+  Value* getValue(const at::Tensor& var);
   Value* getOutput(const IValue& var, size_t i);
   bool hasValue(const IValue& var) const;
 
 private:
   using WeakIValue = at::WeakIValue;
+  using WeakTensorImpl =
+      c10::weak_intrusive_ptr<c10::TensorImpl, c10::UndefinedTensorImpl>;
+
+  // Tensors are looked up for every input of every traced op, so they are
+  // keyed directly on their TensorImpl, without building an IValue. The weak
+  // reference keeps the address of a dead tensor from being reused by another
+  // one while its entry is in the map.
+  struct TensorEntry {
+    TensorEntry(WeakTensorImpl impl, Value* value)
+        : impl(std::move(impl)), value(value) {}
+    WeakTensorImpl impl;
+    Value* value;
+    // lookup_var_name_fn is called at most once per entry, the first time the
+    // value is used
+    bool name_looked_up = false;
+  };
 
   struct WeakIValueHasher {
     size_t operator()(const WeakIValue& t) const {
@@ -81,9 +101,15 @@ private:
     }
   };
 
-  using Frame = std::unordered_map<WeakIValue, Value*, WeakIValueHasher, WeakIValueEq>;
+  struct Frame {
+    std::unordered_map<c10::TensorImpl*, TensorEntry> tensors;
+    // futures, objects and the capsules of custom classes
+    std::unordered_map<WeakIValue, Value*, WeakIValueHasher, WeakIValueEq> others;
+  };
   std::vector<Frame> env_stack;
 
+  TensorEntry* findTensor(const at::Tensor& var);
+
 };
 
 // This is meant to be used as a thread local place, where we can store extra
@@ -204,6 +230,7 @@ TORCH_API void delValueTrace(const IValue& var);
 TORCH_API std::function<void()> pauseTracing();
 
 TORCH_API Value* getValueTrace(const IValue& var);
+TORCH_API Value* getValueTrace(const at::Tensor& var);
 
 TORCH_API std::pair<std::shared_ptr<TracingState>, Stack> trace(
     Stack inputs,
@@ -8,6 +8,7 @@
 
 #include <ATen/ATen.h>
 
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -514,6 +515,11 @@ static void missing_args(const FunctionSignature& signature, int idx) {
 static ssize_t find_param(FunctionSignature& signature, PyObject* name) {
   ssize_t i = 0;
   for (auto& param : signature.params) {
+    // python_name is interned, as are most keywords, so compare pointers
+    // before comparing strings
+    if (name == param.python_name) {
+      return i;
+    }
     int cmp = PyObject_RichCompareBool(name, param.python_name, Py_EQ);
     if (cmp < 0) {
       throw python_error();
@@ -699,6 +705,43 @@ void PythonArgParser::check_deprecated(const FunctionSignature & signature) {
   }
 }
 
+// Describes the positional arguments in args by what FunctionParameter::check
+// (and the var-args IntArrayRef handling of FunctionSignature::parse) depends
+// on: the type of each argument, plus the dtype, requires_grad, dim() == 0 and
+// numel() == 1 of tensors and the emptiness and first element type of tuples
+// and lists.  Returns false for calls with arguments of other types, because
+// whether those bind to a parameter can depend on their value (e.g. numpy
+// arrays through __index__) or on __torch_function__ (tensor subclasses).
+bool PythonArgParser::make_args_key(PyObject* args, ArgsKey& key) {
+  auto nargs = PyTuple_GET_SIZE(args);
+  if (nargs > kMaxCachedArgs) {
+    return false;
+  }
+  key.nargs = nargs;
+  for (ssize_t i = 0; i < nargs; ++i) {
+    PyObject* obj = PyTuple_GET_ITEM(args, i);
+    uintptr_t aux = 0;
+    if (THPVariable_CheckExact(obj)) {
+      auto& var = reinterpret_cast<THPVariable*>(obj)->cdata;
+      aux = static_cast<uintptr_t>(var.scalar_type()) << 3 |
+          (var.requires_grad() ? 4 : 0) | (var.dim() == 0 ? 2 : 0) |
+          (var.numel() == 1 ? 1 : 0);
+    } else if (PyTuple_CheckExact(obj) || PyList_CheckExact(obj)) {
+      auto size = PySequence_Fast_GET_SIZE(obj);
+      aux = size == 0 ? 1 : reinterpret_cast<uintptr_t>(
+          Py_TYPE(PySequence_Fast_GET_ITEM(obj, 0)));
+    } else if (!(obj == Py_None || PyBool_Check(obj) ||
+                 PyLong_CheckExact(obj) || PyFloat_CheckExact(obj) ||
+                 PyComplex_CheckExact(obj) || THPUtils_checkString(obj) ||
+                 THPDtype_Check(obj) || THPLayout_Check(obj) ||
+                 THPDevice_Check(obj) || THPMemoryFormat_Check(obj))) {
+      return false;
+    }
+    key.args[i] = {reinterpret_cast<uintptr_t>(Py_TYPE(obj)), aux};
+  }
+  return true;
+}
+
 PythonArgs PythonArgParser::raw_parse(PyObject* args, PyObject* kwargs, PyObject* parsed_args[]) {
   if (signatures_.size() == 1) {
     auto& signature = signatures_[0];
@@ -707,8 +750,33 @@ PythonArgs PythonArgParser::raw_parse(PyObject* args, PyObject* kwargs, PyObject
     return PythonArgs(traceable, signature, parsed_args);
   }
 
-  for (auto& signature : signatures_) {
+  ArgsKey key;
+  const bool cacheable =
+      (!kwargs || PyDict_Size(kwargs) == 0) && make_args_key(args, key);
+  if (cacheable) {
+    for (const auto& cached : cached_matches_) {
+      if (cached.key.nargs == key.nargs &&
+          std::equal(key.args.begin(), key.args.begin() + key.nargs,
+                     cached.key.args.begin())) {
+        auto& signature = signatures_[cached.signature];
+        if (signature.parse(args, kwargs, parsed_args, false)) {
+          check_deprecated(signature);
+          return PythonArgs(traceable, signature, parsed_args);
+        }
+        break;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < signatures_.size(); ++i) {
+    auto& signature = signatures_[i];
     if (signature.parse(args, kwargs, parsed_args, false)) {
+      if (cacheable) {
+        auto& cached = cached_matches_[next_cached_match_];
+        cached.key = key;
+        cached.signature = i;
+        next_cached_match_ = (next_cached_match_ + 1) % kNumCachedMatches;
+      }
       check_deprecated(signature);
       return PythonArgs(traceable, signature, parsed_args);
     }
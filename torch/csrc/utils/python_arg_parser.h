@@ -67,9 +67,11 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace torch {
@@ -107,6 +109,26 @@ private:
   void check_deprecated(const FunctionSignature & signature);
   PythonArgs raw_parse(PyObject* args, PyObject* kwargs, PyObject* parsed_args[]);
 
+  // Calls with only positional arguments whose types (plus, for tensors and
+  // sequences, the few properties that FunctionParameter::check looks at)
+  // match an earlier call bind to the same signature, so raw_parse remembers
+  // the signature matched by the last few such calls and tries it first
+  // instead of trying every signature in order.  All of this runs under the
+  // GIL, which also protects the cache.
+  static constexpr int kMaxCachedArgs = 6;
+  static constexpr int kNumCachedMatches = 4;
+  struct ArgsKey {
+    int nargs = -1;
+    std::array<std::pair<uintptr_t, uintptr_t>, kMaxCachedArgs> args;
+  };
+  struct CachedMatch {
+    ArgsKey key;
+    size_t signature = 0;
+  };
+  static bool make_args_key(PyObject* args, ArgsKey& key);
+  std::array<CachedMatch, kNumCachedMatches> cached_matches_;
+  int next_cached_match_ = 0;
+
   std::vector<FunctionSignature> signatures_;
   std::string function_name;
   ssize_t max_args;
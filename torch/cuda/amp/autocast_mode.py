@@ -0,0 +1,67 @@
+import torch
+from torch.autograd.grad_mode import _DecoratorContextManager
+
+
+class autocast(_DecoratorContextManager):
+    r"""Context-manager that enables automatic mixed precision for CUDA ops.
+
+    Inside an autocast region, ops that are fast and numerically safe in
+    reduced precision, such as matrix multiplies, convolutions and
+    :func:`torch.nn.functional.linear`, cast their CUDA floating point inputs
+    to ``dtype`` and run in it. Ops that need the range of float, such as
+    softmax, layer and group norm and the loss functions, cast their inputs to
+    ``float32``. Every other op runs in the dtype of its inputs. ``float64``
+    tensors and CPU tensors are never cast.
+
+    The reduced precision copies of the parameters of a model (leaf tensors
+    that require grad) are cached while inside the outermost autocast region,
+    so a weight used several times in the forward pass is only cast once. The
+    cache is dropped on exit, and an in-place update of a weight invalidates
+    its copy.
+
+    Only the forward pass should run under autocast. The backward pass runs
+    the ops in the dtypes chosen during the forward pass.
+
+    This context manager is thread local; it will not affect computation
+    in other threads.
+
+    Also functions as a decorator.
+
+    Arguments:
+        enabled (bool, optional): whether autocasting is enabled in the region.
+            Default: ``True``.
+        dtype (torch.dtype, optional): the reduced precision dtype,
+            ``torch.float16`` or ``torch.bfloat16``. Default: ``torch.float16``.
+
+    Example::
+
+        >>> model = Net().cuda()
+        >>> for input, target in data:
+        ...     optimizer.zero_grad()
+        ...     with torch.cuda.amp.autocast():
+        ...         output = model(input)
+        ...         loss = loss_fn(output, target)
+        ...     loss.backward()
+        ...     optimizer.step()
+    """
+    def __init__(self, enabled=True, dtype=torch.float16):
+        if enabled and not torch.cuda.is_available():
+            raise RuntimeError("torch.cuda.amp.autocast requires CUDA")
+        self._enabled = enabled
+        self._dtype = dtype
+
+    def __enter__(self):
+        self.prev = torch.is_autocast_enabled()
+        self.prev_dtype = torch.get_autocast_dtype()
+        torch.set_autocast_enabled(self._enabled)
+        torch.set_autocast_dtype(self._dtype)
+        torch.autocast_increment_nesting()
+
+    def __exit__(self, *args):
+        # Drop the cached casts when leaving the outermost region, so they
+        # don't outlive the iteration that made them.
+        if torch.autocast_decrement_nesting() == 0:
+            torch.clear_autocast_cache()
+        torch.set_autocast_enabled(self.prev)
+        torch.set_autocast_dtype(self.prev_dtype)
+        return False
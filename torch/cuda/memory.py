@@ -3,7 +3,7 @@ import contextlib
 import warnings
 
 import torch
-from . import is_initialized, _get_device_index
+from . import is_initialized, _get_device_index, _lazy_init
 
 
 def _host_allocator():
@@ -84,6 +84,9 @@ def memory_stats(device=None):
     - ``"num_alloc_retries"``: number of failed ``cudaMalloc`` calls that
       result in a cache flush and retry.
     - ``"num_ooms"``: number of out-of-memory errors thrown.
+    - ``"num_cache_flushes"``: number of times cached blocks were released
+      back to CUDA, either by :func:`~torch.cuda.empty_cache` or by a
+      ``cudaMalloc`` retry.
 
     Arguments:
         device (torch.device or int, optional): selected device. Returns
@@ -123,7 +126,7 @@ def reset_accumulated_memory_stats(device=None):
 
     See :func:`~torch.cuda.memory_stats` for details. Accumulated stats correspond to
     the `"allocated"` and `"freed"` keys in each individual stat dict, as well as
-    `"num_alloc_retries"` and `"num_ooms"`.
+    `"num_alloc_retries"`, `"num_ooms"` and `"num_cache_flushes"`.
 
     Arguments:
         device (torch.device or int, optional): selected device. Returns
@@ -309,6 +312,15 @@ def memory_snapshot():
     Interpreting the output of this function requires familiarity with the
     memory allocator internals.
 
+    The result is a list with one dict per segment (one ``cudaMalloc``
+    allocation), sorted by device and address. Each segment reports its
+    ``"device"``, ``"address"``, allocation ``"stream"``, ``"segment_type"``
+    (``"large"`` or ``"small"``), and its ``"total_size"``,
+    ``"allocated_size"`` and ``"active_size"`` in bytes. ``"blocks"`` lists
+    the blocks the segment is currently split into, in address order, each
+    with its ``"size"``, ``"stream"`` and ``"state"`` (one of
+    ``"active_allocated"``, ``"active_pending_free"`` or ``"inactive"``).
+
     .. note::
         See :ref:`cuda-memory-management` for more details about GPU memory
         management.
@@ -316,6 +328,41 @@ def memory_snapshot():
     return torch._C._cuda_memorySnapshot()
 
 
+def host_memory_stats():
+    r"""Returns a dictionary of statistics of the caching allocator for pinned
+    (page-locked) host memory, which backs :meth:`~torch.Tensor.pin_memory`.
+
+    - ``"num_hits"``: number of allocations served from the cache.
+    - ``"num_misses"``: number of allocations that called ``cudaHostAlloc``.
+    - ``"allocated_bytes"``: bytes of pinned memory currently handed out.
+    - ``"reserved_bytes"``: bytes of pinned memory held by the allocator,
+      both allocated and cached.
+    - ``"peak_reserved_bytes"``: maximum value of ``"reserved_bytes"``.
+    - ``"num_events_created"``: number of CUDA events created to track
+      stream uses of pinned memory. Events are reused once the tracked work
+      completes.
+    """
+    return torch._C._cuda_hostMemoryStats()
+
+
+def reserve_host_memory(size, count=1):
+    r"""Allocates :attr:`count` pinned host memory blocks of :attr:`size`
+    bytes and adds them to the pinned memory cache.
+
+    Allocating pinned memory is slow, so a job that pins batches of a known
+    size (e.g. a :class:`~torch.utils.data.DataLoader` with
+    ``pin_memory=True``) can call this once at startup instead of paying
+    for ``cudaHostAlloc`` during its first iterations. Each cached block
+    serves one allocation of at most :attr:`size` bytes at a time.
+
+    Arguments:
+        size (int): size of each block in bytes.
+        count (int, optional): number of blocks to reserve (default: 1).
+    """
+    _lazy_init()
+    torch._C._cuda_reserveHostMemory(size, count)
+
+
 def memory_summary(device=None, abbreviated=False):
     r"""Returns a human-readable printout of the current memory allocator
     statistics for a given device.
@@ -375,6 +422,7 @@ def memory_summary(device=None, abbreviated=False):
     lines.append(" {_:16} PyTorch CUDA memory summary, device ID {device:<17d} ")
     lines.append("-" * 75)
     lines.append("  {_:9} CUDA OOMs: {num_ooms:<12d} | {_:6} cudaMalloc retries: {num_alloc_retries:<8d}  ")
+    lines.append("  {_:5} Cache flushes: {num_cache_flushes:<12d} | {_:36} ")
     lines.append("=" * 75)
     lines.append("        Metric         | Cur Usage  | Peak Usage | Tot Alloc  | Tot Freed  ")
 
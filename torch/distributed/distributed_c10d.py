@@ -8,6 +8,7 @@ from datetime import timedelta
 
 from .rendezvous import rendezvous, register_rendezvous_handler  # noqa: F401
 from . import (
+    AllToAllOptions,
     AllreduceOptions,
     AllreduceCoalescedOptions,
     BroadcastOptions,
@@ -1465,6 +1466,100 @@ def reduce_scatter(output,
         work.wait()
 
 
+def all_to_all_single(output,
+                      input,
+                      output_split_sizes=None,
+                      input_split_sizes=None,
+                      group=group.WORLD,
+                      async_op=False):
+    """
+    Splits ``input`` along its first dimension, sends split ``i`` to rank
+    ``i``, and concatenates the splits received from all ranks into
+    ``output``. Only gloo (CPU tensors) and nccl (NCCL 2.7+) backends are
+    currently supported.
+
+    Arguments:
+        output (Tensor): Output tensor.
+        input (Tensor): Input tensor to scatter.
+        output_split_sizes (list[Int], optional): Sizes along dimension 0 of
+            the splits received from each rank. If ``None`` or empty,
+            ``output`` is split equally by the world size.
+        input_split_sizes (list[Int], optional): Sizes along dimension 0 of
+            the splits sent to each rank. If ``None`` or empty, ``input`` is
+            split equally by the world size.
+        group (ProcessGroup, optional): The process group to work on.
+        async_op (bool, optional): Whether this op should be an async op.
+
+    Returns:
+        Async work handle, if async_op is set to True.
+        None, if not async_op or if not part of the group.
+
+    """
+    _check_single_tensor(output, "output")
+    _check_single_tensor(input, "input")
+    if _rank_not_in_group(group):
+        return
+
+    opts = AllToAllOptions()
+    output_split_sizes = [] if output_split_sizes is None else output_split_sizes
+    input_split_sizes = [] if input_split_sizes is None else input_split_sizes
+
+    if group == GroupMember.WORLD:
+        _check_default_pg()
+        work = _default_pg.alltoall_base(
+            output, input, output_split_sizes, input_split_sizes, opts)
+    else:
+        work = group.alltoall_base(
+            output, input, output_split_sizes, input_split_sizes, opts)
+
+    if async_op:
+        return work
+    else:
+        work.wait()
+
+
+def all_to_all(output_tensor_list,
+               input_tensor_list,
+               group=group.WORLD,
+               async_op=False):
+    """
+    Sends ``input_tensor_list[i]`` to rank ``i``, and receives
+    ``output_tensor_list[i]`` from rank ``i``. The tensors sent to and
+    received from different ranks can have different sizes. Only gloo (CPU
+    tensors) and nccl (NCCL 2.7+) backends are currently supported.
+
+    Arguments:
+        output_tensor_list (list[Tensor]): List of tensors to receive into,
+            one per rank.
+        input_tensor_list (list[Tensor]): List of tensors to send, one per
+            rank.
+        group (ProcessGroup, optional): The process group to work on.
+        async_op (bool, optional): Whether this op should be an async op.
+
+    Returns:
+        Async work handle, if async_op is set to True.
+        None, if not async_op or if not part of the group.
+
+    """
+    _check_tensor_list(output_tensor_list, "output_tensor_list")
+    _check_tensor_list(input_tensor_list, "input_tensor_list")
+    if _rank_not_in_group(group):
+        return
+
+    opts = AllToAllOptions()
+
+    if group == GroupMember.WORLD:
+        _check_default_pg()
+        work = _default_pg.alltoall(output_tensor_list, input_tensor_list, opts)
+    else:
+        work = group.alltoall(output_tensor_list, input_tensor_list, opts)
+
+    if async_op:
+        return work
+    else:
+        work.wait()
+
+
 def barrier(group=group.WORLD,
             async_op=False):
     """
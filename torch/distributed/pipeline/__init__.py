@@ -0,0 +1,7 @@
+"""
+:mod:`torch.distributed.pipeline` exposes Pipeline, which takes a list of
+remote stage modules (:class:`~torch.distributed.rpc.RRef`) and streams
+micro-batches through them, so that the workers owning consecutive stages
+compute on different micro-batches at the same time.
+"""
+from .pipeline import Pipeline
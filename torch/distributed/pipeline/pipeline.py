@@ -0,0 +1,231 @@
+import threading
+
+import torch
+import torch.distributed.rpc as rpc
+import torch.distributed.autograd as dist_autograd
+from torch.distributed.optim.optimizer import _wait_for_all
+
+
+# Gradients of concurrent micro-batches are accumulated into the same
+# parameters, so we serialize the accumulation on each worker.
+_grad_lock = threading.Lock()
+
+
+def _stage_forward(stage_rref, input, return_rref):
+    # The input of every stage but the first is an RRef owned by the previous
+    # stage, so activations travel directly from one stage to the next. The
+    # fetch runs in the autograd context of the micro-batch, which records the
+    # send/recv functions used by the backward pass.
+    if isinstance(input, rpc.RRef):
+        input = input.to_here()
+    output = stage_rref.local_value()(input)
+    return rpc.RRef(output) if return_rref else output
+
+
+def _stage_accumulate_grads(stage_rref, autograd_ctx_id):
+    grads = dist_autograd.get_gradients(autograd_ctx_id)
+    with _grad_lock:
+        for param in stage_rref.local_value().parameters():
+            grad = grads.get(param)
+            if grad is None:
+                continue
+            if param.grad is None:
+                param.grad = grad
+            else:
+                param.grad.add_(grad)
+
+
+def _stage_zero_grad(stage_rref):
+    with _grad_lock:
+        for param in stage_rref.local_value().parameters():
+            param.grad = None
+
+
+class Pipeline:
+    """
+    Pipeline takes remote references to the stages of a model, splits each
+    batch into micro-batches along the first dimension and streams the
+    micro-batches through the stages.
+
+    The forward pass of a micro-batch is a chain of RPCs, one to the owner of
+    each stage. Every stage keeps its output in an RRef that the next stage
+    fetches directly, so activations never go through the caller, and since
+    several micro-batches are in flight at once, the owner of a stage computes
+    one micro-batch while the activations of another are being sent.
+
+    Each micro-batch runs its forward and backward passes in its own
+    distributed autograd :class:`~torch.distributed.autograd.context`. Once
+    the backward pass of a micro-batch is done, its gradients are added to the
+    ``grad`` of the stage parameters on the workers owning them and the
+    context is released. The gradients of a batch are therefore the sum of the
+    gradients of its micro-batches, ready for any local optimizer to apply on
+    the stage owners.
+
+    Two schedules are supported:
+
+    * ``"gpipe"``: the forward pass of every micro-batch runs before any
+      backward pass starts. All the activations of the batch are alive at the
+      same time.
+    * ``"1f1b"``: at most ``len(stages)`` micro-batches are in flight; the
+      next micro-batch is only admitted once the backward pass of an earlier
+      one is done. This bounds the activations kept alive by the number of
+      stages and lets the backward passes of early micro-batches overlap with
+      the forward passes of later ones.
+
+    Each in-flight micro-batch can hold an RPC thread on the stage owners
+    while it fetches its input, so the agents should be configured with more
+    send/recv threads than the number of micro-batches in flight.
+
+    Args:
+        stages (list[RRef]): RRefs to the stage modules, in execution order.
+            Each module is called with the output of the previous one.
+        chunks (int): number of micro-batches a batch is split into.
+        schedule (str): ``"1f1b"`` (default) or ``"gpipe"``.
+
+    Example::
+
+        >> import torch.distributed.rpc as rpc
+        >> from torch.distributed.pipeline import Pipeline
+        >>
+        >> stage1 = rpc.remote("worker1", torch.nn.Linear, args=(16, 16))
+        >> stage2 = rpc.remote("worker2", torch.nn.Linear, args=(16, 4))
+        >> pipe = Pipeline([stage1, stage2], chunks=8)
+        >>
+        >> losses = pipe.train_step(inputs, targets, torch.nn.MSELoss())
+    """
+    def __init__(self, stages, chunks, schedule="1f1b"):
+        if len(stages) == 0:
+            raise ValueError("Pipeline requires at least one stage.")
+        if chunks < 1:
+            raise ValueError(
+                "chunks should be a positive integer, but got {}".format(chunks))
+        if schedule not in ("1f1b", "gpipe"):
+            raise ValueError(
+                "Unknown pipeline schedule '{}', expected '1f1b' or "
+                "'gpipe'".format(schedule))
+        self.stages = list(stages)
+        self.chunks = chunks
+        self.schedule = schedule
+
+    def _forward_micro_batch(self, input):
+        value = input
+        for stage in self.stages[:-1]:
+            value = rpc.rpc_sync(
+                stage.owner(), _stage_forward, args=(stage, value, True))
+        last = self.stages[-1]
+        return rpc.rpc_sync(
+            last.owner(), _stage_forward, args=(last, value, False))
+
+    def _accumulate_grads(self, autograd_ctx_id):
+        rpc_futs = []
+        for stage in self.stages:
+            rpc_futs.append(rpc.rpc_async(
+                stage.owner(),
+                _stage_accumulate_grads,
+                args=(stage, autograd_ctx_id),
+            ))
+        _wait_for_all(rpc_futs)
+
+    def _run(self, num_micro_batches, max_in_flight, fn):
+        # One thread per micro-batch, as the distributed autograd context is
+        # per thread. Micro-batches are admitted in order.
+        admission = threading.Semaphore(max_in_flight)
+        errors = [None] * num_micro_batches
+
+        def run_micro_batch(index):
+            try:
+                fn(index)
+            except Exception as e:
+                errors[index] = e
+            finally:
+                admission.release()
+
+        threads = []
+        for index in range(num_micro_batches):
+            admission.acquire()
+            thread = threading.Thread(target=run_micro_batch, args=(index,))
+            thread.start()
+            threads.append(thread)
+        for thread in threads:
+            thread.join()
+
+        # Report the error of the earliest micro-batch, other micro-batches
+        # might only have failed because of it.
+        for error in errors:
+            if error is not None and not isinstance(
+                    error, threading.BrokenBarrierError):
+                raise error
+        for error in errors:
+            if error is not None:
+                raise error
+
+    def forward(self, input):
+        """
+        Runs the forward pass of ``input`` through the stages, micro-batch by
+        micro-batch, and returns the outputs of the last stage concatenated
+        along the first dimension. No gradients are recorded.
+        """
+        micro_batches = input.chunk(self.chunks)
+        outputs = [None] * len(micro_batches)
+
+        def forward(index):
+            outputs[index] = self._forward_micro_batch(micro_batches[index])
+
+        self._run(len(micro_batches), len(self.stages), forward)
+        return torch.cat(outputs)
+
+    def train_step(self, input, target, loss_fn):
+        """
+        Runs the forward and backward passes of a batch and accumulates the
+        gradients of the stage parameters on the workers owning them.
+
+        ``input`` and ``target`` are split into micro-batches along the first
+        dimension; ``loss_fn(output, target)`` is computed on the caller for
+        every micro-batch and must return a scalar. This blocks until the
+        gradients of all the micro-batches have been accumulated and returns
+        the list of (detached) micro-batch losses.
+        """
+        micro_batches = input.chunk(self.chunks)
+        micro_targets = target.chunk(self.chunks)
+        if len(micro_batches) != len(micro_targets):
+            raise ValueError(
+                "input and target should have the same size in their first "
+                "dimension, but got {} and {}".format(
+                    input.size(0), target.size(0)))
+        num_micro_batches = len(micro_batches)
+        losses = [None] * num_micro_batches
+
+        if self.schedule == "gpipe":
+            max_in_flight = num_micro_batches
+            barrier = threading.Barrier(num_micro_batches)
+        else:
+            max_in_flight = len(self.stages)
+            barrier = None
+
+        def train(index):
+            try:
+                with dist_autograd.context() as context_id:
+                    output = self._forward_micro_batch(micro_batches[index])
+                    loss = loss_fn(output, micro_targets[index])
+                    if barrier is not None:
+                        barrier.wait()
+                    dist_autograd.backward([loss])
+                    self._accumulate_grads(context_id)
+                    losses[index] = loss.detach()
+            except Exception:
+                if barrier is not None:
+                    barrier.abort()
+                raise
+
+        self._run(num_micro_batches, max_in_flight, train)
+        return losses
+
+    def zero_grad(self):
+        """
+        Clears the gradients of the parameters of all the stages.
+        """
+        rpc_futs = []
+        for stage in self.stages:
+            rpc_futs.append(rpc.rpc_async(
+                stage.owner(), _stage_zero_grad, args=(stage,)))
+        _wait_for_all(rpc_futs)
@@ -79,6 +79,8 @@ def _process_group_construct_rpc_backend_options_handler(
     rpc_timeout,
     init_method,
     num_send_recv_threads=rpc_constants.DEFAULT_NUM_SEND_RECV_THREADS,
+    coalesce_window=rpc_constants.DEFAULT_COALESCE_WINDOW,
+    coalesce_max_bytes=rpc_constants.DEFAULT_COALESCE_MAX_BYTES,
     **kwargs
 ):
     from . import ProcessGroupRpcBackendOptions
@@ -87,14 +89,12 @@ def _process_group_construct_rpc_backend_options_handler(
     rpc_backend_options.rpc_timeout = rpc_timeout
     rpc_backend_options.init_method = init_method
     rpc_backend_options.num_send_recv_threads = num_send_recv_threads
+    rpc_backend_options.coalesce_window = coalesce_window
+    rpc_backend_options.coalesce_max_bytes = coalesce_max_bytes
     return rpc_backend_options
 
 
-def _process_group_init_backend_handler(
-    store, name, rank, world_size, rpc_backend_options
-):
-    from . import ProcessGroupAgent
-
+def _init_process_group(store, rank, world_size):
     # Initialize ProcessGroup.
     if dist.is_initialized():
         raise RuntimeError(
@@ -119,12 +119,27 @@ def _process_group_init_backend_handler(
                     world_size, group.size()
                 )
             )
+        return group
+    except Exception as ex:
+        dist.destroy_process_group()
+        raise ex
+
+
+def _process_group_init_backend_handler(
+    store, name, rank, world_size, rpc_backend_options
+):
+    from . import ProcessGroupAgent
+
+    group = _init_process_group(store, rank, world_size)
+    try:
         # TODO: add try-except and destroy _agent in all processes if any fails.
         return ProcessGroupAgent(
             name,
             group,
             rpc_backend_options.num_send_recv_threads,
             rpc_backend_options.rpc_timeout,
+            rpc_backend_options.coalesce_window,
+            rpc_backend_options.coalesce_max_bytes,
         )
     except Exception as ex:
         dist.destroy_process_group()
@@ -136,3 +151,53 @@ register_backend(
     _process_group_construct_rpc_backend_options_handler,
     _process_group_init_backend_handler,
 )
+
+
+def _socket_construct_rpc_backend_options_handler(
+    rpc_timeout,
+    init_method,
+    num_send_recv_threads=rpc_constants.DEFAULT_NUM_SEND_RECV_THREADS,
+    coalesce_window=rpc_constants.DEFAULT_COALESCE_WINDOW,
+    coalesce_max_bytes=rpc_constants.DEFAULT_COALESCE_MAX_BYTES,
+    num_io_threads=rpc_constants.DEFAULT_NUM_IO_THREADS,
+    **kwargs
+):
+    from . import SocketRpcBackendOptions
+
+    rpc_backend_options = SocketRpcBackendOptions()
+    rpc_backend_options.rpc_timeout = rpc_timeout
+    rpc_backend_options.init_method = init_method
+    rpc_backend_options.num_send_recv_threads = num_send_recv_threads
+    rpc_backend_options.coalesce_window = coalesce_window
+    rpc_backend_options.coalesce_max_bytes = coalesce_max_bytes
+    rpc_backend_options.num_io_threads = num_io_threads
+    return rpc_backend_options
+
+
+def _socket_init_backend_handler(store, name, rank, world_size, rpc_backend_options):
+    from . import SocketAgent
+
+    # The ProcessGroup only resolves names and detects termination, messages
+    # are sent over the connections of the SocketAgent.
+    group = _init_process_group(store, rank, world_size)
+    try:
+        return SocketAgent(
+            name,
+            group,
+            store,
+            rpc_backend_options.num_send_recv_threads,
+            rpc_backend_options.num_io_threads,
+            rpc_backend_options.rpc_timeout,
+            rpc_backend_options.coalesce_window,
+            rpc_backend_options.coalesce_max_bytes,
+        )
+    except Exception as ex:
+        dist.destroy_process_group()
+        raise ex
+
+
+register_backend(
+    "SOCKET",
+    _socket_construct_rpc_backend_options_handler,
+    _socket_init_backend_handler,
+)
@@ -8,3 +8,10 @@ DEFAULT_INIT_METHOD = "env://"
 
 # For ProcessGroupAgent.
 DEFAULT_NUM_SEND_RECV_THREADS = 4
+# Coalescing of small messages is disabled by default.
+DEFAULT_COALESCE_WINDOW = timedelta(0)
+DEFAULT_COALESCE_MAX_BYTES = 64 * 1024
+
+
+# For SocketAgent.
+DEFAULT_NUM_IO_THREADS = 4
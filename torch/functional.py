@@ -11,6 +11,7 @@ __all__ = [
     'broadcast_tensors',
     'cartesian_prod',
     'cdist',
+    'cdist_topk',
     'chain_matmul',
     'einsum',
     'lu',
@@ -398,8 +399,8 @@ def unique(input, sorted=True, return_inverse=False, return_counts=False, dim=No
     .. note:: This function is different from :func:`torch.unique_consecutive` in the sense that
         this function also eliminates non-consecutive duplicate values.
 
-    .. note:: Currently in the CUDA implementation and the CPU implementation when dim is specified,
-        `torch.unique` always sort the tensor at the beginning regardless of the `sort` argument.
+    .. note:: Currently when dim is specified, and in the CUDA implementation with ``sorted=True``,
+        `torch.unique` always sort the tensor at the beginning.
         Sorting could be slow, so if your input tensor is already sorted, it is recommended to use
         :func:`torch.unique_consecutive` which avoids the sorting.
 
@@ -690,6 +691,53 @@ def cdist(x1, x2, p=2, compute_mode='use_mm_for_euclid_dist_if_necessary'):
         raise ValueError("{} is not a valid value for compute_mode".format(compute_mode))
 
 
+def cdist_topk(x1, x2, k, p=2, compute_mode='use_mm_for_euclid_dist_if_necessary'):
+    r"""Returns the :attr:`k` smallest p-norm distances from each row vector of :attr:`x1`
+    to the row vectors of :attr:`x2`, and their indices in :attr:`x2`.
+
+    This is equivalent to ``torch.cdist(x1, x2, p).topk(k, largest=False)``, but the
+    distances are computed tile by tile and never held for all pairs at once, so it
+    can be used for k-nearest-neighbour queries over point sets whose full distance
+    matrix does not fit in memory. The returned distances are sorted in ascending order.
+
+    Args:
+        x1 (Tensor): input tensor of shape :math:`P \times M`.
+        x2 (Tensor): input tensor of shape :math:`R \times M`.
+        k (int): the number of neighbours to return, at most :math:`R`.
+        p: p value for the p-norm distance to calculate between each vector pair
+            :math:`\in [0, \infty]`.
+        compute_mode: same as in :func:`torch.cdist`. With the matrix multiplication
+            approach the neighbours are ranked with matrix multiplication and their
+            distances are then computed directly, so they stay accurate for close pairs.
+            Default: use_mm_for_euclid_dist_if_necessary.
+
+    Returns a namedtuple ``(values, indices)`` of two tensors of shape :math:`P \times k`.
+
+    Example:
+
+        >>> a = torch.tensor([[0.9041,  0.0196], [-0.3108, -2.4423], [-0.4821,  1.059]])
+        >>> b = torch.tensor([[-2.1763, -0.4713], [-0.6986,  1.3702], [0.2,  0.1]])
+        >>> torch.cdist_topk(a, b, 2)
+        torch.return_types.cdist_topk(
+        values=tensor([[0.7087, 2.0959],
+                [2.5931, 2.7138],
+                [0.3791, 1.1768]]),
+        indices=tensor([[2, 1],
+                [2, 0],
+                [1, 2]]))
+    """
+    if (type(x1) is not Tensor or type(x2) is not Tensor) and has_torch_function((x1, x2)):
+        return handle_torch_function(cdist_topk, (x1, x2), x1, x2, k, p=p, compute_mode=compute_mode)
+    if compute_mode == 'use_mm_for_euclid_dist_if_necessary':
+        return torch._C._VariableFunctions.cdist_topk(x1, x2, k, p, None)
+    elif compute_mode == 'use_mm_for_euclid_dist':
+        return torch._C._VariableFunctions.cdist_topk(x1, x2, k, p, 1)
+    elif compute_mode == 'donot_use_mm_for_euclid_dist':
+        return torch._C._VariableFunctions.cdist_topk(x1, x2, k, p, 2)
+    else:
+        raise ValueError("{} is not a valid value for compute_mode".format(compute_mode))
+
+
 def norm(input, p="fro", dim=None, keepdim=False, out=None, dtype=None):
     r"""Returns the matrix norm or vector norm of a given tensor.
 
@@ -152,7 +152,7 @@ def save(m, f, _extra_files=DEFAULT_EXTRA_FILES_MAP):
         ret = m.save_to_buffer(_extra_files=_extra_files)
         f.write(ret)
 
-def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
+def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP, mmap=False):
     r"""
         Load a :class:`ScriptModule` or :class:`ScriptFunction` previously
         saved with :func:`torch.jit.save <torch.jit.save>`
@@ -169,6 +169,10 @@ def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
             _extra_files (dictionary of filename to content): The extra
                 filenames given in the map would be loaded and their content
                 would be stored in the provided map.
+            mmap (bool): Memory map the file instead of reading it. Tensors are
+                then backed by the mapped file, and their data only read from
+                disk when they are first used. Only files saved by
+                :func:`torch.jit.save` can be mapped, not file-like objects.
 
         Returns:
             A :class:`ScriptModule` object.
@@ -203,6 +207,9 @@ def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
             torch.jit.load('scriptmodule.pt', _extra_files=extra_files)
             print(extra_files['foo.txt'])
 
+            # Load with tensors backed by the mapped file
+            torch.jit.load('scriptmodule.pt', mmap=True)
+
         .. testoutput::
             :hide:
 
@@ -231,7 +238,12 @@ def load(f, map_location=None, _extra_files=DEFAULT_EXTRA_FILES_MAP):
     if isinstance(f, str) or \
             (sys.version_info[0] == 2 and isinstance(f, unicode)) or \
             (sys.version_info[0] == 3 and isinstance(f, pathlib.Path)):
-        cpp_module = torch._C.import_ir_module(cu, f, map_location, _extra_files)
+        if mmap:
+            cpp_module = torch._C.import_ir_module_mmap(cu, str(f), map_location, _extra_files)
+        else:
+            cpp_module = torch._C.import_ir_module(cu, f, map_location, _extra_files)
+    elif mmap:
+        raise ValueError("mmap=True requires a file name, but got a file-like object")
     else:
         cpp_module = torch._C.import_ir_module_from_buffer(cu, f.read(), map_location, _extra_files)
 
@@ -17,6 +17,15 @@
 #define ENABLE_NCCL_ERROR_CHECKING
 #endif
 
+// Point-to-point communication (ncclSend and ncclRecv) is supported only for
+// NCCL versions 2.7+.
+#if defined(NCCL_MAJOR) && (NCCL_MAJOR == 2) && defined(NCCL_MINOR) && \
+    (NCCL_MINOR >= 7)
+#define ENABLE_NCCL_P2P_SUPPORT
+#elif defined(NCCL_MAJOR) && (NCCL_MAJOR >= 3)
+#define ENABLE_NCCL_P2P_SUPPORT
+#endif
+
 // Macro to throw on a non-successful NCCL return value.
 #define C10D_NCCL_CHECK(cmd)                                                 \
   do {                                                                       \
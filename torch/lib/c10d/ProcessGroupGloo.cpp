@@ -2,11 +2,18 @@
 
 #include <c10d/GlooDeviceFactory.hpp>
 
+#include <fcntl.h>
 #include <netdb.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <system_error>
 #include <type_traits>
 
 #include <gloo/allgather.h>
@@ -382,7 +389,9 @@ void ProcessGroupGloo::RecvWork::abort() {
 }
 
 ProcessGroupGloo::Options::Options()
-    : timeout(std::chrono::milliseconds(10 * 1000)), threads(2) {}
+    : timeout(std::chrono::milliseconds(10 * 1000)),
+      threads(2),
+      hierarchicalAllreduce(false) {}
 
 namespace {
 
@@ -527,6 +536,10 @@ ProcessGroupGloo::ProcessGroupGloo(
     contexts_.push_back(std::move(context));
   }
 
+  if (options.hierarchicalAllreduce) {
+    initHierarchicalAllreduce(rank, size, options);
+  }
+
   // Every worker thread stores the AsyncWork object it's currently
   // working on in the workInProgress_ vector. It must have size equal
   // to the number of workers such that they can simply index into it
@@ -1106,6 +1119,11 @@ class AsyncSparseAllreduceWork : public ProcessGroupGloo::AsyncWork {
 
 #ifdef USE_CUDA
 
+// Dense CUDA tensors are allreduced in chunks of this many bytes, so that
+// the copies of a chunk to and from the pinned host tensors overlap with the
+// allreduce of the other chunks.
+constexpr int64_t kAllreduceCUDAChunkBytes = 4 * 1024 * 1024;
+
 class AsyncAllreduceCUDAWork : public AsyncAllreduceWork {
  public:
   AsyncAllreduceCUDAWork(
@@ -1116,35 +1134,76 @@ class AsyncAllreduceCUDAWork : public AsyncAllreduceWork {
       : AsyncAllreduceWork(context, inputs, reduceOp, tag) {
     initializeStreamsEvents(inputs, streams, events);
 
+    // The number of chunks only depends on the size of the tensors, so that
+    // all processes run the same number of allreduces.
+    const auto numel = inputs[0].numel();
+    chunkSize = std::max<int64_t>(
+        1, kAllreduceCUDAChunkBytes / inputs[0].element_size());
+    numChunks = std::max<int64_t>(1, (numel + chunkSize - 1) / chunkSize);
+
+    // The chunks are ranges of the memory of the tensors, which can only be
+    // copied separately if the tensors are dense. Otherwise they are copied
+    // at once, before the first chunk is allreduced and after the last one.
+    pipelined = numChunks > 1;
+    for (const auto& input : inputs) {
+      pipelined = pipelined &&
+          input.unsafeGetTensorImpl()->is_non_overlapping_and_dense();
+    }
+
     // Kick off copy from CUDA tensors to pinned CPU tensors.
     tmp.reserve(inputs.size());
+    chunkEvents.resize(numChunks);
+    for (auto& chunkEvent : chunkEvents) {
+      chunkEvent.resize(inputs.size());
+    }
     at::cuda::OptionalCUDAStreamGuard guard;
     for (size_t i = 0; i < inputs.size(); i++) {
       guard.reset_stream(streams[i]);
-      tmp.push_back(pinnedLike(inputs[i]).copy_(inputs[i], true));
+      tmp.push_back(pinnedLike(inputs[i]));
+      if (!pipelined) {
+        tmp[i].copy_(inputs[i], true);
+      }
+      for (int64_t c = 0; c < numChunks; c++) {
+        if (pipelined) {
+          chunk(tmp[i], c).copy_(chunk(inputs[i], c), true);
+        }
+        chunkEvents[c][i].record(streams[i]);
+      }
     }
   }
 
   void run() override {
-    // Synchronize with copy operations.
     at::cuda::OptionalCUDAGuard device_guard;
-    for (size_t i = 0; i < inputs.size(); i++) {
-      device_guard.set_index(inputs[i].device().index());
-      AT_CUDA_CHECK(cudaStreamSynchronize(streams[i]));
-    }
+    at::cuda::OptionalCUDAStreamGuard stream_guard;
+    for (int64_t c = 0; c < numChunks; c++) {
+      // Synchronize with copy operations.
+      std::vector<at::Tensor> tmpChunks;
+      tmpChunks.reserve(inputs.size());
+      for (size_t i = 0; i < inputs.size(); i++) {
+        device_guard.set_index(inputs[i].device().index());
+        chunkEvents[c][i].synchronize();
+        tmpChunks.push_back(chunk(tmp[i], c));
+      }
 
-    // Run allreduce on host side tensors.
-    allreduce(tmp);
+      // Run allreduce on host side tensors.
+      allreduce(tmpChunks);
+
+      // Kick off copy back to the CUDA tensors.
+      // Only the first output in the tensor list contains the results.
+      // See https://github.com/facebookincubator/gloo/issues/152.
+      // The contents is the same for every entry in the tensor list, so
+      // we can use the first entry as the source of the copy below.
+      for (size_t i = 0; pipelined && i < inputs.size(); i++) {
+        stream_guard.reset_stream(streams[i]);
+        chunk(inputs[i], c).copy_(tmpChunks[0], /* non_blocking */ true);
+      }
+    }
 
-    // Kick off copy back to the CUDA tensors.
-    // Only the first output in the tensor list contains the results.
-    // See https://github.com/facebookincubator/gloo/issues/152.
-    // The contents is the same for every entry in the tensor list, so
-    // we can use the first entry as the source of the copy below.
-    at::cuda::OptionalCUDAStreamGuard stream_guard;
     for (size_t i = 0; i < inputs.size(); i++) {
       stream_guard.reset_stream(streams[i]);
-      inputs[i].copy_(tmp[0], /* non_blocking */ true);
+      if (!pipelined) {
+        inputs[i].copy_(tmp[0], /* non_blocking */ true);
+      }
       events[i].record(streams[i]);
     }
   }
@@ -1158,9 +1217,22 @@ class AsyncAllreduceCUDAWork : public AsyncAllreduceWork {
     }
   }
 
+  // Returns the c-th chunk of the memory of the tensor. This assumes that
+  // the memory is dense, like the allreduce does.
+  at::Tensor chunk(const at::Tensor& tensor, int64_t c) const {
+    const auto begin = c * chunkSize;
+    const auto length = std::min(chunkSize, tensor.numel() - begin);
+    return tensor.as_strided({length}, {1}, tensor.storage_offset() + begin);
+  }
+
   std::vector<at::Tensor> tmp;
   std::vector<at::cuda::CUDAStream> streams;
   std::vector<at::cuda::CUDAEvent> events;
+  int64_t chunkSize;
+  int64_t numChunks;
+  bool pipelined;
+  // Recorded after the copy of every chunk of every tensor to the host.
+  std::vector<std::vector<at::cuda::CUDAEvent>> chunkEvents;
 };
 
 class AsyncSparseAllreduceCUDAWork : public AsyncSparseAllreduceWork {
@@ -1226,8 +1298,330 @@ class AsyncSparseAllreduceCUDAWork : public AsyncSparseAllreduceWork {
 
 #endif
 
+// Shared memory segment that is mapped by all processes on a host.
+// One process creates the segment and the others open it by name.
+// The name can be unlinked as soon as every process has opened it,
+// so that the segment doesn't outlive the processes that use it.
+class SharedMemorySegment {
+ public:
+  SharedMemorySegment(const std::string& name, size_t size, bool create)
+      : name_(name), size_(size) {
+    const auto flags = O_RDWR | (create ? (O_CREAT | O_EXCL) : 0);
+    const auto fd = shm_open(name_.c_str(), flags, S_IRUSR | S_IWUSR);
+    if (fd == -1) {
+      throw std::system_error(errno, std::system_category(), name_);
+    }
+    if (create && ftruncate(fd, size_) == -1) {
+      const auto error = errno;
+      ::close(fd);
+      shm_unlink(name_.c_str());
+      throw std::system_error(error, std::system_category(), name_);
+    }
+    data_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    const auto error = errno;
+    ::close(fd);
+    if (data_ == MAP_FAILED) {
+      if (create) {
+        shm_unlink(name_.c_str());
+      }
+      throw std::system_error(error, std::system_category(), name_);
+    }
+  }
+
+  ~SharedMemorySegment() {
+    munmap(data_, size_);
+  }
+
+  void unlink() {
+    shm_unlink(name_.c_str());
+  }
+
+  char* data() const {
+    return static_cast<char*>(data_);
+  }
+
+ protected:
+  const std::string name_;
+  const size_t size_;
+  void* data_;
+};
+
 } // namespace
 
+// The hierarchical allreduce runs in three steps. First, the processes
+// on the same host reduce their inputs through a shared memory segment
+// that holds one slot per process. Every process sums its share of the
+// elements across all slots into the first slot. Second, the first
+// process on every host (the leader) allreduces the first slot with the
+// leaders of the other hosts. Third, all processes on the host copy the
+// result out of the first slot. The steps are separated by barriers on
+// a context that only connects the processes on the same host.
+//
+// Every allreduce uses the same shared memory segment, so they must run
+// one at a time. They are executed in the order they were issued, which
+// is identical on all processes.
+class ProcessGroupGloo::HierarchicalAllreduce {
+ public:
+  class Work : public ProcessGroupGloo::AsyncWork {
+   public:
+    Work(
+        const std::shared_ptr<HierarchicalAllreduce>& state,
+        std::vector<at::Tensor>& inputs)
+        : state(state), inputs(inputs), sequenceNumber(state->issue()) {}
+
+    std::shared_ptr<HierarchicalAllreduce> state;
+    std::vector<at::Tensor> inputs;
+    const uint64_t sequenceNumber;
+
+    void run() override {
+      state->run(sequenceNumber, inputs);
+    }
+  };
+
+  HierarchicalAllreduce(
+      ::gloo::rendezvous::Store& store,
+      int rank,
+      int size,
+      const Options& options) {
+    // Group processes by the hostname of the machine they run on.
+    const auto hostNameMax = sysconf(_SC_HOST_NAME_MAX);
+    std::vector<char> hostnameBuffer(hostNameMax + 1, 0);
+    if (gethostname(hostnameBuffer.data(), hostNameMax) != 0) {
+      throw std::system_error(errno, std::system_category(), "gethostname");
+    }
+    const std::string hostname(hostnameBuffer.data());
+    store.set(
+        "hierarchical/host/" + std::to_string(rank),
+        std::vector<char>(hostname.begin(), hostname.end()));
+
+    std::vector<std::string> hosts(size);
+    for (int i = 0; i < size; i++) {
+      const auto key = "hierarchical/host/" + std::to_string(i);
+      store.wait({key}, options.timeout);
+      const auto value = store.get(key);
+      hosts[i] = std::string(value.begin(), value.end());
+    }
+
+    localRank_ = 0;
+    localSize_ = 0;
+    hostIndex_ = 0;
+    hostCount_ = 0;
+    for (int i = 0; i < size; i++) {
+      const auto first =
+          std::find(hosts.begin(), hosts.begin() + i, hosts[i]) ==
+          hosts.begin() + i;
+      if (hosts[i] == hosts[rank]) {
+        if (i == rank) {
+          localRank_ = localSize_;
+        }
+        if (first) {
+          hostIndex_ = hostCount_;
+        }
+        localSize_++;
+      }
+      if (first) {
+        hostCount_++;
+      }
+    }
+
+    const auto& device = options.devices[0];
+    const auto host = std::to_string(hostIndex_);
+    auto localStore =
+        ::gloo::rendezvous::PrefixStore("hierarchical/local/" + host, store);
+    auto localContext = std::make_shared<::gloo::rendezvous::Context>(
+        localRank_, localSize_);
+    localContext->setTimeout(options.timeout);
+    localContext->connectFullMesh(localStore, device);
+    localContext_ = std::move(localContext);
+
+    if (localRank_ == 0) {
+      auto leaderStore =
+          ::gloo::rendezvous::PrefixStore("hierarchical/leader", store);
+      auto leaderContext = std::make_shared<::gloo::rendezvous::Context>(
+          hostIndex_, hostCount_);
+      leaderContext->setTimeout(options.timeout);
+      leaderContext->connectFullMesh(leaderStore, device);
+      leaderContext_ = std::move(leaderContext);
+    }
+
+    // The leader picks a name for the shared memory segments that is
+    // unique on this host, also across process groups in one process.
+    static std::atomic<uint64_t> segmentCounter(0);
+    const auto key = "hierarchical/segment/" + host;
+    if (localRank_ == 0) {
+      const auto name = "/torch_gloo_" + std::to_string(getpid()) + "_" +
+          std::to_string(segmentCounter++);
+      store.set(key, std::vector<char>(name.begin(), name.end()));
+    }
+    store.wait({key}, options.timeout);
+    const auto value = store.get(key);
+    segmentName_ = std::string(value.begin(), value.end());
+  }
+
+  // Returns true if the hierarchical allreduce supports these inputs.
+  // It only handles sums of dense CPU tensors of types that can be
+  // accumulated on the CPU; everything else runs the regular allreduce.
+  static bool supports(
+      const std::vector<at::Tensor>& inputs,
+      const ReduceOp& reduceOp) {
+    const auto& input = inputs[0];
+    return reduceOp == ReduceOp::SUM && input.device().is_cpu() &&
+        input.layout() == c10::kStrided &&
+        input.scalar_type() != at::kHalf;
+  }
+
+ protected:
+  uint64_t issue() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return issued_++;
+  }
+
+  void run(uint64_t sequenceNumber, std::vector<at::Tensor>& tensors) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [&] { return completed_ == sequenceNumber; });
+    lock.unlock();
+
+    try {
+      allreduce(tensors);
+    } catch (...) {
+      complete();
+      throw;
+    }
+    complete();
+  }
+
+  void complete() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    completed_++;
+    lock.unlock();
+    cv_.notify_all();
+  }
+
+  void allreduce(std::vector<at::Tensor>& tensors) {
+    const auto& input = tensors[0];
+    const auto numel = input.numel();
+    reserve(numel * input.element_size());
+
+    const auto slot = [&](int index) {
+      return at::from_blob(
+          segment_->data() + index * slotBytes_, {numel}, input.options());
+    };
+
+    // Sum the local inputs into this process' slot.
+    auto local = slot(localRank_);
+    local.copy_(tensors[0].reshape({numel}));
+    for (size_t i = 1; i < tensors.size(); i++) {
+      local.add_(tensors[i].reshape({numel}));
+    }
+    barrier();
+
+    // Sum this process' share of the elements across all slots.
+    auto result = slot(0);
+    const auto chunk = (numel + localSize_ - 1) / localSize_;
+    const auto begin = std::min(numel, chunk * localRank_);
+    const auto end = std::min(numel, begin + chunk);
+    if (begin < end) {
+      auto output = result.slice(0, begin, end);
+      for (int i = 1; i < localSize_; i++) {
+        output.add_(slot(i).slice(0, begin, end));
+      }
+    }
+    barrier();
+
+    if (leaderContext_ && hostCount_ > 1) {
+      const auto& scalarType = input.scalar_type();
+      std::vector<at::Tensor> outputs = {result};
+      gloo::AllreduceOptions opts(leaderContext_);
+      GENERATE_ALL_TYPES(scalarType, setReduceFunction, opts);
+      opts.setTag(leaderTag_++);
+      GENERATE_ALL_TYPES(scalarType, setOutputs, opts, outputs);
+      gloo::allreduce(opts);
+    }
+    barrier();
+
+    for (auto& tensor : tensors) {
+      tensor.copy_(result.view(tensor.sizes()));
+    }
+
+    // Don't let the next allreduce write to the segment
+    // before every process has read the result.
+    barrier();
+  }
+
+  template <typename T>
+  void setReduceFunction(gloo::AllreduceOptions& opts) {
+    opts.setReduceFunction(toFunction<T>(ReduceOp::SUM));
+  }
+
+  // Makes sure every slot in the shared memory segment holds at least
+  // `nbytes` bytes. The segment is replaced by a larger one if it
+  // doesn't. This only depends on the size of the inputs, so all
+  // processes on the host replace the segment at the same time.
+  void reserve(size_t nbytes) {
+    if (nbytes <= slotBytes_ && segment_) {
+      return;
+    }
+
+    // Grow geometrically and keep slots cache line aligned.
+    constexpr size_t kAlignment = 64;
+    auto slotBytes = std::max(nbytes, 2 * slotBytes_);
+    slotBytes = (slotBytes + kAlignment - 1) & ~(kAlignment - 1);
+    slotBytes = std::max(slotBytes, kAlignment);
+    const auto name = segmentName_ + "_" + std::to_string(generation_++);
+    segment_.reset();
+    if (localRank_ == 0) {
+      segment_.reset(
+          new SharedMemorySegment(name, slotBytes * localSize_, true));
+    }
+    barrier();
+    if (localRank_ != 0) {
+      segment_.reset(
+          new SharedMemorySegment(name, slotBytes * localSize_, false));
+    }
+    barrier();
+    if (localRank_ == 0) {
+      segment_->unlink();
+    }
+    slotBytes_ = slotBytes;
+  }
+
+  void barrier() {
+    gloo::BarrierOptions opts(localContext_);
+    opts.setTag(localTag_++);
+    gloo::barrier(opts);
+  }
+
+  int localRank_;
+  int localSize_;
+  int hostIndex_;
+  int hostCount_;
+
+  // Context with the processes on this host and, on the leader only,
+  // context with the leaders of all hosts.
+  std::shared_ptr<::gloo::Context> localContext_;
+  std::shared_ptr<::gloo::Context> leaderContext_;
+  uint32_t localTag_ = 0;
+  uint32_t leaderTag_ = 0;
+
+  std::string segmentName_;
+  uint64_t generation_ = 0;
+  std::unique_ptr<SharedMemorySegment> segment_;
+  size_t slotBytes_ = 0;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  uint64_t issued_ = 0;
+  uint64_t completed_ = 0;
+};
+
+void ProcessGroupGloo::initHierarchicalAllreduce(
+    int rank,
+    int size,
+    const Options& options) {
+  hierarchicalAllreduce_ =
+      std::make_shared<HierarchicalAllreduce>(*store_, rank, size, options);
+}
+
 std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
     std::vector<at::Tensor>& inputs,
     const AllreduceOptions& opts) {
@@ -1260,7 +1654,11 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
   std::shared_ptr<AsyncWork> work;
   auto tag = nextTag();
   auto context = getContext(tag);
-  if (device.type() == at::kCPU) {
+  if (hierarchicalAllreduce_ &&
+      HierarchicalAllreduce::supports(inputs, opts.reduceOp)) {
+    work = std::make_shared<HierarchicalAllreduce::Work>(
+        hierarchicalAllreduce_, inputs);
+  } else if (device.type() == at::kCPU) {
     if (layout == c10::kStrided) {
       work = std::make_shared<AsyncAllreduceWork>(
           std::move(context), inputs, opts.reduceOp, tag);
@@ -2238,6 +2636,152 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::reduce_scatter(
   throw std::runtime_error("ProcessGroupGloo does not support reduce_scatter");
 }
 
+namespace {
+
+class AsyncAlltoallWork : public ProcessGroupGloo::AsyncWork {
+ public:
+  AsyncAlltoallWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor> outputs,
+      std::vector<at::Tensor> inputs,
+      uint32_t tag)
+      : context(context),
+        outputs(std::move(outputs)),
+        inputs(std::move(inputs)),
+        tag(tag) {}
+
+  std::shared_ptr<gloo::Context> context;
+  // One contiguous tensor per rank: inputs[i] is sent to rank i, and
+  // outputs[i] is received from rank i.
+  std::vector<at::Tensor> outputs;
+  std::vector<at::Tensor> inputs;
+  const uint32_t tag;
+
+  void run() override {
+    const auto rank = context->rank;
+    const auto size = context->size;
+    std::vector<std::unique_ptr<::gloo::transport::UnboundBuffer>> sendBufs;
+    std::vector<std::unique_ptr<::gloo::transport::UnboundBuffer>> recvBufs;
+
+    // Pairwise exchange: in step i every rank sends to the rank i ahead of it
+    // and receives from the rank i behind it, so that all ranks talk to a
+    // different peer at any point in time.
+    for (int i = 1; i < size; i++) {
+      const auto dst = (rank + i) % size;
+      const auto src = (rank - i + size) % size;
+      auto& input = inputs[dst];
+      if (input.numel() > 0) {
+        auto buf = context->createUnboundBuffer(
+            input.data_ptr(), input.numel() * input.element_size());
+        buf->send(dst, tag);
+        sendBufs.push_back(std::move(buf));
+      }
+      auto& output = outputs[src];
+      if (output.numel() > 0) {
+        auto buf = context->createUnboundBuffer(
+            output.data_ptr(), output.numel() * output.element_size());
+        buf->recv(src, tag);
+        recvBufs.push_back(std::move(buf));
+      }
+    }
+
+    // The split of the local rank doesn't go through the transport.
+    outputs[rank].copy_(inputs[rank]);
+
+    for (auto& buf : sendBufs) {
+      buf->waitSend();
+    }
+    for (auto& buf : recvBufs) {
+      buf->waitRecv();
+    }
+  }
+};
+
+} // namespace
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::alltoall_base(
+    at::Tensor& outputTensor,
+    at::Tensor& inputTensor,
+    std::vector<int64_t>& outputSplitSizes,
+    std::vector<int64_t>& inputSplitSizes,
+    const AllToAllOptions& /* unused */) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupGloo::alltoall_base: " + msg);
+  };
+
+  const std::vector<at::Tensor> tensors = {outputTensor, inputTensor};
+  assertDense(invalidArgument, tensors);
+  assertCPU(invalidArgument, tensors);
+  assertSameDevice(invalidArgument, tensors);
+  if (!outputTensor.options().type_equal(inputTensor.options())) {
+    invalidArgument("output tensor must have the same type as input tensor");
+  }
+  if (!outputTensor.is_contiguous() || !inputTensor.is_contiguous()) {
+    invalidArgument("tensors must be contiguous");
+  }
+  checkSplitSizes(outputSplitSizes, outputTensor, size_);
+  checkSplitSizes(inputSplitSizes, inputTensor, size_);
+
+  // Split both tensors into a flat view per rank.
+  const auto split = [this](
+                         const at::Tensor& tensor,
+                         const std::vector<int64_t>& splitSizes) {
+    std::vector<int64_t> lengths(size_);
+    std::vector<int64_t> offsets(size_);
+    computeLengthsAndOffsets(splitSizes, tensor, &lengths, &offsets);
+    auto flat = tensor.view({-1});
+    std::vector<at::Tensor> splits;
+    splits.reserve(size_);
+    for (int i = 0; i < size_; i++) {
+      splits.push_back(flat.narrow(0, offsets[i], lengths[i]));
+    }
+    return splits;
+  };
+
+  auto tag = nextTag();
+  auto context = getContext(tag);
+  auto work = std::make_shared<AsyncAlltoallWork>(
+      std::move(context),
+      split(outputTensor, outputSplitSizes),
+      split(inputTensor, inputSplitSizes),
+      tag);
+  enqueue(work);
+  return work;
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::alltoall(
+    std::vector<at::Tensor>& outputTensors,
+    std::vector<at::Tensor>& inputTensors,
+    const AllToAllOptions& /* unused */) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupGloo::alltoall: " + msg);
+  };
+
+  if (outputTensors.size() != static_cast<size_t>(size_) ||
+      inputTensors.size() != static_cast<size_t>(size_)) {
+    invalidArgument(
+        "requires as many input and output tensors as the process group size");
+  }
+  const auto& options = inputTensors[0].options();
+  for (const auto* tensors : {&outputTensors, &inputTensors}) {
+    assertDense(invalidArgument, *tensors);
+    assertCPU(invalidArgument, *tensors);
+    for (size_t i = 0; i < tensors->size(); i++) {
+      assertTypeMatch(invalidArgument, options, *tensors, i);
+      if (!(*tensors)[i].is_contiguous()) {
+        invalidArgument("tensors must be contiguous");
+      }
+    }
+  }
+
+  auto tag = nextTag();
+  auto context = getContext(tag);
+  auto work = std::make_shared<AsyncAlltoallWork>(
+      std::move(context), outputTensors, inputTensors, tag);
+  enqueue(work);
+  return work;
+}
+
 at::Tensor& checkSingleTensor(std::vector<at::Tensor>& tensors) {
   if (tensors.size() != 1) {
     throw std::runtime_error("ProcessGroupGloo::send takes a single tensor");
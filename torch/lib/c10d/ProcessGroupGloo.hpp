@@ -129,6 +129,11 @@ class ProcessGroupGloo : public ProcessGroup {
     std::vector<std::shared_ptr<::gloo::transport::Device>> devices;
     std::chrono::milliseconds timeout;
     int threads;
+
+    // Run allreduce of dense CPU tensors in two levels: reduce between
+    // the processes on the same host through shared memory, then
+    // allreduce between one process per host.
+    bool hierarchicalAllreduce;
   };
 
   // Helper functions to create a new device object.
@@ -204,6 +209,18 @@ class ProcessGroupGloo : public ProcessGroup {
       std::vector<std::vector<at::Tensor>>& inputs,
       const ReduceScatterOptions& opts = ReduceScatterOptions()) override;
 
+  std::shared_ptr<ProcessGroup::Work> alltoall_base(
+      at::Tensor& outputTensor,
+      at::Tensor& inputTensor,
+      std::vector<int64_t>& outputSplitSizes,
+      std::vector<int64_t>& inputSplitSizes,
+      const AllToAllOptions& opts = AllToAllOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> alltoall(
+      std::vector<at::Tensor>& outputTensors,
+      std::vector<at::Tensor>& inputTensors,
+      const AllToAllOptions& opts = AllToAllOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> send(
       std::vector<at::Tensor>& tensors,
       int dstRank,
@@ -245,6 +262,14 @@ class ProcessGroupGloo : public ProcessGroup {
   // to contexts being used in a round-robin fashion.
   std::shared_ptr<::gloo::Context> getContext(uint32_t tag);
 
+  // Shared memory state and connections used by the hierarchical
+  // allreduce. Only set if `Options::hierarchicalAllreduce` is true.
+  class HierarchicalAllreduce;
+  std::shared_ptr<HierarchicalAllreduce> hierarchicalAllreduce_;
+
+  // Creates the hierarchical allreduce state (see above).
+  void initHierarchicalAllreduce(int rank, int size, const Options& options);
+
   // Entrypoint for worker threads.
   void runLoop(int workerIndex);
 
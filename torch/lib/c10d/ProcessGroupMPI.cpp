@@ -1,9 +1,17 @@
 #include <c10d/ProcessGroupMPI.hpp>
 
+#include <algorithm>
+#include <cstdlib>
 #include <map>
 
 #include <c10/core/DeviceGuard.h>
 
+#ifdef USE_CUDA
+#include <ATen/cuda/CUDAEvent.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <c10/cuda/CUDAStream.h>
+#endif
+
 #if defined(OPEN_MPI) && OPEN_MPI
 #include <mpi-ext.h> // Needed for CUDA-aware check
 #endif
@@ -41,19 +49,25 @@ std::map<at::ScalarType, MPI_Datatype> mpiDatatype = {
     {at::kShort, MPI_SHORT},
 };
 
-// Checking CUDA-aware MPI support, currently we only support CUDA aware
-// MPI ops through Open MPI
+bool envFlagSet(const char* name) {
+  const char* value = std::getenv(name);
+  return value != nullptr && std::string(value) == "1";
+}
+
+// Checking CUDA-aware MPI support. Open MPI can be queried at run time;
+// MVAPICH2 and Cray MPICH only pass device pointers through if they are
+// enabled by their environment variable.
 bool cudaAwareMpiCheck() {
+  static const bool cudaAware = []() {
 // Run time check
 #if defined(MPIX_CUDA_AWARE_SUPPORT)
-  if (MPIX_Query_cuda_support() == 1) {
-    return true;
-  } else {
-    return false;
-  }
-#else // !defined(MPIX_CUDA_AWARE_SUPPORT)
-  return false;
+    if (MPIX_Query_cuda_support() == 1) {
+      return true;
+    }
 #endif // MPIX_CUDA_AWARE_SUPPORT
+    return envFlagSet("MV2_USE_CUDA") || envFlagSet("MPICH_RDMA_ENABLED_CUDA");
+  }();
+  return cudaAware;
 }
 
 // Checking the input tensor's validity
@@ -91,6 +105,45 @@ void checkSameSizeAndType(
   }
 }
 
+#ifdef USE_CUDA
+const at::Tensor* findCudaTensor(const WorkEntry& entry) {
+  for (const auto* tensors : {&entry.src, &entry.dst}) {
+    for (const auto& tensor : *tensors) {
+      if (tensor.is_cuda()) {
+        return &tensor;
+      }
+    }
+  }
+  return nullptr;
+}
+
+// Orders the run function of an entry with CUDA tensors after the work
+// currently queued on the current stream of their device, i.e. the work that
+// produces the inputs of the collective.
+void orderAfterCurrentStream(WorkEntry& entry) {
+  const auto* tensor = findCudaTensor(entry);
+  if (tensor == nullptr) {
+    return;
+  }
+  auto stream = at::cuda::getCurrentCUDAStream(tensor->device().index());
+  auto event = std::make_shared<at::cuda::CUDAEvent>();
+  event->record(stream);
+  auto run = std::move(entry.run);
+  entry.run = [stream, event, run](std::unique_ptr<WorkEntry>& workEntry) {
+    event->synchronize();
+    at::cuda::CUDAStreamGuard guard(stream);
+    run(workEntry);
+  };
+}
+
+// For the send and recv calls, which are made on the calling thread.
+void waitForCurrentStream(const at::Tensor& tensor) {
+  if (tensor.is_cuda()) {
+    at::cuda::getCurrentCUDAStream(tensor.device().index()).synchronize();
+  }
+}
+#endif
+
 } // namespace
 
 ProcessGroupMPI::AsyncWork::AsyncWork(at::Tensor tensor, MPI_Request request)
@@ -112,7 +165,7 @@ bool ProcessGroupMPI::AsyncWork::isCompleted() {
     return true;
   }
 
-  std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+  auto globalLock = mpiLock();
   int flag = 0;
   MPI_CHECK(MPI_Test(&request_, &flag, &status_));
   if (request_ != MPI_REQUEST_NULL) {
@@ -146,7 +199,7 @@ bool ProcessGroupMPI::AsyncWork::wait() {
     return true;
   }
 
-  std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+  auto globalLock = mpiLock();
   MPI_CHECK(MPI_Wait(&request_, &status_));
   auto ok = (status_.MPI_ERROR == MPI_SUCCESS);
   if (!ok) {
@@ -175,6 +228,13 @@ std::mutex ProcessGroupMPI::pgGlobalMutex_;
 // We only want to initialize once
 std::once_flag ProcessGroupMPI::onceFlagInitMPI;
 
+std::unique_lock<std::mutex> ProcessGroupMPI::mpiLock() {
+  if (mpiThreadSupport_ >= MPI_THREAD_MULTIPLE) {
+    return std::unique_lock<std::mutex>(pgGlobalMutex_, std::defer_lock);
+  }
+  return std::unique_lock<std::mutex>(pgGlobalMutex_);
+}
+
 void ProcessGroupMPI::mpiExit() {
   std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
   MPI_CHECK(MPI_Finalize());
@@ -183,8 +243,10 @@ void ProcessGroupMPI::mpiExit() {
 void ProcessGroupMPI::initMPIOnce() {
   // Initialize MPI environment
   std::call_once(onceFlagInitMPI, []() {
+    // MPI_THREAD_MULTIPLE is requested, so that collectives can run on
+    // several worker threads, but MPI_THREAD_SERIALIZED is enough.
     MPI_CHECK(MPI_Init_thread(
-        nullptr, nullptr, MPI_THREAD_SERIALIZED, &mpiThreadSupport_));
+        nullptr, nullptr, MPI_THREAD_MULTIPLE, &mpiThreadSupport_));
     if (mpiThreadSupport_ < MPI_THREAD_SERIALIZED) {
       throw std::runtime_error(
           "Used MPI implementation doesn't have the "
@@ -199,7 +261,8 @@ void ProcessGroupMPI::initMPIOnce() {
 }
 
 std::shared_ptr<ProcessGroupMPI> ProcessGroupMPI::createProcessGroupMPI(
-    std::vector<int> ranks) {
+    std::vector<int> ranks,
+    int numWorkerThreads) {
   // Once initialization
   initMPIOnce();
 
@@ -240,17 +303,45 @@ std::shared_ptr<ProcessGroupMPI> ProcessGroupMPI::createProcessGroupMPI(
     return std::shared_ptr<ProcessGroupMPI>();
   }
 
-  return std::make_shared<ProcessGroupMPI>(rank, size, groupComm);
+  return std::make_shared<ProcessGroupMPI>(
+      rank, size, groupComm, numWorkerThreads);
 }
 
-ProcessGroupMPI::ProcessGroupMPI(int rank, int size, MPI_Comm pgComm)
-    : ProcessGroup(rank, size), stop_(false), pgComm_(pgComm) {
+ProcessGroupMPI::ProcessGroupMPI(
+    int rank,
+    int size,
+    MPI_Comm pgComm,
+    int numWorkerThreads)
+    : ProcessGroup(rank, size), stop_(false), nextWorker_(0), pgComm_(pgComm) {
   if (pgComm_ == MPI_COMM_NULL) {
     throw std::runtime_error("pgComm_ must not be MPI_COMM_NULL");
   }
+  if (numWorkerThreads < 1) {
+    throw std::invalid_argument(
+        "ProcessGroupMPI needs at least one worker thread");
+  }
+  if (numWorkerThreads > 1 && mpiThreadSupport_ < MPI_THREAD_MULTIPLE) {
+    throw std::runtime_error(
+        "ProcessGroupMPI needs an MPI implementation with MPI_THREAD_MULTIPLE "
+        "support to run collectives on more than one worker thread");
+  }
+
+  // A single worker thread runs on the communicator of the group. Several
+  // worker threads each get a duplicate, so that the collectives that run
+  // concurrently don't get mixed up.
+  workerComms_.resize(numWorkerThreads, pgComm_);
+  if (numWorkerThreads > 1) {
+    std::lock_guard<std::mutex> globalLock(pgGlobalMutex_);
+    for (auto& comm : workerComms_) {
+      MPI_CHECK(MPI_Comm_dup(pgComm_, &comm));
+    }
+  }
+  queues_ = std::vector<std::deque<WorkType>>(numWorkerThreads);
 
-  // Start the worker thread accepting MPI calls
-  workerThread_ = std::thread(&ProcessGroupMPI::runLoop, this);
+  // Start the worker threads accepting MPI calls
+  for (int i = 0; i < numWorkerThreads; i++) {
+    workerThreads_.emplace_back(&ProcessGroupMPI::runLoop, this, i);
+  }
 }
 
 ProcessGroupMPI::~ProcessGroupMPI() {
@@ -259,7 +350,12 @@ ProcessGroupMPI::~ProcessGroupMPI() {
 
 void ProcessGroupMPI::destroy() {
   std::unique_lock<std::mutex> lock(pgMutex_);
-  queueConsumeCV_.wait(lock, [&] { return queue_.empty(); });
+  queueConsumeCV_.wait(lock, [&] {
+    return std::all_of(
+        queues_.begin(), queues_.end(), [](const std::deque<WorkType>& queue) {
+          return queue.empty();
+        });
+  });
 
   // Queue is empty, signal stop
   stop_ = true;
@@ -268,8 +364,9 @@ void ProcessGroupMPI::destroy() {
   lock.unlock();
   queueProduceCV_.notify_all();
 
-  // Join the single worker thread
-  workerThread_.join();
+  for (auto& workerThread : workerThreads_) {
+    workerThread.join();
+  }
 }
 
 void ProcessGroupMPI::abort() {
@@ -277,24 +374,26 @@ void ProcessGroupMPI::abort() {
   MPI_Abort(pgComm_, EXIT_FAILURE);
 }
 
-void ProcessGroupMPI::runLoop() {
+void ProcessGroupMPI::runLoop(size_t workerIndex) {
   std::unique_lock<std::mutex> lock(pgMutex_);
+  auto& queue = queues_[workerIndex];
 
   while (!stop_) {
-    if (queue_.empty()) {
+    if (queue.empty()) {
       queueProduceCV_.wait(lock);
       continue;
     }
 
-    auto workTuple = std::move(queue_.front());
+    auto workTuple = std::move(queue.front());
 
-    queue_.pop_front();
+    queue.pop_front();
 
     auto& workEntry = std::get<0>(workTuple);
     auto& work = std::get<1>(workTuple);
+    workEntry->comm = workerComms_[workerIndex];
 
     lock.unlock();
-    queueConsumeCV_.notify_one();
+    queueConsumeCV_.notify_all();
 
     try {
       workEntry->run(workEntry);
@@ -309,11 +408,16 @@ void ProcessGroupMPI::runLoop() {
 
 std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::enqueue(
     std::unique_ptr<WorkEntry> entry) {
+#ifdef USE_CUDA
+  orderAfterCurrentStream(*entry);
+#endif
   auto work = std::make_shared<WorkMPI>();
   std::unique_lock<std::mutex> lock(pgMutex_);
-  queue_.push_back(std::make_tuple(std::move(entry), work));
+  queues_[nextWorker_].push_back(std::make_tuple(std::move(entry), work));
+  nextWorker_ = (nextWorker_ + 1) % queues_.size();
   lock.unlock();
-  queueProduceCV_.notify_one();
+  // The worker threads share the condition variable.
+  queueProduceCV_.notify_all();
   return work;
 }
 
@@ -325,13 +429,13 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::broadcast(
       [opts, this](std::unique_ptr<WorkEntry>& entry) {
         auto data = (entry->src)[0];
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = mpiLock();
         MPI_CHECK(MPI_Bcast(
             data.data_ptr(),
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             opts.rootRank,
-            pgComm_));
+            entry->comm));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(&tensors, nullptr, std::move(runFunc)));
@@ -347,14 +451,14 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allreduce(
       [opts, this](std::unique_ptr<WorkEntry>& entry) {
         auto data = (entry->src)[0];
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = mpiLock();
         MPI_CHECK(MPI_Allreduce(
             MPI_IN_PLACE,
             data.data_ptr(),
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             mpiOp.at(opts.reduceOp),
-            pgComm_));
+            entry->comm));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(&tensors, nullptr, std::move(runFunc)));
@@ -381,7 +485,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::reduce(
         void* recvbuf = (rank_ == opts.rootRank) ? dataPtr : nullptr;
 
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = mpiLock();
         MPI_CHECK(MPI_Reduce(
             sendbuf,
             recvbuf,
@@ -389,7 +493,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::reduce(
             mpiDatatype.at(data.scalar_type()),
             mpiOp.at(opts.reduceOp),
             opts.rootRank,
-            pgComm_));
+            entry->comm));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(&tensors, nullptr, std::move(runFunc)));
@@ -421,7 +525,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allgather(
         auto flatOutputTensor = newLikeFlat(outputDataVec);
 
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = mpiLock();
         MPI_CHECK(MPI_Allgather(
             data.data_ptr(),
             data.numel(),
@@ -429,7 +533,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::allgather(
             flatOutputTensor.data_ptr(),
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
-            pgComm_));
+            entry->comm));
 
         for (size_t i = 0; i < outputDataVec.size(); ++i) {
           outputDataVec[i].copy_(flatOutputTensor[i]);
@@ -484,7 +588,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::gather(
         }
 
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = mpiLock();
         MPI_CHECK(MPI_Gather(
             data.data_ptr(),
             data.numel(),
@@ -493,7 +597,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::gather(
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             opts.rootRank,
-            pgComm_));
+            entry->comm));
 
         if (rank_ == opts.rootRank) {
           std::vector<at::Tensor>& outputDataVec = entry->dst;
@@ -555,10 +659,14 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::scatter(
           for (size_t i = 0; i < inputDataVec.size(); ++i) {
             flatInputTensor[i].copy_(inputDataVec.at(i));
           }
+#ifdef USE_CUDA
+          // MPI reads the send buffer from the host thread.
+          waitForCurrentStream(flatInputTensor);
+#endif
         }
 
         c10::DeviceGuard guard(data.device());
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+        auto globalLock = mpiLock();
         MPI_CHECK(MPI_Scatter(
             sendbuf,
             data.numel(),
@@ -567,7 +675,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::scatter(
             data.numel(),
             mpiDatatype.at(data.scalar_type()),
             opts.rootRank,
-            pgComm_));
+            entry->comm));
       };
 
   if (rank_ == opts.rootRank) {
@@ -597,9 +705,12 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::send(
   auto& tensor = tensors[0];
   MPI_Request request = MPI_REQUEST_NULL;
 
+#ifdef USE_CUDA
+  waitForCurrentStream(tensor);
+#endif
   {
     c10::DeviceGuard guard(tensor.device());
-    std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+    auto globalLock = mpiLock();
     MPI_CHECK(MPI_Isend(
         tensor.data_ptr(),
         tensor.numel(),
@@ -622,9 +733,12 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::recv(
   auto& tensor = tensors[0];
   MPI_Request request = MPI_REQUEST_NULL;
 
+#ifdef USE_CUDA
+  waitForCurrentStream(tensor);
+#endif
   {
     c10::DeviceGuard guard(tensor.device());
-    std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+    auto globalLock = mpiLock();
     MPI_CHECK(MPI_Irecv(
         tensor.data_ptr(),
         tensor.numel(),
@@ -646,9 +760,12 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::recvAnysource(
   auto& tensor = tensors[0];
   MPI_Request request = MPI_REQUEST_NULL;
 
+#ifdef USE_CUDA
+  waitForCurrentStream(tensor);
+#endif
   {
     c10::DeviceGuard guard(tensor.device());
-    std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
+    auto globalLock = mpiLock();
     MPI_CHECK(MPI_Irecv(
         tensor.data_ptr(),
         tensor.numel(),
@@ -665,9 +782,9 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::recvAnysource(
 std::shared_ptr<ProcessGroup::Work> ProcessGroupMPI::barrier(
     const BarrierOptions& opts) {
   std::function<void(std::unique_ptr<WorkEntry>&)> runFunc =
-      [this](std::unique_ptr<WorkEntry>& entry) {
-        std::unique_lock<std::mutex> globalLock(pgGlobalMutex_);
-        MPI_CHECK(MPI_Barrier(pgComm_));
+      [](std::unique_ptr<WorkEntry>& entry) {
+        auto globalLock = mpiLock();
+        MPI_CHECK(MPI_Barrier(entry->comm));
       };
   auto entry = std::unique_ptr<WorkEntry>(
       new WorkEntry(nullptr, nullptr, std::move(runFunc)));
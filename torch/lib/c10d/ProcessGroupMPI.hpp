@@ -43,6 +43,8 @@ struct WorkEntry {
   std::vector<at::Tensor> dst;
   // src rank returned, for recv only
   int* srcRank = nullptr;
+  // The communicator to run on, set by the worker thread that runs the entry
+  MPI_Comm comm = MPI_COMM_NULL;
   std::function<void(std::unique_ptr<WorkEntry>&)> run;
 };
 
@@ -63,13 +65,26 @@ struct WorkEntry {
 //
 // If you would like to use multiple ProcessGroupMPI, it requres your MPI
 // implemenation to have a thread support value of MPI_THREAD_MULTIPLE, that is,
-// multiple threads may call MPI, with no restriction.
+// multiple threads may call MPI, with no restriction. MPI_THREAD_MULTIPLE also
+// allows a process group to run independent collectives concurrently on
+// several worker threads (see `numWorkerThreads`). Every worker thread runs on
+// its own duplicate of the communicator, and collectives are assigned to the
+// worker threads round robin in the order they are issued, which is the same
+// on all processes. Collectives that are issued without waiting for each
+// other may then run concurrently, so they must not use the same tensors.
 //
 // Also note that ProcessGroupMPI only supports a single Tensor operation. In
 // other words, the size of the input Tensor vector should always be 1.
 //
 // CUDA tensor can be supported if the MPI used is CUDA-aware MPI, and
-// ProcessGroupMPI will automatically detect this support.
+// ProcessGroupMPI will automatically detect this support (through
+// MPIX_Query_cuda_support for Open MPI, and the MV2_USE_CUDA and
+// MPICH_RDMA_ENABLED_CUDA environment variables for MVAPICH2 and Cray MPICH).
+// The device pointers of CUDA tensors are passed to MPI directly. A collective
+// on CUDA tensors records an event on the current stream when it is issued,
+// and the worker thread waits for that event only, rather than for the whole
+// device, before making the MPI call; copies to and from the flattened buffers
+// of e.g. allgather run on that same stream.
 class ProcessGroupMPI : public ProcessGroup {
  public:
   class WorkMPI : public ProcessGroup::Work {
@@ -100,8 +115,12 @@ class ProcessGroupMPI : public ProcessGroup {
     MPI_Status status_;
   };
 
-  // Constructor will spawn up the worker thread loop
-  explicit ProcessGroupMPI(int rank, int size, MPI_Comm pgComm);
+  // Constructor will spawn up the worker thread loops
+  explicit ProcessGroupMPI(
+      int rank,
+      int size,
+      MPI_Comm pgComm,
+      int numWorkerThreads = 1);
 
   virtual ~ProcessGroupMPI();
 
@@ -174,13 +193,14 @@ class ProcessGroupMPI : public ProcessGroup {
 
   // Creating a new ProcessGroupMPI, will initiialize MPI if not initialized
   static std::shared_ptr<ProcessGroupMPI> createProcessGroupMPI(
-      std::vector<int> ranks = {});
+      std::vector<int> ranks = {},
+      int numWorkerThreads = 1);
 
  protected:
   using WorkType =
       std::tuple<std::unique_ptr<WorkEntry>, std::shared_ptr<WorkMPI>>;
   // Worker thread loop
-  void runLoop();
+  void runLoop(size_t workerIndex);
   // Helper function that is called by the destructor
   void destroy();
 
@@ -189,9 +209,13 @@ class ProcessGroupMPI : public ProcessGroup {
   bool stop_;
 
   std::mutex pgMutex_;
-  std::thread workerThread_;
+  std::vector<std::thread> workerThreads_;
 
-  std::deque<WorkType> queue_;
+  // The queue and the communicator of every worker thread, and the worker
+  // thread the next collective is assigned to.
+  std::vector<std::deque<WorkType>> queues_;
+  std::vector<MPI_Comm> workerComms_;
+  size_t nextWorker_;
   std::condition_variable queueProduceCV_;
   std::condition_variable queueConsumeCV_;
 
@@ -203,6 +227,10 @@ class ProcessGroupMPI : public ProcessGroup {
   static std::mutex pgGlobalMutex_;
   static int mpiThreadSupport_;
 
+  // Returns a lock on pgGlobalMutex_, which is only acquired if MPI calls
+  // have to be serialized, i.e. without MPI_THREAD_MULTIPLE.
+  static std::unique_lock<std::mutex> mpiLock();
+
   MPI_Comm pgComm_;
 };
 
@@ -126,6 +126,59 @@ std::string getNcclAbortedCommStoreKey(const std::string ncclIdStr) {
   return std::string(kNCCLAbortedCommStoreKey) + ":" + ncclIdStr;
 }
 
+// Tag of the enclosing ProcessGroupNCCL::CommTagGuard, or -1.
+thread_local int64_t commTag = -1;
+
+// Key of the communicator with the given index in the pool of a set of
+// devices. The first one keeps the key of the devices.
+std::string getPooledKey(const std::string& devicesKey, int index) {
+  return index == 0 ? devicesKey : devicesKey + "#" + std::to_string(index);
+}
+
+#ifdef ENABLE_NCCL_P2P_SUPPORT
+// Sends sendcounts[r] elements at senddispls[r] of sendbuff to every rank r
+// and receives recvcounts[r] elements at recvdispls[r] of recvbuff from it,
+// as a single group of point-to-point operations. Counts and displacements
+// are in elements of `size' bytes.
+ncclResult_t ncclAlltoallv(
+    void* sendbuff,
+    const size_t* sendcounts,
+    const size_t* senddispls,
+    void* recvbuff,
+    const size_t* recvcounts,
+    const size_t* recvdispls,
+    size_t size,
+    ncclDataType_t type,
+    ncclComm_t comm,
+    cudaStream_t stream) {
+  int numranks;
+  C10D_NCCL_CHECK(ncclCommCount(comm, &numranks));
+  C10D_NCCL_CHECK(ncclGroupStart());
+  for (int r = 0; r < numranks; r++) {
+    if (sendcounts[r] != 0) {
+      C10D_NCCL_CHECK(ncclSend(
+          static_cast<char*>(sendbuff) + senddispls[r] * size,
+          sendcounts[r],
+          type,
+          r,
+          comm,
+          stream));
+    }
+    if (recvcounts[r] != 0) {
+      C10D_NCCL_CHECK(ncclRecv(
+          static_cast<char*>(recvbuff) + recvdispls[r] * size,
+          recvcounts[r],
+          type,
+          r,
+          comm,
+          stream));
+    }
+  }
+  C10D_NCCL_CHECK(ncclGroupEnd());
+  return ncclSuccess;
+}
+#endif
+
 } // namespace
 
 const int64_t ProcessGroupNCCL::kWatchdogThreadSleepMillis = 10000;
@@ -261,12 +314,20 @@ ProcessGroupNCCL::ProcessGroupNCCL(
     const std::shared_ptr<Store>& store,
     int rank,
     int size,
-    const std::chrono::milliseconds& opTimeout)
+    const std::chrono::milliseconds& opTimeout,
+    int commsPerDevice,
+    bool isHighPriorityStream)
     : ProcessGroup(rank, size),
       store_(store),
       ncclCommCounter_(0),
       terminateWatchdog_(false),
-      opTimeout_(opTimeout) {
+      opTimeout_(opTimeout),
+      commsPerDevice_(commsPerDevice),
+      isHighPriorityStream_(isHighPriorityStream) {
+  if (commsPerDevice_ < 1) {
+    throw std::invalid_argument(
+        "ProcessGroupNCCL needs at least one communicator per device");
+  }
   char* blockingWait = getenv(NCCL_BLOCKING_WAIT);
   try {
     if (blockingWait != nullptr) {
@@ -455,6 +516,39 @@ void ProcessGroupNCCL::broadcastUniqueNCCLID(ncclUniqueId* ncclID) {
   }
 }
 
+ProcessGroupNCCL::CommTagGuard::CommTagGuard(int64_t tag) : prevTag_(commTag) {
+  if (tag < 0) {
+    throw std::invalid_argument("Communicator tags must be non-negative");
+  }
+  commTag = tag;
+}
+
+ProcessGroupNCCL::CommTagGuard::~CommTagGuard() {
+  commTag = prevTag_;
+}
+
+std::string ProcessGroupNCCL::getPooledCommKey(
+    const std::string& devicesKey,
+    const std::vector<at::Device>& devices) {
+  if (commsPerDevice_ == 1) {
+    return devicesKey;
+  }
+
+  std::lock_guard<std::mutex> lock(commPoolMutex_);
+  auto it = nextPooledComm_.find(devicesKey);
+  if (it == nextPooledComm_.end()) {
+    // Create the whole pool at once, so that its communicators are created
+    // in the same order on all ranks whichever thread gets here first.
+    for (int i = 0; i < commsPerDevice_; i++) {
+      getNCCLComm(getPooledKey(devicesKey, i), devices);
+    }
+    it = nextPooledComm_.emplace(devicesKey, 0).first;
+  }
+  const auto index = commTag >= 0 ? commTag % commsPerDevice_
+                                   : it->second++ % commsPerDevice_;
+  return getPooledKey(devicesKey, static_cast<int>(index));
+}
+
 std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
     const std::string& devicesKey,
     const std::vector<at::Device>& devices) {
@@ -508,7 +602,7 @@ std::vector<std::shared_ptr<NCCLComm>>& ProcessGroupNCCL::getNCCLComm(
     ncclComms[i] = NCCLComm::create(numRanks, rank, ncclID);
 
     // Creates the NCCL streams
-    streamVal.push_back(at::cuda::getStreamFromPool());
+    streamVal.push_back(at::cuda::getStreamFromPool(isHighPriorityStream_));
   }
 
   C10D_NCCL_CHECK(ncclGroupEnd());
@@ -631,7 +725,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::collective(
     PreProcess pre,
     PostProcess post) {
   const auto devices = getDeviceList(inputs);
-  const auto key = getKeyFromDevices(devices);
+  const auto key = getPooledCommKey(getKeyFromDevices(devices), devices);
   auto& ncclComms = getNCCLComm(key, devices);
 
   // First let NCCL streams wait for input tensors allocation streams
@@ -945,12 +1039,195 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::recvAnysource(
   throw std::runtime_error("ProcessGroupNCCL does not support recv");
 }
 
-std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather_base(
-    at::Tensor& /*unused */,
-    at::Tensor& /*unused */,
-    const AllgatherOptions& /*unused */) {
+#ifdef ENABLE_NCCL_P2P_SUPPORT
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall_base(
+    at::Tensor& outputTensor,
+    at::Tensor& inputTensor,
+    std::vector<int64_t>& outputSplitSizes,
+    std::vector<int64_t>& inputSplitSizes,
+    const AllToAllOptions& /* unused */) {
+  if (inputTensor.scalar_type() != outputTensor.scalar_type()) {
+    throw std::runtime_error(
+        "output tensor must have the same type as input tensor");
+  }
+  checkSplitSizes(inputSplitSizes, inputTensor, size_);
+  checkSplitSizes(outputSplitSizes, outputTensor, size_);
+
+  auto inputTensors = std::vector<at::Tensor>{inputTensor};
+  auto outputTensors = std::vector<at::Tensor>{outputTensor};
+  check_gpu_tensors(inputTensors);
+  check_gpu_tensors(outputTensors);
+
+  std::vector<size_t> sendLengths(size_);
+  std::vector<size_t> sendOffsets(size_);
+  std::vector<size_t> recvLengths(size_);
+  std::vector<size_t> recvOffsets(size_);
+  computeLengthsAndOffsets(
+      inputSplitSizes, inputTensor, &sendLengths, &sendOffsets);
+  computeLengthsAndOffsets(
+      outputSplitSizes, outputTensor, &recvLengths, &recvOffsets);
+
+  return collective(
+      inputTensors,
+      outputTensors,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        c10::cuda::CUDACachingAllocator::recordStream(
+            output.storage().data_ptr(), stream);
+        return ncclAlltoallv(
+            input.data_ptr(),
+            sendLengths.data(),
+            sendOffsets.data(),
+            output.data_ptr(),
+            recvLengths.data(),
+            recvOffsets.data(),
+            input.element_size(),
+            getNcclDataType(input.scalar_type()),
+            comm,
+            stream.stream());
+      });
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall(
+    std::vector<at::Tensor>& outputTensors,
+    std::vector<at::Tensor>& inputTensors,
+    const AllToAllOptions& /* unused */) {
+  if (outputTensors.size() != static_cast<size_t>(size_) ||
+      inputTensors.size() != static_cast<size_t>(size_)) {
+    throw std::runtime_error(
+        "Number of input and output tensors must be equal to group size");
+  }
+  const auto& first = inputTensors.front();
+  const auto check = [&first](const std::vector<at::Tensor>& tensors) {
+    for (const auto& t : tensors) {
+      if (!t.is_cuda() || t.is_sparse()) {
+        throw std::runtime_error("Tensors must be CUDA and dense");
+      }
+      if (!t.options().type_equal(first.options()) ||
+          t.get_device() != first.get_device()) {
+        throw std::runtime_error(
+            "Tensors must have identical type and reside on the same device");
+      }
+    }
+  };
+  check(inputTensors);
+  check(outputTensors);
+
+  // The tensors can have a different size for every rank, so they are
+  // exchanged as the splits of a single flattened input and output.
+  std::vector<size_t> sendLengths(size_);
+  std::vector<size_t> sendOffsets(size_);
+  std::vector<size_t> recvLengths(size_);
+  std::vector<size_t> recvOffsets(size_);
+  size_t recvTotal = 0;
+  for (int r = 0; r < size_; r++) {
+    sendLengths[r] = inputTensors[r].numel();
+    sendOffsets[r] = r == 0 ? 0 : sendOffsets[r - 1] + sendLengths[r - 1];
+    recvLengths[r] = outputTensors[r].numel();
+    recvOffsets[r] = recvTotal;
+    recvTotal += recvLengths[r];
+  }
+  auto inputFlattened = std::vector<at::Tensor>{
+      flattenDenseTensors(inputTensors)};
+  auto outputFlattened = std::vector<at::Tensor>{at::empty(
+      {static_cast<int64_t>(recvTotal)}, outputTensors.front().options())};
+
+  return collective(
+      inputFlattened,
+      outputFlattened,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        c10::cuda::CUDACachingAllocator::recordStream(
+            output.storage().data_ptr(), stream);
+        return ncclAlltoallv(
+            input.data_ptr(),
+            sendLengths.data(),
+            sendOffsets.data(),
+            output.data_ptr(),
+            recvLengths.data(),
+            recvOffsets.data(),
+            input.element_size(),
+            getNcclDataType(input.scalar_type()),
+            comm,
+            stream.stream());
+      },
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {},
+      [&](std::vector<at::cuda::CUDAStream>& ncclStreams) {
+        // Copy the flattened output to the output tensors.
+        at::cuda::CUDAStreamGuard guard(ncclStreams[0]);
+        for (int r = 0; r < size_; r++) {
+          // See [Sync Streams].
+          c10::cuda::CUDACachingAllocator::recordStream(
+              outputTensors[r].storage().data_ptr(), ncclStreams[0]);
+          outputTensors[r].copy_(
+              outputFlattened[0]
+                  .narrow(0, recvOffsets[r], recvLengths[r])
+                  .view(outputTensors[r].sizes()),
+              true);
+        }
+      });
+}
+#else
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall_base(
+    at::Tensor& /* unused */,
+    at::Tensor& /* unused */,
+    std::vector<int64_t>& /* unused */,
+    std::vector<int64_t>& /* unused */,
+    const AllToAllOptions& /* unused */) {
   throw std::runtime_error(
-      "no support for allgather_base in NCCL process group");
+      "ProcessGroupNCCL only supports alltoall* for NCCL lib version >= 2.7.0");
+}
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::alltoall(
+    std::vector<at::Tensor>& /* unused */,
+    std::vector<at::Tensor>& /* unused */,
+    const AllToAllOptions& /* unused */) {
+  throw std::runtime_error(
+      "ProcessGroupNCCL only supports alltoall* for NCCL lib version >= 2.7.0");
+}
+#endif
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupNCCL::allgather_base(
+    at::Tensor& outputBuffer,
+    at::Tensor& inputBuffer,
+    const AllgatherOptions& /* unused */) {
+  if (inputBuffer.scalar_type() != outputBuffer.scalar_type()) {
+    throw std::runtime_error(
+        "output tensor must have the same type as input tensor");
+  }
+  if (inputBuffer.numel() * size_ != outputBuffer.numel()) {
+    throw std::runtime_error(
+        "output tensor size must be equal to world_size times input tensor size");
+  }
+
+  // Unlike allgather, the output is gathered into a single buffer, so that
+  // no copy out of a flattened buffer is needed.
+  auto inputTensors = std::vector<at::Tensor>{inputBuffer};
+  auto outputTensors = std::vector<at::Tensor>{outputBuffer};
+  check_gpu_tensors(inputTensors);
+  check_gpu_tensors(outputTensors);
+
+  return collective(
+      inputTensors,
+      outputTensors,
+      [&](at::Tensor& input,
+          at::Tensor& output,
+          ncclComm_t comm,
+          at::cuda::CUDAStream& stream) {
+        c10::cuda::CUDACachingAllocator::recordStream(
+            output.storage().data_ptr(), stream);
+        return ncclAllGather(
+            input.data_ptr(),
+            output.data_ptr(),
+            input.numel(),
+            getNcclDataType(input.scalar_type()),
+            comm,
+            stream.stream());
+      });
 }
 
 } // namespace c10d
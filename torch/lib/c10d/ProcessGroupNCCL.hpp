@@ -140,12 +140,29 @@ class ProcessGroupNCCL : public ProcessGroup {
   // against a different set of devices, the process group creates another NCCL
   // communicator. These NCCL communicators are cached and reused if possible.
   //
+  // Every communicator runs its collectives on its own NCCL stream, so all
+  // collectives on the same set of devices are serialized. With
+  // `commsPerDevice` > 1 the process group keeps a pool of that many
+  // communicators (and streams) per set of devices, created together on the
+  // first collective on those devices, and assigns collectives to them
+  // round-robin, or by the tag of a `CommTagGuard`. Collectives on different
+  // communicators can then run concurrently, which also means that they are
+  // no longer ordered: a collective that consumes the result of another has
+  // to wait on its work first.
+  //
+  // With `isHighPriorityStream` the NCCL streams come from the high priority
+  // stream pool, so that the GPU schedules communication kernels ahead of
+  // pending compute kernels (e.g. the backward GEMMs that DDP overlaps with
+  // its allreduces) instead of queuing them behind.
+  //
   ProcessGroupNCCL(
       const std::shared_ptr<Store>& store,
       int rank,
       int size,
       const std::chrono::milliseconds& opTimeout =
-          std::chrono::milliseconds(kProcessGroupNCCLOpTimeoutMillis));
+          std::chrono::milliseconds(kProcessGroupNCCLOpTimeoutMillis),
+      int commsPerDevice = 1,
+      bool isHighPriorityStream = false);
 
   // This constructor includes the deprecated `groupName` argument.
   // If you have existing code that uses the `groupName`, you can replace
@@ -161,6 +178,20 @@ class ProcessGroupNCCL : public ProcessGroup {
 
   virtual ~ProcessGroupNCCL();
 
+  // While in scope, assigns the collectives that the current thread issues
+  // on process groups with a communicator pool to the communicator with
+  // index `tag % commsPerDevice`, instead of round-robin. Threads that issue
+  // collectives concurrently must use distinct tags, since the collectives
+  // on each communicator have to be issued in the same order on all ranks.
+  class CommTagGuard {
+   public:
+    explicit CommTagGuard(int64_t tag);
+    ~CommTagGuard();
+
+   private:
+    int64_t prevTag_;
+  };
+
   std::shared_ptr<ProcessGroup::Work> broadcast(
       std::vector<at::Tensor>& tensors,
       const BroadcastOptions& opts = BroadcastOptions()) override;
@@ -193,6 +224,18 @@ class ProcessGroupNCCL : public ProcessGroup {
       std::vector<at::Tensor>& inputTensors,
       const AllgatherOptions& opts = AllgatherOptions()) override;
 
+  std::shared_ptr<ProcessGroup::Work> alltoall_base(
+      at::Tensor& outputTensor,
+      at::Tensor& inputTensor,
+      std::vector<int64_t>& outputSplitSizes,
+      std::vector<int64_t>& inputSplitSizes,
+      const AllToAllOptions& opts = AllToAllOptions()) override;
+
+  std::shared_ptr<ProcessGroup::Work> alltoall(
+      std::vector<at::Tensor>& outputTensors,
+      std::vector<at::Tensor>& inputTensors,
+      const AllToAllOptions& opts = AllToAllOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> reduce_scatter(
       std::vector<at::Tensor>& outputTensors,
       std::vector<std::vector<at::Tensor>>& inputTensors,
@@ -238,6 +281,13 @@ class ProcessGroupNCCL : public ProcessGroup {
       const std::string& devicesKey,
       const std::vector<at::Device>& devices);
 
+  // Returns the key of the communicator in the pool of `devicesKey` that the
+  // next collective runs on (see `commsPerDevice`), creating the pool first
+  // if needed.
+  std::string getPooledCommKey(
+      const std::string& devicesKey,
+      const std::vector<at::Device>& devices);
+
   // Wrapper method which can be overridden for tests.
   virtual std::exception_ptr checkForNCCLErrors(
       const std::vector<std::shared_ptr<NCCLComm>>& ncclComms);
@@ -372,6 +422,20 @@ class ProcessGroupNCCL : public ProcessGroup {
   // Timeout for operations. This is only used when blockingWait_ is enabled.
   std::chrono::milliseconds opTimeout_;
 
+  // Number of communicators per set of devices.
+  const int commsPerDevice_;
+
+  // Whether the NCCL streams are high priority streams.
+  const bool isHighPriorityStream_;
+
+  // Round-robin counter of the communicator pool for every set of devices.
+  // A set of devices has an entry once its pool has been created.
+  std::unordered_map<std::string, uint64_t> nextPooledComm_;
+
+  // Serializes the creation of communicator pools, so that their
+  // communicators are created in the same order on all ranks.
+  std::mutex commPoolMutex_;
+
   // Set of communicators that this process group has aborted and their
   // ncclUniqueId has been written to the store. We don't need a lock
   // for this map since only the watchdog thread accesses this set. The
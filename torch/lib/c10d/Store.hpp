@@ -38,6 +38,16 @@ class Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) = 0;
 
+  // Sets or gets multiple keys at once. Stores that talk to a remote
+  // server override these to do so in a single round trip; the default
+  // implementations call `set` and `get` for every key.
+  virtual void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
+  virtual std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys);
+
   void setTimeout(const std::chrono::milliseconds& timeout);
 
  protected:
@@ -1,6 +1,9 @@
 #include <c10d/TCPStore.hpp>
 
 #include <poll.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
 
 #include <unistd.h>
 #include <algorithm>
@@ -10,7 +13,15 @@ namespace c10d {
 
 namespace {
 
-enum class QueryType : uint8_t { SET, GET, ADD, CHECK, WAIT };
+enum class QueryType : uint8_t {
+  SET,
+  GET,
+  ADD,
+  CHECK,
+  WAIT,
+  MULTI_SET,
+  MULTI_GET
+};
 
 enum class CheckResponseType : uint8_t { READY, NOT_READY };
 
@@ -38,9 +49,7 @@ TCPStoreDaemon::~TCPStoreDaemon() {
   join();
   // Close unclosed sockets
   for (auto socket : sockets_) {
-    if (socket != -1) {
-      ::close(socket);
-    }
+    ::close(socket);
   }
   // Now close the rest control pipe
   for (auto fd : controlPipeFd_) {
@@ -54,17 +63,87 @@ void TCPStoreDaemon::join() {
   daemonThread_.join();
 }
 
+#ifdef __linux__
+void TCPStoreDaemon::run() {
+  int epollFd;
+  SYSCHECK_ERR_RETURN_NEG1(epollFd = ::epoll_create1(EPOLL_CLOEXEC));
+  ResourceGuard epollGuard([epollFd] { ::close(epollFd); });
+
+  const auto watch = [epollFd](int fd) {
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    SYSCHECK_ERR_RETURN_NEG1(::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event));
+  };
+  watch(storeListenSocket_);
+  // Watch the read end of the pipe to signal the stopping of the daemon run
+  watch(controlPipeFd_[0]);
+
+  // epoll only returns the sockets that have an event, so the cost of
+  // an iteration doesn't grow with the number of connected clients.
+  // Closed sockets are removed from the epoll set by the kernel.
+  constexpr int kMaxEvents = 256;
+  std::vector<struct epoll_event> events(kMaxEvents);
+
+  // receive the queries
+  while (true) {
+    int numEvents;
+    SYSCHECK_ERR_RETURN_NEG1(
+        numEvents = ::epoll_wait(epollFd, events.data(), kMaxEvents, -1));
+
+    for (int i = 0; i < numEvents; i++) {
+      const auto fd = events[i].data.fd;
+      const auto revents = events[i].events;
+
+      // TCPStore's listening socket has an event and it should now be able
+      // to accept new connections.
+      if (fd == storeListenSocket_) {
+        if (revents ^ EPOLLIN) {
+          throw std::system_error(
+              ECONNABORTED,
+              std::system_category(),
+              "Unexpected epoll event on the master's listening socket: " +
+                  std::to_string(revents));
+        }
+        watch(accept());
+        continue;
+      }
+
+      // The pipe receives an event which tells us to shutdown the daemon
+      if (fd == controlPipeFd_[0]) {
+        // Will be EPOLLHUP when the pipe is closed
+        if (revents ^ EPOLLHUP) {
+          throw std::system_error(
+              ECONNABORTED,
+              std::system_category(),
+              "Unexpected epoll event on the control pipe's reading fd: " +
+                  std::to_string(revents));
+        }
+        return;
+      }
+
+      // Now query the socket that has the event
+      try {
+        query(fd);
+      } catch (...) {
+        // See the comment in the poll based loop below.
+        close(fd);
+      }
+    }
+  }
+}
+#else
 void TCPStoreDaemon::run() {
   std::vector<struct pollfd> fds;
-  fds.push_back({.fd = storeListenSocket_, .events = POLLIN});
-  // Push the read end of the pipe to signal the stopping of the daemon run
-  fds.push_back({.fd = controlPipeFd_[0], .events = POLLHUP});
 
   // receive the queries
-  bool finished = false;
-  while (!finished) {
-    for (size_t i = 0; i < sockets_.size(); i++) {
-      fds[i].revents = 0;
+  while (true) {
+    fds.clear();
+    fds.push_back({.fd = storeListenSocket_, .events = POLLIN});
+    // Push the read end of the pipe to signal the stopping of the daemon run
+    fds.push_back({.fd = controlPipeFd_[0], .events = POLLHUP});
+    for (auto socket : sockets_) {
+      fds.push_back({.fd = socket, .events = POLLIN});
     }
 
     SYSCHECK_ERR_RETURN_NEG1(::poll(fds.data(), fds.size(), -1));
@@ -79,9 +158,7 @@ void TCPStoreDaemon::run() {
             "Unexpected poll revent on the master's listening socket: " +
                 std::to_string(fds[0].revents));
       }
-      int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
-      sockets_.push_back(sockFd);
-      fds.push_back({.fd = sockFd, .events = POLLIN});
+      accept();
     }
     // The pipe receives an event which tells us to shutdown the daemon
     if (fds[1].revents != 0) {
@@ -93,8 +170,7 @@ void TCPStoreDaemon::run() {
             "Unexpected poll revent on the control pipe's reading fd: " +
                 std::to_string(fds[1].revents));
       }
-      finished = true;
-      break;
+      return;
     }
     // Skipping the fds[0] and fds[1],
     // fds[0] is master's listening socket
@@ -115,37 +191,41 @@ void TCPStoreDaemon::run() {
         // exception, other connections will get an exception once they try to
         // use the store. We will go ahead and close this connection whenever
         // we hit an exception here.
-        ::close(fds[fdIdx].fd);
-
-        // Remove all the tracking state of the close FD
-        for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
-          for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
-            if (*vecIt == fds[fdIdx].fd) {
-              vecIt = it->second.erase(vecIt);
-            } else {
-              ++vecIt;
-            }
-          }
-          if (it->second.size() == 0) {
-            it = waitingSockets_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        for (auto it = keysAwaited_.begin(); it != keysAwaited_.end();) {
-          if (it->first == fds[fdIdx].fd) {
-            it = keysAwaited_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        fds.erase(fds.begin() + fdIdx);
-        sockets_.erase(sockets_.begin() + fdIdx - 2);
-        --fdIdx;
+        close(fds[fdIdx].fd);
+      }
+    }
+  }
+}
+#endif
+
+int TCPStoreDaemon::accept() {
+  int socket = std::get<0>(tcputil::accept(storeListenSocket_));
+  sockets_.insert(socket);
+  return socket;
+}
+
+void TCPStoreDaemon::close(int socket) {
+  ::close(socket);
+  sockets_.erase(socket);
+
+  // Remove all the tracking state of the closed socket
+  auto keys = socketKeys_.find(socket);
+  if (keys != socketKeys_.end()) {
+    for (const auto& key : keys->second) {
+      auto waiting = waitingSockets_.find(key);
+      if (waiting == waitingSockets_.end()) {
         continue;
       }
+      auto& sockets = waiting->second;
+      sockets.erase(
+          std::remove(sockets.begin(), sockets.end(), socket), sockets.end());
+      if (sockets.empty()) {
+        waitingSockets_.erase(waiting);
+      }
     }
+    socketKeys_.erase(keys);
   }
+  keysAwaited_.erase(socket);
 }
 
 void TCPStoreDaemon::stop() {
@@ -159,8 +239,10 @@ void TCPStoreDaemon::stop() {
 // query communicates with the worker. The format
 // of the query is as follows:
 // type of query | size of arg1 | arg1 | size of arg2 | arg2 | ...
-// or, in the case of wait
+// or, in the case of check, wait and multi get
 // type of query | number of args | size of arg1 | arg1 | ...
+// or, in the case of multi set
+// type of query | number of keys | size of key1 | key1 | size of value1 | ...
 void TCPStoreDaemon::query(int socket) {
   QueryType qt;
   tcputil::recvBytes<QueryType>(socket, &qt, 1);
@@ -180,6 +262,12 @@ void TCPStoreDaemon::query(int socket) {
   } else if (qt == QueryType::WAIT) {
     waitHandler(socket);
 
+  } else if (qt == QueryType::MULTI_SET) {
+    multiSetHandler(socket);
+
+  } else if (qt == QueryType::MULTI_GET) {
+    multiGetHandler(socket);
+
   } else {
     throw std::runtime_error("Unexpected query type");
   }
@@ -190,6 +278,8 @@ void TCPStoreDaemon::wakeupWaitingClients(const std::string& key) {
   if (socketsToWait != waitingSockets_.end()) {
     for (int socket : socketsToWait->second) {
       if (--keysAwaited_[socket] == 0) {
+        keysAwaited_.erase(socket);
+        socketKeys_.erase(socket);
         tcputil::sendValue<WaitResponseType>(
             socket, WaitResponseType::STOP_WAITING);
       }
@@ -229,12 +319,7 @@ void TCPStoreDaemon::getHandler(int socket) const {
 }
 
 void TCPStoreDaemon::checkHandler(int socket) const {
-  SizeType nargs;
-  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
-  std::vector<std::string> keys(nargs);
-  for (size_t i = 0; i < nargs; i++) {
-    keys[i] = tcputil::recvString(socket);
-  }
+  auto keys = recvKeys(socket);
   // Now we have received all the keys
   if (checkKeys(keys)) {
     tcputil::sendValue<CheckResponseType>(socket, CheckResponseType::READY);
@@ -244,23 +329,54 @@ void TCPStoreDaemon::checkHandler(int socket) const {
 }
 
 void TCPStoreDaemon::waitHandler(int socket) {
-  SizeType nargs;
-  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
-  std::vector<std::string> keys(nargs);
-  for (size_t i = 0; i < nargs; i++) {
-    keys[i] = tcputil::recvString(socket);
+  auto keys = recvKeys(socket);
+  // Only wait on the keys that are missing; the others won't be set again
+  std::vector<std::string> missingKeys;
+  for (auto& key : keys) {
+    if (tcpStore_.count(key) == 0) {
+      missingKeys.push_back(std::move(key));
+    }
   }
-  if (checkKeys(keys)) {
+  if (missingKeys.empty()) {
     tcputil::sendValue<WaitResponseType>(
         socket, WaitResponseType::STOP_WAITING);
   } else {
-    for (auto& key : keys) {
+    for (auto& key : missingKeys) {
       waitingSockets_[key].push_back(socket);
     }
-    keysAwaited_[socket] = keys.size();
+    keysAwaited_[socket] = missingKeys.size();
+    socketKeys_[socket] = std::move(missingKeys);
+  }
+}
+
+void TCPStoreDaemon::multiSetHandler(int socket) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  for (size_t i = 0; i < nargs; i++) {
+    std::string key = tcputil::recvString(socket);
+    tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
+    wakeupWaitingClients(key);
+  }
+}
+
+void TCPStoreDaemon::multiGetHandler(int socket) const {
+  auto keys = recvKeys(socket);
+  for (size_t i = 0; i < keys.size(); i++) {
+    tcputil::sendVector<uint8_t>(
+        socket, tcpStore_.at(keys[i]), (i != (keys.size() - 1)));
   }
 }
 
+std::vector<std::string> TCPStoreDaemon::recvKeys(int socket) const {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  std::vector<std::string> keys(nargs);
+  for (size_t i = 0; i < nargs; i++) {
+    keys[i] = tcputil::recvString(socket);
+  }
+  return keys;
+}
+
 bool TCPStoreDaemon::checkKeys(const std::vector<std::string>& keys) const {
   return std::all_of(keys.begin(), keys.end(), [this](const std::string& s) {
     return tcpStore_.count(s) > 0;
@@ -382,6 +498,45 @@ bool TCPStore::check(const std::vector<std::string>& keys) {
   }
 }
 
+void TCPStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument("multiSet: number of keys and values differ");
+  }
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_SET);
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    std::string regKey = regularPrefix_ + keys[i];
+    tcputil::sendString(storeSocket_, regKey, true);
+    tcputil::sendVector<uint8_t>(storeSocket_, values[i], (i != (nkeys - 1)));
+  }
+}
+
+std::vector<std::vector<uint8_t>> TCPStore::multiGet(
+    const std::vector<std::string>& keys) {
+  std::vector<std::string> regKeys;
+  regKeys.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    regKeys[i] = regularPrefix_ + keys[i];
+  }
+  waitHelper_(regKeys, timeout_);
+
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_GET);
+  SizeType nkeys = regKeys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, regKeys[i], (i != (nkeys - 1)));
+  }
+  std::vector<std::vector<uint8_t>> values;
+  values.reserve(nkeys);
+  for (size_t i = 0; i < nkeys; i++) {
+    values.push_back(tcputil::recvVector<uint8_t>(storeSocket_));
+  }
+  return values;
+}
+
 void TCPStore::wait(const std::vector<std::string>& keys) {
   wait(keys, timeout_);
 }
@@ -3,6 +3,7 @@
 #include <memory>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <c10d/Store.hpp>
 #include <c10d/Utils.hpp>
@@ -20,6 +21,11 @@ class TCPStoreDaemon {
   void run();
   void stop();
 
+  // Accepts a new connection on the listening socket.
+  int accept();
+  // Closes a client socket and drops the keys it was waiting on.
+  void close(int socket);
+
   void query(int socket);
 
   void setHandler(int socket);
@@ -27,7 +33,10 @@ class TCPStoreDaemon {
   void getHandler(int socket) const;
   void checkHandler(int socket) const;
   void waitHandler(int socket);
+  void multiSetHandler(int socket);
+  void multiGetHandler(int socket) const;
 
+  std::vector<std::string> recvKeys(int socket) const;
   bool checkKeys(const std::vector<std::string>& keys) const;
   void wakeupWaitingClients(const std::string& key);
 
@@ -37,8 +46,10 @@ class TCPStoreDaemon {
   std::unordered_map<std::string, std::vector<int>> waitingSockets_;
   // From socket -> number of keys awaited
   std::unordered_map<int, size_t> keysAwaited_;
+  // From socket -> the keys it is waiting on, to clean up on close
+  std::unordered_map<int, std::vector<std::string>> socketKeys_;
 
-  std::vector<int> sockets_;
+  std::unordered_set<int> sockets_;
   int storeListenSocket_;
   std::vector<int> controlPipeFd_{-1, -1};
 };
@@ -69,6 +80,13 @@ class TCPStore : public Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) override;
 
+  void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values) override;
+
+  std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys) override;
+
   // Waits for all workers to join.
   void waitForWorkers();
 
@@ -354,6 +354,62 @@ std::vector<T*> getDataPointers(const std::vector<at::Tensor>& tensors) {
   return ptrs;
 }
 
+// Checks that the split sizes of an alltoall_base tensor partition its first
+// dimension into one split per rank. An empty list of split sizes stands for
+// equal splits.
+inline void checkSplitSizes(
+    const std::vector<int64_t>& split_sizes,
+    const at::Tensor& tensor,
+    int group_size) {
+  if (split_sizes.size() == 0) {
+    if (tensor.dim() == 0 || tensor.size(0) % group_size != 0) {
+      throw std::invalid_argument(
+          "Tensor's dim 0 does not divide equally across group size");
+    }
+  } else {
+    if (split_sizes.size() != static_cast<size_t>(group_size)) {
+      throw std::invalid_argument(
+          "Number of tensor splits not equal to group size");
+    }
+    int64_t sum = 0;
+    for (const auto split_size : split_sizes) {
+      if (split_size < 0) {
+        throw std::invalid_argument("Split sizes must be non-negative");
+      }
+      sum += split_size;
+    }
+    if (tensor.dim() == 0 || sum != tensor.size(0)) {
+      throw std::invalid_argument(
+          "Split sizes doesn't match total dim 0 size");
+    }
+  }
+}
+
+// Computes the number of elements and the element offset of every split of
+// an alltoall_base tensor (see `checkSplitSizes`), and returns the total
+// number of elements.
+template <typename T>
+size_t computeLengthsAndOffsets(
+    const std::vector<int64_t>& split_sizes,
+    const at::Tensor& tensor,
+    std::vector<T>* lengths,
+    std::vector<T>* offsets) {
+  const size_t group_size = lengths->size();
+  const bool equal_splits = split_sizes.size() == 0;
+  const size_t dim0_size = tensor.size(0);
+  const size_t row_size = dim0_size ? tensor.numel() / dim0_size : 1;
+  const size_t split_size = equal_splits ? dim0_size / group_size : 0;
+  size_t offset = 0;
+  for (size_t i = 0; i < group_size; i++) {
+    const size_t length =
+        row_size * (equal_splits ? split_size : split_sizes[i]);
+    (*lengths)[i] = length;
+    (*offsets)[i] = offset;
+    offset += length;
+  }
+  return offset;
+}
+
 using RankType = uint32_t;
 using PortType = uint16_t;
 using SizeType = uint64_t;
@@ -25,8 +25,9 @@ void waitWork(
   }
 }
 
-void testAllreduce(int iter = 1000) {
-  auto pg = c10d::ProcessGroupMPI::createProcessGroupMPI();
+void testAllreduce(int iter = 1000, int numWorkerThreads = 1) {
+  auto pg =
+      c10d::ProcessGroupMPI::createProcessGroupMPI({}, numWorkerThreads);
   // Generate inputs
   std::vector<std::vector<at::Tensor>> allTensors(iter);
   for (auto i = 0; i < iter; ++i) {
@@ -349,6 +350,13 @@ int main(int argc, char** argv) {
   testSendRecv(false);
   testSendRecv(true);
 
+  // Independent collectives on several worker threads.
+  int threadSupport = 0;
+  MPI_Query_thread(&threadSupport);
+  if (threadSupport >= MPI_THREAD_MULTIPLE) {
+    testAllreduce(1000, 4);
+  }
+
   std::cout << "Test successful" << std::endl;
 #else
   std::cout << "MPI executable not found, skipping test" << std::endl;
@@ -116,3 +116,40 @@ TEST(TCPStoreTest, testHelper) {
 TEST(TCPStoreTest, testHelperPrefix) {
   testHelper("testPrefix");
 }
+
+TEST(TCPStoreTest, testMultiSetMultiGet) {
+  auto serverTCPStore = std::make_shared<c10d::TCPStore>(
+      "127.0.0.1",
+      0,
+      1,
+      true,
+      std::chrono::seconds(30),
+      /* wait */ false);
+  auto clientTCPStore = std::make_shared<c10d::TCPStore>(
+      "127.0.0.1", serverTCPStore->getPort(), 1, false);
+  c10d::PrefixStore serverStore("testPrefix", serverTCPStore);
+  c10d::PrefixStore clientStore("testPrefix", clientTCPStore);
+
+  std::vector<std::string> keys;
+  std::vector<std::vector<uint8_t>> values;
+  for (auto i = 0; i < 100; i++) {
+    auto value = "value" + std::to_string(i);
+    keys.push_back("key" + std::to_string(i));
+    values.emplace_back(value.begin(), value.end());
+  }
+  clientStore.multiSet(keys, values);
+  EXPECT_EQ(serverStore.multiGet(keys), values);
+  EXPECT_TRUE(serverStore.multiGet({}).empty());
+  c10d::test::check(serverStore, "key42", "value42");
+
+  // Waiting on a mix of present and missing keys returns once the
+  // missing ones are set.
+  auto waiter = std::thread(
+      [&clientStore] { clientStore.wait({"key0", "late0", "late1"}); });
+  c10d::test::set(serverStore, "late1", "1");
+  c10d::test::set(serverStore, "late0", "0");
+  waiter.join();
+
+  EXPECT_THROW(
+      clientStore.multiSet({"key0"}, {}), std::invalid_argument);
+}
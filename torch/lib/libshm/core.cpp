@@ -1,11 +1,19 @@
+#include <cstdlib>
 #include <cstring>
+#include <iterator>
+#include <map>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
+
+#include <sys/mman.h>
 
 #include <TH/TH.h>
 #include <libshm/err.h>
 #include <libshm/socket.h>
 #include <libshm/libshm.h>
+#include <torch/data/detail/shared_memory.h>
 
 std::unordered_map<std::string, ClientSocket> managers;
 std::string manager_executable_path;
@@ -74,11 +82,115 @@ ClientSocket& get_manager_socket(const std::string& manager_handle) {
   }
 }
 
+namespace {
+
+// Granularity of the sizes of reusable segments. Segments take whole pages
+// anyway, and rounding up lets storages of close sizes share segments.
+constexpr ptrdiff_t kSegmentGranularity = 4096;
+
+// The reusable segments that were closed by their last user. The cache holds
+// one reference to each of them, so that nobody unlinks them.
+struct SegmentCache {
+  struct Segment {
+    std::string manager_handle;
+    std::string filename;
+  };
+
+  SegmentCache() : pid(getpid()) {
+    if (const char* env = std::getenv("TORCH_SHM_CACHE_SIZE")) {
+      max_bytes = std::strtoll(env, nullptr, 10);
+    }
+  }
+
+  ~SegmentCache() {
+    // the manager would unlink them when it exits, but it may outlive us
+    if (pid == getpid()) {
+      for (auto& entry : segments) {
+        shm_unlink(entry.second.filename.c_str());
+      }
+    }
+  }
+
+  // A forked child inherits the cache, but the segments belong to its
+  // parent, which may reuse them at any time. Must hold `mutex`.
+  void forget_after_fork() {
+    if (pid != getpid()) {
+      segments.clear();
+      cached_bytes = 0;
+      pid = getpid();
+    }
+  }
+
+  std::mutex mutex;
+  // size of the segments => segments
+  std::multimap<ptrdiff_t, Segment> segments;
+  ptrdiff_t cached_bytes = 0;
+  ptrdiff_t max_bytes = 0;
+  pid_t pid;
+};
+
+SegmentCache& segment_cache() {
+  static SegmentCache cache;
+  return cache;
+}
+
+void free_segment(const SegmentCache::Segment& segment) {
+  shm_unlink(segment.filename.c_str());
+  AllocInfo info = get_alloc_info(segment.filename.c_str());
+  info.free = true;
+  get_manager_socket(segment.manager_handle).register_deallocation(info);
+}
+
+// Adds a segment to the cache, and moves the largest ones to `evicted` if
+// the cache grows past its size; they are to be freed with free_segment().
+// Returns false if the segment alone is too large.
+bool cache_segment(
+    const std::string& manager_handle,
+    const char* filename,
+    ptrdiff_t size,
+    std::vector<SegmentCache::Segment>& evicted) {
+  auto& cache = segment_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.forget_after_fork();
+  if (size > cache.max_bytes) {
+    return false;
+  }
+  cache.segments.emplace(size, SegmentCache::Segment{manager_handle, filename});
+  cache.cached_bytes += size;
+  while (cache.cached_bytes > cache.max_bytes) {
+    auto largest = std::prev(cache.segments.end());
+    cache.cached_bytes -= largest->first;
+    evicted.push_back(std::move(largest->second));
+    cache.segments.erase(largest);
+  }
+  return true;
+}
+
+bool take_cached_segment(ptrdiff_t size, SegmentCache::Segment& segment) {
+  auto& cache = segment_cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.forget_after_fork();
+  auto it = cache.segments.find(size);
+  if (it == cache.segments.end()) {
+    return false;
+  }
+  segment = std::move(it->second);
+  cache.cached_bytes -= size;
+  cache.segments.erase(it);
+  return true;
+}
+
+} // namespace
+
 void libshm_init(const char *manager_exec_path) {
   manager_executable_path = std::string(manager_exec_path);
+  // Lets the C++ DataLoader register the batches of its worker processes
+  // with the manager.
+  torch::data::detail::set_shared_memory_allocator(
+      &THManagedMapAllocator::makeDataPtr);
 }
 
-THManagedMapAllocatorInit::THManagedMapAllocatorInit(const char* manager_handle, const char* filename)
+THManagedMapAllocatorInit::THManagedMapAllocatorInit(const char* manager_handle, const char* filename, bool register_allocation)
   : manager_handle_(manager_handle ? manager_handle : "") {
   // TODO: unlock GIL when contacting the manager
   try {
@@ -93,18 +205,34 @@ THManagedMapAllocatorInit::THManagedMapAllocatorInit(const char* manager_handle,
       manager_handle_ = manager->first;
       socket = &manager->second;
     }
-    AllocInfo info = get_alloc_info(filename);
-    socket->register_allocation(info);
+    if (register_allocation) {
+      AllocInfo info = get_alloc_info(filename);
+      socket->register_allocation(info);
+    }
   } catch(std::exception &e) {
     THError(e.what());
   }
 }
 
-THManagedMapAllocator::THManagedMapAllocator(const char *manager_handle, const char *filename, int flags, ptrdiff_t size)
-  : THManagedMapAllocatorInit(manager_handle, filename), THRefcountedMapAllocator(filename, flags, size) {}
+THManagedMapAllocator::THManagedMapAllocator(const char *manager_handle, const char *filename, int flags, ptrdiff_t size,
+                                             bool register_allocation)
+  : THManagedMapAllocatorInit(manager_handle, filename, register_allocation),
+    THRefcountedMapAllocator(filename, flags, size) {}
 
 void THManagedMapAllocator::close() {
   if (closed_) return;
+  if (reusable_size_ > 0 && increfIfLast()) {
+    // the reference just taken is the one of the cache
+    std::vector<SegmentCache::Segment> evicted;
+    if (cache_segment(manager_handle_, filename(), reusable_size_, evicted)) {
+      THRefcountedMapAllocator::close();
+      for (auto& segment : evicted) {
+        free_segment(segment);
+      }
+      return;
+    }
+    decref();
+  }
   AllocInfo info = get_alloc_info(filename());
   info.free = true;
   ClientSocket &socket = get_manager_socket(manager_handle_);
@@ -121,6 +249,38 @@ at::DataPtr THManagedMapAllocator::makeDataPtr(const char* manager_handle, const
   return {context->data(), context, &deleteTHManagedMapAllocator, at::DeviceType::CPU};
 }
 
+at::DataPtr THManagedMapAllocator::makeReusableDataPtr(const char* filename, ptrdiff_t size) {
+  auto& cache = segment_cache();
+  if (cache.max_bytes <= 0) {
+    return makeDataPtr("", filename, TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_EXCLUSIVE, size);
+  }
+  size = (size + kSegmentGranularity - 1) / kSegmentGranularity * kSegmentGranularity;
+  THManagedMapAllocator* context = nullptr;
+  SegmentCache::Segment segment;
+  if (take_cached_segment(size, segment)) {
+    try {
+      // still registered with the manager, which was never told it is free
+      context = new THManagedMapAllocator(
+          segment.manager_handle.c_str(), segment.filename.c_str(),
+          TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_NOCREATE, size,
+          /*register_allocation=*/false);
+    } catch (const std::exception&) {
+      // e.g. unlinked by someone else; a new segment is created below
+      free_segment(segment);
+    }
+    if (context) {
+      // hands the reference of the cache to the new context
+      context->decref();
+    }
+  }
+  if (!context) {
+    context = new THManagedMapAllocator(
+        "", filename, TH_ALLOCATOR_MAPPED_SHAREDMEM | TH_ALLOCATOR_MAPPED_EXCLUSIVE, size);
+  }
+  context->reusable_size_ = size;
+  return {context->data(), context, &deleteTHManagedMapAllocator, at::DeviceType::CPU};
+}
+
 THManagedMapAllocator* THManagedMapAllocator::fromDataPtr(const at::DataPtr& dptr) {
   return dptr.cast_context<THManagedMapAllocator>(&deleteTHManagedMapAllocator);
 }
@@ -9,25 +9,43 @@ void libshm_init(const char *manager_exec_path);
 // Superclass to run a constructor before THRefcountedMapAllocator
 class THManagedMapAllocatorInit {
 protected:
-  THManagedMapAllocatorInit(const char* manager_handle, const char* filename);
+  THManagedMapAllocatorInit(const char* manager_handle, const char* filename, bool register_allocation);
   std::string manager_handle_;
 };
 
 // Like a THRefcountedMapAllocator, but it also makes use of an external
 // shared memory manager process to ensure that shared memory regions actually
 // get freed in the end (even if processes lose the memory).
+//
+// The segments created by makeReusableDataPtr() are cached by this process
+// when the last process using them closes them, instead of being unlinked,
+// and later handed out again under their own name. This saves the
+// shm_open/ftruncate/unlink calls, the registration with the manager, and
+// faulting in fresh pages for every storage shared in the file_system
+// strategy. The cache is disabled unless TORCH_SHM_CACHE_SIZE sets its size
+// in bytes.
 class THManagedMapAllocator : private THManagedMapAllocatorInit, public THRefcountedMapAllocator {
 public:
-  THManagedMapAllocator(const char* manager_handle, const char* filename, int flags, ptrdiff_t size);
+  THManagedMapAllocator(const char* manager_handle, const char* filename, int flags, ptrdiff_t size,
+                        bool register_allocation = true);
 
   void close() override;
 
   ~THManagedMapAllocator() { close(); }
 
   static at::DataPtr makeDataPtr(const char* manager_handle, const char* filename, int flags, ptrdiff_t size);
+  // Returns a new exclusive segment of at least `size` bytes, registered with
+  // the default manager. It reuses a cached segment if there is one, in which
+  // case `filename` is unused: the name of the segment is the filename() of
+  // the returned context.
+  static at::DataPtr makeReusableDataPtr(const char* filename, ptrdiff_t size);
   static THManagedMapAllocator* fromDataPtr(const at::DataPtr&);
 
   const char* manager_handle() const { return manager_handle_.c_str(); }
+
+private:
+  // size of the segment if it goes back to the cache once closed, 0 otherwise
+  ptrdiff_t reusable_size_ = 0;
 };
 
 #endif
@@ -81,6 +81,30 @@ void free_used_object(const std::string &name) {
   }
 }
 
+// Handles the messages a client has sent so far, and returns false if it
+// has closed the connection.
+bool receive_messages(ClientSession &session) {
+  std::vector<AllocInfo> infos;
+  bool connected;
+  try {
+    connected = session.socket.receive(infos);
+  } catch (std::exception &e) {
+    DEBUG("error receiving from %d: %s", session.pid, e.what());
+    connected = false;
+  }
+  for (auto &info: infos) {
+    session.pid = info.pid;
+    DEBUG("got alloc info: %d %d %s", (int)info.free, info.pid, info.filename);
+    if (info.free) {
+      free_used_object(info.filename);
+    } else {
+      used_objects.insert(info.filename);
+      DEBUG("registered object %s", info.filename);
+    }
+  }
+  return connected;
+}
+
 int main(int argc, char *argv[]) {
   setsid();  // Daemonize the process
 
@@ -116,35 +140,30 @@ int main(int argc, char *argv[]) {
       break;
 
     for (auto &pfd: pollfds) {
-      if (pfd.revents & (POLLERR | POLLHUP)) {
-        // some process died
-        DEBUG("detaching process");
-        auto &session = client_sessions.at(pfd.fd);
-        (void) session;
-        DEBUG("%d has died", session.pid);
-        to_remove.push_back(pfd.fd);
-      } else if (pfd.revents & POLLIN) {
-        if (pfd.fd == srv_socket->socket_fd) {
+      if (pfd.fd == srv_socket->socket_fd) {
+        if (pfd.revents & POLLIN) {
           // someone is joining
           DEBUG("registered new client");
           auto client = srv_socket->accept();
           int fd = client.socket_fd;
           to_add.push_back(fd);
           client_sessions.emplace(fd, std::move(client));
-        } else {
-          // someone wants to register a segment
-          DEBUG("got alloc info");
-          auto &session = client_sessions.at(pfd.fd);
-          AllocInfo info = session.socket.receive();
-          session.pid = info.pid;
-          DEBUG("got alloc info: %d %d %s", (int)info.free, info.pid, info.filename);
-          if (info.free) {
-            free_used_object(info.filename);
-          } else {
-            used_objects.insert(info.filename);
-            DEBUG("registered object %s", info.filename);
-            session.socket.confirm();
-          }
+        }
+      } else if (pfd.revents & (POLLERR | POLLHUP)) {
+        // some process died, but the segments it registered right before
+        // may still be waiting in the socket
+        DEBUG("detaching process");
+        auto &session = client_sessions.at(pfd.fd);
+        while (receive_messages(session)) {}
+        DEBUG("%d has died", session.pid);
+        to_remove.push_back(pfd.fd);
+      } else if (pfd.revents & POLLIN) {
+        // someone wants to register or free segments
+        DEBUG("got alloc info");
+        auto &session = client_sessions.at(pfd.fd);
+        if (!receive_messages(session)) {
+          DEBUG("%d has disconnected", session.pid);
+          to_remove.push_back(pfd.fd);
         }
       }
     }
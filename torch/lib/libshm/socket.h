@@ -10,6 +10,7 @@
 #include <sstream>
 #include <iostream>
 #include <cstring>
+#include <vector>
 
 #include <libshm/err.h>
 #include <libshm/alloc_info.h>
@@ -69,8 +70,14 @@ protected:
     const char *buffer = (const char*)_buffer;
     size_t bytes_sent = 0;
     ssize_t step_sent;
+#ifdef MSG_NOSIGNAL
+    // a dead manager is reported with EPIPE instead of killing us with SIGPIPE
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
     while (bytes_sent < num_bytes) {
-      SYSCHECK_ERR_RETURN_NEG1(step_sent = ::write(socket_fd, buffer, num_bytes));
+      SYSCHECK_ERR_RETURN_NEG1(step_sent = ::send(socket_fd, buffer, num_bytes - bytes_sent, flags));
       bytes_sent += step_sent;
       buffer += step_sent;
     }
@@ -83,16 +90,30 @@ class ManagerSocket: public Socket {
 public:
   explicit ManagerSocket(int fd): Socket(fd) {}
 
-  AllocInfo receive() {
-    AllocInfo info;
-    recv(&info, sizeof(info));
-    return info;
-  }
-
-  void confirm() {
-    send("OK", 2);
+  // Reads the messages that are available without blocking, and appends them
+  // to `infos`. A message may be split across reads, in which case its start
+  // is kept for the next call. Returns false once the other end has closed
+  // the connection and all its messages have been read.
+  bool receive(std::vector<AllocInfo>& infos) {
+    char buffer[64 * sizeof(AllocInfo)];
+    ssize_t step_received;
+    SYSCHECK_ERR_RETURN_NEG1(step_received = ::read(socket_fd, buffer, sizeof(buffer)));
+    if (step_received == 0) {
+      return false;
+    }
+    partial_message_.append(buffer, step_received);
+    const size_t num_messages = partial_message_.size() / sizeof(AllocInfo);
+    for (size_t i = 0; i < num_messages; i++) {
+      AllocInfo info;
+      memcpy(&info, partial_message_.data() + i * sizeof(AllocInfo), sizeof(AllocInfo));
+      infos.push_back(info);
+    }
+    partial_message_.erase(0, num_messages * sizeof(AllocInfo));
+    return true;
   }
 
+private:
+  std::string partial_message_;
 };
 
 
@@ -139,16 +160,43 @@ public:
     }
   }
 
+  ClientSocket(ClientSocket&& other) = default;
+
+  ~ClientSocket() {
+    try {
+      flush();
+    } catch (...) {
+      // the manager unlinks whatever it was not told about when it exits
+    }
+  }
+
+  // Sends the registration right away, along with the pending
+  // deallocations. There is no need to wait for the manager: the message is
+  // in the socket before the segment is created, and the manager reads all
+  // the messages of a client before dropping it, even if the client dies.
   void register_allocation(AllocInfo &info) {
-    char buffer[3] = {0, 0, 0};
-    send(&info, sizeof(info));
-    recv(buffer, 2);
-    if (strcmp(buffer, "OK") != 0)
-      throw std::runtime_error("Shared memory manager didn't respond with an OK");
+    pending_messages_.push_back(info);
+    flush();
   }
 
+  // Deallocations are only hints for the manager to stop tracking segments,
+  // so they are sent in batches.
   void register_deallocation(AllocInfo &info) {
-    send(&info, sizeof(info));
+    pending_messages_.push_back(info);
+    if (pending_messages_.size() >= MAX_PENDING_MESSAGES) {
+      flush();
+    }
+  }
+
+  void flush() {
+    if (pending_messages_.empty() || socket_fd == -1) {
+      return;
+    }
+    send(pending_messages_.data(), pending_messages_.size() * sizeof(AllocInfo));
+    pending_messages_.clear();
   }
 
+private:
+  static constexpr size_t MAX_PENDING_MESSAGES = 64;
+  std::vector<AllocInfo> pending_messages_;
 };
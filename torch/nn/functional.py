@@ -1712,6 +1712,33 @@ def layer_norm(input, normalized_shape, weight=None, bias=None, eps=1e-5):
                             torch.backends.cudnn.enabled)
 
 
+def dropout_add_layer_norm(input, residual, normalized_shape, weight=None, bias=None,
+                           input_bias=None, p=0.5, training=True, eps=1e-5):
+    # type: (Tensor, Tensor, List[int], Optional[Tensor], Optional[Tensor], Optional[Tensor], float, bool, float) -> Tensor
+    r"""Computes ``layer_norm(residual + dropout(input + input_bias, p, training),
+    normalized_shape, weight, bias, eps)``, as found after the attention and
+    feed-forward blocks of a transformer layer.
+
+    On CUDA the bias, dropout, residual add and normalization run as a single
+    kernel, and the backward reuses the dropout mask and the sum computed by
+    the forward.
+
+    Args:
+        input: input to which :attr:`input_bias` and dropout are applied
+        residual: tensor of the same shape as :attr:`input` added after dropout
+        normalized_shape, weight, bias, eps: see :func:`layer_norm`
+        input_bias: optional tensor of shape :attr:`normalized_shape` added to
+            :attr:`input` before dropout. Default: ``None``
+        p: probability of an element to be zeroed. Default: 0.5
+        training: apply dropout if is ``True``. Default: ``True``
+    """
+    if p < 0. or p > 1.:
+        raise ValueError("dropout probability has to be between 0 and 1, "
+                         "but got {}".format(p))
+    return torch.dropout_add_layer_norm(input, residual, normalized_shape, weight, bias,
+                                        input_bias, p, training, eps)
+
+
 def group_norm(input, num_groups, weight=None, bias=None, eps=1e-5):
     # type: (Tensor, int, Optional[Tensor], Optional[Tensor], float) -> Tensor
     r"""Applies Group Normalization for last certain number of dimensions.
@@ -2035,6 +2062,10 @@ def cross_entropy(input, target, weight=None, size_average=None, ignore_index=-1
     """
     if size_average is not None or reduce is not None:
         reduction = _Reduction.legacy_get_string(size_average, reduce)
+    if weight is None and input.dim() == 2 and not (input.is_sparse or input.is_mkldnn or input.is_quantized):
+        # the fused CPU and CUDA kernels never write out the log-probabilities,
+        # which matters for large numbers of classes
+        return torch.softmax_cross_entropy(input, target, _Reduction.get_enum(reduction), ignore_index)
     return nll_loss(log_softmax(input, 1), target, weight, None, ignore_index, None, reduction)
 
 
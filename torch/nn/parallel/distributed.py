@@ -217,6 +217,25 @@ class DistributedDataParallel(Module):
                          are getting different gradients, which should not
                          happen if DistributedDataParallel is correctly used.
                          (default: ``False``)
+        gradient_as_bucket_view (bool): when setting to ``True``, the ``.grad``
+                         of every dense parameter becomes a view into the
+                         buffer that DistributedDataParallel reduces. The
+                         gradients are then accumulated straight into that
+                         buffer and read from it after the reduction, which
+                         saves two copies of all gradients per iteration and
+                         the memory of one. Code that replaces ``.grad`` with
+                         a new tensor still works, but pays for a copy in the
+                         next iteration. (default: ``False``)
+        sparse_densify_threshold (float, optional): the sparse gradients of
+                         consecutive parameters, e.g. of several embedding
+                         tables, are reduced together with a few collectives
+                         rather than one sparse allreduce each. A sparse
+                         gradient whose nonzeros, summed over all processes,
+                         cover more than this fraction of the elements of its
+                         parameter is instead reduced as a dense tensor, which
+                         is cheaper for dense enough gradients. It is still a
+                         sparse tensor afterwards. ``None`` never densifies.
+                         (default: ``None``)
 
     Attributes:
         module (Module): the module to be parallelized
@@ -230,7 +249,9 @@ class DistributedDataParallel(Module):
                  output_device=None, dim=0, broadcast_buffers=True,
                  process_group=None, bucket_cap_mb=25,
                  find_unused_parameters=False,
-                 check_reduction=False):
+                 check_reduction=False,
+                 gradient_as_bucket_view=False,
+                 sparse_densify_threshold=None):
 
         super(DistributedDataParallel, self).__init__()
 
@@ -278,6 +299,8 @@ class DistributedDataParallel(Module):
         self.module = module
         self.broadcast_buffers = broadcast_buffers
         self.find_unused_parameters = find_unused_parameters
+        self.gradient_as_bucket_view = gradient_as_bucket_view
+        self.sparse_densify_threshold = sparse_densify_threshold
         self.require_backward_grad_sync = True
         self.require_forward_param_sync = True
 
@@ -333,6 +356,16 @@ class DistributedDataParallel(Module):
         self.modules_params = [list(m.parameters()) for m in self._module_copies]
         self.modules_buffers = [list(m.buffers()) for m in self._module_copies]
 
+        # The buffers are broadcast from rank 0 before every forward pass. They
+        # are made views of persistent flat buckets, so that the broadcast
+        # runs without flattening and unflattening them on every iteration.
+        self._buffers_broadcast = None
+        if self.broadcast_buffers and len(self.modules_buffers[0]) > 0:
+            self._buffers_broadcast = dist._PersistentBroadcast(
+                self.process_group,
+                self.modules_buffers[0],
+                self.broadcast_bucket_size)
+
         # Build tuple of (module, parameter) for all parameters that require grads.
         modules_and_parameters = [
             [
@@ -369,17 +402,24 @@ class DistributedDataParallel(Module):
         # computation finishes. Experiments showed 1MB is a reasonable value.
         bucket_indices = dist._compute_bucket_assignment_by_size(
             parameters[0],
-            [1024 * 1024, self.bucket_bytes_cap],
+            [dist._DEFAULT_FIRST_BUCKET_BYTES, self.bucket_bytes_cap],
             expect_sparse_gradient[0])
 
         # Note: reverse list of buckets because we want to approximate the
         # order in which their gradients are produced, and assume they
         # are used in the forward pass in the order they are defined.
+        # The reducer rebuilds the buckets in the order it observes in the
+        # first iteration (see ``_rebuild_buckets`` in ``forward``).
         self.reducer = dist.Reducer(
             parameters,
             list(reversed(bucket_indices)),
             self.process_group,
-            expect_sparse_gradient)
+            expect_sparse_gradient,
+            self.gradient_as_bucket_view,
+            self.bucket_bytes_cap,
+            self.find_unused_parameters,
+            float('inf') if self.sparse_densify_threshold is None
+            else self.sparse_densify_threshold)
 
         # passing a handle to torch.nn.SyncBatchNorm layer
         self._passing_sync_batchnorm_handle(self._module_copies)
@@ -389,6 +429,7 @@ class DistributedDataParallel(Module):
         attrs = copy.copy(self.__dict__)
         del attrs['process_group']
         del attrs['reducer']
+        del attrs['_buffers_broadcast']
         return attrs
 
     def __setstate__(self, state):
@@ -397,6 +438,8 @@ class DistributedDataParallel(Module):
         super(DistributedDataParallel, self).__setstate__(state)
         self.__dict__.setdefault('require_forward_param_sync', True)
         self.__dict__.setdefault('require_backward_grad_sync', True)
+        self.__dict__.setdefault('gradient_as_bucket_view', False)
+        self.__dict__.setdefault('sparse_densify_threshold', None)
         self._ddp_init_helper()
 
     def _check_default_group(self):
@@ -437,10 +480,70 @@ class DistributedDataParallel(Module):
         finally:
             self.require_backward_grad_sync = old_require_backward_grad_sync
 
+    def register_builtin_comm_hook(self, hook, matrix_approximation_rank=1):
+        r"""
+        Replaces the allreduce of dense gradient buckets by a built-in
+        communication hook, e.g. one that compresses the gradients, which
+        trades some accuracy for less communication. It can be registered
+        only once, and is not kept when the module is pickled.
+
+        Arguments:
+            hook (str): ``"fp16_compress"`` casts gradients to half precision
+                for the allreduce. ``"powersgd"`` sends low-rank factors of
+                every gradient with at least two dimensions (PowerSGD), and
+                only supports a single device per process.
+                ``"reduce_scatter"`` shards every bucket across the
+                processes and reduces each shard only on the process that
+                owns it, leaving the gradients of the other shards zero;
+                the processes must then call :meth:`sync_sharded_parameters`
+                after every optimizer step. It requires a process group that
+                supports ``reduce_scatter`` and ``_allgather_base`` (NCCL),
+                a single device per process, and an optimizer that updates
+                parameters elementwise (e.g. SGD or Adam).
+            matrix_approximation_rank (int): rank of the factors sent by
+                ``"powersgd"``. (default: 1)
+
+        Example::
+
+            >>> ddp = torch.nn.parallel.DistributedDataParallel(model, device_ids=[rank])
+            >>> ddp.register_builtin_comm_hook("fp16_compress")
+        """
+        if hook == "fp16_compress":
+            self.reducer._register_fp16_compress_hook(self.process_group)
+        elif hook == "powersgd":
+            self.reducer._register_powersgd_hook(
+                self.process_group, matrix_approximation_rank)
+        elif hook == "reduce_scatter":
+            self.reducer._register_reduce_scatter_hook(self.process_group)
+        else:
+            raise ValueError("Unknown communication hook: {}".format(hook))
+
+    def sync_sharded_parameters(self):
+        r"""
+        Reconstitutes the full parameters with allgather after an optimizer
+        step, when gradients are reduced by the ``"reduce_scatter"``
+        communication hook (see :meth:`register_builtin_comm_hook`). Every
+        process then only holds correctly updated values for the parameters
+        in its own shards, which this copies to all other processes.
+
+        Example::
+
+            >>> ddp.register_builtin_comm_hook("reduce_scatter")
+            >>> ddp(input).sum().backward()
+            >>> optimizer.step()
+            >>> ddp.sync_sharded_parameters()
+        """
+        self.reducer._sync_sharded_parameters()
+
     def forward(self, *inputs, **kwargs):
         if self.require_forward_param_sync:
             self._sync_params()
 
+        # After the first iteration, reassign the buckets in the order in
+        # which the gradients became ready. This happens only once.
+        if torch.is_grad_enabled() and self.require_backward_grad_sync:
+            self.reducer._rebuild_buckets()
+
         if self.device_ids:
             inputs, kwargs = self.scatter(inputs, kwargs, self.device_ids)
             if len(self.device_ids) == 1:
@@ -510,9 +613,7 @@ class DistributedDataParallel(Module):
             if self.broadcast_buffers and len(self.modules_buffers[0]) > 0:
                 # Synchronize buffers across processes.
                 # The process with rank 0 is considered the authoritative copy.
-                self._distributed_broadcast_coalesced(
-                    self.modules_buffers[0],
-                    self.broadcast_bucket_size)
+                self._buffers_broadcast.run()
                 # only do intra-node buffer sync for replicated single-device
                 # CUDA modules
                 if self.device_ids and len(self.device_ids) > 1:
@@ -259,6 +259,51 @@ def linear(input, weight, bias=None, scale=None, zero_point=None):
     _packed_params = torch.ops.quantized.linear_prepack(weight, bias)
     return torch.ops.quantized.linear(input, _packed_params, scale, zero_point)
 
+def layer_norm(input, normalized_shape, weight=None, bias=None, eps=1e-5,
+               scale=None, zero_point=None):
+    # type: (Tensor, List[int], Optional[Tensor], Optional[Tensor], float, Optional[float], Optional[int]) -> Tensor
+    r"""Applies layer normalization over the last dimensions of a quantized
+    input. See :func:`torch.nn.functional.layer_norm`.
+
+    The statistics are computed from the integer values of the input and the
+    result is requantized directly, without a float intermediate.
+
+    Args:
+      input (Tensor): per tensor quantized input
+      normalized_shape (list of int): trailing dimensions to normalize over
+      weight (Tensor): None or fp32 elementwise scale of `normalized_shape`
+      bias (Tensor): None or fp32 elementwise shift of `normalized_shape`
+      eps (float): added to the variance for numerical stability
+      scale (double): output scale. If None, derived from the input scale
+      zero_point (long): output zero point. If None, derived from the input zero_point
+    """
+    if not input.is_quantized:
+        raise ValueError("Input to 'quantized.layer_norm' must be quantized!")
+    if scale is None:
+        scale = input.q_scale()
+    if zero_point is None:
+        zero_point = input.q_zero_point()
+    return torch.ops.quantized.layer_norm(input, normalized_shape, weight, bias,
+                                          eps, scale, zero_point)
+
+def softmax(input, dim, scale=1.0 / 256, zero_point=0):
+    # type: (Tensor, int, float, int) -> Tensor
+    r"""Applies softmax along `dim` of a quantized quint8 or qint8 input.
+    See :func:`torch.nn.functional.softmax`.
+
+    The exponentials are looked up by the integer distance to the maximum
+    along `dim`, so only the normalizing sum is computed in floating point.
+
+    Args:
+      input (Tensor): per tensor quantized input of type `torch.quint8` or `torch.qint8`
+      dim (int): dimension along which softmax is computed
+      scale (double): output scale, :math:`1/256` covers :math:`[0, 1)` with quint8
+      zero_point (long): output zero point, use -128 with qint8
+    """
+    if not input.is_quantized:
+        raise ValueError("Input to 'quantized.softmax' must be quantized!")
+    return torch.ops.quantized.softmax(input, dim, scale, zero_point)
+
 def max_pool2d(input, kernel_size, stride=None, padding=0, dilation=1,
                ceil_mode=False, return_indices=False):
     r"""Applies a 2D max pooling over a quantized input signal composed of
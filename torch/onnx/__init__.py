@@ -32,7 +32,7 @@ def export(model, args, f, export_params=True, verbose=False, training=False,
            operator_export_type=None, opset_version=None, _retain_param_name=True,
            do_constant_folding=True, example_outputs=None, strip_doc_string=True,
            dynamic_axes=None, keep_initializers_as_inputs=None, custom_opsets=None,
-           enable_onnx_checker=True):
+           enable_onnx_checker=True, use_external_data_format=False):
     r"""
     Export a model into ONNX format.  This exporter runs your model
     once in order to get a trace of its execution to be exported;
@@ -147,6 +147,13 @@ def export(model, args, f, export_params=True, verbose=False, training=False,
             to 1 by default.
         enable_onnx_checker (bool, default True): If True the onnx model checker will be run
             as part of the export, to ensure the exported model is a valid ONNX model.
+        use_external_data_format (bool, default False): If True, the data of every
+            initializer of at least 1KB is written to a separate file in the directory
+            of ``f``, named after the initializer, and the model only references it,
+            following the ONNX external data format. This is required to export models
+            larger than 2GB, the size limit of a protobuf, and avoids copying the weights
+            into the model. ``f`` has to be a file name, and the other files have to be
+            kept next to the model file. The onnx checker is not run in this case.
     """
 
     from torch.onnx import utils
@@ -155,7 +162,7 @@ def export(model, args, f, export_params=True, verbose=False, training=False,
                         operator_export_type, opset_version, _retain_param_name,
                         do_constant_folding, example_outputs,
                         strip_doc_string, dynamic_axes, keep_initializers_as_inputs,
-                        custom_opsets, enable_onnx_checker)
+                        custom_opsets, enable_onnx_checker, use_external_data_format)
 
 
 def export_to_pretty_string(*args, **kwargs):
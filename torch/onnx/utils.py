@@ -50,7 +50,7 @@ def export(model, args, f, export_params=True, verbose=False, training=False,
            operator_export_type=None, opset_version=None, _retain_param_name=True,
            do_constant_folding=True, example_outputs=None, strip_doc_string=True,
            dynamic_axes=None, keep_initializers_as_inputs=None, custom_opsets=None,
-           enable_onnx_checker=True):
+           enable_onnx_checker=True, use_external_data_format=False):
     if aten or export_raw_ir:
         assert operator_export_type is None
         assert aten ^ export_raw_ir
@@ -65,7 +65,8 @@ def export(model, args, f, export_params=True, verbose=False, training=False,
             _retain_param_name=_retain_param_name, do_constant_folding=do_constant_folding,
             example_outputs=example_outputs, strip_doc_string=strip_doc_string,
             dynamic_axes=dynamic_axes, keep_initializers_as_inputs=keep_initializers_as_inputs,
-            custom_opsets=custom_opsets, enable_onnx_checker=enable_onnx_checker)
+            custom_opsets=custom_opsets, enable_onnx_checker=enable_onnx_checker,
+            use_external_data_format=use_external_data_format)
 
 
 # ONNX can't handle constants that are lists of tensors, which can
@@ -434,12 +435,18 @@ def _export(model, args, f, export_params=True, verbose=False, training=False,
             opset_version=None, _retain_param_name=False, do_constant_folding=True,
             strip_doc_string=True, dynamic_axes=None, keep_initializers_as_inputs=None,
             fixed_batch_size=False, custom_opsets=None, add_node_names=True,
-            enable_onnx_checker=True):
+            enable_onnx_checker=True, use_external_data_format=False):
     if isinstance(model, torch.nn.DataParallel):
         raise ValueError('torch.nn.DataParallel is not supported by ONNX '
                          'exporter, please use \'attribute\' module to '
                          'unwrap model from torch.nn.DataParallel. Try '
                          'torch.onnx.export(model.module, ...)')
+    if use_external_data_format:
+        # The initializers are written next to the model file, so we need
+        # its path.
+        if export_type is not ExportTypes.PROTOBUF_FILE or not isinstance(f, string_classes):
+            raise ValueError('use_external_data_format requires f to be a file path '
+                             'and export_type to be ExportTypes.PROTOBUF_FILE')
     global __IN_ONNX_EXPORT
     assert __IN_ONNX_EXPORT is False
     __IN_ONNX_EXPORT = True
@@ -481,14 +488,16 @@ def _export(model, args, f, export_params=True, verbose=False, training=False,
             proto, export_map = graph._export_onnx(
                 params_dict, opset_version, dynamic_axes, defer_weight_export,
                 operator_export_type, strip_doc_string, val_keep_init_as_ip, custom_opsets,
-                val_add_node_names)
+                val_add_node_names, use_external_data_format, f if use_external_data_format else '')
         else:
             proto, export_map = graph._export_onnx(
                 {}, opset_version, dynamic_axes, False, operator_export_type,
                 strip_doc_string, val_keep_init_as_ip, custom_opsets, val_add_node_names)
 
-        if enable_onnx_checker and operator_export_type != OperatorExportTypes.ONNX_ATEN_FALLBACK:
-            # Only run checker if enabled and we are not using ATEN fallback
+        if enable_onnx_checker and operator_export_type != OperatorExportTypes.ONNX_ATEN_FALLBACK and \
+                not use_external_data_format:
+            # Only run checker if enabled and we are not using ATEN fallback or
+            # external data, whose initializers the checker can't see.
             _check_onnx_proto(proto)
 
         if export_type == ExportTypes.PROTOBUF_FILE:
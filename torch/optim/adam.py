@@ -1,6 +1,6 @@
 import math
 import torch
-from .optimizer import Optimizer
+from .optimizer import Optimizer, _has_fused_step_kernel
 
 
 class Adam(Optimizer):
@@ -58,13 +58,19 @@ class Adam(Optimizer):
             loss = closure()
 
         for group in self.param_groups:
+            amsgrad = group['amsgrad']
+            beta1, beta2 = group['betas']
+
+            # The bias corrections depend on the step, so the parameters are
+            # updated by one fused op per distinct step. Parameters the fused
+            # op has no kernel for are updated one by one.
+            updates = {}
             for p in group['params']:
                 if p.grad is None:
                     continue
                 grad = p.grad.data
                 if grad.is_sparse:
                     raise RuntimeError('Adam does not support sparse gradients, please consider SparseAdam instead')
-                amsgrad = group['amsgrad']
 
                 state = self.state[p]
 
@@ -79,31 +85,43 @@ class Adam(Optimizer):
                         # Maintains max of all exp. moving avg. of sq. grad. values
                         state['max_exp_avg_sq'] = torch.zeros_like(p.data, memory_format=torch.preserve_format)
 
-                exp_avg, exp_avg_sq = state['exp_avg'], state['exp_avg_sq']
-                if amsgrad:
-                    max_exp_avg_sq = state['max_exp_avg_sq']
-                beta1, beta2 = group['betas']
-
                 state['step'] += 1
-                bias_correction1 = 1 - beta1 ** state['step']
-                bias_correction2 = 1 - beta2 ** state['step']
+                if not _has_fused_step_kernel(p, grad, state['exp_avg'], state['exp_avg_sq']):
+                    exp_avg, exp_avg_sq = state['exp_avg'], state['exp_avg_sq']
+                    bias_correction1 = 1 - beta1 ** state['step']
+                    bias_correction2 = 1 - beta2 ** state['step']
 
-                if group['weight_decay'] != 0:
-                    grad = grad.add(group['weight_decay'], p.data)
+                    if group['weight_decay'] != 0:
+                        grad = grad.add(group['weight_decay'], p.data)
 
-                # Decay the first and second moment running average coefficient
-                exp_avg.mul_(beta1).add_(1 - beta1, grad)
-                exp_avg_sq.mul_(beta2).addcmul_(1 - beta2, grad, grad)
-                if amsgrad:
-                    # Maintains the maximum of all 2nd moment running avg. till now
-                    torch.max(max_exp_avg_sq, exp_avg_sq, out=max_exp_avg_sq)
-                    # Use the max. for normalizing running avg. of gradient
-                    denom = (max_exp_avg_sq.sqrt() / math.sqrt(bias_correction2)).add_(group['eps'])
-                else:
-                    denom = (exp_avg_sq.sqrt() / math.sqrt(bias_correction2)).add_(group['eps'])
+                    # Decay the first and second moment running average coefficient
+                    exp_avg.mul_(beta1).add_(1 - beta1, grad)
+                    exp_avg_sq.mul_(beta2).addcmul_(1 - beta2, grad, grad)
+                    if amsgrad:
+                        max_exp_avg_sq = state['max_exp_avg_sq']
+                        # Maintains the maximum of all 2nd moment running avg. till now
+                        torch.max(max_exp_avg_sq, exp_avg_sq, out=max_exp_avg_sq)
+                        # Use the max. for normalizing running avg. of gradient
+                        denom = (max_exp_avg_sq.sqrt() / math.sqrt(bias_correction2)).add_(group['eps'])
+                    else:
+                        denom = (exp_avg_sq.sqrt() / math.sqrt(bias_correction2)).add_(group['eps'])
+
+                    step_size = group['lr'] / bias_correction1
+                    p.data.addcdiv_(-step_size, exp_avg, denom)
+                    continue
 
-                step_size = group['lr'] / bias_correction1
+                lists = updates.setdefault(state['step'], ([], [], [], [], []))
+                lists[0].append(p.data)
+                lists[1].append(grad)
+                lists[2].append(state['exp_avg'])
+                lists[3].append(state['exp_avg_sq'])
+                if amsgrad:
+                    lists[4].append(state['max_exp_avg_sq'])
 
-                p.data.addcdiv_(-step_size, exp_avg, denom)
+            for step, lists in updates.items():
+                torch._fused_adam_(*lists, step=step, lr=group['lr'],
+                                   beta1=beta1, beta2=beta2, eps=group['eps'],
+                                   weight_decay=group['weight_decay'],
+                                   amsgrad=amsgrad)
 
         return loss
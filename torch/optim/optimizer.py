@@ -14,6 +14,13 @@ class _RequiredParameter(object):
 required = _RequiredParameter()
 
 
+def _has_fused_step_kernel(*tensors):
+    r"""Whether ``torch._fused_sgd_`` and ``torch._fused_adam_`` have a kernel
+    for all of ``tensors``, i.e. they are dense CPU or CUDA tensors."""
+    return all(t.layout == torch.strided and t.device.type in ('cpu', 'cuda')
+               for t in tensors)
+
+
 class Optimizer(object):
     r"""Base class for all optimizers.
 
@@ -1,5 +1,5 @@
 import torch
-from .optimizer import Optimizer, required
+from .optimizer import Optimizer, required, _has_fused_step_kernel
 
 
 class SGD(Optimizer):
@@ -89,24 +89,48 @@ class SGD(Optimizer):
             dampening = group['dampening']
             nesterov = group['nesterov']
 
+            # New momentum buffers start out as zeros and take the gradient
+            # without dampening, so the parameters are updated by one fused
+            # op per dampening value. Parameters the fused op has no kernel
+            # for, e.g. ones with sparse gradients, are updated one by one.
+            updates = {}
             for p in group['params']:
                 if p.grad is None:
                     continue
-                d_p = p.grad.data
-                if weight_decay != 0:
-                    d_p = d_p.add(weight_decay, p.data)
+                buf = None
                 if momentum != 0:
                     param_state = self.state[p]
-                    if 'momentum_buffer' not in param_state:
-                        buf = param_state['momentum_buffer'] = torch.clone(d_p).detach()
-                    else:
-                        buf = param_state['momentum_buffer']
-                        buf.mul_(momentum).add_(1 - dampening, d_p)
-                    if nesterov:
-                        d_p = d_p.add(momentum, buf)
-                    else:
-                        d_p = buf
-
-                p.data.add_(-group['lr'], d_p)
+                    buf = param_state.get('momentum_buffer')
+
+                if not _has_fused_step_kernel(p, p.grad, *([] if buf is None else [buf])):
+                    d_p = p.grad.data
+                    if weight_decay != 0:
+                        d_p = d_p.add(weight_decay, p.data)
+                    if momentum != 0:
+                        if buf is None:
+                            buf = param_state['momentum_buffer'] = torch.clone(d_p).detach()
+                        else:
+                            buf.mul_(momentum).add_(1 - dampening, d_p)
+                        if nesterov:
+                            d_p = d_p.add(momentum, buf)
+                        else:
+                            d_p = buf
+                    p.data.add_(-group['lr'], d_p)
+                    continue
+
+                d = dampening
+                if momentum != 0 and buf is None:
+                    buf = param_state['momentum_buffer'] = torch.zeros_like(
+                        p.data, memory_format=torch.preserve_format)
+                    d = 0
+                params, grads, bufs = updates.setdefault(d, ([], [], []))
+                params.append(p.data)
+                grads.append(p.grad.data)
+                if buf is not None:
+                    bufs.append(buf)
+
+            for d, (params, grads, bufs) in updates.items():
+                torch._fused_sgd_(params, grads, bufs, group['lr'], momentum,
+                                  d, weight_decay, nesterov)
 
         return loss
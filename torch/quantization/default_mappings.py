@@ -49,6 +49,7 @@ DEFAULT_QAT_MODULE_MAPPING = {
 DEFAULT_DYNAMIC_MODULE_MAPPING = {
     nn.Linear: nnqd.Linear,
     nn.LSTM: nnqd.LSTM,
+    nn.GRU: nnqd.GRU,
 }
 
 # Whitelist for propagating the qconfig
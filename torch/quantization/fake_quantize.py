@@ -84,9 +84,11 @@ class FakeQuantize(Module):
                 X = torch.fake_quantize_per_channel_affine(X, self.scale, self.zero_point,
                                                            self.ch_axis, self.quant_min, self.quant_max)
             else:
-                X = torch.fake_quantize_per_tensor_affine(X, float(self.scale),
-                                                          int(self.zero_point), self.quant_min,
-                                                          self.quant_max)
+                # The cachemask variant quantizes and records the straight-through
+                # mask in one pass, so backward does not re-quantize the input.
+                X, _ = torch._fake_quantize_per_tensor_affine_cachemask(X, float(self.scale),
+                                                                        int(self.zero_point), self.quant_min,
+                                                                        self.quant_max)
         return X
 
     with_args = classmethod(_with_args)
@@ -450,7 +450,13 @@ def _legacy_save(obj, f, pickle_module, pickle_protocol):
 
 def _save(obj, zip_file, pickle_module, pickle_protocol):
     serialized_storages = {}
+    _save_pickle(obj, 'data.pkl', zip_file, serialized_storages, pickle_module, pickle_protocol)
+    _save_storages(zip_file, serialized_storages)
 
+
+def _save_pickle(obj, record_name, zip_file, serialized_storages, pickle_module, pickle_protocol):
+    # Writes the pickle data of `obj` as `record_name`, collecting the storages
+    # it references in `serialized_storages`
     def persistent_id(obj):
         # FIXME: the docs say that persistent_id should only return a string
         # but torch store returns tuples. This works only in the binary protocol
@@ -476,8 +482,10 @@ def _save(obj, zip_file, pickle_module, pickle_protocol):
     pickler.persistent_id = persistent_id
     pickler.dump(obj)
     data_value = data_buf.getvalue()
-    zip_file.write_record('data.pkl', data_value, len(data_value))
+    zip_file.write_record(record_name, data_value, len(data_value))
+
 
+def _save_storages(zip_file, serialized_storages):
     # Write each tensor to a file named tensor/the_tensor_key in the zip archive
     for key in sorted(serialized_storages.keys()):
         name = 'data/{}'.format(key)
@@ -813,9 +821,12 @@ def _get_restore_location(map_location):
 
 def _load(zip_file, map_location, pickle_module, **pickle_load_args):
     restore_location = _get_restore_location(map_location)
+    return _load_pickle('data.pkl', zip_file, restore_location, {}, pickle_module, **pickle_load_args)
 
-    loaded_storages = {}
 
+def _load_pickle(record_name, zip_file, restore_location, loaded_storages, pickle_module, **pickle_load_args):
+    # Loads the pickle data written as `record_name`, reading the storages it
+    # references that are not already in `loaded_storages`
     def load_tensor(obj, size, key, location):
         loaded_storages[key] = restore_location(obj, location)
         name = 'data/{}'.format(key)
@@ -839,7 +850,7 @@ def _load(zip_file, map_location, pickle_module, **pickle_load_args):
         return storage
 
     # Load the data (which may in turn use `persistent_load` to load tensors)
-    data_file = io.BytesIO(zip_file.get_record('data.pkl'))
+    data_file = io.BytesIO(zip_file.get_record(record_name))
     unpickler = pickle_module.Unpickler(data_file, **pickle_load_args)
     unpickler.persistent_load = persistent_load
     result = unpickler.load()
@@ -847,6 +858,106 @@ def _load(zip_file, map_location, pickle_module, **pickle_load_args):
     return result
 
 
+def _shard_path(directory, rank):
+    return os.path.join(directory, 'shard_{}.pt'.format(rank))
+
+
+def save_sharded(state_dict, directory, rank=0, pickle_module=pickle, pickle_protocol=DEFAULT_PROTOCOL):
+    """Saves the part of a checkpoint held by one process as a shard of it.
+
+    Every process of a job can save its part independently and at the same
+    time, so that the time taken by a checkpoint scales with the size of the
+    part rather than of the whole model. Each shard is a zip file, like the
+    ones :func:`torch.save` writes with ``_use_new_zipfile_serialization``,
+    with a manifest of the entries it contains, and the value of each entry
+    pickled on its own so that :func:`load_sharded` can read only some of
+    them. Storages shared by entries of the same shard are saved once.
+
+    Args:
+        state_dict (dict): the entries of the shard, with string keys that
+            are unique across all the shards of the checkpoint
+        directory (str): directory of the checkpoint, created if needed
+        rank (int): index of the shard, usually the rank of the process;
+            the shards of a checkpoint are numbered from 0 without gaps
+        pickle_module: module used for pickling metadata and objects
+        pickle_protocol: can be specified to override the default protocol
+
+    Example:
+        >>> # on each rank
+        >>> torch.serialization.save_sharded(model.state_dict(), 'ckpt', rank=rank)
+    """
+    _check_dill_version(pickle_module)
+    for key in state_dict.keys():
+        if not isinstance(key, _string_classes):
+            raise ValueError("save_sharded expects string keys, but got type: " + str(type(key)))
+    if not os.path.isdir(directory):
+        try:
+            os.makedirs(directory)
+        except OSError:
+            # another rank may have created it in the meantime
+            if not os.path.isdir(directory):
+                raise
+    manifest = {}
+    serialized_storages = {}
+    with _open_zipfile_writer(_shard_path(directory, rank)) as zip_file:
+        for index, (key, value) in enumerate(state_dict.items()):
+            manifest[key] = index
+            _save_pickle(value, 'entries/{}.pkl'.format(index), zip_file, serialized_storages,
+                         pickle_module, pickle_protocol)
+        _save_pickle(manifest, 'manifest.pkl', zip_file, {}, pickle_module, pickle_protocol)
+        _save_storages(zip_file, serialized_storages)
+
+
+def load_sharded(directory, keys=None, map_location=None, pickle_module=pickle, **pickle_load_args):
+    """Loads entries of a checkpoint saved with :func:`save_sharded`.
+
+    Only the manifests of the shards and the records of the requested entries
+    are read, so a process restoring its part of a large checkpoint does not
+    read the rest of it.
+
+    Args:
+        directory (str): directory of the checkpoint
+        keys (iterable of str, optional): keys of the entries to load; all
+            the entries of all the shards are loaded if it is ``None``
+        map_location: see :func:`torch.load`
+        pickle_module: module used for unpickling metadata and objects
+        pickle_load_args: (Python 3 only) keyword arguments passed to
+            ``pickle_module.load`` and ``pickle_module.Unpickler``
+
+    Returns:
+        A dict of the loaded entries.
+
+    Example:
+        >>> state_dict = torch.serialization.load_sharded('ckpt', keys=model.state_dict().keys())
+        >>> model.load_state_dict(state_dict)
+    """
+    _check_dill_version(pickle_module)
+    if sys.version_info >= (3, 0) and 'encoding' not in pickle_load_args.keys():
+        pickle_load_args['encoding'] = 'utf-8'
+    restore_location = _get_restore_location(map_location)
+    missing = None if keys is None else set(keys)
+    result = {}
+    rank = 0
+    while os.path.exists(_shard_path(directory, rank)) and (missing is None or missing):
+        with _open_zipfile_reader(_shard_path(directory, rank)) as zip_file:
+            manifest = _load_pickle('manifest.pkl', zip_file, restore_location, {},
+                                    pickle_module, **pickle_load_args)
+            loaded_storages = {}
+            for key, index in manifest.items():
+                if missing is not None:
+                    if key not in missing:
+                        continue
+                    missing.remove(key)
+                result[key] = _load_pickle('entries/{}.pkl'.format(index), zip_file, restore_location,
+                                           loaded_storages, pickle_module, **pickle_load_args)
+        rank += 1
+    if not os.path.exists(_shard_path(directory, 0)):
+        raise ValueError("No shards found in {}".format(directory))
+    if missing:
+        raise KeyError("Entries not found in the shards of {}: {}".format(directory, sorted(missing)))
+    return result
+
+
 def _is_torchscript_zip(zip_file):
     for file_name in zip_file.get_all_records():
         parts = file_name.split(os.sep)
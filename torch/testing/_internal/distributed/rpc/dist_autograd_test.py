@@ -1111,8 +1111,8 @@ class DistAutogradTest(RpcAgentTestFixture):
 
     @unittest.skipIf(
         torch.testing._internal.dist_utils.TEST_CONFIG.rpc_backend_name
-        == "PROCESS_GROUP",
-        "Skipping this test temporarily since ProcessGroupAgent does not report errors on node failures",
+        in ("PROCESS_GROUP", "SOCKET"),
+        "Skipping this test temporarily since ProcessGroupAgent and SocketAgent do not report errors on node failures",
     )
     @dist_init(clean_shutdown=False)
     def test_backward_node_failure(self):
@@ -1337,9 +1337,9 @@ class DistAutogradTest(RpcAgentTestFixture):
 
     @unittest.skipIf(
         torch.testing._internal.dist_utils.TEST_CONFIG.rpc_backend_name
-        == "PROCESS_GROUP",
-        "Skipping this test temporarily since ProcessGroupAgent "
-        + "does not report errors on node failures",
+        in ("PROCESS_GROUP", "SOCKET"),
+        "Skipping this test temporarily since ProcessGroupAgent and SocketAgent "
+        + "do not report errors on node failures",
     )
     @dist_init(clean_shutdown=False)
     def test_backward_node_failure_python_udf(self):
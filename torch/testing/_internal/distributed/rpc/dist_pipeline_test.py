@@ -0,0 +1,122 @@
+from __future__ import absolute_import, division, print_function, unicode_literals
+
+import unittest
+
+import torch
+import torch.distributed.rpc as rpc
+from torch.distributed.pipeline import Pipeline
+from torch.testing._internal.dist_utils import dist_init
+from torch.testing._internal.distributed.rpc.rpc_agent_test_fixture import (
+    RpcAgentTestFixture,
+)
+
+
+def _create_linear(weight, bias):
+    linear = torch.nn.Linear(weight.size(1), weight.size(0))
+    with torch.no_grad():
+        linear.weight.copy_(weight)
+        linear.bias.copy_(bias)
+    return linear
+
+
+class FailingModule(torch.nn.Module):
+    def forward(self, input):
+        raise ValueError("Error running stage.")
+
+
+def _get_grads(stage_rref):
+    return [param.grad for param in stage_rref.local_value().parameters()]
+
+
+@unittest.skipIf(
+    not torch._six.PY3, "Pytorch distributed pipeline does not support python2"
+)
+class DistPipelineTest(RpcAgentTestFixture):
+    def _owners(self):
+        return [
+            "worker%d" % ((self.rank + 1) % self.world_size),
+            "worker%d" % ((self.rank + 2) % self.world_size),
+        ]
+
+    def _test_train_step(self, schedule):
+        torch.manual_seed(0)
+        local_stages = [torch.nn.Linear(4, 3), torch.nn.Linear(3, 2)]
+        input = torch.rand(8, 4)
+        target = torch.rand(8, 2)
+        loss_fn = torch.nn.MSELoss(reduction="sum")
+
+        loss_fn(local_stages[1](local_stages[0](input)), target).backward()
+
+        stages = [
+            rpc.remote(
+                owner,
+                _create_linear,
+                args=(local.weight.detach(), local.bias.detach()),
+            )
+            for owner, local in zip(self._owners(), local_stages)
+        ]
+        pipe = Pipeline(stages, chunks=4, schedule=schedule)
+
+        losses = pipe.train_step(input, target, loss_fn)
+        self.assertEqual(len(losses), 4)
+        self.assertEqual(sum(losses), loss_fn(
+            local_stages[1](local_stages[0](input)), target).detach())
+        for stage, local in zip(stages, local_stages):
+            grads = rpc.rpc_sync(stage.owner(), _get_grads, args=(stage,))
+            self.assertEqual(grads, [param.grad for param in local.parameters()])
+
+        # Gradients accumulate across batches until zero_grad.
+        pipe.train_step(input, target, loss_fn)
+        grads = rpc.rpc_sync(stages[0].owner(), _get_grads, args=(stages[0],))
+        self.assertEqual(grads[0], 2 * local_stages[0].weight.grad)
+
+        pipe.zero_grad()
+        grads = rpc.rpc_sync(stages[0].owner(), _get_grads, args=(stages[0],))
+        self.assertEqual(grads, [None, None])
+
+    @dist_init()
+    def test_train_step_1f1b(self):
+        self._test_train_step("1f1b")
+
+    @dist_init()
+    def test_train_step_gpipe(self):
+        self._test_train_step("gpipe")
+
+    @dist_init()
+    def test_forward(self):
+        torch.manual_seed(0)
+        local_stages = [torch.nn.Linear(4, 3), torch.nn.Linear(3, 2)]
+        input = torch.rand(7, 4)
+
+        stages = [
+            rpc.remote(
+                owner,
+                _create_linear,
+                args=(local.weight.detach(), local.bias.detach()),
+            )
+            for owner, local in zip(self._owners(), local_stages)
+        ]
+        pipe = Pipeline(stages, chunks=3)
+        self.assertEqual(
+            pipe.forward(input), local_stages[1](local_stages[0](input)))
+
+    @dist_init()
+    def test_stage_exception(self):
+        owner1, owner2 = self._owners()
+        stage1 = rpc.remote(owner1, torch.nn.Linear, args=(4, 4))
+        stage2 = rpc.remote(owner2, FailingModule)
+        for schedule in ("1f1b", "gpipe"):
+            pipe = Pipeline([stage1, stage2], chunks=2, schedule=schedule)
+            with self.assertRaisesRegex(Exception, "Error running stage"):
+                pipe.train_step(
+                    torch.rand(4, 4), torch.rand(4, 4), torch.nn.MSELoss())
+
+    @dist_init()
+    def test_invalid_arguments(self):
+        stage = rpc.RRef(torch.nn.Linear(4, 4))
+        with self.assertRaisesRegex(ValueError, "at least one stage"):
+            Pipeline([], chunks=2)
+        with self.assertRaisesRegex(ValueError, "positive integer"):
+            Pipeline([stage], chunks=0)
+        with self.assertRaisesRegex(ValueError, "Unknown pipeline schedule"):
+            Pipeline([stage], chunks=2, schedule="interleaved")
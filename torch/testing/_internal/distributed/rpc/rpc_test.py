@@ -10,6 +10,7 @@ from unittest import mock
 
 import torch
 import torch.distributed as dist
+import torch.distributed.autograd as dist_autograd
 import torch.distributed.rpc as rpc
 import torch.testing._internal.dist_utils
 from torch._jit_internal import _qualified_name
@@ -790,6 +791,24 @@ class RpcTest(RpcAgentTestFixture):
             )
             j += 1
 
+    @dist_init
+    def test_py_tensors_held_large(self):
+        # Keeps more tensor data alive than fits in the shared memory ring of
+        # SocketAgent, so that later messages fall back to the socket.
+        n = self.rank + 1
+        dst_rank = n % self.world_size
+        futs = [
+            rpc.rpc_async(
+                "worker{}".format(dst_rank),
+                torch.add,
+                args=(torch.full((1024, 1024), i), torch.ones(1024, 1024)),
+            )
+            for i in range(24)
+        ]
+        rets = [fut.wait() for fut in futs]
+        for i, ret in enumerate(rets):
+            self.assertEqual(ret, torch.full((1024, 1024), i + 1))
+
     @dist_init
     def test_py_tensors_in_container(self):
         n = self.rank + 1
@@ -851,6 +870,29 @@ class RpcTest(RpcAgentTestFixture):
         ):
             rref = rpc.remote(dst_worker_name, one_arg, args=(10, 20))
 
+    @dist_init
+    def test_torchscript_functions_with_slow_python_udfs(self):
+        # TorchScript calls run on threads of their own on the callee, so they
+        # are served while Python UDFs are still running there.
+        dst_worker_name = "worker{}".format((self.rank + 1) % self.world_size)
+        slow_futs = [
+            rpc.rpc_async(dst_worker_name, my_sleep_func, args=(1,))
+            for _ in range(2)
+        ]
+        rrefs = [
+            rpc.remote(dst_worker_name, one_arg, args=(torch.ones(2) * i,))
+            for i in range(10)
+        ]
+        futs = [
+            rpc.rpc_async(dst_worker_name, one_arg, args=(torch.ones(2) * i,))
+            for i in range(10)
+        ]
+        for i in range(10):
+            self.assertEqual(rrefs[i].to_here(), torch.ones(2) * i + 1)
+            self.assertEqual(futs[i].wait(), torch.ones(2) * i + 1)
+        for fut in slow_futs:
+            fut.wait()
+
     @dist_init
     def test_torchscript_functions_not_supported(self):
         # Right now _rpc_sync_torchscript does not accept annotated torchscript
@@ -1157,6 +1199,44 @@ class RpcTest(RpcAgentTestFixture):
         ):
             rref.local_value()
 
+    @dist_init
+    def test_rref_to_here_async(self):
+        dst = "worker{}".format((self.rank + 1) % self.world_size)
+        rref = rpc.remote(dst, torch.add, args=(torch.ones(2), 1))
+        fut = rref.to_here_async()
+        self.assertEqual(fut.wait(), torch.ones(2) + 1)
+
+        rref = rpc.remote(dst, my_function, args=(1, 2, 3))
+        self.assertEqual(rref.to_here_async().wait(), my_function(1, 2, 3))
+
+        local_rref = RRef(35)
+        with self.assertRaisesRegex(RuntimeError, "use local_value"):
+            local_rref.to_here_async()
+
+    @dist_init
+    def test_immutable_rref_cached(self):
+        dst = "worker{}".format((self.rank + 1) % self.world_size)
+        rref = rpc.remote(dst, torch.add, args=(torch.ones(2), 1))
+        self.assertFalse(rref.is_immutable())
+        # Every fetch of a mutable RRef returns a new copy.
+        self.assertNotEqual(
+            rref.to_here().data_ptr(), rref.to_here().data_ptr()
+        )
+
+        rref.mark_immutable()
+        self.assertTrue(rref.is_immutable())
+        value = rref.to_here()
+        self.assertEqual(value, torch.ones(2) + 1)
+        # Later fetches are served from the cached copy.
+        self.assertEqual(value.data_ptr(), rref.to_here().data_ptr())
+        self.assertEqual(
+            value.data_ptr(), rref.to_here_async().wait().data_ptr()
+        )
+
+        # Fetches in a distributed autograd context are not cached.
+        with dist_autograd.context():
+            self.assertNotEqual(value.data_ptr(), rref.to_here().data_ptr())
+
     @dist_init
     def test_return_local_rrefs(self):
         n = self.rank + 1
@@ -1562,9 +1642,13 @@ class RpcTest(RpcAgentTestFixture):
             fut = rpc.rpc_async(dst_worker, torch.add, args=(torch.ones(1), 3))
             # Shutdown sequence is not very well defined and as a result
             # we can see any of these error messages.
+            # SocketAgent sends through the same ProcessGroupAgent path.
             error_str = (
                 "Encountered exception in ProcessGroupAgent::enqueueSend"
-                if self.rpc_backend == rpc.backend_registry.BackendType.PROCESS_GROUP
+                if self.rpc_backend in (
+                    rpc.backend_registry.BackendType.PROCESS_GROUP,
+                    rpc.backend_registry.BackendType.SOCKET,
+                )
                 else get_shutdown_error_regex()
             )
             with self.assertRaisesRegex(RuntimeError, error_str):
@@ -1618,6 +1702,39 @@ class RpcTest(RpcAgentTestFixture):
         self.assertEqual(timeout, set_timeout)
         rpc.shutdown()
 
+    @dist_init(setup_rpc=False)
+    @requires_process_group_agent("PROCESS_GROUP rpc backend specific test, skip")
+    def test_coalesced_messages(self):
+        rpc_backend_options = self.rpc_backend_options
+        rpc_backend_options.coalesce_window = timedelta(milliseconds=10)
+        rpc_backend_options.coalesce_max_bytes = 1024
+
+        rpc.init_rpc(
+            name="worker{}".format(self.rank),
+            backend=self.rpc_backend,
+            rank=self.rank,
+            world_size=self.world_size,
+            rpc_backend_options=rpc_backend_options,
+        )
+        dst_rank = (self.rank + 1) % self.world_size
+        # small messages are coalesced, large ones are sent on their own.
+        futs = [
+            rpc.rpc_async(
+                "worker{}".format(dst_rank), torch.add, args=(torch.ones(n), n)
+            )
+            for n in [1, 2, 3, 1000, 4, 5]
+        ]
+        for n, fut in zip([1, 2, 3, 1000, 4, 5], futs):
+            self.assertEqual(fut.wait(), torch.ones(n) + n)
+
+        info = rpc.api._get_current_rpc_agent().get_debug_info()
+        self.assertGreater(int(info["agent.num_coalesced_batches"]), 0)
+        self.assertGreaterEqual(
+            int(info["agent.num_coalesced_messages"]),
+            int(info["agent.num_coalesced_batches"]),
+        )
+        rpc.shutdown()
+
     @dist_init
     @requires_process_group_agent("PROCESS_GROUP rpc backend specific test, skip")
     def test_rpc_timeouts(self):
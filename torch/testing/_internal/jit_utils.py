@@ -587,11 +587,25 @@ def _trace(*args, **kwargs):
 
 def enable_cpu_fuser(fn):
     def wrapper(*args, **kwargs):
+        old_state = torch._C._jit_can_fuse_on_cpu()
         torch._C._jit_override_can_fuse_on_cpu(True)
         try:
             fn(*args, **kwargs)
         finally:
-            torch._C._jit_override_can_fuse_on_cpu(False)
+            torch._C._jit_override_can_fuse_on_cpu(old_state)
+    return wrapper
+
+
+# Runs CPU fusion groups through the generated C++ kernels even when the
+# in-process vectorized backend could run them.
+def use_compiled_cpu_fuser(fn):
+    def wrapper(*args, **kwargs):
+        old_state = torch._C._jit_use_vectorized_cpu_fuser()
+        torch._C._jit_override_use_vectorized_cpu_fuser(False)
+        try:
+            fn(*args, **kwargs)
+        finally:
+            torch._C._jit_override_use_vectorized_cpu_fuser(old_state)
     return wrapper
 
 
@@ -7,11 +7,11 @@ static methods.
 
 import torch
 from torch._six import queue, container_abcs, string_classes
-from . import MP_STATUS_CHECK_INTERVAL
+from . import MP_STATUS_CHECK_INTERVAL, ring_buffer
 from torch._utils import ExceptionWrapper
 
 
-def _pin_memory_loop(in_queue, out_queue, device_id, done_event):
+def _pin_memory_loop(in_queue, out_queue, device_id, done_event, ring_buffers=None):
     # This setting is thread local, and prevents the copy in pin_memory from
     # consuming all CPU cores.
     torch.set_num_threads(1)
@@ -28,6 +28,10 @@ def _pin_memory_loop(in_queue, out_queue, device_id, done_event):
         idx, data = r
         if not done_event.is_set() and not isinstance(data, ExceptionWrapper):
             try:
+                if ring_buffers is not None:
+                    # pinning copies the tensors out of the ring buffers, so
+                    # their regions are released right away
+                    data = ring_buffer._unpack(data, ring_buffers)
                 data = pin_memory(data)
             except Exception:
                 data = ExceptionWrapper(
@@ -0,0 +1,97 @@
+r""""Contains definitions of the methods used by the _MultiProcessingDataLoaderIter
+and its workers to send the tensors of batches through the shared memory ring
+buffers of the workers.
+
+A worker copies all the CPU tensors of a batch into one region of its ring
+buffer (`torch._C._ShmRingBuffer`) and sends a `_RingBatch` over the data queue
+instead, where each tensor is replaced by a `_RingTensor` placeholder. The
+main process turns it back into a batch whose tensors view the ring buffer;
+the region is handed back to the worker once they are all freed. Batches that
+do not fit in the free part of the ring buffer are sent as they are.
+
+These **needs** to be in global scope since Py2 doesn't support serializing
+static methods.
+"""
+
+from collections import namedtuple
+
+import torch
+from torch._six import container_abcs, string_classes
+
+
+r"""A batch held by the region [begin, end) of the ring buffer of worker
+`worker_id`. `specs` holds the (offset, dtype, sizes) of each tensor, and
+`data` the batch with its tensors replaced by `_RingTensor`s."""
+_RingBatch = namedtuple('_RingBatch', ['worker_id', 'begin', 'end', 'specs', 'data'])
+
+r"""Placeholder of the tensor `specs[index]` of a `_RingBatch`"""
+_RingTensor = namedtuple('_RingTensor', ['index'])
+
+
+def _align(nbytes):
+    alignment = 64  # ShmRingBuffer::kAlignment
+    return (nbytes + alignment - 1) // alignment * alignment
+
+
+def _can_write(data):
+    return data.device.type == 'cpu' and data.layout == torch.strided and not data.requires_grad
+
+
+def _replace_tensors(data, tensors):
+    if isinstance(data, torch.Tensor):
+        if _can_write(data):
+            tensors.append(data)
+            return _RingTensor(len(tensors) - 1)
+        return data
+    elif isinstance(data, string_classes):
+        return data
+    elif isinstance(data, container_abcs.Mapping):
+        return {k: _replace_tensors(sample, tensors) for k, sample in data.items()}
+    elif isinstance(data, tuple) and hasattr(data, '_fields'):  # namedtuple
+        return type(data)(*(_replace_tensors(sample, tensors) for sample in data))
+    elif isinstance(data, container_abcs.Sequence):
+        return [_replace_tensors(sample, tensors) for sample in data]
+    else:
+        return data
+
+
+def _pack(data, ring, worker_id):
+    tensors = []
+    packed = _replace_tensors(data, tensors)
+    if not tensors:
+        return data
+    sizes = [_align(t.numel() * t.element_size()) for t in tensors]
+    region = ring.allocate(sum(sizes))
+    if region is None:
+        return data
+    begin, end, offset = region
+    specs = []
+    for t, size in zip(tensors, sizes):
+        ring.write(offset, t)
+        specs.append((offset, t.dtype, list(t.size())))
+        offset += size
+    return _RingBatch(worker_id, begin, end, specs, packed)
+
+
+def _restore_tensors(data, tensors):
+    if isinstance(data, _RingTensor):
+        return tensors[data.index]
+    elif isinstance(data, torch.Tensor):
+        return data
+    elif isinstance(data, string_classes):
+        return data
+    elif isinstance(data, container_abcs.Mapping):
+        return {k: _restore_tensors(sample, tensors) for k, sample in data.items()}
+    elif isinstance(data, tuple) and hasattr(data, '_fields'):  # namedtuple
+        return type(data)(*(_restore_tensors(sample, tensors) for sample in data))
+    elif isinstance(data, container_abcs.Sequence):
+        return [_restore_tensors(sample, tensors) for sample in data]
+    else:
+        return data
+
+
+def _unpack(data, rings):
+    if not isinstance(data, _RingBatch):
+        return data
+    tensors = rings[data.worker_id].take(data.begin, data.end, data.specs)
+    return _restore_tensors(data.data, tensors)
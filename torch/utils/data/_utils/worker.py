@@ -10,7 +10,7 @@ import os
 from collections import namedtuple
 from torch._six import queue
 from torch._utils import ExceptionWrapper
-from . import signal_handling, MP_STATUS_CHECK_INTERVAL, IS_WINDOWS
+from . import signal_handling, ring_buffer, MP_STATUS_CHECK_INTERVAL, IS_WINDOWS
 
 if IS_WINDOWS:
     import ctypes
@@ -106,7 +106,7 @@ _IterableDatasetStopIteration = namedtuple('_IterableDatasetStopIteration', ['wo
 
 def _worker_loop(dataset_kind, dataset, index_queue, data_queue, done_event,
                  auto_collation, collate_fn, drop_last, seed, init_fn, worker_id,
-                 num_workers):
+                 num_workers, ring_buffer_name=None):
     # See NOTE [ Data Loader Multiprocessing Shutdown Logic ] for details on the
     # logic of this function.
 
@@ -129,11 +129,16 @@ def _worker_loop(dataset_kind, dataset, index_queue, data_queue, done_event,
         from torch.utils.data import _DatasetKind
 
         init_exception = None
+        ring = None
 
         try:
             if init_fn is not None:
                 init_fn(worker_id)
 
+            # See NOTE [ Shared Memory Ring Buffers of Workers ]
+            if ring_buffer_name is not None:
+                ring = torch._C._ShmRingBuffer.attach(ring_buffer_name)
+
             fetcher = _DatasetKind.create_fetcher(dataset_kind, dataset, auto_collation, collate_fn, drop_last)
         except Exception:
             init_exception = ExceptionWrapper(
@@ -176,6 +181,8 @@ def _worker_loop(dataset_kind, dataset, index_queue, data_queue, done_event,
             else:
                 try:
                     data = fetcher.fetch(index)
+                    if ring is not None:
+                        data = ring_buffer._pack(data, ring, worker_id)
                 except Exception as e:
                     if isinstance(e, StopIteration) and dataset_kind == _DatasetKind.Iterable:
                         data = _IterableDatasetStopIteration(worker_id)
@@ -98,6 +98,14 @@ class DataLoader(object):
         worker_init_fn (callable, optional): If not ``None``, this will be called on each
             worker subprocess with the worker id (an int in ``[0, num_workers - 1]``) as
             input, after seeding and before data loading. (default: ``None``)
+        ring_buffer_size (int, optional): if positive, each worker subprocess
+            sends the CPU tensors of its batches through a shared memory ring
+            buffer of this many bytes, instead of sharing every tensor through
+            the :attr:`multiprocessing` queue. The tensors of the batches are
+            then views of the ring buffer, whose memory is reused once they are
+            freed, so the buffer should hold a few batches. Batches that do not
+            fit in the free part of the buffer are sent through the queue. Not
+            supported on Windows. (default: ``0``)
 
 
     .. warning:: If the ``spawn`` start method is used, :attr:`worker_init_fn`
@@ -120,7 +128,8 @@ class DataLoader(object):
     def __init__(self, dataset, batch_size=1, shuffle=False, sampler=None,
                  batch_sampler=None, num_workers=0, collate_fn=None,
                  pin_memory=False, drop_last=False, timeout=0,
-                 worker_init_fn=None, multiprocessing_context=None):
+                 worker_init_fn=None, multiprocessing_context=None,
+                 ring_buffer_size=0):
         torch._C._log_api_usage_once("python.data_loader")
 
         if num_workers < 0:
@@ -130,12 +139,19 @@ class DataLoader(object):
         if timeout < 0:
             raise ValueError('timeout option should be non-negative')
 
+        if ring_buffer_size < 0:
+            raise ValueError('ring_buffer_size option should be non-negative')
+
+        if ring_buffer_size > 0 and _utils.IS_WINDOWS:
+            raise ValueError('ring_buffer_size option is not supported on Windows')
+
         self.dataset = dataset
         self.num_workers = num_workers
         self.pin_memory = pin_memory
         self.timeout = timeout
         self.worker_init_fn = worker_init_fn
         self.multiprocessing_context = multiprocessing_context
+        self.ring_buffer_size = ring_buffer_size
 
         # Arg-check dataset related before checking samplers because we want to
         # tell users that iterable-style datasets are incompatible with custom
@@ -669,6 +685,26 @@ class _MultiProcessingDataLoaderIter(_BaseDataLoaderIter):
     #     processing indices already in `index_queue` if we are already shutting
     #     down.
 
+    # NOTE [ Shared Memory Ring Buffers of Workers ]
+    #
+    # By default, a worker puts its batches in `worker_result_queue` as they
+    # are, and every tensor in them is moved to shared memory and sent as a file
+    # descriptor (see `torch/multiprocessing/reductions.py`), which costs a few
+    # system calls and a round trip to the shared memory manager per tensor.
+    #
+    # With `ring_buffer_size > 0`, the main process creates one
+    # `torch._C._ShmRingBuffer` per worker, and each worker copies the CPU
+    # tensors of a batch into one region of its ring buffer, and only sends
+    # their offsets (see `_utils/ring_buffer.py`). The main process, or
+    # `pin_memory_thread` if `pin_memory=True`, creates the tensors of the
+    # batch on the ring buffer memory, and the region is given back to the
+    # worker when all of them are freed. A worker never waits for free space:
+    # batches that do not fit are sent the default way, even if the user holds
+    # on to the previous batches.
+    #
+    # The ring buffers are unlinked from the file system once the workers have
+    # exited, and unmapped when the last of their tensors is freed.
+
     def __init__(self, loader):
         super(_MultiProcessingDataLoaderIter, self).__init__(loader)
 
@@ -700,6 +736,11 @@ class _MultiProcessingDataLoaderIter(_BaseDataLoaderIter):
         # contains all `True`s if not using an iterable-style dataset
         # (i.e., if kind != Iterable).
         self._workers_status = []
+        # See NOTE [ Shared Memory Ring Buffers of Workers ]
+        self._ring_buffers = None
+        if loader.ring_buffer_size > 0:
+            self._ring_buffers = [torch._C._ShmRingBuffer.create(loader.ring_buffer_size)
+                                  for _ in range(self._num_workers)]
         for i in range(self._num_workers):
             index_queue = multiprocessing_context.Queue()
             # index_queue.cancel_join_thread()
@@ -708,7 +749,8 @@ class _MultiProcessingDataLoaderIter(_BaseDataLoaderIter):
                 args=(self._dataset_kind, self._dataset, index_queue,
                       self._worker_result_queue, self._workers_done_event,
                       self._auto_collation, self._collate_fn, self._drop_last,
-                      self._base_seed + i, self._worker_init_fn, i, self._num_workers))
+                      self._base_seed + i, self._worker_init_fn, i, self._num_workers,
+                      None if self._ring_buffers is None else self._ring_buffers[i].name))
             w.daemon = True
             # NB: Process.start() actually take some time as it needs to
             #     start a process and pass the arguments over via a pipe.
@@ -728,7 +770,7 @@ class _MultiProcessingDataLoaderIter(_BaseDataLoaderIter):
                 target=_utils.pin_memory._pin_memory_loop,
                 args=(self._worker_result_queue, self._data_queue,
                       torch.cuda.current_device(),
-                      self._pin_memory_thread_done_event))
+                      self._pin_memory_thread_done_event, self._ring_buffers))
             pin_memory_thread.daemon = True
             pin_memory_thread.start()
             # Similar to workers (see comment above), we only register
@@ -879,6 +921,8 @@ class _MultiProcessingDataLoaderIter(_BaseDataLoaderIter):
         self._try_put_index()
         if isinstance(data, ExceptionWrapper):
             data.reraise()
+        if self._ring_buffers is not None and not self._pin_memory:
+            data = _utils.ring_buffer._unpack(data, self._ring_buffers)
         return data
 
     def _shutdown_worker(self, worker_id):
@@ -942,6 +986,10 @@ class _MultiProcessingDataLoaderIter(_BaseDataLoaderIter):
                 for q in self._index_queues:
                     q.cancel_join_thread()
                     q.close()
+                # See NOTE [ Shared Memory Ring Buffers of Workers ]
+                if self._ring_buffers is not None:
+                    for ring in self._ring_buffers:
+                        ring.unlink()
             finally:
                 # Even though all this function does is putting into queues that
                 # we have called `cancel_join_thread` on, weird things can